@@ -1,8 +1,6 @@
-function initUi()
-  app.registerUi({["menu"] = "Toggle Highlight Position", ["callback"] = "laser", ["accelerator"] = "<Alt>x"});
-end
+-- The menu entry is declared in plugin.ini: this script only runs when it is first used
 
-local togglestate = false;
+local toggleState = false;
 
 function laser()
   toggleState = not toggleState
@@ -96,8 +96,8 @@ function app.openDialog(message, options, cb, error) end
 
 --- Allow to register menupoints and toolbar buttons. This needs to be called from initUi
 --- 
---- @param opts {menu: string, callback: string, toolbarID: string, mode:integer, accelerator:string} options (`mode`,
----  `toolbarID` and `accelerator` are optional)
+--- @param opts {menu: string, callback: string, toolbarID: string, mode:integer, accelerator:string, async:boolean}
+---  options (`mode`, `toolbarID`, `accelerator` and `async` are optional)
 --- @return {menuId:integer}
 --- 
 --- Example 1: app.registerUi({["menu"] = "HelloWorld", callback="printMessage", mode=1, accelerator="<Control>a"})
@@ -111,6 +111,15 @@ function app.openDialog(message, options, cb, error) end
 --- 
 --- The mode and accelerator are optional. When specifying the mode, the callback function should have one parameter
 ---    that receives the mode. This is useful for callback functions that are shared among multiple menu entries.
+--- 
+--- With async=true, the callback runs on a worker thread in a Lua state of its own, which loads the main file of the
+---    plugin again, so that a long computation does not freeze the UI. Only app.getStrokes, app.getStrokesPacked,
+---    app.addStrokes and app.addStrokesPacked are available there: the strokes read are the ones of the current layer and
+---    selection when the callback starts, the strokes added are inserted once the callback has returned, under a single
+---    undo action.
+--- 
+--- The same entries can be declared in [ui.<name>] groups of plugin.ini instead, with the same keys. The script of such
+---    a plugin is only loaded when one of its entries is first used, and its initUi is not called.
 function app.registerUi(opts) end
 
 --- Execute an UI action (usually internally called from Toolbar / Menu)
@@ -306,11 +315,14 @@ function app.addTexts(opts) end
 --- Is mostly inverse to app.addTexts (except getTexts will also retrieve the width/height of the textbox)
 --- 
 --- @param type string "selection" or "layer"
+--- @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
 --- @return {text:string, font:{name:string, size:number}, color:integer, x:number, y:number, width:number,
 --- height:number}[] texts
 --- 
 --- Required argument: type ("selection" or "layer")
 --- 
+--- Optional argument: area, to only get the elements in a part of the page (see app.getStrokes)
+--- 
 --- Example: local texts = app.getTexts("layer")
 --- 
 --- possible return value:
@@ -341,17 +353,28 @@ function app.addTexts(opts) end
 ---   },
 --- }
 --- 
-function app.getTexts(type) end
+function app.getTexts(type, area) end
 
 --- Puts a Lua Table of the Strokes (from the selection tool / selected layer) onto the stack.
 --- Is inverse to app.addStrokes
 --- 
 --- @param type string "selection" or "layer"
+--- @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
 --- @return {x:number[], y:number[], pressure:number[], tool:string, width:number, color:integer, fill:number,
 --- linestyle:string}[] strokes
 --- 
 --- Required argument: type ("selection" or "layer")
 --- 
+--- Optional argument: area, to only get the elements whose bounding box intersects a part of the page. With type
+--- "layer", it is answered by the spatial index of the layer, in a time depending on the size of the result.
+---   {x = ..., y = ..., width = ..., height = ...} for a rectangle,
+---   {x = ..., y = ..., radius = ...} for the disc of this radius centered at (x, y).
+--- With type "layer", its field layer (the ID of a non-background layer of the current page) gets the elements of that
+--- layer instead of those of the current layer. It may be given without the other fields.
+--- 
+--- Example: local near = app.getStrokes("layer", {x = 100, y = 200, radius = 20})
+---          local others = app.getStrokes("layer", {x = 0, y = 0, width = 300, height = 100, layer = 2})
+--- 
 --- Example: local strokes = app.getStrokes("selection")
 --- 
 --- possible return value:
@@ -387,7 +410,67 @@ function app.getTexts(type) end
 ---             ["lineStyle"] = "plain",
 ---         },
 --- }
-function app.getStrokes(type) end
+function app.getStrokes(type, area) end
+
+--- Like app.getStrokes, but the points of each stroke are packed in a single string, which is much faster for many
+--- strokes than tables of numbers.
+--- Is inverse to app.addStrokesPacked
+--- 
+--- @param type string "selection" or "layer"
+--- @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
+--- @return {points:string, pointCount:integer, hasPressure:boolean, tool:string, width:number, color:integer,
+--- fill:number, linestyle:string}[] strokes
+--- 
+--- Required argument: type ("selection" or "layer")
+--- 
+--- Optional argument: area, to only get the elements in a part of the page (see app.getStrokes)
+--- 
+--- The points string holds, for each point, its x and y coordinates and its pressure as native-endian doubles (the
+--- pressure is -1 if the stroke has no pressure). The values can be read with string.unpack.
+--- 
+--- Example: local strokes = app.getStrokesPacked("layer")
+---          for _, s in ipairs(strokes) do
+---            local pos = 1
+---            for i = 1, s.pointCount do
+---              local x, y, pressure
+---              x, y, pressure, pos = string.unpack("ddd", s.points, pos)
+---            end
+---          end
+function app.getStrokesPacked(type, area) end
+
+--- Like app.addStrokes, but the points of each stroke are given packed in a single string, as returned by
+--- app.getStrokesPacked.
+--- 
+--- @param opts {strokes:{points:string, hasPressure:boolean, tool:string, width:number, color:integer, fill:number,
+--- linestyle:string}[], allowUndoRedoAction:string}
+--- 
+--- Required Arguments: points
+--- Optional Arguments: hasPressure, tool, width, color, fill, lineStyle
+--- 
+--- The points string holds, for each point, its x and y coordinates and its pressure as native-endian doubles, e.g.
+--- built with string.pack("ddd", x, y, pressure). The pressures are ignored unless hasPressure is true. A stroke must
+--- have at least two points.
+--- 
+--- If optional arguments are not provided, the specified tool settings are used.
+--- If the tool is not provided, the current pen settings are used.
+--- The only tools supported are Pen and Highlighter.
+--- 
+--- Example:
+--- 
+--- app.addStrokesPacked({
+---     ["strokes"] = {
+---         {
+---             ["points"] = string.pack("dddddd", 110.0, 200.0, 0.8, 120.0, 205.0, 0.9),
+---             ["hasPressure"] = true,
+---             ["tool"] = "pen",
+---             ["width"] = 3.8,
+---             ["color"] = 0xa000f0,
+---         },
+---     },
+---     ["allowUndoRedoAction"] = "grouped", -- Each batch of strokes can be grouped into one undo/redo action (or
+--- "individual" or "none")
+--- })
+function app.addStrokesPacked(opts) end
 
 --- Notifies program of any updates to the working document caused
 --- by the API.
@@ -569,10 +652,11 @@ function app.getToolInfo(tool) end
 
 --- Returns a table encoding the document structure in a Lua table.
 --- 
+--- @param opts {pages:integer[]}|nil the numbers of the pages to describe (optional, all pages by default)
 --- @return {pages:{pageWidth:number, pageHeight:number, isAnnotated:boolean, pageTypeFormat:string,
 --- pageTypeConfig:string, backgroundColor:integer, pdfBackgroundPageNo:integer, layers:{isVisible:boolean,
---- isAnnotated:boolean}[], currentLayer:integer}[], currentPage:integer, pdfBackgroundFilename:string,
---- xoppFilename:string}
+--- isAnnotated:boolean}[], currentLayer:integer, revision:integer}[], currentPage:integer,
+--- pdfBackgroundFilename:string, xoppFilename:string, revision:integer}
 --- 
 --- The shape of the returned Lua table will be:
 --- {
@@ -595,17 +679,57 @@ function app.getToolInfo(tool) end
 ---         },
 ---         ...
 ---       },
----       "currentLayer" = integer
+---       "currentLayer" = integer,
+---       "revision" = integer (see app.getPageRevisions)
 ---     },
 ---     ...
 ---   }
 ---   "currentPage" = integer,
 ---   "pdfBackgroundFilename" = string (empty if there is none)
 ---   "xoppFilename" = string (empty if there is none)
+---   "revision" = integer (see app.getDocumentRevision)
 --- }
 --- 
---- Example: local docStructure = app.getDocumentStructure()
-function app.getDocumentStructure() end
+--- When opts.pages is given, only the listed pages are in the "pages" table, under their page numbers.
+--- 
+--- Example 1: local docStructure = app.getDocumentStructure()
+--- 
+--- Example 2: local changed = app.getDocumentStructure({pages = {2, 5}})
+--- only describes the pages 2 and 5, e.g. the ones whose revision changed since the last query
+function app.getDocumentStructure(opts) end
+
+--- Returns the revision of the document: a counter which changes whenever the document changes, i.e. pages are
+--- inserted or deleted, a page or its layers or elements change, or the document or the pdf background file changes.
+--- The current page is not part of the revision.
+--- 
+--- @return integer the revision of the document
+--- 
+--- Example: if app.getDocumentRevision() ~= lastRevision then ... end
+--- checks whether the document changed since the last query, without building a table
+function app.getDocumentRevision() end
+
+--- Returns the revisions of the pages: counters which change whenever the page changes, i.e. its size, background,
+--- current layer, or its layers or elements.
+--- 
+--- @return integer[] the revisions of the pages, by page number
+--- 
+--- Example: local revisions = app.getPageRevisions()
+--- a plugin can compare them to the ones of its last query, and call app.getDocumentStructure({pages = ...}) with the
+--- pages whose revision changed only
+function app.getPageRevisions() end
+
+--- Returns the numbers of the pages on which strokes of visible layers are in the given rectangle.
+--- Uses the ink index of the document: no need to go through all the strokes of the document.
+--- 
+--- @param x number left side of the rectangle, in page coordinates
+--- @param y number top side of the rectangle, in page coordinates
+--- @param width number width of the rectangle
+--- @param height number height of the rectangle
+--- @return table the page numbers (starting at 1), in increasing order
+--- 
+--- Example: local pages = app.getPagesWithInk(0, 0, 200, 100)
+--- returns the pages with handwriting in their top left corner
+function app.getPagesWithInk(x, y, width, height) end
 
 --- Scrolls to the page specified relatively or absolutely (by default)
 --- The page number is clamped to the range between the first and last page
@@ -655,6 +779,19 @@ function app.setCurrentPage(pageNr) end
 --- adds 14.17*6 pt = 3cm to the height of the page (relative mode)
 function app.setPageSize(width, height, relative) end
 
+--- Inserts new pages, configured like the pages inserted from the Journal menu, after the current page or before the
+--- page indicated. All the pages are inserted at once, with a single undo action.
+--- 
+--- @param count integer number of pages to insert
+--- @param pageNr integer (optional) number of the page the new pages are inserted before (automatically clamped)
+--- 
+--- Example 1: app.insertPages(10)
+--- inserts 10 new pages after the current page
+--- 
+--- Example 2: app.insertPages(3, 1)
+--- inserts 3 new pages at the beginning of the document
+function app.insertPages(count, pageNr) end
+
 --- Sets the current layer of the current page as indicated and updates visibility if specified (by default it does not)
 --- Displays an error message, if the selected layer does not exist
 --- 
@@ -698,10 +835,15 @@ function app.setBackgroundName(name) end
 --- of the bounding box remains unchanged
 --- 
 --- @param factor number
+--- @param allPages boolean (optional) scale the text elements of all the layers of all the pages instead, the pages
+---                 being processed concurrently
 --- 
 --- Example: app.scaleTextElements(2.3)
 --- scales all text elements on the current layer with factor 2.3
-function app.scaleTextElements(factor) end
+--- 
+--- Example: app.scaleTextElements(0.5, true)
+--- halves the font size of all the text elements of the document (undone at once)
+function app.scaleTextElements(factor, allPages) end
 
 --- Gets the display DPI.
 --- 
@@ -788,11 +930,14 @@ function app.addImages(opts) end
 --- Is inverse to app.addImages
 --- 
 --- @param type string "selection" or "layer"
+--- @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
 --- @return {x:number, y:number, width:number, height:number, data:string, format:string, imageWidth:number,
 --- imageHeight:number}[] images
 --- 
 --- Required argument: type ("selection" or "layer")
 --- 
+--- Optional argument: area, to only get the elements in a part of the page (see app.getStrokes)
+--- 
 --- Example: local images = app.getImages("selection")
 --- 
 --- return value:
@@ -812,5 +957,5 @@ function app.addImages(opts) end
 ---     },
 ---     ...
 --- }
-function app.getImages(type) end
+function app.getImages(type, area) end
 
@@ -1,5 +1,7 @@
 #include "AudioPlayer.h"
 
+#include <chrono>  // for steady_clock, milliseconds
+
 #include "audio/AudioQueue.h"                // for AudioQueue
 #include "audio/DeviceInfo.h"                // for DeviceInfo
 #include "audio/PortAudioConsumer.h"         // for PortAudioConsumer
@@ -10,6 +12,13 @@
 
 class Settings;
 
+namespace {
+/// The audio decoded before the playback starts, so that it does not start with an underflow
+constexpr std::chrono::milliseconds PREBUFFER_DURATION{50};
+/// The longest the playback waits for it
+constexpr std::chrono::milliseconds PREBUFFER_TIMEOUT{250};
+}  // namespace
+
 AudioPlayer::AudioPlayer(Control& control, Settings& settings):
         control(control),
         settings(settings),
@@ -17,12 +26,21 @@ AudioPlayer::AudioPlayer(Control& control, Settings& settings):
         portAudioConsumer(std::make_unique<PortAudioConsumer>(*this, *audioQueue)),
         vorbisProducer(std::make_unique<VorbisProducer>(*audioQueue)) {}
 
-AudioPlayer::~AudioPlayer() { this->stop(); }
+AudioPlayer::~AudioPlayer() { this->release(); }
 
 auto AudioPlayer::start(fs::path const& file, unsigned int timestamp) -> bool {
     // Start the producer for reading the data
     bool status = this->vorbisProducer->start(file, timestamp);
 
+    if (status) {
+        auto [sampleRate, channels] = this->audioQueue->getAudioAttributes();
+        const auto prebuffer = static_cast<size_t>(sampleRate * channels * PREBUFFER_DURATION.count() / 1000.0);
+        const auto deadline = std::chrono::steady_clock::now() + PREBUFFER_TIMEOUT;
+        this->audioQueue->waitUntil([&] {
+            return this->audioQueue->size() >= prebuffer || std::chrono::steady_clock::now() >= deadline;
+        });
+    }
+
     // Start playing
     if (status) {
         status = status && this->play();
@@ -75,6 +93,12 @@ void AudioPlayer::stop() {
     this->audioQueue->reset();
 }
 
+void AudioPlayer::release() {
+    this->stop();
+    this->portAudioConsumer->closeStream();
+    this->vorbisProducer->closeFiles();
+}
+
 void AudioPlayer::seek(int seconds) {
     // set seek flag here in vorbisProducer
     this->vorbisProducer->seek(seconds);
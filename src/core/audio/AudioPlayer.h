@@ -40,6 +40,11 @@ public:
     bool play();
     void pause();
     void seek(int seconds);
+    /**
+     * Stop the playback, and close what is kept open to start the next one quickly: the output stream and the files
+     * last played (see Settings::isKeepAudioOutputOpen())
+     */
+    void release();
 
     std::vector<DeviceInfo> getOutputDevices();
 
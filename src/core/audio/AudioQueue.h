@@ -11,109 +11,129 @@
 
 #pragma once
 
-#include <algorithm>
-#include <condition_variable>
-#include <deque>
-#include <limits>
-#include <mutex>
+#include <algorithm>  // for copy_n, min
+#include <atomic>     // for atomic
+#include <chrono>     // for milliseconds
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t
+#include <iterator>   // for distance, next
+#include <limits>     // for numeric_limits
+#include <thread>     // for sleep_for
+#include <utility>    // for pair
+#include <vector>     // for vector
 
-#include "util/Assert.h"
 #include "util/safe_casts.h"  // for as_signed
 
+/**
+ * @brief A lock-free single producer, single consumer ring buffer of samples, between a PortAudio stream and a
+ * Vorbis file.
+ *
+ * One side runs in the realtime callback of PortAudio: emplace(), pop(), size(), empty(), hasStreamEnded() and
+ * signalEndOfStream() never allocate, lock nor wait. Only the other side waits, by polling, see waitUntil(). The
+ * samples which do not fit into the preallocated buffer are dropped, see getDroppedSamples().
+ *
+ * reset() and setAudioAttributes() must only be called while neither side runs.
+ */
 template <typename T>
 class AudioQueue {
 public:
+    /// About 1.4 seconds of stereo samples at 48 kHz
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 17;
+    /// How often the non-realtime side checks the queue while it waits
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{5};
+
+    explicit AudioQueue(size_t capacity = DEFAULT_CAPACITY): buffer(capacity) {}
+
     void reset() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->popNotified = false;
-        this->pushNotified = false;
+        this->head = 0;
+        this->tail = 0;
+        this->droppedSamples = 0;
         this->streamEnd = false;
-        internalQueue.clear();
 
         this->sampleRate = -1;
         this->channels = 0;
     }
 
-    bool empty() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.empty();
-    }
+    bool empty() const { return size() == 0; }
 
-    size_t size() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.size();
+    size_t size() const {
+        // The tail is loaded first: the head is never behind it
+        const size_t readPos = this->tail.load(std::memory_order_acquire);
+        return this->head.load(std::memory_order_acquire) - readPos;
     }
 
-    template <typename Iter>
-    void emplace(Iter begI, Iter endI) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        std::move(begI, endI, std::front_inserter(internalQueue));
+    size_t capacity() const { return this->buffer.size(); }
 
-        this->pushNotified = true;
-        this->pushLockCondition.notify_one();
+    /**
+     * Push the samples, from the producer side only
+     * @return The number of samples pushed, the others being dropped as the queue is full
+     */
+    template <typename Iter>
+    size_t emplace(Iter begI, Iter endI) {
+        const size_t writePos = this->head.load(std::memory_order_relaxed);
+        const size_t readPos = this->tail.load(std::memory_order_acquire);
+        const auto requested = static_cast<size_t>(std::distance(begI, endI));
+        const size_t count = std::min(requested, capacity() - (writePos - readPos));
+
+        // In two parts, if the samples wrap around the end of the buffer
+        const size_t start = writePos % capacity();
+        const size_t first = std::min(count, capacity() - start);
+        std::copy_n(begI, first, std::next(this->buffer.begin(), as_signed(start)));
+        std::copy_n(std::next(begI, as_signed(first)), count - first, this->buffer.begin());
+
+        this->head.store(writePos + count, std::memory_order_release);
+        if (count < requested) {
+            this->droppedSamples.fetch_add(requested - count, std::memory_order_relaxed);
+        }
+        return count;
     }
 
+    /**
+     * Pop at most nSamples samples, in whole frames, from the consumer side only
+     * @return The end of the samples written to insertIter
+     */
     template <typename InsertIter>
     InsertIter pop(InsertIter insertIter, size_t nSamples) {
-        std::lock_guard<std::mutex> lock(internalLock);
-
-        if (this->channels == 0) {
-            this->popNotified = true;
-            this->popLockCondition.notify_one();
+        const uint32_t frameSize = this->channels.load(std::memory_order_relaxed);
+        if (frameSize == 0) {
             return insertIter;
         }
 
+        const size_t readPos = this->tail.load(std::memory_order_relaxed);
+        const size_t available = this->head.load(std::memory_order_acquire) - readPos;
+        const size_t count = std::min<size_t>(nSamples, available - available % frameSize);
 
-        auto queueSize = internalQueue.size();
-        auto returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % this->channels);
-        auto begI = rbegin(internalQueue);
-        auto endI = std::next(begI, as_signed(returnBufferLength));
-
-        auto ret = std::move(begI, endI, insertIter);
-        internalQueue.erase(endI.base(), begI.base());
-
-        this->popNotified = true;
-        this->popLockCondition.notify_one();
-        return ret;
-    }
+        const size_t start = readPos % capacity();
+        const size_t first = std::min(count, capacity() - start);
+        auto begI = this->buffer.cbegin();
+        insertIter = std::copy_n(std::next(begI, as_signed(start)), first, insertIter);
+        insertIter = std::copy_n(begI, count - first, insertIter);
 
-    void signalEndOfStream() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        this->streamEnd = true;
-        this->pushNotified = true;
-        this->popNotified = true;
-        this->pushLockCondition.notify_one();
-        this->popLockCondition.notify_one();
+        this->tail.store(readPos + count, std::memory_order_release);
+        return insertIter;
     }
 
-    void waitForProducer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
-        xoj_assert(lock.mutex() == &this->queueLock);
-        while (!this->pushNotified && !hasStreamEnded()) { this->pushLockCondition.wait(lock); }
-        this->pushNotified = false;
-    }
+    void signalEndOfStream() { this->streamEnd.store(true, std::memory_order_release); }
 
-    void waitForConsumer(std::unique_lock<std::mutex>& lock) {
-        // static_assert(lock.mutex() == &this->queueLock);
-        xoj_assert(lock.mutex() == &this->queueLock);
-        while (!this->popNotified && !hasStreamEnded()) { this->popLockCondition.wait(lock); }
-        this->popNotified = false;
-    }
+    bool hasStreamEnded() const { return this->streamEnd.load(std::memory_order_acquire); }
 
-    bool hasStreamEnded() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return this->streamEnd;
+    /**
+     * Wait, on the non-realtime side, until pred() holds or the stream has ended. The realtime side never notifies
+     * the waiting side: the queue is polled.
+     */
+    template <typename Pred>
+    void waitUntil(Pred pred) const {
+        while (!pred() && !hasStreamEnded()) {
+            std::this_thread::sleep_for(POLL_INTERVAL);
+        }
     }
 
-    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() {
-        std::unique_lock retLock{this->queueLock, std::defer_lock};
-        std::lock(retLock, this->internalLock);
-        std::lock_guard lock{this->internalLock, std::adopt_lock};
-        return retLock;
-    }
+    /**
+     * @return The number of samples dropped since the last reset, as the queue was full
+     */
+    size_t getDroppedSamples() const { return this->droppedSamples.load(std::memory_order_relaxed); }
 
     void setAudioAttributes(double lSampleRate, unsigned int lChannels) {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->sampleRate = lSampleRate;
         this->channels = lChannels;
     }
@@ -124,24 +144,22 @@ public:
      * Todo (readability, type-safety): create a struct AudioAttributes; remove this comment
      */
 
-    [[nodiscard]] std::pair<double, int> getAudioAttributes() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return {this->sampleRate, this->channels};
+    [[nodiscard]] std::pair<double, int> getAudioAttributes() const {
+        return {this->sampleRate.load(), static_cast<int>(this->channels.load())};
     }
 
 private:
-    std::mutex queueLock;
-    std::mutex internalLock;
+    /// Preallocated: the realtime side never allocates
+    std::vector<T> buffer;
 
-    std::deque<T> internalQueue;
+    /// The number of samples ever pushed (written by the producer) and popped (written by the consumer)
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
 
-    std::condition_variable pushLockCondition;
-    std::condition_variable popLockCondition;
+    std::atomic<size_t> droppedSamples{0};
 
-    double sampleRate{std::numeric_limits<double>::quiet_NaN()};
-    uint32_t channels{0};
+    std::atomic<double> sampleRate{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<uint32_t> channels{0};
 
-    bool streamEnd{false};
-    bool pushNotified{false};
-    bool popNotified{false};
+    std::atomic<bool> streamEnd{false};
 };
@@ -0,0 +1,133 @@
+#include "BufferedFileWriter.h"
+
+#include <algorithm>  // for max, min
+#include <utility>    // for swap
+
+#include <glib/gstdio.h>  // for g_fopen
+
+BufferedFileWriter::~BufferedFileWriter() { close(); }
+
+auto BufferedFileWriter::open(const fs::path& path) -> bool {
+    close();
+    this->file = g_fopen(path.u8string().c_str(), "wb");
+    if (!this->file) {
+        return false;
+    }
+    this->position = this->end = 0;
+    this->failed = this->closing = false;
+    this->block.reserve(BLOCK_SIZE);
+    this->thread = std::thread([this] { run(); });
+    return true;
+}
+
+auto BufferedFileWriter::write(const void* data, size_t length) -> size_t {
+    if (!this->file) {
+        return 0;
+    }
+    const auto* bytes = static_cast<const char*>(data);
+    for (size_t left = length; left > 0;) {
+        const size_t n = std::min(left, BLOCK_SIZE - this->block.size());
+        this->block.insert(this->block.end(), bytes, bytes + n);
+        bytes += n;
+        left -= n;
+        if (this->block.size() == BLOCK_SIZE) {
+            submit();
+        }
+    }
+    this->position += static_cast<int64_t>(length);
+    this->end = std::max(this->end, this->position);
+
+    std::lock_guard lock(this->mutex);
+    return this->failed ? 0 : length;
+}
+
+void BufferedFileWriter::submit() {
+    if (this->block.empty()) {
+        return;
+    }
+    {
+        std::unique_lock lock(this->mutex);
+        this->blocksWritten.wait(lock, [&] { return this->queue.size() < MAX_QUEUED_BLOCKS; });
+        this->queue.push_back(std::move(this->block));
+    }
+    this->blockQueued.notify_one();
+    this->block = {};
+    this->block.reserve(BLOCK_SIZE);
+}
+
+void BufferedFileWriter::drain() {
+    submit();
+    std::unique_lock lock(this->mutex);
+    this->blocksWritten.wait(lock, [&] { return this->queue.empty() && !this->writing; });
+}
+
+auto BufferedFileWriter::seek(int64_t offset, int whence) -> int64_t {
+    if (!this->file) {
+        return -1;
+    }
+    const int64_t base = whence == SEEK_SET ? 0 : whence == SEEK_CUR ? this->position : this->end;
+    const int64_t target = base + offset;
+    if (target < 0) {
+        return -1;
+    }
+    if (target == this->position) {
+        return target;
+    }
+    // The thread is idle until the next block is queued: the file can be used here
+    drain();
+    if (fseek(this->file, static_cast<long>(target), SEEK_SET) != 0) {
+        return -1;
+    }
+    this->position = target;
+    return target;
+}
+
+auto BufferedFileWriter::tell() const -> int64_t { return this->position; }
+
+auto BufferedFileWriter::size() const -> int64_t { return this->end; }
+
+auto BufferedFileWriter::close() -> bool {
+    if (!this->file) {
+        return false;
+    }
+    submit();
+    {
+        std::lock_guard lock(this->mutex);
+        this->closing = true;
+    }
+    this->blockQueued.notify_one();
+    this->thread.join();
+
+    bool ok = !this->failed;
+    ok = fclose(this->file) == 0 && ok;
+    this->file = nullptr;
+    return ok;
+}
+
+void BufferedFileWriter::run() {
+    std::deque<std::vector<char>> blocks;
+    std::unique_lock lock(this->mutex);
+    for (;;) {
+        this->blockQueued.wait(lock, [&] { return !this->queue.empty() || this->closing; });
+        if (this->queue.empty()) {
+            return;
+        }
+        // All the queued blocks, in a single batch
+        std::swap(blocks, this->queue);
+        this->writing = true;
+        lock.unlock();
+        this->blocksWritten.notify_all();
+
+        bool ok = true;
+        for (const auto& b: blocks) {
+            ok = ok && fwrite(b.data(), 1, b.size(), this->file) == b.size();
+        }
+        ok = ok && fflush(this->file) == 0;
+        blocks.clear();
+
+        lock.lock();
+        this->writing = false;
+        this->failed = this->failed || !ok;
+        this->blocksWritten.notify_all();
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Xournal++
+ *
+ * A file written in the background
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for int64_t
+#include <cstdio>              // for FILE
+#include <deque>               // for deque
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include "filesystem.h"  // for path
+
+/**
+ * @brief A file written by a dedicated thread, so that its writer never waits for the disk
+ *
+ * write() copies the bytes into blocks, queued for the thread, which writes all the blocks queued at once and then
+ * flushes the file. The queue is bounded: write() waits only when it is full, i.e. when the disk has been stalling
+ * for as long as MAX_QUEUED_BLOCKS blocks take to produce.
+ *
+ * The file is seekable, as if it was written directly: seek() waits for the queued blocks to be written first.
+ * Only one thread may use the writer.
+ */
+class BufferedFileWriter final {
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+    /// 8 MiB: several minutes of Ogg/Vorbis audio
+    static constexpr size_t MAX_QUEUED_BLOCKS = 128;
+
+    BufferedFileWriter() = default;
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter&) = delete;
+    BufferedFileWriter& operator=(const BufferedFileWriter&) = delete;
+
+    /**
+     * Create (or truncate) the file and start the thread
+     */
+    bool open(const fs::path& file);
+
+    /**
+     * @return length, or 0 if writing the file failed
+     */
+    size_t write(const void* data, size_t length);
+
+    /**
+     * @param whence SEEK_SET, SEEK_CUR or SEEK_END
+     * @return The new position, -1 on failure
+     */
+    int64_t seek(int64_t offset, int whence);
+
+    int64_t tell() const;
+    int64_t size() const;
+
+    /**
+     * Write what is queued, and close the file
+     * @return Whether all the bytes were written
+     */
+    bool close();
+
+private:
+    void run();
+    /// Queue the current block
+    void submit();
+    /// Wait until the thread wrote all the queued blocks
+    void drain();
+
+    FILE* file = nullptr;
+    std::thread thread;
+
+    /// Being filled, not yet queued
+    std::vector<char> block;
+    /// Where the bytes written go, and the end of the file, counting the bytes not yet on the disk
+    int64_t position = 0;
+    int64_t end = 0;
+
+    std::mutex mutex;
+    std::condition_variable blockQueued;
+    std::condition_variable blocksWritten;
+    /// Guarded by the mutex, as the members below
+    std::deque<std::vector<char>> queue;
+    bool writing = false;
+    bool closing = false;
+    bool failed = false;
+};
@@ -1,9 +1,9 @@
 #include "PortAudioConsumer.h"
 
-#include <algorithm>  // for for_each, transform, max
-#include <deque>      // for _Deque_iterator
+#include <algorithm>  // for fill_n, for_each, transform, max
 #include <iterator>   // for next, prev
 #include <string>     // for to_string, string
+#include <thread>     // for yield
 
 #include <glib.h>  // for g_warning
 
@@ -40,12 +40,14 @@ auto PortAudioConsumer::getSelectedOutputDevice() const -> DeviceInfo {
     }
 }
 
-auto PortAudioConsumer::isPlaying() const -> bool { return this->outputStream && this->outputStream->isActive(); }
+auto PortAudioConsumer::isPlaying() const -> bool {
+    return this->playing && this->outputStream && this->outputStream->isActive();
+}
 
 auto PortAudioConsumer::startPlaying() -> bool {
-    // Abort a playback stream if one is currently active
+    // Detach the callback from a playback currently active
     if (isPlaying()) {
-        this->outputStream->abort();
+        stopPlaying();
     }
 
     auto [sampleRate, channels] = this->audioQueue.getAudioAttributes();
@@ -70,6 +72,18 @@ auto PortAudioConsumer::startPlaying() -> bool {
         return false;
     }
 
+    this->underflows = 0;
+    // Read by the callback, which does not run with the playing flag cleared
+    this->keepStreamOpen = this->audioPlayer.getSettings().isKeepAudioOutputOpen();
+
+    // Reuse the stream kept open if it has the right format
+    if (this->outputStream && this->outputStream->isActive() && this->outputDevice == device->index() &&
+        this->outputSampleRate == sampleRate && this->outputChannels == channels) {
+        this->playing = true;
+        return true;
+    }
+    closeStream();
+
     this->outputChannels = channels;
     portaudio::DirectionSpecificStreamParameters outParams(*device, channels, portaudio::FLOAT32, true,
                                                            device->defaultLowOutputLatency(), nullptr);
@@ -84,10 +98,14 @@ auto PortAudioConsumer::startPlaying() -> bool {
         g_warning("PortAudioConsumer: Unable to open stream to device\nCaused by: %s", e.what());
         return false;
     }
+    this->outputDevice = device->index();
+    this->outputSampleRate = sampleRate;
+    this->playing = true;
     // Start the recording
     try {
         this->outputStream->start();
     } catch (const portaudio::PaException& e) {
+        this->playing = false;
         this->audioQueue.signalEndOfStream();
         g_warning("PortAudioConsumer: Unable to start stream\nCaused by: %s", e.what());
         this->outputStream.reset();
@@ -98,6 +116,19 @@ auto PortAudioConsumer::startPlaying() -> bool {
 
 auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBuffer, unsigned long framesPerBuffer,
                                      const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags statusFlags) -> int {
+    // Set before reading the playing flag, see waitForIdleCallback()
+    this->inCallback = true;
+    struct CallbackExit {
+        std::atomic<bool>& inCallback;
+        ~CallbackExit() { inCallback = false; }
+    } exit{this->inCallback};
+
+    if (outputBuffer != nullptr && !this->playing) {
+        // The stream is kept open between the playbacks
+        std::fill_n(static_cast<float*>(outputBuffer), framesPerBuffer * as_unsigned(this->outputChannels), 0.0F);
+        return paContinue;
+    }
+
     if (statusFlags) {
         g_warning("PortAudioConsumer: PortAudio reported a stream warning: %s", std::to_string(statusFlags).c_str());
     }
@@ -109,9 +140,9 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
         // Fill buffer to requested length if necessary
 
         if (midI != endI) {
-            // Show underflow warning if there are not enough samples and the stream is not yet finished
+            // Count the underflow if there are not enough samples and the stream is not yet finished
             if (!this->audioQueue.hasStreamEnded()) {
-                g_warning("PortAudioConsumer: Not enough audio samples available to fill requested frame");
+                this->underflows.fetch_add(1, std::memory_order_relaxed);
             }
 
             if (midI > std::next(begI, this->outputChannels)) {
@@ -127,6 +158,10 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
         // Continue playback if there is still data available
         if (this->audioQueue.hasStreamEnded() && this->audioQueue.empty()) {
             this->audioPlayer.disableAudioPlaybackButtons();
+            if (this->keepStreamOpen) {
+                this->playing = false;
+                return paContinue;
+            }
             return paComplete;
         }
 
@@ -141,6 +176,25 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
 }
 
 void PortAudioConsumer::stopPlaying() {
+    if (this->outputStream && this->audioPlayer.getSettings().isKeepAudioOutputOpen()) {
+        bool active = false;
+        try {
+            active = this->outputStream->isActive();
+        } catch (const portaudio::PaException&) {
+            // Closed by the backend: closed below
+        }
+        if (active) {
+            this->playing = false;
+            waitForIdleCallback();
+            reportUnderflows();
+            return;
+        }
+    }
+    closeStream();
+}
+
+void PortAudioConsumer::closeStream() {
+    this->playing = false;
     // Stop the playback
     if (this->outputStream) {
         try {
@@ -155,4 +209,20 @@ void PortAudioConsumer::stopPlaying() {
         }
     }
     this->outputStream.reset();
+    this->outputDevice = paNoDevice;
+    reportUnderflows();
+}
+
+void PortAudioConsumer::reportUnderflows() {
+    if (auto count = this->underflows.exchange(0); count > 0) {
+        g_warning("PortAudioConsumer: Not enough audio samples available to fill %zu requested frames", count);
+    }
+}
+
+void PortAudioConsumer::waitForIdleCallback() const {
+    // The callback sets inCallback before reading playing, and this thread cleared playing before reading inCallback:
+    // either the callback sees playing cleared, or it is waited for. It runs for less than a buffer.
+    while (this->inCallback) {
+        std::this_thread::yield();
+    }
 }
@@ -11,8 +11,10 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <vector>  // for vector
+#include <atomic>   // for atomic
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
 
 #include <portaudiocpp/PortAudioCpp.hxx>  // for MemFunCallbackStream, System
 
@@ -33,9 +35,20 @@ public:
     bool startPlaying();
     int playCallback(const void* inputBuffer, void* outputBuffer, unsigned long framesPerBuffer,
                      const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags);
+    /**
+     * Stop reading from the queue. The stream is kept open, playing silence, if Settings::isKeepAudioOutputOpen():
+     * the next playback with the same device and format starts without opening a stream again.
+     * Once it returns, the callback does not access the queue anymore.
+     */
     void stopPlaying();
+    /// Stop the playback, and close the stream even if it was kept open
+    void closeStream();
 
 private:
+    /// Wait until the callback is not running with the playing flag set
+    void waitForIdleCallback() const;
+    void reportUnderflows();
+
     portaudio::System& sys{portaudio::System::instance()};
     AudioPlayer& audioPlayer;
     AudioQueue<float>& audioQueue;
@@ -43,4 +56,16 @@ private:
     std::unique_ptr<portaudio::MemFunCallbackStream<PortAudioConsumer>> outputStream;
 
     int outputChannels = 0;
+    /// The device and the sample rate of the open stream
+    PaDeviceIndex outputDevice = paNoDevice;
+    double outputSampleRate = 0;
+
+    /// Whether the callback reads from the queue; if not, it plays silence (the stream was kept open)
+    std::atomic<bool> playing{false};
+    std::atomic<bool> inCallback{false};
+    /// Settings::isKeepAudioOutputOpen() when the playback started
+    bool keepStreamOpen = false;
+
+    /// The buffers the callback could not fill, reported once the playback stops (the callback must not log)
+    std::atomic<size_t> underflows{0};
 };
@@ -2,7 +2,6 @@
 
 #include <algorithm>  // for for_each, min, max
 #include <cstddef>    // for size_t
-#include <deque>      // for _Deque_iterator
 #include <iterator>   // for back_insert_iterator, back_in...
 #include <memory>     // for unique_ptr
 #include <string>     // for string
@@ -15,10 +14,27 @@
 #include "audio/AudioQueue.h"           // for AudioQueue
 #include "control/settings/Settings.h"  // for Settings
 
-#include "SNDFileCpp.h"  // for make_snd_file, xoj
+#include "SNDFileCpp.h"  // for SNDFileGuard, xoj
 
 using namespace xoj;
 
+namespace {
+/// Samples encoded at once, per channel
+constexpr size_t FRAMES_PER_WRITE = 1024;
+
+auto writerOf(void* user) -> BufferedFileWriter& { return *static_cast<BufferedFileWriter*>(user); }
+
+/// libsndfile writes the encoded file through the BufferedFileWriter
+SF_VIRTUAL_IO writerIO = {
+        [](void* user) -> sf_count_t { return writerOf(user).size(); },
+        [](sf_count_t offset, int whence, void* user) -> sf_count_t { return writerOf(user).seek(offset, whence); },
+        [](void*, sf_count_t, void*) -> sf_count_t { return 0; },  // The file is only written
+        [](const void* data, sf_count_t count, void* user) -> sf_count_t {
+            return static_cast<sf_count_t>(writerOf(user).write(data, static_cast<size_t>(count)));
+        },
+        [](void* user) -> sf_count_t { return writerOf(user).tell(); }};
+}  // namespace
+
 auto VorbisConsumer::start(fs::path const& file) -> bool {
     auto [sampleRate, channels] = this->audioQueue.getAudioAttributes();
 
@@ -32,22 +48,26 @@ auto VorbisConsumer::start(fs::path const& file) -> bool {
     sfInfo.format = SF_FORMAT_OGG | SF_FORMAT_VORBIS;
     sfInfo.samplerate = static_cast<int>(this->settings.getAudioSampleRate());
 
-    auto sfFile = audio::make_snd_file(file.native(), SFM_WRITE, &sfInfo);
+    if (!this->fileWriter.open(file)) {
+        g_warning("VorbisConsumer: output file \"%s\" could not be opened", file.u8string().c_str());
+        return false;
+    }
+    audio::SNDFileGuard sfFile{sf_open_virtual(&writerIO, SFM_WRITE, &sfInfo, &this->fileWriter)};
     if (!sfFile) {
         g_warning("VorbisConsumer: output file \"%s\" could not be opened\ncaused by:%s", file.u8string().c_str(),
                   sf_strerror(sfFile.get()));
+        this->fileWriter.close();
         return false;
     }
 
-    this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels] {
-        auto lock{audioQueue.acquire_lock()};
-        auto buffer_size{size_t(64 * channels)};
+    this->consumerThread = std::thread([this, sfFile = std::move(sfFile), channels = channels]() mutable {
+        auto buffer_size{size_t(FRAMES_PER_WRITE) * size_t(channels)};
         std::vector<float> buffer;
         buffer.reserve(buffer_size);  // efficiency
         float audioGain = static_cast<float>(this->settings.getAudioGain());
 
         while (!(this->stopConsumer || (audioQueue.hasStreamEnded() && audioQueue.empty()))) {
-            audioQueue.waitForProducer(lock);
+            audioQueue.waitUntil([&] { return this->stopConsumer || audioQueue.size() > buffer_size; });
             while (audioQueue.size() > buffer_size || (audioQueue.hasStreamEnded() && !audioQueue.empty())) {
                 buffer.resize(0);
                 this->audioQueue.pop(std::back_inserter(buffer), buffer_size);
@@ -56,9 +76,19 @@ auto VorbisConsumer::start(fs::path const& file) -> bool {
                     std::for_each(begin(buffer), end(buffer), [audioGain](auto& val) { val *= audioGain; });
                 }
                 sf_writef_float(sfFile.get(), buffer.data(),
-                                std::min<sf_count_t>(sf_count_t(buffer.size()) / channels, 64));
+                                std::min<sf_count_t>(sf_count_t(buffer.size()) / channels, FRAMES_PER_WRITE));
             }
         }
+
+        // The last pages are encoded when closing, before the file itself is closed
+        sfFile.reset();
+        if (!this->fileWriter.close()) {
+            g_warning("VorbisConsumer: the audio file could not be written completely");
+        }
+
+        if (auto dropped = audioQueue.getDroppedSamples(); dropped > 0) {
+            g_warning("VorbisConsumer: %zu audio samples were dropped, the file was not written fast enough", dropped);
+        }
     });
     return true;
 }
@@ -16,6 +16,8 @@
 
 #include "filesystem.h"  // for path
 
+#include "BufferedFileWriter.h"  // for BufferedFileWriter
+
 class Settings;
 template <typename T>
 class AudioQueue;
@@ -34,6 +36,9 @@ private:
     Settings& settings;
     AudioQueue<float>& audioQueue;
 
+    /// The encoded file, written by its own thread: the encoding never waits for the disk
+    BufferedFileWriter fileWriter;
+
     std::thread consumerThread{};
     std::atomic<bool> stopConsumer{false};
 };
@@ -1,8 +1,8 @@
 #include "VorbisProducer.h"
 
-#include <algorithm>  // for fill_n, max
+#include <algorithm>  // for fill_n, find_if, max, rotate
 #include <cstdio>     // for size_t, SEEK_CUR, SEEK_SET
-#include <iterator>   // for begin, end
+#include <iterator>   // for begin, end, next
 #include <memory>     // for unique_ptr
 #include <string>     // for string
 #include <utility>    // for move
@@ -17,44 +17,58 @@
 using namespace xoj;
 
 constexpr auto sample_buffer_size = size_t{16384U};
+/// Each one keeps a decoder, which is a few hundred KiB at most
+constexpr size_t MAX_OPENED_FILES = 4;
 
 auto VorbisProducer::start(fs::path const& file, unsigned int timestamp) -> bool {
-    SF_INFO sfInfo{};
-    auto sfFile = audio::make_snd_file(file, SFM_READ, &sfInfo);
-    if (!sfFile) {
-        g_warning("VorbisProducer: input file \"%s\" could not be opened\ncaused by:%s", file.u8string().c_str(),
-                  sf_strerror(sfFile.get()));
-        return false;
+    auto opened = std::find_if(this->openedFiles.begin(), this->openedFiles.end(),
+                               [&](const OpenedFile& f) { return f.path == file; });
+    if (opened == this->openedFiles.end()) {
+        OpenedFile f{file, nullptr, SF_INFO{}};
+        f.file = audio::make_snd_file(file, SFM_READ, &f.info);
+        if (!f.file) {
+            g_warning("VorbisProducer: input file \"%s\" could not be opened\ncaused by:%s", file.u8string().c_str(),
+                      sf_strerror(nullptr));
+            return false;
+        }
+        if (this->openedFiles.size() >= MAX_OPENED_FILES) {
+            this->openedFiles.pop_back();
+        }
+        opened = this->openedFiles.insert(this->openedFiles.begin(), std::move(f));
+    } else {
+        // Most recent first
+        std::rotate(this->openedFiles.begin(), opened, std::next(opened));
+        opened = this->openedFiles.begin();
     }
+    SF_INFO const sfInfo = opened->info;
+    SNDFILE* sfFile = opened->file.get();
 
     sf_count_t seekPosition = sfInfo.samplerate / 1000 * sf_count_t(timestamp);
 
     if (seekPosition < sfInfo.frames) {
-        sf_seek(sfFile.get(), seekPosition, SEEK_SET);
+        sf_seek(sfFile, seekPosition, SEEK_SET);
     } else {
         g_warning("VorbisProducer: Seeking outside of audio file extent");
     }
 
     this->audioQueue.setAudioAttributes(sfInfo.samplerate, static_cast<unsigned int>(sfInfo.channels));
 
-    this->producerThread = std::thread([this, sfInfo, sfFile = std::move(sfFile)] {
+    // The thread is joined before the file is played again (see stop())
+    this->producerThread = std::thread([this, sfInfo, sfFile] {
         sf_count_t numFrames{1};
         size_t const bufferSize{size_t(1024U) * size_t(sfInfo.channels)};
         std::vector<float> sampleBuffer(bufferSize);
-        auto lock = audioQueue.acquire_lock();
 
         while (!this->stopProducer && numFrames > 0 && !this->audioQueue.hasStreamEnded()) {
             sampleBuffer.resize(bufferSize);
-            numFrames = sf_readf_float(sfFile.get(), sampleBuffer.data(), 1024);
+            numFrames = sf_readf_float(sfFile, sampleBuffer.data(), 1024);
             sampleBuffer.resize(size_t(numFrames * sfInfo.channels));
 
-            while (this->audioQueue.size() >= sample_buffer_size && !this->audioQueue.hasStreamEnded() &&
-                   !this->stopProducer) {
-                audioQueue.waitForConsumer(lock);
-            }
+            this->audioQueue.waitUntil(
+                    [this] { return this->audioQueue.size() < sample_buffer_size || this->stopProducer; });
 
             if (auto tmpSeekSeconds = this->seekSeconds.load(); tmpSeekSeconds != 0) {
-                sf_seek(sfFile.get(), tmpSeekSeconds * sfInfo.samplerate, SEEK_CUR);
+                sf_seek(sfFile, tmpSeekSeconds * sfInfo.samplerate, SEEK_CUR);
                 this->seekSeconds -= tmpSeekSeconds;
             }
 
@@ -81,3 +95,5 @@ void VorbisProducer::stop() {
 
 
 void VorbisProducer::seek(int seconds) { this->seekSeconds = seconds; }
+
+void VorbisProducer::closeFiles() { this->openedFiles.clear(); }
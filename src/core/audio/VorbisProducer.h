@@ -13,6 +13,11 @@
 
 #include <atomic>  // for atomic
 #include <thread>  // for thread
+#include <vector>  // for vector
+
+#include <sndfile.h>  // for SF_INFO
+
+#include "audio/SNDFileCpp.h"  // for SNDFileGuard
 
 #include "filesystem.h"  // for path
 
@@ -27,11 +32,24 @@ public:
     void abort();
     void stop();
     void seek(int seconds);
+    /// Close the files kept open. The producer must be stopped.
+    void closeFiles();
 
 private:
     AudioQueue<float>& audioQueue;
     std::thread producerThread{};
 
+    /**
+     * The last files played, kept open, the most recent first: playing one of these recordings from another timestamp
+     * (e.g. clicking another stroke) only seeks, without opening and parsing the file again
+     */
+    struct OpenedFile {
+        fs::path path;
+        xoj::audio::SNDFileGuard file;
+        SF_INFO info{};
+    };
+    std::vector<OpenedFile> openedFiles;
+
     std::atomic<bool> stopProducer{false};
     std::atomic<int> seekSeconds{0};
 };
@@ -111,6 +111,8 @@ void AudioController::continuePlayback() {
 
 void AudioController::stopPlayback() { this->audioPlayer->stop(); }
 
+void AudioController::releasePlayback() { this->audioPlayer->release(); }
+
 auto AudioController::getAudioFilename() const -> fs::path const& { return this->audioFilename; }
 
 auto AudioController::getAudioFolder() const -> fs::path {
@@ -40,6 +40,8 @@ public:
     void pausePlayback();
     void continuePlayback();
     void stopPlayback();
+    /// Stop the playback and close the output stream and the files kept open for the next one
+    void releasePlayback();
     void seekForwards();
     void seekBackwards();
 
@@ -1,8 +1,9 @@
 #include "ClipboardHandler.h"
 
-#include <set>      // for multiset, operator!=
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <functional>  // for function
+#include <set>         // for multiset, operator!=
+#include <utility>     // for move
+#include <vector>      // for vector
 
 #include <cairo-svg.h>      // for cairo_svg_surface_c...
 #include <cairo.h>          // for cairo_create, cairo...
@@ -11,6 +12,7 @@
 
 #include "control/tools/EditSelection.h"          // for EditSelection
 #include "model/Element.h"                        // for Element, ELEMENT_TEXT
+#include "model/ElementContainer.h"               // for ElementContainer
 #include "model/Text.h"                           // for Text
 #include "util/Util.h"                            // for DPI_NORMALIZATION_F...
 #include "util/gtk4_helper.h"                     // for gtk_widget_get_clipboard
@@ -86,21 +88,41 @@ auto ElementCompareFunc(Element* a, Element* b) -> bool {
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents {
+static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * The contents of the clipboard. The image targets are only rendered when another application asks for them, from a
+ * copy of the elements: the selection may be changed or deleted in the meantime.
+ */
+class ClipboardContents: public ElementContainer {
 public:
-    ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str) {
-        this->text = std::move(text);
-        this->image = image;
-        this->svg = std::move(svg);
-        this->str = str;
+    ClipboardContents(string text, GString* str, EditSelection* selection):
+            text(std::move(text)),
+            str(str),
+            x(selection->getOriginalXOnView()),
+            y(selection->getOriginalYOnView()),
+            width(selection->getWidth()),
+            height(selection->getHeight()) {
+        // The points of the strokes are shared, not copied
+        for (Element* e: selection->getElements()) { this->elements.push_back(e->clone()); }
     }
 
     ~ClipboardContents() {
-        g_object_unref(this->image);
+        if (this->image) {
+            g_object_unref(this->image);
+        }
+        if (this->svg) {
+            g_string_free(this->svg, true);
+        }
         g_string_free(this->str, true);
     }
 
+    void forEachElement(std::function<void(Element*)> f) const override {
+        for (auto const& e: this->elements) { f(e.get()); }
+    }
 
     static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection, guint info,
                             ClipboardContents* contents) {
@@ -111,10 +133,11 @@ public:
         } else if (target == gdk_atom_intern_static_string("image/png") ||
                    target == gdk_atom_intern_static_string("image/jpeg") ||
                    target == gdk_atom_intern_static_string("image/gif")) {
-            gtk_selection_data_set_pixbuf(selection, contents->image);
+            gtk_selection_data_set_pixbuf(selection, contents->getImage());
         } else if (atomSvg1 == target || atomSvg2 == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(contents->svg.c_str()),
-                                   static_cast<gint>(contents->svg.length()));
+            GString* svg = contents->getSvg();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(svg->str),
+                                   static_cast<gint>(svg->len));
         } else if (atomXournal == target) {
             gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(contents->str->str),
                                    static_cast<gint>(contents->str->len));
@@ -123,17 +146,68 @@ public:
 
     static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents) { delete contents; }
 
+private:
+    /// Render the PNG image, at 300 DPI, on the first request
+    GdkPixbuf* getImage() {
+        if (this->image) {
+            return this->image;
+        }
+
+        double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
+
+        int w = static_cast<int>(this->width * dpiFactor);
+        int h = static_cast<int>(this->height * dpiFactor);
+        cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
+        cairo_t* crPng = cairo_create(surfacePng);
+        cairo_scale(crPng, dpiFactor, dpiFactor);
+
+        cairo_translate(crPng, -this->x, -this->y);
+
+        xoj::view::ElementContainerView view(this);
+        view.draw(xoj::view::Context::createDefault(crPng));
+
+        cairo_destroy(crPng);
+
+        this->image = gdk_pixbuf_get_from_surface(surfacePng, 0, 0, w, h);
+
+        cairo_surface_destroy(surfacePng);
+        return this->image;
+    }
+
+    /// Render the SVG image on the first request
+    GString* getSvg() {
+        if (this->svg) {
+            return this->svg;
+        }
+
+        this->svg = g_string_sized_new(1048576);  // 1MB
+
+        cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
+                reinterpret_cast<cairo_write_func_t>(svgWriteFunction), this->svg, this->width, this->height);
+        cairo_t* crSVG = cairo_create(surfaceSVG);
+
+        cairo_translate(crSVG, -this->x, -this->y);
+        xoj::view::ElementContainerView view(this);
+        view.draw(xoj::view::Context::createDefault(crSVG));
+
+        cairo_surface_destroy(surfaceSVG);
+        cairo_destroy(crSVG);
+        return this->svg;
+    }
+
 private:
     string text;
-    GdkPixbuf* image;
-    string svg;
     GString* str;
-};
 
-static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
+    std::vector<ElementPtr> elements;
+    double x;
+    double y;
+    double width;
+    double height;
+
+    GdkPixbuf* image = nullptr;
+    GString* svg = nullptr;
+};
 
 auto ClipboardHandler::copy() -> bool {
     if (!this->selection) {
@@ -144,6 +218,7 @@ auto ClipboardHandler::copy() -> bool {
     // prepare xournal contents
     /////////////////////////////////////////////////////////////////
 
+    // Binary encoded: the buffer of the stream is handed to the clipboard as it is
     ObjectOutputStream out(new BinObjectEncoding());
 
     out.writeString(PROJECT_STRING);
@@ -170,46 +245,6 @@ auto ClipboardHandler::copy() -> bool {
         text += t->getText();
     }
 
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: PNG
-    /////////////////////////////////////////////////////////////////
-
-    double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
-
-    int width = static_cast<int>(selection->getWidth() * dpiFactor);
-    int height = static_cast<int>(selection->getHeight() * dpiFactor);
-    cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crPng = cairo_create(surfacePng);
-    cairo_scale(crPng, dpiFactor, dpiFactor);
-
-    cairo_translate(crPng, -selection->getOriginalXOnView(), -selection->getOriginalYOnView());
-
-    xoj::view::ElementContainerView view(this->selection);
-    view.draw(xoj::view::Context::createDefault(crPng));
-
-    cairo_destroy(crPng);
-
-    GdkPixbuf* image = gdk_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
-
-    cairo_surface_destroy(surfacePng);
-
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: SVG
-    /////////////////////////////////////////////////////////////////
-
-    GString* svgString = g_string_sized_new(1048576);  // 1MB
-
-    cairo_surface_t* surfaceSVG =
-            cairo_svg_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString,
-                                                selection->getWidth(), selection->getHeight());
-    cairo_t* crSVG = cairo_create(surfaceSVG);
-
-    cairo_translate(crSVG, -selection->getOriginalXOnView(), -selection->getOriginalYOnView());
-    view.draw(xoj::view::Context::createDefault(crSVG));
-
-    cairo_surface_destroy(surfaceSVG);
-    cairo_destroy(crSVG);
-
     /////////////////////////////////////////////////////////////////
     // copy to clipboard
     /////////////////////////////////////////////////////////////////
@@ -222,7 +257,7 @@ auto ClipboardHandler::copy() -> bool {
     if (!text.empty()) {
         gtk_target_list_add_text_targets(list, 0);
     }
-    // we always copy an image to clipboard
+    // we always copy an image to clipboard, rendered when it is requested
     gtk_target_list_add_image_targets(list, 0, true);
     gtk_target_list_add(list, atomSvg1, 0, 0);
     gtk_target_list_add(list, atomSvg2, 0, 0);
@@ -230,7 +265,7 @@ auto ClipboardHandler::copy() -> bool {
 
     targets = gtk_target_table_new_from_list(list, &n_targets);
 
-    auto* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
+    auto* contents = new ClipboardContents(std::move(text), out.getStr(), this->selection);
 
     gtk_clipboard_set_with_data(this->clipboard, targets, static_cast<guint>(n_targets),
                                 reinterpret_cast<GtkClipboardGetFunc>(ClipboardContents::getFunction),
@@ -240,8 +275,6 @@ auto ClipboardHandler::copy() -> bool {
     gtk_target_table_free(targets, n_targets);
     gtk_target_list_unref(list);
 
-    g_string_free(svgString, true);
-
     return true;
 }
 
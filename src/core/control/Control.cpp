@@ -15,6 +15,10 @@
 #include "control/AudioController.h"                             // for Audi...
 #include "control/ClipboardHandler.h"                            // for Clip...
 #include "control/CompassController.h"                           // for Comp...
+#include "control/DocumentCompactor.h"                           // for Docu...
+#include "control/DocumentMerger.h"                              // for Docu...
+#include "control/DocumentReloader.h"                            // for Docu...
+#include "control/MemoryReport.h"                                // for Memo...
 #include "control/RecentManager.h"                               // for Rece...
 #include "control/ScrollHandler.h"                               // for Scro...
 #include "control/SetsquareController.h"                         // for Sets...
@@ -24,7 +28,11 @@
 #include "control/jobs/AutosaveJob.h"                            // for Auto...
 #include "control/jobs/BaseExportJob.h"                          // for Base...
 #include "control/jobs/CustomExportJob.h"                        // for Cust...
+#include "control/jobs/ImageDecodeJob.h"                         // for Imag...
 #include "control/jobs/PdfExportJob.h"                           // for PdfE...
+#include "control/jobs/PdfPageSizeJob.h"                         // for PdfP...
+#include "control/jobs/PdfTextIndexJob.h"                        // for PdfT...
+#include "control/jobs/RecoveryJournalJob.h"                     // for Reco...
 #include "control/jobs/SaveJob.h"                                // for SaveJob
 #include "control/jobs/Scheduler.h"                              // for JOB_...
 #include "control/jobs/XournalScheduler.h"                       // for Xour...
@@ -37,6 +45,7 @@
 #include "control/settings/SettingsEnums.h"                      // for Button
 #include "control/settings/ViewModes.h"                          // for ViewM..
 #include "control/tools/TextEditor.h"                            // for Text...
+#include "control/xojfile/AutosaveJournal.h"                     // for Auto...
 #include "control/xojfile/LoadHandler.h"                         // for Load...
 #include "control/zoom/ZoomControl.h"                            // for Zoom...
 #include "gui/MainWindow.h"                                      // for Main...
@@ -84,7 +93,10 @@
 #include "pdf/base/XojPdfPage.h"                                 // for XojP...
 #include "plugin/PluginController.h"                             // for Plug...
 #include "undo/AddUndoAction.h"                                  // for AddU...
+#include "undo/AppendDocumentsUndoAction.h"                      // for Appe...
+#include "undo/GroupUndoAction.h"                                // for Grou...
 #include "undo/InsertDeletePageUndoAction.h"                     // for Inse...
+#include "undo/InsertPagesUndoAction.h"                          // for Inse...
 #include "undo/InsertUndoAction.h"                               // for Inse...
 #include "undo/MoveSelectionToLayerUndoAction.h"                 // for Move...
 #include "undo/SwapUndoAction.h"                                 // for SwapUndoAction
@@ -132,12 +144,12 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
 
     this->pageTypes = new PageTypeHandler(gladeSearchPath);
 
-    this->audioController =
-            (disableAudio || this->settings->isAudioDisabled()) ? nullptr : new AudioController(this->settings, this);
+    this->audioEnabled = !disableAudio && !this->settings->isAudioDisabled();
 
     this->scrollHandler = new ScrollHandler(this);
 
     this->scheduler = new XournalScheduler();
+    this->scheduler->setRenderWorkerCount(this->settings->getRenderWorkerCount());
 
     this->doc = new Document(this);
 
@@ -153,13 +165,13 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
     this->toolHandler->loadSettings();
     this->initButtonTool();
 
-    /**
-     * This is needed to update the previews
-     */
-    this->changeTimout = g_timeout_add_seconds(5, xoj::util::wrap_v<checkChangedDocument>, this);
-
     this->pageBackgroundChangeController = std::make_unique<PageBackgroundChangeController>(this);
 
+    this->autosaveJournal = std::make_unique<AutosaveJournal>();
+    // A journal left by a crash is kept until it is restored or discarded, see XournalMain
+    this->recoveryJournal = std::make_unique<RecoveryJournal>(RecoveryJournal::getDefaultPath());
+    setEmergencyJournal(this->recoveryJournal.get());
+
     this->layerController = new LayerController(this);
     this->layerController->registerListener(this);
 
@@ -168,8 +180,19 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath, bool di
 }
 
 Control::~Control() {
-    g_source_remove(this->changeTimout);
+    if (this->changeTimout != 0) {
+        g_source_remove(this->changeTimout);
+    }
     this->enableAutosave(false);
+    if (this->recoveryTimeout != 0) {
+        g_source_remove(this->recoveryTimeout);
+    }
+    if (this->fileChangedTimeout != 0) {
+        g_source_remove(this->fileChangedTimeout);
+    }
+    if (this->fileMonitor) {
+        g_file_monitor_cancel(this->fileMonitor.get());
+    }
 
     deleteLastAutosaveFile();
     this->scheduler->stop();
@@ -187,6 +210,8 @@ Control::~Control() {
     this->toolHandler = nullptr;
     delete this->sidebar;
     this->sidebar = nullptr;
+    this->recoveryJournal->stop();
+    setEmergencyJournal(nullptr);
     delete this->doc;
     this->doc = nullptr;
     delete this->searchBar;
@@ -233,6 +258,7 @@ void Control::deleteLastAutosaveFile() {
     try {
         if (fs::exists(this->lastAutosaveFilename)) {
             fs::remove(this->lastAutosaveFilename);
+            fs::remove(AutosaveJournal::getJournalPath(this->lastAutosaveFilename));
         }
     } catch (const fs::filesystem_error& e) {
         auto fmtstr = FS(_F("Could not remove old autosave file \"{1}\": {2}") % this->lastAutosaveFilename.string() %
@@ -242,6 +268,181 @@ void Control::deleteLastAutosaveFile() {
     this->lastAutosaveFilename.clear();
 }
 
+auto Control::getAutosaveJournal() const -> AutosaveJournal* { return this->autosaveJournal.get(); }
+
+auto Control::getRecoveryJournal() const -> RecoveryJournal* { return this->recoveryJournal.get(); }
+
+void Control::startRecoveryJournal(const fs::path& file, RecoveryJournal::Baseline baseline) {
+    this->recoveryJournal->start(file, std::move(baseline));
+    // The changes made since the baseline
+    scheduleRecoveryRecord();
+}
+
+void Control::startRecoveryJournal() {
+    this->doc->lock();
+    auto filepath = this->doc->getFilepath();
+    auto baseline = RecoveryJournal::captureBaseline(this->doc);
+    this->doc->unlock();
+
+    startRecoveryJournal(filepath, std::move(baseline));
+}
+
+void Control::recoverFromJournal(RecoveryJournal::Recovery recovery, std::function<void(bool)> callback) {
+    auto filepath = recovery.documentFile;
+    this->pendingRecovery = std::move(recovery);
+    openFileWithoutSavingTheCurrentDocument(std::move(filepath), false, -1, std::move(callback));
+}
+
+auto Control::recoveryJournalCallback(Control* control) -> bool {
+    control->recoveryTimeout = 0;
+
+    auto* job = new RecoveryJournalJob(control);
+    control->scheduler->addJob(job, JOB_PRIORITY_NONE);
+    job->unref();
+
+    return false;
+}
+
+void Control::scheduleRecoveryRecord() {
+    // The changes until the timeout are recorded together
+    if (this->recoveryTimeout == 0 && this->recoveryJournal->isActive()) {
+        this->recoveryTimeout = g_timeout_add_seconds(RecoveryJournal::RECORD_DELAY,
+                                                      xoj::util::wrap_v<recoveryJournalCallback>, this);
+    }
+}
+
+void Control::watchDocumentFile() {
+    if (this->fileMonitor) {
+        g_file_monitor_cancel(this->fileMonitor.get());
+        this->fileMonitor.reset();
+    }
+
+    this->doc->lock();
+    auto filepath = this->doc->getFilepath();
+    this->doc->unlock();
+
+    std::error_code ec;
+    this->knownFileTime = filepath.empty() ? fs::file_time_type{} : fs::last_write_time(filepath, ec);
+    if (filepath.empty() || ec) {
+        return;
+    }
+
+    auto file = Util::toGFile(filepath);
+    this->fileMonitor.reset(g_file_monitor_file(file.get(), G_FILE_MONITOR_NONE, nullptr, nullptr), xoj::util::adopt);
+    if (!this->fileMonitor) {
+        return;
+    }
+    g_signal_connect(this->fileMonitor.get(), "changed",
+                     G_CALLBACK(+[](GFileMonitor*, GFile*, GFile*, GFileMonitorEvent event, gpointer self) {
+                         if (event != G_FILE_MONITOR_EVENT_CHANGED &&
+                             event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT &&
+                             event != G_FILE_MONITOR_EVENT_CREATED) {
+                             return;
+                         }
+                         // Wait until the file is entirely written (or synced)
+                         auto* ctrl = static_cast<Control*>(self);
+                         if (ctrl->fileChangedTimeout != 0) {
+                             g_source_remove(ctrl->fileChangedTimeout);
+                         }
+                         ctrl->fileChangedTimeout =
+                                 g_timeout_add(1000, xoj::util::wrap_v<documentFileChangedCallback>, ctrl);
+                     }),
+                     this);
+}
+
+auto Control::documentFileChangedCallback(Control* control) -> bool {
+    if (control->isBlocking) {
+        // The file may be saved by us: its new modification time is known once the save is done
+        return true;
+    }
+    control->fileChangedTimeout = 0;
+
+    control->doc->lock();
+    auto filepath = control->doc->getFilepath();
+    control->doc->unlock();
+
+    std::error_code ec;
+    const auto time = fs::last_write_time(filepath, ec);
+    if (ec || time == control->knownFileTime) {
+        return false;
+    }
+    control->knownFileTime = time;
+
+    if (!control->undoRedo->isChanged()) {
+        control->reloadFromDisk();
+        return false;
+    }
+
+    enum { RELOAD = 1, KEEP };
+    std::vector<XojMsgBox::Button> buttons = {{_("Reload"), RELOAD}, {_("Keep my version"), KEEP}};
+    XojMsgBox::askQuestion(control->getGtkWindow(),
+                           FS(_F("\"{1}\" was changed by another program") % filepath.filename().u8string()),
+                           _("Reload it from the disk? The changes made here since the last save would be lost."),
+                           buttons, [control](int response) {
+                               if (response == RELOAD) {
+                                   control->reloadFromDisk();
+                               }
+                           });
+    return false;
+}
+
+void Control::reloadFromDisk() {
+    this->doc->lock();
+    auto filepath = this->doc->getFilepath();
+    auto pdfFilepath = this->doc->getPdfFilepath();
+    bool attachPdf = this->doc->isAttachPdf();
+    this->doc->unlock();
+
+    LoadHandler loadHandler;
+    loadHandler.setLazyPageLoading(settings->isLazyPageLoading());
+    std::unique_ptr<Document> loaded(loadHandler.loadDocument(filepath));
+    if (!loaded) {
+        // The file may be partially synced: it is reloaded on its next change
+        g_warning("Could not reload \"%s\": %s", filepath.u8string().c_str(), loadHandler.getLastError().c_str());
+        return;
+    }
+
+    clearSelectionEndText();
+    if (this->geometryToolController) {
+        resetGeometryTool();
+    }
+    const size_t currentPage = getCurrentPageNo();
+
+    if (loaded->getPdfFilepath() != pdfFilepath || loaded->isAttachPdf() != attachPdf) {
+        // The pages refer to another background PDF
+        replaceDocument(std::move(loaded), static_cast<int>(currentPage));
+        return;
+    }
+
+    std::vector<PageRef> pages;
+    pages.reserve(loaded->getPageCount());
+    for (size_t n = 0; n < loaded->getPageCount(); n++) {
+        pages.push_back(loaded->getPage(n));
+    }
+    this->doc->lock();
+    // The unloaded pages would be read from the file as it was opened, if it was mapped: they are replaced
+    auto current = DocumentReloader::hashPages(*this->doc, true);
+    auto hashes = DocumentReloader::hashPages(*loaded, false);
+    this->doc->unlock();
+
+    const size_t inserted = DocumentReloader::apply(*this->doc, *this, pages, DocumentReloader::match(current, hashes));
+    g_message("Reloaded \"%s\": %zu of %zu pages changed", filepath.u8string().c_str(), inserted, pages.size());
+
+    this->recoveryJournal->stop();
+    this->undoRedo->clearContents();
+    this->undoRedo->documentSaved();
+    this->undoRedoChanged();
+
+    this->layerController->fireRebuildLayerMenu();
+    updatePageActions();
+    updateWindowTitle();
+    getCursor()->updateCursor();
+    if (currentPage < pages.size()) {
+        scrollHandler->scrollToPage(currentPage);
+    }
+    startRecoveryJournal();
+}
+
 auto Control::checkChangedDocument(Control* control) -> bool {
     if (!control->doc->tryLock()) {
         // call again later
@@ -258,8 +459,9 @@ auto Control::checkChangedDocument(Control* control) -> bool {
     control->changedPages.clear();
     control->doc->unlock();
 
-    // Call again
-    return true;
+    // Started again by the next change
+    control->changeTimout = 0;
+    return false;
 }
 
 void Control::saveSettings() {
@@ -827,6 +1029,10 @@ void Control::insertNewPage(size_t position, bool shouldScrollToPage) {
     pageBackgroundChangeController->insertNewPage(position, shouldScrollToPage);
 }
 
+void Control::insertNewPages(size_t position, size_t count, bool shouldScrollToPage) {
+    pageBackgroundChangeController->insertNewPages(position, count, shouldScrollToPage);
+}
+
 void Control::appendNewPdfPages() {
     auto pageCount = this->doc->getPageCount();
     // find last page with pdf background and get its pdf page number
@@ -846,6 +1052,8 @@ void Control::appendNewPdfPages() {
         string msg = FS(_F("No pdf pages available to append. You may need to reopen the document first."));
         XojMsgBox::showErrorToUser(getGtkWindow(), msg);
     }
+    std::vector<PageRef> newPages;
+    newPages.reserve(insertCount);
     for (size_t i = 0; i != insertCount; ++i) {
 
         doc->lock();
@@ -855,12 +1063,14 @@ void Control::appendNewPdfPages() {
         if (pdf) {
             auto newPage = std::make_shared<XojPage>(pdf->getWidth(), pdf->getHeight());
             newPage->setBackgroundPdfPageNr(currentPdfPageCount + i);
-            insertPage(newPage, pageCount + i);
+            newPages.emplace_back(std::move(newPage));
         } else {
             string msg = FS(_F("Unable to retrieve pdf page."));  // should not happen
             XojMsgBox::showErrorToUser(getGtkWindow(), msg);
         }
     }
+    // One update of the layout and of the sidebar for all the pages
+    insertPages(newPages, pageCount);
 }
 
 void Control::insertPage(const PageRef& page, size_t position, bool shouldScrollToPage) {
@@ -885,6 +1095,32 @@ void Control::insertPage(const PageRef& page, size_t position, bool shouldScroll
     undoRedo->addUndoAction(std::make_unique<InsertDeletePageUndoAction>(page, position, true));
 }
 
+void Control::insertPages(const std::vector<PageRef>& pages, size_t position, bool shouldScrollToPage) {
+    if (pages.size() <= 1) {
+        if (!pages.empty()) {
+            insertPage(pages.front(), position, shouldScrollToPage);
+        }
+        return;
+    }
+
+    this->doc->lock();
+    this->doc->insertPages(pages.begin(), pages.end(), position);
+    this->doc->unlock();
+
+    // the views of all the pages are created before the layout is recalculated once
+    firePagesInserted(position, pages.size());
+
+    getCursor()->updateCursor();
+
+    if (shouldScrollToPage) {
+        scrollHandler->scrollToPage(position);
+        firePageSelected(position);
+    }
+
+    updatePageActions();
+    undoRedo->addUndoAction(std::make_unique<InsertPagesUndoAction>(pages, position));
+}
+
 void Control::gotoPage() {
     auto popup = xoj::popup::PopupWindowWrapper<xoj::popup::GotoDialog>(
             this->gladeSearchPath, this->getCurrentPageNo(), this->doc->getPageCount(),
@@ -964,6 +1200,37 @@ void Control::changePageBackgroundColor() {
     dlg.show(GTK_WINDOW(this->win->getWindow()));
 }
 
+void Control::compactDocument() {
+    clearSelectionEndText();
+
+    enum { COMPACT = 1, COMPACT_DROP_WHITEOUT, CANCEL };
+    std::vector<XojMsgBox::Button> buttons = {{_("Compact"), COMPACT},
+                                              {_("Compact and drop the useless whiteout"), COMPACT_DROP_WHITEOUT},
+                                              {_("Cancel"), CANCEL}};
+    XojMsgBox::askQuestion(
+            getGtkWindow(), _("Compact the document?"),
+            _("The strokes are merged and simplified within a tolerance, and the empty layers without a name are "
+              "removed. The whiteout strokes which erase nothing on plain pages can be dropped too. This can be "
+              "undone."),
+            buttons, [ctrl = this](int response) {
+                if (response != COMPACT && response != COMPACT_DROP_WHITEOUT) {
+                    return;
+                }
+                DocumentCompactor::Options options;
+                options.dropUselessWhiteout = response == COMPACT_DROP_WHITEOUT;
+                DocumentCompactor::Report report;
+                auto undo = DocumentCompactor(options).compact(*ctrl->doc, *ctrl, report);
+                if (undo) {
+                    ctrl->undoRedo->addUndoAction(std::move(undo));
+                    if (report.removedLayers > 0) {
+                        ctrl->getLayerController()->fireRebuildLayerMenu();
+                    }
+                }
+                XojMsgBox::showMessageToUser(ctrl->getGtkWindow(), _("Document compacted"), report.describe(),
+                                             GTK_MESSAGE_INFO);
+            });
+}
+
 void Control::setViewPairedPages(bool enabled) {
     settings->setShowPairedPages(enabled);
     win->getXournal()->layoutPages();
@@ -1092,12 +1359,18 @@ void Control::undoRedoChanged() {
     win->setRedoDescription(undoRedo->redoDescription());
 
     updateWindowTitle();
+    scheduleRecoveryRecord();
 }
 
 void Control::undoRedoPageChanged(PageRef page) {
     if (std::find(begin(this->changedPages), end(this->changedPages), page) == end(this->changedPages)) {
         this->changedPages.emplace_back(std::move(page));
     }
+    // The changes until the timeout (e.g. the next strokes, or the steps of a drag) are handled together
+    if (this->changeTimout == 0) {
+        this->changeTimout = g_timeout_add(settings->getPreviewUpdateDelay(), xoj::util::wrap_v<checkChangedDocument>,
+                                           this);
+    }
 }
 
 void Control::selectTool(ToolType type) {
@@ -1123,6 +1396,8 @@ void Control::selectTool(ToolType type) {
 }
 
 void Control::selectDefaultTool() {
+    // One notification for the tool, its size, color and line style
+    ToolHandler::ChangeBatch batch(*toolHandler);
     ButtonConfig* cfg = settings->getButtonConfig(Button::BUTTON_DEFAULT);
     cfg->applyConfigToToolbarTool(toolHandler);
 
@@ -1162,7 +1437,7 @@ void Control::toolChanged() {
     bool enableSize = toolHandler->hasCapability(TOOL_CAP_SIZE);
     this->actionDB->enableAction(Action::TOOL_SIZE, enableSize);
     if (enableSize) {
-        toolSizeChanged();
+        updateToolSizeActions();
     }
 
     // Set or reset the lineStyle
@@ -1179,9 +1454,10 @@ void Control::toolChanged() {
     this->actionDB->enableAction(Action::TOOL_COLOR, enableColor);
     this->actionDB->enableAction(Action::SELECT_COLOR, enableColor);
     if (enableColor) {
-        toolColorChanged();
+        updateToolColorActions();
     }
 
+    // Once, for the tool, its size and its color
     getCursor()->updateCursor();
 
     if (type != TOOL_TEXT) {
@@ -1207,6 +1483,11 @@ void Control::highlighterSizeChanged() {
 }
 
 void Control::toolSizeChanged() {
+    updateToolSizeActions();
+    getCursor()->updateCursor();
+}
+
+void Control::updateToolSizeActions() {
     if (toolHandler->getToolType() == TOOL_PEN) {
         penSizeChanged();
     } else if (toolHandler->getToolType() == TOOL_ERASER) {
@@ -1216,8 +1497,6 @@ void Control::toolSizeChanged() {
     }
 
     this->actionDB->setActionState(Action::TOOL_SIZE, toolHandler->getSize());
-
-    getCursor()->updateCursor();
 }
 
 void Control::toolFillChanged() {
@@ -1273,10 +1552,14 @@ auto Control::getLineStyleToSelect() -> std::optional<string> const {
 }
 
 void Control::toolColorChanged() {
-    this->actionDB->setActionState(Action::TOOL_COLOR, getToolHandler()->getColorMaskAlpha());
+    updateToolColorActions();
     getCursor()->updateCursor();
 }
 
+void Control::updateToolColorActions() {
+    this->actionDB->setActionState(Action::TOOL_COLOR, getToolHandler()->getColorMaskAlpha());
+}
+
 void Control::changeColorOfSelection() {
     if (this->win && toolHandler->hasCapability(TOOL_CAP_COLOR)) {
         EditSelection* sel = this->win->getXournal()->getSelection();
@@ -1470,6 +1753,7 @@ void Control::replaceDocument(std::unique_ptr<Document> doc, int scrollToPage) {
 
 void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<void(bool)> callback) {
     LoadHandler loadHandler;
+    loadHandler.setLazyPageLoading(settings->isLazyPageLoading());
     std::unique_ptr<Document> doc(loadHandler.loadDocument(filepath));
 
     if (!doc) {
@@ -1479,6 +1763,26 @@ void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<vo
         return;
     }
 
+    std::string journalError;
+    if (!AutosaveJournal::apply(doc.get(), filepath, journalError)) {
+        string msg = FS(_F("The pages modified since the last full autosave could not be restored from \"{1}\"") %
+                        AutosaveJournal::getJournalPath(filepath).u8string()) +
+                     "\n" + journalError;
+        XojMsgBox::showErrorToUser(this->getGtkWindow(), msg);
+    }
+
+    if (auto recovery = std::exchange(this->pendingRecovery, std::nullopt); recovery) {
+        auto baseline = RecoveryJournal::captureBaseline(doc.get());
+        std::string recoveryError;
+        if (RecoveryJournal::apply(doc.get(), *recovery, recoveryError)) {
+            this->recoveredBaseline = std::move(baseline);
+        } else {
+            string msg = FS(_F("The changes to \"{1}\" could not be recovered") % filepath.u8string()) + "\n" +
+                         recoveryError;
+            XojMsgBox::showErrorToUser(this->getGtkWindow(), msg);
+        }
+    }
+
     std::optional<MissingPdfData> missingPdf;
     if (!loadHandler.getMissingPdfFilename().empty() || loadHandler.isAttachedPdfMissing()) {
         missingPdf = {loadHandler.isAttachedPdfMissing(), loadHandler.getMissingPdfFilename()};
@@ -1518,9 +1822,11 @@ void Control::openXoppFile(fs::path filepath, int scrollToPage, std::function<vo
 bool Control::openPdfFile(fs::path filepath, bool attachToDocument, int scrollToPage) {
     this->getCursor()->setCursorBusy(true);
     auto doc = std::make_unique<Document>(this);
-    bool success = doc->readPdf(filepath, /*initPages=*/true, attachToDocument);
+    // Huge pdfs are shown at once: the sizes of the pages are read in the background
+    bool success = doc->readPdf(filepath, /*initPages=*/true, attachToDocument, {}, /*placeholderPageSizes=*/true);
     if (success) {
         this->replaceDocument(std::move(doc), scrollToPage);
+        PdfPageSizeJob::measureDocument(this);
     } else {
         std::string msg = FS(_F("Error reading PDF file \"{1}\"\n{2}") % filepath.u8string() % doc->getLastErrorMsg());
         XojMsgBox::showErrorToUser(this->getGtkWindow(), msg);
@@ -1593,7 +1899,7 @@ void Control::fileLoaded(int scrollToPage) {
     this->doc->unlock();
 
     if (!filepath.empty()) {
-        MetadataEntry md = MetadataManager::getForFile(filepath);
+        MetadataEntry md = this->metadata->getForFile(filepath);
         if (!md.valid) {
             md.zoom = -1;
             md.page = 0;
@@ -1614,6 +1920,20 @@ void Control::fileLoaded(int scrollToPage) {
     win->getXournal()->forceUpdatePagenumbers();
     getCursor()->updateCursor();
     updatePageActions();
+
+    // Extract the text of the pdf in the background, for the search
+    PdfTextIndexJob::indexDocument(this->doc, this->scheduler);
+
+    if (auto baseline = std::exchange(this->recoveredBaseline, std::nullopt); baseline) {
+        // The recovered changes are recorded again, against the file as saved
+        this->doc->lock();
+        auto docPath = this->doc->getFilepath();
+        this->doc->unlock();
+        startRecoveryJournal(docPath, std::move(*baseline));
+    } else {
+        startRecoveryJournal();
+    }
+    watchDocumentFile();
 }
 
 enum class MissingPdfDialogOptions : gint { USE_PROPOSED, SELECT_OTHER, REMOVE, CANCEL };
@@ -1747,9 +2067,42 @@ void Control::askToAnnotatePdf() {
     });
 }
 
+void Control::askToAppendDocument() {
+    xoj::OpenDlg::showAppendDocumentDialog(getGtkWindow(), this->settings, [ctrl = this](fs::path path) {
+        if (!path.empty()) {
+            ctrl->appendDocuments({std::move(path)});
+        }
+    });
+}
+
+void Control::appendDocuments(const std::vector<fs::path>& files) {
+    clearSelectionEndText();
+    getCursor()->setCursorBusy(true);
+    auto result = DocumentMerger::append(*this->doc, *this, files);
+    getCursor()->setCursorBusy(false);
+
+    if (!result.pages.empty()) {
+        if (result.pdfChanged) {
+            // Extract the text of the new pdf in the background, for the search
+            PdfTextIndexJob::indexDocument(this->doc, this->scheduler);
+        }
+        this->undoRedo->addUndoAction(std::make_unique<AppendDocumentsUndoAction>(result.pages, result.first));
+        updatePageActions();
+        getCursor()->updateCursor();
+        scrollHandler->scrollToPage(result.first);
+    }
+    if (!result.errors.empty()) {
+        std::string msg = _("Some documents could not be appended:");
+        for (const auto& error: result.errors) {
+            msg += "\n" + error;
+        }
+        XojMsgBox::showErrorToUser(getGtkWindow(), msg);
+    }
+}
+
 void Control::print() {
     this->doc->lock();
-    PrintHandler::print(this->doc, getCurrentPageNo(), this->getGtkWindow());
+    PrintHandler::print(this->doc, getCurrentPageNo(), this->getGtkWindow(), this->settings->getPrintLookAhead());
     this->doc->unlock();
 }
 
@@ -1942,14 +2295,15 @@ void Control::saveImpl(bool saveAs, std::function<void(bool)> callback) {
     }
 }
 
-void Control::resetSavedStatus() {
+void Control::resetSavedStatus(UndoAction* lastSavedAction) {
     this->doc->lock();
     auto filepath = this->doc->getFilepath();
     this->doc->unlock();
 
-    this->undoRedo->documentSaved();
+    this->undoRedo->documentSaved(lastSavedAction);
     RecentManager::addRecentFileFilename(filepath);
     this->updateWindowTitle();
+    watchDocumentFile();
 }
 
 void Control::quit(bool allowCancel) {
@@ -1970,7 +2324,7 @@ void Control::quit(bool allowCancel) {
             this->scheduler->unlock();
             this->scheduler->stop();  // Finish current task. Must be called to finish pending saves.
             this->closeDocument();    // Must be done after all jobs has finished (Segfault on save/export)
-            settings->save();
+            settings->flush();
             g_application_quit(G_APPLICATION(gtkApp));
         }
     };
@@ -2020,6 +2374,11 @@ void Control::close(std::function<void(bool)> callback, const bool allowDestroy,
 }
 
 void Control::closeDocument() {
+    this->recoveryJournal->stop();
+    if (this->audioController) {
+        // The recordings of the document are not played anymore
+        this->audioController->releasePlayback();
+    }
     this->undoRedo->clearContents();
 
     this->doc->lock();
@@ -2045,6 +2404,13 @@ void Control::showAbout() {
     popup.show(GTK_WINDOW(this->win->getWindow()));
 }
 
+void Control::showMemoryReport() {
+    const MemoryReport report = MemoryReport::collect(this);
+    g_message("%s", report.toString().c_str());
+    // The full list of the pages is in the log
+    XojMsgBox::showMessageToUser(getGtkWindow(), _("Memory Report"), report.toString(20), GTK_MESSAGE_INFO);
+}
+
 auto Control::loadViewMode(ViewModeId mode) -> bool {
     if (!settings->loadViewMode(mode)) {
         return false;
@@ -2112,6 +2478,8 @@ void Control::clipboardPasteImage(GdkPixbuf* img) {
     image->setWidth(scaledWidth);
     image->setHeight(scaledHeight);
 
+    // The pixbuf was encoded to PNG: the surface is decoded from the PNG data off the UI thread
+    ImageDecodeJob::decode(this, *image, page);
     clipboardPaste(std::move(image));
 }
 
@@ -2408,7 +2776,14 @@ auto Control::getSidebar() const -> Sidebar* { return this->sidebar; }
 
 auto Control::getSearchBar() const -> SearchBar* { return this->searchBar; }
 
-auto Control::getAudioController() const -> AudioController* { return this->audioController; }
+auto Control::getAudioController() -> AudioController* {
+    if (!this->audioController && this->audioEnabled) {
+        this->audioController = new AudioController(this->settings, this);
+    }
+    return this->audioController;
+}
+
+auto Control::isAudioEnabled() const -> bool { return this->audioEnabled; }
 
 auto Control::getPageTypes() const -> PageTypeHandler* { return this->pageTypes; }
 
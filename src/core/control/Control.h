@@ -22,22 +22,25 @@
 #include <glib.h>                   // for guint
 #include <gtk/gtk.h>                // for GtkLabel
 
-#include "control/ToolEnums.h"              // for ToolSize, ToolType
-#include "control/jobs/ProgressListener.h"  // for ProgressListener
-#include "control/settings/ViewModes.h"     // for ViewModeId
-#include "control/tools/EditSelection.h"    // for OrderChange
-#include "enums/Action.enum.h"              // for Action
-#include "model/DocumentHandler.h"          // for DocumentHandler
-#include "model/DocumentListener.h"         // for DocumentListener
-#include "model/GeometryTool.h"             // for GeometryTool
-#include "model/PageRef.h"                  // for PageRef
-#include "undo/UndoRedoHandler.h"           // for UndoRedoHandler (ptr only)
+#include "control/ToolEnums.h"                // for ToolSize, ToolType
+#include "control/jobs/ProgressListener.h"    // for ProgressListener
+#include "control/settings/ViewModes.h"       // for ViewModeId
+#include "control/tools/EditSelection.h"      // for OrderChange
+#include "control/xojfile/RecoveryJournal.h"  // for RecoveryJournal
+#include "enums/Action.enum.h"                // for Action
+#include "model/DocumentHandler.h"            // for DocumentHandler
+#include "model/DocumentListener.h"           // for DocumentListener
+#include "model/GeometryTool.h"               // for GeometryTool
+#include "model/PageRef.h"                    // for PageRef
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler (ptr only)
+#include "util/raii/GObjectSPtr.h"            // for GObjectSPtr
 
 #include "ClipboardHandler.h"  // for ClipboardListener
 #include "ToolHandler.h"       // for ToolListener
 #include "filesystem.h"        // for path
 
 class LoadHandler;
+class AutosaveJournal;
 class GeometryToolController;
 class AudioController;
 class FullscreenHandler;
@@ -102,6 +105,14 @@ public:
             bool forceOpen = false);
     /// Shows an open file dialog and opens the selected file
     void askToAnnotatePdf();
+    /// Shows an open file dialog and appends the selected document
+    void askToAppendDocument();
+
+    /**
+     * Append the pages of the documents at the end of the current one, as one undo action (see DocumentMerger). The
+     * documents which cannot be appended are reported to the user.
+     */
+    void appendDocuments(const std::vector<fs::path>& files);
 
     /**
      * (Potentially asynchronously) Opens the given file without saving any previously opened Document. Calls callback
@@ -128,8 +139,15 @@ public:
 
     /**
      * Marks the current document as saved if it is currently marked as unsaved.
+     * @param lastSavedAction The last undo action when the document was saved, see UndoRedoHandler::getLastAction()
      */
-    void resetSavedStatus();
+    void resetSavedStatus(UndoAction* lastSavedAction);
+
+    /**
+     * Load the file of the document again, after it was changed by another program. Only the pages which changed are
+     * replaced: the others keep their views and previews. The changes since the last save are lost.
+     */
+    void reloadFromDisk();
 
     /**
      * Close the current document, prompting to save unsaved changes.
@@ -149,6 +167,10 @@ public:
 
     // Menu Help
     void showAbout();
+    /**
+     * Show the memory used by each pool (see MemoryReport), and write it to the log
+     */
+    void showMemoryReport();
 
     /**
      * @brief Update the Cursor and the Toolbar based on the active color
@@ -203,6 +225,10 @@ public:
     void paperTemplate();
     void paperFormat();
     void changePageBackgroundColor();
+    /**
+     * Compact the document (see DocumentCompactor), once the user confirmed it
+     */
+    void compactDocument();
     void updateBackgroundSizeButton();
 
     /**
@@ -231,8 +257,14 @@ public:
     void addDefaultPage(const std::optional<std::string>& pageTemplate, Document* doc = nullptr);
     void duplicatePage();
     void insertNewPage(size_t position, bool shouldScrollToPage = true);
+    /// Insert count new pages at once (see PageBackgroundChangeController::insertNewPages())
+    void insertNewPages(size_t position, size_t count, bool shouldScrollToPage = true);
     void appendNewPdfPages();
     void insertPage(const PageRef& page, size_t position, bool shouldScrollToPage = true);
+    /**
+     * Insert consecutive pages before the page at position, with one update of the views and one undo action
+     */
+    void insertPages(const std::vector<PageRef>& pages, size_t position, bool shouldScrollToPage = true);
     void deletePage();
     void movePageTowardsBeginning();
     void movePageTowardsEnd();
@@ -291,6 +323,25 @@ public:
 
     void setLastAutosaveFile(fs::path newAutosaveFile);
     void deleteLastAutosaveFile();
+    AutosaveJournal* getAutosaveJournal() const;
+    RecoveryJournal* getRecoveryJournal() const;
+
+    /**
+     * Start recording the changes of the document in the recovery journal
+     * @param file The file the document was saved to
+     * @param baseline The pages of the document, as saved
+     */
+    void startRecoveryJournal(const fs::path& file, RecoveryJournal::Baseline baseline);
+
+    /**
+     * Start recording the changes of the document, as it is now, in the recovery journal
+     */
+    void startRecoveryJournal();
+
+    /**
+     * Open the file of a recovery journal left by a crash, with the recorded changes
+     */
+    void recoverFromJournal(RecoveryJournal::Recovery recovery, std::function<void(bool)> callback);
     void setClipboardHandlerSelection(EditSelection* selection);
 
     void addChangedDocumentListener(DocumentListener* dl);
@@ -310,7 +361,12 @@ public:
     XournalppCursor* getCursor() const;
     Sidebar* getSidebar() const;
     SearchBar* getSearchBar() const;
-    AudioController* getAudioController() const;
+    /**
+     * The audio controller, created on first use since it enumerates the audio devices
+     * @return nullptr if audio is disabled
+     */
+    AudioController* getAudioController();
+    bool isAudioEnabled() const;
     PageTypeHandler* getPageTypes() const;
     PageBackgroundChangeController* getPageBackgroundChangeController() const;
     LayerController* getLayerController() const;
@@ -370,9 +426,24 @@ protected:
     void eraserSizeChanged();
     void penSizeChanged();
     void highlighterSizeChanged();
+    /// The action states of toolSizeChanged() and toolColorChanged(), without updating the cursor
+    void updateToolSizeActions();
+    void updateToolColorActions();
 
     static bool checkChangedDocument(Control* control);
+    static bool documentFileChangedCallback(Control* control);
+
+    /**
+     * Watch the file of the document (after it is loaded or saved), to reload it when another program changes it
+     */
+    void watchDocumentFile();
     static bool autosaveCallback(Control* control);
+    static bool recoveryJournalCallback(Control* control);
+
+    /**
+     * Record the changes in the recovery journal, a few seconds later
+     */
+    void scheduleRecoveryRecord();
 
     /**
      * Load metadata later, md will be deleted
@@ -475,7 +546,8 @@ private:
 
     ScrollHandler* scrollHandler;
 
-    AudioController* audioController;
+    AudioController* audioController = nullptr;
+    bool audioEnabled;
 
     ToolbarDragDropHandler* dragDropHandler = nullptr;
 
@@ -487,9 +559,10 @@ private:
     XournalppCursor* cursor;
 
     /**
-     * Timeout id: the timeout watches the changes and actualizes the previews from time to time
+     * Timeout id: the timeout is started by the first change and actualizes the previews of all the pages changed
+     * until then (see Settings::getPreviewUpdateDelay()). 0 if no change is pending.
      */
-    guint changeTimout;
+    guint changeTimout = 0;
 
     /**
      * The pages wihch has changed since the last update (for preview update)
@@ -511,6 +584,24 @@ private:
      */
     guint autosaveTimeout = 0;
     fs::path lastAutosaveFilename;
+    std::unique_ptr<AutosaveJournal> autosaveJournal;
+
+    /**
+     * The changes since the last save, for a crash recovery
+     */
+    std::unique_ptr<RecoveryJournal> recoveryJournal;
+    guint recoveryTimeout = 0;
+    /// The changes to apply to the next file opened, and the pages as saved
+    std::optional<RecoveryJournal::Recovery> pendingRecovery;
+    std::optional<RecoveryJournal::Baseline> recoveredBaseline;
+
+    /**
+     * Watches the file of the document. Its events set a timeout, so that the file is reloaded once written.
+     */
+    xoj::util::GObjectSPtr<GFileMonitor> fileMonitor;
+    guint fileChangedTimeout = 0;
+    /// The modification time of the file of the document when it was last loaded or saved
+    fs::file_time_type knownFileTime{};
 
     XournalScheduler* scheduler;
 
@@ -1,20 +1,24 @@
 #include "CrashHandler.h"
 
 #include <sstream>
-#include <string>  // for string
+#include <string>        // for string
+#include <system_error>  // for error_code
 
 #include <glib.h>  // for g_warning, g_error
 
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "util/PathUtil.h"                // for getConfigFile
-#include "util/i18n.h"                    // for FC, _F, _
+#include "control/xojfile/RecoveryJournal.h"  // for RecoveryJournal
+#include "control/xojfile/SaveHandler.h"      // for SaveHandler
+#include "util/PathUtil.h"                    // for getConfigFile
+#include "util/i18n.h"                        // for FC, _F, _
 
 #include "filesystem.h"  // for path
 
 static Document* document = nullptr;
+static RecoveryJournal* journal = nullptr;
 static std::stringstream logBuffer;
 
 void setEmergencyDocument(Document* doc) { document = doc; }
+void setEmergencyJournal(RecoveryJournal* j) { journal = j; }
 [[maybe_unused]] static std::stringstream* getCrashHandlerLogBuffer() { return &logBuffer; }
 
 #ifdef _WIN32
@@ -28,13 +32,19 @@ void emergencySave() {
         return;
     }
 
+    std::error_code ec;
+    if (journal && journal->keepForRecovery() && fs::exists(journal->getFile(), ec)) {
+        g_warning("%s", FC(_F("The changes to the current document are kept in \"{1}\"") %
+                           journal->getFile().string()));
+        return;
+    }
+
     g_warning("%s", _("Trying to emergency save the current open document..."));
 
     auto const& filepath = Util::getConfigFile("emergencysave.xopp");
 
     SaveHandler handler;
-    handler.prepareSave(document);
-    handler.saveTo(filepath);
+    handler.saveDocument(document, filepath);
 
     if (!handler.getErrorMessage().empty()) {
         g_error("%s", FC(_F("Error: {1}") % handler.getErrorMessage()));
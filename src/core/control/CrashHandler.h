@@ -12,6 +12,9 @@
 #pragma once
 
 class Document;
+class RecoveryJournal;
 void setEmergencyDocument(Document* doc);
+/// The changes recorded in the journal are not saved again by emergencySave()
+void setEmergencyJournal(RecoveryJournal* journal);
 void installCrashHandlers();
 void emergencySave();
@@ -0,0 +1,268 @@
+#include "DocumentCompactor.h"
+
+#include <algorithm>      // for sort
+#include <iterator>       // for next
+#include <memory>         // for unique_ptr, make_unique
+#include <mutex>          // for mutex, lock_guard
+#include <unordered_set>  // for unordered_set
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "control/ParallelPageEdit.h"        // for ParallelPageEdit::run
+#include "control/tools/StrokeDecimator.h"   // for StrokeDecimator
+#include "model/Document.h"                  // for Document
+#include "model/Element.h"                   // for Element, ELEMENT_STROKE, ELEMENT_IMAGE
+#include "model/ElementInsertionPosition.h"  // for InsertionOrder, InsertionOrderRef
+#include "model/Image.h"                     // for Image
+#include "model/ImageBuffer.h"               // for ImageBuffer
+#include "model/Layer.h"                     // for Layer
+#include "model/PageType.h"                  // for PageType, PageTypeFormat
+#include "model/Point.h"                     // for Point
+#include "model/Stroke.h"                    // for Stroke, StrokeTool
+#include "model/XojPage.h"                   // for XojPage
+#include "undo/CompactPageUndoAction.h"      // for CompactPageUndoAction
+#include "undo/GroupUndoAction.h"            // for GroupUndoAction
+#include "util/Color.h"                      // for Color
+#include "util/Range.h"                      // for Range
+#include "util/i18n.h"                       // for _F, FS
+
+namespace {
+bool isWhiteout(const Element* e, Color background) {
+    return e->getType() == ELEMENT_STROKE && static_cast<const Stroke*>(e)->getToolType() == StrokeTool::ERASER &&
+           e->getColor() == background;
+}
+
+/**
+ * Whether the whiteout stroke at the position pos of layers[layer] is only painted over the background and other
+ * whiteout strokes. The elements of the upper layers and the later ones of its layer are painted over it.
+ */
+bool erasesNothing(const std::vector<Layer*>& layers, size_t layer, const Element* whiteout, Element::Index pos,
+                   Color background) {
+    const Range area(whiteout->boundingRect());
+    for (size_t l = 0; l <= layer; l++) {
+        for (auto&& [e, p]: layers[l]->getElementsInAreaWithPositions(area)) {
+            if ((l < layer || p < pos) && !isWhiteout(e, background)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Whether b continues a, so that the merged stroke is painted the same: opaque strokes of the same style, b starting
+ * at the end of a
+ */
+bool canMerge(const Stroke& a, const Stroke& b, double tolerance) {
+    if (a.getToolType() != b.getToolType() || a.getToolType() == StrokeTool::HIGHLIGHTER ||
+        a.getColor() != b.getColor() || a.getWidth() != b.getWidth() || a.getFill() != -1 || b.getFill() != -1 ||
+        a.getStrokeCapStyle() != b.getStrokeCapStyle() || a.hasPressure() != b.hasPressure() ||
+        a.getLineStyle().hasDashes() || b.getLineStyle().hasDashes() || !a.getAudioFilename().empty() ||
+        !b.getAudioFilename().empty()) {
+        return false;
+    }
+    if (a.getPointCount() == 0 || b.getPointCount() == 0) {
+        return false;
+    }
+    return a.getPoint(a.getPointCount() - 1).lineLengthTo(b.getPoint(0)) <= tolerance;
+}
+
+/// The points of the stroke, with those dropped which are within the tolerance (see StrokeDecimator)
+auto simplify(const std::vector<Point>& points, double tolerance) -> std::vector<Point> {
+    std::vector<Point> res;
+    res.reserve(points.size());
+    res.push_back(points.front());
+    StrokeDecimator decimator(tolerance);
+    decimator.reset(points.front());
+    for (auto it = std::next(points.begin()); it != points.end(); ++it) {
+        if (decimator.replacesLast(*it)) {
+            res.back() = *it;
+        } else {
+            res.push_back(*it);
+        }
+    }
+    return res;
+}
+
+/// An element of the compacted layer: an element of the layer, or the stroke replacing it
+struct Entry {
+    Element* original;
+    Element::Index pos;
+    std::unique_ptr<Stroke> replacement;
+
+    auto getStroke() const -> const Stroke* {
+        if (replacement) {
+            return replacement.get();
+        }
+        return original->getType() == ELEMENT_STROKE ? static_cast<const Stroke*>(original) : nullptr;
+    }
+
+    /// The stroke to change, made the replacement if it is not yet
+    auto editStroke(InsertionOrderRef& removed) -> Stroke* {
+        if (!replacement) {
+            replacement = static_cast<const Stroke*>(original)->cloneStroke();
+            removed.emplace_back(original, pos);
+        }
+        return replacement.get();
+    }
+};
+}  // namespace
+
+DocumentCompactor::DocumentCompactor(Options options): options(options) {}
+
+auto DocumentCompactor::Report::operator+=(const Report& other) -> Report& {
+    elementsBefore += other.elementsBefore;
+    elementsAfter += other.elementsAfter;
+    pointsBefore += other.pointsBefore;
+    pointsAfter += other.pointsAfter;
+    mergedStrokes += other.mergedStrokes;
+    droppedWhiteout += other.droppedWhiteout;
+    removedLayers += other.removedLayers;
+    images += other.images;
+    imageData += other.imageData;
+    return *this;
+}
+
+auto DocumentCompactor::Report::describe() const -> std::string {
+    std::string text = FS(_F("Elements: {1} before, {2} after") % elementsBefore % elementsAfter);
+    text += "\n" + FS(_F("Points of the strokes: {1} before, {2} after") % pointsBefore % pointsAfter);
+    text += "\n" + FS(_F("Strokes merged: {1}") % mergedStrokes);
+    text += "\n" + FS(_F("Whiteout strokes dropped: {1}") % droppedWhiteout);
+    text += "\n" + FS(_F("Empty layers removed: {1}") % removedLayers);
+    if (images > 0) {
+        text += "\n" + FS(_F("Images: {1}, sharing {2} distinct image data") % images % imageData);
+    }
+    return text;
+}
+
+auto DocumentCompactor::compactPage(const PageRef& page, Report& report) const
+        -> std::unique_ptr<CompactPageUndoAction> {
+    const auto& layers = *page->getLayers();
+    const Color background = page->getBackgroundColor();
+    // On another background, the whiteout hides its pattern
+    const bool dropWhiteout = this->options.dropUselessWhiteout &&
+                              page->getBackgroundType().format == PageTypeFormat::Plain && page->isLayerVisible(0);
+
+    auto undo = std::make_unique<CompactPageUndoAction>(page);
+    bool changed = false;
+    std::vector<Layer*> emptyLayers;
+    for (size_t l = 0; l < layers.size(); l++) {
+        Layer* layer = layers[l];
+        const auto& elements = layer->getElements();
+        report.elementsBefore += elements.size();
+
+        std::vector<Entry> kept;
+        InsertionOrderRef removed;
+        for (size_t n = 0; n < elements.size(); n++) {
+            Element* e = elements[n].get();
+            const auto pos = static_cast<Element::Index>(n);
+            if (dropWhiteout && isWhiteout(e, background) && erasesNothing(layers, l, e, pos, background)) {
+                removed.emplace_back(e, pos);
+                report.droppedWhiteout++;
+                continue;
+            }
+            if (e->getType() != ELEMENT_STROKE) {
+                kept.push_back({e, pos, nullptr});
+                continue;
+            }
+
+            const auto* s = static_cast<const Stroke*>(e);
+            report.pointsBefore += s->getPointCount();
+            const Stroke* previous = kept.empty() ? nullptr : kept.back().getStroke();
+            if (previous && canMerge(*previous, *s, this->options.tolerance)) {
+                Stroke* merged = kept.back().editStroke(removed);
+                auto points = merged->getPointVector();
+                const auto& next = s->getPointVector();
+                if (points.back().lineLengthTo(next.front()) == 0.0) {
+                    // The width of the segment is the one of its first point, which is in the next stroke
+                    points.pop_back();
+                }
+                points.insert(points.end(), next.begin(), next.end());
+                merged->setPointVector(std::move(points));
+                removed.emplace_back(e, pos);
+                report.mergedStrokes++;
+                continue;
+            }
+            kept.push_back({e, pos, nullptr});
+        }
+
+        InsertionOrder added;
+        for (size_t n = 0; n < kept.size(); n++) {
+            Entry& entry = kept[n];
+            if (const Stroke* s = entry.getStroke(); s && s->getPointCount() > 2) {
+                auto points = simplify(s->getPointVector(), this->options.tolerance);
+                if (points.size() < s->getPointCount()) {
+                    entry.editStroke(removed)->setPointVector(std::move(points));
+                }
+            }
+            if (const Stroke* s = entry.getStroke()) {
+                report.pointsAfter += s->getPointCount();
+            }
+            if (entry.replacement) {
+                added.emplace_back(std::move(entry.replacement), static_cast<Element::Index>(n));
+            }
+        }
+        report.elementsAfter += kept.size();
+
+        if (!removed.empty()) {
+            std::sort(removed.begin(), removed.end());
+            undo->replaceElements(layer, std::move(removed), std::move(added));
+            changed = true;
+        }
+        if (kept.empty() && !layer->hasName()) {
+            emptyLayers.push_back(layer);
+        }
+    }
+
+    if (emptyLayers.size() == layers.size()) {
+        // A page has at least one layer
+        emptyLayers.erase(emptyLayers.begin());
+    }
+    for (Layer* layer: emptyLayers) {
+        undo->removeLayer(layer);
+    }
+    report.removedLayers += emptyLayers.size();
+
+    if (!changed && emptyLayers.empty()) {
+        return nullptr;
+    }
+    undo->apply();
+    return undo;
+}
+
+auto DocumentCompactor::compact(Document& doc, DocumentHandler& handler, Report& report) const
+        -> std::unique_ptr<GroupUndoAction> {
+    std::vector<PageRef> pages;
+    doc.lock();
+    for (size_t p = 0; p < doc.getPageCount(); p++) {
+        pages.push_back(doc.getPage(p));
+    }
+    doc.unlock();
+
+    std::mutex reportMutex;
+    auto undo = ParallelPageEdit::run(doc, handler, pages, [&](const PageRef& page) -> std::unique_ptr<UndoAction> {
+        Report pageReport;
+        auto action = compactPage(page, pageReport);
+        std::lock_guard lock(reportMutex);
+        report += pageReport;
+        return action;
+    });
+
+    // The identical images share their data since the document was loaded
+    std::unordered_set<const ImageBuffer*> imageData;
+    doc.lock();
+    for (const PageRef& page: pages) {
+        for (const Layer* layer: *page->getLayers()) {
+            for (const auto& e: layer->getElements()) {
+                if (e->getType() == ELEMENT_IMAGE) {
+                    report.images++;
+                    imageData.insert(static_cast<const Image*>(e.get())->getBuffer().get());
+                }
+            }
+        }
+    }
+    doc.unlock();
+    report.imageData += imageData.size();
+
+    return undo;
+}
@@ -0,0 +1,76 @@
+/*
+ * Xournal++
+ *
+ * Compacts the content of a document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+
+#include "model/PageRef.h"  // for PageRef
+
+class CompactPageUndoAction;
+class Document;
+class DocumentHandler;
+class GroupUndoAction;
+
+/**
+ * @brief Removes the debris of long-lived documents, within a tolerance which keeps the rendering unchanged to the eye:
+ *  - the whiteout strokes which erase nothing, if requested: they are on a blank spot of a plain page of their color,
+ *  - the strokes drawn in one go (e.g. a stroke continued after a gap of the input) are merged,
+ *  - the strokes with more points than needed are simplified,
+ *  - the empty layers without a name are removed.
+ * The images are not touched: the identical ones already share their data (see ImageBuffer), which is only reported.
+ */
+class DocumentCompactor {
+public:
+    struct Options {
+        /// The maximal distance of the strokes to the original ones, in page coordinates
+        double tolerance = 0.25;
+        /// Whether the whiteout strokes erasing nothing are dropped
+        bool dropUselessWhiteout = false;
+    };
+
+    struct Report {
+        size_t elementsBefore = 0;
+        size_t elementsAfter = 0;
+        size_t pointsBefore = 0;
+        size_t pointsAfter = 0;
+        size_t mergedStrokes = 0;
+        size_t droppedWhiteout = 0;
+        size_t removedLayers = 0;
+        size_t images = 0;
+        /// The number of distinct image data among the images
+        size_t imageData = 0;
+
+        Report& operator+=(const Report& other);
+
+        /// The savings, to show to the user
+        std::string describe() const;
+    };
+
+    explicit DocumentCompactor(Options options);
+
+    /**
+     * Compact all the pages, in parallel (see ParallelPageEdit). Called from the UI thread, with the document unlocked.
+     * @return The undo action, or nullptr if the document was not changed
+     */
+    auto compact(Document& doc, DocumentHandler& handler, Report& report) const -> std::unique_ptr<GroupUndoAction>;
+
+    /**
+     * Compact a page, without notifying. The page must be locked; distinct pages can be compacted concurrently.
+     * @return The undo action, or nullptr if the page was not changed
+     */
+    auto compactPage(const PageRef& page, Report& report) const -> std::unique_ptr<CompactPageUndoAction>;
+
+private:
+    Options options;
+};
@@ -0,0 +1,91 @@
+#include "DocumentMerger.h"
+
+#include <algorithm>     // for any_of
+#include <memory>        // for unique_ptr
+#include <system_error>  // for error_code
+
+#include "control/xojfile/LoadHandler.h"  // for LoadHandler
+#include "model/Document.h"               // for Document
+#include "model/DocumentChangeType.h"     // for DOCUMENT_CHANGE_COMPLETE
+#include "model/DocumentHandler.h"        // for DocumentHandler
+#include "model/PageType.h"               // for PageType
+#include "model/XojPage.h"                // for XojPage
+#include "util/PlaceholderString.h"       // for PlaceholderString
+#include "util/i18n.h"                    // for _F, FS
+
+namespace {
+bool samePdf(const fs::path& a, const fs::path& b) {
+    std::error_code ec;
+    const bool same = fs::equivalent(a, b, ec);
+    return ec ? a == b : same;
+}
+}  // namespace
+
+auto DocumentMerger::append(Document& doc, DocumentHandler& handler, const std::vector<fs::path>& files) -> Result {
+    Result result;
+    doc.lock();
+    fs::path pdf = doc.getPdfFilepath();
+    bool pdfAttached = doc.isAttachPdf();
+    result.first = doc.getPageCount();
+    doc.unlock();
+
+    for (const fs::path& file: files) {
+        LoadHandler loader;
+        // The pages are parsed when shown, and the background PDF is the one of doc
+        loader.setLazyPageLoading(true);
+        loader.setPdfBackgroundLoading(false);
+        std::unique_ptr<Document> source = loader.loadDocument(file);
+        if (!source) {
+            result.errors.push_back(FS(_F("\"{1}\" could not be read: {2}") % file.u8string() % loader.getLastError()));
+            continue;
+        }
+
+        std::vector<PageRef> pages;
+        pages.reserve(source->getPageCount());
+        for (size_t n = 0; n < source->getPageCount(); n++) {
+            pages.push_back(source->getPage(n));
+        }
+        const bool usesPdf = std::any_of(pages.begin(), pages.end(),
+                                         [](const PageRef& p) { return p->getBackgroundType().isPdfPage(); });
+        if (usesPdf) {
+            const fs::path sourcePdf = source->getPdfFilepath();
+            if (source->isAttachPdf()) {
+                result.errors.push_back(
+                        FS(_F("\"{1}\" has its background PDF attached, which cannot be shared with another document") %
+                           file.u8string()));
+                continue;
+            }
+            if (pdf.empty()) {
+                if (!doc.readPdf(sourcePdf, false, false)) {
+                    result.errors.push_back(FS(_F("The background PDF of \"{1}\" could not be read: {2}") %
+                                               file.u8string() % doc.getLastErrorMsg()));
+                    continue;
+                }
+                pdf = sourcePdf;
+                pdfAttached = false;
+                result.pdfChanged = true;
+            } else if (pdfAttached || !samePdf(pdf, sourcePdf)) {
+                result.errors.push_back(
+                        FS(_F("\"{1}\" has another background PDF than \"{2}\": a document has only one") %
+                           file.u8string() % pdf.u8string()));
+                continue;
+            }
+        }
+        result.pages.insert(result.pages.end(), pages.begin(), pages.end());
+    }
+
+    if (result.pages.empty() && !result.pdfChanged) {
+        return result;
+    }
+    doc.lock();
+    doc.addPages(result.pages.begin(), result.pages.end());
+    doc.unlock();
+
+    if (result.pdfChanged) {
+        // The views are made again, with the PDF
+        handler.fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
+    } else {
+        handler.firePagesInserted(result.first, result.pages.size());
+    }
+    return result;
+}
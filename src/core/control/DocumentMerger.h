@@ -0,0 +1,49 @@
+/*
+ * Xournal++
+ *
+ * Appends documents to a document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "filesystem.h"  // for path
+
+class Document;
+class DocumentHandler;
+
+/**
+ * @brief Appends the pages of other documents (e.g. to assemble the notes of a semester): the documents are loaded
+ * lazily, their pages are moved without a copy and the listeners get one event.
+ *
+ * A document has one background PDF: the pages of a document with a PDF background are only appended if it is the
+ * PDF of the document, or if the document has none yet (it then gets this one).
+ */
+class DocumentMerger {
+public:
+    struct Result {
+        /// The index of the first page appended
+        size_t first = 0;
+        std::vector<PageRef> pages;
+        /// The document got the background PDF of an appended document
+        bool pdfChanged = false;
+        /// For each document not appended, why
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * Append the pages of the files, in order, and notify the handler: documentChanged(DOCUMENT_CHANGE_COMPLETE) if
+     * the document got a background PDF, pagesInserted() otherwise. The document must not be locked.
+     */
+    static Result append(Document& doc, DocumentHandler& handler, const std::vector<fs::path>& files);
+};
@@ -0,0 +1,133 @@
+#include "DocumentReloader.h"
+
+#include <algorithm>      // for min
+#include <deque>          // for deque
+#include <functional>     // for hash
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+
+#include "control/ThumbnailCache.h"  // for ThumbnailCache
+#include "model/AudioElement.h"      // for AudioElement
+#include "model/Document.h"          // for Document
+#include "model/DocumentHandler.h"   // for DocumentHandler
+#include "model/Element.h"           // for Element
+#include "model/Layer.h"             // for Layer
+#include "model/XojPage.h"           // for XojPage
+#include "util/Util.h"               // for npos
+
+namespace {
+void combine(uint64_t& h, uint64_t value) { h = (h ^ value) * 1099511628211ULL; }
+
+bool same(const DocumentReloader::PageHash& a, const DocumentReloader::PageHash& b) { return a && b && *a == *b; }
+}  // namespace
+
+auto DocumentReloader::hashPages(Document& doc, bool onlyLoaded) -> std::vector<PageHash> {
+    const auto pdfFile = doc.getPdfFilepath();
+    std::vector<PageHash> hashes;
+    hashes.reserve(doc.getPageCount());
+    for (size_t n = 0; n < doc.getPageCount(); n++) {
+        PageRef page = doc.getPage(n);
+        if (onlyLoaded && !page->isContentLoaded()) {
+            hashes.emplace_back();
+            continue;
+        }
+        uint64_t h = ThumbnailCache::hashPage(*page, pdfFile);
+        // Not shown, but saved
+        for (const Layer* layer: *page->getLayers()) {
+            combine(h, layer->hasName() ? std::hash<std::string>{}(layer->getName()) : 0);
+            for (const auto& e: layer->getElements()) {
+                if (const auto* audio = dynamic_cast<const AudioElement*>(e.get());
+                    audio && !audio->getAudioFilename().empty()) {
+                    combine(h, std::hash<std::string>{}(audio->getAudioFilename().u8string()));
+                    combine(h, audio->getTimestamp());
+                }
+            }
+        }
+        hashes.push_back(h);
+    }
+    return hashes;
+}
+
+auto DocumentReloader::match(const std::vector<PageHash>& current, const std::vector<PageHash>& loaded)
+        -> std::vector<size_t> {
+    std::vector<size_t> matches(loaded.size(), npos);
+
+    // The pages are mostly edited in place, or inserted or deleted at one place
+    size_t prefix = 0;
+    const size_t common = std::min(current.size(), loaded.size());
+    while (prefix < common && same(current[prefix], loaded[prefix])) {
+        matches[prefix] = prefix;
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < common - prefix &&
+           same(current[current.size() - 1 - suffix], loaded[loaded.size() - 1 - suffix])) {
+        matches[loaded.size() - 1 - suffix] = current.size() - 1 - suffix;
+        suffix++;
+    }
+
+    // In between, the first identical page after the last match
+    std::unordered_map<uint64_t, std::deque<size_t>> candidates;
+    for (size_t n = prefix; n < current.size() - suffix; n++) {
+        if (current[n]) {
+            candidates[*current[n]].push_back(n);
+        }
+    }
+    size_t next = prefix;
+    for (size_t n = prefix; n < loaded.size() - suffix; n++) {
+        auto it = loaded[n] ? candidates.find(*loaded[n]) : candidates.end();
+        if (it == candidates.end()) {
+            continue;
+        }
+        auto& indices = it->second;
+        while (!indices.empty() && indices.front() < next) {
+            indices.pop_front();
+        }
+        if (!indices.empty()) {
+            matches[n] = indices.front();
+            next = indices.front() + 1;
+            indices.pop_front();
+        }
+    }
+    return matches;
+}
+
+auto DocumentReloader::apply(Document& doc, DocumentHandler& handler, const std::vector<PageRef>& loaded,
+                             const std::vector<size_t>& matches) -> size_t {
+    auto deletePage = [&](size_t pos) {
+        // first send event, then delete page...
+        handler.firePageDeleted(pos);
+        doc.lock();
+        doc.deletePage(pos);
+        doc.unlock();
+    };
+
+    // The pages are inserted before the unmatched ones are deleted, so that the document is never empty
+    size_t inserted = 0;
+    size_t pos = 0;
+    size_t old = 0;
+    for (size_t n = 0; n < loaded.size(); n++) {
+        if (matches[n] != npos) {
+            for (; old < matches[n]; old++) {
+                deletePage(pos);
+            }
+            pos++;
+            old++;
+        } else {
+            doc.lock();
+            doc.insertPage(loaded[n], pos);
+            doc.unlock();
+            handler.firePageInserted(pos);
+            pos++;
+            inserted++;
+        }
+    }
+
+    doc.lock();
+    size_t count = doc.getPageCount();
+    doc.unlock();
+    for (; count > pos; count--) {
+        deletePage(pos);
+    }
+    return inserted;
+}
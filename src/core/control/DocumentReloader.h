@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Reloads the document changed on disk, page by page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
+#include <optional>  // for optional
+#include <vector>    // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+class Document;
+class DocumentHandler;
+
+/**
+ * @brief Replaces only the pages which changed when the file of the document is changed by another program (or
+ * synced from another machine), so that the views, the previews and the caches of the other pages are kept.
+ */
+class DocumentReloader {
+public:
+    using PageHash = std::optional<uint64_t>;
+
+    /**
+     * @param onlyLoaded If true, the pages whose content is not loaded are not hashed (their hash is nullopt): their
+     * content may be read from the mapping of a file which has changed since.
+     * @return For each page, a hash of its content: what is shown (see ThumbnailCache::hashPage), the names of the
+     * layers and the audio of the elements. The document must be locked.
+     */
+    static std::vector<PageHash> hashPages(Document& doc, bool onlyLoaded);
+
+    /**
+     * Match the loaded pages to the identical current pages, in the same order: the common pages at the start and at
+     * the end, then the identical pages in between, in order. A page without hash matches no page.
+     *
+     * @return For each loaded page, the index of the identical current page it replaces, or npos. The indices
+     * increase.
+     */
+    static std::vector<size_t> match(const std::vector<PageHash>& current, const std::vector<PageHash>& loaded);
+
+    /**
+     * Make the pages of doc the loaded ones: the pages of doc matched to a loaded page are kept, the others are
+     * deleted and the loaded pages without a match are inserted. The handler is notified of each page deleted or
+     * inserted. The document must not be locked.
+     *
+     * @param matches For each loaded page, see match()
+     * @return The number of pages inserted
+     */
+    static size_t apply(Document& doc, DocumentHandler& handler, const std::vector<PageRef>& loaded,
+                        const std::vector<size_t>& matches);
+};
@@ -1,42 +1,44 @@
 #include "ExportHelper.h"
 
-#include <algorithm>  // for max
+#include <algorithm>  // for max, clamp, transform
+#include <array>      // for array
+#include <atomic>     // for atomic
+#include <cctype>     // for tolower
+#include <chrono>     // for steady_clock, duration
+#include <cstdio>     // for snprintf
+#include <exception>  // for exception
+#include <iostream>   // for cout, endl
 #include <memory>     // for unique_ptr, allocator
+#include <mutex>      // for mutex, lock_guard
 #include <string>     // for string
+#include <thread>     // for thread
+#include <utility>    // for pair
+#include <vector>     // for vector
 
-#include <gio/gio.h>      // for g_file_new_for_commandlin...
-#include <glib.h>         // for g_message, g_error
+#include <gio/gio.h>  // for g_file_new_for_commandlin...
+#include <glib.h>     // for g_message, g_error, g_ascii_formatd
 
 #include "control/jobs/ImageExport.h"       // for ImageExport, EXPORT_GRAPH...
 #include "control/jobs/ProgressListener.h"  // for DummyProgressListener
+#include "control/xojfile/LoadHandler.h"    // for LoadHandler
+#include "control/xojfile/SaveHandler.h"    // for SaveHandler
 #include "model/Document.h"                 // for Document
+#include "model/DocumentHandler.h"          // for DocumentHandler
 #include "pdf/base/XojPdfExport.h"          // for XojPdfExport
 #include "pdf/base/XojPdfExportFactory.h"   // for XojPdfExportFactory
 #include "util/ElementRange.h"              // for parse, PageRangeVector
-#include "util/i18n.h"                      // for _
+#include "util/PathUtil.h"                  // for hasPdfFileExt
+#include "util/PlaceholderString.h"         // for PlaceholderString
+#include "util/i18n.h"                      // for _, FS, _F
 #include "util/raii/GObjectSPtr.h"          // for GObjectSPtr
 
 #include "filesystem.h"  // for operator==, path, u8path
 
 namespace ExportHelper {
 
-/**
- * @brief Export the input file as a bunch of image files (one per page)
- * @param input Path to the input file
- * @param output Path to the output file(s)
- * @param range Page range to be parsed. If range=nullptr, exports the whole file
- * @param pngDpi Set dpi for Png files. Non positive values are ignored
- * @param pngWidth Set the width for Png files. Non positive values are ignored
- * @param pngHeight Set the height for Png files. Non positive values are ignored
- * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported image file has transparent background
- *
- *  The priority is: pngDpi overwrites pngWidth overwrites pngHeight
- *
- * @return 0 on success, -3 on export failure
- */
-auto exportImg(Document* doc, const char* output, const char* range, const char* layerRange, int pngDpi, int pngWidth,
-               int pngHeight, ExportBackgroundType exportBackground) -> int {
-
+namespace {
+/// @return The error message, empty on success
+auto exportImgFile(Document* doc, const char* output, const ExportOptions& options) -> std::string {
     fs::path const path(output);
 
     ExportGraphicsFormat format = EXPORT_GRAPHICS_PNG;
@@ -46,31 +48,155 @@ auto exportImg(Document* doc, const char* output, const char* range, const char*
     }
 
     PageRangeVector exportRange;
-    if (range) {
-        exportRange = ElementRange::parse(range, doc->getPageCount());
+    if (options.range) {
+        exportRange = ElementRange::parse(options.range, doc->getPageCount());
     } else {
         exportRange.emplace_back(0, doc->getPageCount() - 1);
     }
 
     DummyProgressListener progress;
 
-    ImageExport imgExport(doc, path, format, exportBackground, exportRange);
+    ImageExport imgExport(doc, path, format, options.exportBackground, exportRange);
 
     if (format == EXPORT_GRAPHICS_PNG) {
-        if (pngDpi > 0) {
-            imgExport.setQualityParameter(EXPORT_QUALITY_DPI, pngDpi);
-        } else if (pngWidth > 0) {
-            imgExport.setQualityParameter(EXPORT_QUALITY_WIDTH, pngWidth);
-        } else if (pngHeight > 0) {
-            imgExport.setQualityParameter(EXPORT_QUALITY_HEIGHT, pngHeight);
+        if (options.pngDpi > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_DPI, options.pngDpi);
+        } else if (options.pngWidth > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_WIDTH, options.pngWidth);
+        } else if (options.pngHeight > 0) {
+            imgExport.setQualityParameter(EXPORT_QUALITY_HEIGHT, options.pngHeight);
         }
+        imgExport.setPngCompression(options.pngCompression);
     }
 
-    imgExport.setLayerRange(layerRange);
+    imgExport.setLayerRange(options.layerRange);
 
     imgExport.exportGraphics(&progress);
 
-    std::string errorMsg = imgExport.getLastErrorMsg();
+    return imgExport.getLastErrorMsg();
+}
+
+/// @return The error message, empty on success
+auto exportPdfFile(Document* doc, const char* output, const ExportOptions& options) -> std::string {
+    xoj::util::GObjectSPtr<GFile> file(g_file_new_for_commandline_arg(output), xoj::util::adopt);
+
+    std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(doc, nullptr);
+    pdfe->setExportBackground(options.exportBackground);
+    auto path = fs::u8path(g_file_peek_path(file.get()));
+
+    bool exportSuccess = 0;  // Return of the export job
+
+    pdfe->setLayerRange(options.layerRange);
+
+    if (options.range) {
+        // Parse the range
+        PageRangeVector exportRange = ElementRange::parse(options.range, doc->getPageCount());
+        // Do the export
+        exportSuccess = pdfe->createPdf(path, exportRange, options.progressiveMode);
+    } else {
+        exportSuccess = pdfe->createPdf(path, options.progressiveMode);
+    }
+
+    return exportSuccess ? std::string() : pdfe->getLastError();
+}
+
+/// @return The error message of the conversion of a line of the manifest, empty on success
+auto convertFile(const fs::path& input, const fs::path& output, const ExportOptions& options) -> std::string {
+    auto ext = output.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    const bool saveDocument = ext == ".xopp" || ext == ".xoj";
+    if (!saveDocument && ext != ".pdf" && ext != ".png" && ext != ".svg") {
+        return FS(_F("Unsupported output format: \"{1}\"") % output.u8string());
+    }
+
+    DocumentHandler handler;
+    std::unique_ptr<Document> doc;
+    LoadHandler loader;
+    if (saveDocument && Util::hasPdfFileExt(input)) {
+        // A new document with the background PDF, as with --save
+        doc = std::make_unique<Document>(&handler);
+        if (!doc->readPdf(input, /*initPages=*/true, false)) {
+            return doc->getLastErrorMsg();
+        }
+    } else {
+        // Only the exported pages are parsed
+        loader.setLazyPageLoading(!saveDocument);
+        doc = loader.loadDocument(input);
+        if (!doc) {
+            return loader.getLastError();
+        }
+        if (!loader.getMissingPdfFilename().empty()) {
+            return FS(_F("The background file \"{1}\" could not be found.") % loader.getMissingPdfFilename());
+        }
+    }
+
+    if (saveDocument) {
+        SaveHandler saver;
+        saver.saveDocument(doc.get(), output);
+        return saver.getErrorMessage();
+    }
+    const std::string out = output.u8string();
+    return ext == ".pdf" ? exportPdfFile(doc.get(), out.c_str(), options) :
+                           exportImgFile(doc.get(), out.c_str(), options);
+}
+
+void appendJsonString(std::string& json, const std::string& str) {
+    json += '"';
+    for (char c: str) {
+        switch (c) {
+            case '"':
+                json += "\\\"";
+                break;
+            case '\\':
+                json += "\\\\";
+                break;
+            case '\n':
+                json += "\\n";
+                break;
+            case '\t':
+                json += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    std::array<char, 7> escaped{};
+                    std::snprintf(escaped.data(), escaped.size(), "\\u%04x", c);
+                    json += escaped.data();
+                } else {
+                    json += c;
+                }
+        }
+    }
+    json += '"';
+}
+}  // namespace
+
+/**
+ * @brief Export the input file as a bunch of image files (one per page)
+ * @param input Path to the input file
+ * @param output Path to the output file(s)
+ * @param range Page range to be parsed. If range=nullptr, exports the whole file
+ * @param pngDpi Set dpi for Png files. Non positive values are ignored
+ * @param pngWidth Set the width for Png files. Non positive values are ignored
+ * @param pngHeight Set the height for Png files. Non positive values are ignored
+ * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported image file has transparent background
+ *
+ *  The priority is: pngDpi overwrites pngWidth overwrites pngHeight
+ *
+ * @return 0 on success, -3 on export failure
+ */
+auto exportImg(Document* doc, const char* output, const char* range, const char* layerRange, int pngDpi, int pngWidth,
+               int pngHeight, ExportBackgroundType exportBackground, xoj::util::png::Compression pngCompression)
+        -> int {
+
+    ExportOptions options;
+    options.range = range;
+    options.layerRange = layerRange;
+    options.pngDpi = pngDpi;
+    options.pngWidth = pngWidth;
+    options.pngHeight = pngHeight;
+    options.exportBackground = exportBackground;
+    options.pngCompression = pngCompression;
+    std::string errorMsg = exportImgFile(doc, output, options);
     if (!errorMsg.empty()) {
         g_message("Error exporting image: %s\n", errorMsg.c_str());
     }
@@ -94,32 +220,81 @@ auto exportImg(Document* doc, const char* output, const char* range, const char*
 auto exportPdf(Document* doc, const char* output, const char* range, const char* layerRange,
                ExportBackgroundType exportBackground, bool progressiveMode) -> int {
 
-    xoj::util::GObjectSPtr<GFile> file(g_file_new_for_commandline_arg(output), xoj::util::adopt);
-
-    std::unique_ptr<XojPdfExport> pdfe = XojPdfExportFactory::createExport(doc, nullptr);
-    pdfe->setExportBackground(exportBackground);
-    auto path = fs::u8path(g_file_peek_path(file.get()));
+    ExportOptions options;
+    options.range = range;
+    options.layerRange = layerRange;
+    options.exportBackground = exportBackground;
+    options.progressiveMode = progressiveMode;
+    if (std::string errorMsg = exportPdfFile(doc, output, options); !errorMsg.empty()) {
+        g_error("%s", errorMsg.c_str());
+    }
 
-    bool exportSuccess = 0;  // Return of the export job
+    g_message("%s", _("PDF file successfully created"));
 
-    pdfe->setLayerRange(layerRange);
+    return 0;  // no error
+}
 
-    if (range) {
-        // Parse the range
-        PageRangeVector exportRange = ElementRange::parse(range, doc->getPageCount());
-        // Do the export
-        exportSuccess = pdfe->createPdf(path, exportRange, progressiveMode);
-    } else {
-        exportSuccess = pdfe->createPdf(path, progressiveMode);
+auto exportBatch(std::istream& manifest, const ExportOptions& options, unsigned int jobs) -> int {
+    std::vector<std::pair<fs::path, fs::path>> conversions;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        auto tab = line.find('\t');
+        if (tab == std::string::npos) {
+            g_warning("Ignoring the line of the manifest without a tab: %s", line.c_str());
+            continue;
+        }
+        conversions.emplace_back(fs::u8path(line.substr(0, tab)), fs::u8path(line.substr(tab + 1)));
     }
 
-    if (!exportSuccess) {
-        g_error("%s", pdfe->getLastError().c_str());
-    }
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::mutex outputMutex;
 
-    g_message("%s", _("PDF file successfully created"));
+    auto work = [&]() {
+        for (size_t i = next++; i < conversions.size(); i = next++) {
+            const auto& [input, output] = conversions[i];
+            auto start = std::chrono::steady_clock::now();
+            std::string error;
+            try {
+                error = convertFile(input, output, options);
+            } catch (const std::exception& e) {
+                error = e.what();
+            } catch (...) { error = "Unknown exception"; }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-    return 0;  // no error
+            std::string json = "{\"input\": ";
+            appendJsonString(json, input.u8string());
+            json += ", \"output\": ";
+            appendJsonString(json, output.u8string());
+            json += error.empty() ? ", \"ok\": true" : ", \"ok\": false";
+            std::array<char, G_ASCII_DTOSTR_BUF_SIZE> duration{};
+            json += ", \"ms\": ";
+            json += g_ascii_formatd(duration.data(), G_ASCII_DTOSTR_BUF_SIZE, "%.1f", ms);
+            if (!error.empty()) {
+                json += ", \"error\": ";
+                appendJsonString(json, error);
+                failed = true;
+            }
+            json += "}";
+
+            std::lock_guard lock(outputMutex);
+            std::cout << json << std::endl;
+        }
+    };
+
+    jobs = std::clamp(jobs, 1U, static_cast<unsigned int>(std::max<size_t>(conversions.size(), 1)));
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < jobs; i++) { workers.emplace_back(work); }
+    work();
+    for (auto& t: workers) { t.join(); }
+
+    return failed ? -3 : 0;
 }
 
 }  // namespace ExportHelper
@@ -11,13 +11,29 @@
 
 #pragma once
 
+#include <istream>  // for istream
 
 #include "control/jobs/BaseExportJob.h"  // for ExportBackgroundType
+#include "util/PngEncoder.h"             // for Compression
 
 class Document;
 
 namespace ExportHelper {
 
+/**
+ * The options of the exports of the command line, see exportImg() and exportPdf()
+ */
+struct ExportOptions {
+    const char* range = nullptr;
+    const char* layerRange = nullptr;
+    int pngDpi = -1;
+    int pngWidth = -1;
+    int pngHeight = -1;
+    xoj::util::png::Compression pngCompression = xoj::util::png::Compression::DEFAULT;
+    ExportBackgroundType exportBackground = EXPORT_BACKGROUND_ALL;
+    bool progressiveMode = false;
+};
+
 /**
  * @brief Export the input file as a bunch of image files (one per page)
  * @param doc Document to export
@@ -30,13 +46,15 @@ namespace ExportHelper {
  * @param pngWidth Set the width for Png files. Non positive values are ignored
  * @param pngHeight Set the height for Png files. Non positive values are ignored
  * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported image file has transparent background
+ * @param pngCompression The speed/size tradeoff of the encoding of the Png files
  *
  *  The priority is: pngDpi overwrites pngWidth overwrites pngHeight
  *
  * @return 0 on success, -2 on failure opening the input file, -3 on export failure
  */
 int exportImg(Document* doc, const char* output, const char* range, const char* layerRange, int pngDpi, int pngWidth,
-              int pngHeight, ExportBackgroundType exportBackground);
+              int pngHeight, ExportBackgroundType exportBackground,
+              xoj::util::png::Compression pngCompression = xoj::util::png::Compression::DEFAULT);
 
 /**
  * @brief Export the input file as pdf
@@ -55,5 +73,22 @@ int exportImg(Document* doc, const char* output, const char* range, const char*
 int exportPdf(Document* doc, const char* output, const char* range, const char* layerRange,
               ExportBackgroundType exportBackground, bool progressiveMode);
 
+/**
+ * @brief Convert many files in a single process
+ * @param manifest One conversion per line, "INPUT<TAB>OUTPUT". The empty lines and the lines starting with # are
+ *                 skipped. The format of the conversion is guessed from the extension of OUTPUT:
+ *                  - .pdf: exports INPUT as pdf
+ *                  - .png or .svg: exports INPUT as image files
+ *                  - .xopp or .xoj: saves INPUT again, or a new document with the background PDF INPUT
+ * @param options The options applied to all the exports
+ * @param jobs The number of conversions run in parallel
+ *
+ * A line is printed on the standard output when each conversion ends, as a JSON object with the members "input",
+ * "output", "ok" (a boolean), "ms" (the duration of the conversion in milliseconds) and, on failure, "error".
+ *
+ * @return 0 if all the conversions succeeded, -3 otherwise
+ */
+int exportBatch(std::istream& manifest, const ExportOptions& options, unsigned int jobs);
+
 
 }  // namespace ExportHelper
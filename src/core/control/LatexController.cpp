@@ -54,7 +54,8 @@ LatexController::LatexController(Control* control):
         settings(control->getSettings()->latexSettings),
         doc(control->getDocument()),
         texTmpDir(Util::getTmpDirSubfolder("tex")),
-        generator(settings) {
+        generator(settings),
+        cache(Util::getCacheSubfolder("latex")) {
     Util::ensureFolderExists(this->texTmpDir);
 }
 
@@ -177,7 +178,22 @@ void LatexController::triggerImageUpdate(const string& texString) {
 
     this->lastPreviewedTex = texString;
     const std::string texContents = LatexGenerator::templateSub(texString, this->latexTemplate, textColor);
-    auto result = generator.asyncRun(this->texTmpDir, texContents);
+    this->lastPreviewedKey = LatexCache::key(texContents, this->settings.genCmd);
+
+    if (auto pdf = this->cache.lookup(this->lastPreviewedKey)) {
+        // Rendered before: no need to run the LaTeX command
+        this->texProcessOutput.clear();
+        this->temporaryRender = createTexImage(texString, std::move(*pdf));
+        this->isValidTex = this->temporaryRender != nullptr;
+        if (this->isValidTex) {
+            this->dlg->setTempRender(this->temporaryRender->getPdf());
+        }
+        updateStatus();
+        return;
+    }
+
+    auto result = generator.asyncRun(this->texTmpDir, texContents,
+                                     LatexGenerator::constantPreambleLength(this->latexTemplate));
     if (auto* err = std::get_if<LatexGenerator::GenError>(&result)) {
         XojMsgBox::showErrorToUser(this->control->getGtkWindow(), err->message);
     } else if (auto** proc = std::get_if<GSubprocess*>(&result)) {
@@ -294,9 +310,18 @@ auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexIma
         return nullptr;
     }
 
+    auto img = createTexImage(std::move(renderedTex), std::move(*contents));
+    if (img) {
+        // The PDF was compiled from lastPreviewedTex
+        this->cache.store(this->lastPreviewedKey, pdfPath);
+    }
+    return img;
+}
+
+auto LatexController::createTexImage(string renderedTex, string pdf) -> std::unique_ptr<TexImage> {
     auto img = std::make_unique<TexImage>();
     GError* err{};
-    bool loaded = img->loadData(std::move(*contents), &err);
+    bool loaded = img->loadData(std::move(pdf), &err);
 
     if (err != nullptr) {
         string message = FS(_F("Could not load LaTeX PDF file: {1}") % err->message);
@@ -21,6 +21,7 @@
 #include <gtk/gtk.h>  // for GtkTextBuffer
 #include <poppler.h>  // for GObject
 
+#include "control/latex/LatexCache.h"      // for LatexCache
 #include "control/latex/LatexGenerator.h"  // for LatexGenerator
 #include "model/PageRef.h"                 // for PageRef
 
@@ -107,10 +108,15 @@ private:
     bool isUpdating();
 
     /**
-     * Load the preview PDF from disk and create a TexImage object.
+     * Load the preview PDF from disk, keep it in the cache and create a TexImage object.
      */
     std::unique_ptr<TexImage> loadRendered(std::string renderedTex);
 
+    /**
+     * Create a TexImage object from the rendered PDF.
+     */
+    std::unique_ptr<TexImage> createTexImage(std::string renderedTex, std::string pdf);
+
     /**
      * Insert the generated preview TexImage into the current page.
      */
@@ -147,6 +153,11 @@ private:
      */
     std::string lastPreviewedTex;
 
+    /**
+     * The cache key of the last TeX string shown in the preview.
+     */
+    std::string lastPreviewedKey;
+
     /**
      * Whether a preview is currently being generated.
      */
@@ -221,4 +232,9 @@ private:
     std::unique_ptr<TexImage> temporaryRender;
 
     LatexGenerator generator;
+
+    /**
+     * The formulas rendered before, in any document
+     */
+    LatexCache cache;
 };
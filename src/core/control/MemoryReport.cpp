@@ -0,0 +1,126 @@
+#include "MemoryReport.h"
+
+#include <algorithm>  // for sort, min
+#include <iomanip>    // for setprecision
+#include <sstream>    // for ostringstream
+
+#include "control/Control.h"       // for Control
+#include "control/PdfCache.h"      // for PdfCache
+#include "gui/MainWindow.h"        // for MainWindow
+#include "gui/PageView.h"          // for XojPageView
+#include "gui/XournalView.h"       // for XournalView
+#include "gui/sidebar/Sidebar.h"   // for Sidebar
+#include "model/Document.h"        // for Document
+#include "model/Element.h"         // for Element, ELEMENT_IMAGE, ELEMENT_STROKE
+#include "model/Image.h"           // for Image
+#include "model/ImageBuffer.h"     // for ImageBuffer
+#include "model/Layer.h"           // for Layer
+#include "model/Stroke.h"          // for Stroke
+#include "model/XojPage.h"         // for XojPage
+#include "undo/UndoRedoHandler.h"  // for UndoRedoHandler
+
+namespace {
+auto mib(size_t bytes) -> std::string {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MiB";
+    return out.str();
+}
+}  // namespace
+
+auto MemoryReport::Page::getTotal() const -> size_t { return pointsMemory + imageData + viewBuffers; }
+
+auto MemoryReport::getTotal() const -> size_t {
+    return viewBuffers + pointsMemory + pdfCache + previews + imageData + imageSurfaces + undoHistory;
+}
+
+auto MemoryReport::toString(size_t maxPages) const -> std::string {
+    std::ostringstream out;
+    out << "Memory of \"" << (document.empty() ? "unsaved document" : document) << "\": " << mib(getTotal()) << "\n";
+    out << "  Page buffers: " << mib(viewBuffers) << "\n";
+    out << "  Points of the strokes: " << mib(pointsMemory) << "\n";
+    out << "  PDF cache: " << mib(pdfCache) << "\n";
+    out << "  Sidebar previews: " << mib(previews) << "\n";
+    out << "  Image data: " << mib(imageData) << " (" << imageCount << " distinct images)\n";
+    out << "  Image surfaces: " << mib(imageSurfaces) << "\n";
+    out << "  Undo history: " << mib(undoHistory) << " (and " << mib(undoSpilled) << " in a temporary file)\n";
+
+    std::vector<const Page*> sorted;
+    size_t unloaded = 0;
+    for (const Page& p: pages) {
+        if (p.loaded) {
+            sorted.push_back(&p);
+        } else {
+            unloaded++;
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Page* a, const Page* b) { return a->getTotal() > b->getTotal(); });
+
+    out << "Pages (" << pages.size() << ", " << unloaded << " unloaded), the largest first:\n";
+    const size_t shown = std::min(maxPages, sorted.size());
+    for (size_t i = 0; i < shown; i++) {
+        const Page& p = *sorted[i];
+        out << "  Page " << p.index + 1 << ": " << mib(p.getTotal()) << " = points " << mib(p.pointsMemory) << " ("
+            << p.points << " in " << p.elements << " elements) + images " << mib(p.imageData) << " + buffers "
+            << mib(p.viewBuffers) << "\n";
+    }
+    if (shown < sorted.size()) {
+        out << "  … and " << sorted.size() - shown << " more loaded pages\n";
+    }
+    return out.str();
+}
+
+auto MemoryReport::collect(Control* control) -> MemoryReport {
+    MemoryReport report;
+    XournalView* xournal = control->getWindow() ? control->getWindow()->getXournal() : nullptr;
+
+    Document* doc = control->getDocument();
+    doc->lock();
+    report.document = doc->getFilepath().u8string();
+    for (size_t n = 0; n < doc->getPageCount(); n++) {
+        PageRef page = doc->getPage(n);
+        Page& p = report.pages.emplace_back();
+        p.index = n;
+        // Do not load the content of the page only to measure it
+        p.loaded = page->isContentLoaded();
+        if (p.loaded) {
+            for (const Layer* layer: *page->getLayers()) {
+                for (const auto& e: layer->getElements()) {
+                    p.elements++;
+                    if (e->getType() == ELEMENT_STROKE) {
+                        const auto* s = static_cast<const Stroke*>(e.get());
+                        p.points += s->getPointCount();
+                        p.pointsMemory += s->getPointsMemorySize();
+                    } else if (e->getType() == ELEMENT_IMAGE) {
+                        if (const auto& buffer = static_cast<const Image*>(e.get())->getBuffer()) {
+                            p.imageData += buffer->getData().size();
+                        }
+                    }
+                }
+            }
+        }
+        report.pointsMemory += p.pointsMemory;
+    }
+    doc->unlock();
+
+    // The buffers are locked by the render jobs, which may wait for the document
+    for (Page& p: report.pages) {
+        if (XojPageView* view = xournal ? xournal->getViewFor(p.index) : nullptr) {
+            p.viewBuffers = view->getBufferMemoryUsage();
+            report.viewBuffers += p.viewBuffers;
+        }
+    }
+
+    if (PdfCache* cache = xournal ? xournal->getCache() : nullptr) {
+        report.pdfCache = cache->getMemoryUsage();
+    }
+    if (Sidebar* sidebar = control->getSidebar()) {
+        report.previews = sidebar->getMemoryUsage();
+    }
+    const auto images = ImageBuffer::getMemoryUsage();
+    report.imageData = images.data;
+    report.imageCount = images.buffers;
+    report.imageSurfaces = images.surfaces;
+    report.undoHistory = control->getUndoRedoHandler()->getMemoryUsage();
+    report.undoSpilled = control->getUndoRedoHandler()->getSpilledSize();
+    return report;
+}
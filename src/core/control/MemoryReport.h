@@ -0,0 +1,73 @@
+/*
+ * Xournal++
+ *
+ * The memory used by the caches, the document and the undo history
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+class Control;
+
+/**
+ * @brief A snapshot of the memory used by each pool: the buffers of the pages, the PDF cache, the sidebar previews,
+ * the images, the undo history and the points of the strokes, with the breakdown per page. For the bug reports about
+ * the memory usage, and a reference for the memory budgets.
+ */
+struct MemoryReport {
+    struct Page {
+        size_t index = 0;
+        /// If false, the content of the page is unloaded: it uses no memory, and is not counted
+        bool loaded = false;
+        size_t elements = 0;
+        size_t points = 0;
+        /// The memory of the points of the strokes, in bytes
+        size_t pointsMemory = 0;
+        /// The data of the images of the page, in bytes. The data shared by several pages is counted for each.
+        size_t imageData = 0;
+        /// The buffers of the view of the page, in bytes
+        size_t viewBuffers = 0;
+
+        size_t getTotal() const;
+    };
+
+    std::string document;
+    std::vector<Page> pages;
+
+    // All the pools, in bytes
+    size_t viewBuffers = 0;
+    size_t pointsMemory = 0;
+    size_t pdfCache = 0;
+    size_t previews = 0;
+    /// The data of all the images in use (by the document or by the undo history), shared between identical images
+    size_t imageData = 0;
+    size_t imageCount = 0;
+    size_t imageSurfaces = 0;
+    size_t undoHistory = 0;
+    /// The data of the undo history written to a temporary file (not in memory)
+    size_t undoSpilled = 0;
+
+    /**
+     * @return The memory used by all the pools, in bytes
+     */
+    size_t getTotal() const;
+
+    /**
+     * @param maxPages The number of pages listed, the ones using the most memory first
+     * @return The report in plain text
+     */
+    std::string toString(size_t maxPages = static_cast<size_t>(-1)) const;
+
+    /**
+     * Measure the pools of the application. Called from the UI thread.
+     */
+    static MemoryReport collect(Control* control);
+};
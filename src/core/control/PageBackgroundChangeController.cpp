@@ -3,6 +3,7 @@
 #include <memory>   // for __shared_ptr...
 #include <string>   // for allocator
 #include <utility>  // for move
+#include <vector>   // for vector
 
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_g...
 #include <gio/gio.h>                // for GFile
@@ -41,6 +42,8 @@ PageBackgroundChangeController::PageBackgroundChangeController(Control* control)
     registerListener(control);
 }
 
+PageBackgroundChangeController::~PageBackgroundChangeController() = default;
+
 void PageBackgroundChangeController::applyBackgroundToAllPages(const PageType& pt) {
     control->clearSelectionEndText();
 
@@ -60,10 +63,14 @@ void PageBackgroundChangeController::applyBackgroundToAllPages(const PageType& p
 
         control->getUndoRedoHandler()->addUndoAction(std::move(groupUndoAction));
 
-        // Special background types may alter the page sizes as well
-        auto fire = pt.isSpecial() ? &Control::firePageSizeChanged : &Control::firePageChanged;
-        for (size_t n = 0; n < nbPages; n++) {
-            (control->*fire)(n);
+        {
+            // The listeners are notified once for all the pages
+            PageChangesGuard guard(control);
+            // Special background types may alter the page sizes as well
+            auto fire = pt.isSpecial() ? &Control::firePageSizeChanged : &Control::firePageChanged;
+            for (size_t n = 0; n < nbPages; n++) {
+                (control->*fire)(n);
+            }
         }
         control->updateBackgroundSizeButton();
         control->getWindow()->getMenubar()->getPageTypeSubmenu().setSelected(std::move(pt));
@@ -96,7 +103,8 @@ void PageBackgroundChangeController::changePdfPagesBackground(const fs::path& fi
     }
     this->control->getWindow()->getXournal()->recreatePdfCache();
 
-    this->control->fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
+    // The pages are kept, only their backgrounds changed (readPdf() notified the new outline)
+    this->control->fireDocumentChanged(DOCUMENT_CHANGE_PAGES);
 
     auto undoAction = std::make_unique<MissingPdfUndoAction>(oldFilepath, oldAttachPdf);
     this->control->getUndoRedoHandler()->addUndoAction(std::move(undoAction));
@@ -138,6 +146,7 @@ void PageBackgroundChangeController::changeCurrentPageBackground(const PageType&
 
 void PageBackgroundChangeController::setPageTypeForNewPages(const std::optional<PageType>& pt) {
     this->pageTypeForNewPages = pt;
+    this->pagePrototype.reset();
 }
 
 static void setPageImageBackground(const PageRef& page, BackgroundImage img) {
@@ -246,21 +255,54 @@ void PageBackgroundChangeController::copyBackgroundFromOtherPage(PageRef target,
     }
 }
 
+auto PageBackgroundChangeController::getPageTemplate() -> const PageTemplateSettings& {
+    const std::string& templ = control->getSettings()->getPageTemplate();
+    if (templ != this->parsedPageTemplate) {
+        this->pageTemplate = PageTemplateSettings();
+        this->pageTemplate.parse(templ);
+        this->parsedPageTemplate = templ;
+        this->pagePrototype.reset();
+    }
+    return this->pageTemplate;
+}
+
+auto PageBackgroundChangeController::createPageFromTemplate() -> PageRef {
+    const PageTemplateSettings& model = getPageTemplate();
+    if (!this->pagePrototype) {
+        this->pagePrototype = std::make_unique<XojPage>(model.getPageWidth(), model.getPageHeight());
+        if (pageTypeForNewPages && !pageTypeForNewPages->isSpecial()) {
+            this->pagePrototype->setBackgroundType(pageTypeForNewPages.value());
+            this->pagePrototype->setBackgroundColor(model.getBackgroundColor());
+        }
+    }
+    return std::make_shared<XojPage>(*this->pagePrototype);
+}
+
 void PageBackgroundChangeController::insertNewPage(size_t position, bool shouldScrollToPage) {
+    insertNewPages(position, 1, shouldScrollToPage);
+}
+
+void PageBackgroundChangeController::insertNewPages(size_t position, size_t count, bool shouldScrollToPage) {
     control->clearSelectionEndText();
+    if (count == 0) {
+        return;
+    }
 
     Document* doc = control->getDocument();
     if (position > doc->getPageCount()) {
         position = doc->getPageCount();
     }
 
-    PageTemplateSettings model;
-    model.parse(control->getSettings()->getPageTemplate());
-
-    auto page = std::make_shared<XojPage>(model.getPageWidth(), model.getPageHeight());
+    const bool copyLastPageSize = getPageTemplate().isCopyLastPageSize();
+    auto page = createPageFromTemplate();
 
-    auto afterConfigured = [position, shouldScrollToPage, ctrl = this->control](PageRef page) {
-        ctrl->insertPage(page, position, shouldScrollToPage);
+    auto afterConfigured = [position, count, shouldScrollToPage, ctrl = this->control](PageRef page) {
+        // The copies share the background of the first page (e.g. its BackgroundImage)
+        std::vector<PageRef> pages;
+        pages.reserve(count);
+        for (size_t i = 1; i < count; i++) { pages.emplace_back(std::make_shared<XojPage>(*page)); }
+        pages.insert(pages.begin(), std::move(page));
+        ctrl->insertPages(pages, position, shouldScrollToPage);
     };
 
     if (!pageTypeForNewPages) {
@@ -279,13 +321,8 @@ void PageBackgroundChangeController::insertNewPage(size_t position, bool shouldS
             after(std::move(page));
         });
     } else {
-        // Create a new page from template
-        page->setBackgroundType(pageTypeForNewPages.value());
-
-        // Set background Color
-        page->setBackgroundColor(model.getBackgroundColor());
-
-        if (model.isCopyLastPageSize()) {
+        // The page from the template already has the type and the background color
+        if (copyLastPageSize) {
             PageRef current = control->getCurrentPage();
             xoj_assert(current);
             page->setSize(current->getWidth(), current->getHeight());
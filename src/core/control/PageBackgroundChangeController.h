@@ -15,8 +15,10 @@
 #include <functional>
 #include <memory>  // for unique_ptr
 #include <optional>
+#include <string>  // for string
 #include <variant>
 
+#include "control/settings/PageTemplateSettings.h"  // for PageTemplateSettings
 #include "model/BackgroundImage.h"
 #include "model/DocumentChangeType.h"  // for DocumentChangeType
 #include "model/DocumentListener.h"    // for DocumentListener
@@ -27,11 +29,12 @@
 
 class Control;
 class UndoAction;
+class XojPage;
 
 class PageBackgroundChangeController: public DocumentListener {
 public:
     PageBackgroundChangeController(Control* control);
-    ~PageBackgroundChangeController() override = default;
+    ~PageBackgroundChangeController() override;
 
 public:
     void changeCurrentPageBackground(const PageType& pageType);
@@ -46,6 +49,12 @@ public:
     void applyBackgroundToAllPages(const PageType& pt);
     void changePdfPagesBackground(const fs::path& filepath, bool attachPdf);
     void insertNewPage(size_t position, bool shouldScrollToPage = true);
+    /**
+     * @brief Insert count new pages before the page at position, configured like insertNewPage() does (asking at most
+     *      once for the image or the pdf page). The pages share their background and are inserted with a single update
+     *      of the layout and of the sidebar, and a single undo action.
+     */
+    void insertNewPages(size_t position, size_t count, bool shouldScrollToPage = true);
 
     // DocumentListener
 public:
@@ -78,7 +87,22 @@ private:
     auto commitPageTypeChange(size_t pageNum, const PageType& pageType, CommitParameter param = std::nullopt)
             -> std::unique_ptr<UndoAction>;
 
+    /// The page template of the settings, parsed again only once it changed
+    const PageTemplateSettings& getPageTemplate();
+
+    /**
+     * @return A new blank page of the size of the page template. If pageTypeForNewPages is set and not special, the
+     *      page also has this type and the background color of the template.
+     *      The page is copied from a prototype, built again after a change of the template or of pageTypeForNewPages.
+     */
+    PageRef createPageFromTemplate();
+
 private:
     Control* control = nullptr;
     std::optional<PageType> pageTypeForNewPages;
+
+    /// The template string pageTemplate was parsed from
+    std::string parsedPageTemplate;
+    PageTemplateSettings pageTemplate;
+    std::unique_ptr<XojPage> pagePrototype;
 };
@@ -0,0 +1,63 @@
+#include "ParallelPageEdit.h"
+
+#include <algorithm>  // for clamp
+#include <atomic>     // for atomic
+#include <thread>     // for thread
+#include <utility>    // for move
+
+#include "model/Document.h"         // for Document, DocumentPageReadLock
+#include "model/DocumentHandler.h"  // for DocumentHandler, PageChangesGuard
+#include "model/XojPage.h"          // for XojPage
+#include "undo/GroupUndoAction.h"   // for GroupUndoAction
+#include "undo/UndoAction.h"        // for UndoAction
+#include "util/Util.h"              // for npos
+
+auto ParallelPageEdit::run(Document& doc, DocumentHandler& handler, const std::vector<PageRef>& pages, const Edit& edit)
+        -> std::unique_ptr<GroupUndoAction> {
+    if (pages.empty()) {
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<UndoAction>> actions(pages.size());
+    std::atomic<size_t> nextPage{0};
+    auto editPages = [&]() {
+        for (size_t n = nextPage++; n < pages.size(); n = nextPage++) {
+            DocumentPageReadLock lock(doc, *pages[n]);
+            actions[n] = edit(pages[n]);
+        }
+    };
+
+    const size_t threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, pages.size());
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(editPages);
+    }
+    // The UI thread waits anyway: it takes its share of the pages
+    editPages();
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    std::vector<size_t> changedPages;
+    auto group = std::make_unique<GroupUndoAction>();
+    doc.lock();
+    for (size_t n = 0; n < pages.size(); n++) {
+        if (actions[n]) {
+            changedPages.push_back(doc.indexOf(pages[n]));
+            group->addAction(std::move(actions[n]));
+        }
+    }
+    doc.unlock();
+    if (changedPages.empty()) {
+        return nullptr;
+    }
+
+    PageChangesGuard guard(&handler);
+    for (size_t index: changedPages) {
+        if (index != npos) {
+            handler.firePageChanged(index);
+        }
+    }
+    return group;
+}
@@ -0,0 +1,43 @@
+/*
+ * Xournal++
+ *
+ * Runs an edit over many pages concurrently
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <functional>  // for function
+#include <memory>      // for unique_ptr
+#include <vector>      // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+class Document;
+class DocumentHandler;
+class GroupUndoAction;
+class UndoAction;
+
+namespace ParallelPageEdit {
+
+/**
+ * The edit of a page. It runs on several threads at once (one page each), with the document locked shared and the page exclusively (see
+ * DocumentPageReadLock): it must only change its page, and not notify the listeners.
+ * @return The undo action of the change, or nullptr if the page was not changed
+ */
+using Edit = std::function<std::unique_ptr<UndoAction>(const PageRef& page)>;
+
+/**
+ * @brief Edit the pages concurrently, on up to one thread per core, then notify the listeners of the changed pages
+ * at once (see PageChangesGuard). Called from the UI thread, which waits for all the pages to be edited, with the
+ * document unlocked.
+ * @return The undo actions of the pages, in the order of `pages`, or nullptr if no page was changed
+ */
+auto run(Document& doc, DocumentHandler& handler, const std::vector<PageRef>& pages, const Edit& edit)
+        -> std::unique_ptr<GroupUndoAction>;
+
+}  // namespace ParallelPageEdit
@@ -1,116 +1,301 @@
 #include "PdfCache.h"
 
-#include <algorithm>  // for max
-#include <cmath>      // for ceil, abs
+#include <algorithm>  // for min, max
+#include <cmath>      // for abs, ldexp, log2
+#include <cstdint>    // for uint64_t
 #include <cstdio>     // for size_t
 #include <memory>     // for shared_ptr, __shared_ptr_access
 #include <string>     // for string
-#include <utility>    // for move
+#include <utility>    // for move, exchange
 
 #include <glib.h>  // for g_warning
 
-#include "control/settings/Settings.h"  // for Settings
-#include "pdf/base/XojPdfDocument.h"    // for XojPdfDocument
-#include "util/Range.h"                 // for Range
-#include "util/i18n.h"                  // for _
-#include "util/safe_casts.h"            // for as_unsigned
-#include "view/Mask.h"                  // for Mask
+#include "control/PerfStats.h"             // for isEnabled, recordPdfCacheLookup
+#include "control/jobs/PdfRasterizeJob.h"  // for PdfRasterizeJob
+#include "control/jobs/Scheduler.h"        // for Scheduler, JOB_PRIORITY_URGENT
+#include "control/settings/Settings.h"     // for Settings
+#include "pdf/base/XojPdfDocument.h"       // for XojPdfDocument
+#include "util/Range.h"                    // for Range
+#include "util/i18n.h"                     // for _
+#include "util/safe_casts.h"               // for ceil_cast, round_cast, as_unsigned
+#include "view/Mask.h"                     // for Mask
 
 class PdfCacheEntry {
 public:
     /**
      *   Cache [img], the result of rendering [popplerPage] with
-     * the given [zoom].
+     * the zoom of one of the levels of the pyramid.
      *  A change in the document's zoom causes a change in the
      * quality of the PDF backgrounds (zoomed in => need a higher
      * quality rendering).
      *
      * @param popplerPage
      * @param buffer is the result of rendering popplerPage
+     * @param byteSize is the memory used by buffer
+     * @param dpiScaling is the DPI scaling buffer was rendered for
      */
-    PdfCacheEntry(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer):
-            popplerPage(std::move(popplerPage)), buffer(std::forward<xoj::view::Mask>(buffer)) {}
+    PdfCacheEntry(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer, size_t byteSize, int dpiScaling):
+            popplerPage(std::move(popplerPage)),
+            buffer(std::forward<xoj::view::Mask>(buffer)),
+            byteSize(byteSize),
+            dpiScaling(dpiScaling) {}
 
     ~PdfCacheEntry() = default;
 
     XojPdfPageSPtr popplerPage;
     xoj::view::Mask buffer;
+    size_t byteSize;
+    int dpiScaling;
+    uint64_t lastUse = 0;
 };
 
-PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings): pdfDocument(doc) { updateSettings(settings); }
+PdfCache::PdfCache(const XojPdfDocument& doc, Settings* settings, Scheduler* scheduler):
+        lifeline(std::make_shared<Lifeline>()), pdfDocument(doc), scheduler(scheduler) {
+    lifeline->cache = this;
+    updateSettings(settings);
+}
 
-PdfCache::~PdfCache() = default;
+PdfCache::~PdfCache() {
+    // Wait for the running rasterizations. The queued ones will find out the cache is gone.
+    std::unique_lock lock(this->lifeline->mutex);
+    this->lifeline->cache = nullptr;
+}
 
-void PdfCache::setRefreshThreshold(double threshold) { this->zoomRefreshThreshold = threshold; }
+void PdfCache::setRefreshThreshold(double threshold) {
+    std::lock_guard<std::mutex> lock(this->dataMutex);
+    this->zoomRefreshThreshold = threshold;
+}
 
-void PdfCache::setMaxSize(size_t newSize) {
-    this->maxSize = newSize;
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
-    }
+void PdfCache::setPageRasterizedCallback(std::function<void(size_t pdfPageNo)> callback) {
+    std::lock_guard<std::mutex> lock(this->dataMutex);
+    this->pageRasterizedCallback = std::move(callback);
+}
+
+void PdfCache::setMaxMemory(size_t bytes) {
+    std::lock_guard<std::mutex> lock(this->dataMutex);
+    this->maxMemory = bytes;
+    evict(nullptr);
+}
+
+auto PdfCache::getMemoryUsage() -> size_t {
+    std::lock_guard<std::mutex> lock(this->dataMutex);
+    return this->usedMemory;
 }
 
 void PdfCache::updateSettings(Settings* settings) {
     if (settings) {
-        setMaxSize(as_unsigned(settings->getPdfPageCacheSize()));
+        setMaxMemory(static_cast<size_t>(settings->getPdfPageCacheMemory()) * 1024 * 1024);
         setRefreshThreshold(settings->getPDFPageRerenderThreshold());
     }
 }
 
-auto PdfCache::lookup(size_t pdfPageNo) const -> const PdfCacheEntry* {
-    for (auto& e: this->data) {
-        if (static_cast<size_t>(e->popplerPage->getPageId()) == pdfPageNo) {
-            return e.get();
+auto PdfCache::levelFor(double zoom) -> int {
+    if (zoom <= 1.0) {
+        return 0;
+    }
+    return std::min(MAX_LEVEL, ceil_cast<int>(std::log2(zoom)));
+}
+
+auto PdfCache::lookup(size_t pdfPageNo, int minLevel) -> PdfCacheEntry* {
+    for (int level = minLevel; level <= MAX_LEVEL; level++) {
+        if (auto it = this->data.find(toKey(pdfPageNo, level)); it != this->data.end()) {
+            return it->second.get();
         }
     }
+    return nullptr;
+}
 
+auto PdfCache::lookupBelow(size_t pdfPageNo, int maxLevel) -> PdfCacheEntry* {
+    for (int level = maxLevel - 1; level >= 0; level--) {
+        if (auto it = this->data.find(toKey(pdfPageNo, level)); it != this->data.end()) {
+            return it->second.get();
+        }
+    }
     return nullptr;
 }
 
-auto PdfCache::cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer) -> const PdfCacheEntry* {
-    if (this->data.size() > this->maxSize) {
-        this->data.resize(this->maxSize);
+auto PdfCache::cache(size_t pdfPageNo, int level, XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer,
+                     size_t byteSize, int dpiScaling) -> PdfCacheEntry* {
+    auto entry = std::make_unique<PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer),
+                                                 byteSize, dpiScaling);
+    auto* res = entry.get();
+    this->usedMemory += byteSize;
+    auto& slot = this->data[toKey(pdfPageNo, level)];
+    if (slot) {
+        // Rendered for another DPI scaling
+        this->usedMemory -= slot->byteSize;
     }
+    slot = std::move(entry);
 
-    this->data.emplace_front(
-            std::make_unique<PdfCacheEntry>(std::move(popplerPage), std::forward<xoj::view::Mask>(buffer)));
+    evict(res);
+    return res;
+}
 
-    return this->data.front().get();
+void PdfCache::evict(const PdfCacheEntry* keep) {
+    while (this->usedMemory > this->maxMemory) {
+        auto oldest = this->data.end();
+        for (auto it = this->data.begin(); it != this->data.end(); ++it) {
+            if (it->second.get() == keep) {
+                continue;
+            }
+            if (oldest == this->data.end() || it->second->lastUse < oldest->second->lastUse) {
+                oldest = it;
+            }
+        }
+        if (oldest == this->data.end()) {
+            // Only `keep` is left, even if it does not fit in the budget by itself
+            return;
+        }
+        this->usedMemory -= oldest->second->byteSize;
+        this->data.erase(oldest);
+    }
 }
 
-void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight) {
-    std::lock_guard<std::mutex> lock(this->renderMutex);
+bool PdfCache::rasterize(size_t pdfPageNo, int level, int dpiScaling) {
+    std::unique_lock<std::mutex> dataLock(this->dataMutex);
+    std::mutex& pageMutex = this->pageMutexes[pdfPageNo];  // References to unordered_map elements are stable
+    dataLock.unlock();
+
+    std::lock_guard<std::mutex> pageLock(pageMutex);
+
+    XojPdfPageSPtr popplerPage;
+    dataLock.lock();
+    if (auto it = this->data.find(toKey(pdfPageNo, level));
+        it != this->data.end() && it->second->dpiScaling >= dpiScaling) {
+        // Rasterized by another thread in the meantime
+        return true;
+    }
+    if (PdfCacheEntry* other = lookup(pdfPageNo, 0)) {
+        popplerPage = other->popplerPage;
+    } else {
+        popplerPage = pdfDocument.getPage(pdfPageNo);
+    }
+    dataLock.unlock();
 
-    const PdfCacheEntry* cacheResult = lookup(pdfPageNo);
+    if (!popplerPage) {
+        g_warning("PdfCache::rasterize Could not get the pdf page %zu from the document", pdfPageNo);
+        return false;
+    }
 
-    bool needsRefresh = cacheResult == nullptr;
+    const double renderZoom = std::ldexp(1.0, level);
+    const double width = popplerPage->getWidth();
+    const double height = popplerPage->getHeight();
+    xoj::view::Mask buffer(dpiScaling, Range(0, 0, width, height), renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
+    popplerPage->render(buffer.get());
+    const size_t byteSize = 4U * as_unsigned(dpiScaling * dpiScaling) * ceil_cast<size_t>(width * renderZoom) *
+                            ceil_cast<size_t>(height * renderZoom);
 
-    if (!needsRefresh) {
-        double averagedZoom = (zoom + cacheResult->buffer.getZoom()) / 2.0;
-        double percentZoomChange = std::abs(cacheResult->buffer.getZoom() - zoom) * 100.0 / averagedZoom;
+    dataLock.lock();
+    cache(pdfPageNo, level, std::move(popplerPage), std::move(buffer), byteSize, dpiScaling);
+    return true;
+}
 
-        // If we do have a cached result, is its rendering quality
-        // acceptable for our current zoom?
-        needsRefresh = (zoom > 1.0 && percentZoomChange > this->zoomRefreshThreshold);
+void PdfCache::requestRasterization(size_t pdfPageNo, int level, int dpiScaling) {
+    {
+        std::lock_guard<std::mutex> lock(this->dataMutex);
+        if (!this->pendingRasterizations.insert(toKey(pdfPageNo, level)).second) {
+            return;
+        }
+    }
+    // Not under the dataMutex: the scheduler may delete the job (and call cancelRasterization()) under its queue lock
+    auto* job = new PdfRasterizeJob(this->lifeline, pdfPageNo, level, dpiScaling);
+    this->scheduler->addJob(job, JOB_PRIORITY_URGENT);
+    job->unref();
+}
+
+void PdfCache::runRasterization(size_t pdfPageNo, int level, int dpiScaling) {
+    const bool success = rasterize(pdfPageNo, level, dpiScaling);
+
+    std::function<void(size_t)> callback;
+    {
+        std::lock_guard<std::mutex> lock(this->dataMutex);
+        this->pendingRasterizations.erase(toKey(pdfPageNo, level));
+        if (!success) {
+            this->missingPages.insert(pdfPageNo);
+        }
+        callback = this->pageRasterizedCallback;
+    }
+    if (callback) {
+        callback(pdfPageNo);
+    }
+}
+
+void PdfCache::cancelRasterization(size_t pdfPageNo, int level) {
+    std::lock_guard<std::mutex> lock(this->dataMutex);
+    this->pendingRasterizations.erase(toKey(pdfPageNo, level));
+}
+
+void PdfCache::render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight, bool wait) {
+    const int level = levelFor(zoom);
+
+    double scaleX = 1.0;
+    double scaleY = 1.0;
+    cairo_surface_get_device_scale(cairo_get_target(cr), &scaleX, &scaleY);
+    const int dpiScaling = std::max(1, round_cast<int>(scaleX));
+
+    std::unique_lock<std::mutex> lock(this->dataMutex);
+
+    if (this->missingPages.count(pdfPageNo)) {
+        lock.unlock();
+        renderMissingPdfPage(cr, pageWidth, pageHeight);
+        return;
+    }
+
+    PdfCacheEntry* cacheResult = lookup(pdfPageNo, level);
+    PdfCacheEntry* lower = nullptr;
+    if (cacheResult && cacheResult->dpiScaling < dpiScaling) {
+        // Rendered before the window moved to a monitor with a higher DPI scaling: only good enough until the page is
+        // rasterized again, for the pages actually painted
+        lower = std::exchange(cacheResult, nullptr);
+    }
+    if (xoj::perf::isEnabled()) {
+        xoj::perf::recordPdfCacheLookup(cacheResult != nullptr, this->usedMemory, this->maxMemory);
     }
 
-    if (needsRefresh) {
-        double renderZoom = std::max(zoom, 1.0);
+    if (!cacheResult && !lower) {
+        lower = lookupBelow(pdfPageNo, level);
+    }
+    if (lower && lower->dpiScaling >= dpiScaling) {
+        double averagedZoom = (zoom + lower->buffer.getZoom()) / 2.0;
+        double percentZoomChange = std::abs(lower->buffer.getZoom() - zoom) * 100.0 / averagedZoom;
+
+        // We only have a lower resolution version: is its rendering quality
+        // acceptable for our current zoom?
+        if (percentZoomChange <= this->zoomRefreshThreshold) {
+            cacheResult = lower;
+        }
+    }
 
-        auto popplerPage = cacheResult ? cacheResult->popplerPage : pdfDocument.getPage(pdfPageNo);
+    if (!cacheResult && this->scheduler && !wait) {
+        // Make do with the lower resolution version (or a blank page) until the page is rasterized
+        if (lower) {
+            lower->lastUse = ++this->useCounter;
+            lower->buffer.paintTo(cr);
+        } else {
+            cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+            cairo_rectangle(cr, 0, 0, pageWidth, pageHeight);
+            cairo_fill(cr);
+        }
+        lock.unlock();
+        requestRasterization(pdfPageNo, level, dpiScaling);
+        return;
+    }
 
-        if (!popplerPage) {
-            g_warning("PdfCache::render Could not get the pdf page %zu from the document", pdfPageNo);
+    if (!cacheResult) {
+        lock.unlock();
+        if (!rasterize(pdfPageNo, level, dpiScaling)) {
             renderMissingPdfPage(cr, pageWidth, pageHeight);
             return;
         }
-
-        xoj::view::Mask buffer(cairo_get_target(cr), Range(0, 0, popplerPage->getWidth(), popplerPage->getHeight()),
-                               renderZoom, CAIRO_CONTENT_COLOR_ALPHA);
-        popplerPage->render(buffer.get());
-        cacheResult = cache(popplerPage, std::move(buffer));
+        lock.lock();
+        cacheResult = lookup(pdfPageNo, level);
+        if (!cacheResult || cacheResult->dpiScaling < dpiScaling) {
+            // Evicted right away by another thread: the cache is too small to be of any use
+            return;
+        }
     }
 
+    cacheResult->lastUse = ++this->useCounter;
     cacheResult->buffer.paintTo(cr);
 }
 
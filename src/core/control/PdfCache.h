@@ -11,9 +11,14 @@
 
 #pragma once
 
-#include <cstddef>  // for size_t
-#include <deque>    // for deque
-#include <mutex>    // for mutex
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <functional>     // for function
+#include <memory>         // for unique_ptr, shared_ptr
+#include <mutex>          // for mutex
+#include <shared_mutex>   // for shared_mutex
+#include <unordered_map>  // for unordered_map
+#include <unordered_set>  // for unordered_set
 
 #include <cairo.h>  // for cairo_t, cairo_surface_t
 
@@ -25,11 +30,17 @@ class Mask;
 };
 
 class PdfCacheEntry;
+class Scheduler;
 class Settings;
 
 class PdfCache {
 public:
-    PdfCache(const XojPdfDocument& doc, Settings* settings);
+    /**
+     * @param scheduler If not nullptr, the pages missing from the cache are rasterized asynchronously by jobs run on
+     *      this scheduler. In the meantime, render() paints a lower resolution version of the page, or a blank page.
+     *      Otherwise, render() rasterizes the missing pages itself.
+     */
+    PdfCache(const XojPdfDocument& doc, Settings* settings, Scheduler* scheduler = nullptr);
     virtual ~PdfCache();
 
 private:
@@ -43,8 +54,23 @@ public:
      * @param pdfPageNo The page number (in the pdf document)
      * @param zoom The current zoom level
      * @param pageWidth/pageHeight Xournal++ page dimensions
+     * @param wait If true, a missing page is rasterized right away, even if the cache has a scheduler (e.g. for the
+     *      sidebar previews, which are not rendered again once the page is rasterized)
+     */
+    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight, bool wait = false);
+
+    /**
+     * @brief Paint the cached rendering of the page with number pdfPageNo, scaled to the cairo context, without ever
+     *      calling poppler. Used for quick previews.
+     * @return false if the page is not in the cache (nothing is painted then)
      */
-    void render(cairo_t* cr, size_t pdfPageNo, double zoom, double pageWidth, double pageHeight);
+    bool renderCached(cairo_t* cr, size_t pdfPageNo);
+
+    /**
+     * @brief Set the function called once a page has been rasterized asynchronously, so that the views showing it can
+     *      be rerendered. It is called from a worker thread.
+     */
+    void setPageRasterizedCallback(std::function<void(size_t pdfPageNo)> callback);
 
 public:
     /**
@@ -56,32 +82,118 @@ public:
      */
     void setRefreshThreshold(double percentDifference);
 
-    void setMaxSize(size_t newSize);
+    /**
+     * @brief Set the memory budget of the cache, in bytes. The least recently used renderings are evicted first.
+     */
+    void setMaxMemory(size_t bytes);
 
     void updateSettings(Settings* settings);
 
+    /**
+     * @return The memory used by the renderings in the cache, in bytes
+     */
+    size_t getMemoryUsage();
+
     /**
      * @brief Renders an error background, for when the pdf page cannot be rendered
      */
     static void renderMissingPdfPage(cairo_t* cr, double pageWidth, double pageHeight);
 
+    /// Highest level of the pyramid: the pages are never rasterized above this zoom (2^MAX_LEVEL)
+    static constexpr int MAX_LEVEL = 3;
+
 private:
     /**
-     * @brief Look up for a cache entry for the page with number pdfPgeNo in the PDF.
+     * @brief Each page is rasterized at zoom levels 1, 2, 4, ... 2^MAX_LEVEL (level 0, 1, 2, ...)
+     * @return The smallest level whose zoom is at least the given zoom (capped at MAX_LEVEL)
+     */
+    static int levelFor(double zoom);
+    static constexpr uint64_t toKey(size_t pdfPageNo, int level) {
+        return (static_cast<uint64_t>(pdfPageNo) << 8) | static_cast<uint64_t>(level);
+    }
+
+    /**
+     * @brief Look up for a cache entry for the page with number pdfPageNo in the PDF, at the given level or the nearest
+     *      level above it.
      */
-    const PdfCacheEntry* lookup(size_t pdfPageNo) const;
+    PdfCacheEntry* lookup(size_t pdfPageNo, int minLevel);
+    /**
+     * @brief Look up for the cached entry of the page with number pdfPageNo in the PDF, with the highest level below
+     *      maxLevel.
+     */
+    PdfCacheEntry* lookupBelow(size_t pdfPageNo, int maxLevel);
+    /**
+     * @brief Push a cache entry, evicting the least recently used entries if the memory budget is exceeded. It replaces
+     *      the entry of the same page and level, rendered for another DPI scaling, if any.
+     */
+    PdfCacheEntry* cache(size_t pdfPageNo, int level, XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer,
+                         size_t byteSize, int dpiScaling);
+
     /**
-     * @brief Push a cache entry
+     * @brief Evict the least recently used entries until the memory budget is met. The entry `keep` is never evicted.
      */
-    const PdfCacheEntry* cache(XojPdfPageSPtr popplerPage, xoj::view::Mask&& buffer);
+    void evict(const PdfCacheEntry* keep);
+
+    /**
+     * @brief Rasterize the page with number pdfPageNo at the given level, and cache it (unless another thread did it
+     *      in the meantime). A given page is rasterized by one thread at a time, different pages in parallel.
+     * @return false if the page could not be found in the PDF document
+     */
+    bool rasterize(size_t pdfPageNo, int level, int dpiScaling);
+
+    /**
+     * @brief Queue an asynchronous rasterization, unless one is already pending. The dataMutex must not be locked.
+     */
+    void requestRasterization(size_t pdfPageNo, int level, int dpiScaling);
+
+    /**
+     * @brief Run a rasterization requested by requestRasterization(), and notify the users of the cache.
+     *      Called by the PdfRasterizeJob.
+     */
+    void runRasterization(size_t pdfPageNo, int level, int dpiScaling);
+
+    /**
+     * @brief Forget about a pending rasterization whose job was deleted before running
+     */
+    void cancelRasterization(size_t pdfPageNo, int level);
 
 private:
+    /**
+     * Lets the PdfRasterizeJob%s find out if the cache still exists. The cache is only destroyed once no job is
+     * using it (i.e. the jobs hold a shared lock on the mutex while running).
+     */
+    struct Lifeline {
+        std::shared_mutex mutex;
+        PdfCache* cache = nullptr;
+    };
+    std::shared_ptr<Lifeline> lifeline;
+
     XojPdfDocument pdfDocument;
 
-    std::mutex renderMutex;
+    Scheduler* scheduler = nullptr;
+
+    /**
+     * Guards all the members below. Only held for lookups and insertions (and while painting a cached page, so that it
+     * is not evicted in the meantime): never while rasterizing.
+     */
+    std::mutex dataMutex;
+
+    /// Rasterized pages, by (page, level). See toKey().
+    std::unordered_map<uint64_t, std::unique_ptr<PdfCacheEntry>> data;
+    size_t maxMemory = 0;
+    size_t usedMemory = 0;
+    uint64_t useCounter = 0;
 
-    std::deque<std::unique_ptr<PdfCacheEntry>> data;
-    decltype(data)::size_type maxSize = 0;
+    /// Asynchronous rasterizations queued, by (page, level)
+    std::unordered_set<uint64_t> pendingRasterizations;
+    /// Pages which could not be found in the PDF document
+    std::unordered_set<size_t> missingPages;
+    /// Held while rasterizing a page
+    std::unordered_map<size_t, std::mutex> pageMutexes;
+
+    std::function<void(size_t pdfPageNo)> pageRasterizedCallback;
 
     double zoomRefreshThreshold;
+
+    friend class PdfRasterizeJob;
 };
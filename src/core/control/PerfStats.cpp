@@ -0,0 +1,216 @@
+#include "PerfStats.h"
+
+#include <cstdio>     // for snprintf
+#include <cstring>    // for strcmp
+#include <mutex>      // for mutex, lock_guard
+#include <string>     // for string
+#include <utility>    // for exchange
+#include <vector>     // for vector
+
+#include <glib.h>  // for g_getenv, g_get_monotonic_time, g_message
+
+namespace xoj::perf {
+
+namespace {
+auto readMode() -> Mode {
+    const char* value = g_getenv("XOURNALPP_PERF_STATS");
+    if (value == nullptr) {
+        return Mode::OFF;
+    }
+    if (std::strcmp(value, "hud") == 0) {
+        return Mode::HUD;
+    }
+    if (std::strcmp(value, "log") == 0 || std::strcmp(value, "1") == 0) {
+        return Mode::LOG;
+    }
+    return Mode::OFF;
+}
+
+/// Length of the window the summary is computed on, in us
+constexpr int64_t WINDOW = 1000000;
+constexpr double LINE_HEIGHT = 14;
+constexpr double PADDING = 6;
+
+const char* const PRIORITY_NAMES[JOB_N_PRIORITIES] = {"urgent", "high", "low", "none"};
+
+struct Window {
+    Accumulator frame;
+    Accumulator pagePaint;
+    Accumulator inputLatency;
+    std::array<Accumulator, JOB_N_PRIORITIES> jobWait;
+    int64_t pdfLookups = 0;
+    int64_t pdfHits = 0;
+    size_t pdfUsedMemory = 0;
+    size_t pdfMaxMemory = 0;
+};
+
+struct State {
+    std::mutex mutex;
+    Window current;
+    int64_t windowStart = 0;
+    /// Time of the first input event since the last frame, or 0
+    int64_t pendingInput = 0;
+    std::vector<std::string> summary;
+    Totals totals;
+};
+
+auto state() -> State& {
+    static State s;
+    return s;
+}
+
+template <typename... Args>
+auto format(const char* fmt, Args... args) -> std::string {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), fmt, args...);
+    return buffer;
+}
+
+auto summarize(const Window& w, double seconds, const std::array<size_t, JOB_N_PRIORITIES>& queueDepths)
+        -> std::vector<std::string> {
+    std::vector<std::string> lines;
+    lines.push_back(format("frames  %5.1f/s  avg %6.2f ms  max %6.2f ms", static_cast<double>(w.frame.count) / seconds,
+                           w.frame.avgMs(), w.frame.maxMs()));
+    lines.push_back(format("pages   %5ld    avg %6.2f ms  max %6.2f ms", static_cast<long>(w.pagePaint.count),
+                           w.pagePaint.avgMs(), w.pagePaint.maxMs()));
+    lines.push_back(format("input   %5ld    avg %6.2f ms  max %6.2f ms", static_cast<long>(w.inputLatency.count),
+                           w.inputLatency.avgMs(), w.inputLatency.maxMs()));
+    for (size_t i = 0; i < JOB_N_PRIORITIES; i++) {
+        lines.push_back(format("%-6s  %5zu q  wait %6.2f ms  max %6.2f ms", PRIORITY_NAMES[i], queueDepths[i],
+                               w.jobWait[i].avgMs(), w.jobWait[i].maxMs()));
+    }
+    const double hitRate =
+            w.pdfLookups == 0 ? 0.0 : 100.0 * static_cast<double>(w.pdfHits) / static_cast<double>(w.pdfLookups);
+    lines.push_back(format("pdf     %5.1f%% hits of %ld  %zu/%zu MiB", hitRate, static_cast<long>(w.pdfLookups),
+                           w.pdfUsedMemory >> 20, w.pdfMaxMemory >> 20));
+    return lines;
+}
+
+void paintSummary(cairo_t* cr, double x, double y, const std::vector<std::string>& lines) {
+    cairo_save(cr);
+    cairo_rectangle(cr, x, y, HUD_WIDTH, HUD_HEIGHT);
+    cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
+    cairo_fill(cr);
+
+    cairo_select_font_face(cr, "Monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, 11);
+    cairo_set_source_rgb(cr, 1, 1, 1);
+    double lineY = y + PADDING + LINE_HEIGHT - 3;
+    for (const auto& line: lines) {
+        cairo_move_to(cr, x + PADDING, lineY);
+        cairo_show_text(cr, line.c_str());
+        lineY += LINE_HEIGHT;
+    }
+    cairo_restore(cr);
+}
+}  // namespace
+
+const Mode mode = readMode();
+
+std::atomic<bool> accumulateTotals = false;
+
+auto now() -> int64_t { return g_get_monotonic_time(); }
+
+void startTotals() {
+    {
+        State& s = state();
+        std::lock_guard lock(s.mutex);
+        s.totals = Totals();
+    }
+    accumulateTotals = true;
+}
+
+auto takeTotals() -> Totals {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    return std::exchange(s.totals, Totals());
+}
+
+void recordPagePaint(int64_t duration) {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    s.current.pagePaint.add(duration);
+    if (accumulateTotals) {
+        s.totals.pagePaint.add(duration);
+    }
+}
+
+void recordRenderJob(const void* source, int64_t duration) {
+    if (!accumulateTotals) {
+        // Not part of the summary
+        return;
+    }
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    s.totals.renderJobs[source].add(duration);
+}
+
+void recordJobWait(JobPriority priority, int64_t duration) {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    s.current.jobWait[priority].add(duration);
+}
+
+void recordPdfCacheLookup(bool hit, size_t usedMemory, size_t maxMemory) {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    s.current.pdfLookups++;
+    s.current.pdfHits += hit ? 1 : 0;
+    s.current.pdfUsedMemory = usedMemory;
+    s.current.pdfMaxMemory = maxMemory;
+    if (accumulateTotals) {
+        s.totals.pdfLookups++;
+        s.totals.pdfHits += hit ? 1 : 0;
+    }
+}
+
+void recordInput() {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    if (s.pendingInput == 0) {
+        s.pendingInput = now();
+    }
+}
+
+auto endFrame(int64_t frameStart, cairo_t* cr, double x, double y,
+              const std::array<size_t, JOB_N_PRIORITIES>& queueDepths) -> bool {
+    State& s = state();
+    const int64_t end = now();
+    bool changed = false;
+    std::vector<std::string> summary;
+    {
+        std::lock_guard lock(s.mutex);
+        s.current.frame.add(end - frameStart);
+        if (accumulateTotals) {
+            s.totals.frame.add(end - frameStart);
+        }
+        if (s.pendingInput != 0) {
+            s.current.inputLatency.add(end - s.pendingInput);
+            s.pendingInput = 0;
+        }
+
+        if (s.windowStart == 0) {
+            s.windowStart = end;
+        } else if (end - s.windowStart >= WINDOW) {
+            const double seconds = static_cast<double>(end - s.windowStart) / 1e6;
+            s.summary = summarize(s.current, seconds, queueDepths);
+            // The memory of the cache is a level, not a sum: keep it for the next window
+            Window next;
+            next.pdfUsedMemory = s.current.pdfUsedMemory;
+            next.pdfMaxMemory = s.current.pdfMaxMemory;
+            s.current = next;
+            s.windowStart = end;
+            changed = true;
+        }
+        summary = s.summary;
+    }
+
+    if (mode == Mode::LOG && changed) {
+        for (const auto& line: summary) { g_message("perf: %s", line.c_str()); }
+    } else if (mode == Mode::HUD && !summary.empty()) {
+        paintSummary(cr, x, y, summary);
+    }
+    return changed;
+}
+
+}  // namespace xoj::perf
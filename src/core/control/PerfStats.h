@@ -0,0 +1,116 @@
+/*
+ * Xournal++
+ *
+ * Frame time and render job instrumentation
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>      // for max
+#include <array>          // for array
+#include <atomic>         // for atomic, memory_order_relaxed
+#include <cstddef>        // for size_t
+#include <cstdint>        // for int64_t
+#include <unordered_map>  // for unordered_map
+
+#include <cairo.h>  // for cairo_t
+
+#include "control/jobs/Scheduler.h"  // for JOB_N_PRIORITIES, JobPriority
+
+/**
+ * @brief Timings of the paths which make the UI feel slow: painting the pages, waiting for the render jobs, looking up
+ * the PDF cache, and the latency from a pen event to the next frame.
+ *
+ * Enabled by the environment variable XOURNALPP_PERF_STATS:
+ *  - "log": a summary of the last second is logged once per second, while painting
+ *  - "hud": the summary is painted in the top left corner of the main view
+ *
+ * The statistics are always compiled in. When disabled, each hook only costs the check of isEnabled().
+ * They are also enabled, whatever the mode, while Totals are accumulated (by --benchmark-render).
+ */
+namespace xoj::perf {
+
+enum class Mode { OFF, LOG, HUD };
+
+/// Read once, from the environment
+extern const Mode mode;
+
+/// Set by startTotals()
+extern std::atomic<bool> accumulateTotals;
+
+inline bool isEnabled() { return mode != Mode::OFF || accumulateTotals.load(std::memory_order_relaxed); }
+
+/// Count, sum and maximum of durations in us
+struct Accumulator {
+    void add(int64_t value) {
+        count++;
+        sum += value;
+        max = std::max(max, value);
+    }
+    void merge(const Accumulator& other) {
+        count += other.count;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+    double avgMs() const { return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count) / 1000.0; }
+    double maxMs() const { return static_cast<double>(max) / 1000.0; }
+
+    int64_t count = 0;
+    int64_t sum = 0;
+    int64_t max = 0;
+};
+
+/// Statistics accumulated over a whole run, instead of the last second
+struct Totals {
+    Accumulator frame;
+    Accumulator pagePaint;
+    /// The RenderJob%s, by source (i.e. the XojPageView they render)
+    std::unordered_map<const void*, Accumulator> renderJobs;
+    int64_t pdfLookups = 0;
+    int64_t pdfHits = 0;
+};
+
+/**
+ * @brief Enable the statistics and start accumulating the Totals. Must be called before the render threads are started.
+ */
+void startTotals();
+
+/// The Totals accumulated since startTotals() or since the previous call, which starts new ones
+Totals takeTotals();
+
+/// Time since an arbitrary point, in microseconds
+int64_t now();
+
+/// A page was painted by XojPageView::paintPage in `duration` us
+void recordPagePaint(int64_t duration);
+
+/// A job of the given priority waited `duration` us in the queue of the scheduler before it started
+void recordJobWait(JobPriority priority, int64_t duration);
+
+/// A RenderJob for `source` ran for `duration` us
+void recordRenderJob(const void* source, int64_t duration);
+
+/// The PdfCache was asked for a page, which was found at the right resolution iff `hit`
+void recordPdfCacheLookup(bool hit, size_t usedMemory, size_t maxMemory);
+
+/// An input event was handled by the PenInputHandler. Only the first one since the last frame counts.
+void recordInput();
+
+/**
+ * @brief A frame of the main view, started at `frameStart`, is complete.
+ * In HUD mode, paints the summary at (x, y) of the (widget coordinates) cairo context.
+ * @return true if the summary changed, so that the HUD should be repainted
+ */
+bool endFrame(int64_t frameStart, cairo_t* cr, double x, double y,
+              const std::array<size_t, JOB_N_PRIORITIES>& queueDepths);
+
+/// Size of the HUD, in widget coordinates
+constexpr int HUD_WIDTH = 340;
+constexpr int HUD_HEIGHT = 124;
+
+}  // namespace xoj::perf
@@ -1,58 +1,247 @@
 #include "PrintHandler.h"
 
-#include <cmath>   // for M_PI_2
-#include <memory>  // for __shared_ptr_access
-#include <string>  // for string
+#include <algorithm>           // for clamp, find
+#include <cmath>               // for M_PI_2
+#include <condition_variable>  // for condition_variable
+#include <deque>               // for deque
+#include <iterator>            // for next
+#include <memory>              // for enable_shared_from_this, make_shared
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <string>              // for string
+#include <thread>              // for thread
+#include <unordered_map>       // for unordered_map
+#include <unordered_set>       // for unordered_set
+#include <utility>             // for move, exchange
+#include <vector>              // for vector
 
 #include <cairo.h>        // for cairo_rotate, cairo_translate, cairo_t
 #include <config-dev.h>   // for PRINT_CONFIG_FILE
 #include <glib-object.h>  // for g_object_unref, G_CALLBACK, g_signa...
 #include <glib.h>         // for GError, g_error_free, g_warning
 
-#include "model/Document.h"       // for Document
-#include "model/PageRef.h"        // for PageRef
-#include "model/PageType.h"       // for PageType
-#include "model/XojPage.h"        // for XojPage
-#include "pdf/base/XojPdfPage.h"  // for XojPdfPageSPtr, XojPdfPage
-#include "util/Assert.h"          // for xoj_assert
-#include "util/PathUtil.h"        // for getConfigFile
-#include "util/XojMsgBox.h"       // for XojMsgBox
-#include "util/i18n.h"            // for _
-#include "util/safe_casts.h"      // for strict_cast
-#include "view/DocumentView.h"    // for DocumentView
+#include "model/Document.h"           // for Document
+#include "model/PageRef.h"            // for PageRef
+#include "model/PageType.h"           // for PageType
+#include "model/XojPage.h"            // for XojPage
+#include "pdf/base/XojPdfPage.h"      // for XojPdfPageSPtr, XojPdfPage
+#include "util/Assert.h"              // for xoj_assert
+#include "util/PathUtil.h"            // for getConfigFile
+#include "util/Util.h"                // for execInUiThread, npos
+#include "util/XojMsgBox.h"           // for XojMsgBox
+#include "util/i18n.h"                // for _
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr, CairoSPtr
+#include "util/raii/GObjectSPtr.h"    // for GObjectSPtr
+#include "util/safe_casts.h"          // for strict_cast
+#include "view/DocumentView.h"        // for DocumentView
 
 #include "filesystem.h"  // for exists, remove, path
 
 namespace {
-void drawPage(GtkPrintOperation* /*operation*/, GtkPrintContext* context, int pageNr, Document* doc) {
-    cairo_t* cr = gtk_print_context_get_cairo_context(context);
+/**
+ * @brief Renders the pages to print on worker threads, into recording surfaces, ahead of the draw-page requests of
+ * GTK. A page which is not rendered yet when GTK asks for it is drawn later (see
+ * gtk_print_operation_set_defer_drawing), so that the main loop (and the progress dialog) keeps running meanwhile.
+ *
+ * The document is locked by the caller during the whole print operation: the workers do not lock it.
+ */
+class PrintRenderer: public std::enable_shared_from_this<PrintRenderer> {
+public:
+    PrintRenderer(Document* doc, size_t lookAhead): doc(doc), lookAhead(lookAhead) {
+        const unsigned int workerCount = std::clamp(std::thread::hardware_concurrency(), 1U, MAX_WORKERS);
+        for (unsigned int i = 0; i < workerCount; i++) { this->workers.emplace_back([this]() { run(); }); }
+    }
 
-    PageRef page = doc->getPage(static_cast<size_t>(pageNr));
-    if (!page) {
-        return;
+    ~PrintRenderer() { stop(); }
+
+    /**
+     * Stop the workers, before the document is unlocked. The pages being rendered are finished first.
+     */
+    void stop() {
+        {
+            std::lock_guard lock(this->mutex);
+            this->stopping = true;
+        }
+        this->cond.notify_all();
+        for (auto& w: this->workers) { w.join(); }
+        this->workers.clear();
     }
 
-    double width = page->getWidth();
-    double height = page->getHeight();
+    void drawPage(GtkPrintOperation* op, GtkPrintContext* context, size_t pageNr) {
+        xoj::util::CairoSurfaceSPtr rendering;
+        {
+            std::lock_guard lock(this->mutex);
+            // The pages may be printed in reverse order
+            const bool backwards = this->lastPage != npos && pageNr < this->lastPage;
+            this->lastPage = pageNr;
 
-    if (width > height) {
-        cairo_rotate(cr, M_PI_2);
-        cairo_translate(cr, 0, -height);
+            // Keep the renderings ahead of this page only
+            for (auto it = this->rendered.begin(); it != this->rendered.end();) {
+                const bool ahead = backwards ? it->first <= pageNr && it->first + this->lookAhead >= pageNr :
+                                               it->first >= pageNr && it->first <= pageNr + this->lookAhead;
+                it = ahead ? std::next(it) : this->rendered.erase(it);
+            }
+
+            queue(pageNr, true);
+            for (size_t i = 1; i <= this->lookAhead; i++) {
+                if (backwards && i > pageNr) {
+                    break;
+                }
+                queue(backwards ? pageNr - i : pageNr + i, false);
+            }
+
+            if (auto it = this->rendered.find(pageNr); it != this->rendered.end()) {
+                rendering = std::move(it->second);
+                this->rendered.erase(it);
+            } else {
+                // Drawn once a worker has rendered the page
+                gtk_print_operation_set_defer_drawing(op);
+                this->awaitedPage = pageNr;
+                this->awaitedOperation.reset(op, xoj::util::ref);
+                this->awaitedContext = context;
+            }
+        }
+        this->cond.notify_all();
+
+        if (rendering) {
+            paint(gtk_print_context_get_cairo_context(context), pageNr, rendering.get());
+        }
     }
 
-    // For better quality printing, we use a dedicated pdf-renderer in this case
-    if (page->getBackgroundType().isPdfPage()) {
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(page->getPdfPageNr());
-        if (popplerPage) {
-            popplerPage->renderForPrinting(cr);
+    /// More threads would only contend for the pdf library
+    static constexpr unsigned int MAX_WORKERS = 4;
+
+private:
+    /**
+     * Queue the rendering of the page, unless it is rendered or being rendered. The mutex must be held.
+     * @param first If true, the page is rendered before the pages queued so far
+     */
+    void queue(size_t pageNr, bool first) {
+        if (pageNr >= this->doc->getPageCount() || this->rendered.count(pageNr) || this->inProgress.count(pageNr)) {
+            return;
+        }
+        auto it = std::find(this->queued.begin(), this->queued.end(), pageNr);
+        if (it != this->queued.end()) {
+            if (!first) {
+                return;
+            }
+            this->queued.erase(it);
+        }
+        if (first) {
+            this->queued.push_front(pageNr);
+        } else {
+            this->queued.push_back(pageNr);
         }
     }
 
-    xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL;
-    flags.showPDF = xoj::view::HIDE_PDF_BACKGROUND;  // Already printed (if any)
+    void run() {
+        std::unique_lock lock(this->mutex);
+        while (true) {
+            this->cond.wait(lock, [this]() { return this->stopping || !this->queued.empty(); });
+            if (this->stopping) {
+                return;
+            }
+            const size_t pageNr = this->queued.front();
+            this->queued.pop_front();
+            this->inProgress.insert(pageNr);
+
+            lock.unlock();
+            auto rendering = render(pageNr);
+            lock.lock();
+
+            this->inProgress.erase(pageNr);
+            this->rendered[pageNr] = std::move(rendering);
+            if (this->awaitedPage == pageNr) {
+                Util::execInUiThread([self = shared_from_this()]() { self->drawAwaitedPage(); });
+            }
+        }
+    }
+
+    /**
+     * Draw the page GTK is waiting for, and let GTK continue. Called on the UI thread.
+     */
+    void drawAwaitedPage() {
+        xoj::util::CairoSurfaceSPtr rendering;
+        xoj::util::GObjectSPtr<GtkPrintOperation> op;
+        GtkPrintContext* context = nullptr;
+        size_t pageNr = npos;
+        {
+            std::lock_guard lock(this->mutex);
+            auto it = this->rendered.find(this->awaitedPage);
+            if (it == this->rendered.end()) {
+                return;
+            }
+            rendering = std::move(it->second);
+            this->rendered.erase(it);
+            pageNr = std::exchange(this->awaitedPage, npos);
+            op = std::move(this->awaitedOperation);
+            context = std::exchange(this->awaitedContext, nullptr);
+        }
+        paint(gtk_print_context_get_cairo_context(context), pageNr, rendering.get());
+        gtk_print_operation_draw_page_finish(op.get());
+    }
+
+    /**
+     * Record the page, in page coordinates
+     */
+    auto render(size_t pageNr) const -> xoj::util::CairoSurfaceSPtr {
+        PageRef page = this->doc->getPage(pageNr);
+        cairo_rectangle_t extents = {0, 0, page->getWidth(), page->getHeight()};
+        xoj::util::CairoSurfaceSPtr surface(cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents),
+                                            xoj::util::adopt);
+        xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+
+        // For better quality printing, we use a dedicated pdf-renderer in this case
+        if (page->getBackgroundType().isPdfPage()) {
+            XojPdfPageSPtr popplerPage = this->doc->getPdfPage(page->getPdfPageNr());
+            if (popplerPage) {
+                popplerPage->renderForPrinting(cr.get());
+            }
+        }
+
+        xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL;
+        flags.showPDF = xoj::view::HIDE_PDF_BACKGROUND;  // Already printed (if any)
+
+        DocumentView view;
+        view.drawPage(page, cr.get(), true /* dont render eraseable */, flags);
+        return surface;
+    }
+
+    /**
+     * Replay the recorded page on the print context. The vector operations are kept.
+     */
+    void paint(cairo_t* cr, size_t pageNr, cairo_surface_t* rendering) const {
+        PageRef page = this->doc->getPage(pageNr);
+        if (page->getWidth() > page->getHeight()) {
+            cairo_rotate(cr, M_PI_2);
+            cairo_translate(cr, 0, -page->getHeight());
+        }
+        cairo_set_source_surface(cr, rendering, 0, 0);
+        cairo_paint(cr);
+    }
+
+private:
+    Document* doc;
+    size_t lookAhead;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool stopping = false;
+
+    std::deque<size_t> queued;
+    std::unordered_set<size_t> inProgress;
+    std::unordered_map<size_t, xoj::util::CairoSurfaceSPtr> rendered;
+    size_t lastPage = npos;
+
+    /// The page whose drawing was deferred
+    size_t awaitedPage = npos;
+    xoj::util::GObjectSPtr<GtkPrintOperation> awaitedOperation;
+    GtkPrintContext* awaitedContext = nullptr;
+
+    std::vector<std::thread> workers;
+};
 
-    DocumentView view;
-    view.drawPage(page, cr, true /* dont render eraseable */, flags);
+void drawPage(GtkPrintOperation* operation, GtkPrintContext* context, int pageNr, PrintRenderer* renderer) {
+    renderer->drawPage(operation, context, static_cast<size_t>(pageNr));
 }
 
 void requestPageSetup(GtkPrintOperation* /*op*/, GtkPrintContext* /*ctx*/, int pageNr, GtkPageSetup* setup,
@@ -86,7 +275,7 @@ inline void handlePrintError(GError*& error, const char* message) {
 }  // namespace
 
 // Todo: maybe loop over this twice,
-void PrintHandler::print(Document* doc, size_t currentPage, GtkWindow* parent) {
+void PrintHandler::print(Document* doc, size_t currentPage, GtkWindow* parent, size_t lookAhead) {
     GtkPrintSettings* settings{};
     auto filepath = Util::getConfigFile(PRINT_CONFIG_FILE);
     if (fs::exists(filepath)) {
@@ -106,7 +295,10 @@ void PrintHandler::print(Document* doc, size_t currentPage, GtkWindow* parent) {
     gtk_print_operation_set_job_name(op, "Xournal++");
     gtk_print_operation_set_unit(op, GTK_UNIT_POINTS);
     gtk_print_operation_set_use_full_page(op, true);
-    g_signal_connect(op, "draw_page", G_CALLBACK(drawPage), doc);
+    // The pages are rendered in the background: the progress dialog stays responsive
+    gtk_print_operation_set_show_progress(op, true);
+    auto renderer = std::make_shared<PrintRenderer>(doc, lookAhead);
+    g_signal_connect(op, "draw_page", G_CALLBACK(drawPage), renderer.get());
     g_signal_connect(op, "request-page-setup", G_CALLBACK(requestPageSetup), doc);
 
     GError* error{};
@@ -123,5 +315,6 @@ void PrintHandler::print(Document* doc, size_t currentPage, GtkWindow* parent) {
         g_error_free(error);
     }
 
+    renderer->stop();
     g_object_unref(op);
 }
@@ -18,5 +18,9 @@
 class Document;
 
 namespace PrintHandler {
-void print(Document* doc, size_t currentPage, GtkWindow* parent);
+/**
+ * Print the document. The document must be locked during the whole call.
+ * @param lookAhead The number of pages rendered in the background ahead of the page being printed
+ */
+void print(Document* doc, size_t currentPage, GtkWindow* parent, size_t lookAhead);
 }
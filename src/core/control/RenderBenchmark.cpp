@@ -0,0 +1,187 @@
+#include "RenderBenchmark.h"
+
+#include <cmath>    // for abs
+#include <cstddef>  // for size_t
+#include <iomanip>  // for setprecision, setw
+#include <numeric>  // for accumulate
+#include <sstream>  // for ostringstream
+#include <utility>  // for move
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "control/settings/Settings.h"      // for Settings
+#include "control/zoom/ZoomControl.h"       // for ZoomControl
+#include "gui/Layout.h"                     // for Layout
+#include "gui/MainWindow.h"                 // for MainWindow
+#include "gui/PageView.h"                   // for XojPageView
+#include "gui/XournalView.h"                // for XournalView
+#include "model/Document.h"                 // for Document
+#include "util/Rectangle.h"                 // for Rectangle
+
+namespace {
+/// The scroll per frame, relative to the height of the visible area
+constexpr double SCROLL_STEP = 0.125;
+/// Frames before the queues of the scheduler are looked at, for the changes of zoom and of the layout to be applied
+constexpr int SETTLE_MIN_FRAMES = 10;
+/// The longest wait for the render jobs, in us: the benchmark never gets stuck on a job
+constexpr int64_t MAX_WAIT = 30 * G_USEC_PER_SEC;
+
+auto ms(int64_t us) -> double { return static_cast<double>(us) / 1000.0; }
+
+auto percent(int64_t part, int64_t total) -> double {
+    return total == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(total);
+}
+
+auto onOff(bool value) -> const char* { return value ? "on" : "off"; }
+}  // namespace
+
+RenderBenchmark::RenderBenchmark(Control* control, std::function<void(const std::string& report)> onFinished):
+        control(control), onFinished(std::move(onFinished)) {}
+
+RenderBenchmark::~RenderBenchmark() {
+    if (this->tickCallback != 0) {
+        gtk_widget_remove_tick_callback(this->widget, this->tickCallback);
+    }
+}
+
+void RenderBenchmark::start() {
+    this->widget = this->control->getWindow()->getXournal()->getWidget();
+    this->levels.clear();
+    startLevel();
+    this->tickCallback = gtk_widget_add_tick_callback(this->widget, tick, this, nullptr);
+}
+
+auto RenderBenchmark::tick(GtkWidget*, GdkFrameClock*, gpointer self) -> gboolean {
+    auto* benchmark = static_cast<RenderBenchmark*>(self);
+    if (benchmark->advance()) {
+        return G_SOURCE_CONTINUE;
+    }
+    benchmark->tickCallback = 0;
+    benchmark->onFinished(benchmark->toString());
+    return G_SOURCE_REMOVE;
+}
+
+void RenderBenchmark::startLevel() {
+    ZoomControl* zoomControl = this->control->getZoomControl();
+    zoomControl->setZoomFitMode(false);
+    const double zoom = ZOOM_LEVELS[this->levels.size()];
+    zoomControl->setZoom(zoom * zoomControl->getZoom100Value());
+
+    this->levels.push_back({zoom});
+    this->phase = Phase::SETTLE;
+    this->phaseStart = xoj::perf::now();
+    this->phaseFrames = 0;
+}
+
+auto RenderBenchmark::isSchedulerIdle() const -> bool {
+    const auto depths = this->control->getScheduler()->getQueueDepths();
+    return std::accumulate(depths.begin(), depths.end(), size_t{0}) == 0;
+}
+
+auto RenderBenchmark::advance() -> bool {
+    const int64_t now = xoj::perf::now();
+    const bool waitedTooLong = now - this->phaseStart >= MAX_WAIT;
+    this->phaseFrames++;
+    Layout* layout = this->control->getWindow()->getLayout();
+    Level& level = this->levels.back();
+
+    switch (this->phase) {
+        case Phase::SETTLE:
+            // Until the layout of the new zoom is applied
+            layout->scrollAbs(0, 0);
+            if (this->phaseFrames < SETTLE_MIN_FRAMES || (!isSchedulerIdle() && !waitedTooLong)) {
+                return true;
+            }
+            // The rendering of the top of the document is not measured
+            xoj::perf::takeTotals();
+            this->phase = Phase::SCROLL;
+            this->phaseStart = now;
+            return true;
+
+        case Phase::SCROLL: {
+            const auto before = layout->getVisibleRect();
+            const double step = before.height * SCROLL_STEP;
+            layout->scrollRelative(0, step);
+            const auto after = layout->getVisibleRect();
+            if (std::abs(after.y - before.y) >= step - 0.5) {
+                return true;
+            }
+            // At the bottom
+            level.scrollTime = now - this->phaseStart;
+            level.scroll = xoj::perf::takeTotals();
+            this->phase = Phase::DRAIN;
+            this->phaseStart = now;
+            return true;
+        }
+
+        case Phase::DRAIN:
+            if (!isSchedulerIdle() && !waitedTooLong) {
+                return true;
+            }
+            level.drain = xoj::perf::takeTotals();
+            if (this->levels.size() == ZOOM_LEVELS.size()) {
+                return false;
+            }
+            startLevel();
+            return true;
+    }
+    return false;
+}
+
+auto RenderBenchmark::toString() const -> std::string {
+    XournalView* xournal = this->control->getWindow()->getXournal();
+    Settings* settings = this->control->getSettings();
+    Document* doc = this->control->getDocument();
+    doc->lock();
+    const std::string document = doc->getFilepath().u8string();
+    const size_t pageCount = doc->getPageCount();
+    doc->unlock();
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "Render benchmark of \"" << document << "\": " << pageCount << " pages, DPI scaling "
+        << xournal->getDpiScaleFactor() << "\n";
+    out << "  Render workers: " << settings->getRenderWorkerCount() << " (0: automatic), PDF cache "
+        << settings->getPdfPageCacheMemory() << " MiB, draft rendering " << onOff(settings->isDraftRendering())
+        << ", blit on scroll " << onOff(settings->isBlitOnScroll()) << "\n";
+
+    const auto& views = xournal->getViewPages();
+    for (const Level& level: this->levels) {
+        const double seconds = static_cast<double>(level.scrollTime) / G_USEC_PER_SEC;
+        const auto& frame = level.scroll.frame;
+        const auto& paint = level.scroll.pagePaint;
+        int64_t scrollJobs = 0;
+        int64_t drainJobs = 0;
+        for (const auto& [source, jobs]: level.scroll.renderJobs) { scrollJobs += jobs.count; }
+        for (const auto& [source, jobs]: level.drain.renderJobs) { drainJobs += jobs.count; }
+        const int64_t pdfLookups = level.scroll.pdfLookups + level.drain.pdfLookups;
+        const int64_t pdfHits = level.scroll.pdfHits + level.drain.pdfHits;
+
+        out << "Zoom " << std::setprecision(0) << level.zoom * 100 << "%" << std::setprecision(2) << ": "
+            << frame.count << " frames in " << seconds << " s ("
+            << (seconds > 0 ? static_cast<double>(frame.count) / seconds : 0.0) << " fps), frame avg "
+            << frame.avgMs() << " ms, max " << frame.maxMs() << " ms\n";
+        out << "  Page paints: " << paint.count << ", avg " << paint.avgMs() << " ms, max " << paint.maxMs()
+            << " ms\n";
+        out << "  Render jobs: " << scrollJobs << " while scrolling, " << drainJobs << " after\n";
+        out << "  PDF cache: " << std::setprecision(1) << percent(pdfHits, pdfLookups) << "% hits of " << pdfLookups
+            << " lookups" << std::setprecision(2) << "\n";
+
+        out << "  " << std::setw(6) << "page" << std::setw(6) << "jobs" << std::setw(10) << "avg ms" << std::setw(10)
+            << "max ms" << std::setw(10) << "total ms" << "\n";
+        for (size_t i = 0; i < views.size(); i++) {
+            xoj::perf::Accumulator jobs;
+            for (const auto* totals: {&level.scroll, &level.drain}) {
+                if (auto it = totals->renderJobs.find(views[i].get()); it != totals->renderJobs.end()) {
+                    jobs.merge(it->second);
+                }
+            }
+            if (jobs.count == 0) {
+                continue;
+            }
+            out << "  " << std::setw(6) << i + 1 << std::setw(6) << jobs.count << std::setw(10) << jobs.avgMs()
+                << std::setw(10) << jobs.maxMs() << std::setw(10) << ms(jobs.sum) << "\n";
+        }
+    }
+    return out.str();
+}
@@ -0,0 +1,94 @@
+/*
+ * Xournal++
+ *
+ * Scrolls through the document at several zoom levels and measures the rendering (--benchmark-render)
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>       // for array
+#include <cstdint>     // for int64_t
+#include <functional>  // for function
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include <glib.h>     // for gboolean, guint, gpointer
+#include <gtk/gtk.h>  // for GtkWidget, GdkFrameClock
+
+#include "control/PerfStats.h"  // for Totals
+
+class Control;
+
+/**
+ * @brief Drives the main view like a user would, but in a repeatable way: at each zoom level, the document is scrolled
+ * from top to bottom by a fixed step per frame, through the real Layout, XojPageView and RenderJob pipeline. The
+ * frames per second, the times of the page paints and of the render jobs (per page) and the hit rate of the PdfCache
+ * are then reported, for the bug reports and to compare the settings.
+ *
+ * The statistics are taken from xoj::perf: xoj::perf::startTotals() must be called before the render threads start.
+ */
+class RenderBenchmark {
+public:
+    /// The zoom levels, relative to 100%
+    static constexpr std::array<double, 3> ZOOM_LEVELS = {0.5, 1.0, 2.0};
+
+    /**
+     * @param onFinished Called with the report, once the document has been scrolled through at all the zoom levels
+     */
+    RenderBenchmark(Control* control, std::function<void(const std::string& report)> onFinished);
+    ~RenderBenchmark();
+
+    RenderBenchmark(const RenderBenchmark&) = delete;
+    RenderBenchmark& operator=(const RenderBenchmark&) = delete;
+
+    /// Start scrolling. The document must be loaded.
+    void start();
+
+private:
+    enum class Phase {
+        /// The zoom is applied and the top of the document is rendered, which is not measured
+        SETTLE,
+        /// Scrolling down, one step per frame
+        SCROLL,
+        /// At the bottom, the render jobs queued while scrolling finish
+        DRAIN
+    };
+
+    struct Level {
+        double zoom = 1.0;
+        /// In us
+        int64_t scrollTime = 0;
+        xoj::perf::Totals scroll;
+        xoj::perf::Totals drain;
+    };
+
+    static gboolean tick(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+
+    /// Called once per frame. @return false once the benchmark is over
+    bool advance();
+
+    void startLevel();
+
+    /// @return true if no job is waiting in the queues of the scheduler
+    bool isSchedulerIdle() const;
+
+    std::string toString() const;
+
+private:
+    Control* control;
+    std::function<void(const std::string& report)> onFinished;
+
+    GtkWidget* widget = nullptr;
+    guint tickCallback = 0;
+
+    Phase phase = Phase::SETTLE;
+    int64_t phaseStart = 0;
+    int phaseFrames = 0;
+
+    std::vector<Level> levels;
+};
@@ -5,24 +5,66 @@
 
 #include "model/Element.h"                   // for Element, ELEMENT_TEXT
 #include "model/Layer.h"                     // for Layer
+#include "model/PdfTextIndex.h"              // for PdfTextIndex
 #include "model/Text.h"                      // for Text
 #include "model/XojPage.h"                   // for XojPage
 #include "view/overlays/SearchResultView.h"  // for SEARCH_CHANGED_NOTIFICATION
 
-SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf):
+SearchControl::SearchControl(const PageRef& page, XojPdfPageSPtr pdf,
+                             std::shared_ptr<const PdfTextIndex> textIndex):
         page(page),
         pdf(std::move(pdf)),
+        textIndex(std::move(textIndex)),
         viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::SearchResultView>>()) {}
 
 SearchControl::~SearchControl() = default;
 
+void SearchControl::setResults(const std::string& text, std::vector<XojPdfRectangle> results) {
+    if (text == this->currentText) {
+        // Keep the highlighted match
+        return;
+    }
+    this->highlightRect = nullptr;
+    this->currentText = text;
+    this->results = std::move(results);
+    this->viewPool->dispatch(xoj::view::SearchResultView::SEARCH_CHANGED_NOTIFICATION);
+}
+
+auto SearchControl::findTextInPdf(XojPdfPage& pdf, size_t pdfPageNr, const PdfTextIndex* textIndex,
+                                  const std::string& text) -> std::vector<XojPdfRectangle> {
+    // Asking poppler for the text of the page is slow: skip the pages known not to contain it
+    if (textIndex && !textIndex->mayContain(pdfPageNr, text)) {
+        return {};
+    }
+    return pdf.findText(text);
+}
+
+auto SearchControl::findTextInTexts(const PageRef& page, const std::string& text) -> std::vector<XojPdfRectangle> {
+    std::vector<XojPdfRectangle> results;
+    for (Layer* l: *page->getLayers()) {
+        if (!l->isVisible()) {
+            continue;
+        }
+
+        for (auto&& e: l->getElements()) {
+            if (e->getType() == ELEMENT_TEXT) {
+                Text* t = dynamic_cast<Text*>(e.get());
+
+                std::vector<XojPdfRectangle> textResult = t->findText(text);
+                results.insert(results.end(), textResult.begin(), textResult.end());
+            }
+        }
+    }
+    return results;
+}
+
 auto SearchControl::search(const std::string& text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect)
         -> bool {
     this->highlightRect = nullptr;
     if (text.empty()) {
+        this->currentText.clear();
         if (!this->results.empty()) {
             this->results.clear();
-            this->currentText.clear();
             this->viewPool->dispatch(xoj::view::SearchResultView::SEARCH_CHANGED_NOTIFICATION);
         }
         return true;
@@ -33,23 +75,10 @@ auto SearchControl::search(const std::string& text, size_t index, size_t* occurr
         this->currentText = text;
 
         if (this->pdf) {
-            this->results = this->pdf->findText(text);
-        }
-
-        for (Layer* l: *this->page->getLayers()) {
-            if (!l->isVisible()) {
-                continue;
-            }
-
-            for (auto&& e: l->getElements()) {
-                if (e->getType() == ELEMENT_TEXT) {
-                    Text* t = dynamic_cast<Text*>(e.get());
-
-                    std::vector<XojPdfRectangle> textResult = t->findText(text);
-                    this->results.insert(this->results.end(), textResult.begin(), textResult.end());
-                }
-            }
+            this->results = findTextInPdf(*this->pdf, this->page->getPdfPageNr(), this->textIndex.get(), text);
         }
+        auto textResults = findTextInTexts(this->page, text);
+        this->results.insert(this->results.end(), textResults.begin(), textResults.end());
     }
 
     this->viewPool->dispatch(xoj::view::SearchResultView::SEARCH_CHANGED_NOTIFICATION);
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <memory>  // for shared_ptr
 #include <string>  // for string
 #include <vector>  // for vector
 
@@ -20,6 +21,8 @@
 #include "pdf/base/XojPdfPage.h"  // for XojPdfPageSPtr, XojPdfRectangle
 #include "util/DispatchPool.h"
 
+class PdfTextIndex;
+
 namespace xoj::view {
 class OverlayView;
 class Repaintable;
@@ -28,11 +31,32 @@ class SearchResultView;
 
 class SearchControl: public OverlayBase {
 public:
-    SearchControl(const PageRef& page, XojPdfPageSPtr pdf);
+    /**
+     * @param textIndex If set, the pdf page is only searched if the index does not rule it out
+     */
+    SearchControl(const PageRef& page, XojPdfPageSPtr pdf, std::shared_ptr<const PdfTextIndex> textIndex = nullptr);
     virtual ~SearchControl();
 
     bool search(const std::string& text, size_t index, size_t* occurrences, XojPdfRectangle* UpperMostMatch);
 
+    /**
+     * Use the matches of the text found elsewhere (e.g. by a SearchJob), unless the text is already searched
+     */
+    void setResults(const std::string& text, std::vector<XojPdfRectangle> results);
+
+    /**
+     * @return The matches of the text on the pdf page, none if the index rules the page out
+     * May be called from any thread
+     */
+    static std::vector<XojPdfRectangle> findTextInPdf(XojPdfPage& pdf, size_t pdfPageNr,
+                                                      const PdfTextIndex* textIndex, const std::string& text);
+
+    /**
+     * @return The matches of the text in the Text elements of the visible layers of the page
+     * The document must be locked if not called from the UI thread
+     */
+    static std::vector<XojPdfRectangle> findTextInTexts(const PageRef& page, const std::string& text);
+
     const std::vector<XojPdfRectangle>& getResults() const { return results; }
 
     const XojPdfRectangle* getHighlightRect() const { return highlightRect; }
@@ -44,6 +68,7 @@ public:
 private:
     PageRef page;
     XojPdfPageSPtr pdf;
+    std::shared_ptr<const PdfTextIndex> textIndex;
     std::string currentText;
     XojPdfRectangle* highlightRect = nullptr;
 
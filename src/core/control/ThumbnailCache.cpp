@@ -0,0 +1,260 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>     // for sort
+#include <cstdio>        // for snprintf
+#include <fstream>       // for ifstream, ofstream
+#include <string>        // for string, getline, to_string
+#include <system_error>  // for error_code
+#include <type_traits>   // for is_trivially_copyable_v
+#include <utility>       // for move, pair
+#include <vector>        // for vector
+
+#include <glib.h>  // for g_warning
+
+#include "model/BackgroundImage.h"  // for BackgroundImage
+#include "model/Element.h"          // for Element, ELEMENT_STROKE, ...
+#include "model/Image.h"            // for Image
+#include "model/ImageBuffer.h"      // for ImageBuffer
+#include "model/Layer.h"            // for Layer
+#include "model/LineStyle.h"        // for LineStyle
+#include "model/PageType.h"         // for PageType
+#include "model/Point.h"            // for Point
+#include "model/Stroke.h"           // for Stroke
+#include "model/TexImage.h"         // for TexImage
+#include "model/Text.h"             // for Text
+#include "model/XojPage.h"          // for XojPage
+
+namespace {
+constexpr auto HEADER = "XOJ-THUMBNAIL/1.0";
+constexpr auto EXTENSION = ".thumbnail";
+
+/// 64 bit FNV-1a: stable from one session (and one build) to the next, unlike std::hash
+class Hasher {
+public:
+    void add(const void* data, size_t length) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; i++) {
+            hash ^= bytes[i];
+            hash *= PRIME;
+        }
+    }
+
+    template <typename T>
+    void add(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        add(&value, sizeof(T));
+    }
+
+    void add(const std::string& s) {
+        add(s.size());
+        add(s.data(), s.size());
+    }
+
+    auto get() const -> uint64_t { return hash; }
+
+private:
+    static constexpr uint64_t PRIME = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+};
+
+void hashElement(Hasher& h, const Element* e) {
+    h.add(static_cast<int>(e->getType()));
+    h.add(uint32_t(e->getColor()));
+    h.add(e->getX());
+    h.add(e->getY());
+    h.add(e->getElementWidth());
+    h.add(e->getElementHeight());
+
+    switch (e->getType()) {
+        case ELEMENT_STROKE: {
+            const auto* s = static_cast<const Stroke*>(e);
+            h.add(s->getWidth());
+            h.add(static_cast<int>(s->getToolType()));
+            h.add(s->getFill());
+            const auto& dashes = s->getLineStyle().getDashes();
+            h.add(dashes.size());
+            h.add(dashes.data(), dashes.size() * sizeof(double));
+            const auto& points = s->getPointVector();
+            h.add(points.size());
+            for (const Point& p: points) {
+                h.add(p.x);
+                h.add(p.y);
+                h.add(p.z);
+            }
+            break;
+        }
+        case ELEMENT_TEXT: {
+            const auto* t = static_cast<const Text*>(e);
+            h.add(t->getText());
+            h.add(t->getFontName());
+            h.add(t->getFontSize());
+            break;
+        }
+        case ELEMENT_IMAGE: {
+            const auto* img = static_cast<const Image*>(e);
+            h.add(img->getRawDataLength());
+            h.add(img->getRawData(), img->getRawDataLength());
+            break;
+        }
+        case ELEMENT_TEXIMAGE: {
+            h.add(static_cast<const TexImage*>(e)->getBinaryData());
+            break;
+        }
+    }
+}
+
+auto readFromStream(void* closure, unsigned char* data, unsigned int length) -> cairo_status_t {
+    auto* in = static_cast<std::ifstream*>(closure);
+    in->read(reinterpret_cast<char*>(data), length);
+    return in->gcount() == static_cast<std::streamsize>(length) ? CAIRO_STATUS_SUCCESS : CAIRO_STATUS_READ_ERROR;
+}
+
+auto writeToStream(void* closure, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    auto* out = static_cast<std::ofstream*>(closure);
+    out->write(reinterpret_cast<const char*>(data), length);
+    return out->good() ? CAIRO_STATUS_SUCCESS : CAIRO_STATUS_WRITE_ERROR;
+}
+
+auto getPageFile(const fs::path& documentFolder, size_t pageIndex) -> fs::path {
+    return documentFolder / (std::to_string(pageIndex) + EXTENSION);
+}
+}  // namespace
+
+ThumbnailCache::ThumbnailCache(fs::path folder): folder(std::move(folder)) {}
+
+auto ThumbnailCache::getDocumentFolder(const fs::path& file) const -> fs::path {
+    Hasher h;
+    h.add(file.u8string());
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(h.get()));
+    return this->folder / name;
+}
+
+auto ThumbnailCache::load(const fs::path& file, size_t pageIndex, uint64_t contentHash, int width, int height) const
+        -> xoj::util::CairoSurfaceSPtr {
+    std::ifstream in(getPageFile(getDocumentFolder(file), pageIndex), std::ios::binary);
+    std::string header;
+    std::string storedFile;
+    if (!std::getline(in, header) || header != HEADER || !std::getline(in, storedFile) ||
+        storedFile != file.u8string()) {
+        return {};
+    }
+    unsigned long long storedHash = 0;
+    int storedWidth = 0;
+    int storedHeight = 0;
+    if (!(in >> storedHash >> storedWidth >> storedHeight) || in.get() != '\n' || storedHash != contentHash ||
+        storedWidth != width || storedHeight != height) {
+        return {};
+    }
+
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create_from_png_stream(readFromStream, &in),
+                                        xoj::util::adopt);
+    if (cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS ||
+        cairo_image_surface_get_width(surface.get()) != width ||
+        cairo_image_surface_get_height(surface.get()) != height) {
+        return {};
+    }
+    return surface;
+}
+
+void ThumbnailCache::store(const fs::path& file, size_t pageIndex, uint64_t contentHash, cairo_surface_t* thumbnail) {
+    if (file.empty()) {
+        return;
+    }
+    std::lock_guard lock(this->mutex);
+
+    const auto documentFolder = getDocumentFolder(file);
+    std::error_code ec;
+    const bool newDocument = fs::create_directories(documentFolder, ec);
+    if (ec) {
+        g_warning("Could not create the thumbnail folder %s", documentFolder.u8string().c_str());
+        return;
+    }
+
+    // Written aside first, so that no half written thumbnail is ever read
+    const auto path = getPageFile(documentFolder, pageIndex);
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary);
+        out << HEADER << "\n" << file.u8string() << "\n";
+        out << static_cast<unsigned long long>(contentHash) << " " << cairo_image_surface_get_width(thumbnail) << " "
+            << cairo_image_surface_get_height(thumbnail) << "\n";
+        if (cairo_surface_write_to_png_stream(thumbnail, writeToStream, &out) != CAIRO_STATUS_SUCCESS || !out.good()) {
+            out.close();
+            fs::remove(tmpPath, ec);
+            return;
+        }
+    }
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        fs::remove(tmpPath, ec);
+        return;
+    }
+
+    // The modification time of the folders tells the recently used documents
+    fs::last_write_time(documentFolder, fs::file_time_type::clock::now(), ec);
+    if (newDocument) {
+        removeOldDocuments();
+    }
+}
+
+void ThumbnailCache::removeOldDocuments() {
+    std::vector<std::pair<fs::file_time_type, fs::path>> documents;
+    std::error_code ec;
+    for (const auto& entry: fs::directory_iterator(this->folder, ec)) {
+        if (entry.is_directory(ec)) {
+            documents.emplace_back(entry.last_write_time(ec), entry.path());
+        }
+    }
+    if (documents.size() <= MAX_DOCUMENTS) {
+        return;
+    }
+    std::sort(documents.begin(), documents.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = MAX_DOCUMENTS; i < documents.size(); i++) {
+        // Only remove the folders of the cache, made of thumbnails
+        bool onlyThumbnails = true;
+        for (const auto& f: fs::directory_iterator(documents[i].second, ec)) {
+            onlyThumbnails = onlyThumbnails && f.path().extension() == EXTENSION;
+        }
+        if (onlyThumbnails) {
+            fs::remove_all(documents[i].second, ec);
+        } else {
+            g_warning("Not removing %s: it is not a thumbnail folder", documents[i].second.u8string().c_str());
+        }
+    }
+}
+
+auto ThumbnailCache::hashPage(XojPage& page, const fs::path& pdfFile) -> uint64_t {
+    Hasher h;
+    h.add(page.getWidth());
+    h.add(page.getHeight());
+
+    PageType type = page.getBackgroundType();
+    h.add(static_cast<int>(type.format));
+    h.add(type.config);
+    h.add(uint32_t(page.getBackgroundColor()));
+    h.add(page.isLayerVisible(0));
+    if (type.isPdfPage()) {
+        h.add(page.getPdfPageNr());
+        h.add(pdfFile.u8string());
+        std::error_code ec;
+        h.add(fs::last_write_time(pdfFile, ec).time_since_epoch().count());
+    } else if (type.isImagePage()) {
+        if (auto buffer = page.getBackgroundImage().getBuffer()) {
+            h.add(buffer->getData());
+        } else {
+            h.add(page.getBackgroundImage().getFilepath().u8string());
+        }
+    }
+
+    for (const Layer* l: *page.getLayers()) {
+        h.add(l->isVisible());
+        const auto& elements = l->getElements();
+        h.add(elements.size());
+        for (const auto& e: elements) {
+            hashElement(h, e.get());
+        }
+    }
+    return h.get();
+}
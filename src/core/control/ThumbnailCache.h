@@ -0,0 +1,77 @@
+/*
+ * Xournal++
+ *
+ * Caches the page thumbnails of the sidebar on disk, from one session to the next
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <mutex>    // for mutex
+
+#include <cairo.h>  // for cairo_surface_t
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+#include "filesystem.h"  // for path
+
+class XojPage;
+
+/**
+ * @brief Stores the thumbnails of the pages of the recent documents, so that reopening a document shows its sidebar
+ * without rendering the pages again.
+ *
+ * Each document has a folder, named after a hash of its path, with one file per page index. A file holds the hash of
+ * the content of the page the thumbnail was rendered from: only the pages changed in the meantime get rendered again.
+ *
+ * The methods may be called from any thread.
+ */
+class ThumbnailCache {
+public:
+    /**
+     * @param folder The folder of the cache, usually Util::getCacheSubfolder("thumbnails")
+     */
+    explicit ThumbnailCache(fs::path folder);
+
+    /**
+     * @return The thumbnail stored for the page of the file, if it was rendered from the same content and has the given
+     * size in pixels, or nullptr
+     */
+    xoj::util::CairoSurfaceSPtr load(const fs::path& file, size_t pageIndex, uint64_t contentHash, int width,
+                                     int height) const;
+
+    /**
+     * Store the thumbnail of the page of the file, replacing the previous one.
+     * The thumbnails of the least recently stored documents are removed beyond MAX_DOCUMENTS.
+     */
+    void store(const fs::path& file, size_t pageIndex, uint64_t contentHash, cairo_surface_t* thumbnail);
+
+    /**
+     * @return A hash of everything which shows in a thumbnail of the page: its size, background and elements.
+     * The caller must hold the document lock.
+     *
+     * @param pdfFile The PDF file of the document, if any: its modification time is part of the hash
+     */
+    static uint64_t hashPage(XojPage& page, const fs::path& pdfFile);
+
+    /// The number of documents whose thumbnails are kept
+    static constexpr size_t MAX_DOCUMENTS = 20;
+
+private:
+    fs::path getDocumentFolder(const fs::path& file) const;
+
+    /// Remove the folders of the least recently stored documents, beyond MAX_DOCUMENTS
+    void removeOldDocuments();
+
+private:
+    fs::path folder;
+
+    /// Serializes the changes of the folder of the cache
+    std::mutex mutex;
+};
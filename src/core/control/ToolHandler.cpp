@@ -5,7 +5,7 @@
 #include <cstdio>     // for size_t
 #include <optional>   // for nullopt, optional
 #include <string>     // for operator==, string, basic_string
-#include <utility>    // for move
+#include <utility>    // for exchange, move
 
 #include <glib.h>  // for g_warning, g_error
 
@@ -192,10 +192,42 @@ void ToolHandler::selectTool(ToolType type) {
     this->activeTool = this->toolbarSelectedTool;
 }
 
-void ToolHandler::fireToolChanged() const {
-    for (auto&& listener: this->toolChangeListeners) { listener(this->activeTool->type); }
+void ToolHandler::fireToolChanged() { notifyChanged(CHANGE_TOOL); }
 
-    stateChangeListener->toolChanged();
+ToolHandler::ChangeBatch::ChangeBatch(ToolHandler& handler): handler(handler) { handler.batchDepth++; }
+
+ToolHandler::ChangeBatch::~ChangeBatch() {
+    if (--handler.batchDepth == 0) {
+        handler.sendChanges();
+    }
+}
+
+void ToolHandler::notifyChanged(Change change) {
+    this->pendingChanges |= change;
+    if (this->batchDepth == 0) {
+        sendChanges();
+    }
+}
+
+void ToolHandler::sendChanges() {
+    const unsigned changes = std::exchange(this->pendingChanges, 0U);
+    if (changes & CHANGE_TOOL) {
+        for (auto&& listener: this->toolChangeListeners) { listener(this->activeTool->type); }
+        this->stateChangeListener->toolChanged();
+        return;
+    }
+    if (changes & CHANGE_COLOR) {
+        this->stateChangeListener->toolColorChanged();
+    }
+    if (changes & CHANGE_SIZE) {
+        this->stateChangeListener->toolSizeChanged();
+    }
+    if (changes & CHANGE_FILL) {
+        this->stateChangeListener->toolFillChanged();
+    }
+    if (changes & CHANGE_LINE_STYLE) {
+        this->stateChangeListener->toolLineStyleChanged();
+    }
 }
 
 void ToolHandler::addToolChangedListener(ToolChangedCallback listener) {
@@ -236,7 +268,7 @@ void ToolHandler::setPenSize(ToolSize size) {
     this->tools[TOOL_PEN - TOOL_PEN]->setSize(size);
 
     if (this->activeTool->type == TOOL_PEN) {
-        this->stateChangeListener->toolSizeChanged();
+        notifyChanged(CHANGE_SIZE);
     }
 }
 
@@ -244,7 +276,7 @@ void ToolHandler::setEraserSize(ToolSize size) {
     this->tools[TOOL_ERASER - TOOL_PEN]->setSize(size);
 
     if (this->activeTool->type == TOOL_ERASER) {
-        this->stateChangeListener->toolSizeChanged();
+        notifyChanged(CHANGE_SIZE);
     }
 }
 
@@ -252,7 +284,7 @@ void ToolHandler::setHighlighterSize(ToolSize size) {
     this->tools[TOOL_HIGHLIGHTER - TOOL_PEN]->setSize(size);
 
     if (this->activeTool->type == TOOL_HIGHLIGHTER) {
-        this->stateChangeListener->toolSizeChanged();
+        notifyChanged(CHANGE_SIZE);
     }
 }
 
@@ -260,7 +292,7 @@ void ToolHandler::setPenFillEnabled(bool fill) {
     this->tools[TOOL_PEN - TOOL_PEN]->setFill(fill);
 
     if (this->activeTool->type == TOOL_PEN) {
-        this->stateChangeListener->toolFillChanged();
+        notifyChanged(CHANGE_FILL);
     }
 }
 
@@ -274,7 +306,7 @@ void ToolHandler::setHighlighterFillEnabled(bool fill) {
     this->tools[TOOL_HIGHLIGHTER - TOOL_PEN]->setFill(fill);
 
     if (this->activeTool->type == TOOL_HIGHLIGHTER) {
-        this->stateChangeListener->toolFillChanged();
+        notifyChanged(CHANGE_FILL);
     }
 }
 
@@ -325,7 +357,7 @@ void ToolHandler::setSize(ToolSize size) {
 
     Tool* tool = this->toolbarSelectedTool;
     tool->setSize(clippedSize);
-    this->stateChangeListener->toolSizeChanged();
+    notifyChanged(CHANGE_SIZE);
 }
 
 void ToolHandler::setButtonSize(ToolSize size, Button button) {
@@ -340,7 +372,7 @@ void ToolHandler::setButtonSize(ToolSize size, Button button) {
 void ToolHandler::setLineStyle(const LineStyle& style) {
     Tool* tool = this->toolbarSelectedTool;
     tool->setLineStyle(style);
-    this->stateChangeListener->toolLineStyleChanged();
+    notifyChanged(CHANGE_LINE_STYLE);
 }
 
 void ToolHandler::setColor(Color color, bool userSelection) {
@@ -350,7 +382,7 @@ void ToolHandler::setColor(Color color, bool userSelection) {
     Tool* tool = this->activeTool;
     int currentAlpha = tool->getColor().alpha;
     tool->setColor(color);
-    this->stateChangeListener->toolColorChanged();
+    notifyChanged(CHANGE_COLOR);
     if (userSelection) {
         // ensure that tool color alpha is re-applied on new selected color;
         setColorAlpha(*tool, currentAlpha);
@@ -374,7 +406,7 @@ auto ToolHandler::getColorMaskAlpha() const -> Color {
 void ToolHandler::setFillEnabled(bool fill) {
     Tool* tool = this->toolbarSelectedTool;
     tool->setFill(fill);
-    this->stateChangeListener->toolFillChanged();
+    notifyChanged(CHANGE_FILL);
 }
 
 auto ToolHandler::getFill() const -> int {
@@ -588,10 +620,6 @@ void ToolHandler::setSelectionEditTools(bool setColor, bool setSize, bool setFil
     if (this->activeTool->type == TOOL_SELECT_RECT || this->activeTool->type == TOOL_SELECT_REGION ||
         this->activeTool->type == TOOL_SELECT_MULTILAYER_RECT || this->activeTool->type == TOOL_SELECT_MULTILAYER_REGION ||
         this->activeTool->type == TOOL_SELECT_OBJECT || this->activeTool->type == TOOL_PLAY_OBJECT) {
-        this->stateChangeListener->toolColorChanged();
-        this->stateChangeListener->toolSizeChanged();
-        this->stateChangeListener->toolFillChanged();
-        this->stateChangeListener->toolLineStyleChanged();
         this->fireToolChanged();
     }
 }
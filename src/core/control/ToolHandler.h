@@ -54,6 +54,9 @@ public:
     virtual void toolSizeChanged() = 0;
     virtual void toolFillChanged() = 0;
     virtual void toolLineStyleChanged() = 0;
+    /**
+     * @brief Update everything depending on the active tool, including what the other notifications update
+     */
     virtual void toolChanged() = 0;
 
     virtual ~ToolListener();
@@ -65,6 +68,24 @@ public:
     ToolHandler(ToolListener* stateChangedListener, ActionDatabase* actionDB, Settings* settings);
     virtual ~ToolHandler();
 
+    /**
+     * @brief Merges the notifications of the ToolListener sent while it exists: they are sent once the outermost batch
+     *      ends, each at most once. A tool change is sent alone, as toolChanged() updates everything.
+     *
+     * For the changes made together, e.g. selecting a tool and setting its size and color.
+     * (ToolListener::changeColorOfSelection() is an edit, and is not delayed.)
+     */
+    class ChangeBatch {
+    public:
+        explicit ChangeBatch(ToolHandler& handler);
+        ~ChangeBatch();
+        ChangeBatch(const ChangeBatch&) = delete;
+        ChangeBatch& operator=(const ChangeBatch&) = delete;
+
+    private:
+        ToolHandler& handler;
+    };
+
     /**
      * @brief Reset the Button tool with a new tooltype
      *
@@ -240,7 +261,7 @@ public:
      * @brief Update the Toolbar and the cursor based on the active Tool
      *
      */
-    void fireToolChanged() const;
+    void fireToolChanged();
 
     /**
      * @brief Listen for tool changes.
@@ -376,6 +397,17 @@ protected:
     void initTools();
 
 private:
+    enum Change : unsigned {
+        CHANGE_COLOR = 1U << 0,
+        CHANGE_SIZE = 1U << 1,
+        CHANGE_FILL = 1U << 2,
+        CHANGE_LINE_STYLE = 1U << 3,
+        CHANGE_TOOL = 1U << 4,
+    };
+    /// Notify the listeners now, or at the end of the current ChangeBatch
+    void notifyChanged(Change change);
+    void sendChanges();
+
     std::array<std::unique_ptr<Tool>, TOOL_COUNT> tools;
 
     /**
@@ -411,6 +443,9 @@ private:
     std::vector<ToolChangedCallback> toolChangeListeners;
 
     ToolListener* stateChangeListener = nullptr;
+    /// Nested ChangeBatch count, and the Change flags to send at the end of the outermost one
+    int batchDepth = 0;
+    unsigned pendingChanges = 0;
     ActionDatabase* actionDB = nullptr;
     Settings* settings = nullptr;
 };
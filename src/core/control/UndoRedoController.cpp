@@ -1,11 +1,13 @@
 #include "UndoRedoController.h"
 
-#include <algorithm>  // for copy, max
-#include <cstddef>    // for size_t
-#include <iterator>   // for back_insert_iterator, back_...
+#include <algorithm>      // for copy, max
+#include <cstddef>        // for size_t
+#include <iterator>       // for back_insert_iterator, back_...
+#include <unordered_set>  // for unordered_set
 
 #include "control/tools/EditSelection.h"  // for EditSelection
 #include "gui/MainWindow.h"               // for MainWindow
+#include "gui/PageView.h"                 // for XojPageView
 #include "gui/XournalView.h"              // for XournalView
 #include "model/Document.h"               // for Document
 #include "model/ElementInsertionPosition.h"
@@ -16,10 +18,15 @@
 
 #include "Control.h"  // for Control
 
-class XojPageView;
-
 UndoRedoController::UndoRedoController(Control* control): control(control) {}
 
+/**
+ * Undo actions modify elements of any layer in place, which the caches of the lower layers do not track
+ */
+static void setLowerLayersCachesEnabled(Control* control, bool enabled) {
+    for (auto&& view: control->getWindow()->getXournal()->getViewPages()) { view->setLowerLayersCacheEnabled(enabled); }
+}
+
 UndoRedoController::~UndoRedoController() = default;
 
 void UndoRedoController::before() {
@@ -52,11 +59,13 @@ void UndoRedoController::after() {
         return;
     }
 
+    // Test, in a single pass, which elements have not been removed since
+    std::unordered_set<Element*> selected(elements.begin(), elements.end());
     InsertionOrderRef remainingElements;
-    for (Element* e: elements) {
-        // Test, if the element has been removed since
-        if (auto pos = layer->indexOf(e); pos != -1) {
-            remainingElements.emplace_back(e, pos);
+    const auto& layerElements = layer->getElements();
+    for (size_t i = 0; i < layerElements.size() && remainingElements.size() < selected.size(); i++) {
+        if (selected.count(layerElements[i].get())) {
+            remainingElements.emplace_back(layerElements[i].get(), static_cast<Element::Index>(i));
         }
     }
     if (!remainingElements.empty()) {
@@ -72,17 +81,21 @@ void UndoRedoController::after() {
 void UndoRedoController::undo(Control* control) {
     UndoRedoController handler(control);
     handler.before();
+    setLowerLayersCachesEnabled(control, false);
 
     control->getUndoRedoHandler()->undo();
 
+    setLowerLayersCachesEnabled(control, true);
     handler.after();
 }
 
 void UndoRedoController::redo(Control* control) {
     UndoRedoController handler(control);
     handler.before();
+    setLowerLayersCachesEnabled(control, false);
 
     control->getUndoRedoHandler()->redo();
 
+    setLowerLayersCachesEnabled(control, true);
     handler.after();
 }
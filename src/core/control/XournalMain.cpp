@@ -1,49 +1,61 @@
 #include "XournalMain.h"
 
-#include <algorithm>  // for copy, sort, max
-#include <array>      // for array
-#include <chrono>     // for time_point, duration, hours...
-#include <clocale>    // for setlocale, LC_NUMERIC
-#include <cstdio>     // for printf
-#include <cstdlib>    // for exit, size_t
-#include <exception>  // for exception
-#include <iostream>   // for operator<<, endl, basic_...
-#include <locale>     // for locale
-#include <memory>     // for unique_ptr, allocator
-#include <optional>   // for optional, nullopt
-#include <sstream>    // for stringstream
-#include <stdexcept>  // for runtime_error
-#include <string>     // for string, basic_string
-#include <vector>     // for vector
+#include <algorithm>    // for copy, sort, max
+#include <array>        // for array
+#include <chrono>       // for time_point, duration, hours...
+#include <clocale>      // for setlocale, LC_NUMERIC
+#include <cstdio>       // for printf
+#include <cstdlib>      // for exit, size_t
+#include <exception>    // for exception
+#include <fstream>      // for ifstream
+#include <iostream>     // for operator<<, endl, basic_...
+#include <locale>       // for locale
+#include <memory>       // for unique_ptr, allocator
+#include <optional>     // for optional, nullopt
+#include <sstream>      // for stringstream
+#include <stdexcept>    // for runtime_error
+#include <string>       // for string, basic_string
+#include <string_view>  // for string_view
+#include <thread>       // for thread
+#include <vector>       // for vector
 
 #include <gio/gio.h>      // for GApplication, G_APPLICATION
 #include <glib-object.h>  // for G_CALLBACK, g_signal_con...
 #include <glib.h>         // for GOptionEntry, gchar, G_O...
 #include <libintl.h>      // for bindtextdomain, textdomain
 
-#include "control/RecentManager.h"           // for RecentManager
-#include "control/jobs/BaseExportJob.h"      // for ExportBackgroundType
-#include "control/jobs/XournalScheduler.h"   // for XournalScheduler
-#include "control/settings/LatexSettings.h"  // for LatexSettings
-#include "control/settings/Settings.h"       // for Settings
-#include "control/settings/SettingsEnums.h"  // for ICON_THEME_COLOR, ICON_T...
-#include "control/xojfile/LoadHandler.h"     // for LoadHandler
-#include "control/xojfile/SaveHandler.h"     // for SaveHandler
-#include "gui/GladeSearchpath.h"             // for GladeSearchpath
-#include "gui/MainWindow.h"                  // for MainWindow
-#include "gui/XournalView.h"                 // for XournalView
-#include "model/Document.h"                  // for Document
-#include "undo/EmergencySaveRestore.h"       // for EmergencySaveRestore
-#include "undo/UndoRedoHandler.h"            // for UndoRedoHandler
-#include "util/PathUtil.h"                   // for getConfigFolder, openFil...
-#include "util/PlaceholderString.h"          // for PlaceholderString
-#include "util/Stacktrace.h"                 // for Stacktrace
-#include "util/Util.h"                       // for execInUiThread
-#include "util/XojMsgBox.h"                  // for XojMsgBox
-#include "util/i18n.h"                       // for _, FS, _F
+#include "control/DocumentCompactor.h"        // for DocumentCompactor
+#include "control/DocumentMerger.h"           // for DocumentMerger
+#include "control/PerfStats.h"                // for startTotals
+#include "control/RecentManager.h"            // for RecentManager
+#include "control/RenderBenchmark.h"          // for RenderBenchmark
+#include "control/jobs/BaseExportJob.h"       // for ExportBackgroundType
+#include "control/jobs/XournalScheduler.h"    // for XournalScheduler
+#include "control/settings/LatexSettings.h"   // for LatexSettings
+#include "control/settings/Settings.h"        // for Settings
+#include "control/settings/SettingsEnums.h"   // for ICON_THEME_COLOR, ICON_T...
+#include "control/xojfile/LoadHandler.h"      // for LoadHandler
+#include "control/xojfile/RecoveryJournal.h"  // for RecoveryJournal
+#include "control/xojfile/SaveHandler.h"      // for SaveHandler
+#include "gui/GladeSearchpath.h"              // for GladeSearchpath
+#include "gui/MainWindow.h"                   // for MainWindow
+#include "gui/XournalView.h"                  // for XournalView
+#include "model/Document.h"                   // for Document
+#include "model/DocumentHandler.h"            // for DocumentHandler
+#include "model/FontCache.h"                  // for warmUp
+#include "undo/EmergencySaveRestore.h"        // for EmergencySaveRestore
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
+#include "util/PathUtil.h"                    // for getConfigFolder, openFil...
+#include "util/PlaceholderString.h"           // for PlaceholderString
+#include "util/PngEncoder.h"                  // for Compression
+#include "util/Stacktrace.h"                  // for Stacktrace
+#include "util/Util.h"                        // for execInUiThread
+#include "util/XojMsgBox.h"                   // for XojMsgBox
+#include "util/glib_casts.h"                  // for wrap_v
+#include "util/i18n.h"                        // for _, FS, _F
 
 #include "Control.h"       // for Control
-#include "ExportHelper.h"  // for exportImg, exportPdf
+#include "ExportHelper.h"  // for exportImg, exportPdf, exportBatch
 #include "config-dev.h"    // for ERRORLOG_DIR
 #include "config-git.h"    // for GIT_BRANCH, GIT_ORIGIN_O...
 #include "config.h"        // for GETTEXT_PACKAGE, ENABLE_NLS
@@ -70,6 +82,7 @@ auto migrateSettings() -> MigrateResult;
 
 void checkForErrorlog();
 void checkForEmergencySave(Control* control);
+void checkForRecoveryJournal(Control* control);
 
 void initResourcePath(GladeSearchpath* gladePath, const gchar* relativePathAndFile, bool failIfNotFound = true);
 
@@ -241,6 +254,46 @@ void checkForEmergencySave(Control* control) {
             });
 }
 
+void checkForRecoveryJournal(Control* control) {
+    RecoveryJournal* journal = control->getRecoveryJournal();
+    if (!journal->hasLeftover()) {
+        return;
+    }
+
+    std::string error;
+    auto recovery = RecoveryJournal::read(journal->getFile(), error);
+    if (!recovery) {
+        // Nothing to recover from
+        if (!error.empty()) {
+            g_warning("%s", error.c_str());
+        }
+        journal->discardLeftover();
+        control->startRecoveryJournal();
+        return;
+    }
+
+    const std::string msg = FS(_F("Xournal++ crashed last time. Would you like to restore the changes to \"{1}\"?") %
+                               recovery->documentFile.u8string());
+
+    enum { DELETE_FILE = 1, RESTORE_FILE };
+    XojMsgBox::askQuestion(nullptr, _("Recovery file detected"), msg,
+                           {{_("Delete file"), DELETE_FILE}, {_("Restore file"), RESTORE_FILE}},
+                           [recovery = std::move(*recovery), ctrl = control](int response) mutable {
+                               ctrl->getRecoveryJournal()->discardLeftover();
+                               if (response != RESTORE_FILE) {
+                                   ctrl->startRecoveryJournal();
+                                   return;
+                               }
+                               ctrl->recoverFromJournal(std::move(recovery), [ctrl](bool opened) {
+                                   if (opened) {
+                                       // The recovered changes are not saved yet
+                                       ctrl->getUndoRedoHandler()->addUndoAction(
+                                               std::make_unique<EmergencySaveRestore>());
+                                   }
+                               });
+                           });
+}
+
 namespace {
 void exitOnMissingPdfFileName(const LoadHandler& loader) {
     if (!loader.getMissingPdfFilename().empty()) {
@@ -266,14 +319,18 @@ void exitOnMissingPdfFileName(const LoadHandler& loader) {
  * @param pngWidth Set the width for Png files. Non positive values are ignored
  * @param pngHeight Set the height for Png files. Non positive values are ignored
  * @param exportBackground If EXPORT_BACKGROUND_NONE, the exported image file has transparent background
+ * @param pngCompression The speed/size tradeoff of the encoding of the Png files
  *
  *  The priority is: pngDpi overwrites pngWidth overwrites pngHeight
  *
  * @return 0 on success, -2 on failure opening the input file, -3 on export failure
  */
 auto exportImg(const char* input, const char* output, const char* range, const char* layerRange, int pngDpi,
-               int pngWidth, int pngHeight, ExportBackgroundType exportBackground) -> int {
+               int pngWidth, int pngHeight, ExportBackgroundType exportBackground,
+               xoj::util::png::Compression pngCompression) -> int {
     LoadHandler loader;
+    // Only the pages in the range are parsed, when they are exported
+    loader.setLazyPageLoading(true);
     auto doc = loader.loadDocument(input);
     if (doc == nullptr) {
         g_error("%s", loader.getLastError().c_str());
@@ -281,7 +338,8 @@ auto exportImg(const char* input, const char* output, const char* range, const c
 
     exitOnMissingPdfFileName(loader);
 
-    return ExportHelper::exportImg(doc.get(), output, range, layerRange, pngDpi, pngWidth, pngHeight, exportBackground);
+    return ExportHelper::exportImg(doc.get(), output, range, layerRange, pngDpi, pngWidth, pngHeight, exportBackground,
+                                   pngCompression);
 }
 
 /**
@@ -302,8 +360,7 @@ auto saveDoc(const char* input, const char* output) -> int {
     if (!res) {
         g_error("%s", FC(_F("Error: {1}") % newDoc->getLastErrorMsg().c_str()));
     }
-    saver.prepareSave(newDoc.get());
-    saver.saveTo(output);
+    saver.saveDocument(newDoc.get(), output);
 
     if (!saver.getErrorMessage().empty()) {
         g_error("%s", FC(_F("Error: {1}") % saver.getErrorMessage()));
@@ -311,6 +368,82 @@ auto saveDoc(const char* input, const char* output) -> int {
     return 0;
 }
 
+/**
+ * @brief Compact a document (see DocumentCompactor) and save it, printing the savings
+ *
+ * @param input Path to the input .xopp or .xoj file
+ * @param output Path to the output .xopp file
+ * @param tolerance The maximal distance of the strokes to the original ones, in page coordinates
+ * @param dropWhiteout Whether the whiteout strokes erasing nothing are dropped
+ * @return int 0 on success
+ */
+auto compactDoc(const char* input, const char* output, double tolerance, bool dropWhiteout) -> int {
+    LoadHandler loader;
+    auto doc = loader.loadDocument(input);
+    if (doc == nullptr) {
+        g_error("%s", loader.getLastError().c_str());
+    }
+
+    exitOnMissingPdfFileName(loader);
+
+    DocumentCompactor::Options options;
+    options.tolerance = tolerance;
+    options.dropUselessWhiteout = dropWhiteout;
+    DocumentCompactor::Report report;
+    DocumentHandler handler;
+    DocumentCompactor(options).compact(*doc, handler, report);
+
+    SaveHandler saver;
+    saver.saveDocument(doc.get(), output);
+    if (!saver.getErrorMessage().empty()) {
+        g_error("%s", FC(_F("Error: {1}") % saver.getErrorMessage()));
+    }
+
+    std::cout << report.describe() << std::endl;
+    std::error_code errorBefore;
+    std::error_code errorAfter;
+    const auto sizeBefore = fs::file_size(Util::fromGFilename(const_cast<char*>(input), false), errorBefore);
+    const auto sizeAfter = fs::file_size(Util::fromGFilename(const_cast<char*>(output), false), errorAfter);
+    if (!errorBefore && !errorAfter) {
+        std::cout << FS(_F("File size: {1} bytes before, {2} bytes after") % sizeBefore % sizeAfter) << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief Append the input files one after the other (see DocumentMerger) and save the result
+ *
+ * @param inputs Paths to the input .xopp or .xoj files, null terminated
+ * @param output Path to the output .xopp file
+ * @return int 0 on success, -2 if no document could be appended, -3 if some could not
+ */
+auto mergeDocs(gchar** inputs, const char* output) -> int {
+    std::vector<fs::path> files;
+    for (gchar** input = inputs; *input; input++) {
+        files.push_back(Util::fromGFilename(*input, false));
+    }
+
+    DocumentHandler handler;
+    Document doc(&handler);
+    auto result = DocumentMerger::append(doc, handler, files);
+    for (const auto& error: result.errors) {
+        std::cerr << error << std::endl;
+    }
+    if (result.pages.empty()) {
+        return -2;
+    }
+
+    SaveHandler saver;
+    saver.saveDocument(&doc, output);
+    if (!saver.getErrorMessage().empty()) {
+        g_error("%s", FC(_F("Error: {1}") % saver.getErrorMessage()));
+    }
+    std::cout << FS(_F("{1} pages of {2} documents saved") % result.pages.size() %
+                    (files.size() - result.errors.size()))
+              << std::endl;
+    return result.errors.empty() ? 0 : -3;
+}
+
 /**
  * @brief Export the input file as pdf
  * @param input Path to the input file
@@ -328,6 +461,8 @@ auto saveDoc(const char* input, const char* output) -> int {
 auto exportPdf(const char* input, const char* output, const char* range, const char* layerRange,
                ExportBackgroundType exportBackground, bool progressiveMode) -> int {
     LoadHandler loader;
+    // Only the pages in the range are parsed, when they are exported
+    loader.setLazyPageLoading(true);
     auto doc = loader.loadDocument(input);
     if (doc == nullptr) {
         g_error("%s", loader.getLastError().c_str());
@@ -338,6 +473,28 @@ auto exportPdf(const char* input, const char* output, const char* range, const c
     return ExportHelper::exportPdf(doc.get(), output, range, layerRange, exportBackground, progressiveMode);
 }
 
+/// Measures the time spent in each phase of the startup, printed with --startup-timing
+class StartupTimer {
+public:
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+
+    /// Print the time spent since the previous phase ended
+    void phase(const char* name) {
+        auto now = std::chrono::steady_clock::now();
+        if (enabled) {
+            using ms = std::chrono::duration<double, std::milli>;
+            g_message("Startup: %-24s %8.1f ms (total %8.1f ms)", name, ms(now - last).count(),
+                      ms(now - start).count());
+        }
+        last = now;
+    }
+
+private:
+    bool enabled = false;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last = start;
+};
+
 struct XournalMainPrivate {
     XournalMainPrivate() = default;
     XournalMainPrivate(XournalMainPrivate&&) = delete;
@@ -350,12 +507,22 @@ struct XournalMainPrivate {
         g_free(pdfFilename);
         g_free(imgFilename);
         g_free(docFilename);
+        g_free(batchFilename);
+        g_free(compactFilename);
+        g_free(mergeFilename);
+        g_free(benchmarkFilename);
     }
 
     gchar** optFilename{};
     gchar* pdfFilename{};
     gchar* imgFilename{};
     gchar* docFilename{};
+    gchar* batchFilename{};
+    int batchJobs = 0;
+    gchar* compactFilename{};
+    gdouble compactTolerance = DocumentCompactor::Options().tolerance;
+    gboolean compactDropWhiteout = false;
+    gchar* mergeFilename{};
     gboolean showVersion = false;
     int openAtPageNumber = 0;  // when no --page is used, the document opens at the page specified in the metadata file
     gchar* exportRange{};
@@ -363,11 +530,17 @@ struct XournalMainPrivate {
     int exportPngDpi = -1;
     int exportPngWidth = -1;
     int exportPngHeight = -1;
+    gboolean exportPngFast = false;
     gboolean exportNoBackground = false;
     gboolean exportNoRuling = false;
     gboolean progressiveMode = false;
     gboolean disableAudio = false;
     gboolean attachMode = false;
+    gboolean startupTiming = false;
+    StartupTimer startupTimer;
+    gchar* benchmarkFilename{};
+    std::unique_ptr<RenderBenchmark> benchmark;
+    std::thread fontWarmUp;
     std::unique_ptr<GladeSearchpath> gladePath;
     std::unique_ptr<Control> control;
     std::unique_ptr<MainWindow> win;
@@ -483,7 +656,41 @@ void on_open_files(GApplication* application, GFile** files, gint numFiles, gcha
     gtk_window_present(GTK_WINDOW(app_data->win->getWindow()));
 }
 
+/**
+ * Initialize what is not needed to show the first window
+ */
+auto on_first_frame_idle(XMPtr app_data) -> bool {
+    app_data->startupTimer.phase("first frame");
+
+    // Enumerates the audio devices
+    app_data->control->getAudioController();
+
+    auto& globalLatexTemplatePath = app_data->control->getSettings()->latexSettings.globalTemplatePath;
+    if (globalLatexTemplatePath.empty()) {
+        globalLatexTemplatePath = findResourcePath("resources/") / "default_template.tex";
+        g_message("Using default latex template in %s", globalLatexTemplatePath.string().c_str());
+        app_data->control->getSettings()->save();
+    }
+
+    app_data->startupTimer.phase("deferred initialization");
+    return false;
+}
+
+auto on_first_frame(GtkWidget* window, cairo_t*, XMPtr app_data) -> gboolean {
+    g_signal_handlers_disconnect_by_func(window, reinterpret_cast<gpointer>(on_first_frame), app_data);
+    // Once the frame is on screen
+    g_idle_add(xoj::util::wrap_v<on_first_frame_idle>, app_data);
+    return false;
+}
+
 void on_startup(GApplication* application, XMPtr app_data) {
+    app_data->startupTimer.setEnabled(app_data->startupTiming);
+    app_data->startupTimer.phase("command line");
+    if (app_data->benchmarkFilename) {
+        // Before the render threads are started
+        xoj::perf::startTotals();
+    }
+
     initLocalisation();
     ensure_input_model_compatibility();
     const MigrateResult migrateResult = migrateSettings();
@@ -491,20 +698,20 @@ void on_startup(GApplication* application, XMPtr app_data) {
     app_data->gladePath = std::make_unique<GladeSearchpath>();
     initResourcePath(app_data->gladePath.get(), "ui/about.glade");
     initResourcePath(app_data->gladePath.get(), "ui/xournalpp.css", false);
+    app_data->startupTimer.phase("settings migration");
 
     app_data->control = std::make_unique<Control>(application, app_data->gladePath.get(), app_data->disableAudio);
+    app_data->startupTimer.phase("control and plugins");
 
-    auto& globalLatexTemplatePath = app_data->control->getSettings()->latexSettings.globalTemplatePath;
-    if (globalLatexTemplatePath.empty()) {
-        globalLatexTemplatePath = findResourcePath("resources/") / "default_template.tex";
-        g_message("Using default latex template in %s", globalLatexTemplatePath.string().c_str());
-        app_data->control->getSettings()->save();
-    }
+    // Fontconfig gets initialized and the default font of the texts resolved while the window is built
+    app_data->fontWarmUp = std::thread(FontCache::warmUp, app_data->control->getSettings()->getFont());
 
     app_data->win = std::make_unique<MainWindow>(app_data->gladePath.get(), app_data->control.get(),
                                                  GTK_APPLICATION(application));
     app_data->control->initWindow(app_data->win.get());
+    app_data->startupTimer.phase("main window");
     app_data->win->populate(app_data->gladePath.get());
+    app_data->startupTimer.phase("toolbars and menus");
 
     if (migrateResult.status != MigrateStatus::NotNeeded) {
         Util::execInUiThread(
@@ -514,10 +721,14 @@ void on_startup(GApplication* application, XMPtr app_data) {
     gtk_application_set_menubar(GTK_APPLICATION(application), app_data->win->getMenuModel());
     // Do we want stuff in gtk_application_set_app_menu?
 
+    g_signal_connect_after(app_data->win->getWindow(), "draw", G_CALLBACK(on_first_frame), app_data);
     app_data->win->show(nullptr);
+    app_data->startupTimer.phase("window shown");
 
     fs::path p;
-    if (app_data->optFilename) {
+    if (app_data->benchmarkFilename) {
+        p = Util::fromGFilename(app_data->benchmarkFilename, false);
+    } else if (app_data->optFilename) {
         if (g_strv_length(app_data->optFilename) != 1) {
             const std::string msg = _("Sorry, Xournal++ can only open one file at once.\n"
                                       "Others are ignored.");
@@ -535,11 +746,29 @@ void on_startup(GApplication* application, XMPtr app_data) {
     }
     app_data->control->openFileWithoutSavingTheCurrentDocument(
             std::move(p), app_data->attachMode, app_data->openAtPageNumber - 1,
-            [ctrl = app_data->control.get(), app = GTK_APPLICATION(application)](bool) {
+            [app_data, ctrl = app_data->control.get(), app = GTK_APPLICATION(application)](bool loaded) {
                 ctrl->getScheduler()->start();
 
+                if (app_data->benchmarkFilename) {
+                    gtk_application_add_window(app, ctrl->getGtkWindow());
+                    if (!loaded) {
+                        std::cerr << FS(_F("Could not open \"{1}\" for the benchmark") % app_data->benchmarkFilename)
+                                  << std::endl;
+                        g_application_quit(G_APPLICATION(app));
+                        return;
+                    }
+                    app_data->benchmark = std::make_unique<RenderBenchmark>(ctrl, [app](const std::string& report) {
+                        std::cout << report << std::flush;
+                        g_application_quit(G_APPLICATION(app));
+                    });
+                    // Once the layout of the document is done
+                    Util::execInUiThread([app_data]() { app_data->benchmark->start(); });
+                    return;
+                }
+
                 checkForErrorlog();
                 checkForEmergencySave(ctrl);
+                checkForRecoveryJournal(ctrl);
 
                 // There is a timing issue with the layout
                 // This fixes it, see #405
@@ -603,20 +832,121 @@ auto on_handle_local_options(GApplication*, GVariantDict*, XMPtr app_data) -> gi
                                      app_data->exportPngHeight,
                                      app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
                                      app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
-                                                                    EXPORT_BACKGROUND_ALL);
+                                                                    EXPORT_BACKGROUND_ALL,
+                                     app_data->exportPngFast ? xoj::util::png::Compression::FAST :
+                                                               xoj::util::png::Compression::DEFAULT);
                 },
                 "exportImg");
     }
+    if (app_data->batchFilename) {
+        return exec_guarded(
+                [&] {
+                    ExportHelper::ExportOptions options;
+                    options.range = app_data->exportRange;
+                    options.layerRange = app_data->exportLayerRange;
+                    options.pngDpi = app_data->exportPngDpi;
+                    options.pngWidth = app_data->exportPngWidth;
+                    options.pngHeight = app_data->exportPngHeight;
+                    options.pngCompression = app_data->exportPngFast ? xoj::util::png::Compression::FAST :
+                                                                       xoj::util::png::Compression::DEFAULT;
+                    options.exportBackground = app_data->exportNoBackground ? EXPORT_BACKGROUND_NONE :
+                                               app_data->exportNoRuling     ? EXPORT_BACKGROUND_UNRULED :
+                                                                              EXPORT_BACKGROUND_ALL;
+                    options.progressiveMode = app_data->progressiveMode;
+                    const unsigned int jobs = app_data->batchJobs > 0 ? static_cast<unsigned int>(app_data->batchJobs) :
+                                                                        g_get_num_processors();
+                    if (std::string(app_data->batchFilename) == "-") {
+                        return ExportHelper::exportBatch(std::cin, options, jobs);
+                    }
+                    std::ifstream manifest(Util::fromGFilename(app_data->batchFilename, false));
+                    if (!manifest) {
+                        std::cerr << FS(_F("Could not open the manifest \"{1}\"") % app_data->batchFilename)
+                                  << std::endl;
+                        return -2;
+                    }
+                    return ExportHelper::exportBatch(manifest, options, jobs);
+                },
+                "exportBatch");
+    }
     if (app_data->docFilename && app_data->optFilename && *app_data->optFilename) {
         return exec_guarded([&] { return saveDoc(*app_data->optFilename, app_data->docFilename); }, "saveDocument");
     }
+    if (app_data->compactFilename && app_data->optFilename && *app_data->optFilename) {
+        return exec_guarded(
+                [&] {
+                    return compactDoc(*app_data->optFilename, app_data->compactFilename, app_data->compactTolerance,
+                                      app_data->compactDropWhiteout);
+                },
+                "compactDocument");
+    }
+    if (app_data->mergeFilename && app_data->optFilename && *app_data->optFilename) {
+        return exec_guarded([&] { return mergeDocs(app_data->optFilename, app_data->mergeFilename); },
+                            "mergeDocuments");
+    }
     return -1;
 }
 
+/**
+ * @return true if the command line asks for an export, a conversion or the version, which are run without GTK
+ */
+auto isHeadlessCommand(int argc, char** argv) -> bool {
+    constexpr std::array longOptions = {"--create-pdf", "--create-img", "--save", "--batch", "--compact", "--merge",
+                                        "--version"};
+    constexpr std::array shortOptions = {'p', 'i', 's'};
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--") {
+            break;
+        }
+        for (std::string_view opt: longOptions) {
+            if (arg.substr(0, opt.size()) == opt && (arg.size() == opt.size() || arg[opt.size()] == '=')) {
+                return true;
+            }
+        }
+        if (arg.size() >= 2 && arg[0] == '-' && arg[1] != '-' &&
+            std::find(shortOptions.begin(), shortOptions.end(), arg[1]) != shortOptions.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Parse the command line and run the export, without creating the GtkApplication: no display is opened, so that the
+ * exports also run on servers without a display server.
+ */
+auto runHeadless(int argc, char** argv, const GOptionEntry* options, GOptionGroup* exportGroup, XMPtr app_data)
+        -> int {
+    g_set_prgname("com.github.xournalpp.xournalpp");
+    GOptionContext* context = g_option_context_new(nullptr);
+    g_option_context_add_main_entries(context, options, GETTEXT_PACKAGE);
+    g_option_context_add_group(context, exportGroup);
+
+    GError* error = nullptr;
+    bool parsed = g_option_context_parse(context, &argc, &argv, &error);
+    g_option_context_free(context);
+    if (!parsed) {
+        std::cerr << error->message << std::endl;
+        g_error_free(error);
+        return 1;
+    }
+
+    int result = on_handle_local_options(nullptr, nullptr, app_data);
+    if (result == -1) {
+        std::cerr << _("No input file given") << std::endl;
+        return 1;
+    }
+    return result;
+}
+
 void on_shutdown(GApplication*, XMPtr app_data) {
+    app_data->benchmark.reset();
     app_data->control->saveSettings();
     app_data->win->getXournal()->clearSelection();
     app_data->control->getScheduler()->stop();
+    if (app_data->fontWarmUp.joinable()) {
+        app_data->fontWarmUp.join();
+    }
 }
 
 }  // namespace
@@ -624,16 +954,6 @@ void on_shutdown(GApplication*, XMPtr app_data) {
 auto XournalMain::run(int argc, char** argv) -> int {
 
     XournalMainPrivate app_data;
-    GtkApplication* app = gtk_application_new("com.github.xournalpp.xournalpp", APP_FLAGS);
-    g_object_set(G_OBJECT(app), "register-session", true, nullptr);  // Needed for opening files on MacOS from Finder
-    g_set_prgname("com.github.xournalpp.xournalpp");
-    g_signal_connect(app, "activate", G_CALLBACK(&on_activate), &app_data);
-    g_signal_connect(app, "command-line", G_CALLBACK(&on_command_line), &app_data);
-    g_signal_connect(app, "open", G_CALLBACK(&on_open_files), &app_data);
-    g_signal_connect(app, "startup", G_CALLBACK(&on_startup), &app_data);
-    g_signal_connect(app, "shutdown", G_CALLBACK(&on_shutdown), &app_data);
-    g_signal_connect(app, "handle-local-options", G_CALLBACK(&on_handle_local_options), &app_data);
-
     std::array options = {GOptionEntry{"page", 'n', 0, G_OPTION_ARG_INT, &app_data.openAtPageNumber,
                                        _("Jump to Page (first Page: 1)"), "N"},
                           GOptionEntry{G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &app_data.optFilename,
@@ -642,14 +962,33 @@ auto XournalMain::run(int argc, char** argv) -> int {
                                        _("Get version of xournalpp"), nullptr},
                           GOptionEntry{"disable-audio", 0, 0, G_OPTION_ARG_NONE, &app_data.disableAudio,
                                        _("Disable audio for this session"), nullptr},
+                          GOptionEntry{"startup-timing", 0, 0, G_OPTION_ARG_NONE, &app_data.startupTiming,
+                                       _("Print the time spent in each phase of the startup"), nullptr},
+                          GOptionEntry{"benchmark-render", 0, 0, G_OPTION_ARG_FILENAME, &app_data.benchmarkFilename,
+                                       _("Scroll through FILE at several zoom levels, print the frame rate,\n"
+                                         "                                 the render times of the pages and the PDF\n"
+                                         "                                 cache hits, and quit"),
+                                       "FILE"},
                           GOptionEntry{"attach-mode", 0, 0, G_OPTION_ARG_NONE, &app_data.attachMode,
                                        _("Open PDF in attach mode\n"
                                          "                                 Ignored if no PDF file is specified."),
                                        nullptr},
                           GOptionEntry{"save", 's', 0, G_OPTION_ARG_FILENAME, &app_data.docFilename,
                                        _("Save xopp-file with the background PDF specified as FILE"), "XOPPFILE"},
+                          GOptionEntry{"compact", 0, 0, G_OPTION_ARG_FILENAME, &app_data.compactFilename,
+                                       _("Save FILE compacted as XOPPFILE: merge and simplify the strokes, and remove\n"
+                                         "                                 the empty layers without a name"),
+                                       "XOPPFILE"},
+                          GOptionEntry{"compact-tolerance", 0, 0, G_OPTION_ARG_DOUBLE, &app_data.compactTolerance,
+                                       _("The maximal change of the strokes by --compact, in points. Default is 0.25"),
+                                       "T"},
+                          GOptionEntry{"compact-drop-whiteout", 0, 0, G_OPTION_ARG_NONE,
+                                       &app_data.compactDropWhiteout,
+                                       _("With --compact, also drop the whiteout strokes which erase nothing"),
+                                       nullptr},
+                          GOptionEntry{"merge", 0, 0, G_OPTION_ARG_FILENAME, &app_data.mergeFilename,
+                                       _("Save the FILEs appended one after the other as XOPPFILE"), "XOPPFILE"},
                           GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
-    g_application_add_main_option_entries(G_APPLICATION(app), options.data());
 
     /**
      * Export related options
@@ -662,6 +1001,15 @@ auto XournalMain::run(int argc, char** argv) -> int {
                            "                                 Guess the output format from the extension of IMGFILE\n"
                            "                                 Supported formats: .png, .svg"),
                          "IMGFILE"},
+            GOptionEntry{"batch", 0, G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_FILENAME, &app_data.batchFilename,
+                         _("Convert the files listed in MANIFEST, or on the standard input if MANIFEST is -\n"
+                           "                                 One conversion per line: INPUT<TAB>OUTPUT\n"
+                           "                                 The conversion is guessed from the extension of OUTPUT:\n"
+                           "                                 .pdf, .png, .svg, .xopp or .xoj\n"
+                           "                                 A JSON line is printed after each conversion"),
+                         "MANIFEST"},
+            GOptionEntry{"batch-jobs", 0, 0, G_OPTION_ARG_INT, &app_data.batchJobs,
+                         _("Run N conversions of --batch in parallel. Default is the number of processors"), "N"},
             GOptionEntry{"export-no-background", 0, 0, G_OPTION_ARG_NONE, &app_data.exportNoBackground,
                          _("Export without background\n"
                            "                                 The exported file has transparent or white background,\n"
@@ -701,11 +1049,34 @@ auto XournalMain::run(int argc, char** argv) -> int {
                       "                                 No effect without -i/--create-img=foo.png\n"
                       "                                 Ignored if --export-png-dpi or --export-png-width is used"),
                     "N"},
+            GOptionEntry{"export-png-fast", 0, 0, G_OPTION_ARG_NONE, &app_data.exportPngFast,
+                         _("Encode PNG files faster, but larger\n"
+                           "                                 No effect without -i/--create-img=foo.png"),
+                         0},
             GOptionEntry{nullptr}};  // Must be terminated by a nullptr. See gtk doc
-    GOptionGroup* exportGroup = g_option_group_new("export", _("Advanced export options"),
-                                                   _("Display advanced export options"), nullptr, nullptr);
-    g_option_group_add_entries(exportGroup, exportOptions.data());
-    g_application_add_option_group(G_APPLICATION(app), exportGroup);
+    auto createExportGroup = [&exportOptions]() {
+        GOptionGroup* exportGroup = g_option_group_new("export", _("Advanced export options"),
+                                                       _("Display advanced export options"), nullptr, nullptr);
+        g_option_group_add_entries(exportGroup, exportOptions.data());
+        return exportGroup;
+    };
+
+    if (isHeadlessCommand(argc, argv)) {
+        return runHeadless(argc, argv, options.data(), createExportGroup(), &app_data);
+    }
+
+    GtkApplication* app = gtk_application_new("com.github.xournalpp.xournalpp", APP_FLAGS);
+    g_object_set(G_OBJECT(app), "register-session", true, nullptr);  // Needed for opening files on MacOS from Finder
+    g_set_prgname("com.github.xournalpp.xournalpp");
+    g_signal_connect(app, "activate", G_CALLBACK(&on_activate), &app_data);
+    g_signal_connect(app, "command-line", G_CALLBACK(&on_command_line), &app_data);
+    g_signal_connect(app, "open", G_CALLBACK(&on_open_files), &app_data);
+    g_signal_connect(app, "startup", G_CALLBACK(&on_startup), &app_data);
+    g_signal_connect(app, "shutdown", G_CALLBACK(&on_shutdown), &app_data);
+    g_signal_connect(app, "handle-local-options", G_CALLBACK(&on_handle_local_options), &app_data);
+
+    g_application_add_main_option_entries(G_APPLICATION(app), options.data());
+    g_application_add_option_group(G_APPLICATION(app), createExportGroup());
 
     auto rv = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
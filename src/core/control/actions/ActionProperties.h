@@ -94,6 +94,14 @@ struct ActionProperties<Action::ANNOTATE_PDF> {
     }
 };
 
+template <>
+struct ActionProperties<Action::APPEND_DOCUMENT> {
+    static void callback(GSimpleAction*, GVariant*, Control* ctrl) {
+        ctrl->clearSelectionEndText();
+        ctrl->askToAppendDocument();
+    }
+};
+
 template <>
 struct ActionProperties<Action::SAVE> {
     static void callback(GSimpleAction*, GVariant*, Control* ctrl) { ctrl->save(); }
@@ -530,6 +538,10 @@ template <>
 struct ActionProperties<Action::PAPER_BACKGROUND_COLOR> {
     static void callback(GSimpleAction*, GVariant*, Control* ctrl) { ctrl->changePageBackgroundColor(); }
 };
+template <>
+struct ActionProperties<Action::COMPACT_DOCUMENT> {
+    static void callback(GSimpleAction*, GVariant*, Control* ctrl) { ctrl->compactDocument(); }
+};
 
 
 /** Tool menu **/
@@ -851,6 +863,10 @@ struct ActionProperties<Action::HELP> {
     static void callback(GSimpleAction*, GVariant*, Control* ctrl) { XojMsgBox::showHelp(ctrl->getGtkWindow()); }
 };
 template <>
+struct ActionProperties<Action::MEMORY_REPORT> {
+    static void callback(GSimpleAction*, GVariant*, Control* ctrl) { ctrl->showMemoryReport(); }
+};
+template <>
 struct ActionProperties<Action::ABOUT> {
     using app_namespace = std::true_type;
     static void callback(GSimpleAction*, GVariant*, Control* ctrl) { ctrl->showAbout(); }
@@ -2,14 +2,16 @@
 
 #include <glib.h>  // for g_message, g_warning
 
-#include "control/Control.h"              // for Control
-#include "control/jobs/Job.h"             // for JOB_TYPE_AUTOSAVE, JobType
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "model/Document.h"               // for Document
-#include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
-#include "util/PathUtil.h"                // for clearExtensions, getAutosav...
-#include "util/XojMsgBox.h"               // for XojMsgBox
-#include "util/i18n.h"                    // for FS, _F
+#include "control/Control.h"                  // for Control
+#include "control/jobs/Job.h"                 // for JOB_TYPE_AUTOSAVE, JobType
+#include "control/xojfile/AutosaveJournal.h"  // for AutosaveJournal
+#include "control/xojfile/SaveHandler.h"      // for SaveHandler
+#include "model/Document.h"                   // for Document
+#include "model/DocumentHandler.h"            // for DocumentHandler
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
+#include "util/PathUtil.h"                    // for clearExtensions, getAutosav...
+#include "util/XojMsgBox.h"                   // for XojMsgBox
+#include "util/i18n.h"                        // for FS, _F
 
 #include "filesystem.h"  // for path, u8path
 
@@ -28,12 +30,14 @@ void AutosaveJob::run() {
     control->getUndoRedoHandler()->documentAutosaved();
 
     Document* doc = control->getDocument();
+    AutosaveJournal* journal = control->getAutosaveJournal();
 
+    // The pages to save are copied, so that the document is not locked while they are written
+    DocumentHandler snapshotHandler;
+    std::vector<size_t> modified;
+    std::unique_ptr<Document> snapshot;
     doc->lock();
-    handler.prepareSave(doc);
     auto filepath = doc->getFilepath();
-    doc->unlock();
-
     if (filepath.empty()) {
         filepath = Util::getAutosaveFilepath();
     } else {
@@ -41,34 +45,77 @@ void AutosaveJob::run() {
     }
     Util::clearExtensions(filepath);
     filepath += ".autosave.xopp";
+    const auto target = journal->prepareSave(doc, filepath, modified);
+    if (target == AutosaveJournal::Target::DOCUMENT) {
+        snapshot = doc->createSnapshot(&snapshotHandler);
+    } else if (target == AutosaveJournal::Target::JOURNAL) {
+        snapshot = doc->createSnapshot(&snapshotHandler, modified);
+    }
+    doc->unlock();
+
+    const fs::path journalFile = AutosaveJournal::getJournalPath(filepath);
+    if (target == AutosaveJournal::Target::JOURNAL) {
+        handler.prepareJournal(snapshot.get(), modified);
+        g_message("%s", FS(_F("Autosaving the modified pages to {1}") % journalFile.string()).c_str());
+        if (writeFile(handler, journalFile)) {
+            journal->saved(filepath);
+        }
+        return;
+    }
+
+    try {
+        // Removed first: a journal must never be applied to a newer autosave file
+        fs::remove(journalFile);
+    } catch (const fs::filesystem_error& e) {
+        this->error = FS(_F("Could not remove old autosave file \"{1}\": {2}") % journalFile.u8string() % e.what());
+        callAfterRun();
+        return;
+    }
+
+    if (target == AutosaveJournal::Target::UP_TO_DATE) {
+        journal->saved(filepath);
+        return;
+    }
 
     g_message("%s", FS(_F("Autosaving to {1}") % filepath.string()).c_str());
+    if (writeFile(handler, filepath, snapshot.get())) {
+        control->setLastAutosaveFile(filepath);
+        journal->saved(filepath);
+    }
+}
 
+auto AutosaveJob::writeFile(SaveHandler& handler, const fs::path& filepath, Document* doc) -> bool {
     fs::path tempfile = filepath;
     tempfile += u8"~";
-    handler.saveTo(tempfile);
+    if (doc) {
+        handler.saveDocument(doc, tempfile);
+    } else {
+        handler.saveTo(tempfile);
+    }
 
     this->error = handler.getErrorMessage();
     if (!this->error.empty()) {
         callAfterRun();
-    } else {
-        try {
-            if (fs::exists(filepath)) {
-                fs::path swaptmpfile = filepath;
-                swaptmpfile += u8".swap";
-                Util::safeRenameFile(filepath, swaptmpfile);
-                Util::safeRenameFile(tempfile, filepath);
-                // All went well, we can delete the old autosave file
-                fs::remove(swaptmpfile);
-            } else {
-                Util::safeRenameFile(tempfile, filepath);
-            }
-            control->setLastAutosaveFile(filepath);
-        } catch (const fs::filesystem_error& e) {
-            auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
-            this->error = FS(fmtstr % tempfile.u8string() % filepath.u8string() % e.what());
+        return false;
+    }
+
+    try {
+        if (fs::exists(filepath)) {
+            fs::path swaptmpfile = filepath;
+            swaptmpfile += u8".swap";
+            Util::safeRenameFile(filepath, swaptmpfile);
+            Util::safeRenameFile(tempfile, filepath);
+            // All went well, we can delete the old autosave file
+            fs::remove(swaptmpfile);
+        } else {
+            Util::safeRenameFile(tempfile, filepath);
         }
+    } catch (const fs::filesystem_error& e) {
+        auto fmtstr = _F("Could not rename autosave file from \"{1}\" to \"{2}\": {3}");
+        this->error = FS(fmtstr % tempfile.u8string() % filepath.u8string() % e.what());
+        return false;
     }
+    return true;
 }
 
 auto AutosaveJob::getType() -> JobType { return JOB_TYPE_AUTOSAVE; }
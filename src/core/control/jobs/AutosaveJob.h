@@ -13,9 +13,12 @@
 
 #include <string>  // for string
 
-#include "Job.h"  // for Job, JobType
+#include "Job.h"         // for Job, JobType
+#include "filesystem.h"  // for path
 
 class Control;
+class Document;
+class SaveHandler;
 
 class AutosaveJob: public Job {
 public:
@@ -30,6 +33,10 @@ public:
 
     JobType getType() override;
 
+private:
+    /// Write the file prepared in handler (or the whole doc), through a temporary file
+    bool writeFile(SaveHandler& handler, const fs::path& filepath, Document* doc = nullptr);
+
 private:
     Control* control = nullptr;
     std::string error;
@@ -125,8 +125,7 @@ void CustomExportJob::run() {
 
         XojExportHandler h;
         doc->lock();
-        h.prepareSave(doc);
-        h.saveTo(filepath, this->control);
+        h.saveDocument(doc, filepath, this->control);
         doc->unlock();
 
         if (!h.getErrorMessage().empty()) {
@@ -0,0 +1,63 @@
+#include "ImageDecodeJob.h"
+
+#include <utility>  // for move
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/Job.h"               // for JOB_TYPE_RENDER, JobType
+#include "control/jobs/Scheduler.h"         // for JOB_PRIORITY_HIGH
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "control/tools/EditSelection.h"    // for EditSelection
+#include "gui/MainWindow.h"                 // for MainWindow
+#include "gui/XournalView.h"                // for XournalView
+#include "model/Image.h"                    // for Image
+#include "model/ImageBuffer.h"              // for ImageBuffer
+#include "model/XojPage.h"                  // for XojPage
+
+ImageDecodeJob::ImageDecodeJob(Control* control, std::shared_ptr<const ImageBuffer> buffer, PageRef page):
+        control(control), buffer(std::move(buffer)), page(std::move(page)) {
+    this->buffer->beginBackgroundDecoding();
+}
+
+ImageDecodeJob::~ImageDecodeJob() {
+    if (this->decoding) {
+        this->buffer->endBackgroundDecoding();
+    }
+}
+
+void ImageDecodeJob::decode(Control* control, const Image& image, const PageRef& page) {
+    if (!image.hasData()) {
+        return;
+    }
+    auto* job = new ImageDecodeJob(control, image.getBuffer(), page);
+    control->getScheduler()->addJob(job, JOB_PRIORITY_HIGH);
+    job->unref();
+}
+
+auto ImageDecodeJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+auto ImageDecodeJob::getSource() -> void* { return this; }
+
+void ImageDecodeJob::run() {
+    // Cached: the views get it without decoding the image again
+    (void)this->buffer->getSurface();
+    this->buffer->endBackgroundDecoding();
+    this->decoding = false;
+    callAfterRun();
+}
+
+void ImageDecodeJob::afterRun() {
+    this->page->firePageChanged();
+    if (MainWindow* win = this->control->getWindow()) {
+        if (EditSelection* selection = win->getXournal()->getSelection()) {
+            // The image may have been pasted in the selection
+            selection->repaintContents();
+        }
+    }
+}
+
+void ImageDecodeJob::onDelete() {
+    if (this->decoding) {
+        this->buffer->endBackgroundDecoding();
+        this->decoding = false;
+    }
+}
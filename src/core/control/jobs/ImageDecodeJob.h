@@ -0,0 +1,60 @@
+/*
+ * Xournal++
+ *
+ * A job which decodes an image inserted into a page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>  // for shared_ptr
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "Job.h"  // for Job, JobType
+
+class Control;
+class Image;
+class ImageBuffer;
+
+/**
+ * @brief A Job which renders the surface of an image inserted or pasted on a page, off the UI thread.
+ *
+ * The image is inserted right away, with the size read from the header of its data. Until the job is done, the views
+ * of the image draw a placeholder (see ImageBuffer::isDecodingInBackground()). The page and the selection are then
+ * repainted on the UI thread.
+ */
+class ImageDecodeJob: public Job {
+public:
+    ImageDecodeJob(Control* control, std::shared_ptr<const ImageBuffer> buffer, PageRef page);
+
+protected:
+    ~ImageDecodeJob() override;
+
+public:
+    /**
+     * Schedule the decoding of the image, inserted on page
+     */
+    static void decode(Control* control, const Image& image, const PageRef& page);
+
+    JobType getType() override;
+
+    // Every job decodes another image: they can all run in parallel
+    void* getSource() override;
+
+    void run() override;
+    void afterRun() override;
+
+protected:
+    void onDelete() override;
+
+private:
+    Control* control;
+    std::shared_ptr<const ImageBuffer> buffer;
+    PageRef page;
+    bool decoding = true;
+};
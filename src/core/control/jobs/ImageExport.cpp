@@ -1,10 +1,16 @@
 #include "ImageExport.h"
 
-#include <cmath>    // for round
-#include <cstddef>  // for size_t
-#include <memory>   // for __shared_ptr_access, allocat...
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>           // for clamp, max
+#include <atomic>              // for atomic
+#include <cmath>               // for round
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <deque>               // for deque
+#include <fstream>             // for ofstream
+#include <memory>              // for __shared_ptr_access, allocat...
+#include <thread>              // for thread
+#include <utility>             // for move, pair
+#include <vector>              // for vector
 
 #include <cairo-svg.h>  // for cairo_svg_surface_create
 
@@ -14,6 +20,7 @@
 #include "model/PageType.h"              // for PageType
 #include "model/XojPage.h"               // for XojPage
 #include "pdf/base/XojPdfPage.h"         // for XojPdfPageSPtr, XojPdfPage
+#include "util/PngEncoder.h"             // for encode, EncoderOptions
 #include "util/Util.h"                   // for DPI_NORMALIZATION_FACTOR
 #include "util/i18n.h"                   // for _
 #include "view/DocumentView.h"           // for DocumentView
@@ -22,6 +29,7 @@
 #include "view/background/BackgroundView.h"
 
 #include "ProgressListener.h"  // for ProgressListener
+#include "Scheduler.h"         // for Scheduler
 
 using std::string;
 
@@ -47,6 +55,8 @@ void ImageExport::setQualityParameter(ExportQualityCriterion criterion, int valu
     this->qualityParameter = RasterImageQualityParameter(criterion, value);
 }
 
+void ImageExport::setPngCompression(xoj::util::png::Compression compression) { this->pngCompression = compression; }
+
 /**
  * @brief Select layers to export by parsing str
  * @param rangeStr A string parsed to get a list of layers
@@ -63,7 +73,15 @@ void ImageExport::setLayerRange(const char* rangeStr) {
  * @brief Get the last error message
  * @return The last error message to show to the user
  */
-auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
+auto ImageExport::getLastErrorMsg() const -> string {
+    std::lock_guard lock(this->errorMutex);
+    return lastError;
+}
+
+void ImageExport::setError(std::string msg) {
+    std::lock_guard lock(this->errorMutex);
+    this->lastError = std::move(msg);
+}
 
 /**
  * @brief Create Cairo surface for a given page
@@ -71,60 +89,73 @@ auto ImageExport::getLastErrorMsg() const -> string { return lastError; }
  * @param height the height of the page being exported
  * @param id the id of the page being exported
  * @param zoomRatio the zoom ratio for PNG exports with fixed DPI
+ * @param target the surface to create
  *
  * @return the zoom ratio of the current page if the export type is PNG, 0.0 otherwise
  *          The return value may differ from that of the parameter zoomRatio if the export has fixed page width or
  * height (in pixels). In this case, the zoomRatio (and the DPI) is page-dependent as soon as the document has pages of
  * different sizes.
  */
-auto ImageExport::createSurface(double width, double height, size_t id, double zoomRatio) -> double {
+auto ImageExport::createSurface(double width, double height, size_t id, double zoomRatio, PageSurface& target)
+        -> double {
     switch (this->format) {
         case EXPORT_GRAPHICS_PNG:
             switch (this->qualityParameter.getQualityCriterion()) {
                 case EXPORT_QUALITY_WIDTH:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / width;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->qualityParameter.getValue(),
-                                                               (int)std::round(height * zoomRatio));
+                    target.surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                                    this->qualityParameter.getValue(),
+                                                                    (int)std::round(height * zoomRatio)),
+                                         xoj::util::adopt);
                     break;
                 case EXPORT_QUALITY_HEIGHT:
                     zoomRatio = ((double)this->qualityParameter.getValue()) / height;
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               this->qualityParameter.getValue());
+                    target.surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                                    (int)std::round(width * zoomRatio),
+                                                                    this->qualityParameter.getValue()),
+                                         xoj::util::adopt);
                     break;
                 case EXPORT_QUALITY_DPI:  // Use the zoomRatio given as argument
-                    this->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, (int)std::round(width * zoomRatio),
-                                                               (int)std::round(height * zoomRatio));
+                    target.surface.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                                    (int)std::round(width * zoomRatio),
+                                                                    (int)std::round(height * zoomRatio)),
+                                         xoj::util::adopt);
                     break;
             }
-            this->cr = cairo_create(this->surface);
-            cairo_scale(this->cr, zoomRatio, zoomRatio);
+            target.cr.reset(cairo_create(target.surface.get()), xoj::util::adopt);
+            cairo_scale(target.cr.get(), zoomRatio, zoomRatio);
             return zoomRatio;
         case EXPORT_GRAPHICS_SVG:
-            this->surface = cairo_svg_surface_create(getFilenameWithNumber(id).u8string().c_str(), width, height);
-            cairo_svg_surface_restrict_to_version(this->surface, CAIRO_SVG_VERSION_1_2);
-            this->cr = cairo_create(this->surface);
+            target.surface.reset(
+                    cairo_svg_surface_create(getFilenameWithNumber(id).u8string().c_str(), width, height),
+                    xoj::util::adopt);
+            cairo_svg_surface_restrict_to_version(target.surface.get(), CAIRO_SVG_VERSION_1_2);
+            target.cr.reset(cairo_create(target.surface.get()), xoj::util::adopt);
             break;
         default:
-            this->lastError = _("Unsupported graphics format: ") + std::to_string(this->format);
+            setError(_("Unsupported graphics format: ") + std::to_string(this->format));
     }
     return 0.0;
 }
 
 /**
- * Free / store the surface
+ * Store the surface, i.e. encode and write the PNG file
  */
-auto ImageExport::freeSurface(size_t id) -> bool {
-    cairo_destroy(this->cr);
-
-    cairo_status_t status = CAIRO_STATUS_SUCCESS;
-    if (format == EXPORT_GRAPHICS_PNG) {
-        auto filepath = getFilenameWithNumber(id);
-        status = cairo_surface_write_to_png(surface, filepath.u8string().c_str());
+auto ImageExport::storeSurface(size_t id, cairo_surface_t* surface) const -> bool {
+    cairo_surface_flush(surface);
+    // The pages are still drawn in the meantime, but the encoding would otherwise be the bottleneck
+    xoj::util::png::EncoderOptions options{this->pngCompression, std::max(1U, std::thread::hardware_concurrency())};
+    const auto png =
+            xoj::util::png::encode(cairo_image_surface_get_data(surface), cairo_image_surface_get_width(surface),
+                                   cairo_image_surface_get_height(surface), cairo_image_surface_get_stride(surface),
+                                   options);
+    if (png.empty()) {
+        return false;
     }
-    cairo_surface_destroy(surface);
-
-    // we ignore this problem
-    return status == CAIRO_STATUS_SUCCESS;
+    std::ofstream out(getFilenameWithNumber(id), std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+    out.close();
+    return static_cast<bool>(out);
 }
 
 /**
@@ -148,34 +179,39 @@ auto ImageExport::getFilenameWithNumber(size_t no) const -> fs::path {
 }
 
 /**
- * @brief Export a single PNG/SVG page
+ * @brief Draw a single PNG/SVG page
  * @param pageId The index of the page being exported
  * @param id The number of the page being exported
  * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
  * @param format The format of the exported image
  * @param view A DocumentView for drawing the page
  */
-void ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format,
-                                  DocumentView& view) {
+auto ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format,
+                                  DocumentView& view) -> xoj::util::CairoSurfaceSPtr {
     doc->lock();
     PageRef page = doc->getPage(pageId);
+    const bool unloadAfterwards = page->hasContentLoader() && !page->isContentLoaded();
+    // The pages are drawn in parallel: the pdf pages are fetched from the document one at a time
+    XojPdfPageSPtr popplerPage;
+    if (page->getBackgroundType().isPdfPage() && (exportBackground != EXPORT_BACKGROUND_NONE)) {
+        popplerPage = doc->getPdfPage(page->getPdfPageNr());
+    }
     doc->unlock();
 
-    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio);
+    PageSurface target;
+    zoomRatio = createSurface(page->getWidth(), page->getHeight(), id, zoomRatio, target);
 
-    cairo_status_t state = cairo_surface_status(this->surface);
-    if (state != CAIRO_STATUS_SUCCESS) {
-        this->lastError = _("Error save image #1");
-        return;
+    if (!target.surface || cairo_surface_status(target.surface.get()) != CAIRO_STATUS_SUCCESS) {
+        setError(_("Error save image #1"));
+        return nullptr;
     }
+    cairo_t* cr = target.cr.get();
 
     if (page->getBackgroundType().isPdfPage() && (exportBackground != EXPORT_BACKGROUND_NONE)) {
         // Handle the pdf page separately, to call renderForPrinting for better quality.
-        auto pgNo = page->getPdfPageNr();
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
         if (!popplerPage) {
-            this->lastError = _("Error while exporting the pdf background: I cannot find the pdf page number ");
-            this->lastError += std::to_string(pgNo);
+            setError(_("Error while exporting the pdf background: I cannot find the pdf page number ") +
+                     std::to_string(page->getPdfPageNr()));
         } else if (format == EXPORT_GRAPHICS_PNG) {
             popplerPage->render(cr);
         } else {
@@ -191,16 +227,31 @@ void ImageExport::exportImagePage(size_t pageId, size_t id, double zoomRatio, Ex
                                                                        xoj::view::SHOW_RULING_BACKGROUND;
 
     if (layerRange) {
-        view.drawLayersOfPage(*layerRange, page, this->cr, true /* dont render eraseable */, flags);
+        view.drawLayersOfPage(*layerRange, page, cr, true /* dont render eraseable */, flags);
     } else {
-        view.drawPage(page, this->cr, true /* dont render eraseable */, flags);
+        view.drawPage(page, cr, true /* dont render eraseable */, flags);
+    }
+    target.cr.reset();
+
+    if (unloadAfterwards) {
+        // Read from the file for the export only: free the layers again
+        doc->lock();
+        page->unloadContent();
+        doc->unlock();
+    }
+
+    if (format == EXPORT_GRAPHICS_PNG) {
+        // Encoded and written by the thread reporting the progress
+        return std::move(target.surface);
     }
 
-    if (!freeSurface(id)) {
+    // The svg file is complete once its surface is finished
+    cairo_surface_finish(target.surface.get());
+    if (cairo_surface_status(target.surface.get()) != CAIRO_STATUS_SUCCESS) {
         // could not create this file...
-        this->lastError = _("Error save image #2");
-        return;
+        setError(_("Error save image #2"));
     }
+    return nullptr;
 }
 
 /**
@@ -233,19 +284,64 @@ void ImageExport::exportGraphics(ProgressListener* stateListener) {
         zoomRatio = ((double)this->qualityParameter.getValue()) / Util::DPI_NORMALIZATION_FACTOR;
     }
 
-    DocumentView view;
-    size_t current = 0;
-
+    // The pages to export, as pairs (index, number in the file name), in the order of the document
+    std::vector<std::pair<size_t, size_t>> pages;
     for (size_t i = 0; i < count; i++) {
-        auto id = i + 1;
-        if (onePage) {
-            id = SINGLE_PAGE;
+        if (selectedPages[i]) {
+            pages.emplace_back(i, onePage ? SINGLE_PAGE : i + 1);
+        }
+    }
+    if (pages.empty()) {
+        return;
+    }
+
+    const size_t threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, pages.size());
+
+    // The drawn pages, waiting to be written (nullptr if the page is already written or failed). The queue is bounded,
+    // since a page drawn at a high resolution holds a lot of memory.
+    std::mutex queueMutex;
+    std::condition_variable queueCond;
+    std::deque<std::pair<size_t, xoj::util::CairoSurfaceSPtr>> queue;
+    std::atomic<size_t> nextPage{0};
+
+    auto drawPages = [&]() {
+        DocumentView view;
+        for (size_t n = nextPage++; n < pages.size(); n = nextPage++) {
+            auto [pageId, id] = pages[n];
+            auto surface = exportImagePage(pageId, id, zoomRatio, format, view);
+
+            std::unique_lock lock(queueMutex);
+            queueCond.wait(lock, [&]() { return queue.size() < threadCount; });
+            queue.emplace_back(id, std::move(surface));
+            queueCond.notify_all();
         }
+    };
 
-        if (selectedPages[i]) {
-            exportImagePage(i, id, zoomRatio, format, view);
-            stateListener->setCurrentState(++current);
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(drawPages);
+    }
+
+    for (size_t current = 0; current < pages.size();) {
+        std::unique_lock lock(queueMutex);
+        queueCond.wait(lock, [&]() { return !queue.empty(); });
+        auto [id, surface] = std::move(queue.front());
+        queue.pop_front();
+        queueCond.notify_all();
+        lock.unlock();
+
+        if (surface && !storeSurface(id, surface.get())) {
+            // could not create this file...
+            setError(_("Error save image #2"));
         }
+        surface.reset();
+        stateListener->setCurrentState(++current);
+        Scheduler::yieldToUrgentJobs();
+    }
+
+    for (auto& t: threads) {
+        t.join();
     }
 }
 
@@ -12,11 +12,15 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
 #include <string>   // for string
 
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
-#include "util/ElementRange.h"  // for PageRangeVector, LayerRangeVector
+#include "util/ElementRange.h"        // for PageRangeVector, LayerRangeVector
+#include "util/PngEncoder.h"          // for Compression
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr, CairoSPtr
 
 #include "BaseExportJob.h"  // for ExportBackgroundType, EXPORT_BACKGROUND_ALL
 #include "filesystem.h"     // for path
@@ -80,6 +84,10 @@ public:
 
     /**
      * @brief Create one Graphics file per page
+     *
+     * The pages are drawn by a pool of threads, each with its own DocumentView. The PNG files are encoded and written
+     * by the calling thread in the meantime, which also reports the progress.
+     *
      * @param stateListener A listener to track the progress
      */
     void exportGraphics(ProgressListener* stateListener);
@@ -97,6 +105,11 @@ public:
      */
     void setQualityParameter(ExportQualityCriterion criterion, int value);
 
+    /**
+     * @brief Set the speed/size tradeoff of the encoding of the PNG files
+     */
+    void setPngCompression(xoj::util::png::Compression compression);
+
     /**
      * @brief Select layers to export by parsing str
      * @param str A string parsed to get a list of layers
@@ -104,23 +117,32 @@ public:
     void setLayerRange(const char* str);
 
 private:
+    /**
+     * The surface a page is drawn on
+     */
+    struct PageSurface {
+        xoj::util::CairoSurfaceSPtr surface;
+        xoj::util::CairoSPtr cr;
+    };
+
     /**
      * @brief Create Cairo surface for a given page
      * @param width the width of the page being exported
      * @param height the height of the page being exported
      * @param id the id of the page being exported
      * @param zoomRatio the zoom ratio for PNG exports with fixed DPI
+     * @param target the surface to create
      *
      * @return the zoom ratio of the current page if the export type is PNG, 0.0 otherwise
      *          The return value may differ from that of the parameter zoomRatio
      *          if the export has fixed page width or height (in pixels)
      */
-    double createSurface(double width, double height, size_t id, double zoomRatio);
+    double createSurface(double width, double height, size_t id, double zoomRatio, PageSurface& target);
 
     /**
-     * Free / store the surface
+     * Store the surface, i.e. encode and write the PNG file. The SVG files are written when their surface is destroyed.
      */
-    bool freeSurface(size_t id);
+    bool storeSurface(size_t id, cairo_surface_t* surface) const;
 
     /**
      * @brief Get a filename with a (page) number appended
@@ -132,14 +154,19 @@ private:
     fs::path getFilenameWithNumber(size_t no) const;
 
     /**
-     * @brief Export a single PNG/SVG page
+     * @brief Draw a single PNG/SVG page
      * @param pageId The index of the page being exported
      * @param id The number of the page being exported
      * @param zoomRatio The zoom ratio for PNG exports with fixed DPI
      * @param format The format of the exported image
      * @param view A DocumentView for drawing the page
+     *
+     * @return The drawn PNG surface, to be stored with storeSurface(), or nullptr (SVG file already written or error)
      */
-    void exportImagePage(size_t pageId, size_t id, double zoomRatio, ExportGraphicsFormat format, DocumentView& view);
+    xoj::util::CairoSurfaceSPtr exportImagePage(size_t pageId, size_t id, double zoomRatio,
+                                                ExportGraphicsFormat format, DocumentView& view);
+
+    void setError(std::string msg);
 
     static constexpr size_t SINGLE_PAGE = size_t(-1);
 
@@ -180,17 +207,17 @@ public:
     RasterImageQualityParameter qualityParameter = RasterImageQualityParameter();
 
     /**
-     * Export surface
+     * @brief The encoding of the PNG files
      */
-    cairo_surface_t* surface = nullptr;
+    xoj::util::png::Compression pngCompression = xoj::util::png::Compression::DEFAULT;
 
     /**
-     * Cairo context
+     * The last error message to show to the user
      */
-    cairo_t* cr = nullptr;
+    std::string lastError;
 
     /**
-     * The last error message to show to the user
+     * Protects lastError: the pages are exported in parallel
      */
-    std::string lastError;
+    mutable std::mutex errorMutex;
 };
@@ -12,8 +12,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE, JOB_TYPE_RECOGNIZER };
 
 /**
  * A manually ref-counted class representing an asynchronous job to be used with
@@ -96,4 +97,14 @@ private:
     unsigned int afterRunId = 0;
 
     std::atomic<unsigned int> refCount;
+
+    /// When the job was added to the Scheduler, if the performance statistics or the job trace are enabled (0
+    /// otherwise), and with which priority
+    int64_t queuedTime = 0;
+    int queuedPriority = 0;
+
+    /// Removed from the queue of the Scheduler, but not yet released
+    bool cancelled = false;
+
+    friend class Scheduler;
 };
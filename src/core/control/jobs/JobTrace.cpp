@@ -0,0 +1,139 @@
+#include "JobTrace.h"
+
+#include <deque>    // for deque
+#include <fstream>  // for ofstream
+#include <locale>   // for locale
+#include <mutex>    // for mutex, lock_guard
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include <glib.h>  // for g_getenv, g_warning
+
+namespace xoj::trace {
+
+namespace {
+auto readTraceFile() -> fs::path {
+    const char* value = g_getenv("XOURNALPP_JOB_TRACE");
+    return value && *value ? fs::u8path(value) : fs::path();
+}
+
+auto typeName(JobType type) -> const char* {
+    switch (type) {
+        case JOB_TYPE_BLOCKING:
+            return "blocking";
+        case JOB_TYPE_PREVIEW:
+            return "preview";
+        case JOB_TYPE_RENDER:
+            return "render";
+        case JOB_TYPE_AUTOSAVE:
+            return "autosave";
+        case JOB_TYPE_RECOGNIZER:
+            return "recognizer";
+    }
+    return "unknown";
+}
+
+const char* const PRIORITY_NAMES[JOB_N_PRIORITIES] = {"urgent", "high", "low", "none"};
+
+/// The queues are shown as the threads with these ids
+constexpr int QUEUE_THREAD_BASE = 1000;
+
+struct State {
+    std::mutex mutex;
+    std::deque<JobEvent> events;
+    std::vector<std::string> threadNames;
+};
+
+auto state() -> State& {
+    static State s;
+    return s;
+}
+
+void writeString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (char c: str) {
+        if (c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+void writeThreadName(std::ostream& out, int tid, const std::string& name) {
+    out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid << R"(,"args":{"name":)";
+    writeString(out, name);
+    out << "}}";
+}
+}  // namespace
+
+const fs::path traceFile = readTraceFile();
+
+auto registerThread(std::string name) -> int {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    s.threadNames.push_back(std::move(name));
+    return static_cast<int>(s.threadNames.size()) - 1;
+}
+
+void recordJob(const JobEvent& event) {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    if (s.events.size() >= MAX_EVENTS) {
+        s.events.pop_front();
+    }
+    s.events.push_back(event);
+}
+
+auto write(const fs::path& file) -> bool {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+
+    std::ofstream out(file);
+    out.imbue(std::locale::classic());
+    out << "{\"traceEvents\":[\n";
+    // The queues first: there is always at least one event, and the others are preceded by a comma
+    for (int p = 0; p < JOB_N_PRIORITIES; p++) {
+        if (p > 0) {
+            out << ",\n";
+        }
+        writeThreadName(out, QUEUE_THREAD_BASE + p, std::string("queue ") + PRIORITY_NAMES[p]);
+    }
+    for (size_t i = 0; i < s.threadNames.size(); i++) {
+        out << ",\n";
+        writeThreadName(out, static_cast<int>(i), s.threadNames[i]);
+    }
+
+    uint64_t id = 0;
+    for (const JobEvent& e: s.events) {
+        const char* name = typeName(e.type);
+        const char* priority = PRIORITY_NAMES[e.priority];
+        const int queueThread = QUEUE_THREAD_BASE + e.priority;
+        id++;
+        out << ",\n";
+        out << R"({"name":")" << name << R"(","cat":"job","ph":"X","pid":1,"tid":)" << e.thread << R"(,"ts":)"
+            << e.start << R"(,"dur":)" << e.end - e.start << R"(,"args":{"priority":")" << priority
+            << R"(","queued_us":)" << e.start - e.queued << R"(,"source":")" << e.source << "\"}},\n";
+        // The waits overlap: async slices, so that they are not nested
+        out << R"({"name":")" << name << R"(","cat":"queue","ph":"b","id":)" << id << R"(,"pid":1,"tid":)"
+            << queueThread << R"(,"ts":)" << e.queued << "},\n";
+        out << R"({"name":")" << name << R"(","cat":"queue","ph":"e","id":)" << id << R"(,"pid":1,"tid":)"
+            << queueThread << R"(,"ts":)" << e.start << "}";
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        g_warning("Could not write the job trace %s", file.u8string().c_str());
+        return false;
+    }
+    return true;
+}
+
+void clear() {
+    State& s = state();
+    std::lock_guard lock(s.mutex);
+    s.events.clear();
+    s.threadNames.clear();
+}
+
+}  // namespace xoj::trace
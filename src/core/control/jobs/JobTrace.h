@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * Traces of the jobs run by the Scheduler
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t
+#include <string>   // for string
+
+#include "Job.h"         // for JobType
+#include "Scheduler.h"   // for JobPriority
+#include "filesystem.h"  // for path
+
+/**
+ * @brief Records when each job was queued, started and ended, on which worker, to find out why the rendering stalls
+ * behind other jobs.
+ *
+ * Enabled by setting the environment variable XOURNALPP_JOB_TRACE to the path of the trace file, which is written
+ * when the Scheduler stops, in the Chrome trace event format (open it in Perfetto or chrome://tracing). Each job is a
+ * slice on the track of its worker, and the time it waited in the queue is an async slice on the track of its
+ * priority. Only the last MAX_EVENTS jobs are kept.
+ */
+namespace xoj::trace {
+
+struct JobEvent {
+    JobType type;
+    JobPriority priority;
+    const void* source;
+    /// Times in microseconds, from g_get_monotonic_time()
+    int64_t queued;
+    int64_t start;
+    int64_t end;
+    /// As returned by registerThread()
+    int thread;
+};
+
+constexpr size_t MAX_EVENTS = 200000;
+
+/// The trace file, or an empty path if tracing is disabled
+extern const fs::path traceFile;
+
+inline bool isEnabled() { return !traceFile.empty(); }
+
+/// @return The id of a new worker thread, named `name` in the trace
+int registerThread(std::string name);
+
+void recordJob(const JobEvent& event);
+
+/// Write the recorded jobs to the file, in the Chrome trace event format. @return false on failure
+bool write(const fs::path& file);
+
+/// Forget about the recorded jobs and threads
+void clear();
+
+}  // namespace xoj::trace
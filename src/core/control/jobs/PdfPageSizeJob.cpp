@@ -0,0 +1,82 @@
+#include "PdfPageSizeJob.h"
+
+#include <algorithm>  // for min
+#include <tuple>      // for tuple
+#include <utility>    // for move
+
+#include "control/Control.h"                // for Control
+#include "control/jobs/Job.h"               // for JOB_TYPE_RENDER, JobType
+#include "control/jobs/Scheduler.h"         // for Scheduler, JOB_PRIORITY_LOW
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "model/Document.h"                 // for Document
+#include "model/XojPage.h"                  // for XojPage
+#include "pdf/base/XojPdfPage.h"            // for XojPdfPageSPtr, XojPdfPage
+#include "util/Util.h"                      // for execInUiThread, npos
+
+PdfPageSizeJob::PdfPageSizeJob(Control* control, std::shared_ptr<PdfTextIndex> pdf, std::vector<PageRef> pages):
+        control(control), pdf(std::move(pdf)), pages(std::move(pages)) {}
+
+void PdfPageSizeJob::measureDocument(Control* control) {
+    Document* doc = control->getDocument();
+    std::vector<PageRef> pages;
+    doc->lock();
+    auto pdf = doc->getPdfTextIndex();
+    // The first page has its actual size already
+    for (size_t i = 1; i < doc->getPageCount(); i++) { pages.push_back(doc->getPage(i)); }
+    doc->unlock();
+
+    for (size_t i = 0; i < pages.size(); i += PAGES_PER_JOB) {
+        const auto begin = pages.begin() + static_cast<std::ptrdiff_t>(i);
+        const auto end = pages.begin() + static_cast<std::ptrdiff_t>(std::min(i + PAGES_PER_JOB, pages.size()));
+        auto* job = new PdfPageSizeJob(control, pdf, {begin, end});
+        control->getScheduler()->addJob(job, JOB_PRIORITY_LOW);
+        job->unref();
+    }
+}
+
+auto PdfPageSizeJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+auto PdfPageSizeJob::getSource() -> void* { return this; }
+
+void PdfPageSizeJob::run() {
+    Document* doc = this->control->getDocument();
+
+    std::vector<std::tuple<PageRef, double, double>> resized;
+    for (const PageRef& p: this->pages) {
+        doc->lock();
+        if (doc->getPdfTextIndex() != this->pdf) {
+            // Another pdf was loaded
+            doc->unlock();
+            return;
+        }
+        XojPdfPageSPtr pdfPage = p->getBackgroundType().isPdfPage() ? doc->getPdfPage(p->getPdfPageNr()) : nullptr;
+        const double width = p->getWidth();
+        const double height = p->getHeight();
+        doc->unlock();
+
+        if (pdfPage && (pdfPage->getWidth() != width || pdfPage->getHeight() != height)) {
+            resized.emplace_back(p, pdfPage->getWidth(), pdfPage->getHeight());
+        }
+    }
+    if (resized.empty()) {
+        // The usual case: all the pages have the same size
+        return;
+    }
+
+    Util::execInUiThread([control = this->control, pdf = this->pdf, resized = std::move(resized)]() {
+        Document* doc = control->getDocument();
+        std::vector<size_t> pageNumbers;
+        doc->lock();
+        if (doc->getPdfTextIndex() == pdf) {
+            for (const auto& [p, width, height]: resized) {
+                if (size_t pageNo = doc->indexOf(p); pageNo != npos) {
+                    Document::setPageSize(p, width, height);
+                    pageNumbers.push_back(pageNo);
+                }
+            }
+        }
+        doc->unlock();
+
+        for (size_t pageNo: pageNumbers) { control->firePageSizeChanged(pageNo); }
+    });
+}
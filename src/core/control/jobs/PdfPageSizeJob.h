@@ -0,0 +1,60 @@
+/*
+ * Xournal++
+ *
+ * Reads the sizes of the pages of a newly opened pdf, off the UI thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "Job.h"  // for Job, JobType
+
+class Control;
+class PdfTextIndex;
+
+/**
+ * @brief A Job which gives the pages of a pdf opened for annotation their actual size.
+ *
+ * When a pdf is opened, its pages first get the size of the first page (see Document::readPdf), so that the document
+ * is shown right away. The jobs then read the sizes of the pdf pages, a batch at a time, and resize the pages on the
+ * UI thread. The jobs stop if another pdf was loaded in the meantime.
+ */
+class PdfPageSizeJob: public Job {
+public:
+    PdfPageSizeJob(Control* control, std::shared_ptr<PdfTextIndex> pdf, std::vector<PageRef> pages);
+
+protected:
+    ~PdfPageSizeJob() override = default;
+
+public:
+    /**
+     * Schedule the jobs reading the sizes of the pdf pages of the document of the control, but the first one
+     */
+    static void measureDocument(Control* control);
+
+    JobType getType() override;
+
+    // Every job measures other pages: they can all run in parallel
+    void* getSource() override;
+
+    void run() override;
+
+    /// The number of pages measured by a job
+    static constexpr size_t PAGES_PER_JOB = 64;
+
+private:
+    Control* control;
+    /// Identifies the pdf the pages were created for: replaced when another pdf is loaded
+    std::shared_ptr<PdfTextIndex> pdf;
+    std::vector<PageRef> pages;
+};
@@ -0,0 +1,29 @@
+#include "PdfRasterizeJob.h"
+
+#include <shared_mutex>  // for shared_lock
+#include <utility>       // for move
+
+#include "control/jobs/Job.h"  // for JOB_TYPE_RENDER, JobType
+
+PdfRasterizeJob::PdfRasterizeJob(std::shared_ptr<PdfCache::Lifeline> lifeline, size_t pdfPageNo, int level,
+                                 int dpiScaling):
+        lifeline(std::move(lifeline)), pdfPageNo(pdfPageNo), level(level), dpiScaling(dpiScaling) {}
+
+auto PdfRasterizeJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+// Every rasterization is independent: they can all run in parallel
+auto PdfRasterizeJob::getSource() -> void* { return this; }
+
+void PdfRasterizeJob::run() {
+    std::shared_lock lock(this->lifeline->mutex);
+    if (PdfCache* cache = this->lifeline->cache) {
+        cache->runRasterization(this->pdfPageNo, this->level, this->dpiScaling);
+    }
+}
+
+void PdfRasterizeJob::onDelete() {
+    std::shared_lock lock(this->lifeline->mutex);
+    if (PdfCache* cache = this->lifeline->cache) {
+        cache->cancelRasterization(this->pdfPageNo, this->level);
+    }
+}
@@ -0,0 +1,47 @@
+/*
+ * Xournal++
+ *
+ * A job which rasterizes a PDF page into a PdfCache
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+
+#include "control/PdfCache.h"  // for PdfCache
+
+#include "Job.h"  // for Job, JobType
+
+/**
+ * @brief A Job which rasterizes a page of the PDF background at a level of a PdfCache, off the render path.
+ *      The job does nothing if the PdfCache has been destroyed in the meantime.
+ */
+class PdfRasterizeJob: public Job {
+public:
+    PdfRasterizeJob(std::shared_ptr<PdfCache::Lifeline> lifeline, size_t pdfPageNo, int level, int dpiScaling);
+
+protected:
+    ~PdfRasterizeJob() override = default;
+
+public:
+    JobType getType() override;
+
+    void* getSource() override;
+
+    void run() override;
+
+protected:
+    void onDelete() override;
+
+private:
+    std::shared_ptr<PdfCache::Lifeline> lifeline;
+    size_t pdfPageNo;
+    int level;
+    int dpiScaling;
+};
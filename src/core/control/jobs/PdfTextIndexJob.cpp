@@ -0,0 +1,51 @@
+#include "PdfTextIndexJob.h"
+
+#include <algorithm>  // for min
+#include <utility>    // for move
+
+#include "control/jobs/Job.h"        // for JOB_TYPE_RENDER, JobType
+#include "control/jobs/Scheduler.h"  // for Scheduler, JOB_PRIORITY_NONE
+#include "model/Document.h"          // for Document
+#include "model/PdfTextIndex.h"      // for PdfTextIndex
+#include "pdf/base/XojPdfPage.h"     // for XojPdfPageSPtr, XojPdfPage
+
+PdfTextIndexJob::PdfTextIndexJob(std::shared_ptr<PdfTextIndex> index, Document* doc, std::vector<size_t> pdfPages):
+        index(std::move(index)), doc(doc), pdfPages(std::move(pdfPages)) {}
+
+void PdfTextIndexJob::indexDocument(Document* doc, Scheduler* scheduler) {
+    doc->lock();
+    auto index = doc->getPdfTextIndex();
+    doc->unlock();
+
+    const auto pages = index->takePagesToIndex();
+    for (size_t i = 0; i < pages.size(); i += PAGES_PER_JOB) {
+        const auto end = pages.begin() + static_cast<std::ptrdiff_t>(std::min(i + PAGES_PER_JOB, pages.size()));
+        auto* job = new PdfTextIndexJob(index, doc, {pages.begin() + static_cast<std::ptrdiff_t>(i), end});
+        scheduler->addJob(job, JOB_PRIORITY_NONE);
+        job->unref();
+    }
+}
+
+auto PdfTextIndexJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+auto PdfTextIndexJob::getSource() -> void* { return this; }
+
+void PdfTextIndexJob::run() {
+    for (size_t i = 0; i < this->pdfPages.size(); i++) {
+        doc->lock();
+        XojPdfPageSPtr page;
+        if (doc->getPdfTextIndex() == this->index) {
+            page = doc->getPdfPage(this->pdfPages[i]);
+        }
+        doc->unlock();
+
+        if (!page) {
+            // Another pdf was loaded, or the page is missing: the search asks poppler for the remaining pages
+            this->index->cancelPages({this->pdfPages.begin() + static_cast<std::ptrdiff_t>(i), this->pdfPages.end()});
+            return;
+        }
+        this->index->setPageText(this->pdfPages[i], page->getText());
+    }
+}
+
+void PdfTextIndexJob::onDelete() { this->index->cancelPages(this->pdfPages); }
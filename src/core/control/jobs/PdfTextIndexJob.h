@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Extraction of the text of the pdf pages for the search, off the UI thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "Job.h"  // for Job, JobType
+
+class Document;
+class PdfTextIndex;
+class Scheduler;
+
+/**
+ * @brief A Job which extracts the text of some pages of the pdf background into the PdfTextIndex of the document.
+ *      The jobs run on the render workers, after every render job. The job stops if another pdf was loaded in the
+ *      meantime.
+ */
+class PdfTextIndexJob: public Job {
+public:
+    PdfTextIndexJob(std::shared_ptr<PdfTextIndex> index, Document* doc, std::vector<size_t> pdfPages);
+
+protected:
+    ~PdfTextIndexJob() override = default;
+
+public:
+    /**
+     * Schedule the extraction of the text of the pdf pages of the document which are not in its index yet
+     */
+    static void indexDocument(Document* doc, Scheduler* scheduler);
+
+    JobType getType() override;
+
+    // Every job extracts other pages: they can all run in parallel
+    void* getSource() override;
+
+    void run() override;
+
+    /// The number of pages extracted by a job: a job never delays the rendering of the pages for long
+    static constexpr size_t PAGES_PER_JOB = 16;
+
+protected:
+    void onDelete() override;
+
+private:
+    std::shared_ptr<PdfTextIndex> index;
+    Document* doc;
+    std::vector<size_t> pdfPages;
+};
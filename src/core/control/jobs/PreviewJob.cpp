@@ -1,18 +1,24 @@
 #include "PreviewJob.h"
 
-#include <memory>  // for __s...
-#include <mutex>   // for mutex
-#include <vector>  // for vector
+#include <memory>   // for __s...
+#include <mutex>    // for mutex, lock_guard
+#include <utility>  // for move
+#include <vector>   // for vector
 
 #include <glib-object.h>  // for g_o...
 #include <gtk/gtk.h>      // for Gtk...
 
 #include "control/Control.h"                                      // for Con...
+#include "control/ThumbnailCache.h"                               // for Thu...
 #include "control/jobs/Job.h"                                     // for JOB...
+#include "gui/MainWindow.h"                                       // for MainWindow
 #include "gui/Shadow.h"                                           // for Shadow
+#include "gui/XournalView.h"                                      // for XournalView
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"         // for Sid...
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"    // for Sid...
+#include "gui/sidebar/previews/layer/LayerThumbnailCache.h"       // for LayerThumbnailCache
 #include "gui/sidebar/previews/layer/SidebarPreviewLayerEntry.h"  // for Sid...
+#include "gui/sidebar/previews/layer/SidebarPreviewLayers.h"      // for SidebarPreviewLayers
 #include "model/Document.h"                                       // for Doc...
 #include "model/Layer.h"                                          // for Layer
 #include "model/PageRef.h"                                        // for Pag...
@@ -34,89 +40,166 @@ auto PreviewJob::getSource() -> void* { return this->sidebarPreview; }
 auto PreviewJob::getType() -> JobType { return JOB_TYPE_PREVIEW; }
 
 void PreviewJob::initGraphics() {
+    buffer = createSurface();
+    cr = createContext(buffer.get());
+}
+
+auto PreviewJob::createSurface() const -> xoj::util::CairoSurfaceSPtr {
     auto w = this->sidebarPreview->imageWidth;
     auto h = this->sidebarPreview->imageHeight;
     auto DPIscaling = this->sidebarPreview->DPIscaling;
-    buffer.reset(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w * DPIscaling, h * DPIscaling), xoj::util::adopt);
-    cairo_surface_set_device_scale(buffer.get(), DPIscaling, DPIscaling);
-    cr.reset(cairo_create(buffer.get()), xoj::util::adopt);
+    xoj::util::CairoSurfaceSPtr surface(
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w * DPIscaling, h * DPIscaling), xoj::util::adopt);
+    cairo_surface_set_device_scale(surface.get(), DPIscaling, DPIscaling);
+    return surface;
+}
+
+auto PreviewJob::createContext(cairo_surface_t* surface) const -> xoj::util::CairoSPtr {
+    xoj::util::CairoSPtr context(cairo_create(surface), xoj::util::adopt);
     double zoom = this->sidebarPreview->sidebar->getZoom();
-    cairo_translate(cr.get(), Shadow::getShadowTopLeftSize() + 2, Shadow::getShadowTopLeftSize() + 2);
-    cairo_scale(cr.get(), zoom, zoom);
+    cairo_translate(context.get(), Shadow::getShadowTopLeftSize() + 2, Shadow::getShadowTopLeftSize() + 2);
+    cairo_scale(context.get(), zoom, zoom);
+    return context;
 }
 
 void PreviewJob::finishPaint() {
     auto lock = std::lock_guard(this->sidebarPreview->drawingMutex);
     this->sidebarPreview->buffer = std::move(this->buffer);
+    if (auto* layerPreview = dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview)) {
+        layerPreview->renderedRevisions = std::move(this->layerRevisions);
+    }
     Util::execInUiThread([btn = this->sidebarPreview->button]() { gtk_widget_queue_draw(btn.get()); });
 }
 
-void PreviewJob::drawPage() {
-    PageRef page = this->sidebarPreview->page;
+auto PreviewJob::paintFromPageBuffer() -> bool {
+    if (this->sidebarPreview->getRenderType() != RENDER_TYPE_PAGE_PREVIEW) {
+        return false;
+    }
+    MainWindow* win = this->sidebarPreview->sidebar->getControl()->getWindow();
+    return win && win->getXournal()->paintFromPageBuffer(this->sidebarPreview->page, cr.get());
+}
+
+void PreviewJob::readThumbnailKey() {
+    if (this->sidebarPreview->sidebar->getThumbnailCache() == nullptr ||
+        this->sidebarPreview->getRenderType() != RENDER_TYPE_PAGE_PREVIEW) {
+        return;
+    }
     Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
-    DocumentView view;
-    view.setPdfCache(this->sidebarPreview->sidebar->getCache());
-    PreviewRenderType type = this->sidebarPreview->getRenderType();
-    Layer::Index layer = 0;
+    DocumentPageReadLock lock(*doc, *this->sidebarPreview->page);
+    this->thumbnailFile = doc->getFilepath();
+    if (this->thumbnailFile.empty()) {
+        // Not saved yet
+        return;
+    }
+    this->thumbnailPageIndex = doc->indexOf(this->sidebarPreview->page);
+    if (this->thumbnailPageIndex != npos) {
+        this->thumbnailContentHash = ThumbnailCache::hashPage(*this->sidebarPreview->page, doc->getPdfFilepath());
+    }
+}
 
-    doc->lock();
+auto PreviewJob::loadThumbnail() -> bool {
+    if (this->thumbnailPageIndex == npos) {
+        return false;
+    }
+    auto DPIscaling = this->sidebarPreview->DPIscaling;
+    auto thumbnail = this->sidebarPreview->sidebar->getThumbnailCache()->load(
+            this->thumbnailFile, this->thumbnailPageIndex, this->thumbnailContentHash,
+            this->sidebarPreview->imageWidth * DPIscaling, this->sidebarPreview->imageHeight * DPIscaling);
+    if (!thumbnail) {
+        return false;
+    }
+    cairo_surface_set_device_scale(thumbnail.get(), DPIscaling, DPIscaling);
+    this->buffer = std::move(thumbnail);
+    return true;
+}
 
-    // getLayer is not defined for page preview
-    if (type != RENDER_TYPE_PAGE_PREVIEW) {
-        layer = (dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview))->getLayer();
+void PreviewJob::storeThumbnail() {
+    if (this->thumbnailPageIndex == npos) {
+        return;
     }
+    cairo_surface_flush(this->buffer.get());
+    this->sidebarPreview->sidebar->getThumbnailCache()->store(this->thumbnailFile, this->thumbnailPageIndex,
+                                                              this->thumbnailContentHash, this->buffer.get());
+}
 
-    auto context = xoj::view::Context::createDefault(cr.get());
+void PreviewJob::drawPage() {
+    PageRef page = this->sidebarPreview->page;
+    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
+    DocumentView view;
 
-    switch (type) {
-        case RENDER_TYPE_PAGE_PREVIEW:
-            // render all layers
-            view.drawPage(page, cr.get(), true);
-            break;
+    DocumentPageReadLock lock(*doc, *page);
+    // The main view replaces the PDF cache with the document lock held
+    view.setPdfCache(this->sidebarPreview->sidebar->getCache());
 
-        case RENDER_TYPE_PAGE_LAYER:
-            // render single layer
-            view.initDrawing(page, cr.get(), true);
-            if (layer == 0) {
-                auto flags = xoj::view::BACKGROUND_SHOW_ALL;
-                flags.forceVisible = xoj::view::FORCE_VISIBLE;
-                view.drawBackground(flags);
-            } else {
-                view.drawBackground(xoj::view::BACKGROUND_FORCE_PAINT_BACKGROUND_COLOR_ONLY);
-                Layer* drawLayer = (*page->getLayers())[layer - 1];
-                xoj::view::LayerView layerView(drawLayer);
-                layerView.draw(context);
-            }
-            view.finializeDrawing();
-            break;
+    // The previews are not rendered again once the PDF page is rasterized: wait for it
+    auto flags = xoj::view::BACKGROUND_SHOW_ALL;
+    flags.waitForPdf = xoj::view::WAIT_FOR_PDF_RASTERIZATION;
+    view.drawPage(page, cr.get(), true, flags);
+}
 
-        case RENDER_TYPE_PAGE_LAYERSTACK: {
-            // render all layers up to layer
+void PreviewJob::drawLayers() {
+    auto* preview = dynamic_cast<SidebarPreviewLayerEntry*>(this->sidebarPreview);
+    std::shared_ptr<LayerThumbnailCache> thumbnails = preview->sidebar->getLayerThumbnails();
+    PageRef page = preview->page;
+    Document* doc = preview->sidebar->getControl()->getDocument();
+
+    DocumentPageReadLock lock(*doc, *page);
+    this->layerRevisions = preview->getRevisions();
+
+    const int width = cairo_image_surface_get_width(buffer.get());
+    const int height = cairo_image_surface_get_height(buffer.get());
+    for (const LayerRevision& what: this->layerRevisions) {
+        if (!what.layer && !preview->stacked && preview->getLayer() != 0) {
+            // A single layer is shown on the background color, which is cheap to paint
+            DocumentView view;
             view.initDrawing(page, cr.get(), true);
-            auto flags = xoj::view::BACKGROUND_SHOW_ALL;
-            flags.forceVisible = xoj::view::FORCE_VISIBLE;
-            view.drawBackground(flags);
-            for (Layer::Index i = 0; i < layer; i++) {
-                Layer* drawLayer = (*page->getLayers())[i];
-                xoj::view::LayerView layerView(drawLayer);
-                layerView.draw(context);
-            }
+            view.drawBackground(xoj::view::BACKGROUND_FORCE_PAINT_BACKGROUND_COLOR_ONLY);
             view.finializeDrawing();
-            break;
+            continue;
         }
-        default:
-            // unknown type
-            break;
+
+        // The miniatures of the background and of the layers are shared by the previews: e.g. a stack is composed
+        // from the miniatures of its layers, and a change of a layer only renders this layer again
+        auto thumbnail = thumbnails->get(what, width, height);
+        if (!thumbnail) {
+            thumbnail = renderThumbnail(what);
+            thumbnails->store(what, thumbnail);
+        }
+        xoj::util::CairoSaveGuard saveGuard(cr.get());
+        cairo_identity_matrix(cr.get());
+        cairo_set_source_surface(cr.get(), thumbnail.get(), 0, 0);
+        cairo_paint(cr.get());
     }
+}
 
-    doc->unlock();
+auto PreviewJob::renderThumbnail(const LayerRevision& what) const -> xoj::util::CairoSurfaceSPtr {
+    auto surface = createSurface();
+    auto context = createContext(surface.get());
+    clipToPage(context.get());
+
+    if (what.layer) {
+        xoj::view::LayerView layerView(what.layer);
+        layerView.draw(xoj::view::Context::createDefault(context.get()));
+    } else {
+        DocumentView view;
+        view.setPdfCache(this->sidebarPreview->sidebar->getCache());
+        // The previews are not rendered again once the PDF page is rasterized: wait for it
+        auto flags = xoj::view::BACKGROUND_SHOW_ALL;
+        flags.waitForPdf = xoj::view::WAIT_FOR_PDF_RASTERIZATION;
+        flags.forceVisible = xoj::view::FORCE_VISIBLE;
+        view.initDrawing(this->sidebarPreview->page, context.get(), true);
+        view.drawBackground(flags);
+        view.finializeDrawing();
+    }
+    cairo_surface_flush(surface.get());
+    return surface;
 }
 
-void PreviewJob::clipToPage() {
+void PreviewJob::clipToPage(cairo_t* context) const {
     // Only render within the preview page. Without this, the when preview jobs attempt
     // to clear the display, we fill a region larger than the inside of the preview page!
-    cairo_rectangle(cr.get(), 0, 0, this->sidebarPreview->page->getWidth(), this->sidebarPreview->page->getHeight());
-    cairo_clip(cr.get());
+    cairo_rectangle(context, 0, 0, this->sidebarPreview->page->getWidth(), this->sidebarPreview->page->getHeight());
+    cairo_clip(context);
 }
 
 void PreviewJob::run() {
@@ -124,8 +207,21 @@ void PreviewJob::run() {
         return;
     }
 
+    // A reopened document shows the previews stored in its last session
+    readThumbnailKey();
+    if (loadThumbnail()) {
+        finishPaint();
+        return;
+    }
+
     initGraphics();
-    clipToPage();
-    drawPage();
+    clipToPage(cr.get());
+    if (this->sidebarPreview->getRenderType() != RENDER_TYPE_PAGE_PREVIEW) {
+        drawLayers();
+    } else if (!paintFromPageBuffer()) {
+        // Downscaling the buffer of the displayed page is way cheaper than rendering the page again
+        drawPage();
+    }
+    storeThumbnail();
     finishPaint();
 }
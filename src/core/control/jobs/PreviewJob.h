@@ -11,13 +11,20 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <vector>   // for vector
+
 #include <cairo.h>  // for cairo_surface_t, cairo_t
 
+#include "util/Util.h"  // for npos
 #include "util/raii/CairoWrappers.h"
 
-#include "Job.h"  // for Job, JobType
+#include "Job.h"         // for Job, JobType
+#include "filesystem.h"  // for path
 
 class SidebarPreviewBaseEntry;
+struct LayerRevision;
 
 /**
  * @brief A Job which renders a SidebarPreviewPage
@@ -39,9 +46,34 @@ public:
 
 private:
     void initGraphics();
-    void clipToPage();
+    /// A transparent surface of the size of the preview
+    xoj::util::CairoSurfaceSPtr createSurface() const;
+    /// A context drawing the page on the surface
+    xoj::util::CairoSPtr createContext(cairo_surface_t* surface) const;
+    void clipToPage(cairo_t* context) const;
     void finishPaint();
     void drawPage();
+    /**
+     * Paint the preview of a layer or of a stack of layers, from the miniatures of the layers (see LayerThumbnailCache)
+     */
+    void drawLayers();
+    xoj::util::CairoSurfaceSPtr renderThumbnail(const LayerRevision& what) const;
+    /**
+     * Paint a page preview from the buffer of the page in the main view, if it is complete and up to date
+     * @return false if nothing was painted
+     */
+    bool paintFromPageBuffer();
+
+    /**
+     * Read what identifies the preview in the ThumbnailCache, if the preview is cached
+     */
+    void readThumbnailKey();
+    /**
+     * Use the preview stored in the ThumbnailCache as buffer
+     * @return false if there is none for the current content of the page
+     */
+    bool loadThumbnail();
+    void storeThumbnail();
 
 private:
     /**
@@ -63,4 +95,12 @@ private:
      * Sidebar preview
      */
     SidebarPreviewBaseEntry* sidebarPreview = nullptr;
+
+    /// The key of the preview in the ThumbnailCache: thumbnailPageIndex is npos if the preview is not cached
+    fs::path thumbnailFile;
+    size_t thumbnailPageIndex = npos;
+    uint64_t thumbnailContentHash = 0;
+
+    /// What a layer preview shows, see SidebarPreviewLayerEntry::getRevisions()
+    std::vector<LayerRevision> layerRevisions;
 };
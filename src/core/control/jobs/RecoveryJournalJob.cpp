@@ -0,0 +1,13 @@
+#include "RecoveryJournalJob.h"
+
+#include "control/Control.h"                  // for Control
+#include "control/jobs/Job.h"                 // for JOB_TYPE_AUTOSAVE, JobType
+#include "control/xojfile/RecoveryJournal.h"  // for RecoveryJournal
+
+RecoveryJournalJob::RecoveryJournalJob(Control* control): control(control) {}
+
+RecoveryJournalJob::~RecoveryJournalJob() = default;
+
+void RecoveryJournalJob::run() { control->getRecoveryJournal()->record(control->getDocument()); }
+
+auto RecoveryJournalJob::getType() -> JobType { return JOB_TYPE_AUTOSAVE; }
@@ -0,0 +1,32 @@
+/*
+ * Xournal++
+ *
+ * Records the changes of the document in the recovery journal
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "Job.h"  // for Job, JobType
+
+class Control;
+
+class RecoveryJournalJob: public Job {
+public:
+    RecoveryJournalJob(Control* control);
+
+protected:
+    ~RecoveryJournalJob() override;
+
+public:
+    void run() override;
+
+    JobType getType() override;
+
+private:
+    Control* control = nullptr;
+};
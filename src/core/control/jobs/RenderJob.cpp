@@ -1,27 +1,34 @@
 #include "RenderJob.h"
 
-#include <mutex>    // for mutex
-#include <utility>  // for move
-#include <vector>   // for vector
-
-#include <cairo.h>  // for cairo_create, cairo_destroy, cairo_...
-
-#include "control/Control.h"            // for Control
-#include "control/ToolEnums.h"          // for TOOL_PLAY_OBJECT
-#include "control/ToolHandler.h"        // for ToolHandler
-#include "control/jobs/Job.h"           // for JOB_TYPE_RENDER, JobType
-#include "gui/PageView.h"               // for XojPageView
-#include "gui/XournalView.h"            // for XournalView
-#include "gui/widgets/XournalWidget.h"  // for gtk_xournal_repaint_area
-#include "model/Document.h"             // for Document
-#include "model/XojPage.h"              // for Page
-#include "util/Assert.h"                // for xoj_assert
-#include "util/Rectangle.h"             // for Rectangle
-#include "util/Util.h"                  // for execInUiThread
-#include "util/raii/CairoWrappers.h"    // for CairoSurfaceSPtr, CairoSPtr
-#include "util/safe_casts.h"            // for strict_cast, as_signed, as_si...
-#include "view/DocumentView.h"          // for DocumentView
-#include "view/Mask.h"                  // for Mask
+#include <algorithm>  // for find_if
+#include <cstdint>    // for int64_t
+#include <mutex>      // for mutex
+#include <optional>   // for optional
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include <cairo.h>  // for cairo_region_t, cairo_clip, cairo_...
+
+#include "control/Control.h"                // for Control
+#include "control/PerfStats.h"              // for isEnabled, now, recordRenderJob
+#include "control/ToolEnums.h"              // for TOOL_PLAY_OBJECT
+#include "control/ToolHandler.h"            // for ToolHandler
+#include "control/jobs/Job.h"               // for JOB_TYPE_RENDER, JobType
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "gui/PageView.h"                   // for XojPageView
+#include "gui/RepaintHandler.h"             // for RepaintHandler
+#include "gui/XournalView.h"                // for XournalView
+#include "model/Document.h"                 // for Document, DocumentPageReadLock
+#include "model/Layer.h"                    // for Layer
+#include "model/XojPage.h"                  // for Page
+#include "util/Assert.h"                    // for xoj_assert
+#include "util/Range.h"                     // for Range
+#include "util/Rectangle.h"                 // for Rectangle
+#include "util/raii/CairoWrappers.h"        // for CairoSaveGuard, CairoRegionSPtr
+#include "util/safe_casts.h"                // for strict_cast, as_signed, as_si...
+#include "view/DocumentView.h"              // for DocumentView
+#include "view/Mask.h"                      // for Mask
+#include "view/TiledBuffer.h"               // for TiledBuffer
 
 #if defined(__has_cpp_attribute) && __has_cpp_attribute(likely)
 #define XOJ_CPP20_UNLIKELY [[unlikely]]
@@ -29,88 +36,456 @@
 #define XOJ_CPP20_UNLIKELY
 #endif
 
-using xoj::util::Rectangle;
-
 RenderJob::RenderJob(XojPageView* view): view(view) {}
 
 auto RenderJob::getSource() -> void* { return this->view; }
 
-void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
-    /**
-     * Padding seems to be necessary to prevent artefacts of most strokes.
-     * These artefacts are most pronounced when using the stroke deletion
-     * tool on ellipses, but also occur occasionally when removing regular
-     * strokes.
-     **/
-    constexpr int RENDER_PADDING = 1;
+/// Add the rectangles of the region to the current path, and clip to them, on whole pixels
+static void clipToRegion(cairo_t* cr, const cairo_region_t* region) {
+    const int n = cairo_region_num_rectangles(region);
+    for (int i = 0; i < n; i++) {
+        cairo_rectangle_int_t r;
+        cairo_region_get_rectangle(region, i, &r);
+        cairo_rectangle(cr, r.x, r.y, r.width, r.height);
+    }
+    // The pixels are either repainted completely or left untouched, so that no seam appears at the region's edges
+    cairo_antialias_t antialias = cairo_get_antialias(cr);
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+    cairo_clip(cr);
+    cairo_set_antialias(cr, antialias);
+}
 
-    Range maskRange(rect);
-    maskRange.addPadding(RENDER_PADDING);
-    xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(), maskRange, view->xournal->getZoom(),
-                            CAIRO_CONTENT_COLOR_ALPHA);
+bool RenderJob::rerenderRegion(const cairo_region_t* region) {
+    cairo_rectangle_int_t extents;
+    cairo_region_get_extents(region, &extents);
+    const Range maskRange(extents.x, extents.y, extents.x + extents.width, extents.y + extents.height);
+    xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(), maskRange, zoom, CAIRO_CONTENT_COLOR_ALPHA);
+    // Only the elements intersecting the region get drawn, in a single traversal of the page
+    clipToRegion(newMask.get(), region);
 
-    renderToBuffer(newMask.get());
+    auto cacheUse = renderWithLowerLayersCache(newMask, maskRange);
+    if (cacheUse == LowerLayersCacheUse::CANCELLED ||
+        (cacheUse == LowerLayersCacheUse::NOT_CACHED && !renderToBuffer(newMask.get()))) {
+        // The zoom changed: the page will be rendered completely anyway
+        return false;
+    }
 
     std::lock_guard lock(this->view->drawingMutex);
     if (!view->buffer.isInitialized()) {
         // Todo: the buffer must not be uninitializable here, either by moving it into the job or by locking it at job
         // creation a shared prt may also be suffice.
-        XOJ_CPP20_UNLIKELY return;
+        XOJ_CPP20_UNLIKELY return true;
+    }
+    // Only the tiles already rendered need an update: the missing ones will be rendered from scratch.
+    view->buffer.forEachTile(maskRange, [&newMask, region](cairo_t* cr) {
+        xoj::util::CairoSaveGuard guard(cr);
+        clipToRegion(cr, region);
+        newMask.paintTo(cr);
+    });
+    return true;
+}
+
+auto RenderJob::renderWithLowerLayersCache(xoj::view::Mask& mask, const Range& area) -> LowerLayersCacheUse {
+    const PageRef& page = this->view->page;
+    DocumentPageReadLock docLock(*this->view->xournal->getDocument(), *page);
+    const Layer::Index selected = page->getSelectedLayerId();
+    if (selected <= 1) {
+        // No layer below the selected one: nothing to gain
+        return LowerLayersCacheUse::NOT_CACHED;
+    }
+
+    DocumentView localView;
+    initDocumentView(localView);
+
+    XojPageView::LowerLayersState state;
+    state.markAudioStroke = view->getXournal()->getControl()->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT;
+    const auto& layers = *page->getLayers();
+    for (Layer::Index i = 0; i + 1 < selected; i++) {
+        state.layers.emplace_back(layers[i], layers[i]->getRevision());
+    }
+
+    const int dpiScaling = view->xournal->getDpiScaleFactor();
+    const double width = page->getWidth();
+    const double height = page->getHeight();
+    std::vector<xoj::view::TiledBuffer::TileIndex> tiles;
+    unsigned int generation = 0;
+    xoj::util::Rectangle<int> extent;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        if (!view->lowerLayersCacheEnabled || !view->buffer.isInitialized() || view->buffer.getZoom() != zoom ||
+            view->buffer.getDPIScaling() != dpiScaling) {
+            return LowerLayersCacheUse::NOT_CACHED;
+        }
+        auto& cache = view->lowerLayersBuffer;
+        if (!cache.isInitialized() || cache.getZoom() != zoom || cache.getDPIScaling() != dpiScaling ||
+            view->lowerLayersState != state) {
+            view->invalidateLowerLayersCache();
+            cache = xoj::view::TiledBuffer(dpiScaling, zoom, width, height);
+            view->lowerLayersState = std::move(state);
+        }
+        generation = view->lowerLayersGeneration;
+        tiles = cache.getMissingTiles(area);
+        if (!tiles.empty()) {
+            extent = cache.getPixelExtent(tiles);
+        }
+    }
+
+    std::optional<xoj::view::Mask> lowerLayers;
+    if (!tiles.empty()) {
+        lowerLayers.emplace(dpiScaling, extent, zoom, CAIRO_CONTENT_COLOR_ALPHA);
+        localView.drawLayerRange(page, lowerLayers->get(), false, true, 0, selected - 1);
+        if (localView.wasCancelled()) {
+            return LowerLayersCacheUse::CANCELLED;
+        }
+    }
+
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        if (view->lowerLayersGeneration != generation) {
+            // Invalidated in the meantime
+            return LowerLayersCacheUse::NOT_CACHED;
+        }
+        auto& cache = view->lowerLayersBuffer;
+        if (lowerLayers) {
+            cache.insertTiles(tiles, *lowerLayers);
+        }
+        cache.paintTo(mask.get(), area);
+        cache.evictTiles(area);
+    }
+
+    localView.drawLayerRange(page, mask.get(), false, false, selected - 1, layers.size());
+    return localView.wasCancelled() ? LowerLayersCacheUse::CANCELLED : LowerLayersCacheUse::DONE;
+}
+
+bool RenderJob::composeLayers(const Range& tilesArea) {
+    const PageRef& page = this->view->page;
+    DocumentPageReadLock docLock(*this->view->xournal->getDocument(), *page);
+    const bool markAudioStroke =
+            view->getXournal()->getControl()->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT;
+
+    const int dpiScaling = view->xournal->getDpiScaleFactor();
+    const double width = page->getWidth();
+    const double height = page->getHeight();
+    xoj::view::TiledBuffer newBuffer(dpiScaling, zoom, width, height);
+    auto tiles = newBuffer.getMissingTiles(tilesArea.empty() ? Range(0, 0, width, height) : tilesArea);
+    if (tiles.size() > xoj::view::TiledBuffer::DEFAULT_MAX_TILES) {
+        tiles.resize(xoj::view::TiledBuffer::DEFAULT_MAX_TILES);
+    }
+    if (tiles.empty()) {
+        return false;
+    }
+    const auto extent = newBuffer.getPixelExtent(tiles);
+    // Inset by half a pixel, not to reach the neighbouring tiles
+    const Range area((extent.x + 0.5) / zoom, (extent.y + 0.5) / zoom, (extent.x + extent.width - 0.5) / zoom,
+                     (extent.y + extent.height - 0.5) / zoom);
+
+    // Take the cached layers from the view, so that it is not locked while rendering
+    std::vector<XojPageView::LayerTiles> cached;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        if (!view->lowerLayersCacheEnabled || !view->buffer.isInitialized() || view->bufferIsPreview ||
+            view->buffer.getZoom() != zoom || view->buffer.getDPIScaling() != dpiScaling) {
+            return false;
+        }
+        if (view->layerTilesMarkAudioStroke == markAudioStroke) {
+            cached = std::move(view->layerTiles);
+        }
+        view->layerTiles.clear();
+    }
+
+    DocumentView localView;
+    initDocumentView(localView);
+    xoj::view::Mask composed(dpiScaling, extent, zoom, CAIRO_CONTENT_COLOR_ALPHA);
+
+    // The background (with its visibility, the checkerboard replacing a hidden one) and the visible layers, bottom up.
+    // The selected layer is always rendered: it may be edited (e.g. a text) in ways its revision does not tell.
+    constexpr size_t MAX_CACHED_TILES = 4 * xoj::view::TiledBuffer::DEFAULT_MAX_TILES;
+    std::vector<XojPageView::LayerTiles> layerTiles;
+    const auto& layers = *page->getLayers();
+    const Layer::Index selected = page->getSelectedLayerId();
+    for (Layer::Index i = 0; i <= layers.size(); i++) {
+        const Layer* layer = i == 0 ? nullptr : layers[i - 1];
+        const bool visible = page->isLayerVisible(i);
+        const uint64_t revision = i == 0 ? page->getBackgroundRevision() * 2 + (visible ? 1 : 0) :
+                                           layer->getContentRevision() + page->getPageWideChangeCount();
+        auto it = std::find_if(cached.begin(), cached.end(), [layer](const auto& l) { return l.layer == layer; });
+        const bool upToDate = it != cached.end() && it->revision == revision && (i == 0 || i != selected);
+        if (!visible) {
+            if (upToDate) {
+                // Kept for when it is shown again
+                layerTiles.push_back(std::move(*it));
+            }
+            continue;
+        }
+
+        XojPageView::LayerTiles l{layer, revision, {}};
+        if (upToDate) {
+            l = std::move(*it);
+        } else {
+            l.tiles = xoj::view::TiledBuffer(dpiScaling, zoom, width, height);
+        }
+        auto missing = l.tiles.getMissingTiles(area);
+        if (!missing.empty()) {
+            xoj::view::Mask mask(dpiScaling, l.tiles.getPixelExtent(missing), zoom, CAIRO_CONTENT_COLOR_ALPHA);
+            localView.drawLayerRange(page, mask.get(), false, i == 0, i == 0 ? 0 : i - 1, i);
+            if (localView.wasCancelled()) {
+                requeueCompleteRerender();
+                return true;
+            }
+            l.tiles.insertTiles(missing, mask);
+        }
+        l.tiles.paintTo(composed.get(), area);
+        l.tiles.evictTiles(area, tiles.size());
+        if ((i == 0 || i != selected) && (layerTiles.size() + 1) * tiles.size() <= MAX_CACHED_TILES) {
+            layerTiles.push_back(std::move(l));
+        }
+    }
+
+    if (isOutdated()) {
+        requeueCompleteRerender();
+        return true;
+    }
+    newBuffer.insertTiles(tiles, composed);
+
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        if (!view->buffer.isInitialized() || view->buffer.getZoom() != zoom) {
+            // Dropped in the meantime
+            return true;
+        }
+        std::swap(this->view->buffer, newBuffer);
+        this->view->hasDraftTiles = false;
+        this->view->layerTiles = std::move(layerTiles);
+        this->view->layerTilesMarkAudioStroke = markAudioStroke;
     }
-    newMask.paintTo(view->buffer.get());
+    repaintPage();
+    return true;
+}
+
+bool RenderJob::renderTiles(xoj::view::TiledBuffer& buffer, const std::vector<xoj::view::TiledBuffer::TileIndex>& tiles,
+                            xoj::view::BackgroundFlags flags) const {
+    if (tiles.empty()) {
+        return true;
+    }
+    xoj::view::Mask mask(buffer.getDPIScaling(), buffer.getPixelExtent(tiles), buffer.getZoom(),
+                         CAIRO_CONTENT_COLOR_ALPHA);
+    if (!renderToBuffer(mask.get(), flags)) {
+        return false;
+    }
+    buffer.insertTiles(tiles, mask);
+    return true;
+}
+
+void RenderJob::renderPreview() {
+    /// Resolution of the preview, relative to the full render
+    constexpr double PREVIEW_ZOOM_FACTOR = 0.25;
+
+    const double width = view->page->getWidth();
+    const double height = view->page->getHeight();
+    xoj::view::TiledBuffer preview(view->xournal->getDpiScaleFactor(), zoom * PREVIEW_ZOOM_FACTOR, width, height);
+    auto tiles = preview.getMissingTiles(Range(0, 0, width, height));
+    if (tiles.size() > xoj::view::TiledBuffer::DEFAULT_MAX_TILES) {
+        tiles.resize(xoj::view::TiledBuffer::DEFAULT_MAX_TILES);
+    }
+
+    // Rasterizing the PDF is what takes time: only use what the PdfCache already has
+    xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL;
+    flags.onlyCachedPdf = xoj::view::ONLY_USE_CACHED_PDF;
+    if (!renderTiles(preview, tiles, flags)) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        if (this->view->buffer.isInitialized()) {
+            // Something better is already displayed
+            return;
+        }
+        this->view->buffer = std::move(preview);
+        this->view->bufferIsPreview = true;
+    }
+    repaintPage();
+}
+
+void RenderJob::renderMissingTiles(const Range& area) {
+    if (area.empty()) {
+        return;
+    }
+
+    // Render into a detached buffer, so that the view's buffer is not locked while rendering
+    xoj::view::TiledBuffer tmp;
+    std::vector<xoj::view::TiledBuffer::TileIndex> tiles;
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        const auto& buffer = this->view->buffer;
+        if (!buffer.isInitialized() || buffer.getZoom() != zoom ||
+            buffer.getDPIScaling() != view->xournal->getDpiScaleFactor()) {
+            // A complete rerender is pending
+            return;
+        }
+        tiles = buffer.getMissingTiles(area);
+        if (tiles.empty()) {
+            return;
+        }
+        tmp = xoj::view::TiledBuffer(buffer.getDPIScaling(), buffer.getZoom(), view->page->getWidth(),
+                                     view->page->getHeight());
+    }
+
+    const auto extent = tmp.getPixelExtent(tiles);
+    xoj::view::Mask mask(tmp.getDPIScaling(), extent, tmp.getZoom(), CAIRO_CONTENT_COLOR_ALPHA);
+    if (!renderToBuffer(mask.get())) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(this->view->drawingMutex);
+        auto& buffer = this->view->buffer;
+        if (!buffer.isInitialized() || buffer.getZoom() != tmp.getZoom()) {
+            return;
+        }
+        buffer.insertTiles(tiles, mask);
+        buffer.evictTiles(area);
+        if (this->draftQuality) {
+            this->view->hasDraftTiles = true;
+        }
+    }
+
+    repaintPageArea(extent.x / zoom, extent.y / zoom, (extent.x + extent.width) / zoom,
+                    (extent.y + extent.height) / zoom);
 }
 
 void RenderJob::run() {
+    const int64_t start = xoj::perf::isEnabled() ? xoj::perf::now() : 0;
     this->view->repaintRectMutex.lock();
 
     bool rerenderComplete = this->view->rerenderComplete;
-    auto rerenderRects = std::move(this->view->rerenderRects);
+    bool recomposeLayers = this->view->recomposeLayers;
+    auto damage = std::move(this->view->rerenderRegion);
+    Range tilesArea = this->view->tilesArea;
 
     this->view->rerenderComplete = false;
+    this->view->recomposeLayers = false;
+    this->view->rendering = true;
 
     this->view->repaintRectMutex.unlock();
 
+    render(rerenderComplete, recomposeLayers, damage.get(), tilesArea);
+
+    if (start != 0) {
+        xoj::perf::recordRenderJob(this->view, xoj::perf::now() - start);
+    }
+
+    std::lock_guard lock(this->view->repaintRectMutex);
+    this->view->rendering = false;
+}
+
+void RenderJob::render(bool rerenderComplete, bool recomposeLayers, const cairo_region_t* damage,
+                       const Range& tilesArea) {
+    // Read the generation first: if the zoom changes after that, the job will see it is outdated
+    this->zoomGeneration = view->xournal->getZoomGeneration();
+    this->zoom = view->xournal->getZoom();
+    const bool draft = view->xournal->isDraftRendering();
+
+    if (recomposeLayers && !rerenderComplete) {
+        // The visibility of a layer changed: the composed layers are rendered from the current page, damage included
+        this->draftQuality = false;
+        if (composeLayers(tilesArea)) {
+            return;
+        }
+        rerenderComplete = true;
+    }
+
     if (rerenderComplete) {
-        xoj::view::Mask newMask(view->xournal->getDpiScaleFactor(),
-                                Range(0, 0, view->page->getWidth(), view->page->getHeight()), view->xournal->getZoom(),
-                                CAIRO_CONTENT_COLOR_ALPHA);
+        this->draftQuality = draft;
+        bool firstRender = false;
+        {
+            std::lock_guard lock(this->view->drawingMutex);
+            firstRender = !this->view->buffer.isInitialized();
+        }
+        if (firstRender) {
+            renderPreview();
+        }
 
-        renderToBuffer(newMask.get());
+        const double width = view->page->getWidth();
+        const double height = view->page->getHeight();
+        xoj::view::TiledBuffer newBuffer(view->xournal->getDpiScaleFactor(), zoom, width, height);
+
+        // Pages that have not been painted yet (e.g. preloaded pages) get rendered from the top
+        auto tiles = newBuffer.getMissingTiles(tilesArea.empty() ? Range(0, 0, width, height) : tilesArea);
+        if (tiles.size() > xoj::view::TiledBuffer::DEFAULT_MAX_TILES) {
+            tiles.resize(xoj::view::TiledBuffer::DEFAULT_MAX_TILES);
+        }
+        if (!renderTiles(newBuffer, tiles) || isOutdated()) {
+            // Superseded by a zoom change: drop the stale render and start over at the new zoom
+            requeueCompleteRerender();
+            return;
+        }
         {
             std::lock_guard lock(this->view->drawingMutex);
-            std::swap(this->view->buffer, newMask);
+            std::swap(this->view->buffer, newBuffer);
+            this->view->bufferIsPreview = false;
+            this->view->hasDraftTiles = draft;
+            // The page may have changed altogether
+            this->view->layerTiles.clear();
+            this->view->invalidateLowerLayersCache();
         }
         repaintPage();
     } else {
-        for (Rectangle<double> const& rect: rerenderRects) {
-            rerenderRectangle(rect);
-            repaintPageArea(rect.x, rect.y, rect.x + rect.width, rect.y + rect.height);
+        if (damage) {
+            // The edits are always rendered in full quality: only the tiles rendered from scratch can be drafts
+            this->draftQuality = false;
+            if (!rerenderRegion(damage)) {
+                // The zoom changed: the next paint triggers a complete rerender, covering the region
+                return;
+            }
+            const int n = cairo_region_num_rectangles(damage);
+            for (int i = 0; i < n; i++) {
+                cairo_rectangle_int_t r;
+                cairo_region_get_rectangle(damage, i, &r);
+                repaintPageArea(r.x, r.y, r.x + r.width, r.y + r.height);
+            }
         }
+        this->draftQuality = draft;
+        renderMissingTiles(tilesArea);
     }
 }
 
-static void repaintWidgetArea(GtkWidget* widget, int x1, int y1, int x2, int y2) {
-    Util::execInUiThread([=]() { gtk_xournal_repaint_area(widget, x1, y1, x2, y2); });
+auto RenderJob::isOutdated() const -> bool { return view->xournal->getZoomGeneration() != this->zoomGeneration; }
+
+void RenderJob::requeueCompleteRerender() const {
+    {
+        std::lock_guard lock(this->view->repaintRectMutex);
+        this->view->rerenderComplete = true;
+    }
+    this->view->xournal->getControl()->getScheduler()->addRerenderPage(this->view);
 }
 
 void RenderJob::repaintPage() const { repaintPageArea(0, 0, view->getWidth(), view->getHeight()); }
 
 void RenderJob::repaintPageArea(double x1, double y1, double x2, double y2) const {
-    double zoom = view->xournal->getZoom();
+    double displayZoom = view->xournal->getZoom();
     int x = view->getX();
     int y = view->getY();
-    repaintWidgetArea(view->xournal->getWidget(), x + floor_cast<int>(zoom * x1), y + floor_cast<int>(zoom * y1),
-                      x + ceil_cast<int>(zoom * x2), y + ceil_cast<int>(zoom * y2));
+    view->xournal->getRepaintHandler()->repaintWidgetAreaAsync(
+            x + floor_cast<int>(displayZoom * x1), y + floor_cast<int>(displayZoom * y1),
+            x + ceil_cast<int>(displayZoom * x2), y + ceil_cast<int>(displayZoom * y2));
 }
 
-void RenderJob::renderToBuffer(cairo_t* cr) const {
-    DocumentView localView;
+void RenderJob::initDocumentView(DocumentView& localView) const {
     localView.setMarkAudioStroke(this->view->getXournal()->getControl()->getToolHandler()->getToolType() ==
                                  TOOL_PLAY_OBJECT);
     localView.setPdfCache(this->view->xournal->getCache());
+    localView.setDraftQuality(this->draftQuality);
+    localView.setCancellationCheck([this]() { return isOutdated(); });
+}
+
+bool RenderJob::renderToBuffer(cairo_t* cr, xoj::view::BackgroundFlags flags) const {
+    DocumentView localView;
+    initDocumentView(localView);
 
-    std::lock_guard<Document> lock(*this->view->xournal->getDocument());
-    localView.drawPage(this->view->page, cr, false);
+    DocumentPageReadLock lock(*this->view->xournal->getDocument(), *this->view->page);
+    localView.drawPage(this->view->page, cr, false, flags);
+    return !localView.wasCancelled();
 }
 
 auto RenderJob::getType() -> JobType { return JOB_TYPE_RENDER; }
@@ -11,16 +11,21 @@
 
 #pragma once
 
-#include <cairo.h>    // for cairo_surface_t
+#include <vector>  // for vector
+
+#include <cairo.h>    // for cairo_surface_t, cairo_region_t
 #include <gtk/gtk.h>  // for GtkWidget
 
+#include "view/TiledBuffer.h"                 // for TiledBuffer
+#include "view/background/BackgroundFlags.h"  // for BackgroundFlags, BACKGROUND_SHOW_ALL
+
 #include "Job.h"  // for Job, JobType
 
+class DocumentView;
 class XojPageView;
-namespace xoj::util {
-template <class T>
-class Rectangle;
-}  // namespace xoj::util
+namespace xoj::view {
+class Mask;
+}  // namespace xoj::view
 
 class RenderJob: public Job {
 public:
@@ -41,10 +46,82 @@ private:
 
     void repaintPageArea(double x1, double y1, double x2, double y2) const;
 
-    void rerenderRectangle(xoj::util::Rectangle<double> const& rect);
+    /**
+     * Rerender the region (in page coordinates) in a single pass over the page, clipped to the region
+     * @return false if the rendering was cancelled
+     */
+    bool rerenderRegion(const cairo_region_t* region);
+
+    enum class LowerLayersCacheUse { DONE, CANCELLED, NOT_CACHED };
+
+    /**
+     * Render the area to the mask by painting the view's cache of the layers below the selected one, and drawing the
+     * other layers on top. The missing cached tiles get rendered first.
+     * @return NOT_CACHED if the cache cannot be used (the area must then be rendered normally)
+     */
+    LowerLayersCacheUse renderWithLowerLayersCache(xoj::view::Mask& mask, const Range& area);
+
+    /**
+     * Replace the view's buffer by the composition of the background and of the visible layers, taken from the view's
+     * per layer tiles (see XojPageView::layerTiles). Only the missing or outdated ones are rendered.
+     * @return false if the page must be rendered completely instead
+     */
+    bool composeLayers(const Range& tilesArea);
+
+    /**
+     * Render the damaged region or the whole page, as taken from the view
+     */
+    void render(bool rerenderComplete, bool recomposeLayers, const cairo_region_t* damage, const Range& tilesArea);
+
+    /**
+     * Render the given tiles of the buffer (in a single pass over the page)
+     * @return false if the rendering was cancelled
+     */
+    bool renderTiles(xoj::view::TiledBuffer& buffer, const std::vector<xoj::view::TiledBuffer::TileIndex>& tiles,
+                     xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL) const;
 
-    void renderToBuffer(cairo_t* cr) const;
+    /**
+     * First pass for a page which has never been rendered: quickly render the whole page at a low resolution (with
+     * the PDF background taken from the PdfCache, if available) and display it until the full render is ready.
+     */
+    void renderPreview();
+
+    /**
+     * Render the tiles of the view's buffer intersecting the area which are still missing
+     */
+    void renderMissingTiles(const Range& area);
+
+    /**
+     * @return false if the rendering was cancelled because the zoom changed in the meantime
+     */
+    bool renderToBuffer(cairo_t* cr, xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL) const;
+
+    /**
+     * Set up a DocumentView the way render jobs draw the page
+     */
+    void initDocumentView(DocumentView& localView) const;
+
+    /**
+     * @return true if the zoom changed since the job started: whatever it renders is stale
+     */
+    bool isOutdated() const;
+
+    /**
+     * Queue a complete rerender of the page, to replace a cancelled one
+     */
+    void requeueCompleteRerender() const;
 
 private:
     XojPageView* view;
+
+    /**
+     * The zoom the job renders at, and the zoom generation (see XournalView::getZoomGeneration()) it was read in.
+     */
+    double zoom = 1.0;
+    unsigned int zoomGeneration = 0;
+
+    /**
+     * Render in draft quality (see DocumentView::setDraftQuality()), while the view is scrolled
+     */
+    bool draftQuality = false;
 };
@@ -1,22 +1,32 @@
 #include "SaveJob.h"
 
-#include <memory>  // for __shared_ptr_access
+#include <cstdint>  // for uint64_t
+#include <memory>   // for __shared_ptr_access
+#include <string>   // for string
+#include <utility>  // for move
 
 #include <cairo.h>  // for cairo_create, cairo_destroy
 #include <glib.h>   // for g_warning, g_error
 
-#include "control/Control.h"              // for Control
-#include "control/jobs/BlockingJob.h"     // for BlockingJob
-#include "control/xojfile/SaveHandler.h"  // for SaveHandler
-#include "model/Document.h"               // for Document
-#include "model/PageRef.h"                // for PageRef
-#include "model/PageType.h"               // for PageType
-#include "model/XojPage.h"                // for XojPage
-#include "pdf/base/XojPdfPage.h"          // for XojPdfPageSPtr, XojPdfPage
-#include "util/PathUtil.h"                // for clearExtensions, safeRename...
-#include "util/XojMsgBox.h"               // for XojMsgBox
-#include "util/i18n.h"                    // for FS, _, _F
-#include "view/DocumentView.h"            // for DocumentView
+#include "control/Control.h"                  // for Control
+#include "control/ThumbnailCache.h"           // for ThumbnailCache
+#include "control/jobs/BlockingJob.h"         // for BlockingJob
+#include "control/settings/Settings.h"        // for Settings
+#include "control/xojfile/RecoveryJournal.h"  // for RecoveryJournal
+#include "control/xojfile/SaveHandler.h"      // for SaveHandler
+#include "model/Document.h"                   // for Document
+#include "model/DocumentHandler.h"            // for DocumentHandler
+#include "model/ImageBuffer.h"                // for ImageBuffer
+#include "model/PageRef.h"                    // for PageRef
+#include "model/PageType.h"                   // for PageType
+#include "model/XojPage.h"                    // for XojPage
+#include "pdf/base/XojPdfPage.h"              // for XojPdfPageSPtr, XojPdfPage
+#include "undo/UndoRedoHandler.h"             // for UndoRedoHandler
+#include "util/PathUtil.h"                    // for clearExtensions, safeRename...
+#include "util/XojMsgBox.h"                   // for XojMsgBox
+#include "util/i18n.h"                        // for FS, _, _F
+#include "util/raii/CairoWrappers.h"          // for CairoSurfaceSPtr
+#include "view/DocumentView.h"                // for DocumentView
 
 #include "filesystem.h"  // for path, filesystem_error, remove
 
@@ -39,7 +49,8 @@ void SaveJob::afterRun() {
         XojMsgBox::showErrorToUser(control->getGtkWindow(), this->lastError);
         callback(false);
     } else {
-        this->control->resetSavedStatus();
+        this->control->startRecoveryJournal(this->savedFile, std::move(this->savedPages));
+        this->control->resetSavedStatus(this->lastSavedAction);
         callback(true);
     }
 }
@@ -54,6 +65,13 @@ void SaveJob::updatePreview(Control* control) {
     if (doc->getPageCount() > 0) {
         PageRef page = doc->getPage(0);
 
+        // Only render the preview again if the first page changed since the last save
+        const uint64_t contentHash = ThumbnailCache::hashPage(*page, doc->getPdfFilepath());
+        if (doc->getPreview() && doc->getPreviewHash() == contentHash) {
+            doc->unlock();
+            return;
+        }
+
         double width = page->getWidth();
         double height = page->getHeight();
 
@@ -67,10 +85,11 @@ void SaveJob::updatePreview(Control* control) {
         width *= zoom;
         height *= zoom;
 
-        cairo_surface_t* crBuffer =
-                cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil_cast<int>(width), ceil_cast<int>(height));
+        xoj::util::CairoSurfaceSPtr crBuffer(
+                cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil_cast<int>(width), ceil_cast<int>(height)),
+                xoj::util::adopt);
 
-        cairo_t* cr = cairo_create(crBuffer);
+        cairo_t* cr = cairo_create(crBuffer.get());
         cairo_scale(cr, zoom, zoom);
 
         xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL;
@@ -91,8 +110,19 @@ void SaveJob::updatePreview(Control* control) {
         DocumentView view;
         view.drawPage(page, cr, true /* don't render erasable */, flags);
         cairo_destroy(cr);
-        doc->setPreview(crBuffer);
-        cairo_surface_destroy(crBuffer);
+
+        // Encoded once, and not at each save
+        std::string png;
+        const cairo_write_func_t writeFunc = [](void* closure, const unsigned char* data,
+                                                unsigned int length) -> cairo_status_t {
+            static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+            return CAIRO_STATUS_SUCCESS;
+        };
+        if (cairo_surface_write_to_png_stream(crBuffer.get(), writeFunc, &png) == CAIRO_STATUS_SUCCESS) {
+            doc->setPreview(ImageBuffer::get(std::move(png)), contentHash);
+        } else {
+            doc->setPreview(nullptr);
+        }
     } else {
         doc->setPreview(nullptr);
     }
@@ -104,12 +134,26 @@ auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
     SaveHandler h;
+    h.setBinaryPointEncoding(control->getSettings()->isBinaryStrokeEncoding());
 
+    // The document is copied, so that it is not locked while it is written
+    DocumentHandler snapshotHandler;
     doc->lock();
-    h.prepareSave(doc);
     fs::path filepath = doc->getFilepath();
+    // The lazily loaded pages are read from the file which is about to be overwritten
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        doc->getPage(i)->detachContentLoader();
+    }
+    auto snapshot = doc->createSnapshot(&snapshotHandler);
+    this->lastSavedAction = control->getUndoRedoHandler()->getLastAction();
+    this->savedPages = RecoveryJournal::captureBaseline(doc);
     doc->unlock();
 
+    // The journal applies to the file about to be overwritten: the crash handler saves the document until it restarts
+    control->getRecoveryJournal()->stop();
+
+    // The archive saved before, whose unchanged attachments are copied
+    fs::path previousArchive = filepath;
     Util::clearExtensions(filepath, ".pdf");
     auto const target = fs::path{filepath}.concat(".xopp");
     auto const createBackup = doc->shouldCreateBackupOnSave();
@@ -119,6 +163,9 @@ auto SaveJob::save() -> bool {
             // Note: The backup must be created for the target as this is the filepath
             // which will be written to. Do not use the `filepath` variable!
             Util::safeRenameFile(target, fs::path{target} += "~");
+            if (previousArchive == target) {
+                previousArchive += "~";
+            }
         } catch (const fs::filesystem_error& fe) {
             g_warning("Could not create backup! Failed with %s", fe.what());
             this->lastError = FS(_F("Save file error, can't backup: {1}") % std::string(fe.what()));
@@ -129,8 +176,10 @@ auto SaveJob::save() -> bool {
         }
     }
 
+    this->savedFile = target;
+    h.setPreviousArchive(std::move(previousArchive));
+    h.saveDocument(snapshot.get(), target, this->control);
     doc->lock();
-    h.saveTo(target, this->control);
     doc->setFilepath(target);
     doc->unlock();
 
@@ -14,9 +14,13 @@
 #include <functional>
 #include <string>  // for string
 
+#include "control/xojfile/RecoveryJournal.h"  // for RecoveryJournal
+
 #include "BlockingJob.h"  // for BlockingJob
+#include "filesystem.h"   // for path
 
 class Control;
+class UndoAction;
 
 
 class SaveJob: public BlockingJob {
@@ -39,6 +43,11 @@ protected:
 
 private:
     std::string lastError;
+    /// The last undo action when the saved copy of the document was made
+    UndoAction* lastSavedAction = nullptr;
+    /// The pages when the saved copy was made, and the file written, to restart the recovery journal
+    RecoveryJournal::Baseline savedPages;
+    fs::path savedFile;
     /// Called after saving, with boolean parameter true on success, false on failure (error)
     std::function<void(bool)> callback;
 };
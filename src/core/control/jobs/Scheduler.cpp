@@ -1,11 +1,15 @@
 #include "Scheduler.h"
 
+#include <algorithm>  // for any_of, clamp
 #include <cinttypes>  // for PRId64
 #include <cstdint>    // for uint64_t
+#include <utility>    // for move
 
-#include "control/jobs/Job.h"  // for Job, JOB_TYPE_RENDER
-#include "util/Assert.h"       // for xoj_assert
-#include "util/glib_casts.h"   // for wrap_for_once_v
+#include "control/PerfStats.h"      // for isEnabled, now, recordJobWait
+#include "control/jobs/Job.h"       // for Job, JOB_TYPE_RENDER
+#include "control/jobs/JobTrace.h"  // for JobEvent, isEnabled, recordJob
+#include "util/Assert.h"            // for xoj_assert
+#include "util/glib_casts.h"        // for wrap_for_once_v
 
 #include "config-debug.h"  // for DEBUG_SHEDULER
 
@@ -36,18 +40,76 @@ Scheduler::~Scheduler() {
     stop();
 
     Job* job = nullptr;
-    while ((job = getNextJobUnlocked()) != nullptr) { job->unref(); }
+    while ((job = getNextJobUnlocked(nullptr)) != nullptr) { job->unref(); }
 
     if (this->blockRenderZoomTime) {
         g_free(this->blockRenderZoomTime);
     }
 }
 
+thread_local Scheduler::Worker* Scheduler::currentWorker = nullptr;
+
+/// Upper bound for the automatic number of render workers
+constexpr unsigned int MAX_AUTO_RENDER_WORKERS = 8;
+
+void Scheduler::setRenderWorkerCount(unsigned int count) {
+    g_return_if_fail(this->workers.empty());
+    this->renderWorkerCount = count;
+}
+
+auto Scheduler::getRenderWorkerCount() const -> unsigned int {
+    if (this->renderWorkerCount != 0) {
+        return this->renderWorkerCount;
+    }
+    // Leave one processor for the UI thread
+    unsigned int processors = g_get_num_processors();
+    return std::clamp(processors > 1 ? processors - 1 : 1U, 1U, MAX_AUTO_RENDER_WORKERS);
+}
+
+void Scheduler::setParallelismLimit(JobPriority priority, unsigned int count) {
+    std::lock_guard lock{this->jobQueueMutex};
+    this->parallelismLimits[priority] = count;
+}
+
+auto Scheduler::getParallelismLimit(JobPriority priority) const -> unsigned int {
+    if (this->parallelismLimits[priority] != 0) {
+        return this->parallelismLimits[priority];
+    }
+    const unsigned int workers = getRenderWorkerCount();
+    switch (priority) {
+        case JOB_PRIORITY_LOW:
+            // Keep a worker for the pages coming into view while prefetching
+            return std::max(1U, workers - 1);
+        case JOB_PRIORITY_NONE:
+            return 1;
+        default:
+            return workers;
+    }
+}
+
 void Scheduler::start() {
     SDEBUG("Starting scheduler");
-    g_return_if_fail(this->thread == nullptr);
+    g_return_if_fail(this->workers.empty());
+
+    auto addWorker = [this](bool renderLane, std::string workerName) {
+        auto& worker = this->workers.emplace_back(std::make_unique<Worker>());
+        worker->scheduler = this;
+        worker->renderLane = renderLane;
+        worker->name = std::move(workerName);
+        if (xoj::trace::isEnabled()) {
+            worker->traceThread = xoj::trace::registerThread(worker->name);
+        }
+    };
 
-    this->thread = g_thread_new(name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), this);
+    addWorker(false, name);
+    unsigned int renderWorkers = getRenderWorkerCount();
+    for (unsigned int i = 0; i < renderWorkers; i++) { addWorker(true, name + " render " + std::to_string(i)); }
+
+    // Only start the threads once the vector is complete: the workers read it in isSourceRunningUnlocked()
+    for (auto& worker: this->workers) {
+        worker->thread =
+                g_thread_new(worker->name.c_str(), reinterpret_cast<GThreadFunc>(jobThreadCallback), worker.get());
+    }
 }
 
 void Scheduler::stop() {
@@ -56,11 +118,22 @@ void Scheduler::stop() {
     if (!this->threadRunning) {
         return;
     }
-    this->threadRunning = false;
+    {
+        // Taking the lock makes sure no worker is between checking threadRunning and waiting
+        std::lock_guard lock{this->jobQueueMutex};
+        this->threadRunning = false;
+    }
     this->jobQueueCond.notify_all();
 
-    if (this->thread) {
-        g_thread_join(this->thread);
+    for (auto& worker: this->workers) {
+        if (worker->thread) {
+            g_thread_join(worker->thread);
+            worker->thread = nullptr;
+        }
+    }
+
+    if (xoj::trace::isEnabled()) {
+        xoj::trace::write(xoj::trace::traceFile);
     }
 }
 
@@ -71,37 +144,129 @@ void Scheduler::addJob(Job* job, JobPriority priority) {
         std::lock_guard lock{this->jobQueueMutex};
 
         job->ref();
+        job->queuedTime = xoj::perf::isEnabled() || xoj::trace::isEnabled() ? xoj::perf::now() : 0;
+        job->queuedPriority = priority;
         this->jobQueue[priority]->push_back(job);
+        this->queuedJobs.emplace(QueueKey{job->getSource(), job->getType(), priority}, job);
     }
 
     SDEBUG("add job: %" PRId64 "; type: %" PRId64, (uint64_t)job, (uint64_t)job->getType());
     this->jobQueueCond.notify_all();
 }
 
-auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> Job* {
-    Job* job = nullptr;
-
+auto Scheduler::getQueueDepths() -> std::array<size_t, JOB_N_PRIORITIES> {
+    std::array<size_t, JOB_N_PRIORITIES> depths{};
+    std::lock_guard lock{this->jobQueueMutex};
     for (size_t i = JOB_PRIORITY_URGENT; i < JOB_N_PRIORITIES; i++) {
+        depths[i] = this->jobQueue[i]->size() - this->cancelledJobs[i];
+    }
+    return depths;
+}
+
+auto Scheduler::hasQueuedJobUnlocked(void* source, JobType type, JobPriority priority) const -> bool {
+    return this->queuedJobs.count(QueueKey{source, type, priority}) != 0;
+}
+
+void Scheduler::cancelQueuedJobsUnlocked(void* source, JobType type, JobPriority priority) {
+    auto [begin, end] = this->queuedJobs.equal_range(QueueKey{source, type, priority});
+    for (auto it = begin; it != end; ++it) {
+        Job* job = it->second;
+        job->cancelled = true;
+        this->cancelledJobs[priority]++;
+        job->deleteJob();
+    }
+    this->queuedJobs.erase(begin, end);
+}
+
+void Scheduler::cancelQueuedJobUnlocked(Job* job) {
+    if (job->cancelled) {
+        return;
+    }
+    unindexJobUnlocked(job);
+    job->cancelled = true;
+    this->cancelledJobs[job->queuedPriority]++;
+    job->deleteJob();
+}
+
+void Scheduler::unindexJobUnlocked(Job* job) {
+    const auto priority = static_cast<JobPriority>(job->queuedPriority);
+    auto [begin, end] = this->queuedJobs.equal_range(QueueKey{job->getSource(), job->getType(), priority});
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == job) {
+            this->queuedJobs.erase(it);
+            return;
+        }
+    }
+}
+
+static auto isRenderLaneJob(Job* job) -> bool {
+    JobType type = job->getType();
+    return type == JOB_TYPE_RENDER || type == JOB_TYPE_PREVIEW;
+}
+
+auto Scheduler::isSourceRunningUnlocked(void* source, const Worker* except) const -> bool {
+    return std::any_of(this->workers.begin(), this->workers.end(), [&](const auto& w) {
+        return w.get() != except && w->runningSource == source;
+    });
+}
+
+auto Scheduler::getNextJobUnlocked(Worker* worker, bool onlyNotRender, bool* hasRenderJobs, size_t endPriority)
+        -> Job* {
+    for (size_t i = JOB_PRIORITY_URGENT; i < endPriority; i++) {
         std::deque<Job*>& queue = *this->jobQueue[i];
+        const auto priority = static_cast<JobPriority>(i);
 
-        if (onlyNotRender) {
-            for (auto it = queue.begin(); it != queue.end(); ++it) {
+        if (worker != nullptr && worker->renderLane && this->runningRenderJobs[i] >= getParallelismLimit(priority)) {
+            continue;
+        }
+
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            Job* job = *it;
+            xoj_assert(job != nullptr);
+
+            if (job->cancelled) {
+                // Cancelled: release it, along with the cancelled jobs right behind it
+                while (it != queue.end() && (*it)->cancelled) {
+                    (*it)->unref();
+                    it = queue.erase(it);
+                    this->cancelledJobs[i]--;
+                }
+                if (it == queue.end()) {
+                    break;
+                }
                 job = *it;
+            }
 
-                if (job->getType() != JOB_TYPE_RENDER) {
-                    queue.erase(it);
-                    return job;
+            if (worker != nullptr) {
+                if (isRenderLaneJob(job) != worker->renderLane) {
+                    continue;
                 }
 
-                if (hasRenderJobs != nullptr) {
-                    *hasRenderJobs = true;
+                if (onlyNotRender && job->getType() == JOB_TYPE_RENDER) {
+                    if (hasRenderJobs != nullptr) {
+                        *hasRenderJobs = true;
+                    }
+                    continue;
+                }
+
+                // Never run two jobs of the same source concurrently: they would race on the source's buffer
+                if (worker->renderLane && isSourceRunningUnlocked(job->getSource(), worker)) {
+                    continue;
                 }
             }
-        } else if (!queue.empty()) {
-            job = queue.front();
-            queue.pop_front();
-            xoj_assert(job != nullptr);
 
+            queue.erase(it);
+            unindexJobUnlocked(job);
+            if (job->queuedTime != 0 && xoj::perf::isEnabled()) {
+                xoj::perf::recordJobWait(priority, xoj::perf::now() - job->queuedTime);
+            }
+            if (worker != nullptr) {
+                worker->runningSource = job->getSource();
+                worker->runningPriority = priority;
+                if (worker->renderLane) {
+                    this->runningRenderJobs[i]++;
+                }
+            }
             return job;
         }
     }
@@ -112,12 +277,20 @@ auto Scheduler::getNextJobUnlocked(bool onlyNotRender, bool* hasRenderJobs) -> J
 /**
  * Locks the complete scheduler
  */
-void Scheduler::lock() { this->schedulerMutex.lock(); }
+void Scheduler::lock() {
+    for (auto& worker: this->workers) { worker->schedulerMutex.lock(); }
+}
 
 /**
  * Unlocks the complete scheduler
  */
-void Scheduler::unlock() { this->schedulerMutex.unlock(); }
+void Scheduler::unlock() {
+    for (auto it = this->workers.rbegin(); it != this->workers.rend(); ++it) { (*it)->schedulerMutex.unlock(); }
+}
+
+void Scheduler::waitForRunningJobs() {
+    for (auto& worker: this->workers) { std::lock_guard lock{worker->jobRunningMutex}; }
+}
 
 #define ZOOM_WAIT_US_TIMEOUT 300000  // 0.3s
 
@@ -170,10 +343,9 @@ auto g_time_val_diff(GTimeVal* t1, GTimeVal* t2) -> glong {
  * we need to wakeup it later
  */
 auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
-    scheduler->jobRenderThreadTimerId = 0;
-
     {
         std::lock_guard lock{scheduler->blockRenderMutex};
+        scheduler->jobRenderThreadTimerId = 0;
         g_free(scheduler->blockRenderZoomTime);
         scheduler->blockRenderZoomTime = nullptr;
     }
@@ -183,40 +355,112 @@ auto Scheduler::jobRenderThreadTimer(Scheduler* scheduler) -> bool {
     return false;
 }
 
-auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
+void Scheduler::runJob(Worker* worker, Job* job) {
+    SDEBUG("do job: %" PRId64, (uint64_t)job);
+    if (job->queuedTime != 0 && xoj::trace::isEnabled()) {
+        xoj::trace::JobEvent event{job->getType(),
+                                   static_cast<JobPriority>(job->queuedPriority),
+                                   job->getSource(),
+                                   job->queuedTime,
+                                   xoj::perf::now(),
+                                   0,
+                                   worker->traceThread};
+        job->execute();
+        event.end = xoj::perf::now();
+        xoj::trace::recordJob(event);
+    } else {
+        job->execute();
+    }
+    job->unref();
+
+    if (worker->renderLane) {
+        std::lock_guard jobLock{worker->scheduler->jobQueueMutex};
+        worker->scheduler->runningRenderJobs[worker->runningPriority]--;
+    }
+}
+
+void Scheduler::yieldToUrgentJobs() {
+    Worker* worker = currentWorker;
+    if (worker == nullptr) {
+        return;
+    }
+    Scheduler* scheduler = worker->scheduler;
+
+    std::unique_lock jobLock{scheduler->jobQueueMutex};
+    void* const source = worker->runningSource;
+    const JobPriority priority = worker->runningPriority;
+    if (worker->renderLane) {
+        // The limits are not meant for the job which yields: count it out while the others run
+        scheduler->runningRenderJobs[priority]--;
+    }
+
+    while (scheduler->threadRunning) {
+        Job* job = scheduler->getNextJobUnlocked(worker, false, nullptr, priority);
+        if (job == nullptr) {
+            break;
+        }
+        jobLock.unlock();
+        SDEBUG("yield to job: %" PRId64, (uint64_t)job);
+        runJob(worker, job);
+        jobLock.lock();
+    }
+
+    worker->runningSource = source;
+    worker->runningPriority = priority;
+    if (worker->renderLane) {
+        scheduler->runningRenderJobs[priority]++;
+        jobLock.unlock();
+        scheduler->jobQueueCond.notify_all();
+    }
+}
+
+auto Scheduler::jobThreadCallback(Worker* worker) -> gpointer {
+    Scheduler* scheduler = worker->scheduler;
+    currentWorker = worker;
+
     while (scheduler->threadRunning) {
         // lock the whole scheduler
-        std::unique_lock schedulerLock{scheduler->schedulerMutex};
+        std::unique_lock schedulerLock{worker->schedulerMutex};
         SDEBUG("Job Thread: Blocked scheduler.");
 
         bool onlyNonRenderJobs = false;
         glong diff = 1000;
-        if (scheduler->blockRenderZoomTime) {
+        if (worker->renderLane) {
             std::lock_guard lock{scheduler->blockRenderMutex};
-            SDEBUG("Zoom re-render blocking.");
-
-            GTimeVal time;
-            g_get_current_time(&time);
-
-            diff = g_time_val_diff(scheduler->blockRenderZoomTime, &time);
-            if (diff <= 0) {
-                g_free(scheduler->blockRenderZoomTime);
-                scheduler->blockRenderZoomTime = nullptr;
-                SDEBUG("Ended zoom re-render blocking.");
-            } else {
-                onlyNonRenderJobs = true;
-                SDEBUG("Rendering blocked: Only running non-rendering jobs.");
+            if (scheduler->blockRenderZoomTime) {
+                SDEBUG("Zoom re-render blocking.");
+
+                GTimeVal time;
+                g_get_current_time(&time);
+
+                diff = g_time_val_diff(scheduler->blockRenderZoomTime, &time);
+                if (diff <= 0) {
+                    g_free(scheduler->blockRenderZoomTime);
+                    scheduler->blockRenderZoomTime = nullptr;
+                    SDEBUG("Ended zoom re-render blocking.");
+                } else {
+                    onlyNonRenderJobs = true;
+                    SDEBUG("Rendering blocked: Only running non-rendering jobs.");
+                }
             }
         }
 
         Job* job;
 
+        // Taken before fetching the job, so that waitForRunningJobs() cannot slip in between fetching and running it
+        std::unique_lock runningLock{worker->jobRunningMutex};
+
         {
             std::unique_lock jobLock{scheduler->jobQueueMutex};
             SDEBUG("Job Thread: Locked job queue.");
 
+            if (!scheduler->threadRunning) {
+                break;
+            }
+
             bool hasOnlyRenderJobs = false;
-            job = scheduler->getNextJobUnlocked(onlyNonRenderJobs, &hasOnlyRenderJobs);
+            job = worker->renderLane ? scheduler->getNextJobUnlocked(worker, onlyNonRenderJobs, &hasOnlyRenderJobs) :
+                                       scheduler->getNextJobUnlocked(worker);
             if (job != nullptr) {
                 hasOnlyRenderJobs = false;
             }
@@ -225,9 +469,11 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
 
             if (job == nullptr) {
                 // unlock the whole scheduler
+                runningLock.unlock();
                 schedulerLock.unlock();
 
                 if (hasOnlyRenderJobs) {
+                    std::lock_guard lock{scheduler->blockRenderMutex};
                     if (scheduler->jobRenderThreadTimerId) {
                         g_source_remove(scheduler->jobRenderThreadTimerId);
                     }
@@ -238,14 +484,20 @@ auto Scheduler::jobThreadCallback(Scheduler* scheduler) -> gpointer {
                 scheduler->jobQueueCond.wait(jobLock);
                 continue;
             }
+
         }
 
-        // Run the job.
+        runJob(worker, job);
+
         {
-            std::lock_guard lock{scheduler->jobRunningMutex};
-            SDEBUG("do job: %" PRId64, (uint64_t)job);
-            job->execute();
-            job->unref();
+            std::lock_guard jobLock{scheduler->jobQueueMutex};
+            worker->runningSource = nullptr;
+        }
+        runningLock.unlock();
+
+        // Jobs of the same source may have been skipped by other workers in the meantime
+        if (worker->renderLane) {
+            scheduler->jobQueueCond.notify_all();
         }
 
         SDEBUG("next");
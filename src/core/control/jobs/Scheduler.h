@@ -14,14 +14,21 @@
 #pragma once
 
 #include <array>               // for array
+#include <atomic>              // for atomic
 #include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uintptr_t
 #include <deque>               // for deque
+#include <functional>          // for hash
+#include <memory>              // for unique_ptr
 #include <mutex>               // for mutex
 #include <string>              // for string
+#include <unordered_map>       // for unordered_multimap
+#include <vector>              // for vector
 
 #include <glib.h>  // for GThread, GTimeVal, gpointer
 
-class Job;
+#include "Job.h"  // for Job, JobType
 
 /**
  * @file Scheduler.h
@@ -63,12 +70,46 @@ enum JobPriority {
 };
 
 
+/**
+ * The Scheduler runs its jobs on a pool of worker threads:
+ *  - several render workers, which process RenderJob%s and PreviewJob%s in parallel. Two jobs with the same source
+ *    (e.g. the same XojPageView) are never run at the same time. The number of render workers running jobs of each
+ *    priority can be limited (see setParallelismLimit()), so that some workers are always left for the urgent jobs.
+ *  - one serial worker, which processes every other job (saving, autosaving, exporting, blocking jobs...) one after
+ *    the other, in the order given by the priority queues. The long jobs give way to the more urgent ones by calling
+ *    yieldToUrgentJobs().
+ */
 class Scheduler {
 public:
     Scheduler();
     virtual ~Scheduler();
 
 public:
+    /**
+     * Set the number of render workers. Must be called before start().
+     *
+     * @param count The number of render workers. 0 means automatic (depending on the number of processors)
+     */
+    void setRenderWorkerCount(unsigned int count);
+
+    /**
+     * @return The number of render workers used when the scheduler is started
+     */
+    unsigned int getRenderWorkerCount() const;
+
+    /**
+     * Set the maximum number of render workers running jobs of the given priority at the same time.
+     *
+     * @param count The limit. 0 means the default: all the workers for the urgent and high priorities, all but one for
+     *              the low priority (prefetching) and one for the other jobs (e.g. indexing the PDF text).
+     */
+    void setParallelismLimit(JobPriority priority, unsigned int count);
+
+    /**
+     * @return The maximum number of render workers running jobs of the given priority at the same time
+     */
+    unsigned int getParallelismLimit(JobPriority priority) const;
+
     /**
      * Adds a Job to the Scheduler
      *
@@ -79,6 +120,18 @@ public:
      */
     void addJob(Job* job, JobPriority priority);
 
+    /**
+     * @return The number of jobs waiting in the queue of each priority
+     */
+    std::array<size_t, JOB_N_PRIORITIES> getQueueDepths();
+
+    /**
+     * Run the queued jobs of higher priority than the current job, on the current worker, before returning.
+     * Called by the long jobs (e.g. exports) at safe points, typically between two pages: the document must not be
+     * locked. Does nothing if not called from a job.
+     */
+    static void yieldToUrgentJobs();
+
     void start();
     void stop();
 
@@ -103,27 +156,105 @@ public:
     void unblockRerenderZoom();
 
 private:
-    static auto jobThreadCallback(Scheduler* scheduler) -> gpointer;
-    auto getNextJobUnlocked(bool onlyNotRender = false, bool* hasRenderJobs = nullptr) -> Job*;
+    struct Worker {
+        Scheduler* scheduler;
+
+        /**
+         * true if the worker runs RenderJob%s and PreviewJob%s, false if it runs all the other jobs
+         */
+        bool renderLane;
+
+        std::string name;
+        GThread* thread = nullptr;
+
+        /// The id of the worker in the job trace, if enabled
+        int traceThread = -1;
+
+        /**
+         * Held while the worker fetches and runs a job. Scheduler::lock() locks it for every worker.
+         */
+        std::mutex schedulerMutex{};
+
+        /**
+         * Held while the worker runs a job.
+         * This is need to be sure there is no job running if we delete a page.
+         * If a job is, we may access deleted memory.
+         */
+        std::mutex jobRunningMutex{};
+
+        /**
+         * The source of the job being run, or nullptr. Guarded by jobQueueMutex.
+         */
+        void* runningSource = nullptr;
+
+        /**
+         * The priority of the job being run. Guarded by jobQueueMutex.
+         */
+        JobPriority runningPriority = JOB_PRIORITY_NONE;
+    };
+
+    static auto jobThreadCallback(Worker* worker) -> gpointer;
+
+    /**
+     * Run a job fetched by getNextJobUnlocked() on the worker, and release it
+     */
+    static void runJob(Worker* worker, Job* job);
+
+    /**
+     * Fetch the next job for the given worker (and remove it from its queue), among the priorities up to (excluding)
+     * endPriority. If worker is nullptr, any job is returned.
+     * The caller must hold jobQueueMutex.
+     */
+    auto getNextJobUnlocked(Worker* worker, bool onlyNotRender = false, bool* hasRenderJobs = nullptr,
+                            size_t endPriority = JOB_N_PRIORITIES) -> Job*;
+
+    /**
+     * @return true if a job with the given source is currently run by a worker (other than `except`).
+     * The caller must hold jobQueueMutex.
+     */
+    bool isSourceRunningUnlocked(void* source, const Worker* except) const;
+
+    /**
+     * Remove a job taken out of its queue from queuedJobs. The caller must hold jobQueueMutex.
+     */
+    void unindexJobUnlocked(Job* job);
 
     static auto jobRenderThreadTimer(Scheduler* scheduler) -> bool;
 
 protected:
-    bool threadRunning = true;
+    std::atomic<bool> threadRunning = true;
 
     guint jobRenderThreadTimerId = 0;
 
-    GThread* thread = nullptr;
+    unsigned int renderWorkerCount = 0;
+
+    std::vector<std::unique_ptr<Worker>> workers;
 
     std::condition_variable jobQueueCond{};
     std::mutex jobQueueMutex{};
-    std::mutex schedulerMutex{};
 
     /**
-     * This is need to be sure there is no job running if we delete a page.
-     * If a job is, we may access deleted memory.
+     * Blocks until every currently running job has been executed
+     */
+    void waitForRunningJobs();
+
+    /**
+     * @return true if a job of the source and type is queued with the given priority. Constant time.
+     * The caller must hold jobQueueMutex.
+     */
+    bool hasQueuedJobUnlocked(void* source, JobType type, JobPriority priority) const;
+
+    /**
+     * Remove the queued jobs of the source and type with the given priority, calling their Job::deleteJob().
+     * Constant time: the jobs are only marked as cancelled, and released once they reach the front of their queue.
+     * The caller must hold jobQueueMutex.
+     */
+    void cancelQueuedJobsUnlocked(void* source, JobType type, JobPriority priority);
+
+    /**
+     * Remove a queued job: see cancelQueuedJobsUnlocked(). The caller must hold jobQueueMutex.
      */
-    std::mutex jobRunningMutex{};
+    void cancelQueuedJobUnlocked(Job* job);
 
     /**
      * Jobs of each priority. New jobs
@@ -141,6 +272,42 @@ protected:
      */
     std::array<std::deque<Job*>*, JOB_N_PRIORITIES> jobQueue{};
 
+    struct QueueKey {
+        void* source;
+        JobType type;
+        JobPriority priority;
+
+        bool operator==(const QueueKey& other) const {
+            return source == other.source && type == other.type && priority == other.priority;
+        }
+    };
+    struct QueueKeyHash {
+        size_t operator()(const QueueKey& k) const {
+            return std::hash<uintptr_t>()(reinterpret_cast<uintptr_t>(k.source)) ^
+                   (static_cast<size_t>(k.type) << 3 | static_cast<size_t>(k.priority));
+        }
+    };
+
+    /**
+     * The jobs of the queues which are not cancelled, by (source, type, priority)
+     */
+    std::unordered_multimap<QueueKey, Job*, QueueKeyHash> queuedJobs;
+
+    /**
+     * The number of cancelled jobs still in the queue of each priority
+     */
+    std::array<size_t, JOB_N_PRIORITIES> cancelledJobs{};
+
+    /**
+     * Limits set by setParallelismLimit() (0 for the default), and number of render workers running jobs of each
+     * priority. Guarded by jobQueueMutex.
+     */
+    std::array<unsigned int, JOB_N_PRIORITIES> parallelismLimits{};
+    std::array<unsigned int, JOB_N_PRIORITIES> runningRenderJobs{};
+
+    /// The worker of the current thread, if it is one
+    static thread_local Worker* currentWorker;
+
     GTimeVal* blockRenderZoomTime = nullptr;
     std::mutex blockRenderMutex{};
 
@@ -0,0 +1,88 @@
+#include "SearchJob.h"
+
+#include <algorithm>  // for min
+#include <utility>    // for move
+
+#include "control/SearchControl.h"   // for SearchControl
+#include "control/jobs/Scheduler.h"  // for Scheduler, JOB_PRIORITY_HIGH
+#include "model/Document.h"          // for Document
+#include "model/PdfTextIndex.h"      // for PdfTextIndex
+#include "model/XojPage.h"           // for XojPage
+#include "util/Util.h"               // for execInUiThread, npos
+
+SearchJob::SearchJob(Document* doc, std::string text, std::vector<size_t> pages, CancelToken cancelled,
+                     Callback callback):
+        doc(doc),
+        text(std::move(text)),
+        pages(std::move(pages)),
+        cancelled(std::move(cancelled)),
+        callback(std::move(callback)) {}
+
+auto SearchJob::searchDocument(Document* doc, Scheduler* scheduler, const std::string& text, size_t first,
+                               Callback callback) -> CancelToken {
+    auto cancelled = std::make_shared<std::atomic_bool>(false);
+
+    doc->lock();
+    const size_t pageCount = doc->getPageCount();
+    doc->unlock();
+
+    // The pages from the first one on, wrapping around: the matches near the first page are found first
+    std::vector<size_t> pages(pageCount);
+    for (size_t i = 0; i < pageCount; i++) {
+        pages[i] = (first + i) % pageCount;
+    }
+
+    for (size_t i = 0; i < pages.size(); i += PAGES_PER_JOB) {
+        const auto begin = pages.begin() + static_cast<std::ptrdiff_t>(i);
+        const auto end = pages.begin() + static_cast<std::ptrdiff_t>(std::min(i + PAGES_PER_JOB, pages.size()));
+        auto* job = new SearchJob(doc, text, {begin, end}, cancelled, callback);
+        scheduler->addJob(job, JOB_PRIORITY_HIGH);
+        job->unref();
+    }
+    return cancelled;
+}
+
+auto SearchJob::getType() -> JobType { return JOB_TYPE_RENDER; }
+
+auto SearchJob::getSource() -> void* { return this; }
+
+void SearchJob::run() {
+    for (size_t pageNr: this->pages) {
+        if (*this->cancelled) {
+            return;
+        }
+
+        doc->lock();
+        PageRef page = pageNr < doc->getPageCount() ? doc->getPage(pageNr) : nullptr;
+        XojPdfPageSPtr pdf;
+        std::shared_ptr<PdfTextIndex> textIndex;
+        std::vector<XojPdfRectangle> textResults;
+        if (page) {
+            if (size_t pdfPageNr = page->getPdfPageNr(); pdfPageNr != npos) {
+                pdf = doc->getPdfPage(pdfPageNr);
+                textIndex = doc->getPdfTextIndex();
+            }
+            textResults = SearchControl::findTextInTexts(page, this->text);
+        }
+        doc->unlock();
+
+        if (!page) {
+            // The page was removed in the meantime
+            continue;
+        }
+
+        // Same order as SearchControl::search
+        std::vector<XojPdfRectangle> results;
+        if (pdf) {
+            results = SearchControl::findTextInPdf(*pdf, page->getPdfPageNr(), textIndex.get(), this->text);
+        }
+        results.insert(results.end(), textResults.begin(), textResults.end());
+
+        Util::execInUiThread([cancelled = this->cancelled, callback = this->callback, page = std::move(page),
+                              results = std::move(results)]() mutable {
+            if (!*cancelled) {
+                callback(page, std::move(results));
+            }
+        });
+    }
+}
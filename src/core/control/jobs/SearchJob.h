@@ -0,0 +1,73 @@
+/*
+ * Xournal++
+ *
+ * Search of a text on some pages, off the UI thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>      // for atomic_bool
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <memory>      // for shared_ptr
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include "model/PageRef.h"        // for PageRef
+#include "pdf/base/XojPdfPage.h"  // for XojPdfRectangle
+
+#include "Job.h"  // for Job, JobType
+
+class Document;
+class Scheduler;
+
+/**
+ * @brief A Job which searches a text on some pages of the document, and sends the matches of each page to the UI
+ * thread as soon as they are found. The jobs of a search run in parallel on the render workers.
+ */
+class SearchJob: public Job {
+public:
+    /**
+     * Set to true to cancel the jobs of a search: their remaining pages are not searched, and the results not
+     * delivered yet are dropped
+     */
+    using CancelToken = std::shared_ptr<std::atomic_bool>;
+
+    /// Called in the UI thread with the matches on a page (possibly none), unless the search was cancelled
+    using Callback = std::function<void(const PageRef& page, std::vector<XojPdfRectangle> results)>;
+
+    SearchJob(Document* doc, std::string text, std::vector<size_t> pages, CancelToken cancelled, Callback callback);
+
+protected:
+    ~SearchJob() override = default;
+
+public:
+    /**
+     * Search the text on all the pages of the document, starting from the page `first`
+     * @return The token to cancel the search
+     */
+    static CancelToken searchDocument(Document* doc, Scheduler* scheduler, const std::string& text, size_t first,
+                                      Callback callback);
+
+    JobType getType() override;
+
+    // Every job searches other pages: they can all run in parallel
+    void* getSource() override;
+
+    void run() override;
+
+    /// The number of pages searched by a job: the results are spread over the workers
+    static constexpr size_t PAGES_PER_JOB = 8;
+
+private:
+    Document* doc;
+    std::string text;
+    std::vector<size_t> pages;
+    CancelToken cancelled;
+    Callback callback;
+};
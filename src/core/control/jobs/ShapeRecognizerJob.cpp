@@ -0,0 +1,101 @@
+#include "ShapeRecognizerJob.h"
+
+#include <cmath>    // for abs
+#include <limits>   // for numeric_limits
+#include <memory>   // for make_unique
+#include <utility>  // for move
+
+#include "control/Control.h"                          // for Control
+#include "control/jobs/Job.h"                         // for JOB_TYPE_RECOGNIZER, JobType
+#include "control/settings/Settings.h"                // for Settings
+#include "control/shaperecognizer/ShapeRecognizer.h"  // for ShapeRecognizer
+#include "control/tools/SnapToGridInputHandler.h"     // for SnapToGridInputHandler
+#include "model/Document.h"                           // for Document
+#include "model/Element.h"                            // for Element, Element::Index
+#include "model/Layer.h"                              // for Layer
+#include "model/Point.h"                              // for Point
+#include "model/Stroke.h"                             // for Stroke
+#include "model/XojPage.h"                            // for XojPage
+#include "undo/RecognizerUndoAction.h"                // for RecognizerUndoAction
+#include "undo/UndoRedoHandler.h"                     // for UndoRedoHandler
+#include "util/Rectangle.h"                           // for Rectangle
+
+using xoj::util::Rectangle;
+
+ShapeRecognizerJob::ShapeRecognizerJob(Control* control, const PageRef& page, Layer* layer, Stroke* stroke,
+                                       UndoAction* lastAction):
+        control(control),
+        page(page),
+        layer(layer),
+        stroke(stroke),
+        lastAction(lastAction),
+        minSize(control->getSettings()->getStrokeRecognizerMinSize()),
+        copy(stroke->cloneStroke()) {}
+
+ShapeRecognizerJob::~ShapeRecognizerJob() = default;
+
+void ShapeRecognizerJob::run() {
+    ShapeRecognizer reco;
+    reco.setDeadline(std::chrono::steady_clock::now() + TIME_BUDGET);
+    this->recognized = reco.recognizePatterns(this->copy.get(), this->minSize);
+
+    if (this->recognized) {
+        callAfterRun();
+    }
+}
+
+void ShapeRecognizerJob::adjustRecognized() {
+    recognized->setWidth(copy->hasPressure() ? copy->getAvgPressure() : copy->getWidth());
+
+    Settings* settings = control->getSettings();
+    if (!settings->getSnapRecognizedShapesEnabled()) {
+        return;
+    }
+    SnapToGridInputHandler snappingHandler(settings);
+
+    Rectangle<double> oldSnappedBounds = recognized->getSnappedBounds();
+    Point topLeft = Point(oldSnappedBounds.x, oldSnappedBounds.y);
+    Point topLeftSnapped = snappingHandler.snapToGrid(topLeft, false);
+
+    recognized->move(topLeftSnapped.x - topLeft.x, topLeftSnapped.y - topLeft.y);
+    Rectangle<double> snappedBounds = recognized->getSnappedBounds();
+    Point belowRight = Point(snappedBounds.x + snappedBounds.width, snappedBounds.y + snappedBounds.height);
+    Point belowRightSnapped = snappingHandler.snapToGrid(belowRight, false);
+
+    double fx = (std::abs(snappedBounds.width) > std::numeric_limits<double>::epsilon()) ?
+                        (belowRightSnapped.x - topLeftSnapped.x) / snappedBounds.width :
+                        1;
+    double fy = (std::abs(snappedBounds.height) > std::numeric_limits<double>::epsilon()) ?
+                        (belowRightSnapped.y - topLeftSnapped.y) / snappedBounds.height :
+                        1;
+    recognized->scale(topLeftSnapped.x, topLeftSnapped.y, fx, fy, 0, false);
+}
+
+void ShapeRecognizerJob::afterRun() {
+    // The stroke may have been erased, moved or undone in the meantime: keep the user's changes
+    UndoRedoHandler* undo = control->getUndoRedoHandler();
+    if (undo->getLastAction() != this->lastAction) {
+        return;
+    }
+
+    adjustRecognized();
+    auto recognizedPtr = this->recognized.get();
+
+    Document* doc = control->getDocument();
+    doc->lock();
+    if (this->layer->indexOf(this->stroke) == Element::InvalidIndex) {
+        doc->unlock();
+        return;
+    }
+    // Swap the stroke and the shape in one go, so that no frame shows both or none of them
+    auto [original, pos] = this->layer->removeElement(this->stroke);
+    this->layer->insertElement(std::move(this->recognized), pos);
+    doc->unlock();
+
+    undo->addUndoAction(std::make_unique<RecognizerUndoAction>(page, layer, std::move(original), recognizedPtr));
+
+    this->page->fireElementChanged(this->stroke);
+    this->page->fireElementChanged(recognizedPtr);
+}
+
+auto ShapeRecognizerJob::getType() -> JobType { return JOB_TYPE_RECOGNIZER; }
@@ -0,0 +1,69 @@
+/*
+ * Xournal++
+ *
+ * Shape recognition of a stroke, off the UI thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <chrono>  // for milliseconds
+#include <memory>  // for unique_ptr
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "Job.h"  // for Job, JobType
+
+class Control;
+class Layer;
+class Stroke;
+class UndoAction;
+
+/**
+ * @brief Recognizes the shape of a stroke which has already been added to a layer, and replaces the stroke by the
+ * recognized shape once done.
+ *
+ * The recognition runs on a copy of the stroke. The stroke is only replaced if the last undo action did not change,
+ * i.e. if the user did nothing in the meantime which could conflict with the replacement.
+ */
+class ShapeRecognizerJob: public Job {
+public:
+    /**
+     * @param lastAction The last undo action once stroke was added to layer
+     */
+    ShapeRecognizerJob(Control* control, const PageRef& page, Layer* layer, Stroke* stroke, UndoAction* lastAction);
+
+protected:
+    ~ShapeRecognizerJob() override;
+
+public:
+    void run() override;
+    void afterRun() override;
+
+    JobType getType() override;
+
+    /// Longer recognitions are abandoned, and the stroke is kept as is
+    static constexpr std::chrono::milliseconds TIME_BUDGET{250};
+
+private:
+    /// Apply the width of the stroke and snap the recognized shape to the grid
+    void adjustRecognized();
+
+private:
+    Control* control;
+    PageRef page;
+    Layer* layer;
+    Stroke* stroke;
+    UndoAction* lastAction;
+
+    double minSize;
+
+    /// The copy of stroke read by the recognizer
+    std::unique_ptr<Stroke> copy;
+
+    std::unique_ptr<Stroke> recognized;
+};
@@ -24,57 +24,32 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, waitForTaskCompletion);
 }
 
-void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
+void XournalScheduler::removePage(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, false);  // prefetching
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT);
+}
 
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
 
     for (size_t priority = JOB_PRIORITY_URGENT; priority < JOB_N_PRIORITIES; priority++) {
-        std::deque<Job*>& queue = *this->jobQueue[priority];
-        auto it = queue.begin();
-
-        while (it != queue.end()) {
-            Job* job = *it;
-
+        for (Job* job: *this->jobQueue[priority]) {
             // Only remove PREVIEW and RENDER jobs; we aren't
             // responsible for other types of jobs.
             JobType type = job->getType();
             if (type == JOB_TYPE_PREVIEW || type == JOB_TYPE_RENDER) {
-                job->deleteJob();
-
-                it = queue.erase(it);
-
-                job->unref();
-                job = nullptr;
-            } else {
-                ++it;
+                cancelQueuedJobUnlocked(job);
             }
         }
     }
 }
 
-void XournalScheduler::finishTask() { std::lock_guard lock{this->jobRunningMutex}; }
+void XournalScheduler::finishTask() { waitForRunningJobs(); }
 
 void XournalScheduler::removeSource(void* source, JobType type, JobPriority priority, bool awaitFinishTask) {
     {
         std::lock_guard lock{this->jobQueueMutex};
-        std::deque<Job*>& queue = *this->jobQueue[priority];
-
-        auto it = queue.begin();
-
-        while (it != queue.end()) {
-            Job* job = *it;
-
-            if (job->getType() == type && job->getSource() == source) {
-                it = queue.erase(it);
-
-                job->deleteJob();
-                job->unref();
-                job = nullptr;
-            } else {
-                ++it;
-            }
-        }
+        cancelQueuedJobsUnlocked(source, type, priority);
     }
 
     // wait until the last job is done
@@ -85,17 +60,8 @@ void XournalScheduler::removeSource(void* source, JobType type, JobPriority prio
 }
 
 auto XournalScheduler::existsSource(void* source, JobType type, JobPriority priority) -> bool {
-    bool exists = false;
     std::lock_guard lock{this->jobQueueMutex};
-
-    for (Job* job: *this->jobQueue[priority]) {
-        if (job->getType() == type && job->getSource() == source) {
-            exists = true;
-            break;
-        }
-    }
-
-    return exists;
+    return hasQueuedJobUnlocked(source, type, priority);
 }
 
 void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
@@ -117,3 +83,14 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addPrefetchPage(XojPageView* view) {
+    if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT) ||
+        existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW)) {
+        return;
+    }
+
+    auto* job = new RenderJob(view);
+    addJob(job, JOB_PRIORITY_LOW);
+    job->unref();
+}
@@ -40,6 +40,10 @@ public:
 
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
+    /**
+     * Render a page which is not visible yet, but soon will be. Runs after the urgent jobs.
+     */
+    void addPrefetchPage(XojPageView* view);
 
     /**
      * Blocks until all currently running Job%s have been executed
@@ -0,0 +1,80 @@
+#include "LatexCache.h"
+
+#include <algorithm>     // for sort
+#include <system_error>  // for error_code
+#include <utility>       // for move, pair
+#include <vector>        // for vector
+
+#include <glib.h>  // for g_compute_checksum_for_string, g_warning
+
+#include "util/PathUtil.h"  // for readString
+
+LatexCache::LatexCache(fs::path folder): folder(std::move(folder)) {}
+
+auto LatexCache::key(const std::string& texContents, const std::string& genCmd) -> std::string {
+    // The command is separated from the contents by a character a command line cannot contain
+    std::string data = genCmd;
+    data += '\0';
+    data += texContents;
+
+    gchar* checksum = g_compute_checksum_for_data(G_CHECKSUM_SHA256, reinterpret_cast<const guchar*>(data.data()),
+                                                  data.size());
+    std::string key(checksum);
+    g_free(checksum);
+    return key;
+}
+
+auto LatexCache::fileFor(const std::string& key) const -> fs::path { return folder / (key + ".pdf"); }
+
+auto LatexCache::lookup(const std::string& key) const -> std::optional<std::string> {
+    auto file = fileFor(key);
+    std::error_code ec;
+    if (!fs::is_regular_file(file, ec)) {
+        return std::nullopt;
+    }
+
+    auto contents = Util::readString(file, false, std::ios::binary);
+    if (contents) {
+        // Used recently
+        fs::last_write_time(file, fs::file_time_type::clock::now(), ec);
+    }
+    return contents;
+}
+
+void LatexCache::store(const std::string& key, const fs::path& pdf) {
+    auto file = fileFor(key);
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+
+    // Another instance may look the file up in the meantime: it must never be half written
+    std::error_code ec;
+    fs::copy_file(pdf, tmpFile, fs::copy_options::overwrite_existing, ec);
+    if (!ec) {
+        fs::rename(tmpFile, file, ec);
+    }
+    if (ec) {
+        g_warning("Could not cache the rendered LaTeX formula %s: %s", file.string().c_str(), ec.message().c_str());
+        fs::remove(tmpFile, ec);
+        return;
+    }
+
+    prune();
+}
+
+void LatexCache::prune() {
+    std::vector<std::pair<fs::file_time_type, fs::path>> files;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(folder, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        std::error_code timeEc;
+        if (auto time = it->last_write_time(timeEc); !timeEc && it->path().extension() == ".pdf") {
+            files.emplace_back(time, it->path());
+        }
+    }
+    if (files.size() <= MAX_ENTRIES) {
+        return;
+    }
+
+    // Most recently used first
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = MAX_ENTRIES; i < files.size(); i++) { fs::remove(files[i].second, ec); }
+}
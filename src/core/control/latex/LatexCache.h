@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Cache of the rendered LaTeX formulas
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+#include <string>    // for string
+
+#include "filesystem.h"  // for path
+
+/**
+ * @brief The PDF files rendered from LaTeX formulas, kept on disk across documents and sessions.
+ *
+ * A file is named after a hash of the instantiated template (i.e. the template, the formula and the text color) and of
+ * the generator command, so that identical formulas are only compiled once.
+ * The least recently used files are removed once there are more than MAX_ENTRIES.
+ */
+class LatexCache {
+public:
+    explicit LatexCache(fs::path folder);
+
+    /// The number of rendered formulas kept
+    static constexpr size_t MAX_ENTRIES = 500;
+
+    /**
+     * The key of the rendered formula
+     * @param texContents The instantiated template, see LatexGenerator::templateSub
+     * @param genCmd The command compiling the formula
+     */
+    static std::string key(const std::string& texContents, const std::string& genCmd);
+
+    /**
+     * @return The PDF rendered for the key, if it is cached
+     */
+    std::optional<std::string> lookup(const std::string& key) const;
+
+    /**
+     * Keep a copy of the rendered PDF file
+     */
+    void store(const std::string& key, const fs::path& pdf);
+
+private:
+    fs::path fileFor(const std::string& key) const;
+
+    /// Remove the least recently used files
+    void prune();
+
+private:
+    fs::path folder;
+};
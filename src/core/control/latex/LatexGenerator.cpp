@@ -1,8 +1,11 @@
 #include "LatexGenerator.h"
 
-#include <regex>        // for smatch, sregex_iterator
-#include <sstream>      // for ostringstream
-#include <string_view>  // for string_view
+#include <algorithm>     // for min
+#include <memory>        // for unique_ptr
+#include <regex>         // for smatch, sregex_iterator
+#include <sstream>       // for ostringstream
+#include <string_view>   // for string_view
+#include <system_error>  // for error_code
 
 #include <glib.h>     // for GError, gchar, g_error_free
 #include <poppler.h>  // for g_object_unref
@@ -19,6 +22,85 @@
 
 using namespace xoj::util;
 
+namespace {
+/// A format being built in the background
+struct FormatBuild {
+    fs::path built;
+    fs::path target;
+};
+
+void onFormatBuilt(GObject* proc, GAsyncResult* res, gpointer data) {
+    std::unique_ptr<FormatBuild> build(static_cast<FormatBuild*>(data));
+    GErrorGuard err{};
+    if (!g_subprocess_wait_check_finish(G_SUBPROCESS(proc), res, out_ptr(err))) {
+        g_message("Could not precompile the LaTeX preamble, is the mylatexformat package installed? %s", err->message);
+        return;
+    }
+    // Only used once it is complete
+    std::error_code ec;
+    fs::rename(build->built, build->target, ec);
+}
+
+/**
+ * Start compiling the preamble into the format "name.fmt".
+ * The source "name.tex" is left behind, so that a preamble which failed to compile is not tried again.
+ */
+void buildFormat(const fs::path& texDir, const gchar* prog, const std::string& engine, const std::string& name,
+                 const std::string& preamble) {
+    auto source = texDir / (name + ".tex");
+    if (!g_file_set_contents(source.string().c_str(), preamble.c_str(), as_signed(preamble.size()), nullptr)) {
+        return;
+    }
+
+    const std::string jobname = "-jobname=" + name + "-tmp";
+    const std::string baseFormat = "&" + engine;
+    const std::string sourceName = source.filename().string();
+    const gchar* argv[] = {prog, "-ini", "-interaction=nonstopmode", jobname.c_str(),
+                           baseFormat.c_str(), "mylatexformat.ltx", sourceName.c_str(), nullptr};
+
+    auto flags = static_cast<GSubprocessFlags>(G_SUBPROCESS_FLAGS_STDOUT_SILENCE | G_SUBPROCESS_FLAGS_STDERR_SILENCE);
+    xoj::util::GObjectSPtr<GSubprocessLauncher> launcher(g_subprocess_launcher_new(flags), xoj::util::adopt);
+    g_subprocess_launcher_set_cwd(launcher.get(), texDir.u8string().c_str());
+    GErrorGuard err{};
+    xoj::util::GObjectSPtr<GSubprocess> proc(g_subprocess_launcher_spawnv(launcher.get(), argv, out_ptr(err)),
+                                             xoj::util::adopt);
+    if (!proc) {
+        g_warning("Could not precompile the LaTeX preamble: %s", err->message);
+        return;
+    }
+
+    auto* build = new FormatBuild{texDir / (name + "-tmp.fmt"), texDir / (name + ".fmt")};
+    g_subprocess_wait_check_async(proc.get(), nullptr, onFormatBuilt, build);
+}
+
+/**
+ * @return The contents of the LaTeX file loading the precompiled preamble, if it is built already
+ */
+auto usePreambleFormat(const fs::path& texDir, const gchar* prog, const std::string& contents, size_t preambleLength)
+        -> std::string {
+    const std::string engine = fs::path(prog).stem().string();
+    if (engine != "pdflatex" && engine != "latex" && engine != "xelatex") {
+        // Not supported by mylatexformat
+        return contents;
+    }
+
+    const std::string preamble = contents.substr(0, preambleLength) + "\\endofdump\n";
+    gchar* checksum = g_compute_checksum_for_string(G_CHECKSUM_SHA256, (engine + preamble).c_str(), -1);
+    const std::string name = "xpp-preamble-" + std::string(checksum, 16);
+    g_free(checksum);
+
+    std::error_code ec;
+    if (fs::exists(texDir / (name + ".fmt"), ec)) {
+        // The first line selects the format, which skips the preamble up to \endofdump
+        return "%&" + name + "\n" + preamble + contents.substr(preambleLength);
+    }
+    if (!fs::exists(texDir / (name + ".tex"), ec)) {
+        buildFormat(texDir, prog, engine, name, preamble);
+    }
+    return contents;
+}
+}  // namespace
+
 LatexGenerator::LatexGenerator(const LatexSettings& settings): settings(settings) {}
 
 auto LatexGenerator::templateSub(const std::string& input, const std::string& templ, const Color textColor)
@@ -45,7 +127,18 @@ auto LatexGenerator::templateSub(const std::string& input, const std::string& te
     return output;
 }
 
-auto LatexGenerator::asyncRun(const fs::path& texDir, const std::string& texFileContents) -> Result {
+auto LatexGenerator::constantPreambleLength(const std::string& templ) -> size_t {
+    size_t end = std::min(templ.find("%%XPP_"), templ.find("\\begin{document}"));
+    if (end == std::string::npos) {
+        return 0;
+    }
+    // Up to the line of the placeholder
+    size_t lineStart = templ.rfind('\n', end);
+    return lineStart == std::string::npos ? 0 : lineStart + 1;
+}
+
+auto LatexGenerator::asyncRun(const fs::path& texDir, const std::string& texFileContents, size_t preambleLength)
+        -> Result {
     std::string cmd = this->settings.genCmd;
     GErrorGuard err{};
     std::string texFilePathOSEncoding;
@@ -79,7 +172,10 @@ auto LatexGenerator::asyncRun(const fs::path& texDir, const std::string& texFile
     g_free(argv.get()[0]);
     argv.get()[0] = prog;
 
-    if (!g_file_set_contents(texFilePathOSEncoding.c_str(), texFileContents.c_str(), as_signed(texFileContents.size()),
+    const std::string contents = this->settings.precompilePreamble && preambleLength > 0 ?
+                                         usePreambleFormat(texDir, prog, texFileContents, preambleLength) :
+                                         texFileContents;
+    if (!g_file_set_contents(texFilePathOSEncoding.c_str(), contents.c_str(), as_signed(contents.size()),
                              out_ptr(err))) {
         return GenError({FS(_F("Could not save .tex file: {1}") % err->message)});
     }
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
 #include <string>   // for string
 #include <variant>  // for variant
 
@@ -42,14 +43,24 @@ public:
      * in the given directory.
      * The resultant process will have its standard error and (original) standard output
      * combined into a single standard out stream.
+     *
+     * If the preamble is precompiled (see LatexSettings::precompilePreamble), the first preambleLength characters of
+     * the file are compiled into a format in the background. The following runs with the same preamble load the format
+     * instead of the packages.
      */
-    Result asyncRun(const fs::path& texDir, const std::string& texFileContents);
+    Result asyncRun(const fs::path& texDir, const std::string& texFileContents, size_t preambleLength = 0);
 
     /**
      * Instantiate the LaTeX template.
      */
     static std::string templateSub(const std::string& input, const std::string& templ, Color textColor);
 
+    /**
+     * The length of the part of the template before the first line with a placeholder or \begin{document}. This part
+     * is the same in every instance of the template.
+     */
+    static size_t constantPreambleLength(const std::string& templ);
+
 private:
     const LatexSettings& settings;
 };
@@ -77,8 +77,8 @@ void LayerController::fireRebuildLayerMenu() {
 void LayerController::fireLayerVisibilityChanged() {
     for (LayerCtrlListener* l: this->listener) { l->layerVisibilityChanged(); }
 
-    // Rerenders the page - Todo: make this another listener
-    control->getWindow()->getXournal()->layerChanged(selectedPage);
+    // Composes the page again - Todo: make this another listener
+    control->getWindow()->getXournal()->layerVisibilityChanged(selectedPage);
 }
 
 void LayerController::fireSelectedLayerChanged() {
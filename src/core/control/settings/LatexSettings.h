@@ -26,6 +26,11 @@ public:
 #else
     std::string genCmd{"pdflatex -halt-on-error -interaction=nonstopmode '{}'"};
 #endif
+    /**
+     * Precompile the preamble of the template into a format, with the mylatexformat package, so that the packages are
+     * not loaded again for each preview
+     */
+    bool precompilePreamble{false};
 
     /**
      * LaTeX editor theme. Only used if linked with the GtkSourceView
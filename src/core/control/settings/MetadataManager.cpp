@@ -1,25 +1,46 @@
 #include "MetadataManager.h"
 
-#include <algorithm>  // for sort
-#include <cstdlib>    // for strtoll, strtod
-#include <fstream>    // for operator<<, basic_ostream, basic_stringb...
-#include <memory>     // for allocator_traits<>::value_type
-#include <sstream>    // for istringstream
-#include <string>     // for char_traits, string, getline, operator!=
+#include <algorithm>     // for sort
+#include <cstdlib>       // for strtoll, strtod
+#include <fstream>       // for operator<<, basic_ostream, basic_stringb...
+#include <locale>        // for locale
+#include <memory>        // for allocator_traits<>::value_type
+#include <sstream>       // for istringstream
+#include <string>        // for char_traits, string, getline, operator!=
+#include <system_error>  // for error_code
+#include <utility>       // for move
 
 #include <glib.h>  // for g_get_real_time, g_warning, gint64
 
-#include "util/PathUtil.h"   // for getConfigSubfolder
-#include "util/XojMsgBox.h"  // for XojMsgBox
-
 using namespace std;
 
+namespace {
+constexpr auto INDEX_HEADER = "XOJ-METADATA-INDEX/1.0";
+
+auto sortMetadata(const MetadataEntry& a, const MetadataEntry& b) -> bool { return a.time > b.time; }
+
+void writeEntry(ostream& out, const MetadataEntry& e) {
+    out << e.time << ' ' << e.page << ' ' << e.zoom << ' ' << e.path << '\n';
+}
+}  // namespace
+
 MetadataEntry::MetadataEntry(): valid(false), zoom(1), page(0), time(0) {}
 
 
-MetadataManager::MetadataManager(): metadata(nullptr) {}
+MetadataManager::MetadataManager(fs::path folder):
+        folder(std::move(folder)), indexFile(this->folder / "metadata.index") {
+    this->thread = std::thread([this]() { run(); });
+}
 
-MetadataManager::~MetadataManager() { documentChanged(); }
+MetadataManager::~MetadataManager() {
+    documentChanged();
+    {
+        std::lock_guard lock(this->mutex);
+        this->stopping = true;
+    }
+    this->cond.notify_all();
+    this->thread.join();
+}
 
 /**
  * Delete an old metadata file
@@ -40,46 +61,158 @@ void MetadataManager::deleteMetadataFile(fs::path const& path) {
  * Document was closed, a new document was opened etc.
  */
 void MetadataManager::documentChanged() {
-    this->mutex.lock();
-    MetadataEntry* m = metadata;
-    metadata = nullptr;
-    this->mutex.unlock();
+    {
+        std::lock_guard lock(this->mutex);
+        queueCurrent();
+    }
+    this->cond.notify_all();
+}
 
-    if (m == nullptr) {
+void MetadataManager::queueCurrent() {
+    if (!this->current) {
         return;
     }
 
-    storeMetadata(m);
-    delete m;
+    this->entries[this->current->path] = *this->current;
+    this->pending.push_back(std::move(*this->current));
+    this->current.reset();
 }
 
-auto sortMetadata(MetadataEntry& a, MetadataEntry& b) -> bool { return a.time > b.time; }
+void MetadataManager::run() {
+    loadIndex();
 
-/**
- * Load the metadata list (sorted)
- */
-auto MetadataManager::loadList() -> vector<MetadataEntry> {
-    auto folder = Util::getConfigSubfolder("metadata");
+    std::unique_lock lock(this->mutex);
+    while (true) {
+        this->cond.wait(lock, [this]() { return this->stopping || !this->pending.empty(); });
+        if (this->pending.empty()) {
+            // Everything was written before stopping
+            break;
+        }
 
-    vector<MetadataEntry> data;
-    try {
-        for (auto const& f: fs::directory_iterator(folder)) {
-            auto path = folder / f;
+        std::vector<MetadataEntry> added = std::move(this->pending);
+        this->pending.clear();
+        lock.unlock();
+        appendToIndex(added);
+        lock.lock();
+    }
+}
 
-            MetadataEntry entry = loadMetadataFile(path, f.path());
+void MetadataManager::loadIndex() {
+    std::map<fs::path, MetadataEntry> read;
+    std::vector<fs::path> legacyFiles;
+
+    ifstream in(this->indexFile);
+    in.imbue(std::locale::classic());
+    string line;
+    bool hasIndex = in && getline(in, line) && line == INDEX_HEADER;
+    if (hasIndex) {
+        while (getline(in, line)) {
+            this->indexLines++;
+
+            MetadataEntry entry;
+            istringstream iss(line);
+            iss.imbue(std::locale::classic());
+            if (!(iss >> entry.time >> entry.page >> entry.zoom >> entry.path)) {
+                continue;
+            }
+            entry.valid = true;
 
-            if (entry.valid) {
-                data.push_back(entry);
+            // The lines are appended: the last one of a file is the latest
+            read[entry.path] = std::move(entry);
+        }
+    } else {
+        // The metadata files of older versions, one file per document
+        try {
+            for (auto const& f: fs::directory_iterator(this->folder)) {
+                if (f.path().extension() != ".metadata") {
+                    continue;
+                }
+                legacyFiles.push_back(f.path());
+                MetadataEntry entry = loadMetadataFile(f.path(), f.path().filename());
+                auto it = read.find(entry.path);
+                if (entry.valid && (it == read.end() || it->second.time < entry.time)) {
+                    read[entry.path] = std::move(entry);
+                }
             }
+        } catch (const fs::filesystem_error& e) {
+            g_warning("Could not read the metadata folder: %s", e.what());
         }
-    } catch (const fs::filesystem_error& e) {
-        XojMsgBox::showErrorToUser(nullptr, e.what());
-        return data;
+    }
+    in.close();
+
+    {
+        std::lock_guard lock(this->mutex);
+        // The entries stored in the meantime are the latest
+        for (auto& [path, entry]: read) { this->entries.emplace(path, std::move(entry)); }
+        this->loaded = true;
+    }
+    this->cond.notify_all();
+
+    bool compact = !hasIndex || this->indexLines > read.size() + MAX_ENTRIES || read.size() > MAX_ENTRIES;
+    if (compact && compactIndex()) {
+        // Imported
+        for (auto const& f: legacyFiles) { deleteMetadataFile(f); }
+    }
+}
+
+void MetadataManager::appendToIndex(const std::vector<MetadataEntry>& added) {
+    {
+        ofstream out(this->indexFile, ios::app);
+        out.imbue(std::locale::classic());
+        for (const MetadataEntry& e: added) { writeEntry(out, e); }
+        if (!out) {
+            g_warning("Could not write the metadata index %s", this->indexFile.string().c_str());
+        }
+    }
+    this->indexLines += added.size();
+
+    size_t count = 0;
+    {
+        std::lock_guard lock(this->mutex);
+        count = this->entries.size();
+    }
+    if (this->indexLines > count + MAX_ENTRIES || count > MAX_ENTRIES) {
+        compactIndex();
+    }
+}
+
+auto MetadataManager::compactIndex() -> bool {
+    std::vector<MetadataEntry> latest;
+    {
+        std::lock_guard lock(this->mutex);
+        latest.reserve(this->entries.size());
+        for (const auto& [path, entry]: this->entries) { latest.push_back(entry); }
+        std::sort(latest.begin(), latest.end(), sortMetadata);
+        for (size_t i = MAX_ENTRIES; i < latest.size(); i++) { this->entries.erase(latest[i].path); }
+    }
+    if (latest.size() > MAX_ENTRIES) {
+        latest.resize(MAX_ENTRIES);
     }
 
-    std::sort(data.begin(), data.end(), sortMetadata);
+    // Replace the index at once, so that it is never left half written
+    auto tmpFile = this->indexFile;
+    tmpFile += ".tmp";
+    {
+        ofstream out(tmpFile);
+        out.imbue(std::locale::classic());
+        out << INDEX_HEADER << '\n';
+        // Oldest first, as if they were appended
+        for (auto it = latest.rbegin(); it != latest.rend(); it++) { writeEntry(out, *it); }
+        if (!out) {
+            g_warning("Could not write the metadata index %s", tmpFile.string().c_str());
+            return false;
+        }
+    }
 
-    return data;
+    std::error_code ec;
+    fs::rename(tmpFile, this->indexFile, ec);
+    if (ec) {
+        g_warning("Could not replace the metadata index %s: %s", this->indexFile.string().c_str(),
+                  ec.message().c_str());
+        return false;
+    }
+    this->indexLines = latest.size();
+    return true;
 }
 
 /**
@@ -131,47 +264,14 @@ auto MetadataManager::loadMetadataFile(fs::path const& path, fs::path const& fil
  * Get the metadata for a file
  */
 auto MetadataManager::getForFile(fs::path const& file) -> MetadataEntry {
-    vector<MetadataEntry> files = loadList();
-
-    MetadataEntry entry;
-    for (const MetadataEntry& e: files) {
-        if (e.path == file) {
-            entry = e;
-            break;
-        }
-    }
-
-    for (size_t i = 20; i < files.size(); i++) {
-        auto path = files[i].metadataFile;
-        deleteMetadataFile(path);
-    }
-
-    return entry;
-}
+    std::unique_lock lock(this->mutex);
+    this->cond.wait(lock, [this]() { return this->loaded; });
 
-/**
- * Store metadata to file
- */
-void MetadataManager::storeMetadata(MetadataEntry* m) {
-    vector<MetadataEntry> files = loadList();
-    for (const MetadataEntry& e: files) {
-        if (e.path == m->path) {
-            // This is an old entry with the same path
-            deleteMetadataFile(e.metadataFile);
-        }
+    if (this->current && this->current->path == file) {
+        return *this->current;
     }
-
-    auto path = Util::getConfigSubfolder("metadata");
-    gint64 time = g_get_real_time();
-    path /= std::to_string(time);
-    path += ".metadata";
-
-    ofstream out(path);
-    out << "XOJ-METADATA/1.0\n";
-    out << m->path << "\n";
-    out << "page=" << m->page << "\n";
-    out << "zoom=" << m->zoom << "\n";
-    out.close();
+    auto it = this->entries.find(file);
+    return it == this->entries.end() ? MetadataEntry() : it->second;
 }
 
 /**
@@ -182,15 +282,25 @@ void MetadataManager::storeMetadata(fs::path const& file, int page, double zoom)
         return;
     }
 
-    this->mutex.lock();
-    if (metadata == nullptr) {
-        metadata = new MetadataEntry();
-    }
+    bool queued = false;
+    {
+        std::lock_guard lock(this->mutex);
+        if (this->current && this->current->path != file) {
+            // Another document: keep the metadata of the previous one
+            queueCurrent();
+            queued = true;
+        }
+        if (!this->current) {
+            this->current.emplace();
+        }
 
-    metadata->valid = true;
-    metadata->path = file;
-    metadata->zoom = zoom;
-    metadata->page = page;
-    metadata->time = g_get_real_time();
-    this->mutex.unlock();
+        this->current->valid = true;
+        this->current->path = file;
+        this->current->zoom = zoom;
+        this->current->page = page;
+        this->current->time = g_get_real_time();
+    }
+    if (queued) {
+        this->cond.notify_all();
+    }
 }
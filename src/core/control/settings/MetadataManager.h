@@ -11,11 +11,18 @@
 
 #pragma once
 
-#include <mutex>   // for mutex
-#include <vector>  // for vector
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <map>                 // for map
+#include <mutex>               // for mutex
+#include <optional>            // for optional
+#include <thread>              // for thread
+#include <vector>              // for vector
 
 #include <glib.h>  // for gint64
 
+#include "util/PathUtil.h"  // for getConfigSubfolder
+
 #include "filesystem.h"  // for path
 
 
@@ -32,16 +39,28 @@ public:
     gint64 time;
 };
 
+/**
+ * @brief The metadata of the last opened files, kept in a single index file of the metadata folder.
+ *
+ * The index is read once, on a background thread, when the manager is created. The changes are appended to the index
+ * on the same thread, and the index is compacted once it holds too many stale lines. The UI thread never touches the
+ * disk, except to wait for the index to be read the first time a file is opened.
+ *
+ * The metadata files of older versions (one file per document) are imported into the index and deleted.
+ */
 class MetadataManager {
 public:
-    MetadataManager();
+    explicit MetadataManager(fs::path folder = Util::getConfigSubfolder("metadata"));
     virtual ~MetadataManager();
 
+    /// The number of files whose metadata are kept
+    static constexpr size_t MAX_ENTRIES = 1000;
+
 public:
     /**
      * Get the metadata for a file
      */
-    static MetadataEntry getForFile(fs::path const& file);
+    MetadataEntry getForFile(fs::path const& file);
 
     /**
      * Store the current data into metadata
@@ -49,7 +68,7 @@ public:
     void storeMetadata(fs::path const& file, int page, double zoom);
 
     /**
-     * Document was closed, a new document was opened etc.
+     * Document was closed, a new document was opened etc. The metadata of the document are written out.
      */
     void documentChanged();
 
@@ -60,23 +79,56 @@ private:
     static void deleteMetadataFile(fs::path const& path);
 
     /**
-     * Parse a single metadata file
+     * Parse a single metadata file of older versions
      */
     static MetadataEntry loadMetadataFile(fs::path const& path, fs::path const& file);
 
     /**
-     * Store metadata to file
+     * Write the pending entries to the index, until the manager is destroyed. Runs on the background thread.
      */
-    static void storeMetadata(MetadataEntry* m);
+    void run();
+
+    /**
+     * Read the index, or import the metadata files of older versions if there is no index yet
+     */
+    void loadIndex();
+
+    /**
+     * Append the entries to the index
+     */
+    void appendToIndex(const std::vector<MetadataEntry>& added);
 
-private:
     /**
-     * Load the metadata list (sorted)
+     * Rewrite the index with the last entry of each of the MAX_ENTRIES latest files
+     * @return false if the index could not be written
      */
-    static std::vector<MetadataEntry> loadList();
+    bool compactIndex();
 
+    /**
+     * Queue the metadata of the current document to be written. The mutex must be held.
+     */
+    void queueCurrent();
 
 private:
+    fs::path folder;
+    fs::path indexFile;
+
     std::mutex mutex;
-    MetadataEntry* metadata;
+    std::condition_variable cond;
+
+    /// The metadata of the current document, written when it is closed
+    std::optional<MetadataEntry> current;
+
+    /// The last metadata of each file, by path
+    std::map<fs::path, MetadataEntry> entries;
+    bool loaded = false;
+
+    /// Not written to the index yet
+    std::vector<MetadataEntry> pending;
+    bool stopping = false;
+
+    /// Lines of the index, only used on the background thread
+    size_t indexLines = 0;
+
+    std::thread thread;
 };
@@ -1,13 +1,15 @@
 #include "Settings.h"
 
-#include <algorithm>    // for max
-#include <cstdint>      // for uint32_t, int32_t
-#include <cstdio>       // for sscanf, size_t
-#include <cstdlib>      // for atoi
-#include <cstring>      // for strcmp
-#include <exception>    // for exception
-#include <type_traits>  // for add_const<>::type
-#include <utility>      // for pair, move, make_...
+#include <algorithm>      // for max
+#include <cstdint>        // for uint32_t, int32_t
+#include <cstdio>         // for sscanf, size_t
+#include <cstdlib>        // for atoi
+#include <cstring>        // for strcmp
+#include <exception>      // for exception
+#include <string_view>    // for string_view
+#include <type_traits>    // for add_const<>::type
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair, move, make_...
 
 #include <libxml/globals.h>    // for xmlFree, xmlInden...
 #include <libxml/parser.h>     // for xmlKeepBlanksDefault
@@ -22,6 +24,7 @@
 #include "util/Color.h"
 #include "util/PathUtil.h"    // for getConfigFile
 #include "util/Util.h"        // for PRECISION_FORMAT_...
+#include "util/glib_casts.h"  // for wrap_v
 #include "util/i18n.h"        // for _
 #include "util/safe_casts.h"  // for as_unsigned
 
@@ -48,7 +51,7 @@ constexpr auto DEFAULT_TOOLBAR = "Portrait";
 
 Settings::Settings(fs::path filepath): filepath(std::move(filepath)) { loadDefault(); }
 
-Settings::~Settings() = default;
+Settings::~Settings() { flush(); }
 
 void Settings::loadDefault() {
     this->pressureSensitivity = true;
@@ -143,6 +146,9 @@ void Settings::loadDefault() {
     this->snapGridTolerance = 0.50;
     this->snapGridSize = DEFAULT_GRID_SIZE;
 
+    this->snapObjects = false;
+    this->snapObjectsTolerance = 0.50;
+
     this->strokeRecognizerMinSize = 40;
 
     this->touchDrawing = false;
@@ -180,12 +186,23 @@ void Settings::loadDefault() {
             std::vector<ViewMode>{VIEW_MODE_STRUCT_DEFAULT, VIEW_MODE_STRUCT_FULLSCREEN, VIEW_MODE_STRUCT_PRESENTATION};
 
     this->touchZoomStartThreshold = 0.0;
+    this->touchKineticScrolling = true;
 
     this->pageRerenderThreshold = 5.0;
-    this->pdfPageCacheSize = 10;
+    this->pdfPageCacheMemory = 128;
     this->preloadPagesBefore = 3U;
     this->preloadPagesAfter = 5U;
     this->eagerPageCleanup = true;
+    this->lazyPageLoading = false;
+    this->binaryStrokeEncoding = false;
+    this->compactStrokeStorage = false;
+    this->draftRendering = false;
+    this->coalesceRepaints = true;
+    this->blitOnScroll = true;
+    this->renderWorkerCount = 0U;
+    this->pageBufferMemoryBudget = 1024U;
+    this->previewUpdateDelay = 1000U;
+    this->printLookAhead = 8U;
 
     this->selectionBorderColor = Colors::red;
     this->selectionMarkerColor = Colors::xopp_cornflowerblue;
@@ -200,6 +217,7 @@ void Settings::loadDefault() {
     this->audioSampleRate = 44100.0;
     this->audioInputDevice = AUDIO_INPUT_SYSTEM_DEFAULT;
     this->audioOutputDevice = AUDIO_OUTPUT_SYSTEM_DEFAULT;
+    this->keepAudioOutputOpen = true;
     this->audioGain = 1.0;
     this->defaultSeekTime = 5;
 
@@ -237,6 +255,11 @@ void Settings::loadDefault() {
     this->stabilizerFinalizeStroke = true;
     /**/
 
+    this->inkPrediction = false;
+    this->inkPredictionTime = 16;
+    this->inkDecimation = false;
+    this->inkDecimationError = 0.25;
+
     this->useSpacesForTab = false;
     this->numberOfSpacesForTab = 4;
 }
@@ -375,308 +398,506 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         return;
     }
 
-    // TODO(fabian): remove this typo fix in 2-3 release cycles
-    if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("presureSensitivity")) == 0) {
-        this->pressureSensitivity = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    }
-    if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pressureSensitivity")) == 0) {
-        this->pressureSensitivity = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("minimumPressure")) == 0) {
-        // std::max is for backwards compatibility for users who might have set this value too small
-        this->minimumPressure = std::max(0.01, g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pressureMultiplier")) == 0) {
-        this->pressureMultiplier = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("zoomGesturesEnabled")) == 0) {
-        this->zoomGesturesEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectedToolbar")) == 0) {
-        this->selectedToolbar = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("lastSavePath")) == 0) {
-        this->lastSavePath = fs::u8path(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("lastOpenPath")) == 0) {
-        this->lastOpenPath = fs::u8path(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("lastImagePath")) == 0) {
-        this->lastImagePath = fs::u8path(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("edgePanSpeed")) == 0) {
-        this->edgePanSpeed = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("edgePanMaxMult")) == 0) {
-        this->edgePanMaxMult = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("zoomStep")) == 0) {
-        this->zoomStep = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("zoomStepScroll")) == 0) {
-        this->zoomStepScroll = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("displayDpi")) == 0) {
-        this->displayDpi = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("mainWndWidth")) == 0) {
-        this->mainWndWidth = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("mainWndHeight")) == 0) {
-        this->mainWndHeight = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("maximized")) == 0) {
-        this->maximized = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("showToolbar")) == 0) {
-        this->showToolbar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("filepathShownInTitlebar")) == 0) {
-        this->filepathShownInTitlebar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pageNumberShownInTitlebar")) == 0) {
-        this->pageNumberShownInTitlebar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("showSidebar")) == 0) {
-        this->showSidebar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("sidebarNumberingStyle")) == 0) {
-        int num = std::stoi(reinterpret_cast<char*>(value));
-        if (num < static_cast<int>(SidebarNumberingStyle::MIN) || static_cast<int>(SidebarNumberingStyle::MAX) < num) {
-            num = static_cast<int>(SidebarNumberingStyle::DEFAULT);
-            g_warning("Settings::Invalid sidebarNumberingStyle value. Reset to default.");
-        }
-        this->sidebarNumberingStyle = static_cast<SidebarNumberingStyle>(num);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("sidebarWidth")) == 0) {
-        this->sidebarWidth = std::max<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10), 50);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("sidebarOnRight")) == 0) {
-        this->sidebarOnRight = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("scrollbarOnLeft")) == 0) {
-        this->scrollbarOnLeft = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("menubarVisible")) == 0) {
-        this->menubarVisible = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("numColumns")) == 0) {
-        this->numColumns = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("numRows")) == 0) {
-        this->numRows = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("viewFixedRows")) == 0) {
-        this->viewFixedRows = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("layoutVertical")) == 0) {
-        this->layoutVertical = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("layoutRightToLeft")) == 0) {
-        this->layoutRightToLeft = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("layoutBottomToTop")) == 0) {
-        this->layoutBottomToTop = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("showPairedPages")) == 0) {
-        this->showPairedPages = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("numPairsOffset")) == 0) {
-        this->numPairsOffset = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("presentationMode")) == 0) {
-        this->presentationMode = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autoloadMostRecent")) == 0) {
-        this->autoloadMostRecent = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autoloadPdfXoj")) == 0) {
-        this->autoloadPdfXoj = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stylusCursorType")) == 0) {
-        this->stylusCursorType = stylusCursorTypeFromString(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eraserVisibility")) == 0) {
-        this->eraserVisibility = eraserVisibilityFromString(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("iconTheme")) == 0) {
-        this->iconTheme = iconThemeFromString(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("themeVariant")) == 0) {
-        this->themeVariant = themeVariantFromString(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("highlightPosition")) == 0) {
-        this->highlightPosition = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("cursorHighlightColor")) == 0) {
-        this->cursorHighlightColor = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("cursorHighlightRadius")) == 0) {
-        this->cursorHighlightRadius = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("cursorHighlightBorderColor")) == 0) {
-        this->cursorHighlightBorderColor = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("cursorHighlightBorderWidth")) == 0) {
-        this->cursorHighlightBorderWidth = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("useStockIcons")) == 0) {
-        this->useStockIcons = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("defaultSaveName")) == 0) {
-        this->defaultSaveName = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("defaultPdfExportName")) == 0) {
-        this->defaultPdfExportName = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pluginEnabled")) == 0) {
-        this->pluginEnabled = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pluginDisabled")) == 0) {
-        this->pluginDisabled = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pageTemplate")) == 0) {
-        this->pageTemplate = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("sizeUnit")) == 0) {
-        this->sizeUnit = reinterpret_cast<const char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("audioFolder")) == 0) {
-        this->audioFolder = fs::u8path(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveEnabled")) == 0) {
-        this->autosaveEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("autosaveTimeout")) == 0) {
-        this->autosaveTimeout = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("defaultViewModeAttributes")) == 0) {
-        this->viewModes.at(PresetViewModeIds::VIEW_MODE_DEFAULT) =
-                settingsStringToViewMode(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("fullscreenViewModeAttributes")) == 0) {
-        this->viewModes.at(PresetViewModeIds::VIEW_MODE_FULLSCREEN) =
-                settingsStringToViewMode(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("presentationViewModeAttributes")) == 0) {
-        this->viewModes.at(PresetViewModeIds::VIEW_MODE_PRESENTATION) =
-                settingsStringToViewMode(reinterpret_cast<const char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("touchZoomStartThreshold")) == 0) {
-        this->touchZoomStartThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pageRerenderThreshold")) == 0) {
-        this->pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pdfPageCacheSize")) == 0) {
-        this->pdfPageCacheSize = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesBefore")) == 0) {
-        this->preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preloadPagesAfter")) == 0) {
-        this->preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("eagerPageCleanup")) == 0) {
-        this->eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionBorderColor")) == 0) {
-        this->selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("selectionMarkerColor")) == 0) {
-        this->selectionMarkerColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("activeSelectionColor")) == 0) {
-        this->activeSelectionColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("backgroundColor")) == 0) {
-        this->backgroundColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addHorizontalSpace")) == 0) {
-        this->addHorizontalSpace = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addHorizontalSpaceAmount")) == 0) {
-        const int oldHorizontalAmount =
-                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
-        this->addHorizontalSpaceAmountLeft = oldHorizontalAmount;
-        this->addHorizontalSpaceAmountRight = oldHorizontalAmount;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addHorizontalSpaceAmountRight")) == 0) {
-        this->addHorizontalSpaceAmountRight =
-                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addVerticalSpace")) == 0) {
-        this->addVerticalSpace = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addVerticalSpaceAmount")) == 0) {
-        const int oldVerticalAmount =
-                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
-        this->addHorizontalSpaceAmountLeft = oldVerticalAmount;
-        this->addHorizontalSpaceAmountRight = oldVerticalAmount;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addVerticalSpaceAmountAbove")) == 0) {
-        this->addVerticalSpaceAmountAbove =
-                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addHorizontalSpaceAmountLeft")) == 0) {
-        this->addHorizontalSpaceAmountLeft =
-                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("addVerticalSpaceAmountBelow")) == 0) {
-        this->addVerticalSpaceAmountBelow =
-                static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("unlimitedScrolling")) == 0) {
-        this->unlimitedScrolling = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("drawDirModsEnabled")) == 0) {
-        this->drawDirModsEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("drawDirModsRadius")) == 0) {
-        this->drawDirModsRadius = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("snapRotation")) == 0) {
-        this->snapRotation = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("snapRotationTolerance")) == 0) {
-        this->snapRotationTolerance = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("snapGrid")) == 0) {
-        this->snapGrid = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("snapGridSize")) == 0) {
-        this->snapGridSize = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("snapGridTolerance")) == 0) {
-        this->snapGridTolerance = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeRecognizerMinSize")) == 0) {
-        this->strokeRecognizerMinSize = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("touchDrawing")) == 0) {
-        this->touchDrawing = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("gtkTouchInertialScrolling")) == 0) {
-        this->gtkTouchInertialScrolling = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("pressureGuessing")) == 0) {
-        this->pressureGuessing = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("scrollbarHideType")) == 0) {
-        if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("both")) == 0) {
-            this->scrollbarHideType = SCROLLBAR_HIDE_BOTH;
-        } else if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("horizontal")) == 0) {
-            this->scrollbarHideType = SCROLLBAR_HIDE_HORIZONTAL;
-        } else if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("vertical")) == 0) {
-            this->scrollbarHideType = SCROLLBAR_HIDE_VERTICAL;
-        } else {
-            this->scrollbarHideType = SCROLLBAR_HIDE_NONE;
-        }
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("disableScrollbarFadeout")) == 0) {
-        this->disableScrollbarFadeout = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("disableAudio")) == 0) {
-        this->disableAudio = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("audioSampleRate")) == 0) {
-        this->audioSampleRate = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("audioGain")) == 0) {
-        this->audioGain = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("defaultSeekTime")) == 0) {
-        this->defaultSeekTime = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("audioInputDevice")) == 0) {
-        this->audioInputDevice = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("audioOutputDevice")) == 0) {
-        this->audioOutputDevice = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("numIgnoredStylusEvents")) == 0) {
-        this->numIgnoredStylusEvents =
-                std::max<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10), 0);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("inputSystemTPCButton")) == 0) {
-        this->inputSystemTPCButton = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("inputSystemDrawOutsideWindow")) == 0) {
-        this->inputSystemDrawOutsideWindow = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("emptyLastPageAppend")) == 0) {
-        this->emptyLastPageAppend = emptyLastPageAppendFromString(reinterpret_cast<char*>(value));
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeFilterIgnoreTime")) == 0) {
-        this->strokeFilterIgnoreTime = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeFilterIgnoreLength")) == 0) {
-        this->strokeFilterIgnoreLength = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeFilterSuccessiveTime")) == 0) {
-        this->strokeFilterSuccessiveTime = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeFilterEnabled")) == 0) {
-        this->strokeFilterEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("doActionOnStrokeFiltered")) == 0) {
-        this->doActionOnStrokeFiltered = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("trySelectOnStrokeFiltered")) == 0) {
-        this->trySelectOnStrokeFiltered = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.autoCheckDependencies")) == 0) {
-        this->latexSettings.autoCheckDependencies = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.defaultText")) == 0) {
-        this->latexSettings.defaultText = reinterpret_cast<char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.globalTemplatePath")) == 0) {
-        std::string v(reinterpret_cast<char*>(value));
-        this->latexSettings.globalTemplatePath = fs::u8path(v);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.genCmd")) == 0) {
-        this->latexSettings.genCmd = reinterpret_cast<char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.sourceViewThemeId")) == 0) {
-        this->latexSettings.sourceViewThemeId = reinterpret_cast<char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.editorFont")) == 0) {
-        this->latexSettings.editorFont = std::string{reinterpret_cast<char*>(value)};
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.useCustomEditorFont")) == 0) {
-        this->latexSettings.useCustomEditorFont = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.editorWordWrap")) == 0) {
-        this->latexSettings.editorWordWrap = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.sourceViewAutoIndent")) == 0) {
-        this->latexSettings.sourceViewAutoIndent = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.sourceViewSyntaxHighlight")) == 0) {
-        this->latexSettings.sourceViewSyntaxHighlight = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("latexSettings.sourceViewShowLineNumbers")) == 0) {
-        this->latexSettings.sourceViewShowLineNumbers = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("snapRecognizedShapesEnabled")) == 0) {
-        this->snapRecognizedShapesEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("restoreLineWidthEnabled")) == 0) {
-        this->restoreLineWidthEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preferredLocale")) == 0) {
-        this->preferredLocale = reinterpret_cast<char*>(value);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("useSpacesForTab")) == 0) {
-        this->setUseSpacesAsTab(xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("numberOfSpacesForTab")) == 0) {
-        this->setNumberOfSpacesForTab(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
-        /**
-         * Stabilizer related settings
-         */
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerAveragingMethod")) == 0) {
-        this->stabilizerAveragingMethod =
-                (StrokeStabilizer::AveragingMethod)g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerPreprocessor")) == 0) {
-        this->stabilizerPreprocessor =
-                (StrokeStabilizer::Preprocessor)g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerBuffersize")) == 0) {
-        this->stabilizerBuffersize = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerSigma")) == 0) {
-        this->stabilizerSigma = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerDeadzoneRadius")) == 0) {
-        this->stabilizerDeadzoneRadius = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerDrag")) == 0) {
-        this->stabilizerDrag = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerMass")) == 0) {
-        this->stabilizerMass = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerCuspDetection")) == 0) {
-        this->stabilizerCuspDetection = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
-    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("stabilizerFinalizeStroke")) == 0) {
-        this->stabilizerFinalizeStroke = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    // The settings are looked up by name, instead of comparing the name with each of them in turn
+    static const std::unordered_map<std::string_view, void (*)(Settings& s, xmlChar* value)> parsers = {
+            // TODO(fabian): remove this typo fix in 2-3 release cycles
+            {"presureSensitivity", [](Settings& s, xmlChar* value) {
+                 s.pressureSensitivity = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"pressureSensitivity", [](Settings& s, xmlChar* value) {
+                 s.pressureSensitivity = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"minimumPressure", [](Settings& s, xmlChar* value) {
+                 // std::max is for backwards compatibility for users who might have set this value too small
+                 s.minimumPressure = std::max(0.01, g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr));
+             }},
+            {"pressureMultiplier", [](Settings& s, xmlChar* value) {
+                 s.pressureMultiplier = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"zoomGesturesEnabled", [](Settings& s, xmlChar* value) {
+                 s.zoomGesturesEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"selectedToolbar", [](Settings& s, xmlChar* value) {
+                 s.selectedToolbar = reinterpret_cast<const char*>(value);
+             }},
+            {"lastSavePath", [](Settings& s, xmlChar* value) {
+                 s.lastSavePath = fs::u8path(reinterpret_cast<const char*>(value));
+             }},
+            {"lastOpenPath", [](Settings& s, xmlChar* value) {
+                 s.lastOpenPath = fs::u8path(reinterpret_cast<const char*>(value));
+             }},
+            {"lastImagePath", [](Settings& s, xmlChar* value) {
+                 s.lastImagePath = fs::u8path(reinterpret_cast<const char*>(value));
+             }},
+            {"edgePanSpeed", [](Settings& s, xmlChar* value) {
+                 s.edgePanSpeed = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"edgePanMaxMult", [](Settings& s, xmlChar* value) {
+                 s.edgePanMaxMult = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"zoomStep", [](Settings& s, xmlChar* value) {
+                 s.zoomStep = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"zoomStepScroll", [](Settings& s, xmlChar* value) {
+                 s.zoomStepScroll = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"displayDpi", [](Settings& s, xmlChar* value) {
+                 s.displayDpi = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"mainWndWidth", [](Settings& s, xmlChar* value) {
+                 s.mainWndWidth = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"mainWndHeight", [](Settings& s, xmlChar* value) {
+                 s.mainWndHeight = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"maximized", [](Settings& s, xmlChar* value) {
+                 s.maximized = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"showToolbar", [](Settings& s, xmlChar* value) {
+                 s.showToolbar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"filepathShownInTitlebar", [](Settings& s, xmlChar* value) {
+                 s.filepathShownInTitlebar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"pageNumberShownInTitlebar", [](Settings& s, xmlChar* value) {
+                 s.pageNumberShownInTitlebar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"showSidebar", [](Settings& s, xmlChar* value) {
+                 s.showSidebar = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"sidebarNumberingStyle", [](Settings& s, xmlChar* value) {
+                 int num = std::stoi(reinterpret_cast<char*>(value));
+                 if (num < static_cast<int>(SidebarNumberingStyle::MIN) ||
+                     static_cast<int>(SidebarNumberingStyle::MAX) < num) {
+                     num = static_cast<int>(SidebarNumberingStyle::DEFAULT);
+                     g_warning("Settings::Invalid sidebarNumberingStyle value. Reset to default.");
+                 }
+                 s.sidebarNumberingStyle = static_cast<SidebarNumberingStyle>(num);
+             }},
+            {"sidebarWidth", [](Settings& s, xmlChar* value) {
+                 s.sidebarWidth = std::max<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10), 50);
+             }},
+            {"sidebarOnRight", [](Settings& s, xmlChar* value) {
+                 s.sidebarOnRight = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"scrollbarOnLeft", [](Settings& s, xmlChar* value) {
+                 s.scrollbarOnLeft = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"menubarVisible", [](Settings& s, xmlChar* value) {
+                 s.menubarVisible = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"numColumns", [](Settings& s, xmlChar* value) {
+                 s.numColumns = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"numRows", [](Settings& s, xmlChar* value) {
+                 s.numRows = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"viewFixedRows", [](Settings& s, xmlChar* value) {
+                 s.viewFixedRows = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"layoutVertical", [](Settings& s, xmlChar* value) {
+                 s.layoutVertical = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"layoutRightToLeft", [](Settings& s, xmlChar* value) {
+                 s.layoutRightToLeft = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"layoutBottomToTop", [](Settings& s, xmlChar* value) {
+                 s.layoutBottomToTop = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"showPairedPages", [](Settings& s, xmlChar* value) {
+                 s.showPairedPages = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"numPairsOffset", [](Settings& s, xmlChar* value) {
+                 s.numPairsOffset = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"presentationMode", [](Settings& s, xmlChar* value) {
+                 s.presentationMode = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"autoloadMostRecent", [](Settings& s, xmlChar* value) {
+                 s.autoloadMostRecent = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"autoloadPdfXoj", [](Settings& s, xmlChar* value) {
+                 s.autoloadPdfXoj = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"stylusCursorType", [](Settings& s, xmlChar* value) {
+                 s.stylusCursorType = stylusCursorTypeFromString(reinterpret_cast<const char*>(value));
+             }},
+            {"eraserVisibility", [](Settings& s, xmlChar* value) {
+                 s.eraserVisibility = eraserVisibilityFromString(reinterpret_cast<const char*>(value));
+             }},
+            {"iconTheme", [](Settings& s, xmlChar* value) {
+                 s.iconTheme = iconThemeFromString(reinterpret_cast<const char*>(value));
+             }},
+            {"themeVariant", [](Settings& s, xmlChar* value) {
+                 s.themeVariant = themeVariantFromString(reinterpret_cast<const char*>(value));
+             }},
+            {"highlightPosition", [](Settings& s, xmlChar* value) {
+                 s.highlightPosition = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"cursorHighlightColor", [](Settings& s, xmlChar* value) {
+                 s.cursorHighlightColor = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"cursorHighlightRadius", [](Settings& s, xmlChar* value) {
+                 s.cursorHighlightRadius = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"cursorHighlightBorderColor", [](Settings& s, xmlChar* value) {
+                 s.cursorHighlightBorderColor = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"cursorHighlightBorderWidth", [](Settings& s, xmlChar* value) {
+                 s.cursorHighlightBorderWidth = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"useStockIcons", [](Settings& s, xmlChar* value) {
+                 s.useStockIcons = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"defaultSaveName", [](Settings& s, xmlChar* value) {
+                 s.defaultSaveName = reinterpret_cast<const char*>(value);
+             }},
+            {"defaultPdfExportName", [](Settings& s, xmlChar* value) {
+                 s.defaultPdfExportName = reinterpret_cast<const char*>(value);
+             }},
+            {"pluginEnabled", [](Settings& s, xmlChar* value) {
+                 s.pluginEnabled = reinterpret_cast<const char*>(value);
+             }},
+            {"pluginDisabled", [](Settings& s, xmlChar* value) {
+                 s.pluginDisabled = reinterpret_cast<const char*>(value);
+             }},
+            {"pageTemplate", [](Settings& s, xmlChar* value) {
+                 s.pageTemplate = reinterpret_cast<const char*>(value);
+             }},
+            {"sizeUnit", [](Settings& s, xmlChar* value) { s.sizeUnit = reinterpret_cast<const char*>(value); }},
+            {"audioFolder", [](Settings& s, xmlChar* value) {
+                 s.audioFolder = fs::u8path(reinterpret_cast<const char*>(value));
+             }},
+            {"autosaveEnabled", [](Settings& s, xmlChar* value) {
+                 s.autosaveEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"autosaveTimeout", [](Settings& s, xmlChar* value) {
+                 s.autosaveTimeout = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"defaultViewModeAttributes", [](Settings& s, xmlChar* value) {
+                 s.viewModes.at(PresetViewModeIds::VIEW_MODE_DEFAULT) =
+                         settingsStringToViewMode(reinterpret_cast<const char*>(value));
+             }},
+            {"fullscreenViewModeAttributes", [](Settings& s, xmlChar* value) {
+                 s.viewModes.at(PresetViewModeIds::VIEW_MODE_FULLSCREEN) =
+                         settingsStringToViewMode(reinterpret_cast<const char*>(value));
+             }},
+            {"presentationViewModeAttributes", [](Settings& s, xmlChar* value) {
+                 s.viewModes.at(PresetViewModeIds::VIEW_MODE_PRESENTATION) =
+                         settingsStringToViewMode(reinterpret_cast<const char*>(value));
+             }},
+            {"touchZoomStartThreshold", [](Settings& s, xmlChar* value) {
+                 s.touchZoomStartThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"touchKineticScrolling", [](Settings& s, xmlChar* value) {
+                 s.touchKineticScrolling = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"pageRerenderThreshold", [](Settings& s, xmlChar* value) {
+                 s.pageRerenderThreshold = g_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"pdfPageCacheMemory", [](Settings& s, xmlChar* value) {
+                 s.pdfPageCacheMemory = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"preloadPagesBefore", [](Settings& s, xmlChar* value) {
+                 s.preloadPagesBefore = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"preloadPagesAfter", [](Settings& s, xmlChar* value) {
+                 s.preloadPagesAfter = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"eagerPageCleanup", [](Settings& s, xmlChar* value) {
+                 s.eagerPageCleanup = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"lazyPageLoading", [](Settings& s, xmlChar* value) {
+                 s.lazyPageLoading = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"binaryStrokeEncoding", [](Settings& s, xmlChar* value) {
+                 s.binaryStrokeEncoding = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"compactStrokeStorage", [](Settings& s, xmlChar* value) {
+                 s.compactStrokeStorage = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"draftRendering", [](Settings& s, xmlChar* value) {
+                 s.draftRendering = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"coalesceRepaints", [](Settings& s, xmlChar* value) {
+                 s.coalesceRepaints = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"blitOnScroll", [](Settings& s, xmlChar* value) {
+                 s.blitOnScroll = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"renderWorkerCount", [](Settings& s, xmlChar* value) {
+                 s.renderWorkerCount = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"pageBufferMemoryBudget", [](Settings& s, xmlChar* value) {
+                 s.pageBufferMemoryBudget = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"previewUpdateDelay", [](Settings& s, xmlChar* value) {
+                 s.previewUpdateDelay = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"printLookAhead", [](Settings& s, xmlChar* value) {
+                 s.printLookAhead = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"selectionBorderColor", [](Settings& s, xmlChar* value) {
+                 s.selectionBorderColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"selectionMarkerColor", [](Settings& s, xmlChar* value) {
+                 s.selectionMarkerColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"activeSelectionColor", [](Settings& s, xmlChar* value) {
+                 s.activeSelectionColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"backgroundColor", [](Settings& s, xmlChar* value) {
+                 s.backgroundColor = Color(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"addHorizontalSpace", [](Settings& s, xmlChar* value) {
+                 s.addHorizontalSpace = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"addHorizontalSpaceAmount", [](Settings& s, xmlChar* value) {
+                 const int oldHorizontalAmount =
+                         static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
+                 s.addHorizontalSpaceAmountLeft = oldHorizontalAmount;
+                 s.addHorizontalSpaceAmountRight = oldHorizontalAmount;
+             }},
+            {"addHorizontalSpaceAmountRight", [](Settings& s, xmlChar* value) {
+                 s.addHorizontalSpaceAmountRight =
+                         static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"addVerticalSpace", [](Settings& s, xmlChar* value) {
+                 s.addVerticalSpace = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"addVerticalSpaceAmount", [](Settings& s, xmlChar* value) {
+                 const int oldVerticalAmount =
+                         static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
+                 s.addHorizontalSpaceAmountLeft = oldVerticalAmount;
+                 s.addHorizontalSpaceAmountRight = oldVerticalAmount;
+             }},
+            {"addVerticalSpaceAmountAbove", [](Settings& s, xmlChar* value) {
+                 s.addVerticalSpaceAmountAbove =
+                         static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"addHorizontalSpaceAmountLeft", [](Settings& s, xmlChar* value) {
+                 s.addHorizontalSpaceAmountLeft =
+                         static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"addVerticalSpaceAmountBelow", [](Settings& s, xmlChar* value) {
+                 s.addVerticalSpaceAmountBelow =
+                         static_cast<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"unlimitedScrolling", [](Settings& s, xmlChar* value) {
+                 s.unlimitedScrolling = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"drawDirModsEnabled", [](Settings& s, xmlChar* value) {
+                 s.drawDirModsEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"drawDirModsRadius", [](Settings& s, xmlChar* value) {
+                 s.drawDirModsRadius = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"snapRotation", [](Settings& s, xmlChar* value) {
+                 s.snapRotation = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"snapRotationTolerance", [](Settings& s, xmlChar* value) {
+                 s.snapRotationTolerance = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"snapGrid", [](Settings& s, xmlChar* value) {
+                 s.snapGrid = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"snapGridSize", [](Settings& s, xmlChar* value) {
+                 s.snapGridSize = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"snapGridTolerance", [](Settings& s, xmlChar* value) {
+                 s.snapGridTolerance = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"snapObjects", [](Settings& s, xmlChar* value) {
+                 s.snapObjects = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"snapObjectsTolerance", [](Settings& s, xmlChar* value) {
+                 s.snapObjectsTolerance = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"strokeRecognizerMinSize", [](Settings& s, xmlChar* value) {
+                 s.strokeRecognizerMinSize = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"touchDrawing", [](Settings& s, xmlChar* value) {
+                 s.touchDrawing = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"gtkTouchInertialScrolling", [](Settings& s, xmlChar* value) {
+                 s.gtkTouchInertialScrolling = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"pressureGuessing", [](Settings& s, xmlChar* value) {
+                 s.pressureGuessing = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"scrollbarHideType", [](Settings& s, xmlChar* value) {
+                 if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("both")) == 0) {
+                     s.scrollbarHideType = SCROLLBAR_HIDE_BOTH;
+                 } else if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("horizontal")) == 0) {
+                     s.scrollbarHideType = SCROLLBAR_HIDE_HORIZONTAL;
+                 } else if (xmlStrcmp(value, reinterpret_cast<const xmlChar*>("vertical")) == 0) {
+                     s.scrollbarHideType = SCROLLBAR_HIDE_VERTICAL;
+                 } else {
+                     s.scrollbarHideType = SCROLLBAR_HIDE_NONE;
+                 }
+             }},
+            {"disableScrollbarFadeout", [](Settings& s, xmlChar* value) {
+                 s.disableScrollbarFadeout = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"disableAudio", [](Settings& s, xmlChar* value) {
+                 s.disableAudio = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"audioSampleRate", [](Settings& s, xmlChar* value) {
+                 s.audioSampleRate = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"audioGain", [](Settings& s, xmlChar* value) {
+                 s.audioGain = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"defaultSeekTime", [](Settings& s, xmlChar* value) {
+                 s.defaultSeekTime = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"audioInputDevice", [](Settings& s, xmlChar* value) {
+                 s.audioInputDevice = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"audioOutputDevice", [](Settings& s, xmlChar* value) {
+                 s.audioOutputDevice = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"keepAudioOutputOpen", [](Settings& s, xmlChar* value) {
+                 s.keepAudioOutputOpen = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"numIgnoredStylusEvents", [](Settings& s, xmlChar* value) {
+                 s.numIgnoredStylusEvents =
+                         std::max<int>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10), 0);
+             }},
+            {"inputSystemTPCButton", [](Settings& s, xmlChar* value) {
+                 s.inputSystemTPCButton = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"inputSystemDrawOutsideWindow", [](Settings& s, xmlChar* value) {
+                 s.inputSystemDrawOutsideWindow = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"emptyLastPageAppend", [](Settings& s, xmlChar* value) {
+                 s.emptyLastPageAppend = emptyLastPageAppendFromString(reinterpret_cast<char*>(value));
+             }},
+            {"strokeFilterIgnoreTime", [](Settings& s, xmlChar* value) {
+                 s.strokeFilterIgnoreTime = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"strokeFilterIgnoreLength", [](Settings& s, xmlChar* value) {
+                 s.strokeFilterIgnoreLength = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"strokeFilterSuccessiveTime", [](Settings& s, xmlChar* value) {
+                 s.strokeFilterSuccessiveTime = g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"strokeFilterEnabled", [](Settings& s, xmlChar* value) {
+                 s.strokeFilterEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"doActionOnStrokeFiltered", [](Settings& s, xmlChar* value) {
+                 s.doActionOnStrokeFiltered = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"trySelectOnStrokeFiltered", [](Settings& s, xmlChar* value) {
+                 s.trySelectOnStrokeFiltered = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.autoCheckDependencies", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.autoCheckDependencies =
+                         xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.defaultText", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.defaultText = reinterpret_cast<char*>(value);
+             }},
+            {"latexSettings.globalTemplatePath", [](Settings& s, xmlChar* value) {
+                 std::string v(reinterpret_cast<char*>(value));
+                 s.latexSettings.globalTemplatePath = fs::u8path(v);
+             }},
+            {"latexSettings.genCmd", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.genCmd = reinterpret_cast<char*>(value);
+             }},
+            {"latexSettings.precompilePreamble", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.precompilePreamble = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.sourceViewThemeId", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.sourceViewThemeId = reinterpret_cast<char*>(value);
+             }},
+            {"latexSettings.editorFont", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.editorFont = std::string{reinterpret_cast<char*>(value)};
+             }},
+            {"latexSettings.useCustomEditorFont", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.useCustomEditorFont = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.editorWordWrap", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.editorWordWrap = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.sourceViewAutoIndent", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.sourceViewAutoIndent = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.sourceViewSyntaxHighlight", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.sourceViewSyntaxHighlight =
+                         xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"latexSettings.sourceViewShowLineNumbers", [](Settings& s, xmlChar* value) {
+                 s.latexSettings.sourceViewShowLineNumbers =
+                         xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"snapRecognizedShapesEnabled", [](Settings& s, xmlChar* value) {
+                 s.snapRecognizedShapesEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"restoreLineWidthEnabled", [](Settings& s, xmlChar* value) {
+                 s.restoreLineWidthEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"preferredLocale", [](Settings& s, xmlChar* value) {
+                 s.preferredLocale = reinterpret_cast<char*>(value);
+             }},
+            {"useSpacesForTab", [](Settings& s, xmlChar* value) {
+                 s.setUseSpacesAsTab(xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0);
+             }},
+            {"numberOfSpacesForTab", [](Settings& s, xmlChar* value) {
+                 s.setNumberOfSpacesForTab(g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            /**
+             * Stabilizer related settings
+             */
+            {"stabilizerAveragingMethod", [](Settings& s, xmlChar* value) {
+                 s.stabilizerAveragingMethod =
+                         (StrokeStabilizer::AveragingMethod)g_ascii_strtoll(reinterpret_cast<const char*>(value),
+                                                                               nullptr, 10);
+             }},
+            {"stabilizerPreprocessor", [](Settings& s, xmlChar* value) {
+                 s.stabilizerPreprocessor =
+                         (StrokeStabilizer::Preprocessor)g_ascii_strtoll(reinterpret_cast<const char*>(value),
+                                                                               nullptr, 10);
+             }},
+            {"stabilizerBuffersize", [](Settings& s, xmlChar* value) {
+                 s.stabilizerBuffersize = g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10);
+             }},
+            {"stabilizerSigma", [](Settings& s, xmlChar* value) {
+                 s.stabilizerSigma = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"stabilizerDeadzoneRadius", [](Settings& s, xmlChar* value) {
+                 s.stabilizerDeadzoneRadius = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"stabilizerDrag", [](Settings& s, xmlChar* value) {
+                 s.stabilizerDrag = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"stabilizerMass", [](Settings& s, xmlChar* value) {
+                 s.stabilizerMass = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+            {"stabilizerCuspDetection", [](Settings& s, xmlChar* value) {
+                 s.stabilizerCuspDetection = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"stabilizerFinalizeStroke", [](Settings& s, xmlChar* value) {
+                 s.stabilizerFinalizeStroke = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"inkPrediction", [](Settings& s, xmlChar* value) {
+                 s.inkPrediction = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"inkPredictionTime", [](Settings& s, xmlChar* value) {
+                 s.inkPredictionTime = static_cast<unsigned int>(
+                         g_ascii_strtoull(reinterpret_cast<const char*>(value), nullptr, 10));
+             }},
+            {"inkDecimation", [](Settings& s, xmlChar* value) {
+                 s.inkDecimation = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+             }},
+            {"inkDecimationError", [](Settings& s, xmlChar* value) {
+                 s.inkDecimationError = tempg_ascii_strtod(reinterpret_cast<const char*>(value), nullptr);
+             }},
+    };
+
+    if (auto it = parsers.find(reinterpret_cast<const char*>(name)); it != parsers.end()) {
+        it->second(*this, value);
     }
-    /**/
 
     xmlFree(name);
     xmlFree(value);
@@ -771,7 +992,7 @@ auto Settings::load() -> bool {
 
     if (!fs::exists(filepath)) {
         g_warning("Settings file %s does not exist. Regenerating. ", filepath.string().c_str());
-        save();
+        write();
     }
 
     xmlDocPtr doc = xmlParseFile(filepath.u8string().c_str());
@@ -934,9 +1155,31 @@ void Settings::transactionEnd() {
 }
 
 void Settings::save() {
-    if (inTransaction) {
+    this->dirty = true;
+    if (inTransaction || this->saveTimeout != 0) {
         return;
     }
+    this->saveTimeout = g_timeout_add_seconds(SAVE_DELAY, xoj::util::wrap_v<saveCallback>, this);
+}
+
+auto Settings::saveCallback(Settings* settings) -> bool {
+    settings->saveTimeout = 0;
+    settings->flush();
+    return false;
+}
+
+void Settings::flush() {
+    if (this->saveTimeout != 0) {
+        g_source_remove(this->saveTimeout);
+        this->saveTimeout = 0;
+    }
+    if (this->dirty) {
+        write();
+    }
+}
+
+void Settings::write() {
+    this->dirty = false;
 
     xmlDocPtr doc = nullptr;
     xmlNodePtr root = nullptr;
@@ -1080,6 +1323,8 @@ void Settings::save() {
     SAVE_BOOL_PROP(snapGrid);
     SAVE_DOUBLE_PROP(snapGridTolerance);
     SAVE_DOUBLE_PROP(snapGridSize);
+    SAVE_BOOL_PROP(snapObjects);
+    SAVE_DOUBLE_PROP(snapObjectsTolerance);
 
     SAVE_DOUBLE_PROP(strokeRecognizerMinSize);
 
@@ -1093,13 +1338,30 @@ void Settings::save() {
     xmlNode = savePropertyUnsigned("activeSelectionColor", uint32_t(activeSelectionColor), root);
 
     SAVE_DOUBLE_PROP(touchZoomStartThreshold);
+    SAVE_BOOL_PROP(touchKineticScrolling);
     SAVE_DOUBLE_PROP(pageRerenderThreshold);
 
-    SAVE_INT_PROP(pdfPageCacheSize);
-    ATTACH_COMMENT("The count of rendered PDF pages which will be cached.");
+    SAVE_UINT_PROP(pdfPageCacheMemory);
+    ATTACH_COMMENT("The memory (in MiB) the rendered PDF pages may use in a cache.");
     SAVE_UINT_PROP(preloadPagesBefore);
     SAVE_UINT_PROP(preloadPagesAfter);
     SAVE_BOOL_PROP(eagerPageCleanup);
+    SAVE_BOOL_PROP(lazyPageLoading);
+    SAVE_BOOL_PROP(binaryStrokeEncoding);
+    SAVE_BOOL_PROP(compactStrokeStorage);
+    SAVE_BOOL_PROP(draftRendering);
+    SAVE_BOOL_PROP(coalesceRepaints);
+    ATTACH_COMMENT("Repaint the areas rendered in the background once per frame, all together.");
+    SAVE_BOOL_PROP(blitOnScroll);
+    ATTACH_COMMENT("When scrolling, reuse what was drawn and only paint the newly visible strip.");
+    SAVE_UINT_PROP(renderWorkerCount);
+    ATTACH_COMMENT("The number of threads rendering pages. 0 means automatic.");
+    SAVE_UINT_PROP(pageBufferMemoryBudget);
+    ATTACH_COMMENT("The memory budget (in MiB) of the buffers of the displayed pages.");
+    SAVE_UINT_PROP(previewUpdateDelay);
+    ATTACH_COMMENT("The delay (in ms) before the sidebar previews of the changed pages are updated.");
+    SAVE_UINT_PROP(printLookAhead);
+    ATTACH_COMMENT("The number of pages rendered in the background ahead of the page being printed.");
 
     SAVE_STRING_PROP(pageTemplate);
     ATTACH_COMMENT("Config for new pages");
@@ -1111,6 +1373,7 @@ void Settings::save() {
     }
     SAVE_INT_PROP(audioInputDevice);
     SAVE_INT_PROP(audioOutputDevice);
+    SAVE_BOOL_PROP(keepAudioOutputOpen);
     SAVE_DOUBLE_PROP(audioSampleRate);
     SAVE_DOUBLE_PROP(audioGain);
     SAVE_INT_PROP(defaultSeekTime);
@@ -1152,6 +1415,11 @@ void Settings::save() {
     SAVE_BOOL_PROP(stabilizerFinalizeStroke);
     /**/
 
+    SAVE_BOOL_PROP(inkPrediction);
+    SAVE_UINT_PROP(inkPredictionTime);
+    SAVE_BOOL_PROP(inkDecimation);
+    SAVE_DOUBLE_PROP(inkDecimationError);
+
     SAVE_BOOL_PROP(latexSettings.autoCheckDependencies);
     SAVE_STRING_PROP(latexSettings.defaultText);
     // Inline SAVE_STRING_PROP(latexSettings.globalTemplatePath) since it
@@ -1160,6 +1428,7 @@ void Settings::save() {
     fs::path& p = latexSettings.globalTemplatePath;
     xmlNode = saveProperty("latexSettings.globalTemplatePath", p.empty() ? "" : p.u8string().c_str(), root);
     SAVE_STRING_PROP(latexSettings.genCmd);
+    SAVE_BOOL_PROP(latexSettings.precompilePreamble);
     SAVE_STRING_PROP(latexSettings.sourceViewThemeId);
     SAVE_FONT_PROP(latexSettings.editorFont);
     SAVE_BOOL_PROP(latexSettings.useCustomEditorFont);
@@ -1570,6 +1839,24 @@ void Settings::setSnapGridSize(double gridSize) {
     save();
 }
 
+auto Settings::isSnapObjects() const -> bool { return this->snapObjects; }
+
+void Settings::setSnapObjects(bool b) {
+    if (this->snapObjects == b) {
+        return;
+    }
+
+    this->snapObjects = b;
+    save();
+}
+
+auto Settings::getSnapObjectsTolerance() const -> double { return this->snapObjectsTolerance; }
+
+void Settings::setSnapObjectsTolerance(double tolerance) {
+    this->snapObjectsTolerance = tolerance;
+    save();
+}
+
 auto Settings::getStrokeRecognizerMinSize() const -> double { return this->strokeRecognizerMinSize; };
 void Settings::setStrokeRecognizerMinSize(double value) {
     if (this->strokeRecognizerMinSize == value) {
@@ -2053,6 +2340,16 @@ void Settings::setTouchZoomStartThreshold(double threshold) {
     save();
 }
 
+auto Settings::isTouchKineticScrolling() const -> bool { return this->touchKineticScrolling; }
+
+void Settings::setTouchKineticScrolling(bool v) {
+    if (this->touchKineticScrolling == v) {
+        return;
+    }
+    this->touchKineticScrolling = v;
+    save();
+}
+
 
 auto Settings::getPDFPageRerenderThreshold() const -> double { return this->pageRerenderThreshold; }
 void Settings::setPDFPageRerenderThreshold(double threshold) {
@@ -2064,13 +2361,13 @@ void Settings::setPDFPageRerenderThreshold(double threshold) {
     save();
 }
 
-auto Settings::getPdfPageCacheSize() const -> int { return this->pdfPageCacheSize; }
+auto Settings::getPdfPageCacheMemory() const -> unsigned int { return this->pdfPageCacheMemory; }
 
-void Settings::setPdfPageCacheSize(int size) {
-    if (this->pdfPageCacheSize == size) {
+void Settings::setPdfPageCacheMemory(unsigned int mib) {
+    if (this->pdfPageCacheMemory == mib) {
         return;
     }
-    this->pdfPageCacheSize = size;
+    this->pdfPageCacheMemory = mib;
     save();
 }
 
@@ -2104,6 +2401,106 @@ void Settings::setEagerPageCleanup(bool b) {
     save();
 }
 
+auto Settings::isLazyPageLoading() const -> bool { return this->lazyPageLoading; }
+
+void Settings::setLazyPageLoading(bool v) {
+    if (this->lazyPageLoading == v) {
+        return;
+    }
+    this->lazyPageLoading = v;
+    save();
+}
+
+auto Settings::isBinaryStrokeEncoding() const -> bool { return this->binaryStrokeEncoding; }
+
+void Settings::setBinaryStrokeEncoding(bool v) {
+    if (this->binaryStrokeEncoding == v) {
+        return;
+    }
+    this->binaryStrokeEncoding = v;
+    save();
+}
+
+auto Settings::isCompactStrokeStorage() const -> bool { return this->compactStrokeStorage; }
+
+void Settings::setCompactStrokeStorage(bool v) {
+    if (this->compactStrokeStorage == v) {
+        return;
+    }
+    this->compactStrokeStorage = v;
+    save();
+}
+
+auto Settings::isDraftRendering() const -> bool { return this->draftRendering; }
+
+void Settings::setDraftRendering(bool v) {
+    if (this->draftRendering == v) {
+        return;
+    }
+    this->draftRendering = v;
+    save();
+}
+
+auto Settings::isCoalesceRepaints() const -> bool { return this->coalesceRepaints; }
+
+void Settings::setCoalesceRepaints(bool v) {
+    if (this->coalesceRepaints == v) {
+        return;
+    }
+    this->coalesceRepaints = v;
+    save();
+}
+
+auto Settings::isBlitOnScroll() const -> bool { return this->blitOnScroll; }
+
+void Settings::setBlitOnScroll(bool v) {
+    if (this->blitOnScroll == v) {
+        return;
+    }
+    this->blitOnScroll = v;
+    save();
+}
+
+auto Settings::getRenderWorkerCount() const -> unsigned int { return this->renderWorkerCount; }
+
+void Settings::setRenderWorkerCount(unsigned int v) {
+    if (this->renderWorkerCount == v) {
+        return;
+    }
+    this->renderWorkerCount = v;
+    save();
+}
+
+auto Settings::getPageBufferMemoryBudget() const -> unsigned int { return this->pageBufferMemoryBudget; }
+
+void Settings::setPageBufferMemoryBudget(unsigned int v) {
+    if (this->pageBufferMemoryBudget == v) {
+        return;
+    }
+    this->pageBufferMemoryBudget = v;
+    save();
+}
+
+auto Settings::getPreviewUpdateDelay() const -> unsigned int { return this->previewUpdateDelay; }
+
+void Settings::setPreviewUpdateDelay(unsigned int v) {
+    if (this->previewUpdateDelay == v) {
+        return;
+    }
+    this->previewUpdateDelay = v;
+    save();
+}
+
+auto Settings::getPrintLookAhead() const -> unsigned int { return this->printLookAhead; }
+
+void Settings::setPrintLookAhead(unsigned int v) {
+    if (this->printLookAhead == v) {
+        return;
+    }
+    this->printLookAhead = v;
+    save();
+}
+
 auto Settings::getBorderColor() const -> Color { return this->selectionBorderColor; }
 
 void Settings::setBorderColor(Color color) {
@@ -2172,6 +2569,16 @@ void Settings::setAudioOutputDevice(PaDeviceIndex deviceIndex) {
     save();
 }
 
+auto Settings::isKeepAudioOutputOpen() const -> bool { return this->keepAudioOutputOpen; }
+
+void Settings::setKeepAudioOutputOpen(bool keep) {
+    if (this->keepAudioOutputOpen == keep) {
+        return;
+    }
+    this->keepAudioOutputOpen = keep;
+    save();
+}
+
 auto Settings::getAudioSampleRate() const -> double { return this->audioSampleRate; }
 
 void Settings::setAudioSampleRate(double sampleRate) {
@@ -2590,6 +2997,46 @@ void Settings::setStabilizerPreprocessor(StrokeStabilizer::Preprocessor preproce
     save();
 }
 
+auto Settings::isInkPrediction() const -> bool { return inkPrediction; }
+
+void Settings::setInkPrediction(bool enabled) {
+    if (inkPrediction == enabled) {
+        return;
+    }
+    inkPrediction = enabled;
+    save();
+}
+
+auto Settings::getInkPredictionTime() const -> unsigned int { return inkPredictionTime; }
+
+void Settings::setInkPredictionTime(unsigned int ms) {
+    if (inkPredictionTime == ms) {
+        return;
+    }
+    inkPredictionTime = ms;
+    save();
+}
+
+auto Settings::isInkDecimation() const -> bool { return inkDecimation; }
+
+void Settings::setInkDecimation(bool enabled) {
+    if (inkDecimation == enabled) {
+        return;
+    }
+    inkDecimation = enabled;
+    save();
+}
+
+auto Settings::getInkDecimationError() const -> double { return inkDecimationError; }
+
+void Settings::setInkDecimationError(double pixels) {
+    if (inkDecimationError == pixels) {
+        return;
+    }
+    inkDecimationError = pixels;
+    save();
+}
+
 /**
  * @brief Get Color Palette used for Tools
  *
@@ -104,12 +104,29 @@ public:
     bool load();
     void parseData(xmlNodePtr cur, SElement& elem);
 
+    /**
+     * Schedule the settings to be written. The changes made until then are written together.
+     */
     void save();
 
+    /**
+     * Write the settings now, if they changed since the last time they were written
+     */
+    void flush();
+
+    /// Delay, in seconds, between a change and the settings being written
+    static constexpr guint SAVE_DELAY = 2;
+
 private:
     void loadDefault();
     void parseItem(xmlDocPtr doc, xmlNodePtr cur);
 
+    /**
+     * Write the settings file
+     */
+    void write();
+    static bool saveCallback(Settings* settings);
+
     static xmlNodePtr savePropertyDouble(const gchar* key, double value, xmlNodePtr parent);
     static xmlNodePtr saveProperty(const gchar* key, int value, xmlNodePtr parent);
     static xmlNodePtr savePropertyUnsigned(const gchar* key, unsigned int value, xmlNodePtr parent);
@@ -316,6 +333,11 @@ public:
     double getSnapGridSize() const;
     void setSnapGridSize(double gridSize);
 
+    bool isSnapObjects() const;
+    void setSnapObjects(bool b);
+    double getSnapObjectsTolerance() const;
+    void setSnapObjectsTolerance(double tolerance);
+
     double getStrokeRecognizerMinSize() const;
     void setStrokeRecognizerMinSize(double value);
 
@@ -387,8 +409,14 @@ public:
     double getTouchZoomStartThreshold() const;
     void setTouchZoomStartThreshold(double threshold);
 
-    int getPdfPageCacheSize() const;
-    [[maybe_unused]] void setPdfPageCacheSize(int size);
+    bool isTouchKineticScrolling() const;
+    void setTouchKineticScrolling(bool v);
+
+    /**
+     * Memory budget of each PDF page cache, in MiB
+     */
+    unsigned int getPdfPageCacheMemory() const;
+    [[maybe_unused]] void setPdfPageCacheMemory(unsigned int mib);
 
     unsigned int getPreloadPagesBefore() const;
     void setPreloadPagesBefore(unsigned int n);
@@ -399,6 +427,36 @@ public:
     bool isEagerPageCleanup() const;
     void setEagerPageCleanup(bool b);
 
+    bool isLazyPageLoading() const;
+    void setLazyPageLoading(bool v);
+
+    bool isBinaryStrokeEncoding() const;
+    void setBinaryStrokeEncoding(bool v);
+
+    bool isCompactStrokeStorage() const;
+    void setCompactStrokeStorage(bool v);
+
+    bool isDraftRendering() const;
+    void setDraftRendering(bool v);
+
+    bool isCoalesceRepaints() const;
+    void setCoalesceRepaints(bool v);
+
+    bool isBlitOnScroll() const;
+    void setBlitOnScroll(bool v);
+
+    unsigned int getRenderWorkerCount() const;
+    void setRenderWorkerCount(unsigned int v);
+
+    unsigned int getPageBufferMemoryBudget() const;
+    void setPageBufferMemoryBudget(unsigned int v);
+
+    unsigned int getPreviewUpdateDelay() const;
+    void setPreviewUpdateDelay(unsigned int v);
+
+    unsigned int getPrintLookAhead() const;
+    void setPrintLookAhead(unsigned int v);
+
     std::string const& getPageTemplate() const;
     void setPageTemplate(const std::string& pageTemplate);
 
@@ -413,6 +471,9 @@ public:
     PaDeviceIndex getAudioOutputDevice() const;
     void setAudioOutputDevice(PaDeviceIndex deviceIndex);
 
+    bool isKeepAudioOutputOpen() const;
+    void setKeepAudioOutputOpen(bool keep);
+
     double getAudioSampleRate() const;
     void setAudioSampleRate(double sampleRate);
 
@@ -566,6 +627,15 @@ public:
     void setStabilizerAveragingMethod(StrokeStabilizer::AveragingMethod averagingMethod);
     void setStabilizerPreprocessor(StrokeStabilizer::Preprocessor preprocessor);
 
+    bool isInkPrediction() const;
+    void setInkPrediction(bool enabled);
+    unsigned int getInkPredictionTime() const;
+    void setInkPredictionTime(unsigned int ms);
+    bool isInkDecimation() const;
+    void setInkDecimation(bool enabled);
+    double getInkDecimationError() const;
+    void setInkDecimationError(double pixels);
+
     const Palette& getColorPalette();
 
     void setNumberOfSpacesForTab(unsigned int numberSpaces);
@@ -932,6 +1002,11 @@ private:
      */
     bool snapGrid{};
 
+    /**
+     * snapping to the endpoints and corners of the strokes on the page
+     */
+    bool snapObjects{};
+
     /**
      * Default name if you save a new document
      */
@@ -951,9 +1026,9 @@ private:
     std::vector<ViewMode> viewModes;
 
     /**
-     *  The count of pages which will be cached
+     *  The memory (in MiB) the rendered PDF pages may use in a cache
      */
-    int pdfPageCacheSize{};
+    unsigned int pdfPageCacheMemory{};
 
     /**
      *  Percentage by which the page's zoom must change
@@ -968,6 +1043,11 @@ private:
      */
     double touchZoomStartThreshold{};
 
+    /**
+     * Keep scrolling, slowing down, when the finger leaves the screen while panning with touch
+     */
+    bool touchKineticScrolling{};
+
     /**
      * The color to draw borders on selected elements
      * (Page, insert image selection etc.)
@@ -1017,6 +1097,9 @@ private:
     /// Grid size for Snapping
     double snapGridSize{};
 
+    /// Snap tolerance for the endpoints and corners of strokes, as a fraction of the grid size (like snapGridTolerance)
+    double snapObjectsTolerance{};
+
     /**
      * Minimum size of stroke to detect shape
      */
@@ -1045,6 +1128,12 @@ private:
      */
     PaDeviceIndex audioOutputDevice{};
 
+    /**
+     * Keep the playback stream open (playing silence) and the last played audio files open while the document is
+     * open, so that the playback starts without delay
+     */
+    bool keepAudioOutputOpen{};
+
     /**
      * The sample rate used for recording
      */
@@ -1113,6 +1202,10 @@ private:
      */
     bool inTransaction{};
 
+    /// The settings changed since they were last written
+    bool dirty{};
+    guint saveTimeout{};
+
     /** The preferred locale as its language code
      * e.g. "en_US"
      */
@@ -1133,6 +1226,60 @@ private:
      */
     bool eagerPageCleanup{};
 
+    /**
+     * Read the layers of the pages from the file only when they are needed
+     */
+    bool lazyPageLoading{};
+
+    /**
+     * Save the points of the strokes in binary form, in a zip archive
+     */
+    bool binaryStrokeEncoding{};
+
+    /**
+     * Keep the points of the strokes of the inactive pages in single precision
+     */
+    bool compactStrokeStorage{};
+
+    /**
+     * Render the pages faster, in a lower quality, while the view is scrolled or zoomed. They are rendered again in
+     * full quality once the view is idle.
+     */
+    bool draftRendering{};
+
+    /**
+     * Gather the areas to repaint once rendered by the render jobs, and repaint them all at the next frame of the main
+     * view rather than one by one
+     */
+    bool coalesceRepaints{};
+
+    /**
+     * Keep what was drawn in the visible area of the main view: when scrolling, it is shifted and only the newly
+     * exposed strip is painted
+     */
+    bool blitOnScroll{};
+
+    /**
+     * The number of threads rendering pages and previews. 0 means automatic (depending on the number of processors).
+     */
+    unsigned int renderWorkerCount{};
+
+    /**
+     * Memory budget (in MiB) of the page buffers: beyond it, the least recently displayed off-screen pages are freed
+     */
+    unsigned int pageBufferMemoryBudget{};
+
+    /**
+     * Delay (in ms) between a change of a page and the update of its preview in the sidebar. The changes made in the
+     * meantime are handled by the same update.
+     */
+    unsigned int previewUpdateDelay{};
+
+    /**
+     * The number of pages rendered ahead of the page being printed
+     */
+    unsigned int printLookAhead{};
+
     /**
      * Stabilizer related settings
      */
@@ -1147,6 +1294,18 @@ private:
     StrokeStabilizer::AveragingMethod stabilizerAveragingMethod{};
     StrokeStabilizer::Preprocessor stabilizerPreprocessor{};
 
+    /**
+     * Draw the ink up to where the pen is predicted to be, inkPredictionTime ms ahead of the last event
+     */
+    bool inkPrediction{};
+    unsigned int inkPredictionTime{};
+
+    /**
+     * Drop the points of the strokes which move the ink by less than inkDecimationError device pixels
+     */
+    bool inkDecimation{};
+    double inkDecimationError{};
+
     /**
      * @brief Color Palette for tool colors
      *
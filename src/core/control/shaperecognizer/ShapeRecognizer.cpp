@@ -32,6 +32,12 @@ void ShapeRecognizer::resetRecognizer() {
     this->queueLength = 0;
 }
 
+void ShapeRecognizer::setDeadline(std::chrono::steady_clock::time_point deadline) { this->deadline = deadline; }
+
+auto ShapeRecognizer::isPastDeadline() const -> bool {
+    return this->deadline && std::chrono::steady_clock::now() > *this->deadline;
+}
+
 /**
  *  Test if segments form standard shapes
  */
@@ -117,6 +123,12 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
         return 0;
     }
 
+    // Each call computes the inertia of the whole range: long strokes may not be done in time
+    if (isPastDeadline()) {
+        RDEBUG("deadline passed");
+        return 0;
+    }
+
     if (end - start < 5) {
         nsides = 1;  // too small for a polygon
     }
@@ -343,6 +355,10 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke, double strokeMinSize) ->
         }
     }
 
+    if (isPastDeadline()) {
+        return nullptr;
+    }
+
     // not a polygon: maybe a circle ?
     auto s = CircleRecognizer::recognize(stroke);
     if (s) {
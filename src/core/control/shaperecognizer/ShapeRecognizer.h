@@ -11,8 +11,10 @@
 
 #pragma once
 
-#include <array>  // for array
+#include <array>     // for array
+#include <chrono>    // for steady_clock
 #include <memory>
+#include <optional>  // for optional
 
 #include "RecoSegment.h"
 #include "ShapeRecognizerConfig.h"  // for MAX_POLYGON_SIDES
@@ -30,6 +32,11 @@ public:
     auto recognizePatterns(Stroke* stroke, double strokeMinSize) -> std::unique_ptr<Stroke>;
     void resetRecognizer();
 
+    /**
+     * @brief Give up the recognition (i.e. recognizePatterns() returns nullptr) once the deadline is passed
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
 private:
     auto tryRectangle() -> std::unique_ptr<Stroke>;
     // function Stroke* tryArrow(); removed after commit a3f7a251282dcfea8b4de695f28ce52bf2035da2
@@ -40,9 +47,13 @@ private:
 
     static bool isStrokeLargeEnough(Stroke* stroke, double strokeMinSize);
 
+    bool isPastDeadline() const;
+
 private:
     std::array<RecoSegment, MAX_POLYGON_SIDES + 1> queue{};
     int queueLength;
 
     Stroke* stroke;
+
+    std::optional<std::chrono::steady_clock::time_point> deadline;
 };
@@ -19,6 +19,7 @@
 #include "undo/InsertUndoAction.h"                 // for InsertUndoAction
 #include "undo/UndoRedoHandler.h"                  // for UndoRedoHandler
 #include "util/Assert.h"                           // for xoj_assert
+#include "util/DamageRegion.h"                     // for DamageRegion
 #include "util/DispatchPool.h"                     // for DispatchPool
 #include "view/overlays/ShapeToolView.h"           // for ShapeToolView
 
@@ -37,8 +38,20 @@ void BaseShapeHandler::updateShape(bool isAltDown, bool isShiftDown, bool isCont
     std::swap(shape, this->shape);
     Range repaintRange = rg.unite(lastSnappingRange);
     lastSnappingRange = rg;
-    repaintRange.addPadding(0.5 * this->stroke->getWidth());
-    viewPool->dispatch(xoj::view::ShapeToolView::FLAG_DIRTY_REGION, repaintRange);
+    const double padding = 0.5 * this->stroke->getWidth();
+    if (this->stroke->getFill() != -1) {
+        // The filling changes everywhere in between
+        repaintRange.addPadding(padding);
+        viewPool->dispatch(xoj::view::ShapeToolView::FLAG_DIRTY_REGION, repaintRange);
+        return;
+    }
+    // Only repaint along the old and the new outlines (e.g. not inside an ellipse)
+    xoj::util::DamageRegion damage;
+    damage.addOutline(shape, padding);
+    damage.addOutline(this->shape, padding);
+    for (const Range& r: damage.getRanges()) {
+        viewPool->dispatch(xoj::view::ShapeToolView::FLAG_DIRTY_REGION, r);
+    }
 }
 
 void BaseShapeHandler::cancelStroke() {
@@ -123,7 +136,7 @@ void BaseShapeHandler::onButtonPressEvent(const PositionInputData& pos, double z
     this->buttonDownPoint.x = pos.x / zoom;
     this->buttonDownPoint.y = pos.y / zoom;
 
-    this->startPoint = snappingHandler.snapToGrid(this->buttonDownPoint, pos.isAltDown());
+    this->startPoint = snappingHandler.snapToObjectsOrGrid(this->buttonDownPoint, *this->page, pos.isAltDown());
     this->currPoint = this->startPoint;
 
     this->stroke = createStroke(this->control);
@@ -10,6 +10,7 @@
 #include <utility>
 
 #include <gdk/gdk.h>  // for gdk_cairo_set_sour...
+#include <gtk/gtk.h>  // for gtk_widget_add_tick_callback
 
 #include "control/Control.h"                       // for Control
 #include "control/settings/Settings.h"             // for Settings
@@ -251,6 +252,7 @@ EditSelection::EditSelection(Control* ctrl, const PageRef& page, Layer* layer, X
         snappingHandler(ctrl->getSettings()) {}
 
 EditSelection::~EditSelection() {
+    finishNudging();
     finalizeSelection();
 
     if (this->edgePanHandler) {
@@ -400,6 +402,8 @@ auto EditSelection::setFill(int alphaPen, int alphaHighligther) -> UndoActionPtr
     return this->contents->setFill(alphaPen, alphaHighligther);
 }
 
+void EditSelection::repaintContents() { this->contents->repaintContents(); }
+
 /**
  * Set the line style of all elements, return an undo action
  * (Or nullptr if nothing done)
@@ -534,6 +538,7 @@ void EditSelection::mouseUp() {
  * Handles mouse input for moving and resizing, coordinates are relative to "view"
  */
 void EditSelection::mouseDown(CursorSelectionType type, double x, double y) {
+    finishNudging();
     double zoom = this->view->getXournal()->getZoom();
 
     this->mouseDownType = type;
@@ -829,6 +834,45 @@ void EditSelection::moveSelection(double dx, double dy, bool addMoveUndo) {
     this->view->getXournal()->repaintSelection();
 }
 
+void EditSelection::nudge(double dx, double dy) {
+    this->pendingNudgeX += dx;
+    this->pendingNudgeY += dy;
+    if (this->nudgeTickCallback == 0) {
+        this->nudgeTickCallback = gtk_widget_add_tick_callback(this->view->getXournal()->getWidget(),
+                                                               applyPendingNudgeTick, this, nullptr);
+    }
+}
+
+auto EditSelection::applyPendingNudgeTick(GtkWidget*, GdkFrameClock*, gpointer self) -> gboolean {
+    auto* selection = static_cast<EditSelection*>(self);
+    selection->nudgeTickCallback = 0;
+    selection->applyPendingNudge();
+    return G_SOURCE_REMOVE;
+}
+
+void EditSelection::applyPendingNudge() {
+    if (this->pendingNudgeX == 0 && this->pendingNudgeY == 0) {
+        return;
+    }
+    moveSelection(this->pendingNudgeX, this->pendingNudgeY);
+    this->nudgedX += this->pendingNudgeX;
+    this->nudgedY += this->pendingNudgeY;
+    this->pendingNudgeX = this->pendingNudgeY = 0;
+    ensureWithinVisibleArea();
+}
+
+void EditSelection::finishNudging() {
+    if (this->nudgeTickCallback != 0) {
+        gtk_widget_remove_tick_callback(this->view->getXournal()->getWidget(), this->nudgeTickCallback);
+        this->nudgeTickCallback = 0;
+    }
+    applyPendingNudge();
+    if (this->nudgedX != 0 || this->nudgedY != 0) {
+        this->contents->addMoveUndo(this->undo, this->nudgedX, this->nudgedY);
+        this->nudgedX = this->nudgedY = 0;
+    }
+}
+
 void EditSelection::setEdgePan(bool pan) {
     if (pan && !this->edgePanHandler) {
         this->edgePanHandler = g_timeout_source_new(1000 / PAN_TIMER_RATE);
@@ -1066,7 +1110,8 @@ void EditSelection::paint(cairo_t* cr, double zoom) {
 
         cairo_translate(cr, -rx, -ry);
     }
-    this->contents->paint(cr, x, y, this->rotation, this->width, this->height, zoom);
+    this->contents->paint(cr, x, y, this->rotation, this->width, this->height, zoom,
+                          this->mouseDownType != CURSOR_SELECTION_NONE);
 
     cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
 
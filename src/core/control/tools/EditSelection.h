@@ -16,8 +16,9 @@
 #include <utility>  // for pair
 #include <vector>   // for vector
 
-#include <cairo.h>  // for cairo_t, cairo_matrix_t
-#include <glib.h>   // for GSource
+#include <cairo.h>    // for cairo_t, cairo_matrix_t
+#include <glib.h>     // for GSource, guint
+#include <gtk/gtk.h>  // for GtkWidget, GdkFrameClock
 
 #include "control/ToolEnums.h"               // for ToolSize
 #include "model/Element.h"                   // for Element, Element::Index
@@ -200,6 +201,11 @@ public:
      */
     UndoActionPtr setFill(int alphaPen, int alphaHighligther);
 
+    /**
+     * Render the elements again, e.g. once the images among them have been decoded
+     */
+    void repaintContents();
+
 public:
     /**
      * Add an element to the this selection
@@ -243,6 +249,17 @@ public:
      */
     void moveSelection(double dx, double dy, bool addMoveUndo = false);
 
+    /**
+     * Move the selection by a step of the arrow keys. The repeated steps are merged and applied once per frame, and
+     * a single move undo is added for all of them by finishNudging() (e.g. when the key is released).
+     */
+    void nudge(double dx, double dy);
+
+    /**
+     * Apply the pending steps of nudge() and add the move undo of the steps since the last call, if any
+     */
+    void finishNudging();
+
     /**
      * Get the cursor type for the current position (if 0 then the default cursor should be used)
      */
@@ -352,6 +369,10 @@ private:
 
     static bool handleEdgePan(EditSelection* self);
 
+private:
+    static gboolean applyPendingNudgeTick(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+    void applyPendingNudge();
+
 private:  // DATA
     /**
      * The position (and rotation) relative to the current view
@@ -450,4 +471,17 @@ private:  // HANDLER
      * the selection in mouseDown while edge panning.
      */
     bool edgePanInhibitNext = false;
+
+    /**
+     * The steps of nudge() not applied yet, and the ones applied without a move undo so far
+     */
+    double pendingNudgeX = 0;
+    double pendingNudgeY = 0;
+    double nudgedX = 0;
+    double nudgedY = 0;
+
+    /**
+     * The tick callback applying the pending steps, or 0
+     */
+    guint nudgeTickCallback = 0;
 };
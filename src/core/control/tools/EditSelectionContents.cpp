@@ -293,14 +293,16 @@ auto EditSelectionContents::setLineStyle(LineStyle style) -> UndoActionPtr {
  */
 auto EditSelectionContents::setColor(Color color) -> UndoActionPtr {
     auto undo = std::make_unique<ColorUndoAction>(this->sourcePage, this->sourceLayer);
+    undo->reserve(this->selected.size());
 
     bool found = false;
 
+    // The elements are only changed here: the selection is repainted once, from a new buffer
     for (Element* e: this->selected) {
-        if (e->getType() == ELEMENT_TEXT || e->getType() == ELEMENT_STROKE) {
+        if ((e->getType() == ELEMENT_TEXT || e->getType() == ELEMENT_STROKE) && e->getColor() != color) {
             auto lastColor = e->getColor();
             e->setColor(color);
-            undo->addStroke(e, lastColor, e->getColor());
+            undo->addStroke(e, lastColor, color);
 
             found = true;
         }
@@ -331,6 +333,11 @@ void EditSelectionContents::fillUndoItem(DeleteUndoAction* undo) {
     this->insertionOrder.clear();
 }
 
+void EditSelectionContents::repaintContents() {
+    this->deleteViewBuffer();
+    this->sourceView->getXournal()->repaintSelection();
+}
+
 /**
  * Callback to redrawing the buffer asynchron
  */
@@ -396,15 +403,8 @@ void EditSelectionContents::finalizeSelection(Rectangle<double> bounds, Rectangl
                                               bool aspectRatio, Layer* layer, const PageRef& targetPage,
                                               XojPageView* targetView, UndoRedoHandler* undo) {
     xoj_assert(this->selected.size() == this->insertionOrder.size());
-    for (auto&& [e, index]: this->makeMoveEffective(bounds, snappedBounds, aspectRatio)) {
-        if (index == Element::InvalidIndex) {
-            // if the element didn't have a source layer (e.g, clipboard)
-            g_warning("Invalid index");
-            layer->addElement(std::move(e));
-        } else {
-            layer->insertElement(std::move(e), index);
-        }
-    }
+    // The elements without a source layer (e.g. from the clipboard) are appended
+    layer->insertElements(this->makeMoveEffective(bounds, snappedBounds, aspectRatio));
 }
 
 auto EditSelectionContents::getOriginalX() const -> double { return this->originalBounds.x; }
@@ -503,7 +503,7 @@ void EditSelectionContents::updateContent(Rectangle<double> bounds, Rectangle<do
  * paints the selection
  */
 void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotation, double width, double height,
-                                  double zoom) {
+                                  double zoom, bool transforming) {
     double fx = width / this->originalBounds.width;
     double fy = height / this->originalBounds.height;
 
@@ -517,46 +517,67 @@ void EditSelectionContents::paint(cairo_t* cr, double x, double y, double rotati
     }
 
     if (this->crBuffer == nullptr) {
-        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::abs(width) * zoom),
-                                                    static_cast<int>(std::abs(height) * zoom));
+        // Small selections get some headroom, so that they still look sharp while they are scaled up or rotated
+        const double pixels = std::abs(width * height) * zoom * zoom;
+        this->bufferOversampling = pixels * OVERSAMPLING * OVERSAMPLING <= MAX_OVERSAMPLED_PIXELS ? OVERSAMPLING : 1;
+        const double renderZoom = zoom * this->bufferOversampling;
+
+        this->crBuffer = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                    std::max(1, static_cast<int>(std::abs(width) * renderZoom)),
+                                                    std::max(1, static_cast<int>(std::abs(height) * renderZoom)));
         cairo_t* cr2 = cairo_create(this->crBuffer);
 
-        int dx = static_cast<int>(this->relativeX * zoom);
-        int dy = static_cast<int>(this->relativeY * zoom);
+        int dx = static_cast<int>(this->relativeX * renderZoom);
+        int dy = static_cast<int>(this->relativeY * renderZoom);
 
-        cairo_translate(cr2, fx < 0 ? -width * zoom : 0, fy < 0 ? -height * zoom : 0);
+        cairo_translate(cr2, fx < 0 ? -width * renderZoom : 0, fy < 0 ? -height * renderZoom : 0);
         cairo_scale(cr2, fx, fy);
         cairo_translate(cr2, -dx, -dy);
-        cairo_scale(cr2, zoom, zoom);
+        cairo_scale(cr2, renderZoom, renderZoom);
 
         xoj::view::ElementContainerView view(this);
         view.draw(xoj::view::Context::createDefault(cr2));
 
         cairo_destroy(cr2);
-    }
-
-    cairo_save(cr);
 
-    int wImg = cairo_image_surface_get_width(this->crBuffer);
-    int hImg = cairo_image_surface_get_height(this->crBuffer);
+        this->bufferWidth = width;
+        this->bufferHeight = height;
+        this->bufferZoom = zoom;
+    }
 
-    int wTarget = static_cast<int>(std::abs(width) * zoom);
-    int hTarget = static_cast<int>(std::abs(height) * zoom);
+    const bool upToDate = this->bufferWidth == width && this->bufferHeight == height && this->bufferZoom == zoom;
+    if (!upToDate && !transforming && !this->rescaleId) {
+        // During a gesture, the buffer is only transformed: it is rendered again once, when the gesture is over
+        this->rescaleId = g_idle_add(xoj::util::wrap_v<repaintSelection>, this);
+    }
 
-    double sx = static_cast<double>(wTarget) / wImg;
-    double sy = static_cast<double>(hTarget) / hImg;
+    cairo_save(cr);
 
-    if (wTarget != wImg || hTarget != hImg || std::abs(rotation) > std::numeric_limits<double>::epsilon()) {
-        if (!this->rescaleId) {
-            this->rescaleId = g_idle_add(xoj::util::wrap_v<repaintSelection>, this);
+    if (upToDate && this->bufferOversampling == 1) {
+        // Pixel aligned, as the buffer was rendered
+        double dx = static_cast<int>(std::min(x, x + width) * zoom);
+        double dy = static_cast<int>(std::min(y, y + height) * zoom);
+        cairo_set_source_surface(cr, this->crBuffer, dx, dy);
+    } else {
+        const int wImg = cairo_image_surface_get_width(this->crBuffer);
+        const int hImg = cairo_image_surface_get_height(this->crBuffer);
+        double sx = std::abs(width) * zoom / wImg;
+        double sy = std::abs(height) * zoom / hImg;
+
+        cairo_translate(cr, std::min(x, x + width) * zoom, std::min(y, y + height) * zoom);
+        // The selection was mirrored since the buffer was rendered
+        if ((width < 0) != (this->bufferWidth < 0)) {
+            cairo_translate(cr, std::abs(width) * zoom, 0);
+            sx = -sx;
+        }
+        if ((height < 0) != (this->bufferHeight < 0)) {
+            cairo_translate(cr, 0, std::abs(height) * zoom);
+            sy = -sy;
         }
         cairo_scale(cr, sx, sy);
+        cairo_set_source_surface(cr, this->crBuffer, 0, 0);
+        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
     }
-
-    double dx = static_cast<int>(std::min(x, x + width) * zoom / sx);
-    double dy = static_cast<int>(std::min(y, y + height) * zoom / sy);
-
-    cairo_set_source_surface(cr, this->crBuffer, dx, dy);
     cairo_paint(cr);
 
     cairo_restore(cr);
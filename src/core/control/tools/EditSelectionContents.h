@@ -82,6 +82,11 @@ public:
      */
     UndoActionPtr setFill(int alphaPen, int alphaHighligther);
 
+    /**
+     * Render the elements again, e.g. once the images among them have been decoded
+     */
+    void repaintContents();
+
 public:
     /**
      * Add an element to the this selection
@@ -120,8 +125,12 @@ public:
 public:
     /**
      * paints the selection
+     *
+     * @param transforming true while the selection is moved, scaled or rotated by the user: the cached rendering of
+     *      the elements is then only transformed, and rendered again once the gesture is over.
      */
-    void paint(cairo_t* cr, double x, double y, double rotation, double width, double height, double zoom);
+    void paint(cairo_t* cr, double x, double y, double rotation, double width, double height, double zoom,
+               bool transforming = false);
 
     /// Applies the transformation to the selected elements, empties the selection and return the modified elements
     InsertionOrder makeMoveEffective(const xoj::util::Rectangle<double>& bounds,
@@ -221,6 +230,18 @@ private:
      */
     cairo_surface_t* crBuffer = nullptr;
 
+    /**
+     * The size of the selection and the zoom crBuffer was rendered for, and its resolution relative to the zoom
+     */
+    double bufferWidth = 0;
+    double bufferHeight = 0;
+    double bufferZoom = 0;
+    int bufferOversampling = 1;
+
+    /// The buffer of the smaller selections is rendered at OVERSAMPLING times the zoom
+    static constexpr int OVERSAMPLING = 2;
+    static constexpr double MAX_OVERSAMPLED_PIXELS = 2048.0 * 2048.0;
+
     /**
      * The source id for the rescaling task
      */
@@ -1,11 +1,13 @@
 #include "EraseHandler.h"
 
-#include <memory>   // for make_unique, unique_ptr
-#include <utility>  // for move
-#include <vector>   // for vector
+#include <algorithm>  // for max, min
+#include <future>     // for async, future
+#include <memory>     // for make_unique, unique_ptr
+#include <utility>    // for move
+#include <vector>     // for vector
 
 #include <gdk/gdk.h>  // for GdkRectangle
-#include <glib.h>     // for gint
+#include <glib.h>     // for gint, g_get_num_processors
 
 #include "control/ToolEnums.h"            // for ERASER_TYPE_DELETE_STROKE
 #include "control/ToolHandler.h"          // for ToolHandler
@@ -22,6 +24,46 @@
 #include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
 #include "util/Range.h"                   // for Range
 #include "util/SmallVector.h"             // for SmallVector
+#include "util/UnionOfIntervals.h"        // for UnionOfIntervals
+
+struct EraseHandler::StrokeHit {
+    Stroke* stroke = nullptr;
+    /// For the stroke deletion eraser: whether the stroke must be deleted
+    bool hit = false;
+    /// For a stroke touched for the first time by the standard eraser: the sections to erase
+    IntersectionParametersContainer intersections{};
+    /// For a stroke already touched by the standard eraser: the sections to erase
+    UnionOfIntervals<PathParameter> erasedSections{};
+};
+
+namespace {
+/// Below that, starting a thread costs more than it saves
+constexpr size_t MIN_STROKES_PER_THREAD = 16;
+
+/**
+ * Calls fn(i) for every i in [0, count), distributed over a few threads. The calling thread takes its share.
+ */
+template <class Fn>
+void parallelFor(size_t count, Fn&& fn) {
+    const size_t threadCount =
+            std::max<size_t>(1, std::min<size_t>(g_get_num_processors(), count / MIN_STROKES_PER_THREAD));
+    auto runChunk = [&fn, count, threadCount](size_t chunk) {
+        for (size_t i = chunk * count / threadCount, end = (chunk + 1) * count / threadCount; i < end; i++) {
+            fn(i);
+        }
+    };
+    std::vector<std::future<void>> others;
+    others.reserve(threadCount - 1);
+    for (size_t chunk = 1; chunk < threadCount; chunk++) {
+        // Runs in this thread when waited for, if no thread can be started
+        others.push_back(std::async(std::launch::async | std::launch::deferred, runChunk, chunk));
+    }
+    runChunk(0);
+    for (auto& f: others) {
+        f.get();
+    }
+}
+}  // namespace
 
 EraseHandler::EraseHandler(UndoRedoHandler* undo, Document* doc, const PageRef& page, ToolHandler* handler,
                            LegacyRedrawable* view):
@@ -52,20 +94,53 @@ void EraseHandler::erase(double x, double y) {
 
     Layer* l = page->getSelectedLayer();
 
-    for (Element* e: xoj::refElementContainer(l->getElements())) {
+    // Rounding in intersectsArea() can make the bounding boxes up to 1 unit larger
+    Range eraserArea(eraserRect.x - 1, eraserRect.y - 1, eraserRect.x + eraserRect.width + 1,
+                     eraserRect.y + eraserRect.height + 1);
+    std::vector<Stroke*> candidates;
+    for (Element* e: l->getElementsInArea(eraserArea)) {
         if (e->getType() == ELEMENT_STROKE && e->intersectsArea(&eraserRect)) {
-            eraseStroke(l, dynamic_cast<Stroke*>(e), x, y, range);
+            candidates.push_back(dynamic_cast<Stroke*>(e));
         }
     }
 
+    // The intersections are computed in parallel. The strokes are then modified (and the undo actions recorded) one
+    // after the other, in the order of the layer.
+    std::vector<StrokeHit> hits(candidates.size());
+    this->doc->lock();
+    parallelFor(candidates.size(), [&](size_t i) { hits[i] = hitTest(candidates[i], x, y); });
+    this->doc->unlock();
+
+    for (auto& hit: hits) {
+        eraseStroke(l, hit, range);
+    }
+
     this->view->rerenderRange(range);
 }
 
-void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range) {
+auto EraseHandler::hitTest(Stroke* s, double x, double y) const -> StrokeHit {
+    StrokeHit hit{s};
+    if (const ErasableStroke* erasable = s->getErasable(); erasable) {
+        // This stroke has already been touched by the eraser (necessarily the default eraser)
+        const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
+        const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
+        hit.erasedSections = erasable->findErasedSections(paddedEraserBox);
+    } else if (this->handler->getEraserType() == ERASER_TYPE_DELETE_STROKE) {
+        hit.hit = s->intersects(x, y, halfEraserSize);
+    } else {
+        const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
+        const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
+        hit.intersections = s->intersectWithPaddedBox(paddedEraserBox);
+    }
+    return hit;
+}
+
+void EraseHandler::eraseStroke(Layer* l, StrokeHit& hit, Range& range) {
+    Stroke* s = hit.stroke;
     ErasableStroke* erasable = s->getErasable();
     if (!erasable) {
         if (this->handler->getEraserType() == ERASER_TYPE_DELETE_STROKE) {
-            if (!s->intersects(x, y, halfEraserSize)) {
+            if (!hit.hit) {
                 // The stroke does not intersect the eraser square
                 return;
             }
@@ -97,11 +172,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& r
                 return;
             }
 
-            const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
-            const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
-            auto intersectionParameters = s->intersectWithPaddedBox(paddedEraserBox);
-
-            if (intersectionParameters.empty()) {
+            if (hit.intersections.empty()) {
                 // The stroke does not intersect the eraser square
                 return;
             }
@@ -118,7 +189,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& r
             s->setErasable(erasable);
             doc->unlock();
             this->eraseUndoAction->addOriginal(l, s, pos);
-            erasable->beginErasure(intersectionParameters, range);
+            erasable->beginErasure(hit.intersections, range);
         }
     } else {
         /**
@@ -129,9 +200,7 @@ void EraseHandler::eraseStroke(Layer* l, Stroke* s, double x, double y, Range& r
         if (pos == -1) {
             return;
         }
-        const double paddingCoeff = PADDING_COEFFICIENT_CAP[s->getStrokeCapStyle()];
-        const PaddedBox paddedEraserBox{{x, y}, halfEraserSize, halfEraserSize + paddingCoeff * s->getWidth()};
-        erasable->erase(paddedEraserBox, range);
+        erasable->erase(std::move(hit.erasedSections), range);
     }
 }
 
@@ -34,7 +34,15 @@ public:
     void finalize();
 
 private:
-    void eraseStroke(Layer* l, Stroke* s, double x, double y, Range& range);
+    /// What the eraser does to a stroke, see hitTest()
+    struct StrokeHit;
+
+    /**
+     * @brief Tests the stroke against the eraser, without modifying anything. Can run concurrently for different
+     * strokes, under the document lock.
+     */
+    StrokeHit hitTest(Stroke* s, double x, double y) const;
+    void eraseStroke(Layer* l, StrokeHit& hit, Range& range);
 
 private:
     PageRef page;
@@ -11,6 +11,7 @@
 #include <glib.h>         // for g_error_free, g_free, GError
 
 #include "control/Control.h"              // for Control
+#include "control/jobs/ImageDecodeJob.h"  // for ImageDecodeJob
 #include "control/tools/EditSelection.h"  // for EditSelection
 #include "gui/MainWindow.h"               // for MainWindow
 #include "gui/PageView.h"                 // for XojPageView
@@ -72,10 +73,7 @@ auto ImageHandler::createImageFromFile(const fs::path& p) -> std::unique_ptr<Ima
         XojMsgBox::showErrorToUser(nullptr, msg.str());
         return nullptr;
     }
-    // Render the image.
-    // FIXME: this is horrible. We need an ImageView class...
-    (void)img->getImage();
-
+    // The size is read from the header: the image is decoded once inserted, on another thread (see addImageToDocument)
     return img;
 }
 
@@ -95,6 +93,7 @@ bool ImageHandler::addImageToDocument(std::unique_ptr<Image> img, PageRef page,
         return false;
     }
 
+    ImageDecodeJob::decode(control, *img, page);
     auto sel = SelectionFactory::createFromFloatingElement(control, page, layer, view, std::move(img));
     control->getWindow()->getXournal()->setSelection(sel.release());
     return true;
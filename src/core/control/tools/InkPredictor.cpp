@@ -0,0 +1,88 @@
+#include "InkPredictor.h"
+
+#include <algorithm>  // for min, max
+#include <array>      // for array
+#include <cmath>      // for abs
+
+namespace {
+using Matrix3 = std::array<std::array<double, 3>, 3>;
+
+auto determinant(const Matrix3& a) -> double {
+    return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) +
+           a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+}
+
+/**
+ * Solve m * x = b by Cramer's rule
+ * @return false if m is singular
+ */
+auto solve(const Matrix3& m, const std::array<double, 3>& b, std::array<double, 3>& x) -> bool {
+    const double d = determinant(m);
+    if (std::abs(d) < 1e-9) {
+        return false;
+    }
+    for (size_t col = 0; col < 3; col++) {
+        Matrix3 mc = m;
+        for (size_t row = 0; row < 3; row++) { mc[row][col] = b[row]; }
+        x[col] = determinant(mc) / d;
+    }
+    return true;
+}
+}  // namespace
+
+InkPredictor::InkPredictor(guint32 horizon): horizon(horizon) {}
+
+void InkPredictor::reset() { this->samples.assign(Sample()); }
+
+void InkPredictor::addSample(double x, double y, guint32 timestamp) {
+    this->samples.push_front({x, y, timestamp, true});
+}
+
+auto InkPredictor::predict() -> std::optional<Point> {
+    const Sample last = this->samples.front();
+    if (!last.valid) {
+        return std::nullopt;
+    }
+
+    // Normal equations of the least squares fit, with the times relative to the last sample (in ms, <= 0)
+    Matrix3 m{};
+    std::array<double, 3> bx{};
+    std::array<double, 3> by{};
+    size_t count = 0;
+    double span = 0;
+    for (const Sample& s: this->samples) {
+        if (!s.valid) {
+            continue;
+        }
+        const double t = -static_cast<double>(last.timestamp - s.timestamp);
+        const std::array<double, 3> powers = {1, t, t * t};
+        for (size_t row = 0; row < 3; row++) {
+            for (size_t col = 0; col < 3; col++) { m[row][col] += powers[row] * powers[col]; }
+            bx[row] += powers[row] * s.x;
+            by[row] += powers[row] * s.y;
+        }
+        span = std::max(span, -t);
+        count++;
+    }
+    if (span < 1) {
+        // All the samples have the same time stamp: the speed is unknown
+        return Point(last.x, last.y);
+    }
+
+    std::array<double, 3> cx{};
+    std::array<double, 3> cy{};
+    const bool quadratic = count > 3 && solve(m, bx, cx) && solve(m, by, cy);
+    if (!quadratic) {
+        // Degree 1: the upper left 2x2 block of the system
+        const double d = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+        if (std::abs(d) < 1e-9) {
+            return Point(last.x, last.y);
+        }
+        cx = {(bx[0] * m[1][1] - m[0][1] * bx[1]) / d, (m[0][0] * bx[1] - m[1][0] * bx[0]) / d, 0};
+        cy = {(by[0] * m[1][1] - m[0][1] * by[1]) / d, (m[0][0] * by[1] - m[1][0] * by[0]) / d, 0};
+    }
+
+    // The fitted curve does not go exactly through the last sample: only its displacement is applied
+    const double h = std::min(static_cast<double>(this->horizon), span * MAX_EXTRAPOLATION);
+    return Point(last.x + cx[1] * h + cx[2] * h * h, last.y + cy[1] * h + cy[2] * h * h);
+}
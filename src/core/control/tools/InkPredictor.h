@@ -0,0 +1,65 @@
+/*
+ * Xournal++
+ *
+ * Predicts where the pen is heading
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+
+#include <glib.h>  // for guint32
+
+#include "model/Point.h"          // for Point
+#include "util/CircularBuffer.h"  // for CircularBuffer
+
+/**
+ * @brief Extrapolates the motion of the pen a few milliseconds ahead, so that the ink can be drawn where the pen will
+ * be once the frame is displayed, instead of where it was when the event was sent.
+ *
+ * The coordinates of the last samples are fitted, as functions of time, with a polynomial of degree 2 (least squares),
+ * or of degree 1 while there are too few samples. The prediction is never added to the stroke.
+ */
+class InkPredictor {
+public:
+    /**
+     * @param horizon How far ahead to predict, in ms
+     */
+    explicit InkPredictor(guint32 horizon);
+
+    /// Forget the samples of the previous stroke
+    void reset();
+
+    void addSample(double x, double y, guint32 timestamp);
+
+    /**
+     * @return The predicted position, without pressure, or nothing if there is no sample yet. It is the position of
+     *      the last sample while the samples do not span enough time to estimate the speed.
+     */
+    std::optional<Point> predict();
+
+    /// The number of samples fitted
+    static constexpr size_t SAMPLES = 6;
+
+    /// The prediction is not extrapolated further than the samples span, times this factor
+    static constexpr double MAX_EXTRAPOLATION = 1.0;
+
+private:
+    struct Sample {
+        double x{};
+        double y{};
+        guint32 timestamp{};
+        /// false for the entries of the buffer no sample was written to since the last reset
+        bool valid = false;
+    };
+
+    /// The order of the samples does not matter to the fit: the buffer is only traversed from begin() to end()
+    CircularBuffer<Sample> samples{SAMPLES};
+    guint32 horizon;
+};
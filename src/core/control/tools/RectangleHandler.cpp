@@ -19,7 +19,7 @@ auto RectangleHandler::createShape(bool isAltDown, bool isShiftDown, bool isCont
     /**
      * Snap point to grid (if enabled)
      */
-    Point c = snappingHandler.snapToGrid(this->currPoint, isAltDown);
+    Point c = snappingHandler.snapToObjectsOrGrid(this->currPoint, *this->page, isAltDown);
 
     double width = c.x - this->startPoint.x;
     double height = c.y - this->startPoint.y;
@@ -1,7 +1,8 @@
 #include "Selection.h"
 
-#include <algorithm>  // for max, min
-#include <cmath>      // for abs, NAN
+#include <algorithm>  // for max, min, clamp, fill
+#include <cmath>      // for abs, sqrt
+#include <cstddef>    // for ptrdiff_t
 #include <memory>     // for __shared_ptr_access
 
 #include <gdk/gdk.h>  // for GdkRGBA, gdk_cairo_set_source_rgba
@@ -29,13 +30,11 @@ auto Selection::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
                 continue;
             }
             bool selectionOnLayer = false;
-            Element::Index pos = 0;
-            for (auto&& e: l->getElements()) {
-                if (e->isInSelection(this)) {
-                    this->selectedElements.emplace_back(e.get(), pos);
+            for (auto&& [e, pos]: l->getElementsInAreaWithPositions(this->bbox)) {
+                if (isInBoundingBox(e) && e->isInSelection(this)) {
+                    this->selectedElements.emplace_back(e, pos);
                     selectionOnLayer = true;
                 }
-                pos++;
             }
             if (selectionOnLayer) {
                 layerId = page->getLayers()->size() - as_unsigned(std::distance(page->getLayers()->rbegin(), it));
@@ -45,13 +44,11 @@ auto Selection::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
     } else {
         std::lock_guard lock(*doc);
         Layer* l = page->getSelectedLayer();
-        Element::Index pos = 0;
-        for (auto&& e: l->getElements()) {
-            if (e->isInSelection(this)) {
-                this->selectedElements.emplace_back(e.get(), pos);
+        for (auto&& [e, pos]: l->getElementsInAreaWithPositions(this->bbox)) {
+            if (isInBoundingBox(e) && e->isInSelection(this)) {
+                this->selectedElements.emplace_back(e, pos);
                 layerId = page->getSelectedLayerId();
             }
-            pos++;
         }
     }
 
@@ -60,6 +57,11 @@ auto Selection::finalize(PageRef page, bool disableMultilayer, Document* doc) ->
     return layerId;
 }
 
+auto Selection::isInBoundingBox(const Element* e) const -> bool {
+    // The points tested by isInSelection() are all in the snapped bounds: a stroke is rejected without reading them
+    return this->bbox.contains(e->getSnappedBounds());
+}
+
 auto Selection::isMultiLayerSelection() -> bool {
     return this->multiLayer;
 }
@@ -106,6 +108,7 @@ RegionSelect::RegionSelect(double x, double y, bool multiLayer): Selection(multi
 void RegionSelect::currentPos(double x, double y) {
     boundaryPoints.emplace_back(x, y);
     bbox.addPoint(x, y);
+    gridValid = false;
 
     // at least three points needed
     if (boundaryPoints.size() >= 3) {
@@ -125,66 +128,119 @@ auto RegionSelect::contains(double x, double y) const -> bool {
         return false;
     }
 
-    int hits = 0;
+    if (!gridValid) {
+        buildGrid();
+    }
+    if (cells.empty()) {
+        // The lasso has no area
+        return false;
+    }
 
-    const BoundaryPoint& last = boundaryPoints.back();
+    size_t row = rowOf(y);
+    switch (cells[row * columns + columnOf(x)]) {
+        case Cell::INSIDE:
+            return true;
+        case Cell::OUTSIDE:
+            return false;
+        default:
+            return rowContains(x, y, row);
+    }
+}
 
-    double lastx = last.x;
-    double lasty = last.y;
-    double curx = NAN, cury = NAN;
+auto RegionSelect::rowOf(double y) const -> size_t {
+    return std::min(rows - 1, static_cast<size_t>(std::max(0.0, (y - bbox.minY) / cellHeight)));
+}
 
-    // Walk the edges of the polygon
-    for (auto pointIterator = boundaryPoints.begin(); pointIterator != boundaryPoints.end();
-         lastx = curx, lasty = cury, ++pointIterator) {
-        curx = pointIterator->x;
-        cury = pointIterator->y;
+auto RegionSelect::columnOf(double x) const -> size_t {
+    return std::min(columns - 1, static_cast<size_t>(std::max(0.0, (x - bbox.minX) / cellWidth)));
+}
 
-        if (cury == lasty) {
-            continue;
+auto RegionSelect::rowContains(double x, double y, size_t row) const -> bool {
+    const size_t n = boundaryPoints.size();
+    bool inside = false;
+    for (size_t i: rowEdges[row]) {
+        const BoundaryPoint& a = boundaryPoints[i == 0 ? n - 1 : i - 1];
+        const BoundaryPoint& b = boundaryPoints[i];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) {
+            inside = !inside;
         }
+    }
+    return inside;
+}
 
-        int leftx = 0;
-        if (curx < lastx) {
-            if (x >= lastx) {
-                continue;
+void RegionSelect::buildGrid() const {
+    gridValid = true;
+    cells.clear();
+    rowEdges.clear();
+
+    const double width = bbox.getWidth();
+    const double height = bbox.getHeight();
+    if (!(width > 0 && height > 0)) {
+        return;
+    }
+
+    // About 2 edges per row, and square-ish cells
+    const size_t n = boundaryPoints.size();
+    const double side = std::clamp(std::sqrt(static_cast<double>(n)) * 2, 8.0, 256.0);
+    rows = columns = static_cast<size_t>(side);
+    cellWidth = width / static_cast<double>(columns);
+    cellHeight = height / static_cast<double>(rows);
+
+    cells.assign(rows * columns, Cell::OUTSIDE);
+    rowEdges.resize(rows);
+
+    // Avoids missing a cell the boundary only touches, because of rounding errors
+    const double padding = cellWidth * 1e-3;
+
+    for (size_t i = 0; i < n; i++) {
+        const BoundaryPoint& a = boundaryPoints[i == 0 ? n - 1 : i - 1];
+        const BoundaryPoint& b = boundaryPoints[i];
+        const BoundaryPoint& top = a.y < b.y ? a : b;
+        const BoundaryPoint& bottom = a.y < b.y ? b : a;
+
+        const size_t firstRow = rowOf(top.y);
+        const size_t lastRow = rowOf(bottom.y);
+        for (size_t row = firstRow; row <= lastRow; row++) {
+            if (a.y != b.y) {
+                rowEdges[row].push_back(i);
             }
-            leftx = static_cast<int>(curx);
-        } else {
-            if (x >= curx) {
-                continue;
+
+            // The part of the edge in the row
+            double x1 = top.x;
+            double x2 = bottom.x;
+            if (top.y != bottom.y) {
+                const double slope = (bottom.x - top.x) / (bottom.y - top.y);
+                const double rowTop = std::max(top.y, bbox.minY + static_cast<double>(row) * cellHeight);
+                const double rowBottom = std::min(bottom.y, bbox.minY + static_cast<double>(row + 1) * cellHeight);
+                x1 = top.x + (rowTop - top.y) * slope;
+                x2 = top.x + (rowBottom - top.y) * slope;
             }
-            leftx = static_cast<int>(lastx);
+            const size_t firstColumn = columnOf(std::min(x1, x2) - padding);
+            const size_t lastColumn = columnOf(std::max(x1, x2) + padding);
+            std::fill(cells.begin() + static_cast<std::ptrdiff_t>(row * columns + firstColumn),
+                      cells.begin() + static_cast<std::ptrdiff_t>(row * columns + lastColumn + 1), Cell::BOUNDARY);
         }
+    }
 
-        double test1 = NAN, test2 = NAN;
-        if (cury < lasty) {
-            if (y < cury || y >= lasty) {
+    // The cells between two boundary cells of a row are all inside or all outside: test the first one only
+    for (size_t row = 0; row < rows; row++) {
+        const double y = bbox.minY + (static_cast<double>(row) + 0.5) * cellHeight;
+        bool known = false;
+        Cell run = Cell::OUTSIDE;
+        for (size_t column = 0; column < columns; column++) {
+            Cell& cell = cells[row * columns + column];
+            if (cell == Cell::BOUNDARY) {
+                known = false;
                 continue;
             }
-            if (x < leftx) {
-                hits++;
-                continue;
+            if (!known) {
+                const double x = bbox.minX + (static_cast<double>(column) + 0.5) * cellWidth;
+                run = rowContains(x, y, rowOf(y)) ? Cell::INSIDE : Cell::OUTSIDE;
+                known = true;
             }
-            test1 = x - curx;
-            test2 = y - cury;
-        } else {
-            if (y < lasty || y >= cury) {
-                continue;
-            }
-            if (x < leftx) {
-                hits++;
-                continue;
-            }
-            test1 = x - lastx;
-            test2 = y - lasty;
-        }
-
-        if (test1 < (test2 / (lasty - cury) * (lastx - curx))) {
-            hits++;
+            cell = run;
         }
     }
-
-    return (hits & 1) != 0;
 }
 
 auto RegionSelect::userTapped(double zoom) const -> bool {
@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t
+#include <vector>   // for vector
 
 #include "model/Element.h"  // for Element (ptr only), ShapeContainer
 #include "model/ElementInsertionPosition.h"
@@ -52,6 +54,12 @@ public:
     auto releaseElements() -> InsertionOrderRef;
 
 private:
+    /**
+     * Quick rejection of the elements which are only partially in the bounding box of the selection. The layer only
+     * returns the elements intersecting it.
+     */
+    bool isInBoundingBox(const Element* e) const;
+
 protected:
     std::vector<BoundaryPoint> boundaryPoints;
 
@@ -95,4 +103,30 @@ public:
     bool contains(double x, double y) const override;
     bool userTapped(double zoom) const override;
     const std::vector<BoundaryPoint>& getBoundary() const override;
+
+private:
+    /**
+     * Rasterize the lasso on a grid over its bounding box. Each cell is either inside or outside of the lasso, or is
+     * crossed by its boundary. Only the points of the boundary cells are tested against the edges, and only against
+     * the edges of their row.
+     */
+    void buildGrid() const;
+
+    /// Even-odd test of the point against the edges spanning the row of the grid
+    bool rowContains(double x, double y, size_t row) const;
+
+    size_t rowOf(double y) const;
+    size_t columnOf(double x) const;
+
+    enum class Cell : uint8_t { OUTSIDE, INSIDE, BOUNDARY };
+
+    /// The grid is built by the first call to contains() after the lasso changed
+    mutable bool gridValid = false;
+    mutable size_t rows = 0;
+    mutable size_t columns = 0;
+    mutable double cellWidth = 0;
+    mutable double cellHeight = 0;
+    mutable std::vector<Cell> cells;
+    /// The indices of the edges spanning each row. Edge i goes from point i - 1 (the last point for i = 0) to point i.
+    mutable std::vector<std::vector<size_t>> rowEdges;
 };
@@ -1,7 +1,13 @@
 #include "SnapToGridInputHandler.h"
 
+#include <cmath>   // for sqrt
+#include <vector>  // for vector
+
 #include "control/settings/Settings.h"
+#include "model/Layer.h"
 #include "model/Snapping.h"
+#include "model/XojPage.h"
+#include "util/Range.h"
 
 SnapToGridInputHandler::SnapToGridInputHandler(Settings* settings): settings(settings) {}
 
@@ -44,3 +50,36 @@ Point SnapToGridInputHandler::snap(Point const& pos, Point const& center, bool a
     Point rotationSnappedPoint{snapRotation(pos, center, alt)};
     return snapToGrid(rotationSnappedPoint, alt);
 }
+
+std::optional<Point> SnapToGridInputHandler::snapToObjects(Point const& pos, XojPage& page, bool alt) {
+    if (alt == settings->isSnapObjects()) {
+        return std::nullopt;
+    }
+    // Same tolerance scale as snapping to grid
+    double radius = settings->getSnapGridSize() / std::sqrt(2) * settings->getSnapObjectsTolerance();
+    Range area(pos.x - radius, pos.y - radius, pos.x + radius, pos.y + radius);
+
+    std::vector<Element*> candidates;
+    for (Layer* l: *page.getLayers()) {
+        if (!l->isVisible()) {
+            continue;
+        }
+        auto elements = l->getElementsInArea(area);
+        candidates.insert(candidates.end(), elements.begin(), elements.end());
+    }
+    return Snapping::snapToVertices(pos, candidates, radius);
+}
+
+Point SnapToGridInputHandler::snapToObjectsOrGrid(Point const& pos, XojPage& page, bool alt) {
+    if (auto vertex = snapToObjects(pos, page, alt)) {
+        return *vertex;
+    }
+    return snapToGrid(pos, alt);
+}
+
+Point SnapToGridInputHandler::snap(Point const& pos, Point const& center, XojPage& page, bool alt) {
+    if (auto vertex = snapToObjects(pos, page, alt)) {
+        return *vertex;
+    }
+    return snap(pos, center, alt);
+}
@@ -10,9 +10,12 @@
  */
 #pragma once
 
+#include <optional>  // for optional
+
 #include "model/Point.h"
 
 class Settings;
+class XojPage;
 
 class SnapToGridInputHandler final {
 
@@ -71,4 +74,31 @@ public:
      * @param alt indicates whether snapping mode is altered (via the Alt key)
      */
     [[nodiscard]] Point snap(Point const& pos, Point const& center, bool alt);
+
+    /**
+     * @brief If a point is near enough to an endpoint or a corner of a stroke on the visible layers of the page, it
+     * returns the nearest one. The strokes are looked up in the spatial index of their layer.
+     * @param pos the position
+     * @param page the page the point is on
+     * @param alt indicates whether snapping mode is altered (via the Alt key)
+     */
+    [[nodiscard]] std::optional<Point> snapToObjects(Point const& pos, XojPage& page, bool alt);
+
+    /**
+     * @brief Snapping to the strokes of the page, or to the grid if there is no stroke near enough
+     * @param pos the position
+     * @param page the page the point is on
+     * @param alt indicates whether snapping mode is altered (via the Alt key)
+     */
+    [[nodiscard]] Point snapToObjectsOrGrid(Point const& pos, XojPage& page, bool alt);
+
+    /**
+     * @brief Snapping to the strokes of the page, or rotation snapping followed by snapping to grid if there is no
+     * stroke near enough
+     * @param pos the coordinate of the point
+     * @param center the center of rotation
+     * @param page the page the point is on
+     * @param alt indicates whether snapping mode is altered (via the Alt key)
+     */
+    [[nodiscard]] Point snap(Point const& pos, Point const& center, XojPage& page, bool alt);
 };
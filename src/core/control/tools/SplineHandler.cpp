@@ -2,7 +2,8 @@
 
 #include <algorithm>  // for max, max_element
 #include <cmath>      // for pow, M_PI, cos, sin
-#include <cstddef>    // for size_t
+#include <cstddef>    // for size_t, ptrdiff_t
+#include <iterator>   // for back_inserter, next
 #include <list>       // for list, operator!=
 #include <memory>     // for allocator_traits<>...
 #include <optional>   // for optional
@@ -29,6 +30,17 @@
 #include "util/DispatchPool.h"
 #include "view/overlays/SplineToolView.h"
 
+namespace {
+/// The segment from the i-th knot to the next one
+auto makeSegment(const std::vector<Point>& knots, const std::vector<Point>& tangents, size_t i) -> SplineSegment {
+    const Point& p = knots[i];
+    const Point& q = knots[i + 1];
+    const Point& s = tangents[i];
+    const Point& t = tangents[i + 1];
+    return SplineSegment(p, Point(p.x + s.x, p.y + s.y), Point(q.x - t.x, q.y - t.y), q);
+}
+}  // namespace
+
 SplineHandler::SplineHandler(Control* control, const PageRef& page):
         InputHandler(control, page),
         snappingHandler(control->getSettings()),
@@ -162,7 +174,7 @@ auto SplineHandler::onMotionNotifyEvent(const PositionInputData& pos, double zoo
                 return true;
             }
         } else {
-            this->currPoint = snappingHandler.snap(this->buttonDownPoint, knots.back(), pos.isAltDown());
+            this->currPoint = snappingHandler.snap(this->buttonDownPoint, knots.back(), *this->page, pos.isAltDown());
         }
         this->inFirstKnotAttractionZone = nowInAttractionZone;
     }
@@ -214,12 +226,12 @@ void SplineHandler::onButtonPressEvent(const PositionInputData& pos, double zoom
         stroke = createStroke(this->control);
         xoj_assert(this->knots.empty() && this->tangents.empty());
         this->buttonDownPoint = Point(pos.x / zoom, pos.y / zoom);
-        this->currPoint = snappingHandler.snapToGrid(this->buttonDownPoint, pos.isAltDown());
+        this->currPoint = snappingHandler.snapToObjectsOrGrid(this->buttonDownPoint, *this->page, pos.isAltDown());
         this->addKnot(this->currPoint);
     } else {
         xoj_assert(!this->knots.empty());
         this->buttonDownPoint = Point(pos.x / zoom, pos.y / zoom);
-        this->currPoint = snappingHandler.snap(this->buttonDownPoint, knots.back(), pos.isAltDown());
+        this->currPoint = snappingHandler.snap(this->buttonDownPoint, knots.back(), *this->page, pos.isAltDown());
         double dist = this->buttonDownPoint.lineLengthTo(this->knots.front());
         if (dist < this->knotsAttractionRadius) {  // now the spline is closed and finalized
             this->addKnotWithTangent(this->knots.front(), this->tangents.front());
@@ -249,6 +261,7 @@ void SplineHandler::clearTinySpline() {
     // Clearing the knots ensures the view will not draw anything (thus the repainting will erase everything)
     this->knots.clear();
     this->tangents.clear();
+    this->updateFlattenedSegments();
     this->stroke.reset();
     // Repaints and deletes the views
     this->viewPool->dispatchAndClear(xoj::view::SplineToolView::FINALIZATION_REQUEST, rg);
@@ -298,6 +311,7 @@ void SplineHandler::addKnot(const Point& p) { addKnotWithTangent(p, Point(0, 0))
 void SplineHandler::addKnotWithTangent(const Point& p, const Point& t) {
     this->knots.push_back(p);
     this->tangents.push_back(t);
+    this->updateFlattenedSegments();
 }
 
 void SplineHandler::modifyLastTangent(const Point& t) {
@@ -309,6 +323,22 @@ void SplineHandler::deleteLastKnotWithTangent() {
     xoj_assert(this->knots.size() > 1 && this->knots.size() == this->tangents.size());
     this->knots.pop_back();
     this->tangents.pop_back();
+    this->updateFlattenedSegments();
+}
+
+void SplineHandler::updateFlattenedSegments() {
+    const size_t definitive = this->knots.size() > 2 ? this->knots.size() - 2 : 0;
+    while (this->segmentOffsets.size() > definitive) {
+        this->flattenedSegments.erase(
+                std::next(this->flattenedSegments.begin(), static_cast<std::ptrdiff_t>(this->segmentOffsets.back())),
+                this->flattenedSegments.end());
+        this->segmentOffsets.pop_back();
+    }
+    while (this->segmentOffsets.size() < definitive) {
+        this->segmentOffsets.push_back(this->flattenedSegments.size());
+        auto pts = makeSegment(this->knots, this->tangents, this->segmentOffsets.size() - 1).toPointSequence();
+        std::move(pts.begin(), pts.end(), std::back_inserter(this->flattenedSegments));
+    }
 }
 
 auto SplineHandler::computeTotalRepaintRange(const Data& data, double strokeWidth) const -> Range {
@@ -379,24 +409,17 @@ auto SplineHandler::getData() const -> std::optional<Data> {
     if (this->knots.empty()) {
         return std::nullopt;
     }
-    return Data{this->knots, this->tangents, this->currPoint, this->knotsAttractionRadius,
+    return Data{this->knots, this->tangents, this->flattenedSegments, this->currPoint, this->knotsAttractionRadius,
                 this->inFirstKnotAttractionZone};
 }
 
 auto SplineHandler::linearizeSpline(const SplineHandler::Data& data) -> std::vector<Point> {
     xoj_assert(!data.knots.empty() && data.knots.size() == data.tangents.size());
 
-    std::vector<Point> result;
-
-    auto itKnot1 = data.knots.begin();
-    auto itKnot2 = std::next(itKnot1);
-    auto itTgt1 = data.tangents.begin();
-    auto itTgt2 = std::next(itTgt1);
-    auto end = data.knots.end();
-    for (; itKnot2 != end; ++itKnot1, ++itKnot2, ++itTgt1, ++itTgt2) {
-        SplineSegment seg(*itKnot1, Point(itKnot1->x + itTgt1->x, itKnot1->y + itTgt1->y),
-                          Point(itKnot2->x - itTgt2->x, itKnot2->y - itTgt2->y), *itKnot2);
-        auto pts = seg.toPointSequence();
+    // Only the last segment is flattened again
+    std::vector<Point> result = data.flattenedSegments;
+    if (const size_t n = data.knots.size(); n > 1) {
+        auto pts = makeSegment(data.knots, data.tangents, n - 2).toPointSequence();
         std::move(pts.begin(), pts.end(), std::back_inserter(result));
     }
     result.emplace_back(data.knots.back());
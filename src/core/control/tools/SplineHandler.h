@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstddef>   // for size_t
 #include <memory>    // for unique_ptr
 #include <optional>  // for optional
 #include <vector>    // for vector
@@ -45,6 +46,9 @@ class SplineToolView;
 struct SplineHandlerData {
     const std::vector<Point>& knots;
     const std::vector<Point>& tangents;
+    /// The segments which no longer change (all but the last one) flattened: from the first knot to the last but one
+    /// (excluded)
+    const std::vector<Point>& flattenedSegments;
     const Point& currPoint;
     double knotsAttractionRadius;
     bool closedSpline;
@@ -108,9 +112,19 @@ private:
      */
     void clearTinySpline();
 
+    /**
+     * @brief Flatten the segments which became definitive, or drop those which are no longer (the last segment is
+     * never definitive: the last knot and tangent can still be modified)
+     */
+    void updateFlattenedSegments();
+
 private:
     std::vector<Point> knots{};
     std::vector<Point> tangents{};
+    /// See SplineHandlerData::flattenedSegments
+    std::vector<Point> flattenedSegments{};
+    /// The index in flattenedSegments of the first point of each segment
+    std::vector<size_t> segmentOffsets{};
     Point currPoint;
     Point buttonDownPoint;  // never snapped to grid
     /**
@@ -0,0 +1,40 @@
+#include "StrokeDecimator.h"
+
+#include <algorithm>  // for all_of, clamp
+#include <cmath>      // for abs, hypot
+
+StrokeDecimator::StrokeDecimator(double maxError): maxError(maxError) {}
+
+void StrokeDecimator::reset(const Point& first) {
+    this->kept = first;
+    this->last.reset();
+    this->dropped.clear();
+}
+
+auto StrokeDecimator::fits(const Point& q, const Point& p) const -> bool {
+    const Point& a = this->kept;
+    const double dx = p.x - a.x;
+    const double dy = p.y - a.y;
+    const double length2 = dx * dx + dy * dy;
+    const double t = length2 > 0 ? std::clamp(((q.x - a.x) * dx + (q.y - a.y) * dy) / length2, 0.0, 1.0) : 0.0;
+    if (std::hypot(q.x - a.x - t * dx, q.y - a.y - t * dy) > this->maxError) {
+        return false;
+    }
+    // The edges of the ink move by half the difference of the widths
+    return q.z == Point::NO_PRESSURE || std::abs(q.z - a.z) <= 2 * this->maxError;
+}
+
+auto StrokeDecimator::replacesLast(const Point& p) -> bool {
+    if (this->last && this->dropped.size() < MAX_DROPPED && fits(*this->last, p) &&
+        std::all_of(this->dropped.begin(), this->dropped.end(), [&](const Point& q) { return fits(q, p); })) {
+        this->dropped.push_back(*this->last);
+        this->last = p;
+        return true;
+    }
+    if (this->last) {
+        this->kept = *this->last;
+    }
+    this->dropped.clear();
+    this->last = p;
+    return false;
+}
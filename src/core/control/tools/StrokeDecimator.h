@@ -0,0 +1,57 @@
+/*
+ * Xournal++
+ *
+ * Drops the points of a stroke which do not change its ink
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+#include <vector>    // for vector
+
+#include "model/Point.h"  // for Point
+
+/**
+ * @brief Decimates the points of a stroke while it is drawn, with a bounded error.
+ *
+ * The last point of the stroke is replaced by the new one, instead of appending it, as long as the points dropped
+ * since the last kept one stay within the error of the resulting segment. With pressure, their width must also stay
+ * within the error of the width of the segment (the width of its first point): the extrema of the pressure are kept.
+ */
+class StrokeDecimator {
+public:
+    /**
+     * @param maxError The maximal distance of a dropped point to the stroke, in page coordinates
+     */
+    explicit StrokeDecimator(double maxError);
+
+    /// Start a stroke at this point
+    void reset(const Point& first);
+
+    /**
+     * @return true if the point replaces the last point of the stroke, false if it must be appended
+     */
+    bool replacesLast(const Point& p);
+
+    /// A kept point every so many points at most, to bound the cost of a point
+    static constexpr size_t MAX_DROPPED = 64;
+
+private:
+    /// Whether the dropped point q is close enough to the segment from the last kept point to p
+    bool fits(const Point& q, const Point& p) const;
+
+    double maxError;
+
+    /// The last point kept in the stroke, before its last point
+    Point kept;
+    /// The last point of the stroke
+    std::optional<Point> last;
+    /// The points dropped between `kept` and `last`
+    std::vector<Point> dropped;
+};
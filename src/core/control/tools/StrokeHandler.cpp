@@ -2,7 +2,6 @@
 
 #include <algorithm>  // for max, min
 #include <cmath>      // for ceil, pow, abs
-#include <limits>     // for numeric_limits
 #include <memory>     // for unique_ptr, mak...
 #include <utility>    // for move
 #include <vector>     // for vector
@@ -12,12 +11,12 @@
 #include "control/Control.h"                                // for Control
 #include "control/ToolEnums.h"                              // for DRAWING_TYPE_ST...
 #include "control/ToolHandler.h"                            // for ToolHandler
+#include "control/jobs/ShapeRecognizerJob.h"                // for ShapeRecognizerJob
+#include "control/jobs/XournalScheduler.h"                  // for XournalScheduler
 #include "control/layer/LayerController.h"                  // for LayerController
 #include "control/settings/Settings.h"                      // for Settings
 #include "control/settings/SettingsEnums.h"                 // for EmptyLastPageAppendType
-#include "control/shaperecognizer/ShapeRecognizer.h"        // for ShapeRecognizer
 #include "control/tools/InputHandler.h"                     // for InputHandler::P...
-#include "control/tools/SnapToGridInputHandler.h"           // for SnapToGridInput...
 #include "gui/inputdevices/PositionInputData.h"             // for PositionInputData
 #include "model/Document.h"                                 // for Document
 #include "model/Element.h"
@@ -26,25 +25,27 @@
 #include "model/Stroke.h"                                   // for Stroke, STROKE_...
 #include "model/XojPage.h"                                  // for XojPage
 #include "undo/InsertUndoAction.h"                          // for InsertUndoAction
-#include "undo/RecognizerUndoAction.h"                      // for RecognizerUndoA...
 #include "undo/UndoRedoHandler.h"                           // for UndoRedoHandler
 #include "util/Assert.h"                                    // for xoj_assert
 #include "util/DispatchPool.h"                              // for DispatchPool
 #include "util/Range.h"                                     // for Range
-#include "util/Rectangle.h"                                 // for Rectangle, util
 #include "view/overlays/StrokeToolFilledHighlighterView.h"  // for StrokeToolFilledHighlighterView
 #include "view/overlays/StrokeToolFilledView.h"             // for StrokeToolFilledView
 #include "view/overlays/StrokeToolView.h"                   // for StrokeToolView
 
 #include "StrokeStabilizer.h"  // for Base, get
 
-using xoj::util::Rectangle;
-
 StrokeHandler::StrokeHandler(Control* control, const PageRef& page):
         InputHandler(control, page),
-        snappingHandler(control->getSettings()),
         stabilizer(StrokeStabilizer::get(control->getSettings())),
-        viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::StrokeToolView>>()) {}
+        viewPool(std::make_shared<xoj::util::DispatchPool<xoj::view::StrokeToolView>>()) {
+    if (Settings* settings = control->getSettings(); settings->isInkPrediction()) {
+        this->predictor.emplace(settings->getInkPredictionTime());
+    }
+    if (Settings* settings = control->getSettings(); settings->isInkDecimation()) {
+        this->decimationError = settings->getInkDecimationError();
+    }
+}
 
 StrokeHandler::~StrokeHandler() = default;
 
@@ -65,6 +66,18 @@ auto StrokeHandler::onMotionNotifyEvent(const PositionInputData& pos, double zoo
     }
 
     stabilizer->processEvent(pos);
+
+    if (this->predictor) {
+        this->predictor->addSample(pos.x / zoom, pos.y / zoom, pos.timestamp);
+    }
+
+    if (auto end = stabilizer->predictEndPoint(); end) {
+        // Preview the part of the stroke the stabilizer has not painted yet, to keep the ink close to the pen
+        this->viewPool->dispatch(xoj::view::StrokeToolView::PREDICTED_END_REQUEST, *end);
+    } else if (auto predicted = this->predictor ? this->predictor->predict() : std::nullopt; predicted) {
+        // Preview where the pen will be once the frame is displayed
+        this->viewPool->dispatch(xoj::view::StrokeToolView::PREDICTED_END_REQUEST, *predicted);
+    }
     return true;
 }
 
@@ -116,8 +129,13 @@ void StrokeHandler::paintTo(Point point) {
 }
 
 void StrokeHandler::drawSegmentTo(const Point& point) {
-
-    this->stroke->addPoint(this->hasPressure ? point : Point(point.x, point.y));
+    const Point p = this->hasPressure ? point : Point(point.x, point.y);
+    if (this->decimator && this->decimator->replacesLast(p)) {
+        // The view keeps the points it painted: only the stroke drops the last one
+        this->stroke->setLastPoint(p);
+    } else {
+        this->stroke->addPoint(p);
+    }
     this->viewPool->dispatch(xoj::view::StrokeToolView::ADD_POINT_REQUEST, this->stroke->getPointVector().back());
     return;
 }
@@ -179,19 +197,6 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos, double zo
         }
     }
 
-    ToolHandler* h = control->getToolHandler();
-    if (h->getDrawingType() == DRAWING_TYPE_SHAPE_RECOGNIZER) {
-        ShapeRecognizer reco;
-
-        auto recognized = reco.recognizePatterns(stroke.get(), control->getSettings()->getStrokeRecognizerMinSize());
-
-        if (recognized) {
-            // strokeRecognizerDetected handles the repainting and the deletion of the views.
-            strokeRecognizerDetected(std::move(recognized), layer);
-            return;
-        }
-    }
-
     auto ptr = stroke.get();
     Document* doc = control->getDocument();
     doc->lock();
@@ -203,54 +208,14 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos, double zo
     this->viewPool->dispatchAndClear(xoj::view::StrokeToolView::FINALIZATION_REQUEST, Range());
 
     page->fireElementChanged(ptr);
-}
 
-void StrokeHandler::strokeRecognizerDetected(std::unique_ptr<Stroke> recognized, Layer* layer) {
-    recognized->setWidth(stroke->hasPressure() ? stroke->getAvgPressure() : stroke->getWidth());
-
-    // snapping
-    if (control->getSettings()->getSnapRecognizedShapesEnabled()) {
-        Rectangle<double> oldSnappedBounds = recognized->getSnappedBounds();
-        Point topLeft = Point(oldSnappedBounds.x, oldSnappedBounds.y);
-        Point topLeftSnapped = snappingHandler.snapToGrid(topLeft, false);
-
-        recognized->move(topLeftSnapped.x - topLeft.x, topLeftSnapped.y - topLeft.y);
-        Rectangle<double> snappedBounds = recognized->getSnappedBounds();
-        Point belowRight = Point(snappedBounds.x + snappedBounds.width, snappedBounds.y + snappedBounds.height);
-        Point belowRightSnapped = snappingHandler.snapToGrid(belowRight, false);
-
-        double fx = (std::abs(snappedBounds.width) > std::numeric_limits<double>::epsilon()) ?
-                            (belowRightSnapped.x - topLeftSnapped.x) / snappedBounds.width :
-                            1;
-        double fy = (std::abs(snappedBounds.height) > std::numeric_limits<double>::epsilon()) ?
-                            (belowRightSnapped.y - topLeftSnapped.y) / snappedBounds.height :
-                            1;
-        recognized->scale(topLeftSnapped.x, topLeftSnapped.y, fx, fy, 0, false);
+    ToolHandler* h = control->getToolHandler();
+    if (h->getDrawingType() == DRAWING_TYPE_SHAPE_RECOGNIZER) {
+        // The recognition of long strokes takes a while: the stroke is replaced by the shape once it is recognized
+        auto* job = new ShapeRecognizerJob(control, page, layer, ptr, undo->getLastAction());
+        control->getScheduler()->addJob(job, JOB_PRIORITY_URGENT);
+        job->unref();
     }
-
-    UndoRedoHandler* undo = control->getUndoRedoHandler();
-    auto recognizedPtr = recognized.get();
-    auto strokePtr = stroke.get();
-    undo->addUndoAction(std::make_unique<RecognizerUndoAction>(page, layer, std::move(stroke), recognizedPtr));
-
-    Document* doc = control->getDocument();
-    doc->lock();
-    layer->addElement(std::move(recognized));
-    doc->unlock();
-
-    Range range(recognizedPtr->getX(), recognizedPtr->getY());
-    range.addPoint(recognizedPtr->getX() + recognizedPtr->getElementWidth(),
-                   recognizedPtr->getY() + recognizedPtr->getElementHeight());
-
-    range.addPoint(strokePtr->getX(), strokePtr->getY());
-    range.addPoint(strokePtr->getX() + strokePtr->getElementWidth(), strokePtr->getY() + strokePtr->getElementHeight());
-
-    this->viewPool->dispatch(xoj::view::StrokeToolView::STROKE_REPLACEMENT_REQUEST, *recognizedPtr);
-
-    // Blitt the new stroke to the page's buffer, delete all the views and refresh the area (so the recognized stroke
-    // gets displayed instead of the old one).
-    this->viewPool->dispatchAndClear(xoj::view::StrokeToolView::FINALIZATION_REQUEST, range);
-    page->fireElementChanged(recognizedPtr);
 }
 
 void StrokeHandler::onButtonPressEvent(const PositionInputData& pos, double zoom) {
@@ -265,8 +230,17 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos, double zoom
 
     const double width = this->hasPressure ? pos.pressure * stroke->getWidth() : Point::NO_PRESSURE;
     stroke->addPoint(Point(this->buttonDownPoint.x, this->buttonDownPoint.y, width));
+    if (this->decimationError > 0) {
+        this->decimator.emplace(this->decimationError / zoom);
+        this->decimator->reset(stroke->getPoint(0));
+    }
 
     stabilizer->initialize(this, zoom, pos);
+
+    if (this->predictor) {
+        this->predictor->reset();
+        this->predictor->addSample(this->buttonDownPoint.x, this->buttonDownPoint.y, pos.timestamp);
+    }
 }
 
 void StrokeHandler::onButtonDoublePressEvent(const PositionInputData&, double) {
@@ -11,15 +11,17 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
+#include <memory>    // for unique_ptr
+#include <optional>  // for optional
 
 #include <gdk/gdk.h>  // for GdkEventKey
 
 #include "model/PageRef.h"  // for PageRef
 #include "model/Point.h"    // for Point
 
-#include "InputHandler.h"            // for InputHandler
-#include "SnapToGridInputHandler.h"  // for SnapToGridInputHandler
+#include "InkPredictor.h"     // for InkPredictor
+#include "InputHandler.h"     // for InputHandler
+#include "StrokeDecimator.h"  // for StrokeDecimator
 
 class Control;
 class Layer;
@@ -83,11 +85,8 @@ protected:
      */
     void drawSegmentTo(const Point& point);
 
-    void strokeRecognizerDetected(std::unique_ptr<Stroke> recognized, Layer* layer);
-
 protected:
     Point buttonDownPoint;  // used for tapSelect and filtering - never snapped to grid.
-    SnapToGridInputHandler snappingHandler;
 
 private:
     /**
@@ -95,6 +94,17 @@ private:
      */
     std::unique_ptr<StrokeStabilizer::Base> stabilizer;
 
+    /**
+     * Extrapolates the events to preview the ink ahead of the pen, if enabled
+     */
+    std::optional<InkPredictor> predictor;
+
+    /**
+     * Drops the points which do not change the ink, if enabled. Its error is decimationError device pixels.
+     */
+    std::optional<StrokeDecimator> decimator;
+    double decimationError = 0.0;
+
     std::shared_ptr<xoj::util::DispatchPool<xoj::view::StrokeToolView>> viewPool;
 
     bool hasPressure;
@@ -82,6 +82,14 @@ void StrokeStabilizer::Active::finalizeStroke() {
     }
 }
 
+auto StrokeStabilizer::Active::predictEndPoint() -> std::optional<Point> {
+    if (!finalize) {
+        return std::nullopt;
+    }
+    Event ev = getLastEvent();
+    return Point(ev.x / zoom, ev.y / zoom);
+}
+
 void StrokeStabilizer::Active::quadraticSplineTo(const Event& ev) {
     /**
      * Using the last two points of the stroke, draw a spline quadratic segment to the coordinates of ev.
@@ -293,31 +301,45 @@ void StrokeStabilizer::Inertia::rebalanceStrokePressures() {
  * StrokeStabilizer::Arithmetic
  */
 void StrokeStabilizer::Arithmetic::recordFirstEvent(const PositionInputData& pos) {
-    eventBuffer.assign(Event(pos));  // Fill the buffer with copies of Event(pos)
+    Event ev(pos);
+    eventBuffer.assign(ev);  // Fill the buffer with copies of Event(pos)
+    resetSum(ev);
 }
 
 void StrokeStabilizer::Arithmetic::averageAndPaint(const Event& ev, guint32 timestamp) {
     /**
-     * Push the event and overwrite the oldest event in the buffer
+     * Push the event and overwrite the oldest event in the buffer, keeping the running sum up to date
      */
+    const Event oldest = eventBuffer.back();
     eventBuffer.push_front(ev);
 
-    /**
-     * Average the coordinates using an arithmetic mean
-     */
-    Event sum = std::accumulate(begin(eventBuffer), end(eventBuffer), Event(0, 0, 0), [](auto&& lhs, auto&& rhs) {
-        return Event(lhs.x + rhs.x, lhs.y + rhs.y, lhs.pressure + rhs.pressure);
-    });
+    if (++pushesSinceSum < bufferLength) {
+        sum.x += ev.x - oldest.x;
+        sum.y += ev.y - oldest.y;
+        sum.pressure += ev.pressure - oldest.pressure;
+    } else {
+        /**
+         * Sum the buffer again once in a while, so that the rounding errors of the running sum do not add up
+         */
+        sum = std::accumulate(begin(eventBuffer), end(eventBuffer), Event(0, 0, 0), [](auto&& lhs, auto&& rhs) {
+            return Event(lhs.x + rhs.x, lhs.y + rhs.y, lhs.pressure + rhs.pressure);
+        });
+        pushesSinceSum = 0;
+    }
 
     /**
-     * Rescale the averaged coordinates and draw
+     * Average the coordinates using an arithmetic mean, and draw
      */
     double d = static_cast<double>(eventBuffer.size());
-    sum.pressure /= d;
-    sum.x /= d;
-    sum.y /= d;
-    setLastPaintedEvent(sum);
-    drawEvent(sum);
+    Event mean(sum.x / d, sum.y / d, sum.pressure / d);
+    setLastPaintedEvent(mean);
+    drawEvent(mean);
+}
+
+void StrokeStabilizer::Arithmetic::resetSum(const Event& ev) {
+    double d = static_cast<double>(eventBuffer.size());
+    sum = Event(d * ev.x, d * ev.y, d * ev.pressure);
+    pushesSinceSum = 0;
 }
 
 auto StrokeStabilizer::Arithmetic::getLastEvent() -> Event { return eventBuffer.front(); }
@@ -325,6 +347,7 @@ auto StrokeStabilizer::Arithmetic::getLastEvent() -> Event { return eventBuffer.
 void StrokeStabilizer::Arithmetic::resetBuffer(Event& ev, guint32 timestamp) {
     if (eventBuffer.back() != ev) {
         eventBuffer.assign(ev);  // Replace the entire content of the buffer with copies of ev
+        resetSum(ev);
     }
 }
 
@@ -367,12 +390,14 @@ void StrokeStabilizer::VelocityGaussian::averageAndPaint(const Event& ev, guint3
     auto it = eventBuffer.cbegin();
     for (; it != eventBuffer.cend(); ++it) {
         /**
-         * The first weight is always 1
+         * The first weight is always 1. The weight is below MIN_WEIGHT exactly when the squared sum of velocities is
+         * above the cutoff: this spares the exponential of the first discarded event.
          */
-        weight = exp(-sumOfVelocities * sumOfVelocities / twoSigmaSquared);
-        if (weight < 0.01) {
+        const double squaredSum = sumOfVelocities * sumOfVelocities;
+        if (squaredSum > squaredSumCutoff) {
             break;
         }
+        weight = std::exp(-squaredSum / twoSigmaSquared);
         sumOfVelocities += (*it).velocity;
         weightedSum.x += weight * (*it).x;
         weightedSum.y += weight * (*it).y;
@@ -10,11 +10,12 @@
  */
 #pragma once
 
-#include <cmath>    // for hypot
-#include <cstddef>  // for size_t
-#include <deque>    // for deque
-#include <memory>   // for allocator, unique_ptr
-#include <string>   // for operator+, char_traits
+#include <cmath>     // for hypot, log
+#include <cstddef>   // for size_t
+#include <deque>     // for deque
+#include <memory>    // for allocator, unique_ptr
+#include <optional>  // for optional, nullopt
+#include <string>    // for operator+, char_traits
 
 #include <glib.h>  // for guint32
 
@@ -89,6 +90,15 @@ public:
      */
     virtual void finalizeStroke() {}
 
+    /**
+     * @brief Predict where the stroke would end if it were finalized now, so that the gap between the last painted
+     * point and the input device can be previewed. The prediction is not added to the stroke.
+     * @return The predicted end point, without pressure, or nothing if there is no gap to fill
+     *
+     * Nothing in the base class, which paints each event right away
+     */
+    virtual auto predictEndPoint() -> std::optional<Point> { return std::nullopt; }
+
     [[maybe_unused]] virtual auto getInfo() -> std::string { return "No stabilizer"; }
 
 protected:
@@ -125,6 +135,12 @@ public:
      */
     void finalizeStroke() override;
 
+    /**
+     * @brief Predict where the stroke would end if it were finalized now: at the last event's coordinates
+     * @return The predicted end point, or nothing if the stroke will not be finalized
+     */
+    auto predictEndPoint() -> std::optional<Point> override;
+
     /**
      * @brief Compute stabilized coordinates for the event and paints the obtained point
      * @param pos The MotionNotify event information
@@ -364,7 +380,10 @@ private:
  */
 class VelocityGaussian: virtual public Active {
 public:
-    VelocityGaussian(bool finalize, double sigma): Active(finalize), twoSigmaSquared(2 * sigma * sigma) {}
+    VelocityGaussian(bool finalize, double sigma):
+            Active(finalize),
+            twoSigmaSquared(2 * sigma * sigma),
+            squaredSumCutoff(-twoSigmaSquared * std::log(MIN_WEIGHT)) {}
     ~VelocityGaussian() override = default;
 
     [[maybe_unused]] auto getInfo() -> std::string override {
@@ -425,6 +444,13 @@ private:
      */
     const double twoSigmaSquared;
 
+    /**
+     * @brief The events whose weight is below MIN_WEIGHT are discarded. Their squared sum of velocities (see
+     * averageAndPaint()) is above squaredSumCutoff.
+     */
+    static constexpr double MIN_WEIGHT = 0.01;
+    const double squaredSumCutoff;
+
     /**
      * @brief Timestamp of the last event received. Used to compute the velocity of the next event
      */
@@ -474,6 +500,21 @@ protected:
     CircularBuffer<Event> eventBuffer;
 
 private:
+    /**
+     * @brief Set the running sum for a buffer filled with copies of ev
+     */
+    void resetSum(const Event& ev);
+
+    /**
+     * @brief Running sum of the events in the buffer, updated with each new event instead of summing the buffer again
+     */
+    Event sum;
+
+    /**
+     * @brief Number of events pushed since the buffer was last summed entirely
+     */
+    size_t pushesSinceSum = 0;
+
     /**
      * @brief Get the last event received by the stabilizer
      * @return The last event received
@@ -1,9 +1,10 @@
 #include "TextEditor.h"
 
-#include <cstring>  // for strcmp, size_t
-#include <memory>   // for allocator, make_unique, __shared_p...
-#include <string>   // for std::string()
-#include <utility>  // for move
+#include <algorithm>  // for clamp
+#include <cstring>    // for strcmp, size_t
+#include <memory>     // for allocator, make_unique, __shared_p...
+#include <string>     // for std::string()
+#include <utility>    // for move, exchange
 
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_B, GDK_KEY_ISO_Enter, GDK_...
 #include <glib-object.h>     // for g_object_get, g_object_unref, G_CA...
@@ -95,31 +96,6 @@ static auto cloneToCString(GtkTextBuffer* buf) {
  */
 static auto cloneToStdString(GtkTextBuffer* buf) -> std::string { return cloneToCString(buf).get(); }
 
-/**
- * @brief Clone the buffer's content and insert a string into the clone
- * This makes one less copy operation over using cloneToStdString followed by insert()
- * (The text is copied "only" twice, and not three times)
- */
-static auto cloneWithInsertToStdString(GtkTextBuffer* buf, std::string_view insertedStr) -> std::string {
-    GtkTextIter start, end;
-    gtk_text_buffer_get_bounds(buf, &start, &end);
-    GtkTextIter insertionPoint = getIteratorAtCursor(buf);
-
-    auto firstHalf = xoj::util::OwnedCString::assumeOwnership(gtk_text_iter_get_text(&start, &insertionPoint));
-    auto secondHalf = xoj::util::OwnedCString::assumeOwnership(gtk_text_iter_get_text(&insertionPoint, &end));
-
-    std::string_view str1(firstHalf);
-    std::string_view str2(secondHalf);
-
-    std::string res;
-    res.reserve(str1.length() + str2.length() + insertedStr.length());
-    res += str1;
-    res += insertedStr;
-    res += str2;
-
-    return res;
-}
-
 TextEditor::TextEditor(Control* control, const PageRef& page, GtkWidget* xournalWidget, double x, double y):
         control(control),
         page(page),
@@ -194,7 +170,8 @@ void TextEditor::replaceBufferContent(const std::string& text) {
 
 void TextEditor::setColor(Color color) {
     this->textElement->setColor(color);
-    repaintEditor(false);
+    // The whole text changes
+    this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION, this->previousBoundingBox);
 }
 
 void TextEditor::setFont(XojFont font) {
@@ -203,7 +180,9 @@ void TextEditor::setFont(XojFont font) {
 }
 
 void TextEditor::afterFontChange() {
-    this->textElement->updatePangoFont(this->layout.get());
+    this->textElement->updatePangoFont(this->layout.getPrototype());
+    this->layout.invalidate();
+    this->layoutStatus = LayoutStatus::NEEDS_COMPLETE_UPDATE;
     this->computeVirtualCursorPosition();
     this->repaintEditor();
 }
@@ -540,8 +519,8 @@ void TextEditor::moveCursor(GtkMovementStep step, int count, bool extendSelectio
 void TextEditor::findPos(GtkTextIter* iter, double xPos, double yPos) const {
     int index = 0;
     int trailing = 0;
-    pango_layout_xy_to_index(this->getUpToDateLayout(), round_cast<int>(xPos * PANGO_SCALE),
-                             round_cast<int>(yPos * PANGO_SCALE), &index, &trailing);
+    this->getUpToDateLayout().xyToIndex(round_cast<int>(xPos * PANGO_SCALE), round_cast<int>(yPos * PANGO_SCALE),
+                                        &index, &trailing);
     /*
      * trailing is non-zero iff the abscissa is past the middle of the grapheme.
      * In this case, it contains the length of the grapheme in utf8 char count.
@@ -590,14 +569,13 @@ void TextEditor::jumpALine(GtkTextIter* textIter, int count) {
         return;
     }
 
-    PangoLayoutLine* line = pango_layout_get_line_readonly(this->layout.get(), cursorLine + count);
-    if (line == nullptr) {
-        return;
-    }
-
+    // The texts are not wrapped: each buffer line is a paragraph of a single line
     int index = 0;
     int trailing = 0;
-    pango_layout_line_x_to_index(line, this->virtualCursorAbscissa, &index, &trailing);
+    if (!this->getUpToDateLayout().paragraphXToIndex(static_cast<size_t>(cursorLine + count),
+                                                     this->virtualCursorAbscissa, &index, &trailing)) {
+        return;
+    }
     /*
      * trailing is non-zero iff the abscissa is past the middle of the grapheme.
      * In this case, it contains the length of the grapheme in utf8 char count.
@@ -609,8 +587,7 @@ void TextEditor::jumpALine(GtkTextIter* textIter, int count) {
 void TextEditor::computeVirtualCursorPosition() {
     int offset = getByteOffsetOfCursor(this->buffer.get());
 
-    PangoRectangle rect = {0};
-    pango_layout_index_to_pos(this->getUpToDateLayout(), offset, &rect);
+    PangoRectangle rect = this->getUpToDateLayout().indexToPos(offset);
     this->virtualCursorAbscissa = rect.x;
 }
 
@@ -880,48 +857,58 @@ auto TextEditor::BlinkTimer::callback(TextEditor* te) -> bool {
     return false;
 }
 
-void TextEditor::setTextToPangoLayout(PangoLayout* pl) const {
+auto TextEditor::getParagraphContents() const -> std::vector<TextEditorLayout::ParagraphContent> {
     std::string_view preed(preeditString);
 
-    if (!preed.empty()) {
-        // When using an Input Method, we need to insert the preeditString into the text at the cursor location
-        std::string txt = cloneWithInsertToStdString(this->buffer.get(), preed);
-
-        int pos = getByteOffsetOfCursor(this->buffer.get());
-        xoj::util::PangoAttrListSPtr attrlist(pango_attr_list_new(), xoj::util::adopt);
-        pango_attr_list_splice(attrlist.get(), this->preeditAttrList.get(), pos, static_cast<int>(preed.length()));
-
-        pango_layout_set_attributes(pl, attrlist.get());
-
-        pango_layout_set_text(pl, txt.c_str(), static_cast<int>(txt.length()));
-    } else {
-        setSelectionAttributesToPangoLayout(pl);
-        pango_layout_set_text(pl, cloneToCString(this->buffer.get()).get(), -1);
+    GtkTextIter selectionStart;
+    GtkTextIter selectionEnd;
+    int selectionStartIndex = 0;
+    int selectionEndIndex = 0;
+    if (preed.empty() && gtk_text_buffer_get_selection_bounds(this->buffer.get(), &selectionStart, &selectionEnd)) {
+        selectionStartIndex = getByteOffsetOfIterator(selectionStart);
+        selectionEndIndex = getByteOffsetOfIterator(selectionEnd);
     }
-}
+    const GtkTextIter cursor = getIteratorAtCursor(this->buffer.get());
+    const int cursorLine = gtk_text_iter_get_line(&cursor);
 
-Color TextEditor::getSelectionColor() const { return this->control->getSettings()->getSelectionColor(); }
-
-void TextEditor::setSelectionAttributesToPangoLayout(PangoLayout* pl) const {
-    xoj::util::PangoAttrListSPtr attrlist(pango_attr_list_new(), xoj::util::adopt);
-
-    GtkTextIter start;
-    GtkTextIter end;
-    bool hasSelection = gtk_text_buffer_get_selection_bounds(this->buffer.get(), &start, &end);
+    // Not gtk_text_iter_forward_line(): it does not stop on an empty last line
+    const int lineCount = gtk_text_buffer_get_line_count(this->buffer.get());
+    std::vector<TextEditorLayout::ParagraphContent> contents;
+    contents.reserve(static_cast<size_t>(lineCount));
 
-    if (hasSelection) {
-        auto selectionColorU16 = Util::argb_to_ColorU16(this->getSelectionColor());
-        PangoAttribute* attrib =
-                pango_attr_background_new(selectionColorU16.red, selectionColorU16.green, selectionColorU16.blue);
-        attrib->start_index = static_cast<unsigned int>(getByteOffsetOfIterator(start));
-        attrib->end_index = static_cast<unsigned int>(getByteOffsetOfIterator(end));
-
-        pango_attr_list_insert(attrlist.get(), attrib);  // attrlist takes ownership of attrib
+    int index = 0;
+    for (int line = 0; line < lineCount; line++) {
+        GtkTextIter lineStart;
+        gtk_text_buffer_get_iter_at_line(this->buffer.get(), &lineStart, line);
+        GtkTextIter lineEnd = lineStart;
+        if (!gtk_text_iter_ends_line(&lineEnd)) {
+            gtk_text_iter_forward_to_line_end(&lineEnd);
+        }
+        auto& c = contents.emplace_back();
+        c.text = xoj::util::OwnedCString::assumeOwnership(gtk_text_iter_get_text(&lineStart, &lineEnd)).get();
+        c.index = index;
+
+        const int length = static_cast<int>(c.text.length());
+        c.selectionStart = std::clamp(selectionStartIndex - index, 0, length);
+        c.selectionEnd = std::clamp(selectionEndIndex - index, 0, length);
+
+        if (!preed.empty() && line == cursorLine) {
+            // When using an Input Method, we need to insert the preeditString into the text at the cursor location
+            c.preeditIndex = gtk_text_iter_get_line_index(&cursor);
+            c.preeditLength = static_cast<int>(preed.length());
+            c.preeditAttributes = this->preeditAttrList.get();
+            c.text.insert(static_cast<size_t>(c.preeditIndex), preed);
+            // The paragraphs after this one are shifted by the preedit string
+            index += c.preeditLength;
+        }
+        index += gtk_text_iter_get_bytes_in_line(&lineStart);
     }
 
-    pango_layout_set_attributes(pl, attrlist.get());
+    return contents;
 }
 
+Color TextEditor::getSelectionColor() const { return this->control->getSettings()->getSelectionColor(); }
+
 auto TextEditor::computeBoundingBox() const -> Range {
     /*
      * NB: we cannot rely on Text::calcSize directly, since it would not take the size changes due to the IM
@@ -929,7 +916,7 @@ auto TextEditor::computeBoundingBox() const -> Range {
      */
     int w = 0;
     int h = 0;
-    pango_layout_get_size(getUpToDateLayout(), &w, &h);
+    getUpToDateLayout().getSize(&w, &h);
     double width = (static_cast<double>(w)) / PANGO_SCALE;
     double height = (static_cast<double>(h)) / PANGO_SCALE;
     double x = textElement->getX();
@@ -941,19 +928,14 @@ auto TextEditor::computeBoundingBox() const -> Range {
     return res;
 }
 
-auto TextEditor::getUpToDateLayout() const -> PangoLayout* {
-    switch (layoutStatus) {
-        case LayoutStatus::NEEDS_COMPLETE_UPDATE:
-            setTextToPangoLayout(this->layout.get());
-            break;
-        case LayoutStatus::NEEDS_ATTRIBUTES_UPDATE:
-            setSelectionAttributesToPangoLayout(this->layout.get());
-            break;
-        case LayoutStatus::UP_TO_DATE:
-            break;
+auto TextEditor::getUpToDateLayout() const -> const TextEditorLayout& {
+    if (layoutStatus != LayoutStatus::UP_TO_DATE) {
+        // Only the paragraphs whose text or selection changed are laid out again
+        Range dirty = this->layout.update(getParagraphContents(), this->getSelectionColor());
+        this->layoutDirtyRange = this->layoutDirtyRange.unite(dirty);
     }
     layoutStatus = LayoutStatus::UP_TO_DATE;
-    return this->layout.get();
+    return this->layout;
 }
 
 auto TextEditor::getCursorBox() const -> const Range& { return this->cursorBox; }
@@ -969,8 +951,7 @@ auto TextEditor::computeCursorBox() const -> Range {
         const gchar* preeditText = this->preeditString.get();
         offset += static_cast<int>(g_utf8_offset_to_pointer(preeditText, preeditCursor) - preeditText);
     }
-    PangoRectangle rect = {0};
-    pango_layout_index_to_pos(getUpToDateLayout(), offset, &rect);
+    PangoRectangle rect = getUpToDateLayout().indexToPos(offset);
     const double ratio = 1.0 / PANGO_SCALE;
 
     // Warning: rect.width could be negative (e.g. for languages written from right to left).
@@ -980,13 +961,34 @@ auto TextEditor::computeCursorBox() const -> Range {
 }
 
 void TextEditor::repaintEditor(bool sizeChanged) {
-    Range dirtyRange(this->previousBoundingBox);
+    getUpToDateLayout();
+    Range dirtyRange = std::exchange(this->layoutDirtyRange, Range()).unite(this->cursorBox);
+    this->updateCursorBox();
+    dirtyRange = dirtyRange.unite(this->cursorBox);
+    dirtyRange.translate(this->textElement->getX(), this->textElement->getY());
+
     if (sizeChanged) {
-        this->previousBoundingBox = this->computeBoundingBox();
-        dirtyRange = dirtyRange.unite(this->previousBoundingBox);
+        Range box = this->computeBoundingBox();
+        const Range& old = this->previousBoundingBox;
+        if (box.minX != old.minX || box.minY != old.minY || box.maxX != old.maxX || box.maxY != old.maxY) {
+            // Only the edges of the frame move: the view pads each of them
+            for (const Range& r: {old, box}) {
+                this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION,
+                                         Range(r.minX, r.minY, r.maxX, r.minY));
+                this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION,
+                                         Range(r.minX, r.maxY, r.maxX, r.maxY));
+                this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION,
+                                         Range(r.minX, r.minY, r.minX, r.maxY));
+                this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION,
+                                         Range(r.maxX, r.minY, r.maxX, r.maxY));
+            }
+            this->previousBoundingBox = box;
+        }
+    }
+
+    if (dirtyRange.isValid()) {
+        this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION, dirtyRange);
     }
-    this->updateCursorBox();
-    this->viewPool->dispatch(xoj::view::TextEditionView::FLAG_DIRTY_REGION, dirtyRange);
 }
 
 void TextEditor::repaintCursorAfterChange() {
@@ -1081,7 +1083,7 @@ void TextEditor::initializeEditionAt(double x, double y) {
         text->setInEditing(true);
         this->page->fireElementChanged(text);
     }
-    this->layout = this->textElement->createPangoLayout();
+    this->layout.setPrototype(this->textElement->createPangoLayout());
     this->previousBoundingBox = Range(this->textElement->boundingRect());
     this->replaceBufferContent(this->textElement->getText());
 }
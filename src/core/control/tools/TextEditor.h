@@ -12,6 +12,7 @@
 #pragma once
 
 #include <string>  // for string
+#include <vector>  // for vector
 
 #include <gdk/gdk.h>      // for GdkEventKey
 #include <glib.h>         // for gint, gboolean, gchar
@@ -26,6 +27,8 @@
 #include "util/raii/GObjectSPtr.h"
 #include "util/raii/PangoSPtr.h"
 
+#include "TextEditorLayout.h"  // for TextEditorLayout
+
 class Text;
 class XojFont;
 class Control;
@@ -67,7 +70,8 @@ public:
     void setFont(XojFont font);
     void setColor(Color color);
 
-    PangoLayout* getUpToDateLayout() const;
+    /// The layouts of the paragraphs, updated with the content of the buffer
+    const TextEditorLayout& getUpToDateLayout() const;
 
     const std::shared_ptr<xoj::util::DispatchPool<xoj::view::TextEditionView>>& getViewPool() const;
 
@@ -102,15 +106,16 @@ private:
 
 private:
     /**
-     * @brief Add the text to the provided Pango layout.
-     * The added text contains both this->text, and the preedit string of the Input Method (this->preeditstring)
-     * This function also sets up the attributes of the preedit string (typically underlined)
+     * @brief Split the text into paragraphs for the layout.
+     * The text contains both the buffer, and the preedit string of the Input Method (this->preeditstring)
+     * This function also sets up the selection, and the attributes of the preedit string (typically underlined)
      */
-    void setTextToPangoLayout(PangoLayout* pl) const;
-
-    void setSelectionAttributesToPangoLayout(PangoLayout* pl) const;
+    std::vector<TextEditorLayout::ParagraphContent> getParagraphContents() const;
 
     Range computeBoundingBox() const;
+    /**
+     * @brief Repaint the paragraphs which changed since the last repaint, and the frame if the size changed
+     */
     void repaintEditor(bool sizeChanged = true);
 
     /**
@@ -162,10 +167,12 @@ private:
 
     xoj::util::GObjectSPtr<GtkIMContext> imContext;
     xoj::util::GObjectSPtr<GtkTextBuffer> buffer;
-    xoj::util::GObjectSPtr<PangoLayout> layout;
+    mutable TextEditorLayout layout;
 
     enum class LayoutStatus { UP_TO_DATE, NEEDS_ATTRIBUTES_UPDATE, NEEDS_COMPLETE_UPDATE };
     mutable LayoutStatus layoutStatus;
+    /// The area of the paragraphs laid out again since the last repaint, in TextBox coordinates
+    mutable Range layoutDirtyRange;
 
     // InputMethod preedit data
     int preeditCursor;
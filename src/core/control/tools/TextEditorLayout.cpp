@@ -0,0 +1,252 @@
+#include "TextEditorLayout.h"
+
+#include <algorithm>  // for max, min, upper_bound
+#include <iterator>   // for prev
+#include <utility>    // for move
+
+#include "util/raii/PangoSPtr.h"  // for PangoAttrListSPtr
+
+namespace {
+auto toRange(const PangoRectangle& r) -> Range {
+    return Range(static_cast<double>(r.x) / PANGO_SCALE, static_cast<double>(r.y) / PANGO_SCALE,
+                 static_cast<double>(r.x + r.width) / PANGO_SCALE, static_cast<double>(r.y + r.height) / PANGO_SCALE);
+}
+
+auto unite(const PangoRectangle& a, const PangoRectangle& b) -> PangoRectangle {
+    int x1 = std::min(a.x, b.x);
+    int y1 = std::min(a.y, b.y);
+    int x2 = std::max(a.x + a.width, b.x + b.width);
+    int y2 = std::max(a.y + a.height, b.y + b.height);
+    return {x1, y1, x2 - x1, y2 - y1};
+}
+
+auto samePlacement(const PangoRectangle& a, const PangoRectangle& b) -> bool {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+}  // namespace
+
+void TextEditorLayout::setPrototype(xoj::util::GObjectSPtr<PangoLayout> prototype) {
+    this->prototype = std::move(prototype);
+    invalidate();
+}
+
+auto TextEditorLayout::getPrototype() const -> PangoLayout* { return this->prototype.get(); }
+
+void TextEditorLayout::invalidate() { this->invalidated = true; }
+
+auto TextEditorLayout::isUpToDate(const Paragraph& p, const ParagraphContent& c) const -> bool {
+    bool selected = c.selectionEnd > c.selectionStart;
+    bool wasSelected = p.selectionEnd > p.selectionStart;
+    if (selected != wasSelected ||
+        (selected && (p.selectionStart != c.selectionStart || p.selectionEnd != c.selectionEnd))) {
+        return false;
+    }
+    // The attributes of the preedit string are not compared
+    return !p.hasPreedit && !c.preeditAttributes && p.text == c.text;
+}
+
+auto TextEditorLayout::createParagraph(ParagraphContent&& c) const -> Paragraph {
+    Paragraph p;
+    p.layout.reset(pango_layout_copy(this->prototype.get()), xoj::util::adopt);
+    p.text = std::move(c.text);
+    p.index = c.index;
+    p.selectionStart = c.selectionStart;
+    p.selectionEnd = c.selectionEnd;
+    p.hasPreedit = c.preeditAttributes != nullptr;
+
+    xoj::util::PangoAttrListSPtr attrlist(pango_attr_list_new(), xoj::util::adopt);
+    if (p.hasPreedit) {
+        // As in a single layout, the selection is not highlighted while the Input Method is composing
+        pango_attr_list_splice(attrlist.get(), c.preeditAttributes, c.preeditIndex, c.preeditLength);
+    } else if (p.selectionEnd > p.selectionStart) {
+        auto selectionColorU16 = Util::argb_to_ColorU16(this->selectionColor);
+        PangoAttribute* attrib =
+                pango_attr_background_new(selectionColorU16.red, selectionColorU16.green, selectionColorU16.blue);
+        attrib->start_index = static_cast<unsigned int>(p.selectionStart);
+        attrib->end_index = static_cast<unsigned int>(p.selectionEnd);
+
+        pango_attr_list_insert(attrlist.get(), attrib);  // attrlist takes ownership of attrib
+    }
+    pango_layout_set_attributes(p.layout.get(), attrlist.get());
+    pango_layout_set_text(p.layout.get(), p.text.c_str(), static_cast<int>(p.text.length()));
+    return p;
+}
+
+auto TextEditorLayout::update(std::vector<ParagraphContent> contents, Color selectionColor) -> Range {
+    Range dirty;
+
+    if (selectionColor != this->selectionColor) {
+        this->selectionColor = selectionColor;
+        // Only the highlighted paragraphs need to be laid out again
+        for (auto& p: this->paragraphs) {
+            if (p.selectionEnd > p.selectionStart) {
+                p.selectionStart = p.selectionEnd = -1;
+            }
+        }
+    }
+
+    std::vector<Paragraph> old = std::move(this->paragraphs);
+    this->paragraphs.clear();
+    if (this->invalidated) {
+        for (const auto& p: old) { dirty = dirty.unite(toRange(p.paintRect)); }
+        old.clear();
+        this->invalidated = false;
+    }
+
+    // Keep the paragraphs at the beginning and at the end which have not changed
+    const size_t n = contents.size();
+    const size_t m = old.size();
+    size_t prefix = 0;
+    while (prefix < std::min(n, m) && isUpToDate(old[prefix], contents[prefix])) { prefix++; }
+    size_t suffix = 0;
+    while (suffix < std::min(n, m) - prefix && isUpToDate(old[m - 1 - suffix], contents[n - 1 - suffix])) {
+        suffix++;
+    }
+
+    for (size_t i = prefix; i < m - suffix; i++) { dirty = dirty.unite(toRange(old[i].paintRect)); }
+
+    this->paragraphs.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        if (i < prefix) {
+            this->paragraphs.emplace_back(std::move(old[i]));
+        } else if (i >= n - suffix) {
+            this->paragraphs.emplace_back(std::move(old[m - n + i]));
+        } else {
+            this->paragraphs.emplace_back(createParagraph(std::move(contents[i])));
+            continue;
+        }
+        this->paragraphs.back().index = contents[i].index;
+    }
+
+    std::vector<PangoRectangle> previousRects;
+    previousRects.reserve(n);
+    for (const auto& p: this->paragraphs) { previousRects.push_back(p.paintRect); }
+
+    placeParagraphs();
+
+    // Repaint the paragraphs which were laid out or moved
+    for (size_t i = 0; i < n; i++) {
+        const Paragraph& p = this->paragraphs[i];
+        if (i >= prefix && i < n - suffix) {
+            dirty = dirty.unite(toRange(p.paintRect));
+        } else if (!samePlacement(previousRects[i], p.paintRect)) {
+            dirty = dirty.unite(toRange(previousRects[i])).unite(toRange(p.paintRect));
+        }
+    }
+    return dirty;
+}
+
+void TextEditorLayout::placeParagraphs() {
+    this->width = 0;
+    for (auto& p: this->paragraphs) {
+        pango_layout_get_size(p.layout.get(), &p.width, &p.height);
+        this->width = std::max(this->width, p.width);
+    }
+
+    int y = 0;
+#if PANGO_VERSION_CHECK(1, 48, 5)
+    // The layouts have a line spacing factor of 1 (see Text::createPangoLayout): consecutive baselines are one line
+    // height apart
+    int baseline = 0;
+#endif
+    for (size_t i = 0; i < this->paragraphs.size(); i++) {
+        Paragraph& p = this->paragraphs[i];
+        PangoLayoutLine* line = pango_layout_get_line_readonly(p.layout.get(), 0);
+
+#if PANGO_VERSION_CHECK(1, 48, 5)
+        if (i == 0) {
+            baseline = pango_layout_get_baseline(p.layout.get());
+        } else {
+            int lineHeight = 0;
+            pango_layout_line_get_height(line, &lineHeight);
+            baseline += lineHeight;
+        }
+        p.y = baseline - pango_layout_get_baseline(p.layout.get());
+#else
+        p.y = y;
+#endif
+        y = p.y + p.height;
+
+        // A paragraph written from right to left is aligned on the right of a single layout
+        p.x = line && line->resolved_dir == PANGO_DIRECTION_RTL ? this->width - p.width : 0;
+
+        PangoRectangle ink;
+        PangoRectangle logical;
+        pango_layout_get_extents(p.layout.get(), &ink, &logical);
+        p.paintRect = unite(ink, logical);
+        p.paintRect.x += p.x;
+        p.paintRect.y += p.y;
+    }
+    this->height = y;
+}
+
+void TextEditorLayout::getSize(int* width, int* height) const {
+    *width = this->width;
+    *height = this->height;
+}
+
+auto TextEditorLayout::paragraphAtIndex(int index) const -> const Paragraph& {
+    auto it = std::upper_bound(this->paragraphs.begin(), this->paragraphs.end(), index,
+                               [](int i, const Paragraph& p) { return i < p.index; });
+    return it == this->paragraphs.begin() ? *it : *std::prev(it);
+}
+
+auto TextEditorLayout::paragraphAtY(int y) const -> const Paragraph& {
+    auto it = std::upper_bound(this->paragraphs.begin(), this->paragraphs.end(), y,
+                               [](int y, const Paragraph& p) { return y < p.y; });
+    return it == this->paragraphs.begin() ? *it : *std::prev(it);
+}
+
+auto TextEditorLayout::indexToPos(int index) const -> PangoRectangle {
+    PangoRectangle rect = {0};
+    if (this->paragraphs.empty()) {
+        return rect;
+    }
+    const Paragraph& p = paragraphAtIndex(index);
+    int localIndex = std::min(index - p.index, static_cast<int>(p.text.length()));
+    pango_layout_index_to_pos(p.layout.get(), localIndex, &rect);
+    rect.x += p.x;
+    rect.y += p.y;
+    return rect;
+}
+
+void TextEditorLayout::xyToIndex(int x, int y, int* index, int* trailing) const {
+    *index = 0;
+    *trailing = 0;
+    if (this->paragraphs.empty()) {
+        return;
+    }
+    const Paragraph& p = paragraphAtY(y);
+    pango_layout_xy_to_index(p.layout.get(), x - p.x, y - p.y, index, trailing);
+    *index += p.index;
+}
+
+auto TextEditorLayout::getParagraphCount() const -> size_t { return this->paragraphs.size(); }
+
+auto TextEditorLayout::paragraphXToIndex(size_t paragraph, int x, int* index, int* trailing) const -> bool {
+    if (paragraph >= this->paragraphs.size()) {
+        return false;
+    }
+    const Paragraph& p = this->paragraphs[paragraph];
+    PangoLayoutLine* line = pango_layout_get_line_readonly(p.layout.get(), 0);
+    if (line == nullptr) {
+        return false;
+    }
+    pango_layout_line_x_to_index(line, x - p.x, index, trailing);
+    *index += p.index;
+    return true;
+}
+
+void TextEditorLayout::forEachLayout(double minY, double maxY,
+                                     const std::function<void(PangoLayout*, double, double)>& f) const {
+    for (const auto& p: this->paragraphs) {
+        Range r = toRange(p.paintRect);
+        if (r.maxY < minY) {
+            continue;
+        }
+        if (r.minY > maxY) {
+            break;
+        }
+        f(p.layout.get(), static_cast<double>(p.x) / PANGO_SCALE, static_cast<double>(p.y) / PANGO_SCALE);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Xournal++
+ *
+ * The layout of a text under edition
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <string>      // for string
+#include <vector>      // for vector
+
+#include <pango/pango.h>  // for PangoLayout, PangoAttrList, PangoRectangle
+
+#include "util/Color.h"             // for Color
+#include "util/Range.h"             // for Range
+#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+
+/**
+ * @brief The Pango layouts of a text under edition, one per paragraph.
+ *
+ * Pango lays a layout out again as a whole whenever its text or its attributes change. Here, a change only lays out
+ * the paragraphs it touches, and the paragraphs are placed one under the other, as the lines of a single layout.
+ * The texts are not wrapped: each paragraph is a single line.
+ *
+ * The positions are in Pango units, relative to the upper left corner of the text. The indices are byte indices in
+ * the text, including the preedit string of the Input Method.
+ */
+class TextEditorLayout {
+public:
+    /// The content of a paragraph, given to update()
+    struct ParagraphContent {
+        /// Without the paragraph separator, with the preedit string
+        std::string text;
+        /// Index of the first byte of the paragraph in the text
+        int index = 0;
+        /// Selected bytes of the paragraph, if selectionEnd > selectionStart
+        int selectionStart = 0;
+        int selectionEnd = 0;
+        /// Attributes of the preedit string, if the paragraph contains it
+        PangoAttrList* preeditAttributes = nullptr;
+        int preeditIndex = 0;
+        int preeditLength = 0;
+    };
+
+    TextEditorLayout() = default;
+
+    /**
+     * @param prototype Empty layout, whose font and settings the paragraphs copy
+     */
+    void setPrototype(xoj::util::GObjectSPtr<PangoLayout> prototype);
+    PangoLayout* getPrototype() const;
+
+    /// Lay out all the paragraphs again on the next update, e.g. after the font of the prototype changed
+    void invalidate();
+
+    /**
+     * Update the paragraphs. Only the paragraphs whose text or attributes changed are laid out again.
+     * @return The area to repaint, in text coordinates (i.e. not in Pango units)
+     */
+    Range update(std::vector<ParagraphContent> contents, Color selectionColor);
+
+    void getSize(int* width, int* height) const;
+
+    PangoRectangle indexToPos(int index) const;
+    void xyToIndex(int x, int y, int* index, int* trailing) const;
+
+    size_t getParagraphCount() const;
+    /**
+     * Index at the abscissa x on the paragraph
+     * @return false if there is no such paragraph
+     */
+    bool paragraphXToIndex(size_t paragraph, int x, int* index, int* trailing) const;
+
+    /**
+     * Call f on the layouts of the paragraphs intersecting the band [minY, maxY] of the text, with the position of
+     * their upper left corner. The band and the positions are in text coordinates.
+     */
+    void forEachLayout(double minY, double maxY, const std::function<void(PangoLayout*, double, double)>& f) const;
+
+private:
+    struct Paragraph {
+        xoj::util::GObjectSPtr<PangoLayout> layout;
+
+        std::string text;
+        int index = 0;
+        int selectionStart = 0;
+        int selectionEnd = 0;
+        bool hasPreedit = false;
+
+        /// Position of the layout
+        int x = 0;
+        int y = 0;
+        /// Logical size
+        int width = 0;
+        int height = 0;
+        /// Union of the logical and ink rectangles, at the position of the layout
+        PangoRectangle paintRect{};
+    };
+
+    bool isUpToDate(const Paragraph& p, const ParagraphContent& c) const;
+    Paragraph createParagraph(ParagraphContent&& c) const;
+
+    /// Place the paragraphs one under the other, and compute the size of the text
+    void placeParagraphs();
+
+    /// The paragraph containing the byte index
+    const Paragraph& paragraphAtIndex(int index) const;
+    /// The paragraph at the ordinate y
+    const Paragraph& paragraphAtY(int y) const;
+
+private:
+    xoj::util::GObjectSPtr<PangoLayout> prototype;
+
+    std::vector<Paragraph> paragraphs;
+    bool invalidated = true;
+    Color selectionColor{};
+
+    int width = 0;
+    int height = 0;
+};
@@ -10,6 +10,7 @@
 #include "gui/LegacyRedrawable.h"                  // for Redrawable
 #include "gui/inputdevices/InputEvents.h"          // for KeyEvent
 #include "model/Element.h"                         // for Element
+#include "model/ElementInsertionPosition.h"        // for InsertionOrderRef
 #include "model/Layer.h"                           // for Layer
 #include "model/XojPage.h"                         // for XojPage
 #include "undo/MoveUndoAction.h"                   // for MoveUndoAction
@@ -43,11 +44,17 @@ void VerticalToolHandler::adoptElements(const Side side) {
     this->elements.clear();
 
     // Add new elements based on position
+    InsertionOrderRef adopted;
+    Element::Index pos = 0;
     for (Element* e: xoj::refElementContainer(this->layer->getElements())) {
         if ((side == Side::Below && e->getY() >= this->startY) ||
             (side == Side::Above && e->getY() + e->getElementHeight() <= this->startY)) {
-            this->elements.push_back(this->layer->removeElement(e).e);
+            adopted.emplace_back(e, pos);
         }
+        pos++;
+    }
+    for (auto&& [e, _]: this->layer->removeElementsAt(adopted)) {
+        this->elements.push_back(std::move(e));
     }
 
     Range rg = this->ownedElementsOriginalBoundingBox;
@@ -1,20 +1,18 @@
 #include "DoubleAttribute.h"
 
-#include <string>  // for allocator, string
-
-#include <glib.h>  // for g_ascii_formatd, G_ASCII_DTOSTR_B...
+#include <array>    // for array
+#include <cstddef>  // for size_t
 
 #include "control/xml/Attribute.h"  // for XMLAttribute
+#include "util/NumberListWriter.h"  // for formatDouble
 #include "util/OutputStream.h"      // for OutputStream
-#include "util/Util.h"              // for PRECISION_FORMAT_STRING
 
 DoubleAttribute::DoubleAttribute(const char* name, double value): XMLAttribute(name) { this->value = value; }
 
 DoubleAttribute::~DoubleAttribute() = default;
 
 void DoubleAttribute::writeOut(OutputStream* out) {
-    char str[G_ASCII_DTOSTR_BUF_SIZE];
-    // g_ascii_ version uses C locale always.
-    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
-    out->write(str);
+    std::array<char, xoj::util::FORMATTED_DOUBLE_MAX_LENGTH> str{};
+    const char* end = xoj::util::formatDouble(str.data(), value);
+    out->write(str.data(), static_cast<size_t>(end - str.data()));
 }
@@ -1,8 +1,12 @@
 #include "XmlImageNode.h"
 
+#include <string>   // for string
+#include <utility>  // for move
+
 #include <glib.h>  // for g_base64_encode, g_free, gchar, g_e...
 
 #include "control/xml/XmlNode.h"  // for XmlNode
+#include "model/ImageBuffer.h"    // for ImageBuffer
 #include "util/OutputStream.h"    // for OutputStream
 
 XmlImageNode::XmlImageNode(const char* tag): XmlNode(tag) {
@@ -24,6 +28,8 @@ void XmlImageNode::setImage(cairo_surface_t* img) {
     this->img = cairo_surface_reference(img);
 }
 
+void XmlImageNode::setImage(std::shared_ptr<const ImageBuffer> data) { this->data = std::move(data); }
+
 auto XmlImageNode::pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length)
         -> cairo_status_t {
     for (unsigned int i = 0; i < length; i++, image->pos++) {
@@ -39,6 +45,11 @@ auto XmlImageNode::pngWriteFunction(XmlImageNode* image, const unsigned char* da
     return CAIRO_STATUS_SUCCESS;
 }
 
+auto XmlImageNode::getSurface() const -> xoj::util::CairoSurfaceSPtr {
+    // A new reference, as the surface of the buffer may be evicted from the cache meanwhile
+    return this->data ? this->data->getSurface() : xoj::util::CairoSurfaceSPtr(this->img, xoj::util::ref);
+}
+
 void XmlImageNode::writeOut(OutputStream* out) {
     out->write("<");
     out->write(tag);
@@ -46,12 +57,18 @@ void XmlImageNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    if (this->img == nullptr) {
+    if (this->data && this->data->isPng()) {
+        // No need to encode the image again
+        const std::string& png = this->data->getData();
+        gchar* base64_str = g_base64_encode(reinterpret_cast<const guchar*>(png.data()), png.size());
+        out->write(base64_str);
+        g_free(base64_str);
+    } else if (xoj::util::CairoSurfaceSPtr surface = getSurface(); !surface) {
         g_error("XmlImageNode::writeOut(); this->img == nullptr");
     } else {
         this->out = out;
         this->pos = 0;
-        cairo_surface_write_to_png_stream(this->img, reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
+        cairo_surface_write_to_png_stream(surface.get(), reinterpret_cast<cairo_write_func_t>(&pngWriteFunction), this);
         gchar* base64_str = g_base64_encode(this->buffer, this->pos);
         out->write(base64_str);
         g_free(base64_str);
@@ -11,10 +11,15 @@
 
 #pragma once
 
+#include <memory>  // for shared_ptr
+
 #include <cairo.h>  // for cairo_surface_t, cairo_status_t
 
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
 #include "XmlNode.h"  // for XmlNode
 
+class ImageBuffer;
 class OutputStream;
 
 class XmlImageNode: public XmlNode {
@@ -25,12 +30,21 @@ public:
 public:
     void setImage(cairo_surface_t* img);
 
+    /**
+     * Write the data of the buffer, or the PNG encoding of its surface if it is not a PNG image
+     */
+    void setImage(std::shared_ptr<const ImageBuffer> data);
+
     static cairo_status_t pngWriteFunction(XmlImageNode* image, const unsigned char* data, unsigned int length);
 
     void writeOut(OutputStream* out) override;
 
+private:
+    xoj::util::CairoSurfaceSPtr getSurface() const;
+
 private:
     cairo_surface_t* img;
+    std::shared_ptr<const ImageBuffer> data;
 
     OutputStream* out;
     unsigned int pos;
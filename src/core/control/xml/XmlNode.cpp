@@ -42,14 +42,13 @@ void XmlNode::setAttrib(const char* attrib, std::vector<double> values) {
 }
 
 void XmlNode::writeOut(OutputStream* out, ProgressListener* listener) {
-    out->write("<");
-    out->write(tag);
-    writeAttributes(out);
-
     if (children.empty()) {
+        out->write("<");
+        out->write(tag);
+        writeAttributes(out);
         out->write("/>\n");
     } else {
-        out->write(">\n");
+        writeOpeningTag(out);
 
         if (listener) {
             listener->setMaximumState(children.size());
@@ -65,14 +64,33 @@ void XmlNode::writeOut(OutputStream* out, ProgressListener* listener) {
             i++;
         }
 
-        out->write("</");
-        out->write(tag);
-        out->write(">\n");
+        writeClosingTag(out);
+    }
+}
+
+void XmlNode::writeOpeningTag(OutputStream* out) {
+    out->write("<");
+    out->write(tag);
+    writeAttributes(out);
+    out->write(">\n");
+}
+
+void XmlNode::writeChildren(OutputStream* out) {
+    for (auto& node: children) {
+        node->writeOut(out);
     }
 }
 
+void XmlNode::writeClosingTag(OutputStream* out) {
+    out->write("</");
+    out->write(tag);
+    out->write(">\n");
+}
+
 void XmlNode::addChild(XmlNode* node) { children.emplace_back(node); }
 
+void XmlNode::clearChildren() { children.clear(); }
+
 void XmlNode::putAttrib(XMLAttribute* a) {
     for (auto& attrib: attributes) {
         if (attrib->getName() == a->getName()) {
@@ -38,7 +38,15 @@ public:
 
     virtual void writeOut(OutputStream* out) { writeOut(out, nullptr); }
 
+    /**
+     * Write the node in pieces, so that its children can be created, written and freed one after the other
+     */
+    void writeOpeningTag(OutputStream* out);
+    void writeChildren(OutputStream* out);
+    void writeClosingTag(OutputStream* out);
+
     void addChild(XmlNode* node);
+    void clearChildren();
 
 protected:
     void putAttrib(XMLAttribute* a);
@@ -4,8 +4,8 @@
 #include <utility>    // for move
 
 #include "control/xml/XmlAudioNode.h"  // for XmlAudioNode
+#include "util/NumberListWriter.h"     // for NumberListWriter
 #include "util/OutputStream.h"         // for OutputStream
-#include "util/Util.h"                 // for writeCoordinateString
 
 XmlPointNode::XmlPointNode(const char* tag): XmlAudioNode(tag) {}
 
@@ -17,15 +17,20 @@ void XmlPointNode::writeOut(OutputStream* out) {
     out->write(tag);
     writeAttributes(out);
 
-    out->write(">");
+    if (points.empty()) {
+        // The points are stored elsewhere
+        out->write("/>\n");
+        return;
+    }
 
-    auto pointIter = points.begin();
-    Util::writeCoordinateString(out, pointIter->x, pointIter->y);
-    ++pointIter;
-    for (; pointIter != points.end(); ++pointIter) {
-        out->write(" ");
+    out->write(">");
 
-        Util::writeCoordinateString(out, pointIter->x, pointIter->y);
+    {
+        xoj::util::NumberListWriter writer(out);
+        for (const Point& p: points) {
+            writer.write(p.x);
+            writer.write(p.y);
+        }
     }
 
     out->write("</");
@@ -1,11 +1,16 @@
 #include "XmlTexNode.h"
 
+#include <string>   // for string
+#include <utility>  // for move
+
 #include <glib.h>  // for g_base64_encode, g_free, gchar, guchar
 
 #include "control/xml/XmlNode.h"  // for XmlNode
+#include "model/ImageBuffer.h"    // for ImageBuffer
 #include "util/OutputStream.h"    // for OutputStream
 
-XmlTexNode::XmlTexNode(const char* tag, std::string&& binaryData): XmlNode(tag), binaryData(binaryData) {}
+XmlTexNode::XmlTexNode(const char* tag, std::shared_ptr<const ImageBuffer> binaryData):
+        XmlNode(tag), binaryData(std::move(binaryData)) {}
 
 XmlTexNode::~XmlTexNode() = default;
 
@@ -16,10 +21,12 @@ void XmlTexNode::writeOut(OutputStream* out) {
 
     out->write(">");
 
-    gchar* base64_str =
-            g_base64_encode(reinterpret_cast<const guchar*>(this->binaryData.c_str()), this->binaryData.length());
-    out->write(base64_str);
-    g_free(base64_str);
+    if (this->binaryData) {
+        const std::string& data = this->binaryData->getData();
+        gchar* base64_str = g_base64_encode(reinterpret_cast<const guchar*>(data.data()), data.size());
+        out->write(base64_str);
+        g_free(base64_str);
+    }
 
     out->write("</");
     out->write(tag);
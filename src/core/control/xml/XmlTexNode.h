@@ -11,15 +11,16 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <memory>  // for shared_ptr
 
 #include "XmlNode.h"  // for XmlNode
 
+class ImageBuffer;
 class OutputStream;
 
 class XmlTexNode: public XmlNode {
 public:
-    XmlTexNode(const char* tag, std::string&& binaryData);
+    XmlTexNode(const char* tag, std::shared_ptr<const ImageBuffer> binaryData);
     virtual ~XmlTexNode();
 
 public:
@@ -29,5 +30,5 @@ private:
     /**
      * Binary .PNG or .PDF
      */
-    std::string binaryData;
+    std::shared_ptr<const ImageBuffer> binaryData;
 };
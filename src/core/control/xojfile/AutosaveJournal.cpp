@@ -0,0 +1,118 @@
+#include "AutosaveJournal.h"
+
+#include <algorithm>  // for all_of, equal
+
+#include "model/Document.h"  // for Document
+#include "model/Layer.h"     // for Layer
+#include "model/XojPage.h"   // for XojPage
+#include "util/i18n.h"       // for FS, _F
+
+#include "LoadHandler.h"  // for LoadHandler
+
+AutosaveJournal::PageState::PageState(const PageRef& p):
+        page(p),
+        changeCount(p->getChangeCount()),
+        width(p->getWidth()),
+        height(p->getHeight()),
+        backgroundType(p->getBackgroundType()),
+        backgroundColor(p->getBackgroundColor()),
+        pdfPageNr(p->getPdfPageNr()),
+        backgroundName(p->backgroundHasName() ? p->getBackgroundName() : std::string()),
+        backgroundImage(p->getBackgroundImage()) {
+    // Do not read the pages which were not needed since the document was opened: they cannot have changed
+    if (p->isContentLoaded()) {
+        for (const Layer* l: *p->getLayers()) { layers.emplace_back(l, l->getRevision()); }
+    }
+}
+
+auto AutosaveJournal::PageState::sameBackground(const PageRef& p) -> bool {
+    return width == p->getWidth() && height == p->getHeight() && backgroundType == p->getBackgroundType() &&
+           backgroundColor == p->getBackgroundColor() && pdfPageNr == p->getPdfPageNr() &&
+           backgroundName == (p->backgroundHasName() ? p->getBackgroundName() : std::string()) &&
+           backgroundImage == p->getBackgroundImage();
+}
+
+auto AutosaveJournal::PageState::matches(const PageRef& p) -> bool {
+    if (page.lock() != p || changeCount != p->getChangeCount() || !sameBackground(p)) {
+        return false;
+    }
+    if (!p->isContentLoaded()) {
+        return layers.empty();
+    }
+    const auto& pageLayers = *p->getLayers();
+    return std::equal(pageLayers.begin(), pageLayers.end(), layers.begin(), layers.end(),
+                      [](const Layer* l, const auto& saved) {
+                          return l == saved.first && l->getRevision() == saved.second;
+                      });
+}
+
+auto AutosaveJournal::prepareSave(Document* doc, const fs::path& autosaveFile, std::vector<size_t>& modified)
+        -> Target {
+    this->pendingPages.clear();
+    for (size_t i = 0; i < doc->getPageCount(); i++) { this->pendingPages.emplace_back(doc->getPage(i)); }
+
+    modified.clear();
+    bool samePages = this->savedFile == autosaveFile && this->savedPages.size() == doc->getPageCount() &&
+                     this->journalWrites < MAX_JOURNAL_WRITES && fs::exists(autosaveFile);
+    for (size_t i = 0; samePages && i < doc->getPageCount(); i++) {
+        PageRef p = doc->getPage(i);
+        if (this->savedPages[i].page.lock() != p) {
+            samePages = false;
+        } else if (!this->savedPages[i].matches(p)) {
+            modified.push_back(i);
+        }
+    }
+
+    // Once most pages were modified, the journal is not worth it anymore
+    if (!samePages || 2 * modified.size() > doc->getPageCount()) {
+        this->pendingTarget = Target::DOCUMENT;
+    } else if (modified.empty()) {
+        this->pendingTarget = Target::UP_TO_DATE;
+    } else {
+        this->pendingTarget = Target::JOURNAL;
+    }
+    return this->pendingTarget;
+}
+
+void AutosaveJournal::saved(const fs::path& autosaveFile) {
+    if (this->pendingTarget == Target::DOCUMENT) {
+        this->savedPages = std::move(this->pendingPages);
+        this->savedFile = autosaveFile;
+        this->journalWrites = 0;
+    } else if (this->pendingTarget == Target::JOURNAL) {
+        // The journal holds all the pages modified since the full autosave: the reference stays the same
+        this->journalWrites++;
+    }
+    this->pendingPages.clear();
+}
+
+auto AutosaveJournal::getJournalPath(const fs::path& autosaveFile) -> fs::path {
+    return fs::path(autosaveFile) += ".journal";
+}
+
+auto AutosaveJournal::apply(Document* doc, const fs::path& autosaveFile, std::string& error) -> bool {
+    const fs::path journalFile = getJournalPath(autosaveFile);
+    if (!fs::exists(journalFile)) {
+        return true;
+    }
+
+    LoadHandler handler;
+    auto journal = handler.loadDocument(journalFile);
+    if (!journal) {
+        error = handler.getLastError();
+        return false;
+    }
+
+    const auto& indices = handler.getJournalPages();
+    if (handler.getJournalBasePageCount() != doc->getPageCount() || indices.size() != journal->getPageCount() ||
+        !std::all_of(indices.begin(), indices.end(), [doc](size_t i) { return i < doc->getPageCount(); })) {
+        error = FS(_F("The autosave journal \"{1}\" does not match the autosave file") % journalFile.u8string());
+        return false;
+    }
+
+    for (size_t i = 0; i < indices.size(); i++) {
+        doc->deletePage(indices[i]);
+        doc->insertPage(journal->getPage(i), indices[i]);
+    }
+    return true;
+}
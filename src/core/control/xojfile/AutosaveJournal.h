@@ -0,0 +1,110 @@
+/*
+ * Xournal++
+ *
+ * Autosave of the pages modified since the last full autosave
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <memory>   // for weak_ptr
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "model/BackgroundImage.h"  // for BackgroundImage
+#include "model/PageRef.h"          // for PageRef
+#include "model/PageType.h"         // for PageType
+#include "util/Color.h"             // for Color
+
+#include "filesystem.h"  // for path
+
+class Document;
+class Layer;
+class XojPage;
+
+/**
+ * The autosave file is only rewritten from time to time. In between, the pages modified since it was written are
+ * saved in a journal next to it: a document with these pages only, whose root node lists their indices.
+ * The journal is applied when the autosave file is opened.
+ *
+ * A full autosave is written when the pages were added, removed or reordered, when most pages were modified or when
+ * the journal was written MAX_JOURNAL_WRITES times.
+ */
+class AutosaveJournal {
+public:
+    enum class Target {
+        /// The whole document is to be written to the autosave file
+        DOCUMENT,
+        /// The modified pages are to be written to the journal
+        JOURNAL,
+        /// The autosave file is up to date: the journal is to be removed
+        UP_TO_DATE
+    };
+
+    /**
+     * Find what the next autosave of doc has to write: either the whole document or its journal.
+     * The document must be locked.
+     *
+     * @param modified Receives the indices of the pages to write to the journal
+     */
+    Target prepareSave(Document* doc, const fs::path& autosaveFile, std::vector<size_t>& modified);
+
+    /**
+     * The file prepared by prepareSave() was written
+     */
+    void saved(const fs::path& autosaveFile);
+
+    static fs::path getJournalPath(const fs::path& autosaveFile);
+
+    /**
+     * Replace the pages of doc, read from autosaveFile, by the ones of its journal (if there is one)
+     * @return false if the journal could not be applied
+     */
+    static bool apply(Document* doc, const fs::path& autosaveFile, std::string& error);
+
+public:
+    static constexpr int MAX_JOURNAL_WRITES = 10;
+
+    /// The state of a page when it was saved (also used by RecoveryJournal)
+    struct PageState {
+        explicit PageState(const PageRef& p);
+
+        /**
+         * @return true if p is the page, unchanged
+         */
+        bool matches(const PageRef& p);
+
+        /**
+         * @return true if p has the same size and background as the page had
+         */
+        bool sameBackground(const PageRef& p);
+
+        std::weak_ptr<XojPage> page;
+        uint64_t changeCount;
+        /// Empty if the content of the page was not loaded, see XojPage::setContentLoader()
+        std::vector<std::pair<const Layer*, uint64_t>> layers;
+        double width;
+        double height;
+        PageType backgroundType;
+        Color backgroundColor;
+        size_t pdfPageNr;
+        std::string backgroundName;
+        BackgroundImage backgroundImage;
+    };
+
+private:
+    /// State of the pages when the autosave file was written
+    std::vector<PageState> savedPages;
+    fs::path savedFile;
+    int journalWrites = 0;
+
+    std::vector<PageState> pendingPages;
+    Target pendingTarget = Target::DOCUMENT;
+};
@@ -0,0 +1,62 @@
+#include "BinaryPointData.h"
+
+#include <cstdint>  // for uint32_t, uint8_t
+#include <cstring>  // for memcpy
+
+namespace {
+constexpr size_t VALUE_SIZE = sizeof(uint32_t);
+
+void appendValue(std::string& data, double value) {
+    const auto f = static_cast<float>(value);
+    uint32_t bits = 0;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const char bytes[VALUE_SIZE] = {static_cast<char>(bits & 0xffU), static_cast<char>((bits >> 8U) & 0xffU),
+                                    static_cast<char>((bits >> 16U) & 0xffU), static_cast<char>(bits >> 24U)};
+    data.append(bytes, VALUE_SIZE);
+}
+
+auto readValue(const char* p) -> double {
+    const auto* b = reinterpret_cast<const uint8_t*>(p);
+    const uint32_t bits = static_cast<uint32_t>(b[0]) | static_cast<uint32_t>(b[1]) << 8U |
+                          static_cast<uint32_t>(b[2]) << 16U | static_cast<uint32_t>(b[3]) << 24U;
+    float f = 0;
+    std::memcpy(&f, &bits, sizeof(f));
+    return static_cast<double>(f);
+}
+}  // namespace
+
+void BinaryPointData::append(std::string& data, const std::vector<Point>& points, bool withPressure) {
+    const size_t valueCount = 2 * points.size() + (withPressure && !points.empty() ? points.size() - 1 : 0);
+    data.reserve(data.size() + valueCount * VALUE_SIZE);
+
+    for (const Point& p: points) {
+        appendValue(data, p.x);
+        appendValue(data, p.y);
+    }
+    if (withPressure && !points.empty()) {
+        for (auto it = points.begin(); it != points.end() - 1; ++it) {
+            appendValue(data, it->z);
+        }
+    }
+}
+
+auto BinaryPointData::read(std::string_view data, size_t offset, size_t count, bool withPressure,
+                           std::vector<Point>& points, std::vector<double>& pressures) -> bool {
+    const size_t pressureCount = withPressure && count != 0 ? count - 1 : 0;
+    // Written so that it cannot overflow with hostile values
+    if (offset > data.size() || count > (data.size() - offset) / VALUE_SIZE / 2 ||
+        pressureCount > (data.size() - offset) / VALUE_SIZE - 2 * count) {
+        return false;
+    }
+
+    const char* p = data.data() + offset;
+    points.reserve(points.size() + count);
+    for (size_t i = 0; i < count; i++, p += 2 * VALUE_SIZE) {
+        points.emplace_back(readValue(p), readValue(p + VALUE_SIZE));
+    }
+    pressures.reserve(pressures.size() + pressureCount);
+    for (size_t i = 0; i < pressureCount; i++, p += VALUE_SIZE) {
+        pressures.push_back(readValue(p));
+    }
+    return true;
+}
@@ -0,0 +1,47 @@
+/*
+ * Xournal++
+ *
+ * Binary encoding of the points of the strokes, stored in a separate entry of the .xopp archive
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include "model/Point.h"  // for Point
+
+/**
+ * The points of a stroke are stored as little endian float32: the x and y coordinates of each point, followed by the
+ * pressure values of all the points but the last one (just like the "width" attribute of the text format).
+ * The strokes refer to their points with the offset (in bytes) and the number of points.
+ */
+namespace BinaryPointData {
+/// Name of the entry in the archive
+constexpr const char* ENTRY_NAME = "points.bin";
+
+/// Values of the "pointFormat" attribute of the strokes
+constexpr const char* FORMAT_XY = "xy";
+constexpr const char* FORMAT_XY_PRESSURE = "xyp";
+
+/**
+ * @brief Append the points to data
+ * @param withPressure Append the pressure values (the z coordinates) as well
+ */
+void append(std::string& data, const std::vector<Point>& points, bool withPressure);
+
+/**
+ * @brief Read count points at the given offset of data
+ * @param pressures Receives the count - 1 pressure values, if withPressure
+ * @return false if the points are not within data
+ */
+bool read(std::string_view data, size_t offset, size_t count, bool withPressure, std::vector<Point>& points,
+          std::vector<double>& pressures);
+}  // namespace BinaryPointData
@@ -0,0 +1,27 @@
+#include "LazyPageLoader.h"
+
+#include <string_view>  // for string_view
+#include <utility>      // for move
+
+#include "LoadHandler.h"  // for LoadHandler
+
+LazyContentSource::LazyContentSource(std::shared_ptr<const std::string_view> content,
+                                     std::shared_ptr<const std::string> pointData, fs::path filepath, int fileVersion,
+                                     bool isGzFile, GHashTable* audioFiles):
+        content(std::move(content)),
+        pointData(std::move(pointData)),
+        filepath(std::move(filepath)),
+        fileVersion(fileVersion),
+        isGzFile(isGzFile),
+        audioFiles(g_hash_table_ref(audioFiles)) {}
+
+LazyContentSource::~LazyContentSource() { g_hash_table_unref(this->audioFiles); }
+
+LazyPageLoader::LazyPageLoader(std::shared_ptr<const LazyContentSource> source, size_t begin, size_t end):
+        source(std::move(source)), begin(begin), end(end) {}
+
+auto LazyPageLoader::load(std::vector<Layer*>& layers) const -> bool {
+    LoadHandler handler;
+    return handler.loadLayers(*this->source, this->source->content->substr(begin, end - begin),
+                              layers);
+}
@@ -0,0 +1,63 @@
+/*
+ * Xournal++
+ *
+ * Reads the layers of a page from the file, when they are first needed
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+#include <glib.h>  // for GHashTable
+
+#include "model/PageContentLoader.h"  // for PageContentLoader
+
+#include "filesystem.h"  // for path
+
+class Layer;
+
+/**
+ * What is needed to parse the layers of the pages of a lazily loaded document, shared by its pages
+ */
+struct LazyContentSource {
+    LazyContentSource(std::shared_ptr<const std::string_view> content, std::shared_ptr<const std::string> pointData,
+                      fs::path filepath, int fileVersion, bool isGzFile, GHashTable* audioFiles);
+    ~LazyContentSource();
+    LazyContentSource(const LazyContentSource&) = delete;
+    LazyContentSource& operator=(const LazyContentSource&) = delete;
+
+    /// The whole content.xml
+    std::shared_ptr<const std::string_view> content;
+    /// The binary points of the strokes, if any
+    std::shared_ptr<const std::string> pointData;
+    /// The document, for the attachments
+    fs::path filepath;
+    int fileVersion;
+    bool isGzFile;
+    /// Temporary files of the audio attachments, by attachment name
+    GHashTable* audioFiles;
+};
+
+class LazyPageLoader: public PageContentLoader {
+public:
+    /**
+     * @param begin, end The layers of the page in the content
+     */
+    LazyPageLoader(std::shared_ptr<const LazyContentSource> source, size_t begin, size_t end);
+
+    bool load(std::vector<Layer*>& layers) const override;
+
+private:
+    std::shared_ptr<const LazyContentSource> source;
+    size_t begin;
+    size_t end;
+};
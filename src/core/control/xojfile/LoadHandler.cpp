@@ -1,14 +1,21 @@
 #include "LoadHandler.h"
 
-#include <algorithm>    // for copy
-#include <cmath>        // for isnan
-#include <cstdlib>      // for atoi, size_t
-#include <cstring>      // for strcmp, strlen
-#include <iterator>     // for back_inserter
-#include <memory>       // for __shared_ptr_access
-#include <regex>        // for regex_search, smatch
-#include <type_traits>  // for remove_reference<>::type
-#include <utility>      // for move
+#include <algorithm>           // for copy, min, all_of
+#include <atomic>              // for atomic
+#include <cmath>               // for isnan
+#include <condition_variable>  // for condition_variable
+#include <cstdlib>             // for atoi, size_t
+#include <cstring>             // for strcmp, strlen
+#include <future>              // for async, future
+#include <iterator>            // for back_inserter
+#include <memory>              // for __shared_ptr_access
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <regex>               // for regex_search, smatch
+#include <sstream>             // for istringstream
+#include <thread>              // for thread
+#include <type_traits>         // for remove_reference<>::type
+#include <utility>             // for move
+#include <vector>              // for vector
 
 #include <gio/gio.h>      // for g_file_get_path, g_fil...
 #include <glib-object.h>  // for g_object_unref
@@ -28,11 +35,14 @@
 #include "util/Assert.h"                       // for xoj_assert
 #include "util/GzUtil.h"                       // for GzUtil
 #include "util/LoopUtil.h"
+#include "util/NumberListParser.h"   // for countNumberTokens, forEachNumber
 #include "util/PlaceholderString.h"  // for PlaceholderString
 #include "util/i18n.h"               // for _F, FC, FS, _
 #include "util/raii/GObjectSPtr.h"
 #include "util/safe_casts.h"  // for as_signed, as_unsigned
 
+#include "BinaryPointData.h"    // for ENTRY_NAME, read, FORMAT_XY
+#include "LazyPageLoader.h"     // for LazyPageLoader, LazyContentSource
 #include "LoadHandlerHelper.h"  // for getAttrib, getAttribDo...
 
 using std::string;
@@ -50,6 +60,37 @@ using std::string;
 namespace {
 constexpr size_t MAX_VERSION_LENGTH = 50;
 constexpr size_t MAX_MIMETYPE_LENGTH = 25;
+constexpr size_t CONTENT_CHUNK_SIZE = 64 * 1024;
+constexpr size_t XML_CHUNK_SIZE = 1024;
+/// Below that, starting the threads costs more than it saves
+constexpr size_t MIN_PAGES_FOR_PARALLEL_PARSING = 4;
+
+/// An uncompressed file, parsed where it is mapped in memory
+struct MappedContent {
+    explicit MappedContent(GMappedFile* file):
+            file(file), xml(g_mapped_file_get_contents(file), g_mapped_file_get_length(file)) {}
+    ~MappedContent() { g_mapped_file_unref(this->file); }
+    MappedContent(const MappedContent&) = delete;
+    MappedContent& operator=(const MappedContent&) = delete;
+
+    GMappedFile* file;
+    std::string_view xml;
+};
+
+/// The content read from the compressed file
+struct ReadContent {
+    explicit ReadContent(std::string data): data(std::move(data)), xml(this->data) {}
+    ReadContent(const ReadContent&) = delete;
+    ReadContent& operator=(const ReadContent&) = delete;
+
+    std::string data;
+    std::string_view xml;
+};
+
+template <class Content>
+auto shareContent(const std::shared_ptr<Content>& content) -> std::shared_ptr<const std::string_view> {
+    return std::shared_ptr<const std::string_view>(content, &content->xml);
+}
 }  // namespace
 
 LoadHandler::LoadHandler():
@@ -76,6 +117,9 @@ LoadHandler::LoadHandler():
 }
 
 LoadHandler::~LoadHandler() {
+    if (this->pdfLoading.valid()) {
+        this->pdfLoading.wait();
+    }
     if (this->audioFiles) {
         g_hash_table_unref(this->audioFiles);
     }
@@ -211,35 +255,83 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
     return -1;
 }
 
-auto LoadHandler::parseXml() -> bool {
-    xoj_assert(this->doc);
-    const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
-                                  LoadHandler::parserText, nullptr, nullptr};
+auto LoadHandler::readContent() -> std::shared_ptr<const std::string_view> {
+    this->contentMapped = false;
+    if (this->isGzFile && gzdirect(this->gzFp)) {
+        // The file is not compressed: no need to copy it
+        GError* mapError = nullptr;
+        GMappedFile* file = g_mapped_file_new(this->filepath.u8string().c_str(), false, &mapError);
+        if (file && g_mapped_file_get_length(file) > 0) {
+            this->contentMapped = true;
+            return shareContent(std::make_shared<MappedContent>(file));
+        }
+        if (file) {
+            g_mapped_file_unref(file);
+        }
+        if (mapError) {
+            g_warning("Could not map \"%s\" in memory: %s", this->filepath.u8string().c_str(), mapError->message);
+            g_error_free(mapError);
+        }
+    }
+
+    std::string content;
+
+    zip_int64_t len = 0;
+    zip_stat_t contentStat;
+    if (!this->isGzFile && zip_stat(this->zipFp, "content.xml", 0, &contentStat) == 0 &&
+        (contentStat.valid & ZIP_STAT_SIZE)) {
+        // Read at once, e.g. for the stored (uncompressed) entries
+        content.resize(contentStat.size);
+        size_t readBytes = 0;
+        while (readBytes < content.size() &&
+               (len = readContentFile(content.data() + readBytes, content.size() - readBytes)) >= 0) {
+            readBytes += static_cast<size_t>(len);
+        }
+        content.resize(readBytes);
+    }
+
+    while (len >= 0) {
+        const size_t oldSize = content.size();
+        content.resize(oldSize + CONTENT_CHUNK_SIZE);
+        len = readContentFile(content.data() + oldSize, CONTENT_CHUNK_SIZE);
+        content.resize(oldSize + (len > 0 ? static_cast<size_t>(len) : 0U));
+    }
+
+    return shareContent(std::make_shared<ReadContent>(std::move(content)));
+}
+
+auto LoadHandler::createParseContext() -> GMarkupParseContext* {
+    static const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
+                                         LoadHandler::parserText, nullptr, nullptr};
+    return g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
+}
+
+auto LoadHandler::beginParse() -> GMarkupParseContext* {
     this->error = nullptr;
-    gboolean valid = true;
 
     this->pos = PARSER_POS_NOT_STARTED;
     this->creator = "Unknown";
     this->fileVersion = 1;
 
-    GMarkupParseContext* context =
-            g_markup_parse_context_new(&parser, static_cast<GMarkupParseFlags>(0), this, nullptr);
-
-    zip_int64_t len = 0;
-    do {
-        char buffer[1024];
-        len = readContentFile(buffer, sizeof(buffer));
-        if (len > 0) {
-            valid = g_markup_parse_context_parse(context, buffer, len, &error);
-        }
+    return createParseContext();
+}
 
-        if (error) {
-            g_warning("LoadHandler::parseXml: %s\n", error->message);
-            valid = false;
-            break;
+auto LoadHandler::feedXml(GMarkupParseContext* context, std::string_view xml) -> bool {
+    // The errors set by the handler only stop the parser at the end of a chunk
+    for (size_t offset = 0; offset < xml.size(); offset += XML_CHUNK_SIZE) {
+        const size_t len = std::min(XML_CHUNK_SIZE, xml.size() - offset);
+        if (!g_markup_parse_context_parse(context, xml.data() + offset, as_signed(len), &error) || error) {
+            return false;
         }
-    } while (len >= 0 && valid && !error);
+    }
+    return true;
+}
 
+auto LoadHandler::endParse(GMarkupParseContext* context, bool valid) -> bool {
+    // The PDF must be open before the pages are added to the document
+    if (!finishPdfLoading()) {
+        valid = false;
+    }
     if (valid) {
         valid = g_markup_parse_context_end_parse(context, &error);
     } else {
@@ -271,6 +363,340 @@ auto LoadHandler::parseXml() -> bool {
     return valid;
 }
 
+auto LoadHandler::parseXml() -> bool {
+    xoj_assert(this->doc);
+    const auto content = readContent();
+
+    zip_stat_t pointDataStat;
+    if (!this->isGzFile && zip_stat(this->zipFp, BinaryPointData::ENTRY_NAME, 0, &pointDataStat) == 0) {
+        this->pointData = readZipAttachment(BinaryPointData::ENTRY_NAME);
+        if (!this->pointData) {
+            this->lastError = this->error ? this->error->message : _("Could not read the points of the strokes");
+            g_clear_error(&this->error);
+            g_warning("LoadHandler::parseXml: %s\n", this->lastError.c_str());
+            return false;
+        }
+    }
+
+    unsigned int threadCount = this->pageParserThreadCount;
+    if (threadCount == 0) {
+        threadCount = g_get_num_processors();
+    }
+    std::vector<PageRange> pageRanges;
+    if ((this->lazyPageLoading || threadCount > 1) && scanPageRanges(*content, pageRanges) &&
+        (this->lazyPageLoading || pageRanges.size() >= MIN_PAGES_FOR_PARALLEL_PARSING)) {
+        GMarkupParseContext* context = beginParse();
+        if (parsePagesInParallel(context, content, pageRanges, threadCount)) {
+            return endParse(context, true);
+        }
+        g_markup_parse_context_free(context);
+
+        // Parse the file again on this thread, so the errors are reported exactly as usual
+        resetParserState();
+    }
+
+    GMarkupParseContext* context = beginParse();
+    bool valid = feedXml(context, *content);
+    if (!valid && error) {
+        g_warning("LoadHandler::parseXml: %s\n", error->message);
+    }
+    return endParse(context, valid);
+}
+
+auto LoadHandler::scanPageRanges(std::string_view xml, std::vector<PageRange>& ranges) -> bool {
+    ranges.clear();
+    auto skipPast = [&xml](size_t from, std::string_view terminator) {
+        size_t found = xml.find(terminator, from);
+        return found == std::string_view::npos ? found : found + terminator.size();
+    };
+
+    // Number of open elements: the pages are the children of the root element
+    size_t depth = 0;
+    size_t p = 0;
+    while ((p = xml.find('<', p)) != std::string_view::npos) {
+        const std::string_view tag = xml.substr(p);
+        if (tag.compare(0, 4, "<!--") == 0) {
+            p = skipPast(p + 4, "-->");
+        } else if (tag.compare(0, 9, "<![CDATA[") == 0) {
+            p = skipPast(p + 9, "]]>");
+        } else if (tag.compare(0, 2, "<?") == 0) {
+            p = skipPast(p + 2, "?>");
+        } else if (tag.compare(0, 2, "<!") == 0) {
+            p = skipPast(p + 2, ">");
+        } else {
+            const bool closing = tag.compare(0, 2, "</") == 0;
+            const size_t nameBegin = p + (closing ? 2 : 1);
+            const size_t nameEnd = std::min(xml.find_first_of(" \t\r\n/>", nameBegin), xml.size());
+            const std::string_view name = xml.substr(nameBegin, nameEnd - nameBegin);
+
+            // Find the end of the tag. '>' is allowed in the attribute values
+            size_t tagEnd = nameEnd;
+            for (char quote = 0; tagEnd < xml.size() && (quote || xml[tagEnd] != '>'); tagEnd++) {
+                if (xml[tagEnd] == quote) {
+                    quote = 0;
+                } else if (!quote && (xml[tagEnd] == '"' || xml[tagEnd] == '\'')) {
+                    quote = xml[tagEnd];
+                }
+            }
+            if (tagEnd == xml.size()) {
+                return false;
+            }
+
+            if (closing) {
+                if (depth == 0) {
+                    return false;
+                }
+                depth--;
+                if (depth == 1 && name == "page") {
+                    if (ranges.empty() || ranges.back().end != std::string_view::npos) {
+                        return false;
+                    }
+                    ranges.back().end = tagEnd + 1;
+                    if (ranges.back().layersBegin != std::string_view::npos) {
+                        ranges.back().layersEnd = p;
+                    }
+                }
+            } else {
+                const bool selfClosing = xml[tagEnd - 1] == '/';
+                if (depth == 1 && name == "page") {
+                    ranges.push_back({p, selfClosing ? tagEnd + 1 : std::string_view::npos, std::string_view::npos,
+                                      std::string_view::npos});
+                } else if (depth == 1 && name == "audio" && !ranges.empty()) {
+                    // The pages need all the audio attachments
+                    return false;
+                } else if (depth == 2 && !ranges.empty()) {
+                    // A child of a page: the layers can only be left aside if nothing follows them
+                    PageRange& range = ranges.back();
+                    if (name == "layer" && range.layersBegin == std::string_view::npos && !range.splitFailed) {
+                        range.layersBegin = p;
+                    } else if (name != "layer" && range.layersBegin != std::string_view::npos) {
+                        range.layersBegin = std::string_view::npos;
+                        range.splitFailed = true;
+                    }
+                }
+                depth += selfClosing ? 0 : 1;
+            }
+            p = tagEnd + 1;
+        }
+        if (p == std::string_view::npos) {
+            return false;
+        }
+    }
+
+    return depth == 0 && std::all_of(ranges.begin(), ranges.end(),
+                                     [](const PageRange& r) { return r.end != std::string_view::npos; });
+}
+
+auto LoadHandler::parsePagesInParallel(GMarkupParseContext* context,
+                                       const std::shared_ptr<const std::string_view>& content,
+                                       const std::vector<PageRange>& ranges, unsigned int threadCount) -> bool {
+    const std::string_view xml = *content;
+
+    // Parse the root element and what precedes the first page, e.g. the audio attachments
+    if (!feedXml(context, xml.substr(0, ranges.front().begin)) || this->pos != PARSER_POS_STARTED) {
+        return false;
+    }
+
+    std::shared_ptr<const LazyContentSource> lazySource;
+    if (this->lazyPageLoading) {
+        // The file may be replaced or modified long before the pages are loaded: do not keep it mapped
+        auto source = this->contentMapped ? shareContent(std::make_shared<ReadContent>(std::string(xml))) : content;
+        lazySource = std::make_shared<const LazyContentSource>(std::move(source), this->pointData, this->filepath,
+                                                               this->fileVersion, this->isGzFile, this->audioFiles);
+    }
+
+    std::mutex parsedMutex;
+    std::condition_variable pageParsed;
+    std::vector<std::unique_ptr<LoadHandler>> parsers(ranges.size());
+    std::vector<bool> parsed(ranges.size(), false);
+    std::atomic<size_t> nextPage{0};
+    std::atomic<bool> cancelled{false};
+
+    auto parsePages = [&]() {
+        for (size_t i = nextPage++; i < ranges.size() && !cancelled; i = nextPage++) {
+            const PageRange& range = ranges[i];
+            auto parser = std::make_unique<LoadHandler>();
+            parser->initPageParser(*this);
+
+            if (lazySource && range.layersBegin != std::string_view::npos) {
+                // Only the page table: the page without its layers
+                std::string header(xml.substr(range.begin, range.layersBegin - range.begin));
+                header += xml.substr(range.layersEnd, range.end - range.layersEnd);
+                if (parser->parsePageChunk(header)) {
+                    parser->pages.front()->setContentLoader(
+                            std::make_shared<LazyPageLoader>(lazySource, range.layersBegin, range.layersEnd));
+                } else {
+                    parser.reset();
+                }
+            } else if (!parser->parsePageChunk(xml.substr(range.begin, range.end - range.begin))) {
+                parser.reset();
+            }
+
+            std::lock_guard lock(parsedMutex);
+            parsers[i] = std::move(parser);
+            parsed[i] = true;
+            pageParsed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threadCount = std::min(threadCount, static_cast<unsigned int>(ranges.size()));
+    threads.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        threads.emplace_back(parsePages);
+    }
+
+    // Add the pages in the file order, and parse what follows each of them
+    bool success = true;
+    for (size_t i = 0; i < ranges.size() && success; i++) {
+        std::unique_ptr<LoadHandler> parser;
+        {
+            std::unique_lock lock(parsedMutex);
+            pageParsed.wait(lock, [&parsed, i]() { return parsed[i]; });
+            parser = std::move(parsers[i]);
+        }
+        const size_t nextBegin = i + 1 < ranges.size() ? ranges[i + 1].begin : xml.size();
+        success = parser && addParsedPage(*parser) &&
+                  feedXml(context, xml.substr(ranges[i].end, nextBegin - ranges[i].end));
+    }
+
+    cancelled = true;
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    return success;
+}
+
+void LoadHandler::resetParserState() {
+    // The PDF is opened again when the file is parsed again
+    if (this->pdfLoading.valid()) {
+        this->pdfLoading.wait();
+        this->pdfLoading = {};
+    }
+    if (this->error) {
+        g_error_free(this->error);
+        this->error = nullptr;
+    }
+    this->lastError.clear();
+    this->pdfMissing.clear();
+    this->attachedPdfMissing = false;
+    this->pdfFilenameParsed = false;
+
+    this->page = nullptr;
+    this->layer = nullptr;
+    this->stroke = nullptr;
+    this->image = nullptr;
+    this->teximage = nullptr;
+    this->text = nullptr;
+    this->pages.clear();
+    this->pressureBuffer.clear();
+    this->loadedTimeStamp = 0;
+    this->loadedFilename.clear();
+
+    g_hash_table_unref(this->audioFiles);
+    this->audioFiles = g_hash_table_new(g_str_hash, g_str_equal);
+
+    this->doc = std::make_unique<Document>(&dHanlder);
+}
+
+void LoadHandler::initPageParser(const LoadHandler& mainHandler) {
+    this->pageParser = true;
+    this->pos = PARSER_POS_STARTED;
+    this->fileVersion = mainHandler.fileVersion;
+    this->isGzFile = mainHandler.isGzFile;
+    this->filepath = mainHandler.filepath;
+    this->xournalFilepath = mainHandler.xournalFilepath;
+    this->zipFp = mainHandler.zipFp;
+    this->zipMutex = mainHandler.zipMutex;
+    this->pointData = mainHandler.pointData;
+
+    // Only read: the audio attachments all precede the pages
+    g_hash_table_unref(this->audioFiles);
+    this->audioFiles = g_hash_table_ref(mainHandler.audioFiles);
+}
+
+auto LoadHandler::parsePageChunk(std::string_view xml) -> bool {
+    GMarkupParseContext* context = createParseContext();
+    bool valid = feedXml(context, xml) && g_markup_parse_context_end_parse(context, &error) && !error;
+    g_markup_parse_context_free(context);
+
+    if (this->error) {
+        g_error_free(this->error);
+        this->error = nullptr;
+    }
+    return valid && this->pos == PARSER_POS_STARTED && this->pages.size() == 1;
+}
+
+auto LoadHandler::addParsedPage(LoadHandler& pageParser) -> bool {
+    PageRef parsedPage = pageParser.pages.front();
+
+    if (pageParser.clonedBackgroundPage) {
+        const size_t nr = *pageParser.clonedBackgroundPage;
+        if (nr > this->pages.size()) {
+            return false;
+        }
+        if (nr < this->pages.size()) {
+            parsedPage->setBackgroundImage(this->pages[nr]->getBackgroundImage());
+        }
+    }
+
+    if (pageParser.deferredPdfBackground && !this->pdfFilenameParsed) {
+        auto& [domain, pdfFilename] = *pageParser.deferredPdfBackground;
+        loadBackgroundPdf(domain.c_str(), pdfFilename);
+        if (this->error) {
+            return false;
+        }
+    }
+
+    this->pages.push_back(std::move(parsedPage));
+    return true;
+}
+
+auto LoadHandler::loadLayers(const LazyContentSource& source, std::string_view xml, std::vector<Layer*>& layers)
+        -> bool {
+    this->pageParser = true;
+    this->pos = PARSER_POS_STARTED;
+    this->fileVersion = source.fileVersion;
+    this->isGzFile = source.isGzFile;
+    this->pointData = source.pointData;
+    this->filepath = source.filepath;
+    this->xournalFilepath = source.filepath;
+    g_hash_table_unref(this->audioFiles);
+    this->audioFiles = g_hash_table_ref(source.audioFiles);
+
+    if (!this->isGzFile && xml.find("<attachment") != std::string_view::npos) {
+        // The file is only kept open while the layers need it
+        int zipError = 0;
+        this->zipFp = zip_open(this->filepath.u8string().c_str(), ZIP_RDONLY, &zipError);
+        if (!this->zipFp) {
+            g_warning("Could not open \"%s\" to read the attachments of a page", this->filepath.u8string().c_str());
+            return false;
+        }
+    }
+
+    // The layers are parsed as the children of a placeholder page
+    GMarkupParseContext* context = createParseContext();
+    bool valid = feedXml(context, "<page width=\"0\" height=\"0\">") && feedXml(context, xml) &&
+                 feedXml(context, "</page>") && g_markup_parse_context_end_parse(context, &error) && !error;
+    g_markup_parse_context_free(context);
+
+    if (this->error) {
+        g_warning("LoadHandler::loadLayers: %s", this->error->message);
+        g_error_free(this->error);
+        this->error = nullptr;
+    }
+    if (this->zipFp) {
+        zip_close(this->zipFp);
+        this->zipFp = nullptr;
+    }
+
+    for (auto& p: this->pages) {
+        layers.insert(layers.end(), p->layer.begin(), p->layer.end());
+        p->layer.clear();
+    }
+    return valid && this->pos == PARSER_POS_STARTED;
+}
+
 void LoadHandler::parseStart() {
     if (strcmp(elementName, "xournal") == 0) {
         endRootTag = "xournal";
@@ -291,6 +717,16 @@ void LoadHandler::parseStart() {
             this->creator = creator;
         }
 
+        const char* journalPages = LoadHandlerHelper::getAttrib("journalpages", true, this);
+        if (journalPages) {
+            std::istringstream indices(journalPages);
+            size_t index = 0;
+            while (indices >> index) {
+                this->journalPages.push_back(index);
+            }
+            LoadHandlerHelper::getAttribSizeT("journalbasepages", false, this, this->journalBasePageCount);
+        }
+
         this->pos = PARSER_POS_STARTED;
     } else if (strcmp(elementName, "MrWriter") == 0) {
         endRootTag = "MrWriter";
@@ -383,26 +819,14 @@ void LoadHandler::parseBgPixmap() {
         this->page->setBackgroundImage(img);
     } else if (!strcmp(domain, "attach")) {
         // This is the new zip file attach domain
-        const auto readResult = readZipAttachment(filepath);  ///< Do not remove the const qualifier - see below
+        auto readResult = readZipAttachment(filepath);
         if (!readResult) {
             return;
         }
-        const std::string& imgData = *readResult;  ///< Do not remove the const qualifier - see below
-
-        /**
-         * To avoid an unecessary copy, the data is still managed by the std::unique_ptr<std::string> instance. The
-         * input stream assumes the data will not be modified: do not remove the const qualifier on readResult or
-         * imgData
-         */
-        xoj::util::GObjectSPtr<GInputStream> inputStream(
-                g_memory_input_stream_new_from_data(imgData.data(), static_cast<gssize>(imgData.size()), nullptr),
-                xoj::util::adopt);
 
         GError* error = nullptr;
         BackgroundImage img;
-        img.loadFile(inputStream.get(), filepath, &error);
-
-        g_input_stream_close(inputStream.get(), nullptr, nullptr);
+        img.loadData(std::move(*readResult), filepath, &error);
 
         if (error) {
             error("%s", FC(_F("Could not read image: {1}. Error message: {2}") % filepath.string() % error->message));
@@ -417,10 +841,15 @@ void LoadHandler::parseBgPixmap() {
         if (endptr == filename.c_str()) {
             error("%s", FC(_F("Could not read page number for cloned background image: {1}.") % filepath.string()));
         }
-        PageRef p = pages[nr];
+        if (this->pageParser) {
+            // The cloned page belongs to another page parser
+            this->clonedBackgroundPage = nr;
+        } else {
+            PageRef p = pages[nr];
 
-        if (p) {
-            this->page->setBackgroundImage(p->getBackgroundImage());
+            if (p) {
+                this->page->setBackgroundImage(p->getBackgroundImage());
+            }
         }
     } else {
         error("%s", FC(_F("Unknown pixmap::domain type: {1}") % domain));
@@ -430,72 +859,95 @@ void LoadHandler::parseBgPixmap() {
 }
 
 void LoadHandler::parseBgPdf() {
-    xoj_assert(this->doc);
     int pageno = LoadHandlerHelper::getAttribInt("pageno", this);
-    bool attachToDocument = false;
-    fs::path pdfFilename;
 
     this->page->setBackgroundPdfPageNr(as_unsigned(pageno) - 1);
 
     if (!this->pdfFilenameParsed) {
 
         const char* domain = LoadHandlerHelper::getAttrib("domain", false, this);
-        {
-            const char* sFilename = LoadHandlerHelper::getAttrib("filename", false, this);
-            if (sFilename == nullptr) {
-                error("PDF Filename missing!");
-                return;
-            }
-            pdfFilename = fs::u8path(sFilename);
+        const char* sFilename = LoadHandlerHelper::getAttrib("filename", false, this);
+        if (sFilename == nullptr) {
+            error("PDF Filename missing!");
+            return;
         }
 
-        if (!strcmp("absolute", domain))  // Absolute OR relative path
-        {
-            if (pdfFilename.is_relative()) {
-                pdfFilename = xournalFilepath.remove_filename() / pdfFilename;
-            }
-        } else if (!strcmp("attach", domain)) {
-            attachToDocument = true;
-            // Handle old format separately
-            if (this->isGzFile) {
-                pdfFilename = (fs::path{xournalFilepath} += ".") += pdfFilename;
-            } else {
-                auto pdfBytes = readZipAttachment(pdfFilename);
-                if (!pdfBytes) {
-                    return;
-                }
-                doc->readPdf(pdfFilename, false, attachToDocument, std::move(pdfBytes));
+        if (this->pageParser) {
+            // The main handler loads the PDF into the document
+            this->deferredPdfBackground.emplace(domain ? domain : "", fs::u8path(sFilename));
+            this->pdfFilenameParsed = true;
+            return;
+        }
+        loadBackgroundPdf(domain, fs::u8path(sFilename));
+    }
+}
 
-                if (!doc->getLastErrorMsg().empty()) {
-                    error("%s", FC(_F("Error reading PDF: {1}") % doc->getLastErrorMsg()));
-                }
+void LoadHandler::loadBackgroundPdf(const char* domain, fs::path pdfFilename) {
+    xoj_assert(this->doc);
+    bool attachToDocument = false;
 
-                this->pdfFilenameParsed = true;
+    if (!strcmp("absolute", domain))  // Absolute OR relative path
+    {
+        if (pdfFilename.is_relative()) {
+            pdfFilename = fs::path{xournalFilepath}.remove_filename() / pdfFilename;
+        }
+    } else if (!strcmp("attach", domain)) {
+        attachToDocument = true;
+        // Handle old format separately
+        if (this->isGzFile) {
+            pdfFilename = (fs::path{xournalFilepath} += ".") += pdfFilename;
+        } else if (this->pdfBackgroundLoading) {
+            auto pdfBytes = readZipAttachment(pdfFilename);
+            if (!pdfBytes) {
                 return;
             }
-        } else {
-            error("%s", FC(_F("Unknown domain type: {1}") % domain));
+            startPdfLoading(std::move(pdfFilename), attachToDocument, std::move(pdfBytes));
+
+            this->pdfFilenameParsed = true;
             return;
         }
+    } else {
+        error("%s", FC(_F("Unknown domain type: {1}") % domain));
+        return;
+    }
 
-        this->pdfFilenameParsed = true;
+    this->pdfFilenameParsed = true;
 
-        if (fs::is_regular_file(pdfFilename)) {
-            doc->readPdf(pdfFilename, false, attachToDocument);
-            if (!doc->getLastErrorMsg().empty()) {
-                error("%s", FC(_F("Error reading PDF: {1}") % doc->getLastErrorMsg()));
-            }
+    if (!this->pdfBackgroundLoading) {
+        doc->setPdfAttributes(pdfFilename, attachToDocument);
+        return;
+    }
+    if (fs::is_regular_file(pdfFilename)) {
+        startPdfLoading(std::move(pdfFilename), attachToDocument);
+    } else {
+        doc->setPdfAttributes(pdfFilename, attachToDocument);
+        if (attachToDocument) {
+            this->attachedPdfMissing = true;
         } else {
-            doc->setPdfAttributes(pdfFilename, attachToDocument);
-            if (attachToDocument) {
-                this->attachedPdfMissing = true;
-            } else {
-                this->pdfMissing = pdfFilename.u8string();
-            }
+            this->pdfMissing = pdfFilename.u8string();
         }
     }
 }
 
+void LoadHandler::startPdfLoading(fs::path pdfFilename, bool attachToDocument, std::unique_ptr<std::string> pdfBytes) {
+    Document* doc = this->doc.get();
+    this->pdfLoading = std::async(std::launch::async, [doc, pdfFilename = std::move(pdfFilename), attachToDocument,
+                                                       pdfBytes = std::move(pdfBytes)]() mutable {
+        return doc->readPdf(pdfFilename, false, attachToDocument, std::move(pdfBytes));
+    });
+}
+
+auto LoadHandler::finishPdfLoading() -> bool {
+    if (!this->pdfLoading.valid()) {
+        return true;
+    }
+    if (!this->pdfLoading.get()) {
+        error("%s", FC(_F("Error reading PDF: {1}") % doc->getLastErrorMsg()));
+        return false;
+    }
+    return true;
+}
+
 void LoadHandler::parsePage() {
     if (!strcmp(elementName, "background")) {
         const char* name = LoadHandlerHelper::getAttrib("name", true, this);
@@ -548,15 +1000,9 @@ void LoadHandler::parseStroke() {
         pressure = endPtr;
     }
 
-    while (*pressure != 0) {
-        char* tmpptr = nullptr;
-        double val = g_ascii_strtod(pressure, &tmpptr);
-        if (tmpptr == pressure) {
-            break;
-        }
-        pressure = tmpptr;
-        this->pressureBuffer.push_back(val);
-    }
+    const char* pressureEnd = pressure + strlen(pressure);
+    this->pressureBuffer.reserve(xoj::util::countNumberTokens(pressure, pressureEnd));
+    xoj::util::forEachNumber(pressure, pressureEnd, [this](double v) { this->pressureBuffer.push_back(v); });
 
     Color color{0U};
     const char* sColor = LoadHandlerHelper::getAttrib("color", false, this);
@@ -637,6 +1083,40 @@ void LoadHandler::parseStroke() {
         loadedFilename = "";
         loadedTimeStamp = 0;
     }
+
+    size_t pointOffset = 0;
+    if (LoadHandlerHelper::getAttribSizeT("pointOffset", true, this, pointOffset)) {
+        // Last: this may delete the stroke
+        readBinaryPoints(pointOffset);
+    }
+}
+
+void LoadHandler::readBinaryPoints(size_t offset) {
+    size_t count = 0;
+    if (!LoadHandlerHelper::getAttribSizeT("pointCount", false, this, count)) {
+        return;
+    }
+    const char* format = LoadHandlerHelper::getAttrib("pointFormat", true, this);
+    const bool withPressure = format && strcmp(format, BinaryPointData::FORMAT_XY_PRESSURE) == 0;
+    if (format && !withPressure && strcmp(format, BinaryPointData::FORMAT_XY) != 0) {
+        error("%s", FC(_F("Unknown point format: {1}") % format));
+        return;
+    }
+
+    if (count < 2) {
+        error("%s", FC(_F("Wrong count of points ({1})") % (2 * count)));
+        return;
+    }
+
+    std::vector<Point> points;
+    this->pressureBuffer.clear();
+    if (!this->pointData ||
+        !BinaryPointData::read(*this->pointData, offset, count, withPressure, points, this->pressureBuffer)) {
+        error("%s", FC(_F("The points of a stroke are missing from {1}") % BinaryPointData::ENTRY_NAME));
+        return;
+    }
+    this->stroke->setPointVector(std::move(points));
+    applyPressureBuffer();
 }
 
 void LoadHandler::parseText() {
@@ -791,6 +1271,7 @@ void LoadHandler::parseAudio() {
 
     GOutputStream* outputStream = g_io_stream_get_output_stream(G_IO_STREAM(fileStream));
 
+    std::lock_guard lock(*this->zipMutex);
     zip_stat_t attachmentFileStat;
     int statStatus = zip_stat(this->zipFp, filename, 0, &attachmentFileStat);
     if (statStatus != 0) {
@@ -815,21 +1296,21 @@ void LoadHandler::parseAudio() {
         return;
     }
 
-    gpointer data = g_malloc(1024);
+    // Large enough for the recordings to be copied in a few reads
+    constexpr size_t BUFFER_SIZE = 1024 * 1024;
+    std::vector<char> data(std::min<size_t>(BUFFER_SIZE, std::max<size_t>(length, 1)));
     zip_uint64_t readBytes = 0;
     while (readBytes < length) {
-        zip_int64_t read = zip_fread(attachmentFile, data, 1024);
-        if (read == -1) {
-            g_free(data);
+        zip_int64_t read = zip_fread(attachmentFile, data.data(), data.size());
+        if (read <= 0) {
             zip_fclose(attachmentFile);
             error("%s", FC(_F("Could not open attachment: {1}. Error message: Could not read file") % filename));
             return;
         }
 
-        gboolean writeSuccessful =
-                g_output_stream_write_all(outputStream, data, static_cast<gsize>(read), nullptr, nullptr, nullptr);
+        gboolean writeSuccessful = g_output_stream_write_all(outputStream, data.data(), static_cast<gsize>(read),
+                                                             nullptr, nullptr, nullptr);
         if (!writeSuccessful) {
-            g_free(data);
             zip_fclose(attachmentFile);
             error("%s", FC(_F("Could not open attachment: {1}. Error message: Could not write file") % filename));
             return;
@@ -837,7 +1318,6 @@ void LoadHandler::parseAudio() {
 
         readBytes += static_cast<zip_uint64_t>(read);
     }
-    g_free(data);
     zip_fclose(attachmentFile);
 
     g_hash_table_insert(this->audioFiles, g_strdup(filename), g_file_get_path(tmpFile.get()));
@@ -906,7 +1386,8 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
         handler->pos = PARSER_POS_IN_LAYER;
         handler->text = nullptr;
     } else if (handler->pos == PARSER_POS_IN_IMAGE && strcmp(elementName, "image") == 0) {
-        xoj_assert_message(handler->image->getImage() != nullptr, "image can't be rendered");
+        // Not decoded here: the images are rendered with their pages, on the render threads
+        xoj_assert_message(handler->image->getImageFormat(), "image can't be rendered");
         handler->pos = PARSER_POS_IN_LAYER;
         handler->image = nullptr;
     } else if (handler->pos == PARSER_POS_IN_TEXIMAGE && strcmp(elementName, "teximage") == 0) {
@@ -915,6 +1396,28 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
     }
 }
 
+void LoadHandler::applyPressureBuffer() {
+    if (this->pressureBuffer.empty()) {
+        return;
+    }
+    if (this->pressureBuffer.size() + 1 >= this->stroke->getPointCount()) {
+        auto firstNonPositive = std::find_if(this->pressureBuffer.begin(), this->pressureBuffer.end(),
+                                             [](double v) { return v <= 0 || std::isnan(v); });
+        if (firstNonPositive != this->pressureBuffer.end()) {
+            // Warning: this may delete this->stroke if no positive pressure values are provided
+            // Do not dereference this->stroke after that
+            this->fixNullPressureValues();
+        } else {
+            this->stroke->setPressure(this->pressureBuffer);
+        }
+    } else {
+        g_warning("%s", FC(_F("xoj-File: {1}") % this->filepath.string().c_str()));
+        g_warning("%s", FC(_F("Wrong number of pressure values, got {1}, expected {2}") %
+                           this->pressureBuffer.size() % (this->stroke->getPointCount() - 1)));
+    }
+    this->pressureBuffer.clear();
+}
+
 void LoadHandler::fixNullPressureValues() {
     /*
      * Due to various bugs (see e.g. https://github.com/xournalpp/xournalpp/issues/3643), old files may contain strokes
@@ -992,54 +1495,29 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
 
     auto* handler = static_cast<LoadHandler*>(userdata);
     if (handler->pos == PARSER_POS_IN_STROKE) {
-        const char* ptr = text;
-        int n = 0;
+        const char* end = text + textLen;
 
-        bool xRead = false;
-        double x = 0;
+        // Parse straight into the stroke's final point vector, sized up front
+        std::vector<Point> points = handler->stroke->getPointVector();
+        points.reserve(points.size() + xoj::util::countNumberTokens(text, end) / 2);
 
-        while (textLen > 0) {
-            double tmp = g_ascii_strtod(text, const_cast<char**>(&ptr));
-            if (ptr == text) {
-                break;
-            }
-            textLen -= as_unsigned(ptr - text);
-            text = ptr;
-            n++;
-
-            if (!xRead) {
-                xRead = true;
-                x = tmp;
+        int n = 0;
+        double x = 0;
+        xoj::util::forEachNumber(text, end, [&](double v) {
+            if ((n++ & 1) == 0) {
+                x = v;
             } else {
-                xRead = false;
-                handler->stroke->addPoint(Point(x, tmp));
+                points.emplace_back(x, v);
             }
-        }
-        handler->stroke->freeUnusedPointItems();
+        });
+        handler->stroke->setPointVector(std::move(points));
 
         if (n < 4 || (n & 1)) {
             error2(*error, "%s", FC(_F("Wrong count of points ({1})") % n));
             return;
         }
 
-        if (!handler->pressureBuffer.empty()) {
-            if (handler->pressureBuffer.size() + 1 >= handler->stroke->getPointCount()) {
-                auto firstNonPositive = std::find_if(handler->pressureBuffer.begin(), handler->pressureBuffer.end(),
-                                                     [](double v) { return v <= 0 || std::isnan(v); });
-                if (firstNonPositive != handler->pressureBuffer.end()) {
-                    // Warning: this may delete handler->stroke if no positive pressure values are provided
-                    // Do not dereference handler->stroke after that
-                    handler->fixNullPressureValues();
-                } else {
-                    handler->stroke->setPressure(handler->pressureBuffer);
-                }
-            } else {
-                g_warning("%s", FC(_F("xoj-File: {1}") % handler->filepath.string().c_str()));
-                g_warning("%s", FC(_F("Wrong number of pressure values, got {1}, expected {2}") %
-                                   handler->pressureBuffer.size() % (handler->stroke->getPointCount() - 1)));
-            }
-            handler->pressureBuffer.clear();
-        }
+        handler->applyPressureBuffer();
     } else if (handler->pos == PARSER_POS_IN_TEXT) {
         gchar* txt = g_strndup(text, textLen);
         handler->text->setText(txt);
@@ -1052,16 +1530,13 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
 }
 
 auto LoadHandler::parseBase64(const gchar* base64, gsize length) -> string {
-    // We have to copy the string in order to null terminate it, sigh.
-    auto* base64data = static_cast<gchar*>(g_memdup(base64, static_cast<guint>(length) + 1));
-    base64data[length] = '\0';
-
-    gsize binaryBufferLen = 0;
-    guchar* binaryBuffer = g_base64_decode(base64data, &binaryBufferLen);
-    g_free(base64data);
-
-    string str = string(reinterpret_cast<char*>(binaryBuffer), binaryBufferLen);
-    g_free(binaryBuffer);
+    // Decoded in place: the text does not need to be null terminated
+    string str((length / 4) * 3 + 3, '\0');
+    gint state = 0;
+    guint save = 0;
+    const gsize decodedLength =
+            g_base64_decode_step(base64, length, reinterpret_cast<guchar*>(str.data()), &state, &save);
+    str.resize(decodedLength);
 
     return str;
 }
@@ -1120,6 +1595,7 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> std::unique_ptr<Docu
 }
 
 auto LoadHandler::readZipAttachment(fs::path const& filename) -> std::unique_ptr<std::string> {
+    std::lock_guard lock(*this->zipMutex);
     zip_stat_t attachmentFileStat;
     const int statStatus = zip_stat(this->zipFp, filename.u8string().c_str(), 0, &attachmentFileStat);
     if (statStatus != 0) {
@@ -1172,3 +1648,13 @@ auto LoadHandler::getTempFileForPath(fs::path const& filename) -> fs::path {
 }
 
 auto LoadHandler::getFileVersion() const -> int { return this->fileVersion; }
+
+auto LoadHandler::getJournalPages() const -> const std::vector<size_t>& { return this->journalPages; }
+
+auto LoadHandler::getJournalBasePageCount() const -> size_t { return this->journalBasePageCount; }
+
+void LoadHandler::setPageParserThreadCount(unsigned int count) { this->pageParserThreadCount = count; }
+
+void LoadHandler::setLazyPageLoading(bool lazy) { this->lazyPageLoading = lazy; }
+
+void LoadHandler::setPdfBackgroundLoading(bool load) { this->pdfBackgroundLoading = load; }
@@ -11,11 +11,15 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <memory>    // for unique_ptr
-#include <optional>  // for optional
-#include <string>    // for string
-#include <vector>    // for vector
+#include <cstddef>      // for size_t
+#include <future>       // for future
+#include <memory>       // for unique_ptr, shared_ptr
+#include <mutex>        // for mutex
+#include <optional>     // for optional
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <utility>      // for pair
+#include <vector>       // for vector
 
 #include <glib.h>     // for gchar, GError, gsize, GMarkupPars...
 #include <zip.h>      // for zip_file_t, zip_t
@@ -32,6 +36,7 @@
 
 class Image;
 class Layer;
+struct LazyContentSource;
 class Stroke;
 class TexImage;
 class Text;
@@ -65,6 +70,31 @@ public:
     /** @return The version of the loaded file */
     int getFileVersion() const;
 
+    /**
+     * @return For an autosave journal: the indices of its pages in the autosaved document, and the page count of the
+     * autosaved document (see AutosaveJournal)
+     */
+    const std::vector<size_t>& getJournalPages() const;
+    size_t getJournalBasePageCount() const;
+
+    /**
+     * Set the number of threads building the pages of a document.
+     * 0 (the default) uses one thread per processor, 1 parses the whole document on the calling thread.
+     */
+    void setPageParserThreadCount(unsigned int count);
+
+    /**
+     * Only read the size and the background of the pages: their layers are read when they are first needed.
+     * See XojPage::setContentLoader().
+     */
+    void setLazyPageLoading(bool lazy);
+
+    /**
+     * If false, the background PDF is not opened: only its file is recorded (see Document::getPdfFilepath()). For the
+     * documents whose pages are moved to another one.
+     */
+    void setPdfBackgroundLoading(bool load);
+
 private:
     void parseStart();
     void parseContents();
@@ -84,8 +114,68 @@ private:
     zip_int64_t readContentFile(char* buffer, zip_uint64_t len);
     bool closeFile();
     bool openFile(fs::path const& filepath);
+    /**
+     * Read content.xml. The uncompressed .xoj files are mapped in memory instead of being read.
+     */
+    std::shared_ptr<const std::string_view> readContent();
     bool parseXml();
 
+    GMarkupParseContext* createParseContext();
+    GMarkupParseContext* beginParse();
+    bool feedXml(GMarkupParseContext* context, std::string_view xml);
+    bool endParse(GMarkupParseContext* context, bool valid);
+
+    /**
+     * Position of a top level <page> element in content.xml, from its opening '<' to (excluding) the character
+     * following its closing tag
+     */
+    struct PageRange {
+        size_t begin;
+        size_t end;
+        /// The layers of the page, if they are its last children: from the first <layer> to the closing </page>
+        size_t layersBegin;
+        size_t layersEnd;
+        bool splitFailed = false;
+    };
+
+    /**
+     * @brief Find the top level pages of the document, without parsing them
+     * @return false if the pages cannot be parsed independently of each other
+     */
+    static bool scanPageRanges(std::string_view xml, std::vector<PageRange>& ranges);
+
+    /**
+     * @brief Parse the pages on worker threads, while this thread parses what is between the pages and adds the
+     *      pages to the document in order.
+     * @return false if any error occurred. The document must then be parsed again sequentially.
+     */
+    bool parsePagesInParallel(GMarkupParseContext* context, const std::shared_ptr<const std::string_view>& content,
+                              const std::vector<PageRange>& ranges, unsigned int threadCount);
+    void resetParserState();
+
+    /**
+     * Make this a handler parsing a single <page> element of the document loaded by mainHandler
+     */
+    void initPageParser(const LoadHandler& mainHandler);
+    bool parsePageChunk(std::string_view xml);
+    /**
+     * Resolve what the page parser could not do without the previous pages, and add the page to the document
+     */
+    bool addParsedPage(LoadHandler& pageParser);
+
+    /**
+     * Parse the layers of a lazily loaded page
+     */
+    bool loadLayers(const LazyContentSource& source, std::string_view xml, std::vector<Layer*>& layers);
+
+    /**
+     * Read the points of the stroke from the binary point data of the archive
+     */
+    void readBinaryPoints(size_t offset);
+    /**
+     * Give the pressure values read for the stroke to the stroke. Must be called last: this may delete the stroke.
+     */
+    void applyPressureBuffer();
     void fixNullPressureValues();
     static void parserText(GMarkupParseContext* context, const gchar* text, gsize textLen, gpointer userdata,
                            GError** error);
@@ -101,6 +191,17 @@ private:
     void parseBgSolid();
     void parseBgPixmap();
     void parseBgPdf();
+    void loadBackgroundPdf(const char* domain, fs::path pdfFilename);
+    /**
+     * Open the PDF background on another thread, while the rest of the file is parsed. The document is not touched
+     * by the parser until finishPdfLoading().
+     */
+    void startPdfLoading(fs::path pdfFilename, bool attachToDocument, std::unique_ptr<std::string> pdfBytes = {});
+    /**
+     * Wait for the PDF background to be open, if it is being opened
+     * @return false if it could not be read (the error is set)
+     */
+    bool finishPdfLoading();
     void parseAttachment();
 
     void readImage(const gchar* base64string, gsize base64stringLen);
@@ -125,6 +226,8 @@ private:
     fs::path filepath;
 
     bool pdfFilenameParsed;
+    /// The PDF background being opened, see startPdfLoading()
+    std::future<bool> pdfLoading;
 
     ParserPosition pos;
 
@@ -132,13 +235,36 @@ private:
     int fileVersion;
     int minimalFileVersion;
 
+    std::vector<size_t> journalPages;
+    size_t journalBasePageCount = 0;
+
     zip_t* zipFp;
     zip_file_t* zipContentFile;
     gzFile gzFp;
     bool isGzFile = false;
+    /// The content is mapped from the file, see readContent()
+    bool contentMapped = false;
+
+    /// The zip archive is shared with the page parsers
+    std::shared_ptr<std::mutex> zipMutex = std::make_shared<std::mutex>();
+
+    unsigned int pageParserThreadCount = 0;
+
+    bool lazyPageLoading = false;
+    bool pdfBackgroundLoading = true;
+
+    /// This handler only parses a single page, for a main handler
+    bool pageParser = false;
+    /// Page number given by a cloned background image, for the main handler to resolve
+    std::optional<size_t> clonedBackgroundPage;
+    /// Domain and filename of the first PDF background of the page, for the main handler to load the PDF
+    std::optional<std::pair<std::string, fs::path>> deferredPdfBackground;
 
     std::vector<double> pressureBuffer;
 
+    /// The points of the strokes stored in binary form (see BinaryPointData), if any. Shared with the page parsers.
+    std::shared_ptr<const std::string> pointData;
+
     std::vector<PageRef> pages;
     PageRef page;
     Layer* layer;
@@ -163,6 +289,8 @@ private:
     DocumentHandler dHanlder;
     std::unique_ptr<Document> doc;
 
+    friend class LazyPageLoader;
+
     friend Color LoadHandlerHelper::parseBackgroundColor(LoadHandler* loadHandler);
     friend bool LoadHandlerHelper::parseColor(const char* text, Color& color, LoadHandler* loadHandler);
 
@@ -0,0 +1,441 @@
+#include "RecoveryJournal.h"
+
+#include <cstring>       // for memcmp, strlen
+#include <memory>        // for unique_ptr, make_unique
+#include <system_error>  // for error_code
+#include <utility>       // for move
+
+#include <glib.h>        // for g_warning
+#include <glib/gstdio.h>  // for g_fopen
+
+#include "model/Document.h"                         // for Document
+#include "model/Element.h"                          // for Element, ElementPtr
+#include "model/Image.h"                            // for Image
+#include "model/Layer.h"                            // for Layer
+#include "model/Stroke.h"                           // for Stroke
+#include "model/TexImage.h"                         // for TexImage
+#include "model/Text.h"                             // for Text
+#include "model/XojPage.h"                          // for XojPage
+#include "util/PathUtil.h"                          // for getConfigFile, hasXournalFileExt
+#include "util/i18n.h"                              // for FS, _F
+#include "util/serializing/BinObjectEncoding.h"     // for BinObjectEncoding
+#include "util/serializing/InputStreamException.h"  // for InputStreamException
+#include "util/serializing/ObjectInputStream.h"     // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"    // for ObjectOutputStream
+
+#ifdef _WIN32
+#include <io.h>  // for _commit, _fileno
+#else
+#include <unistd.h>  // for fsync
+#endif
+
+namespace {
+constexpr char MAGIC[] = "XOPP-RECOVERY/1\n";
+constexpr size_t MAGIC_LENGTH = sizeof(MAGIC) - 1;
+
+auto toString(ObjectOutputStream& out) -> std::string {
+    GString* data = out.getStr();
+    std::string s(data->str, data->len);
+    g_string_free(data, true);
+    return s;
+}
+
+/// The saved file, as it is on the disk: the journal only applies to that version
+auto getFileStamp(const fs::path& file, size_t& fileSize, size_t& modified) -> bool {
+    std::error_code ec;
+    fileSize = static_cast<size_t>(fs::file_size(file, ec));
+    if (ec) {
+        return false;
+    }
+    modified = static_cast<size_t>(fs::last_write_time(file, ec).time_since_epoch().count());
+    return !ec;
+}
+
+auto serializeHeader(const fs::path& documentFile, size_t pageCount) -> std::optional<std::string> {
+    size_t fileSize = 0;
+    size_t modified = 0;
+    if (!getFileStamp(documentFile, fileSize, modified)) {
+        return std::nullopt;
+    }
+    ObjectOutputStream out(new BinObjectEncoding());
+    out.writeObject("RecoveryJournal");
+    out.writeString(documentFile.u8string());
+    out.writeSizeT(fileSize);
+    out.writeSizeT(modified);
+    out.writeSizeT(pageCount);
+    out.endObject();
+    return toString(out);
+}
+
+auto serializePage(size_t index, XojPage& page) -> std::string {
+    ObjectOutputStream out(new BinObjectEncoding());
+    out.writeObject("RecoveryPage");
+    out.writeSizeT(index);
+    const auto& layers = *page.getLayers();
+    out.writeSizeT(layers.size());
+    for (const Layer* l: layers) {
+        out.writeInt(l->isVisible());
+        out.writeInt(l->hasName());
+        out.writeString(l->hasName() ? l->getName() : std::string());
+        const auto& elements = l->getElements();
+        out.writeSizeT(elements.size());
+        for (const auto& e: elements) {
+            e->serialize(out);
+        }
+    }
+    out.endObject();
+    return toString(out);
+}
+
+auto readElement(ObjectInputStream& in) -> ElementPtr {
+    std::string name = in.getNextObjectName();
+    ElementPtr element;
+    if (name == "Stroke") {
+        element = std::make_unique<Stroke>();
+    } else if (name == "Image") {
+        element = std::make_unique<Image>();
+    } else if (name == "TexImage") {
+        element = std::make_unique<TexImage>();
+    } else if (name == "Text") {
+        element = std::make_unique<Text>();
+    } else {
+        throw InputStreamException(FS(FORMAT_STR("Get unknown object {1}") % name), __FILE__, __LINE__);
+    }
+    element->readSerialized(in);
+    return element;
+}
+
+auto writeBlob(FILE* stream, const std::string& blob) -> bool {
+    const uint64_t length = blob.size();
+    return fwrite(&length, sizeof(length), 1, stream) == 1 &&
+           fwrite(blob.data(), 1, blob.size(), stream) == blob.size();
+}
+
+auto readBlob(FILE* stream, std::string& blob) -> bool {
+    uint64_t length = 0;
+    if (fread(&length, sizeof(length), 1, stream) != 1) {
+        return false;
+    }
+    blob.resize(static_cast<size_t>(length));
+    return fread(blob.data(), 1, blob.size(), stream) == blob.size();
+}
+
+auto syncToDisk(FILE* stream) -> bool {
+    if (fflush(stream) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(stream)) == 0;
+#else
+    return fsync(fileno(stream)) == 0;
+#endif
+}
+}  // namespace
+
+RecoveryJournal::RecoveryJournal(fs::path journalFile): file(std::move(journalFile)) {
+    std::error_code ec;
+    this->leftover = fs::exists(this->file, ec);
+}
+
+RecoveryJournal::~RecoveryJournal() { close(); }
+
+auto RecoveryJournal::getDefaultPath() -> fs::path { return Util::getConfigFile("recovery.journal"); }
+
+auto RecoveryJournal::captureBaseline(Document* doc) -> Baseline {
+    Baseline baseline;
+    baseline.reserve(doc->getPageCount());
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        baseline.emplace_back(doc->getPage(i));
+    }
+    return baseline;
+}
+
+void RecoveryJournal::start(const fs::path& documentFile, Baseline baseline) {
+    std::lock_guard lock(this->mutex);
+    invalidate();
+
+    if (this->leftover || this->kept || documentFile.empty() || !Util::hasXournalFileExt(documentFile)) {
+        return;
+    }
+    auto headerBlob = serializeHeader(documentFile, baseline.size());
+    if (!headerBlob) {
+        return;
+    }
+
+    this->stream = g_fopen(this->file.u8string().c_str(), "w+b");
+    if (!this->stream) {
+        g_warning("Could not create the recovery journal %s", this->file.u8string().c_str());
+        return;
+    }
+    this->documentFile = documentFile;
+    if (fwrite(MAGIC, 1, MAGIC_LENGTH, this->stream) != MAGIC_LENGTH || !writeBlob(this->stream, *headerBlob) ||
+        !syncToDisk(this->stream)) {
+        g_warning("Could not write the recovery journal %s", this->file.u8string().c_str());
+        invalidate();
+        return;
+    }
+
+    this->header = std::move(*headerBlob);
+    this->pages = std::move(baseline);
+    this->size = MAGIC_LENGTH + sizeof(uint64_t) + this->header.size();
+    this->active = true;
+}
+
+void RecoveryJournal::stop() {
+    std::lock_guard lock(this->mutex);
+    invalidate();
+}
+
+auto RecoveryJournal::keepForRecovery() -> bool {
+    this->kept = true;
+    return this->active;
+}
+
+void RecoveryJournal::close() {
+    if (this->stream) {
+        fclose(this->stream);
+        this->stream = nullptr;
+    }
+}
+
+void RecoveryJournal::invalidate() {
+    // Unset first: the crash handler must not rely on a journal being removed
+    this->active = false;
+    close();
+    if (!this->leftover && !this->kept && !this->documentFile.empty()) {
+        std::error_code ec;
+        fs::remove(this->file, ec);
+    }
+    this->documentFile.clear();
+    this->header.clear();
+    this->pages.clear();
+    this->lastRecords.clear();
+    this->size = 0;
+}
+
+void RecoveryJournal::record(Document* doc) {
+    std::lock_guard lock(this->mutex);
+    if (!this->active) {
+        return;
+    }
+
+    // The pages are serialized with the document locked, and written once it is unlocked
+    std::vector<std::pair<size_t, std::string>> records;
+    doc->lock();
+    bool samePages = doc->getPageCount() == this->pages.size();
+    for (size_t i = 0; samePages && i < this->pages.size(); i++) {
+        PageRef p = doc->getPage(i);
+        auto& state = this->pages[i];
+        if (state.page.lock() != p || !state.sameBackground(p)) {
+            samePages = false;
+        } else if (!state.matches(p)) {
+            records.emplace_back(i, serializePage(i, *p));
+            state = AutosaveJournal::PageState(p);
+        }
+    }
+    doc->unlock();
+
+    if (!samePages) {
+        // Not replayable onto the saved file anymore
+        invalidate();
+        return;
+    }
+    if (records.empty()) {
+        return;
+    }
+
+    for (const auto& [index, blob]: records) {
+        if (!writeBlob(this->stream, blob)) {
+            invalidate();
+            return;
+        }
+        this->lastRecords[index] = {this->size, blob.size()};
+        this->size += sizeof(uint64_t) + blob.size();
+    }
+    if (!syncToDisk(this->stream)) {
+        g_warning("Could not write the recovery journal %s", this->file.u8string().c_str());
+        invalidate();
+        return;
+    }
+
+    uint64_t live = this->header.size();
+    for (const auto& [index, blob]: this->lastRecords) {
+        live += sizeof(uint64_t) + blob.length;
+    }
+    if (this->size > MIN_COMPACTION_SIZE && this->size > COMPACTION_FACTOR * live) {
+        compact();
+    }
+}
+
+void RecoveryJournal::compact() {
+    // Written aside and renamed, so that a crash in between leaves one complete journal
+    auto tmpFile = this->file;
+    tmpFile += ".tmp";
+    FILE* out = g_fopen(tmpFile.u8string().c_str(), "w+b");
+    if (!out) {
+        return;
+    }
+
+    std::map<size_t, Blob> records;
+    uint64_t newSize = MAGIC_LENGTH + sizeof(uint64_t) + this->header.size();
+    bool ok = fwrite(MAGIC, 1, MAGIC_LENGTH, out) == MAGIC_LENGTH && writeBlob(out, this->header);
+    std::string blob;
+    for (const auto& [index, position]: this->lastRecords) {
+        if (!ok) {
+            break;
+        }
+        ok = fseek(this->stream, static_cast<long>(position.offset), SEEK_SET) == 0 && readBlob(this->stream, blob) &&
+             writeBlob(out, blob);
+        records[index] = {newSize, blob.size()};
+        newSize += sizeof(uint64_t) + blob.size();
+    }
+    ok = ok && syncToDisk(out);
+
+    std::error_code ec;
+    if (ok) {
+        fclose(this->stream);
+        this->stream = nullptr;
+        fs::rename(tmpFile, this->file, ec);
+    }
+    if (!ok || ec) {
+        fclose(out);
+        fs::remove(tmpFile, ec);
+        if (!this->stream) {
+            // The journal is lost
+            invalidate();
+        } else {
+            fseek(this->stream, 0, SEEK_END);
+        }
+        return;
+    }
+
+    this->stream = out;
+    fseek(this->stream, 0, SEEK_END);
+    this->lastRecords = std::move(records);
+    this->size = newSize;
+}
+
+auto RecoveryJournal::isActive() const -> bool { return this->active; }
+
+auto RecoveryJournal::getFile() const -> const fs::path& { return this->file; }
+
+auto RecoveryJournal::hasLeftover() const -> bool {
+    std::lock_guard lock(this->mutex);
+    return this->leftover;
+}
+
+void RecoveryJournal::discardLeftover() {
+    std::lock_guard lock(this->mutex);
+    if (this->leftover) {
+        std::error_code ec;
+        fs::remove(this->file, ec);
+        this->leftover = false;
+    }
+}
+
+auto RecoveryJournal::read(const fs::path& journalFile, std::string& error) -> std::optional<Recovery> {
+    FILE* stream = g_fopen(journalFile.u8string().c_str(), "rb");
+    if (!stream) {
+        return std::nullopt;
+    }
+    std::unique_ptr<FILE, decltype(&fclose)> guard(stream, &fclose);
+
+    char magic[MAGIC_LENGTH];
+    std::string headerBlob;
+    if (fread(magic, 1, MAGIC_LENGTH, stream) != MAGIC_LENGTH || std::memcmp(magic, MAGIC, MAGIC_LENGTH) != 0 ||
+        !readBlob(stream, headerBlob)) {
+        error = FS(_F("\"{1}\" is not a recovery journal") % journalFile.u8string());
+        return std::nullopt;
+    }
+
+    Recovery recovery;
+    size_t fileSize = 0;
+    size_t modified = 0;
+    try {
+        ObjectInputStream in;
+        if (!in.read(headerBlob.data(), headerBlob.size())) {
+            throw InputStreamException("Invalid header", __FILE__, __LINE__);
+        }
+        in.readObject("RecoveryJournal");
+        recovery.documentFile = fs::u8path(in.readString());
+        fileSize = in.readSizeT();
+        modified = in.readSizeT();
+        recovery.pageCount = in.readSizeT();
+        in.endObject();
+    } catch (const InputStreamException& e) {
+        error = FS(_F("Could not read the recovery journal \"{1}\": {2}") % journalFile.u8string() % e.what());
+        return std::nullopt;
+    }
+
+    size_t currentSize = 0;
+    size_t currentModified = 0;
+    if (!getFileStamp(recovery.documentFile, currentSize, currentModified) || currentSize != fileSize ||
+        currentModified != modified) {
+        error = FS(_F("The file \"{1}\" was modified since the changes were recorded") %
+                   recovery.documentFile.u8string());
+        return std::nullopt;
+    }
+
+    // An incomplete last record was being written during the crash
+    std::string blob;
+    while (readBlob(stream, blob)) {
+        recovery.records.emplace_back(std::move(blob));
+    }
+    return recovery;
+}
+
+auto RecoveryJournal::apply(Document* doc, const Recovery& recovery, std::string& error) -> bool {
+    if (doc->getPageCount() != recovery.pageCount) {
+        error = FS(_F("The recovery journal does not match the file \"{1}\"") % recovery.documentFile.u8string());
+        return false;
+    }
+
+    // The last record of each page wins
+    std::map<size_t, std::vector<std::unique_ptr<Layer>>> pageLayers;
+    try {
+        for (const auto& record: recovery.records) {
+            ObjectInputStream in;
+            if (!in.read(record.data(), record.size())) {
+                throw InputStreamException("Invalid record", __FILE__, __LINE__);
+            }
+            in.readObject("RecoveryPage");
+            const size_t index = in.readSizeT();
+            if (index >= recovery.pageCount) {
+                throw InputStreamException("Invalid page index", __FILE__, __LINE__);
+            }
+            std::vector<std::unique_ptr<Layer>> layers(in.readSizeT());
+            for (auto& l: layers) {
+                l = std::make_unique<Layer>();
+                l->setVisible(in.readInt());
+                const bool hasName = in.readInt();
+                std::string name = in.readString();
+                if (hasName) {
+                    l->setName(name);
+                }
+                const size_t count = in.readSizeT();
+                for (size_t i = 0; i < count; i++) {
+                    l->addElement(readElement(in));
+                }
+            }
+            in.endObject();
+            pageLayers[index] = std::move(layers);
+        }
+    } catch (const InputStreamException& e) {
+        error = FS(_F("Could not read the recovery journal: {1}") % e.what());
+        return false;
+    }
+
+    for (auto& [index, layers]: pageLayers) {
+        PageRef page = doc->getPage(index);
+        std::vector<Layer*> oldLayers = *page->getLayers();
+        // Added first: a page is never left without layers
+        for (auto& l: layers) {
+            page->addLayer(l.release());
+        }
+        for (Layer* l: oldLayers) {
+            page->removeLayer(l);
+            delete l;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,162 @@
+/*
+ * Xournal++
+ *
+ * Journal of the pages modified since the document was saved, for the recovery after a crash
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>    // for atomic_bool
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
+#include <cstdio>    // for FILE
+#include <map>       // for map
+#include <mutex>     // for mutex
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include "AutosaveJournal.h"  // for AutosaveJournal::PageState
+#include "filesystem.h"       // for path
+
+class Document;
+
+/**
+ * @brief An append-only journal of the pages modified since the document was last saved or opened, so that a crash
+ * does not depend on saving the whole document from the crash handler (see emergencySave()).
+ *
+ * The journal starts with a header naming the saved file. Every record(), a few seconds after the changes, appends
+ * the layers of the pages modified since the previous record, serialized with ObjectOutputStream, and syncs the file
+ * to the disk. After a crash, the records are replayed onto the saved file, the last record of a page winning.
+ *
+ * Only the layers are journaled: when the pages are added, removed, reordered or get another background, the
+ * journal is removed and the crash handler saves the whole document again.
+ */
+class RecoveryJournal {
+public:
+    /// The state of the pages of the document, as saved in its file
+    using Baseline = std::vector<AutosaveJournal::PageState>;
+
+    /// The records found in the journal of a crashed session
+    struct Recovery {
+        fs::path documentFile;
+        size_t pageCount = 0;
+        std::vector<std::string> records;
+    };
+
+    /// The seconds between a change and its record
+    static constexpr unsigned RECORD_DELAY = 2;
+
+    /**
+     * A journal left in journalFile by a crashed session (or by another running instance) is kept until it is
+     * discarded, see hasLeftover(): no journal is started meanwhile.
+     */
+    explicit RecoveryJournal(fs::path journalFile);
+    ~RecoveryJournal();
+
+    RecoveryJournal(const RecoveryJournal&) = delete;
+    RecoveryJournal& operator=(const RecoveryJournal&) = delete;
+
+    /**
+     * @return The state of the pages of doc, to start the journal once doc is saved. The document must be locked.
+     */
+    static Baseline captureBaseline(Document* doc);
+
+    /**
+     * Start a new journal for the document saved in documentFile, whose pages were in the state baseline
+     */
+    void start(const fs::path& documentFile, Baseline baseline);
+
+    /**
+     * Stop journaling, and remove the journal
+     */
+    void stop();
+
+    /**
+     * Keep the journal file for the next session, instead of the emergency save. Lock free, for the crash handler.
+     * @return false if the journal is not active: the document must be saved
+     */
+    bool keepForRecovery();
+
+    /**
+     * Append the pages of doc modified since the last record. Doc must not be locked.
+     */
+    void record(Document* doc);
+
+    /**
+     * @return true if the journal holds the changes to the saved file. May be called from the crash handler.
+     */
+    bool isActive() const;
+
+    const fs::path& getFile() const;
+
+    /**
+     * @return true if the journal file of another session was found at the construction, see read()
+     */
+    bool hasLeftover() const;
+
+    /**
+     * Remove the journal file of another session, so that the journal can start
+     */
+    void discardLeftover();
+
+    /**
+     * Read the journal of a crashed session
+     * @return Nothing if there is no journal, or if it does not match the saved file anymore (see error)
+     */
+    static std::optional<Recovery> read(const fs::path& journalFile, std::string& error);
+
+    /**
+     * Replace the layers of the pages of doc, read from recovery.documentFile, by the recorded ones
+     * @return false if the records could not be applied
+     */
+    static bool apply(Document* doc, const Recovery& recovery, std::string& error);
+
+    static fs::path getDefaultPath();
+
+public:
+    /// The journal is rewritten with the last record of each page when it is that much larger
+    static constexpr uint64_t COMPACTION_FACTOR = 4;
+    static constexpr uint64_t MIN_COMPACTION_SIZE = 1024 * 1024;
+
+private:
+    /// The position of a record in the file
+    struct Blob {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+    };
+
+    void close();
+
+    /**
+     * Stop and remove the journal, the mutex being locked
+     */
+    void invalidate();
+
+    /**
+     * Rewrite the journal with the last record of each page
+     */
+    void compact();
+
+private:
+    mutable std::mutex mutex;
+
+    fs::path file;
+    FILE* stream = nullptr;
+    std::atomic_bool active = false;
+    std::atomic_bool kept = false;
+    bool leftover = false;
+
+    fs::path documentFile;
+    std::string header;
+    Baseline pages;
+
+    uint64_t size = 0;
+    /// The last record of each page
+    std::map<size_t, Blob> lastRecords;
+};
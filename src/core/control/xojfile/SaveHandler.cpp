@@ -2,13 +2,22 @@
 
 #include <cinttypes>   // for PRIx32
 #include <cstdint>     // for uint32_t
+#include <algorithm>   // for min
 #include <cstdio>      // for sprintf, size_t
 #include <filesystem>  // for exists
+#include <fstream>     // for ifstream
+#include <memory>      // for unique_ptr
+#include <string>      // for to_string
+#include <utility>     // for pair
+#include <vector>      // for vector
 
 #include <cairo.h>                  // for cairo_surface_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for gdk_pixbuf_save
 #include <glib.h>                   // for g_free, g_strdup_printf
+#include <zip.h>                    // for zip_open, zip_file_add, zip_source_buffer
+#include <zlib.h>                   // for crc32
 
+#include "control/jobs/ProgressListener.h"      // for ProgressListener
 #include "control/pagetype/PageTypeHandler.h"  // for PageTypeHandler
 #include "control/xml/XmlAudioNode.h"          // for XmlAudioNode
 #include "control/xml/XmlImageNode.h"          // for XmlImageNode
@@ -22,6 +31,7 @@
 #include "model/Element.h"                     // for Element, ELEMENT_IMAGE
 #include "model/Font.h"                        // for XojFont
 #include "model/Image.h"                       // for Image
+#include "model/ImageBuffer.h"                 // for ImageBuffer
 #include "model/Layer.h"                       // for Layer
 #include "model/LineStyle.h"                   // for LineStyle
 #include "model/PageType.h"                    // for PageType
@@ -37,47 +47,211 @@
 #include "util/PlaceholderString.h"            // for PlaceholderString
 #include "util/i18n.h"                         // for FS, _F
 
+#include "BinaryPointData.h"  // for append, ENTRY_NAME, FORMAT_XY
+
 #include "config.h"  // for FILE_FORMAT_VERSION
 
+namespace {
+/// Last version of the format without binary points: the files not using them are not flagged as newer
+constexpr int TEXT_FILE_FORMAT_VERSION = 4;
+/// The entry of the preview in the archives, read by xournalpp-thumbnailer
+constexpr const char* THUMBNAIL_ENTRY_NAME = "thumbnails/thumbnail.png";
+
+struct ZipDiscarder {
+    void operator()(zip_t* zip) const { zip_discard(zip); }
+};
+
+/**
+ * The archive written by the previous save. Its entries are found by content (size and CRC-32), so that the names of
+ * the images may change from a save to the next.
+ */
+class PreviousArchive {
+public:
+    explicit PreviousArchive(const fs::path& path) {
+        if (path.empty()) {
+            return;
+        }
+        int error = 0;
+        archive.reset(zip_open(path.u8string().c_str(), ZIP_RDONLY, &error));
+        if (!archive) {
+            // Not an archive, e.g. a .xoj file or an annotated PDF
+            return;
+        }
+        const zip_int64_t count = zip_get_num_entries(archive.get(), 0);
+        for (zip_uint64_t i = 0; count > 0 && i < static_cast<zip_uint64_t>(count); i++) {
+            zip_stat_t st;
+            if (zip_stat_index(archive.get(), i, 0, &st) == 0 && (st.valid & ZIP_STAT_SIZE) &&
+                (st.valid & ZIP_STAT_CRC)) {
+                entries.push_back({st.size, st.crc, i});
+            }
+        }
+    }
+
+    /// @return A source copying the entry with this content without recompressing it, or nullptr
+    auto findBuffer(zip_t* target, const std::string& data) const -> zip_source_t* {
+        return find(target, data.size(), [&data]() {
+            uLong crc = crc32(0L, Z_NULL, 0);
+            constexpr size_t CHUNK = 1 << 20;
+            for (size_t done = 0; done < data.size(); done += CHUNK) {
+                crc = crc32(crc, reinterpret_cast<const Bytef*>(data.data() + done),
+                            static_cast<uInt>(std::min(CHUNK, data.size() - done)));
+            }
+            return static_cast<zip_uint32_t>(crc);
+        });
+    }
+
+    /// @return A source copying the entry with the content of the file without recompressing it, or nullptr
+    auto findFile(zip_t* target, const fs::path& file) const -> zip_source_t* {
+        std::error_code ec;
+        const auto size = fs::file_size(file, ec);
+        if (ec) {
+            return nullptr;
+        }
+        return find(target, size, [&file]() {
+            uLong crc = crc32(0L, Z_NULL, 0);
+            std::ifstream in(file, std::ios::binary);
+            std::vector<char> chunk(1 << 20);
+            while (in.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || in.gcount() > 0) {
+                crc = crc32(crc, reinterpret_cast<const Bytef*>(chunk.data()), static_cast<uInt>(in.gcount()));
+            }
+            return static_cast<zip_uint32_t>(crc);
+        });
+    }
+
+private:
+    template <typename Crc>
+    auto find(zip_t* target, zip_uint64_t size, Crc computeCrc) const -> zip_source_t* {
+        bool computed = false;
+        zip_uint32_t crc = 0;
+        for (const Entry& e: entries) {
+            if (e.size != size) {
+                continue;
+            }
+            if (!computed) {
+                // Only computed if an entry has the same size
+                crc = computeCrc();
+                computed = true;
+            }
+            if (e.crc == crc) {
+                // The whole entry: its compressed data are copied as they are
+                return zip_source_zip(target, archive.get(), e.index, 0, 0, -1);
+            }
+        }
+        return nullptr;
+    }
+
+    struct Entry {
+        zip_uint64_t size;
+        zip_uint32_t crc;
+        zip_uint64_t index;
+    };
+
+    /// Read by zip_close() of the new archive: must outlive it
+    std::unique_ptr<zip_t, ZipDiscarder> archive;
+    std::vector<Entry> entries;
+};
+
+auto hasAudioRecordings(Document* doc) -> bool {
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        for (Layer* l: *doc->getPage(i)->getLayers()) {
+            for (auto&& e: l->getElements()) {
+                auto* audioElement = dynamic_cast<AudioElement*>(e.get());
+                if (audioElement && !audioElement->getAudioFilename().empty()) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+}  // namespace
+
 SaveHandler::SaveHandler() {
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
 }
 
+void SaveHandler::setBinaryPointEncoding(bool binary) { this->binaryPointEncoding = binary; }
+
+void SaveHandler::setPreviousArchive(fs::path path) { this->previousArchive = std::move(path); }
+
 void SaveHandler::prepareSave(Document* doc) {
+    prepareHeader(doc);
+    clearSaveState(doc);
+
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef p = doc->getPage(i);
+        visitPage(root.get(), p, doc, static_cast<int>(i));
+    }
+}
+
+void SaveHandler::prepareJournal(Document* doc, const std::vector<size_t>& pages) {
+    prepareHeader(doc);
+    // The other pages may be shared with a document being modified, see Document::createSnapshot()
+    clearSaveState(doc, pages);
+
+    std::string indices;
+    for (size_t i: pages) {
+        indices += (indices.empty() ? "" : " ") + std::to_string(i);
+    }
+    this->root->setAttrib("journalpages", indices);
+    this->root->setAttrib("journalbasepages", doc->getPageCount());
+
+    // The ids are the ones of the pages within the journal, for the cloned backgrounds
+    int id = 0;
+    for (size_t i: pages) {
+        visitPage(root.get(), doc->getPage(i), doc, id++);
+    }
+}
+
+void SaveHandler::saveDocument(Document* doc, const fs::path& filepath, ProgressListener* listener) {
+    prepareHeader(doc);
+    clearSaveState(doc);
+    this->streamedDoc = doc;
+    saveTo(filepath, listener);
+    this->streamedDoc = nullptr;
+}
+
+void SaveHandler::prepareHeader(Document* doc) {
     if (this->root) {
         // cleanup old data
         backgroundImages.clear();
+        backgroundImageNames.clear();
+        pointData.clear();
+        attachedImages.clear();
+        attachedImageNames.clear();
+        attachedPdf.clear();
     }
 
     this->firstPdfPageVisited = false;
     this->attachBgId = 1;
+    // The audio recordings are referenced by their file name, which is not supported in archives
+    this->writeArchive = this->binaryPointEncoding && !hasAudioRecordings(doc);
 
     root.reset(new XmlNode("xournal"));
 
     writeHeader();
 
-    cairo_surface_t* preview = doc->getPreview();
-    if (preview) {
+    this->preview = doc->getPreview();
+    if (this->preview && !this->writeArchive) {
+        // The archives store the PNG as is, in an entry the thumbnailers read without decoding the XML
         auto* image = new XmlImageNode("preview");
-        image->setImage(preview);
+        image->setImage(this->preview);
         this->root->addChild(image);
     }
+}
 
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        p->getBackgroundImage().clearSaveState();
-    }
+void SaveHandler::clearSaveState(Document* doc, const std::vector<size_t>& pages) {
+    for (size_t i: pages) { doc->getPage(i)->getBackgroundImage().clearSaveState(); }
+}
 
-    for (size_t i = 0; i < doc->getPageCount(); i++) {
-        PageRef p = doc->getPage(i);
-        visitPage(root.get(), p, doc, static_cast<int>(i));
-    }
+void SaveHandler::clearSaveState(Document* doc) {
+    for (size_t i = 0; i < doc->getPageCount(); i++) { doc->getPage(i)->getBackgroundImage().clearSaveState(); }
 }
 
 void SaveHandler::writeHeader() {
     this->root->setAttrib("creator", PROJECT_STRING);
-    this->root->setAttrib("fileversion", FILE_FORMAT_VERSION);
+    this->root->setAttrib("fileversion", this->writeArchive ? FILE_FORMAT_VERSION : TEXT_FILE_FORMAT_VERSION);
     this->root->addChild(new XmlTextNode("title", std::string{"Xournal++ document - see "} + PROJECT_HOMEPAGE_URL));
 }
 
@@ -118,16 +292,26 @@ void SaveHandler::visitStroke(XmlPointNode* stroke, Stroke* s) {
 
     const auto& pts = s->getPointVector();
 
-    stroke->setPoints(pts);
-
-    if (s->hasPressure()) {
-        std::vector<double> values;
-        values.reserve(pts.size() + 1);
-        values.emplace_back(s->getWidth());
-        std::transform(pts.begin(), pts.end() - 1, std::back_inserter(values), [](const Point& p) { return p.z; });
-        stroke->setAttrib("width", std::move(values));
-    } else {
+    if (this->writeArchive) {
         stroke->setAttrib("width", s->getWidth());
+        stroke->setAttrib("pointOffset", this->pointData.size());
+        stroke->setAttrib("pointCount", pts.size());
+        stroke->setAttrib("pointFormat",
+                          s->hasPressure() ? BinaryPointData::FORMAT_XY_PRESSURE : BinaryPointData::FORMAT_XY);
+        BinaryPointData::append(this->pointData, pts, s->hasPressure());
+    } else {
+        stroke->setPoints(pts);
+
+        if (s->hasPressure()) {
+            std::vector<double> values;
+            values.reserve(pts.size() + 1);
+            values.emplace_back(s->getWidth());
+            std::transform(pts.begin(), pts.end() - 1, std::back_inserter(values),
+                           [](const Point& p) { return p.z; });
+            stroke->setAttrib("width", std::move(values));
+        } else {
+            stroke->setAttrib("width", s->getWidth());
+        }
     }
 
     visitStrokeExtended(stroke, s);
@@ -187,18 +371,34 @@ void SaveHandler::visitLayer(XmlNode* page, Layer* l) {
             writeTimestamp(t, text);
         } else if (e->getType() == ELEMENT_IMAGE) {
             auto* i = dynamic_cast<Image*>(e.get());
-            auto* image = new XmlImageNode("image");
+            XmlNode* image = nullptr;
+            if (this->writeArchive && i->getBuffer()) {
+                image = new XmlNode("image");
+                auto* attachment = new XmlNode("attachment");
+                attachment->setAttrib("path", attachImage(i->getBuffer()));
+                image->addChild(attachment);
+            } else {
+                auto* node = new XmlImageNode("image");
+                node->setImage(i->getBuffer());
+                image = node;
+            }
             layer->addChild(image);
 
-            image->setImage(i->getImage());
-
             image->setAttrib("left", i->getX());
             image->setAttrib("top", i->getY());
             image->setAttrib("right", i->getX() + i->getElementWidth());
             image->setAttrib("bottom", i->getY() + i->getElementHeight());
         } else if (e->getType() == ELEMENT_TEXIMAGE) {
             auto* i = dynamic_cast<TexImage*>(e.get());
-            auto* image = new XmlTexNode("teximage", std::string(i->getBinaryData()));
+            XmlNode* image = nullptr;
+            if (this->writeArchive && i->getBuffer()) {
+                image = new XmlNode("teximage");
+                auto* attachment = new XmlNode("attachment");
+                attachment->setAttrib("path", attachImage(i->getBuffer()));
+                image->addChild(attachment);
+            } else {
+                image = new XmlTexNode("teximage", i->getBuffer());
+            }
             layer->addChild(image);
 
             image->setAttrib("text", i->getText().c_str());
@@ -242,6 +442,7 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
                 if (!exists(filepath)) {
                     doc->getPdfDocument().save(filepath, &error);
                 }
+                this->attachedPdf = filepath;
 
                 if (error) {
                     if (!this->errorMessage.empty()) {
@@ -268,14 +469,19 @@ void SaveHandler::visitPage(XmlNode* root, PageRef p, Document* doc, int id) {
             background->setAttrib("filename", filename);
             g_free(filename);
         } else if (p->getBackgroundImage().isAttached() && p->getBackgroundImage().getPixbuf()) {
-            char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
+            // The identical images of other pages are written once
+            auto buffer = p->getBackgroundImage().getBuffer();
+            auto it = this->backgroundImageNames.find(buffer.get());
+            if (it == this->backgroundImageNames.end()) {
+                char* filename = g_strdup_printf("bg_%d.png", this->attachBgId++);
+                it = this->backgroundImageNames.emplace(buffer.get(), filename).first;
+                g_free(filename);
+                backgroundImages.emplace_back(p->getBackgroundImage());
+            }
             background->setAttrib("domain", "attach");
-            background->setAttrib("filename", filename);
-            p->getBackgroundImage().setFilepath(filename);
+            background->setAttrib("filename", it->second.u8string());
+            p->getBackgroundImage().setFilepath(it->second);
 
-            backgroundImages.emplace_back(p->getBackgroundImage());
-
-            g_free(filename);
             p->getBackgroundImage().setCloneId(id);
         } else {
             background->setAttrib("domain", "absolute");
@@ -316,6 +522,11 @@ void SaveHandler::writeBackgroundName(XmlNode* background, PageRef p) {
 }
 
 void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
+    if (this->writeArchive) {
+        saveToArchive(filepath, listener);
+        return;
+    }
+
     GzOutputStream out(filepath);
 
     if (!out.getLastError().empty()) {
@@ -332,15 +543,43 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
     }
 }
 
-void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
+void SaveHandler::writeContent(OutputStream* out, ProgressListener* listener) {
     // XMLNode should be locale-safe ( store doubles using Locale 'C' format
 
     out->write("<?xml version=\"1.0\" standalone=\"no\"?>\n");
-    root->writeOut(out, listener);
+    if (!this->streamedDoc) {
+        root->writeOut(out, listener);
+        return;
+    }
+
+    // Only one page is kept in memory as XML nodes
+    root->writeOpeningTag(out);
+    root->writeChildren(out);
+    root->clearChildren();
+
+    Document* doc = this->streamedDoc;
+    if (listener) {
+        listener->setMaximumState(doc->getPageCount());
+    }
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        visitPage(root.get(), doc->getPage(i), doc, static_cast<int>(i));
+        root->writeChildren(out);
+        root->clearChildren();
+        if (listener) {
+            listener->setCurrentState(i + 1);
+        }
+    }
+    root->writeClosingTag(out);
+}
+
+void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
+    writeContent(out, listener);
 
     for (BackgroundImage const& img: backgroundImages) {
         auto tmpfn = (fs::path(filepath) += ".") += img.getFilepath();
-        if (!gdk_pixbuf_save(img.getPixbuf(), tmpfn.u8string().c_str(), "png", nullptr, nullptr)) {
+        const std::string png = getBackgroundPng(img);
+        if (png.empty() || !g_file_set_contents(tmpfn.u8string().c_str(), png.data(), static_cast<gssize>(png.size()),
+                                                nullptr)) {
             if (!this->errorMessage.empty()) {
                 this->errorMessage += "\n";
             }
@@ -351,3 +590,136 @@ void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressLi
 }
 
 auto SaveHandler::getErrorMessage() -> std::string { return this->errorMessage; }
+
+auto SaveHandler::attachImage(const std::shared_ptr<const ImageBuffer>& buffer) -> std::string {
+    auto it = this->attachedImageNames.find(buffer.get());
+    if (it == this->attachedImageNames.end()) {
+        std::string name = "images/" + std::to_string(this->attachedImages.size() + 1);
+        it = this->attachedImageNames.emplace(buffer.get(), name).first;
+        this->attachedImages.emplace_back(std::move(name), buffer);
+    }
+    return it->second;
+}
+
+auto SaveHandler::getBackgroundPng(const BackgroundImage& img) -> std::string {
+    // The PNG images are written as they were read
+    auto buffer = img.getBuffer();
+    if (buffer && buffer->isPng()) {
+        return buffer->getData();
+    }
+
+    gchar* data = nullptr;
+    gsize size = 0;
+    if (!gdk_pixbuf_save_to_buffer(img.getPixbuf(), &data, &size, "png", nullptr, nullptr)) {
+        return {};
+    }
+    std::string png(data, size);
+    g_free(data);
+    return png;
+}
+
+void SaveHandler::saveToArchive(const fs::path& filepath, ProgressListener* listener) {
+    auto addError = [this](const std::string& message) {
+        if (!this->errorMessage.empty()) {
+            this->errorMessage += "\n";
+        }
+        this->errorMessage += message;
+    };
+
+    StringOutputStream content;
+    writeContent(&content, listener);
+
+    // The buffers must outlive the archive: they are only read by zip_close()
+    std::vector<std::pair<std::string, std::string>> entries;
+    entries.emplace_back("mimetype", "application/xournal++\n");
+    const std::string version = std::to_string(FILE_FORMAT_VERSION);
+    entries.emplace_back("META-INF/version", "current=" + version + "\nmin=" + version + "\n");
+    entries.emplace_back("content.xml", content.getData());
+    entries.emplace_back(BinaryPointData::ENTRY_NAME, std::move(this->pointData));
+    this->pointData.clear();
+
+    for (BackgroundImage const& img: backgroundImages) {
+        if (std::string png = getBackgroundPng(img); !png.empty()) {
+            entries.emplace_back(img.getFilepath().u8string(), std::move(png));
+        } else {
+            addError(FS(_F("Could not write background \"{1}\". Continuing anyway.") % img.getFilepath().u8string()));
+        }
+    }
+
+    fs::path previousPath = this->previousArchive;
+#ifdef _WIN32
+    // The file could not be replaced by zip_close() while it is open
+    if (std::error_code ec; fs::equivalent(previousPath, filepath, ec)) {
+        previousPath.clear();
+    }
+#endif
+    // Declared before the new archive, which reads from it when it is closed
+    const PreviousArchive previous(previousPath);
+
+    int zipError = 0;
+    zip_t* zipFp = zip_open(filepath.u8string().c_str(), ZIP_CREATE | ZIP_TRUNCATE, &zipError);
+    if (!zipFp) {
+        zip_error_t error;
+        zip_error_init_with_code(&error, zipError);
+        addError(FS(_F("Error opening file: \"{1}\"") % filepath.u8string()) + "\n" + zip_error_strerror(&error));
+        zip_error_fini(&error);
+        return;
+    }
+
+    auto addEntry = [zipFp](const char* name, zip_source_t* source) -> zip_int64_t {
+        if (!source) {
+            return -1;
+        }
+        const zip_int64_t index = zip_file_add(zipFp, name, source, ZIP_FL_OVERWRITE | ZIP_FL_ENC_UTF_8);
+        if (index < 0) {
+            zip_source_free(source);
+        }
+        return index;
+    };
+
+    bool valid = true;
+    for (auto&& [name, data]: entries) {
+        const zip_int64_t index = addEntry(name.c_str(), zip_source_buffer(zipFp, data.data(), data.size(), 0));
+        valid = valid && index >= 0;
+        if (valid && name == "mimetype") {
+            // Readable without decompressing, as in the other container formats
+            zip_set_file_compression(zipFp, static_cast<zip_uint64_t>(index), ZIP_CM_STORE, 0);
+        }
+    }
+    for (auto&& [name, buffer]: this->attachedImages) {
+        if (!valid) {
+            break;
+        }
+        // The buffers are kept alive by attachedImages
+        const std::string& data = buffer->getData();
+        zip_source_t* source = previous.findBuffer(zipFp, data);
+        valid = addEntry(name.c_str(), source ? source : zip_source_buffer(zipFp, data.data(), data.size(), 0)) >= 0;
+    }
+    if (valid && this->preview) {
+        const std::string& data = this->preview->getData();
+        const zip_int64_t index = addEntry(THUMBNAIL_ENTRY_NAME, zip_source_buffer(zipFp, data.data(), data.size(), 0));
+        valid = index >= 0;
+        if (valid) {
+            // Already compressed
+            zip_set_file_compression(zipFp, static_cast<zip_uint64_t>(index), ZIP_CM_STORE, 0);
+        }
+    }
+    if (valid && !this->attachedPdf.empty()) {
+        zip_source_t* source = previous.findFile(zipFp, this->attachedPdf);
+        if (!source) {
+            source = zip_source_file(zipFp, this->attachedPdf.u8string().c_str(), 0, 0);
+        }
+        valid = addEntry("bg.pdf", source) >= 0;
+    }
+    if (!valid) {
+        addError(FS(_F("Error writing data to file: \"{1}\"") % filepath.u8string()) + "\n" + zip_strerror(zipFp));
+        zip_discard(zipFp);
+        return;
+    }
+
+    if (zip_close(zipFp) != 0) {
+        addError(FS(_F("Error occurred while closing file: \"{1}\"") % filepath.u8string()) + "\n" +
+                 zip_strerror(zipFp));
+        zip_discard(zipFp);
+    }
+}
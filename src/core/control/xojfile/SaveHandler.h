@@ -11,9 +11,11 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <map>     // for map
+#include <memory>  // for unique_ptr, shared_ptr
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
 
 #include "control/xml/XmlNode.h"    // for XmlNode
 #include "model/BackgroundImage.h"  // for BackgroundImage
@@ -26,6 +28,7 @@ class XmlPointNode;
 class ProgressListener;
 class AudioElement;
 class Document;
+class ImageBuffer;
 class Layer;
 class OutputStream;
 class Stroke;
@@ -36,11 +39,39 @@ public:
     SaveHandler();
 
 public:
+    /**
+     * Store the points of the strokes in binary form, in a .xopp zip archive. Files with audio recordings are still
+     * saved in the text format, because their recordings are not part of the file.
+     * Must be set before prepareSave().
+     */
+    void setBinaryPointEncoding(bool binary);
+
+    /**
+     * The archive the document was saved to before, if any: the attachments found unchanged in it are copied as they
+     * are, without being compressed again
+     */
+    void setPreviousArchive(fs::path path);
+
+    /**
+     * Build the XML tree of the whole document, to be written by saveTo() (possibly after the document was unlocked)
+     */
     void prepareSave(Document* doc);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
-    std::string getErrorMessage();
 
+    /**
+     * Save the document without building its whole XML tree: the pages are converted and written one after the
+     * other. The document must stay locked during the call.
+     */
+    void saveDocument(Document* doc, const fs::path& filepath, ProgressListener* listener = nullptr);
+
+    /**
+     * Build the XML tree of some pages only, to be written by saveTo(). The indices of the pages in doc are stored in
+     * the root node, see AutosaveJournal.
+     */
+    void prepareJournal(Document* doc, const std::vector<size_t>& pages);
+
+    std::string getErrorMessage();
 protected:
     static std::string getColorStr(Color c, unsigned char alpha = 0xff);
 
@@ -58,12 +89,42 @@ protected:
     virtual void writeTimestamp(AudioElement* audioElement, XmlAudioNode* xmlAudioNode);
     virtual void writeBackgroundName(XmlNode* background, PageRef p);
 
+private:
+    /// Create the root node with the header, and reset the state of the previous save
+    void prepareHeader(Document* doc);
+    /// Reset the clone ids of the background images of the pages
+    static void clearSaveState(Document* doc);
+    static void clearSaveState(Document* doc, const std::vector<size_t>& pages);
+    void writeContent(OutputStream* out, ProgressListener* listener);
+    void saveToArchive(const fs::path& filepath, ProgressListener* listener);
+    /// Name of the archive entry holding the image, stored once for all the elements sharing its buffer
+    std::string attachImage(const std::shared_ptr<const ImageBuffer>& buffer);
+    /// The background image encoded as PNG
+    static std::string getBackgroundPng(const BackgroundImage& img);
+
 protected:
     std::unique_ptr<XmlNode> root{};
+    /// The document whose pages are written by writeContent(), if they are not part of root
+    Document* streamedDoc = nullptr;
     bool firstPdfPageVisited;
     int attachBgId;
 
     std::string errorMessage;
 
     std::vector<BackgroundImage> backgroundImages{};
+    /// The attached background images, by buffer: the identical images are written once
+    std::map<const ImageBuffer*, fs::path> backgroundImageNames;
+
+    bool binaryPointEncoding = false;
+    /// The document is saved in a zip archive, with the points in pointData
+    bool writeArchive = false;
+    std::string pointData;
+    /// The images and TexImages written to the archive, with their entry names
+    std::vector<std::pair<std::string, std::shared_ptr<const ImageBuffer>>> attachedImages;
+    std::map<const ImageBuffer*, std::string> attachedImageNames;
+    /// The attached PDF background, copied into the archive
+    fs::path attachedPdf;
+    /// The PNG preview of the document
+    std::shared_ptr<const ImageBuffer> preview;
+    fs::path previousArchive;
 };
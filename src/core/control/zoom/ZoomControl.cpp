@@ -199,8 +199,14 @@ void ZoomControl::zoomSequenceChange(double zoom, bool relative, xoj::util::Poin
 }
 
 void ZoomControl::endZoomSequence() {
+    const bool wasActive = isZoomSequenceActive();
     scrollPosition = {-1, -1};
     zoomSequenceStart = -1;
+
+    if (wasActive && this->view) {
+        // The pages only scaled their buffers during the sequence: the repaint renders them at the final zoom
+        gtk_xournal_repaint_all(this->view->getWidget());
+    }
 }
 
 void ZoomControl::cancelZoomSequence() {
@@ -405,6 +411,14 @@ void ZoomControl::setZoomStep(double zoomStep) { this->zoomStep = zoomStep; }
 
 void ZoomControl::setZoomStepScroll(double zoomStep) { this->zoomStepScroll = zoomStep; }
 
+void ZoomControl::documentChanged(DocumentChangeType type) {
+    if (type == DOCUMENT_CHANGE_PAGES) {
+        // The size of the current page may have changed
+        updateZoomPresentationValue();
+        updateZoomFitValue();
+    }
+}
+
 void ZoomControl::pageSizeChanged(size_t page) {
     updateZoomPresentationValue(page);
     updateZoomFitValue(page);
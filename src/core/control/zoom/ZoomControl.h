@@ -181,6 +181,7 @@ protected:
     void fireZoomChanged();
     void fireZoomRangeValueChanged();
 
+    void documentChanged(DocumentChangeType type) override;
     void pageSizeChanged(size_t page) override;
     void pageSelected(size_t page) override;
 
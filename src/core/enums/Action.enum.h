@@ -34,6 +34,7 @@ enum class Action : size_t {
     NEW_FILE,
     OPEN,
     ANNOTATE_PDF,
+    APPEND_DOCUMENT,
     SAVE,
     SAVE_AS,
     EXPORT_AS_PDF,
@@ -98,6 +99,7 @@ enum class Action : size_t {
     DELETE_PAGE,
     PAPER_FORMAT,
     PAPER_BACKGROUND_COLOR,
+    COMPACT_DOCUMENT,
 
     // Menu Tools
     SELECT_TOOL,
@@ -142,6 +144,7 @@ enum class Action : size_t {
 
     // Menu Help
     HELP,
+    MEMORY_REPORT,
     ABOUT,
 
     // Generic tool config, for the toolbar
@@ -8,6 +8,7 @@ constexpr const char* ACTION_NAMES[] = {  // Action to string conversion map
         "new-file",
         "open",
         "annotate-pdf",
+        "append-document",
         "save",
         "save-as",
         "export-as-pdf",
@@ -64,6 +65,7 @@ constexpr const char* ACTION_NAMES[] = {  // Action to string conversion map
         "delete-page",
         "paper-format",
         "paper-background-color",
+        "compact-document",
         "select-tool",
         "select-default-tool",
         "tool-draw-shape-recognizer",
@@ -96,6 +98,7 @@ constexpr const char* ACTION_NAMES[] = {  // Action to string conversion map
         "tex",
         "plugin-manager",
         "help",
+        "memory-report",
         "about",
         "tool-size",
         "tool-fill",
@@ -3,6 +3,12 @@
 #include "GladeSearchpath.h"  // for GladeSearchpath
 #include "filesystem.h"       // for path
 
-Builder::Builder(GladeSearchpath* gladeSearchPath, const std::string& uiFile):
-        builder(gtk_builder_new_from_file(gladeSearchPath->findFile("", uiFile).u8string().c_str()), xoj::util::adopt) {
+static auto newBuilder(GladeSearchpath* gladeSearchPath, const std::string& uiFile) -> GtkBuilder* {
+    if (auto resource = GladeSearchpath::findResource(uiFile); !resource.empty()) {
+        return gtk_builder_new_from_resource(resource.c_str());
+    }
+    return gtk_builder_new_from_file(gladeSearchPath->findFile("", uiFile).u8string().c_str());
 }
+
+Builder::Builder(GladeSearchpath* gladeSearchPath, const std::string& uiFile):
+        builder(newBuilder(gladeSearchPath, uiFile), xoj::util::adopt) {}
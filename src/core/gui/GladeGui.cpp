@@ -15,14 +15,20 @@
 GladeGui::GladeGui(GladeSearchpath* gladeSearchPath, const std::string& glade, const std::string& mainWnd) {
     this->gladeSearchPath = gladeSearchPath;
 
-    auto filepath = this->gladeSearchPath->findFile("", glade);
-
     GError* error = nullptr;
     builder.reset(gtk_builder_new(), xoj::util::adopt);
 
-    if (!gtk_builder_add_from_file(builder.get(), filepath.u8string().c_str(), &error)) {
-        std::string msg =
-                FS(_F("Error loading glade file \"{1}\" (try to load \"{2}\")") % glade % filepath.u8string());
+    std::string source = GladeSearchpath::findResource(glade);
+    bool loaded = false;
+    if (!source.empty()) {
+        loaded = gtk_builder_add_from_resource(builder.get(), source.c_str(), &error);
+    } else {
+        source = this->gladeSearchPath->findFile("", glade).u8string();
+        loaded = gtk_builder_add_from_file(builder.get(), source.c_str(), &error);
+    }
+
+    if (!loaded) {
+        std::string msg = FS(_F("Error loading glade file \"{1}\" (try to load \"{2}\")") % glade % source);
 
         if (error != nullptr) {
             msg += "\n";
@@ -11,6 +11,13 @@
 
 #include "GladeSearchpath.h"
 
+#include <gio/gio.h>  // for g_resources_get_info
+
+namespace {
+/// Of the files of the ui directory, see xournalpp.gresource.xml.in
+constexpr auto RESOURCE_PREFIX = "/com/github/xournalpp/xournalpp/ui/";
+}  // namespace
+
 GladeSearchpath::GladeSearchpath() = default;
 
 GladeSearchpath::~GladeSearchpath() { directories.clear(); }
@@ -35,6 +42,14 @@ auto GladeSearchpath::findFile(fs::path const& subdir, fs::path const& file) con
     return fs::path{};
 }
 
+auto GladeSearchpath::findResource(const std::string& file) -> std::string {
+    std::string path = RESOURCE_PREFIX + file;
+    if (!g_resources_get_info(path.c_str(), G_RESOURCE_LOOKUP_FLAGS_NONE, nullptr, nullptr, nullptr)) {
+        return {};
+    }
+    return path;
+}
+
 /**
  * @return The first search path
  */
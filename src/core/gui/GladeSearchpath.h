@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <string>  // for string
 #include <vector>  // for vector
 
 #include "filesystem.h"  // for path
@@ -28,6 +29,12 @@ public:
      */
     fs::path findFile(fs::path const& subdir, fs::path const& file) const;
 
+    /**
+     * Searches for a file of the ui directory in the resources compiled into the executable (see ENABLE_GRESOURCE)
+     * @return Its resource path, an empty string if not found: the file is then to be read with findFile()
+     */
+    static std::string findResource(const std::string& file);
+
     /**
      * @return The first search path
      */
@@ -1,13 +1,17 @@
 #include "Layout.h"
 
-#include <algorithm>    // for max, lower_bound, transform
+#include <algorithm>    // for max, lower_bound, upper_bound, sort, transform
 #include <cmath>        // for abs
+#include <functional>   // for greater
 #include <iterator>     // for begin, end, distance
 #include <numeric>      // for accumulate
 #include <optional>     // for optional
 #include <type_traits>  // for make_signed_t, remove_referen...
+#include <utility>      // for pair
+#include <vector>       // for vector
 
 #include <glib-object.h>  // for G_CALLBACK, g_signal_connect
+#include <glib.h>         // for g_get_monotonic_time, G_USEC_PER_SEC
 
 #include "control/Control.h"            // for Control
 #include "control/settings/Settings.h"  // for Settings
@@ -37,24 +41,50 @@ constexpr auto const XOURNAL_ROOM_FOR_SHADOW = 3;
  */
 constexpr auto const XOURNAL_PADDING_BETWEEN = 15;
 
+/**
+ * Maximal number of pages prefetched ahead of the visible area
+ */
+constexpr size_t PREFETCH_MAX_PAGES = 4;
+
+/**
+ * Pages which will be scrolled into view within this time (in seconds) at the current velocity are prefetched
+ */
+constexpr double PREFETCH_LOOKAHEAD_TIME = 0.5;
+
+/**
+ * Scroll events further apart (in seconds) are not taken as part of the same movement
+ */
+constexpr double SCROLL_MOVEMENT_TIMEOUT = 0.25;
+
 
 Layout::Layout(XournalView* view, ScrollHandling* scrollHandling): view(view), scrollHandling(scrollHandling) {
     g_signal_connect(scrollHandling->getHorizontal(), "value-changed", G_CALLBACK(horizontalScrollChanged), this);
     g_signal_connect(scrollHandling->getVertical(), "value-changed", G_CALLBACK(verticalScrollChanged), this);
 
 
-    lastScrollHorizontal = gtk_adjustment_get_value(scrollHandling->getHorizontal());
-    lastScrollVertical = gtk_adjustment_get_value(scrollHandling->getVertical());
+    horizontalScroll.lastValue = gtk_adjustment_get_value(scrollHandling->getHorizontal());
+    verticalScroll.lastValue = gtk_adjustment_get_value(scrollHandling->getVertical());
 }
 
 void Layout::horizontalScrollChanged(GtkAdjustment* adjustment, Layout* layout) {
-    Layout::checkScroll(adjustment, layout->lastScrollHorizontal);
+    Layout::checkScroll(adjustment, layout->horizontalScroll);
+    layout->view->scrollActivityDetected();
+    if (layout->scrollingBothAxes) {
+        // scrollRelative() updates the visibility once for both axes
+        return;
+    }
     layout->updateVisibility();
+    layout->prefetchPages(false);
 }
 
 void Layout::verticalScrollChanged(GtkAdjustment* adjustment, Layout* layout) {
-    Layout::checkScroll(adjustment, layout->lastScrollVertical);
+    Layout::checkScroll(adjustment, layout->verticalScroll);
+    layout->view->scrollActivityDetected();
+    if (layout->scrollingBothAxes) {
+        return;
+    }
     layout->updateVisibility();
+    layout->prefetchPages(true);
 
     layout->maybeAddLastPage(layout);
 }
@@ -82,55 +112,128 @@ void Layout::maybeAddLastPage(Layout* layout) {
     }
 }
 
-void Layout::checkScroll(GtkAdjustment* adjustment, double& lastScroll) {
-    lastScroll = gtk_adjustment_get_value(adjustment);
+void Layout::checkScroll(GtkAdjustment* adjustment, ScrollTracker& tracker) {
+    const double value = gtk_adjustment_get_value(adjustment);
+    const gint64 now = g_get_monotonic_time();
+    const double delta = value - tracker.lastValue;
+    const double dt = static_cast<double>(now - tracker.lastTime) / G_USEC_PER_SEC;
+
+    if (delta != 0.0) {
+        const int direction = delta > 0 ? 1 : -1;
+        if (direction != tracker.direction || dt > SCROLL_MOVEMENT_TIMEOUT || dt <= 0.0) {
+            // A new movement: only its direction is known so far
+            tracker.velocity = 0;
+        } else {
+            tracker.velocity = 0.5 * tracker.velocity + 0.5 * std::abs(delta) / dt;
+        }
+        tracker.direction = direction;
+    }
+
+    tracker.lastValue = value;
+    tracker.lastTime = now;
+}
+
+void Layout::prefetchPages(bool vertical) {
+    const ScrollTracker& tracker = vertical ? this->verticalScroll : this->horizontalScroll;
+    if (tracker.direction == 0) {
+        return;
+    }
+    prefetchPagesAhead(vertical, tracker.direction, tracker.velocity * PREFETCH_LOOKAHEAD_TIME);
+}
+
+void Layout::prefetchScrollTarget(double dx, double dy) {
+    if (dx != 0) {
+        prefetchPagesAhead(false, dx > 0 ? 1 : -1, std::abs(dx));
+    }
+    if (dy != 0) {
+        prefetchPagesAhead(true, dy > 0 ? 1 : -1, std::abs(dy));
+    }
+}
+
+void Layout::prefetchPagesAhead(bool vertical, int direction, double distance) {
+    // The area about to be scrolled into view: at least one screen ahead, more when scrolling fast
+    const Rectangle<double> visRect = getVisibleRect();
+    Rectangle<double> ahead = visRect;
+    if (vertical) {
+        ahead.height = std::max(visRect.height, distance);
+        ahead.y = direction > 0 ? visRect.y + visRect.height : visRect.y - ahead.height;
+    } else {
+        ahead.width = std::max(visRect.width, distance);
+        ahead.x = direction > 0 ? visRect.x + visRect.width : visRect.x - ahead.width;
+    }
+
+    // Only the pages in the grid cells of that area are candidates
+    const auto& pages = this->view->viewPages;
+    const GridRange cells = getGridRange(ahead);
+    std::vector<size_t> candidates;
+    for (size_t row = cells.firstRow; row < cells.endRow; ++row) {
+        for (size_t col = cells.firstCol; col < cells.endCol; ++col) {
+            if (auto optionalPage = this->mapper.at({col, row}); optionalPage && *optionalPage < pages.size()) {
+                candidates.push_back(*optionalPage);
+            }
+        }
+    }
+    // Closest pages first
+    if (direction > 0) {
+        std::sort(candidates.begin(), candidates.end());
+    } else {
+        std::sort(candidates.begin(), candidates.end(), std::greater<>());
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < candidates.size() && count < PREFETCH_MAX_PAGES; i++) {
+        auto& pageView = pages[candidates[i]];
+        if (!pageView->isVisible() && !pageView->hasBuffer() && pageView->getRect().intersects(ahead)) {
+            pageView->prefetch();
+            count++;
+        }
+    }
 }
 
 void Layout::updateVisibility() {
     Rectangle visRect = getVisibleRect();
 
-    // step through every possible page position and update using p->setIsVisible()
-    // Using initial grid aprox speeds things up by a factor of 5.  See previous git check-in for specifics.
-    int x1 = 0;
-    int y1 = 0;
+    // Only the grid cells intersecting the visible area are checked, found by binary search on the cumulated sizes of
+    // the rows and columns. The pages of the cells visible the previous time are hidden if they are not any more.
+    const GridRange visCells = getGridRange(visRect);
+    const GridRange oldCells =
+            this->visibleCells.value_or(GridRange{0, this->rowYStart.size(), 0, this->colXStart.size()});
+    this->visibleCells = visCells;
 
     // Data to select page based on visibility
     std::optional<size_t> mostPageNr;
     double mostPagePercent = 0;
 
-    for (size_t row = 0; row < this->rowYStart.size(); ++row) {
-        auto y2 = as_signed_strict(this->rowYStart[row]);
-        for (size_t col = 0; col < this->colXStart.size(); ++col) {
-            auto x2 = as_signed_strict(this->colXStart[col]);
+    for (size_t row = std::min(oldCells.firstRow, visCells.firstRow); row < std::max(oldCells.endRow, visCells.endRow);
+         ++row) {
+        for (size_t col = std::min(oldCells.firstCol, visCells.firstCol);
+             col < std::max(oldCells.endCol, visCells.endCol); ++col) {
             auto optionalPage = this->mapper.at({col, row});
-            if (optionalPage)  // a page exists at this grid location
-            {
-                auto& pageView = this->view->viewPages[*optionalPage];
-
-                // check if grid location is visible as an aprox for page visiblity:
-                if (!(visRect.x > x2 || visRect.x + visRect.width < x1)  // visrect not outside current row/col
-                    && !(visRect.y > y2 || visRect.y + visRect.height < y1)) {
-                    // now use exact check of page itself:
-                    // visrect not outside current page dimensions:
-                    auto const& pageRect = pageView->getRect();
-                    if (auto intersection = pageRect.intersects(visRect); intersection) {
-                        pageView->setIsVisible(true);
-                        // Set the selected page
-                        double percent = intersection->area() / pageRect.area();
-
-                        if (percent > mostPagePercent) {
-                            mostPageNr = *optionalPage;
-                            mostPagePercent = percent;
-                        }
-                    }
-                } else {
-                    pageView->setIsVisible(false);
+            if (!optionalPage || *optionalPage >= this->view->viewPages.size()) {
+                continue;
+            }
+            auto& pageView = this->view->viewPages[*optionalPage];
+
+            // check if grid location is visible as an aprox for page visiblity:
+            if (!visCells.contains(row, col)) {
+                pageView->setIsVisible(false);
+                continue;
+            }
+            // now use exact check of page itself:
+            auto const& pageRect = pageView->getRect();
+            if (auto intersection = pageRect.intersects(visRect); intersection) {
+                pageView->setIsVisible(true);
+                // Set the selected page
+                double percent = intersection->area() / pageRect.area();
+
+                if (percent > mostPagePercent) {
+                    mostPageNr = *optionalPage;
+                    mostPagePercent = percent;
                 }
+            } else {
+                pageView->setIsVisible(false);
             }
-            x1 = x2;
         }
-        y1 = y2;
-        x1 = 0;
     }
 
     if (mostPageNr) {
@@ -138,6 +241,21 @@ void Layout::updateVisibility() {
     }
 }
 
+auto Layout::getGridRange(const Rectangle<double>& rect) const -> GridRange {
+    // The starts hold the end of each row (column), including the padding after it: row r spans
+    // [rowYStart[r - 1], rowYStart[r]], with 0 as the start of the first row
+    auto range = [](const std::vector<unsigned>& ends, double from, double to) -> std::pair<size_t, size_t> {
+        auto first = std::lower_bound(ends.begin(), ends.end(), from, [](unsigned end, double v) { return end < v; });
+        auto last = std::upper_bound(ends.begin(), ends.end(), to, [](double v, unsigned end) { return v < end; });
+        auto firstIdx = static_cast<size_t>(std::distance(ends.begin(), first));
+        auto endIdx = std::min(ends.size(), static_cast<size_t>(std::distance(ends.begin(), last)) + 1);
+        return {firstIdx, std::max(firstIdx, endIdx)};
+    };
+    auto [firstRow, endRow] = range(this->rowYStart, rect.y, rect.y + rect.height);
+    auto [firstCol, endCol] = range(this->colXStart, rect.x, rect.x + rect.width);
+    return {firstRow, endRow, firstCol, endCol};
+}
+
 auto Layout::getVisibleRect() -> Rectangle<double> {
     return Rectangle(gtk_adjustment_get_value(scrollHandling->getHorizontal()),
                      gtk_adjustment_get_value(scrollHandling->getVertical()),
@@ -183,6 +301,13 @@ void Layout::recalculate_int() const {
         pc.heightRows[r] = std::max(pc.heightRows[r], v->getDisplayHeightDouble());
     }
 
+    updateMinimalSize();
+    pc.valid = true;
+}
+
+void Layout::updateMinimalSize() const {
+    auto* settings = view->getControl()->getSettings();
+
     // add space around the entire page area to accommodate older Wacom tablets with limited sense area.
     auto vPadding = 2 * XOURNAL_PADDING;
     if (settings->getUnlimitedScrolling()) {
@@ -205,7 +330,6 @@ void Layout::recalculate_int() const {
 
     pc.minWidth = floor_cast<size_t>(std::accumulate(begin(pc.widthCols), end(pc.widthCols), double(pc.minWidth)));
     pc.minHeight = floor_cast<size_t>(std::accumulate(begin(pc.heightRows), end(pc.heightRows), double(pc.minHeight)));
-    pc.valid = true;
 }
 
 void Layout::recalculate() {
@@ -213,6 +337,35 @@ void Layout::recalculate() {
     gtk_widget_queue_resize(view->getWidget());
 }
 
+void Layout::recalculatePage(size_t pageIdx) {
+    {
+        std::lock_guard g{pc.m};
+        auto const len = view->viewPages.size();
+        if (pc.valid && pageIdx < len && mapper.data_.actualPages == len) {
+            // Only the column and the row of the page may change size: the page mapping stays as it is
+            auto const [c, r] = mapper.at(pageIdx);
+            pc.widthCols[c] = 0;
+            for (size_t row = 0; row < pc.heightRows.size(); ++row) {
+                if (auto optionalPage = mapper.at({c, row}); optionalPage) {
+                    pc.widthCols[c] =
+                            std::max(pc.widthCols[c], view->viewPages[*optionalPage]->getDisplayWidthDouble());
+                }
+            }
+            pc.heightRows[r] = 0;
+            for (size_t col = 0; col < pc.widthCols.size(); ++col) {
+                if (auto optionalPage = mapper.at({col, r}); optionalPage) {
+                    pc.heightRows[r] =
+                            std::max(pc.heightRows[r], view->viewPages[*optionalPage]->getDisplayHeightDouble());
+                }
+            }
+            updateMinimalSize();
+        } else {
+            pc.valid = false;
+        }
+    }
+    gtk_widget_queue_resize(view->getWidget());
+}
+
 void Layout::layoutPages(int width, int height) {
     std::lock_guard g{pc.m};
     if (!pc.valid) {
@@ -231,6 +384,9 @@ void Layout::layoutPages(int width, int height) {
     auto const rows = this->pc.heightRows.size();
     auto const columns = this->pc.widthCols.size();
 
+    // Any page may move: the next visibility update checks the whole grid
+    this->visibleCells.reset();
+
 
     // add space around the entire page area to accommodate older Wacom tablets with limited sense area.
     auto v_padding = XOURNAL_PADDING;
@@ -381,10 +537,29 @@ void Layout::scrollRelative(double x, double y) {
         return;
     }
 
-    gtk_adjustment_set_value(scrollHandling->getHorizontal(),
-                             gtk_adjustment_get_value(scrollHandling->getHorizontal()) + x);
-    gtk_adjustment_set_value(scrollHandling->getVertical(),
-                             gtk_adjustment_get_value(scrollHandling->getVertical()) + y);
+    GtkAdjustment* hadj = scrollHandling->getHorizontal();
+    GtkAdjustment* vadj = scrollHandling->getVertical();
+    const double oldX = gtk_adjustment_get_value(hadj);
+    const double oldY = gtk_adjustment_get_value(vadj);
+
+    this->scrollingBothAxes = true;
+    gtk_adjustment_set_value(hadj, oldX + x);
+    gtk_adjustment_set_value(vadj, oldY + y);
+    this->scrollingBothAxes = false;
+
+    const bool movedX = gtk_adjustment_get_value(hadj) != oldX;
+    const bool movedY = gtk_adjustment_get_value(vadj) != oldY;
+    if (!movedX && !movedY) {
+        return;
+    }
+    updateVisibility();
+    if (movedX) {
+        prefetchPages(false);
+    }
+    if (movedY) {
+        prefetchPages(true);
+        maybeAddLastPage(this);
+    }
 }
 
 void Layout::scrollAbs(double x, double y) {
@@ -419,6 +594,20 @@ auto Layout::getPageViewAt(int x, int y) -> XojPageView* {
     return nullptr;
 }
 
+auto Layout::getPagesInRect(const Rectangle<double>& rect) const -> std::vector<size_t> {
+    const GridRange cells = getGridRange(rect);
+    std::vector<size_t> pages;
+    for (size_t row = cells.firstRow; row < cells.endRow; ++row) {
+        for (size_t col = cells.firstCol; col < cells.endCol; ++col) {
+            if (auto optionalPage = this->mapper.at({col, row}); optionalPage) {
+                pages.push_back(*optionalPage);
+            }
+        }
+    }
+    std::sort(pages.begin(), pages.end());
+    return pages;
+}
+
 auto Layout::getPageIndexAtGridMap(size_t row, size_t col) -> std::optional<size_t> {
     return this->mapper.at({col, row});  // watch out.. x,y --> c,r
 }
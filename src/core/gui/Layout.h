@@ -92,6 +92,12 @@ public:
      */
     void recalculate();
 
+    /**
+     * recalculate and resize Layout after the size of a single page changed.
+     * Only the row and the column of the page are measured again, unless the Layout needs a complete recalculation.
+     */
+    void recalculatePage(size_t pageIdx);
+
     /**
      * Performs a layout of the XojPageView's managed in this Layout
      * Sets out pages in a grid.
@@ -108,11 +114,21 @@ public:
      */
     void updateVisibility();
 
+    /**
+     * Queue low priority renders of the pages up to where a scroll by (dx, dy) from the visible area ends
+     */
+    void prefetchScrollTarget(double dx, double dy);
+
     /**
      * Return the pageview containing co-ordinates.
      */
     XojPageView* getPageViewAt(int x, int y);
 
+    /**
+     * The indices of the pages in the cells of the grid intersecting rect (in widget coordinates), in increasing order
+     */
+    std::vector<size_t> getPagesInRect(const xoj::util::Rectangle<double>& rect) const;
+
     /**
      * Return the page index found ( or std::nullopt if not found) at layout grid row,col
      *
@@ -150,10 +166,58 @@ protected:
 private:
     void recalculate_int() const;
 
+    /**
+     * Sets pc.minWidth and pc.minHeight from the sizes of the columns and rows, and the padding from the settings
+     */
+    void updateMinimalSize() const;
+
     void maybeAddLastPage(Layout* layout);
 
+    /**
+     * Direction and speed of the scrolling along one axis
+     */
+    struct ScrollTracker {
+        double lastValue = -1;
+        gint64 lastTime = 0;
+        /// Sign of the last scroll: 1 forward, -1 backward, 0 unknown
+        int direction = 0;
+        /// In pixels per second, averaged over the last scroll events. 0 at the start of a scroll.
+        double velocity = 0;
+    };
+
     // Todo(Fabian): move to ScrollHandling also it must not depend on Layout
-    static void checkScroll(GtkAdjustment* adjustment, double& lastScroll);
+    static void checkScroll(GtkAdjustment* adjustment, ScrollTracker& tracker);
+
+    /**
+     * Queue low priority renders of the pages about to be scrolled into view
+     * (depending on the scroll direction and velocity), unless they already have a buffer.
+     */
+    void prefetchPages(bool vertical);
+
+    /**
+     * Prefetch the pages within `distance` (but at least a screen) of the visible area, along the axis and the
+     * direction (1 forward, -1 backward)
+     */
+    void prefetchPagesAhead(bool vertical, int direction, double distance);
+
+    /**
+     * A range of cells of the grid: [firstRow, endRow) x [firstCol, endCol)
+     */
+    struct GridRange {
+        size_t firstRow;
+        size_t endRow;
+        size_t firstCol;
+        size_t endCol;
+
+        bool contains(size_t row, size_t col) const {
+            return firstRow <= row && row < endRow && firstCol <= col && col < endCol;
+        }
+    };
+
+    /**
+     * Returns the cells of the grid which intersect rect, by binary search in rowYStart and colXStart
+     */
+    GridRange getGridRange(const xoj::util::Rectangle<double>& rect) const;
 
     /**
      * Calls the scroll handler to set the layout size by updating the horizontal and vertical GtkAdjustments
@@ -166,8 +230,11 @@ private:
     ScrollHandling* scrollHandling = nullptr;
 
     // Todo(Fabian): move to ScrollHandling also it must not depend on Layout
-    double lastScrollHorizontal = -1;
-    double lastScrollVertical = -1;
+    ScrollTracker horizontalScroll;
+    ScrollTracker verticalScroll;
+
+    /// Set while scrollRelative() moves both adjustments, so that the visibility is updated once
+    bool scrollingBothAxes = false;
 
     /**
      * layoutPages invalidates the precalculation of recalculate
@@ -178,4 +245,9 @@ private:
     mutable PreCalculated pc{};
     mutable std::vector<unsigned> colXStart;
     mutable std::vector<unsigned> rowYStart;
+
+    /**
+     * The cells whose pages were set visible by the last updateVisibility(), if the layout did not change since then
+     */
+    std::optional<GridRange> visibleCells;
 };
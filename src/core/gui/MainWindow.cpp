@@ -723,9 +723,13 @@ auto MainWindow::getToolbarModel() const -> ToolbarModel* { return this->toolbar
 auto MainWindow::getToolMenuHandler() const -> ToolMenuHandler* { return this->toolbar.get(); }
 
 void MainWindow::loadMainCSS(GladeSearchpath* gladeSearchPath, const gchar* cssFilename) {
-    auto filepath = gladeSearchPath->findFile("", cssFilename);
     xoj::util::GObjectSPtr<GtkCssProvider> provider(gtk_css_provider_new(), xoj::util::adopt);
-    gtk_css_provider_load_from_path(provider.get(), filepath.u8string().c_str(), nullptr);
+    if (auto resource = GladeSearchpath::findResource(cssFilename); !resource.empty()) {
+        gtk_css_provider_load_from_resource(provider.get(), resource.c_str());
+    } else {
+        auto filepath = gladeSearchPath->findFile("", cssFilename);
+        gtk_css_provider_load_from_path(provider.get(), filepath.u8string().c_str(), nullptr);
+    }
     gtk_style_context_add_provider_for_screen(gdk_screen_get_default(), GTK_STYLE_PROVIDER(provider.get()),
                                               GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 }
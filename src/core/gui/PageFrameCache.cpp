@@ -0,0 +1,98 @@
+#include "PageFrameCache.h"
+
+#include <algorithm>  // for find_if, max, min, rotate
+
+#include "gui/Shadow.h"  // for Shadow
+
+namespace {
+/// How far the shadow and the border of the selected page reach outside the page
+constexpr int OUTER_MARGIN_TOP_LEFT = 12;
+constexpr int OUTER_MARGIN_BOTTOM_RIGHT = 16;
+/// How far they reach inside the page (the corners of the shadow and the border)
+constexpr int INNER_MARGIN = 16;
+}  // namespace
+
+void PageFrameCache::drawFrame(cairo_t* cr, int x, int y, int width, int height, bool selected, Color borderColor) {
+    if (selected) {
+        Shadow::drawShadow(cr, x - 2, y - 2, width + 4, height + 4);
+
+        // Draw border
+        Util::cairo_set_source_rgbi(cr, borderColor);
+        cairo_set_line_width(cr, 4.0);
+        cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+        cairo_set_line_join(cr, CAIRO_LINE_JOIN_MITER);
+
+        cairo_rectangle(cr, x, y, width, height);
+        cairo_stroke(cr);
+    } else {
+        Shadow::drawShadow(cr, x, y, width, height);
+    }
+}
+
+auto PageFrameCache::createFrame(cairo_t* cr, int width, int height, bool selected, Color borderColor,
+                                 double deviceScale) -> Frame {
+    Frame frame{width, height, selected, borderColor, deviceScale, {}};
+
+    // The strips do not overlap, and leave out the middle of the page
+    const int left = -OUTER_MARGIN_TOP_LEFT;
+    const int top = -OUTER_MARGIN_TOP_LEFT;
+    const int right = width + OUTER_MARGIN_BOTTOM_RIGHT;
+    const int bottom = height + OUTER_MARGIN_BOTTOM_RIGHT;
+    const int innerLeft = std::min(INNER_MARGIN, width);
+    const int innerTop = std::min(INNER_MARGIN, height);
+    const int innerRight = std::max(innerLeft, width - INNER_MARGIN);
+    const int innerBottom = std::max(innerTop, height - INNER_MARGIN);
+
+    const std::array<std::array<int, 4>, 4> rects = {{{left, top, right, innerTop},
+                                                      {left, innerBottom, right, bottom},
+                                                      {left, innerTop, innerLeft, innerBottom},
+                                                      {innerRight, innerTop, right, innerBottom}}};
+
+    for (size_t i = 0; i < rects.size(); i++) {
+        auto [x1, y1, x2, y2] = rects[i];
+        Strip& strip = frame.strips[i];
+        strip.x = x1;
+        strip.y = y1;
+        strip.width = x2 - x1;
+        strip.height = y2 - y1;
+        if (strip.width <= 0 || strip.height <= 0) {
+            continue;
+        }
+
+        // Similar to the target, to get its device scale
+        strip.surface.reset(cairo_surface_create_similar(cairo_get_target(cr), CAIRO_CONTENT_COLOR_ALPHA, strip.width,
+                                                         strip.height),
+                            xoj::util::adopt);
+        cairo_t* stripCr = cairo_create(strip.surface.get());
+        drawFrame(stripCr, -x1, -y1, width, height, selected, borderColor);
+        cairo_destroy(stripCr);
+    }
+    return frame;
+}
+
+void PageFrameCache::draw(cairo_t* cr, int x, int y, int width, int height, bool selected, Color borderColor) {
+    double deviceScale = 1;
+    cairo_surface_get_device_scale(cairo_get_target(cr), &deviceScale, nullptr);
+
+    auto it = std::find_if(this->frames.begin(), this->frames.end(), [&](const Frame& f) {
+        return f.width == width && f.height == height && f.selected == selected && f.borderColor == borderColor &&
+               f.deviceScale == deviceScale;
+    });
+    if (it == this->frames.end()) {
+        if (this->frames.size() >= MAX_FRAMES) {
+            this->frames.pop_back();
+        }
+        this->frames.insert(this->frames.begin(), createFrame(cr, width, height, selected, borderColor, deviceScale));
+    } else if (it != this->frames.begin()) {
+        std::rotate(this->frames.begin(), it, it + 1);
+    }
+
+    for (const Strip& strip: this->frames.front().strips) {
+        if (!strip.surface) {
+            continue;
+        }
+        cairo_set_source_surface(cr, strip.surface.get(), x + strip.x, y + strip.y);
+        cairo_rectangle(cr, x + strip.x, y + strip.y, strip.width, strip.height);
+        cairo_fill(cr);
+    }
+}
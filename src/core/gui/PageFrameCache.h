@@ -0,0 +1,70 @@
+/*
+ * Xournal++
+ *
+ * The shadows and the borders of the pages, composited once per size
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/Color.h"                // for Color
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+/**
+ * @brief Draws the shadow of the pages, and the border of the selected page.
+ *
+ * Compositing a shadow piece by piece costs a dozen of operations per page and per frame. Here, the frame of a page
+ * (everything the shadow and the border cover, except the middle of the page, which is painted over anyway) is
+ * composited once per size and selection state, into four strips which are then painted as they are.
+ */
+class PageFrameCache {
+public:
+    PageFrameCache() = default;
+
+    /**
+     * Draw the frame of the page whose rectangle is (x, y, width, height), before the page itself
+     */
+    void draw(cairo_t* cr, int x, int y, int width, int height, bool selected, Color borderColor);
+
+    /// The frames of the pages of that many sizes are kept
+    static constexpr size_t MAX_FRAMES = 8;
+
+private:
+    /// A part of the frame, positioned relatively to the upper left corner of the page
+    struct Strip {
+        xoj::util::CairoSurfaceSPtr surface;
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    struct Frame {
+        int width = 0;
+        int height = 0;
+        bool selected = false;
+        Color borderColor{};
+        double deviceScale = 1;
+
+        std::array<Strip, 4> strips;
+    };
+
+    static Frame createFrame(cairo_t* cr, int width, int height, bool selected, Color borderColor, double deviceScale);
+
+    /// Composite the frame piece by piece
+    static void drawFrame(cairo_t* cr, int x, int y, int width, int height, bool selected, Color borderColor);
+
+private:
+    /// Most recently used first
+    std::vector<Frame> frames;
+};
@@ -19,6 +19,7 @@
 
 #include "control/AudioController.h"                // for AudioController
 #include "control/Control.h"                        // for Control
+#include "control/PerfStats.h"                      // for isEnabled, now, recordPagePaint
 #include "control/ScrollHandler.h"                  // for ScrollHandler
 #include "control/SearchControl.h"                  // for SearchControl
 #include "control/Tool.h"                           // for Tool
@@ -43,6 +44,7 @@
 #include "control/tools/StrokeHandler.h"            // for StrokeHandler
 #include "control/tools/TextEditor.h"               // for TextEditor, TextE...
 #include "control/tools/VerticalToolHandler.h"      // for VerticalToolHandler
+#include "control/zoom/ZoomControl.h"               // for ZoomControl
 #include "gui/FloatingToolbox.h"                    // for FloatingToolbox
 #include "gui/MainWindow.h"                         // for MainWindow
 #include "gui/PdfFloatingToolbox.h"                 // for PdfFloatingToolbox
@@ -59,6 +61,7 @@
 #include "model/XojPage.h"                          // for XojPage
 #include "pdf/base/XojPdfAction.h"                  // for XojPdfAction
 #include "pdf/base/XojPdfDocument.h"                // for XojPdfDocument
+#include "pdf/base/XojPdfLinkMap.h"                 // for XojPdfLinkMap
 #include "pdf/base/XojPdfPage.h"                    // for XojPdfRectangle
 #include "undo/DeleteUndoAction.h"                  // for DeleteUndoAction
 #include "undo/InsertUndoAction.h"                  // for InsertUndoAction
@@ -124,6 +127,23 @@ void XojPageView::setIsVisible(bool visible) { this->visible = visible; }
 void XojPageView::deleteViewBuffer() {
     std::lock_guard lock(this->drawingMutex);
     this->buffer.reset();
+    this->bufferIsPreview = false;
+    this->hasDraftTiles = false;
+    this->layerTiles.clear();
+    invalidateLowerLayersCache();
+}
+
+void XojPageView::setLowerLayersCacheEnabled(bool enabled) {
+    std::lock_guard lock(this->drawingMutex);
+    this->lowerLayersCacheEnabled = enabled;
+    this->layerTiles.clear();
+    invalidateLowerLayersCache();
+}
+
+void XojPageView::invalidateLowerLayersCache() {
+    this->lowerLayersBuffer.reset();
+    this->lowerLayersState = LowerLayersState();
+    this->lowerLayersGeneration++;
 }
 
 auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
@@ -140,25 +160,30 @@ auto XojPageView::containsPoint(int x, int y, bool local) const -> bool {
     return x >= 0 && y >= 0 && x <= this->getWidth() && y <= this->getHeight();
 }
 
+void XojPageView::createSearchControl() {
+    auto pNr = this->page->getPdfPageNr();
+    XojPdfPageSPtr pdf = nullptr;
+    std::shared_ptr<PdfTextIndex> textIndex;
+    if (pNr != npos) {
+        Document* doc = xournal->getControl()->getDocument();
+
+        doc->lock();
+        pdf = doc->getPdfPage(pNr);
+        textIndex = doc->getPdfTextIndex();
+        doc->unlock();
+    }
+    this->search = std::make_unique<SearchControl>(page, pdf, std::move(textIndex));
+    this->overlayViews.emplace_back(std::make_unique<xoj::view::SearchResultView>(
+            this->search.get(), this, settings->getSelectionColor(), settings->getActiveSelectionColor()));
+}
+
 auto XojPageView::searchTextOnPage(const std::string& text, size_t index, size_t* occurrences,
                                    XojPdfRectangle* matchRect) -> bool {
     if (!this->search) {
         if (text.empty()) {
             return true;
         }
-
-        auto pNr = this->page->getPdfPageNr();
-        XojPdfPageSPtr pdf = nullptr;
-        if (pNr != npos) {
-            Document* doc = xournal->getControl()->getDocument();
-
-            doc->lock();
-            pdf = doc->getPdfPage(pNr);
-            doc->unlock();
-        }
-        this->search = std::make_unique<SearchControl>(page, pdf);
-        this->overlayViews.emplace_back(std::make_unique<xoj::view::SearchResultView>(
-                this->search.get(), this, settings->getSelectionColor(), settings->getActiveSelectionColor()));
+        createSearchControl();
     }
 
     bool found = this->search->search(text, index, occurrences, matchRect);
@@ -168,6 +193,18 @@ auto XojPageView::searchTextOnPage(const std::string& text, size_t index, size_t
     return found;
 }
 
+void XojPageView::setSearchResults(const std::string& text, std::vector<XojPdfRectangle> results) {
+    if (!this->search) {
+        if (results.empty()) {
+            return;
+        }
+        createSearchControl();
+    }
+    this->search->setResults(text, std::move(results));
+
+    repaintPage();
+}
+
 void XojPageView::endText() { this->textEditor.reset(); }
 
 void XojPageView::startText(double x, double y) {
@@ -795,6 +832,56 @@ void XojPageView::rerenderPage() {
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
+void XojPageView::layerVisibilityChanged() {
+    if (!isVisible()) {
+        // Rendered when it gets shown
+        deleteViewBuffer();
+        return;
+    }
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->recomposeLayers = true;
+    }
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
+void XojPageView::prefetch() {
+    if (this->hasBuffer()) {
+        return;
+    }
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->rerenderComplete = true;
+    }
+    this->xournal->getControl()->getScheduler()->addPrefetchPage(this);
+}
+
+void XojPageView::ensureFullyRendered() {
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        if (this->rerenderComplete) {
+            return;  // Already on its way
+        }
+    }
+    {
+        std::lock_guard lock(this->drawingMutex);
+        const Range pageRange(0, 0, page->getWidth(), page->getHeight());
+        if (this->buffer.isInitialized() && !this->bufferIsPreview && !this->hasDraftTiles &&
+            this->buffer.getZoom() == xournal->getZoom() &&
+            this->buffer.getDPIScaling() == xournal->getDpiScaleFactor() &&
+            this->buffer.getMissingTiles(pageRange).empty()) {
+            return;
+        }
+    }
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        // Not the part that was visible when the page was last painted: the whole page, from the top
+        this->tilesArea = Range();
+        this->rerenderComplete = true;
+    }
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
 void XojPageView::repaintPage() const { xournal->getRepaintHandler()->repaintPage(this); }
 
 void XojPageView::repaintArea(double x1, double y1, double x2, double y2) const {
@@ -810,7 +897,8 @@ void XojPageView::drawAndDeleteToolView(xoj::view::ToolView* v, const Range& rg)
         v->isViewOf(this->textEditor.get())) {
         // Draw the inputHandler's view onto the page buffer.
         std::lock_guard lock(this->drawingMutex);
-        v->drawWithoutDrawingAids(buffer.get());
+        const Range target = rg.empty() ? Range(0, 0, page->getWidth(), page->getHeight()) : rg;
+        buffer.forEachTile(target, [v](cairo_t* cr) { v->drawWithoutDrawingAids(cr); });
     }
     this->deleteOverlayView(v, rg);
 }
@@ -849,24 +937,31 @@ void XojPageView::rerenderRect(double x, double y, double width, double height)
         return;
     }
 
-    auto rect = Rectangle<double>{x, y, width, height};
-
-    this->repaintRectMutex.lock();
+    /**
+     * Padding seems to be necessary to prevent artefacts of most strokes.
+     * These artefacts are most pronounced when using the stroke deletion
+     * tool on ellipses, but also occur occasionally when removing regular
+     * strokes.
+     **/
+    constexpr int RENDER_PADDING = 1;
+
+    const int x1 = floor_cast<int>(x) - RENDER_PADDING;
+    const int y1 = floor_cast<int>(y) - RENDER_PADDING;
+    const cairo_rectangle_int_t rect = {x1, y1, ceil_cast<int>(x + width) + RENDER_PADDING - x1,
+                                        ceil_cast<int>(y + height) + RENDER_PADDING - y1};
 
-    for (auto&& r: this->rerenderRects) {
-        // its faster to redraw only one rect than repaint twice the same area
-        // so loop through the rectangles to be redrawn, if new rectangle
-        // intersects any of them, replace it by the union with the new one
-        if (r.intersects(rect)) {
-            r.unite(rect);
-            this->repaintRectMutex.unlock();
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        if (!this->rerenderRegion) {
+            this->rerenderRegion.reset(cairo_region_create_rectangle(&rect), xoj::util::adopt);
+        } else if (cairo_region_contains_rectangle(this->rerenderRegion.get(), &rect) == CAIRO_REGION_OVERLAP_IN) {
+            // Already pending
             return;
+        } else {
+            cairo_region_union_rectangle(this->rerenderRegion.get(), &rect);
         }
     }
 
-    this->rerenderRects.push_back(rect);
-    this->repaintRectMutex.unlock();
-
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
@@ -934,72 +1029,68 @@ void XojPageView::drawLoadingPage(cairo_t* cr) {
 
 bool XojPageView::displayLinkPopover(std::shared_ptr<XojPdfPage> page, double pageX, double pageY) {
     // Search for selected link
-    const auto links = page->getLinks();
+    const auto linkMap = page->getLinkMap();
+    const XojPdfPage::Link* link = linkMap->findLink(pageX, pageY);
+    if (!link) {
+        return false;
+    }
+    const XojPdfRectangle& rect = link->bounds;
+    std::shared_ptr<const LinkDestination> dest = link->action->getDestination();
 
-    for (auto&& [rect, action]: links) {
-        std::shared_ptr<const LinkDestination> dest = action->getDestination();
+    GtkWidget* box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
+    GtkWidget* popover = makePopover(rect, box);
 
-        if (!(rect.x1 <= pageX && pageX <= rect.x2 && rect.y1 <= pageY && pageY <= rect.y2)) {
-            continue;
-        }
+    if (auto uriOpt = dest->getURI()) {
+        const std::string& uri = uriOpt.value();
+        char* uriLabel = g_markup_escape_text(uri.c_str(), -1);
 
-        GtkWidget* box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 5);
-        GtkWidget* popover = makePopover(rect, box);
+        auto labelMarkup = serdes_stream<std::stringstream>();
+        labelMarkup << "<a href=" << std::quoted(uri) << ">" << uriLabel << "</a>";
 
-        if (auto uriOpt = dest->getURI()) {
-            const std::string& uri = uriOpt.value();
-            char* uriLabel = g_markup_escape_text(uri.c_str(), -1);
+        std::string linkMarkup = labelMarkup.str();
 
-            auto labelMarkup = serdes_stream<std::stringstream>();
-            labelMarkup << "<a href=" << std::quoted(uri) << ">" << uriLabel << "</a>";
+        g_free(uriLabel);
 
-            std::string linkMarkup = labelMarkup.str();
+        GtkWidget* label = gtk_label_new(nullptr);
+        gtk_label_set_markup(GTK_LABEL(label), linkMarkup.c_str());
+        gtk_box_append(GTK_BOX(box), label);
+    } else {
+        size_t pdfPage = dest->getPdfPage();
 
-            g_free(uriLabel);
+        Document* doc = xournal->getControl()->getDocument();
+        doc->lock();
+        const size_t pageId = doc->findPdfPage(pdfPage);
+        doc->unlock();
 
-            GtkWidget* label = gtk_label_new(nullptr);
-            gtk_label_set_markup(GTK_LABEL(label), linkMarkup.c_str());
-            gtk_box_append(GTK_BOX(box), label);
+        GtkWidget* button{};
+        if (pageId != npos) {
+            const auto pageNo = static_cast<int64_t>(pageId + 1);
+            button = gtk_button_new_with_label(FC(_F("Scroll to page {1}") % pageNo));
         } else {
-            size_t pdfPage = dest->getPdfPage();
-
-            Document* doc = xournal->getControl()->getDocument();
-            doc->lock();
-            const size_t pageId = doc->findPdfPage(pdfPage);
-            doc->unlock();
-
-            GtkWidget* button{};
-            if (pageId != npos) {
-                const auto pageNo = static_cast<int64_t>(pageId + 1);
-                button = gtk_button_new_with_label(FC(_F("Scroll to page {1}") % pageNo));
-            } else {
-                button = gtk_button_new_with_label(FC(_F("Add missing page")));
-            }
-            gtk_box_append(GTK_BOX(box), button);
-
-            g_signal_connect(
-                    button, "clicked",
-                    G_CALLBACK(+[](GtkButton* bt,
-                                   std::tuple<XojPageView*, std::shared_ptr<LinkDestination>, GtkWidget*>* state) {
-                        XojPageView* self;
-                        std::shared_ptr<LinkDestination> dest;
-                        GtkWidget* popover;
-                        std::tie(self, dest, popover) = *state;
-
-                        self->getXournal()->getControl()->getScrollHandler()->scrollToLinkDest(*dest);
-                        gtk_popover_popdown(GTK_POPOVER(popover));
-
-                        delete state;
-                    }),
-                    new std::tuple(std::make_tuple(this, dest, popover)));
+            button = gtk_button_new_with_label(FC(_F("Add missing page")));
         }
-
-        gtk_widget_show_all(popover);
-        gtk_popover_popup(GTK_POPOVER(popover));
-        return true;
+        gtk_box_append(GTK_BOX(box), button);
+
+        g_signal_connect(
+                button, "clicked",
+                G_CALLBACK(+[](GtkButton* bt,
+                               std::tuple<XojPageView*, std::shared_ptr<LinkDestination>, GtkWidget*>* state) {
+                    XojPageView* self;
+                    std::shared_ptr<LinkDestination> dest;
+                    GtkWidget* popover;
+                    std::tie(self, dest, popover) = *state;
+
+                    self->getXournal()->getControl()->getScrollHandler()->scrollToLinkDest(*dest);
+                    gtk_popover_popdown(GTK_POPOVER(popover));
+
+                    delete state;
+                }),
+                new std::tuple(std::make_tuple(this, dest, popover)));
     }
 
-    return false;
+    gtk_widget_show_all(popover);
+    gtk_popover_popup(GTK_POPOVER(popover));
+    return true;
 }
 
 GtkWidget* XojPageView::makePopover(const XojPdfRectangle& rect, GtkWidget* child) {
@@ -1021,11 +1112,18 @@ GtkWidget* XojPageView::makePopover(const XojPdfRectangle& rect, GtkWidget* chil
 }
 
 auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
+    this->lastPaintTime = g_get_monotonic_time();
+    const int64_t paintStart = xoj::perf::isEnabled() ? xoj::perf::now() : 0;
 
     double zoom = xournal->getZoom();
     xoj::util::CairoSaveGuard saveGuard(cr);
     cairo_scale(cr, zoom, zoom);
 
+    const Range pageRange(0, 0, page->getWidth(), page->getHeight());
+    Range clip;
+    cairo_clip_extents(cr, &clip.minX, &clip.minY, &clip.maxX, &clip.maxY);
+    clip = clip.intersect(pageRange);
+
     {
         std::lock_guard lock(this->drawingMutex);  // Lock the mutex first
         xoj::util::CairoSaveGuard saveGuard(cr);   // see comment at the end of the scope
@@ -1034,13 +1132,43 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
             return true;
         }
 
-        if (this->buffer.getZoom() != zoom) {
-            rerenderPage();
+        if (this->buffer.getZoom() != zoom || this->buffer.getDPIScaling() != xournal->getDpiScaleFactor()) {
+            // During a zoom gesture, the buffer is only scaled, and rendered once at the end of the gesture
+            // (ZoomControl::endZoomSequence repaints the pages). The full resolution render of a preview is already
+            // underway.
+            // After the window moved to a monitor with another DPI scaling, the buffer is scaled until the page is
+            // rendered again: only the pages painted are, when they get painted, not all of them at once.
+            if (!this->bufferIsPreview && !xournal->getControl()->getZoomControl()->isZoomSequenceActive()) {
+                rerenderPage();
+            }
             cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_FAST);
+        } else {
+            if (this->hasDraftTiles && !xournal->isDraftRendering()) {
+                // The scrolling stopped: replace the draft tiles
+                this->hasDraftTiles = false;
+                rerenderPage();
+            }
+
+            // Render the tiles of the visible part, with a margin of one tile to make small scrolls seamless
+            Range area = getVisiblePart();
+            if (!area.empty()) {
+                area.addPadding(xoj::view::TiledBuffer::TILE_SIZE / zoom);
+                area = area.intersect(pageRange);
+                if (!this->buffer.getMissingTiles(area).empty()) {
+                    rerenderTiles(area);
+                }
+            }
+        }
+
+        if (!clip.empty() && !this->buffer.getMissingTiles(clip).empty()) {
+            // Some tiles are still being rendered: show a blank page there in the meantime
+            cairo_set_source_rgb(cr, 1, 1, 1);
+            cairo_rectangle(cr, clip.minX, clip.minY, clip.getWidth(), clip.getHeight());
+            cairo_fill(cr);
         }
-        this->buffer.paintTo(cr);
+        this->buffer.paintTo(cr, clip);
     }  // Restore the state of cr and then release the mutex
-       // restoring the state of cr ensures this->buffer.surface is not longer referenced as the source in cr.
+       // restoring the state of cr ensures the buffer's surfaces are no longer referenced as the source in cr.
 
     /**
      * All the overlay painters below follow the assumption:
@@ -1052,6 +1180,9 @@ auto XojPageView::paintPage(cairo_t* cr, GdkRectangle* rect) -> bool {
         v->draw(cr);
     }
 
+    if (paintStart != 0) {
+        xoj::perf::recordPagePaint(xoj::perf::now() - paintStart);
+    }
     return true;
 }
 
@@ -1063,6 +1194,40 @@ auto XojPageView::isSelected() const -> bool { return selected; }
 
 auto XojPageView::hasBuffer() const -> bool { return this->buffer.isInitialized(); }
 
+auto XojPageView::getBufferMemoryUsage() -> size_t {
+    std::lock_guard lock(this->drawingMutex);
+    size_t usage = this->buffer.getMemoryUsage() + this->lowerLayersBuffer.getMemoryUsage();
+    for (const auto& l: this->layerTiles) { usage += l.tiles.getMemoryUsage(); }
+    return usage;
+}
+
+auto XojPageView::paintFromBuffer(cairo_t* cr) -> bool {
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        if (this->rendering || this->rerenderComplete || this->rerenderRegion) {
+            return false;
+        }
+    }
+    std::lock_guard lock(this->drawingMutex);
+    if (!this->buffer.isInitialized() || this->bufferIsPreview || this->hasDraftTiles) {
+        return false;
+    }
+    const Range pageRange(0, 0, page->getWidth(), page->getHeight());
+    if (!this->buffer.getMissingTiles(pageRange).empty()) {
+        return false;
+    }
+    this->buffer.paintTo(cr, pageRange);
+    return true;
+}
+
+void XojPageView::rerenderTiles(const Range& area) {
+    {
+        std::lock_guard lock(this->repaintRectMutex);
+        this->tilesArea = area;
+    }
+    this->xournal->getControl()->getScheduler()->addRerenderPage(this);
+}
+
 auto XojPageView::getSelectionColor() -> GdkRGBA { return Util::rgb_to_GdkRGBA(settings->getSelectionColor()); }
 
 auto XojPageView::getTextEditor() -> TextEditor* { return textEditor.get(); }
@@ -1157,6 +1322,11 @@ void XojPageView::elementChanged(Element* elem) {
                             page->getSelectedLayerId() == page->getLayerCount() &&
                             getVisiblePart().contains(elem->boundingRect());
     if (!noRerender) {
+        if (page->getSelectedLayerId() == 0 || page->getSelectedLayer()->indexOf(elem) == Element::InvalidIndex) {
+            // The element may belong to one of the cached lower layers
+            std::lock_guard lock(this->drawingMutex);
+            invalidateLowerLayersCache();
+        }
         rerenderElement(elem);
     }
 }
@@ -1164,6 +1334,14 @@ void XojPageView::elementChanged(Element* elem) {
 void XojPageView::elementsChanged(const std::vector<Element*>& elements, const Range& range) {
     if (!range.empty()) {
         rerenderRange(range);
+        return;
+    }
+    Range bounds;
+    for (Element* e: elements) {
+        bounds = bounds.unite(Range(e->boundingRect()));
+    }
+    if (!bounds.empty()) {
+        rerenderRange(bounds);
     }
 }
 
@@ -12,9 +12,11 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
 #include <memory>   // for unique_ptr, shared_ptr
 #include <mutex>    // for mutex
 #include <string>   // for string
+#include <utility>  // for pair
 #include <vector>   // for vector
 
 #include <cairo.h>    // for cairo_t
@@ -25,10 +27,11 @@
 #include "gui/inputdevices/InputEvents.h"
 #include "model/PageListener.h"       // for PageListener
 #include "model/PageRef.h"            // for PageRef
+#include "util/Range.h"               // for Range
 #include "util/Rectangle.h"           // for Rectangle
-#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
-#include "view/Mask.h"                // for Mask
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr, CairoRegionSPtr
 #include "view/Repaintable.h"         // for Repaintable
+#include "view/TiledBuffer.h"         // for TiledBuffer
 
 #include "Layout.h"            // for Layout
 #include "LegacyRedrawable.h"  // for LegacyRedrawable
@@ -44,8 +47,8 @@ class TextEditor;
 class VerticalToolHandler;
 class XournalView;
 class Element;
+class Layer;
 class PositionInputData;
-class Range;
 class TexImage;
 class XojPdfRectangle;
 class XojPdfPage;
@@ -63,6 +66,20 @@ public:
 public:
     void addOverlayView(std::unique_ptr<xoj::view::OverlayView>);
     void rerenderPage() override;
+    /**
+     * Show the new visibility of the layers: a visible page composes its cached layers again (see layerTiles), the
+     * others drop their buffer and get rendered once shown.
+     */
+    void layerVisibilityChanged();
+    /**
+     * Render the page in the background, ahead of it becoming visible. Does nothing if the page has a buffer already.
+     */
+    void prefetch();
+    /**
+     * Render the whole page again, at the current zoom and in full quality, unless its buffer already is. For the
+     * off-screen pages kept ready to be shown at once.
+     */
+    void ensureFullyRendered();
     void rerenderRect(double x, double y, double width, double height) override;
 
     void repaintPage() const override;
@@ -105,6 +122,11 @@ public:
 
     bool searchTextOnPage(const std::string& text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect);
 
+    /**
+     * Show the matches of the text found by a SearchJob
+     */
+    void setSearchResults(const std::string& text, std::vector<XojPdfRectangle> results);
+
     bool onKeyPressEvent(const KeyEvent& event);
     bool onKeyReleaseEvent(const KeyEvent& event);
 
@@ -116,6 +138,13 @@ public:
 
     void deleteViewBuffer() override;
 
+    /**
+     * Enable or disable the cache of the layers below the selected one. It must be disabled while elements of other
+     * layers are modified in place (e.g. by undo actions), as those modifications are not tracked. The cached tiles are
+     * discarded in both cases.
+     */
+    void setLowerLayersCacheEnabled(bool enabled);
+
     /**
      * Returns whether this PageView contains the
      * given point on the display
@@ -134,6 +163,20 @@ public:
 
     GdkRGBA getSelectionColor() override;
     bool hasBuffer() const;
+    /**
+     * @return The memory used by the page's buffer, in bytes
+     */
+    size_t getBufferMemoryUsage();
+    /**
+     * @brief Paints the page from its buffer, e.g. to derive a thumbnail from it. May be called from any thread.
+     *
+     * @return false if nothing was painted, because the buffer does not cover the whole page or is not up to date
+     */
+    bool paintFromBuffer(cairo_t* cr);
+    /**
+     * @return The time (as given by g_get_monotonic_time()) the page was last painted on screen
+     */
+    inline gint64 getLastPaintTime() const { return lastPaintTime; }
 
     TextEditor* getTextEditor();
 
@@ -208,6 +251,11 @@ private:
 
     void drawLoadingPage(cairo_t* cr);
 
+    /**
+     * Request the rendering of the buffer's tiles intersecting the given area (in page coordinates)
+     */
+    void rerenderTiles(const Range& area);
+
     /**
      * @brief Make and display a popover dialog near the given location.
      *
@@ -245,6 +293,13 @@ private:
 
     void deleteView(xoj::view::OverlayView* v);
 
+    void createSearchControl();
+
+    /**
+     * Discard the cache of the layers below the selected one. The caller must hold drawingMutex.
+     */
+    void invalidateLowerLayersCache();
+
 private:
     PageRef page;
     XournalView* xournal = nullptr;
@@ -276,8 +331,59 @@ private:
 
     bool visible = true;
     bool selected = false;
+    gint64 lastPaintTime = 0;
+
+    xoj::view::TiledBuffer buffer;
+    /**
+     * True while the buffer only holds the quick low resolution preview, and the full resolution render is underway.
+     * Guarded by drawingMutex.
+     */
+    bool bufferIsPreview = false;
+
+    /**
+     * True if some tiles of the buffer were rendered in draft quality, while the view was scrolled. They are replaced
+     * by a full quality render once the view is idle. Guarded by drawingMutex.
+     */
+    bool hasDraftTiles = false;
+
+    /**
+     * The background and the visible layers below the selected one, at the zoom of `buffer`. Rerendering a
+     * rectangle then only draws the selected layer and the ones above it on top of these tiles.
+     * Guarded by drawingMutex.
+     */
+    xoj::view::TiledBuffer lowerLayersBuffer;
+    /**
+     * What lowerLayersBuffer was rendered from. Guarded by drawingMutex.
+     */
+    struct LowerLayersState {
+        std::vector<std::pair<const Layer*, uint64_t>> layers;  ///< The layers, with their revisions
+        bool markAudioStroke = false;
+
+        bool operator==(const LowerLayersState& other) const {
+            return layers == other.layers && markAudioStroke == other.markAudioStroke;
+        }
+        bool operator!=(const LowerLayersState& other) const { return !(*this == other); }
+    } lowerLayersState;
+    /**
+     * Incremented whenever lowerLayersBuffer is invalidated: a render job started before that must not insert its
+     * tiles. Guarded by drawingMutex.
+     */
+    unsigned int lowerLayersGeneration = 0;
+    bool lowerLayersCacheEnabled = true;
+
+    /**
+     * The background and each visible layer rendered separately, at the zoom of `buffer`, once the visibility of a
+     * layer changed: showing or hiding a layer again only composes them. Dropped with the buffer and by a complete
+     * rerender. Guarded by drawingMutex.
+     */
+    struct LayerTiles {
+        const Layer* layer;  ///< nullptr for the background
+        uint64_t revision;   ///< Layer::getContentRevision() and XojPage::getPageWideChangeCount(), or the background's
+        xoj::view::TiledBuffer tiles;
+    };
+    std::vector<LayerTiles> layerTiles;
+    bool layerTilesMarkAudioStroke = false;
 
-    xoj::view::Mask buffer;
     std::mutex drawingMutex;
 
     bool inEraser = false;
@@ -293,8 +399,21 @@ private:
     std::unique_ptr<SearchControl> search;
 
     std::mutex repaintRectMutex;
-    std::vector<xoj::util::Rectangle<double>> rerenderRects;
+    /**
+     * The parts of the page to rerender, in page coordinates rounded outwards (with a padding). Overlapping damage is
+     * merged by the region, so that any point is rendered once. Guarded by repaintRectMutex.
+     */
+    xoj::util::CairoRegionSPtr rerenderRegion;
     bool rerenderComplete = false;
+    /// Whether the layers must be composed again from layerTiles. Guarded by repaintRectMutex.
+    bool recomposeLayers = false;
+    /// Whether a RenderJob is updating the buffer. Guarded by repaintRectMutex.
+    bool rendering = false;
+    /**
+     * The part of the page whose tiles should be rendered (the visible part, with a margin), in page coordinates.
+     * Updated when painting the page. Guarded by repaintRectMutex.
+     */
+    Range tilesArea;
 
     int dispX{};  // position on display - set in Layout::layoutPages
     int dispY{};
@@ -73,8 +73,9 @@ protected:
          */
         bool found = false;
         double minDistSq = std::numeric_limits<double>::max();
-        Element::Index pos = 0;
-        for (auto&& e: l->getElements()) {
+        // Rounding in intersectsArea() can make the bounding boxes up to 1 unit larger
+        const Range searchArea(x - 11, y - 11, x + 11, y + 11);
+        for (auto&& [e, pos]: l->getElementsInAreaWithPositions(searchArea)) {
             const double eX = e->getX() + e->getElementWidth() / 2.0;
             const double eY = e->getY() + e->getElementHeight() / 2.0;
             const double dx = eX - this->x;
@@ -82,12 +83,11 @@ protected:
             const double distSq = dx * dx + dy * dy;
             const GdkRectangle matchRect = {gint(x - 10), gint(y - 10), 20, 20};
             if (e->intersectsArea(&matchRect) && distSq < minDistSq) {
-                if (this->checkElement(e.get(), pos)) {
+                if (this->checkElement(e, pos)) {
                     minDistSq = distSq;
                     found = true;
                 }
             }
-            pos++;
         }
         return found;
     }
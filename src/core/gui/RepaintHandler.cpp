@@ -1,15 +1,27 @@
 #include "RepaintHandler.h"
 
-#include <gtk/gtk.h>  // for gtk_widget_queue_draw
+#include <utility>  // for swap
 
-#include "gui/widgets/XournalWidget.h"  // for gtk_xournal_repaint_area
+#include <cairo.h>    // for cairo_region_union_rectangle
+#include <gtk/gtk.h>  // for gtk_widget_add_tick_callback
+
+#include "gui/widgets/XournalWidget.h"  // for gtk_xournal_repaint_area, gtk_xournal_repaint_all
+#include "util/Range.h"                 // for Range
+#include "util/Util.h"                  // for execInUiThread
+#include "util/raii/CairoWrappers.h"    // for CairoRegionSPtr
 
 #include "PageView.h"     // for XojPageView
 #include "XournalView.h"  // for XournalView
 
 RepaintHandler::RepaintHandler(XournalView* xournal): xournal(xournal) {}
 
-RepaintHandler::~RepaintHandler() { this->xournal = nullptr; }
+RepaintHandler::~RepaintHandler() {
+    // The widget, if already destroyed, dropped its tick callbacks
+    if (this->tickCallbackId && this->xournal->getWidget()) {
+        gtk_widget_remove_tick_callback(this->xournal->getWidget(), this->tickCallbackId);
+    }
+    this->xournal = nullptr;
+}
 
 void RepaintHandler::repaintPage(const XojPageView* view) {
     int x1 = view->getX();
@@ -23,7 +35,73 @@ void RepaintHandler::repaintPage(const XojPageView* view) {
 void RepaintHandler::repaintPageArea(const XojPageView* view, int x1, int y1, int x2, int y2) {
     int x = view->getX();
     int y = view->getY();
+    if (this->batchDepth > 0) {
+        this->batch.add(Range(x + x1, y + y1, x + x2, y + y2));
+        return;
+    }
     gtk_xournal_repaint_area(this->xournal->getWidget(), x + x1, y + y1, x + x2, y + y2);
 }
 
-void RepaintHandler::repaintPageBorder(const XojPageView* view) { gtk_widget_queue_draw(this->xournal->getWidget()); }
+void RepaintHandler::repaintPageBorder(const XojPageView* view) { gtk_xournal_repaint_all(this->xournal->getWidget()); }
+
+void RepaintHandler::beginBatch() { this->batchDepth++; }
+
+void RepaintHandler::endBatch() {
+    if (--this->batchDepth > 0 || this->batch.empty()) {
+        return;
+    }
+    // The coordinates are integers: so are the bounds of the merged rectangles
+    for (const Range& rg: this->batch.getRanges()) {
+        gtk_xournal_repaint_area(this->xournal->getWidget(), static_cast<int>(rg.minX), static_cast<int>(rg.minY),
+                                 static_cast<int>(rg.maxX), static_cast<int>(rg.maxY));
+    }
+    this->batch.clear();
+}
+
+void RepaintHandler::setCoalesceAsyncRepaints(bool coalesce) { this->coalesceAsyncRepaints = coalesce; }
+
+void RepaintHandler::repaintWidgetAreaAsync(int x1, int y1, int x2, int y2) {
+    if (!this->coalesceAsyncRepaints) {
+        GtkWidget* widget = this->xournal->getWidget();
+        Util::execInUiThread([=]() { gtk_xournal_repaint_area(widget, x1, y1, x2, y2); });
+        return;
+    }
+    {
+        std::lock_guard lock(this->asyncRepaintsMutex);
+        this->asyncRepaints.add(Range(x1, y1, x2, y2));
+        if (this->asyncRepaintsScheduled) {
+            return;
+        }
+        this->asyncRepaintsScheduled = true;
+    }
+    Util::execInUiThread([this]() { scheduleAsyncRepaints(); });
+}
+
+void RepaintHandler::scheduleAsyncRepaints() {
+    if (this->tickCallbackId == 0) {
+        this->tickCallbackId =
+                gtk_widget_add_tick_callback(this->xournal->getWidget(), flushAsyncRepaints, this, nullptr);
+    }
+}
+
+auto RepaintHandler::flushAsyncRepaints(GtkWidget* widget, GdkFrameClock*, gpointer self) -> gboolean {
+    auto* handler = static_cast<RepaintHandler*>(self);
+    handler->tickCallbackId = 0;
+
+    xoj::util::DamageRegion areas;
+    {
+        std::lock_guard lock(handler->asyncRepaintsMutex);
+        std::swap(areas, handler->asyncRepaints);
+        handler->asyncRepaintsScheduled = false;
+    }
+
+    // A single invalidation: the widget is drawn once, at this frame
+    xoj::util::CairoRegionSPtr region(cairo_region_create(), xoj::util::adopt);
+    for (const Range& rg: areas.getRanges()) {
+        const cairo_rectangle_int_t r{static_cast<int>(rg.minX), static_cast<int>(rg.minY),
+                                      static_cast<int>(rg.maxX - rg.minX), static_cast<int>(rg.maxY - rg.minY)};
+        cairo_region_union_rectangle(region.get(), &r);
+    }
+    gtk_xournal_repaint_region(widget, region.get());
+    return G_SOURCE_REMOVE;
+}
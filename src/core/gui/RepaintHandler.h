@@ -11,6 +11,13 @@
 
 #pragma once
 
+#include <atomic>  // for atomic
+#include <mutex>   // for mutex
+
+#include <gtk/gtk.h>  // for GtkWidget, GdkFrameClock
+
+#include "util/DamageRegion.h"  // for DamageRegion
+
 class XojPageView;
 class XournalView;
 
@@ -35,6 +42,43 @@ public:
      */
     void repaintPageBorder(const XojPageView* view);
 
+    /**
+     * Until the matching call to endBatch(), the repainted page areas are gathered and coalesced into a few rectangles,
+     * repainted by endBatch(). The batches can be nested.
+     */
+    void beginBatch();
+    void endBatch();
+
+    /**
+     * Repaint an area of the widget, from any thread (e.g. once a render job is done). If coalescing, the areas are
+     * gathered until the next frame of the widget, and invalidated all at once.
+     */
+    void repaintWidgetAreaAsync(int x1, int y1, int x2, int y2);
+
+    void setCoalesceAsyncRepaints(bool coalesce);
+
 private:
+    /// Called in the UI thread to get the next frame to repaint the gathered areas
+    void scheduleAsyncRepaints();
+    static gboolean flushAsyncRepaints(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+
     XournalView* xournal;
+
+    int batchDepth = 0;
+
+    /**
+     * The areas repainted in the current batch, in widget coordinates
+     */
+    xoj::util::DamageRegion batch;
+
+    std::atomic<bool> coalesceAsyncRepaints{true};
+
+    /**
+     * The areas to repaint at the next frame, in widget coordinates, and whether that frame was asked for
+     */
+    std::mutex asyncRepaintsMutex;
+    xoj::util::DamageRegion asyncRepaints;
+    bool asyncRepaintsScheduled = false;
+
+    guint tickCallbackId = 0;
 };
@@ -0,0 +1,91 @@
+#include "ScrollBuffer.h"
+
+#include <utility>  // for swap
+
+ScrollBuffer::ScrollBuffer(): damage(cairo_region_create(), xoj::util::adopt) {}
+
+void ScrollBuffer::invalidate(int x, int y, int width, int height) {
+    const cairo_rectangle_int_t r{x, y, width, height};
+    cairo_region_union_rectangle(this->damage.get(), &r);
+}
+
+void ScrollBuffer::invalidate(const cairo_region_t* region) { cairo_region_union(this->damage.get(), region); }
+
+void ScrollBuffer::invalidateAll() { this->valid = false; }
+
+auto ScrollBuffer::fitsTarget(cairo_t* cr, const cairo_rectangle_int_t& viewport) const -> bool {
+    double scale = 1;
+    cairo_surface_get_device_scale(cairo_get_target(cr), &scale, nullptr);
+    return this->surface && this->area.width == viewport.width && this->area.height == viewport.height &&
+           this->deviceScale == scale;
+}
+
+void ScrollBuffer::draw(cairo_t* cr, const cairo_rectangle_int_t& viewport, uint64_t key,
+                        const std::function<void(cairo_t*)>& paint) {
+    if (viewport.width <= 0 || viewport.height <= 0) {
+        return;
+    }
+    if (!fitsTarget(cr, viewport)) {
+        // Similar to the target, to get its device scale and a format it paints fast
+        this->surface.reset(cairo_surface_create_similar(cairo_get_target(cr), CAIRO_CONTENT_COLOR, viewport.width,
+                                                         viewport.height),
+                            xoj::util::adopt);
+        this->spare.reset();
+        cairo_surface_get_device_scale(this->surface.get(), &this->deviceScale, nullptr);
+        this->valid = false;
+    }
+    if (key != this->key) {
+        this->key = key;
+        this->valid = false;
+    }
+
+    xoj::util::CairoRegionSPtr toPaint(cairo_region_create_rectangle(&viewport), xoj::util::adopt);
+    if (this->valid) {
+        if (this->area.x != viewport.x || this->area.y != viewport.y) {
+            // Shift the content by the scroll delta
+            if (!this->spare) {
+                this->spare.reset(cairo_surface_create_similar(this->surface.get(), CAIRO_CONTENT_COLOR,
+                                                               viewport.width, viewport.height),
+                                  xoj::util::adopt);
+            }
+            cairo_t* shiftCr = cairo_create(this->spare.get());
+            cairo_set_operator(shiftCr, CAIRO_OPERATOR_SOURCE);
+            cairo_set_source_surface(shiftCr, this->surface.get(), this->area.x - viewport.x,
+                                     this->area.y - viewport.y);
+            cairo_paint(shiftCr);
+            cairo_destroy(shiftCr);
+            std::swap(this->surface, this->spare);
+        }
+        // What was already visible is up to date, but for the damage
+        cairo_region_subtract_rectangle(toPaint.get(), &this->area);
+        cairo_region_intersect_rectangle(this->damage.get(), &viewport);
+        cairo_region_union(toPaint.get(), this->damage.get());
+    }
+    this->area = viewport;
+    this->valid = true;
+    this->damage.reset(cairo_region_create(), xoj::util::adopt);
+
+    if (!cairo_region_is_empty(toPaint.get())) {
+        cairo_t* bufferCr = cairo_create(this->surface.get());
+        cairo_translate(bufferCr, -viewport.x, -viewport.y);
+        // One rectangle at a time: only the pages of each rectangle are painted
+        const int n = cairo_region_num_rectangles(toPaint.get());
+        for (int i = 0; i < n; i++) {
+            cairo_rectangle_int_t r;
+            cairo_region_get_rectangle(toPaint.get(), i, &r);
+            cairo_save(bufferCr);
+            cairo_rectangle(bufferCr, r.x, r.y, r.width, r.height);
+            cairo_clip(bufferCr);
+            paint(bufferCr);
+            cairo_restore(bufferCr);
+        }
+        cairo_destroy(bufferCr);
+    }
+
+    cairo_save(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cr, this->surface.get(), viewport.x, viewport.y);
+    cairo_rectangle(cr, viewport.x, viewport.y, viewport.width, viewport.height);
+    cairo_fill(cr);
+    cairo_restore(cr);
+}
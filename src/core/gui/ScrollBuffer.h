@@ -0,0 +1,69 @@
+/*
+ * Xournal++
+ *
+ * The content of the visible area of the main view, kept from one frame to the next
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>     // for uint64_t
+#include <functional>  // for function
+
+#include <cairo.h>  // for cairo_t, cairo_rectangle_int_t, cairo_region_t
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr, CairoRegionSPtr
+
+/**
+ * @brief Keeps what was drawn in the visible area of the main view, so that a frame paints only what changed.
+ *
+ * When the view scrolls, the kept content is shifted by the scroll delta, and only the newly exposed strip is
+ * painted: scrolling costs as much as the scrolled distance, not as the visible area. Within the visible area, only
+ * the areas invalidated since the last frame (see invalidate()) are painted again. Everything is in the coordinates
+ * of the widget.
+ *
+ * Only what does not move with the view (the background, the pages and their frames) is kept: the selection, drawn
+ * over the pages, is not.
+ */
+class ScrollBuffer {
+public:
+    ScrollBuffer();
+
+    /**
+     * The area has to be painted again at the next frame
+     */
+    void invalidate(int x, int y, int width, int height);
+    void invalidate(const cairo_region_t* region);
+    void invalidateAll();
+
+    /**
+     * Draws the visible area into cr, painting the parts which are not up to date with paint() first.
+     *
+     * @param viewport The visible area
+     * @param key Whatever the content depends on besides the invalidated areas (the colors...): everything is painted
+     *      again when it changes
+     * @param paint Paints the content into its argument, which is clipped to the area to paint
+     */
+    void draw(cairo_t* cr, const cairo_rectangle_int_t& viewport, uint64_t key,
+              const std::function<void(cairo_t*)>& paint);
+
+private:
+    bool fitsTarget(cairo_t* cr, const cairo_rectangle_int_t& viewport) const;
+
+private:
+    /// The content of `area`
+    xoj::util::CairoSurfaceSPtr surface;
+    /// The previous surface, reused to shift the content
+    xoj::util::CairoSurfaceSPtr spare;
+    cairo_rectangle_int_t area{0, 0, 0, 0};
+    double deviceScale = 1;
+    uint64_t key = 0;
+    bool valid = false;
+
+    /// What was invalidated since the last frame
+    xoj::util::CairoRegionSPtr damage;
+};
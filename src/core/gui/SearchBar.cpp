@@ -1,19 +1,24 @@
 #include "SearchBar.h"
 
-#include <string>  // for allocator, string
+#include <string>   // for allocator, string
+#include <utility>  // for move
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIFT_MASK
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Return
 #include <glib-object.h>     // for G_CALLBACK, g_signal_connect
 #include <glib.h>            // for g_free, g_strdup_printf
 
-#include "control/Control.h"           // for Control
-#include "control/ScrollHandler.h"     // for ScrollHandler
-#include "control/zoom/ZoomControl.h"  // for ZoomControl
-#include "gui/MainWindow.h"            // for MainWindow
-#include "model/Document.h"            // for Document
-#include "util/PlaceholderString.h"    // for PlaceholderString
-#include "util/i18n.h"                 // for _, FC, _F
+#include "control/Control.h"                // for Control
+#include "control/ScrollHandler.h"          // for ScrollHandler
+#include "control/jobs/PdfTextIndexJob.h"   // for PdfTextIndexJob
+#include "control/jobs/SearchJob.h"         // for SearchJob
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
+#include "control/zoom/ZoomControl.h"       // for ZoomControl
+#include "gui/MainWindow.h"                 // for MainWindow
+#include "gui/XournalView.h"                // for XournalView
+#include "model/Document.h"                 // for Document
+#include "util/PlaceholderString.h"         // for PlaceholderString
+#include "util/i18n.h"                      // for _, FC, _F
 
 SearchBar::SearchBar(Control* control): control(control) {
     MainWindow* win = control->getWindow();
@@ -56,45 +61,98 @@ SearchBar::SearchBar(Control* control): control(control) {
                                    GTK_STYLE_PROVIDER(cssTextFild), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 }
 
-SearchBar::~SearchBar() { this->control = nullptr; }
+SearchBar::~SearchBar() {
+    cancelSearch();
+    this->control = nullptr;
+}
+
+void SearchBar::showSearchState(const char* state, bool found) {
+    MainWindow* win = control->getWindow();
+    gtk_label_set_text(GTK_LABEL(win->get("lbSearchState")), state);
+
+    if (found) {
+        gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry {}", -1, nullptr);
+    } else {
+        gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry { color: #ff0000; }", -1, nullptr);
+    }
+}
 
-auto SearchBar::searchTextonCurrentPage(const char* text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect)
-        -> bool {
-    size_t p = control->getCurrentPageNo();
-    this->page = p;
+void SearchBar::cancelSearch() {
+    if (this->searchToken) {
+        *this->searchToken = true;
+        this->searchToken.reset();
+    }
+}
 
-    return control->searchTextOnPage(text, p, index, occurrences, matchRect);
+void SearchBar::clearResults() {
+    const size_t pageCount = control->getDocument()->getPageCount();
+    for (size_t i = pageCount - 1; i < pageCount; i--) {
+        control->searchTextOnPage("", i, 0, nullptr, nullptr);
+    }
 }
 
 void SearchBar::search(const char* text) {
-    MainWindow* win = control->getWindow();
-    GtkWidget* lbSearchState = win->get("lbSearchState");
+    cancelSearch();
 
-    bool found = true;
     this->indexInPage = 0;
+    this->occurrences = 0;
+    this->page = control->getCurrentPageNo();
+    this->searchStartPage = this->page;
+    this->startPageSearched = false;
+    this->pagesSearched = 0;
+    this->pagesWithMatches = 0;
 
-    if (*text != 0) {
-        found = searchTextonCurrentPage(text, 1, &this->occurrences, nullptr);
-        if (found) {
-            if (occurrences == 1) {
-                gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text found once on this page"));
-            } else {
-                char* msg = g_strdup_printf(_("Text found %zu times on this page"), occurrences);
-                gtk_label_set_text(GTK_LABEL(lbSearchState), msg);
-                g_free(msg);
-            }
-        } else {
-            gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
-        }
-    } else {
-        searchTextonCurrentPage("", 1, nullptr, nullptr);
-        gtk_label_set_text(GTK_LABEL(lbSearchState), "");
+    // The label is set once the matches on the current page are known
+    showSearchState("", true);
+
+    if (*text == 0) {
+        clearResults();
+        return;
     }
 
-    if (found) {
-        gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry {}", -1, nullptr);
-    } else {
-        gtk_css_provider_load_from_data(cssTextFild, "GtkSearchEntry { color: #ff0000; }", -1, nullptr);
+    // Search all the pages in the background, the highlights appear as the pages are searched
+    this->searchToken = SearchJob::searchDocument(
+            control->getDocument(), control->getScheduler(), text, this->page,
+            [this, text = std::string(text)](const PageRef& page, std::vector<XojPdfRectangle> results) {
+                pageSearched(text, page, std::move(results));
+            });
+}
+
+void SearchBar::pageSearched(const std::string& text, const PageRef& page, std::vector<XojPdfRectangle> results) {
+    Document* doc = control->getDocument();
+    doc->lock();
+    const size_t pageNr = doc->indexOf(page);
+    const size_t pageCount = doc->getPageCount();
+    doc->unlock();
+
+    this->pagesSearched++;
+    const size_t count = results.size();
+    if (count > 0) {
+        this->pagesWithMatches++;
+    }
+    control->getWindow()->getXournal()->setSearchResults(pageNr, text, std::move(results));
+
+    // The state is only shown until the user goes to another match
+    if (this->indexInPage != 0) {
+        return;
+    }
+    if (pageNr == this->searchStartPage && !this->startPageSearched) {
+        this->startPageSearched = true;
+        this->occurrences = count;
+        if (count == 1) {
+            showSearchState(_("Text found once on this page"), true);
+        } else if (count > 1) {
+            char* msg = g_strdup_printf(_("Text found %zu times on this page"), count);
+            showSearchState(msg, true);
+            g_free(msg);
+        }
+    }
+    if (this->pagesSearched >= pageCount && this->occurrences == 0) {
+        if (this->pagesWithMatches == 0) {
+            showSearchState(_("Text not found"), false);
+        } else {
+            showSearchState(FC(_F("Text found on {1} other pages") % this->pagesWithMatches), true);
+        }
     }
 }
 
@@ -115,6 +173,11 @@ void SearchBar::search(Fun next) {
     if (*text == 0) {
         return;
     }
+    if (!this->startPageSearched) {
+        // The background search has not reached the current page yet
+        control->searchTextOnPage(text, page, 1, &occurrences, nullptr);
+        this->startPageSearched = true;
+    }
     const size_t originalPage = page;
 
     XojPdfRectangle matchRect = XojPdfRectangle();
@@ -179,11 +242,12 @@ void SearchBar::showSearchBar(bool show) {
         gtk_widget_show_all(searchBar);
         gtk_widget_grab_focus(searchTextField);
         this->indexInPage = 0;
+
+        // The pages not extracted yet, e.g. of a pdf background set since the document was loaded
+        PdfTextIndexJob::indexDocument(control->getDocument(), control->getScheduler());
     } else {
         gtk_widget_hide(searchBar);
-        const size_t pageCount = control->getDocument()->getPageCount();
-        for (size_t i = pageCount - 1; i < pageCount; i--) {
-            control->searchTextOnPage("", i, 0, nullptr, nullptr);
-        }
+        cancelSearch();
+        clearResults();
     }
 }
@@ -11,9 +11,16 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
 #include <gtk/gtk.h>             // for GtkButton, GtkEntry
 #include <gtk/gtkcssprovider.h>  // for GtkCssProvider
 
+#include "control/jobs/SearchJob.h"  // for SearchJob
+#include "model/PageRef.h"           // for PageRef
+
 class Control;
 class XojPdfRectangle;
 
@@ -54,7 +61,26 @@ private:
     void searchPrevious();
 
     void search(const char* text);
-    bool searchTextonCurrentPage(const char* text, size_t index, size_t* occurrences, XojPdfRectangle* matchRect);
+
+    /**
+     * Cancel the search started by search(const char*), if it is still running
+     */
+    void cancelSearch();
+
+    /**
+     * Remove the matches shown on all the pages
+     */
+    void clearResults();
+
+    /**
+     * The matches on a page found by the search started by search(const char*)
+     */
+    void pageSearched(const std::string& text, const PageRef& page, std::vector<XojPdfRectangle> results);
+
+    /**
+     * Sets the label and the color of the search field
+     */
+    void showSearchState(const char* state, bool found);
 
 private:
     Control* control;
@@ -62,4 +88,12 @@ private:
     size_t page = 0;
     size_t indexInPage = 0;
     size_t occurrences = 0;
+
+    /// The search running in the background, on all the pages
+    SearchJob::CancelToken searchToken;
+    /// The page on which the search started, and whether its matches are known in `occurrences`
+    size_t searchStartPage = 0;
+    bool startPageSearched = false;
+    size_t pagesSearched = 0;
+    size_t pagesWithMatches = 0;
 };
@@ -1,9 +1,13 @@
 #include "XournalView.h"
 
-#include <algorithm>  // for max, min
-#include <iterator>   // for begin
+#include <algorithm>  // for max, min, sort, find, move
+#include <cstdint>    // for int64_t
+#include <iterator>   // for begin, back_inserter, make_move_iterator
 #include <memory>     // for unique_ptr, make_unique
+#include <mutex>      // for lock_guard
 #include <optional>   // for optional
+#include <utility>    // for pair
+#include <vector>     // for vector
 
 #include <gdk/gdk.h>         // for GdkEventKey, GDK_SHIF...
 #include <gdk/gdkkeysyms.h>  // for GDK_KEY_Page_Down
@@ -17,6 +21,7 @@
 #include "control/jobs/XournalScheduler.h"       // for XournalScheduler
 #include "control/settings/MetadataManager.h"    // for MetadataManager
 #include "control/settings/Settings.h"           // for Settings
+#include "control/settings/ViewModes.h"          // for VIEW_MODE_FULLSCREEN, VIEW_MODE_PRESENTATION
 #include "control/tools/CursorSelectionType.h"   // for CURSOR_SELECTION_NONE
 #include "control/tools/EditSelection.h"         // for EditSelection
 #include "control/zoom/ZoomControl.h"            // for ZoomControl
@@ -37,7 +42,7 @@
 #include "util/Assert.h"                         // for xoj_assert
 #include "util/Point.h"                          // for Point
 #include "util/Rectangle.h"                      // for Rectangle
-#include "util/Util.h"                           // for npos
+#include "util/Util.h"                           // for npos, execInUiThread
 #include "util/glib_casts.h"                     // for wrap_v
 #include "util/safe_casts.h"                     // for round_cast
 
@@ -62,12 +67,7 @@ std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t max
 
 XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* scrollHandling):
         scrollHandling(scrollHandling), control(control) {
-    Document* doc = control->getDocument();
-    doc->lock();
-    if (doc->getPdfPageCount() != 0) {
-        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
-    }
-    doc->unlock();
+    recreatePdfCache();
 
     registerListener(control);
 
@@ -81,6 +81,7 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
     g_signal_connect(getWidget(), "realize", G_CALLBACK(onRealized), this);
 
     this->repaintHandler = std::make_unique<RepaintHandler>(this);
+    this->repaintHandler->setCoalesceAsyncRepaints(control->getSettings()->isCoalesceRepaints());
     this->handRecognition = std::make_unique<HandRecognition>(this->widget, inputContext, control->getSettings());
 
     control->getZoomControl()->addZoomListener(this);
@@ -95,14 +96,47 @@ XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* sc
 
 XournalView::~XournalView() {
     g_source_remove(this->cleanupTimeout);
+    if (this->draftTimeoutId) {
+        g_source_remove(this->draftTimeoutId);
+    }
 
     gtk_widget_destroy(this->widget);
     this->widget = nullptr;
 }
 
 
+void XournalView::scrollActivityDetected() {
+    if (!this->control->getSettings()->isDraftRendering()) {
+        return;
+    }
+    this->lastScrollActivity = g_get_monotonic_time() / 1000;
+    if (!this->draftTimeoutId) {
+        this->draftRendering = true;
+        this->draftTimeoutId = g_timeout_add(DRAFT_IDLE_TIME, xoj::util::wrap_v<draftIdleTimeout>, this);
+    }
+}
+
+auto XournalView::draftIdleTimeout(XournalView* self) -> bool {
+    gint64 sinceLastScroll = g_get_monotonic_time() / 1000 - self->lastScrollActivity;
+    if (sinceLastScroll < DRAFT_IDLE_TIME) {
+        // Scrolled in the meantime: wait for the rest of the time after the last scroll
+        self->draftTimeoutId = g_timeout_add(static_cast<guint>(DRAFT_IDLE_TIME - sinceLastScroll),
+                                             xoj::util::wrap_v<draftIdleTimeout>, self);
+        return false;
+    }
+
+    self->draftTimeoutId = 0;
+    self->draftRendering = false;
+    // Painting the pages replaces their draft tiles
+    gtk_xournal_repaint_all(self->widget);
+    return false;
+}
+
+auto XournalView::isDraftRendering() const -> bool { return this->draftRendering.load(); }
+
 auto XournalView::clearMemoryTimer(XournalView* widget) -> gboolean {
     widget->cleanupBufferCache();
+    widget->unloadInactivePageContents();
     return true;
 }
 
@@ -118,6 +152,93 @@ auto XournalView::cleanupBufferCache() -> void {
             page->deleteViewBuffer();
         }
     }
+
+    enforceBufferMemoryBudget();
+}
+
+void XournalView::enforceBufferMemoryBudget() {
+    const size_t budget = static_cast<size_t>(control->getSettings()->getPageBufferMemoryBudget()) * 1024 * 1024;
+
+    // The pages kept ready to be flipped to are freed only if nothing else is left
+    const auto [keptLower, keptUpper] = keepsPreloadedPagesRendered() ?
+                                                preloadPageBounds(this->currentPage, this->viewPages.size()) :
+                                                std::pair<size_t, size_t>(0, 0);
+
+    size_t used = 0;
+    std::vector<std::pair<XojPageView*, size_t>> candidates;
+    std::vector<std::pair<XojPageView*, size_t>> keptPages;
+    for (size_t i = 0; i < this->viewPages.size(); i++) {
+        auto&& page = this->viewPages[i];
+        const size_t usage = page->getBufferMemoryUsage();
+        used += usage;
+        if (usage != 0 && !page->isVisible()) {
+            (keptLower <= i && i < keptUpper ? keptPages : candidates).emplace_back(page.get(), usage);
+        }
+    }
+    if (used <= budget) {
+        return;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.first->getLastPaintTime() < b.first->getLastPaintTime();
+    });
+    candidates.insert(candidates.end(), keptPages.begin(), keptPages.end());
+    size_t freed = 0;
+    for (auto it = candidates.begin(); it != candidates.end() && used > budget; ++it) {
+        it->first->deleteViewBuffer();
+        used -= it->second;
+        freed++;
+    }
+    g_message("Page buffers exceeded the memory budget of %zu MiB: freed %zu off-screen pages, %zu MiB in use",
+              budget / (1024 * 1024), freed, used / (1024 * 1024));
+}
+
+void XournalView::unloadInactivePageContents() {
+    /// The layers of a page are kept in memory for that long (in µs) after they were last used
+    constexpr int64_t PAGE_CONTENT_UNLOAD_DELAY = 120 * G_USEC_PER_SEC;
+
+    Document* doc = control->getDocument();
+    std::lock_guard lock(*doc);
+    const int64_t threshold = g_get_monotonic_time() - PAGE_CONTENT_UNLOAD_DELAY;
+
+    const bool compact = control->getSettings()->isCompactStrokeStorage();
+    std::vector<XojPageView*> candidates;
+    for (size_t i = 0; i < this->viewPages.size(); i++) {
+        auto&& view = this->viewPages[i];
+        const PageRef page = view->getPage();
+        if (i != this->currentPage && page && (compact || page->hasContentLoader()) && page->isContentLoaded() &&
+            page->getLastContentAccess() < threshold && !view->isVisible() && !view->getTextEditor()) {
+            candidates.push_back(view.get());
+        }
+    }
+    if (candidates.empty()) {
+        return;
+    }
+
+    // The undo actions and the selection keep pointers to the elements
+    std::vector<PageRef> inUse = control->getUndoRedoHandler()->getReferencedPages();
+    if (auto* selection = getSelection(); selection) {
+        inUse.push_back(selection->getSourcePage());
+    }
+
+    size_t unloaded = 0;
+    size_t compacted = 0;
+    for (auto* view: candidates) {
+        const PageRef page = view->getPage();
+        if (page->hasContentLoader() && std::find(inUse.begin(), inUse.end(), page) == inUse.end() &&
+            page->unloadContent()) {
+            unloaded++;
+        } else if (compact) {
+            // The pointers to the strokes stay valid
+            compacted += page->compactContent();
+        }
+    }
+    if (unloaded != 0) {
+        g_message("Freed the layers of %zu inactive pages", unloaded);
+    }
+    if (compacted != 0) {
+        g_message("Compacted the points of %zu strokes on inactive pages", compacted);
+    }
 }
 
 auto XournalView::getCurrentPage() const -> size_t { return currentPage; }
@@ -168,10 +289,11 @@ auto XournalView::onKeyPressEvent(const KeyEvent& event) -> bool {
             ydir = 1;
         }
         if (xdir != 0 || ydir != 0) {
-            selection->moveSelection(d * xdir, d * ydir, /*addMoveUndo=*/true);
-            selection->ensureWithinVisibleArea();
+            // Applied on the next frame, with a single undo action once the key is released
+            selection->nudge(d * xdir, d * ydir);
             return true;
         }
+        selection->finishNudging();
     }
 
     Layout* layout = gtk_xournal_get_layout(this->widget);
@@ -313,6 +435,13 @@ auto XournalView::onKeyPressEvent(const KeyEvent& event) -> bool {
 auto XournalView::getRepaintHandler() const -> RepaintHandler* { return this->repaintHandler.get(); }
 
 auto XournalView::onKeyReleaseEvent(const KeyEvent& event) -> bool {
+    if (auto* selection = getSelection(); selection) {
+        const auto keyval = event.keyval;
+        if (keyval == GDK_KEY_Left || keyval == GDK_KEY_Up || keyval == GDK_KEY_Right || keyval == GDK_KEY_Down) {
+            selection->finishNudging();
+        }
+    }
+
     size_t p = getCurrentPage();
     if (p != npos && p < this->viewPages.size()) {
         auto& v = this->viewPages[p];
@@ -352,6 +481,13 @@ auto XournalView::searchTextOnPage(const std::string& text, size_t pageNumber, s
     return v->searchTextOnPage(text, index, occurrences, matchRect);
 }
 
+void XournalView::setSearchResults(size_t pageNumber, const std::string& text, std::vector<XojPdfRectangle> results) {
+    if (pageNumber == npos || pageNumber >= this->viewPages.size()) {
+        return;
+    }
+    this->viewPages[pageNumber]->setSearchResults(text, std::move(results));
+}
+
 void XournalView::forceUpdatePagenumbers() {
     size_t p = this->currentPage;
     this->currentPage = npos;
@@ -404,18 +540,32 @@ void XournalView::pageSelected(size_t page) {
 
     if (control->getSettings()->isEagerPageCleanup()) {
         this->cleanupBufferCache();
+    } else {
+        this->enforceBufferMemoryBudget();
     }
 
-    // Load surrounding pages if they are not
+    preloadPages(page);
+}
+
+void XournalView::preloadPages(size_t page) {
+    const bool keepRendered = keepsPreloadedPagesRendered();
     const auto& [pagesLower, pagesUpper] = preloadPageBounds(page, this->viewPages.size());
     xoj_assert(pagesLower <= pagesUpper);
     for (size_t i = pagesLower; i < pagesUpper; i++) {
-        if (!this->viewPages[i]->hasBuffer()) {
-            this->viewPages[i]->rerenderPage();
+        auto& view = this->viewPages[i];
+        if (keepRendered && !view->isVisible()) {
+            view->ensureFullyRendered();
+        } else if (!view->hasBuffer()) {
+            view->rerenderPage();
         }
     }
 }
 
+auto XournalView::keepsPreloadedPagesRendered() const -> bool {
+    const ViewModeId mode = control->getSettings()->getActiveViewMode();
+    return mode == VIEW_MODE_FULLSCREEN || mode == VIEW_MODE_PRESENTATION;
+}
+
 auto XournalView::getControl() const -> Control* { return control; }
 
 void XournalView::scrollTo(size_t pageNo, XojPdfRectangle rect) {
@@ -483,6 +633,12 @@ void XournalView::layerChanged(size_t page) {
     }
 }
 
+void XournalView::layerVisibilityChanged(size_t page) {
+    if (page != npos && page < this->viewPages.size()) {
+        this->viewPages[page]->layerVisibilityChanged();
+    }
+}
+
 void XournalView::getPasteTarget(double& x, double& y) const {
     size_t pageNo = getCurrentPage();
     if (pageNo == npos) {
@@ -517,12 +673,24 @@ auto XournalView::getVisibleRect(const XojPageView* redrawable) const -> Rectang
 }
 
 void XournalView::recreatePdfCache() {
-    this->cache.reset();
-
     Document* doc = control->getDocument();
     doc->lock();
+    // Shared with the sidebar previews, which get it with the document lock held
+    this->cache.reset();
     if (doc->getPdfPageCount() != 0) {
-        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
+        // The PDF pages are rasterized off the render jobs, which paint a placeholder until then
+        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings(),
+                                                 control->getScheduler());
+        this->cache->setPageRasterizedCallback([this](size_t pdfPageNo) {
+            Util::execInUiThread([this, pdfPageNo]() {
+                for (auto&& v: this->viewPages) {
+                    const PageRef& page = v->getPage();
+                    if (page->getBackgroundType().isPdfPage() && page->getPdfPageNr() == pdfPageNo) {
+                        v->rerenderPage();
+                    }
+                }
+            });
+        });
     }
     doc->unlock();
 }
@@ -545,6 +713,7 @@ void XournalView::ensureRectIsVisible(int x, int y, int width, int height) {
 }
 
 void XournalView::zoomChanged() {
+    this->zoomGeneration++;
 
     size_t currentPage = this->getCurrentPage();
     XojPageView* view = getViewFor(currentPage);
@@ -565,6 +734,11 @@ void XournalView::zoomChanged() {
         layout->scrollAbs(pos.x, pos.y);
     }
 
+    if (keepsPreloadedPagesRendered() && !zoom->isZoomSequenceActive()) {
+        // The buffers of the pages around are at the previous zoom
+        preloadPages(currentPage);
+    }
+
     Document* doc = control->getDocument();
     doc->lock();
     auto const& file = doc->getEvMetadataFilename();
@@ -583,7 +757,12 @@ void XournalView::zoomChanged() {
 }
 
 void XournalView::pageSizeChanged(size_t page) {
-    layoutPages();
+    if (page != npos) {
+        gtk_xournal_get_layout(this->widget)->recalculatePage(page);
+        placePages();
+    } else {
+        layoutPages();
+    }
     if (page != npos && page < this->viewPages.size()) {
         this->viewPages[page]->rerenderPage();
     }
@@ -595,15 +774,27 @@ void XournalView::pageChanged(size_t page) {
     }
 }
 
-void XournalView::pageDeleted(size_t page) {
+void XournalView::pageDeleted(size_t page) { pagesDeleted(page, 1); }
+
+void XournalView::pagesDeleted(size_t first, size_t count) {
     const size_t currentPageNo = control->getCurrentPageNo();
 
-    viewPages.erase(begin(viewPages) + static_cast<long>(page));
+    std::vector<std::unique_ptr<XojPageView>> deletedViews;
+    {
+        std::lock_guard lock(this->viewPagesMutex);
+        auto begin = viewPages.begin() + as_signed(first);
+        auto end = begin + as_signed(count);
+        std::move(begin, end, std::back_inserter(deletedViews));
+        viewPages.erase(begin, end);
+    }
+    deletedViews.clear();
 
     layoutPages();
 
-    if (currentPageNo > page) {
-        control->getScrollHandler()->scrollToPage(currentPageNo - 1);
+    if (currentPageNo >= first + count) {
+        control->getScrollHandler()->scrollToPage(currentPageNo - count);
+    } else if (currentPageNo > first) {
+        control->getScrollHandler()->scrollToPage(first);
     } else {
         control->getScrollHandler()->scrollToPage(currentPageNo);
     }
@@ -621,13 +812,23 @@ auto XournalView::getTextEditor() const -> TextEditor* {
 
 auto XournalView::getCache() const -> PdfCache* { return this->cache.get(); }
 
-void XournalView::pageInserted(size_t page) {
+void XournalView::pageInserted(size_t page) { pagesInserted(page, 1); }
+
+void XournalView::pagesInserted(size_t first, size_t count) {
+    std::vector<std::unique_ptr<XojPageView>> pageViews;
+    pageViews.reserve(count);
     Document* doc = control->getDocument();
     doc->lock();
-    auto pageView = std::make_unique<XojPageView>(this, doc->getPage(page));
+    for (size_t n = first; n < first + count; n++) {
+        pageViews.emplace_back(std::make_unique<XojPageView>(this, doc->getPage(n)));
+    }
     doc->unlock();
 
-    viewPages.insert(begin(viewPages) + as_signed(page), std::move(pageView));
+    {
+        std::lock_guard lock(this->viewPagesMutex);
+        viewPages.insert(begin(viewPages) + as_signed(first), std::make_move_iterator(pageViews.begin()),
+                         std::make_move_iterator(pageViews.end()));
+    }
 
     layoutPages();
     // check which pages are visible and select the most visible page
@@ -637,6 +838,8 @@ void XournalView::pageInserted(size_t page) {
 
 auto XournalView::getZoom() const -> double { return control->getZoomControl()->getZoom(); }
 
+auto XournalView::getZoomGeneration() const -> unsigned int { return zoomGeneration.load(); }
+
 auto XournalView::getDpiScaleFactor() const -> int { return gtk_widget_get_scale_factor(widget); }
 
 void XournalView::clearSelection() {
@@ -728,14 +931,19 @@ void XournalView::repaintSelection(bool evenWithoutSelection) {
 }
 
 void XournalView::layoutPages() {
+    gtk_xournal_get_layout(this->widget)->recalculate();
+    placePages();
+}
+
+void XournalView::placePages() {
     Layout* layout = gtk_xournal_get_layout(this->widget);
-    layout->recalculate();
 
     // Todo (fabian): the following lines are conceptually wrong, the Layout::layoutPages function is meant to be
     // called by an expose event, but removing it, will break "add page".
     auto rectangle = layout->getVisibleRect();
     layout->layoutPages(std::max<int>(layout->getMinimalWidth(), round_cast<int>(rectangle.width)),
                         std::max<int>(layout->getMinimalHeight(), round_cast<int>(rectangle.height)));
+    gtk_xournal_repaint_all(this->widget);
 }
 
 auto XournalView::getDisplayHeight() const -> int {
@@ -768,6 +976,10 @@ auto XournalView::isPageVisible(size_t page, int* visibleHeight) const -> bool {
 }
 
 void XournalView::documentChanged(DocumentChangeType type) {
+    if (type == DOCUMENT_CHANGE_PAGES) {
+        pagesChanged();
+        return;
+    }
     if (type != DOCUMENT_CHANGE_CLEARED && type != DOCUMENT_CHANGE_COMPLETE) {
         return;
     }
@@ -778,7 +990,12 @@ void XournalView::documentChanged(DocumentChangeType type) {
 
     clearSelection();
 
-    viewPages.clear();
+    std::vector<std::unique_ptr<XojPageView>> newViewPages;
+    {
+        std::lock_guard lock(this->viewPagesMutex);
+        std::swap(viewPages, newViewPages);
+    }
+    newViewPages.clear();
 
     recreatePdfCache();
 
@@ -786,19 +1003,37 @@ void XournalView::documentChanged(DocumentChangeType type) {
     doc->lock();
 
     size_t pagecount = doc->getPageCount();
-    viewPages.reserve(pagecount);
+    newViewPages.reserve(pagecount);
     for (size_t i = 0; i < pagecount; i++) {
-        viewPages.emplace_back(std::make_unique<XojPageView>(this, doc->getPage(i)));
+        newViewPages.emplace_back(std::make_unique<XojPageView>(this, doc->getPage(i)));
     }
 
     doc->unlock();
 
+    {
+        std::lock_guard lock(this->viewPagesMutex);
+        std::swap(viewPages, newViewPages);
+    }
+
     layoutPages();
     scrollTo(0);
 
     scheduler->unlock();
 }
 
+void XournalView::pagesChanged() {
+    layoutPages();
+
+    // The pages out of view are rendered again when they are shown: drop their buffers instead of queueing jobs
+    for (auto& view: this->viewPages) {
+        if (view->isVisible()) {
+            view->rerenderPage();
+        } else {
+            view->deleteViewBuffer();
+        }
+    }
+}
+
 auto XournalView::cut() -> bool {
     size_t p = getCurrentPage();
     if (p == npos || p >= viewPages.size()) {
@@ -843,6 +1078,16 @@ auto XournalView::getDocument() const -> Document* { return control->getDocument
 
 auto XournalView::getViewPages() const -> std::vector<std::unique_ptr<XojPageView>> const& { return viewPages; }
 
+auto XournalView::paintFromPageBuffer(const PageRef& page, cairo_t* cr) const -> bool {
+    std::lock_guard lock(this->viewPagesMutex);
+    for (auto&& v: this->viewPages) {
+        if (v->getPage() == page) {
+            return v->paintFromBuffer(cr);
+        }
+    }
+    return false;
+}
+
 auto XournalView::getCursor() const -> XournalppCursor* { return control->getCursor(); }
 
 auto XournalView::getSelection() const -> EditSelection* {
@@ -11,9 +11,11 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
 #include <cstddef>  // for size_t
 #include <limits>   // for numeric_limits
 #include <memory>   // for unique_ptr
+#include <mutex>    // for mutex
 #include <string>   // for string
 #include <utility>  // for pair
 #include <vector>   // for vector
@@ -26,6 +28,7 @@
 #include "gui/inputdevices/InputEvents.h"  // for KeyEvent
 #include "model/DocumentChangeType.h"      // for DocumentChangeType
 #include "model/DocumentListener.h"        // for DocumentListener
+#include "model/PageRef.h"                 // for PageRef
 #include "pdf/base/XojPdfPage.h"           // for XojPdfRectangle
 #include "util/Util.h"                     // for npos
 
@@ -64,6 +67,10 @@ public:
     void clearSelection();
 
     void layerChanged(size_t page);
+    /**
+     * Show the page with the new visibility of its layers, without rendering the layers again if possible
+     */
+    void layerVisibilityChanged(size_t page);
 
     void requestFocus();
 
@@ -74,6 +81,8 @@ public:
     bool searchTextOnPage(const std::string& text, size_t pageNumber, size_t index, size_t* occurrences,
                           XojPdfRectangle* matchRect);
 
+    void setSearchResults(size_t pageNumber, const std::string& text, std::vector<XojPdfRectangle> results);
+
     bool cut();
     bool copy();
     bool paste();
@@ -101,8 +110,20 @@ public:
     TextEditor* getTextEditor() const;
     std::vector<std::unique_ptr<XojPageView>> const& getViewPages() const;
 
+    /**
+     * @brief Paints the page from the buffer of its view, if the buffer is complete and up to date. May be called from
+     * any thread.
+     *
+     * @return false if nothing was painted, and the page must be rendered instead
+     */
+    bool paintFromPageBuffer(const PageRef& page, cairo_t* cr) const;
+
     Control* getControl() const;
     double getZoom() const;
+    /**
+     * @return A counter incremented on every zoom change. Render jobs use it to find out if their result is outdated.
+     */
+    unsigned int getZoomGeneration() const;
     int getDpiScaleFactor() const;
     Document* getDocument() const;
     PdfCache* getCache() const;
@@ -134,6 +155,17 @@ public:
      */
     ScrollHandling* getScrollHandling() const;
 
+    /**
+     * The view was scrolled now (by the user, by a drag or by a zoom). Until it is idle, the pages are rendered in
+     * draft quality, if enabled in the settings.
+     */
+    void scrollActivityDetected();
+
+    /**
+     * @return true while the pages are to be rendered in draft quality. May be called from any thread.
+     */
+    bool isDraftRendering() const;
+
 public:
     // ZoomListener interface
     void zoomChanged() override;
@@ -145,6 +177,8 @@ public:
     void pageChanged(size_t page) override;
     void pageInserted(size_t page) override;
     void pageDeleted(size_t page) override;
+    void pagesInserted(size_t first, size_t count) override;
+    void pagesDeleted(size_t first, size_t count) override;
     void documentChanged(DocumentChangeType type) override;
 
 public:
@@ -158,12 +192,46 @@ public:
 private:
     void fireZoomChanged();
 
+    // Layout the pages with the layout size calculated beforehand
+    void placePages();
+
+    /// Lays out the pages and renders the visible ones again, after a change of many pages
+    void pagesChanged();
+
     std::pair<size_t, size_t> preloadPageBounds(size_t page, size_t maxPage);
 
+    /**
+     * Render the pages around the page which have no buffer. In the fullscreen and presentation view modes, they are
+     * also rendered again if their buffer is not at the current zoom, so that flipping to them shows them at once.
+     */
+    void preloadPages(size_t page);
+
+    /**
+     * @return true if the active view mode keeps the preloaded pages rendered at the current zoom
+     */
+    bool keepsPreloadedPagesRendered() const;
+
     static auto clearMemoryTimer(XournalView* widget) -> gboolean;
 
+    /**
+     * Ends the draft rendering once the view was not scrolled for DRAFT_IDLE_TIME
+     */
+    static auto draftIdleTimeout(XournalView* self) -> bool;
+
     void cleanupBufferCache();
 
+    /**
+     * Free the buffers of the least recently displayed off-screen pages, until the buffers fit in the memory budget
+     * set in the settings.
+     */
+    void enforceBufferMemoryBudget();
+
+    /**
+     * Free the layers of the lazily loaded pages which were not used for a while. They are read again from the file
+     * when they are needed. The strokes of the other inactive pages are compacted, if enabled in the settings.
+     */
+    void unloadInactivePageContents();
+
 private:
     /**
      * Scrollbars
@@ -173,12 +241,29 @@ private:
     GtkWidget* widget = nullptr;
 
     std::vector<std::unique_ptr<XojPageView>> viewPages;
+    /**
+     * Guards viewPages against paintFromPageBuffer(). Only the UI thread changes viewPages, so it only locks the mutex
+     * for the changes. The removed views must be destroyed once the mutex is released, as their destructor waits for
+     * the running jobs.
+     */
+    mutable std::mutex viewPagesMutex;
 
     Control* control = nullptr;
 
     size_t currentPage = 0;
     size_t lastSelectedPage = npos;
 
+    std::atomic<unsigned int> zoomGeneration{0};
+
+    /**
+     * Draft rendering, while the view is scrolled
+     */
+    std::atomic<bool> draftRendering{false};
+    gint64 lastScrollActivity = 0;  ///< in ms
+    guint draftTimeoutId = 0;
+    /// in ms
+    static constexpr guint DRAFT_IDLE_TIME = 150;
+
     std::unique_ptr<PdfCache> cache;
 
     /**
@@ -1,7 +1,9 @@
 #include "XournalppCursor.h"
 
+#include <algorithm>         // for find_if, rotate
 #include <cmath>             // for cos, sin, M_PI, NAN, fmod
 #include <cstdint>           // for uint32_t
+#include <functional>        // for hash
 #include <initializer_list>  // for initializer_list
 
 #include <cairo.h>                  // for cairo_move_to, cairo_lin...
@@ -346,6 +348,9 @@ auto XournalppCursor::getResizeCursor(double deltaAngle) -> GdkCursor* {
     }
     this->currentCursor = CRSR_RESIZE;
     this->currentCursorFlavour = flavour;
+    if (GdkCursor* cached = findCachedCursor()) {
+        return cached;
+    }
 
     double a = (this->angle + deltaAngle) * M_PI / 180;
     cairo_surface_t* crCursor = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, RESIZE_CURSOR_SIZE, RESIZE_CURSOR_SIZE);
@@ -376,7 +381,7 @@ auto XournalppCursor::getResizeCursor(double deltaAngle) -> GdkCursor* {
             gdk_cursor_new_from_pixbuf(gtk_widget_get_display(control->getWindow()->getXournal()->getWidget()), pixbuf,
                                        RESIZE_CURSOR_SIZE / 2, RESIZE_CURSOR_SIZE / 2);
     g_object_unref(pixbuf);
-    return cursor;
+    return cacheCursor(cursor);
 }
 
 auto XournalppCursor::getEraserCursor() -> GdkCursor* {
@@ -390,6 +395,9 @@ auto XournalppCursor::getEraserCursor() -> GdkCursor* {
     }
     this->currentCursor = CRSR_ERASER;
     this->currentCursorFlavour = flavour;
+    if (GdkCursor* cached = findCachedCursor()) {
+        return cached;
+    }
 
     cairo_surface_t* surface =
             cairo_image_surface_create(CAIRO_FORMAT_ARGB32, ceil_cast<int>(cursorSize), ceil_cast<int>(cursorSize));
@@ -404,7 +412,7 @@ auto XournalppCursor::getEraserCursor() -> GdkCursor* {
     GdkCursor* cursor =
             gdk_cursor_new_from_surface(gdk_display_get_default(), surface, cursorSize / 2.0, cursorSize / 2.0);
     cairo_surface_destroy(surface);
-    return cursor;
+    return cacheCursor(cursor);
 }
 
 
@@ -448,12 +456,24 @@ auto XournalppCursor::createHighlighterOrPenCursor(double alpha) -> GdkCursor* {
     gulong flavour = (cursorType == STYLUS_CURSOR_DOT ? 1U : 0U) | (cursorType == STYLUS_CURSOR_BIG ? 2U : 0U) |
                      (bright ? 4U : 0U) | static_cast<gulong>(64 * alpha) << 3U |
                      static_cast<gulong>(cursorSize) << 10U | static_cast<gulong>(uint32_t(irgb)) << 15U;
+    if (bright) {
+        // The cached cursors must not be reused once the highlight changed
+        Settings* settings = control->getSettings();
+        const auto highlight = static_cast<gulong>(std::hash<double>{}(settings->getCursorHighlightRadius()) ^
+                                                   std::hash<double>{}(settings->getCursorHighlightBorderWidth()) ^
+                                                   uint32_t(settings->getCursorHighlightColor()) ^
+                                                   (uint32_t(settings->getCursorHighlightBorderColor()) << 1U));
+        flavour ^= highlight * 31U;
+    }
 
     if ((cursor == this->currentCursor) && (flavour == this->currentCursorFlavour)) {
         return nullptr;
     }
     this->currentCursor = cursor;
     this->currentCursorFlavour = flavour;
+    if (GdkCursor* cached = findCachedCursor()) {
+        return cached;
+    }
 
     if ((cursorType == STYLUS_CURSOR_BIG) || bright) {
         height = width = 90;
@@ -518,7 +538,7 @@ auto XournalppCursor::createHighlighterOrPenCursor(double alpha) -> GdkCursor* {
     GdkCursor* gdkCursor = gdk_cursor_new_from_pixbuf(
             gtk_widget_get_display(control->getWindow()->getXournal()->getWidget()), pixbuf, centerX, centerY);
     g_object_unref(pixbuf);
-    return gdkCursor;
+    return cacheCursor(gdkCursor);
 }
 
 
@@ -582,6 +602,9 @@ auto XournalppCursor::createCustomDrawDirCursor(int size, bool shift, bool ctrl)
     }
     this->currentCursor = newCursorID;
     this->currentCursorFlavour = flavour;
+    if (GdkCursor* cached = findCachedCursor()) {
+        return cached;
+    }
 
     int height = size;
     int width = size;
@@ -640,5 +663,34 @@ auto XournalppCursor::createCustomDrawDirCursor(int size, bool shift, bool ctrl)
             gtk_widget_get_display(control->getWindow()->getXournal()->getWidget()), pixbuf, centerX, centerY);
     g_object_unref(pixbuf);
 
+    return cacheCursor(cursor);
+}
+
+auto XournalppCursor::getScaleFactor() const -> int {
+    return gtk_widget_get_scale_factor(control->getWindow()->getXournal()->getWidget());
+}
+
+auto XournalppCursor::findCachedCursor() -> GdkCursor* {
+    const int scaleFactor = getScaleFactor();
+    auto it = std::find_if(this->cachedCursors.begin(), this->cachedCursors.end(), [&](const CachedCursor& c) {
+        return c.id == this->currentCursor && c.flavour == this->currentCursorFlavour && c.scaleFactor == scaleFactor;
+    });
+    if (it == this->cachedCursors.end()) {
+        return nullptr;
+    }
+    std::rotate(this->cachedCursors.begin(), it, it + 1);
+    return GDK_CURSOR(g_object_ref(this->cachedCursors.front().cursor.get()));
+}
+
+auto XournalppCursor::cacheCursor(GdkCursor* cursor) -> GdkCursor* {
+    if (!cursor) {
+        return nullptr;
+    }
+    if (this->cachedCursors.size() >= MAX_CACHED_CURSORS) {
+        this->cachedCursors.pop_back();
+    }
+    this->cachedCursors.insert(this->cachedCursors.begin(),
+                               CachedCursor{this->currentCursor, this->currentCursorFlavour, getScaleFactor(),
+                                            xoj::util::GObjectSPtr<GdkCursor>(cursor, xoj::util::ref)});
     return cursor;
 }
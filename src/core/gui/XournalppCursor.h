@@ -11,11 +11,15 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
 #include <gdk/gdk.h>  // for GdkCursor
 #include <glib.h>     // for guint, gulong
 
 #include "control/tools/CursorSelectionType.h"  // for CursorSelectionType
 #include "gui/inputdevices/InputEvents.h"       // for InputDeviceClass, INP...
+#include "util/raii/GObjectSPtr.h"              // for GObjectSPtr
 
 class Control;
 
@@ -49,6 +53,21 @@ private:
     GdkCursor* createHighlighterOrPenCursor(double alpha);
     GdkCursor* createCustomDrawDirCursor(int size, bool shift, bool ctrl);
 
+    /**
+     * The custom cursor of the current cursor type and flavour, if it was created recently
+     * @return A new reference, or nullptr
+     */
+    GdkCursor* findCachedCursor();
+    /**
+     * Keep the custom cursor created for the current cursor type and flavour
+     * @return cursor
+     */
+    GdkCursor* cacheCursor(GdkCursor* cursor);
+    int getScaleFactor() const;
+
+    /// The custom cursors of that many types and flavours are kept
+    static constexpr size_t MAX_CACHED_CURSORS = 16;
+
 private:
     InputDeviceClass inputDevice = INPUT_DEVICE_MOUSE;
 
@@ -70,6 +89,15 @@ private:
     gulong currentCursorFlavour{};  // for different flavours of a cursor (i.e. drawdir, pen and highlighter custom
                                     // cursors)
 
+    struct CachedCursor {
+        guint id;
+        gulong flavour;
+        int scaleFactor;
+        xoj::util::GObjectSPtr<GdkCursor> cursor;
+    };
+    /// Most recently used first
+    std::vector<CachedCursor> cachedCursors;
+
     // for resizing rotated/mirrored selections
     double angle = 0;
     bool mirror = false;
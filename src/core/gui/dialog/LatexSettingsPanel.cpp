@@ -72,6 +72,8 @@ void LatexSettingsPanel::load(const LatexSettings& settings) {
                                       Util::toGFilename(settings.globalTemplatePath).c_str());
     }
     gtk_entry_set_text(GTK_ENTRY(builder.get("latexSettingsGenCmd")), settings.genCmd.c_str());
+    gtk_check_button_set_active(GTK_CHECK_BUTTON(builder.get("latexSettingsPrecompilePreamble")),
+                                settings.precompilePreamble);
 
     std::string themeId = settings.sourceViewThemeId;
 
@@ -107,6 +109,8 @@ void LatexSettingsPanel::save(LatexSettings& settings) {
     settings.defaultText = gtk_entry_get_text(GTK_ENTRY(builder.get("latexDefaultEntry")));
     settings.globalTemplatePath = Util::fromGFilename(gtk_file_chooser_get_filename(this->globalTemplateChooser));
     settings.genCmd = gtk_entry_get_text(GTK_ENTRY(builder.get("latexSettingsGenCmd")));
+    settings.precompilePreamble =
+            gtk_check_button_get_active(GTK_CHECK_BUTTON(builder.get("latexSettingsPrecompilePreamble")));
 
 #ifdef USE_GTK_SOURCEVIEW
     GtkSourceStyleScheme* theme = gtk_source_style_scheme_chooser_get_style_scheme(
@@ -349,6 +349,7 @@ void SettingsDialog::load() {
     loadCheckbox("cbDoActionOnStrokeFiltered", settings->getDoActionOnStrokeFiltered());
     loadCheckbox("cbTrySelectOnStrokeFiltered", settings->getTrySelectOnStrokeFiltered());
     loadCheckbox("cbSnapRecognizedShapesEnabled", settings->getSnapRecognizedShapesEnabled());
+    loadCheckbox("cbSnapObjects", settings->isSnapObjects());
     loadCheckbox("cbRestoreLineWidthEnabled", settings->getRestoreLineWidthEnabled());
     loadCheckbox("cbStockIcons", settings->areStockIconsUsed());
     loadCheckbox("cbHideHorizontalScrollbar", settings->getScrollbarHideType() & SCROLLBAR_HIDE_HORIZONTAL);
@@ -397,6 +398,11 @@ void SettingsDialog::load() {
     showStabilizerPreprocessorOptions(settings->getStabilizerPreprocessor());
     /***********/
 
+    loadCheckbox("cbInkPrediction", settings->isInkPrediction());
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("sbInkPredictionTime")), settings->getInkPredictionTime());
+    loadCheckbox("cbInkDecimation", settings->isInkDecimation());
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("sbInkDecimationError")), settings->getInkDecimationError());
+
     GtkComboBox* cbSidebarNumberingStyle = GTK_COMBO_BOX(builder.get("cbSidebarPageNumberStyle"));
     gtk_combo_box_set_active(cbSidebarNumberingStyle, static_cast<int>(settings->getSidebarNumberingStyle()));
 
@@ -436,6 +442,9 @@ void SettingsDialog::load() {
     GtkWidget* spSnapGridSize = builder.get("spSnapGridSize");
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(spSnapGridSize), settings->getSnapGridSize() / DEFAULT_GRID_SIZE);
 
+    GtkWidget* spSnapObjectsTolerance = builder.get("spSnapObjectsTolerance");
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(spSnapObjectsTolerance), settings->getSnapObjectsTolerance());
+
     GtkWidget* spStrokeRecognizerMinSize = builder.get("spStrokeRecognizerMinSize");
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(spStrokeRecognizerMinSize), settings->getStrokeRecognizerMinSize());
 
@@ -588,6 +597,12 @@ void SettingsDialog::load() {
     gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("preloadPagesAfter")),
                               static_cast<double>(settings->getPreloadPagesAfter()));
     loadCheckbox("cbEagerPageCleanup", settings->isEagerPageCleanup());
+    loadCheckbox("cbLazyPageLoading", settings->isLazyPageLoading());
+    loadCheckbox("cbBinaryStrokeEncoding", settings->isBinaryStrokeEncoding());
+    loadCheckbox("cbCompactStrokeStorage", settings->isCompactStrokeStorage());
+    loadCheckbox("cbDraftRendering", settings->isDraftRendering());
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(builder.get("pageBufferMemoryBudget")),
+                              static_cast<double>(settings->getPageBufferMemoryBudget()));
 
     disableWithCheckbox("cbUnlimitedScrolling", "cbAddVerticalSpace");
     disableWithCheckbox("cbUnlimitedScrolling", "cbAddHorizontalSpace");
@@ -709,6 +724,7 @@ void SettingsDialog::save() {
     settings->setDoActionOnStrokeFiltered(getCheckbox("cbDoActionOnStrokeFiltered"));
     settings->setTrySelectOnStrokeFiltered(getCheckbox("cbTrySelectOnStrokeFiltered"));
     settings->setSnapRecognizedShapesEnabled(getCheckbox("cbSnapRecognizedShapesEnabled"));
+    settings->setSnapObjects(getCheckbox("cbSnapObjects"));
     settings->setRestoreLineWidthEnabled(getCheckbox("cbRestoreLineWidthEnabled"));
     settings->setAreStockIconsUsed(getCheckbox("cbStockIcons"));
     settings->setPressureGuessingEnabled(getCheckbox("cbEnablePressureInference"));
@@ -743,6 +759,12 @@ void SettingsDialog::save() {
     settings->setStabilizerCuspDetection(getCheckbox("cbStabilizerEnableCuspDetection"));
     settings->setStabilizerFinalizeStroke(getCheckbox("cbStabilizerEnableFinalizeStroke"));
 
+    settings->setInkPrediction(getCheckbox("cbInkPrediction"));
+    settings->setInkPredictionTime(static_cast<unsigned int>(
+            gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(builder.get("sbInkPredictionTime")))));
+    settings->setInkDecimation(getCheckbox("cbInkDecimation"));
+    settings->setInkDecimationError(gtk_spin_button_get_value(GTK_SPIN_BUTTON(builder.get("sbInkDecimationError"))));
+
     settings->setSidebarNumberingStyle(static_cast<SidebarNumberingStyle>(
             gtk_combo_box_get_active(GTK_COMBO_BOX(builder.get("cbSidebarPageNumberStyle")))));
 
@@ -861,6 +883,11 @@ void SettingsDialog::save() {
     settings->setPreloadPagesAfter(preloadPagesAfter);
     settings->setPreloadPagesBefore(preloadPagesBefore);
     settings->setEagerPageCleanup(getCheckbox("cbEagerPageCleanup"));
+    settings->setLazyPageLoading(getCheckbox("cbLazyPageLoading"));
+    settings->setBinaryStrokeEncoding(getCheckbox("cbBinaryStrokeEncoding"));
+    settings->setCompactStrokeStorage(getCheckbox("cbCompactStrokeStorage"));
+    settings->setDraftRendering(getCheckbox("cbDraftRendering"));
+    settings->setPageBufferMemoryBudget(spinAsUint(GTK_SPIN_BUTTON(builder.get("pageBufferMemoryBudget"))));
 
     settings->setDefaultSaveName(gtk_entry_get_text(GTK_ENTRY(builder.get("txtDefaultSaveName"))));
     settings->setDefaultPdfExportName(gtk_entry_get_text(GTK_ENTRY(builder.get("txtDefaultPdfName"))));
@@ -989,6 +1016,8 @@ void SettingsDialog::save() {
             static_cast<double>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(builder.get("spSnapGridTolerance")))));
     settings->setSnapGridSize(static_cast<double>(
             gtk_spin_button_get_value(GTK_SPIN_BUTTON(builder.get("spSnapGridSize"))) * DEFAULT_GRID_SIZE));
+    settings->setSnapObjectsTolerance(
+            static_cast<double>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(builder.get("spSnapObjectsTolerance")))));
 
     settings->setStrokeRecognizerMinSize(
             static_cast<double>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(builder.get("spStrokeRecognizerMinSize")))));
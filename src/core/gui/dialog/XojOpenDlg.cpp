@@ -150,6 +150,21 @@ void xoj::OpenDlg::showOpenFileDialog(GtkWindow* parent, Settings* settings, std
     popup.show(parent);
 }
 
+void xoj::OpenDlg::showAppendDocumentDialog(GtkWindow* parent, Settings* settings,
+                                            std::function<void(fs::path)> callback) {
+    auto popup = xoj::popup::PopupWindowWrapper<FileDlg>(_("Append a document"),
+                                                         addSetLastSavePathToCallback(std::move(callback), settings));
+
+    auto* fc = GTK_FILE_CHOOSER(popup.getPopup()->getWindow());
+    xoj::addFilterXopp(fc);
+    xoj::addFilterXoj(fc);
+
+    addlastSavePathShortcut(fc, settings);
+    setCurrentFolderToLastOpenPath(fc, settings);
+
+    popup.show(parent);
+}
+
 void xoj::OpenDlg::showAnnotatePdfDialog(GtkWindow* parent, Settings* settings,
                                          std::function<void(fs::path, bool)> callback) {
     auto popup = xoj::popup::PopupWindowWrapper<FileDlg>(_("Annotate Pdf file"),
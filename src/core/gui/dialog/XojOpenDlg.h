@@ -23,6 +23,8 @@ namespace xoj::OpenDlg {
 void showOpenFileDialog(GtkWindow* parent, Settings* settings, std::function<void(fs::path)> callback);
 /// @param callback(path, attachPdf)
 void showAnnotatePdfDialog(GtkWindow* parent, Settings* settings, std::function<void(fs::path, bool)> callback);
+/// Only the Xournal++ and Xournal files
+void showAppendDocumentDialog(GtkWindow* parent, Settings* settings, std::function<void(fs::path)> callback);
 void showOpenTemplateDialog(GtkWindow* parent, Settings* settings, std::function<void(fs::path)> callback);
 
 /// @param callback(path, attachImg)
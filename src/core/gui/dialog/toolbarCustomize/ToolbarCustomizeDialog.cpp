@@ -67,8 +67,8 @@ constexpr auto UI_DIALOG_NAME = "DialogCustomizeToolbar";
 
 ToolbarCustomizeDialog::ToolbarCustomizeDialog(GladeSearchpath* gladeSearchPath, MainWindow* win,
                                                ToolbarDragDropHandler* handler):
-        itemData(buildToolDataVector(win->getToolMenuHandler()->getToolItems())),
-        colorItemData(buildColorDataVector(handler->getControl()->getSettings()->getColorPalette())) {
+        tools(win->getToolMenuHandler()->getToolItems()),
+        palette(handler->getControl()->getSettings()->getColorPalette()) {
     Builder builder(gladeSearchPath, UI_FILE);
     window.reset(GTK_WINDOW(builder.get(UI_DIALOG_NAME)));
     notebook = GTK_NOTEBOOK(builder.get("notebook"));
@@ -84,51 +84,22 @@ ToolbarCustomizeDialog::ToolbarCustomizeDialog(GladeSearchpath* gladeSearchPath,
     labels[Cat::TOOLS] = C_("Item category in toolbar customization dialog", "Tools");
     labels[Cat::SEPARATORS] = C_("Item category in toolbar customization dialog", "Separators");
     labels[Cat::PLUGINS] = C_("Item category in toolbar customization dialog", "Plugins");
-    EnumIndexedArray<GtkWidget*, Cat> tabs;
 
     for (std::underlying_type_t<Cat> n = 0; n < xoj::to_underlying(Cat::ENUMERATOR_COUNT); n++) {
         Cat c = static_cast<Cat>(n);
-        tabs[c] = gtk_list_box_new();
+        GtkWidget* list = gtk_list_box_new();
+        tabs.push_back(GTK_LIST_BOX(list));
         GtkWidget* w = gtk_scrolled_window_new();
-        gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(w), tabs[c]);
+        gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(w), list);
         gtk_notebook_append_page(notebook, w, gtk_label_new(labels[c].c_str()));
     }
+    filledTabs.resize(tabs.size(), false);
 
-    auto addEntry = [&tabs](GtkWidget* w, Cat c) {
-        GtkWidget* row = gtk_list_box_row_new();
-        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), w);
-        gtk_list_box_row_set_selectable(GTK_LIST_BOX_ROW(row), false);
-        gtk_list_box_append(GTK_LIST_BOX(tabs[c]), row);
-    };
-
-    for (auto& data: itemData) {
-        addEntry(data.ebox.get(), data.item->getCategory());
-    }
-
-    for (auto& data: colorItemData) {
-        addEntry(data.ebox.get(), Cat::COLORS);
-    }
-
-    // init separator and spacer
-    for (SeparatorData& data: separators) {
-        GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
-        gtk_box_append(box, ToolbarSeparatorImage::newImage(data.separator));
-        gtk_box_append(box, gtk_label_new(data.label));
-
-        GtkWidget* ebox = gtk_event_box_new();
-        gtk_container_add(GTK_CONTAINER(ebox), GTK_WIDGET(box));
-        gtk_widget_show_all(ebox);
-
-        // make ebox a drag source
-        gtk_drag_source_set(ebox, GDK_BUTTON1_MASK, &ToolbarDragDropHelper::dropTargetEntry, 1, GDK_ACTION_MOVE);
-        ToolbarDragDropHelper::dragSourceAddToolbar(ebox);
-
-        g_signal_connect(ebox, "drag-begin", G_CALLBACK(toolitemDragBeginSeparator), &data);
-        g_signal_connect(ebox, "drag-end", G_CALLBACK(toolitemDragEndSeparator), &data);
-        g_signal_connect(ebox, "drag-data-get", G_CALLBACK(toolitemDragDataGetSeparator), &data);
-
-        addEntry(ebox, Cat::SEPARATORS);
-    }
+    fillTab(static_cast<guint>(gtk_notebook_get_current_page(notebook)));
+    g_signal_connect(notebook, "switch-page", G_CALLBACK(+[](GtkNotebook*, GtkWidget*, guint page, gpointer d) {
+                         static_cast<ToolbarCustomizeDialog*>(d)->fillTab(page);
+                     }),
+                     this);
 
     GtkWidget* target = GTK_WIDGET(notebook);  // builder.get("viewport1");
     // prepare drag & drop
@@ -245,74 +216,115 @@ void ToolbarCustomizeDialog::dragDataReceived(GtkWidget* widget, GdkDragContext*
     gtk_drag_finish(dragContext, true, false, time);
 }
 
-/**
- * builds up the icon list
- */
-auto ToolbarCustomizeDialog::buildToolDataVector(const std::vector<std::unique_ptr<AbstractToolItem>>& tools)
-        -> std::vector<ToolItemDragData> {
-    // By reserving, we ensure no reallocation is done, so the pointer `&data` used below is not invalidated
-    std::vector<ToolItemDragData> database;
-    database.reserve(tools.size());
+void ToolbarCustomizeDialog::fillTab(guint page) {
+    if (page >= tabs.size() || filledTabs[page]) {
+        return;
+    }
+    filledTabs[page] = true;
+
+    using Cat = AbstractToolItem::Category;
+    const Cat c = static_cast<Cat>(page);
+    GtkListBox* list = tabs[page];
+    auto addEntry = [list](GtkWidget* w) {
+        GtkWidget* row = gtk_list_box_row_new();
+        gtk_list_box_row_set_child(GTK_LIST_BOX_ROW(row), w);
+        gtk_list_box_row_set_selectable(GTK_LIST_BOX_ROW(row), false);
+        gtk_widget_show(row);
+        gtk_list_box_append(list, row);
+    };
+
     for (auto&& item: tools) {
-        std::string name = item->getToolDisplayName();
-        GtkWidget* icon = item->getNewToolIcon(); /* floating */
-        xoj_assert(icon);
-
-        GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
-        gtk_box_append(box, icon);
-        gtk_box_append(box, gtk_label_new(name.c_str()));
-
-        GtkWidget* ebox = gtk_event_box_new();
-        gtk_container_add(GTK_CONTAINER(ebox), GTK_WIDGET(box));
-        gtk_widget_show_all(GTK_WIDGET(ebox));
-
-        auto& data = database.emplace_back();
-        data.dlg = this;
-        data.icon = icon;
-        data.item = item.get();
-        data.ebox.reset(ebox, xoj::util::adopt);
-
-        // make ebox a drag source
-        gtk_drag_source_set(ebox, GDK_BUTTON1_MASK, &ToolbarDragDropHelper::dropTargetEntry, 1, GDK_ACTION_MOVE);
-        ToolbarDragDropHelper::dragSourceAddToolbar(ebox);
-
-        g_signal_connect(ebox, "drag-begin", G_CALLBACK(toolitemDragBegin), &data);
-        g_signal_connect(ebox, "drag-end", G_CALLBACK(toolitemDragEnd), &data);
-        g_signal_connect(ebox, "drag-data-get", G_CALLBACK(toolitemDragDataGet), &data);
+        if (item->getCategory() == c) {
+            addEntry(buildToolItemEntry(item.get()));
+        }
+    }
+
+    if (c == Cat::COLORS) {
+        for (size_t i = 0; i < palette.size(); i++) {
+            // namedColor needs to be a pointer to pass it into a ColorToolItemDragData
+            addEntry(buildColorItemEntry(&(palette.getColorAt(i))));
+        }
     }
-    return database;
-}
 
-auto ToolbarCustomizeDialog::buildColorDataVector(const Palette& palette) -> std::vector<ColorToolItemDragData> {
-    // By reserving, we ensure no reallocation is done, so the pointer `&data` used below is not invalidated
-    std::vector<ColorToolItemDragData> database;
-    database.reserve(palette.size());
-    for (size_t i = 0; i < palette.size(); i++) {
-        // namedColor needs to be a pointer to pass it into a ColorToolItemDragData
-        const NamedColor* namedColor = &(palette.getColorAt(i));
-
-        GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
-        gtk_box_append(box, ColorIcon::newGtkImage(namedColor->getColor(), 16, true));
-        gtk_box_append(box, gtk_label_new(namedColor->getName().c_str()));
-
-        GtkWidget* ebox = gtk_event_box_new();
-        gtk_container_add(GTK_CONTAINER(ebox), GTK_WIDGET(box));
-        gtk_widget_show_all(GTK_WIDGET(ebox));
-
-        // make ebox a drag source
-        gtk_drag_source_set(ebox, GDK_BUTTON1_MASK, &ToolbarDragDropHelper::dropTargetEntry, 1, GDK_ACTION_MOVE);
-        ToolbarDragDropHelper::dragSourceAddToolbar(ebox);
-
-        auto& data = database.emplace_back();
-        data.dlg = this;
-        data.namedColor = namedColor;
-        data.ebox.reset(ebox, xoj::util::ref);
-
-        g_signal_connect(ebox, "drag-begin", G_CALLBACK(toolitemColorDragBegin), &data);
-        g_signal_connect(ebox, "drag-end", G_CALLBACK(toolitemColorDragEnd), &data);
-        g_signal_connect(ebox, "drag-data-get", G_CALLBACK(toolitemColorDragDataGet), &data);
+    if (c == Cat::SEPARATORS) {
+        // init separator and spacer
+        for (SeparatorData& data: separators) { addEntry(buildSeparatorEntry(data)); }
     }
-    return database;
+}
+
+/**
+ * builds up the entry of a tool item
+ */
+auto ToolbarCustomizeDialog::buildToolItemEntry(AbstractToolItem* item) -> GtkWidget* {
+    std::string name = item->getToolDisplayName();
+    GtkWidget* icon = item->getNewToolIcon(); /* floating */
+    xoj_assert(icon);
+
+    GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
+    gtk_box_append(box, icon);
+    gtk_box_append(box, gtk_label_new(name.c_str()));
+
+    GtkWidget* ebox = gtk_event_box_new();
+    gtk_container_add(GTK_CONTAINER(ebox), GTK_WIDGET(box));
+    gtk_widget_show_all(GTK_WIDGET(ebox));
+
+    auto& data = itemData.emplace_back();
+    data.dlg = this;
+    data.icon = icon;
+    data.item = item;
+    data.ebox.reset(ebox, xoj::util::adopt);
+
+    // make ebox a drag source
+    gtk_drag_source_set(ebox, GDK_BUTTON1_MASK, &ToolbarDragDropHelper::dropTargetEntry, 1, GDK_ACTION_MOVE);
+    ToolbarDragDropHelper::dragSourceAddToolbar(ebox);
+
+    g_signal_connect(ebox, "drag-begin", G_CALLBACK(toolitemDragBegin), &data);
+    g_signal_connect(ebox, "drag-end", G_CALLBACK(toolitemDragEnd), &data);
+    g_signal_connect(ebox, "drag-data-get", G_CALLBACK(toolitemDragDataGet), &data);
+    return ebox;
+}
+
+auto ToolbarCustomizeDialog::buildColorItemEntry(const NamedColor* namedColor) -> GtkWidget* {
+    GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
+    gtk_box_append(box, ColorIcon::newGtkImage(namedColor->getColor(), 16, true));
+    gtk_box_append(box, gtk_label_new(namedColor->getName().c_str()));
+
+    GtkWidget* ebox = gtk_event_box_new();
+    gtk_container_add(GTK_CONTAINER(ebox), GTK_WIDGET(box));
+    gtk_widget_show_all(GTK_WIDGET(ebox));
+
+    // make ebox a drag source
+    gtk_drag_source_set(ebox, GDK_BUTTON1_MASK, &ToolbarDragDropHelper::dropTargetEntry, 1, GDK_ACTION_MOVE);
+    ToolbarDragDropHelper::dragSourceAddToolbar(ebox);
+
+    auto& data = colorItemData.emplace_back();
+    data.dlg = this;
+    data.namedColor = namedColor;
+    data.ebox.reset(ebox, xoj::util::ref);
+
+    g_signal_connect(ebox, "drag-begin", G_CALLBACK(toolitemColorDragBegin), &data);
+    g_signal_connect(ebox, "drag-end", G_CALLBACK(toolitemColorDragEnd), &data);
+    g_signal_connect(ebox, "drag-data-get", G_CALLBACK(toolitemColorDragDataGet), &data);
+    return ebox;
+}
+
+auto ToolbarCustomizeDialog::buildSeparatorEntry(SeparatorData& data) -> GtkWidget* {
+    GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 2));
+    gtk_box_append(box, ToolbarSeparatorImage::newImage(data.separator));
+    gtk_box_append(box, gtk_label_new(data.label));
+
+    GtkWidget* ebox = gtk_event_box_new();
+    gtk_container_add(GTK_CONTAINER(ebox), GTK_WIDGET(box));
+    gtk_widget_show_all(ebox);
+
+    // make ebox a drag source
+    gtk_drag_source_set(ebox, GDK_BUTTON1_MASK, &ToolbarDragDropHelper::dropTargetEntry, 1, GDK_ACTION_MOVE);
+    ToolbarDragDropHelper::dragSourceAddToolbar(ebox);
+
+    g_signal_connect(ebox, "drag-begin", G_CALLBACK(toolitemDragBeginSeparator), &data);
+    g_signal_connect(ebox, "drag-end", G_CALLBACK(toolitemDragEndSeparator), &data);
+    g_signal_connect(ebox, "drag-data-get", G_CALLBACK(toolitemDragDataGetSeparator), &data);
+    return ebox;
 }
 
 void ToolbarCustomizeDialog::show(GtkWindow* parent) {
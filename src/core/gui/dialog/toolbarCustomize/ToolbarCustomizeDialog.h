@@ -12,6 +12,7 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -22,6 +23,7 @@
 #include "util/raii/GtkWindowUPtr.h"
 
 class AbstractToolItem;
+struct NamedColor;
 struct Palette;
 class MainWindow;
 class ToolbarDragDropHandler;
@@ -42,8 +44,16 @@ private:
     struct ColorToolItemDragData;
     struct SeparatorData;
 
-    std::vector<ToolItemDragData> buildToolDataVector(const std::vector<std::unique_ptr<AbstractToolItem>>& tools);
-    std::vector<ColorToolItemDragData> buildColorDataVector(const Palette& palette);
+    GtkWidget* buildToolItemEntry(AbstractToolItem* item);
+    GtkWidget* buildColorItemEntry(const NamedColor* namedColor);
+    static GtkWidget* buildSeparatorEntry(SeparatorData& data);
+
+    /**
+     * @brief Fill the tab of the notebook with the entries of its category, if it is not filled yet
+     * The tabs are filled when they are shown for the first time, so that opening the dialog does not create the
+     * entries of every category
+     */
+    void fillTab(guint page);
 
     // void rebuildIconview();
 
@@ -74,18 +84,25 @@ private:
     // void freeIconview();
 
 private:
+    const std::vector<std::unique_ptr<AbstractToolItem>>& tools;
+    const Palette& palette;
+
     /**
-     * @brief Stores the widget and other data associated to each drag-able toolbar item
-     * Modifications are not allowed to avoid vector reallocation and pointer invalidation
-     * (pointers are feed to g_signal's callback data)
+     * @brief Stores the widget and other data associated to each drag-able toolbar item of the filled tabs
+     * Only appended to: a deque never moves its elements then, so the pointers feed to g_signal's callback data stay
+     * valid
      */
-    const std::vector<ToolItemDragData> itemData;
+    std::deque<ToolItemDragData> itemData;
     /**
-     * @brief Stores the widget and other data associated to each drag-able color item
+     * @brief Stores the widget and other data associated to each drag-able color item, once the tab is filled
      */
-    const std::vector<ColorToolItemDragData> colorItemData;
+    std::deque<ColorToolItemDragData> colorItemData;
     static std::array<SeparatorData, 2> separators;
 
     xoj::util::GtkWindowUPtr window;
     GtkNotebook* notebook;
+
+    /// The list of each tab of the notebook, by category
+    std::vector<GtkListBox*> tabs;
+    std::vector<bool> filledTabs;
 };
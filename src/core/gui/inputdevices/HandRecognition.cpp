@@ -29,6 +29,11 @@ HandRecognition::HandRecognition(GtkWidget* widget, InputContext* inputContext,
 }
 
 HandRecognition::~HandRecognition() {
+    if (timeoutId) {
+        g_source_remove(timeoutId);
+        timeoutId = 0;
+    }
+
     // Enable touchscreen on quit application
     if (!touchState && enabled && touchImpl) {
         touchImpl->enableTouch();
@@ -42,6 +47,9 @@ HandRecognition::~HandRecognition() {
  * Reload settings
  */
 void HandRecognition::reload() {
+    // The backend may change: give the touchscreen back with the current one
+    unblock();
+
     SElement& touch = settings->getCustomElement("touch");
 
     enabled = false;
@@ -100,42 +108,35 @@ void HandRecognition::reload() {
  * @return true to call again
  */
 auto HandRecognition::enableTimeout(HandRecognition* self) -> bool {
-    gint64 now = g_get_monotonic_time() / 1000;
-    gint64 lastPenActionTime = now - self->lastPenAction;
-    if (lastPenActionTime < 20) {
-        // Pen action within the last 20ms, so simple restart timeout
-        return true;
-    }
-
-    if (lastPenActionTime > self->disableTimeout) {
-        // Timeout elapsed, enable touch again
-        self->enableTouch();
-        self->touchState = true;
-
-        // Do not call again
+    gint64 sinceLastPenAction = g_get_monotonic_time() / 1000 - self->lastPenAction;
+    if (sinceLastPenAction < self->disableTimeout) {
+        // The pen was seen in the meantime: wait for the rest of the timeout after its last event
+        self->timeoutId = g_timeout_add(as_unsigned(self->disableTimeout - sinceLastPenAction),
+                                        xoj::util::wrap_v<enableTimeout>, self);
         return false;
     }
 
-    auto nextTime = static_cast<guint>(now - self->lastPenAction + self->disableTimeout);
+    self->timeoutId = 0;
+    self->enableTouch();
+    self->touchState = true;
 
-    g_timeout_add(nextTime, xoj::util::wrap_v<enableTimeout>, self);
-
-    // Do not call again, a new time is scheduled
+    // Do not call again
     return false;
 }
 
 /**
  * There was a pen event, restart the timer
+ *
+ * Called for every pen event: while the touchscreen is disabled, only the time of the event is recorded. The timer
+ * checks it when it expires, instead of being restarted for each event.
  */
 void HandRecognition::penEvent() {
     lastPenAction = g_get_monotonic_time() / 1000;
 
     if (touchState) {
         touchState = false;
-        if (enabled) {
-            disableTouch();
-        }
-        g_timeout_add(as_unsigned(disableTimeout), xoj::util::wrap_v<enableTimeout>, this);
+        disableTouch();
+        timeoutId = g_timeout_add(as_unsigned(disableTimeout), xoj::util::wrap_v<enableTimeout>, this);
     }
 }
 
@@ -176,6 +177,12 @@ void HandRecognition::event(InputDeviceClass device) {
 }
 
 void HandRecognition::unblock() {
-    this->enableTouch();
-    this->touchState = true;
+    if (this->timeoutId) {
+        g_source_remove(this->timeoutId);
+        this->timeoutId = 0;
+    }
+    if (!this->touchState) {
+        this->enableTouch();
+        this->touchState = true;
+    }
 }
@@ -12,7 +12,7 @@
 #pragma once
 
 #include <gdk/gdk.h>  // for GdkDevice
-#include <glib.h>     // for gint64
+#include <glib.h>     // for gint64, guint
 #include <gtk/gtk.h>  // for GtkWidget
 
 #include "InputEvents.h"  // for InputDeviceClass
@@ -86,6 +86,11 @@ private:
      */
     int disableTimeout = 500;
 
+    /**
+     * The timer enabling touch again, while touch is disabled
+     */
+    guint timeoutId = 0;
+
     /**
      * True if an X11 session is running
      */
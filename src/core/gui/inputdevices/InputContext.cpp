@@ -5,6 +5,7 @@
 #include "InputContext.h"
 
 #include <cstddef>  // for NULL
+#include <utility>  // for move, swap
 #include <vector>   // for vector
 
 #include <glib-object.h>  // for g_signal_hand...
@@ -12,6 +13,7 @@
 #include "control/Control.h"                            // for Control
 #include "control/DeviceListHelper.h"                   // for InputDevice
 #include "control/settings/Settings.h"                  // for Settings
+#include "gui/RepaintHandler.h"                         // for RepaintHandler
 #include "gui/XournalView.h"                            // for XournalView
 #include "gui/inputdevices/GeometryToolInputHandler.h"  // for GeometryToolInputHandler
 #include "gui/inputdevices/HandRecognition.h"           // for HandRecognition
@@ -25,8 +27,10 @@
 #include "util/glib_casts.h"  // for wrap_for_g_callback
 #include "util/gtk4_helper.h"
 
-#include "InputEvents.h"   // for InputEvent
-#include "config-debug.h"  // for DEBUG_INPUT
+#include "InputEvents.h"     // for InputEvent
+#include "InputRecording.h"  // for isRecording, record
+#include "InputReplay.h"     // for InputReplay
+#include "config-debug.h"    // for DEBUG_INPUT
 
 class ScrollHandling;
 class ToolHandler;
@@ -58,8 +62,13 @@ static gboolean keyboardCallback(GtkEventControllerKey* self, guint keyval, guin
 }
 
 InputContext::~InputContext() {
+    this->replay.reset();
+
     // Destructor is called in xournal_widget_dispose, so it can still accept events
     g_signal_handler_disconnect(this->widget, signal_id);
+    if (this->tickCallbackId != 0) {
+        gtk_widget_remove_tick_callback(this->widget, this->tickCallbackId);
+    }
 
     delete this->stylusHandler;
     this->stylusHandler = nullptr;
@@ -107,6 +116,8 @@ void InputContext::connect(GtkWidget* pWidget) {
 
 
     signal_id = g_signal_connect(pWidget, "event", xoj::util::wrap_for_g_callback_v<eventCallback>, this);
+
+    this->replay = InputReplay::fromEnvironment(this, pWidget);
 }
 
 auto InputContext::eventCallback(GtkWidget* widget, GdkEvent* event, InputContext* self) -> bool {
@@ -136,6 +147,48 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
         this->getSettings()->transactionEnd();
     }
 
+    if (xoj::input::isRecording()) {
+        xoj::input::record(event);
+    }
+
+    return process(std::move(event));
+}
+
+auto InputContext::process(InputEvent event) -> bool {
+    /*
+     * With event compression disabled, high-rate tablets send several motion events per frame.
+     * Those are processed together before the next frame, with a single repaint.
+     */
+    if (event.type == MOTION_EVENT &&
+        (event.deviceClass == INPUT_DEVICE_PEN || event.deviceClass == INPUT_DEVICE_ERASER)) {
+        this->pendingMotionEvents.emplace_back(std::move(event));
+        const auto& pending = this->pendingMotionEvents;
+        if (pending.back().timestamp - pending.front().timestamp >= MAX_PENDING_MOTION_SPAN) {
+            // No frame came in time (the main loop is busy, or the window is not drawn): do not hold the samples back
+            flushMotionEvents();
+        } else if (this->tickCallbackId == 0) {
+            this->tickCallbackId = gtk_widget_add_tick_callback(this->widget, tickCallback, this, nullptr);
+        }
+        return true;
+    }
+
+    // The other events must come after the pending motion events
+    flushMotionEvents();
+
+    return dispatch(event);
+}
+
+auto InputContext::dispatch(const InputEvent& event) -> bool {
+    if (!this->replay) {
+        return dispatchToHandlers(event);
+    }
+    const int64_t start = g_get_monotonic_time();
+    const bool handled = dispatchToHandlers(event);
+    this->replay->recordDispatch(g_get_monotonic_time() - start);
+    return handled;
+}
+
+auto InputContext::dispatchToHandlers(const InputEvent& event) -> bool {
     // We do not handle scroll events manually but let GTK do it for us
     if (event.type == SCROLL_EVENT) {
         // Hand over to standard GTK Scroll / Zoom handling
@@ -188,6 +241,26 @@ auto InputContext::handle(GdkEvent* sourceEvent) -> bool {
     return false;
 }
 
+void InputContext::flushMotionEvents() {
+    if (this->pendingMotionEvents.empty()) {
+        return;
+    }
+    std::vector<InputEvent> events;
+    std::swap(events, this->pendingMotionEvents);
+
+    RepaintHandler* repaintHandler = this->view->getRepaintHandler();
+    repaintHandler->beginBatch();
+    for (const InputEvent& event: events) { dispatch(event); }
+    repaintHandler->endBatch();
+}
+
+auto InputContext::tickCallback(GtkWidget*, GdkFrameClock*, gpointer self) -> gboolean {
+    auto* context = static_cast<InputContext*>(self);
+    context->tickCallbackId = 0;
+    context->flushMotionEvents();
+    return G_SOURCE_REMOVE;
+}
+
 auto InputContext::getXournal() -> GtkXournal* { return GTK_XOURNAL(widget); }
 
 auto InputContext::getView() -> XournalView* { return view; }
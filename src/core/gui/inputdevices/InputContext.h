@@ -15,6 +15,7 @@
 #include <memory>  // for unique_ptr
 #include <set>     // for set
 #include <string>  // for string
+#include <vector>  // for vector
 
 #include <gdk/gdk.h>  // for GdkEvent, GdkModifierType
 #include <glib.h>     // for gulong
@@ -22,7 +23,10 @@
 
 #include "gui/widgets/XournalWidget.h"  // for GtkXournal
 
+#include "InputEvents.h"  // for InputEvent
+
 class GeometryToolInputHandler;
+class InputReplay;
 class KeyboardInputHandler;
 class MouseInputHandler;
 class ScrollHandling;
@@ -52,6 +56,21 @@ private:
 
     std::set<std::string> knownDevices;
 
+    /**
+     * Motion events of the stylus received since the last frame, see flushMotionEvents()
+     */
+    std::vector<InputEvent> pendingMotionEvents;
+    guint tickCallbackId = 0;
+
+    /**
+     * The pending motion events are handled without waiting for the next frame once they span this duration (in ms,
+     * according to their timestamps), e.g. while the frame clock is stalled
+     */
+    static constexpr guint32 MAX_PENDING_MOTION_SPAN = 50;
+
+    /// The replay of a recording of input events, if asked for by the environment (see InputRecording.h)
+    std::unique_ptr<InputReplay> replay;
+
 public:
     enum DeviceType {
         MOUSE,
@@ -80,12 +99,37 @@ private:
      */
     bool handle(GdkEvent* event);
 
+    /**
+     * Pass the event to the appropriate handler, measuring the time it takes during a replay
+     * @param event The event to handle
+     * @return Whether the event was handled
+     */
+    bool dispatch(const InputEvent& event);
+    bool dispatchToHandlers(const InputEvent& event);
+
+    /**
+     * Handle the pending motion events of the stylus at once, before the next frame or the next other event.
+     * Every event is processed, for the fidelity of the strokes, but the areas they repaint are merged in one.
+     */
+    void flushMotionEvents();
+
+    /**
+     * Called by the frame clock before each frame where motion events are pending
+     */
+    static gboolean tickCallback(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+
     /**
      * Print debug output
      */
     void printDebug(GdkEvent* event);
 
 public:
+    /**
+     * Handle a translated event, received by the widget or replayed
+     * @return Whether the event was handled
+     */
+    bool process(InputEvent event);
+
     /**
      * Connect the input handling to the window to receive events
      */
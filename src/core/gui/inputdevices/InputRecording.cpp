@@ -0,0 +1,238 @@
+#include "InputRecording.h"
+
+#include <algorithm>  // for sort
+#include <cstdio>     // for snprintf
+#include <cstdint>    // for uintptr_t
+#include <fstream>    // for ofstream, ifstream
+#include <limits>     // for numeric_limits
+#include <locale>     // for locale
+#include <map>        // for map
+#include <mutex>      // for mutex, lock_guard
+#include <numeric>    // for accumulate
+#include <sstream>    // for istringstream
+#include <utility>    // for move
+
+#include <glib.h>  // for g_getenv, g_warning
+
+namespace xoj::input {
+
+namespace {
+auto readRecordFile() -> fs::path {
+    const char* value = g_getenv("XOURNALPP_INPUT_RECORD");
+    return value && *value ? fs::u8path(value) : fs::path();
+}
+
+struct Recorder {
+    std::mutex mutex;
+    std::ofstream out;
+    bool opened = false;
+    /// The touch sequences in progress, and their number in the recording
+    std::map<const GdkEventSequence*, int> sequences;
+    int lastSequence = 0;
+};
+
+auto recorder() -> Recorder& {
+    static Recorder r;
+    return r;
+}
+
+auto toGdkEventType(InputEventType type, bool touch) -> GdkEventType {
+    switch (type) {
+        case MOTION_EVENT:
+            return touch ? GDK_TOUCH_UPDATE : GDK_MOTION_NOTIFY;
+        case BUTTON_PRESS_EVENT:
+            return touch ? GDK_TOUCH_BEGIN : GDK_BUTTON_PRESS;
+        case BUTTON_2_PRESS_EVENT:
+            return GDK_2BUTTON_PRESS;
+        case BUTTON_3_PRESS_EVENT:
+            return GDK_3BUTTON_PRESS;
+        case BUTTON_RELEASE_EVENT:
+            return touch ? GDK_TOUCH_END : GDK_BUTTON_RELEASE;
+        case ENTER_EVENT:
+            return GDK_ENTER_NOTIFY;
+        case LEAVE_EVENT:
+            return GDK_LEAVE_NOTIFY;
+        case PROXIMITY_IN_EVENT:
+            return GDK_PROXIMITY_IN;
+        case PROXIMITY_OUT_EVENT:
+            return GDK_PROXIMITY_OUT;
+        case SCROLL_EVENT:
+            return GDK_SCROLL;
+        case GRAB_BROKEN_EVENT:
+            return GDK_GRAB_BROKEN;
+        case KEY_PRESS_EVENT:
+            return GDK_KEY_PRESS;
+        case KEY_RELEASE_EVENT:
+            return GDK_KEY_RELEASE;
+        default:
+            return GDK_NOTHING;
+    }
+}
+}  // namespace
+
+const fs::path recordFile = readRecordFile();
+
+void write(std::ostream& out, const RecordedEvent& e) {
+    // Enough digits for the positions to be read back exactly
+    const auto precision = out.precision(std::numeric_limits<double>::max_digits10);
+    out << static_cast<int>(e.type) << ' ' << static_cast<int>(e.deviceClass) << ' ' << e.absoluteX << ' '
+        << e.absoluteY << ' ' << e.relativeX << ' ' << e.relativeY << ' ' << e.button << ' ' << e.state << ' '
+        << e.pressure << ' ' << e.timestamp << ' ' << e.sequence << '\n';
+    out.precision(precision);
+}
+
+auto parse(const std::string& line) -> std::optional<RecordedEvent> {
+    std::istringstream iss(line);
+    iss.imbue(std::locale::classic());
+    RecordedEvent e;
+    int type = 0;
+    int deviceClass = 0;
+    if (!(iss >> type >> deviceClass >> e.absoluteX >> e.absoluteY >> e.relativeX >> e.relativeY >> e.button >>
+          e.state >> e.pressure >> e.timestamp >> e.sequence)) {
+        return std::nullopt;
+    }
+    if (type < UNKNOWN || type > KEY_RELEASE_EVENT || deviceClass < INPUT_DEVICE_MOUSE ||
+        deviceClass > INPUT_DEVICE_IGNORE) {
+        return std::nullopt;
+    }
+    e.type = static_cast<InputEventType>(type);
+    e.deviceClass = static_cast<InputDeviceClass>(deviceClass);
+    return e;
+}
+
+auto save(std::ostream& out, const std::vector<RecordedEvent>& events) -> bool {
+    out.imbue(std::locale::classic());
+    out << RECORDING_HEADER << '\n';
+    for (const RecordedEvent& e: events) { write(out, e); }
+    return static_cast<bool>(out);
+}
+
+auto save(const fs::path& file, const std::vector<RecordedEvent>& events) -> bool {
+    std::ofstream out(file);
+    if (!save(out, events)) {
+        g_warning("Could not write the input recording %s", file.u8string().c_str());
+        return false;
+    }
+    return true;
+}
+
+auto load(std::istream& in) -> std::optional<std::vector<RecordedEvent>> {
+    std::string line;
+    if (!std::getline(in, line) || line != RECORDING_HEADER) {
+        return std::nullopt;
+    }
+    std::vector<RecordedEvent> events;
+    while (std::getline(in, line)) {
+        if (auto e = parse(line)) {
+            events.push_back(*e);
+        }
+    }
+    return events;
+}
+
+auto load(const fs::path& file) -> std::optional<std::vector<RecordedEvent>> {
+    std::ifstream in(file);
+    auto events = load(in);
+    if (!events) {
+        g_warning("%s is not an input recording", file.u8string().c_str());
+    }
+    return events;
+}
+
+auto toInputEvent(const RecordedEvent& e, GdkDevice* device) -> InputEvent {
+    InputEvent event{};
+
+    // The handlers only check that there is a source event: a bare one of the right type is enough
+    GdkEvent* source = gdk_event_new(toGdkEventType(e.type, e.sequence != 0));
+    event.sourceEvent = source;
+    gdk_event_free(source);
+
+    event.type = e.type;
+    event.deviceClass = e.deviceClass;
+    event.deviceName = device ? gdk_device_get_name(device) : "";
+    event.deviceId = DeviceId(device);
+    event.absoluteX = e.absoluteX;
+    event.absoluteY = e.absoluteY;
+    event.relativeX = e.relativeX;
+    event.relativeY = e.relativeY;
+    event.button = e.button;
+    event.state = static_cast<GdkModifierType>(e.state);
+    event.pressure = e.pressure;
+    event.timestamp = e.timestamp;
+    // The sequences are opaque to the handlers, which only compare them: distinct dummy pointers will do
+    event.sequence = reinterpret_cast<GdkEventSequence*>(static_cast<uintptr_t>(e.sequence));
+    return event;
+}
+
+void record(const InputEvent& event) {
+    Recorder& r = recorder();
+    std::lock_guard lock(r.mutex);
+    if (!r.opened) {
+        r.opened = true;
+        r.out.open(recordFile);
+        r.out.imbue(std::locale::classic());
+        r.out << RECORDING_HEADER << '\n';
+    }
+    if (!r.out) {
+        return;
+    }
+
+    RecordedEvent e;
+    e.type = event.type;
+    e.deviceClass = event.deviceClass;
+    e.absoluteX = event.absoluteX;
+    e.absoluteY = event.absoluteY;
+    e.relativeX = event.relativeX;
+    e.relativeY = event.relativeY;
+    e.button = event.button;
+    e.state = static_cast<unsigned int>(event.state);
+    e.pressure = event.pressure;
+    e.timestamp = event.timestamp;
+    if (event.sequence) {
+        auto [it, added] = r.sequences.emplace(event.sequence, 0);
+        if (added) {
+            it->second = ++r.lastSequence;
+        }
+        e.sequence = it->second;
+        if (event.type == BUTTON_RELEASE_EVENT) {
+            // GDK may reuse the pointer for a later sequence
+            r.sequences.erase(it);
+        }
+    }
+    write(r.out, e);
+
+    if (event.type == BUTTON_RELEASE_EVENT) {
+        // Keep whole strokes on the disk, should the application not be closed properly
+        r.out.flush();
+    }
+    if (!r.out) {
+        g_warning("Could not write the input recording %s", recordFile.u8string().c_str());
+    }
+}
+
+auto summarize(std::vector<int64_t> samples) -> Distribution {
+    Distribution d;
+    if (samples.empty()) {
+        return d;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](size_t p) { return samples[(samples.size() - 1) * p / 100]; };
+    d.count = samples.size();
+    d.mean = static_cast<double>(std::accumulate(samples.begin(), samples.end(), int64_t{0})) /
+             static_cast<double>(samples.size());
+    d.p50 = percentile(50);
+    d.p90 = percentile(90);
+    d.p99 = percentile(99);
+    d.max = samples.back();
+    return d;
+}
+
+auto toString(const Distribution& d) -> std::string {
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "p50 %.2f ms  p90 %.2f ms  p99 %.2f ms  max %.2f ms  (%zu samples)",
+                  static_cast<double>(d.p50) / 1000.0, static_cast<double>(d.p90) / 1000.0,
+                  static_cast<double>(d.p99) / 1000.0, static_cast<double>(d.max) / 1000.0, d.count);
+    return buffer;
+}
+
+}  // namespace xoj::input
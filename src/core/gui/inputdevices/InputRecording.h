@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * Recordings of the input events, for the latency measurements
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <cstdint>   // for int64_t, uint32_t
+#include <iosfwd>    // for istream, ostream
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
+
+#include <gdk/gdk.h>  // for GdkDevice
+
+#include "InputEvents.h"  // for InputEvent, InputEventType, InputDeviceClass
+#include "filesystem.h"   // for path
+
+/**
+ * @brief Records the input events of the main view, so that the same strokes can be replayed to measure the input
+ * pipeline (InputContext -> PenInputHandler -> StrokeHandler -> painting of the overlay) and catch its regressions.
+ *
+ * Enabled by the environment variables:
+ *  - XOURNALPP_INPUT_RECORD: the path of the file the translated events received by the main view are written to,
+ *    one event per line (type, device class, positions, button, modifiers, pressure, timestamp and touch sequence)
+ *  - XOURNALPP_INPUT_REPLAY: the path of a recording, replayed against the main view once the window is shown (see
+ *    InputReplay). XOURNALPP_INPUT_REPLAY_SPEED is the speed factor of the replay: 1 (the default) keeps the
+ *    original timing, 0 sends the events as fast as the main loop allows.
+ *
+ * The recordings are replayed headlessly by the benchmarks (test/benchmarks/InputReplayBenchmark.cpp).
+ */
+namespace xoj::input {
+
+struct RecordedEvent {
+    InputEventType type{UNKNOWN};
+    InputDeviceClass deviceClass{INPUT_DEVICE_IGNORE};
+
+    double absoluteX{0};
+    double absoluteY{0};
+    double relativeX{0};
+    double relativeY{0};
+
+    unsigned int button{0};
+    unsigned int state{0};
+    double pressure{Point::NO_PRESSURE};
+    uint32_t timestamp{0};
+
+    /// Number of the touch sequence of the event in the recording, 0 if there is none
+    int sequence{0};
+};
+
+constexpr auto RECORDING_HEADER = "XOJ-INPUT-RECORDING/1.0";
+
+void write(std::ostream& out, const RecordedEvent& e);
+/// @return The event of a line written by write(), or nothing if the line is invalid
+std::optional<RecordedEvent> parse(const std::string& line);
+
+/// Write a recording, with its header. @return false on failure
+bool save(const fs::path& file, const std::vector<RecordedEvent>& events);
+bool save(std::ostream& out, const std::vector<RecordedEvent>& events);
+/// Read a recording. The invalid lines are skipped. @return nothing if the file is not a recording
+std::optional<std::vector<RecordedEvent>> load(const fs::path& file);
+std::optional<std::vector<RecordedEvent>> load(std::istream& in);
+
+/**
+ * @brief The event to replay, coming from `device` (which must outlive it)
+ * The touch sequences of the recording are mapped to distinct dummy sequences.
+ */
+InputEvent toInputEvent(const RecordedEvent& e, GdkDevice* device);
+
+/// The recording file, or an empty path if recording is disabled
+extern const fs::path recordFile;
+
+inline bool isRecording() { return !recordFile.empty(); }
+
+/// Append the event to the recording file
+void record(const InputEvent& event);
+
+/// Percentiles of a distribution of durations, in microseconds
+struct Distribution {
+    size_t count = 0;
+    double mean = 0;
+    int64_t p50 = 0;
+    int64_t p90 = 0;
+    int64_t p99 = 0;
+    int64_t max = 0;
+};
+
+Distribution summarize(std::vector<int64_t> samples);
+
+/// e.g. "p50 0.12 ms  p90 0.40 ms  p99 1.20 ms  max 3.00 ms  (1234 samples)"
+std::string toString(const Distribution& d);
+
+}  // namespace xoj::input
@@ -0,0 +1,158 @@
+#include "InputReplay.h"
+
+#include <algorithm>  // for max
+#include <cstdlib>    // for strtod
+#include <utility>    // for move
+
+#include <glib.h>  // for g_getenv, g_get_monotonic_time, g_message
+
+#include "InputContext.h"  // for InputContext
+
+InputReplay::InputReplay(InputContext* context, GtkWidget* widget, std::vector<xoj::input::RecordedEvent> events,
+                         double speed):
+        context(context), widget(widget), events(std::move(events)), speed(std::max(speed, 0.0)) {
+    GdkSeat* seat = gdk_display_get_default_seat(gtk_widget_get_display(widget));
+    this->device = seat ? gdk_seat_get_pointer(seat) : nullptr;
+}
+
+InputReplay::~InputReplay() {
+    if (this->mapHandler != 0) {
+        g_signal_handler_disconnect(this->widget, this->mapHandler);
+    }
+    if (this->sourceId != 0) {
+        g_source_remove(this->sourceId);
+    }
+    if (this->afterPaintHandler != 0) {
+        g_signal_handler_disconnect(this->frameClock, this->afterPaintHandler);
+    }
+}
+
+auto InputReplay::fromEnvironment(InputContext* context, GtkWidget* widget) -> std::unique_ptr<InputReplay> {
+    const char* file = g_getenv("XOURNALPP_INPUT_REPLAY");
+    if (!file || !*file) {
+        return nullptr;
+    }
+    auto events = xoj::input::load(fs::u8path(file));
+    if (!events || events->empty()) {
+        return nullptr;
+    }
+    const char* speedValue = g_getenv("XOURNALPP_INPUT_REPLAY_SPEED");
+    const double speed = speedValue && *speedValue ? std::strtod(speedValue, nullptr) : 1.0;
+
+    auto replay = std::make_unique<InputReplay>(context, widget, std::move(*events), speed);
+    replay->mapHandler = g_signal_connect(widget, "map", G_CALLBACK(mapCallback), replay.get());
+    return replay;
+}
+
+void InputReplay::mapCallback(GtkWidget*, gpointer self) {
+    auto* replay = static_cast<InputReplay*>(self);
+    if (replay->startTime == 0 && replay->sourceId == 0) {
+        replay->sourceId = g_timeout_add(START_DELAY, startCallback, self);
+    }
+}
+
+auto InputReplay::startCallback(gpointer self) -> gboolean {
+    auto* replay = static_cast<InputReplay*>(self);
+    replay->sourceId = 0;
+    replay->start();
+    return G_SOURCE_REMOVE;
+}
+
+void InputReplay::start() {
+    this->frameClock = gtk_widget_get_frame_clock(this->widget);
+    if (this->frameClock) {
+        this->afterPaintHandler =
+                g_signal_connect(this->frameClock, "after-paint", G_CALLBACK(afterPaintCallback), this);
+    }
+    g_message("input replay: %zu events at speed %.2f", this->events.size(), this->speed);
+
+    this->startTime = g_get_monotonic_time();
+    this->firstTimestamp = this->events.front().timestamp;
+    this->next = 0;
+    step();
+}
+
+auto InputReplay::dueTime(const xoj::input::RecordedEvent& e) const -> int64_t {
+    if (this->speed == 0) {
+        return this->startTime;
+    }
+    // The timestamps are in ms
+    const auto elapsed = static_cast<double>(e.timestamp - this->firstTimestamp) * 1000.0 / this->speed;
+    return this->startTime + static_cast<int64_t>(elapsed);
+}
+
+auto InputReplay::stepCallback(gpointer self) -> gboolean {
+    auto* replay = static_cast<InputReplay*>(self);
+    replay->sourceId = 0;
+    replay->step();
+    return G_SOURCE_REMOVE;
+}
+
+void InputReplay::step() {
+    const int64_t now = g_get_monotonic_time();
+    // One event per iteration at full speed, every due event otherwise
+    const size_t end = this->speed == 0 ? std::min(this->next + 1, this->events.size()) : this->events.size();
+    while (this->next < end && dueTime(this->events[this->next]) <= now) {
+        const xoj::input::RecordedEvent& recorded = this->events[this->next++];
+        InputEvent event = xoj::input::toInputEvent(recorded, this->device);
+        // The handlers use the timestamps (e.g. to batch the motion events): replay them on the current clock
+        event.timestamp = static_cast<guint32>((this->speed == 0 ? now : dueTime(recorded)) / 1000);
+        this->unpainted.push_back(g_get_monotonic_time());
+        this->context->process(std::move(event));
+    }
+    scheduleNextStep();
+}
+
+void InputReplay::scheduleNextStep() {
+    if (this->next >= this->events.size()) {
+        // The latencies of the last events are known after the next frame
+        gtk_widget_queue_draw(this->widget);
+        if (!this->frameClock) {
+            report();
+        }
+        return;
+    }
+    if (this->speed == 0) {
+        // Below the priority of the redraws, for the frames to be painted in between
+        this->sourceId = g_idle_add_full(G_PRIORITY_LOW, stepCallback, this, nullptr);
+        return;
+    }
+    const int64_t delay = std::max<int64_t>(0, dueTime(this->events[this->next]) - g_get_monotonic_time());
+    this->sourceId = g_timeout_add(static_cast<guint>(delay / 1000), stepCallback, this);
+}
+
+void InputReplay::afterPaintCallback(GdkFrameClock*, gpointer self) { static_cast<InputReplay*>(self)->afterPaint(); }
+
+void InputReplay::afterPaint() {
+    const int64_t now = g_get_monotonic_time();
+    for (int64_t sent: this->unpainted) { this->latencies.push_back(now - sent); }
+    this->unpainted.clear();
+
+    if (this->startTime != 0 && this->next >= this->events.size()) {
+        report();
+    }
+}
+
+void InputReplay::recordDispatch(int64_t duration) {
+    if (this->startTime != 0 && !this->reported) {
+        this->processingTimes.push_back(duration);
+    }
+}
+
+void InputReplay::report() {
+    if (this->reported) {
+        return;
+    }
+    this->reported = true;
+    if (this->afterPaintHandler != 0) {
+        g_signal_handler_disconnect(this->frameClock, this->afterPaintHandler);
+        this->afterPaintHandler = 0;
+    }
+
+    const double seconds = static_cast<double>(g_get_monotonic_time() - this->startTime) / 1e6;
+    const auto processing = xoj::input::toString(xoj::input::summarize(std::move(this->processingTimes)));
+    const auto latency = xoj::input::toString(xoj::input::summarize(std::move(this->latencies)));
+    g_message("input replay: %zu events in %.2f s", this->events.size(), seconds);
+    g_message("input replay: processing %s", processing.c_str());
+    g_message("input replay: latency    %s", latency.c_str());
+}
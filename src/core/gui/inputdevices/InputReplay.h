@@ -0,0 +1,90 @@
+/*
+ * Xournal++
+ *
+ * Replays a recording of input events against the main view
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t, uint32_t
+#include <memory>   // for unique_ptr
+#include <vector>   // for vector
+
+#include <gtk/gtk.h>  // for GtkWidget, GdkFrameClock, GdkDevice
+
+#include "InputRecording.h"  // for RecordedEvent
+
+class InputContext;
+
+/**
+ * @brief Sends the events of a recording (see InputRecording.h) to the InputContext of the main view, at the original
+ * timing times a speed factor, and measures the pipeline: the time to process each event, and the latency from the
+ * event to the end of the next frame. The distributions are logged when the replay is over.
+ */
+class InputReplay {
+public:
+    /**
+     * @param speed Speed factor of the replay. If 0, the events are sent as fast as the main loop allows, one per
+     * iteration, so that the frames are still painted.
+     */
+    InputReplay(InputContext* context, GtkWidget* widget, std::vector<xoj::input::RecordedEvent> events, double speed);
+    ~InputReplay();
+
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    /// The replay asked for by XOURNALPP_INPUT_REPLAY, if any. It starts once the widget is shown.
+    static std::unique_ptr<InputReplay> fromEnvironment(InputContext* context, GtkWidget* widget);
+
+    /// Start replaying
+    void start();
+
+    /// An event (replayed or not) was dispatched to the input handlers in `duration` us
+    void recordDispatch(int64_t duration);
+
+    /// Time between the widget being shown and the start of the replay, so that the document is loaded and laid out
+    static constexpr guint START_DELAY = 1000;
+
+private:
+    static void mapCallback(GtkWidget* widget, gpointer self);
+    static gboolean startCallback(gpointer self);
+    static gboolean stepCallback(gpointer self);
+    static void afterPaintCallback(GdkFrameClock* clock, gpointer self);
+
+    /// Time (in us, from g_get_monotonic_time()) at which the event should be sent
+    int64_t dueTime(const xoj::input::RecordedEvent& e) const;
+
+    void step();
+    void scheduleNextStep();
+    void afterPaint();
+    void report();
+
+private:
+    InputContext* context;
+    GtkWidget* widget;
+    GdkDevice* device = nullptr;
+
+    std::vector<xoj::input::RecordedEvent> events;
+    size_t next = 0;
+    double speed;
+
+    int64_t startTime = 0;
+    uint32_t firstTimestamp = 0;
+
+    gulong mapHandler = 0;
+    guint sourceId = 0;
+    GdkFrameClock* frameClock = nullptr;
+    gulong afterPaintHandler = 0;
+
+    /// When the events sent since the last frame were sent
+    std::vector<int64_t> unpainted;
+    std::vector<int64_t> processingTimes;
+    std::vector<int64_t> latencies;
+    bool reported = false;
+};
@@ -12,6 +12,7 @@
 #include <glib.h>     // for gdouble, gint, g_message
 #include <gtk/gtk.h>  // for gtk_adjustment_get_value
 
+#include "control/PerfStats.h"                  // for isEnabled, recordInput
 #include "control/ToolEnums.h"                  // for TOOL_HAND, TOOL_IMAGE
 #include "control/ToolHandler.h"                // for ToolHandler
 #include "control/settings/Settings.h"          // for Settings
@@ -81,6 +82,9 @@ void PenInputHandler::handleScrollEvent(InputEvent const& event) {
 }
 
 auto PenInputHandler::actionStart(InputEvent const& event) -> bool {
+    if (xoj::perf::isEnabled()) {
+        xoj::perf::recordInput();
+    }
     this->inputContext->focusWidget();
 
     this->lastActionStartTimeStamp = event.timestamp;
@@ -264,6 +268,9 @@ bool PenInputHandler::isCurrentTapSelection(InputEvent const& event) const {
 }
 
 auto PenInputHandler::actionMotion(InputEvent const& event) -> bool {
+    if (xoj::perf::isEnabled()) {
+        xoj::perf::recordInput();
+    }
     /*
      * Workaround for misbehaving devices where Enter events are not published every time
      * This is required to disable outside scrolling again
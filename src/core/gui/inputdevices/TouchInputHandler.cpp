@@ -14,11 +14,23 @@
 #include "gui/XournalView.h"                        // for XournalView
 #include "gui/inputdevices/AbstractInputHandler.h"  // for AbstractInputHandler
 #include "gui/inputdevices/InputEvents.h"           // for InputEvent, BUTTO...
+#include "gui/scroll/KineticScroller.h"             // for KineticScroller
+#include "gui/widgets/XournalWidget.h"              // for GtkXournal
 
 #include "InputContext.h"  // for InputContext
 
 TouchInputHandler::TouchInputHandler(InputContext* inputContext): AbstractInputHandler(inputContext) {}
 
+TouchInputHandler::~TouchInputHandler() = default;
+
+auto TouchInputHandler::getScroller() -> KineticScroller* {
+    if (!this->scroller) {
+        auto* layout = inputContext->getView()->getControl()->getWindow()->getLayout();
+        this->scroller = std::make_unique<KineticScroller>(GTK_WIDGET(inputContext->getXournal()), layout);
+    }
+    return this->scroller.get();
+}
+
 auto TouchInputHandler::handleImpl(InputEvent const& event) -> bool {
     bool zoomGesturesEnabled = inputContext->getSettings()->isZoomGesturesEnabled();
 
@@ -33,6 +45,9 @@ auto TouchInputHandler::handleImpl(InputEvent const& event) -> bool {
         if (this->primarySequence == nullptr && this->secondarySequence == nullptr) {
             this->primarySequence = event.sequence;
 
+            // Touching the screen stops a fling
+            getScroller()->stop();
+
             // Set sequence data
             sequenceStart(event);
         }
@@ -40,6 +55,7 @@ auto TouchInputHandler::handleImpl(InputEvent const& event) -> bool {
         else if (this->primarySequence && this->primarySequence != event.sequence &&
                  this->secondarySequence == nullptr) {
             this->secondarySequence = event.sequence;
+            getScroller()->stop();
 
             // Even if zoom gestures are disabled,
             // this is still the start of a sequence.
@@ -74,6 +90,10 @@ auto TouchInputHandler::handleImpl(InputEvent const& event) -> bool {
             zoomEnd();
         }
 
+        if (event.sequence == this->primarySequence && this->secondarySequence == nullptr) {
+            getScroller()->release(event.timestamp, inputContext->getSettings()->isTouchKineticScrolling());
+        }
+
         if (event.sequence == this->primarySequence) {
             // If secondarySequence is nullptr, this sets primarySequence
             // to nullptr. If it isn't, then it is now the primary sequence!
@@ -115,9 +135,8 @@ void TouchInputHandler::scrollMotion(InputEvent const& event) {
         }
     }();
 
-    auto* layout = inputContext->getView()->getControl()->getWindow()->getLayout();
-
-    layout->scrollRelative(-offset.x, -offset.y);
+    // Applied at the next frame, with the other motions until then
+    getScroller()->move(-offset.x, -offset.y, event.timestamp);
 }
 
 void TouchInputHandler::zoomStart() {
@@ -188,6 +207,10 @@ void TouchInputHandler::zoomEnd() {
 }
 
 void TouchInputHandler::onUnblock() {
+    if (this->scroller) {
+        this->scroller->stop();
+    }
+
     this->primarySequence = nullptr;
     this->secondarySequence = nullptr;
 
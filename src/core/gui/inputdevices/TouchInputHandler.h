@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <memory>  // for unique_ptr
+
 #include <gdk/gdk.h>  // for GdkEventSequence
 
 #include "util/Point.h"  // for Point
@@ -18,6 +20,7 @@
 #include "AbstractInputHandler.h"  // for AbstractInputHandler
 
 class InputContext;
+class KineticScroller;
 struct InputEvent;
 
 class TouchInputHandler: public AbstractInputHandler {
@@ -39,7 +42,11 @@ private:
 
     bool canBlockZoom{false};
 
+    /// Applies the scroll motions once per frame, and flings
+    std::unique_ptr<KineticScroller> scroller;
+
 private:
+    KineticScroller* getScroller();
     void sequenceStart(InputEvent const& event);
     void scrollMotion(InputEvent const& event);
     void zoomStart();
@@ -48,7 +55,7 @@ private:
 
 public:
     explicit TouchInputHandler(InputContext* inputContext);
-    ~TouchInputHandler() override = default;
+    ~TouchInputHandler() override;
 
     bool handleImpl(InputEvent const& event) override;
     void onUnblock() override;
@@ -47,11 +47,18 @@ static void removeItemsWithClass(GMenu* menu, const char* classname) {
 void Menubar::populate(const GladeSearchpath* gladeSearchPath, MainWindow* win) {
     builder.reset(gtk_builder_new(), xoj::util::adopt);
 
-    auto filepath = gladeSearchPath->findFile("", MENU_XML_FILE);
     GError* error = nullptr;
+    std::string source = GladeSearchpath::findResource(MENU_XML_FILE);
+    bool loaded = false;
+    if (!source.empty()) {
+        loaded = gtk_builder_add_from_resource(builder.get(), source.c_str(), &error);
+    } else {
+        source = gladeSearchPath->findFile("", MENU_XML_FILE).u8string();
+        loaded = gtk_builder_add_from_file(builder.get(), source.c_str(), &error);
+    }
 
-    if (!gtk_builder_add_from_file(builder.get(), filepath.u8string().c_str(), &error)) {
-        std::string msg = FS(_F("Error loading menubar XML file (try to load \"{1}\")") % filepath.u8string());
+    if (!loaded) {
+        std::string msg = FS(_F("Error loading menubar XML file (try to load \"{1}\")") % source);
 
         if (error != nullptr) {
             msg += "\n";
@@ -78,7 +85,7 @@ void Menubar::populate(const GladeSearchpath* gladeSearchPath, MainWindow* win)
 
     forEachSubmenu([&](auto& subm) { subm.addToMenubar(*this); });
 
-    if (!ctrl->getAudioController()) {
+    if (!ctrl->isAudioEnabled()) {
         removeItemsWithClass(G_MENU(menu), "audio");
     }
 
@@ -121,12 +121,24 @@ PageTypeSelectionPopover::PageTypeSelectionPopover(PageTypeHandler* typesHandler
 GtkWidget* PageTypeSelectionPopover::createPopover() const {
     GtkWidget* popover = gtk_popover_new();
 
+    // The previews of the page types are only rendered when the popover is opened for the first time
+    g_signal_connect(popover, "show", G_CALLBACK(+[](GtkWidget* popover, gpointer d) {
+                         if (!gtk_popover_get_child(GTK_POPOVER(popover))) {
+                             static_cast<const PageTypeSelectionPopover*>(d)->fillPopover(GTK_POPOVER(popover));
+                         }
+                     }),
+                     const_cast<PageTypeSelectionPopover*>(this));
+
+    return popover;
+}
+
+void PageTypeSelectionPopover::fillPopover(GtkPopover* popover) const {
     // Todo(cpp20): constexpr this
     std::string prefixedActionName = G_ACTION_NAMESPACE;
     prefixedActionName += SELECTION_ACTION_NAME;
 
     GtkBox* box = GTK_BOX(gtk_box_new(GTK_ORIENTATION_VERTICAL, 0));
-    gtk_popover_set_child(GTK_POPOVER(popover), GTK_WIDGET(box));
+    gtk_popover_set_child(popover, GTK_WIDGET(box));
 
     gtk_box_append(box, createPreviewGrid(types->getPageTypes(), prefixedActionName));
     gtk_box_append(box, gtk_separator_new(GTK_ORIENTATION_HORIZONTAL));
@@ -186,8 +198,6 @@ GtkWidget* PageTypeSelectionPopover::createPopover() const {
     gtk_box_append(box, button);
 
     gtk_widget_show_all(GTK_WIDGET(box));
-
-    return popover;
 }
 
 void PageTypeSelectionPopover::entrySelected(const PageTypeInfo*) {
@@ -14,7 +14,7 @@
 #include <memory>
 #include <vector>  // for vector
 
-#include <gtk/gtk.h>  // for GtkWidget
+#include <gtk/gtk.h>  // for GtkWidget, GtkPopover
 
 #include "gui/PopoverFactory.h"
 #include "gui/menus/PageTypeSelectionMenuBase.h"
@@ -37,6 +37,9 @@ public:
 private:
     void entrySelected(const PageTypeInfo* info) override;
 
+    /// Build the content of the popover (with a preview of each page type)
+    void fillPopover(GtkPopover* popover) const;
+
 private:
     PageBackgroundChangeController* controller;
 };
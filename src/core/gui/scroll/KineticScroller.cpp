@@ -0,0 +1,119 @@
+#include "KineticScroller.h"
+
+#include <algorithm>  // for clamp, min
+#include <cmath>      // for exp, abs, hypot
+
+#include <glib.h>  // for g_get_monotonic_time, G_USEC_PER_SEC
+
+#include "gui/Layout.h"      // for Layout
+#include "util/Rectangle.h"  // for Rectangle
+
+namespace {
+/// The speed of the finger is measured over its last moves within this time (in ms)
+constexpr guint32 VELOCITY_WINDOW = 100;
+/// No fling if the finger stood still for longer than this (in ms) before leaving the screen
+constexpr guint32 MAX_IDLE_BEFORE_RELEASE = 50;
+/// Slower releases do not fling (in pixels per second)
+constexpr double MIN_FLING_VELOCITY = 200;
+constexpr double MAX_FLING_VELOCITY = 8000;
+/// The fling stops below this speed (in pixels per second)
+constexpr double STOP_VELOCITY = 20;
+/// Rate of the exponential slowdown of the fling, per second
+constexpr double DECELERATION = 3.5;
+}  // namespace
+
+KineticScroller::KineticScroller(GtkWidget* widget, Layout* layout): widget(widget), layout(layout) {}
+
+KineticScroller::~KineticScroller() {
+    if (this->tickCallbackId != 0) {
+        gtk_widget_remove_tick_callback(this->widget, this->tickCallbackId);
+    }
+}
+
+void KineticScroller::move(double dx, double dy, guint32 time) {
+    this->velocityX = this->velocityY = 0;
+    this->pendingX += dx;
+    this->pendingY += dy;
+
+    this->totalX += dx;
+    this->totalY += dy;
+    this->samples.push_back({time, this->totalX, this->totalY});
+    while (time - this->samples.front().time > VELOCITY_WINDOW) {
+        this->samples.pop_front();
+    }
+    scheduleTick();
+}
+
+void KineticScroller::release(guint32 time, bool fling) {
+    const bool moving = this->samples.size() >= 2 && time - this->samples.back().time <= MAX_IDLE_BEFORE_RELEASE;
+    if (fling && moving) {
+        const Sample& first = this->samples.front();
+        const Sample& last = this->samples.back();
+        const double dt = static_cast<double>(last.time - first.time) / 1000;
+        if (dt > 0) {
+            double vx = (last.x - first.x) / dt;
+            double vy = (last.y - first.y) / dt;
+            const double speed = std::hypot(vx, vy);
+            if (speed >= MIN_FLING_VELOCITY) {
+                const double scale = std::min(speed, MAX_FLING_VELOCITY) / speed;
+                this->velocityX = vx * scale;
+                this->velocityY = vy * scale;
+                this->lastFrameTime = g_get_monotonic_time();
+                // The fling covers v / DECELERATION in total: the pages at its end are needed soon
+                this->layout->prefetchScrollTarget(this->velocityX / DECELERATION, this->velocityY / DECELERATION);
+                scheduleTick();
+            }
+        }
+    }
+    this->samples.clear();
+}
+
+void KineticScroller::stop() {
+    this->velocityX = this->velocityY = 0;
+    this->samples.clear();
+}
+
+void KineticScroller::scheduleTick() {
+    if (this->tickCallbackId == 0) {
+        this->tickCallbackId = gtk_widget_add_tick_callback(this->widget, tick, this, nullptr);
+    }
+}
+
+auto KineticScroller::tick(GtkWidget*, GdkFrameClock* clock, gpointer self) -> gboolean {
+    auto* scroller = static_cast<KineticScroller*>(self);
+
+    const bool flinging = scroller->velocityX != 0 || scroller->velocityY != 0;
+    if (flinging) {
+        const gint64 frameTime = gdk_frame_clock_get_frame_time(clock);
+        const double dt = std::clamp(static_cast<double>(frameTime - scroller->lastFrameTime) / G_USEC_PER_SEC, 0.0,
+                                     0.1);  // after a stall, do not jump
+        scroller->lastFrameTime = frameTime;
+        // The distance covered by the exponentially decreasing speed during dt
+        const double decay = std::exp(-DECELERATION * dt);
+        scroller->pendingX += scroller->velocityX * (1 - decay) / DECELERATION;
+        scroller->pendingY += scroller->velocityY * (1 - decay) / DECELERATION;
+        scroller->velocityX *= decay;
+        scroller->velocityY *= decay;
+    }
+
+    if (scroller->pendingX != 0 || scroller->pendingY != 0) {
+        const auto before = scroller->layout->getVisibleRect();
+        scroller->layout->scrollRelative(scroller->pendingX, scroller->pendingY);
+        const auto after = scroller->layout->getVisibleRect();
+        // Stop the fling along the axes where the view stopped at an edge
+        if (std::abs(after.x - before.x) < std::abs(scroller->pendingX) - 0.5) {
+            scroller->velocityX = 0;
+        }
+        if (std::abs(after.y - before.y) < std::abs(scroller->pendingY) - 0.5) {
+            scroller->velocityY = 0;
+        }
+        scroller->pendingX = scroller->pendingY = 0;
+    }
+
+    if (std::hypot(scroller->velocityX, scroller->velocityY) >= STOP_VELOCITY) {
+        return G_SOURCE_CONTINUE;
+    }
+    scroller->velocityX = scroller->velocityY = 0;
+    scroller->tickCallbackId = 0;
+    return G_SOURCE_REMOVE;
+}
@@ -0,0 +1,78 @@
+/*
+ * Xournal++
+ *
+ * Touch scrolling applied once per frame, with flings
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <deque>  // for deque
+
+#include <gtk/gtk.h>  // for GtkWidget, GdkFrameClock
+
+class Layout;
+
+/**
+ * The touch motions add up until the next frame, where they scroll the view at once: the visibility of the pages is
+ * updated once per frame, however many events came in between.
+ *
+ * When the finger leaves the screen while moving, the view keeps scrolling at the speed of the finger, slowing down
+ * exponentially, and the pages where the scrolling will stop are prefetched.
+ */
+class KineticScroller {
+public:
+    KineticScroller(GtkWidget* widget, Layout* layout);
+    ~KineticScroller();
+
+    KineticScroller(const KineticScroller&) = delete;
+    KineticScroller& operator=(const KineticScroller&) = delete;
+
+    /**
+     * Scroll by (dx, dy) at the next frame
+     * @param time The time of the event, in milliseconds
+     */
+    void move(double dx, double dy, guint32 time);
+
+    /**
+     * The finger left the screen: fling at its last speed if `fling`
+     */
+    void release(guint32 time, bool fling);
+
+    /**
+     * Stop the fling, if any. What was moved but not yet applied is still scrolled.
+     */
+    void stop();
+
+private:
+    static gboolean tick(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+    void scheduleTick();
+
+    GtkWidget* widget;
+    Layout* layout;
+    guint tickCallbackId = 0;
+
+    /// Not yet applied
+    double pendingX = 0;
+    double pendingY = 0;
+
+    /// The recent positions of the finger, summing the moves, for its speed at the release
+    struct Sample {
+        guint32 time;
+        double x;
+        double y;
+    };
+    std::deque<Sample> samples;
+    double totalX = 0;
+    double totalY = 0;
+
+    /// In pixels per second, 0 when not flinging
+    double velocityX = 0;
+    double velocityY = 0;
+    /// Frame time of the last step of the fling, in microseconds
+    gint64 lastFrameTime = 0;
+};
@@ -11,6 +11,8 @@ void AbstractSidebarPage::selectPageNr(size_t page, size_t pdfPage) {}
 
 auto AbstractSidebarPage::getControl() -> Control* { return this->control; }
 
+auto AbstractSidebarPage::getMemoryUsage() -> size_t { return 0; }
+
 void AbstractSidebarPage::setTmpDisabled(bool disabled) {
     GdkCursor* cursor = nullptr;
     if (disabled) {
@@ -51,6 +51,11 @@ public:
      */
     virtual GtkWidget* getWidget() = 0;
 
+    /**
+     * The memory (in bytes) used by the buffers of this sidebar page, e.g. by its previews
+     */
+    virtual size_t getMemoryUsage();
+
     /**
      * Temporary disable Sidebar (e.g. while saving)
      */
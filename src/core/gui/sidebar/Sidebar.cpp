@@ -146,6 +146,14 @@ size_t Sidebar::getSelectedTab() const { return this->currentTabIdx; }
 
 auto Sidebar::getControl() -> Control* { return this->control; }
 
+auto Sidebar::getMemoryUsage() -> size_t {
+    size_t usage = 0;
+    for (auto& tab: this->tabs) {
+        usage += tab->getMemoryUsage();
+    }
+    return usage;
+}
+
 void Sidebar::documentChanged(DocumentChangeType type) {
     if (type == DOCUMENT_CHANGE_CLEARED || type == DOCUMENT_CHANGE_COMPLETE || type == DOCUMENT_CHANGE_PDF_BOOKMARKS) {
         updateVisibleTabs();
@@ -78,6 +78,11 @@ public:
      */
     void setSelectedTab(size_t tab);
 
+    /**
+     * @return The memory (in bytes) used by the buffers of all the tabs, e.g. by the previews
+     */
+    size_t getMemoryUsage();
+
 public:
     // DocumentListener interface
     void documentChanged(DocumentChangeType type) override;
@@ -55,6 +55,8 @@ SidebarIndexPage::SidebarIndexPage(Control* control):
 
     this->selectHandler = g_signal_connect(treeViewBookmarks, "cursor-changed", G_CALLBACK(treeBookmarkSelected), this);
     xoj_assert(this->selectHandler != 0);
+    this->expandHandler = g_signal_connect(treeViewBookmarks, "test-expand-row", G_CALLBACK(treeRowExpanding), this);
+    xoj_assert(this->expandHandler != 0);
 
     gtk_widget_show(this->treeViewBookmarks);
 
@@ -99,7 +101,9 @@ auto SidebarIndexPage::treeBookmarkSelected(GtkWidget* treeview, SidebarIndexPag
 
                 sidebar->control->getScrollHandler()->scrollToLinkDest(*dest);
             }
-            g_object_unref(link);
+            if (link) {
+                g_object_unref(link);
+            }
 
             return true;
         }
@@ -107,6 +111,15 @@ auto SidebarIndexPage::treeBookmarkSelected(GtkWidget* treeview, SidebarIndexPag
     return false;
 }
 
+auto SidebarIndexPage::treeRowExpanding(GtkTreeView* treeview, GtkTreeIter* iter, GtkTreePath* path,
+                                        SidebarIndexPage* sidebar) -> gboolean {
+    Document* doc = sidebar->control->getDocument();
+    doc->lock();
+    doc->loadContentsChildren(gtk_tree_view_get_model(treeview), iter);
+    doc->unlock();
+    return false;  // Let the row expand
+}
+
 auto SidebarIndexPage::searchTimeoutFunc(SidebarIndexPage* sidebar) -> bool {
     sidebar->searchTimeout = 0;
 
@@ -189,6 +202,9 @@ auto SidebarIndexPage::expandOpenLinks(GtkTreeModel* model, GtkTreeIter* parent)
     if (gtk_tree_model_iter_children(model, &iter, parent)) {
         do {
             gtk_tree_model_get(model, &iter, DOCUMENT_LINKS_COLUMN_LINK, &link, -1);
+            if (link == nullptr) {
+                continue;  // The placeholder of rows not loaded yet
+            }
 
             if (link->dest->getExpand()) {
                 GtkTreePath* path = gtk_tree_model_get_path(model, &iter);
@@ -246,7 +262,9 @@ auto SidebarIndexPage::selectPageNr(size_t page, size_t pdfPage, GtkTreeIter* pa
                 }
             }
 
-            g_object_unref(link);
+            if (link) {
+                g_object_unref(link);
+            }
         }
     }
 
@@ -256,6 +274,11 @@ auto SidebarIndexPage::selectPageNr(size_t page, size_t pdfPage, GtkTreeIter* pa
         XojLinkDest* link = nullptr;
 
         gtk_tree_model_get(model, &iter, DOCUMENT_LINKS_COLUMN_LINK, &link, -1);
+        if (link == nullptr) {
+            // The placeholder of rows not loaded yet
+            valid = gtk_tree_model_iter_next(model, &iter);
+            continue;
+        }
 
         if (link->dest->getPdfPage() == pdfPage) {
             GtkTreeSelection* selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(treeViewBookmarks));
@@ -289,15 +312,17 @@ void SidebarIndexPage::documentChanged(DocumentChangeType type) {
 
         Document* doc = this->control->getDocument();
 
-        //  Block the cursor-change signal when the document changes, otherwise
-        //  there will be a deadlock: both the selectHandler and this code will
-        //  lock the document.
+        //  Block the cursor-change and the expansion signals when the document
+        //  changes, otherwise there will be a deadlock: both the handlers and
+        //  this code will lock the document.
         g_signal_handler_block(this->treeViewBookmarks, this->selectHandler);
+        g_signal_handler_block(this->treeViewBookmarks, this->expandHandler);
         doc->lock();
         GtkTreeModel* model = doc->getContentsModel();
         gtk_tree_view_set_model(GTK_TREE_VIEW(this->treeViewBookmarks), model);
         int count = expandOpenLinks(model, nullptr);
         doc->unlock();
+        g_signal_handler_unblock(this->treeViewBookmarks, this->expandHandler);
         g_signal_handler_unblock(this->treeViewBookmarks, this->selectHandler);
         this->treeBookmarkSelected(this->treeViewBookmarks, this);
 
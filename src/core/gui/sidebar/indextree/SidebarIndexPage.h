@@ -82,6 +82,12 @@ private:
      */
     static auto treeBookmarkSelected(GtkWidget* treeview, SidebarIndexPage* sidebar) -> bool;
 
+    /**
+     * A row is about to be expanded: load its children (see Document::loadContentsChildren)
+     */
+    static gboolean treeRowExpanding(GtkTreeView* treeview, GtkTreeIter* iter, GtkTreePath* path,
+                                     SidebarIndexPage* sidebar);
+
     /**
      * The function which is called after a search timeout
      */
@@ -109,6 +115,7 @@ private:
      * method for why this is necessary.
      */
     unsigned long selectHandler = 0;  // g_signal_connect uses 0 as error value
+    unsigned long expandHandler = 0;
 
     /**
      * If currently searching, scroll to the page is disable, else search is not really working
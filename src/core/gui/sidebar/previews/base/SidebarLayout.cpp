@@ -1,16 +1,20 @@
 #include "SidebarLayout.h"
 
 #include <algorithm>  // for max
+#include <cstddef>    // for size_t
 #include <vector>     // for vector
 
 #include <gtk/gtk.h>  // for GTK_FIXED, gtk_fixed_move
 
+#include "util/Rectangle.h"  // for Rectangle
 #include "util/gtk4_helper.h"
 #include "util/safe_casts.h"  // for as_unsigned
 
 #include "SidebarPreviewBase.h"       // for SidebarPreviewBase
 #include "SidebarPreviewBaseEntry.h"  // for SidebarPreviewBaseEntry
 
+using xoj::util::Rectangle;
+
 class SidebarRow {
 public:
     explicit SidebarRow(int width) {
@@ -21,20 +25,20 @@ public:
     ~SidebarRow() { clear(); }
 
 
-    auto isSpaceFor(SidebarPreviewBaseEntry* p) -> bool {
+    auto isSpaceFor(int entryWidth) -> bool {
         if (this->list.empty()) {
             return true;
         }
 
-        if (this->currentWidth + p->getWidth() < width) {
+        if (this->currentWidth + entryWidth < width) {
             return true;
         }
         return false;
     }
 
-    void add(SidebarPreviewBaseEntry* p) {
-        this->list.push_back(p);
-        this->currentWidth += p->getWidth();
+    void add(size_t index, int entryWidth, int entryHeight) {
+        this->list.push_back({index, entryWidth, entryHeight});
+        this->currentWidth += entryWidth;
     }
 
     void clear() {
@@ -46,19 +50,19 @@ public:
 
     auto getWidth() const -> int { return this->currentWidth; }
 
-    auto placeAt(int y, GtkFixed* layout) -> int {
+    auto placeAt(int y, std::vector<Rectangle<int>>& positions) -> int {
         int height = 0;
         int x = 0;
 
-        for (SidebarPreviewBaseEntry* p: this->list) { height = std::max(height, p->getHeight()); }
+        for (const Entry& e: this->list) { height = std::max(height, e.height); }
 
 
-        for (SidebarPreviewBaseEntry* p: this->list) {
-            int currentY = (height - p->getHeight()) / 2;
+        for (const Entry& e: this->list) {
+            int currentY = (height - e.height) / 2;
 
-            gtk_fixed_move(layout, p->getWidget(), x, y + currentY);
+            positions[e.index] = Rectangle<int>(x, y + currentY, e.width, e.height);
 
-            x += p->getWidth();
+            x += e.width;
         }
 
 
@@ -66,10 +70,16 @@ public:
     }
 
 private:
+    struct Entry {
+        size_t index;
+        int width;
+        int height;
+    };
+
     int width;
     int currentWidth;
 
-    std::vector<SidebarPreviewBaseEntry*> list;
+    std::vector<Entry> list;
 };
 
 void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
@@ -81,27 +91,39 @@ void SidebarLayout::layout(SidebarPreviewBase* sidebar) {
     SidebarRow row(sidebarWidth);
     GtkFixed* w = sidebar->miniaturesContainer.get();
 
-    for (auto& p: sidebar->previews) {
-        if (row.isSpaceFor(p.get())) {
-            row.add(p.get());
+    // Only the positions are computed here: the entries may not be created yet
+    auto& positions = sidebar->entryPositions;
+    positions.assign(sidebar->previews.size(), Rectangle<int>());
+
+    for (size_t i = 0; i < sidebar->previews.size(); i++) {
+        auto [entryWidth, entryHeight] = sidebar->getEntrySize(i);
+        if (row.isSpaceFor(entryWidth)) {
+            row.add(i, entryWidth, entryHeight);
         } else {
-            y += row.placeAt(y, w);
+            y += row.placeAt(y, positions);
 
             width = std::max(width, row.getWidth());
 
             row.clear();
-            row.add(p.get());
+            row.add(i, entryWidth, entryHeight);
         }
     }
 
     if (row.getCount() != 0) {
-        y += row.placeAt(y, w);
+        y += row.placeAt(y, positions);
 
         width = std::max(width, row.getWidth());
 
         row.clear();
     }
 
+    for (size_t i = 0; i < sidebar->previews.size(); i++) {
+        if (auto& p = sidebar->previews[i]) {
+            gtk_fixed_move(w, p->getWidget(), positions[i].x, positions[i].y);
+        }
+    }
+
     gtk_widget_set_size_request(GTK_WIDGET(w), width, y);
+    sidebar->updateVisibleEntries(true);
     gtk_widget_show_all(GTK_WIDGET(w));
 }
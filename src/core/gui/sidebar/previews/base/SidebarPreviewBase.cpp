@@ -1,17 +1,19 @@
 #include "SidebarPreviewBase.h"
 
-#include <cstdlib>  // for abs, size_t
+#include <algorithm>  // for partition_point, min
+#include <cstdlib>    // for abs, size_t
+#include <utility>    // for move, pair
 
 #include <glib-object.h>  // for g_object_ref, G_CALLBACK, g_sig...
 #include <glib.h>         // for g_idle_add
 
-#include "control/Control.h"   // for Control
-#include "control/PdfCache.h"  // for PdfCache
-#include "gui/Builder.h"       // for Builder
-#include "gui/MainWindow.h"    // for MainWindow
-#include "model/Document.h"    // for Document
-#include "util/Util.h"         // for npos
-#include "util/glib_casts.h"   // for wrap_for_once_v
+#include "control/Control.h"         // for Control
+#include "control/ThumbnailCache.h"  // for ThumbnailCache
+#include "gui/Builder.h"             // for Builder
+#include "gui/MainWindow.h"          // for MainWindow
+#include "gui/XournalView.h"         // for XournalView
+#include "util/Util.h"               // for npos
+#include "util/glib_casts.h"         // for wrap_for_once_v
 #include "util/gtk4_helper.h"
 
 #include "SidebarLayout.h"            // for SidebarLayout
@@ -30,14 +32,6 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, const char* menuId, con
     gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scrollableBox.get()), GTK_WIDGET(miniaturesContainer.get()));
     gtk_widget_set_vexpand(scrollableBox.get(), true);
 
-    Document* doc = this->control->getDocument();
-    doc->lock();
-    if (doc->getPdfPageCount() != 0) {
-        this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
-    }
-    doc->unlock();
-
-
     registerListener(this->control);
     this->control->addChangedDocumentListener(this);
 
@@ -48,6 +42,16 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, const char* menuId, con
             }),
             this);
 
+    auto* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scrollableBox.get()));
+    g_signal_connect(vadj, "value-changed", G_CALLBACK(+[](GtkAdjustment*, gpointer d) {
+                         static_cast<SidebarPreviewBase*>(d)->updateVisibleEntries(false);
+                     }),
+                     this);
+    g_signal_connect(vadj, "notify::page-size", G_CALLBACK(+[](GObject*, GParamSpec*, gpointer d) {
+                         static_cast<SidebarPreviewBase*>(d)->updateVisibleEntries(false);
+                     }),
+                     this);
+
     Builder builder(control->getGladeSearchPath(), XML_FILE);
     GMenuModel* menu = G_MENU_MODEL(builder.get<GObject>(menuId));
     contextMenu.reset(GTK_MENU(gtk_menu_new_from_model(menu)), xoj::util::adopt);
@@ -58,7 +62,11 @@ SidebarPreviewBase::SidebarPreviewBase(Control* control, const char* menuId, con
     gtk_widget_show_all(mainBox.get());
 }
 
-SidebarPreviewBase::~SidebarPreviewBase() { this->control->removeChangedDocumentListener(this); }
+SidebarPreviewBase::~SidebarPreviewBase() {
+    this->control->removeChangedDocumentListener(this);
+    auto* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(scrollableBox.get()));
+    g_signal_handlers_disconnect_by_data(vadj, this);
+}
 
 void SidebarPreviewBase::enableSidebar() { enabled = true; }
 
@@ -75,24 +83,85 @@ void SidebarPreviewBase::newWidth(double width) {
 
 auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
-auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache.get(); }
+auto SidebarPreviewBase::getCache() -> PdfCache* {
+    // The pages are rasterized once for all the views, at any zoom
+    MainWindow* win = this->control->getWindow();
+    return win && win->getXournal() ? win->getXournal()->getCache() : nullptr;
+}
+
+auto SidebarPreviewBase::getThumbnailCache() -> ThumbnailCache* { return this->thumbnailCache.get(); }
 
 void SidebarPreviewBase::layout() { SidebarLayout::layout(this); }
 
+auto SidebarPreviewBase::getEntrySize(size_t index) -> std::pair<int, int> {
+    auto& p = this->previews[index];
+    return {p->getWidth(), p->getHeight()};
+}
+
+auto SidebarPreviewBase::createEntry(size_t index) -> std::unique_ptr<SidebarPreviewBaseEntry> { return nullptr; }
+
+void SidebarPreviewBase::updateVisibleEntries(bool complete) {
+    if (!this->entriesOnDemand) {
+        return;
+    }
+
+    GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(this->scrollableBox.get()));
+    const double pageSize = gtk_adjustment_get_page_size(vadj);
+    const double top = gtk_adjustment_get_value(vadj) - CREATED_ENTRIES_MARGIN * pageSize;
+    const double bottom = gtk_adjustment_get_value(vadj) + (1.0 + CREATED_ENTRIES_MARGIN) * pageSize;
+
+    // The entries are laid out row after row
+    const auto& positions = this->entryPositions;
+    auto firstIt = std::partition_point(positions.begin(), positions.end(),
+                                        [top](const auto& r) { return r.y + r.height <= top; });
+    auto endIt = std::partition_point(firstIt, positions.end(), [bottom](const auto& r) { return r.y < bottom; });
+    const auto first = static_cast<size_t>(firstIt - positions.begin());
+    const auto end = static_cast<size_t>(endIt - positions.begin());
+
+    const size_t count = std::min(this->previews.size(), positions.size());
+    const size_t oldFirst = complete ? 0 : this->firstCreatedEntry;
+    const size_t oldEnd = complete ? count : std::min(this->endCreatedEntry, count);
+    for (size_t i = oldFirst; i < oldEnd; i++) {
+        if (i < first || i >= end) {
+            this->previews[i].reset();
+        }
+    }
+
+    for (size_t i = first; i < end && i < count; i++) {
+        if (this->previews[i]) {
+            continue;
+        }
+        auto p = createEntry(i);
+        if (!p) {
+            continue;
+        }
+        const auto& pos = positions[i];
+        gtk_fixed_put(this->miniaturesContainer.get(), p->getWidget(), pos.x, pos.y);
+        p->setSelected(i == this->selectedEntry);
+        gtk_widget_show_all(p->getWidget());
+        this->previews[i] = std::move(p);
+    }
+
+    this->firstCreatedEntry = first;
+    this->endCreatedEntry = end;
+}
+
 auto SidebarPreviewBase::hasData() -> bool { return true; }
 
 auto SidebarPreviewBase::getWidget() -> GtkWidget* { return this->mainBox.get(); }
 
+auto SidebarPreviewBase::getMemoryUsage() -> size_t {
+    size_t usage = 0;
+    for (auto& p: this->previews) {
+        if (p) {
+            usage += p->getBufferMemoryUsage();
+        }
+    }
+    return usage;
+}
+
 void SidebarPreviewBase::documentChanged(DocumentChangeType type) {
     if (type == DOCUMENT_CHANGE_COMPLETE || type == DOCUMENT_CHANGE_CLEARED) {
-        this->cache.reset();
-
-        Document* doc = control->getDocument();
-        doc->lock();
-        if (doc->getPdfPageCount() != 0) {
-            this->cache = std::make_unique<PdfCache>(doc->getPdfDocument(), control->getSettings());
-        }
-        doc->unlock();
         updatePreviews();
     }
 }
@@ -112,24 +181,18 @@ auto SidebarPreviewBase::scrollToPreview(SidebarPreviewBase* sidebar) -> bool {
         return false;
     }
 
-    if (sidebar->selectedEntry != npos && sidebar->selectedEntry < sidebar->previews.size()) {
-        auto& p = sidebar->previews[sidebar->selectedEntry];
-
-        // scroll to preview
+    if (sidebar->selectedEntry != npos && sidebar->selectedEntry < sidebar->entryPositions.size()) {
+        // The entry may not be created: scroll to its position
+        const auto& pos = sidebar->entryPositions[sidebar->selectedEntry];
         GtkAdjustment* vadj = gtk_scrolled_window_get_vadjustment(GTK_SCROLLED_WINDOW(sidebar->scrollableBox.get()));
-        GtkWidget* widget = p->getWidget();
-
-        GtkAllocation allocation;
-        gtk_widget_get_allocation(widget, &allocation);
-        int x = allocation.x;
-        int y = allocation.y;
 
-        if (x == -1) {
+        if (gtk_adjustment_get_upper(vadj) < pos.y + pos.height) {
+            // The container has not been resized to the new layout yet
             g_idle_add(xoj::util::wrap_for_once_v<scrollToPreview>, sidebar);
             return false;
         }
 
-        gtk_adjustment_clamp_page(vadj, y, y + allocation.height);
+        gtk_adjustment_clamp_page(vadj, pos.y, pos.y + pos.height);
     }
     return false;
 }
@@ -13,16 +13,19 @@
 
 #include <cstddef>  // for size_t
 #include <memory>   // for unique_ptr
+#include <utility>  // for pair
 #include <vector>   // for vector
 
 #include <gtk/gtk.h>  // for GtkWidget, GtkAllocation
 
 #include "gui/sidebar/AbstractSidebarPage.h"  // for AbstractSidebarPage
 #include "model/DocumentChangeType.h"         // for DocumentChangeType
+#include "util/Rectangle.h"  // for Rectangle
 #include "util/Util.h"
 #include "util/raii/GObjectSPtr.h"
 
 class PdfCache;
+class ThumbnailCache;
 class SidebarLayout;
 class SidebarPreviewBaseEntry;
 class Control;
@@ -56,16 +59,23 @@ public:
      */
     GtkWidget* getWidget() override;
 
+    size_t getMemoryUsage() override;
+
     /**
      * Gets the zoom factor for the previews
      */
     double getZoom() const;
 
     /**
-     * Gets the PDF cache for preview rendering
+     * Gets the PDF cache for preview rendering, shared with the main view
      */
     PdfCache* getCache();
 
+    /**
+     * Gets the on-disk cache of the previews, or nullptr if the previews are not cached
+     */
+    ThumbnailCache* getThumbnailCache();
+
 public:
     // DocumentListener interface (only the part handled by SidebarPreviewBase)
     void documentChanged(DocumentChangeType type) override;
@@ -81,6 +91,25 @@ protected:
     /// The width of the sidebar has changed
     void newWidth(double width);
 
+    /**
+     * @return The size of the entry at the given index, which may not be created yet. By default, the size of the
+     * created entry.
+     */
+    virtual std::pair<int, int> getEntrySize(size_t index);
+
+    /**
+     * Create the entry at the given index, when it gets close to the visible part of the sidebar. Only called if
+     * entriesOnDemand is set: the derived class then leaves the entries which are not created as nullptr in previews.
+     */
+    virtual std::unique_ptr<SidebarPreviewBaseEntry> createEntry(size_t index);
+
+    /**
+     * Create the entries close to the visible part of the sidebar and destroy the others, if entriesOnDemand is set
+     * @param complete Look for the entries to destroy among all of them, and not only among those created for the
+     * previously visible part (required once the entries were laid out again)
+     */
+    void updateVisibleEntries(bool complete);
+
 public:
     /**
      * Opens a context menu, at the current cursor position.
@@ -96,10 +125,15 @@ private:
     /// last recorded width of the sidebar
     double lastWidth = -1;
 
-    /**
-     * For preview rendering
-     */
-    std::unique_ptr<PdfCache> cache;
+    /// Position of each entry in miniaturesContainer, whether it is created or not. Computed by SidebarLayout.
+    std::vector<xoj::util::Rectangle<int>> entryPositions;
+
+    /// The entries created on demand are in [firstCreatedEntry, endCreatedEntry)
+    size_t firstCreatedEntry = 0;
+    size_t endCreatedEntry = 0;
+
+    /// Part of the sidebar above and below the visible part with created entries, in heights of the visible part
+    static constexpr double CREATED_ENTRIES_MARGIN = 1.0;
 
 protected:
     /// The scrollable area with the miniatures
@@ -129,6 +163,15 @@ protected:
      */
     std::vector<std::unique_ptr<SidebarPreviewBaseEntry>> previews;
 
+    /// Keeps the previews from one session to the next. Set by the derived classes whose previews are cached.
+    std::unique_ptr<ThumbnailCache> thumbnailCache;
+
+    /**
+     * Only create the entries (their widget and buffer) close to the visible part of the sidebar, with createEntry().
+     * For sidebars with many entries, e.g. the pages of a long document.
+     */
+    bool entriesOnDemand = false;
+
     /**
      * The sidebar is enabled
      */
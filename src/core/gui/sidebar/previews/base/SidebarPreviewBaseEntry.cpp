@@ -1,5 +1,7 @@
 #include "SidebarPreviewBaseEntry.h"
 
+#include <tuple>  // for tie
+
 #include <gdk/gdk.h>      // for GdkEvent, GDK_BUTTON_PRESS
 #include <glib-object.h>  // for G_CALLBACK, g_object_ref
 #include <gtk/gtk.h>      //
@@ -101,6 +103,11 @@ void SidebarPreviewBaseEntry::paint(cairo_t* cr) {
     if (!this->buffer) {
         drawLoadingPage();
         doRepaint = true;
+    } else if (const int scaling = gtk_widget_get_scale_factor(this->button.get()); scaling != this->DPIscaling) {
+        // Moved to a monitor with another DPI scaling: the buffer is scaled until the preview is rendered again. Only
+        // the previews painted are.
+        this->DPIscaling = scaling;
+        doRepaint = true;
     }
 
     cairo_set_source_surface(cr, this->buffer.get(), 0, 0);
@@ -140,15 +147,28 @@ void SidebarPreviewBaseEntry::paint(cairo_t* cr) {
 void SidebarPreviewBaseEntry::updateSize() {
     this->DPIscaling = gtk_widget_get_scale_factor(this->button.get());
 
+    std::tie(this->imageWidth, this->imageHeight) = getImageSize(page, sidebar->getZoom());
+    gtk_widget_set_size_request(this->button.get(), imageWidth, imageHeight);
+}
+
+auto SidebarPreviewBaseEntry::getImageSize(const PageRef& page, double zoom) -> std::pair<int, int> {
     const int shadowPadding = Shadow::getShadowBottomRightSize() + Shadow::getShadowTopLeftSize() + 4;
     // To avoid having a black line, we use floor rather than ceil
-    this->imageWidth = floor_cast<int>(page->getWidth() * sidebar->getZoom()) + shadowPadding;
-    this->imageHeight = floor_cast<int>(page->getHeight() * sidebar->getZoom()) + shadowPadding;
-    gtk_widget_set_size_request(this->button.get(), imageWidth, imageHeight);
+    return {floor_cast<int>(page->getWidth() * zoom) + shadowPadding,
+            floor_cast<int>(page->getHeight() * zoom) + shadowPadding};
 }
 
 auto SidebarPreviewBaseEntry::getWidget() const -> GtkWidget* { return this->button.get(); }
 
+auto SidebarPreviewBaseEntry::getBufferMemoryUsage() -> size_t {
+    std::lock_guard lock(this->drawingMutex);
+    if (!this->buffer) {
+        return 0;
+    }
+    return static_cast<size_t>(cairo_image_surface_get_stride(this->buffer.get())) *
+           static_cast<size_t>(cairo_image_surface_get_height(this->buffer.get()));
+}
+
 auto SidebarPreviewBaseEntry::getWidth() const -> int { return imageWidth; }
 
 auto SidebarPreviewBaseEntry::getHeight() const -> int { return imageHeight; }
@@ -11,7 +11,8 @@
 
 #pragma once
 
-#include <mutex>  // for mutex
+#include <mutex>    // for mutex
+#include <utility>  // for pair
 
 #include <cairo.h>    // for cairo_t, cairo_surface_t
 #include <glib.h>     // for gboolean
@@ -56,6 +57,17 @@ public:
     virtual void repaint();
     virtual void updateSize();
 
+    /**
+     * @return The memory (in bytes) used by the buffer of the miniature
+     */
+    size_t getBufferMemoryUsage();
+
+    /**
+     * @return The size of the miniature of the page, with its shadow. This is the size of an entry showing the page,
+     * without the decorations added by the derived classes.
+     */
+    static std::pair<int, int> getImageSize(const PageRef& page, double zoom);
+
     /**
      * @return What should be rendered
      */
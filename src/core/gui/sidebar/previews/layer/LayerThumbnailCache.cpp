@@ -0,0 +1,76 @@
+#include "LayerThumbnailCache.h"
+
+#include <algorithm>  // for find
+#include <utility>    // for move
+
+#include <cairo.h>  // for cairo_image_surface_get_width
+
+#include "model/XojPage.h"  // for XojPage
+
+auto LayerRevision::of(XojPage& page, Layer::Index index) -> LayerRevision {
+    if (index == 0) {
+        return {&page, nullptr, page.getBackgroundRevision()};
+    }
+    const auto& layers = *page.getLayers();
+    if (index > layers.size()) {
+        return {};
+    }
+    const Layer* layer = layers[index - 1];
+    // The changes of the page which are not traced to a layer may concern any of them
+    return {&page, layer, layer->getContentRevision() + page.getPageWideChangeCount()};
+}
+
+void LayerThumbnailCache::setPage(const XojPage* page) {
+    std::lock_guard lock(this->mutex);
+    if (this->page != page) {
+        this->page = page;
+        this->thumbnails.clear();
+    }
+}
+
+auto LayerThumbnailCache::get(const LayerRevision& what, int width, int height) const -> xoj::util::CairoSurfaceSPtr {
+    std::lock_guard lock(this->mutex);
+    if (what.page != this->page) {
+        return nullptr;
+    }
+    auto it = this->thumbnails.find(what.layer);
+    if (it == this->thumbnails.end() || it->second.revision != what.revision) {
+        return nullptr;
+    }
+    cairo_surface_t* surface = it->second.surface.get();
+    if (cairo_image_surface_get_width(surface) != width || cairo_image_surface_get_height(surface) != height) {
+        // The zoom of the previews changed
+        return nullptr;
+    }
+    return it->second.surface;
+}
+
+void LayerThumbnailCache::store(const LayerRevision& what, xoj::util::CairoSurfaceSPtr surface) {
+    std::lock_guard lock(this->mutex);
+    if (what.page != this->page) {
+        // Rendered for a page which is not shown any more
+        return;
+    }
+    this->thumbnails[what.layer] = {what.revision, std::move(surface)};
+}
+
+auto LayerThumbnailCache::getMemoryUsage() const -> size_t {
+    std::lock_guard lock(this->mutex);
+    size_t usage = 0;
+    for (const auto& [layer, thumbnail]: this->thumbnails) {
+        usage += static_cast<size_t>(cairo_image_surface_get_stride(thumbnail.surface.get())) *
+                 static_cast<size_t>(cairo_image_surface_get_height(thumbnail.surface.get()));
+    }
+    return usage;
+}
+
+void LayerThumbnailCache::retain(const std::vector<Layer*>& layers) {
+    std::lock_guard lock(this->mutex);
+    for (auto it = this->thumbnails.begin(); it != this->thumbnails.end();) {
+        if (it->first && std::find(layers.begin(), layers.end(), it->first) == layers.end()) {
+            it = this->thumbnails.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * The miniatures of the layers of a page, shared by the layer previews
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <map>      // for map
+#include <mutex>    // for mutex
+#include <vector>   // for vector
+
+#include "model/Layer.h"  // for Layer, Layer::Index
+#include "util/raii/CairoWrappers.h"
+
+class XojPage;
+
+/**
+ * What a miniature shows: the background of the page (layer is nullptr) or a layer, at a revision
+ */
+struct LayerRevision {
+    const XojPage* page = nullptr;
+    const Layer* layer = nullptr;
+    uint64_t revision = 0;
+
+    bool operator==(const LayerRevision& other) const {
+        return page == other.page && layer == other.layer && revision == other.revision;
+    }
+    bool operator!=(const LayerRevision& other) const { return !(*this == other); }
+
+    /**
+     * @param index 0 for the background, the index of the layer otherwise
+     */
+    static LayerRevision of(XojPage& page, Layer::Index index);
+};
+
+/**
+ * @brief Miniatures of the background and of each layer of a page, on transparent surfaces, with the revision they
+ * show. The layer previews compose them (e.g. a stack of layers), so that a change of a layer only renders the layer
+ * again. Used by the preview jobs: the methods are thread safe.
+ */
+class LayerThumbnailCache {
+public:
+    /**
+     * Set the page of the miniatures. Those of another page are dropped, and not stored any more.
+     */
+    void setPage(const XojPage* page);
+
+    /**
+     * @return The miniature of this revision, of the given size in pixels, or nullptr if there is none
+     */
+    xoj::util::CairoSurfaceSPtr get(const LayerRevision& what, int width, int height) const;
+
+    void store(const LayerRevision& what, xoj::util::CairoSurfaceSPtr surface);
+
+    /**
+     * Drop the miniatures of the layers which are not in `layers` (e.g. deleted ones), and keep the others
+     */
+    void retain(const std::vector<Layer*>& layers);
+
+    /// The memory (in bytes) used by the miniatures
+    size_t getMemoryUsage() const;
+
+private:
+    struct Thumbnail {
+        uint64_t revision;
+        xoj::util::CairoSurfaceSPtr surface;
+    };
+
+    mutable std::mutex mutex;
+    const XojPage* page = nullptr;
+    std::map<const Layer*, Thumbnail> thumbnails;
+};
@@ -1,5 +1,7 @@
 #include "SidebarPreviewLayerEntry.h"
 
+#include <mutex>  // for lock_guard
+
 #include <gdk/gdk.h>      // for GdkEvent, GDK_BUTTON_PRESS, GdkEve...
 #include <glib-object.h>  // for G_CALLBACK, g_signal_connect, g_si...
 
@@ -70,3 +72,24 @@ void SidebarPreviewLayerEntry::setVisibleCheckbox(bool enabled) {
     gtk_check_button_set_active(GTK_CHECK_BUTTON(cbVisible), enabled);
     g_signal_handler_unblock(cbVisible, callbackId);
 }
+
+auto SidebarPreviewLayerEntry::getRevisions() const -> std::vector<LayerRevision> {
+    std::vector<LayerRevision> revisions;
+    // A layer is shown on the background color, a stack on the full background
+    revisions.push_back(LayerRevision::of(*page, 0));
+    for (Layer::Index i = stacked ? 1 : layerId; i <= layerId && i > 0; i++) {
+        revisions.push_back(LayerRevision::of(*page, i));
+    }
+    return revisions;
+}
+
+void SidebarPreviewLayerEntry::repaintIfChanged() {
+    {
+        std::lock_guard lock(this->drawingMutex);
+        if (!this->buffer || this->renderedRevisions == getRevisions()) {
+            // Not shown yet, or up to date
+            return;
+        }
+    }
+    repaint();
+}
@@ -13,6 +13,7 @@
 
 #include <cstddef>  // for size_t
 #include <string>   // for string
+#include <vector>   // for vector
 
 #include <gtk/gtk.h>  // for GtkWi...
 
@@ -21,6 +22,8 @@
 #include "model/PageRef.h"                                      // for PageRef
 #include "util/raii/GObjectSPtr.h"
 
+#include "LayerThumbnailCache.h"  // for LayerRevision
+
 class SidebarPreviewLayers;
 
 class SidebarPreviewLayerEntry: public SidebarPreviewBaseEntry {
@@ -50,6 +53,16 @@ public:
      */
     void setVisibleCheckbox(bool enabled);
 
+    /**
+     * @return The background and the layers shown by the preview, at their current revision
+     */
+    std::vector<LayerRevision> getRevisions() const;
+
+    /**
+     * Render the preview again if what it shows changed since it was rendered
+     */
+    void repaintIfChanged();
+
 protected:
     void mouseButtonPressCallback() override;
     void checkboxToggled();
@@ -75,5 +88,8 @@ private:
     /// render as stacked
     bool stacked = false;
 
+    /// What the buffer shows, set by the PreviewJob. Guarded by drawingMutex.
+    std::vector<LayerRevision> renderedRevisions;
+
     friend class PreviewJob;
 };
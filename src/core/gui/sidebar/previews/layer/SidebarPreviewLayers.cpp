@@ -41,6 +41,15 @@ auto SidebarPreviewLayers::getIconName() -> std::string {
     return this->iconNameHelper.iconName(icon);
 }
 
+void SidebarPreviewLayers::documentChanged(DocumentChangeType type) {
+    if (type != DOCUMENT_CHANGE_PAGES) {
+        SidebarPreviewBase::documentChanged(type);
+        return;
+    }
+    // The current page may have changed as well
+    updatePreviews();
+}
+
 void SidebarPreviewLayers::pageSizeChanged(size_t page) {
     if (page != this->lc->getCurrentPageId() || !enabled) {
         return;
@@ -54,8 +63,8 @@ void SidebarPreviewLayers::pageChanged(size_t page) {
         return;
     }
 
-    // Repaint all layer
-    for (auto& p: this->previews) { p->repaint(); }
+    // Only the previews of the changed layers are rendered again
+    for (auto& p: this->previews) { dynamic_cast<SidebarPreviewLayerEntry*>(p.get())->repaintIfChanged(); }
 }
 
 void SidebarPreviewLayers::updatePreviews() {
@@ -72,6 +81,15 @@ void SidebarPreviewLayers::updatePreviews() {
         return;
     }
 
+    if (page != this->thumbnailsPage.lock()) {
+        // Even if a new page has the address of the previous one
+        this->layerThumbnails->setPage(nullptr);
+        this->layerThumbnails->setPage(page.get());
+        this->thumbnailsPage = page;
+    } else {
+        this->layerThumbnails->retain(*page->getLayers());
+    }
+
     auto layerCount = page->getLayerCount();
 
     for (auto i = layerCount + 1; i != 0;) {
@@ -87,6 +105,14 @@ void SidebarPreviewLayers::updatePreviews() {
     layerVisibilityChanged();
 }
 
+auto SidebarPreviewLayers::getLayerThumbnails() const -> std::shared_ptr<LayerThumbnailCache> {
+    return this->layerThumbnails;
+}
+
+auto SidebarPreviewLayers::getMemoryUsage() -> size_t {
+    return SidebarPreviewBase::getMemoryUsage() + this->layerThumbnails->getMemoryUsage();
+}
+
 void SidebarPreviewLayers::rebuildLayerMenu() {
     if (!enabled) {
         return;
@@ -19,6 +19,9 @@
 #include "gui/IconNameHelper.h"                            // for IconNameHe...
 #include "gui/sidebar/previews/base/SidebarPreviewBase.h"  // for SidebarPre...
 #include "model/Layer.h"                                   // for Layer, Lay...
+#include "model/PageRef.h"                                 // for XojPage
+
+#include "LayerThumbnailCache.h"  // for LayerThumbnailCache
 
 class Control;
 class GladeGui;
@@ -66,8 +69,16 @@ public:
      */
     void layerVisibilityChanged(Layer::Index layerIndex, bool enabled);
 
+    /**
+     * @return The miniatures of the layers of the current page, composed by the previews
+     */
+    std::shared_ptr<LayerThumbnailCache> getLayerThumbnails() const;
+
+    size_t getMemoryUsage() override;
+
 public:
     // DocumentListener interface (only the part which is not handled by SidebarPreviewBase)
+    void documentChanged(DocumentChangeType type) override;
     void pageSizeChanged(size_t page) override;
     void pageChanged(size_t page) override;
 
@@ -83,4 +94,9 @@ private:
     bool stacked;
 
     IconNameHelper iconNameHelper;
+
+    /// Shared with the preview jobs, which may outlive the sidebar
+    std::shared_ptr<LayerThumbnailCache> layerThumbnails = std::make_shared<LayerThumbnailCache>();
+    /// The page of the miniatures
+    std::weak_ptr<XojPage> thumbnailsPage;
 };
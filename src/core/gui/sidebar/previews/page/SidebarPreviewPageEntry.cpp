@@ -47,6 +47,15 @@ auto SidebarPreviewPageEntry::getHeight() const -> int {
     return imageHeight;
 }
 
+auto SidebarPreviewPageEntry::getSize(SidebarPreviewPages* sidebar, const PageRef& page) -> std::pair<int, int> {
+    auto [width, height] = getImageSize(page, sidebar->getZoom());
+    if (sidebar->getControl()->getSettings()->getSidebarNumberingStyle() ==
+        SidebarNumberingStyle::NUMBER_BELOW_PREVIEW) {
+        height += PagePreviewDecoration::MARGIN_BOTTOM;
+    }
+    return {width, height};
+}
+
 void SidebarPreviewPageEntry::setIndex(size_t index) { this->index = index; }
 
 size_t SidebarPreviewPageEntry::getIndex() const { return this->index; }
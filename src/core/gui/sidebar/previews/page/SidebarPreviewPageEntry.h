@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
+#include <utility>  // for pair
+
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"  // for Previ...
 #include "model/PageRef.h"                                      // for PageRef
 
@@ -24,6 +27,11 @@ public:
 public:
     int getHeight() const override;
 
+    /**
+     * @return The size an entry showing the page has, without creating it
+     */
+    static std::pair<int, int> getSize(SidebarPreviewPages* sidebar, const PageRef& page);
+
     PreviewRenderType getRenderType() const override;
 
     void setIndex(size_t index);
@@ -8,10 +8,12 @@
 #include <glib-object.h>  // for g_obj...
 
 #include "control/Control.h"                                    // for Control
+#include "control/ThumbnailCache.h"                             // for ThumbnailCache
 #include "gui/sidebar/previews/base/SidebarPreviewBaseEntry.h"  // for Sideb...
 #include "model/Document.h"                                     // for Document
 #include "model/PageRef.h"                                      // for PageRef
 #include "util/Assert.h"                                        // for xoj_assert
+#include "util/PathUtil.h"                                      // for getCacheSubfolder
 #include "util/Util.h"                                          // for npos
 #include "util/gtk4_helper.h"
 #include "util/i18n.h"        // for _
@@ -23,7 +25,11 @@ constexpr auto MENU_ID = "PreviewPagesContextMenu";
 constexpr auto TOOLBAR_ID = "PreviewPagesToolbar";
 
 SidebarPreviewPages::SidebarPreviewPages(Control* control):
-        SidebarPreviewBase(control, MENU_ID, TOOLBAR_ID), iconNameHelper(control->getSettings()) {}
+        SidebarPreviewBase(control, MENU_ID, TOOLBAR_ID), iconNameHelper(control->getSettings()) {
+    // Long documents would need thousands of widgets and buffers otherwise
+    this->entriesOnDemand = true;
+    this->thumbnailCache = std::make_unique<ThumbnailCache>(Util::getCacheSubfolder("thumbnails"));
+}
 
 SidebarPreviewPages::~SidebarPreviewPages() = default;
 
@@ -43,13 +49,45 @@ void SidebarPreviewPages::updatePreviews() {
     Document* doc = this->getControl()->getDocument();
     doc->lock();
     size_t len = doc->getPageCount();
-    for (size_t i = 0; i < len; i++) {
-        auto p = std::make_unique<SidebarPreviewPageEntry>(this, doc->getPage(i), i);
-        gtk_fixed_put(this->miniaturesContainer.get(), p->getWidget(), 0, 0);
-        this->previews.emplace_back(std::move(p));
+    doc->unlock();
+
+    // The entries get created by layout(), once visible
+    this->previews.resize(len);
+
+    layout();
+}
+
+auto SidebarPreviewPages::getEntrySize(size_t index) -> std::pair<int, int> {
+    if (this->previews[index]) {
+        return SidebarPreviewBase::getEntrySize(index);
     }
+    Document* doc = this->getControl()->getDocument();
+    doc->lock();
+    PageRef page = doc->getPage(index);
+    doc->unlock();
+    return SidebarPreviewPageEntry::getSize(this, page);
+}
+
+auto SidebarPreviewPages::createEntry(size_t index) -> std::unique_ptr<SidebarPreviewBaseEntry> {
+    Document* doc = this->getControl()->getDocument();
+    doc->lock();
+    auto p = std::make_unique<SidebarPreviewPageEntry>(this, doc->getPage(index), index);
     doc->unlock();
+    return p;
+}
 
+void SidebarPreviewPages::documentChanged(DocumentChangeType type) {
+    if (type != DOCUMENT_CHANGE_PAGES) {
+        SidebarPreviewBase::documentChanged(type);
+        return;
+    }
+    // Only the created entries are repainted: the others are created with the new pages when scrolled to
+    for (auto& p: this->previews) {
+        if (p) {
+            p->updateSize();
+            p->repaint();
+        }
+    }
     layout();
 }
 
@@ -57,9 +95,10 @@ void SidebarPreviewPages::pageSizeChanged(size_t page) {
     if (page == npos || page >= this->previews.size()) {
         return;
     }
-    auto& p = this->previews[page];
-    p->updateSize();
-    p->repaint();
+    if (auto& p = this->previews[page]) {
+        p->updateSize();
+        p->repaint();
+    }
 
     layout();
 }
@@ -69,16 +108,19 @@ void SidebarPreviewPages::pageChanged(size_t page) {
         return;
     }
 
-    auto& p = this->previews[page];
-    p->repaint();
+    if (auto& p = this->previews[page]) {
+        p->repaint();
+    }
 }
 
-void SidebarPreviewPages::pageDeleted(size_t page) {
-    if (page >= previews.size()) {
+void SidebarPreviewPages::pageDeleted(size_t page) { pagesDeleted(page, 1); }
+
+void SidebarPreviewPages::pagesDeleted(size_t first, size_t count) {
+    if (first + count > previews.size()) {
         return;
     }
 
-    previews.erase(previews.begin() + as_signed(page));
+    previews.erase(previews.begin() + as_signed(first), previews.begin() + as_signed(first + count));
 
     // Unselect page, to prevent double selection displaying
     unselectPage();
@@ -88,16 +130,15 @@ void SidebarPreviewPages::pageDeleted(size_t page) {
     layout();
 }
 
-void SidebarPreviewPages::pageInserted(size_t page) {
-    Document* doc = control->getDocument();
-    doc->lock();
-
-    auto p = std::make_unique<SidebarPreviewPageEntry>(this, doc->getPage(page), page);
+void SidebarPreviewPages::pageInserted(size_t page) { pagesInserted(page, 1); }
 
-    doc->unlock();
+void SidebarPreviewPages::pagesInserted(size_t first, size_t count) {
+    if (first > previews.size()) {
+        return;
+    }
 
-    gtk_fixed_put(this->miniaturesContainer.get(), p->getWidget(), 0, 0);
-    this->previews.insert(this->previews.begin() + as_signed(page), std::move(p));
+    // The entries get created by layout(), if visible
+    this->previews.insert(this->previews.begin() + as_signed(first), count, nullptr);
 
     // Unselect page, to prevent double selection displaying
     unselectPage();
@@ -112,12 +153,15 @@ void SidebarPreviewPages::pageInserted(size_t page) {
  */
 void SidebarPreviewPages::unselectPage() {
     for (auto& p: this->previews) {
-        p->setSelected(false);
+        if (p) {
+            p->setSelected(false);
+        }
     }
 }
 
 void SidebarPreviewPages::pageSelected(size_t page) {
-    if (this->selectedEntry != npos && this->selectedEntry < this->previews.size()) {
+    if (this->selectedEntry != npos && this->selectedEntry < this->previews.size() &&
+        this->previews[this->selectedEntry]) {
         this->previews[this->selectedEntry]->setSelected(false);
     }
     this->selectedEntry = page;
@@ -127,8 +171,10 @@ void SidebarPreviewPages::pageSelected(size_t page) {
     }
 
     if (this->selectedEntry != npos && this->selectedEntry < this->previews.size()) {
-        auto& p = this->previews[this->selectedEntry];
-        p->setSelected(true);
+        // The entry is created once scrolled to, if needed
+        if (auto& p = this->previews[this->selectedEntry]) {
+            p->setSelected(true);
+        }
         scrollToPreview(this);
     }
 }
@@ -136,6 +182,9 @@ void SidebarPreviewPages::pageSelected(size_t page) {
 void SidebarPreviewPages::updateIndices() {
     size_t index = 0;
     for (auto& preview: this->previews) {
-        dynamic_cast<SidebarPreviewPageEntry*>(preview.get())->setIndex(index++);
+        if (preview) {
+            dynamic_cast<SidebarPreviewPageEntry*>(preview.get())->setIndex(index);
+        }
+        index++;
     }
 }
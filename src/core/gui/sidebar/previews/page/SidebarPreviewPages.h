@@ -15,6 +15,7 @@
 #include <memory>   // for unique_ptr
 #include <string>   // for string
 #include <tuple>    // for tuple
+#include <utility>  // for pair
 #include <vector>   // for vector
 
 #include <glib.h>     // for gulong
@@ -54,11 +55,18 @@ public:
 
 public:
     // DocumentListener interface (only the part which is not handled by SidebarPreviewBase)
+    void documentChanged(DocumentChangeType type) override;
     void pageSizeChanged(size_t page) override;
     void pageChanged(size_t page) override;
     void pageSelected(size_t page) override;
     void pageInserted(size_t page) override;
     void pageDeleted(size_t page) override;
+    void pagesInserted(size_t first, size_t count) override;
+    void pagesDeleted(size_t first, size_t count) override;
+
+protected:
+    std::pair<int, int> getEntrySize(size_t index) override;
+    std::unique_ptr<SidebarPreviewBaseEntry> createEntry(size_t index) override;
 
 private:
     /**
@@ -2,6 +2,7 @@
 
 #include <algorithm>  // for max
 #include <cmath>      // for NAN
+#include <cstdint>    // for uint32_t, uint64_t
 #include <optional>   // for optional
 #include <vector>     // for vector
 
@@ -9,12 +10,15 @@
 #include <gdk/gdk.h>  // for GdkRectangle, GdkWindowAttr
 
 #include "control/Control.h"                // for Control
+#include "control/PerfStats.h"              // for endFrame, isEnabled, now
+#include "control/jobs/XournalScheduler.h"  // for XournalScheduler
 #include "control/settings/Settings.h"      // for Settings
 #include "control/tools/EditSelection.h"    // for EditSelection
 #include "gui/Layout.h"                     // for Layout
 #include "gui/LegacyRedrawable.h"           // for Redrawable
+#include "gui/PageFrameCache.h"             // for PageFrameCache
 #include "gui/PageView.h"                   // for XojPageView
-#include "gui/Shadow.h"                     // for Shadow
+#include "gui/ScrollBuffer.h"               // for ScrollBuffer
 #include "gui/XournalView.h"                // for XournalView
 #include "gui/inputdevices/InputContext.h"  // for InputContext
 #include "gui/scroll/ScrollHandling.h"      // for ScrollHandling
@@ -69,6 +73,8 @@ auto gtk_xournal_new(XournalView* view, InputContext* inputContext) -> GtkWidget
     xoj->view = view;
     xoj->scrollHandling = inputContext->getScrollHandling();
     xoj->layout = new Layout(view, inputContext->getScrollHandling());
+    xoj->frameCache = new PageFrameCache();
+    xoj->scrollBuffer = new ScrollBuffer();
     xoj->selection = nullptr;
     xoj->input = inputContext;
 
@@ -174,6 +180,8 @@ static void gtk_xournal_size_allocate(GtkWidget* widget, GtkAllocation* allocati
 
     // layout the pages in the XournalWidget
     xournal->layout->layoutPages(allocation->width, allocation->height);
+    // The pages may have moved
+    xournal->scrollBuffer->invalidateAll();
 }
 
 static void gtk_xournal_realize(GtkWidget* widget) {
@@ -204,26 +212,6 @@ static void gtk_xournal_realize(GtkWidget* widget) {
     gdk_window_set_user_data(gtk_widget_get_window(widget), widget);
 }
 
-static void gtk_xournal_draw_shadow(GtkXournal* xournal, cairo_t* cr, int left, int top, int width, int height,
-                                    bool selected) {
-    if (selected) {
-        Shadow::drawShadow(cr, left - 2, top - 2, width + 4, height + 4);
-
-        Settings* settings = xournal->view->getControl()->getSettings();
-
-        // Draw border
-        Util::cairo_set_source_rgbi(cr, settings->getBorderColor());
-        cairo_set_line_width(cr, 4.0);
-        cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
-        cairo_set_line_join(cr, CAIRO_LINE_JOIN_MITER);
-
-        cairo_rectangle(cr, left, top, width, height);
-        cairo_stroke(cr);
-    } else {
-        Shadow::drawShadow(cr, left, top, width, height);
-    }
-}
-
 void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2) {
     g_return_if_fail(widget != nullptr);
     g_return_if_fail(GTK_IS_XOURNAL(widget));
@@ -239,15 +227,30 @@ void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2)
         return;  // outside visible area
     }
 
+    GTK_XOURNAL(widget)->scrollBuffer->invalidate(x1, y1, x2 - x1, y2 - y1);
     gtk_widget_queue_draw_area(widget, x1, y1, x2 - x1, y2 - y1);
 }
 
-static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
-    g_return_val_if_fail(widget != nullptr, false);
-    g_return_val_if_fail(GTK_IS_XOURNAL(widget), false);
+void gtk_xournal_repaint_region(GtkWidget* widget, const cairo_region_t* region) {
+    g_return_if_fail(widget != nullptr);
+    g_return_if_fail(GTK_IS_XOURNAL(widget));
 
-    GtkXournal* xournal = GTK_XOURNAL(widget);
+    GTK_XOURNAL(widget)->scrollBuffer->invalidate(region);
+    gtk_widget_queue_draw_region(widget, region);
+}
+
+void gtk_xournal_repaint_all(GtkWidget* widget) {
+    g_return_if_fail(widget != nullptr);
+    g_return_if_fail(GTK_IS_XOURNAL(widget));
 
+    GTK_XOURNAL(widget)->scrollBuffer->invalidateAll();
+    gtk_widget_queue_draw(widget);
+}
+
+/**
+ * Draw the background and the pages, clipped by cr
+ */
+static void gtk_xournal_draw_pages(GtkXournal* xournal, cairo_t* cr) {
     double x1 = NAN, x2 = NAN, y1 = NAN, y2 = NAN;
 
     cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
@@ -260,7 +263,13 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
     // Add a padding for the shadow of the pages
     Rectangle clippingRect(x1 - 10, y1 - 10, x2 - x1 + 20, y2 - y1 + 20);
 
-    for (auto&& pv: xournal->view->getViewPages()) {
+    // Only the pages of the cells of the grid intersecting the clip are checked
+    const auto& viewPages = xournal->view->getViewPages();
+    for (size_t pageIdx: xournal->layout->getPagesInRect(clippingRect)) {
+        if (pageIdx >= viewPages.size()) {
+            continue;
+        }
+        auto&& pv = viewPages[pageIdx];
         int px = pv->getX();
         int py = pv->getY();
         int pw = pv->getDisplayWidth();
@@ -270,7 +279,7 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
             continue;
         }
 
-        gtk_xournal_draw_shadow(xournal, cr, px, py, pw, ph, pv->isSelected());
+        xournal->frameCache->draw(cr, px, py, pw, ph, pv->isSelected(), settings->getBorderColor());
 
         cairo_save(cr);
         cairo_translate(cr, px, py);
@@ -278,6 +287,46 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         pv->paintPage(cr, nullptr);
         cairo_restore(cr);
     }
+}
+
+static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
+    g_return_val_if_fail(widget != nullptr, false);
+    g_return_val_if_fail(GTK_IS_XOURNAL(widget), false);
+
+    GtkXournal* xournal = GTK_XOURNAL(widget);
+    const int64_t frameStart = xoj::perf::isEnabled() ? xoj::perf::now() : 0;
+
+    Settings* settings = xournal->view->getControl()->getSettings();
+    if (settings->isBlitOnScroll()) {
+        // The buffer holds the visible part of the widget
+        GtkAdjustment* hadj = xournal->scrollHandling->getHorizontal();
+        GtkAdjustment* vadj = xournal->scrollHandling->getVertical();
+        GdkRectangle visible{static_cast<int>(gtk_adjustment_get_value(hadj)),
+                             static_cast<int>(gtk_adjustment_get_value(vadj)),
+                             static_cast<int>(gtk_adjustment_get_page_size(hadj)),
+                             static_cast<int>(gtk_adjustment_get_page_size(vadj))};
+        GtkAllocation alloc = {0};
+        gtk_widget_get_allocation(widget, &alloc);
+        GdkRectangle allocated{0, 0, alloc.width, alloc.height};
+        GdkRectangle viewport{0, 0, 0, 0};
+        gdk_rectangle_intersect(&visible, &allocated, &viewport);
+
+        double x1 = NAN, x2 = NAN, y1 = NAN, y2 = NAN;
+        cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+        const bool clipInViewport = x1 >= viewport.x && y1 >= viewport.y && x2 <= viewport.x + viewport.width &&
+                                    y2 <= viewport.y + viewport.height;
+        if (clipInViewport && viewport.width > 0 && viewport.height > 0) {
+            const uint64_t key = (uint64_t(uint32_t(settings->getBackgroundColor())) << 32U) |
+                                 uint32_t(settings->getBorderColor());
+            xournal->scrollBuffer->draw(cr, viewport, key,
+                                        [xournal](cairo_t* bufferCr) { gtk_xournal_draw_pages(xournal, bufferCr); });
+        } else {
+            // Drawn where the buffer does not reach
+            gtk_xournal_draw_pages(xournal, cr);
+        }
+    } else {
+        gtk_xournal_draw_pages(xournal, cr);
+    }
 
     if (xournal->selection) {
         cairo_save(cr);
@@ -290,6 +339,16 @@ static auto gtk_xournal_draw(GtkWidget* widget, cairo_t* cr) -> gboolean {
         cairo_restore(cr);
     }
 
+    if (frameStart != 0) {
+        // The HUD stays in the top left corner of the visible area
+        const int hudX = static_cast<int>(gtk_adjustment_get_value(xournal->scrollHandling->getHorizontal()));
+        const int hudY = static_cast<int>(gtk_adjustment_get_value(xournal->scrollHandling->getVertical()));
+        auto depths = xournal->view->getControl()->getScheduler()->getQueueDepths();
+        if (xoj::perf::endFrame(frameStart, cr, hudX, hudY, depths) && xoj::perf::mode == xoj::perf::Mode::HUD) {
+            gtk_widget_queue_draw_area(widget, hudX, hudY, xoj::perf::HUD_WIDTH, xoj::perf::HUD_HEIGHT);
+        }
+    }
+
     return true;
 }
 
@@ -304,6 +363,12 @@ static void gtk_xournal_dispose(GObject* object) {
     delete xournal->layout;
     xournal->layout = nullptr;
 
+    delete xournal->frameCache;
+    xournal->frameCache = nullptr;
+
+    delete xournal->scrollBuffer;
+    xournal->scrollBuffer = nullptr;
+
     delete xournal->input;
     xournal->input = nullptr;
 }
@@ -32,6 +32,8 @@ G_BEGIN_DECLS
 
 class EditSelection;
 class Layout;
+class PageFrameCache;
+class ScrollBuffer;
 class XojPageView;
 class ScrollHandling;
 class XournalView;
@@ -57,6 +59,15 @@ struct _GtkXournal {
 
     Layout* layout;
 
+    /**
+     * The shadows and borders of the pages
+     */
+    PageFrameCache* frameCache = nullptr;
+
+    /**
+     * What was drawn in the visible area, reused at the next frames
+     */
+    ScrollBuffer* scrollBuffer = nullptr;
 
     /**
      * Selected content, if any
@@ -83,6 +94,13 @@ void gtk_xournal_scroll_relative(GtkWidget* widget, double x, double y);
 
 void gtk_xournal_repaint_area(GtkWidget* widget, int x1, int y1, int x2, int y2);
 
+void gtk_xournal_repaint_region(GtkWidget* widget, const cairo_region_t* region);
+
+/**
+ * Everything is painted again at the next frame, when the layout, the zoom or the rendering of all the pages changed
+ */
+void gtk_xournal_repaint_all(GtkWidget* widget);
+
 xoj::util::Rectangle<double>* gtk_xournal_get_visible_area(GtkWidget* widget, const XojPageView* p);
 
 G_END_DECLS
@@ -0,0 +1,24 @@
+#include "ArcLengthTable.h"
+
+#include "util/Assert.h"  // for xoj_assert
+
+ArcLengthTable::ArcLengthTable(const std::vector<Point>& points) {
+    this->lengths.reserve(points.size());
+    double length = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (i > 0) {
+            length += points[i - 1].lineLengthTo(points[i]);
+        }
+        this->lengths.push_back(length);
+    }
+}
+
+auto ArcLengthTable::getLength(const PathParameter& parameter) const -> double {
+    xoj_assert(parameter.index < this->lengths.size());
+    if (parameter.index + 1 == this->lengths.size()) {
+        return this->lengths.back();
+    }
+    // The segments are straight lines
+    const double start = this->lengths[parameter.index];
+    return start + parameter.t * (this->lengths[parameter.index + 1] - start);
+}
@@ -0,0 +1,42 @@
+/*
+ * Xournal++
+ *
+ * Cumulative lengths along a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "PathParameter.h"  // for PathParameter
+#include "Point.h"          // for Point
+
+/**
+ * Length of the polyline from its first point to each of its points, so that the position of the dashes along any part
+ * of a stroke does not require measuring the part before it.
+ */
+class ArcLengthTable {
+public:
+    explicit ArcLengthTable(const std::vector<Point>& points);
+
+    /**
+     * @return The length of the path from the first point to the point of the given index
+     */
+    double getLength(size_t index) const { return this->lengths[index]; }
+
+    /**
+     * @return The length of the path from the first point to the point of the given parameter
+     */
+    double getLength(const PathParameter& parameter) const;
+
+    double getTotalLength() const { return this->lengths.empty() ? 0.0 : this->lengths.back(); }
+
+private:
+    std::vector<double> lengths;
+};
@@ -3,37 +3,41 @@
 #include <string>   // for string
 #include <utility>  // for move
 
-#include <glib-object.h>  // for g_object_unref
+#include <glib.h>  // for g_file_get_contents
 
 #include "util/Stacktrace.h"  // for Stacktrace
 
+#include "ImageBuffer.h"  // for ImageBuffer
+
 /*
  * The contents of a background image
  *
  * Internal impl object, dont move this to an external header/source file due this is the best way to reduce code
- * bloat and increase encapsulation. This object is only used in this source scope and is a RAII Container for the
- * GdkPixbuf*
+ * bloat and increase encapsulation. This object is only used in this source scope and holds the shared image buffer,
+ * which owns the GdkPixbuf*: the pages with identical background images share a single decoded image.
  * No xournal memory leak tests necessary, because we use smart ptrs to ensure memory correctness
  */
 
 struct BackgroundImage::Content {
-    Content(fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_file(this->path.u8string().c_str(), error)) {}
-
-    Content(GInputStream* stream, fs::path path, GError** error):
-            path(std::move(path)), pixbuf(gdk_pixbuf_new_from_stream(stream, nullptr, error)) {}
+    Content(fs::path path, GError** error): path(std::move(path)) {
+        gchar* contents = nullptr;
+        gsize length = 0;
+        if (g_file_get_contents(this->path.u8string().c_str(), &contents, &length, error)) {
+            load(std::string(contents, length), error);
+            g_free(contents);
+        }
+    }
 
-    ~Content() {
-        g_object_unref(this->pixbuf);
-        this->pixbuf = nullptr;
-    };
+    Content(std::string&& data, fs::path path, GError** error): path(std::move(path)) { load(std::move(data), error); }
 
-    Content(const Content&) = delete;
-    Content(Content&&) = default;
-    auto operator=(const Content&) -> Content& = delete;
-    auto operator=(Content&&) -> Content& = default;
+    void load(std::string&& data, GError** error) {
+        this->buffer = ImageBuffer::get(std::move(data));
+        this->pixbuf = this->buffer->getPixbuf(error);
+    }
 
+    std::shared_ptr<const ImageBuffer> buffer;
     fs::path path;
+    /// Owned by the buffer
     GdkPixbuf* pixbuf = nullptr;
     int pageId = -1;
     bool attach = false;
@@ -55,8 +59,8 @@ void BackgroundImage::loadFile(fs::path const& path, GError** error) {
     this->img = std::make_shared<Content>(path, error);
 }
 
-void BackgroundImage::loadFile(GInputStream* stream, fs::path const& path, GError** error) {
-    this->img = std::make_shared<Content>(stream, path, error);
+void BackgroundImage::loadData(std::string&& data, fs::path const& path, GError** error) {
+    this->img = std::make_shared<Content>(std::move(data), path, error);
 }
 
 auto BackgroundImage::getCloneId() -> int { return this->img ? this->img->pageId : -1; }
@@ -91,3 +95,7 @@ void BackgroundImage::setAttach(bool attach) {
 auto BackgroundImage::getPixbuf() const -> GdkPixbuf* { return this->img ? this->img->pixbuf : nullptr; }
 
 auto BackgroundImage::isEmpty() const -> bool { return !this->img; }
+
+auto BackgroundImage::getBuffer() const -> std::shared_ptr<const ImageBuffer> {
+    return this->img ? this->img->buffer : nullptr;
+}
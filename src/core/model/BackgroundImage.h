@@ -12,13 +12,15 @@
 #pragma once
 
 #include <memory>  // for shared_ptr
+#include <string>  // for string
 
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbuf
-#include <gio/gio.h>                // for GInputStream
 #include <glib.h>                   // for GError
 
 #include "filesystem.h"  // for path
 
+class ImageBuffer;
+
 struct BackgroundImage {
     BackgroundImage();
     BackgroundImage(const BackgroundImage& img);
@@ -34,7 +36,8 @@ struct BackgroundImage {
     void free();
 
     void loadFile(fs::path const& filepath, GError** error);
-    void loadFile(GInputStream* stream, fs::path const& filepath, GError** error);
+    /// Load the image from its encoded data, e.g. read from an archive
+    void loadData(std::string&& data, fs::path const& filepath, GError** error);
 
     int getCloneId();
     void setCloneId(int id);
@@ -48,6 +51,9 @@ struct BackgroundImage {
 
     GdkPixbuf* getPixbuf() const;
 
+    /// The encoded data of the image, shared with the identical images. nullptr if it could not be read
+    std::shared_ptr<const ImageBuffer> getBuffer() const;
+
     bool isEmpty() const;
 
 private:
@@ -0,0 +1,28 @@
+#include "CompactPoints.h"
+
+CompactPoints::CompactPoints(const std::vector<Point>& points) {
+    this->coordinates.reserve(2 * points.size());
+    for (const Point& p: points) {
+        this->coordinates.push_back(static_cast<float>(p.x));
+        this->coordinates.push_back(static_cast<float>(p.y));
+    }
+
+    if (!points.empty() && points.front().z != Point::NO_PRESSURE) {
+        this->pressure.reserve(points.size());
+        for (const Point& p: points) { this->pressure.push_back(static_cast<float>(p.z)); }
+    }
+}
+
+auto CompactPoints::size() const -> size_t { return this->coordinates.size() / 2; }
+
+auto CompactPoints::hasPressure() const -> bool { return !this->pressure.empty(); }
+
+auto CompactPoints::expand() const -> std::vector<Point> {
+    std::vector<Point> points;
+    points.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+        points.emplace_back(this->coordinates[2 * i], this->coordinates[2 * i + 1],
+                            hasPressure() ? static_cast<double>(this->pressure[i]) : Point::NO_PRESSURE);
+    }
+    return points;
+}
@@ -0,0 +1,47 @@
+/*
+ * Xournal++
+ *
+ * The points of a stroke, in single precision
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <vector>   // for vector
+
+#include "Point.h"  // for Point
+
+/**
+ * Single precision copy of the points of a Stroke which is not in use. The coordinates take 8 bytes per point instead
+ * of the 24 bytes of a Point, and the pressure values are only stored if the stroke has some.
+ *
+ * The coordinates are rounded to the nearest float, i.e. by less than 1e-4 point on pages up to 1000 points wide.
+ */
+class CompactPoints {
+public:
+    explicit CompactPoints(const std::vector<Point>& points);
+
+    size_t size() const;
+    bool hasPressure() const;
+
+    /**
+     * @return The points, in double precision again
+     */
+    std::vector<Point> expand() const;
+
+private:
+    /**
+     * x0, y0, x1, y1...
+     */
+    std::vector<float> coordinates;
+
+    /**
+     * Empty if the stroke has no pressure values
+     */
+    std::vector<float> pressure;
+};
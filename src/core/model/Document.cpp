@@ -1,5 +1,6 @@
 #include "Document.h"
 
+#include <algorithm>  // for for_each
 #include <array>
 #include <ctime>  // for size_t, localtime, strf...
 #include <iomanip>
@@ -42,6 +43,7 @@ void Document::freeTreeContentModel() {
 
         this->contentsModel.reset();
     }
+    this->unloadedContents.clear();
 }
 
 auto Document::freeTreeContentEntry(GtkTreeModel* treeModel, GtkTreePath* path, GtkTreeIter* iter, Document* doc)
@@ -85,11 +87,16 @@ void Document::unlock() {
 */
 auto Document::tryLock() -> bool { return this->documentLock.try_lock(); }
 
+void Document::lock_shared() { this->documentLock.lock_shared(); }
+
+void Document::unlock_shared() { this->documentLock.unlock_shared(); }
+
+DocumentPageReadLock::DocumentPageReadLock(Document& doc, const XojPage& page):
+        documentLock(doc), pageLock(page.getReadMutex()) {}
+
 void Document::clearDocument(bool destroy) {
-    if (this->preview) {
-        cairo_surface_destroy(this->preview);
-        this->preview = nullptr;
-    }
+    this->preview.reset();
+    this->previewHash = 0;
 
     if (!destroy) {
         // release lock
@@ -102,7 +109,9 @@ void Document::clearDocument(bool destroy) {
         }
     }
 
+    retirePages(this->pages.begin(), this->pages.end());
     this->pages.clear();
+    this->pageNumbers.clear();
     this->pageIndex.reset();
     freeTreeContentModel();
 
@@ -117,7 +126,10 @@ auto Document::getPageCount() const -> size_t { return this->pages.size(); }
 
 auto Document::getPdfPageCount() const -> size_t { return pdfDocument.getPageCount(); }
 
-void Document::setFilepath(fs::path filepath) { this->filepath = std::move(filepath); }
+void Document::setFilepath(fs::path filepath) {
+    this->filepath = std::move(filepath);
+    this->revision++;
+}
 
 auto Document::getFilepath() const -> fs::path { return filepath; }
 
@@ -175,19 +187,15 @@ auto Document::createSaveFilename(DocumentType type, const std::string& defaultS
     return p;
 }
 
-auto Document::getPreview() const -> cairo_surface_t* { return this->preview; }
+auto Document::getPreview() const -> std::shared_ptr<const ImageBuffer> { return this->preview; }
 
-void Document::setPreview(cairo_surface_t* preview) {
-    if (this->preview) {
-        cairo_surface_destroy(this->preview);
-    }
-    if (preview) {
-        this->preview = cairo_surface_reference(preview);
-    } else {
-        this->preview = nullptr;
-    }
+void Document::setPreview(std::shared_ptr<const ImageBuffer> preview, uint64_t contentHash) {
+    this->preview = std::move(preview);
+    this->previewHash = contentHash;
 }
 
+auto Document::getPreviewHash() const -> uint64_t { return this->previewHash; }
+
 auto Document::getEvMetadataFilename() const -> fs::path {
     if (!this->filepath.empty()) {
         return this->filepath;
@@ -236,14 +244,20 @@ void Document::buildTreeContentsModel(GtkTreeIter* parent, XojPdfBookmarkIterato
                            DOCUMENT_LINKS_COLUMN_LINK, link, DOCUMENT_LINKS_COLUMN_PAGE_NUMBER, "", -1);
 
         g_free(titleMarkup);
-        g_object_unref(link);
 
-        XojPdfBookmarkIterator* child = iter->getChildIter();
-        if (child) {
-            buildTreeContentsModel(&treeIter, child);
-            delete child;
+        if (XojPdfBookmarkIterator* child = iter->getChildIter()) {
+            if (link->dest->getExpand()) {
+                buildTreeContentsModel(&treeIter, child);
+                delete child;
+            } else {
+                // Loaded when the row is expanded, see loadContentsChildren()
+                GtkTreeIter placeholder = {0};
+                gtk_tree_store_append(GTK_TREE_STORE(contentsModel.get()), &placeholder, &treeIter);
+                this->unloadedContents.emplace(link, child);
+            }
         }
 
+        g_object_unref(link);
         delete action;
 
     } while (iter->next());
@@ -279,6 +293,44 @@ void Document::buildContentsModel() {
 
 auto Document::getContentsModel() const -> GtkTreeModel* { return this->contentsModel.get(); }
 
+auto Document::loadContentsChildren(GtkTreeModel* model, GtkTreeIter* parent) -> bool {
+    if (!this->contentsModel || model != this->contentsModel.get()) {
+        return false;
+    }
+
+    XojLinkDest* link = nullptr;
+    gtk_tree_model_get(model, parent, DOCUMENT_LINKS_COLUMN_LINK, &link, -1);
+    if (link == nullptr) {
+        return false;
+    }
+    auto it = this->unloadedContents.find(link);
+    g_object_unref(link);
+    if (it == this->unloadedContents.end()) {
+        return false;
+    }
+    std::unique_ptr<XojPdfBookmarkIterator> children = std::move(it->second);
+    this->unloadedContents.erase(it);
+
+    // The placeholder is removed once the children are there, so that the row stays expandable
+    GtkTreeIter placeholder = {0};
+    gtk_tree_model_iter_children(model, &placeholder, parent);
+    buildTreeContentsModel(parent, children.get());
+    gtk_tree_store_remove(GTK_TREE_STORE(model), &placeholder);
+
+    fillPageLabelsBelow(parent);
+    return true;
+}
+
+void Document::fillPageLabelsBelow(GtkTreeIter* parent) {
+    GtkTreeModel* model = this->contentsModel.get();
+    GtkTreeIter child = {0};
+    for (bool valid = gtk_tree_model_iter_children(model, &child, parent); valid;
+         valid = gtk_tree_model_iter_next(model, &child)) {
+        fillPageLabels(model, nullptr, &child, this);
+        fillPageLabelsBelow(&child);
+    }
+}
+
 auto Document::fillPageLabels(GtkTreeModel* treeModel, GtkTreePath* path, GtkTreeIter* iter, Document* doc) -> bool {
     XojLinkDest* link = nullptr;
     gtk_tree_model_get(treeModel, iter, DOCUMENT_LINKS_COLUMN_LINK, &link, -1);
@@ -309,10 +361,11 @@ void Document::updateIndexPageNumbers() {
 void Document::setPdfAttributes(const fs::path& filename, bool attachToDocument) {
     this->pdfFilepath = filename;
     this->attachPdf = attachToDocument;
+    this->revision++;
 }
 
 auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDocument,
-                       std::unique_ptr<std::string> data) -> bool {
+                       std::unique_ptr<std::string> data, bool placeholderPageSizes) -> bool {
     GError* popplerError = nullptr;
 
     lock();
@@ -340,19 +393,33 @@ auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDo
 
     this->pdfFilepath = filename;
     this->attachPdf = attachToDocument;
+    this->pdfTextIndex = std::make_shared<PdfTextIndex>(pdfDocument.getPageCount());
     lastError = "";
+    this->revision++;
 
     if (initPages) {
+        retirePages(this->pages.begin(), this->pages.end());
         this->pages.clear();
     }
 
     if (initPages) {
+        double placeholderWidth = 0;
+        double placeholderHeight = 0;
         for (size_t i = 0; i < pdfDocument.getPageCount(); i++) {
-            XojPdfPageSPtr page = pdfDocument.getPage(i);
-            auto p = std::make_shared<XojPage>(page->getWidth(), page->getHeight());
+            std::shared_ptr<XojPage> p;
+            if (placeholderPageSizes && i > 0) {
+                p = std::make_shared<XojPage>(placeholderWidth, placeholderHeight);
+            } else {
+                XojPdfPageSPtr page = pdfDocument.getPage(i);
+                placeholderWidth = page->getWidth();
+                placeholderHeight = page->getHeight();
+                p = std::make_shared<XojPage>(placeholderWidth, placeholderHeight);
+            }
             p->setBackgroundPdfPageNr(i);
             this->pages.emplace_back(std::move(p));
         }
+        this->pageNumbers.clear();
+        renumberPages(0);
     }
 
     indexPdfPages();
@@ -366,7 +433,11 @@ auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDo
     return true;
 }
 
-void Document::resetPdf() { pdfDocument.reset(); }
+void Document::resetPdf() {
+    pdfDocument.reset();
+    pdfTextIndex = std::make_shared<PdfTextIndex>(0);
+    this->revision++;
+}
 
 void Document::setPageSize(PageRef p, double width, double height) { p->setSize(width, height); }
 
@@ -379,9 +450,15 @@ auto Document::getPageHeight(PageRef p) -> double { return p->getHeight(); }
  */
 auto Document::getLastErrorMsg() const -> std::string { return lastError; }
 
-void Document::deletePage(size_t pNr) {
-    auto it = this->pages.begin() + as_signed(pNr);
-    this->pages.erase(it);
+void Document::deletePage(size_t pNr) { deletePages(pNr, 1); }
+
+void Document::deletePages(size_t first, size_t count) {
+    auto begin = this->pages.begin() + as_signed(first);
+    auto end = begin + as_signed(count);
+    std::for_each(begin, end, [&](const PageRef& p) { this->pageNumbers.erase(p.get()); });
+    retirePages(begin, end);
+    this->pages.erase(begin, end);
+    renumberPages(first);
 
     // Reset the page index
     this->pageIndex.reset();
@@ -390,6 +467,8 @@ void Document::deletePage(size_t pNr) {
 
 void Document::insertPage(const PageRef& p, size_t position) {
     this->pages.insert(this->pages.begin() + as_signed(position), p);
+    renumberPages(position);
+    this->revision++;
 
     // Reset the page index
     this->pageIndex.reset();
@@ -398,21 +477,32 @@ void Document::insertPage(const PageRef& p, size_t position) {
 
 void Document::addPage(const PageRef& p) {
     this->pages.push_back(p);
+    this->pageNumbers[p.get()] = this->pages.size() - 1;
+    this->revision++;
 
     // Reset the page index
     this->pageIndex.reset();
     updateIndexPageNumbers();
 }
 
-auto Document::indexOf(const PageRef& page) -> size_t {
-    for (size_t i = 0; i < this->pages.size(); i++) {
-        PageRef pg = this->pages[i];
-        if (pg == page) {
-            return i;
-        }
-    }
+void Document::renumberPages(size_t position) {
+    for (size_t i = position; i < this->pages.size(); i++) { this->pageNumbers[this->pages[i].get()] = i; }
+}
+
+void Document::retirePages(std::vector<PageRef>::const_iterator first, std::vector<PageRef>::const_iterator last) {
+    std::for_each(first, last, [&](const PageRef& p) { this->revision += p->getRevision(); });
+    this->revision++;
+}
+
+auto Document::getRevision() const -> uint64_t {
+    uint64_t result = this->revision;
+    for (const PageRef& p: this->pages) { result += p->getRevision(); }
+    return result;
+}
 
-    return npos;
+auto Document::indexOf(const PageRef& page) const -> size_t {
+    auto it = this->pageNumbers.find(page.get());
+    return it == this->pageNumbers.end() ? npos : it->second;
 }
 
 auto Document::getPage(size_t page) const -> PageRef {
@@ -430,17 +520,25 @@ auto Document::getPdfPage(size_t page) const -> XojPdfPageSPtr { return this->pd
 
 auto Document::getPdfDocument() const -> const XojPdfDocument& { return this->pdfDocument; }
 
+auto Document::getPdfTextIndex() const -> std::shared_ptr<PdfTextIndex> { return this->pdfTextIndex; }
+
+auto Document::getInkIndex() -> InkIndex& { return this->inkIndex; }
+
 auto Document::operator=(const Document& doc) -> Document& {
     clearDocument();
 
     // Copy PDF Document
     this->pdfDocument = doc.pdfDocument;
+    this->pdfTextIndex = doc.pdfTextIndex;
 
     this->password = doc.password;
     this->createBackupOnSave = doc.createBackupOnSave;
     this->pdfFilepath = doc.pdfFilepath;
     this->filepath = doc.filepath;
     this->pages = doc.pages;
+    this->pageNumbers = doc.pageNumbers;
+    this->revision++;
+    this->inkIndex = InkIndex();
     this->attachPdf = doc.attachPdf;
 
     indexPdfPages();
@@ -457,6 +555,29 @@ auto Document::operator=(const Document& doc) -> Document& {
     return *this;
 }
 
+auto Document::createSnapshot(DocumentHandler* handler, const std::optional<std::vector<size_t>>& pages) const
+        -> std::unique_ptr<Document> {
+    auto snapshot = std::make_unique<Document>(handler);
+    snapshot->pdfDocument = this->pdfDocument;
+    snapshot->pdfTextIndex = this->pdfTextIndex;
+    snapshot->password = this->password;
+    snapshot->createBackupOnSave = this->createBackupOnSave;
+    snapshot->pdfFilepath = this->pdfFilepath;
+    snapshot->filepath = this->filepath;
+    snapshot->attachPdf = this->attachPdf;
+    snapshot->setPreview(this->preview, this->previewHash);
+
+    snapshot->pages = this->pages;
+    auto copyPage = [&snapshot](size_t i) { snapshot->pages[i] = PageRef(snapshot->pages[i]->clone()); };
+    if (pages) {
+        std::for_each(pages->begin(), pages->end(), copyPage);
+    } else {
+        for (size_t i = 0; i < snapshot->pages.size(); i++) { copyPage(i); }
+    }
+    snapshot->renumberPages(0);
+    return snapshot;
+}
+
 void Document::setCreateBackupOnSave(bool backup) { this->createBackupOnSave = backup; }
 
 auto Document::shouldCreateBackupOnSave() const -> bool { return this->createBackupOnSave; }
@@ -3,7 +3,8 @@
  *
  * The document
  *
- * All methods are unlocked, you need to lock the document before you change something and unlock after.
+ * All methods are unlocked, you need to lock the document before you change something and unlock after. The threads
+ * only reading a page lock it with DocumentPageReadLock instead.
  *
  * @author Xournal++ Team
  * https://github.com/xournalpp/xournalpp
@@ -14,8 +15,11 @@
 #pragma once
 
 #include <cstddef>        // for size_t
-#include <memory>         // for unique_ptr
+#include <cstdint>        // for uint64_t
+#include <memory>         // for unique_ptr, shared_ptr
 #include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <shared_mutex>   // for shared_mutex, shared_lock
 #include <string>         // for string
 #include <unordered_map>  // for unordered_map
 #include <vector>         // for vector
@@ -28,10 +32,15 @@
 #include "pdf/base/XojPdfPage.h"      // for XojPdfPageSPtr
 #include "util/raii/GObjectSPtr.h"    // for GObjectSptr
 
-#include "PageRef.h"     // for PageRef
-#include "filesystem.h"  // for path
+#include "InkIndex.h"         // for InkIndex
+#include "LinkDestination.h"  // for XojLinkDest
+#include "PageRef.h"          // for PageRef
+#include "PdfTextIndex.h"     // for PdfTextIndex
+#include "filesystem.h"       // for path
 
 class DocumentHandler;
+class ImageBuffer;
+class XojPage;
 class XojPdfBookmarkIterator;
 
 class Document {
@@ -43,27 +52,56 @@ public:
     enum DocumentType { XOPP, XOJ, PDF };
 
     void setPdfAttributes(const fs::path& filename, bool attachToDocument);
+    /**
+     * @param placeholderPageSizes If true (and initPages), the pages get the size of the first pdf page, instead of
+     *      asking the pdf library for the size of every page. See PdfPageSizeJob.
+     */
     bool readPdf(const fs::path& filename, bool initPages, bool attachToDocument,
-                 std::unique_ptr<std::string> data = {});
+                 std::unique_ptr<std::string> data = {}, bool placeholderPageSizes = false);
     void resetPdf();
 
     size_t getPageCount() const;
     size_t getPdfPageCount() const;
     XojPdfPageSPtr getPdfPage(size_t page) const;
+
+    /**
+     * The text of the pages of the pdf background, for the search. Replaced when another pdf is loaded.
+     */
+    std::shared_ptr<PdfTextIndex> getPdfTextIndex() const;
+
+    /**
+     * The index of the ink and of the audio linked elements of the pages. The document must be locked while using it.
+     */
+    InkIndex& getInkIndex();
     const XojPdfDocument& getPdfDocument() const;
 
     void insertPage(const PageRef& p, size_t position);
     void addPage(const PageRef& p);
     template <class InputIter>
     void addPages(InputIter first, InputIter last);
+
+    /**
+     * Insert several pages at once, before the page at position
+     */
+    template <class InputIter>
+    void insertPages(InputIter first, InputIter last, size_t position);
+
     PageRef getPage(size_t page) const;
     void deletePage(size_t pNr);
 
+    /**
+     * Delete the count pages starting at first, at once
+     */
+    void deletePages(size_t first, size_t count);
+
     static void setPageSize(PageRef p, double width, double height);
     static double getPageWidth(PageRef p);
     static double getPageHeight(PageRef p);
 
-    size_t indexOf(const PageRef& page);
+    /**
+     * @return The position of the page in the document, or npos. Constant time.
+     */
+    size_t indexOf(const PageRef& page) const;
 
     /**
      * @return The last error message to show to the user
@@ -74,6 +112,14 @@ public:
 
     Document& operator=(const Document& doc);
 
+    /**
+     * Copy the document, so that it can be saved while this one is modified. The document must be locked.
+     * @param pages The pages to copy. The other ones are shared with this document: they must not be read without
+     *              locking it. All the pages are copied by default.
+     */
+    std::unique_ptr<Document> createSnapshot(DocumentHandler* handler,
+                                             const std::optional<std::vector<size_t>>& pages = std::nullopt) const;
+
     void setFilepath(fs::path filepath);
     fs::path getFilepath() const;
     fs::path getPdfFilepath() const;
@@ -84,6 +130,14 @@ public:
 
     GtkTreeModel* getContentsModel() const;
 
+    /**
+     * Fill in the children of the row of the contents model, if they are not loaded yet. Only the rows under expanded
+     * rows are loaded: the others have a single placeholder child, without link, so that they can be expanded.
+     * @param model The contents model the row is from: nothing is done if it was replaced since
+     * @return true if rows were added
+     */
+    bool loadContentsChildren(GtkTreeModel* model, GtkTreeIter* parent);
+
     void setCreateBackupOnSave(bool backup);
     bool shouldCreateBackupOnSave() const;
 
@@ -91,13 +145,33 @@ public:
 
     bool isAttachPdf() const;
 
-    cairo_surface_t* getPreview() const;
-    void setPreview(cairo_surface_t* preview);
+    /**
+     * @return The PNG preview of the first page, written to the file, or nullptr
+     */
+    std::shared_ptr<const ImageBuffer> getPreview() const;
+    /**
+     * @param contentHash The hash of the first page the preview was rendered from (see ThumbnailCache::hashPage)
+     */
+    void setPreview(std::shared_ptr<const ImageBuffer> preview, uint64_t contentHash = 0);
+    uint64_t getPreviewHash() const;
 
     void lock();
     void unlock();
     bool tryLock();
 
+    /**
+     * Lock the document for reading only: the readers do not block each other, only the threads locking it with
+     * lock(). Use DocumentPageReadLock, which also serializes the readers of a same page.
+     */
+    void lock_shared();
+    void unlock_shared();
+
+    /**
+     * @return A counter which changes whenever the document changes: pages inserted or deleted, the files or any
+     *      change of a page (see XojPage::getRevision()). Goes through the pages, without loading them.
+     */
+    uint64_t getRevision() const;
+
 private:
     void buildContentsModel();
     void freeTreeContentModel();
@@ -105,12 +179,26 @@ private:
 
     void buildTreeContentsModel(GtkTreeIter* parent, XojPdfBookmarkIterator* iter);
     void updateIndexPageNumbers();
+
+    /**
+     * Update the positions of the pages from position on, after pages were inserted or deleted there
+     */
+    void renumberPages(size_t position);
+
+    /**
+     * Count the revisions of the pages which are removed, so that the revision of the document keeps increasing
+     */
+    void retirePages(std::vector<PageRef>::const_iterator first, std::vector<PageRef>::const_iterator last);
     static bool fillPageLabels(GtkTreeModel* treeModel, GtkTreePath* path, GtkTreeIter* iter, Document* doc);
+    /// Fill the page labels of the rows below the row of the contents model
+    void fillPageLabelsBelow(GtkTreeIter* parent);
 
 private:
     DocumentHandler* handler = nullptr;
 
     XojPdfDocument pdfDocument;
+    std::shared_ptr<PdfTextIndex> pdfTextIndex = std::make_shared<PdfTextIndex>(0);
+    InkIndex inkIndex;
 
     fs::path filepath;
     fs::path pdfFilepath;
@@ -128,6 +216,11 @@ private:
      */
     std::vector<PageRef> pages;
 
+    /**
+     * The position of each page in pages, kept up to date by every modification of pages
+     */
+    std::unordered_map<const XojPage*, size_t> pageNumbers;
+
     /**
      * Index from pdf page number to document page number
      */
@@ -150,25 +243,60 @@ private:
      */
     xoj::util::GObjectSPtr<GtkTreeModel> contentsModel;
 
+    /**
+     * The children of the rows of the contents model which are not loaded yet, by the link of the row
+     */
+    std::unordered_map<XojLinkDest*, std::unique_ptr<XojPdfBookmarkIterator>> unloadedContents;
+
     /**
      *  create a backup before save
      */
     bool createBackupOnSave = false;
 
     /**
-     * The preview for the file
+     * The preview for the file, and the hash of the first page it was rendered from
+     */
+    std::shared_ptr<const ImageBuffer> preview;
+    uint64_t previewHash = 0;
+
+    /**
+     * The lock of the document: exclusive for the changes, shared for the renders
      */
-    cairo_surface_t* preview = nullptr;
+    std::shared_mutex documentLock;
 
     /**
-     * The lock of the document
+     * Changes of the document itself, and revisions of the removed pages, see getRevision()
      */
-    std::mutex documentLock;
+    uint64_t revision = 0;
 };
 
+/**
+ * @brief Locks the document shared and the page exclusively, for the threads which only read a page (e.g. the render
+ * jobs). The renders of different pages then run concurrently, while the elements of a page still fill their caches
+ * (sizes, outlines, text layouts...) one thread at a time.
+ */
+class DocumentPageReadLock {
+public:
+    DocumentPageReadLock(Document& doc, const XojPage& page);
+
+private:
+    std::shared_lock<Document> documentLock;
+    std::unique_lock<std::mutex> pageLock;
+};
+
+
 template <class InputIter>
 void Document::addPages(InputIter first, InputIter last) {
-    this->pages.insert(this->pages.end(), first, last);
+    insertPages(first, last, this->pages.size());
+}
+
+template <class InputIter>
+void Document::insertPages(InputIter first, InputIter last, size_t position) {
+    this->pages.insert(this->pages.begin() + static_cast<std::ptrdiff_t>(position), first, last);
+    renumberPages(position);
+    this->revision++;
+
+    // Reset the page index
     this->pageIndex.reset();
     updateIndexPageNumbers();
 }
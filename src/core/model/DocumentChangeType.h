@@ -11,4 +11,10 @@
 
 #pragma once
 
-enum DocumentChangeType { DOCUMENT_CHANGE_CLEARED, DOCUMENT_CHANGE_COMPLETE, DOCUMENT_CHANGE_PDF_BOOKMARKS };
+enum DocumentChangeType {
+    DOCUMENT_CHANGE_CLEARED,
+    DOCUMENT_CHANGE_COMPLETE,
+    DOCUMENT_CHANGE_PDF_BOOKMARKS,
+    /// The content and possibly the size of several pages changed, the pages themselves are the same
+    DOCUMENT_CHANGE_PAGES
+};
@@ -1,5 +1,7 @@
 #include "DocumentHandler.h"
 
+#include <utility>  // for exchange
+
 #include "model/DocumentChangeType.h"  // for DocumentChangeType
 
 #include "DocumentListener.h"  // for DocumentListener
@@ -13,21 +15,66 @@ void DocumentHandler::fireDocumentChanged(DocumentChangeType type) {
 }
 
 void DocumentHandler::firePageSizeChanged(size_t page) {
+    if (this->pageChanges.depth > 0) {
+        collectPageChange(page, true);
+        return;
+    }
     for (DocumentListener* dl: this->listener) { dl->pageSizeChanged(page); }
 }
 
 void DocumentHandler::firePageChanged(size_t page) {
+    if (this->pageChanges.depth > 0) {
+        collectPageChange(page, false);
+        return;
+    }
     for (DocumentListener* dl: this->listener) { dl->pageChanged(page); }
 }
 
 void DocumentHandler::firePageInserted(size_t page) {
+    // The index of the page changed so far may not be valid any more
+    this->pageChanges.several = this->pageChanges.several || this->pageChanges.page;
     for (DocumentListener* dl: this->listener) { dl->pageInserted(page); }
 }
 
 void DocumentHandler::firePageDeleted(size_t page) {
+    this->pageChanges.several = this->pageChanges.several || this->pageChanges.page;
     for (DocumentListener* dl: this->listener) { dl->pageDeleted(page); }
 }
 
+void DocumentHandler::firePagesInserted(size_t first, size_t count) {
+    this->pageChanges.several = this->pageChanges.several || this->pageChanges.page;
+    for (DocumentListener* dl: this->listener) { dl->pagesInserted(first, count); }
+}
+
+void DocumentHandler::firePagesDeleted(size_t first, size_t count) {
+    this->pageChanges.several = this->pageChanges.several || this->pageChanges.page;
+    for (DocumentListener* dl: this->listener) { dl->pagesDeleted(first, count); }
+}
+
 void DocumentHandler::firePageSelected(size_t page) {
     for (DocumentListener* dl: this->listener) { dl->pageSelected(page); }
 }
+
+void DocumentHandler::beginPageChanges() { this->pageChanges.depth++; }
+
+void DocumentHandler::endPageChanges() {
+    if (this->pageChanges.depth == 0 || --this->pageChanges.depth > 0) {
+        return;
+    }
+    PageChanges changes = std::exchange(this->pageChanges, PageChanges());
+    if (changes.several) {
+        fireDocumentChanged(DOCUMENT_CHANGE_PAGES);
+    } else if (changes.page) {
+        if (changes.sizeChanged) {
+            firePageSizeChanged(*changes.page);
+        }
+        firePageChanged(*changes.page);
+    }
+}
+
+void DocumentHandler::collectPageChange(size_t page, bool sizeChanged) {
+    auto& changes = this->pageChanges;
+    changes.several = changes.several || (changes.page && *changes.page != page);
+    changes.page = page;
+    changes.sizeChanged = changes.sizeChanged || sizeChanged;
+}
@@ -13,6 +13,7 @@
 
 #include <cstddef>  // for size_t
 #include <list>     // for list
+#include <optional>  // for optional
 
 #include "DocumentChangeType.h"  // for DocumentChangeType
 
@@ -30,15 +31,53 @@ public:
     void firePageChanged(size_t page);
     void firePageInserted(size_t page);
     void firePageDeleted(size_t page);
+    /// For the pages inserted or deleted at once, e.g. when appending documents
+    void firePagesInserted(size_t first, size_t count);
+    void firePagesDeleted(size_t first, size_t count);
     // void firePageLoaded(PageRef page);
     void firePageSelected(size_t page);
 
+    /**
+     * Collects the page changed and page size changed events until the matching endPageChanges(). They are then sent
+     * as the usual events if only one page changed, and as one documentChanged(DOCUMENT_CHANGE_PAGES) otherwise, so
+     * that the listeners lay out and render the document once for a change of many pages.
+     * The calls can be nested: the events are sent by the outermost endPageChanges().
+     */
+    void beginPageChanges();
+    void endPageChanges();
+
 private:
     void addListener(DocumentListener* l);
     void removeListener(DocumentListener* l);
 
+    void collectPageChange(size_t page, bool sizeChanged);
+
 private:
     std::list<DocumentListener*> listener;
 
+    /// The page changes collected since beginPageChanges()
+    struct PageChanges {
+        size_t depth = 0;
+        std::optional<size_t> page;
+        bool sizeChanged = false;
+        /// More than one page changed, or pages were inserted or deleted in between
+        bool several = false;
+    } pageChanges;
+
     friend class DocumentListener;
 };
+
+/**
+ * Collects the page changes of a DocumentHandler during its lifetime, see DocumentHandler::beginPageChanges()
+ */
+class PageChangesGuard {
+public:
+    explicit PageChangesGuard(DocumentHandler* handler): handler(handler) { handler->beginPageChanges(); }
+    ~PageChangesGuard() { handler->endPageChanges(); }
+
+    PageChangesGuard(const PageChangesGuard&) = delete;
+    PageChangesGuard& operator=(const PageChangesGuard&) = delete;
+
+private:
+    DocumentHandler* handler;
+};
@@ -29,4 +29,13 @@ void DocumentListener::pageInserted(size_t page) {}
 
 void DocumentListener::pageDeleted(size_t page) {}
 
+void DocumentListener::pagesInserted(size_t first, size_t count) {
+    for (size_t n = 0; n < count; n++) { pageInserted(first + n); }
+}
+
+void DocumentListener::pagesDeleted(size_t first, size_t count) {
+    // The next page takes the index of the deleted one
+    for (size_t n = 0; n < count; n++) { pageDeleted(first); }
+}
+
 void DocumentListener::pageSelected(size_t page) {}
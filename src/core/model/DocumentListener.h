@@ -31,6 +31,15 @@ public:
     virtual void pageChanged(size_t page);
     virtual void pageInserted(size_t page);
     virtual void pageDeleted(size_t page);
+    /**
+     * The pages first to first + count - 1 were inserted at once. By default, calls pageInserted() for each.
+     */
+    virtual void pagesInserted(size_t first, size_t count);
+    /**
+     * The pages first to first + count - 1 are to be deleted at once (they are still in the document). By default,
+     * calls pageDeleted() for each.
+     */
+    virtual void pagesDeleted(size_t first, size_t count);
     virtual void pageSelected(size_t page);
 
 private:
@@ -1,17 +1,32 @@
 #include "Element.h"
 
 #include <algorithm>  // for max, min
+#include <array>      // for array
 #include <cmath>      // for ceil, floor, NAN
-#include <cstdint>    // for uint32_t
+#include <cstdint>    // for uint32_t, uintptr_t
+#include <mutex>      // for mutex, lock_guard
 
 #include <glib.h>  // for gint
 
+#include "model/Layer.h"                          // for Layer
 #include "util/safe_casts.h"                      // for as_unsigned
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
 
 using xoj::util::Rectangle;
 
+namespace {
+/**
+ * The elements computing their size lock one of these mutexes, picked from their address: a mutex per element would
+ * make each of them 40 bytes larger
+ */
+std::array<std::mutex, 64> sizeMutexes;
+
+auto sizeMutexOf(const Element* e) -> std::mutex& {
+    return sizeMutexes[(reinterpret_cast<std::uintptr_t>(e) / alignof(Element)) % sizeMutexes.size()];
+}
+}  // namespace
+
 Element::Element(ElementType type): type(type) {}
 
 auto Element::getType() const -> ElementType { return this->type; }
@@ -19,33 +34,26 @@ auto Element::getType() const -> ElementType { return this->type; }
 void Element::setX(double x) {
     this->x = x;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 void Element::setY(double y) {
     this->y = y;
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Element::getX() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return x;
 }
 
 auto Element::getY() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return y;
 }
 auto Element::getSnappedBounds() const -> Rectangle<double> {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->snappedBounds;
 }
 
@@ -53,21 +61,33 @@ void Element::move(double dx, double dy) {
     this->x += dx;
     this->y += dy;
     this->snappedBounds = this->snappedBounds.translated(dx, dy);
+    boundsChanged();
 }
 
-auto Element::getElementWidth() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
+void Element::ensureSizeCalculated() const {
+    if (this->sizeCalculated.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard lock(sizeMutexOf(this));
+    if (!this->sizeCalculated.load(std::memory_order_relaxed)) {
         calcSize();
+        this->sizeCalculated.store(true, std::memory_order_release);
     }
+}
+
+void Element::boundsChanged() {
+    if (this->parentLayer.layer && !this->parentLayer.boundsDirty.exchange(true)) {
+        this->parentLayer.layer->elementBoundsChanged(this);
+    }
+}
+
+auto Element::getElementWidth() const -> double {
+    ensureSizeCalculated();
     return this->width;
 }
 
 auto Element::getElementHeight() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->height;
 }
 
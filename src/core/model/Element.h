@@ -11,7 +11,9 @@
 
 #pragma once
 
+#include <atomic>   // for atomic
 #include <cstddef>  // for ptrdiff_t
+#include <cstdint>  // for uint64_t
 #include <memory>   // for unique_ptr
 #include <vector>   // for vector
 
@@ -21,6 +23,7 @@
 #include "util/Rectangle.h"                 // for Rectangle
 #include "util/serializing/Serializable.h"  // for Serializable
 
+class Layer;
 class ObjectInputStream;
 class ObjectOutputStream;
 
@@ -88,9 +91,21 @@ private:
 protected:
     virtual void calcSize() const = 0;
 
+    /**
+     * Compute the cached size with calcSize(), unless it is up to date. Several threads may call it at once on the
+     * same element (e.g. render jobs): the size is computed once, and published with sizeCalculated.
+     */
+    void ensureSizeCalculated() const;
+
+    /**
+     * Notify the layer containing the element (if any) that the bounding box may have changed.
+     * Must be called by every method moving or resizing the element.
+     */
+    void boundsChanged();
+
 protected:
-    // If the size has been calculated
-    mutable bool sizeCalculated = false;
+    // If the size has been calculated. Only set to true once the fields below are written, see ensureSizeCalculated()
+    mutable std::atomic<bool> sizeCalculated{false};
 
     mutable double width = 0;
     mutable double height = 0;
@@ -112,6 +127,23 @@ private:
      * The color in RGB format
      */
     Color color{0U};
+
+    /**
+     * The layer containing the element, set by the layer. It is not copied along with the element.
+     */
+    struct LayerLink {
+        Layer* layer = nullptr;
+        /// true if the layer already knows the bounding box is outdated
+        std::atomic<bool> boundsDirty{false};
+        /// Increases along the elements of the layer: the position of the element is found by a binary search
+        uint64_t orderKey = 0;
+
+        LayerLink() = default;
+        LayerLink(const LayerLink&) {}
+        LayerLink& operator=(const LayerLink&) { return *this; }
+    } parentLayer;
+
+    friend class Layer;
 };
 
 namespace xoj {
@@ -0,0 +1,82 @@
+#include "FontCache.h"
+
+#include <memory>         // for unique_ptr
+#include <mutex>          // for mutex, lock_guard
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+
+#include <pango/pangocairo.h>  // for pango_cairo_font_map_get_default
+
+#include "model/Font.h"             // for XojFont
+#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+
+namespace {
+using DescriptionPtr = std::unique_ptr<PangoFontDescription, decltype(&pango_font_description_free)>;
+
+struct Cache {
+    std::mutex mutex;
+    /// Without size, by font name
+    std::unordered_map<std::string, DescriptionPtr> descriptions;
+};
+
+auto cache() -> Cache& {
+    static Cache c;
+    return c;
+}
+
+/// The description of the font name, without size, with the family Pango picks for it
+auto resolve(const std::string& name) -> DescriptionPtr {
+    DescriptionPtr desc(pango_font_description_from_string(name.c_str()), pango_font_description_free);
+    // The size does not change the font picked
+    pango_font_description_set_absolute_size(desc.get(), 12 * PANGO_SCALE);
+
+    xoj::util::GObjectSPtr<PangoContext> context(pango_font_map_create_context(pango_cairo_font_map_get_default()),
+                                                 xoj::util::adopt);
+    xoj::util::GObjectSPtr<PangoFont> font(pango_context_load_font(context.get(), desc.get()), xoj::util::adopt);
+    if (font) {
+        // Only the family: the style asked for may be synthesized (e.g. an oblique face of a regular font)
+        DescriptionPtr picked(pango_font_describe(font.get()), pango_font_description_free);
+        if (const char* family = pango_font_description_get_family(picked.get())) {
+            pango_font_description_set_family(desc.get(), family);
+        }
+    }
+    pango_font_description_unset_fields(desc.get(), PANGO_FONT_MASK_SIZE);
+    return desc;
+}
+}  // namespace
+
+auto FontCache::createDescription(const XojFont& font) -> PangoFontDescription* {
+    Cache& c = cache();
+    PangoFontDescription* desc = nullptr;
+    {
+        std::lock_guard lock(c.mutex);
+        if (auto it = c.descriptions.find(font.getName()); it != c.descriptions.end()) {
+            desc = pango_font_description_copy(it->second.get());
+        }
+    }
+    if (!desc) {
+        // Not under the lock: the other fonts stay available in the meantime
+        DescriptionPtr resolved = resolve(font.getName());
+        desc = pango_font_description_copy(resolved.get());
+        std::lock_guard lock(c.mutex);
+        c.descriptions.emplace(font.getName(), std::move(resolved));
+    }
+    pango_font_description_set_absolute_size(desc, font.getSize() * PANGO_SCALE);
+    return desc;
+}
+
+void FontCache::warmUp(const XojFont& font) {
+    PangoFontDescription* desc = createDescription(font);
+    xoj::util::GObjectSPtr<PangoContext> context(pango_font_map_create_context(pango_cairo_font_map_get_default()),
+                                                 xoj::util::adopt);
+    xoj::util::GObjectSPtr<PangoLayout> layout(pango_layout_new(context.get()), xoj::util::adopt);
+    pango_layout_set_font_description(layout.get(), desc);
+    pango_font_description_free(desc);
+
+    // Shaping a text loads the font and its glyphs
+    pango_layout_set_text(layout.get(), "Xournal++ 0123456789", -1);
+    int width = 0;
+    int height = 0;
+    pango_layout_get_size(layout.get(), &width, &height);
+}
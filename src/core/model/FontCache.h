@@ -0,0 +1,37 @@
+/*
+ * Xournal++
+ *
+ * The fonts of the texts, as resolved by Pango and fontconfig
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <pango/pango.h>  // for PangoFontDescription
+
+class XojFont;
+
+/**
+ * Looking up a font (the first time in the process with the initialization of fontconfig, then the resolution of the
+ * aliases and of the fallbacks) is slow. The descriptions of the fonts actually used are cached by font name, for all
+ * the threads, and the lookups needed at startup are done in the background by warmUp().
+ */
+namespace FontCache {
+
+/**
+ * @return A new description of `font`, with the family which Pango picks for it (e.g. "DejaVu Sans" for "Sans"),
+ *      to be freed with pango_font_description_free(). Thread safe.
+ */
+PangoFontDescription* createDescription(const XojFont& font);
+
+/**
+ * Initialize the font map and resolve `font`, e.g. the default font of the texts. Meant for a background thread at
+ * startup, so that the first text laid out does not wait for it.
+ */
+void warmUp(const XojFont& font);
+
+}  // namespace FontCache
@@ -1,18 +1,14 @@
 #include "Image.h"
 
-#include <algorithm>  // for min
-#include <array>      // for array
 #include <memory>
-#include <utility>    // for move, pair
+#include <utility>  // for move, pair
 
-#include <cairo.h>    // for cairo_surface_destroy
-#include <gdk/gdk.h>  // for gdk_cairo_set_sourc...
-#include <glib.h>     // for guchar
+#include <cairo.h>  // for cairo_surface_write_to_png_stream
+#include <glib.h>   // for g_free, g_strcmp0
 
 #include "model/Element.h"                        // for Element, ELEMENT_IMAGE
 #include "util/Assert.h"                          // for xoj_assert
 #include "util/Rectangle.h"                       // for Rectangle
-#include "util/raii/GObjectSPtr.h"                // for GObjectSPtr
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
 
@@ -20,17 +16,7 @@ using xoj::util::Rectangle;
 
 Image::Image(): Element(ELEMENT_IMAGE) {}
 
-Image::~Image() {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    if (this->format) {
-        gdk_pixbuf_format_free(this->format);
-        this->format = nullptr;
-    }
-}
+Image::~Image() = default;
 
 auto Image::clone() const -> ElementPtr {
     auto img = std::make_unique<Image>();
@@ -42,9 +28,8 @@ auto Image::clone() const -> ElementPtr {
     img->height = this->height;
     img->data = this->data;
 
-    img->image = cairo_surface_reference(this->image);
     img->snappedBounds = this->snappedBounds;
-    img->sizeCalculated = this->sizeCalculated;
+    img->sizeCalculated = this->sizeCalculated.load();
 
     return img;
 }
@@ -52,53 +37,20 @@ auto Image::clone() const -> ElementPtr {
 void Image::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::setImage(std::string_view data) { setImage(std::string(data)); }
 
 void Image::setImage(std::string&& data) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-    this->data = std::move(data);
-
-    if (this->format) {
-        gdk_pixbuf_format_free(this->format);
-        this->format = nullptr;
-    }
-
-    // FIXME: awful hack to try to parse the format
-    std::array<char*, 4096> buffer{};
-    xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
-    size_t remaining = this->data.size();
-    while (remaining > 0) {
-        size_t readLen = std::min(remaining, buffer.size());
-        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.c_str()), readLen,
-                                     nullptr))
-            break;
-        remaining -= readLen;
-
-        // Try to determine the format early, if possible
-        this->format = gdk_pixbuf_loader_get_format(loader.get());
-        if (this->format) {
-            break;
-        }
-    }
-    gdk_pixbuf_loader_close(loader.get(), nullptr);
-    // if the format was not determined early, it can probably be determined now
-    if (!this->format) {
-        this->format = gdk_pixbuf_loader_get_format(loader.get());
-    }
-    xoj_assert_message(this->format != nullptr, "could not parse the image format!");
-
-    // the format is owned by the pixbuf, so create a copy
-    this->format = gdk_pixbuf_format_copy(this->format);
+    this->data = ImageBuffer::get(std::move(data));
+    xoj_assert_message(this->data->getFormat() != nullptr, "could not parse the image format!");
 }
 
 void Image::setImage(GdkPixbuf* img) {
@@ -109,11 +61,6 @@ void Image::setImage(GdkPixbuf* img) {
 }
 
 void Image::setImage(cairo_surface_t* image) {
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
     struct {
         std::string buffer;
         std::string readbuf;
@@ -126,38 +73,12 @@ void Image::setImage(cairo_surface_t* image) {
     };
     cairo_surface_write_to_png_stream(image, writeFunc, &closure_);
 
-    data = std::move(closure_.buffer);
+    this->data = ImageBuffer::get(std::move(closure_.buffer));
 }
 
-auto Image::getImage() const -> cairo_surface_t* {
-    xoj_assert_message(data.length() > 0, "image has no data, cannot render it!");
-    if (this->image == nullptr) {
-        xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
-        gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.c_str()), this->data.length(),
-                                nullptr);
-        [[maybe_unused]] bool success = gdk_pixbuf_loader_close(loader.get(), nullptr);
-        xoj_assert_message(success, "errors in loading image data!");
-
-        GdkPixbuf* tmp = gdk_pixbuf_loader_get_pixbuf(loader.get());
-        xoj_assert(tmp != nullptr);
-        xoj::util::GObjectSPtr<GdkPixbuf> pixbuf(gdk_pixbuf_apply_embedded_orientation(tmp), xoj::util::adopt);
-
-        this->imageSize = {gdk_pixbuf_get_width(pixbuf.get()), gdk_pixbuf_get_height(pixbuf.get())};
-
-        // TODO: pass in window once this code is refactored into ImageView
-        this->image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->imageSize.first, this->imageSize.second);
-        xoj_assert(this->image != nullptr);
-
-        // Paint the pixbuf on to the surface
-        // NOTE: we do this manually instead of using gdk_cairo_surface_create_from_pixbuf
-        // since this does not work in CLI mode.
-        cairo_t* cr = cairo_create(this->image);
-        gdk_cairo_set_source_pixbuf(cr, pixbuf.get(), 0, 0);
-        cairo_paint(cr);
-        cairo_destroy(cr);
-    }
-
-    return this->image;
+auto Image::getImage(int minWidth, int minHeight) const -> xoj::util::CairoSurfaceSPtr {
+    xoj_assert_message(hasData(), "image has no data, cannot render it!");
+    return this->data->getSurface(minWidth, minHeight);
 }
 
 void Image::scale(double x0, double y0, double fx, double fy, double rotation,
@@ -172,6 +93,7 @@ void Image::scale(double x0, double y0, double fx, double fy, double rotation,
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::rotate(double x0, double y0, double th) {}
@@ -184,7 +106,7 @@ void Image::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->width);
     out.writeDouble(this->height);
 
-    out.writeImage(this->data);
+    out.writeImage(this->data ? this->data->getData() : std::string_view());
 
     out.endObject();
 }
@@ -197,15 +119,11 @@ void Image::readSerialized(ObjectInputStream& in) {
     this->width = in.readDouble();
     this->height = in.readDouble();
 
-    if (this->image) {
-        cairo_surface_destroy(this->image);
-        this->image = nullptr;
-    }
-
-    this->data = in.readImage();
+    this->data = ImageBuffer::get(in.readImage());
 
     in.endObject();
     this->calcSize();
+    boundsChanged();
 }
 
 void Image::calcSize() const {
@@ -213,12 +131,27 @@ void Image::calcSize() const {
     this->sizeCalculated = true;
 }
 
-bool Image::hasData() const { return !this->data.empty(); }
+bool Image::hasData() const { return this->data && !this->data->getData().empty(); }
 
-const unsigned char* Image::getRawData() const { return reinterpret_cast<const unsigned char*>(this->data.data()); }
+const unsigned char* Image::getRawData() const {
+    return this->data ? reinterpret_cast<const unsigned char*>(this->data->getData().data()) : nullptr;
+}
+
+size_t Image::getRawDataLength() const { return this->data ? this->data->getData().size() : 0; }
+
+std::pair<int, int> Image::getImageSize() const { return this->data ? this->data->getImageSize() : NOSIZE; }
 
-size_t Image::getRawDataLength() const { return this->data.size(); }
+auto Image::getBuffer() const -> const std::shared_ptr<const ImageBuffer>& { return this->data; }
 
-std::pair<int, int> Image::getImageSize() const { return this->imageSize; }
+GdkPixbufFormat* Image::getImageFormat() const { return this->data ? this->data->getFormat() : nullptr; }
 
-GdkPixbufFormat* Image::getImageFormat() const { return this->format; }
+bool Image::isOpaque() const {
+    GdkPixbufFormat* format = hasData() ? this->data->getFormat() : nullptr;
+    if (!format) {
+        return false;
+    }
+    gchar* name = gdk_pixbuf_format_get_name(format);
+    const bool jpeg = g_strcmp0(name, "jpeg") == 0;
+    g_free(name);
+    return jpeg;
+}
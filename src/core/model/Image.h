@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstddef>      // for size_t
+#include <memory>       // for shared_ptr
 #include <string>       // for string
 #include <string_view>  // for string_view
 #include <utility>      // for pair, make_pair
@@ -19,7 +20,10 @@
 #include <cairo.h>                  // for cairo_surface_t, cairo_status_t
 #include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbufFormat, GdkPixbuf
 
-#include "Element.h"  // for Element
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+#include "Element.h"      // for Element
+#include "ImageBuffer.h"  // for ImageBuffer
 
 class ObjectInputStream;
 class ObjectOutputStream;
@@ -51,10 +55,11 @@ public:
     /// FIXME: remove this method. Currently, it is used by Control::clipboardPasteImage.
     [[deprecated]] void setImage(GdkPixbuf* img);
 
-    /// Returns the internal surface that contains the rendered image data.
+    /// Returns a surface that contains the rendered image data: the smallest downscaled version of at least
+    /// minWidth x minHeight pixels, or by default the full resolution (see ImageBuffer::getSurface()).
     ///
     /// Note that the image is rendered lazily by default; call this method to render it.
-    cairo_surface_t* getImage() const;
+    xoj::util::CairoSurfaceSPtr getImage(int minWidth = 0, int minHeight = 0) const;
 
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
@@ -63,15 +68,22 @@ public:
 
     bool hasData() const;
 
+    /// Whether every pixel of the image is opaque, i.e. the image hides what lies below it (JPEG images)
+    bool isOpaque() const;
+
     /// Return a pointer to the raw data. Note that the pointer will be invalidated if the data is changed.
     const unsigned char* getRawData() const;
 
     /// Return the length of the raw data.
     size_t getRawDataLength() const;
 
-    /// Return the size of the raw image, or (-1, -1) if the image has not been rendered yet.
+    /// Return the size of the raw image, read from its header if the image has not been rendered yet, or (-1, -1) if
+    /// the data cannot be decoded.
     std::pair<int, int> getImageSize() const;
 
+    /// Return the buffer holding the raw data, shared with the identical images.
+    const std::shared_ptr<const ImageBuffer>& getBuffer() const;
+
     [[maybe_unused]] GdkPixbufFormat* getImageFormat() const;
 
     static constexpr std::pair<int, int> NOSIZE = std::make_pair(-1, -1);
@@ -84,8 +96,6 @@ public:
 private:
     void calcSize() const override;
 
-    static cairo_status_t cairoReadFunction(const Image* image, unsigned char* data, unsigned int length);
-
 private:
     /// Set the image data by rendering the surface to PNG and copying the PNG data.
     ///
@@ -94,12 +104,6 @@ private:
     /// FIXME: remove this when setImage(GdkPixbuf*) is removed.
     [[deprecated]] void setImage(cairo_surface_t* image);
 
-    /// Temporary surface used as a render buffer.
-    mutable cairo_surface_t* image = nullptr;
-
-    /// Image format information.
-    mutable GdkPixbufFormat* format = nullptr;
-    mutable std::pair<int, int> imageSize = {-1, -1};
-
-    std::string data;
+    /// Raw data, and the surface it is rendered to
+    std::shared_ptr<const ImageBuffer> data;
 };
@@ -0,0 +1,461 @@
+#include "ImageBuffer.h"
+
+#include <algorithm>      // for min
+#include <functional>     // for hash
+#include <iterator>       // for next
+#include <list>           // for list
+#include <map>            // for map
+#include <optional>       // for optional, nullopt
+#include <unordered_map>  // for unordered_multimap
+#include <utility>        // for move, pair
+#include <vector>         // for vector
+
+#include <gdk/gdk.h>      // for gdk_cairo_set_source_pixbuf
+#include <glib-object.h>  // for g_signal_connect, G_CALLBACK
+
+#include "util/Assert.h"  // for xoj_assert, xoj_assert_message
+
+namespace {
+/// The buffers in use, by hash. The entries of the destroyed buffers are removed by the deleter of the buffers.
+struct Pool {
+    std::mutex mutex;
+    std::unordered_multimap<size_t, std::weak_ptr<const ImageBuffer>> buffers;
+};
+
+auto getPool() -> Pool& {
+    static Pool pool;
+    return pool;
+}
+
+/// The keys of the surfaces of getRaster() come after the levels of downscaling, which never come close
+constexpr int RASTER_KEY_BASE = 1 << 16;
+
+/// The surfaces rendered from the buffers, by buffer and level of downscaling (or raster id, see getRaster())
+class SurfaceCache {
+public:
+    using Key = std::pair<const ImageBuffer*, int>;
+
+    /// @return The cached surface, now the most recently used one, or nullptr
+    auto get(const Key& key) -> xoj::util::CairoSurfaceSPtr {
+        std::lock_guard lock(this->mutex);
+        auto it = this->entries.find(key);
+        if (it == this->entries.end()) {
+            return {};
+        }
+        this->lru.splice(this->lru.end(), this->lru, it->second.lruPosition);
+        return it->second.surface;
+    }
+
+    /// Add the surface, and release the least recently used ones beyond the budget (but the new one)
+    void add(const Key& key, const xoj::util::CairoSurfaceSPtr& surface) {
+        const size_t bytes = static_cast<size_t>(cairo_image_surface_get_stride(surface.get())) *
+                             static_cast<size_t>(cairo_image_surface_get_height(surface.get()));
+        std::vector<xoj::util::CairoSurfaceSPtr> released;  // Destroyed once the cache is unlocked
+        std::lock_guard lock(this->mutex);
+        if (this->entries.count(key)) {
+            return;
+        }
+        auto position = this->lru.insert(this->lru.end(), key);
+        this->entries.emplace(key, Entry{surface, bytes, position});
+        this->bytes += bytes;
+        while (this->bytes > ImageBuffer::SURFACE_CACHE_BUDGET && this->lru.front() != key) {
+            released.emplace_back(erase(this->entries.find(this->lru.front())));
+        }
+    }
+
+    auto getBytes() -> size_t {
+        std::lock_guard lock(this->mutex);
+        return this->bytes;
+    }
+
+    /// Remove the surfaces of a destroyed buffer
+    void remove(const ImageBuffer* buffer) {
+        std::vector<xoj::util::CairoSurfaceSPtr> released;
+        std::lock_guard lock(this->mutex);
+        for (auto it = this->entries.lower_bound({buffer, 0}); it != this->entries.end() && it->first.first == buffer;) {
+            auto next = std::next(it);
+            released.emplace_back(erase(it));
+            it = next;
+        }
+    }
+
+private:
+    struct Entry {
+        xoj::util::CairoSurfaceSPtr surface;
+        size_t bytes;
+        std::list<Key>::iterator lruPosition;
+    };
+
+    auto erase(std::map<Key, Entry>::iterator it) -> xoj::util::CairoSurfaceSPtr {
+        auto surface = std::move(it->second.surface);
+        this->bytes -= it->second.bytes;
+        this->lru.erase(it->second.lruPosition);
+        this->entries.erase(it);
+        return surface;
+    }
+
+    std::mutex mutex;
+    std::map<Key, Entry> entries;
+    std::list<Key> lru;  ///< Least recently used first
+    size_t bytes = 0;
+};
+
+/// Never destroyed, as the buffers may still be destroyed during the destruction of the static objects
+auto getSurfaceCache() -> SurfaceCache& {
+    static auto* cache = new SurfaceCache();
+    return *cache;
+}
+
+/// @return The surface downscaled to width x height pixels
+auto downscale(cairo_surface_t* source, int width, int height) -> xoj::util::CairoSurfaceSPtr {
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                        xoj::util::adopt);
+    cairo_t* cr = cairo_create(surface.get());
+    cairo_scale(cr, static_cast<double>(width) / cairo_image_surface_get_width(source),
+                static_cast<double>(height) / cairo_image_surface_get_height(source));
+    cairo_set_source_surface(cr, source, 0, 0);
+    // Averages the source pixels, and does not fade the borders
+    cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+    cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+/// Number of halvings of a width x height image keeping at least minWidth x minHeight pixels
+auto downscalingLevel(int width, int height, int minWidth, int minHeight) -> int {
+    int level = 0;
+    if (minWidth > 0 && minHeight > 0) {
+        while ((width + 1) / 2 >= minWidth && (height + 1) / 2 >= minHeight && width > 1 && height > 1) {
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+            level++;
+        }
+    }
+    return level;
+}
+
+auto downscaledLength(int length, int level) -> int {
+    for (int i = 0; i < level; i++) {
+        length = (length + 1) / 2;
+    }
+    return length;
+}
+
+struct Header {
+    /// Without the embedded orientation applied
+    std::pair<int, int> size = {-1, -1};
+    /// Whether the embedded orientation swaps the width and the height
+    bool transposed = false;
+    bool prepared = false;
+};
+
+/**
+ * @return The size and the orientation of the encoded image, as read from its header. The data is only fed to a
+ *      loader until it has allocated the pixbuf (which carries the orientation), i.e. nothing is decoded.
+ */
+auto readHeader(const std::string& data) -> Header {
+    constexpr size_t CHUNK_SIZE = 4096;
+    Header header;
+    xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
+    g_signal_connect(loader.get(), "size-prepared", G_CALLBACK(+[](GdkPixbufLoader*, int w, int h, gpointer d) {
+                         static_cast<Header*>(d)->size = {w, h};
+                     }),
+                     &header);
+    g_signal_connect(loader.get(), "area-prepared", G_CALLBACK(+[](GdkPixbufLoader* l, gpointer d) {
+                         auto* header = static_cast<Header*>(d);
+                         // The orientations 5 to 8 transpose the image
+                         const gchar* o = gdk_pixbuf_get_option(gdk_pixbuf_loader_get_pixbuf(l), "orientation");
+                         header->transposed = o && o[0] >= '5' && o[0] <= '8';
+                         header->prepared = true;
+                     }),
+                     &header);
+    for (size_t pos = 0; pos < data.size() && !header.prepared; pos += CHUNK_SIZE) {
+        const size_t len = std::min(CHUNK_SIZE, data.size() - pos);
+        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(data.data() + pos), len,
+                                     nullptr)) {
+            break;
+        }
+    }
+    gdk_pixbuf_loader_close(loader.get(), nullptr);
+    return header;
+}
+
+/**
+ * @param size If set, the size to decode the image at (without its embedded orientation applied). The loaders which
+ *      support it (e.g. JPEG) then downscale while decoding, without ever holding the full resolution.
+ */
+auto decode(const std::string& data, GError** error, std::optional<std::pair<int, int>> size = std::nullopt)
+        -> xoj::util::GObjectSPtr<GdkPixbuf> {
+    xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
+    if (size) {
+        g_signal_connect(loader.get(), "size-prepared", G_CALLBACK(+[](GdkPixbufLoader* l, int, int, gpointer d) {
+                             const auto* s = static_cast<const std::pair<int, int>*>(d);
+                             gdk_pixbuf_loader_set_size(l, s->first, s->second);
+                         }),
+                         &*size);
+    }
+    if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(data.data()), data.size(), error)) {
+        gdk_pixbuf_loader_close(loader.get(), nullptr);
+        return {};
+    }
+    if (!gdk_pixbuf_loader_close(loader.get(), error)) {
+        return {};
+    }
+    // The pixbuf is owned by the loader
+    return xoj::util::GObjectSPtr<GdkPixbuf>(gdk_pixbuf_loader_get_pixbuf(loader.get()), xoj::util::ref);
+}
+}  // namespace
+
+ImageBuffer::ImageBuffer(std::string&& data, size_t hash): data(std::move(data)), hash(hash) {}
+
+ImageBuffer::~ImageBuffer() {
+    getSurfaceCache().remove(this);
+
+    if (this->format) {
+        gdk_pixbuf_format_free(this->format);
+        this->format = nullptr;
+    }
+}
+
+auto ImageBuffer::get(std::string&& data) -> std::shared_ptr<const ImageBuffer> {
+    const size_t hash = std::hash<std::string>{}(data);
+
+    // Buffers with the same hash but other data, which must only be released once the pool is unlocked
+    std::vector<std::shared_ptr<const ImageBuffer>> collisions;
+
+    Pool& pool = getPool();
+    std::lock_guard lock(pool.mutex);
+    auto [begin, end] = pool.buffers.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (auto buffer = it->second.lock(); buffer && buffer->data == data) {
+            return buffer;
+        } else if (buffer) {
+            collisions.emplace_back(std::move(buffer));
+        }
+    }
+
+    std::shared_ptr<const ImageBuffer> buffer(new ImageBuffer(std::move(data), hash), [](const ImageBuffer* b) {
+        {
+            Pool& pool = getPool();
+            std::lock_guard lock(pool.mutex);
+            auto [begin, end] = pool.buffers.equal_range(b->hash);
+            for (auto it = begin; it != end;) {
+                it = it->second.expired() ? pool.buffers.erase(it) : std::next(it);
+            }
+        }
+        delete b;
+    });
+    pool.buffers.emplace(hash, buffer);
+    return buffer;
+}
+
+auto ImageBuffer::getMemoryUsage() -> MemoryUsage {
+    MemoryUsage usage;
+    // Released once the pool is unlocked: the deleter of the last reference locks it
+    std::vector<std::shared_ptr<const ImageBuffer>> buffers;
+    {
+        Pool& pool = getPool();
+        std::lock_guard lock(pool.mutex);
+        buffers.reserve(pool.buffers.size());
+        for (auto&& [hash, weak]: pool.buffers) {
+            if (auto buffer = weak.lock()) {
+                usage.data += buffer->data.size();
+                buffers.emplace_back(std::move(buffer));
+            }
+        }
+    }
+    usage.buffers = buffers.size();
+    usage.surfaces = getSurfaceCache().getBytes();
+    return usage;
+}
+
+auto ImageBuffer::getData() const -> const std::string& { return this->data; }
+
+auto ImageBuffer::getHash() const -> size_t { return this->hash; }
+
+auto ImageBuffer::getFormat() const -> GdkPixbufFormat* {
+    std::lock_guard lock(this->mutex);
+    if (this->formatParsed) {
+        return this->format;
+    }
+    this->formatParsed = true;
+
+    // Only feed the loader until it recognizes the format
+    constexpr size_t CHUNK_SIZE = 4096;
+    xoj::util::GObjectSPtr<GdkPixbufLoader> loader(gdk_pixbuf_loader_new(), xoj::util::adopt);
+    GdkPixbufFormat* loaderFormat = nullptr;
+    for (size_t pos = 0; pos < this->data.size() && !loaderFormat; pos += CHUNK_SIZE) {
+        const size_t len = std::min(CHUNK_SIZE, this->data.size() - pos);
+        if (!gdk_pixbuf_loader_write(loader.get(), reinterpret_cast<const guchar*>(this->data.data() + pos), len,
+                                     nullptr)) {
+            break;
+        }
+        loaderFormat = gdk_pixbuf_loader_get_format(loader.get());
+    }
+    gdk_pixbuf_loader_close(loader.get(), nullptr);
+    // if the format was not determined early, it can probably be determined now
+    if (!loaderFormat) {
+        loaderFormat = gdk_pixbuf_loader_get_format(loader.get());
+    }
+
+    // the format is owned by the loader, so create a copy
+    this->format = loaderFormat ? gdk_pixbuf_format_copy(loaderFormat) : nullptr;
+    return this->format;
+}
+
+auto ImageBuffer::isPng() const -> bool {
+    GdkPixbufFormat* f = getFormat();
+    if (!f) {
+        return false;
+    }
+    gchar* name = gdk_pixbuf_format_get_name(f);
+    const bool png = g_strcmp0(name, "png") == 0;
+    g_free(name);
+    return png;
+}
+
+auto ImageBuffer::getPixbuf(GError** error) const -> GdkPixbuf* {
+    std::lock_guard lock(this->mutex);
+    if (!this->pixbuf) {
+        this->pixbuf = decode(this->data, error);
+    }
+    return this->pixbuf.get();
+}
+
+auto ImageBuffer::getSurface(int minWidth, int minHeight) const -> xoj::util::CairoSurfaceSPtr {
+    std::lock_guard lock(this->mutex);
+    SurfaceCache& cache = getSurfaceCache();
+
+    xoj::util::CairoSurfaceSPtr full;
+    auto renderFull = [&]() {
+        full = render();
+        if (full) {
+            cache.add({this, 0}, full);
+        }
+        return static_cast<bool>(full);
+    };
+    int level = 0;
+    if (minWidth > 0 && minHeight > 0) {
+        // Not decoded yet: the size is read from the header
+        if (this->surfaceSize.first < 0 && !parseHeader() && !renderFull()) {
+            return {};
+        }
+        level = downscalingLevel(this->surfaceSize.first, this->surfaceSize.second, minWidth, minHeight);
+    }
+    if (level == 0 && full) {
+        return full;
+    }
+    if (auto surface = cache.get({this, level})) {
+        return surface;
+    }
+
+    if (level > 0 && !full) {
+        full = cache.get({this, 0});
+    }
+    if (level > 0 && !full && !this->pixbuf && parseHeader()) {
+        // Decode the image directly at the resolution of the level
+        if (auto surface = render(level)) {
+            cache.add({this, level}, surface);
+            return surface;
+        }
+    }
+    if (!full && !renderFull()) {
+        return {};
+    }
+    if (level == 0) {
+        return full;
+    }
+    auto surface = downscale(full.get(), downscaledLength(this->surfaceSize.first, level),
+                             downscaledLength(this->surfaceSize.second, level));
+    cache.add({this, level}, surface);
+    return surface;
+}
+
+auto ImageBuffer::getRaster(int id, const std::function<xoj::util::CairoSurfaceSPtr()>& render) const
+        -> xoj::util::CairoSurfaceSPtr {
+    xoj_assert(0 <= id && id <= MAX_RASTER_ID);
+    SurfaceCache& cache = getSurfaceCache();
+    const SurfaceCache::Key key{this, RASTER_KEY_BASE + id};
+    if (auto surface = cache.get(key)) {
+        return surface;
+    }
+    // Not under the mutex: the buffer is immutable, and rendering may take a while
+    auto surface = render();
+    if (surface) {
+        cache.add(key, surface);
+    }
+    return surface;
+}
+
+auto ImageBuffer::render(int level) const -> xoj::util::CairoSurfaceSPtr {
+    xoj::util::GObjectSPtr<GdkPixbuf> decoded;
+    if (level == 0) {
+        // Do not keep the decoded image if only the surface is needed
+        decoded = this->pixbuf ? this->pixbuf : decode(this->data, nullptr);
+        xoj_assert_message(decoded, "errors in loading image data!");
+    } else {
+        xoj_assert(this->headerParsed && this->encodedSize.first > 0);
+        decoded = decode(this->data, nullptr,
+                         std::pair(downscaledLength(this->encodedSize.first, level),
+                                   downscaledLength(this->encodedSize.second, level)));
+    }
+    if (!decoded) {
+        return {};
+    }
+    xoj::util::GObjectSPtr<GdkPixbuf> oriented(gdk_pixbuf_apply_embedded_orientation(decoded.get()),
+                                               xoj::util::adopt);
+
+    const int width = gdk_pixbuf_get_width(oriented.get());
+    const int height = gdk_pixbuf_get_height(oriented.get());
+    if (level == 0) {
+        this->surfaceSize = {width, height};
+    }
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                        xoj::util::adopt);
+
+    // Paint the pixbuf on to the surface
+    // NOTE: we do this manually instead of using gdk_cairo_surface_create_from_pixbuf
+    // since this does not work in CLI mode.
+    cairo_t* cr = cairo_create(surface.get());
+    gdk_cairo_set_source_pixbuf(cr, oriented.get(), 0, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+
+    return surface;
+}
+
+auto ImageBuffer::parseHeader() const -> bool {
+    if (!this->headerParsed) {
+        this->headerParsed = true;
+        const Header header = readHeader(this->data);
+        if (header.size.first > 0 && header.size.second > 0) {
+            this->encodedSize = header.size;
+            if (this->surfaceSize.first < 0) {
+                const auto [w, h] = header.size;
+                this->surfaceSize = header.transposed ? std::pair(h, w) : std::pair(w, h);
+            }
+        }
+    }
+    return this->encodedSize.first > 0;
+}
+
+auto ImageBuffer::getSurfaceSize() const -> std::pair<int, int> {
+    std::lock_guard lock(this->mutex);
+    return this->surfaceSize;
+}
+
+auto ImageBuffer::getImageSize() const -> std::pair<int, int> {
+    std::lock_guard lock(this->mutex);
+    if (this->surfaceSize.first < 0) {
+        parseHeader();
+    }
+    return this->surfaceSize;
+}
+
+void ImageBuffer::beginBackgroundDecoding() const { this->backgroundDecodings++; }
+
+void ImageBuffer::endBackgroundDecoding() const { this->backgroundDecodings--; }
+
+auto ImageBuffer::isDecodingInBackground() const -> bool { return this->backgroundDecodings > 0; }
@@ -0,0 +1,154 @@
+/*
+ * Xournal++
+ *
+ * Encoded image data, shared by the identical images
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <atomic>      // for atomic
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+#include <memory>      // for shared_ptr
+#include <mutex>       // for mutex
+#include <string>      // for string
+#include <utility>     // for pair
+
+#include <cairo.h>                  // for cairo_surface_t
+#include <gdk-pixbuf/gdk-pixbuf.h>  // for GdkPixbuf, GdkPixbufFormat
+#include <glib.h>                   // for GError
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "util/raii/GObjectSPtr.h"    // for GObjectSPtr
+
+/**
+ * The encoded data (PNG, JPEG, PDF...) of an image, of a background image or of a TexImage.
+ *
+ * The buffers are content-addressed: get() returns the buffer already holding the same data, if there is one. The
+ * copies of an image (e.g. pasted several times) thus share their data and their rendered surface, and are written
+ * only once to the archives.
+ *
+ * The data is immutable. The format, pixbuf and surfaces are computed on demand, and may be used from any thread.
+ *
+ * The surfaces rendered from all the buffers are kept in a cache of bounded size, and rendered again when needed after
+ * they were evicted. Besides the full resolution, they come in downscaled versions (halving the size at each level),
+ * so that drawing a large photo at a low zoom level does not sample the full resolution. The rasterizations of the PDF
+ * data of the TexImages are kept in the same cache (see getRaster()).
+ */
+class ImageBuffer {
+public:
+    ImageBuffer(const ImageBuffer&) = delete;
+    ImageBuffer& operator=(const ImageBuffer&) = delete;
+    ImageBuffer(ImageBuffer&&) = delete;
+    ImageBuffer& operator=(ImageBuffer&&) = delete;
+    ~ImageBuffer();
+
+    /**
+     * @return The buffer holding data: the one of the identical images if there is one, or else a new one
+     */
+    static std::shared_ptr<const ImageBuffer> get(std::string&& data);
+
+    const std::string& getData() const;
+    size_t getHash() const;
+
+    /**
+     * @return The format of the image, or nullptr if GdkPixbuf cannot read it (e.g. for PDF data)
+     */
+    GdkPixbufFormat* getFormat() const;
+
+    bool isPng() const;
+
+    /**
+     * @return The decoded image, without its embedded orientation applied, or nullptr if it cannot be decoded
+     */
+    GdkPixbuf* getPixbuf(GError** error = nullptr) const;
+
+    /**
+     * @return The image rendered in a surface, with its embedded orientation applied, or nullptr if it cannot be
+     *      decoded. This is the smallest downscaled version of at least minWidth x minHeight pixels, or by default the
+     *      full resolution. It is rendered on the first call, or if it was evicted from the cache since.
+     */
+    xoj::util::CairoSurfaceSPtr getSurface(int minWidth = 0, int minHeight = 0) const;
+
+    /**
+     * @return The surface rendered from the data by the caller (e.g. the PDF of a TexImage rasterized at some
+     *      resolution), identified by id (between 0 and MAX_RASTER_ID). It comes from the cache of the surfaces if it
+     *      is still there, or else from render(), and is then cached.
+     */
+    xoj::util::CairoSurfaceSPtr getRaster(int id, const std::function<xoj::util::CairoSurfaceSPtr()>& render) const;
+
+    static constexpr int MAX_RASTER_ID = 255;
+
+    /**
+     * @return The size of the surface at full resolution, or (-1, -1) if it has not been rendered yet (and its header
+     *      was not read, see getImageSize())
+     */
+    std::pair<int, int> getSurfaceSize() const;
+
+    /**
+     * @return The size of the image at full resolution, with its embedded orientation applied, or (-1, -1) if it
+     *      cannot be decoded. If the image has not been rendered yet, the size is read from its header only.
+     */
+    std::pair<int, int> getImageSize() const;
+
+    /**
+     * The surface is being rendered on another thread, which will repaint the views of the image once done (see
+     * ImageDecodeJob). Meanwhile, the views draw a placeholder instead of waiting for the surface.
+     */
+    void beginBackgroundDecoding() const;
+    void endBackgroundDecoding() const;
+    bool isDecodingInBackground() const;
+
+    /**
+     * Budget, in bytes, of the cache of surfaces shared by all the buffers
+     */
+    static constexpr size_t SURFACE_CACHE_BUDGET = 256 * 1024 * 1024;
+
+    struct MemoryUsage {
+        /// The number of buffers in use
+        size_t buffers = 0;
+        /// The data of the buffers, in bytes
+        size_t data = 0;
+        /// The surfaces in the cache, in bytes
+        size_t surfaces = 0;
+    };
+
+    /**
+     * @return The memory used by all the buffers (of all the documents and of the undo history)
+     */
+    static MemoryUsage getMemoryUsage();
+
+private:
+    ImageBuffer(std::string&& data, size_t hash);
+
+    /**
+     * Decode the image at full resolution, or directly at the given level of downscaling (which requires encodedSize).
+     * The caller must hold mutex.
+     */
+    xoj::util::CairoSurfaceSPtr render(int level = 0) const;
+
+    /**
+     * Read the size and the orientation of the image from its header, once. The caller must hold mutex.
+     * @return false if the header cannot be read
+     */
+    bool parseHeader() const;
+
+    std::string data;
+    size_t hash;
+
+    mutable std::mutex mutex;
+    mutable bool formatParsed = false;
+    mutable GdkPixbufFormat* format = nullptr;
+    mutable xoj::util::GObjectSPtr<GdkPixbuf> pixbuf;
+    mutable std::pair<int, int> surfaceSize = {-1, -1};
+    /// The size read from the header of the image, without its orientation applied
+    mutable bool headerParsed = false;
+    mutable std::pair<int, int> encodedSize = {-1, -1};
+
+    mutable std::atomic<int> backgroundDecodings{0};
+};
@@ -0,0 +1,103 @@
+#include "InkIndex.h"
+
+#include <algorithm>  // for any_of, lower_bound, stable_sort, upper_bound
+#include <utility>    // for move, pair
+
+#include "model/AudioElement.h"  // for AudioElement
+#include "model/Document.h"      // for Document
+#include "model/Element.h"       // for Element, ELEMENT_STROKE
+#include "model/Layer.h"         // for Layer
+#include "model/XojPage.h"       // for XojPage
+#include "util/Rectangle.h"      // for Rectangle
+
+auto InkIndex::getLayerStates(XojPage& page) -> std::vector<LayerState> {
+    std::vector<LayerState> states;
+    for (const Layer* l: *page.getLayers()) {
+        states.push_back({l, l->getRevision(), l->getBoundsRevision(), l->isVisible()});
+    }
+    return states;
+}
+
+auto InkIndex::summarize(const PageRef& page, std::vector<LayerState> layers) -> PageSummary {
+    PageSummary summary;
+    summary.page = page;
+    summary.layers = std::move(layers);
+    for (const Layer* l: *page->getLayers()) {
+        if (!l->isVisible()) {
+            continue;
+        }
+        for (const auto& e: l->getElements()) {
+            if (e->getType() == ELEMENT_STROKE) {
+                summary.inkBounds = summary.inkBounds.unite(Range(e->boundingRect()));
+            }
+            if (const auto* a = dynamic_cast<const AudioElement*>(e.get()); a && !a->getAudioFilename().empty()) {
+                summary.audio.emplace_back(a->getTimestamp(), a);
+            }
+        }
+    }
+    return summary;
+}
+
+void InkIndex::update(const Document& doc) {
+    const size_t pageCount = doc.getPageCount();
+    bool changed = this->pages.size() != pageCount;
+    this->pages.resize(pageCount);
+
+    for (size_t i = 0; i < pageCount; i++) {
+        PageRef page = doc.getPage(i);
+        PageSummary& summary = this->pages[i];
+        auto layers = getLayerStates(*page);
+        if (summary.page.lock() == page && summary.layers == layers) {
+            continue;
+        }
+        summary = summarize(page, std::move(layers));
+        changed = true;
+    }
+
+    if (changed) {
+        this->audio.clear();
+        for (size_t i = 0; i < pageCount; i++) {
+            for (const auto& [timestamp, element]: this->pages[i].audio) {
+                this->audio.push_back({timestamp, i, element});
+            }
+        }
+        std::stable_sort(this->audio.begin(), this->audio.end(),
+                         [](const AudioEntry& a, const AudioEntry& b) { return a.timestamp < b.timestamp; });
+    }
+}
+
+auto InkIndex::getPagesWithInk(const Document& doc, const Range& area) -> std::vector<size_t> {
+    update(doc);
+
+    std::vector<size_t> result;
+    for (size_t i = 0; i < this->pages.size(); i++) {
+        const PageSummary& summary = this->pages[i];
+        if (summary.inkBounds.intersect(area).empty()) {
+            continue;
+        }
+        // The bounds only rule out pages: the spatial index of the layers tells if a stroke is in the area
+        PageRef page = summary.page.lock();
+        const auto& layers = *page->getLayers();
+        if (std::any_of(layers.begin(), layers.end(), [&](const Layer* l) {
+                if (!l->isVisible()) {
+                    return false;
+                }
+                auto elements = l->getElementsInArea(area);
+                return std::any_of(elements.begin(), elements.end(),
+                                   [](const Element* e) { return e->getType() == ELEMENT_STROKE; });
+            })) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+auto InkIndex::getAudioElements(const Document& doc, size_t from, size_t to) -> std::vector<AudioEntry> {
+    update(doc);
+
+    auto begin = std::lower_bound(this->audio.begin(), this->audio.end(), from,
+                                  [](const AudioEntry& a, size_t t) { return a.timestamp < t; });
+    auto end = std::upper_bound(begin, this->audio.end(), to,
+                                [](size_t t, const AudioEntry& a) { return t < a.timestamp; });
+    return {begin, end};
+}
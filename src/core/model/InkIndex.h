@@ -0,0 +1,92 @@
+/*
+ * Xournal++
+ *
+ * Document level index of the ink and of the audio linked elements
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <memory>   // for weak_ptr
+#include <vector>   // for vector
+
+#include "util/Range.h"  // for Range
+
+#include "PageRef.h"  // for PageRef
+
+class AudioElement;
+class Document;
+class Layer;
+class XojPage;
+
+/**
+ * @brief Summaries of the pages of a document, to find the pages with ink in a region, or the elements recorded along
+ * with the audio around a given time, without going through every element of every page.
+ *
+ * Each page is summarized by the bounds of the strokes of its visible layers and its audio linked elements. A summary
+ * is only computed again once the layers of its page changed (see Layer::getRevision() and
+ * Layer::getBoundsRevision()). The audio linked elements are kept sorted by timestamp.
+ *
+ * Not thread safe: the document must be locked while querying.
+ */
+class InkIndex {
+public:
+    struct AudioEntry {
+        size_t timestamp;
+        /// Index of the page in the document
+        size_t page;
+        const AudioElement* element;
+    };
+
+    /**
+     * @return The indices of the pages on which a stroke of a visible layer intersects the area (in page coordinates),
+     *      in increasing order
+     */
+    std::vector<size_t> getPagesWithInk(const Document& doc, const Range& area);
+
+    /**
+     * @return The audio linked elements of the visible layers, whose timestamp is in [from, to], sorted by timestamp
+     */
+    std::vector<AudioEntry> getAudioElements(const Document& doc, size_t from, size_t to);
+
+private:
+    struct LayerState {
+        const Layer* layer;
+        uint64_t revision;
+        uint64_t boundsRevision;
+        bool visible;
+
+        bool operator==(const LayerState& o) const {
+            return layer == o.layer && revision == o.revision && boundsRevision == o.boundsRevision &&
+                   visible == o.visible;
+        }
+    };
+
+    struct PageSummary {
+        std::weak_ptr<XojPage> page;
+        std::vector<LayerState> layers;
+        /// Bounds of the strokes of the visible layers (empty if there are none)
+        Range inkBounds;
+        /// The audio linked elements of the visible layers, and their timestamps
+        std::vector<std::pair<size_t, const AudioElement*>> audio;
+    };
+
+    static std::vector<LayerState> getLayerStates(XojPage& page);
+    static PageSummary summarize(const PageRef& page, std::vector<LayerState> layers);
+
+    /**
+     * Summarize the pages which changed since the last query, and sort the audio linked elements again if need be
+     */
+    void update(const Document& doc);
+
+    std::vector<PageSummary> pages;
+
+    /// The audio linked elements of all pages, sorted by timestamp
+    std::vector<AudioEntry> audio;
+};
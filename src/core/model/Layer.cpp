@@ -1,6 +1,8 @@
 #include "Layer.h"
 
+#include <algorithm>      // for remove_if, sort, is_sorted
 #include <cstddef>
+#include <iterator>       // for back_inserter
 #include <memory>
 #include <utility>
 #include <vector>
@@ -10,9 +12,14 @@
 #include "model/Element.h"  // for Element, Element::Index, Element::Inval...
 #include "model/ElementInsertionPosition.h"
 #include "util/Assert.h"      // for xoj_assert
+#include "util/Range.h"       // for Range
+#include "util/Rectangle.h"   // for Rectangle
 #include "util/Stacktrace.h"  // for Stacktrace
 #include "util/safe_casts.h"
 
+/// Gap between the order keys of consecutive elements, leaving room for insertions
+constexpr uint64_t ORDER_KEY_SPACING = 1U << 16;
+
 Layer::Layer() = default;
 
 Layer::~Layer() = default;
@@ -38,7 +45,10 @@ void Layer::addElement(ElementPtr e) {
         return;
     }
 
+    Element* ptr = e.get();
     this->elements.emplace_back(std::move(e));
+    indexElement(ptr, static_cast<Element::Index>(this->elements.size()) - 1);
+    this->revision++;
 }
 
 void Layer::insertElement(ElementPtr e, Element::Index pos) {
@@ -54,31 +64,83 @@ void Layer::insertElement(ElementPtr e, Element::Index pos) {
         pos = 0;
     }
 
+    Element* ptr = e.get();
     // If the element should be inserted at the top
     if (pos >= static_cast<int>(this->elements.size())) {
+        pos = static_cast<Element::Index>(this->elements.size());
         this->elements.push_back(std::move(e));
     } else {
         this->elements.insert(this->elements.begin() + pos, std::move(e));
     }
+    indexElement(ptr, pos);
+    this->revision++;
 }
 
-auto Layer::indexOf(Element* e) const -> Element::Index {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (this->elements[i].get() == e) {
-            return i;
+void Layer::insertElements(InsertionOrder&& elts) {
+    xoj_assert(std::is_sorted(elts.begin(), elts.end()));
+
+    std::vector<ElementPtr> merged;
+    merged.reserve(this->elements.size() + elts.size());
+    std::vector<size_t> positions;
+    positions.reserve(elts.size());
+    std::vector<ElementPtr> appended;
+
+    auto old = this->elements.begin();
+    for (auto&& [e, pos]: elts) {
+        if (e == nullptr) {
+            g_warning("insertElements(nullptr)!");
+            Stacktrace::printStracktrace();
+            continue;
+        }
+        if (pos < 0) {
+            appended.emplace_back(std::move(e));
+            continue;
+        }
+        while (as_signed(merged.size()) < pos && old != this->elements.end()) {
+            merged.emplace_back(std::move(*old++));
         }
+        positions.emplace_back(merged.size());
+        merged.emplace_back(std::move(e));
+    }
+    std::move(old, this->elements.end(), std::back_inserter(merged));
+    for (auto&& e: appended) {
+        positions.emplace_back(merged.size());
+        merged.emplace_back(std::move(e));
     }
 
-    return Element::InvalidIndex;
+    if (positions.empty()) {
+        return;
+    }
+    this->elements = std::move(merged);
+    indexElements(positions);
+    this->revision++;
+}
+
+auto Layer::indexOf(Element* e) const -> Element::Index {
+    std::lock_guard lock(this->indexMutex);
+    return indexOfNoLock(e);
+}
+
+auto Layer::indexOfNoLock(const Element* e, size_t first) const -> Element::Index {
+    if (!e || e->parentLayer.layer != this || first >= this->elements.size()) {
+        return Element::InvalidIndex;
+    }
+    const uint64_t key = e->parentLayer.orderKey;
+    auto it = std::lower_bound(this->elements.begin() + as_signed(first), this->elements.end(), key,
+                               [](const ElementPtr& elt, uint64_t k) { return elt->parentLayer.orderKey < k; });
+    if (it == this->elements.end() || it->get() != e) {
+        return Element::InvalidIndex;
+    }
+    return static_cast<Element::Index>(it - this->elements.begin());
 }
 
 auto Layer::removeElement(Element* e) -> InsertionPosition {
-    for (unsigned int i = 0; i < this->elements.size(); i++) {
-        if (e == this->elements[i].get()) {
-            auto res = std::move(this->elements[i]);
-            this->elements.erase(this->elements.begin() + i);
-            return InsertionPosition{std::move(res), i};
-        }
+    if (const Element::Index i = indexOf(e); i != Element::InvalidIndex) {
+        auto res = std::move(this->elements[as_unsigned(i)]);
+        this->elements.erase(this->elements.begin() + i);
+        unindexElement(res.get());
+        this->revision++;
+        return InsertionPosition{std::move(res), i};
     }
 
     g_warning("Could not remove element from layer, it's not on the layer!");
@@ -91,33 +153,77 @@ auto Layer::removeElementAt(Element* e, Element::Index pos) -> InsertionPosition
         auto iter = std::next(this->elements.begin(), pos);
         auto res = std::move(*iter);
         this->elements.erase(iter);
+        unindexElement(res.get());
+        this->revision++;
         return InsertionPosition{std::move(res), pos};
     }
     return removeElement(e);
 }
 
 auto Layer::removeElementsAt(InsertionOrderRef const& elts) -> InsertionOrder {
-    InsertionOrder res;
-    res.reserve(elts.size());
-    auto endIndex = static_cast<Element::Index>(elements.size());
-    for (auto&& [e, p]: elts) {
-        xoj_assert(e);
-        auto pos = p;
-        if (pos < 0 || pos > endIndex || elements[static_cast<size_t>(pos)].get() != e) {
-            pos = indexOf(e);
-            if (pos == Element::InvalidIndex) {
-                g_warning("Could not remove element from layer, it's not on the layer!");
-                Stacktrace::printStracktrace();
+    // The positions are all found before any element is taken out, as the binary searches go through the elements
+    std::vector<size_t> positions;
+    positions.reserve(elts.size());
+    bool sorted = true;
+    bool missing = false;
+    {
+        std::lock_guard lock(this->indexMutex);
+        for (auto&& [e, pos]: elts) {
+            xoj_assert(e);
+            Element::Index i = pos;
+            if (pos < 0 || as_unsigned(pos) >= this->elements.size() || this->elements[as_unsigned(pos)].get() != e) {
+                i = indexOfNoLock(e);
+            }
+            if (i == Element::InvalidIndex) {
+                missing = true;
                 continue;
             }
+            sorted = sorted && (positions.empty() || positions.back() < as_unsigned(i));
+            positions.push_back(as_unsigned(i));
+        }
+    }
+    if (missing) {
+        g_warning("Could not remove element from layer, it's not on the layer!");
+        Stacktrace::printStracktrace();
+    }
+    if (!sorted) {
+        std::sort(positions.begin(), positions.end());
+        positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+    }
+
+    InsertionOrder res;
+    res.reserve(positions.size());
+    for (size_t i: positions) {
+        res.emplace_back(std::move(this->elements[i]), static_cast<Element::Index>(i));
+    }
+    if (res.empty()) {
+        return res;
+    }
+
+    {
+        std::lock_guard lock(this->indexMutex);
+        for (auto&& r: res) {
+            unindexElementNoLock(r.e.get());
         }
-        res.emplace_back(std::move(elements[static_cast<size_t>(pos)]), pos);
     }
     this->elements.erase(std::remove(this->elements.begin(), this->elements.end(), nullptr), this->elements.end());
+    this->revision++;
     return res;
 }
 
-auto Layer::clearNoFree() -> std::vector<ElementPtr> { return std::move(this->elements); }
+auto Layer::clearNoFree() -> std::vector<ElementPtr> {
+    {
+        std::lock_guard lock(this->indexMutex);
+        for (auto&& e: this->elements) {
+            e->parentLayer.layer = nullptr;
+            e->parentLayer.boundsDirty = false;
+        }
+        this->index.clear();
+        this->dirtyElements.clear();
+    }
+    this->revision++;
+    return std::move(this->elements);
+}
 
 auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
 
@@ -129,12 +235,171 @@ auto Layer::isVisible() const -> bool { return visible; }
 /**
  * @return true if the layer is visible
  */
-void Layer::setVisible(bool visible) { this->visible = visible; }
+void Layer::setVisible(bool visible) {
+    if (this->visible != visible) {
+        this->visible = visible;
+        this->visibilityChanges++;
+    }
+}
+
+auto Layer::getRevision() const -> uint64_t { return revision + visibilityChanges; }
+
+auto Layer::getBoundsRevision() const -> uint64_t {
+    std::lock_guard lock(this->indexMutex);
+    // The elements only notify their first move until the index is updated: the next move must increment the counter
+    updateIndex();
+    return boundsRevision;
+}
+
+auto Layer::getContentRevision() const -> uint64_t { return revision + getBoundsRevision() + elementChanges; }
+
+auto Layer::countElementChange(const Element* e) -> bool {
+    if (!e->parentLayer.layer) {
+        return false;
+    }
+    e->parentLayer.layer->elementChanges++;
+    return true;
+}
 
 auto Layer::getElements() const -> std::vector<ElementPtr> const& { return this->elements; }
 
+auto Layer::getElementsInArea(const Range& area) const -> std::vector<Element*> {
+    std::lock_guard lock(this->indexMutex);
+    updateIndex();
+
+    auto outside = [&area](const Element* e) {
+        auto r = e->boundingRect();
+        return r.x > area.maxX || r.x + r.width < area.minX || r.y > area.maxY || r.y + r.height < area.minY;
+    };
+
+    auto res = this->index.query(area);
+    if (2 * res.size() > this->elements.size()) {
+        // Most of the layer: filtering the whole list is cheaper than sorting the candidates
+        res.clear();
+        for (auto&& e: this->elements) {
+            if (!outside(e.get())) {
+                res.push_back(e.get());
+            }
+        }
+        return res;
+    }
+
+    res.erase(std::remove_if(res.begin(), res.end(), outside), res.end());
+    std::sort(res.begin(), res.end(), [](const Element* a, const Element* b) {
+        return a->parentLayer.orderKey < b->parentLayer.orderKey;
+    });
+    return res;
+}
+
+auto Layer::getElementsInAreaWithPositions(const Range& area) const -> InsertionOrderRef {
+    auto found = getElementsInArea(area);
+    InsertionOrderRef res;
+    res.reserve(found.size());
+    std::lock_guard lock(this->indexMutex);
+    // The elements are sorted: each one is after the previous one
+    size_t first = 0;
+    for (Element* e: found) {
+        if (const Element::Index i = indexOfNoLock(e, first); i != Element::InvalidIndex) {
+            res.emplace_back(e, i);
+            first = as_unsigned(i) + 1;
+        }
+    }
+    return res;
+}
+
+void Layer::elementBoundsChanged(Element* e) {
+    std::lock_guard lock(this->indexMutex);
+    this->dirtyElements.insert(e);
+    this->boundsRevision++;
+}
+
+void Layer::indexElement(Element* e, Element::Index pos) {
+    std::lock_guard lock(this->indexMutex);
+    const auto i = as_unsigned(pos);
+    const uint64_t prev = i > 0 ? this->elements[i - 1]->parentLayer.orderKey : 0;
+    const uint64_t next = i + 1 < this->elements.size() ? this->elements[i + 1]->parentLayer.orderKey :
+                                                          prev + 2 * ORDER_KEY_SPACING;
+    if (next - prev < 2) {
+        renumberOrderKeys();
+    } else {
+        e->parentLayer.orderKey = prev + (next - prev) / 2;
+    }
+
+    e->parentLayer.layer = this;
+    e->parentLayer.boundsDirty = true;
+    // The bounding box is computed lazily, as the element may not be complete yet (e.g. while loading a file)
+    this->dirtyElements.insert(e);
+}
+
+void Layer::indexElements(const std::vector<size_t>& positions) {
+    std::lock_guard lock(this->indexMutex);
+    // Spread the keys of each run of consecutive new elements between the keys of its neighbours
+    bool renumber = false;
+    for (size_t k = 0, l = 0; k < positions.size() && !renumber; k = l) {
+        for (l = k + 1; l < positions.size() && positions[l] == positions[l - 1] + 1; l++) {}
+        const size_t first = positions[k];
+        const size_t last = positions[l - 1] + 1;
+        const uint64_t count = l - k;
+        const uint64_t prev = first > 0 ? this->elements[first - 1]->parentLayer.orderKey : 0;
+        const uint64_t next = last < this->elements.size() ? this->elements[last]->parentLayer.orderKey :
+                                                             prev + (count + 1) * ORDER_KEY_SPACING;
+        if (next - prev <= count) {
+            renumber = true;
+        } else {
+            const uint64_t step = (next - prev) / (count + 1);
+            for (size_t j = 0; j < count; j++) {
+                this->elements[first + j]->parentLayer.orderKey = prev + (j + 1) * step;
+            }
+        }
+    }
+    if (renumber) {
+        renumberOrderKeys();
+    }
+
+    for (size_t pos: positions) {
+        Element* e = this->elements[pos].get();
+        e->parentLayer.layer = this;
+        e->parentLayer.boundsDirty = true;
+        this->dirtyElements.insert(e);
+    }
+}
+
+void Layer::unindexElement(Element* e) {
+    std::lock_guard lock(this->indexMutex);
+    unindexElementNoLock(e);
+}
+
+void Layer::unindexElementNoLock(Element* e) {
+    this->index.remove(e);
+    this->dirtyElements.erase(e);
+    e->parentLayer.layer = nullptr;
+    e->parentLayer.boundsDirty = false;
+}
+
+void Layer::renumberOrderKeys() {
+    uint64_t key = 0;
+    for (auto&& e: this->elements) {
+        key += ORDER_KEY_SPACING;
+        e->parentLayer.orderKey = key;
+    }
+}
+
+void Layer::updateIndex() const {
+    for (Element* e: this->dirtyElements) {
+        // Reset first: a concurrent change marks the element again
+        e->parentLayer.boundsDirty = false;
+        if (e->parentLayer.layer == this) {
+            this->index.insert(e, Range(e->boundingRect()));
+        }
+    }
+    this->dirtyElements.clear();
+}
+
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
 auto Layer::getName() const -> std::string { return name.value_or(""); }
 
-void Layer::setName(const std::string& newName) { this->name = newName; }
+void Layer::setName(const std::string& newName) {
+    this->name = newName;
+    this->revision++;
+}
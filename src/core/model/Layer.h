@@ -11,14 +11,21 @@
 
 #pragma once
 
-#include <cstddef>   // for size_t
-#include <memory>    // for unique_ptr
-#include <optional>  // for optional
-#include <string>    // for string
+#include <atomic>         // for atomic
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <memory>         // for unique_ptr
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_set>  // for unordered_set
 #include <vector>    // for vector
 
 #include "Element.h"  // for Element, Element::Index
 #include "ElementInsertionPosition.h"  // for InsertionOrder
+#include "util/SpatialGrid.h"          // for SpatialGrid
+
+class Range;
 
 template <class T>
 using optional = std::optional<T>;
@@ -46,7 +53,15 @@ public:
     void insertElement(ElementPtr e, Element::Index pos);
 
     /**
-     * Returns the index of the given Element with respect to the internal list
+     * Inserts the Element%s, sorted by position, as if they were inserted one after the other with insertElement().
+     * Elements with an invalid position are appended. Costs O(n) for the whole batch, instead of O(n) per Element.
+     *
+     * @note The page listeners are not notified: the caller should fire a single notification for the batch
+     */
+    void insertElements(InsertionOrder&& elts);
+
+    /**
+     * Returns the index of the given Element with respect to the internal list, in O(log n)
      */
     auto indexOf(Element* e) const -> Element::Index;
 
@@ -64,7 +79,9 @@ public:
     auto removeElementAt(Element* e, Element::Index pos) -> InsertionPosition;
 
     /**
-     * Removes the Elements. If an element cannot be found at its designated position, it is search through the layer
+     * Removes the Elements. If an element cannot be found at its designated position, it is searched through the layer
+     * (in a single pass for all such elements).
+     * @return The removed elements, sorted by their former positions
      */
     auto removeElementsAt(InsertionOrderRef const& elts) -> InsertionOrder;
 
@@ -78,6 +95,17 @@ public:
      */
     auto getElements() const -> std::vector<ElementPtr> const&;
 
+    /**
+     * Returns the Element%s whose bounding box intersects the given area, in the order of the Layer%s internal list.
+     * Uses a spatial index: prefer this to going through getElements() when only a part of the page is concerned.
+     */
+    auto getElementsInArea(const Range& area) const -> std::vector<Element*>;
+
+    /**
+     * Same as getElementsInArea(), along with the positions of the Element%s in the Layer%s internal list
+     */
+    auto getElementsInAreaWithPositions(const Range& area) const -> InsertionOrderRef;
+
     /**
      * Returns whether or not the Layer is empty
      */
@@ -93,6 +121,30 @@ public:
      */
     void setVisible(bool visible);
 
+    /**
+     * @return A counter incremented whenever an element is added or removed, or the visibility or the name changes.
+     *      Changes to the elements themselves are not tracked (the page listeners are notified of those).
+     */
+    auto getRevision() const -> uint64_t;
+
+    /**
+     * @return A counter incremented whenever an element of the layer is moved or resized
+     */
+    auto getBoundsRevision() const -> uint64_t;
+
+    /**
+     * @return A counter which changes whenever anything drawn of the layer changes: getRevision(), getBoundsRevision()
+     *      and the changes of its elements notified by the page (see PageHandler::fireElementChanged()). Showing or
+     *      hiding the layer does not change it.
+     */
+    auto getContentRevision() const -> uint64_t;
+
+    /**
+     * Count a change of the element in the content revision of its layer
+     * @return false if the element is not in a layer
+     */
+    static bool countElementChange(const Element* e);
+
     /**
      * Creates a deep copy of this Layer by copying all of the Element%s contained in it
      */
@@ -113,10 +165,60 @@ public:
      */
     void setName(const std::string& newName);
 
+private:
+    /**
+     * Called by the elements of the layer when they are moved or resized
+     */
+    void elementBoundsChanged(Element* e);
+
+    /**
+     * Add the element (which must be in `elements` already, at the given position) to the spatial index
+     */
+    void indexElement(Element* e, Element::Index pos);
+    /**
+     * Add the elements at the given positions (sorted, in `elements` already) to the spatial index
+     */
+    void indexElements(const std::vector<size_t>& positions);
+    void unindexElement(Element* e);
+    /**
+     * Same as unindexElement(). The caller must hold indexMutex.
+     */
+    void unindexElementNoLock(Element* e);
+    /**
+     * Same as indexOf(), searching from the position `first` on. The caller must hold indexMutex.
+     */
+    auto indexOfNoLock(const Element* e, size_t first = 0) const -> Element::Index;
+    /**
+     * Reassign evenly spaced order keys to all the elements. The caller must hold indexMutex.
+     */
+    void renumberOrderKeys();
+    /**
+     * Update the spatial index with the new bounds of the elements moved since the last query.
+     * The caller must hold indexMutex.
+     */
+    void updateIndex() const;
+
 private:
     std::vector<ElementPtr> elements;
 
     bool visible = true;
 
+    uint64_t revision = 0;
+    uint64_t visibilityChanges = 0;
+
     std::optional<std::string> name;
+
+    /**
+     * Spatial index of the elements. The order keys of the elements (see Element::LayerLink) increase along
+     * `elements`, so that the results of a query can be sorted, and the position of an element found, by comparing
+     * them. The index is updated lazily for moved elements (see dirtyElements).
+     * Guarded by indexMutex, as the order keys.
+     */
+    mutable std::mutex indexMutex;
+    mutable xoj::util::SpatialGrid<Element*> index;
+    mutable std::unordered_set<Element*> dirtyElements;
+    uint64_t boundsRevision = 0;
+    std::atomic<uint64_t> elementChanges{0};
+
+    friend class Element;
 };
@@ -0,0 +1,34 @@
+/*
+ * Xournal++
+ *
+ * Reads the layers of a page on demand
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <vector>  // for vector
+
+class Layer;
+
+/**
+ * @brief Source of the layers of a page which were left in the file when the document was opened.
+ *
+ * Shared by the page and its copies of the document. load() may be called from any thread, for different pages at
+ * the same time.
+ */
+class PageContentLoader {
+public:
+    virtual ~PageContentLoader() = default;
+
+    /**
+     * @brief Build the layers of the page again from the file
+     * @param layers Receives the new layers, owned by the caller. Filled as much as possible, even on failure.
+     * @return false if the content could not be read entirely
+     */
+    virtual bool load(std::vector<Layer*>& layers) const = 0;
+};
@@ -1,5 +1,7 @@
 #include "PageHandler.h"
 
+#include "model/Layer.h"  // for Layer
+
 #include "PageListener.h"  // for PageListener
 
 namespace xoj::util {
@@ -18,23 +20,43 @@ void PageHandler::addListener(PageListener* l) { this->listeners.push_back(l); }
 void PageHandler::removeListener(PageListener* l) { this->listeners.remove(l); }
 
 void PageHandler::fireRectChanged(Rectangle<double>& rect) {
+    this->changeCount++;
+    this->pageWideChangeCount++;
     for (PageListener* pl: this->listeners) { pl->rectChanged(rect); }
 }
 
 void PageHandler::fireRangeChanged(Range& range) {
+    this->changeCount++;
+    this->pageWideChangeCount++;
     for (PageListener* pl: this->listeners) { pl->rangeChanged(range); }
 }
 
 void PageHandler::fireElementChanged(Element* elem) {
+    this->changeCount++;
+    if (!Layer::countElementChange(elem)) {
+        this->pageWideChangeCount++;
+    }
     for (PageListener* pl: this->listeners) { pl->elementChanged(elem); }
 }
 
 void PageHandler::fireElementsChanged(const std::vector<Element*>& elements, Range range) {
+    this->changeCount++;
+    bool inLayers = true;
+    for (const Element* e: elements) { inLayers = Layer::countElementChange(e) && inLayers; }
+    if (!inLayers) {
+        this->pageWideChangeCount++;
+    }
     for (PageListener* pl: this->listeners) {
         pl->elementsChanged(elements, range);
     }
 }
 
 void PageHandler::firePageChanged() {
+    this->changeCount++;
+    this->pageWideChangeCount++;
     for (PageListener* pl: this->listeners) { pl->pageChanged(); }
 }
+
+auto PageHandler::getChangeCount() const -> uint64_t { return this->changeCount; }
+
+auto PageHandler::getPageWideChangeCount() const -> uint64_t { return this->pageWideChangeCount; }
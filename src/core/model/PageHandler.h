@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <list>  // for list
+#include <atomic>   // for atomic
+#include <cstdint>  // for uint64_t
+#include <list>     // for list
 #include <vector>
 
 #include "util/Range.h"  // for Range
@@ -36,11 +38,24 @@ public:
     /**
      * @brief The listed elements have been changed
      * @param range (optional) if provided, the Range must contain the bounding boxes of the changed elements, both
-     * before and after they were changed
+     * before and after they were changed. If not, the current bounding boxes of the elements are used.
+     *
+     * Prefer this to one fireElementChanged() per element when many elements are inserted or removed at once.
      */
     void fireElementsChanged(const std::vector<Element*>& elements, Range range = Range());
     void firePageChanged();
 
+    /**
+     * @return A counter incremented by each of the notifications above
+     */
+    uint64_t getChangeCount() const;
+
+    /**
+     * @return A counter incremented by the notifications above which are not only about elements in a layer (the
+     *      others are counted in the content revision of the layers, see Layer::getContentRevision())
+     */
+    uint64_t getPageWideChangeCount() const;
+
 private:
     void addListener(PageListener* l);
     void removeListener(PageListener* l);
@@ -48,5 +63,8 @@ private:
 private:
     std::list<PageListener*> listeners;
 
+    std::atomic<uint64_t> changeCount{0};
+    std::atomic<uint64_t> pageWideChangeCount{0};
+
     friend class PageListener;
 };
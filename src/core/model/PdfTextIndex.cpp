@@ -0,0 +1,81 @@
+#include "PdfTextIndex.h"
+
+#include <algorithm>  // for all_of
+#include <utility>    // for move
+
+#include <glib.h>  // for g_utf8_normalize, g_utf8_casefold, g_free
+
+PdfTextIndex::PdfTextIndex(size_t pageCount): states(pageCount, State::UNKNOWN), texts(pageCount) {}
+
+void PdfTextIndex::setPageText(size_t pdfPage, std::string_view text) {
+    std::string normalized = normalize(text);
+
+    std::lock_guard lock(this->mutex);
+    if (pdfPage < this->states.size()) {
+        this->texts[pdfPage] = std::move(normalized);
+        this->states[pdfPage] = State::INDEXED;
+    }
+}
+
+auto PdfTextIndex::mayContain(size_t pdfPage, const std::string& text) const -> bool {
+    const std::string pattern = normalize(text);
+
+    std::lock_guard lock(this->mutex);
+    if (pdfPage >= this->states.size() || this->states[pdfPage] != State::INDEXED) {
+        return true;
+    }
+    return this->texts[pdfPage].find(pattern) != std::string::npos;
+}
+
+auto PdfTextIndex::takePagesToIndex() -> std::vector<size_t> {
+    std::vector<size_t> pages;
+
+    std::lock_guard lock(this->mutex);
+    for (size_t i = 0; i < this->states.size(); i++) {
+        if (this->states[i] == State::UNKNOWN) {
+            this->states[i] = State::EXTRACTING;
+            pages.push_back(i);
+        }
+    }
+    return pages;
+}
+
+void PdfTextIndex::cancelPages(const std::vector<size_t>& pdfPages) {
+    std::lock_guard lock(this->mutex);
+    for (size_t page: pdfPages) {
+        if (page < this->states.size() && this->states[page] == State::EXTRACTING) {
+            this->states[page] = State::UNKNOWN;
+        }
+    }
+}
+
+auto PdfTextIndex::isComplete() const -> bool {
+    std::lock_guard lock(this->mutex);
+    return std::all_of(this->states.begin(), this->states.end(), [](State s) { return s == State::INDEXED; });
+}
+
+auto PdfTextIndex::normalize(std::string_view text) -> std::string {
+    gchar* composed = g_utf8_normalize(text.data(), static_cast<gssize>(text.size()), G_NORMALIZE_ALL_COMPOSE);
+    if (!composed) {
+        // Not valid UTF-8: keep the bytes as they are
+        return std::string(text);
+    }
+    gchar* folded = g_utf8_casefold(composed, -1);
+    g_free(composed);
+
+    std::string result;
+    bool space = false;
+    for (const gchar* c = folded; *c; c++) {
+        if (g_ascii_isspace(*c)) {
+            space = true;
+            continue;
+        }
+        if (space && !result.empty()) {
+            result += ' ';
+        }
+        space = false;
+        result += *c;
+    }
+    g_free(folded);
+    return result;
+}
@@ -0,0 +1,75 @@
+/*
+ * Xournal++
+ *
+ * The text of the pages of the pdf background, kept in memory for the search
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <mutex>        // for mutex
+#include <string>       // for string
+#include <string_view>  // for string_view
+#include <vector>       // for vector
+
+/**
+ * @brief Holds the text of the pages of a pdf document, extracted once by background jobs (see PdfTextIndexJob), to
+ * find the pages which may contain a searched text without asking poppler to extract the text of every page again.
+ *
+ * The texts and the searched texts are normalized the same way (compatibility composition, case folding, every run of
+ * white spaces as a single space), which only ever makes more pages match. A page whose text is not known yet may
+ * always contain the searched text: the index only rules out pages, the matches themselves are still found on the
+ * remaining pages by XojPdfPage::findText.
+ *
+ * Each pdf document loaded has its own index (see Document::getPdfTextIndex). The methods may be called from any
+ * thread.
+ */
+class PdfTextIndex {
+public:
+    explicit PdfTextIndex(size_t pageCount);
+
+    /**
+     * Store the text of a pdf page
+     */
+    void setPageText(size_t pdfPage, std::string_view text);
+
+    /**
+     * @return false if the pdf page is known not to contain text
+     */
+    bool mayContain(size_t pdfPage, const std::string& text) const;
+
+    /**
+     * @return The pages whose text is neither known nor already being extracted, now marked as being extracted
+     */
+    std::vector<size_t> takePagesToIndex();
+
+    /**
+     * The extraction of the pages, as returned by takePagesToIndex(), was abandoned: they may be taken again
+     */
+    void cancelPages(const std::vector<size_t>& pdfPages);
+
+    /**
+     * @return true if the text of every page is known
+     */
+    bool isComplete() const;
+
+    /**
+     * Normalize the (UTF-8) text: compatibility composition, case folding, and every run of white spaces as one space
+     */
+    static std::string normalize(std::string_view text);
+
+private:
+    enum class State { UNKNOWN, EXTRACTING, INDEXED };
+
+    mutable std::mutex mutex;
+
+    std::vector<State> states;
+
+    /// The normalized text of the indexed pages
+    std::vector<std::string> texts;
+};
@@ -0,0 +1,86 @@
+#include "SegmentHitKernel.h"
+
+#include <algorithm>  // for max
+#include <cmath>      // for abs, sqrt
+
+#ifdef __SSE2__
+#include <emmintrin.h>  // for __m128d, _mm_*
+#endif
+
+namespace {
+/// Leniency of the tests, in points: far larger than the rounding errors, far smaller than what can be seen
+constexpr double SLACK = 1e-6;
+}  // namespace
+
+SegmentHitKernel::SegmentHitKernel(double x, double y, double halfEraserSize, double padding):
+        x(x),
+        y(y),
+        hi(halfEraserSize + SLACK),
+        lo(std::max(halfEraserSize - SLACK, 0.0)),
+        hi2(hi * hi),
+        lo2(lo * lo),
+        reach(padding + SLACK + hi * std::sqrt(2)) {}
+
+auto SegmentHitKernel::findCandidate(const Point* points, size_t first, size_t last) const -> size_t {
+    size_t i = first;
+#ifdef __SSE2__
+    const __m128d cx = _mm_set1_pd(this->x);
+    const __m128d cy = _mm_set1_pd(this->y);
+    const __m128d hi = _mm_set1_pd(this->hi);
+    const __m128d hi2 = _mm_set1_pd(this->hi2);
+    const __m128d lo2 = _mm_set1_pd(this->lo2);
+    const __m128d reach = _mm_set1_pd(this->reach);
+    const __m128d half = _mm_set1_pd(0.5);
+    const __m128d absMask = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffff));
+    // Segments i and i + 1 at a time. The points are not stored by coordinate, so they are loaded one by one.
+    for (; i + 1 <= last; i += 2) {
+        const Point& a0 = points[i];
+        const Point& a1 = points[i + 1];
+        const Point& b1 = points[i + 2];
+        const __m128d ax = _mm_set_pd(a1.x, a0.x);
+        const __m128d ay = _mm_set_pd(a1.y, a0.y);
+        const __m128d bx = _mm_set_pd(b1.x, a1.x);
+        const __m128d by = _mm_set_pd(b1.y, a1.y);
+
+        // The end of the segment is in the eraser square
+        const __m128d inSquare = _mm_and_pd(_mm_cmple_pd(_mm_and_pd(_mm_sub_pd(bx, cx), absMask), hi),
+                                            _mm_cmple_pd(_mm_and_pd(_mm_sub_pd(by, cy), absMask), hi));
+
+        // The center is close enough to the line, and to the middle of the segment
+        const __m128d dx = _mm_sub_pd(bx, ax);
+        const __m128d dy = _mm_sub_pd(by, ay);
+        const __m128d len2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        const __m128d cross = _mm_sub_pd(_mm_mul_pd(_mm_sub_pd(cy, ay), dx), _mm_mul_pd(_mm_sub_pd(cx, ax), dy));
+        const __m128d mx = _mm_sub_pd(cx, _mm_mul_pd(_mm_add_pd(ax, bx), half));
+        const __m128d my = _mm_sub_pd(cy, _mm_mul_pd(_mm_add_pd(ay, by), half));
+        const __m128d dist2 = _mm_add_pd(_mm_mul_pd(mx, mx), _mm_mul_pd(my, my));
+        const __m128d radius = _mm_add_pd(_mm_mul_pd(_mm_sqrt_pd(len2), half), reach);
+        const __m128d nearLine = _mm_and_pd(
+                _mm_and_pd(_mm_cmpge_pd(len2, lo2), _mm_cmple_pd(_mm_mul_pd(cross, cross), _mm_mul_pd(hi2, len2))),
+                _mm_cmple_pd(dist2, _mm_mul_pd(radius, radius)));
+
+        if (const int mask = _mm_movemask_pd(_mm_or_pd(inSquare, nearLine)); mask != 0) {
+            return (mask & 1) ? i : i + 1;
+        }
+    }
+#endif
+    for (; i <= last; i++) {
+        const Point& a = points[i];
+        const Point& b = points[i + 1];
+        const bool inSquare = (std::abs(b.x - this->x) <= this->hi) & (std::abs(b.y - this->y) <= this->hi);
+
+        const double dx = b.x - a.x;
+        const double dy = b.y - a.y;
+        const double len2 = dx * dx + dy * dy;
+        const double cross = (this->y - a.y) * dx - (this->x - a.x) * dy;
+        const double mx = this->x - (a.x + b.x) * 0.5;
+        const double my = this->y - (a.y + b.y) * 0.5;
+        const double radius = std::sqrt(len2) * 0.5 + this->reach;
+        const bool nearLine = (len2 >= this->lo2) & (cross * cross <= this->hi2 * len2) &
+                              (mx * mx + my * my <= radius * radius);
+        if (inSquare | nearLine) {
+            return i;
+        }
+    }
+    return i;
+}
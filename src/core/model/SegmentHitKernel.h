@@ -0,0 +1,53 @@
+/*
+ * Xournal++
+ *
+ * Batched hit-test of the segments of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+#include "Point.h"  // for Point
+
+/**
+ * Finds the segments of a polyline which may be hit by the eraser square of Stroke::intersects(), without any square
+ * root or division but one square root per segment: the distances are compared squared. It tests two segments at a
+ * time with SSE2 where available (always on x86-64), and otherwise has no branch within a segment.
+ *
+ * The tests are slightly more lenient than those of Stroke::intersects(), so that rounding errors never make a hit
+ * segment missed: the candidates are to be confirmed by the exact test.
+ *
+ * Segment i goes from points[i] to points[i + 1].
+ */
+class SegmentHitKernel {
+public:
+    /**
+     * @param x, y The center of the eraser square
+     * @param halfEraserSize Half the side of the eraser square
+     * @param padding The padding along the segments of Stroke::intersects()
+     */
+    SegmentHitKernel(double x, double y, double halfEraserSize, double padding);
+
+    /**
+     * @return The index of the first of the segments [first, last] which may be hit, or last + 1 if none can
+     */
+    size_t findCandidate(const Point* points, size_t first, size_t last) const;
+
+private:
+    double x;
+    double y;
+    /// halfEraserSize, a bit larger or a bit smaller depending on the test
+    double hi;
+    double lo;
+    /// hi * hi and lo * lo
+    double hi2;
+    double lo2;
+    /// What a segment's half-length is added to, to get the largest distance from its middle to the eraser center
+    double reach;
+};
@@ -0,0 +1,76 @@
+/*
+ * Xournal++
+ *
+ * Copy-on-write storage of the points of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr, make_shared
+#include <utility>  // for move
+#include <vector>   // for vector
+
+#include "Point.h"  // for Point
+
+/**
+ * The points of a stroke, shared by its copies (e.g. the clones kept by the undo actions, in the clipboard or on a
+ * copied page) until one of them is modified.
+ *
+ * Only read accessors are provided: makeMutable() gives write access, after copying the points if they are shared.
+ * Like the rest of the stroke, this is guarded by the document lock.
+ */
+class SharedPoints {
+public:
+    using const_iterator = std::vector<Point>::const_iterator;
+
+    SharedPoints() = default;
+    SharedPoints(std::vector<Point> points):
+            buffer(points.empty() ? nullptr : std::make_shared<std::vector<Point>>(std::move(points))) {}
+
+    auto getVector() const -> const std::vector<Point>& { return buffer ? *buffer : getEmptyVector(); }
+
+    /**
+     * @return The points, which are copied first if they are shared with another stroke
+     */
+    auto makeMutable() -> std::vector<Point>& {
+        if (!buffer) {
+            buffer = std::make_shared<std::vector<Point>>();
+        } else if (buffer.use_count() > 1) {
+            buffer = std::make_shared<std::vector<Point>>(*buffer);
+        }
+        return *buffer;
+    }
+
+    /**
+     * @return true if the points are shared with another stroke
+     */
+    auto isShared() const -> bool { return buffer && buffer.use_count() > 1; }
+
+    auto size() const -> size_t { return getVector().size(); }
+    auto empty() const -> bool { return getVector().empty(); }
+    auto data() const -> const Point* { return getVector().data(); }
+
+    auto operator[](size_t i) const -> const Point& { return (*buffer)[i]; }
+    auto at(size_t i) const -> const Point& { return getVector().at(i); }
+    auto front() const -> const Point& { return buffer->front(); }
+    auto back() const -> const Point& { return buffer->back(); }
+
+    auto begin() const -> const_iterator { return getVector().begin(); }
+    auto end() const -> const_iterator { return getVector().end(); }
+    auto cbegin() const -> const_iterator { return getVector().cbegin(); }
+    auto cend() const -> const_iterator { return getVector().cend(); }
+
+private:
+    static auto getEmptyVector() -> const std::vector<Point>& {
+        static const std::vector<Point> empty;
+        return empty;
+    }
+
+    std::shared_ptr<std::vector<Point>> buffer;
+};
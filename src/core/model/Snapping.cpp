@@ -4,7 +4,9 @@
 #include <cmath>      // for pow, atan2, cos, hypot, remainder, sin, abs
 #include <cstdlib>    // for abs
 
-#include "model/Point.h"  // for Point
+#include "model/Element.h"  // for Element, ELEMENT_STROKE
+#include "model/Point.h"    // for Point
+#include "model/Stroke.h"   // for Stroke
 
 namespace Snapping {
 
@@ -60,4 +62,33 @@ double distanceLine(Point const& pos, Point const& first, Point const& second) {
     }
 }
 
+std::optional<Point> snapToVertices(Point const& pos, std::vector<Element*> const& elements, double radius) {
+    std::optional<Point> nearest;
+    double nearestDistance = radius;
+    auto consider = [&](Point const& p) {
+        double d = distance(p, pos);
+        if (d < nearestDistance) {
+            nearestDistance = d;
+            nearest = Point(p.x, p.y, pos.z);
+        }
+    };
+
+    for (Element* e: elements) {
+        if (e->getType() != ELEMENT_STROKE) {
+            continue;
+        }
+        auto const& points = static_cast<Stroke*>(e)->getPointVector();
+        if (points.empty()) {
+            continue;
+        }
+        if (points.size() <= MAX_SHAPE_POINTS) {
+            for (auto const& p: points) { consider(p); }
+        } else {
+            consider(points.front());
+            consider(points.back());
+        }
+    }
+    return nearest;
+}
+
 }  // namespace Snapping
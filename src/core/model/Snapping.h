@@ -10,8 +10,14 @@
  */
 #pragma once
 
+#include <cstddef>   // for size_t
+#include <optional>  // for optional
+#include <vector>    // for vector
+
 #include "Point.h"
 
+class Element;
+
 namespace Snapping {
 
 /**
@@ -74,4 +80,18 @@ namespace Snapping {
  */
 [[nodiscard]] double distanceLine(Point const& pos, Point const& first, Point const& second);
 
+/// Strokes with at most this many points are shapes (lines, rectangles, arrows...): all of their points are vertices
+constexpr size_t MAX_SHAPE_POINTS = 16;
+
+/**
+ * @brief Looks for the nearest vertex of the given strokes: their endpoints, and all the points of the strokes with
+ * at most MAX_SHAPE_POINTS points. The elements which are not strokes are ignored.
+ * @param pos the position
+ * @param elements the candidate elements, e.g. those near pos according to the spatial index of their layer
+ * @param radius the maximal distance to pos
+ * @return the nearest vertex (with the pressure of pos), or nothing if there is no vertex within the radius
+ */
+[[nodiscard]] std::optional<Point> snapToVertices(Point const& pos, std::vector<Element*> const& elements,
+                                                  double radius);
+
 }  // namespace Snapping
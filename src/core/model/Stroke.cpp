@@ -4,8 +4,7 @@
 #include <cmath>      // for abs, hypot, sqrt
 #include <cstdint>    // for uint64_t
 #include <iterator>   // for back_insert_iterator
-#include <limits>     // for numeric_limits
-#include <memory>
+#include <memory>     // for make_shared
 #include <numeric>    // for accumulate
 #include <optional>   // for optional, nullopt
 #include <string>     // for to_string, operator<<
@@ -14,11 +13,18 @@
 #include <glib.h>   // for g_free, g_message
 
 #include "eraser/PaddedBox.h"                     // for PaddedBox
+#include "model/ArcLengthTable.h"                 // for ArcLengthTable
 #include "model/AudioElement.h"                   // for AudioElement
+#include "model/CompactPoints.h"                  // for CompactPoints
 #include "model/Element.h"                        // for Element, ELEMENT_ST...
 #include "model/LineStyle.h"                      // for LineStyle
 #include "model/Point.h"                          // for Point, Point::NO_PR...
+#include "model/SegmentHitKernel.h"               // for SegmentHitKernel
+#include "model/StrokeDetailLevels.h"             // for StrokeDetailLevels
+#include "model/StrokeOutline.h"                  // for StrokeOutline
+#include "model/StrokeSegmentTree.h"              // for StrokeSegmentTree
 #include "util/Assert.h"                          // for xoj_assert
+#include "util/FixedSizePool.h"                   // for FixedSizePool
 #include "util/BasePointerIterator.h"             // for BasePointerIterator
 #include "util/Interval.h"                        // for Interval
 #include "util/PairView.h"                        // for PairView<>::BaseIte...
@@ -77,11 +83,44 @@ constexpr void updateSnappedBounds(Rectangle<Float>& snap, Point const& p) {
     }
 }
 
+/**
+ * Apply an affine transformation to the coordinates of the points. The transformation is inlined, unlike in
+ * cairo_matrix_transform_point(), so that the compiler can vectorize the loop.
+ */
+static void transformPoints(std::vector<Point>& points, const cairo_matrix_t& matrix) {
+    const double xx = matrix.xx;
+    const double xy = matrix.xy;
+    const double yx = matrix.yx;
+    const double yy = matrix.yy;
+    const double x0 = matrix.x0;
+    const double y0 = matrix.y0;
+    for (Point& p: points) {
+        const double px = p.x;
+        const double py = p.y;
+        p.x = xx * px + xy * py + x0;
+        p.y = yx * px + yy * py + y0;
+    }
+}
 
 Stroke::Stroke(): AudioElement(ELEMENT_STROKE) {}
 
 Stroke::~Stroke() = default;
 
+using StrokePool = xoj::util::FixedSizePool<sizeof(Stroke), alignof(Stroke)>;
+
+void* Stroke::operator new(size_t size) {
+    // The size differs for derived classes
+    return size == sizeof(Stroke) ? StrokePool::allocate() : ::operator new(size);
+}
+
+void Stroke::operator delete(void* ptr, size_t size) {
+    if (size == sizeof(Stroke)) {
+        StrokePool::deallocate(ptr);
+    } else {
+        ::operator delete(ptr);
+    }
+}
+
 /**
  * Clone style attributes, but not the data (position, pressure etc.)
  */
@@ -100,18 +139,23 @@ auto Stroke::cloneStroke() const -> std::unique_ptr<Stroke> {
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
     s->points = this->points;
+    s->compactedPoints = this->compactedPoints;
+    s->segmentTree = this->segmentTree;
+    s->arcLengths = this->arcLengths;
+    s->detailLevels = this->detailLevels;
     s->x = this->x;
     s->y = this->y;
     s->Element::width = this->Element::width;
     s->Element::height = this->Element::height;
     s->snappedBounds = this->snappedBounds;
-    s->sizeCalculated = this->sizeCalculated;
+    s->sizeCalculated = this->sizeCalculated.load();
     return s;
 }
 
 auto Stroke::clone() const -> ElementPtr { return this->cloneStroke(); }
 
 std::unique_ptr<Stroke> Stroke::cloneSection(const PathParameter& lowerBound, const PathParameter& upperBound) const {
+    this->expandPoints();
     xoj_assert(lowerBound.isValid() && upperBound.isValid());
     xoj_assert(lowerBound <= upperBound);
     xoj_assert(upperBound.index < this->points.size() - 1);
@@ -119,24 +163,26 @@ std::unique_ptr<Stroke> Stroke::cloneSection(const PathParameter& lowerBound, co
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
 
-    s->points.reserve(upperBound.index - lowerBound.index + 2);
+    auto& newPoints = s->points.makeMutable();
+    newPoints.reserve(upperBound.index - lowerBound.index + 2);
 
-    s->points.emplace_back(this->getPoint(lowerBound));
+    newPoints.emplace_back(this->getPoint(lowerBound));
 
     auto beginIt = std::next(this->points.cbegin(), (std::ptrdiff_t)lowerBound.index + 1);
     auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)upperBound.index + 1);
-    std::copy(beginIt, endIt, std::back_inserter(s->points));
+    std::copy(beginIt, endIt, std::back_inserter(newPoints));
 
-    s->points.emplace_back(this->getPoint(upperBound));
+    newPoints.emplace_back(this->getPoint(upperBound));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    newPoints.back().z = Point::NO_PRESSURE;
 
     return s;
 }
 
 std::unique_ptr<Stroke> Stroke::cloneCircularSectionOfClosedStroke(const PathParameter& startParam,
                                                                    const PathParameter& endParam) const {
+    this->expandPoints();
     xoj_assert(startParam.isValid() && endParam.isValid());
     xoj_assert(endParam < startParam);
     xoj_assert(startParam.index < this->points.size() - 1);
@@ -144,27 +190,29 @@ std::unique_ptr<Stroke> Stroke::cloneCircularSectionOfClosedStroke(const PathPar
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
 
-    s->points.reserve(this->points.size() - startParam.index + endParam.index + 1);
+    auto& newPoints = s->points.makeMutable();
+    newPoints.reserve(this->points.size() - startParam.index + endParam.index + 1);
 
-    s->points.emplace_back(this->getPoint(startParam));
+    newPoints.emplace_back(this->getPoint(startParam));
 
     auto startIt = std::next(this->points.cbegin(), (std::ptrdiff_t)startParam.index + 1);
     // Skip the last point: points.back().equalPos(points.front()) == true and we want this point only once
     xoj_assert(startIt != this->points.cend());
-    std::copy(startIt, std::prev(this->points.cend()), std::back_inserter(s->points));
+    std::copy(startIt, std::prev(this->points.cend()), std::back_inserter(newPoints));
 
     auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)endParam.index + 1);
-    std::copy(this->points.cbegin(), endIt, std::back_inserter(s->points));
+    std::copy(this->points.cbegin(), endIt, std::back_inserter(newPoints));
 
-    s->points.emplace_back(this->getPoint(endParam));
+    newPoints.emplace_back(this->getPoint(endParam));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    newPoints.back().z = Point::NO_PRESSURE;
 
     return s;
 }
 
 void Stroke::serialize(ObjectOutputStream& out) const {
+    this->expandPoints();
     out.writeObject("Stroke");
 
     this->AudioElement::serialize(out);
@@ -185,6 +233,7 @@ void Stroke::serialize(ObjectOutputStream& out) const {
 }
 
 void Stroke::readSerialized(ObjectInputStream& in) {
+    auto& points = this->preparePointsModification();
     in.readObject("Stroke");
 
     this->AudioElement::readSerialized(in);
@@ -197,7 +246,7 @@ void Stroke::readSerialized(ObjectInputStream& in) {
 
     this->capStyle = static_cast<StrokeCapStyle>(in.readInt());
 
-    in.readData(this->points);
+    in.readData(points);
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -221,13 +270,30 @@ auto Stroke::getFill() const -> int { return fill; }
  */
 void Stroke::setFill(int fill) { this->fill = fill; }
 
-void Stroke::setWidth(double width) { this->width = width; }
+void Stroke::setWidth(double width) {
+    this->width = width;
+    boundsChanged();
+}
 
 auto Stroke::getWidth() const -> double { return this->width; }
 
 auto Stroke::rescaleWithMirror() -> bool { return true; }
 
 auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
+    this->expandPoints();
+
+    // A stroke partially in the selection usually leaves it over a long run of points: test a sample of the points
+    // first to reject it early
+    constexpr size_t SAMPLE_STEP = 16;
+    const size_t n = this->points.size();
+    if (n > SAMPLE_STEP) {
+        for (size_t i = SAMPLE_STEP - 1; i < n; i += SAMPLE_STEP) {
+            if (!container->contains(this->points[i].x, this->points[i].y)) {
+                return false;
+            }
+        }
+    }
+
     for (auto&& p: this->points) {
         double px = p.x;
         double py = p.y;
@@ -241,7 +307,25 @@ auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    this->preparePointsModification().emplace_back(p);
+    boundsChanged();
+    if (!sizeCalculated) {
+        return;
+    }
+
+    if (hasPressure()) {
+        updateBoundsLastTwoPressures();
+    } else {
+        updateBoundingBox(Element::x, Element::y, Element::width, Element::height, p, 0.5 * this->width);
+        updateSnappedBounds(Element::snappedBounds, p);
+    }
+}
+
+void Stroke::setLastPoint(const Point& p) {
+    auto& points = this->preparePointsModification();
+    xoj_assert(!points.empty());
+    points.back() = p;
+    boundsChanged();
     if (!sizeCalculated) {
         return;
     }
@@ -254,16 +338,24 @@ void Stroke::addPoint(const Point& p) {
     }
 }
 
-auto Stroke::getPointCount() const -> size_t { return this->points.size(); }
+auto Stroke::getPointCount() const -> size_t {
+    return this->points.empty() && this->compactedPoints ? this->compactedPoints->size() : this->points.size();
+}
 
-auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
+auto Stroke::getPointVector() const -> std::vector<Point> const& {
+    this->expandPoints();
+    return this->points.getVector();
+}
 
 void Stroke::deletePointsFrom(size_t index) {
+    auto& points = this->preparePointsModification();
     points.resize(std::min(index, points.size()));
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Stroke::getPoint(size_t index) const -> Point {
+    this->expandPoints();
     if (index < 0 || index >= this->points.size()) {
         g_warning("Stroke::getPoint(%zu) out of bounds!", index);
         return Point(0., 0., Point::NO_PRESSURE);
@@ -272,6 +364,7 @@ auto Stroke::getPoint(size_t index) const -> Point {
 }
 
 Point Stroke::getPoint(PathParameter parameter) const {
+    this->expandPoints();
     xoj_assert(parameter.isValid() && parameter.index < this->points.size() - 1);
 
     const Point& p = this->points[parameter.index];
@@ -280,9 +373,109 @@ Point Stroke::getPoint(PathParameter parameter) const {
     return res;
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
+auto Stroke::getPoints() const -> const Point* {
+    this->expandPoints();
+    return this->points.data();
+}
+
+auto Stroke::compact() -> bool {
+    if (this->points.empty() || this->erasable) {
+        return false;
+    }
+    if (!this->compactedPoints) {
+        this->compactedPoints = std::make_shared<const CompactPoints>(this->points.getVector());
+        // The expanded points will be rounded
+        this->segmentTree.reset();
+        this->arcLengths.reset();
+    }
+    // Like the expanded points, the simplified ones are computed again when needed
+    this->detailLevels.reset();
+    this->outline.reset();
+    this->points = SharedPoints();
+    return true;
+}
+
+auto Stroke::isCompacted() const -> bool { return this->points.empty() && this->compactedPoints; }
+
+void Stroke::writePoints(ObjectOutputStream& out) const {
+    this->expandPoints();
+    out.writeData(this->points.getVector());
+}
+
+void Stroke::dropPoints() {
+    // The bounds are kept as they are
+    getSnappedBounds();
+    this->points = SharedPoints();
+    this->compactedPoints.reset();
+    this->segmentTree.reset();
+    this->arcLengths.reset();
+    this->detailLevels.reset();
+    this->outline.reset();
+}
+
+void Stroke::readPoints(ObjectInputStream& in) {
+    std::vector<Point> pts;
+    in.readData(pts);
+    restorePoints(std::move(pts));
+}
+
+void Stroke::restorePoints(std::vector<Point> pts) {
+    this->points = std::move(pts);
+    this->outline.reset();
+}
+
+auto Stroke::getPointsMemorySize() const -> size_t { return getPointCount() * sizeof(Point); }
+
+void Stroke::expandPoints() const {
+    if (this->points.empty() && this->compactedPoints) {
+        this->points = this->compactedPoints->expand();
+    }
+}
+
+auto Stroke::preparePointsModification() -> std::vector<Point>& {
+    expandPoints();
+    this->compactedPoints.reset();
+    this->segmentTree.reset();
+    this->arcLengths.reset();
+    this->detailLevels.reset();
+    this->outline.reset();
+    return this->points.makeMutable();
+}
+
+auto Stroke::getSegmentTree() const -> const StrokeSegmentTree* {
+    if (!this->segmentTree && this->points.size() > StrokeSegmentTree::MIN_SEGMENT_COUNT) {
+        this->segmentTree = std::make_shared<const StrokeSegmentTree>(this->points.getVector());
+    }
+    return this->segmentTree.get();
+}
+
+auto Stroke::getArcLengthTable() const -> const ArcLengthTable& {
+    if (!this->arcLengths) {
+        this->arcLengths = std::make_shared<const ArcLengthTable>(getPointVector());
+    }
+    return *this->arcLengths;
+}
+
+auto Stroke::getSimplifiedPointVector(double tolerance) const -> const std::vector<Point>& {
+    const std::vector<Point>& pts = getPointVector();
+    if (tolerance < StrokeDetailLevels::MIN_TOLERANCE || pts.size() < StrokeDetailLevels::MIN_POINT_COUNT) {
+        return pts;
+    }
+    if (!this->detailLevels) {
+        this->detailLevels = std::make_shared<StrokeDetailLevels>();
+    }
+    return this->detailLevels->get(pts, tolerance);
+}
+
+auto Stroke::getOutline() const -> StrokeOutline& {
+    if (!this->outline) {
+        this->outline = std::make_shared<StrokeOutline>();
+    }
+    return *this->outline;
+}
 
 void Stroke::setPointVectorInternal(const Range* const snappingBox) {
+    boundsChanged();
     if (!snappingBox || this->points.empty() || this->points.front().z != Point::NO_PRESSURE) {
         // We cannot deduce the bounding box from the snapping box if the stroke has pressure values
         this->sizeCalculated = false;
@@ -298,17 +491,34 @@ void Stroke::setPointVectorInternal(const Range* const snappingBox) {
 }
 
 void Stroke::setPointVector(const std::vector<Point>& other, const Range* const snappingBox) {
+    this->compactedPoints.reset();
+    this->segmentTree.reset();
+    this->arcLengths.reset();
+    this->detailLevels.reset();
+    this->outline.reset();
     this->points = other;
     this->setPointVectorInternal(snappingBox);
 }
 
 void Stroke::setPointVector(std::vector<Point>&& other, const Range* const snappingBox) {
+    this->compactedPoints.reset();
+    this->segmentTree.reset();
+    this->arcLengths.reset();
+    this->detailLevels.reset();
+    this->outline.reset();
     this->points = std::move(other);
     this->setPointVectorInternal(snappingBox);
 }
 
 
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+void Stroke::freeUnusedPointItems() {
+    if (this->points.isShared()) {
+        return;
+    }
+    this->points = std::vector<Point>(this->points.begin(), this->points.end());
+    // The outlines refer to the previous vector
+    this->outline.reset();
+}
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
@@ -319,30 +529,32 @@ void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
+    for (auto&& point: this->preparePointsModification()) {
         point.x += dx;
         point.y += dy;
     }
     Element::x += dx;
     Element::y += dy;
     Element::snappedBounds = Element::snappedBounds.translated(dx, dy);
+    boundsChanged();
 }
 
 void Stroke::rotate(double x0, double y0, double th) {
+    auto& points = this->preparePointsModification();
     cairo_matrix_t rotMatrix;
     cairo_matrix_init_identity(&rotMatrix);
     cairo_matrix_translate(&rotMatrix, x0, y0);
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y);
-    }
+    transformPoints(points, rotMatrix);
     this->sizeCalculated = false;
+    boundsChanged();
     // Width and Height will likely be changed after this operation
 }
 
 void Stroke::scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) {
+    auto& points = this->preparePointsModification();
     double fz = (restoreLineWidth) ? 1 : sqrt(std::abs(fx * fy));
     cairo_matrix_t scaleMatrix;
     cairo_matrix_init_identity(&scaleMatrix);
@@ -352,19 +564,23 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
-
-        if (p.z != Point::NO_PRESSURE) {
-            p.z *= fz;
+    transformPoints(points, scaleMatrix);
+    if (fz != 1.0) {
+        for (auto&& p: points) {
+            // A select rather than a branch, so that the loop can be vectorized
+            p.z = p.z != Point::NO_PRESSURE ? p.z * fz : p.z;
         }
     }
     this->width *= fz;
 
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 auto Stroke::hasPressure() const -> bool {
+    if (this->points.empty() && this->compactedPoints) {
+        return this->compactedPoints->hasPressure();
+    }
     if (!this->points.empty()) {
         return this->points[0].z != Point::NO_PRESSURE;
     }
@@ -372,12 +588,14 @@ auto Stroke::hasPressure() const -> bool {
 }
 
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
+    this->expandPoints();
+    return std::accumulate(this->points.begin(), this->points.end(), 0.0,
                            [](double l, Point const& p) { return l + p.z; }) /
            static_cast<double>(this->points.size());
 }
 
 void Stroke::updateBoundsLastTwoPressures() {
+    this->expandPoints();
     if (!sizeCalculated || this->points.empty()) {
         return;
     }
@@ -385,8 +603,8 @@ void Stroke::updateBoundsLastTwoPressures() {
     auto const pointCount = this->getPointCount();
     xoj_assert(pointCount >= 2);
 
-    Point& p = this->points.back();
-    Point& p2 = this->points[pointCount - 2];
+    const Point& p = this->points.back();
+    const Point& p2 = this->points[pointCount - 2];
     double pressure = p2.z;
 
     updateSnappedBounds(snappedBounds, p);
@@ -395,43 +613,51 @@ void Stroke::updateBoundsLastTwoPressures() {
 }
 
 void Stroke::scalePressure(double factor) {
+    auto& points = this->preparePointsModification();
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) {
+    for (auto&& p: points) {
         p.z *= factor;
     }
     this->sizeCalculated = false;
+    boundsChanged();
 }
 
 void Stroke::setLastPressure(double pressure) {
-    if (!this->points.empty()) {
+    auto& points = this->preparePointsModification();
+    if (!points.empty()) {
         xoj_assert(pressure != Point::NO_PRESSURE);
-        Point& back = this->points.back();
+        Point& back = points.back();
         back.z = pressure;
+        boundsChanged();
     }
 }
 
 void Stroke::setSecondToLastPressure(double pressure) {
-    auto const pointCount = this->getPointCount();
+    auto& points = this->preparePointsModification();
+    auto const pointCount = points.size();
     if (pointCount >= 2) {
-        Point& p = this->points[pointCount - 2];
+        Point& p = points[pointCount - 2];
         p.z = pressure;
         updateBoundsLastTwoPressures();
+        boundsChanged();
     }
 }
 
 void Stroke::setPressure(const std::vector<double>& pressure) {
+    auto& points = this->preparePointsModification();
     // The last pressure is not used - as there is no line drawn from this point
-    if (this->points.size() - 1 != pressure.size()) {
+    if (points.size() - 1 != pressure.size()) {
         g_warning("invalid pressure point count: %s, expected %s", std::to_string(pressure.size()).data(),
-                  std::to_string(this->points.size() - 1).data());
+                  std::to_string(points.size() - 1).data());
     }
 
-    auto max_size = std::min(pressure.size(), this->points.size() - 1);
+    auto max_size = std::min(pressure.size(), points.size() - 1);
     for (size_t i = 0U; i != max_size; ++i) {
-        this->points[i].z = pressure[i];
+        points[i].z = pressure[i];
     }
+    boundsChanged();
 }
 
 /**
@@ -445,6 +671,7 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
  * checks if the stroke is intersected by the eraser rectangle
  */
 auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap) const -> bool {
+    this->expandPoints();
     if (this->points.empty()) {
         return false;
     }
@@ -454,9 +681,12 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
+    constexpr double PADDING = 0.1;
+
+    // Tests the segment from last to point
+    auto intersectsSegment = [&](const Point& last, const Point& point) -> bool {
+        double lastX = last.x;
+        double lastY = last.y;
         double px = point.x;
         double py = point.y;
 
@@ -489,8 +719,6 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
 
                 distance -= halfEraserSize * std::sqrt(2);
 
-                constexpr double PADDING = 0.1;
-
                 if (distance <= len / 2 + PADDING) {
                     if (gap) {
                         *gap = distance;
@@ -499,12 +727,33 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
                 }
             }
         }
+        return false;
+    };
 
-        lastX = px;
-        lastY = py;
+    if (intersectsSegment(points[0], points[0])) {
+        return true;
     }
 
-    return false;
+    // The kernel skips the segments which cannot be hit, and the candidates are confirmed one by one
+    const SegmentHitKernel kernel(x, y, halfEraserSize, PADDING);
+    auto intersectsSegments = [&](size_t first, size_t last) -> bool {
+        for (size_t i = kernel.findCandidate(points.data(), first, last); i <= last;
+             i = kernel.findCandidate(points.data(), i + 1, last)) {
+            if (intersectsSegment(points[i], points[i + 1])) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (const StrokeSegmentTree* tree = getSegmentTree(); tree) {
+        // A segment can only be hit if the center of the eraser is that close to its bounding box: at most
+        // halfEraserSize away from the line, and halfEraserSize * sqrt(2) + PADDING from the segment along the line.
+        const double margin = halfEraserSize * (1 + std::sqrt(2)) + PADDING;
+        const Rectangle<double> area(x - margin, y - margin, 2 * margin, 2 * margin);
+        return tree->forEachSegmentRangeIn(area, 0, tree->getSegmentCount() - 1, intersectsSegments);
+    }
+    return points.size() > 1 && intersectsSegments(0, points.size() - 2);
 }
 
 
@@ -577,6 +826,7 @@ static TinyVector<double, 2> intersectLineSegmentWithRectangle(const Point& p, c
 }
 
 auto Stroke::intersectWithPaddedBox(const PaddedBox& box) const -> IntersectionParametersContainer {
+    this->expandPoints();
     auto pointCount = this->points.size();
     if (pointCount < 2) {
         if (pointCount == 1 && this->points.back().isInside(box.getInnerRectangle())) {
@@ -592,6 +842,7 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box) const -> IntersectionP
 
 auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, size_t lastIndex) const
         -> IntersectionParametersContainer {
+    this->expandPoints();
     xoj_assert(firstIndex <= lastIndex && lastIndex < this->points.size() - 1);
 
     const auto innerBox = box.getInnerRectangle();
@@ -618,7 +869,7 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
 
     size_t index = firstIndex;
 
-    const PairView segments(this->points);
+    const PairView segments(this->points.getVector());
     auto segmentIt = std::next(segments.begin(), (std::ptrdiff_t)index);
 
     Flags flags = initializeFlagsFromHalfTangentAtFirstKnot(segmentIt.first(), segmentIt.second());
@@ -715,10 +966,25 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
         DEBUG_ERASER(debugstream << "|  |__** result.size() = " << std::setw(3) << result.size() << std::endl;)
     };
 
-    auto endSegmentIt = std::next(segments.begin(), (std::ptrdiff_t)(lastIndex + 1));
-    for (; segmentIt != endSegmentIt; segmentIt++, index++) {
-        processSegment(segmentIt.first(), segmentIt.second(), index);
+    auto processSegments = [&segments, &processSegment](size_t first, size_t last) -> bool {
+        auto it = std::next(segments.begin(), (std::ptrdiff_t)first);
+        for (size_t i = first; i <= last; it++, i++) {
+            processSegment(it.first(), it.second(), i);
+        }
+        return false;
+    };
+
+    if (const StrokeSegmentTree* tree = getSegmentTree(); tree) {
+        // The segments away from the padded box are left unchanged by processSegment(). Some rounding margin is added.
+        constexpr double ROUNDING_MARGIN = 1e-6;
+        const Rectangle<double> area(outerBox.x - ROUNDING_MARGIN, outerBox.y - ROUNDING_MARGIN,
+                                     outerBox.width + 2 * ROUNDING_MARGIN, outerBox.height + 2 * ROUNDING_MARGIN);
+        tree->forEachSegmentRangeIn(area, firstIndex, lastIndex, processSegments);
+    } else {
+        processSegments(firstIndex, lastIndex);
     }
+    segmentIt = std::next(segments.begin(), (std::ptrdiff_t)(lastIndex + 1));
+    index = lastIndex + 1;
 
     auto isHalfTangentAtLastKnotGoingTowardInnerBox =
             [&innerBox, &outerBox](const Point& lastKnot, const Point& halfTangentControlPoint) -> bool {
@@ -810,6 +1076,7 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
  * Also used for Selected Bounding box.
  */
 void Stroke::calcSize() const {
+    this->expandPoints();
     if (this->points.empty()) {
         Element::x = 0;
         Element::y = 0;
@@ -820,17 +1087,18 @@ void Stroke::calcSize() const {
 
         // used for snapping
         Element::snappedBounds = Rectangle<double>{};
+        return;
     }
 
-    double minSnapX = std::numeric_limits<double>::max();
-    double maxSnapX = std::numeric_limits<double>::min();
-    double minSnapY = std::numeric_limits<double>::max();
-    double maxSnapY = std::numeric_limits<double>::min();
+    double minSnapX = points[0].x;
+    double maxSnapX = points[0].x;
+    double minSnapY = points[0].y;
+    double maxSnapY = points[0].y;
 
     auto halfThick = 0.0;
 
-    // #pragma omp parralel
-    for (auto&& p: points) {
+    // One pass with independent accumulators, without branches
+    for (const Point& p: points) {
         halfThick = std::max(halfThick, p.z);
         minSnapX = std::min(minSnapX, p.x);
         minSnapY = std::min(minSnapY, p.y);
@@ -861,6 +1129,7 @@ auto Stroke::getStrokeCapStyle() const -> StrokeCapStyle { return this->capStyle
 void Stroke::setStrokeCapStyle(const StrokeCapStyle capStyle) { this->capStyle = capStyle; }
 
 void Stroke::debugPrint() const {
+    this->expandPoints();
     g_message("%s", FC(FORMAT_STR("Stroke {1} / hasPressure() = {2}") % (int64_t)this % this->hasPressure()));
 
     for (auto&& p: points) {
@@ -12,7 +12,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
-#include <memory>   // for unique_ptr
+#include <memory>   // for unique_ptr, shared_ptr
 #include <vector>   // for vector
 
 #include "model/Element.h"
@@ -20,11 +20,17 @@
 #include "AudioElement.h"  // for AudioElement
 #include "LineStyle.h"     // for LineStyle
 #include "Point.h"         // for Point
+#include "SharedPoints.h"  // for SharedPoints
 
+class ArcLengthTable;
+class CompactPoints;
 class Element;
 class ObjectInputStream;
 class ObjectOutputStream;
 class ShapeContainer;
+class StrokeDetailLevels;
+class StrokeOutline;
+class StrokeSegmentTree;
 
 class StrokeTool {
 public:
@@ -65,6 +71,12 @@ public:
     Stroke& operator=(Stroke&&) = default;
     ~Stroke() override;
 
+    /**
+     * The strokes are allocated from a pool, as a document can have millions of them
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
 public:
     auto cloneStroke() const -> std::unique_ptr<Stroke>;
     auto clone() const -> ElementPtr override;
@@ -110,6 +122,10 @@ public:
     void setFill(int fill);
 
     void addPoint(const Point& p);
+    /**
+     * Replace the last point, e.g. a point dropped while drawing. The bounds are not shrunk.
+     */
+    void setLastPoint(const Point& p);
     size_t getPointCount() const;
     void freeUnusedPointItems();
     std::vector<Point> const& getPointVector() const;
@@ -117,6 +133,44 @@ public:
     Point getPoint(PathParameter parameter) const;
     const Point* getPoints() const;
 
+    /**
+     * @brief Keep the points only in single precision (see CompactPoints) until they are used again, to save memory.
+     *      The points are expanded again by the accessors, which is why the document must be locked.
+     * @return true if memory was freed
+     */
+    bool compact();
+
+    /**
+     * @return true if the points are currently only stored in single precision
+     */
+    bool isCompacted() const;
+
+    /**
+     * @brief Write the points to be stored away from the stroke, see dropPoints() and readPoints()
+     */
+    void writePoints(ObjectOutputStream& out) const;
+
+    /**
+     * @brief Free the points and the data computed from them, keeping the bounds, until readPoints() is called.
+     *      The stroke must not be in a layer meanwhile, e.g. it is owned by an undo action (see UndoAction::spill).
+     */
+    void dropPoints();
+
+    /**
+     * @brief Read back the points written by writePoints()
+     */
+    void readPoints(ObjectInputStream& in);
+
+    /**
+     * @brief Give back the points freed by dropPoints(), e.g. rebuilt from other strokes
+     */
+    void restorePoints(std::vector<Point> pts);
+
+    /**
+     * @return About the memory (in bytes) used by the points
+     */
+    size_t getPointsMemorySize() const;
+
     /**
      * @brief Replace the stroke's points by the ones in the provided vector (they will be copied).
      * @param other New vector of points for the stroke
@@ -130,7 +184,41 @@ public:
 private:
     void setPointVectorInternal(const Range* const snappingBox);
 
+    /**
+     * Expand the compacted points, if needed, before reading them
+     */
+    void expandPoints() const;
+
+    /**
+     * Expand the compacted points, if needed, and drop the compacted copy and the data computed from the points before
+     * modifying them
+     * @return The points, no longer shared with the clones
+     */
+    auto preparePointsModification() -> std::vector<Point>&;
+
 public:
+    /**
+     * @return The tree of the segment boxes, built on the first call, or nullptr if the stroke is too short for it
+     */
+    const StrokeSegmentTree* getSegmentTree() const;
+
+    /**
+     * @return The lengths along the stroke, computed on the first call
+     */
+    const ArcLengthTable& getArcLengthTable() const;
+
+    /**
+     * @return The points, simplified for a rendering on which a deviation of tolerance (in page coordinates) is not
+     *      noticeable, or the points themselves if tolerance is too small
+     */
+    const std::vector<Point>& getSimplifiedPointVector(double tolerance) const;
+
+    /**
+     * @return The outlines of the stroke with pressure, for its points and their simplified versions. They are kept
+     *      until the points change.
+     */
+    StrokeOutline& getOutline() const;
+
     void deletePointsFrom(size_t index);
 
     void setToolType(StrokeTool type);
@@ -202,8 +290,24 @@ private:
     double width = 0;
     StrokeTool toolType = StrokeTool::PEN;
 
-    // The array with the points
-    std::vector<Point> points{};
+    // The array with the points, shared by the clones until one of them is modified. Empty while the stroke is
+    // compacted.
+    mutable SharedPoints points{};
+
+    // Single precision copy of the points, shared by the clones
+    std::shared_ptr<const CompactPoints> compactedPoints;
+
+    // Bounding boxes of the segments for the hit-tests, shared by the clones
+    mutable std::shared_ptr<const StrokeSegmentTree> segmentTree;
+
+    // Cumulative lengths along the stroke, for the dashes, shared by the clones
+    mutable std::shared_ptr<const ArcLengthTable> arcLengths;
+
+    // Simplified points for the low zoom levels, shared by the clones
+    mutable std::shared_ptr<StrokeDetailLevels> detailLevels;
+
+    // Outlines of the points and of the simplified ones, not shared by the clones
+    mutable std::shared_ptr<StrokeOutline> outline;
 
     /**
      * Dashed line
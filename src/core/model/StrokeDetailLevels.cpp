@@ -0,0 +1,74 @@
+#include "StrokeDetailLevels.h"
+
+#include <algorithm>  // for clamp
+#include <cmath>      // for abs, floor, hypot, log2, ldexp
+#include <cstddef>    // for size_t
+#include <mutex>      // for lock_guard
+#include <utility>    // for pair
+
+namespace {
+/// Deviation of p from the segment [a, b], including the half width difference for points with pressure
+auto deviation(const Point& p, const Point& a, const Point& b) -> double {
+    const double dx = b.x - a.x;
+    const double dy = b.y - a.y;
+    const double squaredLength = dx * dx + dy * dy;
+    double t = 0;
+    if (squaredLength > 0) {
+        t = std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / squaredLength, 0.0, 1.0);
+    }
+    double distance = std::hypot(a.x + t * dx - p.x, a.y + t * dy - p.y);
+    if (p.z != Point::NO_PRESSURE) {
+        distance += 0.5 * std::abs(a.z + t * (b.z - a.z) - p.z);
+    }
+    return distance;
+}
+}  // namespace
+
+auto StrokeDetailLevels::get(const std::vector<Point>& points, double tolerance) -> const std::vector<Point>& {
+    const int exponent = static_cast<int>(std::floor(std::log2(tolerance)));
+    // The references to the elements of the map stay valid when other levels are added
+    std::lock_guard lock(this->mutex);
+    auto it = this->levels.find(exponent);
+    if (it == this->levels.end()) {
+        it = this->levels.emplace(exponent, simplify(points, std::ldexp(1.0, exponent))).first;
+    }
+    return it->second;
+}
+
+auto StrokeDetailLevels::simplify(const std::vector<Point>& points, double tolerance) -> std::vector<Point> {
+    if (points.size() <= 2) {
+        return points;
+    }
+    std::vector<bool> kept(points.size(), false);
+    kept.front() = true;
+    kept.back() = true;
+
+    // Ranges [first, last] whose inner points are still to be decided, without recursion for the long strokes
+    std::vector<std::pair<size_t, size_t>> ranges{{0, points.size() - 1}};
+    while (!ranges.empty()) {
+        auto [first, last] = ranges.back();
+        ranges.pop_back();
+
+        double maxDeviation = 0;
+        size_t farthest = first;
+        for (size_t i = first + 1; i < last; i++) {
+            if (double d = deviation(points[i], points[first], points[last]); d > maxDeviation) {
+                maxDeviation = d;
+                farthest = i;
+            }
+        }
+        if (maxDeviation > tolerance) {
+            kept[farthest] = true;
+            ranges.emplace_back(first, farthest);
+            ranges.emplace_back(farthest, last);
+        }
+    }
+
+    std::vector<Point> simplified;
+    for (size_t i = 0; i < points.size(); i++) {
+        if (kept[i]) {
+            simplified.push_back(points[i]);
+        }
+    }
+    return simplified;
+}
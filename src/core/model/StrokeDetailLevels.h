@@ -0,0 +1,56 @@
+/*
+ * Xournal++
+ *
+ * Simplified versions of a stroke, for the renderings at low zoom levels
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <map>      // for map
+#include <mutex>    // for mutex
+#include <vector>   // for vector
+
+#include "Point.h"  // for Point
+
+/**
+ * The points of a stroke simplified with the Douglas-Peucker algorithm, computed on demand and cached for each power of
+ * two of the tolerance. At low zoom levels, most of the points of a stroke fall in the same device pixel.
+ *
+ * Like the rest of the stroke, this is guarded by the document lock. The levels are shared by the clones of the stroke,
+ * which may be on other pages rendered concurrently (see DocumentPageReadLock): get() locks its own mutex.
+ */
+class StrokeDetailLevels {
+public:
+    /**
+     * Below this tolerance (in page coordinates), the simplification is not worth its memory: use the points directly
+     */
+    static constexpr double MIN_TOLERANCE = 0.25;
+
+    /**
+     * Strokes with fewer points are drawn directly
+     */
+    static constexpr size_t MIN_POINT_COUNT = 64;
+
+    /**
+     * @return The points, simplified so that the path stays within tolerance of the original one. The actual tolerance
+     *      is the largest power of two below the given one. The reference stays valid while the points do not change.
+     */
+    const std::vector<Point>& get(const std::vector<Point>& points, double tolerance);
+
+    /**
+     * @brief Douglas-Peucker simplification of the polyline. The first and last points are always kept. For points
+     *      with pressure, the deviation of the half width counts as a distance.
+     */
+    static std::vector<Point> simplify(const std::vector<Point>& points, double tolerance);
+
+private:
+    /// Simplified points, per exponent of the tolerance
+    std::map<int, std::vector<Point>> levels;
+    std::mutex mutex;
+};
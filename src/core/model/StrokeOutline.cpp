@@ -0,0 +1,95 @@
+#include "StrokeOutline.h"
+
+#include <algorithm>  // for find_if
+#include <cmath>      // for hypot, M_PI
+#include <utility>    // for move
+
+#include "util/Assert.h"    // for xoj_assert
+#include "util/PairView.h"  // for PairView
+
+namespace {
+/**
+ * Adds the outline of the segment from p to q, as cairo_stroke() would draw it with the given width and cap, as one or
+ * two sub-paths. All the sub-paths have the same orientation, so that filling them with CAIRO_FILL_RULE_WINDING
+ * paints their union.
+ */
+void addSegmentOutline(cairo_t* cr, const Point& p, const Point& q, double width, cairo_line_cap_t cap) {
+    const double halfWidth = 0.5 * width;
+    const double length = std::hypot(q.x - p.x, q.y - p.y);
+    if (length == 0.0) {
+        // Degenerate segments are drawn as dots (round caps) or squares aligned with the axes (square caps)
+        if (cap == CAIRO_LINE_CAP_ROUND) {
+            cairo_new_sub_path(cr);
+            cairo_arc(cr, p.x, p.y, halfWidth, 0, 2 * M_PI);
+            cairo_close_path(cr);
+        } else if (cap == CAIRO_LINE_CAP_SQUARE) {
+            cairo_rectangle(cr, p.x - halfWidth, p.y - halfWidth, width, width);
+        }
+        return;
+    }
+    // Unit vector along the segment, and normal vector of length halfWidth
+    const double ux = (q.x - p.x) / length;
+    const double uy = (q.y - p.y) / length;
+    const double nx = -uy * halfWidth;
+    const double ny = ux * halfWidth;
+    // Square caps prolong the segment by half the width on each side
+    const double ext = cap == CAIRO_LINE_CAP_SQUARE ? halfWidth : 0.0;
+    const double px = p.x - ux * ext;
+    const double py = p.y - uy * ext;
+    const double qx = q.x + ux * ext;
+    const double qy = q.y + uy * ext;
+
+    // Same orientation as cairo_arc() and cairo_rectangle()
+    cairo_move_to(cr, px - nx, py - ny);
+    cairo_line_to(cr, qx - nx, qy - ny);
+    cairo_line_to(cr, qx + nx, qy + ny);
+    cairo_line_to(cr, px + nx, py + ny);
+    cairo_close_path(cr);
+
+    if (cap == CAIRO_LINE_CAP_ROUND) {
+        // The round joins are the round caps of the consecutive segments
+        cairo_new_sub_path(cr);
+        cairo_arc(cr, p.x, p.y, halfWidth, 0, 2 * M_PI);
+        cairo_close_path(cr);
+        cairo_new_sub_path(cr);
+        cairo_arc(cr, q.x, q.y, halfWidth, 0, 2 * M_PI);
+        cairo_close_path(cr);
+    }
+}
+}  // namespace
+
+void StrokeOutline::addTo(cairo_t* cr, const std::vector<Point>& pts, cairo_line_cap_t cap) {
+    for (const auto& [p, q]: PairView(pts)) {
+        xoj_assert(p.z > 0.0);
+        addSegmentOutline(cr, p, q, p.z, cap);
+    }
+}
+
+auto StrokeOutline::get(const std::vector<Point>& pts, cairo_line_cap_t cap) -> const cairo_path_t* {
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&pts](const Entry& e) { return e.points == &pts && e.size == pts.size(); });
+    if (it != entries.end() && it->cap == cap) {
+        return it->path.get();
+    }
+
+    /*
+     * The path is built in a scaled space: cairo stores the coordinates of paths in fixed point, with 8 bits of
+     * fractional part in device space. The outline is then precise enough for the higher zoom levels.
+     */
+    constexpr double PRECISION_SCALE = 16.0;
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 0, 0);
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, PRECISION_SCALE, PRECISION_SCALE);
+    addTo(cr, pts, cap);
+    // In user space, i.e. in page coordinates
+    std::unique_ptr<cairo_path_t, PathDeleter> path(cairo_copy_path(cr));
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+
+    if (it == entries.end()) {
+        it = entries.insert(entries.end(), Entry{&pts, pts.size(), cap, nullptr});
+    }
+    it->cap = cap;
+    it->path = std::move(path);
+    return it->path.get();
+}
@@ -0,0 +1,57 @@
+/*
+ * Xournal++
+ *
+ * The outline of a stroke with pressure, as a path to fill
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>  // for unique_ptr
+#include <vector>  // for vector
+
+#include <cairo.h>  // for cairo_path_t, cairo_t, cairo_line_cap_t
+
+#include "Point.h"  // for Point
+
+/**
+ * The outline of a stroke whose width varies along the path: the union of the outlines of its segments, each one as
+ * cairo_stroke() would draw it with its own width and the stroke's caps. Filling the outline with
+ * CAIRO_FILL_RULE_WINDING paints every pixel of the stroke once, so that translucent strokes need no mask.
+ *
+ * The outlines are computed on demand, for the points and for each simplified version of them, and kept in page
+ * coordinates until the points change. Like the rest of the stroke, this is guarded by the document lock.
+ */
+class StrokeOutline {
+public:
+    /**
+     * @param pts The points of the stroke, or a simplified version of them. Their address identifies them: they must
+     *      stay unchanged as long as this outline is kept.
+     * @return The outline of the points, to be added with cairo_append_path()
+     */
+    const cairo_path_t* get(const std::vector<Point>& pts, cairo_line_cap_t cap);
+
+    /**
+     * @brief Adds the outline of the points to the current path of cr, as its sub-paths
+     */
+    static void addTo(cairo_t* cr, const std::vector<Point>& pts, cairo_line_cap_t cap);
+
+private:
+    struct PathDeleter {
+        void operator()(cairo_path_t* p) const { cairo_path_destroy(p); }
+    };
+
+    struct Entry {
+        const std::vector<Point>* points = nullptr;
+        size_t size = 0;
+        cairo_line_cap_t cap = CAIRO_LINE_CAP_ROUND;
+        std::unique_ptr<cairo_path_t, PathDeleter> path;
+    };
+
+    /// One outline per detail level in use: typically one or two
+    std::vector<Entry> entries;
+};
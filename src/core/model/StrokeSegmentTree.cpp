@@ -0,0 +1,44 @@
+#include "StrokeSegmentTree.h"
+
+#include <utility>  // for move
+
+#include "util/Assert.h"  // for xoj_assert
+
+StrokeSegmentTree::StrokeSegmentTree(const std::vector<Point>& points):
+        segmentCount(points.empty() ? 0 : points.size() - 1) {
+    xoj_assert(this->segmentCount > 0);
+
+    std::vector<Box>& leaves = this->levels.emplace_back();
+    leaves.reserve((this->segmentCount + LEAF_SIZE - 1) / LEAF_SIZE);
+    for (size_t first = 0; first < this->segmentCount; first += LEAF_SIZE) {
+        const size_t last = std::min(first + LEAF_SIZE, this->segmentCount);
+        Box box{points[first].x, points[first].y, points[first].x, points[first].y};
+        for (size_t i = first + 1; i <= last; i++) {
+            box.minX = std::min(box.minX, points[i].x);
+            box.minY = std::min(box.minY, points[i].y);
+            box.maxX = std::max(box.maxX, points[i].x);
+            box.maxY = std::max(box.maxY, points[i].y);
+        }
+        leaves.push_back(box);
+    }
+
+    while (this->levels.back().size() > 1) {
+        const std::vector<Box>& children = this->levels.back();
+        std::vector<Box> parents;
+        parents.reserve((children.size() + 1) / 2);
+        for (size_t i = 0; i < children.size(); i += 2) {
+            Box box = children[i];
+            if (i + 1 < children.size()) {
+                const Box& other = children[i + 1];
+                box.minX = std::min(box.minX, other.minX);
+                box.minY = std::min(box.minY, other.minY);
+                box.maxX = std::max(box.maxX, other.maxX);
+                box.maxY = std::max(box.maxY, other.maxY);
+            }
+            parents.push_back(box);
+        }
+        this->levels.push_back(std::move(parents));
+    }
+}
+
+auto StrokeSegmentTree::getSegmentCount() const -> size_t { return this->segmentCount; }
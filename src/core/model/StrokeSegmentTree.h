@@ -0,0 +1,215 @@
+/*
+ * Xournal++
+ *
+ * Bounding boxes of the segments of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>  // for min, max
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
+
+#include "util/Rectangle.h"  // for Rectangle
+
+#include "Point.h"  // for Point
+
+/**
+ * Binary tree of the bounding boxes of the segments of a stroke, used to skip the segments which are far from the
+ * eraser in the hit-tests of long strokes. The leaves hold the boxes of LEAF_SIZE consecutive segments.
+ *
+ * Segment i goes from points[i] to points[i + 1]. The boxes do not take the stroke thickness into account.
+ */
+class StrokeSegmentTree {
+public:
+    /**
+     * Number of segments in a leaf
+     */
+    static constexpr size_t LEAF_SIZE = 16;
+
+    /**
+     * Strokes with fewer segments are faster to go through directly
+     */
+    static constexpr size_t MIN_SEGMENT_COUNT = 8 * LEAF_SIZE;
+
+    explicit StrokeSegmentTree(const std::vector<Point>& points);
+
+    size_t getSegmentCount() const;
+
+    /**
+     * @brief Call f(first, last) on the ranges of segments between firstIndex and lastIndex whose bounding box touches
+     *      the rectangle, in increasing order. The other segments do not touch the rectangle.
+     * @param f Returns true to stop the search
+     * @return true if f stopped the search
+     */
+    template <class Fun>
+    bool forEachSegmentRangeIn(const xoj::util::Rectangle<double>& rect, size_t firstIndex, size_t lastIndex,
+                               Fun f) const;
+
+    /**
+     * @brief Same as forEachSegmentRangeIn(), but the adjacent ranges are merged, e.g. to keep the joins between their
+     *      segments when stroking them
+     * @param f Called as f(first, last), on ranges separated by at least one segment not touching the rectangle
+     */
+    template <class Fun>
+    void forEachJoinedSegmentRangeIn(const xoj::util::Rectangle<double>& rect, size_t firstIndex, size_t lastIndex,
+                                     Fun f) const;
+
+    /**
+     * @brief Call f(firstA, lastA, firstB, lastB) on the pairs of ranges of segments, within [firstIndexA, lastIndexA]
+     *      and [firstIndexB, lastIndexB] respectively, whose bounding boxes overlap once enlarged by padding. The other
+     *      pairs of segments do not overlap.
+     */
+    template <class Fun>
+    void forEachOverlappingRangePair(size_t firstIndexA, size_t lastIndexA, size_t firstIndexB, size_t lastIndexB,
+                                     double padding, Fun f) const;
+
+private:
+    struct Box {
+        double minX;
+        double minY;
+        double maxX;
+        double maxY;
+
+        bool touches(const xoj::util::Rectangle<double>& rect) const {
+            return minX <= rect.x + rect.width && rect.x <= maxX && minY <= rect.y + rect.height && rect.y <= maxY;
+        }
+
+        bool overlaps(const Box& o, double padding) const {
+            return minX - padding < o.maxX + padding && o.minX - padding < maxX + padding &&
+                   minY - padding < o.maxY + padding && o.minY - padding < maxY + padding;
+        }
+    };
+
+    /// A node of the tree, with the range [first, last] of the segments it covers
+    struct NodeRef {
+        size_t level;
+        size_t node;
+        size_t first;
+        size_t last;
+    };
+
+    NodeRef getNode(size_t level, size_t node) const {
+        const size_t nodeSize = LEAF_SIZE << level;
+        const size_t first = node * nodeSize;
+        return {level, node, first, std::min(first + nodeSize, this->segmentCount) - 1};
+    }
+
+    template <class Fun>
+    bool visit(size_t level, size_t node, const xoj::util::Rectangle<double>& rect, size_t firstIndex,
+               size_t lastIndex, Fun& f) const;
+
+    template <class Fun>
+    void visitPair(const NodeRef& a, const NodeRef& b, size_t firstIndexA, size_t lastIndexA, size_t firstIndexB,
+                   size_t lastIndexB, double padding, Fun& f) const;
+
+    size_t segmentCount;
+
+    /**
+     * levels[0] are the leaves, levels[k + 1][i] is the union of levels[k][2 * i] and levels[k][2 * i + 1].
+     * The last level is the root.
+     */
+    std::vector<std::vector<Box>> levels;
+};
+
+template <class Fun>
+bool StrokeSegmentTree::forEachSegmentRangeIn(const xoj::util::Rectangle<double>& rect, size_t firstIndex,
+                                              size_t lastIndex, Fun f) const {
+    if (firstIndex > lastIndex || firstIndex >= this->segmentCount) {
+        return false;
+    }
+    lastIndex = std::min(lastIndex, this->segmentCount - 1);
+    return visit(this->levels.size() - 1, 0, rect, firstIndex, lastIndex, f);
+}
+
+template <class Fun>
+void StrokeSegmentTree::forEachJoinedSegmentRangeIn(const xoj::util::Rectangle<double>& rect, size_t firstIndex,
+                                                    size_t lastIndex, Fun f) const {
+    bool hasRange = false;
+    size_t rangeFirst = 0;
+    size_t rangeLast = 0;
+    forEachSegmentRangeIn(rect, firstIndex, lastIndex, [&](size_t first, size_t last) {
+        if (hasRange && rangeLast + 1 == first) {
+            rangeLast = last;
+        } else {
+            if (hasRange) {
+                f(rangeFirst, rangeLast);
+            }
+            hasRange = true;
+            rangeFirst = first;
+            rangeLast = last;
+        }
+        return false;
+    });
+    if (hasRange) {
+        f(rangeFirst, rangeLast);
+    }
+}
+
+template <class Fun>
+bool StrokeSegmentTree::visit(size_t level, size_t node, const xoj::util::Rectangle<double>& rect, size_t firstIndex,
+                              size_t lastIndex, Fun& f) const {
+    // Segments covered by the node
+    const size_t nodeSize = LEAF_SIZE << level;
+    const size_t nodeFirst = node * nodeSize;
+    const size_t nodeLast = std::min(nodeFirst + nodeSize, this->segmentCount) - 1;
+    if (nodeLast < firstIndex || lastIndex < nodeFirst || !this->levels[level][node].touches(rect)) {
+        return false;
+    }
+
+    if (level == 0) {
+        return f(std::max(nodeFirst, firstIndex), std::min(nodeLast, lastIndex));
+    }
+    if (visit(level - 1, 2 * node, rect, firstIndex, lastIndex, f)) {
+        return true;
+    }
+    return 2 * node + 1 < this->levels[level - 1].size() &&
+           visit(level - 1, 2 * node + 1, rect, firstIndex, lastIndex, f);
+}
+
+template <class Fun>
+void StrokeSegmentTree::forEachOverlappingRangePair(size_t firstIndexA, size_t lastIndexA, size_t firstIndexB,
+                                                    size_t lastIndexB, double padding, Fun f) const {
+    if (firstIndexA > lastIndexA || firstIndexA >= this->segmentCount || firstIndexB > lastIndexB ||
+        firstIndexB >= this->segmentCount) {
+        return;
+    }
+    lastIndexA = std::min(lastIndexA, this->segmentCount - 1);
+    lastIndexB = std::min(lastIndexB, this->segmentCount - 1);
+    const NodeRef root = getNode(this->levels.size() - 1, 0);
+    visitPair(root, root, firstIndexA, lastIndexA, firstIndexB, lastIndexB, padding, f);
+}
+
+template <class Fun>
+void StrokeSegmentTree::visitPair(const NodeRef& a, const NodeRef& b, size_t firstIndexA, size_t lastIndexA,
+                                  size_t firstIndexB, size_t lastIndexB, double padding, Fun& f) const {
+    if (a.last < firstIndexA || lastIndexA < a.first || b.last < firstIndexB || lastIndexB < b.first ||
+        !this->levels[a.level][a.node].overlaps(this->levels[b.level][b.node], padding)) {
+        return;
+    }
+
+    if (a.level == 0 && b.level == 0) {
+        f(std::max(a.first, firstIndexA), std::min(a.last, lastIndexA), std::max(b.first, firstIndexB),
+          std::min(b.last, lastIndexB));
+        return;
+    }
+    // Split the larger node
+    if (a.level >= b.level) {
+        visitPair(getNode(a.level - 1, 2 * a.node), b, firstIndexA, lastIndexA, firstIndexB, lastIndexB, padding, f);
+        if (2 * a.node + 1 < this->levels[a.level - 1].size()) {
+            visitPair(getNode(a.level - 1, 2 * a.node + 1), b, firstIndexA, lastIndexA, firstIndexB, lastIndexB,
+                      padding, f);
+        }
+    } else {
+        visitPair(a, getNode(b.level - 1, 2 * b.node), firstIndexA, lastIndexA, firstIndexB, lastIndexB, padding, f);
+        if (2 * b.node + 1 < this->levels[b.level - 1].size()) {
+            visitPair(a, getNode(b.level - 1, 2 * b.node + 1), firstIndexA, lastIndexA, firstIndexB, lastIndexB,
+                      padding, f);
+        }
+    }
+}
@@ -1,7 +1,10 @@
 #include "TexImage.h"
 
-#include <memory>
-#include <utility>  // for move
+#include <algorithm>  // for clamp, max
+#include <cmath>      // for ldexp, log2
+#include <memory>     // for make_shared
+#include <mutex>      // for mutex, lock_guard
+#include <utility>    // for move
 
 #include <poppler-document.h>  // for poppler_document_ge...
 #include <poppler-page.h>      // for poppler_page_get_size
@@ -9,11 +12,21 @@
 #include "model/Element.h"                        // for Element, ELEMENT_TE...
 #include "util/Rectangle.h"                       // for Rectangle
 #include "util/raii/GObjectSPtr.h"                // for GObjectSPtr
+#include "util/safe_casts.h"                      // for ceil_cast
 #include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
 #include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
 
 using xoj::util::Rectangle;
 
+struct TexImage::PdfRendering {
+    explicit PdfRendering(PopplerDocument* pdf): page(poppler_document_get_page(pdf, 0), xoj::util::adopt) {}
+
+    xoj::util::GObjectSPtr<PopplerPage> page;
+
+    /// Held while rasterizing the page
+    std::mutex mutex;
+};
+
 TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
 
 TexImage::~TexImage() { freeImageAndPdf(); }
@@ -25,6 +38,7 @@ void TexImage::freeImageAndPdf() {
     }
 
     this->pdf.reset();
+    this->rendering.reset();
 }
 
 auto TexImage::cloneTexImage() const -> std::unique_ptr<TexImage> {
@@ -37,15 +51,13 @@ auto TexImage::cloneTexImage() const -> std::unique_ptr<TexImage> {
     img->height = this->height;
     img->text = this->text;
     img->snappedBounds = this->snappedBounds;
-    img->sizeCalculated = this->sizeCalculated;
+    img->sizeCalculated = this->sizeCalculated.load();
 
-    // Clone has a copy of our PDF.
+    // The clone shares our data, and the PDF or image it was loaded to
+    img->binaryData = this->binaryData;
     img->pdf = this->pdf;
-
-    // Load a copy of our data (must be called after
-    // giving the clone a copy of our PDF -- it may change
-    // the PDF we've given it).
-    img->loadData(std::string(this->binaryData), nullptr);
+    img->rendering = this->rendering;
+    img->image = this->image ? cairo_surface_reference(this->image) : nullptr;
 
     return img;
 }
@@ -55,19 +67,22 @@ auto TexImage::clone() const -> ElementPtr { return cloneTexImage(); }
 void TexImage::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    boundsChanged();
 }
 
 auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length) -> cairo_status_t {
+    const std::string& binaryData = image->getBinaryData();
     for (unsigned int i = 0; i < length; i++, image->read++) {
-        if (image->read >= image->binaryData.length()) {
+        if (image->read >= binaryData.length()) {
             return CAIRO_STATUS_READ_ERROR;
         }
-        data[i] = static_cast<unsigned char>(image->binaryData[image->read]);
+        data[i] = static_cast<unsigned char>(binaryData[image->read]);
     }
 
     return CAIRO_STATUS_SUCCESS;
@@ -76,7 +91,12 @@ auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned
 /**
  * Gets the binary data, a .PNG image or a .PDF
  */
-auto TexImage::getBinaryData() const -> std::string const& { return this->binaryData; }
+auto TexImage::getBinaryData() const -> std::string const& {
+    static const std::string empty;
+    return this->binaryData ? this->binaryData->getData() : empty;
+}
+
+auto TexImage::getBuffer() const -> const std::shared_ptr<const ImageBuffer>& { return this->binaryData; }
 
 void TexImage::setText(std::string text) { this->text = std::move(text); }
 
@@ -84,24 +104,27 @@ auto TexImage::getText() const -> std::string { return this->text; }
 
 auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
     this->freeImageAndPdf();
-    this->binaryData = bytes;
-    if (this->binaryData.length() < 4) {
+    this->binaryData = ImageBuffer::get(std::move(bytes));
+    const std::string& data = this->binaryData->getData();
+    if (data.length() < 4) {
         return false;
     }
 
-    const std::string type = binaryData.substr(1, 3);
+    const std::string type = data.substr(1, 3);
     if (type == "PDF") {
-        // Note: binaryData must not be modified while pdf is live.
-        this->pdf.reset(poppler_document_new_from_data(this->binaryData.data(), this->binaryData.size(), nullptr, err),
+        // Note: the shared buffer is immutable and outlives the pdf, which may be shared by the clones
+        this->pdf.reset(poppler_document_new_from_data(const_cast<char*>(data.data()), static_cast<int>(data.size()),
+                                                       nullptr, err),
                         xoj::util::adopt);
         if (!pdf.get() || poppler_document_get_n_pages(this->pdf.get()) < 1) {
             return false;
         }
+        this->rendering = std::make_shared<PdfRendering>(this->pdf.get());
         if (std::abs(this->width * this->height) <= std::numeric_limits<double>::epsilon()) {
-            xoj::util::GObjectSPtr<PopplerPage> page(poppler_document_get_page(this->pdf.get(), 0), xoj::util::adopt);
-            poppler_page_get_size(page.get(), &this->width, &this->height);
+            poppler_page_get_size(this->rendering->page.get(), &this->width, &this->height);
         }
     } else if (type == "PNG") {
+        this->read = 0;
         this->image = cairo_image_surface_create_from_png_stream(
                 reinterpret_cast<cairo_read_func_t>(&cairoReadFunction), this);
     } else {
@@ -115,6 +138,37 @@ auto TexImage::getImage() const -> cairo_surface_t* { return this->image; }
 
 auto TexImage::getPdf() const -> PopplerDocument* { return this->pdf.get(); }
 
+auto TexImage::getPdfPage() const -> PopplerPage* { return this->rendering ? this->rendering->page.get() : nullptr; }
+
+auto TexImage::getPdfRaster(double pixelsPerPoint) const -> xoj::util::CairoSurfaceSPtr {
+    if (!this->rendering) {
+        return nullptr;
+    }
+    const int level = pixelsPerPoint > 0 ? std::clamp(ceil_cast<int>(std::log2(pixelsPerPoint)), MIN_RASTER_LEVEL,
+                                                      MAX_RASTER_LEVEL) :
+                                           MIN_RASTER_LEVEL;
+
+    // The rasters are kept in the cache of the decoded images, within its memory budget
+    std::lock_guard lock(this->rendering->mutex);
+    return this->binaryData->getRaster(level - MIN_RASTER_LEVEL, [&]() {
+        PopplerPage* page = this->rendering->page.get();
+        double pageWidth = 0;
+        double pageHeight = 0;
+        poppler_page_get_size(page, &pageWidth, &pageHeight);
+
+        const double zoom = std::ldexp(1.0, level);
+        xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                                       std::max(1, ceil_cast<int>(pageWidth * zoom)),
+                                                                       std::max(1, ceil_cast<int>(pageHeight * zoom))),
+                                            xoj::util::adopt);
+        cairo_t* cr = cairo_create(surface.get());
+        cairo_scale(cr, zoom, zoom);
+        poppler_page_render(page, cr);
+        cairo_destroy(cr);
+        return surface;
+    });
+}
+
 void TexImage::scale(double x0, double y0, double fx, double fy, double rotation,
                      bool) {  // line width scaling option is not used
 
@@ -124,6 +178,7 @@ void TexImage::scale(double x0, double y0, double fx, double fy, double rotation
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::rotate(double x0, double y0, double th) {
@@ -139,7 +194,7 @@ void TexImage::serialize(ObjectOutputStream& out) const {
     out.writeDouble(this->height);
     out.writeString(this->text);
 
-    out.writeString(this->binaryData);
+    out.writeString(getBinaryData());
 
     out.endObject();
 }
@@ -160,6 +215,7 @@ void TexImage::readSerialized(ObjectInputStream& in) {
 
     in.endObject();
     this->calcSize();
+    boundsChanged();
 }
 
 void TexImage::calcSize() const {
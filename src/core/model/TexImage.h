@@ -11,16 +11,18 @@
 
 #pragma once
 
-#include <memory>
+#include <memory>  // for shared_ptr
 #include <string>  // for string
 
 #include <cairo.h>    // for cairo_surface_t, cairo_status_t
 #include <glib.h>     // for GError
 #include <poppler.h>  // for PopplerDocument
 
-#include "util/raii/GObjectSPtr.h"  // for GObjectSPtr
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "util/raii/GObjectSPtr.h"    // for GObjectSPtr
 
-#include "Element.h"  // for Element
+#include "Element.h"      // for Element
+#include "ImageBuffer.h"  // for ImageBuffer
 
 class ObjectInputStream;
 class ObjectOutputStream;
@@ -44,6 +46,11 @@ public:
      */
     const std::string& getBinaryData() const;
 
+    /**
+     * Returns the buffer of the binary data, shared with the identical TexImages.
+     */
+    const std::shared_ptr<const ImageBuffer>& getBuffer() const;
+
     /**
      * @return The image, if render source is PNG. Note: this is deprecated.
      */
@@ -56,6 +63,24 @@ public:
      */
     PopplerDocument* getPdf() const;
 
+    /**
+     * @return The page of the PDF Document, if rendered as a PDF. It is shared by the clones.
+     */
+    PopplerPage* getPdfPage() const;
+
+    /**
+     * @return The PDF page rasterized with at least pixelsPerPoint pixels per point of the page (or at the highest
+     *      resolution, 2^MAX_RASTER_LEVEL), or nullptr if not rendered as a PDF.
+     *
+     * The rasterizations are made at power of two resolutions, so that small zoom changes reuse them. They are kept in
+     * the cache of the decoded images (see ImageBuffer::getRaster()), shared by the identical TexImages and rendered
+     * again once evicted. May be used from any thread.
+     */
+    xoj::util::CairoSurfaceSPtr getPdfRaster(double pixelsPerPoint) const;
+
+    static constexpr int MIN_RASTER_LEVEL = -2;
+    static constexpr int MAX_RASTER_LEVEL = 3;
+
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
@@ -92,6 +117,12 @@ private:
      */
     xoj::util::GObjectSPtr<PopplerDocument> pdf;
 
+    /**
+     * The page of the PDF and its last rasterizations, shared by the clones
+     */
+    struct PdfRendering;
+    std::shared_ptr<PdfRendering> rendering;
+
     /**
      * Tex image, if rendered as image. Note: this is deprecated and subject to removal in a later version.
      */
@@ -100,7 +131,7 @@ private:
     /**
      * PNG Image / PDF Document
      */
-    std::string binaryData;
+    std::shared_ptr<const ImageBuffer> binaryData;
 
     /**
      * Read position for PNG binaryData (deprecated).
@@ -9,6 +9,7 @@
 #include "model/AudioElement.h"   // for AudioElement
 #include "model/Element.h"        // for ELEMENT_TEXT, Eleme...
 #include "model/Font.h"           // for XojFont
+#include "model/FontCache.h"      // for createDescription
 #include "pdf/base/XojPdfPage.h"  // for XojPdfRectangle
 #include "util/Rectangle.h"       // for Rectangle
 #include "util/Stacktrace.h"      // for Stacktrace
@@ -37,7 +38,7 @@ auto Text::cloneText() const -> std::unique_ptr<Text> {
     text->height = this->height;
     text->cloneAudioData(this);
     text->snappedBounds = this->snappedBounds;
-    text->sizeCalculated = this->sizeCalculated;
+    text->sizeCalculated = this->sizeCalculated.load();
     text->inEditing = this->inEditing;
 
     return text;
@@ -47,7 +48,10 @@ auto Text::clone() const -> ElementPtr { return cloneText(); }
 
 auto Text::getFont() -> XojFont& { return font; }
 
-void Text::setFont(const XojFont& font) { this->font = font; }
+void Text::setFont(const XojFont& font) {
+    this->font = font;
+    boundsChanged();
+}
 
 auto Text::getFontSize() const -> double { return font.getSize(); }
 
@@ -57,15 +61,15 @@ auto Text::getText() const -> const std::string& { return this->text; }
 
 void Text::setText(std::string text) {
     this->text = std::move(text);
+    this->layout.reset();
     sizeCalculated = false;
+    boundsChanged();
 }
 
 void Text::calcSize() const {
-    auto layout = createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
     int w = 0;
     int h = 0;
-    pango_layout_get_size(layout.get(), &w, &h);
+    pango_layout_get_size(getPangoLayout(), &w, &h);
     this->width = (static_cast<double>(w)) / PANGO_SCALE;
     this->height = (static_cast<double>(h)) / PANGO_SCALE;
     this->updateSnapping();
@@ -74,11 +78,13 @@ void Text::calcSize() const {
 void Text::setWidth(double width) {
     this->width = width;
     this->updateSnapping();
+    boundsChanged();
 }
 
 void Text::setHeight(double height) {
     this->height = height;
     this->updateSnapping();
+    boundsChanged();
 }
 
 void Text::setInEditing(bool inEditing) { this->inEditing = inEditing; }
@@ -98,13 +104,27 @@ auto Text::createPangoLayout() const -> xoj::util::GObjectSPtr<PangoLayout> {
 }
 
 void Text::updatePangoFont(PangoLayout* layout) const {
-    PangoFontDescription* desc = pango_font_description_from_string(this->getFontName().c_str());
-    pango_font_description_set_absolute_size(desc, this->getFontSize() * PANGO_SCALE);
+    PangoFontDescription* desc = FontCache::createDescription(this->font);
 
     pango_layout_set_font_description(layout, desc);
     pango_font_description_free(desc);
 }
 
+auto Text::getPangoLayout(const cairo_font_options_t* options) const -> PangoLayout* {
+    if (!this->layout) {
+        this->layout = createPangoLayout();
+        pango_layout_set_text(this->layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
+        this->layoutFont = this->font;
+    } else if (this->layoutFont.getName() != this->font.getName() ||
+               this->layoutFont.getSize() != this->font.getSize()) {
+        updatePangoFont(this->layout.get());
+        this->layoutFont = this->font;
+    }
+    // Setting the same options again does not invalidate the layout
+    pango_cairo_context_set_font_options(pango_layout_get_context(this->layout.get()), options);
+    return this->layout.get();
+}
+
 void Text::scale(double x0, double y0, double fx, double fy, double rotation,
                  bool) {  // line width scaling option is not used
     // only proportional scale allowed...
@@ -124,6 +144,7 @@ void Text::scale(double x0, double y0, double fx, double fy, double rotation,
     this->font.setSize(size);
 
     sizeCalculated = false;
+    boundsChanged();
 }
 
 void Text::rotate(double x0, double y0, double th) {}
@@ -163,6 +184,7 @@ void Text::readSerialized(ObjectInputStream& in) {
     this->AudioElement::readSerialized(in);
 
     this->text = in.readString();
+    this->layout.reset();
 
     font.readSerialized(in);
 
@@ -179,24 +201,28 @@ auto Text::findText(const std::string& search) const -> std::vector<XojPdfRectan
         return {};
     }
 
-    auto layout = this->createPangoLayout();
-    pango_layout_set_text(layout.get(), this->text.c_str(), static_cast<int>(this->text.length()));
-
-
     std::string text = StringUtils::toLowerCase(this->text);
 
     std::string pattern = StringUtils::toLowerCase(search);
 
+    size_t first = text.find(pattern);
+    if (first == std::string::npos) {
+        // Most texts do not contain the pattern: no need to lay them out
+        return {};
+    }
+
+    PangoLayout* layout = this->getPangoLayout();
+
     std::vector<XojPdfRectangle> list;
 
-    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+    for (size_t pos = first; pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
         XojPdfRectangle mark;
         PangoRectangle rect = {0};
-        pango_layout_index_to_pos(layout.get(), static_cast<int>(pos), &rect);
+        pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
         mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + this->getX();
         mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + this->getY();
 
-        pango_layout_index_to_pos(layout.get(), static_cast<int>(pos + patternLength - 1), &rect);
+        pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
         mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + this->getX();
         mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + this->getY();
 
@@ -14,6 +14,7 @@
 #include <string>  // for string
 #include <vector>
 
+#include <cairo.h>  // for cairo_font_options_t
 #include <pango/pango.h>
 
 #include "model/Element.h"
@@ -50,6 +51,14 @@ public:
     xoj::util::GObjectSPtr<PangoLayout> createPangoLayout() const;
     void updatePangoFont(PangoLayout* layout) const;
 
+    /**
+     * @return The layout of the text, built on the first call and kept until the text or the font changes. It is laid
+     *      out in the coordinates of the page (so at any zoom level), with the given font options (those of the
+     *      target surface when drawing) or else the default ones.
+     *      Like the rest of the element, the layout is guarded by the document lock.
+     */
+    PangoLayout* getPangoLayout(const cairo_font_options_t* options = nullptr) const;
+
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
@@ -79,4 +88,8 @@ private:
     std::string text;
 
     bool inEditing = false;
+
+    mutable xoj::util::GObjectSPtr<PangoLayout> layout;
+    /// The font of the layout, which may have been modified through getFont() since
+    mutable XojFont layoutFont;
 };
@@ -1,13 +1,18 @@
 #include "XojPage.h"
 
-#include <algorithm>  // for find, transform
+#include <algorithm>  // for find, transform, equal
 #include <iterator>   // for back_insert_iterator, back_inserter, begin
 #include <utility>    // for move
 
-#include "model/Layer.h"     // for Layer, Layer::Index
-#include "model/PageType.h"  // for PageType, PageTypeFormat, PageTypeForma...
-#include "util/Assert.h"     // for xoj_assert
-#include "util/i18n.h"       // for _
+#include <glib.h>  // for g_get_monotonic_time, g_warning
+
+#include "model/Element.h"            // for ELEMENT_STROKE
+#include "model/Layer.h"              // for Layer, Layer::Index
+#include "model/PageContentLoader.h"  // for PageContentLoader
+#include "model/PageType.h"           // for PageType, PageTypeFormat, PageTypeForma...
+#include "model/Stroke.h"             // for Stroke
+#include "util/Assert.h"              // for xoj_assert
+#include "util/i18n.h"                // for _
 
 #include "BackgroundImage.h"  // for BackgroundImage
 
@@ -31,7 +36,9 @@ XojPage::XojPage(XojPage const& page):
         currentLayer(page.currentLayer),
         bgType(page.bgType),
         pdfBackgroundPage(page.pdfBackgroundPage),
-        backgroundColor(page.backgroundColor) {
+        backgroundColor(page.backgroundColor),
+        backgroundName(page.backgroundName) {
+    page.ensureContentLoaded();
     this->layer.reserve(page.layer.size());
     std::transform(begin(page.layer), end(page.layer), std::back_inserter(this->layer),
                    [](auto* layer) { return layer->clone(); });
@@ -40,11 +47,13 @@ XojPage::XojPage(XojPage const& page):
 auto XojPage::clone() -> XojPage* { return new XojPage(*this); }
 
 void XojPage::addLayer(Layer* layer) {
+    ensureContentLoaded();
     this->layer.push_back(layer);
     this->currentLayer = npos;
 }
 
 void XojPage::insertLayer(Layer* layer, Layer::Index index) {
+    ensureContentLoaded();
     if (index >= this->layer.size()) {
         addLayer(layer);
         return;
@@ -55,6 +64,7 @@ void XojPage::insertLayer(Layer* layer, Layer::Index index) {
 }
 
 void XojPage::removeLayer(Layer* l) {
+    ensureContentLoaded();
     if (auto it = std::find(layer.begin(), layer.end(), l); it != layer.end()) {
         this->layer.erase(it);
     }
@@ -65,16 +75,26 @@ void XojPage::removeLayer(Layer* l) {
     }
 }
 
-void XojPage::setSelectedLayerId(Layer::Index id) { this->currentLayer = id; }
+void XojPage::setSelectedLayerId(Layer::Index id) {
+    this->currentLayer = id;
+    this->revision++;
+}
 
-auto XojPage::getLayers() -> std::vector<Layer*>* { return &this->layer; }
+auto XojPage::getLayers() -> std::vector<Layer*>* {
+    ensureContentLoaded();
+    return &this->layer;
+}
 
-auto XojPage::getLayerCount() const -> Layer::Index { return this->layer.size(); }
+auto XojPage::getLayerCount() const -> Layer::Index {
+    ensureContentLoaded();
+    return this->layer.size();
+}
 
 /**
  * Layer ID 0 = Background, Layer ID 1 = Layer 1
  */
 auto XojPage::getSelectedLayerId() -> Layer::Index {
+    ensureContentLoaded();
     if (this->currentLayer == npos) {
         this->currentLayer = this->layer.size();
     }
@@ -85,9 +105,11 @@ auto XojPage::getSelectedLayerId() -> Layer::Index {
 void XojPage::setLayerVisible(Layer::Index layerId, bool visible) {
     if (layerId == 0) {
         backgroundVisible = visible;
+        this->revision++;
         return;
     }
 
+    ensureContentLoaded();
     layerId--;
     if (layerId >= this->layer.size()) {
         return;
@@ -101,6 +123,7 @@ auto XojPage::isLayerVisible(Layer::Index layerId) const -> bool {
         return backgroundVisible;
     }
 
+    ensureContentLoaded();
     layerId--;
     if (layerId >= this->layer.size()) {
         return false;
@@ -113,15 +136,26 @@ void XojPage::setBackgroundPdfPageNr(size_t page) {
     this->pdfBackgroundPage = page;
     this->bgType.format = PageTypeFormat::Pdf;
     this->bgType.config = "";
+    this->revision++;
+    this->backgroundRevision++;
+    setCachedBackgroundView(nullptr);
 }
 
-void XojPage::setBackgroundColor(Color color) { this->backgroundColor = color; }
+void XojPage::setBackgroundColor(Color color) {
+    this->backgroundColor = color;
+    this->revision++;
+    this->backgroundRevision++;
+    setCachedBackgroundView(nullptr);
+}
 
 auto XojPage::getBackgroundColor() const -> Color { return this->backgroundColor; }
 
 void XojPage::setSize(double width, double height) {
     this->width = width;
     this->height = height;
+    this->revision++;
+    this->backgroundRevision++;
+    setCachedBackgroundView(nullptr);
 }
 
 auto XojPage::getWidth() const -> double { return this->width; }
@@ -131,6 +165,7 @@ auto XojPage::getHeight() const -> double { return this->height; }
 auto XojPage::getPdfPageNr() const -> size_t { return this->pdfBackgroundPage; }
 
 auto XojPage::isAnnotated() const -> bool {
+    ensureContentLoaded();
     for (Layer* l: this->layer) {
         if (l->isAnnotated()) {
             return true;
@@ -148,15 +183,23 @@ void XojPage::setBackgroundType(const PageType& bgType) {
     if (!bgType.isImagePage()) {
         this->backgroundImage.free();
     }
+    this->revision++;
+    this->backgroundRevision++;
+    setCachedBackgroundView(nullptr);
 }
 
 auto XojPage::getBackgroundType() -> PageType { return this->bgType; }
 
 auto XojPage::getBackgroundImage() -> BackgroundImage& { return this->backgroundImage; }
 
-void XojPage::setBackgroundImage(BackgroundImage img) { this->backgroundImage = std::move(img); }
+void XojPage::setBackgroundImage(BackgroundImage img) {
+    this->backgroundImage = std::move(img);
+    this->revision++;
+    this->backgroundRevision++;
+}
 
 auto XojPage::getSelectedLayer() -> Layer* {
+    ensureContentLoaded();
     xoj_assert(!layer.empty());
     size_t layer = getSelectedLayerId();
 
@@ -171,4 +214,133 @@ auto XojPage::getBackgroundName() const -> std::string { return backgroundName.v
 
 auto XojPage::backgroundHasName() const -> bool { return backgroundName.has_value(); }
 
-void XojPage::setBackgroundName(const std::string& newName) { backgroundName = newName; }
+void XojPage::setBackgroundName(const std::string& newName) {
+    backgroundName = newName;
+    this->revision++;
+}
+
+void XojPage::setContentLoader(std::shared_ptr<PageContentLoader> loader) {
+    std::lock_guard lock(this->contentMutex);
+    for (Layer* l: this->layer) { delete l; }
+    this->layer.clear();
+    this->loadedLayerRevisions.clear();
+    this->revisionLayers.clear();
+    this->revision++;
+    this->contentLoader = std::move(loader);
+    this->contentLoaded = this->contentLoader == nullptr;
+}
+
+void XojPage::detachContentLoader() {
+    ensureContentLoaded();
+    std::lock_guard lock(this->contentMutex);
+    this->contentLoader.reset();
+    this->loadedLayerRevisions.clear();
+}
+
+auto XojPage::hasContentLoader() const -> bool {
+    std::lock_guard lock(this->contentMutex);
+    return this->contentLoader != nullptr;
+}
+
+auto XojPage::isContentLoaded() const -> bool { return this->contentLoaded; }
+
+auto XojPage::getLastContentAccess() const -> int64_t { return this->lastContentAccess; }
+
+void XojPage::ensureContentLoaded() const {
+    this->lastContentAccess.store(g_get_monotonic_time(), std::memory_order_relaxed);
+    if (this->contentLoaded.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard lock(this->contentMutex);
+    if (this->contentLoaded) {
+        // Read by another thread in the meantime
+        return;
+    }
+
+    xoj_assert(this->contentLoader);
+    if (!this->contentLoader->load(this->layer)) {
+        g_warning("The content of a page could not be read entirely from the file");
+    }
+    if (this->layer.empty()) {
+        // ensure at least one valid layer exists
+        this->layer.push_back(new Layer());
+    }
+
+    this->loadedLayerRevisions.clear();
+    for (const Layer* l: this->layer) { this->loadedLayerRevisions.emplace_back(l, l->getRevision()); }
+    // Reading the layers is no change
+    this->revisionLayers = this->loadedLayerRevisions;
+    this->loadedChangeCount = getChangeCount();
+    this->contentLoaded.store(true, std::memory_order_release);
+}
+
+auto XojPage::isContentModified() const -> bool {
+    return getChangeCount() != this->loadedChangeCount ||
+           !std::equal(this->layer.begin(), this->layer.end(), this->loadedLayerRevisions.begin(),
+                       this->loadedLayerRevisions.end(), [](const Layer* l, const auto& loaded) {
+                           return l == loaded.first && l->getRevision() == loaded.second;
+                       });
+}
+
+auto XojPage::unloadContent() -> bool {
+    std::lock_guard lock(this->contentMutex);
+    if (!this->contentLoader || !this->contentLoaded || isContentModified()) {
+        return false;
+    }
+
+    for (Layer* l: this->layer) { delete l; }
+    this->layer.clear();
+    this->loadedLayerRevisions.clear();
+    this->contentLoaded = false;
+    return true;
+}
+
+auto XojPage::compactContent() -> size_t {
+    std::lock_guard lock(this->contentMutex);
+    if (!this->contentLoaded || this->lastCompaction > this->lastContentAccess) {
+        // Nothing was expanded since
+        return 0;
+    }
+    this->lastCompaction = g_get_monotonic_time();
+
+    // Go through the layers directly, as this is not an access to the content
+    size_t compacted = 0;
+    for (Layer* l: this->layer) {
+        for (const auto& e: l->getElements()) {
+            if (e->getType() == ELEMENT_STROKE && static_cast<Stroke*>(e.get())->compact()) {
+                compacted++;
+            }
+        }
+    }
+    return compacted;
+}
+
+auto XojPage::getReadMutex() const -> std::mutex& { return this->readMutex; }
+
+auto XojPage::getCachedBackgroundView() const -> std::shared_ptr<const xoj::view::BackgroundView> {
+    std::lock_guard lock(this->backgroundViewMutex);
+    return this->backgroundView;
+}
+
+void XojPage::setCachedBackgroundView(std::shared_ptr<const xoj::view::BackgroundView> view) const {
+    std::lock_guard lock(this->backgroundViewMutex);
+    this->backgroundView = std::move(view);
+}
+
+auto XojPage::getRevision() const -> uint64_t {
+    auto unchanged = [](const Layer* l, const auto& last) {
+        return l == last.first && l->getRevision() == last.second;
+    };
+    // The layers of a page which is not loaded did not change since they were read
+    if (this->contentLoaded.load(std::memory_order_acquire) &&
+        !std::equal(this->layer.begin(), this->layer.end(), this->revisionLayers.begin(), this->revisionLayers.end(),
+                    unchanged)) {
+        this->revision++;
+        this->revisionLayers.clear();
+        for (const Layer* l: this->layer) { this->revisionLayers.emplace_back(l, l->getRevision()); }
+    }
+    return this->revision + getChangeCount();
+}
+
+auto XojPage::getBackgroundRevision() const -> uint64_t { return this->backgroundRevision; }
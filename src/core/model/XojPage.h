@@ -11,9 +11,14 @@
 
 #pragma once
 
+#include <atomic>    // for atomic
 #include <cstddef>   // for size_t
+#include <cstdint>   // for int64_t, uint64_t
+#include <memory>    // for shared_ptr
+#include <mutex>     // for mutex
 #include <optional>  // for optional
 #include <string>    // for string
+#include <utility>   // for pair
 #include <vector>    // for vector
 
 #include "util/Color.h"  // for Color
@@ -24,6 +29,11 @@
 #include "PageHandler.h"      // for PageHandler
 #include "PageType.h"         // for PageType
 
+class PageContentLoader;
+namespace xoj::view {
+class BackgroundView;
+}
+
 class XojPage: public PageHandler {
 public:
     XojPage(double width, double height, bool suppressLayerCreation = false);
@@ -81,6 +91,82 @@ public:
      */
     XojPage* clone();
 
+    /**
+     * @brief Leave the layers in the file: they are read with the loader when they are first needed.
+     *      The current layers are dropped.
+     */
+    void setContentLoader(std::shared_ptr<PageContentLoader> loader);
+
+    /**
+     * @brief Keep the layers in memory from now on (e.g. because the file they were read from is overwritten).
+     *      The layers are read first if needed.
+     */
+    void detachContentLoader();
+
+    /**
+     * @return true if the layers of the page can be read again from a file
+     */
+    bool hasContentLoader() const;
+
+    /**
+     * @return false while the layers of a lazily loaded page are still in the file
+     */
+    bool isContentLoaded() const;
+
+    /**
+     * @return The time (from g_get_monotonic_time()) the layers were last accessed
+     */
+    int64_t getLastContentAccess() const;
+
+    /**
+     * @brief Free the layers of a lazily loaded page, so they are read again from the file when they are needed.
+     *      Nothing is done if the layers were modified since they were read.
+     *      The document must be locked, and nothing may hold pointers to the layers or their elements.
+     * @return true if the layers were freed
+     */
+    bool unloadContent();
+
+    /**
+     * @brief Keep the points of the strokes in single precision until they are used again (see Stroke::compact()).
+     *      Nothing is done if the layers are not loaded. The document must be locked.
+     * @return The number of strokes which were compacted
+     */
+    size_t compactContent();
+
+    /**
+     * @return A counter which changes whenever the attributes, the layers or the elements of the page change: the
+     *      page notifications (see PageHandler::getChangeCount()) and the layers added, removed, renamed or hidden.
+     *      Lazily loaded pages are not loaded to compute it.
+     */
+    uint64_t getRevision() const;
+
+    /**
+     * @return A counter incremented whenever the background type, the PDF page, the image, the color or the size of
+     *      the page changes
+     */
+    uint64_t getBackgroundRevision() const;
+
+    /**
+     * @return The mutex serializing the threads reading the page while the document is locked shared (see
+     *      DocumentPageReadLock)
+     */
+    std::mutex& getReadMutex() const;
+
+    /**
+     * @return The view of the ruling of the page, kept since it was last drawn, or nullptr. Dropped when the
+     *      background type, the background color or the size of the page changes.
+     */
+    std::shared_ptr<const xoj::view::BackgroundView> getCachedBackgroundView() const;
+    void setCachedBackgroundView(std::shared_ptr<const xoj::view::BackgroundView> view) const;
+
+private:
+    /**
+     * Read the layers with the content loader, if they were not read yet
+     */
+    void ensureContentLoaded() const;
+
+    bool isContentModified() const;
+
 private:
     /**
      * The Background image if any
@@ -94,9 +180,39 @@ private:
     double height = 0;
 
     /**
-     * The layer list
+     * The layer list. Filled on first access for lazily loaded pages.
+     */
+    mutable std::vector<Layer*> layer;
+
+    /**
+     * Lazy loading: where the layers are read from, and whether they were read. Also when they were last accessed
+     * and their strokes last compacted.
      */
-    std::vector<Layer*> layer;
+    std::shared_ptr<PageContentLoader> contentLoader;
+    mutable std::atomic<bool> contentLoaded{true};
+    mutable std::mutex contentMutex;
+    mutable std::mutex readMutex;
+    mutable std::atomic<int64_t> lastContentAccess{0};
+    int64_t lastCompaction{0};
+
+    /**
+     * State of the layers after they were read, to tell whether they changed since
+     */
+    mutable std::vector<std::pair<const Layer*, uint64_t>> loadedLayerRevisions;
+    mutable uint64_t loadedChangeCount = 0;
+
+    /**
+     * Changes of the attributes of the page, and the layers when the revision was last computed, see getRevision()
+     */
+    mutable uint64_t revision = 0;
+    uint64_t backgroundRevision = 0;
+    mutable std::vector<std::pair<const Layer*, uint64_t>> revisionLayers;
+
+    /**
+     * The view of the ruling, see getCachedBackgroundView()
+     */
+    mutable std::shared_ptr<const xoj::view::BackgroundView> backgroundView;
+    mutable std::mutex backgroundViewMutex;
 
     /**
      * The current selected layer ID
@@ -134,4 +250,10 @@ private:
     // Allow LayerController to modify layers of a page
     // Notifications were be sent
     friend class LayerController;
+
+    // Allow RecoveryJournal to replace the layers of a recovered page
+    friend class RecoveryJournal;
+
+    // Allow CompactPageUndoAction to remove the empty layers of a page
+    friend class CompactPageUndoAction;
 };
@@ -1,6 +1,6 @@
 #include "ErasableStroke.h"
 
-#include <algorithm>  // for max, min, copy, lower_bound
+#include <algorithm>  // for max, min, copy, lower_bound, sort, remove_if
 #include <cstddef>    // for size_t, ptrdiff_t
 #include <iterator>   // for next
 #include <optional>   // for optional
@@ -8,12 +8,13 @@
 
 #include <glib.h>  // for g_warning
 
-#include "model/Point.h"            // for Point
-#include "model/Stroke.h"           // for Stroke, IntersectionParameter...
-#include "util/Assert.h"            // for xoj_assert
-#include "util/Range.h"             // for Range
-#include "util/SmallVector.h"       // for SmallVector
-#include "util/UnionOfIntervals.h"  // for UnionOfIntervals
+#include "model/Point.h"              // for Point
+#include "model/Stroke.h"             // for Stroke, IntersectionParameter...
+#include "model/StrokeSegmentTree.h"  // for StrokeSegmentTree
+#include "util/Assert.h"              // for xoj_assert
+#include "util/Range.h"               // for Range
+#include "util/SmallVector.h"         // for SmallVector
+#include "util/UnionOfIntervals.h"    // for UnionOfIntervals
 
 #include "ErasableStrokeOverlapTree.h"  // for ErasableStroke::OverlapTree
 #include "PaddedBox.h"                  // for PaddedBox
@@ -23,6 +24,11 @@ using xoj::util::Rectangle;
 ErasableStroke::ErasableStroke(const Stroke& stroke): stroke(stroke) {
     const auto& pts = this->stroke.getPointVector();
     closedStroke = pts.size() >= 3 && pts.front().lineLengthTo(pts.back()) < CLOSED_STROKE_DISTANCE;
+
+    maxLineWidth = this->stroke.getWidth();
+    if (this->stroke.hasPressure()) {
+        for (const Point& p: pts) { maxLineWidth = std::max(maxLineWidth, p.z); }
+    }
 }
 
 ErasableStroke::~ErasableStroke() = default;
@@ -42,6 +48,9 @@ void ErasableStroke::beginErasure(const IntersectionParametersContainer& paddedI
         return;
     }
 
+    // Where the rendering of the stroke changes
+    Range changes;
+
     xoj_assert(paddedIntersections.size() % 2 == 0);
 
     UnionOfIntervals<PathParameter> sections;
@@ -50,7 +59,7 @@ void ErasableStroke::beginErasure(const IntersectionParametersContainer& paddedI
 
     // We will need to rerender everywhere a section was removed
     for (auto& s: sections.cloneToIntervalVector()) {
-        range = range.unite(computeSubSectionBoundingBox(s));
+        changes = changes.unite(computeSubSectionBoundingBox(s));
     }
 
     // Now contains remaining sections
@@ -64,21 +73,21 @@ void ErasableStroke::beginErasure(const IntersectionParametersContainer& paddedI
             if (subsections.size() == 1) {
                 // We erased the stroke from its ends. Simply add the end points to ensure the filling is rerendered
                 const Point& p1 = this->stroke.getPointVector().front();
-                range.addPoint(p1.x, p1.y);
+                changes.addPoint(p1.x, p1.y);
                 const Point& p2 = this->stroke.getPointVector().back();
-                range.addPoint(p2.x, p2.y);
+                changes.addPoint(p2.x, p2.y);
             } else {
                 // The stroke was split in two or more (and possibly shrank). Need to rerender its entire box.
-                range.addPoint(this->stroke.getX(), this->stroke.getY());
-                range.addPoint(this->stroke.getX() + this->stroke.getElementWidth(),
-                               this->stroke.getY() + this->stroke.getElementHeight());
+                changes.addPoint(this->stroke.getX(), this->stroke.getY());
+                changes.addPoint(this->stroke.getX() + this->stroke.getElementWidth(),
+                                 this->stroke.getY() + this->stroke.getElementHeight());
             }
         } else if (subsections.size() > 1) {
             /**
              * Highlighter and the stroke has been split in two or more subsections.
              * Rerender wherever those subsections overlap
              */
-            addOverlapsToRange(subsections, range);
+            addOverlapsToRange(subsections, changes);
         }
     }
 
@@ -86,13 +95,18 @@ void ErasableStroke::beginErasure(const IntersectionParametersContainer& paddedI
         std::lock_guard<std::mutex> lock(this->sectionsMutex);
         this->remainingSections.swap(sections);
     }  // release the mutex
+
+    range = range.unite(changes);
+    invalidateMasks(changes);
 }
 
-void ErasableStroke::erase(const PaddedBox& box, Range& range) {
+void ErasableStroke::erase(const PaddedBox& box, Range& range) { erase(findErasedSections(box), range); }
+
+auto ErasableStroke::findErasedSections(const PaddedBox& box) const -> UnionOfIntervals<PathParameter> {
     size_t n = (size_t)this->stroke.getPointCount();
     if (n < 2) {
         g_warning("Erasing empty stroke");
-        return;
+        return {};
     }
 
     std::vector<SubSection> sections = this->getRemainingSubSectionsVector();
@@ -101,7 +115,7 @@ void ErasableStroke::erase(const PaddedBox& box, Range& range) {
         /** Nothing left to erase! **/
         std::lock_guard<std::mutex> lock(this->boxesMutex);
         boundingBoxes.clear();
-        return;
+        return {};
     }
 
     if (changesAtLastIteration) {
@@ -149,13 +163,23 @@ void ErasableStroke::erase(const PaddedBox& box, Range& range) {
     for (auto& i: indexIntervals) {
         newErasedSections.appendData(this->stroke.intersectWithPaddedBox(box, i.min, i.max));
     }
+    return newErasedSections;
+}
+
+void ErasableStroke::erase(UnionOfIntervals<PathParameter> newErasedSections, Range& range) {
+    size_t n = (size_t)this->stroke.getPointCount();
+    if (n < 2) {
+        return;
+    }
 
     changesAtLastIteration = !newErasedSections.empty();
     if (changesAtLastIteration) {
+        // Where the rendering of the stroke changes
+        Range changes;
 
         // We will need to rerender everywhere a section was removed
         for (auto& s: newErasedSections.cloneToIntervalVector()) {
-            range = range.unite(computeSubSectionBoundingBox(s));
+            changes = changes.unite(computeSubSectionBoundingBox(s));
         }
 
         const bool highlighter = this->stroke.getToolType() == StrokeTool::HIGHLIGHTER;
@@ -165,6 +189,7 @@ void ErasableStroke::erase(const PaddedBox& box, Range& range) {
              * Detect if a section has been modified. If so, rerender whatever needs rerendering.
              */
 
+            std::vector<SubSection> sections = this->getRemainingSubSectionsVector();
             std::vector<SubSection> newRemainingSections;
             // Update the remaining sections
             newErasedSections.complement({0, 0.0}, {n - 2, 1.0});
@@ -196,17 +221,17 @@ void ErasableStroke::erase(const PaddedBox& box, Range& range) {
                         }
                         // The section shrank.
                         Point p = this->stroke.getPoint(section.min);
-                        range.addPoint(p.x, p.y);
+                        changes.addPoint(p.x, p.y);
                         p = this->stroke.getPoint(section.max);
-                        range.addPoint(p.x, p.y);
+                        changes.addPoint(p.x, p.y);
                         p = this->stroke.getPoint(subsection.min);
-                        range.addPoint(p.x, p.y);
+                        changes.addPoint(p.x, p.y);
                         p = this->stroke.getPoint(subsection.max);
-                        range.addPoint(p.x, p.y);
+                        changes.addPoint(p.x, p.y);
                         continue;
                     }
                     // The section was split in two or more (and possibly shrank). Need to rerender its entire box.
-                    range = range.unite(this->getSubSectionBoundingBox(section));
+                    changes = changes.unite(this->getSubSectionBoundingBox(section));
                     break;
                 }
                 // Necessarily highlighter and not filled
@@ -215,7 +240,7 @@ void ErasableStroke::erase(const PaddedBox& box, Range& range) {
                      * The section has been split in two (or more).
                      * Rerender wherever those subsections overlap.
                      */
-                    addOverlapsToRange(subsections, range);
+                    addOverlapsToRange(subsections, changes);
                 }
             }
         } else {
@@ -226,10 +251,13 @@ void ErasableStroke::erase(const PaddedBox& box, Range& range) {
                 remainingSections.intersect(newErasedSections.getData());
             }  // Release the mutex
         }
+
+        range = range.unite(changes);
+        invalidateMasks(changes);
     }
 }
 
-auto ErasableStroke::getStrokes() const -> std::vector<std::unique_ptr<Stroke>> {
+auto ErasableStroke::getStrokes(std::vector<IndexRanges>* copiedPoints) const -> std::vector<std::unique_ptr<Stroke>> {
     std::vector<SubSection> sections = this->getRemainingSubSectionsVector();
 
     std::vector<std::unique_ptr<Stroke>> strokes;
@@ -247,6 +275,11 @@ auto ErasableStroke::getStrokes() const -> std::vector<std::unique_ptr<Stroke>>
          * Clone the first and last sections as a single stroke
          */
         strokes.push_back(this->stroke.cloneCircularSectionOfClosedStroke(sections.back().min, sections.front().max));
+        if (copiedPoints) {
+            // See Stroke::cloneCircularSectionOfClosedStroke(): the last point is the first one
+            copiedPoints->push_back({{sections.back().min.index + 1, this->stroke.getPointCount() - 1},
+                                     {0, sections.front().max.index + 1}});
+        }
 
         // Avoid cloning those sections again
         ++sectionIt;
@@ -255,6 +288,9 @@ auto ErasableStroke::getStrokes() const -> std::vector<std::unique_ptr<Stroke>>
 
     for (; sectionIt != sectionEndIt; ++sectionIt) {
         strokes.push_back(this->stroke.cloneSection(sectionIt->min, sectionIt->max));
+        if (copiedPoints) {
+            copiedPoints->push_back({{sectionIt->min.index + 1, sectionIt->max.index + 1}});
+        }
     }
 
     return strokes;
@@ -267,7 +303,18 @@ std::vector<ErasableStroke::SubSection> ErasableStroke::getRemainingSubSectionsV
 
 bool ErasableStroke::isClosedStroke() const { return this->closedStroke; }
 
-auto ErasableStroke::getSubSectionBoundingBox(const ErasableStroke::SubSection& section) const -> const Range& {
+double ErasableStroke::getMaxLineWidth() const { return this->maxLineWidth; }
+
+void ErasableStroke::invalidateMasks(const Range& rg) {
+    if (rg.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->masksMutex);
+    this->linesMask.dirtyRange = this->linesMask.dirtyRange.unite(rg);
+    this->fillingMask.dirtyRange = this->fillingMask.dirtyRange.unite(rg);
+}
+
+auto ErasableStroke::getSubSectionBoundingBox(const ErasableStroke::SubSection& section) const -> Range {
 
     std::lock_guard<std::mutex> lock(this->boxesMutex);
 
@@ -303,7 +350,7 @@ auto ErasableStroke::computeSubSectionBoundingBox(const SubSection& section) con
 
     Range rg = pointRange(this->stroke.getPoint(section.min));
 
-    auto data = this->stroke.getPointVector();
+    const auto& data = this->stroke.getPointVector();
     auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)section.max.index + 1);
     for (auto ptIt = std::next(data.cbegin(), (std::ptrdiff_t)section.min.index + 1); ptIt != endIt; ++ptIt) {
         rg = rg.unite(pointRange(*ptIt));
@@ -313,9 +360,21 @@ auto ErasableStroke::computeSubSectionBoundingBox(const SubSection& section) con
 }
 
 void ErasableStroke::addOverlapsToRange(const std::vector<SubSection>& subsections, Range& range) {
+    /**
+     * Sweep and prune: the subsections are sorted by the left side of their bounding box, so that each one only needs
+     * to be compared to the previous ones whose bounding box reaches it.
+     */
+    std::vector<std::pair<Range, size_t>> boxes;
+    boxes.reserve(subsections.size());
+    for (size_t i = 0; i < subsections.size(); ++i) {
+        boxes.emplace_back(getSubSectionBoundingBox(subsections[i]), i);
+    }
+    std::sort(boxes.begin(), boxes.end(), [](const auto& a, const auto& b) { return a.first.minX < b.first.minX; });
+
+    const StrokeSegmentTree* segmentTree = this->stroke.getSegmentTree();
 
-    // Will contain the intersection trees of the subsections
-    std::vector<OverlapTree> overlapTrees(subsections.size());
+    // Will contain the intersection trees of the subsections, if the stroke is too short for a segment tree
+    std::vector<OverlapTree> overlapTrees(segmentTree ? 0 : subsections.size());
     /**
      * For each given subsection, we compute a binary tree whose leaves correspond to individual segments in the
      * subsection and contain the thin bounding box of the segments.
@@ -325,32 +384,81 @@ void ErasableStroke::addOverlapsToRange(const std::vector<SubSection>& subsectio
      * To compute the overlaps between two subsections, we intersect the bounding boxes in their trees, until we reach
      * intersecting leaves.
      * See ErasableStroke::OverlapTree for the details.
+     *
+     * The long strokes use their segment tree instead, which is kept for as long as the stroke: only the boxes of the
+     * segments at the ends of the subsections need to be computed.
      */
 
     const double halfWidth = 0.5 * this->stroke.getWidth();
-    size_t i = 0;
-    size_t j = 0;
-    for (auto it1 = subsections.cbegin(), itEnd = subsections.cend(); it1 != itEnd; ++it1, ++i) {
-        j = i + 1;
-        for (auto it2 = std::next(it1); it2 != itEnd; ++it2, ++j) {
-            if (!getSubSectionBoundingBox(*it1).intersect(getSubSectionBoundingBox(*it2)).empty()) {
-                // Compute the intersections trees if they have not yet been computed
-                if (!overlapTrees[i].isPopulated()) {
-                    overlapTrees[i].populate(*it1, this->stroke);
-                }
-                if (!overlapTrees[j].isPopulated()) {
-                    overlapTrees[j].populate(*it2, this->stroke);
-                }
+    std::vector<const std::pair<Range, size_t>*> active;
+    for (const auto& box: boxes) {
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&box](const auto* other) { return other->first.maxX < box.first.minX; }),
+                     active.end());
+        for (const auto* other: active) {
+            if (box.first.intersect(other->first).empty()) {
+                continue;
+            }
+            size_t i = std::min(box.second, other->second);
+            size_t j = std::max(box.second, other->second);
+            if (segmentTree) {
+                addOverlapsToRange(*segmentTree, subsections[i], subsections[j], halfWidth, range);
+                continue;
+            }
+            // Compute the intersections trees if they have not yet been computed
+            if (!overlapTrees[i].isPopulated()) {
+                overlapTrees[i].populate(subsections[i], this->stroke);
+            }
+            if (!overlapTrees[j].isPopulated()) {
+                overlapTrees[j].populate(subsections[j], this->stroke);
+            }
 #ifdef DEBUG_ERASABLE_STROKE_BOXES
-                overlapTrees[i].addOverlapsToRange(overlapTrees[j], halfWidth, range, debugMask.get());
+            overlapTrees[i].addOverlapsToRange(overlapTrees[j], halfWidth, range, debugMask.get());
 #else
-                overlapTrees[i].addOverlapsToRange(overlapTrees[j], halfWidth, range);
+            overlapTrees[i].addOverlapsToRange(overlapTrees[j], halfWidth, range);
 #endif
-            }
         }
+        active.push_back(&box);
     }
 }
 
+void ErasableStroke::addOverlapsToRange(const StrokeSegmentTree& tree, const SubSection& section1,
+                                        const SubSection& section2, double halfWidth, Range& range) const {
+    // The segments of a section, the first and last ones being cut at the ends of the section
+    auto lastSegment = [](const SubSection& section) {
+        return section.max.t == 0.0 && section.max.index > section.min.index ? section.max.index - 1
+                                                                              : section.max.index;
+    };
+    auto segmentBox = [&](const SubSection& section, size_t i) {
+        const Point p1 = i == section.min.index ? this->stroke.getPoint(section.min) : this->stroke.getPoint(i);
+        const Point p2 = i == section.max.index ? this->stroke.getPoint(section.max) : this->stroke.getPoint(i + 1);
+        Range box(p1.x, p1.y);
+        box.addPoint(p2.x, p2.y);
+        box.addPadding(halfWidth);
+        return box;
+    };
+
+    tree.forEachOverlappingRangePair(
+            section1.min.index, lastSegment(section1), section2.min.index, lastSegment(section2), halfWidth,
+            [&](size_t first1, size_t last1, size_t first2, size_t last2) {
+                for (size_t i = first1; i <= last1; ++i) {
+                    const Range box1 = segmentBox(section1, i);
+                    for (size_t j = first2; j <= last2; ++j) {
+                        const Range box2 = segmentBox(section2, j);
+                        if (box1.maxX > box2.minX && box2.maxX > box1.minX && box1.maxY > box2.minY &&
+                            box2.maxY > box1.minY) {
+                            const Range overlap = box1.intersect(box2);
+#ifdef DEBUG_ERASABLE_STROKE_BOXES
+                            paintDebugRect(Rectangle<double>(overlap), 'b', debugMask.get());
+#endif
+                            range.addPoint(overlap.minX, overlap.minY);
+                            range.addPoint(overlap.maxX, overlap.maxY);
+                        }
+                    }
+                }
+            });
+}
+
 #ifdef DEBUG_ERASABLE_STROKE_BOXES
 void ErasableStroke::paintDebugRect(const Rectangle<double>& rect, char color, cairo_t* cr) {
     if (cr == nullptr) {
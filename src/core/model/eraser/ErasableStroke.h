@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstddef>  // for size_t
 #include <memory>   // for unique_ptr
 #include <mutex>    // for mutex
 #include <utility>  // for pair
@@ -20,18 +21,18 @@
 #include "model/PathParameter.h"    // for PathParameter
 #include "model/Stroke.h"           // for Stroke (ptr only), IntersectionPa...
 #include "util/Interval.h"          // for Interval
+#include "util/Range.h"             // for Range
 #include "util/Rectangle.h"         // for Rectangle
 #include "util/UnionOfIntervals.h"  // for UnionOfIntervals
+#include "view/Mask.h"              // for Mask
 
 #include "config-debug.h"  // for DEBUG_ERASABLE_STROKE_BOXES
 
 #ifdef DEBUG_ERASABLE_STROKE_BOXES
 #include <cairo.h>  // for cairo_t
-
-#include "view/Mask.h"
 #endif
 
-class Range;
+class StrokeSegmentTree;
 struct PaddedBox;
 
 class ErasableStroke {
@@ -65,12 +66,33 @@ public:
      */
     void erase(const PaddedBox& box, Range& range);
 
+    /**
+     * @brief Find the sections of the stroke that the eraser box would erase, without erasing them.
+     * Apart from the cache of bounding boxes, this does not modify the ErasableStroke: several strokes can be tested
+     * concurrently. The result is meant for erase(erasedSections, range).
+     * @param box PaddedBox of the eraser
+     * @return The sections to be erased
+     */
+    UnionOfIntervals<PathParameter> findErasedSections(const PaddedBox& box) const;
+
+    /**
+     * @brief Erase the sections returned by findErasedSections()
+     * @param erasedSections The sections to be erased
+     * @param range Range (destined to rerendering) that will be widened around the erased sections
+     */
+    void erase(UnionOfIntervals<PathParameter> erasedSections, Range& range);
+
+    /// Ranges [first, last) of indices of the points of the stroke
+    using IndexRanges = std::vector<std::pair<size_t, size_t>>;
+
     /**
      * @brief Get the resulting strokes (if any) once the erasing is finished
+     * @param copiedPoints (optional) Receives, for each resulting stroke, the indices of the points of the stroke
+     *      copied in between its first and last points (which are interpolated), in their order in the resulting stroke
      * @return A vector of pointers to newly created strokes (owned by the caller).
      * The resulting strokes correspond to what's left of the original stroke
      */
-    std::vector<std::unique_ptr<Stroke>> getStrokes() const;
+    std::vector<std::unique_ptr<Stroke>> getStrokes(std::vector<IndexRanges>* copiedPoints = nullptr) const;
 
     /**
      * @brief Get a clone of the data, in the form of a vector of sections
@@ -83,12 +105,17 @@ public:
      */
     bool isClosedStroke() const;
 
+    /**
+     * @return The width of the thickest point of the stroke
+     */
+    double getMaxLineWidth() const;
+
     /**
      * @brief Get the bounding box of a subsection.
      * The bounding box is either pulled from cache or computed and added to cache
-     * @return The bounding box.
+     * @return The bounding box. It is returned by value, as the cache may be modified by another call at any time.
      */
-    const Range& getSubSectionBoundingBox(const SubSection& section) const;
+    Range getSubSectionBoundingBox(const SubSection& section) const;
 
 protected:
     /**
@@ -104,6 +131,17 @@ protected:
      */
     void addOverlapsToRange(const std::vector<SubSection>& subsections, Range& range);
 
+    /**
+     * @brief Add to the range the overlaps of two subsections, found with the segment tree of the stroke
+     */
+    void addOverlapsToRange(const StrokeSegmentTree& tree, const SubSection& section1, const SubSection& section2,
+                            double halfWidth, Range& range) const;
+
+    /**
+     * @brief Mark the cached masks as out of date in the given range
+     */
+    void invalidateMasks(const Range& rg);
+
 public:
     /**
      * @brief Reference to the stroke being erased
@@ -137,6 +175,22 @@ protected:
     bool closedStroke;
     static constexpr double CLOSED_STROKE_DISTANCE = 0.3;
 
+    double maxLineWidth;
+
+public:
+    /**
+     * @brief Rendering of the remaining sections, kept by ErasableStrokeView from one frame to the next so that only
+     * the parts of the stroke which were erased in between need to be drawn again.
+     */
+    struct CachedMask {
+        xoj::view::Mask mask;
+        /// Where the mask is out of date
+        Range dirtyRange;
+    };
+    mutable CachedMask linesMask;
+    mutable CachedMask fillingMask;
+    mutable std::mutex masksMutex;
+
 #ifdef DEBUG_ERASABLE_STROKE_BOXES
 public:
     mutable xoj::view::Mask debugMask;
@@ -1,33 +1,62 @@
 #include "XojCairoPdfExport.h"
 
-#include <algorithm>  // for copy, min
-#include <map>        // for map
-#include <memory>     // for __shared_ptr_access
-#include <sstream>    // for ostringstream, operator<<
-#include <stack>      // for stack
-#include <utility>    // for pair, make_pair
-#include <vector>     // for vector
+#include <algorithm>           // for clamp, copy, min
+#include <condition_variable>  // for condition_variable
+#include <map>                 // for map
+#include <memory>              // for __shared_ptr_access
+#include <mutex>               // for mutex, unique_lock
+#include <numeric>             // for iota
+#include <sstream>             // for ostringstream, operator<<
+#include <thread>              // for thread
+#include <utility>             // for pair, make_pair, move
+#include <vector>              // for vector
 
 #include <cairo-pdf.h>    // for cairo_pdf_surface_set_met...
 #include <glib-object.h>  // for g_object_unref
-
-#include "control/jobs/ProgressListener.h"  // for ProgressListener
-#include "model/Document.h"                 // for Document
-#include "model/Layer.h"                    // for Layer
-#include "model/LinkDestination.h"          // for LinkDestination, XojLinkDest
-#include "model/PageRef.h"                  // for PageRef
-#include "model/PageType.h"                 // for PageType
-#include "model/XojPage.h"                  // for XojPage
-#include "pdf/base/XojPdfPage.h"            // for XojPdfPageSPtr, XojPdfPage
-#include "util/Assert.h"                    // for xoj_assert
-#include "util/Util.h"                      // for npos
-#include "util/i18n.h"                      // for _
-#include "util/serdesstream.h"              // for serdes_stream
-#include "view/DocumentView.h"              // for DocumentView
+#include <glib.h>         // for g_warning
+
+#include "control/jobs/ProgressListener.h"    // for ProgressListener
+#include "control/jobs/Scheduler.h"           // for Scheduler
+#include "model/Document.h"                   // for Document
+#include "model/Layer.h"                      // for Layer
+#include "model/LinkDestination.h"            // for LinkDestination
+#include "model/PageRef.h"                    // for PageRef
+#include "model/PageType.h"                   // for PageType
+#include "model/XojPage.h"                    // for XojPage
+#include "pdf/base/XojPdfAction.h"            // for XojPdfAction
+#include "pdf/base/XojPdfBookmarkIterator.h"  // for XojPdfBookmarkIterator
+#include "pdf/base/XojPdfPage.h"              // for XojPdfPageSPtr, XojPdfPage
+#include "util/Assert.h"                      // for xoj_assert
+#include "util/Util.h"                        // for npos
+#include "util/i18n.h"                        // for _
+#include "util/serdesstream.h"                // for serdes_stream
+#include "view/DocumentView.h"                // for DocumentView
 
 #include "config.h"      // for PROJECT_STRING
 #include "filesystem.h"  // for path
 
+namespace {
+/**
+ * Records what draw() paints on a page of the given size, to paint it later on the pdf surface
+ */
+template <typename DrawFun>
+auto record(double width, double height, DrawFun&& draw) -> xoj::util::CairoSurfaceSPtr {
+    cairo_rectangle_t extents{0, 0, width, height};
+    xoj::util::CairoSurfaceSPtr surface(cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, &extents),
+                                        xoj::util::adopt);
+    xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+
+    // Turn on font hint metrics, for consistency with text display in the app
+    cairo_font_options_t* fontOptions = cairo_font_options_create();
+    cairo_font_options_set_hint_metrics(fontOptions, CAIRO_HINT_METRICS_ON);
+    cairo_set_font_options(cr.get(), fontOptions);
+    cairo_font_options_destroy(fontOptions);
+
+    draw(cr.get());
+    return surface;
+}
+}  // namespace
+
 XojCairoPdfExport::XojCairoPdfExport(Document* doc, ProgressListener* progressListener):
         doc(doc), progressListener(progressListener) {}
 
@@ -56,39 +85,31 @@ auto XojCairoPdfExport::startPdf(const fs::path& file, bool exportOutline) -> bo
     }
 #endif
 
-    // Turn on font hint metrics, for consistency with text display in the app
-    cairo_font_options_t* fontOptions = cairo_font_options_create();
-    cairo_font_options_set_hint_metrics(fontOptions, CAIRO_HINT_METRICS_ON);
-    cairo_set_font_options(cr, fontOptions);
-    cairo_font_options_destroy(fontOptions);
-
     return cairo_surface_status(this->surface) == CAIRO_STATUS_SUCCESS;
 }
 
 #if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1, 16, 0)
 void XojCairoPdfExport::populatePdfOutline() {
-    auto tocModel = doc->getContentsModel();
-    if (tocModel == nullptr)
-        return;
-
-    int idCounter = CAIRO_PDF_OUTLINE_ROOT;
-    std::stack<std::pair<GtkTreeIter, int>> nodeStack;
-
-    GtkTreeIter firstIter = {0};
-    if (!gtk_tree_model_get_iter_first(tocModel, &firstIter)) {
+    // From the outline of the background PDF rather than from the contents model, which is only loaded where the
+    // user expanded it
+    std::unique_ptr<XojPdfBookmarkIterator> iter(doc->getPdfDocument().getContentsIter());
+    if (iter == nullptr) {
         // Outline is empty, so do nothing.
         return;
     }
+    addPdfOutline(iter.get(), CAIRO_PDF_OUTLINE_ROOT);
+}
 
-    nodeStack.push(std::make_pair(firstIter, idCounter));
-    while (!nodeStack.empty()) {
-        auto [iter, parentId] = nodeStack.top();
-        nodeStack.pop();
-        const int currentId = ++idCounter;
-        XojLinkDest* link = nullptr;
+void XojCairoPdfExport::addPdfOutline(XojPdfBookmarkIterator* iter, int parentId) {
+    do {
+        std::unique_ptr<XojPdfAction> action(iter->getAction());
+        if (action == nullptr || action->getTitle().empty()) {
+            // Skipped with their children, as in the contents model
+            continue;
+        }
 
-        gtk_tree_model_get(tocModel, &iter, DOCUMENT_LINKS_COLUMN_LINK, &link, -1);
-        auto dest = link->dest;
+        int currentId = parentId;
+        auto dest = action->getDestination();
         auto pdfBgPage = dest->getPdfPage();  // Link destination in original background PDF
         auto pageDest = pdfBgPage == npos ? npos : doc->findPdfPage(pdfBgPage);  // Destination in document
         if (pageDest != npos) {
@@ -98,25 +119,21 @@ void XojCairoPdfExport::populatePdfOutline() {
                 linkAttrBuf << " pos=[" << dest->getLeft() << " " << dest->getTop() << "]";
             }
             const auto linkAttr = linkAttrBuf.str();
-            auto outlineFlags = dest->getExpand() ? CAIRO_PDF_OUTLINE_FLAG_OPEN : 0;
-            cairo_pdf_surface_add_outline(this->surface, parentId, link->dest->getName().data(), linkAttr.data(),
-                                          static_cast<cairo_pdf_outline_flags_t>(outlineFlags));
-        }
-        g_object_unref(link);
-
-        GtkTreeIter childIter;
-        if (gtk_tree_model_iter_children(tocModel, &childIter, &iter)) {
-            nodeStack.push(std::make_pair(childIter, currentId));
+            auto outlineFlags = iter->isOpen() ? CAIRO_PDF_OUTLINE_FLAG_OPEN : 0;
+            currentId = cairo_pdf_surface_add_outline(this->surface, parentId, action->getTitle().c_str(),
+                                                      linkAttr.data(),
+                                                      static_cast<cairo_pdf_outline_flags_t>(outlineFlags));
         }
 
-        if (gtk_tree_model_iter_next(tocModel, &iter)) {
-            nodeStack.push(std::make_pair(iter, parentId));
+        if (std::unique_ptr<XojPdfBookmarkIterator> child{iter->getChildIter()}) {
+            addPdfOutline(child.get(), currentId);
         }
-    }
+    } while (iter->next());
 }
 #endif
 
 bool XojCairoPdfExport::endPdf() {
+    this->pdfBackground.reset();
     cairo_surface_finish(this->surface);
     bool success = cairo_surface_status(this->surface) == CAIRO_STATUS_SUCCESS;
     if (!success) {
@@ -131,21 +148,27 @@ bool XojCairoPdfExport::endPdf() {
     return success;
 }
 
-void XojCairoPdfExport::exportPage(size_t page) {
-    PageRef p = doc->getPage(page);
-
-    cairo_pdf_surface_set_size(this->surface, p->getWidth(), p->getHeight());
-
-    DocumentView view;
-
-    cairo_save(this->cr);
+auto XojCairoPdfExport::recordPage(size_t page, bool progressiveMode) -> RecordedPage {
+    RecordedPage rec;
+    XojPdfPageSPtr popplerPage;
 
+    doc->lock();
+    PageRef p = doc->getPage(page);
+    const bool unloadAfterwards = p->hasContentLoader() && !p->isContentLoaded();
     // For a better pdf quality, we use a dedicated pdf rendering
     if (p->getBackgroundType().isPdfPage() && (exportBackground != EXPORT_BACKGROUND_NONE)) {
-        auto pgNo = p->getPdfPageNr();
-        XojPdfPageSPtr popplerPage = doc->getPdfPage(pgNo);
+        rec.pdfPageNo = p->getPdfPageNr();
+        popplerPage = doc->getPdfPage(rec.pdfPageNo);
+    }
+    doc->unlock();
 
-        popplerPage->renderForPrinting(cr);
+    rec.width = p->getWidth();
+    rec.height = p->getHeight();
+
+    if (popplerPage) {
+        rec.background = record(rec.width, rec.height, [&](cairo_t* cr) { popplerPage->renderForPrinting(cr); });
+    } else if (rec.pdfPageNo != npos) {
+        g_warning("XojCairoPdfExport: could not find the pdf page %zu", rec.pdfPageNo);
     }
 
     xoj::view::BackgroundFlags flags;
@@ -155,21 +178,31 @@ void XojCairoPdfExport::exportPage(size_t page) {
     flags.showRuling = exportBackground <= EXPORT_BACKGROUND_UNRULED ? xoj::view::HIDE_RULING_BACKGROUND :
                                                                        xoj::view::SHOW_RULING_BACKGROUND;
 
-    if (layerRange) {
-        view.drawLayersOfPage(*layerRange, p, this->cr, true /* dont render eraseable */, flags);
-    } else {
-        view.drawPage(p, this->cr, true /* dont render eraseable */, flags);
-    }
-
-    // next page
-    cairo_show_page(this->cr);
-    cairo_restore(this->cr);
-}
+    DocumentView view;
+    auto drawPage = [&](cairo_t* cr) {
+        if (layerRange) {
+            view.drawLayersOfPage(*layerRange, p, cr, true /* dont render eraseable */, flags);
+        } else {
+            view.drawPage(p, cr, true /* dont render eraseable */, flags);
+        }
+    };
+
+    // The recordings hold no pointer to the elements
+    auto unloadPage = [&]() {
+        if (unloadAfterwards) {
+            doc->lock();
+            p->unloadContent();
+            doc->unlock();
+        }
+    };
 
-// export layers one by one to produce as many PDF pages as there are layers.
-void XojCairoPdfExport::exportPageLayers(size_t page) {
-    PageRef p = doc->getPage(page);
+    if (!progressiveMode) {
+        rec.pages.emplace_back(record(rec.width, rec.height, drawPage));
+        unloadPage();
+        return rec;
+    }
 
+    // export layers one by one to produce as many PDF pages as there are layers.
     // We keep a copy of the layers initial Visible state
     std::map<Layer*, bool> initialVisibility;
     for (const auto& layer: *p->getLayers()) {
@@ -181,11 +214,106 @@ void XojCairoPdfExport::exportPageLayers(size_t page) {
     // only Layer 1 visible, the last has all layers visible.
     for (const auto& layer: *p->getLayers()) {
         layer->setVisible(true);
-        exportPage(page);
+        rec.pages.emplace_back(record(rec.width, rec.height, drawPage));
     }
 
     // We restore the initial visibilities
     for (const auto& layer: *p->getLayers()) layer->setVisible(initialVisibility[layer]);
+    unloadPage();
+    return rec;
+}
+
+void XojCairoPdfExport::writePage(RecordedPage& rec) {
+    if (rec.pdfPageNo != this->pdfBackgroundPageNo || !this->pdfBackground) {
+        if (this->pdfBackground) {
+            // No longer painted
+            cairo_surface_finish(this->pdfBackground.get());
+        }
+        this->pdfBackground = std::move(rec.background);
+        this->pdfBackgroundPageNo = rec.pdfPageNo;
+    }
+
+    for (const auto& recording: rec.pages) {
+        cairo_pdf_surface_set_size(this->surface, rec.width, rec.height);
+        cairo_save(this->cr);
+
+        // Painting the same recording again, cairo writes it only once in the file
+        if (rec.pdfPageNo != npos && this->pdfBackground) {
+            cairo_set_source_surface(this->cr, this->pdfBackground.get(), 0, 0);
+            cairo_paint(this->cr);
+        }
+        cairo_set_source_surface(this->cr, recording.get(), 0, 0);
+        cairo_paint(this->cr);
+
+        // next page
+        cairo_show_page(this->cr);
+        cairo_restore(this->cr);
+
+        // The page is written in the file
+        cairo_surface_finish(recording.get());
+    }
+}
+
+void XojCairoPdfExport::exportPages(const std::vector<size_t>& pages, bool progressiveMode) {
+    if (this->progressListener) {
+        this->progressListener->setMaximumState(pages.size());
+    }
+    if (pages.empty()) {
+        return;
+    }
+
+    const size_t threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, pages.size());
+    // The pages are recorded at most that far ahead of the page being written, as they hold all their content
+    const size_t window = 2 * threadCount;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::map<size_t, RecordedPage> recorded;  // By position in pages
+    size_t next = 0;
+    size_t written = 0;
+
+    auto recordPages = [&]() {
+        std::unique_lock lock(mutex);
+        while (true) {
+            cond.wait(lock, [&]() { return next >= pages.size() || next < written + window; });
+            if (next >= pages.size()) {
+                return;
+            }
+            const size_t n = next++;
+            lock.unlock();
+            RecordedPage rec = recordPage(pages[n], progressiveMode);
+            lock.lock();
+            recorded.emplace(n, std::move(rec));
+            cond.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        threads.emplace_back(recordPages);
+    }
+
+    // The pages are written in order, as soon as they are recorded
+    for (size_t n = 0; n < pages.size(); n++) {
+        std::unique_lock lock(mutex);
+        cond.wait(lock, [&]() { return recorded.count(n) != 0; });
+        auto node = recorded.extract(n);
+        written = n + 1;
+        cond.notify_all();
+        lock.unlock();
+
+        writePage(node.mapped());
+
+        if (this->progressListener) {
+            this->progressListener->setCurrentState(n + 1);
+        }
+        Scheduler::yieldToUrgentJobs();
+    }
+
+    for (auto& t: threads) {
+        t.join();
+    }
 }
 
 auto XojCairoPdfExport::createPdf(fs::path const& file, const PageRangeVector& range, bool progressiveMode) -> bool {
@@ -205,31 +333,15 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, const PageRangeVector& r
         return false;
     }
 
-    size_t count = 0;
+    std::vector<size_t> pages;
     for (const auto& e: range) {
         xoj_assert(e.last >= e.first);  // Ok, when the PageRangeVector was the result of parsing
-        count += e.last - e.first + 1;  // Not accurate, if e.last is > doc->getPageCount()
-    }
-
-    if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
-    }
-
-    size_t c = 0;
-    for (const auto& e: range) {
-        auto max = std::min(e.last, doc->getPageCount());  // Should be e.last for parsed PageRangeVector
-        for (size_t i = e.first; i <= max; i++) {
-            if (progressiveMode) {
-                exportPageLayers(i);
-            } else {
-                exportPage(i);
-            }
-
-            if (this->progressListener) {
-                this->progressListener->setCurrentState(++c);
-            }
+        auto end = std::min(e.last + 1, doc->getPageCount());  // Should be e.last + 1 for parsed PageRangeVector
+        for (size_t i = e.first; i < end; i++) {
+            pages.push_back(i);
         }
     }
+    exportPages(pages, progressiveMode);
 
     return endPdf();
 }
@@ -247,22 +359,9 @@ auto XojCairoPdfExport::createPdf(fs::path const& file, bool progressiveMode) ->
         return false;
     }
 
-    auto count = doc->getPageCount();
-    if (this->progressListener) {
-        this->progressListener->setMaximumState(count);
-    }
-
-    for (decltype(count) i = 0; i < count; i++) {
-        if (progressiveMode) {
-            exportPageLayers(i);
-        } else {
-            exportPage(i);
-        }
-
-        if (this->progressListener) {
-            this->progressListener->setCurrentState(i + 1);
-        }
-    }
+    std::vector<size_t> pages(doc->getPageCount());
+    std::iota(pages.begin(), pages.end(), size_t(0));
+    exportPages(pages, progressiveMode);
 
     return endPdf();
 }
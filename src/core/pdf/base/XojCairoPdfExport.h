@@ -12,19 +12,24 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
 #include <string>   // for string
+#include <vector>   // for vector
 
 #include <cairo.h>    // for CAIRO_VERSION, CAIRO_VERSION...
 #include <gtk/gtk.h>  // for GtkTreeModel
 
 #include "control/jobs/BaseExportJob.h"  // for ExportBackgroundType, EXPORT...
 #include "util/ElementRange.h"           // for PageRangeVector
+#include "util/Util.h"                   // for npos
+#include "util/raii/CairoWrappers.h"     // for CairoSurfaceSPtr
 
 #include "XojPdfExport.h"  // for XojPdfExport
 #include "filesystem.h"    // for path
 
 class Document;
 class ProgressListener;
+class XojPdfBookmarkIterator;
 
 class XojCairoPdfExport: public XojPdfExport {
 public:
@@ -51,13 +56,49 @@ private:
      * This requires features available only in cairo 1.16 or newer.
      */
     void populatePdfOutline();
+
+    /**
+     * Add the entries of the iterator and their children under the outline entry parentId
+     */
+    void addPdfOutline(XojPdfBookmarkIterator* iter, int parentId);
 #endif
     bool endPdf();
-    void exportPage(size_t page);
+
     /**
-     * Export as a PDF document where each additional layer creates a
-     * new page */
-    void exportPageLayers(size_t page);
+     * The content of a page of the document, recorded to be written in the pdf surface
+     */
+    struct RecordedPage {
+        double width = 0;
+        double height = 0;
+        /// The pdf background page, or npos
+        size_t pdfPageNo = npos;
+        xoj::util::CairoSurfaceSPtr background;
+        /// One recording per exported pdf page: a single one, or one per layer in progressive mode
+        std::vector<xoj::util::CairoSurfaceSPtr> pages;
+    };
+
+    /**
+     * Record the page of the document. Called by the worker threads: only reads the document.
+     * In progressive mode, each additional layer creates a new page.
+     * The layers of a lazily loaded page are freed again once recorded, if the export loaded them: the memory used by
+     * the export does not grow with the number of pages.
+     */
+    RecordedPage recordPage(size_t page, bool progressiveMode);
+
+    /**
+     * Write the recorded page in the pdf surface. The background of the last written page is painted again as is when
+     * the next page has the same one (e.g. the pages of a progressive export): cairo then writes it only once in the
+     * exported file, and every page refers to it.
+     * The recordings are finished once written: the pdf surface keeps a reference to them until the end of the export,
+     * but their content (and the images they reference) is freed.
+     */
+    void writePage(RecordedPage& rec);
+
+    /**
+     * Export the pages, in the given order. They are recorded in parallel by a pool of threads, and written in order by
+     * the calling thread, which also reports the progress.
+     */
+    void exportPages(const std::vector<size_t>& pages, bool progressiveMode);
 
     /**
      * @brief Select layers to export by parsing str
@@ -77,4 +118,10 @@ private:
     std::string lastError;
 
     std::unique_ptr<LayerRangeVector> layerRange;
+
+    /**
+     * Recording of the rendering of the pdf page pdfBackgroundPageNo, painted on the last written page
+     */
+    xoj::util::CairoSurfaceSPtr pdfBackground;
+    size_t pdfBackgroundPageNo = npos;
 };
@@ -0,0 +1,23 @@
+#include "XojPdfLinkMap.h"
+
+#include <utility>  // for move
+
+#include "util/Range.h"  // for Range
+
+XojPdfLinkMap::XojPdfLinkMap(std::vector<XojPdfPage::Link> links): links(std::move(links)) {
+    for (size_t i = 0; i < this->links.size(); i++) {
+        const XojPdfRectangle& r = this->links[i].bounds;
+        this->index.insert(i, Range(r.x1, r.y1, r.x2, r.y2));
+    }
+}
+
+auto XojPdfLinkMap::findLink(double x, double y) const -> const XojPdfPage::Link* {
+    const XojPdfPage::Link* res = nullptr;
+    for (size_t i: this->index.query(Range(x, y))) {
+        const XojPdfRectangle& r = this->links[i].bounds;
+        if (r.x1 <= x && x <= r.x2 && r.y1 <= y && y <= r.y2 && (!res || &this->links[i] < res)) {
+            res = &this->links[i];
+        }
+    }
+    return res;
+}
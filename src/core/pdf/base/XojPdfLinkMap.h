@@ -0,0 +1,49 @@
+/*
+ * Xournal++
+ *
+ * The links of a pdf page, indexed by their position
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
+#include <vector>   // for vector
+
+#include "util/SpatialGrid.h"  // for SpatialGrid
+
+#include "XojPdfPage.h"  // for XojPdfPage::Link
+
+/**
+ * @brief The links of a pdf page, as returned once by the pdf library, so that finding the link under a point (on
+ * each click or pointer motion) looks at the few links near that point instead of asking the library for every link
+ * of the page again. Pages such as the index of a book have thousands of links.
+ *
+ * Immutable once built: it may be used from any thread.
+ */
+class XojPdfLinkMap {
+public:
+    explicit XojPdfLinkMap(std::vector<XojPdfPage::Link> links);
+
+    /**
+     * @return The link under the point, nullptr if there is none. If links overlap, the first one of the page.
+     */
+    const XojPdfPage::Link* findLink(double x, double y) const;
+
+    const std::vector<XojPdfPage::Link>& getLinks() const { return links; }
+
+    /// Size of the cells of the index, in pdf points: about a line of text
+    static constexpr double CELL_SIZE = 16.0;
+
+private:
+    std::vector<XojPdfPage::Link> links;
+    /// On the indices in `links`
+    xoj::util::SpatialGrid<size_t> index{CELL_SIZE};
+};
+
+using XojPdfLinkMapSPtr = std::shared_ptr<const XojPdfLinkMap>;
@@ -24,6 +24,7 @@
 #include "XojPdfAction.h"
 
 class XojPdfLink;
+class XojPdfLinkMap;
 
 /// Determines how text is selected on a user action.
 enum class XojPdfPageSelectionStyle : uint8_t {
@@ -77,6 +78,9 @@ public:
 
     virtual std::vector<XojPdfRectangle> findText(const std::string& text) = 0;
 
+    /// @return The text of the whole page, in reading order
+    virtual std::string getText() = 0;
+
     /// Retrieve the text contained in the provided rectangle using the given
     /// selection style.
     /// @param rect start and end points
@@ -103,6 +107,11 @@ public:
      */
     virtual auto getLinks() -> std::vector<Link> = 0;
 
+    /**
+     * @return The links of the page, indexed by position. Asks the pdf library for them only the first time.
+     */
+    virtual auto getLinkMap() -> std::shared_ptr<const XojPdfLinkMap> = 0;
+
     virtual int getPageId() const = 0;
 
 private:
@@ -0,0 +1,27 @@
+#include "XojPdfPageCache.h"
+
+auto XojPdfPageCache::get(size_t pdfPage, const std::function<XojPdfPageSPtr()>& create) -> XojPdfPageSPtr {
+    std::lock_guard lock(this->mutex);
+    if (auto it = this->index.find(pdfPage); it != this->index.end()) {
+        this->pages.splice(this->pages.begin(), this->pages, it->second);
+        return it->second->second;
+    }
+
+    // Created under the lock, so that two callers do not create the same page
+    XojPdfPageSPtr page = create();
+    this->pages.emplace_front(pdfPage, page);
+    this->index[pdfPage] = this->pages.begin();
+
+    if (this->pages.size() > MAX_PAGES) {
+        // The callers still holding the page keep it alive
+        this->index.erase(this->pages.back().first);
+        this->pages.pop_back();
+    }
+    return page;
+}
+
+void XojPdfPageCache::clear() {
+    std::lock_guard lock(this->mutex);
+    this->index.clear();
+    this->pages.clear();
+}
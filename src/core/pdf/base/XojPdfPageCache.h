@@ -0,0 +1,47 @@
+/*
+ * Xournal++
+ *
+ * Keeps the latest pages of a pdf document alive
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <functional>     // for function
+#include <list>           // for list
+#include <mutex>          // for mutex
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+
+#include "XojPdfPage.h"  // for XojPdfPageSPtr
+
+/**
+ * @brief The page objects of a pdf document most recently asked for, shared by all the callers (the pdf cache, the
+ * search, the text selection, the exports...), so that the pdf library does not parse a page again for each of them.
+ *
+ * Shared by the copies of a document. At most MAX_PAGES pages are kept, the least recently used ones are dropped. The
+ * methods may be called from any thread.
+ */
+class XojPdfPageCache {
+public:
+    /**
+     * @return The page, created with `create` if it is not in the cache
+     */
+    XojPdfPageSPtr get(size_t pdfPage, const std::function<XojPdfPageSPtr()>& create);
+
+    void clear();
+
+    /// Number of pages kept
+    static constexpr size_t MAX_PAGES = 32;
+
+private:
+    std::mutex mutex;
+    /// Most recently used first
+    std::list<std::pair<size_t, XojPdfPageSPtr>> pages;
+    std::unordered_map<size_t, std::list<std::pair<size_t, XojPdfPageSPtr>>::iterator> index;
+};
@@ -0,0 +1,84 @@
+#include "XojPdfTextCache.h"
+
+#include <algorithm>  // for find_if, remove_if
+#include <utility>    // for move
+
+auto XojPdfTextCache::getTextLayout(size_t pdfPage) -> TextLayoutSPtr {
+    std::lock_guard lock(this->mutex);
+    auto it = this->data.find(pdfPage);
+    if (it == this->data.end() || !it->second.layout) {
+        return nullptr;
+    }
+    it->second.lastUse = ++this->useCounter;
+    return it->second.layout;
+}
+
+void XojPdfTextCache::setTextLayout(size_t pdfPage, TextLayoutSPtr layout) {
+    std::lock_guard lock(this->mutex);
+    Entry& e = use(pdfPage);
+    e.layout = std::move(layout);
+    resize(pdfPage, e);
+}
+
+auto XojPdfTextCache::getSearchResults(size_t pdfPage, const std::string& text)
+        -> std::optional<std::vector<XojPdfRectangle>> {
+    std::lock_guard lock(this->mutex);
+    auto it = this->data.find(pdfPage);
+    if (it == this->data.end()) {
+        return std::nullopt;
+    }
+    auto& searches = it->second.searches;
+    auto search = std::find_if(searches.begin(), searches.end(), [&](const auto& s) { return s.first == text; });
+    if (search == searches.end()) {
+        return std::nullopt;
+    }
+    it->second.lastUse = ++this->useCounter;
+    return search->second;
+}
+
+void XojPdfTextCache::setSearchResults(size_t pdfPage, const std::string& text, std::vector<XojPdfRectangle> results) {
+    std::lock_guard lock(this->mutex);
+    Entry& e = use(pdfPage);
+    auto& searches = e.searches;
+    searches.erase(std::remove_if(searches.begin(), searches.end(), [&](const auto& s) { return s.first == text; }),
+                   searches.end());
+    searches.emplace(searches.begin(), text, std::move(results));
+    if (searches.size() > MAX_SEARCHES) {
+        searches.resize(MAX_SEARCHES);
+    }
+    resize(pdfPage, e);
+}
+
+auto XojPdfTextCache::use(size_t pdfPage) -> Entry& {
+    Entry& e = this->data[pdfPage];
+    e.lastUse = ++this->useCounter;
+    return e;
+}
+
+void XojPdfTextCache::resize(size_t pdfPage, Entry& keep) {
+    const size_t size = byteSize(keep);
+    this->usedMemory = this->usedMemory - keep.byteSize + size;
+    keep.byteSize = size;
+
+    while (this->usedMemory > MAX_MEMORY && this->data.size() > 1) {
+        auto oldest = this->data.end();
+        for (auto it = this->data.begin(); it != this->data.end(); ++it) {
+            if (it->first != pdfPage && (oldest == this->data.end() || it->second.lastUse < oldest->second.lastUse)) {
+                oldest = it;
+            }
+        }
+        this->usedMemory -= oldest->second.byteSize;
+        this->data.erase(oldest);
+    }
+}
+
+auto XojPdfTextCache::byteSize(const Entry& e) -> size_t {
+    size_t size = sizeof(Entry);
+    if (e.layout) {
+        size += e.layout->text.size() + e.layout->glyphs.size() * sizeof(XojPdfRectangle);
+    }
+    for (const auto& [text, results]: e.searches) {
+        size += text.size() + results.size() * sizeof(XojPdfRectangle);
+    }
+    return size;
+}
@@ -0,0 +1,84 @@
+/*
+ * Xournal++
+ *
+ * Caches the text layout of the pdf pages, for the search and the text selection
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <memory>         // for shared_ptr
+#include <mutex>          // for mutex
+#include <optional>       // for optional
+#include <string>         // for string
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
+
+#include "XojPdfPage.h"  // for XojPdfRectangle
+
+/**
+ * @brief The text and glyph rectangles of the pages of a pdf document, and the matches of the latest searches on them,
+ * so that searching or selecting text again on a page does not ask the pdf library to extract it again.
+ *
+ * Shared by all the XojPdfPage%s of a document. The least recently used pages are dropped above MAX_MEMORY bytes. The
+ * methods may be called from any thread: the text is extracted by the callers, without holding the lock.
+ */
+class XojPdfTextCache {
+public:
+    struct TextLayout {
+        std::string text;
+        /// The bounding box of every character of the text, in the coordinates of the pdf library
+        std::vector<XojPdfRectangle> glyphs;
+    };
+    using TextLayoutSPtr = std::shared_ptr<const TextLayout>;
+
+    /**
+     * @return The text layout of the pdf page, or nullptr if it is not in the cache
+     */
+    TextLayoutSPtr getTextLayout(size_t pdfPage);
+    void setTextLayout(size_t pdfPage, TextLayoutSPtr layout);
+
+    /**
+     * @return The matches of the text on the pdf page, if they are in the cache
+     */
+    std::optional<std::vector<XojPdfRectangle>> getSearchResults(size_t pdfPage, const std::string& text);
+    void setSearchResults(size_t pdfPage, const std::string& text, std::vector<XojPdfRectangle> results);
+
+    /// Memory budget of the cache, in bytes
+    static constexpr size_t MAX_MEMORY = 32 * 1024 * 1024;
+    /// Number of searches kept for each page
+    static constexpr size_t MAX_SEARCHES = 4;
+
+private:
+    struct Entry {
+        TextLayoutSPtr layout;
+        /// Latest search first
+        std::vector<std::pair<std::string, std::vector<XojPdfRectangle>>> searches;
+        size_t byteSize = 0;
+        uint64_t lastUse = 0;
+    };
+
+    /**
+     * @return The entry of the page, created if need be, marked as just used
+     */
+    Entry& use(size_t pdfPage);
+
+    /**
+     * Update the byte size of the entry, and drop the least recently used entries (but `keep`) above the budget
+     */
+    void resize(size_t pdfPage, Entry& keep);
+
+    static size_t byteSize(const Entry& e);
+
+    std::mutex mutex;
+    std::unordered_map<size_t, Entry> data;
+    size_t usedMemory = 0;
+    uint64_t useCounter = 0;
+};
@@ -2,9 +2,10 @@
 
 #include <algorithm>  // for min
 #include <cstddef>    // for size_t
+#include <mutex>      // for call_once
 
 #include <glib.h>              // for g_warning, gchar
-#include <poppler-action.h>    // for poppler_dest_free, PopplerActi...
+#include <poppler-action.h>    // for poppler_action_copy, poppler_dest_free
 #include <poppler-document.h>  // for poppler_document_find_dest
 #include <poppler-page.h>      // for poppler_page_get_size
 
@@ -15,15 +16,17 @@
 using std::string;
 
 PopplerGlibAction::PopplerGlibAction(PopplerAction* action, PopplerDocument* document):
-        document(document, xoj::util::ref) {
+        document(document, xoj::util::ref), action(poppler_action_copy(action)) {
     if (gchar* title_cstr = reinterpret_cast<PopplerActionAny*>(action)->title) {
         title = std::string{title_cstr};
     }
-
-    destination = getDestination(action);
 }
 
-PopplerGlibAction::~PopplerGlibAction() = default;
+PopplerGlibAction::~PopplerGlibAction() {
+    if (action) {
+        poppler_action_free(action);
+    }
+}
 
 auto PopplerGlibAction::getDestination(PopplerAction* action) -> std::shared_ptr<const LinkDestination> {
     auto dest = std::make_shared<LinkDestination>();
@@ -47,7 +50,14 @@ auto PopplerGlibAction::getDestination(PopplerAction* action) -> std::shared_ptr
     return dest;
 }
 
-auto PopplerGlibAction::getDestination() -> std::shared_ptr<const LinkDestination> { return destination; }
+auto PopplerGlibAction::getDestination() -> std::shared_ptr<const LinkDestination> {
+    std::call_once(destinationResolved, [this]() {
+        destination = getDestination(action);
+        poppler_action_free(action);
+        action = nullptr;
+    });
+    return destination;
+}
 
 void PopplerGlibAction::linkFromDest(LinkDestination& link, PopplerDest* pDest) {
     switch (pDest->type) {
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <memory>  // for shared_ptr
+#include <mutex>   // for once_flag
 #include <string>  // for string
 
 #include <poppler.h>  // for PopplerAction, PopplerDocument
@@ -27,7 +28,14 @@ public:
     PopplerGlibAction(PopplerAction* action, PopplerDocument* document);
     ~PopplerGlibAction() override;
 
+    PopplerGlibAction(const PopplerGlibAction&) = delete;
+    PopplerGlibAction& operator=(const PopplerGlibAction&) = delete;
+
 public:
+    /**
+     * The destination is resolved on the first call (it may have to look up a named destination, and load the
+     * target page): the outline and the pages have many actions, of which few are ever followed.
+     */
     virtual std::shared_ptr<const LinkDestination> getDestination() override;
     virtual std::string getTitle() override;
 
@@ -37,6 +45,9 @@ private:
 
 private:
     xoj::util::raii::GObjectSPtr<PopplerDocument> document;
+    /// A copy, owned, until the destination is resolved
+    PopplerAction* action;
     std::shared_ptr<const LinkDestination> destination;
+    std::once_flag destinationResolved;
     std::string title;
 };
@@ -7,6 +7,7 @@
 
 #include "util/PathUtil.h"  // for toUri
 
+#include "PopplerGlibDocumentPool.h"          // for PopplerGlibDocumentPool
 #include "PopplerGlibPage.h"                  // for PopplerGlibPage
 #include "PopplerGlibPageBookmarkIterator.h"  // for PopplerGlibPageBookmark...
 #include "filesystem.h"                       // for path
@@ -17,7 +18,8 @@ using std::string;
 
 PopplerGlibDocument::PopplerGlibDocument() = default;
 
-PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document) {
+PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc):
+        document(doc.document), textCache(doc.textCache), pageCache(doc.pageCache), renderPool(doc.renderPool) {
     if (document) {
         g_object_ref(document);
     }
@@ -39,6 +41,9 @@ void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
     if (document) {
         g_object_ref(document);
     }
+    textCache = (dynamic_cast<PopplerGlibDocument*>(doc))->textCache;
+    pageCache = (dynamic_cast<PopplerGlibDocument*>(doc))->pageCache;
+    renderPool = (dynamic_cast<PopplerGlibDocument*>(doc))->renderPool;
 }
 
 auto PopplerGlibDocument::equals(XojPdfDocumentInterface* doc) const -> bool {
@@ -69,6 +74,11 @@ auto PopplerGlibDocument::load(fs::path const& file, string password, GError** e
     }
 
     this->document = poppler_document_new_from_file(uri->c_str(), password.c_str(), error);
+    this->textCache = std::make_shared<XojPdfTextCache>();
+    this->pageCache = std::make_shared<XojPdfPageCache>();
+    this->renderPool = this->document ?
+                               std::make_shared<PopplerGlibDocumentPool>(this->document, nullptr, file, password) :
+                               nullptr;
     return this->document != nullptr;
 }
 
@@ -81,7 +91,12 @@ auto PopplerGlibDocument::load(std::unique_ptr<std::string> data, string passwor
             data->data(), data->size(), [](gpointer d) { delete reinterpret_cast<std::string*>(d); }, data.get());
     data.release();  // the string will be deleted with the bytes object
     this->document = poppler_document_new_from_bytes(bytes, password.c_str(), error);
-    g_bytes_unref(bytes);  // a reference is now held by the document
+    this->renderPool = this->document ?
+                               std::make_shared<PopplerGlibDocumentPool>(this->document, bytes, fs::path(), password) :
+                               nullptr;
+    g_bytes_unref(bytes);  // a reference is now held by the document (and the pool)
+    this->textCache = std::make_shared<XojPdfTextCache>();
+    this->pageCache = std::make_shared<XojPdfPageCache>();
 
     return this->document != nullptr;
 }
@@ -93,6 +108,9 @@ void PopplerGlibDocument::reset() {
         g_object_unref(document);
         document = nullptr;
     }
+    textCache.reset();
+    pageCache.reset();
+    renderPool.reset();
 }
 
 auto PopplerGlibDocument::getPage(size_t page) const -> XojPdfPageSPtr {
@@ -100,11 +118,12 @@ auto PopplerGlibDocument::getPage(size_t page) const -> XojPdfPageSPtr {
         return nullptr;
     }
 
-    PopplerPage* pg = poppler_document_get_page(document, int(page));
-    XojPdfPageSPtr pageptr = std::make_shared<PopplerGlibPage>(pg, document);
-    g_object_unref(pg);
-
-    return pageptr;
+    return pageCache->get(page, [&]() -> XojPdfPageSPtr {
+        PopplerPage* pg = poppler_document_get_page(document, int(page));
+        XojPdfPageSPtr pageptr = std::make_shared<PopplerGlibPage>(pg, document, textCache, renderPool);
+        g_object_unref(pg);
+        return pageptr;
+    });
 }
 
 auto PopplerGlibDocument::getPageCount() const -> size_t {
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <cstddef>  // for size_t
+#include <memory>   // for shared_ptr
 #include <string>   // for string
 
 #include <glib.h>     // for GError, gpointer, gsize
@@ -19,9 +20,12 @@
 
 #include "pdf/base/XojPdfDocumentInterface.h"  // for XojPdfDocumentInterface
 #include "pdf/base/XojPdfPage.h"               // for XojPdfPageSPtr
+#include "pdf/base/XojPdfPageCache.h"          // for XojPdfPageCache
+#include "pdf/base/XojPdfTextCache.h"          // for XojPdfTextCache
 
 #include "filesystem.h"  // for path
 
+class PopplerGlibDocumentPool;
 class XojPdfBookmarkIterator;
 
 class PopplerGlibDocument: public XojPdfDocumentInterface {
@@ -47,4 +51,13 @@ public:
 
 private:
     PopplerDocument* document = nullptr;
+
+    /// Shared by the pages of the document, and by the copies of this instance
+    std::shared_ptr<XojPdfTextCache> textCache;
+
+    /// The latest pages, shared by the copies of this instance
+    std::shared_ptr<XojPdfPageCache> pageCache;
+
+    /// The instances the pages are rendered with, shared by the pages and the copies of this instance
+    std::shared_ptr<PopplerGlibDocumentPool> renderPool;
 };
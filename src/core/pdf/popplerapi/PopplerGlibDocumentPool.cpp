@@ -0,0 +1,127 @@
+#include "PopplerGlibDocumentPool.h"
+
+#include <algorithm>  // for clamp
+#include <thread>     // for thread
+#include <utility>    // for move
+
+#include <poppler-document.h>  // for poppler_document_new_from_bytes
+#include <poppler-page.h>      // for poppler_page_render
+
+#include "util/PathUtil.h"  // for toGFilename
+
+PopplerGlibDocumentPool::PopplerGlibDocumentPool(PopplerDocument* document, GBytes* bytes, fs::path file,
+                                                 std::string password):
+        file(std::move(file)),
+        password(std::move(password)),
+        pageCount(poppler_document_get_n_pages(document)),
+        bytes(bytes ? g_bytes_ref(bytes) : nullptr),
+        maxInstances(getMaxInstanceCount()) {
+    g_object_ref(document);
+    this->instances.push_back({document, false});
+}
+
+PopplerGlibDocumentPool::~PopplerGlibDocumentPool() {
+    for (auto& instance: this->instances) {
+        if (instance.document) {
+            g_object_unref(instance.document);
+        }
+    }
+    if (this->bytes) {
+        g_bytes_unref(this->bytes);
+    }
+}
+
+auto PopplerGlibDocumentPool::getMaxInstanceCount() -> size_t {
+    // As many as the render workers can use
+    return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+}
+
+void PopplerGlibDocumentPool::render(PopplerPage* page, cairo_t* cr, bool forPrinting) {
+    auto renderPage = [&](PopplerPage* p) {
+        if (forPrinting) {
+            poppler_page_render_for_printing(p, cr);
+        } else {
+            poppler_page_render(p, cr);
+        }
+    };
+
+    const auto [index, document] = acquire();
+    if (index == 0) {
+        renderPage(page);
+    } else if (PopplerPage* other = poppler_document_get_page(document, poppler_page_get_index(page))) {
+        renderPage(other);
+        g_object_unref(other);
+    }
+    release(index);
+}
+
+auto PopplerGlibDocumentPool::acquire() -> Lease {
+    std::unique_lock lock(this->mutex);
+    for (;;) {
+        for (size_t i = 0; i < this->instances.size(); i++) {
+            if (auto& instance = this->instances[i]; instance.document && !instance.busy) {
+                instance.busy = true;
+                return {i, instance.document};
+            }
+        }
+        if (this->instances.size() < this->maxInstances) {
+            // All the instances are busy: open another one
+            const size_t index = this->instances.size();
+            this->instances.push_back({nullptr, true});
+            lock.unlock();
+            PopplerDocument* document = open();
+            lock.lock();
+            if (document) {
+                this->instances[index].document = document;
+                return {index, document};
+            }
+            // The slot stays empty, and no more instances are opened
+            this->instances[index].busy = false;
+            this->maxInstances = this->instances.size();
+        }
+        this->instanceReleased.wait(lock);
+    }
+}
+
+void PopplerGlibDocumentPool::release(size_t index) {
+    {
+        std::lock_guard lock(this->mutex);
+        this->instances[index].busy = false;
+    }
+    this->instanceReleased.notify_one();
+}
+
+auto PopplerGlibDocumentPool::open() -> PopplerDocument* {
+    GBytes* content = nullptr;
+    {
+        std::lock_guard lock(this->mutex);
+        if (!this->bytes) {
+            // Mapped once, for all the instances
+            GError* error = nullptr;
+            GMappedFile* mapped = g_mapped_file_new(Util::toGFilename(this->file).c_str(), false, &error);
+            if (!mapped) {
+                g_warning("Could not map the PDF file to render it in parallel: %s", error->message);
+                g_error_free(error);
+                return nullptr;
+            }
+            this->bytes = g_mapped_file_get_bytes(mapped);
+            g_mapped_file_unref(mapped);  // a reference is now held by the bytes object
+        }
+        content = g_bytes_ref(this->bytes);
+    }
+
+    GError* error = nullptr;
+    PopplerDocument* document = poppler_document_new_from_bytes(content, this->password.c_str(), &error);
+    g_bytes_unref(content);
+    if (!document) {
+        g_warning("Could not open another instance of the PDF document: %s", error->message);
+        g_error_free(error);
+        return nullptr;
+    }
+    if (poppler_document_get_n_pages(document) != this->pageCount) {
+        // The file changed since the document was loaded
+        g_object_unref(document);
+        return nullptr;
+    }
+    return document;
+}
@@ -0,0 +1,87 @@
+/*
+ * Xournal++
+ *
+ * Independent poppler instances of a PDF document, to render it in parallel
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <vector>              // for vector
+
+#include <cairo.h>    // for cairo_t
+#include <glib.h>     // for GBytes
+#include <poppler.h>  // for PopplerDocument, PopplerPage
+
+#include "filesystem.h"  // for path
+
+/**
+ * poppler does not render the pages of a PopplerDocument concurrently: its parser (XRef) and its caches are shared by
+ * all of them. The pool opens other instances of the same document, as render threads compete for the first one,
+ * each rendering with a single thread at a time. The instances are opened from the same bytes: those the document was
+ * loaded from, or the file mapped in memory.
+ *
+ * The first instance is the document the pages come from, which is also used without the pool (for the text, the
+ * links...).
+ */
+class PopplerGlibDocumentPool {
+public:
+    /**
+     * @param bytes The content of the document if it was loaded from memory, nullptr if it was loaded from file
+     */
+    PopplerGlibDocumentPool(PopplerDocument* document, GBytes* bytes, fs::path file, std::string password);
+    ~PopplerGlibDocumentPool();
+
+    PopplerGlibDocumentPool(const PopplerGlibDocumentPool&) = delete;
+    PopplerGlibDocumentPool& operator=(const PopplerGlibDocumentPool&) = delete;
+
+    /**
+     * @brief Render the page (from the first instance) with an instance no other thread is rendering with, waiting for
+     *      one if needed
+     */
+    void render(PopplerPage* page, cairo_t* cr, bool forPrinting);
+
+    /// The most instances opened, including the first one
+    static size_t getMaxInstanceCount();
+
+private:
+    struct Lease {
+        size_t index;
+        PopplerDocument* document;
+    };
+
+    /**
+     * @return An instance, now used by this thread. Opens a new instance if all are busy.
+     */
+    Lease acquire();
+    void release(size_t index);
+
+    /// Open another instance. Called without the mutex.
+    PopplerDocument* open();
+
+    fs::path file;
+    std::string password;
+    /// Of the first instance, that the others must have too
+    int pageCount;
+
+    std::mutex mutex;
+    std::condition_variable instanceReleased;
+
+    /// Guarded by the mutex, as the members below
+    GBytes* bytes = nullptr;
+    struct Instance {
+        PopplerDocument* document = nullptr;
+        bool busy = false;
+    };
+    std::vector<Instance> instances;
+    /// The instances being opened count as busy instances
+    size_t maxInstances;
+};
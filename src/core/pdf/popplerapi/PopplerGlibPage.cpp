@@ -2,30 +2,38 @@
 
 #include <algorithm>  // for max, min
 #include <cstdlib>    // for abs, NULL, ptrdiff_t
-#include <memory>     // for make_unique
+#include <memory>     // for make_unique, make_shared
+#include <mutex>      // for lock_guard
 #include <sstream>    // for operator<<, ostringstream, bas...
+#include <utility>    // for move
 
 #include <glib.h>          // for g_free, g_utf8_offset_to_pointer
 #include <poppler-page.h>  // for _PopplerRectangle, _PopplerLin...
 #include <poppler.h>       // for PopplerRectangle, g_object_ref
 
 #include "pdf/base/XojPdfAction.h"     // for XojPdfAction
+#include "pdf/base/XojPdfLinkMap.h"    // for XojPdfLinkMap
 #include "pdf/base/XojPdfPage.h"       // for XojPdfRectangle, XojPdfPage::Link
 #include "util/Assert.h"               // for xoj_assert
 #include "util/GListView.h"            // for GListView, GListView<>::GListV...
 #include "util/raii/CLibrariesSPtr.h"  // for adopt
 #include "util/raii/CairoWrappers.h"   // for CairoRegionSPtr
 
-#include "PopplerGlibAction.h"  // for PopplerGlibAction
-#include "cairo.h"              // for cairo_region_create, cairo_reg...
+#include "PopplerGlibAction.h"        // for PopplerGlibAction
+#include "PopplerGlibDocumentPool.h"  // for PopplerGlibDocumentPool
+#include "cairo.h"                    // for cairo_region_create, cairo_reg...
 
-PopplerGlibPage::PopplerGlibPage(PopplerPage* page, PopplerDocument* parentDoc): page(page), document(parentDoc) {
+PopplerGlibPage::PopplerGlibPage(PopplerPage* page, PopplerDocument* parentDoc,
+                                 std::shared_ptr<XojPdfTextCache> textCache,
+                                 std::shared_ptr<PopplerGlibDocumentPool> renderPool):
+        page(page), document(parentDoc), textCache(std::move(textCache)), renderPool(std::move(renderPool)) {
     if (page != nullptr) {
         g_object_ref(page);
     }
 }
 
-PopplerGlibPage::PopplerGlibPage(const PopplerGlibPage& other): page(other.page), document(other.document) {
+PopplerGlibPage::PopplerGlibPage(const PopplerGlibPage& other):
+        page(other.page), document(other.document), textCache(other.textCache), renderPool(other.renderPool) {
     if (page != nullptr) {
         g_object_ref(page);
     }
@@ -55,6 +63,8 @@ PopplerGlibPage& PopplerGlibPage::operator=(const PopplerGlibPage& other) {
     }
 
     document = other.document;
+    textCache = other.textCache;
+    renderPool = other.renderPool;
 
     return *this;
 }
@@ -77,15 +87,77 @@ void PopplerGlibPage::render(cairo_t* cr) const {
     cairo_save(cr);
     cairo_set_source_rgb(cr, 1., 1., 1.);
     cairo_paint(cr);
-    poppler_page_render(page, cr);
+    if (renderPool) {
+        renderPool->render(page, cr, false);
+    } else {
+        poppler_page_render(page, cr);
+    }
     cairo_restore(cr);
 }
 
-void PopplerGlibPage::renderForPrinting(cairo_t* cr) const { poppler_page_render_for_printing(page, cr); }
+void PopplerGlibPage::renderForPrinting(cairo_t* cr) const {
+    if (renderPool) {
+        renderPool->render(page, cr, true);
+    } else {
+        poppler_page_render_for_printing(page, cr);
+    }
+}
 
 auto PopplerGlibPage::getPageId() const -> int { return poppler_page_get_index(page); }
 
+auto PopplerGlibPage::getTextLayout() -> XojPdfTextCache::TextLayoutSPtr {
+    const auto pageNo = static_cast<size_t>(getPageId());
+    if (textCache) {
+        if (auto layout = textCache->getTextLayout(pageNo)) {
+            return layout;
+        }
+    }
+
+    auto layout = std::make_shared<XojPdfTextCache::TextLayout>();
+    if (char* text = poppler_page_get_text(page)) {
+        layout->text = text;
+        g_free(text);
+    }
+    PopplerRectangle* rectArray = nullptr;
+    guint numRects = 0;
+    if (poppler_page_get_text_layout(page, &rectArray, &numRects)) {
+        layout->glyphs.reserve(numRects);
+        for (guint i = 0; i < numRects; i++) {
+            layout->glyphs.emplace_back(rectArray[i].x1, rectArray[i].y1, rectArray[i].x2, rectArray[i].y2);
+        }
+        g_free(rectArray);
+    }
+
+    if (textCache) {
+        textCache->setTextLayout(pageNo, layout);
+    }
+    return layout;
+}
+
+auto PopplerGlibPage::getText() -> std::string {
+    if (textCache) {
+        if (auto layout = textCache->getTextLayout(static_cast<size_t>(getPageId()))) {
+            return layout->text;
+        }
+    }
+    // Not worth caching the layout if only the text is needed
+    char* text = poppler_page_get_text(page);
+    if (!text) {
+        return "";
+    }
+    std::string result(text);
+    g_free(text);
+    return result;
+}
+
 auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRectangle> {
+    const auto pageNo = static_cast<size_t>(getPageId());
+    if (textCache) {
+        if (auto findings = textCache->getSearchResults(pageNo, text)) {
+            return std::move(*findings);
+        }
+    }
+
     std::vector<XojPdfRectangle> findings;
 
     double height = getHeight();
@@ -96,6 +168,9 @@ auto PopplerGlibPage::findText(const std::string& text) -> std::vector<XojPdfRec
     }
     g_list_free(matches);
 
+    if (textCache) {
+        textCache->setSearchResults(pageNo, text, findings);
+    }
     return findings;
 }
 
@@ -192,18 +267,28 @@ auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfP
     PopplerRectangle rect{std::min(selectRect.x1, selectRect.x2), std::min(selectRect.y1, selectRect.y2),
                           std::max(selectRect.x1, selectRect.x2), std::max(selectRect.y1, selectRect.y2)};
 
-    PopplerRectangle* rectArray = nullptr;
-    guint numRects = 0;
+    // The glyphs of the whole page are the same for every selection: they come from the cache
+    XojPdfTextCache::TextLayoutSPtr layout;
+    std::vector<XojPdfRectangle> areaGlyphs;
     if (style == XojPdfPageSelectionStyle::Area) {
         // We always want to select in the "proper" rectangle.
         PopplerRectangle area{rect.x1, rect.y1, rect.x2, rect.y2};
-        if (!poppler_page_get_text_layout_for_area(this->page, &area, &rectArray, &numRects)) {
-            return {xoj::util::CairoRegionSPtr(cairo_region_create(), xoj::util::adopt), textRects};
+        PopplerRectangle* rectArray = nullptr;
+        guint numRects = 0;
+        if (poppler_page_get_text_layout_for_area(this->page, &area, &rectArray, &numRects)) {
+            areaGlyphs.reserve(numRects);
+            for (guint i = 0; i < numRects; i++) {
+                areaGlyphs.emplace_back(rectArray[i].x1, rectArray[i].y1, rectArray[i].x2, rectArray[i].y2);
+            }
+            g_free(rectArray);
         }
     } else {
-        if (!poppler_page_get_text_layout(this->page, &rectArray, &numRects)) {
-            return {xoj::util::CairoRegionSPtr(cairo_region_create(), xoj::util::adopt), textRects};
-        }
+        layout = getTextLayout();
+    }
+    const std::vector<XojPdfRectangle>& rectArray = layout ? layout->glyphs : areaGlyphs;
+    const size_t numRects = rectArray.size();
+    if (numRects == 0) {
+        return {xoj::util::CairoRegionSPtr(cairo_region_create(), xoj::util::adopt), textRects};
     }
 
     // construct the region later for area selection, but use poppler's region
@@ -219,10 +304,10 @@ auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfP
         return std::abs(r1.y1 - r2.y1) < eps && std::abs(r1.y2 - r2.y2) < eps;
     };
 
-    PopplerRectangle prevRect = rectArray[0];
+    XojPdfRectangle prevRect = rectArray[0];
     if (style == XojPdfPageSelectionStyle::Area) {
         // helper to add only those rectangles that have nonempty intersection with the selected area
-        const auto addTextRectsInArea = [&](const PopplerRectangle& r) {
+        const auto addTextRectsInArea = [&](const XojPdfRectangle& r) {
             auto x1 = std::max(rect.x1, r.x1);
             auto y1 = std::max(rect.y1, r.y1);
             auto x2 = std::min(rect.x2, r.x2);
@@ -235,8 +320,8 @@ auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfP
         };
 
         // construct the text rectangles
-        for (guint i = 1; i < numRects; i++) {
-            PopplerRectangle nextRect = rectArray[i];
+        for (size_t i = 1; i < numRects; i++) {
+            const XojPdfRectangle& nextRect = rectArray[i];
             if (isSameLine(prevRect, nextRect)) {
                 // Merge if both prev & next rectangles are in bounds. Note that
                 // only x is checked since rectArray was constructed for the
@@ -268,7 +353,7 @@ auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfP
         // this is for all other styles (e.g., linear)
 
         // helper to add only those rectangles that are contained in the selection region
-        const auto addTextRectsInRegion = [&](const PopplerRectangle& r) {
+        const auto addTextRectsInRegion = [&](const XojPdfRectangle& r) {
             auto crect = cairoRectFromDouble(r.x1, r.y1, r.x2 - r.x1, r.y2 - r.y1);
             if (cairo_region_contains_rectangle(region, &crect) == CAIRO_REGION_OVERLAP_IN) {
                 textRects.emplace_back(r.x1, r.y1, r.x2, r.y2);
@@ -276,8 +361,8 @@ auto PopplerGlibPage::selectTextLines(const XojPdfRectangle& selectRect, XojPdfP
         };
 
         // construct the text rectangles
-        for (guint i = 1; i < numRects; i++) {
-            PopplerRectangle nextRect = rectArray[i];
+        for (size_t i = 1; i < numRects; i++) {
+            const XojPdfRectangle& nextRect = rectArray[i];
             if (isSameLine(prevRect, nextRect)) {
                 // merge the rectangles if they, when combined, are contained in the selection region
                 auto x1 = std::min(prevRect.x1, nextRect.x2);
@@ -316,3 +401,11 @@ auto PopplerGlibPage::getLinks() -> std::vector<Link> {
 
     return results;
 }
+
+auto PopplerGlibPage::getLinkMap() -> XojPdfLinkMapSPtr {
+    std::lock_guard lock(this->linkMapMutex);
+    if (!this->linkMap) {
+        this->linkMap = std::make_shared<const XojPdfLinkMap>(getLinks());
+    }
+    return this->linkMap;
+}
@@ -11,18 +11,28 @@
 
 #pragma once
 
+#include <memory>  // for shared_ptr
+#include <mutex>   // for mutex
 #include <string>  // for string
 #include <vector>  // for vector
 
 #include <cairo.h>    // for cairo_t, cairo_region_t
 #include <poppler.h>  // for PopplerPage
 
-#include "pdf/base/XojPdfPage.h"  // for XojPdfRectangle (ptr only), XojPdfP...
+#include "pdf/base/XojPdfLinkMap.h"    // for XojPdfLinkMapSPtr
+#include "pdf/base/XojPdfPage.h"       // for XojPdfRectangle (ptr only), XojPdfP...
+#include "pdf/base/XojPdfTextCache.h"  // for XojPdfTextCache
 
+class PopplerGlibDocumentPool;
 
 class PopplerGlibPage: public XojPdfPage {
 public:
-    PopplerGlibPage(PopplerPage* page, PopplerDocument* doc);
+    /**
+     * @param textCache If set, the text layout and the search results of the page are kept in this cache
+     * @param renderPool If set, the page is rendered with an instance of the document from this pool
+     */
+    PopplerGlibPage(PopplerPage* page, PopplerDocument* doc, std::shared_ptr<XojPdfTextCache> textCache = nullptr,
+                    std::shared_ptr<PopplerGlibDocumentPool> renderPool = nullptr);
     PopplerGlibPage(const PopplerGlibPage& other);
     virtual ~PopplerGlibPage();
     PopplerGlibPage& operator=(const PopplerGlibPage& other);
@@ -36,6 +46,8 @@ public:
 
     std::vector<XojPdfRectangle> findText(const std::string& text) override;
 
+    std::string getText() override;
+
     std::string selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
 
     cairo_region_t* selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
@@ -43,10 +55,23 @@ public:
     TextSelection selectTextLines(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
 
     auto getLinks() -> std::vector<Link> override;
+    auto getLinkMap() -> XojPdfLinkMapSPtr override;
 
     int getPageId() const override;
 
+private:
+    /**
+     * @return The text and the glyph rectangles of the page, from the cache if possible
+     */
+    XojPdfTextCache::TextLayoutSPtr getTextLayout();
+
 private:
     PopplerPage* page;
     PopplerDocument* document;
+    std::shared_ptr<XojPdfTextCache> textCache;
+    std::shared_ptr<PopplerGlibDocumentPool> renderPool;
+
+    /// Built on the first call to getLinkMap(), guarded by the mutex
+    XojPdfLinkMapSPtr linkMap;
+    std::mutex linkMapMutex;
 };
@@ -15,7 +15,8 @@
 
 #ifdef ENABLE_PLUGINS
 
-#include <utility>  // for move, pair
+#include <string_view>  // for string_view
+#include <utility>      // for move, pair
 
 #include "gui/toolbarMenubar/ToolMenuHandler.h"  // for ToolMenuHandler
 #include "util/i18n.h"                           // for _
@@ -29,6 +30,7 @@ extern "C" {
 #include <lualib.h>   // for luaL_openlibs
 }
 
+#include "PluginWorker.h"       // for PluginWorker
 #include "luapi_application.h"  // for luaopen_app
 
 /*
@@ -42,6 +44,9 @@ Plugin::Plugin(Control* control, std::string name, fs::path path):
     loadIni();
 }
 
+// Stops a running worker: its results would be applied by a plugin which no longer exists
+Plugin::~Plugin() = default;
+
 auto Plugin::getPluginFromLua(lua_State* lua) -> Plugin* {
     lua_getfield(lua, LUA_REGISTRYINDEX, "Xournalpp_Plugin");
 
@@ -55,7 +60,7 @@ auto Plugin::getPluginFromLua(lua_State* lua) -> Plugin* {
 }
 
 void Plugin::registerToolbar() {
-    if (!this->valid || !this->enabled) {
+    if (!this->valid || !this->enabled || this->lazy) {
         return;
     }
 
@@ -113,10 +118,26 @@ size_t Plugin::populateMenuSection(GtkApplicationWindow* win, size_t startId) {
     return startId;
 }
 
-void Plugin::executeMenuEntry(MenuEntry* entry) { callFunction(entry->callback, entry->mode); }
+void Plugin::executeMenuEntry(MenuEntry* entry) {
+    if (entry->async) {
+        executeAsync(entry->callback, entry->mode);
+    } else if (ensureLoaded()) {
+        callFunction(entry->callback, entry->mode);
+    }
+}
+
+void Plugin::executeAsync(const std::string& callback, ptrdiff_t mode) {
+    if (worker && worker->isRunning()) {
+        XojMsgBox::showPluginMessage(name, _("The plugin is still running"), false);
+        return;
+    }
+    worker = std::make_shared<PluginWorker>(this);
+    worker->start(path / mainfile, callback, mode);
+}
 
-auto Plugin::registerMenu(std::string menu, std::string callback, ptrdiff_t mode, std::string accelerator) -> size_t {
-    menuEntries.emplace_back(this, std::move(menu), std::move(callback), mode, std::move(accelerator));
+auto Plugin::registerMenu(std::string menu, std::string callback, ptrdiff_t mode, std::string accelerator, bool async)
+        -> size_t {
+    menuEntries.emplace_back(this, std::move(menu), std::move(callback), mode, std::move(accelerator), async);
     return menuEntries.size() - 1;
 }
 
@@ -132,16 +153,22 @@ void Plugin::registerToolButton(ToolMenuHandler* toolMenuHandler) {
     }
 }
 
-void Plugin::executeToolbarButton(ToolbarButtonEntry* entry) { callFunction(entry->callback, entry->mode); }
+void Plugin::executeToolbarButton(ToolbarButtonEntry* entry) {
+    if (entry->async) {
+        executeAsync(entry->callback, entry->mode);
+    } else if (ensureLoaded()) {
+        callFunction(entry->callback, entry->mode);
+    }
+}
 
 void Plugin::registerToolButton(std::string description, std::string toolbarId, std::string iconName,
-                                std::string callback, ptrdiff_t mode) {
+                                std::string callback, ptrdiff_t mode, bool async) {
     if (toolbarId == "") {
         return;
     }
     toolbarId = "Plugin::" + toolbarId;  // In order to avoid name collisions with built in toolbar id's.
     toolbarButtonEntries.emplace_back(this, std::move(description), std::move(toolbarId), std::move(iconName),
-                                      std::move(callback), mode);
+                                      std::move(callback), mode, async);
 }
 
 auto Plugin::getControl() const -> Control* { return control; }
@@ -180,11 +207,52 @@ void Plugin::loadIni() {
     defaultEnabled = defaultEnabledStr == "true";
     enabled = defaultEnabled;
 
+    loadUiManifest(config);
+
     g_key_file_free(config);
 
     this->valid = true;
 }
 
+void Plugin::loadUiManifest(GKeyFile* config) {
+    constexpr std::string_view UI_GROUP_PREFIX = "ui.";
+
+    gchar** groups = g_key_file_get_groups(config, nullptr);
+    for (gchar** group = groups; *group; group++) {
+        if (std::string_view(*group).substr(0, UI_GROUP_PREFIX.size()) != UI_GROUP_PREFIX) {
+            continue;
+        }
+
+        auto LOAD_FROM_GROUP = [config, group](char const* key) {
+            std::string target;
+            if (char* value = g_key_file_get_string(config, *group, key, nullptr); value != nullptr) {
+                target = value;
+                g_free(value);
+            }
+            return target;
+        };
+
+        std::string callback = LOAD_FROM_GROUP("callback");
+        if (callback.empty()) {
+            g_warning("Plugin "%s": UI entry [%s] has no callback", name.c_str(), *group);
+            continue;
+        }
+
+        ptrdiff_t mode = std::numeric_limits<ptrdiff_t>::max();
+        if (g_key_file_has_key(config, *group, "mode", nullptr)) {
+            mode = g_key_file_get_integer(config, *group, "mode", nullptr);
+        }
+        bool async = g_key_file_get_boolean(config, *group, "async", nullptr);
+
+        // Same entries as app.registerUi
+        std::string menu = LOAD_FROM_GROUP("menu");
+        registerMenu(menu, callback, mode, LOAD_FROM_GROUP("accelerator"), async);
+        registerToolButton(menu, LOAD_FROM_GROUP("toolbarId"), LOAD_FROM_GROUP("iconName"), callback, mode, async);
+        this->lazy = true;
+    }
+    g_strfreev(groups);
+}
+
 void Plugin::registerXournalppLibs(lua_State* luaPtr) {
     for (auto const& lib: loadedlibs) {
         luaL_requiref(luaPtr, lib.name, lib.func, 1);
@@ -193,30 +261,30 @@ void Plugin::registerXournalppLibs(lua_State* luaPtr) {
     }
 }
 
-void Plugin::addPluginToLuaPath() {
-    lua_getglobal(lua.get(), "package");
+void Plugin::addPathToLua(lua_State* luaPtr, const fs::path& pluginPath) {
+    lua_getglobal(luaPtr, "package");
 
     // get field "path" from table at top of stack (-1)
-    lua_getfield(lua.get(), -1, "path");
+    lua_getfield(luaPtr, -1, "path");
 
     // grab path string from top of stack
-    std::string luaPath = lua_tostring(lua.get(), -1);
+    std::string luaPath = lua_tostring(luaPtr, -1);
 
     // prepend the path of the current plugin
-    auto curPath = this->path / "?.lua";
+    auto curPath = pluginPath / "?.lua";
     std::string combinedPath = curPath.string() + ";" + luaPath;
 
     // get rid of the std::string on the stack we just pushed
-    lua_pop(lua.get(), 1);
+    lua_pop(luaPtr, 1);
 
     // push the new one
-    lua_pushstring(lua.get(), combinedPath.c_str());
+    lua_pushstring(luaPtr, combinedPath.c_str());
 
     // set the field "path" in table at -2 with value at top of stack
-    lua_setfield(lua.get(), -2, "path");
+    lua_setfield(luaPtr, -2, "path");
 
     // get rid of package table from top of stack
-    lua_pop(lua.get(), 1);
+    lua_pop(luaPtr, 1);
 }
 
 void Plugin::loadScript() {
@@ -235,7 +303,22 @@ void Plugin::loadScript() {
         return;
     }
 
+    if (this->lazy) {
+        g_message("Plugin \"%s\" declares its UI, its script is loaded on first use", name.c_str());
+        return;
+    }
+
+    runScript();
+}
+
+auto Plugin::ensureLoaded() -> bool {
+    if (!this->lua && this->valid) {
+        runScript();
+    }
+    return this->valid;
+}
 
+void Plugin::runScript() {
     // Create Lua state variable
     lua.reset(luaL_newstate());
 
@@ -261,7 +344,7 @@ void Plugin::loadScript() {
 
     registerXournalppLibs(lua.get());
 
-    addPluginToLuaPath();
+    addPathToLua(lua.get(), path);
 
     // Run the loaded Lua script
     if (lua_pcall(lua.get(), 0, 0, 0) != LUA_OK) {
@@ -34,17 +34,20 @@ extern "C" {
 }
 
 class Plugin;
+class PluginWorker;
 class Control;
 class ToolMenuHandler;
 
 struct MenuEntry final {
     MenuEntry() = default;
-    MenuEntry(Plugin* plugin, std::string label, std::string callback, ptrdiff_t mode, std::string accelerator):
+    MenuEntry(Plugin* plugin, std::string label, std::string callback, ptrdiff_t mode, std::string accelerator,
+              bool async):
             plugin(plugin),
             label(std::move(label)),
             callback(std::move(callback)),
             mode(mode),
-            accelerator(std::move(accelerator)) {}
+            accelerator(std::move(accelerator)),
+            async(async) {}
 
     Plugin* plugin = nullptr;                               ///< The Plugin
     std::string label{};                                    ///< Menu display name
@@ -55,6 +58,7 @@ struct MenuEntry final {
      *     https://developer.gnome.org/gtk3/stable/gtk3-Keyboard-Accelerators.html#gtk-accelerator-parse
      */
     std::string accelerator{};
+    bool async = false;  ///< The callback runs on a worker thread, see PluginWorker
     /// Action activated when using the menu entry
     xoj::util::GObjectSPtr<GSimpleAction> action;
 };
@@ -62,13 +66,14 @@ struct MenuEntry final {
 struct ToolbarButtonEntry final {
     ToolbarButtonEntry() = default;
     ToolbarButtonEntry(Plugin* plugin, std::string description, std::string toolbarId, std::string iconName,
-                       std::string callback, ptrdiff_t mode):
+                       std::string callback, ptrdiff_t mode, bool async):
             plugin(plugin),
             description(std::move(description)),
             toolbarId(std::move(toolbarId)),
             iconName(std::move(iconName)),
             callback(std::move(callback)),
-            mode(mode) {}
+            mode(mode),
+            async(async) {}
 
     Plugin* plugin = nullptr;
     std::string description{};  ///< description displayed on hovering over the toolbar button
@@ -76,6 +81,7 @@ struct ToolbarButtonEntry final {
     std::string iconName{};     ///< name of the icon which should be stored as iconName + ".svg"
     std::string callback{};     ///< Callback function name
     ptrdiff_t mode{std::numeric_limits<ptrdiff_t>::max()};  ///< mode in which the callback function is run
+    bool async = false;  ///< The callback runs on a worker thread, see PluginWorker
 };
 
 struct LuaDeleter {
@@ -85,9 +91,13 @@ struct LuaDeleter {
 class Plugin final {
 public:
     Plugin(Control* control, std::string name, fs::path path);
+    ~Plugin();
 
 public:
-    /// Load the plugin script
+    /**
+     * Load the plugin script. The script of a plugin declaring its UI in plugin.ini is only loaded when one of its
+     * callbacks is first called, see ensureLoaded()
+     */
     void loadScript();
 
     /// Check if this plugin is valid
@@ -108,7 +118,7 @@ public:
 
     // Register toolbar button
     void registerToolButton(std::string description, std::string toolbarId, std::string iconName, std::string callback,
-                            ptrdiff_t mode);
+                            ptrdiff_t mode, bool async);
     // Register all toolbar buttons
     void registerToolButton(ToolMenuHandler* toolMenuHandler);
 
@@ -146,7 +156,8 @@ public:
 
     /// Register a menu item
     /// @return Internal ID, can e.g. be used to disable the menu
-    auto registerMenu(std::string menu, std::string callback, ptrdiff_t mode, std::string accelerator) -> size_t;
+    auto registerMenu(std::string menu, std::string callback, ptrdiff_t mode, std::string accelerator, bool async)
+            -> size_t;
 
     ///@return The main controller
     auto getControl() const -> Control*;
@@ -155,13 +166,26 @@ private:
     /// Load ini file
     void loadIni();
 
+    /// Register the UI entries declared by the [ui.*] groups of plugin.ini
+    void loadUiManifest(GKeyFile* config);
+
+    /// Create the Lua state and run the plugin script
+    void runScript();
+
+    /// Run the plugin script if it is not loaded yet
+    /// @return true if the script is loaded
+    auto ensureLoaded() -> bool;
+
     /// Load custom Lua Libraries
     static void registerXournalppLibs(lua_State* luaPtr);
 
-    /// Add the plugin folder to the lua path
-    void addPluginToLuaPath();
+    /// Run a callback on a worker thread, unless one is already running
+    void executeAsync(const std::string& callback, ptrdiff_t mode);
 
 public:
+    /// Add the plugin folder to the lua path
+    static void addPathToLua(lua_State* luaPtr, const fs::path& pluginPath);
+
     /// Get Plugin from lua engine
     static auto getPluginFromLua(lua_State* lua) -> Plugin*;
 
@@ -175,6 +199,7 @@ private:
     std::vector<MenuEntry> menuEntries;                    ///< All registered menu entries
     xoj::util::GObjectSPtr<GMenu> menuSection;             ///< Menu section containing the menu entries
     std::vector<ToolbarButtonEntry> toolbarButtonEntries;  ///< All registered toolbar button entries
+    std::shared_ptr<PluginWorker> worker;                  ///< The last async callback
 
 
     std::string name;             ///< Plugin name
@@ -187,6 +212,7 @@ private:
     bool defaultEnabled = false;  ///< The plugin is default enabled
     bool inInitUi = false;        ///< Flag to check if init ui is currently running
     bool valid = false;           ///< Flag if the plugin is valid / correct loaded
+    bool lazy = false;            ///< The UI is declared in plugin.ini, the script is loaded on first use
 
     static constexpr auto G_ACTION_NAME_PREFIX = "plugins.action-";
 };
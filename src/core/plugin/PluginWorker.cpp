@@ -0,0 +1,378 @@
+#include "PluginWorker.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <cstdint>  // for uint32_t
+#include <cstring>  // for memcpy
+#include <limits>   // for numeric_limits
+#include <utility>  // for move
+
+#include <glib.h>  // for g_warning
+
+#include "control/Control.h"              // for Control
+#include "control/tools/EditSelection.h"  // for EditSelection
+#include "gui/MainWindow.h"               // for MainWindow
+#include "gui/XournalView.h"              // for XournalView
+#include "model/Element.h"                // for Element, ELEMENT_STROKE
+#include "model/Layer.h"                  // for Layer
+#include "model/Stroke.h"                 // for Stroke, StrokeTool
+#include "model/StrokeStyle.h"            // for StrokeStyle
+#include "model/XojPage.h"                // for XojPage
+#include "undo/InsertUndoAction.h"        // for InsertsUndoAction
+#include "undo/UndoRedoHandler.h"         // for UndoRedoHandler
+#include "util/Util.h"                    // for execInUiThread
+#include "util/XojMsgBox.h"               // for XojMsgBox
+#include "util/safe_casts.h"              // for as_signed
+
+#include "Plugin.h"  // for Plugin, LuaDeleter
+
+extern "C" {
+#include <lauxlib.h>  // for luaL_error, luaL_checktype, luaL_requiref
+#include <lualib.h>   // for luaL_openlibs
+}
+
+namespace {
+constexpr auto REGISTRY_KEY = "Xournalpp_PluginWorker";
+/// The callback checks whether it was cancelled every that many instructions
+constexpr int CANCEL_CHECK_INTERVAL = 10000;
+constexpr size_t PACKED_POINT_SIZE = 3 * sizeof(double);
+
+auto copyStroke(const Stroke& s) -> PluginWorker::StrokeData {
+    PluginWorker::StrokeData data;
+    data.points = s.getPointVector();
+    data.hasPressure = s.hasPressure();
+    StrokeTool tool = s.getToolType();
+    data.options.tool = tool == StrokeTool::HIGHLIGHTER ? "highlighter" : tool == StrokeTool::ERASER ? "eraser" : "pen";
+    data.options.width = s.getWidth();
+    data.options.color = s.getColor();
+    data.options.fill = s.getFill();
+    data.options.lineStyle = StrokeStyle::formatStyle(s.getLineStyle());
+    return data;
+}
+
+template <typename Elements>
+void copyStrokes(const Elements& elements, std::vector<PluginWorker::StrokeData>& strokes) {
+    for (const auto& e: elements) {
+        if (e->getType() == ELEMENT_STROKE) {
+            strokes.emplace_back(copyStroke(static_cast<const Stroke&>(*e)));
+        }
+    }
+}
+
+/// Same attributes as app.getStrokes
+void pushAttributes(lua_State* L, const PluginWorker::StrokeData& s) {
+    lua_pushstring(L, s.options.tool.c_str());
+    lua_setfield(L, -2, "tool");
+    lua_pushnumber(L, s.options.width.value_or(0));
+    lua_setfield(L, -2, "width");
+    lua_pushinteger(L, as_signed(uint32_t(s.options.color.value_or(Color(0U))) & 0xffffffU));
+    lua_setfield(L, -2, "color");
+    lua_pushinteger(L, s.options.fill.value_or(-1));
+    lua_setfield(L, -2, "fill");
+    lua_pushstring(L, s.options.lineStyle.value_or("plain").c_str());
+    lua_setfield(L, -2, "lineStyle");
+}
+
+void readCoordinates(lua_State* L, const char* field, std::vector<double>& values) {
+    lua_getfield(L, -1, field);
+    if (lua_istable(L, -1)) {
+        size_t count = lua_rawlen(L, -1);
+        values.reserve(count);
+        for (size_t i = 1; i <= count; i++) {
+            lua_rawgeti(L, -1, as_signed(i));
+            values.push_back(lua_tonumber(L, -1));
+            lua_pop(L, 1);
+        }
+    }
+    lua_pop(L, 1);
+}
+
+}  // namespace
+
+PluginWorker::PluginWorker(Plugin* plugin):
+        plugin(plugin), pluginName(plugin->getName()), pluginPath(plugin->getPath()) {
+    Control* ctrl = plugin->getControl();
+    if (PageRef page = ctrl->getCurrentPage(); page) {
+        copyStrokes(page->getSelectedLayer()->getElements(), this->layerStrokes);
+    }
+    if (EditSelection* sel = ctrl->getWindow()->getXournal()->getSelection(); sel) {
+        // The selected strokes are part of the layer too
+        this->hasSelection = true;
+        copyStrokes(sel->getElements(), this->selectionStrokes);
+        this->layerStrokes.insert(this->layerStrokes.end(), this->selectionStrokes.begin(),
+                                  this->selectionStrokes.end());
+    }
+}
+
+PluginWorker::~PluginWorker() {
+    this->cancelled = true;
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+}
+
+void PluginWorker::start(fs::path mainFile, std::string callback, ptrdiff_t mode) {
+    this->running = true;
+    this->thread = std::thread([this, mainFile = std::move(mainFile), callback = std::move(callback), mode] {
+        run(mainFile, callback, mode);
+        // The plugin may have been unloaded meanwhile
+        Util::execInUiThread([weak = weak_from_this()] {
+            if (auto worker = weak.lock(); worker) {
+                worker->finish();
+            }
+        });
+    });
+}
+
+auto PluginWorker::isRunning() const -> bool { return this->running; }
+
+auto PluginWorker::getWorkerFromLua(lua_State* L) -> PluginWorker* {
+    lua_getfield(L, LUA_REGISTRYINDEX, REGISTRY_KEY);
+    auto* worker = static_cast<PluginWorker*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    return worker;
+}
+
+void PluginWorker::run(const fs::path& mainFile, const std::string& callback, ptrdiff_t mode) {
+    std::unique_ptr<lua_State, LuaDeleter> lua(luaL_newstate());
+    lua_State* L = lua.get();
+    luaL_openlibs(L);
+
+    lua_pushlightuserdata(L, this);
+    lua_setfield(L, LUA_REGISTRYINDEX, REGISTRY_KEY);
+    luaL_requiref(L, "app", openAppLibrary, 1);
+    lua_pop(L, 1);
+    Plugin::addPathToLua(L, this->pluginPath);
+    lua_sethook(L, cancelHook, LUA_MASKCOUNT, CANCEL_CHECK_INTERVAL);
+
+    // The main file defines the callback
+    if (luaL_loadfile(L, mainFile.string().c_str()) != LUA_OK || lua_pcall(L, 0, 0, 0) != LUA_OK) {
+        this->error = lua_tostring(L, -1);
+        return;
+    }
+
+    lua_getglobal(L, callback.c_str());
+    int numArgs = 0;
+    if (mode != std::numeric_limits<ptrdiff_t>::max()) {
+        lua_pushinteger(L, mode);
+        numArgs = 1;
+    }
+    if (lua_pcall(L, numArgs, 0, 0) != LUA_OK) {
+        this->error = lua_tostring(L, -1);
+        this->addedStrokes.clear();
+    }
+}
+
+void PluginWorker::finish() {
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+    this->running = false;
+
+    if (!this->error.empty()) {
+        XojMsgBox::showPluginMessage(this->pluginName, this->error, true);
+        g_warning("Error in Plugin: \"%s\", error: \"%s\"", this->pluginName.c_str(), this->error.c_str());
+        return;
+    }
+
+    Control* ctrl = this->plugin->getControl();
+    PageRef page = ctrl->getCurrentPage();
+    if (this->addedStrokes.empty() || !page) {
+        return;
+    }
+
+    // All the strokes in one batch
+    Layer* layer = page->getSelectedLayer();
+    std::vector<Element*> elements;
+    elements.reserve(this->addedStrokes.size());
+    for (auto& data: this->addedStrokes) {
+        auto stroke = std::make_unique<Stroke>();
+        stroke->setPointVector(std::move(data.points));
+        data.options.applyTo(*stroke, ctrl->getToolHandler());
+        elements.push_back(stroke.get());
+        layer->addElement(std::move(stroke));
+    }
+    this->addedStrokes.clear();
+
+    ctrl->getUndoRedoHandler()->addUndoAction(std::make_unique<InsertsUndoAction>(page, layer, elements));
+    page->fireElementsChanged(elements);
+}
+
+void PluginWorker::cancelHook(lua_State* L, lua_Debug*) {
+    if (getWorkerFromLua(L)->cancelled) {
+        luaL_error(L, "The plugin was stopped");
+    }
+}
+
+auto PluginWorker::openAppLibrary(lua_State* L) -> int {
+    static const luaL_Reg workerlib[] = {{"getStrokes", getStrokes},
+                                         {"getStrokesPacked", getStrokesPacked},
+                                         {"addStrokes", addStrokes},
+                                         {"addStrokesPacked", addStrokesPacked},
+                                         {nullptr, nullptr}};
+    luaL_newlib(L, workerlib);
+    return 1;
+}
+
+auto PluginWorker::getStrokesArgument(lua_State* L) -> const std::vector<StrokeData>& {
+    std::string type = luaL_checkstring(L, 1);
+    PluginWorker* worker = PluginWorker::getWorkerFromLua(L);
+    if (type == "layer") {
+        return worker->layerStrokes;
+    }
+    if (type == "selection") {
+        if (!worker->hasSelection) {
+            luaL_error(L, "There is no selection");
+        }
+        return worker->selectionStrokes;
+    }
+    luaL_error(L, "Unknown argument (%s) for getting selection", type.c_str());
+    return worker->layerStrokes;  // luaL_error does not return
+}
+
+template <typename ReadPoints>
+int PluginWorker::queueStrokes(lua_State* L, ReadPoints readPoints) {
+    PluginWorker* worker = PluginWorker::getWorkerFromLua(L);
+
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TTABLE);
+    lua_getfield(L, 1, "strokes");
+    if (!lua_istable(L, -1)) {
+        return luaL_error(L, "Missing stroke table!");
+    }
+
+    size_t numStrokes = lua_rawlen(L, -1);
+    for (size_t a = 1; a <= numStrokes; a++) {
+        lua_rawgeti(L, -1, as_signed(a));  // get current stroke
+        if (!lua_istable(L, -1)) {
+            return luaL_error(L, "Stroke %d is not a table!", static_cast<int>(a));
+        }
+        StrokeData stroke;
+        readPoints(stroke.points);
+        if (stroke.points.size() >= 2) {
+            stroke.options = StrokeOptions::fromLua(L);
+            worker->addedStrokes.emplace_back(std::move(stroke));
+        } else {
+            g_warning("Stroke shorter than two points. Discarding. (Has %zu/2)", stroke.points.size());
+        }
+        lua_pop(L, 1);  // cleanup stroke table
+    }
+    return 0;
+}
+
+int PluginWorker::getStrokes(lua_State* L) {
+    const auto& strokes = getStrokesArgument(L);
+
+    lua_createtable(L, static_cast<int>(strokes.size()), 0);
+    int currStrokeNo = 0;
+    for (const auto& s: strokes) {
+        lua_newtable(L);  // create stroke table
+
+        lua_createtable(L, static_cast<int>(s.points.size()), 0);
+        for (size_t i = 0; i < s.points.size(); i++) {
+            lua_pushnumber(L, s.points[i].x);
+            lua_rawseti(L, -2, as_signed(i + 1));
+        }
+        lua_setfield(L, -2, "x");
+
+        lua_createtable(L, static_cast<int>(s.points.size()), 0);
+        for (size_t i = 0; i < s.points.size(); i++) {
+            lua_pushnumber(L, s.points[i].y);
+            lua_rawseti(L, -2, as_signed(i + 1));
+        }
+        lua_setfield(L, -2, "y");
+
+        if (s.hasPressure) {
+            lua_createtable(L, static_cast<int>(s.points.size()), 0);
+            for (size_t i = 0; i < s.points.size(); i++) {
+                lua_pushnumber(L, s.points[i].z);
+                lua_rawseti(L, -2, as_signed(i + 1));
+            }
+            lua_setfield(L, -2, "pressure");
+        }
+
+        pushAttributes(L, s);
+        lua_rawseti(L, -2, ++currStrokeNo);
+    }
+    return 1;
+}
+
+int PluginWorker::getStrokesPacked(lua_State* L) {
+    const auto& strokes = getStrokesArgument(L);
+
+    lua_createtable(L, static_cast<int>(strokes.size()), 0);
+    int currStrokeNo = 0;
+    std::vector<double> packed;
+    for (const auto& s: strokes) {
+        lua_newtable(L);  // create stroke table
+
+        packed.clear();
+        packed.reserve(3 * s.points.size());
+        for (const Point& p: s.points) {
+            packed.push_back(p.x);
+            packed.push_back(p.y);
+            packed.push_back(p.z);
+        }
+        lua_pushlstring(L, reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(double));
+        lua_setfield(L, -2, "points");
+        lua_pushinteger(L, as_signed(s.points.size()));
+        lua_setfield(L, -2, "pointCount");
+        lua_pushboolean(L, s.hasPressure);
+        lua_setfield(L, -2, "hasPressure");
+
+        pushAttributes(L, s);
+        lua_rawseti(L, -2, ++currStrokeNo);
+    }
+    return 1;
+}
+
+int PluginWorker::addStrokes(lua_State* L) {
+    return queueStrokes(L, [L](std::vector<Point>& points) {
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> pressure;
+        readCoordinates(L, "x", x);
+        readCoordinates(L, "y", y);
+        readCoordinates(L, "pressure", pressure);
+        if (x.size() != y.size()) {
+            luaL_error(L, "X and Y vectors are not equal length!");
+        }
+        if (!pressure.empty() && pressure.size() != x.size()) {
+            luaL_error(L, "Pressure vector is not equal length!");
+        }
+        points.reserve(x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            points.emplace_back(x[i], y[i], pressure.empty() ? Point::NO_PRESSURE : pressure[i]);
+        }
+    });
+}
+
+int PluginWorker::addStrokesPacked(lua_State* L) {
+    return queueStrokes(L, [L](std::vector<Point>& points) {
+        lua_getfield(L, -1, "points");
+        size_t length = 0;
+        const char* data = lua_type(L, -1) == LUA_TSTRING ? lua_tolstring(L, -1, &length) : nullptr;
+        if (!data) {
+            luaL_error(L, "Missing points string!");
+        }
+        if (length % PACKED_POINT_SIZE != 0) {
+            luaL_error(L, "The points string is incomplete!");
+        }
+        lua_getfield(L, -2, "hasPressure");
+        const bool hasPressure = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+
+        points.resize(length / PACKED_POINT_SIZE);
+        for (Point& p: points) {
+            std::memcpy(&p.x, data, sizeof(double));
+            std::memcpy(&p.y, data + sizeof(double), sizeof(double));
+            if (hasPressure) {
+                std::memcpy(&p.z, data + 2 * sizeof(double), sizeof(double));
+            }
+            data += PACKED_POINT_SIZE;
+        }
+        lua_pop(L, 1);  // cleanup points string
+    });
+}
+
+#endif
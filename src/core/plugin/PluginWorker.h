@@ -0,0 +1,120 @@
+/*
+ * Xournal++
+ *
+ * Runs a plugin callback on a worker thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "config-features.h"  // for ENABLE_PLUGINS
+
+#ifdef ENABLE_PLUGINS
+
+#include <atomic>   // for atomic_bool
+#include <cstddef>  // for ptrdiff_t
+#include <memory>   // for enable_shared_from_this, shared_ptr
+#include <string>   // for string
+#include <thread>   // for thread
+#include <vector>   // for vector
+
+#include "model/Point.h"  // for Point
+#include "util/Color.h"   // for Color
+
+#include "StrokeOptions.h"  // for StrokeOptions
+#include "filesystem.h"     // for path
+
+extern "C" {
+#include <lua.h>  // for lua_State
+}
+
+class Plugin;
+
+/**
+ * @brief Runs a plugin callback registered with the "async" option of app.registerUi, in a Lua state of its own on a
+ * worker thread, so that a long computation does not freeze the UI.
+ *
+ * The worker state loads the main file of the plugin again, with a restricted app library which only exchanges
+ * messages with the document:
+ *  - app.getStrokes and app.getStrokesPacked return the strokes of the current layer and of the selection, copied on
+ *    the UI thread before the callback starts
+ *  - app.addStrokes and app.addStrokesPacked queue the strokes, which are added on the UI thread in one batch, under a
+ *    single undo action, once the callback has returned.
+ *
+ * A plugin runs at most one worker at a time.
+ */
+class PluginWorker final: public std::enable_shared_from_this<PluginWorker> {
+public:
+    /// A stroke, copied from or to be added to the document
+    struct StrokeData {
+        std::vector<Point> points;
+        bool hasPressure = false;
+        StrokeOptions options;
+    };
+
+    /**
+     * Copy the strokes of the document the callback may read. Called on the UI thread.
+     */
+    explicit PluginWorker(Plugin* plugin);
+    ~PluginWorker();
+
+    PluginWorker(const PluginWorker&) = delete;
+    PluginWorker& operator=(const PluginWorker&) = delete;
+
+    /**
+     * Start the callback on the worker thread. The mode is passed as the callback argument, unless it is the default.
+     */
+    void start(fs::path mainFile, std::string callback, ptrdiff_t mode);
+
+    /// @return true until the results of the callback are applied
+    bool isRunning() const;
+
+    /// Get the worker from its Lua state
+    static PluginWorker* getWorkerFromLua(lua_State* L);
+
+private:
+    void run(const fs::path& mainFile, const std::string& callback, ptrdiff_t mode);
+
+    /// Add the strokes of the callback to the document, on the UI thread
+    void finish();
+
+    /// The restricted app library of the worker state
+    static int openAppLibrary(lua_State* L);
+    static void cancelHook(lua_State* L, lua_Debug* ar);
+
+    /// The strokes requested by the first argument, "layer" or "selection"
+    static const std::vector<StrokeData>& getStrokesArgument(lua_State* L);
+    /// Queue the strokes of opts.strokes, reading the points of each stroke table with readPoints
+    template <typename ReadPoints>
+    static int queueStrokes(lua_State* L, ReadPoints readPoints);
+
+    static int getStrokes(lua_State* L);
+    static int getStrokesPacked(lua_State* L);
+    static int addStrokes(lua_State* L);
+    static int addStrokesPacked(lua_State* L);
+
+private:
+    Plugin* plugin;
+    std::string pluginName;
+    fs::path pluginPath;
+
+    std::thread thread;
+    std::atomic_bool running{false};
+    /// Stops the callback at its next instructions
+    std::atomic_bool cancelled{false};
+
+    /// Only read by the worker thread
+    std::vector<StrokeData> layerStrokes;
+    std::vector<StrokeData> selectionStrokes;
+    bool hasSelection = false;
+
+    /// Only written by the worker thread, until finish()
+    std::vector<StrokeData> addedStrokes;
+    std::string error;
+};
+
+#endif
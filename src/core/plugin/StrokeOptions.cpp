@@ -0,0 +1,111 @@
+#include "StrokeOptions.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <cstdint>  // for uint32_t
+
+#include <glib.h>  // for g_warning
+
+#include "control/Tool.h"         // for Tool
+#include "control/ToolEnums.h"    // for toolSizeToString, toolSizeFromString
+#include "control/ToolHandler.h"  // for ToolHandler
+#include "model/Stroke.h"         // for Stroke, StrokeTool
+#include "model/StrokeStyle.h"    // for StrokeStyle
+#include "util/i18n.h"            // for FC, _F
+#include "util/safe_casts.h"      // for as_unsigned
+
+extern "C" {
+#include <lauxlib.h>  // for luaL_optstring
+}
+
+auto StrokeOptions::fromLua(lua_State* L) -> StrokeOptions {
+    StrokeOptions options;
+
+    // Get attributes.
+    lua_getfield(L, -1, "tool");
+    lua_getfield(L, -2, "width");
+    lua_getfield(L, -3, "color");
+    lua_getfield(L, -4, "fill");
+    lua_getfield(L, -5, "lineStyle");
+    // stack now has following:
+    //   -6 = table
+    //   -5 = tool
+    //   -4 = width
+    //   -3 = color
+    //   -2 = fill
+    //   -1 = lineStyle
+
+    options.tool = luaL_optstring(L, -5, "");
+    if (lua_isnumber(L, -4)) {  // Check if the width was provided
+        options.width = lua_tonumber(L, -4);
+    }
+    if (lua_isinteger(L, -3)) {  // Check if the color was provided
+        options.color = static_cast<Color>(static_cast<uint32_t>(as_unsigned(lua_tointeger(L, -3))));
+    }
+    if (lua_isinteger(L, -2)) {  // Check if fill settings were provided
+        options.fill = static_cast<int>(lua_tointeger(L, -2));
+    }
+    if (lua_isstring(L, -1)) {  // Check if line style settings were provided
+        options.lineStyle = lua_tostring(L, -1);
+    }
+
+    // stack cleanup is needed as this is a helper function
+    lua_pop(L, 5);
+    return options;
+}
+
+void StrokeOptions::applyTo(Stroke& stroke, ToolHandler* toolHandler) const {
+    std::string size;
+    double thickness;
+    int fillOpacity;
+    bool filled;
+    Color toolColor;
+    std::string toolLineStyle;
+
+    // TODO: (willnilges) Handle DrawingType?
+    // TODO: (willnilges) Break out Eraser functionality into a new API call.
+
+    // Set tool type
+    if (this->tool == "highlighter") {
+        stroke.setToolType(StrokeTool::HIGHLIGHTER);
+
+        size = toolSizeToString(toolHandler->getHighlighterSize());
+        thickness = toolHandler->getToolThickness(TOOL_HIGHLIGHTER)[toolSizeFromString(size)];
+
+        fillOpacity = toolHandler->getHighlighterFill();
+        filled = toolHandler->getHighlighterFillEnabled();
+
+        Tool& t = toolHandler->getTool(TOOL_HIGHLIGHTER);
+        toolColor = t.getColor();
+    } else {
+        if (this->tool != "pen") {
+            g_warning("%s", FC(_F("Unknown stroke type: \"{1}\", defaulting to pen") % this->tool));
+        }
+        stroke.setToolType(StrokeTool::PEN);
+
+        size = toolSizeToString(toolHandler->getPenSize());
+        thickness = toolHandler->getToolThickness(TOOL_PEN)[toolSizeFromString(size)];
+
+        fillOpacity = toolHandler->getPenFill();
+        filled = toolHandler->getPenFillEnabled();
+
+        Tool& t = toolHandler->getTool(TOOL_PEN);
+        toolColor = t.getColor();
+        toolLineStyle = StrokeStyle::formatStyle(t.getLineStyle());
+    }
+
+    stroke.setWidth(this->width.value_or(thickness));
+    stroke.setColor(this->color.value_or(toolColor));
+
+    if (this->fill) {
+        stroke.setFill(*this->fill);
+    } else if (filled) {
+        stroke.setFill(fillOpacity);
+    } else {
+        stroke.setFill(-1);  // No fill
+    }
+
+    stroke.setLineStyle(StrokeStyle::parseStyle(this->lineStyle.value_or(toolLineStyle)));
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * Xournal++
+ *
+ * The attributes of a stroke added by a plugin
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "config-features.h"  // for ENABLE_PLUGINS
+
+#ifdef ENABLE_PLUGINS
+
+#include <optional>  // for optional
+#include <string>    // for string
+
+#include "util/Color.h"  // for Color
+
+extern "C" {
+#include <lua.h>  // for lua_State
+}
+
+class Stroke;
+class ToolHandler;
+
+/**
+ * The attributes of a stroke given by a plugin (see app.addStrokes): those not given are taken from the settings of
+ * the tool when the stroke is added.
+ */
+struct StrokeOptions final {
+    std::string tool;  ///< "pen" or "highlighter"
+    std::optional<double> width;
+    std::optional<Color> color;
+    std::optional<int> fill;
+    std::optional<std::string> lineStyle;
+
+    /// Read the options of the stroke table on the top of the Lua stack
+    static StrokeOptions fromLua(lua_State* L);
+
+    /// Set the attributes of the stroke, the missing ones from the current tool settings
+    void applyTo(Stroke& stroke, ToolHandler* toolHandler) const;
+};
+
+#endif
@@ -10,10 +10,14 @@
  */
 #pragma once
 
+#include <algorithm>  // for clamp, remove_if
 #include <cstring>
-#include <limits>  // for numeric_limits
+#include <limits>     // for numeric_limits
 #include <memory>
+#include <numeric>    // for iota
+#include <optional>   // for optional, nullopt
 #include <sstream>
+#include <string>     // for string, to_string
 
 #include <gtk/gtk.h>
 #include <stdint.h>
@@ -21,6 +25,7 @@
 #include "control/Control.h"
 #include "control/ExportHelper.h"
 #include "control/PageBackgroundChangeController.h"
+#include "control/ParallelPageEdit.h"
 #include "control/ScrollHandler.h"
 #include "control/Tool.h"
 #include "control/actions/ActionDatabase.h"  // for ActionDatabase
@@ -43,14 +48,19 @@
 #include "model/Element.h"
 #include "model/Font.h"
 #include "model/Image.h"
+#include "model/Layer.h"
 #include "model/SplineSegment.h"
 #include "model/Stroke.h"
 #include "model/StrokeStyle.h"
 #include "model/Text.h"
 #include "model/XojPage.h"  // IWYU pragma: keep for XojPage
 #include "plugin/Plugin.h"
+#include "plugin/StrokeOptions.h"
+#include "undo/GroupUndoAction.h"
 #include "undo/InsertUndoAction.h"
+#include "undo/ScaleUndoAction.h"
 #include "util/PopupWindowWrapper.h"  // for PopupWindowWrapper
+#include "util/Range.h"               // for Range
 #include "util/StringUtils.h"
 #include "util/i18n.h"        // for _
 #include "util/safe_casts.h"  // for round_cast, as_signed, as_unsigned
@@ -64,15 +74,110 @@ extern "C" {
 }
 
 
-static std::tuple<std::optional<std::string>, std::vector<Element*>> getElementsFromHelper(Control* control,
-                                                                                           const std::string& type) {
+/**
+ * The optional second argument of app.getStrokes, app.getStrokesPacked, app.getTexts and app.getImages
+ */
+struct ElementFilter {
+    /// The area the bounding boxes of the elements must intersect (the bounding box of the disc if radius is set)
+    std::optional<Range> area;
+    /// The bounding boxes must also intersect the disc of this radius centered at (x, y)
+    std::optional<double> radius;
+    double x = 0;
+    double y = 0;
+    /// The layer to get the elements from instead of the current one (type "layer")
+    std::optional<Layer::Index> layerId;
+};
+
+/**
+ * Read the filter table at index idx of the stack, if any: {x:number, y:number, width:number, height:number},
+ * {x:number, y:number, radius:number} or neither, with an optional layer:integer field
+ * @return An error message if the table is invalid
+ */
+static std::optional<std::string> getElementFilterHelper(lua_State* L, int idx, ElementFilter& filter) {
+    if (lua_isnoneornil(L, idx)) {
+        return std::nullopt;
+    }
+    if (!lua_istable(L, idx)) {
+        return "The area must be a table";
+    }
+
+    auto getNumber = [&](const char* field) -> std::optional<double> {
+        lua_getfield(L, idx, field);
+        std::optional<double> res;
+        if (lua_isnumber(L, -1)) {
+            res = lua_tonumber(L, -1);
+        }
+        lua_pop(L, 1);
+        return res;
+    };
+
+    auto x = getNumber("x");
+    auto y = getNumber("y");
+    auto width = getNumber("width");
+    auto height = getNumber("height");
+    auto radius = getNumber("radius");
+
+    lua_getfield(L, idx, "layer");
+    if (lua_isinteger(L, -1)) {
+        const lua_Integer layer = lua_tointeger(L, -1);
+        if (layer < 1) {
+            lua_pop(L, 1);
+            return "The layer ID must be a positive integer";
+        }
+        filter.layerId = as_unsigned(layer);
+    } else if (!lua_isnil(L, -1)) {
+        lua_pop(L, 1);
+        return "The layer ID must be a positive integer";
+    }
+    lua_pop(L, 1);
+
+    if (!x && !y && !width && !height && !radius) {
+        // Only the layer
+        return std::nullopt;
+    }
+    if (!x || !y) {
+        return "Missing x or y coordinate of the area";
+    }
+    if (radius) {
+        if (*radius < 0) {
+            return "The radius must not be negative";
+        }
+        filter.radius = radius;
+        filter.x = *x;
+        filter.y = *y;
+        filter.area = Range(*x - *radius, *y - *radius, *x + *radius, *y + *radius);
+    } else {
+        if (!width || !height || *width < 0 || *height < 0) {
+            return "The area needs a width and a height, or a radius";
+        }
+        filter.area = Range(*x, *y, *x + *width, *y + *height);
+    }
+    return std::nullopt;
+}
+
+static std::tuple<std::optional<std::string>, std::vector<Element*>> getElementsFromHelper(
+        Control* control, const std::string& type, const ElementFilter& filter = {}) {
     std::vector<Element*> elements = {};
     if (type == "layer") {
         auto sel = control->getWindow()->getXournal()->getSelection();
         if (sel) {
             control->clearSelection();  // otherwise texts in the selection won't be recognized
         }
-        elements = xoj::refElementContainer(control->getCurrentPage()->getSelectedLayer()->getElements());
+        const PageRef& page = control->getCurrentPage();
+        Layer* layer = page->getSelectedLayer();
+        if (filter.layerId) {
+            if (*filter.layerId > page->getLayerCount()) {
+                return std::make_tuple(std::make_optional("No layer with layer ID " + std::to_string(*filter.layerId)),
+                                       elements);
+            }
+            layer = (*page->getLayers())[*filter.layerId - 1];
+        }
+        if (filter.area) {
+            // Answered by the spatial index of the layer
+            elements = layer->getElementsInArea(*filter.area);
+        } else {
+            elements = xoj::refElementContainer(layer->getElements());
+        }
     } else if (type == "selection") {
         auto sel = control->getWindow()->getXournal()->getSelection();
         if (sel) {
@@ -80,11 +185,33 @@ static std::tuple<std::optional<std::string>, std::vector<Element*>> getElements
         } else {
             return std::make_tuple(std::make_optional("There is no selection"), elements);
         }
+        if (filter.area) {
+            const Range& area = *filter.area;
+            elements.erase(std::remove_if(elements.begin(), elements.end(),
+                                          [&area](const Element* e) {
+                                              auto r = e->boundingRect();
+                                              return r.x > area.maxX || r.x + r.width < area.minX ||
+                                                     r.y > area.maxY || r.y + r.height < area.minY;
+                                          }),
+                           elements.end());
+        }
     } else {
         std::stringstream err_msg;
         err_msg << "Unknown argument (" << type << ") for getting selection";
         return std::make_tuple(std::make_optional(err_msg.str()), elements);
     }
+
+    if (filter.radius) {
+        // The distance from the center to the closest point of the bounding box
+        elements.erase(std::remove_if(elements.begin(), elements.end(),
+                                      [&filter](const Element* e) {
+                                          auto r = e->boundingRect();
+                                          const double dx = std::clamp(filter.x, r.x, r.x + r.width) - filter.x;
+                                          const double dy = std::clamp(filter.y, r.y, r.y + r.height) - filter.y;
+                                          return dx * dx + dy * dy > *filter.radius * *filter.radius;
+                                      }),
+                       elements.end());
+    }
     return std::make_tuple(std::nullopt, elements);
 }
 
@@ -427,8 +554,8 @@ static int applib_openDialog(lua_State* L) {
 /**
  * Allow to register menupoints and toolbar buttons. This needs to be called from initUi
  *
- * @param opts {menu: string, callback: string, toolbarID: string, mode:integer, accelerator:string} options (`mode`,
- `toolbarID` and `accelerator` are optional)
+ * @param opts {menu: string, callback: string, toolbarID: string, mode:integer, accelerator:string, async:boolean}
+ options (`mode`, `toolbarID`, `accelerator` and `async` are optional)
  * @return {menuId:integer}
  *
  * Example 1: app.registerUi({["menu"] = "HelloWorld", callback="printMessage", mode=1, accelerator="<Control>a"})
@@ -442,6 +569,15 @@ static int applib_openDialog(lua_State* L) {
  *
  * The mode and accelerator are optional. When specifying the mode, the callback function should have one parameter
    that receives the mode. This is useful for callback functions that are shared among multiple menu entries.
+ *
+ * With async=true, the callback runs on a worker thread in a Lua state of its own, which loads the main file of the
+   plugin again, so that a long computation does not freeze the UI. Only app.getStrokes, app.getStrokesPacked,
+   app.addStrokes and app.addStrokesPacked are available there: the strokes read are the ones of the current layer and
+   selection when the callback starts, the strokes added are inserted once the callback has returned, under a single
+   undo action.
+ *
+ * The same entries can be declared in [ui.<name>] groups of plugin.ini instead, with the same keys. The script of such
+   a plugin is only loaded when one of its entries is first used, and its initUi is not called.
  */
 static int applib_registerUi(lua_State* L) {
     Plugin* plugin = Plugin::getPluginFromLua(L);
@@ -482,11 +618,14 @@ static int applib_registerUi(lua_State* L) {
         return luaL_error(L, "Missing callback function!");
     }
 
-    size_t menuId = plugin->registerMenu(menu, callback, mode, accelerator);
-    plugin->registerToolButton(menu, toolbarId, iconName, callback, mode);
+    lua_getfield(L, 1, "async");
+    const bool async = lua_toboolean(L, -1);
+
+    size_t menuId = plugin->registerMenu(menu, callback, mode, accelerator, async);
+    plugin->registerToolButton(menu, toolbarId, iconName, callback, mode, async);
 
     // Make sure to remove all vars which are put to the stack before!
-    lua_pop(L, 6);
+    lua_pop(L, 7);
 
     // Add return value to the Stack
     lua_createtable(L, 0, 2);
@@ -697,98 +836,7 @@ static void addStrokeHelper(lua_State* L, std::unique_ptr<Stroke> stroke) {
     PageRef const& page = ctrl->getCurrentPage();
     Layer* layer = page->getSelectedLayer();
 
-    std::string size;
-    double thickness;
-    int fillOpacity;
-    bool filled;
-    Color color;
-    std::string lineStyle;
-    ToolHandler* toolHandler;
-    const char* tool;
-    std::string allowUndoRedoAction;
-
-    // Get attributes.
-    lua_getfield(L, -1, "tool");
-    lua_getfield(L, -2, "width");
-    lua_getfield(L, -3, "color");
-    lua_getfield(L, -4, "fill");
-    lua_getfield(L, -5, "lineStyle");
-    // stack now has following:
-    //   -6 = table
-    //   -5 = tool
-    //   -4 = width
-    //   -3 = color
-    //   -2 = fill
-    //   -1 = lineStyle
-
-    tool = luaL_optstring(L, -5, "");  // We're gonna need the tool type.
-
-    toolHandler = ctrl->getToolHandler();
-
-    // TODO: (willnilges) Handle DrawingType?
-    // TODO: (willnilges) Break out Eraser functionality into a new API call.
-
-    // Set tool type
-    if (strcmp("highlighter", tool) == 0) {
-        stroke->setToolType(StrokeTool::HIGHLIGHTER);
-
-        size = toolSizeToString(toolHandler->getHighlighterSize());
-        thickness = toolHandler->getToolThickness(TOOL_HIGHLIGHTER)[toolSizeFromString(size)];
-
-        fillOpacity = toolHandler->getHighlighterFill();
-        filled = toolHandler->getHighlighterFillEnabled();
-
-        Tool& tool = toolHandler->getTool(TOOL_HIGHLIGHTER);
-        color = tool.getColor();
-    } else {
-        if (!(strcmp("pen", tool) == 0)) {
-            g_warning("%s", FC(_F("Unknown stroke type: \"{1}\", defaulting to pen") % tool));
-        }
-        stroke->setToolType(StrokeTool::PEN);
-
-        size = toolSizeToString(toolHandler->getPenSize());
-        thickness = toolHandler->getToolThickness(TOOL_PEN)[toolSizeFromString(size)];
-
-        fillOpacity = toolHandler->getPenFill();
-        filled = toolHandler->getPenFillEnabled();
-
-        Tool& tool = toolHandler->getTool(TOOL_PEN);
-        color = tool.getColor();
-        lineStyle = StrokeStyle::formatStyle(tool.getLineStyle());
-    }
-
-    // Set width
-    if (lua_isnumber(L, -4)) {  // Check if the width was provided
-        stroke->setWidth(lua_tonumber(L, -4));
-    } else {
-        stroke->setWidth(thickness);
-    }
-
-    // Set color
-    if (lua_isinteger(L, -3)) {  // Check if the color was provided
-        stroke->setColor(static_cast<Color>(static_cast<uint32_t>(as_unsigned(lua_tointeger(L, -3)))));
-    } else {
-        stroke->setColor(color);
-    }
-
-    // Set fill
-    if (lua_isinteger(L, -2)) {  // Check if fill settings were provided
-        stroke->setFill(static_cast<int>(lua_tointeger(L, -2)));
-    } else if (filled) {
-        stroke->setFill(fillOpacity);
-    } else {
-        stroke->setFill(-1);  // No fill
-    }
-
-    // Set line style
-    if (lua_isstring(L, -1)) {  // Check if line style settings were provided
-        stroke->setLineStyle(StrokeStyle::parseStyle(lua_tostring(L, -1)));
-    } else {
-        stroke->setLineStyle(StrokeStyle::parseStyle(lineStyle.data()));
-    }
-
-    // stack cleanup is needed as this is a helper function
-    lua_pop(L, 5);  // Finally done with all that Lua data.
+    StrokeOptions::fromLua(L).applyTo(*stroke, ctrl->getToolHandler());
 
     // Add the stroke
     layer->addElement(std::move(stroke));
@@ -1288,11 +1336,14 @@ static int applib_addTexts(lua_State* L) {
  * Is mostly inverse to app.addTexts (except getTexts will also retrieve the width/height of the textbox)
  *
  * @param type string "selection" or "layer"
+ * @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
  * @return {text:string, font:{name:string, size:number}, color:integer, x:number, y:number, width:number,
  * height:number}[] texts
  *
  * Required argument: type ("selection" or "layer")
  *
+ * Optional argument: area, to only get the elements in a part of the page (see app.getStrokes)
+ *
  * Example: local texts = app.getTexts("layer")
  *
  * possible return value:
@@ -1330,10 +1381,15 @@ static int applib_getTexts(lua_State* L) {
     Control* control = plugin->getControl();
 
     // Discard any extra arguments passed in
-    lua_settop(L, 1);
+    lua_settop(L, 2);
     luaL_checktype(L, 1, LUA_TSTRING);
 
-    const auto& [err, elements] = getElementsFromHelper(control, type);
+    ElementFilter filter;
+    if (auto filterErr = getElementFilterHelper(L, 2, filter)) {
+        return luaL_error(L, filterErr->c_str());
+    }
+
+    const auto& [err, elements] = getElementsFromHelper(control, type, filter);
     if (err.has_value()) {
         return luaL_error(L, err.value().c_str());
     }
@@ -1393,11 +1449,22 @@ static int applib_getTexts(lua_State* L) {
  * Is inverse to app.addStrokes
  *
  * @param type string "selection" or "layer"
+ * @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
  * @return {x:number[], y:number[], pressure:number[], tool:string, width:number, color:integer, fill:number,
  * linestyle:string}[] strokes
  *
  * Required argument: type ("selection" or "layer")
  *
+ * Optional argument: area, to only get the elements whose bounding box intersects a part of the page. With type
+ * "layer", it is answered by the spatial index of the layer, in a time depending on the size of the result.
+ *   {x = ..., y = ..., width = ..., height = ...} for a rectangle,
+ *   {x = ..., y = ..., radius = ...} for the disc of this radius centered at (x, y).
+ * With type "layer", its field layer (the ID of a non-background layer of the current page) gets the elements of that
+ * layer instead of those of the current layer. It may be given without the other fields.
+ *
+ * Example: local near = app.getStrokes("layer", {x = 100, y = 200, radius = 20})
+ *          local others = app.getStrokes("layer", {x = 0, y = 0, width = 300, height = 100, layer = 2})
+ *
  * Example: local strokes = app.getStrokes("selection")
  *
  * possible return value:
@@ -1440,10 +1507,15 @@ static int applib_getStrokes(lua_State* L) {
     Control* control = plugin->getControl();
 
     // Discard any extra arguments passed in
-    lua_settop(L, 1);
+    lua_settop(L, 2);
     luaL_checktype(L, 1, LUA_TSTRING);
 
-    const auto& [err, elements] = getElementsFromHelper(control, type);
+    ElementFilter filter;
+    if (auto filterErr = getElementFilterHelper(L, 2, filter)) {
+        return luaL_error(L, filterErr->c_str());
+    }
+
+    const auto& [err, elements] = getElementsFromHelper(control, type, filter);
     if (err.has_value()) {
         return luaL_error(L, err.value().c_str());
     }
@@ -1533,6 +1605,217 @@ static int applib_getStrokes(lua_State* L) {
     return 1;
 }
 
+/**
+ * Like app.getStrokes, but the points of each stroke are packed in a single string, which is much faster for many
+ * strokes than tables of numbers.
+ * Is inverse to app.addStrokesPacked
+ *
+ * @param type string "selection" or "layer"
+ * @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
+ * @return {points:string, pointCount:integer, hasPressure:boolean, tool:string, width:number, color:integer,
+ * fill:number, linestyle:string}[] strokes
+ *
+ * Required argument: type ("selection" or "layer")
+ *
+ * Optional argument: area, to only get the elements in a part of the page (see app.getStrokes)
+ *
+ * The points string holds, for each point, its x and y coordinates and its pressure as native-endian doubles (the
+ * pressure is -1 if the stroke has no pressure). The values can be read with string.unpack.
+ *
+ * Example: local strokes = app.getStrokesPacked("layer")
+ *          for _, s in ipairs(strokes) do
+ *            local pos = 1
+ *            for i = 1, s.pointCount do
+ *              local x, y, pressure
+ *              x, y, pressure, pos = string.unpack("ddd", s.points, pos)
+ *            end
+ *          end
+ */
+static int applib_getStrokesPacked(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    std::string type = luaL_checkstring(L, 1);
+    Control* control = plugin->getControl();
+
+    // Discard any extra arguments passed in
+    lua_settop(L, 2);
+
+    ElementFilter filter;
+    if (auto filterErr = getElementFilterHelper(L, 2, filter)) {
+        return luaL_error(L, filterErr->c_str());
+    }
+
+    const auto& [err, elements] = getElementsFromHelper(control, type, filter);
+    if (err.has_value()) {
+        return luaL_error(L, err.value().c_str());
+    }
+
+    lua_newtable(L);  // create table of the elements
+    int currStrokeNo = 0;
+    std::vector<double> packed;
+
+    for (Element* e: elements) {
+        if (e->getType() != ELEMENT_STROKE) {
+            continue;
+        }
+        auto* s = static_cast<Stroke*>(e);
+        lua_newtable(L);  // create stroke table
+
+        const auto& points = s->getPointVector();
+        packed.clear();
+        packed.reserve(3 * points.size());
+        for (const Point& p: points) {
+            packed.push_back(p.x);
+            packed.push_back(p.y);
+            packed.push_back(p.z);
+        }
+        lua_pushlstring(L, reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(double));
+        lua_setfield(L, -2, "points");  // add points to stroke
+
+        lua_pushinteger(L, as_signed(points.size()));
+        lua_setfield(L, -2, "pointCount");  // add point count to stroke
+
+        lua_pushboolean(L, s->hasPressure());
+        lua_setfield(L, -2, "hasPressure");  // add pressure flag to stroke
+
+        StrokeTool tool = s->getToolType();
+        if (tool == StrokeTool::PEN) {
+            lua_pushstring(L, "pen");
+        } else if (tool == StrokeTool::ERASER) {
+            lua_pushstring(L, "eraser");
+        } else if (tool == StrokeTool::HIGHLIGHTER) {
+            lua_pushstring(L, "highlighter");
+        } else {
+            return luaL_error(L, "Unknown StrokeTool::Value.");
+        }
+        lua_setfield(L, -2, "tool");  // add tool to stroke
+
+        lua_pushnumber(L, s->getWidth());
+        lua_setfield(L, -2, "width");  // add width to stroke
+
+        lua_pushinteger(L, as_signed(uint32_t(s->getColor()) & 0xffffffU));
+        lua_setfield(L, -2, "color");  // add color to stroke
+
+        lua_pushinteger(L, s->getFill());
+        lua_setfield(L, -2, "fill");  // add fill to stroke
+
+        lua_pushstring(L, StrokeStyle::formatStyle(s->getLineStyle()).c_str());
+        lua_setfield(L, -2, "lineStyle");  // add linestyle to stroke
+
+        lua_rawseti(L, -2, ++currStrokeNo);  // add stroke to returned table
+    }
+    return 1;
+}
+
+/**
+ * Like app.addStrokes, but the points of each stroke are given packed in a single string, as returned by
+ * app.getStrokesPacked.
+ *
+ * @param opts {strokes:{points:string, hasPressure:boolean, tool:string, width:number, color:integer, fill:number,
+ * linestyle:string}[], allowUndoRedoAction:string}
+ *
+ * Required Arguments: points
+ * Optional Arguments: hasPressure, tool, width, color, fill, lineStyle
+ *
+ * The points string holds, for each point, its x and y coordinates and its pressure as native-endian doubles, e.g.
+ * built with string.pack("ddd", x, y, pressure). The pressures are ignored unless hasPressure is true. A stroke must
+ * have at least two points.
+ *
+ * If optional arguments are not provided, the specified tool settings are used.
+ * If the tool is not provided, the current pen settings are used.
+ * The only tools supported are Pen and Highlighter.
+ *
+ * Example:
+ *
+ * app.addStrokesPacked({
+ *     ["strokes"] = {
+ *         {
+ *             ["points"] = string.pack("dddddd", 110.0, 200.0, 0.8, 120.0, 205.0, 0.9),
+ *             ["hasPressure"] = true,
+ *             ["tool"] = "pen",
+ *             ["width"] = 3.8,
+ *             ["color"] = 0xa000f0,
+ *         },
+ *     },
+ *     ["allowUndoRedoAction"] = "grouped", -- Each batch of strokes can be grouped into one undo/redo action (or
+ * "individual" or "none")
+ * })
+ */
+static int applib_addStrokesPacked(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* ctrl = plugin->getControl();
+    std::vector<Element*> strokes;
+    const char* allowUndoRedoAction;
+
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    lua_getfield(L, 1, "strokes");
+    if (!lua_istable(L, -1)) {
+        return luaL_error(L, "Missing stroke table!");
+    }
+
+    // stack now has following:
+    //  1 = table arg
+    // -1 = strokes
+
+    constexpr size_t pointSize = 3 * sizeof(double);
+    size_t numStrokes = lua_rawlen(L, -1);
+    for (size_t a = 1; a <= numStrokes; a++) {
+        lua_rawgeti(L, -1, as_signed(a));  // get current stroke
+        if (!lua_istable(L, -1)) {
+            return luaL_error(L, "Stroke %d is not a table!", static_cast<int>(a));
+        }
+
+        lua_getfield(L, -1, "points");
+        size_t length = 0;
+        const char* data = lua_type(L, -1) == LUA_TSTRING ? lua_tolstring(L, -1, &length) : nullptr;
+        if (!data) {
+            return luaL_error(L, "Missing points string!");
+        }
+        if (length % pointSize != 0) {
+            return luaL_error(L, "The points string of stroke %d is incomplete!", static_cast<int>(a));
+        }
+        lua_getfield(L, -2, "hasPressure");
+        const bool hasPressure = lua_toboolean(L, -1);
+        lua_pop(L, 1);  // cleanup pressure flag
+
+        std::vector<Point> points(length / pointSize);
+        for (size_t i = 0; i < points.size(); i++, data += pointSize) {
+            Point& p = points[i];
+            std::memcpy(&p.x, data, sizeof(double));
+            std::memcpy(&p.y, data + sizeof(double), sizeof(double));
+            if (hasPressure) {
+                std::memcpy(&p.z, data + 2 * sizeof(double), sizeof(double));
+            }
+        }
+        lua_pop(L, 1);  // cleanup points string
+
+        if (points.size() >= 2) {
+            auto stroke = std::make_unique<Stroke>();
+            stroke->setPointVector(std::move(points));
+            // Finish building the Stroke and apply it to the layer.
+            strokes.push_back(stroke.get());
+            addStrokeHelper(L, std::move(stroke));
+        } else {
+            g_warning("Stroke shorter than two points. Discarding. (Has %zu/2)", points.size());
+        }
+        // Onto the next stroke
+        lua_pop(L, 1);  // cleanup stroke table
+    }
+
+    lua_pop(L, 1);  // cleanup strokes table
+
+    // stack now has following:
+    //  1 = table arg
+
+    // Check how the user wants to handle undoing
+    lua_getfield(L, 1, "allowUndoRedoAction");
+    allowUndoRedoAction = luaL_optstring(L, -1, "grouped");
+    lua_pop(L, 1);
+    return handleUndoRedoActionHelper(L, ctrl, allowUndoRedoAction, strokes);
+}
+
 /**
  * Notifies program of any updates to the working document caused
  * by the API.
@@ -2082,10 +2365,11 @@ static int applib_getToolInfo(lua_State* L) {
 /**
  * Returns a table encoding the document structure in a Lua table.
  *
+ * @param opts {pages:integer[]}|nil the numbers of the pages to describe (optional, all pages by default)
  * @return {pages:{pageWidth:number, pageHeight:number, isAnnotated:boolean, pageTypeFormat:string,
  * pageTypeConfig:string, backgroundColor:integer, pdfBackgroundPageNo:integer, layers:{isVisible:boolean,
- * isAnnotated:boolean}[], currentLayer:integer}[], currentPage:integer, pdfBackgroundFilename:string,
- * xoppFilename:string}
+ * isAnnotated:boolean}[], currentLayer:integer, revision:integer}[], currentPage:integer,
+ * pdfBackgroundFilename:string, xoppFilename:string, revision:integer}
  *
  * The shape of the returned Lua table will be:
  * {
@@ -2108,22 +2392,52 @@ static int applib_getToolInfo(lua_State* L) {
  *         },
  *         ...
  *       },
- *       "currentLayer" = integer
+ *       "currentLayer" = integer,
+ *       "revision" = integer (see app.getPageRevisions)
  *     },
  *     ...
  *   }
  *   "currentPage" = integer,
  *   "pdfBackgroundFilename" = string (empty if there is none)
  *   "xoppFilename" = string (empty if there is none)
+ *   "revision" = integer (see app.getDocumentRevision)
  * }
  *
- * Example: local docStructure = app.getDocumentStructure()
+ * When opts.pages is given, only the listed pages are in the "pages" table, under their page numbers.
+ *
+ * Example 1: local docStructure = app.getDocumentStructure()
+ *
+ * Example 2: local changed = app.getDocumentStructure({pages = {2, 5}})
+ * only describes the pages 2 and 5, e.g. the ones whose revision changed since the last query
  */
 static int applib_getDocumentStructure(lua_State* L) {
     Plugin* plugin = Plugin::getPluginFromLua(L);
     Control* control = plugin->getControl();
     Document* doc = control->getDocument();
 
+    // The page numbers to describe, starting at 1
+    std::vector<size_t> pageNumbers;
+    if (lua_istable(L, 1)) {
+        lua_getfield(L, 1, "pages");
+        if (lua_istable(L, -1)) {
+            size_t count = lua_rawlen(L, -1);
+            for (size_t i = 1; i <= count; i++) {
+                lua_rawgeti(L, -1, as_signed(i));
+                lua_Integer p = lua_tointeger(L, -1);
+                lua_pop(L, 1);
+                if (p < 1 || static_cast<size_t>(p) > doc->getPageCount()) {
+                    return luaL_error(L, "Invalid page number %d", static_cast<int>(p));
+                }
+                pageNumbers.push_back(static_cast<size_t>(p));
+            }
+        }
+        lua_pop(L, 1);
+    } else {
+        pageNumbers.resize(doc->getPageCount());
+        std::iota(pageNumbers.begin(), pageNumbers.end(), 1);
+    }
+    lua_settop(L, 0);
+
     lua_newtable(L);
 
     lua_pushliteral(L, "pages");
@@ -2134,7 +2448,7 @@ static int applib_getDocumentStructure(lua_State* L) {
     //   -1 = pages table/array
 
     // add pages
-    for (size_t p = 1; p <= doc->getPageCount(); ++p) {
+    for (size_t p: pageNumbers) {
         auto page = doc->getPage(p - 1);
         lua_pushinteger(L, as_signed(p));  // key of the page
         lua_newtable(L);                   // beginning of table for page p
@@ -2199,6 +2513,9 @@ static int applib_getDocumentStructure(lua_State* L) {
         lua_pushinteger(L, as_signed(page->getSelectedLayerId()));  // value
         lua_setfield(L, -2, "currentLayer");                        // insert
 
+        lua_pushinteger(L, as_signed(page->getRevision()));  // value
+        lua_setfield(L, -2, "revision");                     // insert
+
         lua_settable(L, -3);  // end of table for page p
     }
     lua_settable(L, -3);  // end of pages table
@@ -2212,6 +2529,82 @@ static int applib_getDocumentStructure(lua_State* L) {
     lua_pushstring(L, doc->getFilepath().string().c_str());  // value
     lua_setfield(L, -2, "xoppFilename");                     // insert
 
+    lua_pushinteger(L, as_signed(doc->getRevision()));  // value
+    lua_setfield(L, -2, "revision");                    // insert
+
+    return 1;
+}
+
+/**
+ * Returns the revision of the document: a counter which changes whenever the document changes, i.e. pages are
+ * inserted or deleted, a page or its layers or elements change, or the document or the pdf background file changes.
+ * The current page is not part of the revision.
+ *
+ * @return integer the revision of the document
+ *
+ * Example: if app.getDocumentRevision() ~= lastRevision then ... end
+ * checks whether the document changed since the last query, without building a table
+ */
+static int applib_getDocumentRevision(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    lua_pushinteger(L, as_signed(plugin->getControl()->getDocument()->getRevision()));
+    return 1;
+}
+
+/**
+ * Returns the revisions of the pages: counters which change whenever the page changes, i.e. its size, background,
+ * current layer, or its layers or elements.
+ *
+ * @return integer[] the revisions of the pages, by page number
+ *
+ * Example: local revisions = app.getPageRevisions()
+ * a plugin can compare them to the ones of its last query, and call app.getDocumentStructure({pages = ...}) with the
+ * pages whose revision changed only
+ */
+static int applib_getPageRevisions(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Document* doc = plugin->getControl()->getDocument();
+
+    lua_createtable(L, static_cast<int>(doc->getPageCount()), 0);
+    for (size_t p = 0; p < doc->getPageCount(); p++) {
+        lua_pushinteger(L, as_signed(doc->getPage(p)->getRevision()));
+        lua_rawseti(L, -2, as_signed(p + 1));
+    }
+    return 1;
+}
+
+/**
+ * Returns the numbers of the pages on which strokes of visible layers are in the given rectangle.
+ * Uses the ink index of the document: no need to go through all the strokes of the document.
+ *
+ * @param x number left side of the rectangle, in page coordinates
+ * @param y number top side of the rectangle, in page coordinates
+ * @param width number width of the rectangle
+ * @param height number height of the rectangle
+ * @return table the page numbers (starting at 1), in increasing order
+ *
+ * Example: local pages = app.getPagesWithInk(0, 0, 200, 100)
+ * returns the pages with handwriting in their top left corner
+ */
+static int applib_getPagesWithInk(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Document* doc = plugin->getControl()->getDocument();
+
+    double x = luaL_checknumber(L, 1);
+    double y = luaL_checknumber(L, 2);
+    double width = luaL_checknumber(L, 3);
+    double height = luaL_checknumber(L, 4);
+
+    doc->lock();
+    auto pages = doc->getInkIndex().getPagesWithInk(*doc, Range(x, y, x + width, y + height));
+    doc->unlock();
+
+    lua_newtable(L);
+    for (size_t i = 0; i < pages.size(); i++) {
+        lua_pushinteger(L, as_signed(i + 1));         // key
+        lua_pushinteger(L, as_signed(pages[i] + 1));  // value
+        lua_settable(L, -3);                          // insert
+    }
     return 1;
 }
 
@@ -2350,6 +2743,38 @@ static int applib_setPageSize(lua_State* L) {
     return 0;
 }
 
+/**
+ * Inserts new pages, configured like the pages inserted from the Journal menu, after the current page or before the
+ * page indicated. All the pages are inserted at once, with a single undo action.
+ *
+ * @param count integer number of pages to insert
+ * @param pageNr integer (optional) number of the page the new pages are inserted before (automatically clamped)
+ *
+ * Example 1: app.insertPages(10)
+ * inserts 10 new pages after the current page
+ *
+ * Example 2: app.insertPages(3, 1)
+ * inserts 3 new pages at the beginning of the document
+ **/
+static int applib_insertPages(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* control = plugin->getControl();
+
+    lua_Integer count = luaL_checkinteger(L, 1);
+    if (count < 0) {
+        return luaL_error(L, "The number of pages to insert must not be negative");
+    }
+
+    size_t position = control->getCurrentPageNo() + 1;
+    if (lua_isinteger(L, 2)) {
+        const size_t last = control->getDocument()->getPageCount() + 1;
+        position = std::min<size_t>(as_unsigned(std::max<lua_Integer>(lua_tointeger(L, 2), 1)), last) - 1;
+    }
+    control->insertNewPages(position, static_cast<size_t>(count));
+
+    return 0;
+}
+
 /**
  * Sets the current layer of the current page as indicated and updates visibility if specified (by default it does not)
  * Displays an error message, if the selected layer does not exist
@@ -2464,25 +2889,61 @@ static int applib_setBackgroundName(lua_State* L) {
  * of the bounding box remains unchanged
  *
  * @param factor number
+ * @param allPages boolean (optional) scale the text elements of all the layers of all the pages instead, the pages
+ *                 being processed concurrently
  *
  * Example: app.scaleTextElements(2.3)
  * scales all text elements on the current layer with factor 2.3
+ *
+ * Example: app.scaleTextElements(0.5, true)
+ * halves the font size of all the text elements of the document (undone at once)
  **/
 static int applib_scaleTextElements(lua_State* L) {
     Plugin* plugin = Plugin::getPluginFromLua(L);
     Control* control = plugin->getControl();
 
     double f = luaL_checknumber(L, 1);
+    const bool allPages = lua_toboolean(L, 2);
 
     control->clearSelectionEndText();
 
-    const auto& elements = control->getCurrentPage()->getSelectedLayer()->getElements();
-
-    for (auto const& e: elements) {
-        if (e->getType() == ELEMENT_TEXT) {
-            Text* t = static_cast<Text*>(e.get());
-            t->scale(t->getX(), t->getY(), f, f, 0.0, false);
-        }
+    Document* doc = control->getDocument();
+    std::vector<PageRef> pages;
+    if (allPages) {
+        doc->lock();
+        for (size_t p = 0; p < doc->getPageCount(); p++) { pages.push_back(doc->getPage(p)); }
+        doc->unlock();
+    } else if (PageRef page = control->getCurrentPage()) {
+        pages.push_back(std::move(page));
+    }
+
+    auto group = ParallelPageEdit::run(
+            *doc, *control, pages, [f, allPages](const PageRef& page) -> std::unique_ptr<UndoAction> {
+                auto scales = std::make_unique<GroupUndoAction>();
+                bool scaled = false;
+                const Layer* selected = allPages ? nullptr : page->getSelectedLayer();
+                for (Layer* layer: *page->getLayers()) {
+                    if (selected && layer != selected) {
+                        continue;
+                    }
+                    for (auto const& e: layer->getElements()) {
+                        if (e->getType() == ELEMENT_TEXT) {
+                            Text* t = static_cast<Text*>(e.get());
+                            std::vector<Element*> scaledText{t};
+                            scales->addAction(std::make_unique<ScaleUndoAction>(page, &scaledText, t->getX(),
+                                                                                t->getY(), f, f, 0.0, false));
+                            t->scale(t->getX(), t->getY(), f, f, 0.0, false);
+                            scaled = true;
+                        }
+                    }
+                }
+                if (!scaled) {
+                    return nullptr;
+                }
+                return scales;
+            });
+    if (group) {
+        control->getUndoRedoHandler()->addUndoAction(std::move(group));
     }
 
     return 0;
@@ -2761,7 +3222,6 @@ static int applib_addImages(lua_State* L) {
         } else {  // data was provided instead
             img = std::make_unique<Image>();
             img->setImage(std::string(data, dataLen));
-            img->getImage();  // render image first to get the proper width and height
         }
 
         auto [width, height] = img->getImageSize();
@@ -2834,11 +3294,14 @@ static int applib_addImages(lua_State* L) {
  * Is inverse to app.addImages
  *
  * @param type string "selection" or "layer"
+ * @param area? table {x:number, y:number, width:number, height:number, radius:number, layer:integer}
  * @return {x:number, y:number, width:number, height:number, data:string, format:string, imageWidth:number,
  * imageHeight:number}[] images
  *
  * Required argument: type ("selection" or "layer")
  *
+ * Optional argument: area, to only get the elements in a part of the page (see app.getStrokes)
+ *
  * Example: local images = app.getImages("selection")
  *
  * return value:
@@ -2865,9 +3328,14 @@ static int applib_getImages(lua_State* L) {
     Control* control = plugin->getControl();
 
     // Discard any extra arguments passed in
-    lua_settop(L, 1);
+    lua_settop(L, 2);
+
+    ElementFilter filter;
+    if (auto filterErr = getElementFilterHelper(L, 2, filter)) {
+        return luaL_error(L, filterErr->c_str());
+    }
 
-    const auto& [err, elements] = getElementsFromHelper(control, type);
+    const auto& [err, elements] = getElementsFromHelper(control, type, filter);
     if (err.has_value()) {
         return luaL_error(L, err.value().c_str());
     }
@@ -2941,10 +3409,14 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},  // Todo(gtk4) remo
                                   {"getSidebarPageNo", applib_getSidebarPageNo},
                                   {"setSidebarPageNo", applib_setSidebarPageNo},
                                   {"getDocumentStructure", applib_getDocumentStructure},
+                                  {"getDocumentRevision", applib_getDocumentRevision},
+                                  {"getPageRevisions", applib_getPageRevisions},
+                                  {"getPagesWithInk", applib_getPagesWithInk},
                                   {"scrollToPage", applib_scrollToPage},
                                   {"scrollToPos", applib_scrollToPos},
                                   {"setCurrentPage", applib_setCurrentPage},
                                   {"setPageSize", applib_setPageSize},
+                                  {"insertPages", applib_insertPages},
                                   {"setCurrentLayer", applib_setCurrentLayer},
                                   {"setLayerVisibility", applib_setLayerVisibility},
                                   {"setCurrentLayerName", applib_setCurrentLayerName},
@@ -2953,6 +3425,7 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},  // Todo(gtk4) remo
                                   {"getDisplayDpi", applib_getDisplayDpi},
                                   {"export", applib_export},
                                   {"addStrokes", applib_addStrokes},
+                                  {"addStrokesPacked", applib_addStrokesPacked},
                                   {"addSplines", applib_addSplines},
                                   {"addImages", applib_addImages},
                                   {"addTexts", applib_addTexts},
@@ -2960,6 +3433,7 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},  // Todo(gtk4) remo
                                   {"fileDialogOpen", applib_fileDialogOpen},
                                   {"refreshPage", applib_refreshPage},
                                   {"getStrokes", applib_getStrokes},
+                                  {"getStrokesPacked", applib_getStrokesPacked},
                                   {"getImages", applib_getImages},
                                   {"getTexts", applib_getTexts},
                                   {"openFile", applib_openFile},
@@ -9,6 +9,7 @@
 #include "model/Element.h"           // for Element, ELEMENT_IMAGE, ELEMENT_...
 #include "model/Layer.h"             // for Layer
 #include "model/XojPage.h"           // for XojPage
+#include "undo/PageLayerPosEntry.h"  // for insertEntries, removeEntries
 #include "undo/UndoAction.h"         // for UndoAction
 #include "util/i18n.h"               // for _
 
@@ -29,13 +30,9 @@ auto AddUndoAction::redo(Control* control) -> bool {
 
     Document* doc = control->getDocument();
     doc->lock();
-    for (const auto& elem: elements) {
-        elem.layer->insertElement(std::move(elem.elementOwn), elem.pos);
-    }
+    insertEntries(elements);
     doc->unlock();
-    for (const auto& elem: elements) {
-        this->page->fireElementChanged(elem.element);
-    }
+    this->page->fireElementsChanged(getEntryElements(elements));
 
     this->undone = true;
     return true;
@@ -51,13 +48,9 @@ auto AddUndoAction::undo(Control* control) -> bool {
 
     Document* doc = control->getDocument();
     doc->lock();
-    for (const auto& elem: elements) {
-        elem.elementOwn = elem.layer->removeElement(elem.element).e;
-    }
+    removeEntries(elements);
     doc->unlock();
-    for (const auto& elem: elements) {
-        this->page->fireElementChanged(elem.element);
-    }
+    this->page->fireElementsChanged(getEntryElements(elements));
     this->undone = false;
 
     return true;
@@ -0,0 +1,54 @@
+#include "AppendDocumentsUndoAction.h"
+
+#include <utility>  // for move
+
+#include "control/Control.h"        // for Control
+#include "control/ScrollHandler.h"  // for ScrollHandler
+#include "gui/XournalppCursor.h"    // for XournalppCursor
+#include "model/Document.h"         // for Document
+#include "util/i18n.h"              // for _
+
+AppendDocumentsUndoAction::AppendDocumentsUndoAction(std::vector<PageRef> pages, size_t first):
+        AppendDocumentsUndoAction("AppendDocumentsUndoAction", std::move(pages), first) {}
+
+AppendDocumentsUndoAction::AppendDocumentsUndoAction(const char* typeName, std::vector<PageRef> pages, size_t first):
+        UndoAction(typeName), pages(std::move(pages)), first(first) {}
+
+auto AppendDocumentsUndoAction::undo(Control* control) -> bool {
+    Document* doc = control->getDocument();
+    control->clearSelectionEndText();
+
+    doc->lock();
+    const bool inPlace = this->first + this->pages.size() <= doc->getPageCount() &&
+                         doc->getPage(this->first) == this->pages.front();
+    doc->unlock();
+    if (!inPlace) {
+        // this should not happen
+        return false;
+    }
+
+    // first send event, then delete pages...
+    control->firePagesDeleted(this->first, this->pages.size());
+    doc->lock();
+    doc->deletePages(this->first, this->pages.size());
+    doc->unlock();
+    return true;
+}
+
+auto AppendDocumentsUndoAction::redo(Control* control) -> bool {
+    Document* doc = control->getDocument();
+    control->clearSelectionEndText();
+
+    doc->lock();
+    doc->insertPages(this->pages.begin(), this->pages.end(), this->first);
+    doc->unlock();
+
+    control->firePagesInserted(this->first, this->pages.size());
+    control->getCursor()->updateCursor();
+    control->getScrollHandler()->scrollToPage(this->first);
+    return true;
+}
+
+auto AppendDocumentsUndoAction::getText() -> std::string { return _("Documents appended"); }
+
+auto AppendDocumentsUndoAction::getPages() -> std::vector<PageRef> { return this->pages; }
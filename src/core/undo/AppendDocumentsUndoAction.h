@@ -0,0 +1,44 @@
+/*
+ * Xournal++
+ *
+ * Undo action for documents appended
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "UndoAction.h"  // for UndoAction
+
+class Control;
+
+/**
+ * The pages of the documents appended (see DocumentMerger), removed and inserted again at once
+ */
+class AppendDocumentsUndoAction: public UndoAction {
+public:
+    AppendDocumentsUndoAction(std::vector<PageRef> pages, size_t first);
+
+public:
+    bool undo(Control* control) override;
+    bool redo(Control* control) override;
+
+    std::string getText() override;
+    std::vector<PageRef> getPages() override;
+
+protected:
+    AppendDocumentsUndoAction(const char* typeName, std::vector<PageRef> pages, size_t first);
+
+private:
+    std::vector<PageRef> pages;
+    size_t first;
+};
@@ -2,6 +2,7 @@
 
 #include <memory>  // for allocator, __shared_ptr_access, __share...
 #include <unordered_map>
+#include <vector>  // for vector
 
 #include "control/Control.h"
 #include "model/Document.h"
@@ -41,11 +42,14 @@ void ArrangeUndoAction::applyRearrange(Control* control) {
 
     std::unordered_map<Element*, ElementPtr> removedElements;
     removedElements.reserve(srcOrder.size());
+    std::vector<Element*> elements;
+    elements.reserve(srcOrder.size());
 
     Document* doc = control->getDocument();
     doc->lock();
     for (const auto& [e, _]: srcOrder) {
         removedElements.emplace(e, layer->removeElement(e).e);
+        elements.push_back(e);
     }
 
     for (const auto& [e, i]: tgtOrder) {
@@ -53,7 +57,8 @@ void ArrangeUndoAction::applyRearrange(Control* control) {
     }
     doc->unlock();
 
-    this->page->firePageChanged();
+    // Only the stacking order changed: the elements are still in their bounds
+    this->page->fireElementsChanged(elements);
 }
 
 std::string ArrangeUndoAction::getText() { return this->description; }
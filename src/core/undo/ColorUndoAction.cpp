@@ -13,84 +13,61 @@
 
 using xoj::util::Rectangle;
 
-class ColorUndoActionEntry {
-public:
-    ColorUndoActionEntry(Element* e, Color oldColor, Color newColor): e(e), oldColor(oldColor), newColor(newColor) {}
-    Element* e;
-    Color oldColor;
-    Color newColor;
-};
-
 ColorUndoAction::ColorUndoAction(const PageRef& page, Layer* layer): UndoAction("ColorUndoAction") {
     this->page = page;
     this->layer = layer;
 }
 
-ColorUndoAction::~ColorUndoAction() {
-    for (ColorUndoActionEntry* e: this->data) { delete e; }
+ColorUndoAction::~ColorUndoAction() = default;
+
+void ColorUndoAction::reserve(size_t n) {
+    this->elements.reserve(n);
+    this->originalColors.reserve(n);
+    this->newColors.reserve(n);
 }
 
 void ColorUndoAction::addStroke(Element* e, Color originalColor, Color newColor) {
-    this->data.push_back(new ColorUndoActionEntry(e, originalColor, newColor));
+    this->elements.push_back(e);
+    this->originalColors.push_back(originalColor);
+    this->newColors.push_back(newColor);
 }
 
-auto ColorUndoAction::undo(Control* control) -> bool {
-    if (this->data.empty()) {
-        return true;
+void ColorUndoAction::applyColors(Control* control, const std::vector<Color>& colors) {
+    if (this->elements.empty()) {
+        return;
     }
 
     Document* doc = control->getDocument();
     doc->lock();
-    ColorUndoActionEntry* e = this->data.front();
-    double x1 = e->e->getX();
-    double x2 = e->e->getX() + e->e->getElementWidth();
-    double y1 = e->e->getY();
-    double y2 = e->e->getY() + e->e->getElementHeight();
-
-    for (ColorUndoActionEntry* e: this->data) {
-        e->e->setColor(e->oldColor);
-
-        x1 = std::min(x1, e->e->getX());
-        x2 = std::max(x2, e->e->getX() + e->e->getElementWidth());
-        y1 = std::min(y1, e->e->getY());
-        y2 = std::max(y2, e->e->getY() + e->e->getElementHeight());
+    Element* first = this->elements.front();
+    double x1 = first->getX();
+    double x2 = first->getX() + first->getElementWidth();
+    double y1 = first->getY();
+    double y2 = first->getY() + first->getElementHeight();
+
+    for (size_t i = 0; i < this->elements.size(); i++) {
+        Element* e = this->elements[i];
+        e->setColor(colors[i]);
+
+        x1 = std::min(x1, e->getX());
+        x2 = std::max(x2, e->getX() + e->getElementWidth());
+        y1 = std::min(y1, e->getY());
+        y2 = std::max(y2, e->getY() + e->getElementHeight());
     }
 
     doc->unlock();
 
     Rectangle rect(x1, y1, x2 - x1, y2 - y1);
     this->page->fireRectChanged(rect);
+}
 
+auto ColorUndoAction::undo(Control* control) -> bool {
+    applyColors(control, this->originalColors);
     return true;
 }
 
 auto ColorUndoAction::redo(Control* control) -> bool {
-    if (this->data.empty()) {
-        return true;
-    }
-
-    Document* doc = control->getDocument();
-    doc->lock();
-    ColorUndoActionEntry* e = this->data.front();
-    double x1 = e->e->getX();
-    double x2 = e->e->getX() + e->e->getElementWidth();
-    double y1 = e->e->getY();
-    double y2 = e->e->getY() + e->e->getElementHeight();
-
-    for (ColorUndoActionEntry* e: this->data) {
-        e->e->setColor(e->newColor);
-
-        x1 = std::min(x1, e->e->getX());
-        x2 = std::max(x2, e->e->getX() + e->e->getElementWidth());
-        y1 = std::min(y1, e->e->getY());
-        y2 = std::max(y2, e->e->getY() + e->e->getElementHeight());
-    }
-
-    doc->unlock();
-
-    Rectangle rect(x1, y1, x2 - x1, y2 - y1);
-    this->page->fireRectChanged(rect);
-
+    applyColors(control, this->newColors);
     return true;
 }
 
@@ -11,15 +11,15 @@
 
 #pragma once
 
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "model/PageRef.h"  // for PageRef
 #include "util/Color.h"     // for Color
 
 #include "UndoAction.h"  // for UndoAction
 
-class ColorUndoActionEntry;
 class Element;
 class Layer;
 class Control;
@@ -34,9 +34,18 @@ public:
     bool redo(Control* control) override;
     std::string getText() override;
 
+    /// Reserve the entries for n elements
+    void reserve(size_t n);
     void addStroke(Element* e, Color originalColor, Color newColor);
 
 private:
-    std::vector<ColorUndoActionEntry*> data;
+    /// Set the colors of all the elements, then repaint them at once
+    void applyColors(Control* control, const std::vector<Color>& colors);
+
+private:
+    /// Parallel arrays, with one entry per element
+    std::vector<Element*> elements;
+    std::vector<Color> originalColors;
+    std::vector<Color> newColors;
     Layer* layer;
 };
@@ -0,0 +1,101 @@
+#include "CompactPageUndoAction.h"
+
+#include <algorithm>  // for max, min
+#include <utility>    // for move
+
+#include "control/Control.h"                // for Control
+#include "control/layer/LayerController.h"  // for LayerController
+#include "model/Document.h"                 // for Document
+#include "model/XojPage.h"                  // for XojPage
+#include "undo/UndoAction.h"                // for UndoAction
+#include "util/i18n.h"                      // for _
+
+CompactPageUndoAction::CompactPageUndoAction(const PageRef& page): UndoAction("CompactPageUndoAction") {
+    this->page = page;
+}
+
+CompactPageUndoAction::~CompactPageUndoAction() {
+    if (!this->undone) {
+        // The removed layers are not in the page
+        for (auto& [layer, index]: this->removedLayers) {
+            delete layer;
+        }
+    }
+}
+
+void CompactPageUndoAction::replaceElements(Layer* layer, InsertionOrderRef removed, InsertionOrder added) {
+    this->changes.push_back({layer, std::move(added), std::move(removed)});
+}
+
+void CompactPageUndoAction::removeLayer(Layer* layer) {
+    const auto& layers = *this->page->getLayers();
+    auto index = static_cast<Layer::Index>(std::find(layers.begin(), layers.end(), layer) - layers.begin());
+    this->removedLayers.emplace_back(layer, index);
+}
+
+void CompactPageUndoAction::swapElements() {
+    for (auto& c: this->changes) {
+        auto out = c.layer->removeElementsAt(c.inLayer);
+        c.inLayer = refInsertionOrder(c.stash);
+        c.layer->insertElements(std::move(c.stash));
+        c.stash = std::move(out);
+    }
+}
+
+void CompactPageUndoAction::apply() {
+    this->selectedLayer = this->page->getSelectedLayerId();
+    swapElements();
+    if (this->removedLayers.empty()) {
+        return;
+    }
+
+    Layer::Index selected = this->selectedLayer;
+    for (auto it = this->removedLayers.rbegin(); it != this->removedLayers.rend(); ++it) {
+        this->page->removeLayer(it->first);
+        if (it->second < this->selectedLayer) {
+            // The layer ids start at 1: the selected layer or one below it is removed
+            selected--;
+        }
+    }
+    if (this->selectedLayer > 0) {
+        selected = std::min(std::max<Layer::Index>(selected, 1), this->page->getLayerCount());
+    }
+    this->page->setSelectedLayerId(selected);
+}
+
+auto CompactPageUndoAction::undo(Control* control) -> bool {
+    Document* doc = control->getDocument();
+    doc->lock();
+    for (auto& [layer, index]: this->removedLayers) {
+        this->page->insertLayer(layer, index);
+    }
+    swapElements();
+    this->page->setSelectedLayerId(this->selectedLayer);
+    doc->unlock();
+
+    this->undone = true;
+    notify(control);
+    return true;
+}
+
+auto CompactPageUndoAction::redo(Control* control) -> bool {
+    Document* doc = control->getDocument();
+    doc->lock();
+    apply();
+    doc->unlock();
+
+    this->undone = false;
+    notify(control);
+    return true;
+}
+
+void CompactPageUndoAction::notify(Control* control) {
+    this->page->firePageChanged();
+    if (!this->removedLayers.empty()) {
+        control->getLayerController()->fireRebuildLayerMenu();
+    }
+}
+
+auto CompactPageUndoAction::removesLayers() const -> bool { return !this->removedLayers.empty(); }
+
+auto CompactPageUndoAction::getText() -> std::string { return _("Compact document"); }
@@ -0,0 +1,77 @@
+/*
+ * Xournal++
+ *
+ * Undo action for the compaction of a page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <string>   // for string
+#include <utility>  // for pair
+#include <vector>   // for vector
+
+#include "model/ElementInsertionPosition.h"  // for InsertionOrder, InsertionOrderRef
+#include "model/Layer.h"                     // for Layer, Layer::Index
+#include "model/PageRef.h"                   // for PageRef
+
+#include "UndoAction.h"  // for UndoAction
+
+class Control;
+
+/**
+ * @brief The elements of a page replaced by a compaction (see DocumentCompactor), and the empty layers it removed.
+ * Undoing and redoing swap the two versions of the elements, the layers are removed and inserted back.
+ */
+class CompactPageUndoAction: public UndoAction {
+public:
+    explicit CompactPageUndoAction(const PageRef& page);
+    ~CompactPageUndoAction() override;
+
+public:
+    /**
+     * Replace elements of a layer: `removed` are the elements of the layer at their current positions, `added` are
+     * the new elements at their positions once `removed` are gone. Applied by apply().
+     */
+    void replaceElements(Layer* layer, InsertionOrderRef removed, InsertionOrder added);
+
+    /**
+     * Remove this layer, once its elements are replaced. Applied by apply().
+     */
+    void removeLayer(Layer* layer);
+
+    /**
+     * Apply the changes recorded to the page, without notifying. The page must be locked.
+     */
+    void apply();
+
+    bool undo(Control* control) override;
+    bool redo(Control* control) override;
+
+    std::string getText() override;
+
+    bool removesLayers() const;
+
+private:
+    /// Exchange the elements of the layers with the stashed ones
+    void swapElements();
+    void notify(Control* control);
+
+    struct LayerChange {
+        Layer* layer;
+        /// The elements which are not in the layer (the removed ones after apply(), the added ones after undo)
+        InsertionOrder stash;
+        /// The elements of the layer which are in the stash of the other version
+        InsertionOrderRef inLayer;
+    };
+    std::vector<LayerChange> changes;
+
+    /// The layers removed, with their index in the page before the removal, in increasing order
+    std::vector<std::pair<Layer*, Layer::Index>> removedLayers;
+    /// The selected layer before the removal of the layers
+    Layer::Index selectedLayer = 0;
+};
@@ -8,7 +8,9 @@
 #include "model/Document.h"
 #include "model/Element.h"           // for Element, ELEMENT_IMAGE, ELEMENT_...
 #include "model/Layer.h"             // for Layer
+#include "model/Stroke.h"            // for Stroke
 #include "model/XojPage.h"           // for XojPage
+#include "undo/PageLayerPosEntry.h"  // for insertEntries, removeEntries
 #include "undo/UndoAction.h"         // for UndoAction
 #include "util/i18n.h"               // for _
 
@@ -31,13 +33,9 @@ auto DeleteUndoAction::undo(Control* control) -> bool {
 
     Document* doc = control->getDocument();
     doc->lock();
-    for (auto& elem: elements) {
-        elem.layer->insertElement(std::move(elem.elementOwn), elem.pos);
-    }
+    insertEntries(elements);
     doc->unlock();
-    for (const auto& elem: elements) {
-        this->page->fireElementChanged(elem.element);
-    }
+    this->page->fireElementsChanged(getEntryElements(elements));
 
     this->undone = true;
     return true;
@@ -53,13 +51,9 @@ auto DeleteUndoAction::redo(Control* control) -> bool {
 
     Document* doc = control->getDocument();
     doc->lock();
-    for (auto& elem: elements) {
-        elem.elementOwn = elem.layer->removeElement(elem.element).e;
-    }
+    removeEntries(elements);
     doc->unlock();
-    for (auto& elem: elements) {
-        this->page->fireElementChanged(elem.element);
-    }
+    this->page->fireElementsChanged(getEntryElements(elements));
 
     this->undone = false;
 
@@ -103,3 +97,31 @@ auto DeleteUndoAction::getText() -> std::string {
 
     return text;
 }
+
+template <typename Fun>
+void DeleteUndoAction::forOwnedStrokes(Fun f) const {
+    // The elements are only owned while the action is done, i.e. while they are not in the document
+    for (auto const& entry: elements) {
+        if (entry.elementOwn && entry.element->getType() == ELEMENT_STROKE) {
+            f(static_cast<Stroke*>(entry.element));
+        }
+    }
+}
+
+auto DeleteUndoAction::getSpillableSize() const -> size_t {
+    size_t size = 0;
+    forOwnedStrokes([&](Stroke* s) { size += s->getPointsMemorySize(); });
+    return size;
+}
+
+void DeleteUndoAction::writeSpillData(ObjectOutputStream& out) const {
+    forOwnedStrokes([&](Stroke* s) { s->writePoints(out); });
+}
+
+void DeleteUndoAction::dropSpillData() {
+    forOwnedStrokes([](Stroke* s) { s->dropPoints(); });
+}
+
+void DeleteUndoAction::readSpillData(ObjectInputStream& in) {
+    forOwnedStrokes([&](Stroke* s) { s->readPoints(in); });
+}
@@ -11,8 +11,9 @@
 
 #pragma once
 
-#include <set>     // for multiset
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <set>      // for multiset
+#include <string>   // for string
 
 #include "model/Element.h"  // for Element, Element::Index
 #include "model/PageRef.h"  // for PageRef
@@ -22,6 +23,8 @@
 
 class Control;
 class Layer;
+class ObjectInputStream;
+class ObjectOutputStream;
 
 class DeleteUndoAction: public UndoAction {
 public:
@@ -35,7 +38,18 @@ public:
 
     std::string getText() override;
 
+    size_t getSpillableSize() const override;
+    void writeSpillData(ObjectOutputStream& out) const override;
+    void dropSpillData() override;
+    void readSpillData(ObjectInputStream& in) override;
+
 private:
+    /**
+     * Call f on the strokes owned by the action
+     */
+    template <typename Fun>
+    void forOwnedStrokes(Fun f) const;
+
     // Todo (performance): replace by flat_multi_set / sorted_vector
     std::multiset<PageLayerPosEntry<Element>> elements{};
     bool eraser = true;
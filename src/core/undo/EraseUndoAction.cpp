@@ -1,16 +1,23 @@
 #include "EraseUndoAction.h"
 
-#include <memory>  // for __shared_ptr_access, __shar...
-#include <vector>  // for vector
+#include <algorithm>  // for copy, fill
+#include <iterator>   // for next
+#include <memory>     // for __shared_ptr_access, __shar...
+#include <vector>     // for vector
+
+#include <glib.h>  // for g_warning
 
 #include "control/Control.h"
 #include "model/Document.h"
-#include "model/Layer.h"                  // for Layer
-#include "model/Stroke.h"                 // for Stroke
-#include "model/XojPage.h"                // for XojPage
-#include "model/eraser/ErasableStroke.h"  // for ErasableStroke
-#include "undo/UndoAction.h"              // for UndoAction
-#include "util/i18n.h"                    // for _
+#include "model/Layer.h"                          // for Layer
+#include "model/Stroke.h"                         // for Stroke
+#include "model/XojPage.h"                        // for XojPage
+#include "model/eraser/ErasableStroke.h"          // for ErasableStroke
+#include "undo/UndoAction.h"                      // for UndoAction
+#include "util/i18n.h"                            // for _
+#include "util/safe_casts.h"                      // for as_signed
+#include "util/serializing/ObjectInputStream.h"   // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"  // for ObjectOutputStream
 
 
 EraseUndoAction::EraseUndoAction(const PageRef& page): UndoAction("EraseUndoAction") { this->page = page; }
@@ -43,10 +50,13 @@ void EraseUndoAction::finalize() {
             entry.elementOwn = std::move(own);
 
             ErasableStroke* e = entry.element->getErasable();
-            std::vector<std::unique_ptr<Stroke>> strokeList = e->getStrokes();
-            for (auto& stroke: strokeList) {
+            std::vector<ErasableStroke::IndexRanges> copiedPoints;
+            std::vector<std::unique_ptr<Stroke>> strokeList = e->getStrokes(&copiedPoints);
+            OriginalPoints& data = this->originalPoints[entry.element];
+            for (size_t i = 0; i < strokeList.size(); i++) {
                 // TODO (Marmare314): should use unique_ptr in layer
-                auto copy = std::move(stroke);
+                auto copy = std::move(strokeList[i]);
+                data.pieces.emplace_back(copy.get(), std::move(copiedPoints[i]));
                 this->addEdited(entry.layer, copy.get(), pos);
                 entry.layer->insertElement(std::move(copy), pos);
                 pos++;
@@ -55,6 +65,10 @@ void EraseUndoAction::finalize() {
             delete e;
             e = nullptr;
             entry.element->setErasable(nullptr);
+
+            // The points of the edited strokes are not kept twice
+            keepErasedPoints(*entry.element, data);
+            entry.element->dropPoints();
         }
     }
 
@@ -63,9 +77,91 @@ void EraseUndoAction::finalize() {
 
 auto EraseUndoAction::getText() -> std::string { return _("Erase stroke"); }
 
+void EraseUndoAction::keepErasedPoints(const Stroke& stroke, OriginalPoints& data) {
+    const auto& points = stroke.getPointVector();
+    std::vector<bool> copied(points.size(), false);
+    for (const auto& piece: data.pieces) {
+        for (auto [first, last]: piece.second) {
+            std::fill(std::next(copied.begin(), as_signed(first)), std::next(copied.begin(), as_signed(last)), true);
+        }
+    }
+
+    data.pointCount = points.size();
+    for (size_t i = 0; i < points.size();) {
+        if (copied[i]) {
+            i++;
+            continue;
+        }
+        size_t end = i;
+        while (end < points.size() && !copied[end]) {
+            end++;
+        }
+        data.erased.emplace_back(i, std::vector<Point>(std::next(points.begin(), as_signed(i)),
+                                                       std::next(points.begin(), as_signed(end))));
+        i = end;
+    }
+}
+
+auto EraseUndoAction::rebuildPoints(const OriginalPoints& data) -> std::optional<std::vector<Point>> {
+    std::vector<Point> points(data.pointCount);
+    for (const auto& [first, erased]: data.erased) {
+        if (first + erased.size() > points.size()) {
+            return std::nullopt;
+        }
+        std::copy(erased.begin(), erased.end(), std::next(points.begin(), as_signed(first)));
+    }
+    for (const auto& [piece, ranges]: data.pieces) {
+        const auto& piecePoints = piece->getPointVector();
+        size_t count = 0;
+        for (auto [first, last]: ranges) {
+            count += last - first;
+        }
+        if (piecePoints.size() != count + 2) {
+            return std::nullopt;
+        }
+        // Skip the interpolated first point
+        auto it = std::next(piecePoints.begin());
+        for (auto [first, last]: ranges) {
+            if (last > points.size()) {
+                return std::nullopt;
+            }
+            std::copy(it, std::next(it, as_signed(last - first)), std::next(points.begin(), as_signed(first)));
+            it += as_signed(last - first);
+        }
+    }
+    return points;
+}
+
+void EraseUndoAction::fireChanged() {
+    std::vector<Element*> elements;
+    elements.reserve(original.size() + edited.size());
+    for (auto const& entry: original) {
+        elements.push_back(entry.element);
+    }
+    for (auto const& entry: edited) {
+        elements.push_back(entry.element);
+    }
+    this->page->fireElementsChanged(elements);
+}
+
 auto EraseUndoAction::undo(Control* control) -> bool {
     Document* doc = control->getDocument();
     doc->lock();
+    // Rebuild all the original strokes before changing anything
+    std::vector<std::pair<Stroke*, std::vector<Point>>> rebuilt;
+    for (auto& [stroke, data]: this->originalPoints) {
+        auto points = rebuildPoints(data);
+        if (!points) {
+            doc->unlock();
+            g_warning("EraseUndoAction: the erased strokes could not be rebuilt");
+            return false;
+        }
+        rebuilt.emplace_back(stroke, std::move(*points));
+    }
+    for (auto& [stroke, points]: rebuilt) {
+        stroke->restorePoints(std::move(points));
+    }
+
     for (auto const& entry: edited) {
         entry.elementOwn = entry.layer->removeElement(entry.element).e;
     }
@@ -73,12 +169,7 @@ auto EraseUndoAction::undo(Control* control) -> bool {
         entry.layer->insertElement(std::move(entry.elementOwn), entry.pos);
     }
     doc->unlock();
-    for (auto const& entry: edited) {
-        this->page->fireElementChanged(entry.element);
-    }
-    for (auto const& entry: original) {
-        this->page->fireElementChanged(entry.element);
-    }
+    fireChanged();
 
     this->undone = true;
     return true;
@@ -93,14 +184,50 @@ auto EraseUndoAction::redo(Control* control) -> bool {
     for (auto const& entry: edited) {
         entry.layer->insertElement(std::move(entry.elementOwn), entry.pos);
     }
-    doc->unlock();
-    for (auto const& entry: original) {
-        this->page->fireElementChanged(entry.element);
-    }
-    for (auto const& entry: edited) {
-        this->page->fireElementChanged(entry.element);
+    // The bounds are kept for the repaint
+    for (auto& [stroke, data]: this->originalPoints) {
+        stroke->dropPoints();
     }
+    doc->unlock();
+    fireChanged();
 
     this->undone = false;
     return true;
 }
+
+// Only the points of the original strokes which are in none of the edited strokes are in memory while the action is
+// done
+
+auto EraseUndoAction::getSpillableSize() const -> size_t {
+    size_t size = 0;
+    for (const auto& [stroke, data]: this->originalPoints) {
+        for (const auto& erased: data.erased) {
+            size += erased.second.size() * sizeof(Point);
+        }
+    }
+    return size;
+}
+
+void EraseUndoAction::writeSpillData(ObjectOutputStream& out) const {
+    for (const auto& [stroke, data]: this->originalPoints) {
+        for (const auto& erased: data.erased) {
+            out.writeData(erased.second);
+        }
+    }
+}
+
+void EraseUndoAction::dropSpillData() {
+    for (auto& [stroke, data]: this->originalPoints) {
+        for (auto& erased: data.erased) {
+            std::vector<Point>().swap(erased.second);
+        }
+    }
+}
+
+void EraseUndoAction::readSpillData(ObjectInputStream& in) {
+    for (auto& [stroke, data]: this->originalPoints) {
+        for (auto& erased: data.erased) {
+            in.readData(erased.second);
+        }
+    }
+}
@@ -11,17 +11,26 @@
 
 #pragma once
 
-#include <set>     // for multiset
-#include <string>  // for string
+#include <cstddef>   // for size_t
+#include <map>       // for map
+#include <optional>  // for optional
+#include <set>       // for multiset
+#include <string>    // for string
+#include <utility>   // for pair
+#include <vector>    // for vector
 
-#include "model/PageRef.h"  // for PageRef
-#include "model/Stroke.h"   // for Stroke
+#include "model/PageRef.h"                // for PageRef
+#include "model/Point.h"                  // for Point
+#include "model/Stroke.h"                 // for Stroke
+#include "model/eraser/ErasableStroke.h"  // for ErasableStroke::IndexRanges
 
 #include "PageLayerPosEntry.h"  // for PageLayerPosEntry
 #include "UndoAction.h"         // for UndoAction
 
 class Control;
 class Layer;
+class ObjectInputStream;
+class ObjectOutputStream;
 
 class EraseUndoAction: public UndoAction {
 public:
@@ -39,7 +48,39 @@ public:
 
     std::string getText() override;
 
+    size_t getSpillableSize() const override;
+    void writeSpillData(ObjectOutputStream& out) const override;
+    void dropSpillData() override;
+    void readSpillData(ObjectInputStream& in) override;
+
+private:
+    /**
+     * The points of an original stroke while the action is done. Only the points which are not in the edited strokes
+     * are kept, the others are read back from the edited strokes on undo: the undo history ensures that they are then
+     * as the erasure left them.
+     */
+    struct OriginalPoints {
+        size_t pointCount = 0;
+
+        /// The edited strokes made from the original one, with the indices of the original points they hold
+        std::vector<std::pair<Stroke*, ErasableStroke::IndexRanges>> pieces;
+
+        /// The points which are in none of the edited strokes, by index of their first point
+        std::vector<std::pair<size_t, std::vector<Point>>> erased;
+    };
+
+    /**
+     * Repaint the original and the edited strokes at once
+     */
+    void fireChanged();
+
+    static void keepErasedPoints(const Stroke& stroke, OriginalPoints& data);
+    static std::optional<std::vector<Point>> rebuildPoints(const OriginalPoints& data);
+
 private:
     std::multiset<PageLayerPosEntry<Stroke>> edited{};
     std::multiset<PageLayerPosEntry<Stroke>> original{};
+
+    /// The points of the original strokes, see finalize()
+    std::map<Stroke*, OriginalPoints> originalPoints;
 };
@@ -3,9 +3,9 @@
 #include <algorithm>  // for none_of
 #include <utility>    // for move
 
-#include "undo/UndoAction.h"  // for UndoAction
-
-class Control;
+#include "control/Control.h"       // for Control
+#include "model/DocumentHandler.h"  // for PageChangesGuard
+#include "undo/UndoAction.h"        // for UndoAction
 
 GroupUndoAction::GroupUndoAction(): UndoAction("GroupUndoAction") {}
 
@@ -30,6 +30,8 @@ auto GroupUndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto GroupUndoAction::redo(Control* control) -> bool {
+    // The listeners are notified once for all the pages changed by the actions
+    PageChangesGuard guard(control);
     bool result = true;
     for (auto& action: actions) { result = result && action->redo(control); }
 
@@ -37,6 +39,7 @@ auto GroupUndoAction::redo(Control* control) -> bool {
 }
 
 auto GroupUndoAction::undo(Control* control) -> bool {
+    PageChangesGuard guard(control);
     bool result = true;
     for (auto& action: actions) { result = result && action->undo(control); }
 
@@ -50,3 +53,21 @@ auto GroupUndoAction::getText() -> std::string {
 
     return actions[0]->getText();
 }
+
+auto GroupUndoAction::getSpillableSize() const -> size_t {
+    size_t size = 0;
+    for (auto& action: actions) { size += action->getSpillableSize(); }
+    return size;
+}
+
+void GroupUndoAction::writeSpillData(ObjectOutputStream& out) const {
+    for (auto& action: actions) { action->writeSpillData(out); }
+}
+
+void GroupUndoAction::dropSpillData() {
+    for (auto& action: actions) { action->dropSpillData(); }
+}
+
+void GroupUndoAction::readSpillData(ObjectInputStream& in) {
+    for (auto& action: actions) { action->readSpillData(in); }
+}
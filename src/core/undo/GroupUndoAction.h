@@ -11,15 +11,18 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
 #include "UndoAction.h"  // for UndoAction
 
 class Control;
+class ObjectInputStream;
+class ObjectOutputStream;
 
 
 class GroupUndoAction: public UndoAction {
@@ -39,6 +42,11 @@ public:
 
     std::string getText() override;
 
+    size_t getSpillableSize() const override;
+    void writeSpillData(ObjectOutputStream& out) const override;
+    void dropSpillData() override;
+    void readSpillData(ObjectInputStream& in) override;
+
 private:
     std::vector<std::unique_ptr<UndoAction>> actions;
 };
@@ -0,0 +1,10 @@
+#include "InsertPagesUndoAction.h"
+
+#include <utility>  // for move
+
+#include "util/i18n.h"  // for _
+
+InsertPagesUndoAction::InsertPagesUndoAction(std::vector<PageRef> pages, size_t first):
+        AppendDocumentsUndoAction("InsertPagesUndoAction", std::move(pages), first) {}
+
+auto InsertPagesUndoAction::getText() -> std::string { return _("Pages inserted"); }
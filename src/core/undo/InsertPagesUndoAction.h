@@ -0,0 +1,31 @@
+/*
+ * Xournal++
+ *
+ * Undo action for several new pages inserted at once
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for string
+#include <vector>   // for vector
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "AppendDocumentsUndoAction.h"  // for AppendDocumentsUndoAction
+
+/**
+ * The consecutive pages inserted by Control::insertPages(), removed and inserted again at once
+ */
+class InsertPagesUndoAction: public AppendDocumentsUndoAction {
+public:
+    InsertPagesUndoAction(std::vector<PageRef> pages, size_t first);
+
+public:
+    std::string getText() override;
+};
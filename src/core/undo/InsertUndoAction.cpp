@@ -5,12 +5,13 @@
 
 #include "control/Control.h"
 #include "model/Document.h"
-#include "model/Element.h"    // for Element, ELEMENT_IMAGE, ELEMENT_STROKE
-#include "model/Layer.h"      // for Layer
-#include "model/PageRef.h"    // for PageRef
-#include "model/XojPage.h"    // for XojPage
-#include "undo/UndoAction.h"  // for UndoAction
-#include "util/i18n.h"        // for _
+#include "model/Element.h"                   // for Element, ELEMENT_IMAGE, ELEMENT_STROKE
+#include "model/ElementInsertionPosition.h"  // for InsertionOrderRef
+#include "model/Layer.h"                     // for Layer
+#include "model/PageRef.h"                   // for PageRef
+#include "model/XojPage.h"                   // for XojPage
+#include "undo/UndoAction.h"                 // for UndoAction
+#include "util/i18n.h"                       // for _
 
 InsertUndoAction::InsertUndoAction(const PageRef& page, Layer* layer, Element* element):
         UndoAction("InsertUndoAction"), layer(layer), element(element), elementOwn(nullptr) {
@@ -74,13 +75,16 @@ auto InsertsUndoAction::undo(Control* control) -> bool {
 
     Document* doc = control->getDocument();
     doc->lock();
+    InsertionOrderRef refs;
+    refs.reserve(this->elements.size());
     for (Element* elem: this->elements) {
-        this->elementsOwn.emplace_back(this->layer->removeElement(elem).e);
+        refs.emplace_back(elem);
     }
-    doc->unlock();
-    for (Element* elem: this->elements) {
-        this->page->fireElementChanged(elem);
+    for (auto&& [e, pos]: this->layer->removeElementsAt(refs)) {
+        this->elementsOwn.emplace_back(std::move(e));
     }
+    doc->unlock();
+    this->page->fireElementsChanged(this->elements);
 
     this->undone = true;
 
@@ -94,10 +98,7 @@ auto InsertsUndoAction::redo(Control* control) -> bool {
         this->layer->addElement(std::move(elem));
     }
     doc->unlock();
-    for (auto&& elem: this->elementsOwn) {
-        auto ptr = elem.get();
-        this->page->fireElementChanged(ptr);
-    }
+    this->page->fireElementsChanged(this->elements);
     this->elementsOwn = std::vector<ElementPtr>(0);
 
     this->undone = false;
@@ -91,7 +91,7 @@ void MergeLayerDownUndoAction::triggerUIUpdate(Control* control) {
      *     When this implementation is called by the `UndoRedoHandler` the
      *     document is locked. Calling `layerChanged` adds a render job which
      *     can only be processed when the document is unlocked again, but might
-     *     have already claimed `Scheduler::jobRunningMutex`.
+     *     have already claimed a `Scheduler` worker's `jobRunningMutex`.
      *     `fireRebuildLayerMenu` will wait for `jobRunningMutex` to be free,
      *     so calling `fireRebuildLayerMenu` AFTER `layerChanged` will likely
      *     result in a DEADLOCK.
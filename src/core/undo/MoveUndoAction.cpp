@@ -10,6 +10,7 @@
 #include "model/PageRef.h"    // for PageRef
 #include "model/XojPage.h"    // for XojPage
 #include "undo/UndoAction.h"  // for UndoAction
+#include "util/Range.h"       // for Range
 #include "util/i18n.h"        // for _
 
 MoveUndoAction::MoveUndoAction(Layer* sourceLayer, const PageRef& sourcePage, std::vector<Element*> selected, double mx,
@@ -45,10 +46,12 @@ auto MoveUndoAction::undo(Control* control) -> bool {
         switchLayer(&this->elements, this->targetLayer, this->sourceLayer);
     }
 
+    Range before = getBounds();
     move();
+    Range after = getBounds();
     doc->unlock();
-    repaint();
     this->undone = true;
+    repaint(before, after);
 
     return true;
 }
@@ -60,10 +63,12 @@ auto MoveUndoAction::redo(Control* control) -> bool {
         switchLayer(&this->elements, this->sourceLayer, this->targetLayer);
     }
 
+    Range before = getBounds();
     move();
+    Range after = getBounds();
     doc->unlock();
-    repaint();
     this->undone = false;
+    repaint(before, after);
 
     return true;
 }
@@ -74,16 +79,25 @@ void MoveUndoAction::switchLayer(std::vector<Element*>* entries, Layer* oldLayer
     }
 }
 
-void MoveUndoAction::repaint() {
+auto MoveUndoAction::getBounds() const -> Range {
+    Range range;
+    for (Element* e: this->elements) {
+        range = range.unite(Range(e->boundingRect()));
+    }
+    return range;
+}
+
+void MoveUndoAction::repaint(Range& before, Range& after) {
     if (this->elements.empty()) {
         return;
     }
 
-    this->page->firePageChanged();
-
-    if (this->targetPage) {
-        this->targetPage->firePageChanged();
-    }
+    // The elements are on the target page while the action is done
+    const PageRef& donePage = this->targetPage ? this->targetPage : this->page;
+    const PageRef& beforePage = this->undone ? donePage : this->page;
+    const PageRef& afterPage = this->undone ? this->page : donePage;
+    beforePage->fireRangeChanged(before);
+    afterPage->fireRangeChanged(after);
 }
 
 auto MoveUndoAction::getPages() -> std::vector<PageRef> {
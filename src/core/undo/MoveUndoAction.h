@@ -15,6 +15,7 @@
 #include <vector>  // for vector
 
 #include "model/PageRef.h"  // for PageRef
+#include "util/Range.h"     // for Range
 
 #include "UndoAction.h"  // for UndoAction
 
@@ -36,9 +37,17 @@ public:
 
 private:
     void switchLayer(std::vector<Element*>* entries, Layer* oldLayer, Layer* newLayer);
-    void repaint();
+    /**
+     * Repaint the bounds of the elements before they were moved and after, on their respective pages
+     */
+    void repaint(Range& before, Range& after);
     void move();
 
+    /**
+     * @return The bounds of the elements
+     */
+    Range getBounds() const;
+
 private:
     std::vector<Element*> elements;
     PageRef targetPage;
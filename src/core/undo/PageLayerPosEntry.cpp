@@ -0,0 +1,46 @@
+#include "PageLayerPosEntry.h"
+
+#include <unordered_map>  // for unordered_map
+
+#include "model/ElementInsertionPosition.h"  // for InsertionOrder, InsertionOrderRef
+#include "model/Layer.h"                     // for Layer
+
+void insertEntries(const std::multiset<PageLayerPosEntry<Element>>& entries) {
+    // The entries are sorted by position, and so are the batches
+    std::unordered_map<Layer*, InsertionOrder> batches;
+    for (const auto& entry: entries) {
+        batches[entry.layer].emplace_back(std::move(entry.elementOwn), entry.pos);
+    }
+    for (auto&& [layer, batch]: batches) {
+        layer->insertElements(std::move(batch));
+    }
+}
+
+void removeEntries(const std::multiset<PageLayerPosEntry<Element>>& entries) {
+    std::unordered_map<Layer*, InsertionOrderRef> batches;
+    for (const auto& entry: entries) {
+        batches[entry.layer].emplace_back(entry.element, entry.pos);
+    }
+
+    std::unordered_map<const Element*, ElementPtr> removed;
+    removed.reserve(entries.size());
+    for (auto&& [layer, batch]: batches) {
+        for (auto&& [e, pos]: layer->removeElementsAt(batch)) {
+            removed.emplace(e.get(), std::move(e));
+        }
+    }
+    for (const auto& entry: entries) {
+        if (auto it = removed.find(entry.element); it != removed.end()) {
+            entry.elementOwn = std::move(it->second);
+        }
+    }
+}
+
+auto getEntryElements(const std::multiset<PageLayerPosEntry<Element>>& entries) -> std::vector<Element*> {
+    std::vector<Element*> elements;
+    elements.reserve(entries.size());
+    for (const auto& entry: entries) {
+        elements.push_back(entry.element);
+    }
+    return elements;
+}
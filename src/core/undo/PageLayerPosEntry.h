@@ -12,7 +12,9 @@
 #pragma once
 
 #include <memory>
+#include <set>
 #include <utility>
+#include <vector>
 
 #include "model/Element.h"
 
@@ -41,3 +43,17 @@ template <typename T>
 constexpr auto operator<(const PageLayerPosEntry<T>& lhs, const PageLayerPosEntry<T>& rhs) -> bool {
     return lhs.pos < rhs.pos;
 }
+
+/**
+ * Inserts the elements owned by the entries back into their layers, with one batch per layer.
+ * The page listeners are not notified.
+ */
+void insertEntries(const std::multiset<PageLayerPosEntry<Element>>& entries);
+
+/**
+ * Removes the elements of the entries from their layers, with one batch per layer. The entries take their ownership.
+ * The page listeners are not notified.
+ */
+void removeEntries(const std::multiset<PageLayerPosEntry<Element>>& entries);
+
+auto getEntryElements(const std::multiset<PageLayerPosEntry<Element>>& entries) -> std::vector<Element*>;
@@ -2,6 +2,13 @@
 
 #include <utility>  // for move
 
+#include <glib.h>  // for g_warning
+
+#include "util/serializing/BinObjectEncoding.h"     // for BinObjectEncoding
+#include "util/serializing/InputStreamException.h"  // for InputStreamException
+#include "util/serializing/ObjectInputStream.h"     // for ObjectInputStream
+#include "util/serializing/ObjectOutputStream.h"    // for ObjectOutputStream
+
 UndoAction::UndoAction(std::string className): className(std::move(className)) {}
 
 auto UndoAction::getPages() -> std::vector<PageRef> {
@@ -11,3 +18,49 @@ auto UndoAction::getPages() -> std::vector<PageRef> {
 }
 
 auto UndoAction::getClassName() const -> std::string const& { return this->className; }
+
+auto UndoAction::spill(UndoSpillFile& file) -> bool {
+    if (this->spilledData || getSpillableSize() == 0) {
+        return false;
+    }
+
+    ObjectOutputStream out(new BinObjectEncoding());
+    writeSpillData(out);
+    GString* data = out.getStr();
+    this->spilledData = file.write(data->str, data->len);
+    g_string_free(data, true);
+
+    if (!this->spilledData) {
+        return false;
+    }
+    dropSpillData();
+    return true;
+}
+
+void UndoAction::restore(UndoSpillFile& file) {
+    if (!this->spilledData) {
+        return;
+    }
+
+    std::string data;
+    ObjectInputStream in;
+    try {
+        if (!file.read(*this->spilledData, data) || !in.read(data.data(), data.size())) {
+            throw InputStreamException("Could not read the undo file", __FILE__, __LINE__);
+        }
+        readSpillData(in);
+    } catch (const InputStreamException& e) {
+        g_warning("Could not restore the data of the undo action %s: %s", this->className.c_str(), e.what());
+    }
+    this->spilledData.reset();
+}
+
+auto UndoAction::isSpilled() const -> bool { return this->spilledData.has_value(); }
+
+auto UndoAction::getSpillableSize() const -> size_t { return 0; }
+
+void UndoAction::writeSpillData(ObjectOutputStream&) const {}
+
+void UndoAction::dropSpillData() {}
+
+void UndoAction::readSpillData(ObjectInputStream&) {}
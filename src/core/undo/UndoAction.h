@@ -11,13 +11,19 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>   // for size_t
+#include <memory>    // for unique_ptr
+#include <optional>  // for optional
+#include <string>    // for string
+#include <vector>    // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
+#include "UndoSpillFile.h"  // for UndoSpillFile
+
 class Control;
+class ObjectInputStream;
+class ObjectOutputStream;
 
 class UndoAction {
 public:
@@ -37,11 +43,41 @@ public:
 
     auto getClassName() const -> std::string const&;
 
+    /**
+     * Write the bulky data of the action (e.g. the points of the strokes it owns) to the file, and free it.
+     * Only called on the actions of the undo list: the data is not part of the document.
+     * @return true if memory was freed
+     */
+    bool spill(UndoSpillFile& file);
+
+    /**
+     * Read back the data written by spill(), before undoing the action
+     */
+    void restore(UndoSpillFile& file);
+
+    bool isSpilled() const;
+
+    /**
+     * @return The memory (in bytes) which spill() would free
+     */
+    virtual size_t getSpillableSize() const;
+
+    /**
+     * The hooks of spill() and restore(): the data is written, dropped once it is stored, and read back in the same
+     * order. Nothing is spilled by default.
+     */
+    virtual void writeSpillData(ObjectOutputStream& out) const;
+    virtual void dropSpillData();
+    virtual void readSpillData(ObjectInputStream& in);
+
 protected:
     // This is only for debugging / Testing purpose
     std::string className;
     PageRef page;
     bool undone = false;
+
+private:
+    std::optional<UndoSpillFile::Blob> spilledData;
 };
 
 using UndoActionPtr = std::unique_ptr<UndoAction>;
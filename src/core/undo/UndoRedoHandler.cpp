@@ -1,11 +1,12 @@
 #include "UndoRedoHandler.h"
 
-#include <algorithm>  // for find_if
-#include <cinttypes>  // for PRIu64
-#include <cstdint>    // for uint64_t
-#include <iterator>   // for end, begin
-#include <memory>     // for unique_ptr, allocator_traits<>::value_type
-#include <utility>    // for move
+#include <algorithm>         // for find_if
+#include <cinttypes>         // for PRIu64
+#include <cstdint>           // for uint64_t
+#include <initializer_list>  // for initializer_list
+#include <iterator>          // for end, begin, next
+#include <memory>            // for unique_ptr, allocator_traits<>::value_type
+#include <utility>           // for move
 
 #include <glib.h>  // for g_message
 
@@ -78,6 +79,7 @@ void UndoRedoHandler::clearContents() {
 
     undoList.clear();
     clearRedo();
+    this->spillFile.reset();
 
     this->savedUndo = nullptr;
     this->autosavedUndo = nullptr;
@@ -106,6 +108,10 @@ void UndoRedoHandler::undo() {
     this->redoList.emplace_back(std::move(this->undoList.back()));
     this->undoList.pop_back();
 
+    if (undoAction.isSpilled()) {
+        undoAction.restore(*this->spillFile);
+    }
+
     bool undoResult = undoAction.undo(this->control);
 
     if (!undoResult) {
@@ -146,6 +152,49 @@ void UndoRedoHandler::redo() {
     printContents();
 }
 
+void UndoRedoHandler::setMemoryBudget(size_t budget) {
+    this->memoryBudget = budget;
+    enforceMemoryBudget();
+}
+
+void UndoRedoHandler::enforceMemoryBudget() {
+    if (this->undoList.size() < 2) {
+        return;
+    }
+
+    // The spilled actions are the oldest ones: the actions are read back when undone, and redone on top of the list
+    size_t used = this->undoList.back()->getSpillableSize();
+    for (auto it = std::next(this->undoList.rbegin()); it != this->undoList.rend() && !(*it)->isSpilled(); ++it) {
+        size_t size = (*it)->getSpillableSize();
+        if (used + size <= this->memoryBudget) {
+            used += size;
+            continue;
+        }
+        if (!this->spillFile) {
+            this->spillFile = std::make_unique<UndoSpillFile>();
+        }
+        if (!(*it)->spill(*this->spillFile)) {
+            used += size;
+        }
+    }
+}
+
+auto UndoRedoHandler::getMemoryUsage() const -> size_t {
+    size_t used = 0;
+    for (const auto* list: {&this->undoList, &this->redoList}) {
+        for (const auto& action: *list) {
+            if (!action->isSpilled()) {
+                used += action->getSpillableSize();
+            }
+        }
+    }
+    return used;
+}
+
+auto UndoRedoHandler::getSpilledSize() const -> size_t {
+    return this->spillFile ? static_cast<size_t>(this->spillFile->getSize()) : 0;
+}
+
 auto UndoRedoHandler::canUndo() -> bool { return !this->undoList.empty(); }
 
 auto UndoRedoHandler::canRedo() -> bool { return !this->redoList.empty(); }
@@ -160,6 +209,7 @@ void UndoRedoHandler::addUndoAction(UndoActionPtr action) {
 
     this->undoList.emplace_back(std::move(action));
     clearRedo();
+    enforceMemoryBudget();
     fireUpdateUndoRedoButtons(this->undoList.back()->getPages());
 
     printContents();
@@ -201,6 +251,20 @@ void UndoRedoHandler::fireUpdateUndoRedoButtons(const std::vector<PageRef>& page
     }
 }
 
+auto UndoRedoHandler::getReferencedPages() const -> std::vector<PageRef> {
+    std::vector<PageRef> pages;
+    for (const auto* list: {&this->undoList, &this->redoList}) {
+        for (auto&& action: *list) {
+            for (auto&& page: action->getPages()) {
+                if (page) {
+                    pages.emplace_back(std::move(page));
+                }
+            }
+        }
+    }
+    return pages;
+}
+
 void UndoRedoHandler::addUndoRedoListener(UndoRedoListener* listener) { this->listener.emplace_back(listener); }
 
 auto UndoRedoHandler::isChanged() -> bool {
@@ -222,6 +286,10 @@ void UndoRedoHandler::documentAutosaved() {
     this->autosavedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
 }
 
-void UndoRedoHandler::documentSaved() {
-    this->savedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
+void UndoRedoHandler::documentSaved() { this->savedUndo = getLastAction(); }
+
+void UndoRedoHandler::documentSaved(UndoAction* lastAction) { this->savedUndo = lastAction; }
+
+auto UndoRedoHandler::getLastAction() const -> UndoAction* {
+    return this->undoList.empty() ? nullptr : this->undoList.back().get();
 }
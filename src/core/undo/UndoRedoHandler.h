@@ -11,13 +11,16 @@
 
 #pragma once
 
-#include <deque>   // for deque
-#include <string>  // for string
-#include <vector>  // for vector
+#include <cstddef>  // for size_t
+#include <deque>    // for deque
+#include <memory>   // for unique_ptr
+#include <string>   // for string
+#include <vector>   // for vector
 
 #include "model/PageRef.h"  // for PageRef
 
-#include "UndoAction.h"  // for UndoActionPtr
+#include "UndoAction.h"     // for UndoActionPtr
+#include "UndoSpillFile.h"  // for UndoSpillFile
 
 class Control;
 
@@ -48,17 +51,52 @@ public:
     void clearContents();
 
     void fireUpdateUndoRedoButtons(const std::vector<PageRef>& pages);
+
+    /**
+     * @return The pages the undo and redo actions refer to, possibly with duplicates
+     */
+    std::vector<PageRef> getReferencedPages() const;
     void addUndoRedoListener(UndoRedoListener* listener);
 
     bool isChanged();
     bool isChangedAutosave();
     void documentAutosaved();
     void documentSaved();
+    /**
+     * Mark the document as saved in the state it had when lastAction was the last action, see getLastAction().
+     * For the documents which are written while they can still be modified.
+     */
+    void documentSaved(UndoAction* lastAction);
+    UndoAction* getLastAction() const;
+
+    /**
+     * Set the memory (in bytes) the undo actions may use: the data of the older ones is written to a temporary file,
+     * and read back when they are undone. The undo history is as deep as without a limit.
+     */
+    void setMemoryBudget(size_t budget);
+
+    /// The default memory budget
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 128 * 1024 * 1024;
+
+    /**
+     * @return The memory (in bytes) used by the data of the undo and redo actions which may be spilled
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @return The size (in bytes) of the temporary file of the spilled data
+     */
+    size_t getSpilledSize() const;
 
 private:
     void clearRedo();
     void printContents();
 
+    /**
+     * Spill the data of the oldest undo actions over the memory budget. The last action is always kept in memory.
+     */
+    void enforceMemoryBudget();
+
 private:
     std::deque<UndoActionPtr> undoList;
     std::deque<UndoActionPtr> redoList;
@@ -68,5 +106,10 @@ private:
 
     std::vector<UndoRedoListener*> listener;
 
+    size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+
+    /// Created when the first action is spilled
+    std::unique_ptr<UndoSpillFile> spillFile;
+
     Control* control = nullptr;
 };
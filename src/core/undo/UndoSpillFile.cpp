@@ -0,0 +1,53 @@
+#include "UndoSpillFile.h"
+
+#include <atomic>        // for atomic
+#include <system_error>  // for error_code
+
+#include <glib.h>  // for g_warning
+
+#include "util/PathUtil.h"  // for getTmpDirSubfolder
+
+UndoSpillFile::UndoSpillFile() {
+    static std::atomic<unsigned> counter = 0;
+    this->path = Util::getTmpDirSubfolder("undo") / (std::to_string(counter++) + ".bin");
+    this->stream.open(this->path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!this->stream.is_open()) {
+        g_warning("Could not create the undo file %s", this->path.u8string().c_str());
+    }
+}
+
+UndoSpillFile::~UndoSpillFile() {
+    this->stream.close();
+    std::error_code ec;
+    fs::remove(this->path, ec);
+}
+
+auto UndoSpillFile::write(const char* data, size_t length) -> std::optional<Blob> {
+    if (!this->stream.is_open()) {
+        return std::nullopt;
+    }
+    this->stream.clear();
+    this->stream.seekp(static_cast<std::streamoff>(this->size));
+    this->stream.write(data, static_cast<std::streamsize>(length));
+    this->stream.flush();
+    if (!this->stream.good()) {
+        g_warning("Could not write to the undo file %s", this->path.u8string().c_str());
+        return std::nullopt;
+    }
+    Blob blob{this->size, length};
+    this->size += length;
+    return blob;
+}
+
+auto UndoSpillFile::read(const Blob& blob, std::string& data) -> bool {
+    if (!this->stream.is_open() || blob.offset + blob.length > this->size) {
+        return false;
+    }
+    data.resize(blob.length);
+    this->stream.clear();
+    this->stream.seekg(static_cast<std::streamoff>(blob.offset));
+    this->stream.read(data.data(), static_cast<std::streamsize>(blob.length));
+    return this->stream.gcount() == static_cast<std::streamsize>(blob.length);
+}
+
+auto UndoSpillFile::getSize() const -> uint64_t { return this->size; }
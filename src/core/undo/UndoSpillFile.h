@@ -0,0 +1,60 @@
+/*
+ * Xournal++
+ *
+ * Temporary file holding the data of the old undo actions
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>   // for size_t
+#include <cstdint>   // for uint64_t
+#include <fstream>   // for fstream
+#include <optional>  // for optional
+#include <string>    // for string
+
+#include "filesystem.h"  // for path
+
+/**
+ * @brief A temporary file to which the undo actions spill their data (see UndoAction::spill), to cap the memory used
+ * by the undo history without limiting its depth.
+ *
+ * The data is only ever appended: the space of the restored data is given back when the file is removed, i.e. when
+ * the undo history is cleared.
+ */
+class UndoSpillFile {
+public:
+    /// The position of some data in the file
+    struct Blob {
+        uint64_t offset = 0;
+        size_t length = 0;
+    };
+
+    UndoSpillFile();
+    ~UndoSpillFile();
+
+    UndoSpillFile(const UndoSpillFile&) = delete;
+    UndoSpillFile& operator=(const UndoSpillFile&) = delete;
+
+    /**
+     * @return The position of the data, or nothing if it could not be written
+     */
+    std::optional<Blob> write(const char* data, size_t length);
+
+    /**
+     * @return false if the data could not be read
+     */
+    bool read(const Blob& blob, std::string& data);
+
+    /// The size of the file, in bytes
+    uint64_t getSize() const;
+
+private:
+    fs::path path;
+    std::fstream stream;
+    uint64_t size = 0;
+};
@@ -1,12 +1,14 @@
 #include "DocumentView.h"
 
-#include <memory>  // for __shared_ptr_access, uni...
-#include <vector>  // for vector
+#include <memory>   // for __shared_ptr_access, uni...
+#include <utility>  // for move
+#include <vector>   // for vector
 
 #include <glib.h>  // for g_message
 
 #include "model/Layer.h"                     // for Layer
 #include "model/XojPage.h"                   // for XojPage
+#include "util/raii/CairoWrappers.h"         // for CairoSaveGuard
 #include "view/DebugShowRepaintBounds.h"     // for IF_DEBUG_REPAINT
 #include "view/View.h"                       // for EditionTreatment, NORMAL...
 #include "view/background/BackgroundView.h"  // for BackgroundFlags, Backgro...
@@ -18,8 +20,16 @@
  */
 void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStroke = markAudioStroke; }
 
+void DocumentView::setDraftQuality(bool draftQuality) { this->draftQuality = draftQuality; }
+
 void DocumentView::setPdfCache(PdfCache* cache) { pdfCache = cache; }
 
+void DocumentView::setCancellationCheck(std::function<bool()> isCancelled) {
+    this->isCancelled = std::move(isCancelled);
+}
+
+auto DocumentView::wasCancelled() const -> bool { return this->cancelled; }
+
 /**
  * Drawing first step
  * @param page The page to draw
@@ -66,16 +76,40 @@ void DocumentView::drawBackground(xoj::view::BackgroundFlags bgFlags) const {
 }
 
 void DocumentView::drawPage(PageRef page, cairo_t* cr, bool dontRenderEditingStroke, xoj::view::BackgroundFlags flags) {
+    drawLayerRange(page, cr, dontRenderEditingStroke, true, 0, page->getLayerCount(), flags);
+}
+
+void DocumentView::drawLayerRange(PageRef page, cairo_t* cr, bool dontRenderEditingStroke, bool withBackground,
+                                  size_t firstLayer, size_t lastLayer, xoj::view::BackgroundFlags flags) {
     initDrawing(page, cr, dontRenderEditingStroke);
+    this->cancelled = false;
 
-    drawBackground(flags);
+    xoj::util::CairoSaveGuard saveGuard(cr);
+    if (this->draftQuality) {
+        cairo_set_antialias(cr, CAIRO_ANTIALIAS_FAST);
+        flags.onlyCachedPdf = xoj::view::ONLY_USE_CACHED_PDF;
+    }
+
+    if (withBackground) {
+        drawBackground(flags);
+    }
 
     xoj::view::Context context{cr, (xoj::view::NonAudioTreatment)this->markAudioStroke,
-                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR};
-    for (Layer* layer: *page->getLayers()) {
+                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR,
+                               (xoj::view::QualityTreatment)this->draftQuality};
+    const auto& layers = *page->getLayers();
+    for (size_t i = firstLayer; i < lastLayer && i < layers.size(); i++) {
+        if (this->isCancelled && this->isCancelled()) {
+            this->cancelled = true;
+            break;
+        }
+        Layer* layer = layers[i];
         if (layer->isVisible()) {
             xoj::view::LayerView layerView(layer);
-            layerView.draw(context);
+            if (!layerView.draw(context, this->isCancelled)) {
+                this->cancelled = true;
+                break;
+            }
         }
     }
 
@@ -11,6 +11,9 @@
 
 #pragma once
 
+#include <cstddef>     // for size_t
+#include <functional>  // for function
+
 #include <cairo.h>  // for cairo_t
 
 #include "model/PageRef.h"  // for PageRef
@@ -39,6 +42,18 @@ public:
     void drawPage(PageRef page, cairo_t* cr, bool dontRenderEditingStroke,
                   xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL);
 
+    /**
+     * Draw the visible layers with indices in [firstLayer, lastLayer) (0-based) of the page, optionally on top of the
+     * background. Follows the cancellation check, like drawPage().
+     * @param page The page to draw
+     * @param cr Draw to this context
+     * @param dontRenderEditingStroke false to draw currently drawing stroke
+     * @param withBackground true to draw the background first
+     * @param flags show/hide various background components
+     */
+    void drawLayerRange(PageRef page, cairo_t* cr, bool dontRenderEditingStroke, bool withBackground, size_t firstLayer,
+                        size_t lastLayer, xoj::view::BackgroundFlags flags = xoj::view::BACKGROUND_SHOW_ALL);
+
     /**
      * Only draws the prescribed layers of the given page, regardless of the layer's current visibility.
      * @param layerRange Range of layers to draw
@@ -55,6 +70,23 @@ public:
      */
     void setMarkAudioStroke(bool markAudioStroke);
 
+    /**
+     * Draw faster, at the expense of the quality: fast antialiasing, simplified strokes, and the PDF backgrounds only
+     * taken from the PdfCache (scaled, or left blank if they are not cached). Used while the view is scrolled.
+     */
+    void setDraftQuality(bool draftQuality);
+
+    /**
+     * Set a callback checked between layers and elements by drawPage(). Once it returns true, drawPage() stops, leaving
+     * the drawing unfinished.
+     */
+    void setCancellationCheck(std::function<bool()> isCancelled);
+
+    /**
+     * @return true if the last call to drawPage() was cancelled
+     */
+    bool wasCancelled() const;
+
     // API for special drawing, usually you won't call this methods
 public:
     void setPdfCache(PdfCache* cache);
@@ -88,5 +120,8 @@ private:
     PdfCache* pdfCache = nullptr;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
+    bool draftQuality = false;
 
+    std::function<bool()> isCancelled;
+    bool cancelled = false;
 };
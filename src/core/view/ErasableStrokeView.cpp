@@ -1,19 +1,22 @@
 #include "ErasableStrokeView.h"
 
-#include <cmath>     // for ceil
+#include <cmath>     // for ceil, floor
 #include <iosfwd>    // for ptrdiff_t
 #include <iterator>  // for next
 #include <memory>    // for allocator_traits<>::value_type
+#include <mutex>     // for lock_guard
 #include <vector>    // for vector
 
+#include "model/ArcLengthTable.h"         // for ArcLengthTable
 #include "model/LineStyle.h"              // for LineStyle
 #include "model/PathParameter.h"          // for PathParameter
 #include "model/Point.h"                  // for Point
 #include "model/Stroke.h"                 // for Stroke, StrokeTool::HIGHLIG...
+#include "model/StrokeSegmentTree.h"      // for StrokeSegmentTree
 #include "model/eraser/ErasableStroke.h"  // for ErasableStroke, ErasableStr...
 #include "util/Assert.h"                  // for xoj_assert
 #include "util/Color.h"                   // for cairo_set_source_rgbi
-#include "util/Interval.h"                // for Interval
+#include "util/Range.h"                   // for Range
 #include "util/Rectangle.h"               // for Rectangle
 #include "util/Util.h"                    // for cairo_set_dash_from_vector
 
@@ -26,6 +29,62 @@ using namespace xoj::view;
 
 ErasableStrokeView::ErasableStrokeView(const ErasableStroke& erasableStroke): erasableStroke(erasableStroke) {}
 
+bool ErasableStrokeView::isFirstAndLastMerged(const std::vector<ErasableStroke::SubSection>& sections) const {
+    const Stroke& stroke = this->erasableStroke.stroke;
+    return this->erasableStroke.isClosedStroke() && stroke.getToolType() == StrokeTool::HIGHLIGHTER &&
+           sections.size() >= 2 && sections.front().min == PathParameter(0, 0.0) &&
+           sections.back().max == PathParameter(stroke.getPointCount() - 2, 1.0);
+}
+
+template <class DrawFun>
+bool ErasableStrokeView::blitCachedMask(cairo_t* cr, ErasableStroke::CachedMask& cache, DrawFun draw) const {
+    cairo_surface_t* target = cairo_get_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return false;
+    }
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (matrix.xy != 0 || matrix.yx != 0 || matrix.xx != matrix.yy || matrix.xx <= 0) {
+        return false;
+    }
+    const double zoom = matrix.xx;
+
+    const Stroke& stroke = this->erasableStroke.stroke;
+    const Range extents(stroke.boundingRect());
+    if (extents.getWidth() * extents.getHeight() * zoom * zoom > MAX_CACHED_MASK_PIXELS) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->erasableStroke.masksMutex);
+    if (!cache.mask.isInitialized() || cache.mask.getZoom() != zoom) {
+        cache.mask = Mask(target, extents, zoom);
+        cache.dirtyRange = extents;
+    }
+
+    if (!cache.dirtyRange.empty()) {
+        // Rounded to whole pixels, so that the pixels on the border are entirely drawn again
+        const Range& dirty = cache.dirtyRange;
+        const Range rg(std::floor(dirty.minX * zoom) / zoom, std::floor(dirty.minY * zoom) / zoom,
+                       std::ceil(dirty.maxX * zoom) / zoom, std::ceil(dirty.maxY * zoom) / zoom);
+        cache.mask.wipeRange(rg);
+
+        cairo_t* crMask = cache.mask.get();
+        xoj::util::CairoSaveGuard guard(crMask);
+        cairo_rectangle(crMask, rg.minX, rg.minY, rg.getWidth(), rg.getHeight());
+        cairo_clip(crMask);
+        cairo_set_line_join(crMask, CAIRO_LINE_JOIN_ROUND);
+        cairo_set_line_cap(crMask, StrokeView::CAIRO_LINE_CAP[stroke.getStrokeCapStyle()]);
+        cairo_set_source_rgba(crMask, 1, 1, 1, 1);
+        cairo_set_operator(crMask, CAIRO_OPERATOR_SOURCE);
+        draw(crMask, rg);
+
+        cache.dirtyRange = Range();
+    }
+
+    cache.mask.blitTo(cr);
+    return true;
+}
+
 void ErasableStrokeView::draw(cairo_t* cr) const {
     std::vector<ErasableStroke::SubSection> sections = erasableStroke.getRemainingSubSectionsVector();
 
@@ -35,27 +94,62 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
 
     const Stroke& stroke = this->erasableStroke.stroke;
 
+    // Merged ends depend on the whole sections: those are stroked entirely (but clipped) in the mask
+    const bool mergeFirstAndLast = !stroke.hasPressure() && isFirstAndLastMerged(sections);
+
+    bool cached = blitCachedMask(cr, erasableStroke.linesMask, [&](cairo_t* crMask, const Range& rg) {
+        if (mergeFirstAndLast) {
+            strokeSections(crMask, sections);
+        } else {
+            strokeSectionsIn(crMask, sections, rg);
+        }
+    });
+    if (!cached) {
+        strokeSections(cr, sections);
+    }
+
+#ifdef DEBUG_ERASABLE_STROKE_BOXES
+    if (!this->erasableStroke.debugMask.isInitialized()) {
+        cairo_matrix_t matrix;
+        cairo_get_matrix(cr, &matrix);
+
+        Range extents(0, 0, stroke.getElementWidth(), stroke.getElementHeight());
+        extents.addPadding(5 * stroke.getWidth());
+        erasableStroke.debugMask = Mask(cairo_get_target(cr), extents, matrix.xx, CAIRO_CONTENT_COLOR_ALPHA);
+        cairo_set_line_width(this->erasableStroke.debugMask.get(), 2);
+    } else {
+        xoj::util::CairoSaveGuard guard(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        this->erasableStroke.debugMask.paintTo(cr);
+    }
+#endif
+}
+
+void ErasableStrokeView::strokeSections(cairo_t* cr, const std::vector<ErasableStroke::SubSection>& sections) const {
+    const Stroke& stroke = this->erasableStroke.stroke;
+
     const auto& dashes = stroke.getLineStyle().getDashes();
 
     const std::vector<Point>& data = stroke.getPointVector();
+    const ArcLengthTable& lengths = stroke.getArcLengthTable();
 
     xoj::util::CairoSaveGuard guard(cr);
 
     if (stroke.hasPressure()) {
-        double dashOffset = 0;
         for (const auto& interval: sections) {
             Point p = stroke.getPoint(interval.min);
             cairo_set_line_width(cr, p.z);
             cairo_move_to(cr, p.x, p.y);
 
-            const Point* lastPoint = &p;
+            // The dashes are placed as on the whole stroke, so that they do not move while the stroke is erased
+            double dashOffset = lengths.getLength(interval.min);
+            size_t index = interval.min.index;
 
             auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)interval.max.index + 1);
             for (auto it = std::next(data.cbegin(), (std::ptrdiff_t)interval.min.index + 1); it != endIt; ++it) {
                 if (!dashes.empty()) {
                     Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
-                    dashOffset += lastPoint->lineLengthTo(*it);
-                    lastPoint = &(*it);
+                    dashOffset = lengths.getLength(++index);
                 }
                 cairo_line_to(cr, it->x, it->y);
                 cairo_stroke(cr);
@@ -73,12 +167,8 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
         }
     } else {
         cairo_set_line_width(cr, stroke.getWidth());
-        Util::cairo_set_dash_from_vector(cr, dashes, 0);
 
-        bool mergeFirstAndLast = this->erasableStroke.isClosedStroke() &&
-                                 stroke.getToolType() == StrokeTool::HIGHLIGHTER && sections.size() >= 2 &&
-                                 sections.front().min == PathParameter(0, 0.0) &&
-                                 sections.back().max == PathParameter(data.size() - 2, 1.0);
+        bool mergeFirstAndLast = isFirstAndLastMerged(sections);
 
         auto sectionIt = sections.cbegin();
         auto sectionEndIt = sections.cend();
@@ -90,6 +180,7 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
             const ErasableStroke::SubSection& first = sections.front();
             const ErasableStroke::SubSection& last = sections.back();
             Point p = stroke.getPoint(last.min);
+            Util::cairo_set_dash_from_vector(cr, dashes, lengths.getLength(last.min));
             cairo_move_to(cr, p.x, p.y);
 
             auto endIt = data.cend();
@@ -110,6 +201,7 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
 
         for (; sectionIt != sectionEndIt; ++sectionIt) {
             Point p = stroke.getPoint(sectionIt->min);
+            Util::cairo_set_dash_from_vector(cr, dashes, lengths.getLength(sectionIt->min));
             cairo_move_to(cr, p.x, p.y);
 
             auto endIt = std::next(data.cbegin(), (std::ptrdiff_t)sectionIt->max.index + 1);
@@ -122,21 +214,66 @@ void ErasableStrokeView::draw(cairo_t* cr) const {
             cairo_stroke(cr);
         }
     }
+}
 
-#ifdef DEBUG_ERASABLE_STROKE_BOXES
-    if (!this->erasableStroke.debugMask.isInitialized()) {
-        cairo_matrix_t matrix;
-        cairo_get_matrix(cr, &matrix);
+void ErasableStrokeView::strokeSectionsIn(cairo_t* cr, const std::vector<ErasableStroke::SubSection>& sections,
+                                          const Range& rg) const {
+    const Stroke& stroke = this->erasableStroke.stroke;
+    const std::vector<Point>& data = stroke.getPointVector();
+    const bool hasPressure = stroke.hasPressure();
+    const StrokeSegmentTree* tree = stroke.getSegmentTree();
+    const auto& dashes = stroke.getLineStyle().getDashes();
+    const ArcLengthTable& lengths = stroke.getArcLengthTable();
 
-        Range extents(0, 0, stroke.getElementWidth(), stroke.getElementHeight());
-        extents.addPadding(5 * stroke.getWidth());
-        erasableStroke.debugMask = Mask(cairo_get_target(cr), extents, matrix.xx, CAIRO_CONTENT_COLOR_ALPHA);
-        cairo_set_line_width(this->erasableStroke.debugMask.get(), 2);
-    } else {
-        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
-        this->erasableStroke.debugMask.paintTo(cr);
+    // The segments further away from rg than the line width paint nothing in it, not even their caps or joins
+    Range paddedRange = rg;
+    paddedRange.addPadding(this->erasableStroke.getMaxLineWidth());
+    const Rectangle<double> rect(paddedRange.getX(), paddedRange.getY(), paddedRange.getWidth(),
+                                 paddedRange.getHeight());
+
+    xoj::util::CairoSaveGuard guard(cr);
+    cairo_set_line_width(cr, stroke.getWidth());
+
+    // Stroke the segments first to last of the section, with the dashes placed as in strokeSections()
+    auto strokePart = [&](const ErasableStroke::SubSection& section, size_t first, size_t last) {
+        auto setDashes = [&](double offset) {
+            if (!dashes.empty()) {
+                Util::cairo_set_dash_from_vector(cr, dashes, offset);
+            }
+        };
+
+        const bool startsSection = first == section.min.index;
+        Point p = startsSection ? stroke.getPoint(section.min) : data[first];
+        Point q = last == section.max.index ? stroke.getPoint(section.max) : data[last + 1];
+        if (hasPressure) {
+            cairo_set_line_width(cr, p.z);
+        }
+        setDashes(startsSection ? lengths.getLength(section.min) : lengths.getLength(first));
+        cairo_move_to(cr, p.x, p.y);
+        for (size_t i = first + 1; i <= last; i++) {
+            cairo_line_to(cr, data[i].x, data[i].y);
+            if (hasPressure) {
+                cairo_stroke(cr);
+                cairo_set_line_width(cr, data[i].z);
+                setDashes(lengths.getLength(i));
+                cairo_move_to(cr, data[i].x, data[i].y);
+            }
+        }
+        cairo_line_to(cr, q.x, q.y);
+        cairo_stroke(cr);
+    };
+
+    for (const auto& section: sections) {
+        if (this->erasableStroke.getSubSectionBoundingBox(section).intersect(paddedRange).empty()) {
+            continue;
+        }
+        if (!tree) {
+            strokePart(section, section.min.index, section.max.index);
+            continue;
+        }
+        tree->forEachJoinedSegmentRangeIn(rect, section.min.index, section.max.index,
+                                          [&](size_t first, size_t last) { strokePart(section, first, last); });
     }
-#endif
 }
 
 void ErasableStrokeView::drawFilling(cairo_t* cr) const {
@@ -146,6 +283,15 @@ void ErasableStrokeView::drawFilling(cairo_t* cr) const {
         return;
     }
 
+    // The filling of a section depends on all its points: it is filled entirely (but clipped) in the mask
+    bool cached = blitCachedMask(cr, erasableStroke.fillingMask,
+                                 [&](cairo_t* crMask, const Range&) { fillSections(crMask, sections); });
+    if (!cached) {
+        fillSections(cr, sections);
+    }
+}
+
+void ErasableStrokeView::fillSections(cairo_t* cr, const std::vector<ErasableStroke::SubSection>& sections) const {
     const Stroke& stroke = this->erasableStroke.stroke;
     const std::vector<Point>& data = stroke.getPointVector();
 
@@ -12,10 +12,12 @@
 #pragma once
 
 #include <utility>  // for pair
+#include <vector>   // for vector
 
 #include <cairo.h>  // for cairo_t
 
-class ErasableStroke;
+#include "model/eraser/ErasableStroke.h"  // for ErasableStroke
+
 class Range;
 
 namespace xoj {
@@ -29,12 +31,15 @@ public:
 
     /**
      * @brief Draw the erasable stroke assuming the cairo context is all set
+     * On raster surfaces, the stroke is drawn into a mask kept from one frame to the next, where only the parts which
+     * were erased in between are drawn again. The mask is then blitted to cr.
      * @param cr The cairo context to draw to
      */
     void draw(cairo_t* cr) const;
 
     /**
      * @brief Draw the filling of the erasable stroke  assuming the cairo context is all set
+     * Like draw(), this goes through a cached mask on raster surfaces.
      * @param cr The cairo context
      */
     void drawFilling(cairo_t* cr) const;
@@ -46,7 +51,42 @@ public:
      */
     void paintFilledHighlighter(cairo_t* cr) const;
 
+    /**
+     * @brief Larger masks are not cached (e.g. when zooming in a lot on a long stroke)
+     */
+    static constexpr double MAX_CACHED_MASK_PIXELS = 4096.0 * 4096.0;
+
 private:
+    /**
+     * @brief Stroke the sections on cr
+     */
+    void strokeSections(cairo_t* cr, const std::vector<ErasableStroke::SubSection>& sections) const;
+
+    /**
+     * @brief Stroke the parts of the sections which paint in the given range.
+     * Each part is stroked as one path, so the result is only valid within the range.
+     */
+    void strokeSectionsIn(cairo_t* cr, const std::vector<ErasableStroke::SubSection>& sections,
+                          const Range& rg) const;
+
+    /**
+     * @brief Fill the sections on cr
+     */
+    void fillSections(cairo_t* cr, const std::vector<ErasableStroke::SubSection>& sections) const;
+
+    /**
+     * @return true if the first and last sections of the closed highlighter stroke are drawn as one
+     */
+    bool isFirstAndLastMerged(const std::vector<ErasableStroke::SubSection>& sections) const;
+
+    /**
+     * @brief Update the cached mask where it is out of date, calling draw(crMask, rg) with crMask clipped to rg, and
+     * use it as a mask on cr.
+     * @return false if the mask cannot be used on cr (vector surface, rotation, too large mask): nothing was done
+     */
+    template <class DrawFun>
+    bool blitCachedMask(cairo_t* cr, ErasableStroke::CachedMask& cache, DrawFun draw) const;
+
     /**
      * @brief Create a cairo mask for a given rectangle and sets up a context for drawing on it
      * @param target A cairo context on which the mask would be used
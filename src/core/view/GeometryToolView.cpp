@@ -22,9 +22,14 @@ void GeometryToolView::draw(cairo_t* cr) const {
     xoj::util::CairoSaveGuard saveGuard(cr);
     cairo_save(cr);
 
-    if (!mask.isInitialized()) {
-        // Initialize the mask on first call, when the geometry tool changes size and when zooming
+    // The artwork is drawn once for each size, zoom and DPI scaling: the motions only paint it transformed
+    double deviceScale = 1.0;
+    cairo_surface_get_device_scale(cairo_get_target(cr), &deviceScale, nullptr);
+    if (!mask.isInitialized() || mask.getZoom() != this->parent->getZoom() || maskDeviceScale != deviceScale) {
+        // Initialize the mask on first call, when the geometry tool changes size, when zooming and when the window
+        // moves to a monitor of another DPI scaling
         mask = createMask(cr);
+        maskDeviceScale = deviceScale;
         this->drawGeometryTool(mask.get());
     }
     cairo_translate(cr, geometryTool->getTranslationX(), geometryTool->getTranslationY());
@@ -127,6 +127,8 @@ protected:
 
 private:
     mutable Mask mask;
+    /// The device scale of the surface the mask was made for
+    mutable double maskDeviceScale = 0.0;
     ZoomControl* zoomControl;
 };
 };  // namespace xoj::view
\ No newline at end of file
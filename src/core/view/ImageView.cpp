@@ -1,9 +1,12 @@
 #include "ImageView.h"
 
+#include <cmath>  // for abs, ceil
+
 #include <cairo.h>  // for cairo_image_surface_get_height, cairo_image...
 
-#include "model/Image.h"  // for Image
-#include "view/View.h"    // for Context, OPACITY_NO_AUDIO, view
+#include "model/Image.h"        // for Image
+#include "model/ImageBuffer.h"  // for ImageBuffer
+#include "view/View.h"          // for Context, OPACITY_NO_AUDIO, view
 
 using namespace xoj::view;
 
@@ -11,12 +14,42 @@ ImageView::ImageView(const Image* image): image(image) {}
 
 ImageView::~ImageView() = default;
 
+void ImageView::drawPlaceholder(cairo_t* cr) const {
+    cairo_rectangle(cr, image->getX(), image->getY(), image->getElementWidth(), image->getElementHeight());
+    cairo_set_source_rgba(cr, 0.5, 0.5, 0.5, 0.25);
+    cairo_fill(cr);
+}
+
 void ImageView::draw(const Context& ctx) const {
     cairo_t* cr = ctx.cr;
 
     cairo_save(cr);
 
-    cairo_surface_t* img = image->getImage();
+    // Sample a downscaled version of the image when it is drawn small on a raster surface. The other surfaces (PDF
+    // export, printing) get the full resolution.
+    int minWidth = 0;
+    int minHeight = 0;
+    if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+        if (image->hasData() && image->getBuffer()->isDecodingInBackground()) {
+            // Do not wait for the image: its views are repainted once it is decoded
+            drawPlaceholder(cr);
+            cairo_restore(cr);
+            return;
+        }
+
+        double w = image->getElementWidth();
+        double h = image->getElementHeight();
+        cairo_user_to_device_distance(cr, &w, &h);
+        double scaleX = 1;
+        double scaleY = 1;
+        cairo_surface_get_device_scale(cairo_get_target(cr), &scaleX, &scaleY);
+        w *= scaleX;
+        h *= scaleY;
+        minWidth = static_cast<int>(std::ceil(std::abs(w)));
+        minHeight = static_cast<int>(std::ceil(std::abs(h)));
+    }
+    auto surface = image->getImage(minWidth, minHeight);
+    cairo_surface_t* img = surface.get();
     int width = cairo_image_surface_get_width(img);
     int height = cairo_image_surface_get_height(img);
 
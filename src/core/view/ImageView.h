@@ -25,6 +25,10 @@ public:
      */
     void draw(const Context& ctx) const override;
 
+private:
+    /// Drawn while the image is decoded on another thread
+    void drawPlaceholder(cairo_t* cr) const;
+
 private:
     const Image* image;
 };
@@ -1,23 +1,101 @@
 #include "LayerView.h"
 
-#include <memory>  // for unique_ptr
+#include <algorithm>  // for any_of, none_of, max, min
+#include <cmath>      // for abs
+#include <cstddef>    // for size_t
+#include <memory>     // for unique_ptr
+#include <optional>   // for optional
+#include <vector>     // for vector
 
 #include <cairo.h>  // for cairo_clip_extents, cairo_rectangle
 #include <glib.h>   // for g_message
 
-#include "model/Element.h"  // for Element
-#include "model/Layer.h"    // for Layer
+#include "model/Element.h"    // for Element, ELEMENT_STROKE
+#include "model/Image.h"      // for Image
+#include "model/Layer.h"      // for Layer
+#include "model/Point.h"      // for Point
+#include "model/Stroke.h"     // for Stroke, StrokeTool
+#include "util/Range.h"       // for Range
+#include "util/Rectangle.h"   // for Rectangle
 
 #include "DebugShowRepaintBounds.h"  // for IF_DEBUG_REPAINT
+#include "StrokeView.h"              // for StrokeView
 #include "View.h"                    // for Context, ElementView
 
 using namespace xoj::view;
 
+namespace {
+/// Occluders kept while drawing a layer: the elements below are only tested against these
+constexpr size_t MAX_OCCLUDERS = 8;
+
+auto boundsOf(const Element* e) -> Range {
+    const xoj::util::Rectangle<double> r = e->boundingRect();
+    return Range(std::min(r.x, r.x + r.width), std::min(r.y, r.y + r.height), std::max(r.x, r.x + r.width),
+                 std::max(r.y, r.y + r.height));
+}
+
+/**
+ * @param pixel The size of a pixel: the antialiased edges of the element are not considered opaque
+ * @return The area the element paints opaquely, if it is simple enough to tell: JPEG images, and axis-aligned
+ * rectangles drawn with the pen and filled without transparency.
+ */
+auto opaqueArea(const Element* e, double pixel) -> std::optional<Range> {
+    Range area;
+    if (e->getType() == ELEMENT_IMAGE) {
+        if (!static_cast<const Image*>(e)->isOpaque()) {
+            return std::nullopt;
+        }
+        area = boundsOf(e);
+    } else if (e->getType() == ELEMENT_STROKE) {
+        const auto* s = static_cast<const Stroke*>(e);
+        if (s->getToolType() != StrokeTool::PEN || s->getFill() != 255 || s->getErasable() != nullptr ||
+            s->getPointCount() != 5) {
+            return std::nullopt;
+        }
+        const auto& pts = s->getPointVector();
+        if (pts.front().x != pts.back().x || pts.front().y != pts.back().y) {
+            return std::nullopt;
+        }
+        for (size_t i = 0; i < 4; i++) {
+            const Point& p = pts[i];
+            const Point& q = pts[i + 1];
+            if (p.x != q.x && p.y != q.y) {
+                // Not axis-aligned
+                return std::nullopt;
+            }
+            area.addPoint(p.x, p.y);
+        }
+    } else {
+        return std::nullopt;
+    }
+    area.addPadding(-pixel);
+    return area.isValid() ? std::optional(area) : std::nullopt;
+}
+
+auto covers(const Range& outer, const Range& inner) -> bool {
+    return outer.minX <= inner.minX && outer.minY <= inner.minY && inner.maxX <= outer.maxX &&
+           inner.maxY <= outer.maxY;
+}
+
+/**
+ * What the drawing of a layer needs to know of an element, gathered once in a contiguous array: the passes over the
+ * elements (clip, occlusion, drawing) do not go back to each element's heap object until it is drawn
+ */
+struct DrawEntry {
+    Element* e;
+    Range bounds;
+    ElementType type;
+    bool hidden;
+};
+}  // namespace
+
 LayerView::LayerView(const Layer* layer): layer(layer) {}
 
 const Layer* LayerView::getLayer() const { return layer; }
 
-void LayerView::draw(const Context& ctx) const {
+void LayerView::draw(const Context& ctx) const { draw(ctx, nullptr); }
+
+bool LayerView::draw(const Context& ctx, const std::function<bool()>& isCancelled) const {
     IF_DEBUG_REPAINT(int drawn = 0; int notDrawn = 0;);
 
     // Get the bounds of the mask, in page coordinates
@@ -26,8 +104,73 @@ void LayerView::draw(const Context& ctx) const {
     double minY;
     double maxY;
     cairo_clip_extents(ctx.cr, &minX, &minY, &maxX, &maxY);
+    const Range clip(minX, minY, maxX, maxY);
 
-    for (auto const& e: layer->getElements()) {
+    // The clip may consist of several rectangles (e.g. the damaged region of a page)
+    std::vector<Range> clipRects;
+    if (cairo_rectangle_list_t* list = cairo_copy_clip_rectangle_list(ctx.cr); list->status == CAIRO_STATUS_SUCCESS) {
+        for (int i = 0; i < list->num_rectangles; i++) {
+            const cairo_rectangle_t& r = list->rectangles[i];
+            clipRects.emplace_back(r.x, r.y, r.x + r.width, r.y + r.height);
+        }
+        cairo_rectangle_list_destroy(list);
+    } else {
+        cairo_rectangle_list_destroy(list);
+        clipRects.push_back(clip);
+    }
+
+    std::vector<DrawEntry> entries;
+    {
+        const std::vector<Element*> elements = layer->getElementsInArea(clip);
+        entries.reserve(elements.size());
+        for (Element* e: elements) {
+            entries.push_back({e, boundsOf(e), e->getType(), false});
+        }
+    }
+
+    // Skip the elements in the clip extents but outside of the clip rectangles
+    if (clipRects.size() > 1) {
+        for (DrawEntry& entry: entries) {
+            entry.hidden = std::none_of(clipRects.begin(), clipRects.end(),
+                                        [&entry](const Range& r) { return !entry.bounds.intersect(r).empty(); });
+        }
+    }
+
+    // Going from the top, skip the elements hidden under opaque elements. When elements are faded out (audio
+    // playback), nothing is opaque. Vector outputs (export, printing) keep all the elements.
+    const bool raster = cairo_surface_get_type(cairo_get_target(ctx.cr)) == CAIRO_SURFACE_TYPE_IMAGE;
+    if (raster && !ctx.fadeOutNonAudio) {
+        double pixelX = 1;
+        double pixelY = 1;
+        cairo_device_to_user_distance(ctx.cr, &pixelX, &pixelY);
+        const double pixel = std::max(std::abs(pixelX), std::abs(pixelY));
+
+        std::vector<Range> occluders;
+        for (size_t i = entries.size(); i-- > 0;) {
+            DrawEntry& entry = entries[i];
+            if (entry.hidden) {
+                continue;
+            }
+            const Range visible = entry.bounds.intersect(clip);
+            entry.hidden = std::any_of(occluders.begin(), occluders.end(),
+                                       [&visible](const Range& o) { return covers(o, visible); });
+            if (!entry.hidden && occluders.size() < MAX_OCCLUDERS) {
+                if (auto area = opaqueArea(entry.e, pixel)) {
+                    occluders.push_back(*area);
+                }
+            }
+        }
+    }
+
+    for (const DrawEntry& entry: entries) {
+        Element* e = entry.e;
+        if (isCancelled && isCancelled()) {
+            return false;
+        }
+        if (entry.hidden) {
+            IF_DEBUG_REPAINT(notDrawn++;);
+            continue;
+        }
 
         IF_DEBUG_REPAINT({
             auto cr = ctx.cr;
@@ -38,11 +181,19 @@ void LayerView::draw(const Context& ctx) const {
             cairo_stroke(cr);
         });
 
-        if (e->intersectsArea(minX, minY, maxX - minX, maxY - minY)) {
-            ElementView::createFromElement(e.get())->draw(ctx);
+        // Same test as Element::intersectsArea()
+        const Range& b = entry.bounds;
+        if (std::max(b.minX, minX) < std::min(b.maxX, maxX) && std::max(b.minY, minY) < std::min(b.maxY, maxY)) {
+            if (entry.type == ELEMENT_STROKE) {
+                // Most elements: drawn without allocating a view, nor any virtual call
+                StrokeView(static_cast<const Stroke*>(e)).draw(ctx);
+            } else {
+                ElementView::createFromElement(e)->draw(ctx);
+            }
             IF_DEBUG_REPAINT(drawn++;);
         }
         IF_DEBUG_REPAINT(else { notDrawn++; });
     }
     IF_DEBUG_REPAINT(g_message("DBG:LayerView::draw: draw %i / not draw %i", drawn, notDrawn););
+    return true;
 }
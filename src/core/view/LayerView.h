@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <functional>  // for function
+
 class Layer;
 namespace xoj::view {
 class Context;
@@ -24,6 +26,13 @@ public:
      */
     void draw(const Context& ctx) const;
 
+    /**
+     * @brief Draws the Layer, unless isCancelled() returns true
+     *      isCancelled() is checked before drawing each element.
+     * @return false if the drawing was cancelled
+     */
+    bool draw(const Context& ctx, const std::function<bool()>& isCancelled) const;
+
     const Layer* getLayer() const;
 
 private:
@@ -1,13 +1,20 @@
 #include "Mask.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <type_traits>
+#include <vector>
 
 #include <cairo.h>
 
 #include "util/Assert.h"
+#include "util/Compositing.h"
 #include "util/Range.h"
 #include "util/safe_casts.h"  // for ceil_cast, floor_cast
 
+#include "SurfacePool.h"
 #include "config-debug.h"
 
 using namespace xoj::view;
@@ -32,6 +39,13 @@ Mask::Mask(int DPIScaling, const Range& extent, double zoom, cairo_content_t con
     constructorImpl(DPIScaling, extent, zoom, contentType);
 }
 
+Mask::Mask(int DPIScaling, const xoj::util::Rectangle<int>& pixelExtent, double zoom, cairo_content_t contentType):
+        xOffset(pixelExtent.x), yOffset(pixelExtent.y), zoom(zoom) {
+    xoj_assert(pixelExtent.width > 0 && pixelExtent.height > 0);
+    xoj_assert(zoom > 0.0);
+    createSurface(DPIScaling, pixelExtent.width, pixelExtent.height, contentType);
+}
+
 template <typename DPIInfoType>
 class SurfaceCreator {};
 template <>
@@ -47,8 +61,8 @@ class SurfaceCreator<int> {
 public:
     static cairo_surface_t* create(int DPIScaling, cairo_content_t contentType, int width, int height) {
         cairo_surface_t* surf =
-                cairo_image_surface_create(contentType == CAIRO_CONTENT_ALPHA ? CAIRO_FORMAT_A8 : CAIRO_FORMAT_ARGB32,
-                                           width * DPIScaling, height * DPIScaling);
+                SurfacePool::acquire(contentType == CAIRO_CONTENT_ALPHA ? CAIRO_FORMAT_A8 : CAIRO_FORMAT_ARGB32,
+                                     width * DPIScaling, height * DPIScaling);
         cairo_surface_set_device_scale(surf, DPIScaling, DPIScaling);
         return surf;
     }
@@ -66,6 +80,11 @@ void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom
     const int width = ceil_cast<int>(extent.maxX * zoom) - xOffset;
     const int height = ceil_cast<int>(extent.maxY * zoom) - yOffset;
 
+    createSurface(dpiInfo, width, height, contentType);
+}
+
+template <typename DPIInfoType>
+void Mask::createSurface(DPIInfoType dpiInfo, int width, int height, cairo_content_t contentType) {
     /*
      * Create the most suitable kind of surface.
      *
@@ -85,7 +104,11 @@ void Mask::constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom
     });
 
     this->cr.reset(cairo_create(surf), xoj::util::adopt);
-    cairo_surface_destroy(surf);  // surf is now owned by this->cr
+    if constexpr (std::is_same_v<DPIInfoType, int>) {
+        this->pooledSurface = std::shared_ptr<cairo_surface_t>(surf, SurfacePool::release);
+    } else {
+        cairo_surface_destroy(surf);  // surf is now owned by this->cr
+    }
 
     cairo_translate(this->cr.get(), -xOffset, -yOffset);
     cairo_scale(this->cr.get(), zoom, zoom);
@@ -102,8 +125,128 @@ auto Mask::get() -> cairo_t* { return cr.get(); }
 
 bool Mask::isInitialized() const { return cr; }
 
+namespace {
+/// Transformations within this distance of a whole pixel are considered pixel-aligned
+constexpr double PIXEL_EPSILON = 1e-6;
+
+auto isInteger(double v) -> bool { return std::abs(v - std::round(v)) < PIXEL_EPSILON; }
+
+auto isImage(cairo_surface_t* surf, cairo_format_t format) -> bool {
+    return cairo_surface_get_type(surf) == CAIRO_SURFACE_TYPE_IMAGE && cairo_image_surface_get_format(surf) == format &&
+           cairo_image_surface_get_data(surf);
+}
+};  // namespace
+
+bool Mask::tryBlitMultiply(cairo_t* targetCr) const {
+    /*
+     * pixman has no fast path for the multiply blend mode (used by the highlighters), so we use our own kernel in the
+     * common case: a solid color, image surfaces, and the mask pixels aligned with those of the target.
+     */
+    if (cairo_get_operator(targetCr) != CAIRO_OPERATOR_MULTIPLY) {
+        return false;
+    }
+    double r = 0.;
+    double g = 0.;
+    double b = 0.;
+    double a = 0.;
+    if (cairo_pattern_get_rgba(cairo_get_source(targetCr), &r, &g, &b, &a) != CAIRO_STATUS_SUCCESS) {
+        return false;
+    }
+    cairo_surface_t* src = cairo_get_target(cr.get());
+    cairo_surface_t* dst = cairo_get_group_target(targetCr);
+    if (!isImage(src, CAIRO_FORMAT_A8) || !isImage(dst, CAIRO_FORMAT_ARGB32)) {
+        return false;
+    }
+
+    // From the target's user space to its pixels
+    cairo_matrix_t toPixels;
+    cairo_get_matrix(targetCr, &toPixels);
+    double dstScaleX = 1.;
+    double dstScaleY = 1.;
+    double dstOffsetX = 0.;
+    double dstOffsetY = 0.;
+    cairo_surface_get_device_scale(dst, &dstScaleX, &dstScaleY);
+    cairo_surface_get_device_offset(dst, &dstOffsetX, &dstOffsetY);
+    cairo_matrix_t device;
+    cairo_matrix_init(&device, dstScaleX, 0., 0., dstScaleY, dstOffsetX, dstOffsetY);
+    cairo_matrix_multiply(&toPixels, &toPixels, &device);
+
+    // From the mask's pixels to the target's pixels, as done by blitTo()
+    double srcScaleX = 1.;
+    double srcScaleY = 1.;
+    cairo_surface_get_device_scale(src, &srcScaleX, &srcScaleY);
+    cairo_matrix_t m;
+    cairo_matrix_init_scale(&m, 1. / srcScaleX, 1. / srcScaleY);
+    cairo_matrix_t maskToUser;
+    cairo_matrix_init_scale(&maskToUser, 1. / zoom, 1. / zoom);
+    cairo_matrix_translate(&maskToUser, xOffset, yOffset);
+    cairo_matrix_multiply(&m, &m, &maskToUser);
+    cairo_matrix_multiply(&m, &m, &toPixels);
+    if (std::abs(m.xx - 1.) > PIXEL_EPSILON || std::abs(m.yy - 1.) > PIXEL_EPSILON || m.xy != 0. || m.yx != 0. ||
+        !isInteger(m.x0) || !isInteger(m.y0)) {
+        return false;
+    }
+    const int maskX = static_cast<int>(std::round(m.x0));
+    const int maskY = static_cast<int>(std::round(m.y0));
+    const int maskWidth = cairo_image_surface_get_width(src);
+    const int maskHeight = cairo_image_surface_get_height(src);
+    const int dstWidth = cairo_image_surface_get_width(dst);
+    const int dstHeight = cairo_image_surface_get_height(dst);
+
+    cairo_rectangle_list_t* clip = cairo_copy_clip_rectangle_list(targetCr);
+    if (clip->status != CAIRO_STATUS_SUCCESS) {
+        cairo_rectangle_list_destroy(clip);
+        return false;
+    }
+    // The clip rectangles, in the target's pixels
+    std::vector<xoj::util::Rectangle<int>> rects;
+    rects.reserve(static_cast<size_t>(clip->num_rectangles));
+    for (int i = 0; i < clip->num_rectangles; i++) {
+        const cairo_rectangle_t& rect = clip->rectangles[i];
+        double x1 = rect.x;
+        double y1 = rect.y;
+        double x2 = rect.x + rect.width;
+        double y2 = rect.y + rect.height;
+        cairo_matrix_transform_point(&toPixels, &x1, &y1);
+        cairo_matrix_transform_point(&toPixels, &x2, &y2);
+        if (!isInteger(x1) || !isInteger(y1) || !isInteger(x2) || !isInteger(y2)) {
+            // Antialiased clip
+            cairo_rectangle_list_destroy(clip);
+            return false;
+        }
+        const int minX = std::max({static_cast<int>(std::round(std::min(x1, x2))), maskX, 0});
+        const int minY = std::max({static_cast<int>(std::round(std::min(y1, y2))), maskY, 0});
+        const int maxX = std::min({static_cast<int>(std::round(std::max(x1, x2))), maskX + maskWidth, dstWidth});
+        const int maxY = std::min({static_cast<int>(std::round(std::max(y1, y2))), maskY + maskHeight, dstHeight});
+        if (minX < maxX && minY < maxY) {
+            rects.emplace_back(minX, minY, maxX - minX, maxY - minY);
+        }
+    }
+    cairo_rectangle_list_destroy(clip);
+
+    cairo_surface_flush(src);
+    cairo_surface_flush(dst);
+    const auto color = xoj::util::compositing::premultiply(r, g, b, a);
+    unsigned char* srcData = cairo_image_surface_get_data(src);
+    unsigned char* dstData = cairo_image_surface_get_data(dst);
+    const int srcStride = cairo_image_surface_get_stride(src);
+    const int dstStride = cairo_image_surface_get_stride(dst);
+    for (auto&& rect: rects) {
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            auto* dstRow = reinterpret_cast<uint32_t*>(dstData + static_cast<std::ptrdiff_t>(y) * dstStride) + rect.x;
+            const uint8_t* maskRow = srcData + static_cast<std::ptrdiff_t>(y - maskY) * srcStride + (rect.x - maskX);
+            xoj::util::compositing::multiplyMasked(dstRow, maskRow, static_cast<size_t>(rect.width), color);
+        }
+    }
+    cairo_surface_mark_dirty(dst);
+    return true;
+}
+
 void Mask::blitTo(cairo_t* targetCr) const {
     xoj_assert(isInitialized());
+    if (tryBlitMultiply(targetCr)) {
+        return;
+    }
     xoj::util::CairoSaveGuard guard(targetCr);
     cairo_scale(targetCr, 1. / zoom, 1. / zoom);
     cairo_mask_surface(targetCr, cairo_get_target(const_cast<cairo_t*>(cr.get())), xOffset, yOffset);
@@ -137,7 +280,12 @@ void Mask::wipeRange(const Range& rg) {
     wipe();
 }
 
-void Mask::reset() { cr.reset(); }
+void Mask::reset() {
+    cr.reset();
+    pooledSurface.reset();
+}
+
+Mask::~Mask() { reset(); }
 
 #ifdef DEBUG_MASKS
 namespace {
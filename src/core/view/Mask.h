@@ -11,9 +11,12 @@
 
 #pragma once
 
+#include <memory>
+
 #include <cairo.h>
 #include <gdk/gdk.h>
 
+#include "util/Rectangle.h"
 #include "util/raii/CairoWrappers.h"
 
 class Range;
@@ -27,6 +30,12 @@ namespace xoj::view {
 class Mask {
 public:
     Mask() = default;
+    ~Mask();
+    Mask(const Mask&) = default;
+    Mask(Mask&&) = default;
+    Mask& operator=(const Mask&) = default;
+    Mask& operator=(Mask&&) = default;
+
     /**
      * @brief Create a mask tailored for the specified target
      * @param target A cairo surface similar to that on which the mask will be used
@@ -47,6 +56,17 @@ public:
      */
     Mask(int DPIScaling, const Range& extent, double zoom, cairo_content_t contentType = CAIRO_CONTENT_ALPHA);
 
+    /**
+     * @brief Create a mask covering exactly the given rectangle of device pixels
+     * @param DPIScaling The DPI scaling of the targeted use monitor
+     * @param pixelExtent The extent of the mask, in device space coordinates (i.e. local coordinates times zoom, before
+     * DPI scaling).
+     * @param zoom The local zoom ratio (zoom ratio of the cairo context(s) on which the mask will be used).
+     * @param contentType The intended content of the mask
+     */
+    Mask(int DPIScaling, const xoj::util::Rectangle<int>& pixelExtent, double zoom,
+         cairo_content_t contentType = CAIRO_CONTENT_ALPHA);
+
     cairo_t* get();
     bool isInitialized() const;
     /**
@@ -78,8 +98,18 @@ public:
 private:
     template <typename DPIInfoType>
     void constructorImpl(DPIInfoType dpiInfo, const Range& extent, double zoom, cairo_content_t contentType);
+    template <typename DPIInfoType>
+    void createSurface(DPIInfoType dpiInfo, int width, int height, cairo_content_t contentType);
+    /**
+     * @brief Blit a solid color through the mask with the multiply blend mode, without going through cairo.
+     * @return false if the configuration is not supported (then nothing is done)
+     */
+    bool tryBlitMultiply(cairo_t* targetCr) const;
 
     xoj::util::CairoSPtr cr;
+    /// The image surface of cr, given back to the SurfacePool once the mask and its copies are gone. Declared after
+    /// cr, so that cr no longer references it when it is given back.
+    std::shared_ptr<cairo_surface_t> pooledSurface;
     int xOffset = 0;
     int yOffset = 0;
     double zoom = 1.0;
@@ -1,16 +1,23 @@
 #include "StrokeView.h"
 
 #include <algorithm>  // for max
-#include <cmath>      // for ceil
+#include <cmath>      // for abs, ceil
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
 
 #include <glib.h>  // for g_warning
 
-#include "model/Stroke.h"    // for Stroke, StrokeTool::HIGHLIGHTER
-#include "util/Assert.h"     // for xoj_assert
-#include "util/Color.h"      // for cairo_set_source_rgbi
-#include "util/Rectangle.h"  // for Rectangle
-#include "view/Mask.h"       // for Mask
-#include "view/View.h"       // for Context, OPACITY_NO_AUDIO, view
+#include "model/ArcLengthTable.h"     // for ArcLengthTable
+#include "model/Point.h"              // for Point
+#include "model/Stroke.h"             // for Stroke, StrokeTool::HIGHLIGHTER
+#include "model/StrokeOutline.h"      // for StrokeOutline
+#include "model/StrokeSegmentTree.h"  // for StrokeSegmentTree
+#include "util/Assert.h"              // for xoj_assert
+#include "util/Color.h"               // for cairo_set_source_rgbi
+#include "util/Rectangle.h"           // for Rectangle
+#include "util/Util.h"                // for cairo_set_dash_from_vector
+#include "view/Mask.h"                // for Mask
+#include "view/View.h"                // for Context, OPACITY_NO_AUDIO, view
 
 #include "ErasableStrokeView.h"  // for ErasableStrokeView
 #include "StrokeViewHelper.h"
@@ -34,7 +41,12 @@ void StrokeView::draw(const Context& ctx) const {
     const bool highlighter = s->getToolType() == StrokeTool::HIGHLIGHTER;
     const bool filledHighlighter = highlighter && s->getFill() != -1;
     const bool drawTranslucent = ctx.fadeOutNonAudio && s->getAudioFilename().empty();
-    const bool useMask = (!ctx.noColor && filledHighlighter) || drawTranslucent;
+    const bool edited = s->getErasable() != nullptr && ctx.showCurrentEdition;
+    // Strokes with pressure are filled at once with their outline, which paints each pixel once
+    const bool drawOutline = s->hasPressure() && !highlighter && !edited && s->getLineStyle().getDashes().empty();
+    // A translucent outline needs no mask, unless a filling would show through it
+    const bool translucentOutline = drawTranslucent && drawOutline && s->getFill() == -1 && !ctx.noColor;
+    const bool useMask = (!ctx.noColor && filledHighlighter) || (drawTranslucent && !translucentOutline);
 
     if (ctx.showCurrentEdition && filledHighlighter && s->getErasable() != nullptr) {
         // Currently being erased filled highlighter strokes need a special treatment
@@ -46,6 +58,13 @@ void StrokeView::draw(const Context& ctx) const {
     // The mask will be colorblind
     const bool noColor = ctx.noColor || useMask;
 
+    // At low zoom levels, many points fall in the same pixel. The dashes need the exact length of the path.
+    const double tolerance =
+            s->getLineStyle().hasDashes()
+                    ? 0.0
+                    : getDetailTolerance(ctx.cr, ctx.draftQuality ? DRAFT_PIXEL_TOLERANCE : PIXEL_TOLERANCE);
+    const std::vector<Point>& pts = s->getSimplifiedPointVector(tolerance);
+
     xoj::util::CairoSaveGuard saveGuard(ctx.cr);
 
     Mask mask;
@@ -100,7 +119,7 @@ void StrokeView::draw(const Context& ctx) const {
             ErasableStrokeView erasableStrokeView(*erasable);
             erasableStrokeView.drawFilling(cr);
         } else {
-            StrokeViewHelper::pathToCairo(cr, s->getPointVector());
+            StrokeViewHelper::pathToCairo(cr, pts);
             cairo_fill(cr);
         }
     }
@@ -120,6 +139,12 @@ void StrokeView::draw(const Context& ctx) const {
          */
         Util::cairo_set_source_rgbi(cr, s->getColor(), OPACITY_HIGHLIGHTER);
         cairo_set_operator(cr, CAIRO_OPERATOR_MULTIPLY);
+    } else if (translucentOutline) {
+        /**
+         * Pen with pressure, without audio: the opacity is applied directly
+         */
+        Util::cairo_set_source_rgbi(cr, s->getColor(), std::max(MINIMAL_ALPHA, OPACITY_NO_AUDIO));
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
     } else {
         /**
          * Normal pen
@@ -128,14 +153,23 @@ void StrokeView::draw(const Context& ctx) const {
         cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
     }
 
-    if (ErasableStroke* erasable = s->getErasable(); erasable != nullptr && ctx.showCurrentEdition) {
+    if (edited) {
         // don't render erasable for previews
-        ErasableStrokeView erasableStrokeView(*erasable);
+        ErasableStrokeView erasableStrokeView(*s->getErasable());
         erasableStrokeView.draw(cr);
+    } else if (drawOutline) {
+        // The outline is computed once for the points and kept on the stroke
+        cairo_new_path(cr);
+        cairo_append_path(cr, s->getOutline().get(pts, CAIRO_LINE_CAP[s->getStrokeCapStyle()]));
+        cairo_set_fill_rule(cr, CAIRO_FILL_RULE_WINDING);
+        cairo_fill(cr);
     } else if (s->hasPressure() && !highlighter) {
-        StrokeViewHelper::drawWithPressure(cr, s->getPointVector(), s->getLineStyle());
+        StrokeViewHelper::drawWithPressure(cr, pts, s->getLineStyle());
+    } else if (!highlighter && !useMask && !s->getLineStyle().getDashes().empty() && s->getSegmentTree()) {
+        // Highlighters are excluded: the overlapping parts would be painted twice
+        drawDashesIn(cr, *s->getSegmentTree());
     } else {
-        StrokeViewHelper::drawNoPressure(cr, s->getPointVector(), s->getWidth(), s->getLineStyle());
+        StrokeViewHelper::drawNoPressure(cr, pts, s->getWidth(), s->getLineStyle());
     }
 
     if (useMask) {
@@ -167,3 +201,48 @@ void StrokeView::draw(const Context& ctx) const {
         mask.blitTo(ctx.cr);
     }
 }
+
+auto StrokeView::getDetailTolerance(cairo_t* cr, double pixelTolerance) -> double {
+    cairo_surface_t* target = cairo_get_group_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        // The exports keep all the details
+        return 0;
+    }
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (matrix.xy != 0 || matrix.yx != 0) {
+        return 0;
+    }
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+    const double pixelsPerUnit = std::max(std::abs(matrix.xx) * deviceScaleX, std::abs(matrix.yy) * deviceScaleY);
+    return pixelsPerUnit > 0 ? pixelTolerance / pixelsPerUnit : 0;
+}
+
+void StrokeView::drawDashesIn(cairo_t* cr, const StrokeSegmentTree& tree) const {
+    double x1 = 0;
+    double y1 = 0;
+    double x2 = 0;
+    double y2 = 0;
+    cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+
+    // The segments further away from the clip than the line width paint nothing in it, not even their caps or joins
+    const double width = s->getWidth();
+    const Rectangle<double> rect(x1 - width, y1 - width, x2 - x1 + 2 * width, y2 - y1 + 2 * width);
+
+    const std::vector<Point>& pts = s->getPointVector();
+    const ArcLengthTable& lengths = s->getArcLengthTable();
+    const auto& dashes = s->getLineStyle().getDashes();
+
+    cairo_set_line_width(cr, width);
+    tree.forEachJoinedSegmentRangeIn(rect, 0, tree.getSegmentCount() - 1, [&](size_t first, size_t last) {
+        // The dashes are placed as if the whole stroke was drawn
+        Util::cairo_set_dash_from_vector(cr, dashes, lengths.getLength(first));
+        cairo_move_to(cr, pts[first].x, pts[first].y);
+        for (size_t i = first + 1; i <= last + 1; i++) {
+            cairo_line_to(cr, pts[i].x, pts[i].y);
+        }
+        cairo_stroke(cr);
+    });
+}
@@ -16,6 +16,7 @@
 #include "View.h"  // for ElementView
 
 class Stroke;
+class StrokeSegmentTree;
 
 class xoj::view::StrokeView: public xoj::view::ElementView {
 public:
@@ -33,12 +34,31 @@ public:
     void draw(const Context& ctx) const override;
 
 private:
+    /**
+     * @brief Stroke only the parts of the dashed stroke which paint in the clip of cr, with their dashes at the same
+     *      place as when stroking the whole stroke. For long strokes, placing the dashes along the whole stroke is
+     *      what takes most of the time of a small redraw.
+     */
+    void drawDashesIn(cairo_t* cr, const StrokeSegmentTree& tree) const;
+
+    /**
+     * @param pixelTolerance The deviation allowed, in device pixels
+     * @return The deviation from the stroke (in page coordinates) which is not noticeable on cr, or 0 if the stroke
+     *      must be drawn exactly (e.g. in exports)
+     */
+    static double getDetailTolerance(cairo_t* cr, double pixelTolerance);
+
     const Stroke* s;
 
 public:
     static constexpr double OPACITY_HIGHLIGHTER = 0.47;
     static constexpr double MINIMAL_ALPHA = 0.04;
 
+    /// Deviation, in device pixels, allowed when simplifying the strokes at low zoom levels
+    static constexpr double PIXEL_TOLERANCE = 0.25;
+    /// Deviation, in device pixels, allowed for the draft renders done while scrolling
+    static constexpr double DRAFT_PIXEL_TOLERANCE = 1.0;
+
     //  Must match the enum StrokeCapStyle in Stroke.h
     static constexpr cairo_line_cap_t CAIRO_LINE_CAP[] = {CAIRO_LINE_CAP_ROUND, CAIRO_LINE_CAP_BUTT,
                                                           CAIRO_LINE_CAP_SQUARE};
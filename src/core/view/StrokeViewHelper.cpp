@@ -1,10 +1,12 @@
 #include "StrokeViewHelper.h"
 
+#include <cstddef>  // for size_t
+
 #include "model/LineStyle.h"
 #include "model/Point.h"
+#include "model/StrokeOutline.h"
 #include "util/Assert.h"
 #include "util/LoopUtil.h"
-#include "util/PairView.h"
 #include "util/Util.h"  // for cairo_set_dash_from_vector
 
 void xoj::view::StrokeViewHelper::pathToCairo(cairo_t* cr, const std::vector<Point>& pts) {
@@ -34,28 +36,38 @@ double xoj::view::StrokeViewHelper::drawWithPressure(cairo_t* cr, const std::vec
                                                      const LineStyle& lineStyle, double dashOffset) {
     const auto& dashes = lineStyle.getDashes();
 
+    if (dashes.empty()) {
+        /*
+         * The segments are filled at once, as the union of their outlines: this rasterizes each pixel once, instead
+         * of once per cairo_stroke() of every segment covering it
+         */
+        const cairo_fill_rule_t fillRule = cairo_get_fill_rule(cr);
+        StrokeOutline::addTo(cr, pts, cairo_get_line_cap(cr));
+        cairo_set_fill_rule(cr, CAIRO_FILL_RULE_WINDING);
+        cairo_fill(cr);
+        cairo_set_fill_rule(cr, fillRule);
+        return dashOffset;
+    }
+
     /*
-     * Because the width varies, we need to call cairo_stroke() once per segment
+     * Because the width varies and the dashes must follow the whole path, we need to call cairo_stroke() for each
+     * width. With round caps and joins, a run of segments of the same width looks the same stroked at once as stroked
+     * one by one, and stroking is what takes the time.
      */
-    auto drawSegment = [cr](const Point& p, const Point& q) {
-        xoj_assert(p.z > 0.0);
-        cairo_set_line_width(cr, p.z);
-        cairo_move_to(cr, p.x, p.y);
-        cairo_line_to(cr, q.x, q.y);
+    const bool joinRuns = cairo_get_line_cap(cr) == CAIRO_LINE_CAP_ROUND &&
+                          cairo_get_line_join(cr) == CAIRO_LINE_JOIN_ROUND;
+    for (size_t i = 0; i + 1 < pts.size();) {
+        const double width = pts[i].z;
+        xoj_assert(width > 0.0);
+        cairo_set_line_width(cr, width);
+        Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
+        cairo_move_to(cr, pts[i].x, pts[i].y);
+        do {
+            dashOffset += pts[i].lineLengthTo(pts[i + 1]);
+            cairo_line_to(cr, pts[i + 1].x, pts[i + 1].y);
+            i++;
+        } while (joinRuns && i + 1 < pts.size() && pts[i].z == width);
         cairo_stroke(cr);
-    };
-
-    if (!dashes.empty()) {
-        for (const auto& [p, q]: PairView(pts)) {
-            Util::cairo_set_dash_from_vector(cr, dashes, dashOffset);
-            dashOffset += p.lineLengthTo(q);
-            drawSegment(p, q);
-        }
-    } else {
-        cairo_set_dash(cr, nullptr, 0, 0.0);
-        for (const auto& [p, q]: PairView(pts)) {
-            drawSegment(p, q);
-        }
     }
     return dashOffset;
 }
@@ -0,0 +1,90 @@
+#include "SurfacePool.h"
+
+#include <algorithm>  // for find_if
+#include <iterator>   // for next
+#include <vector>     // for vector
+
+using namespace xoj::view;
+
+auto SurfacePool::acquire(cairo_format_t format, int width, int height) -> cairo_surface_t* {
+    cairo_surface_t* surface = nullptr;
+    {
+        Shared& shared = getShared();
+        std::lock_guard lock(shared.mutex);
+        // The most recently released first: its memory is the most likely to still be in the caches
+        auto it = std::find_if(shared.entries.rbegin(), shared.entries.rend(), [&](const Entry& e) {
+            return e.format == format && e.width == width && e.height == height;
+        });
+        if (it != shared.entries.rend()) {
+            surface = it->surface;
+            shared.bytes -= it->bytes;
+            shared.entries.erase(std::next(it).base());
+        }
+    }
+
+    if (!surface) {
+        // New image surfaces are already transparent
+        return cairo_image_surface_create(format, width, height);
+    }
+
+    cairo_surface_set_device_scale(surface, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+void SurfacePool::release(cairo_surface_t* surface) {
+    if (!surface) {
+        return;
+    }
+    const bool reusable = cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS &&
+                          cairo_surface_get_type(surface) == CAIRO_SURFACE_TYPE_IMAGE &&
+                          cairo_surface_get_reference_count(surface) == 1;
+    const auto bytes = reusable ? static_cast<size_t>(cairo_image_surface_get_stride(surface)) *
+                                          static_cast<size_t>(cairo_image_surface_get_height(surface)) :
+                                  0U;
+    if (!reusable || bytes > MAX_SURFACE_BYTES) {
+        cairo_surface_destroy(surface);
+        return;
+    }
+
+    // Freed outside of the lock
+    std::vector<cairo_surface_t*> evicted;
+    {
+        Shared& shared = getShared();
+        std::lock_guard lock(shared.mutex);
+        shared.entries.push_back({surface, cairo_image_surface_get_format(surface),
+                                  cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface),
+                                  bytes});
+        shared.bytes += bytes;
+        while (shared.bytes > MAX_BYTES) {
+            evicted.push_back(shared.entries.front().surface);
+            shared.bytes -= shared.entries.front().bytes;
+            shared.entries.pop_front();
+        }
+    }
+    for (cairo_surface_t* s: evicted) {
+        cairo_surface_destroy(s);
+    }
+}
+
+void SurfacePool::clear() {
+    std::deque<Entry> entries;
+    {
+        Shared& shared = getShared();
+        std::lock_guard lock(shared.mutex);
+        entries.swap(shared.entries);
+        shared.bytes = 0;
+    }
+    for (const Entry& e: entries) {
+        cairo_surface_destroy(e.surface);
+    }
+}
+
+auto SurfacePool::getPooledBytes() -> size_t {
+    Shared& shared = getShared();
+    std::lock_guard lock(shared.mutex);
+    return shared.bytes;
+}
@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * Recycles the image surfaces of the masks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <deque>    // for deque
+#include <mutex>    // for mutex
+
+#include <cairo.h>  // for cairo_surface_t, cairo_format_t
+
+namespace xoj::view {
+
+/**
+ * @brief The image surfaces of the masks which were destroyed, to be reused by the next masks of the same format and
+ *      size instead of allocating (and clearing) new ones.
+ *
+ * The tiles of the rendered pages and the buffers of the render jobs are created and destroyed constantly, most of
+ * them with the same few sizes. The least recently released surfaces are freed first once the pool holds more than
+ * MAX_BYTES. Used by the render threads and the UI thread.
+ */
+class SurfacePool {
+public:
+    /// The total size of the surfaces kept
+    static constexpr size_t MAX_BYTES = 64 * 1024 * 1024;
+    /// The larger surfaces are never kept
+    static constexpr size_t MAX_SURFACE_BYTES = MAX_BYTES / 4;
+
+    /**
+     * @return A transparent image surface of this format and size in pixels: a new reference, to be released with
+     *      release()
+     */
+    static cairo_surface_t* acquire(cairo_format_t format, int width, int height);
+
+    /**
+     * Keep the surface to be reused by acquire(), if nothing else references it. Takes the reference.
+     */
+    static void release(cairo_surface_t* surface);
+
+    /**
+     * Free all the surfaces kept
+     */
+    static void clear();
+
+    /**
+     * @return The total size of the surfaces kept, in bytes
+     */
+    static size_t getPooledBytes();
+
+private:
+    struct Entry {
+        cairo_surface_t* surface;
+        cairo_format_t format;
+        int width;
+        int height;
+        size_t bytes;
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        /// Least recently released first
+        std::deque<Entry> entries;
+        size_t bytes = 0;
+    };
+
+    /// Never destroyed, as masks may still be destroyed during the destruction of the static objects
+    static Shared& getShared() {
+        static Shared* shared = new Shared();
+        return *shared;
+    }
+};
+};  // namespace xoj::view
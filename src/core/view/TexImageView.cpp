@@ -1,15 +1,15 @@
 #include "TexImageView.h"
 
-#include <string>  // for string
+#include <algorithm>  // for max
+#include <cmath>      // for abs
 
-#include <cairo.h>             // for cairo_paint_with_alpha, cairo_scale
-#include <glib.h>              // for g_warning
-#include <poppler-document.h>  // for poppler_document_get_n_pages, poppler_...
-#include <poppler-page.h>      // for poppler_page_render, poppler_page_get_...
-#include <poppler.h>           // for PopplerPage, PopplerDocument, g_clear_...
+#include <cairo.h>         // for cairo_paint_with_alpha, cairo_scale
+#include <poppler-page.h>  // for poppler_page_render, poppler_page_get_...
+#include <poppler.h>       // for PopplerPage
 
-#include "model/TexImage.h"  // for TexImage
-#include "view/View.h"       // for Context, OPACITY_NO_AUDIO, view
+#include "model/TexImage.h"           // for TexImage
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+#include "view/View.h"                // for Context, OPACITY_NO_AUDIO, view
 
 using namespace xoj::view;
 
@@ -22,17 +22,10 @@ void TexImageView::draw(const Context& ctx) const {
     cairo_t* cr = ctx.cr;
     cairo_save(cr);
 
-    PopplerDocument* pdf = texImage->getPdf();
+    PopplerPage* page = texImage->getPdfPage();
     cairo_surface_t* img = texImage->getImage();
 
-    if (pdf != nullptr) {
-        if (poppler_document_get_n_pages(pdf) < 1) {
-            g_warning("Got latex PDF without pages!: %s", texImage->getText().c_str());
-            return;
-        }
-
-        PopplerPage* page = poppler_document_get_page(pdf, 0);
-
+    if (page != nullptr) {
         double pageWidth = 0;
         double pageHeight = 0;
         poppler_page_get_size(page, &pageWidth, &pageHeight);
@@ -44,6 +37,30 @@ void TexImageView::draw(const Context& ctx) const {
         cairo_translate(cr, texImage->getX(), texImage->getY());
         cairo_scale(cr, xFactor, yFactor);
 
+        // Paint a cached rasterization on a raster surface. The other surfaces (PDF export, printing) get the vectors.
+        xoj::util::CairoSurfaceSPtr raster;
+        if (cairo_surface_get_type(cairo_get_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE) {
+            double w = pageWidth;
+            double h = pageHeight;
+            cairo_user_to_device_distance(cr, &w, &h);
+            double scaleX = 1;
+            double scaleY = 1;
+            cairo_surface_get_device_scale(cairo_get_target(cr), &scaleX, &scaleY);
+            double pixelsPerPoint = std::max(std::abs(w * scaleX) / pageWidth, std::abs(h * scaleY) / pageHeight);
+            raster = texImage->getPdfRaster(pixelsPerPoint);
+        }
+
+        auto paintPage = [&]() {
+            if (raster) {
+                double rasterScale = cairo_image_surface_get_width(raster.get()) / pageWidth;
+                cairo_scale(cr, 1 / rasterScale, 1 / rasterScale);
+                cairo_set_source_surface(cr, raster.get(), 0, 0);
+                cairo_paint(cr);
+            } else {
+                poppler_page_render(page, cr);
+            }
+        };
+
         // Make TeX images translucent when highlighting audio strokes as they can not have audio
         if (ctx.fadeOutNonAudio) {
             /**
@@ -51,16 +68,14 @@ void TexImageView::draw(const Context& ctx) const {
              * This sets the current pattern to the temporary surface.
              */
             cairo_push_group(cr);
-            poppler_page_render(page, cr);
+            paintPage();
             cairo_pop_group_to_source(cr);
 
             // paint the temporary surface with opacity level
             cairo_paint_with_alpha(cr, OPACITY_NO_AUDIO);
         } else {
-            poppler_page_render(page, cr);
+            paintPage();
         }
-
-        g_clear_object(&page);
     } else if (img != nullptr) {
         int width = cairo_image_surface_get_width(img);
         int height = cairo_image_surface_get_height(img);
@@ -7,7 +7,6 @@
 #include "util/Color.h"           // for cairo_set_source_rgbi
 #include "util/StringUtils.h"     // for StringUtils
 #include "util/raii/CairoWrappers.h"
-#include "util/raii/GObjectSPtr.h"
 #include "view/View.h"            // for Context, OPACITY_NO_AUDIO, view
 
 #include "filesystem.h"  // for path
@@ -18,14 +17,6 @@ TextView::TextView(const Text* text): text(text) {}
 
 TextView::~TextView() = default;
 
-auto TextView::initPango(cairo_t* cr, const Text* t) -> xoj::util::GObjectSPtr<PangoLayout> {
-    auto layout = t->createPangoLayout();
-    pango_cairo_update_layout(cr, layout.get());
-    pango_context_set_matrix(pango_layout_get_context(layout.get()), nullptr);
-
-    return layout;
-}
-
 void TextView::draw(const Context& ctx) const {
     if (text->isInEditing()) {
         // The drawing is handled by gui/TextEditor
@@ -45,9 +36,10 @@ void TextView::draw(const Context& ctx) const {
 
     cairo_translate(ctx.cr, text->getX(), text->getY());
 
-    auto layout = initPango(ctx.cr, text);
-    const std::string& content = text->getText();
-    pango_layout_set_text(layout.get(), content.c_str(), static_cast<int>(content.length()));
-
-    pango_cairo_show_layout(ctx.cr, layout.get());
+    // The layout is reused from one rendering to the other, with the font options of the target (e.g. no hinted
+    // metrics in PDF exports)
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(cairo_get_target(ctx.cr), options);
+    pango_cairo_show_layout(ctx.cr, text->getPangoLayout(options));
+    cairo_font_options_destroy(options);
 }
@@ -0,0 +1,116 @@
+#include "TiledBuffer.h"
+
+#include <algorithm>  // for min, max, sort
+
+#include "util/Assert.h"      // for xoj_assert
+#include "util/safe_casts.h"  // for ceil_cast, floor_cast, as_unsigned
+
+using namespace xoj::view;
+
+TiledBuffer::TiledBuffer(int DPIScaling, double zoom, double pageWidth, double pageHeight):
+        dpiScaling(DPIScaling),
+        zoom(zoom),
+        pixelWidth(ceil_cast<int>(pageWidth * zoom)),
+        pixelHeight(ceil_cast<int>(pageHeight * zoom)) {
+    xoj_assert(DPIScaling > 0);
+    xoj_assert(zoom > 0.0);
+    this->cols = (pixelWidth + TILE_SIZE - 1) / TILE_SIZE;
+    this->rows = (pixelHeight + TILE_SIZE - 1) / TILE_SIZE;
+}
+
+bool TiledBuffer::isInitialized() const { return zoom > 0.0; }
+
+bool TiledBuffer::empty() const { return tiles.empty(); }
+
+size_t TiledBuffer::getMemoryUsage() const {
+    size_t res = 0;
+    for (auto&& [key, tile]: tiles) {
+        auto ext = getTilePixelExtent(fromKey(key));
+        res += as_unsigned(ext.width * ext.height * dpiScaling * dpiScaling) * 4U;  // ARGB32
+    }
+    return res;
+}
+
+auto TiledBuffer::getMissingTiles(const Range& rg) const -> std::vector<TileIndex> {
+    std::vector<TileIndex> res;
+    if (!isInitialized() || rg.empty() || !rg.isValid()) {
+        return res;
+    }
+
+    const int minCol = std::max(0, floor_cast<int>(rg.minX * zoom) / TILE_SIZE);
+    const int minRow = std::max(0, floor_cast<int>(rg.minY * zoom) / TILE_SIZE);
+    const int maxCol = std::min(cols - 1, (ceil_cast<int>(rg.maxX * zoom) - 1) / TILE_SIZE);
+    const int maxRow = std::min(rows - 1, (ceil_cast<int>(rg.maxY * zoom) - 1) / TILE_SIZE);
+
+    for (int row = minRow; row <= maxRow; row++) {
+        for (int col = minCol; col <= maxCol; col++) {
+            TileIndex tile{col, row};
+            if (tiles.find(toKey(tile)) == tiles.end()) {
+                res.push_back(tile);
+            }
+        }
+    }
+    return res;
+}
+
+auto TiledBuffer::getTilePixelExtent(const TileIndex& tile) const -> xoj::util::Rectangle<int> {
+    const int x = tile.col * TILE_SIZE;
+    const int y = tile.row * TILE_SIZE;
+    return {x, y, std::min(TILE_SIZE, pixelWidth - x), std::min(TILE_SIZE, pixelHeight - y)};
+}
+
+auto TiledBuffer::getPixelExtent(const std::vector<TileIndex>& tileList) const -> xoj::util::Rectangle<int> {
+    xoj_assert(!tileList.empty());
+    auto res = getTilePixelExtent(tileList.front());
+    for (auto&& t: tileList) { res.unite(getTilePixelExtent(t)); }
+    return res;
+}
+
+auto TiledBuffer::getTileRange(const TileIndex& tile) const -> Range {
+    auto ext = getTilePixelExtent(tile);
+    return Range(ext.x / zoom, ext.y / zoom, (ext.x + ext.width) / zoom, (ext.y + ext.height) / zoom);
+}
+
+bool TiledBuffer::intersects(const TileIndex& tile, const Range& rg) const {
+    Range tileRange = getTileRange(tile);
+    return tileRange.minX < rg.maxX && rg.minX < tileRange.maxX && tileRange.minY < rg.maxY && rg.minY < tileRange.maxY;
+}
+
+void TiledBuffer::insertTiles(const std::vector<TileIndex>& tileList, const Mask& source) {
+    xoj_assert(isInitialized());
+    xoj_assert(source.getZoom() == zoom);
+    for (auto&& t: tileList) {
+        Mask mask(dpiScaling, getTilePixelExtent(t), zoom, CAIRO_CONTENT_COLOR_ALPHA);
+        source.paintTo(mask.get());
+        tiles.insert_or_assign(toKey(t), Tile{std::move(mask), ++useCounter});
+    }
+}
+
+void TiledBuffer::paintTo(cairo_t* cr, const Range& rg) {
+    for (auto&& [key, tile]: tiles) {
+        if (intersects(fromKey(key), rg)) {
+            tile.mask.paintTo(cr);
+            tile.lastUse = ++useCounter;
+        }
+    }
+}
+
+void TiledBuffer::evictTiles(const Range& keep, size_t maxTiles) {
+    if (tiles.size() <= maxTiles) {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> candidates;  // (lastUse, key)
+    for (auto&& [key, tile]: tiles) {
+        if (keep.empty() || !intersects(fromKey(key), keep)) {
+            candidates.emplace_back(tile.lastUse, key);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (auto it = candidates.begin(); it != candidates.end() && tiles.size() > maxTiles; ++it) {
+        tiles.erase(it->second);
+    }
+}
+
+void TiledBuffer::reset() { *this = TiledBuffer(); }
@@ -0,0 +1,158 @@
+/*
+ * Xournal++
+ *
+ * Tiled backing store of a page view
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include <cairo.h>  // for cairo_t
+
+#include "util/Range.h"      // for Range
+#include "util/Rectangle.h"  // for Rectangle
+
+#include "Mask.h"  // for Mask
+
+namespace xoj::view {
+
+/**
+ * @brief Backing store of a page, made of square tiles of TILE_SIZE x TILE_SIZE device pixels.
+ *
+ * All the tiles of a TiledBuffer are rendered at the same zoom level: a zoom change requires a new TiledBuffer (the
+ * old one can still be painted, scaled, until the new one is ready).
+ * Only the tiles that are actually needed (typically those intersecting the visible part of the page) get rendered.
+ * The tiles are evicted in least recently painted order.
+ *
+ * The class is not thread safe: the owner is responsible for locking.
+ */
+class TiledBuffer {
+public:
+    /// Size of the tiles, in device pixels (i.e. before DPI scaling)
+    static constexpr int TILE_SIZE = 256;
+    /// Default maximal number of tiles kept in a buffer (32MiB of ARGB32 tiles without DPI scaling)
+    static constexpr size_t DEFAULT_MAX_TILES = 128;
+
+    struct TileIndex {
+        int col;
+        int row;
+    };
+
+    TiledBuffer() = default;
+    /**
+     * @param DPIScaling The DPI scaling of the monitor
+     * @param zoom The zoom at which the tiles are rendered
+     * @param pageWidth, pageHeight The size of the page, in page coordinates
+     */
+    TiledBuffer(int DPIScaling, double zoom, double pageWidth, double pageHeight);
+
+    /**
+     * @return true if the buffer has been set up for a given zoom (it may contain no tile yet)
+     */
+    bool isInitialized() const;
+
+    /**
+     * @return true if no tile has been rendered
+     */
+    bool empty() const;
+
+    /**
+     * @return The memory used by the rendered tiles, in bytes
+     */
+    size_t getMemoryUsage() const;
+
+    inline double getZoom() const { return zoom; }
+    inline int getDPIScaling() const { return dpiScaling; }
+
+    /**
+     * @brief Get the tiles intersecting the given range (in page coordinates) that have not been rendered yet.
+     *      The tiles are listed in row-major order.
+     */
+    std::vector<TileIndex> getMissingTiles(const Range& rg) const;
+
+    /**
+     * @return The extent of the tile, in device pixels
+     */
+    xoj::util::Rectangle<int> getTilePixelExtent(const TileIndex& tile) const;
+
+    /**
+     * @return The bounding box of the tiles, in device pixels
+     */
+    xoj::util::Rectangle<int> getPixelExtent(const std::vector<TileIndex>& tiles) const;
+
+    /**
+     * @brief Create the given tiles by cutting them out of a mask covering them (typically a mask whose extent was
+     *      given by getPixelExtent(tiles)). The mask must have been rendered at the buffer's zoom.
+     */
+    void insertTiles(const std::vector<TileIndex>& tiles, const Mask& source);
+
+    /**
+     * @brief Paint the tiles intersecting the given range to the cairo context.
+     * @param cr A cairo context in page coordinates
+     * @param rg The range (in page coordinates) to paint
+     */
+    void paintTo(cairo_t* cr, const Range& rg);
+
+    /**
+     * @brief Call fn(cairo_t*) on the context of every rendered tile intersecting the given range.
+     *      The contexts are in page coordinates.
+     */
+    template <typename Fn>
+    void forEachTile(const Range& rg, Fn&& fn) {
+        for (auto&& [key, tile]: tiles) {
+            if (intersects(fromKey(key), rg)) {
+                fn(tile.mask.get());
+            }
+        }
+    }
+
+    /**
+     * @brief Evict the least recently painted tiles until at most maxTiles remain.
+     *      Tiles intersecting `keep` are never evicted.
+     */
+    void evictTiles(const Range& keep, size_t maxTiles = DEFAULT_MAX_TILES);
+
+    /**
+     * @brief Delete all the tiles. The buffer is no longer initialized afterwards.
+     */
+    void reset();
+
+private:
+    static constexpr uint64_t toKey(const TileIndex& tile) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(tile.row)) << 32) | static_cast<uint32_t>(tile.col);
+    }
+    static constexpr TileIndex fromKey(uint64_t key) {
+        return {static_cast<int>(static_cast<uint32_t>(key)), static_cast<int>(static_cast<uint32_t>(key >> 32))};
+    }
+
+    /// Range of the tile, in page coordinates
+    Range getTileRange(const TileIndex& tile) const;
+    bool intersects(const TileIndex& tile, const Range& rg) const;
+
+    struct Tile {
+        Mask mask;
+        uint64_t lastUse;
+    };
+
+    std::unordered_map<uint64_t, Tile> tiles;
+
+    int dpiScaling = 0;
+    double zoom = 0.0;
+    /// Size of the page, in device pixels
+    int pixelWidth = 0;
+    int pixelHeight = 0;
+    int cols = 0;
+    int rows = 0;
+
+    uint64_t useCounter = 0;
+};
+};  // namespace xoj::view
@@ -18,6 +18,8 @@ enum ImageBackgroundTreatment : bool { SHOW_IMAGE_BACKGROUND = true, HIDE_IMAGE_
 enum RulingBackgroundTreatment : bool { SHOW_RULING_BACKGROUND = true, HIDE_RULING_BACKGROUND = false };
 enum BackgroundColorTreatment : bool { FORCE_AT_LEAST_BACKGROUND_COLOR = true, DONT_FORCE_BACKGROUND_COLOR = false };
 enum VisibilityTreatment : bool { FORCE_VISIBLE = true, USE_DOCUMENT_VISIBILITY = false };
+enum PDFCacheTreatment : bool { ONLY_USE_CACHED_PDF = true, RENDER_PDF_IF_NEEDED = false };
+enum PDFRasterizationTreatment : bool { WAIT_FOR_PDF_RASTERIZATION = true, RASTERIZE_PDF_ASYNCHRONOUSLY = false };
 
 struct BackgroundFlags {
     PDFBackgroundTreatment showPDF;
@@ -25,6 +27,11 @@ struct BackgroundFlags {
     RulingBackgroundTreatment showRuling;
     BackgroundColorTreatment forceBackgroundColor = DONT_FORCE_BACKGROUND_COLOR;
     VisibilityTreatment forceVisible = USE_DOCUMENT_VISIBILITY;
+    /// If ONLY_USE_CACHED_PDF, PDF backgrounds are painted (scaled) from the PdfCache, or left blank if not cached
+    PDFCacheTreatment onlyCachedPdf = RENDER_PDF_IF_NEEDED;
+    /// If WAIT_FOR_PDF_RASTERIZATION, the PDF pages missing from the PdfCache are rasterized right away, even if the
+    /// cache rasterizes them asynchronously for the main view
+    PDFRasterizationTreatment waitForPdf = RASTERIZE_PDF_ASYNCHRONOUSLY;
 };
 
 static constexpr BackgroundFlags BACKGROUND_SHOW_ALL = {SHOW_PDF_BACKGROUND, SHOW_IMAGE_BACKGROUND,
@@ -0,0 +1,178 @@
+#include "BackgroundTile.h"
+
+#include <algorithm>   // for max
+#include <cmath>       // for ceil, lround
+#include <cstdint>     // for uint32_t
+#include <functional>  // for less
+#include <list>        // for list
+#include <map>         // for map
+#include <mutex>       // for mutex, lock_guard
+#include <tuple>       // for tie
+#include <utility>     // for move, pair
+#include <vector>      // for vector
+
+#include "util/raii/CairoWrappers.h"  // for CairoSurfaceSPtr
+
+using namespace xoj::view;
+
+namespace {
+struct TileKey {
+    BackgroundTile::Motif motif;
+    double width;
+    double height;
+    double lineWidth;
+    uint32_t color;
+    cairo_line_cap_t lineCap;
+    int periodsX;  ///< Number of periods in the tile
+    int periodsY;
+    int pixelsX;  ///< Size of the tile
+    int pixelsY;
+
+    bool operator<(const TileKey& o) const {
+        if (motif != o.motif) {
+            return std::less<BackgroundTile::Motif>()(motif, o.motif);
+        }
+        return std::tie(width, height, lineWidth, color, lineCap, periodsX, periodsY, pixelsX, pixelsY) <
+               std::tie(o.width, o.height, o.lineWidth, o.color, o.lineCap, o.periodsX, o.periodsY, o.pixelsX,
+                        o.pixelsY);
+    }
+};
+
+/// The rendered tiles, released least recently used first beyond BackgroundTile::CACHE_BUDGET
+class TileCache {
+public:
+    /// @return The cached tile, now the most recently used one, or nullptr
+    auto get(const TileKey& key) -> xoj::util::CairoSurfaceSPtr {
+        std::lock_guard lock(this->mutex);
+        auto it = this->entries.find(key);
+        if (it == this->entries.end()) {
+            return {};
+        }
+        this->lru.splice(this->lru.end(), this->lru, it->second.lruPosition);
+        return it->second.surface;
+    }
+
+    void add(const TileKey& key, const xoj::util::CairoSurfaceSPtr& surface) {
+        const size_t bytes = static_cast<size_t>(cairo_image_surface_get_stride(surface.get())) *
+                             static_cast<size_t>(cairo_image_surface_get_height(surface.get()));
+        std::vector<xoj::util::CairoSurfaceSPtr> released;  // Destroyed once the cache is unlocked
+        std::lock_guard lock(this->mutex);
+        if (this->entries.count(key)) {
+            return;
+        }
+        auto position = this->lru.insert(this->lru.end(), key);
+        this->entries.emplace(key, Entry{surface, bytes, position});
+        this->bytes += bytes;
+        while (this->bytes > BackgroundTile::CACHE_BUDGET && this->lru.size() > 1) {
+            auto it = this->entries.find(this->lru.front());
+            released.emplace_back(std::move(it->second.surface));
+            this->bytes -= it->second.bytes;
+            this->lru.pop_front();
+            this->entries.erase(it);
+        }
+    }
+
+private:
+    struct Entry {
+        xoj::util::CairoSurfaceSPtr surface;
+        size_t bytes;
+        std::list<TileKey>::iterator lruPosition;
+    };
+
+    std::mutex mutex;
+    std::map<TileKey, Entry> entries;
+    std::list<TileKey> lru;  ///< Least recently used first
+    size_t bytes = 0;
+};
+
+auto getTileCache() -> TileCache& {
+    static TileCache cache;
+    return cache;
+}
+
+auto render(const TileKey& key) -> xoj::util::CairoSurfaceSPtr {
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, key.pixelsX, key.pixelsY),
+                                        xoj::util::adopt);
+    cairo_t* cr = cairo_create(surface.get());
+    cairo_scale(cr, key.pixelsX / (key.periodsX * key.width), key.pixelsY / (key.periodsY * key.height));
+    // The neighbouring periods overlap the borders of the tile, so that it repeats seamlessly
+    for (int i = -1; i <= key.periodsX; i++) {
+        for (int j = -1; j <= key.periodsY; j++) {
+            cairo_save(cr);
+            cairo_translate(cr, i * key.width, j * key.height);
+            key.motif(cr, key.width, key.height);
+            cairo_restore(cr);
+        }
+    }
+    Util::cairo_set_source_rgbi(cr, Color(key.color));
+    cairo_set_line_width(cr, key.lineWidth);
+    cairo_set_line_cap(cr, key.lineCap);
+    cairo_stroke(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+/// @return The number of periods in a tile and its size in pixels, or {0, 0} if a period is too large
+auto getTileSize(double periodPixels) -> std::pair<int, int> {
+    if (periodPixels > BackgroundTile::MAX_TILE_SIZE) {
+        return {0, 0};
+    }
+    const int periods = std::max(1, static_cast<int>(std::ceil(BackgroundTile::MIN_TILE_SIZE / periodPixels)));
+    return {periods, static_cast<int>(std::lround(periods * periodPixels))};
+}
+}  // namespace
+
+BackgroundTile::BackgroundTile(Motif motif, double width, double height, double lineWidth, Color color,
+                               cairo_line_cap_t lineCap):
+        motif(motif), width(width), height(height), lineWidth(lineWidth), color(color), lineCap(lineCap) {}
+
+bool BackgroundTile::paint(cairo_t* cr, double originX, double originY, double rectX, double rectY,
+                           double rectWidth, double rectHeight) const {
+    cairo_surface_t* target = cairo_get_group_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return false;
+    }
+    // Lines thicker than a period would bleed out of the rectangle from the neighbouring periods
+    if (this->width <= this->lineWidth || this->height <= this->lineWidth) {
+        return false;
+    }
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cr, &matrix);
+    if (matrix.xy != 0.0 || matrix.yx != 0.0 || matrix.xx <= 0.0 || matrix.yy <= 0.0) {
+        return false;
+    }
+    double deviceScaleX = 1;
+    double deviceScaleY = 1;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+
+    auto [periodsX, pixelsX] = getTileSize(this->width * matrix.xx * deviceScaleX);
+    auto [periodsY, pixelsY] = getTileSize(this->height * matrix.yy * deviceScaleY);
+    if (pixelsX <= 0 || pixelsY <= 0) {
+        return false;
+    }
+
+    // The tiles are shared by all the zoom levels giving the same number of pixels
+    TileKey key{this->motif, this->width, this->height, this->lineWidth, uint32_t(this->color), this->lineCap,
+                periodsX,    periodsY,    pixelsX,      pixelsY};
+    auto& cache = getTileCache();
+    auto tile = cache.get(key);
+    if (!tile) {
+        tile = render(key);
+        cache.add(key, tile);
+    }
+
+    cairo_pattern_t* pattern = cairo_pattern_create_for_surface(tile.get());
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+    cairo_matrix_t patternMatrix;
+    cairo_matrix_init_scale(&patternMatrix, pixelsX / (periodsX * this->width), pixelsY / (periodsY * this->height));
+    cairo_matrix_translate(&patternMatrix, -originX, -originY);
+    cairo_pattern_set_matrix(pattern, &patternMatrix);
+
+    cairo_save(cr);
+    cairo_set_source(cr, pattern);
+    cairo_rectangle(cr, rectX, rectY, rectWidth, rectHeight);
+    cairo_fill(cr);
+    cairo_restore(cr);
+    cairo_pattern_destroy(pattern);
+    return true;
+}
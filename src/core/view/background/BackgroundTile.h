@@ -0,0 +1,60 @@
+/*
+ * Xournal++
+ *
+ * Periodic motif of a background, painted from a cached tile
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+#include <cairo.h>  // for cairo_t, cairo_line_cap_t
+
+#include "util/Color.h"  // for Color
+
+namespace xoj::view {
+/**
+ * @brief Motif of a ruled background, repeated with a fixed period (e.g. the lines of a graph or the dots of a dotted
+ * page).
+ *
+ * On raster surfaces, the motif is rendered once in a tile spanning a few periods, at the resolution of the surface,
+ * and the page is filled with a repeating pattern of this tile. The tiles are kept in a cache shared by all the pages,
+ * so that the many pages of a grid layout at a low zoom level only cost one fill each.
+ */
+class BackgroundTile {
+public:
+    /// Adds the paths of one period of the motif, i.e. in [0, width] x [0, height], to cr
+    using Motif = void (*)(cairo_t* cr, double width, double height);
+
+    BackgroundTile(Motif motif, double width, double height, double lineWidth, Color color, cairo_line_cap_t lineCap);
+
+    /**
+     * @brief Fills the rectangle with the motif, with one period starting at (originX, originY)
+     *
+     * @return false if nothing was painted, and the caller should stroke the paths of the motif instead. This is the
+     * case on vector surfaces (PDF export, printing), on rotated surfaces and when the tile would be too large.
+     */
+    bool paint(cairo_t* cr, double originX, double originY, double rectX, double rectY, double rectWidth,
+               double rectHeight) const;
+
+    /// Memory used by the cached tiles, in bytes
+    static constexpr size_t CACHE_BUDGET = 16 * 1024 * 1024;
+
+    /// Bounds on the size of the tiles, in pixels
+    static constexpr int MIN_TILE_SIZE = 64;
+    static constexpr int MAX_TILE_SIZE = 512;
+
+private:
+    Motif motif;
+    double width;
+    double height;
+    double lineWidth;
+    Color color;
+    cairo_line_cap_t lineCap;
+};
+};  // namespace xoj::view
@@ -57,7 +57,7 @@ auto BackgroundView::createRuled(double width, double height, Color backgroundCo
 }
 
 auto BackgroundView::createForPage(PageRef page, BackgroundFlags bgFlags, PdfCache* pdfCache)
-        -> std::unique_ptr<BackgroundView> {
+        -> std::shared_ptr<const BackgroundView> {
     const double width = page->getWidth();
     const double height = page->getHeight();
     if (!bgFlags.forceVisible && !page->isLayerVisible(0)) {
@@ -74,7 +74,8 @@ auto BackgroundView::createForPage(PageRef page, BackgroundFlags bgFlags, PdfCac
                 break;
             case PageTypeFormat::Pdf:
                 if (bgFlags.showPDF) {
-                    return std::make_unique<PdfBackgroundView>(width, height, page->getPdfPageNr(), pdfCache);
+                    return std::make_unique<PdfBackgroundView>(width, height, page->getPdfPageNr(), pdfCache,
+                                                               bgFlags.onlyCachedPdf, bgFlags.waitForPdf);
                 }
                 break;
             default:
@@ -83,7 +84,12 @@ auto BackgroundView::createForPage(PageRef page, BackgroundFlags bgFlags, PdfCac
         }
     } else {
         if (bgFlags.showRuling) {
-            return createRuled(width, height, page->getBackgroundColor(), pt);
+            if (auto cached = page->getCachedBackgroundView()) {
+                return cached;
+            }
+            std::shared_ptr<const BackgroundView> view = createRuled(width, height, page->getBackgroundColor(), pt);
+            page->setCachedBackgroundView(view);
+            return view;
         }
     }
 
@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include <memory>  // for unique_ptr
+#include <memory>  // for unique_ptr, shared_ptr
 
 #include <cairo.h>  // for cairo_t
 
@@ -40,8 +40,13 @@ public:
     [[nodiscard]] static std::unique_ptr<BackgroundView> createRuled(double width, double height, Color backgroundColor,
                                                                      const PageType& pt, double lineWidthFactor = 1.0);
 
-    [[nodiscard]] static std::unique_ptr<BackgroundView> createForPage(PageRef page, xoj::view::BackgroundFlags bgFlags,
-                                                                       PdfCache* pdfCache = nullptr);
+    /**
+     * @brief The view of the background of the page. The views of the rulings are kept by the page (see
+     * XojPage::getCachedBackgroundView()), so that their configuration is only parsed once.
+     */
+    [[nodiscard]] static std::shared_ptr<const BackgroundView> createForPage(PageRef page,
+                                                                             xoj::view::BackgroundFlags bgFlags,
+                                                                             PdfCache* pdfCache = nullptr);
 
 protected:
     double pageWidth;
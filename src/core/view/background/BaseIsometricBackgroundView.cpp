@@ -38,44 +38,46 @@ void BaseIsometricBackgroundView::draw(cairo_t* cr) const {
     double contentXOffset = (pageWidth - contentWidth) / 2;
     double contentYOffset = (pageHeight - contentHeight) / 2;
 
-    // Get the bounds of the mask, in page coordinates
-    double minX;
-    double maxX;
-    double minY;
-    double maxY;
-    cairo_clip_extents(cr, &minX, &minY, &maxX, &maxY);
-
-    // Get the indices we need to paint (= on or near the mask)
-    const double halfLineWidth = 0.5 * lineWidth;
-    auto [indexMinX, indexMaxX] =
-            getIndexBounds(minX - halfLineWidth - xstep - contentXOffset, maxX + halfLineWidth + xstep - contentXOffset,
-                           xstep, 0.0, contentWidth);
-    auto [indexMinY, indexMaxY] =
-            getIndexBounds(minY - halfLineWidth - ystep - contentYOffset, maxY + halfLineWidth + ystep - contentYOffset,
-                           ystep, 0.0, contentHeight);
-
-    if ((indexMinY + indexMinX) % 2) {
-        /** The painted area should start with \/\/\/...
-         *                                     /\/\/\/..
-         *
-         * Enlarge by 1 so that it starts with /\/\/...
-         *                                     \/\/\/..
-         */
-        if (indexMinX) {
-            --indexMinX;
-        } else {
-            --indexMinY;
+    if (!paintTiled(cr, xstep, ystep, contentXOffset, contentYOffset, contentWidth, contentHeight)) {
+        // Get the bounds of the mask, in page coordinates
+        double minX;
+        double maxX;
+        double minY;
+        double maxY;
+        cairo_clip_extents(cr, &minX, &minY, &maxX, &maxY);
+
+        // Get the indices we need to paint (= on or near the mask)
+        const double halfLineWidth = 0.5 * lineWidth;
+        auto [indexMinX, indexMaxX] = getIndexBounds(minX - halfLineWidth - xstep - contentXOffset,
+                                                       maxX + halfLineWidth + xstep - contentXOffset, xstep, 0.0,
+                                                       contentWidth);
+        auto [indexMinY, indexMaxY] = getIndexBounds(minY - halfLineWidth - ystep - contentYOffset,
+                                                       maxY + halfLineWidth + ystep - contentYOffset, ystep, 0.0,
+                                                       contentHeight);
+
+        if ((indexMinY + indexMinX) % 2) {
+            /** The painted area should start with \/\/\/...
+             *                                     /\/\/\/..
+             *
+             * Enlarge by 1 so that it starts with /\/\/...
+             *                                     \/\/\/..
+             */
+            if (indexMinX) {
+                --indexMinX;
+            } else {
+                --indexMinY;
+            }
         }
-    }
 
-    // Compute the offset and the number of steps within the mask
-    contentXOffset += indexMinX * xstep;
-    contentYOffset += indexMinY * ystep;
+        // Compute the offset and the number of steps within the mask
+        contentXOffset += indexMinX * xstep;
+        contentYOffset += indexMinY * ystep;
 
-    cols = indexMaxX - indexMinX;
-    rows = indexMaxY - indexMinY;
+        cols = indexMaxX - indexMinX;
+        rows = indexMaxY - indexMinY;
 
-    paintGrid(cr, cols, rows, xstep, ystep, contentXOffset, contentYOffset);
+        paintGrid(cr, cols, rows, xstep, ystep, contentXOffset, contentYOffset);
+    }
 
     cairo_save(cr);
     Util::cairo_set_source_rgbi(cr, foregroundColor);
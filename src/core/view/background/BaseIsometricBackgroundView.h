@@ -32,6 +32,14 @@ protected:
     virtual void paintGrid(cairo_t* cr, int cols, int rows, double xstep, double ystep, double xOffset,
                            double yOffset) const = 0;
 
+    /**
+     * @brief Paints the grid on the whole content area from cached tiles (see BackgroundTile), and adds the paths of
+     * the lines which are not periodic to cr.
+     * @return false if nothing was painted, and the grid should be drawn by paintGrid() instead
+     */
+    virtual bool paintTiled(cairo_t* cr, double xstep, double ystep, double xOffset, double yOffset,
+                            double contentWidth, double contentHeight) const = 0;
+
 protected:
     double triangleSize = 14.17;  // 5mm
 
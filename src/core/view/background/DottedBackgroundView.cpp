@@ -7,9 +7,18 @@
 #include "view/background/OneColorBackgroundView.h"  // for OneColorBackgrou...
 #include "view/background/PlainBackgroundView.h"     // for PlainBackgroundView
 
+#include "BackgroundTile.h"  // for BackgroundTile
+
 using namespace background_config_strings;
 using namespace xoj::view;
 
+namespace {
+void addDot(cairo_t* cr, double, double) {
+    cairo_move_to(cr, 0.0, 0.0);
+    cairo_line_to(cr, 0.0, 0.0);
+}
+}  // namespace
+
 DottedBackgroundView::DottedBackgroundView(double pageWidth, double pageHeight, Color backgroundColor,
                                            const BackgroundConfig& config):
         OneColorBackgroundView(pageWidth, pageHeight, backgroundColor, config, DEFAULT_LINE_WIDTH, DEFAULT_LINE_COLOR,
@@ -36,6 +45,17 @@ void DottedBackgroundView::draw(cairo_t* cr) const {
             getIndexBounds(minX - halfLineWidth, maxX + halfLineWidth, squareSize, squareSize, pageWidth);
     auto [indexMinY, indexMaxY] =
             getIndexBounds(minY - halfLineWidth, maxY + halfLineWidth, squareSize, squareSize, pageHeight);
+    if (indexMinX > indexMaxX || indexMinY > indexMaxY) {
+        return;
+    }
+
+    BackgroundTile tile(addDot, squareSize, squareSize, lineWidth, foregroundColor, CAIRO_LINE_CAP_ROUND);
+    const double tiledWidth = (indexMaxX - indexMinX) * squareSize + lineWidth;
+    const double tiledHeight = (indexMaxY - indexMinY) * squareSize + lineWidth;
+    if (tile.paint(cr, 0.0, 0.0, indexMinX * squareSize - halfLineWidth, indexMinY * squareSize - halfLineWidth,
+                   tiledWidth, tiledHeight)) {
+        return;
+    }
 
     for (int i = indexMinX; i <= indexMaxX; ++i) {
         double x = i * squareSize;
@@ -8,9 +8,23 @@
 #include "view/background/OneColorBackgroundView.h"  // for OneColorBackgrou...
 #include "view/background/PlainBackgroundView.h"     // for PlainBackgroundView
 
+#include "BackgroundTile.h"  // for BackgroundTile
+
 using namespace background_config_strings;
 using namespace xoj::view;
 
+namespace {
+void addVerticalLine(cairo_t* cr, double, double height) {
+    cairo_move_to(cr, 0.0, 0.0);
+    cairo_line_to(cr, 0.0, height);
+}
+
+void addHorizontalLine(cairo_t* cr, double width, double) {
+    cairo_move_to(cr, 0.0, 0.0);
+    cairo_line_to(cr, width, 0.0);
+}
+}  // namespace
+
 GraphBackgroundView::GraphBackgroundView(double pageWidth, double pageHeight, Color backgroundColor,
                                          const BackgroundConfig& config):
         OneColorBackgroundView(pageWidth, pageHeight, backgroundColor, config, DEFAULT_LINE_WIDTH, DEFAULT_LINE_COLOR,
@@ -61,6 +75,19 @@ void GraphBackgroundView::draw(cairo_t* cr) const {
         maxY = std::min(maxY, squareSize * pageIndexMaxY);
     }
 
+    // The square caps of the lines extend the rectangles by halfLineWidth
+    if (indexMinX <= indexMaxX && indexMinY <= indexMaxY) {
+        BackgroundTile vLines(addVerticalLine, squareSize, squareSize, lineWidth, foregroundColor, CAIRO_LINE_CAP_BUTT);
+        BackgroundTile hLines(addHorizontalLine, squareSize, squareSize, lineWidth, foregroundColor,
+                              CAIRO_LINE_CAP_BUTT);
+        if (vLines.paint(cr, 0.0, 0.0, indexMinX * squareSize - halfLineWidth, minY - halfLineWidth,
+                         (indexMaxX - indexMinX) * squareSize + lineWidth, maxY - minY + lineWidth)) {
+            hLines.paint(cr, 0.0, 0.0, minX - halfLineWidth, indexMinY * squareSize - halfLineWidth,
+                         maxX - minX + lineWidth, (indexMaxY - indexMinY) * squareSize + lineWidth);
+            return;
+        }
+    }
+
     for (int i = indexMinX; i <= indexMaxX; ++i) {
         cairo_move_to(cr, i * squareSize, minY);
         cairo_line_to(cr, i * squareSize, maxY);
@@ -4,8 +4,20 @@
 #include "view/background/BackgroundView.h"               // for view
 #include "view/background/BaseIsometricBackgroundView.h"  // for BaseIsometr...
 
+#include "BackgroundTile.h"  // for BackgroundTile
+
 using namespace xoj::view;
 
+namespace {
+/// The dots of a period of two columns and two rows
+void addDots(cairo_t* cr, double width, double height) {
+    cairo_move_to(cr, 0.5 * width, 0.0);
+    cairo_line_to(cr, 0.5 * width, 0.0);
+    cairo_move_to(cr, 0.0, 0.5 * height);
+    cairo_line_to(cr, 0.0, 0.5 * height);
+}
+}  // namespace
+
 IsoDottedBackgroundView::IsoDottedBackgroundView(double pageWidth, double pageHeight, Color backgroundColor,
                                                  const BackgroundConfig& config):
         BaseIsometricBackgroundView(pageWidth, pageHeight, backgroundColor, config, DEFAULT_LINE_WIDTH) {}
@@ -32,3 +44,11 @@ void IsoDottedBackgroundView::paintGrid(cairo_t* cr, int cols, int rows, double
         }
     }
 }
+
+bool IsoDottedBackgroundView::paintTiled(cairo_t* cr, double xstep, double ystep, double xOffset, double yOffset,
+                                         double contentWidth, double contentHeight) const {
+    BackgroundTile tile(addDots, 2 * xstep, 2 * ystep, lineWidth, foregroundColor, CAIRO_LINE_CAP_ROUND);
+    const double halfLineWidth = 0.5 * lineWidth;
+    return tile.paint(cr, xOffset, yOffset, xOffset - halfLineWidth, yOffset - halfLineWidth, contentWidth + lineWidth,
+                      contentHeight + lineWidth);
+}
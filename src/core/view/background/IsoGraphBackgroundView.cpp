@@ -5,8 +5,28 @@
 #include "view/background/BackgroundView.h"               // for view
 #include "view/background/BaseIsometricBackgroundView.h"  // for BaseIsometr...
 
+#include "BackgroundTile.h"  // for BackgroundTile
+
 using namespace xoj::view;
 
+namespace {
+/// The vertical lines and the diagonals of a period of two columns and two rows
+void addCell(cairo_t* cr, double width, double height) {
+    const double x = 0.5 * width;
+    const double y = 0.5 * height;
+    auto addLine = [cr](double x1, double y1, double x2, double y2) {
+        cairo_move_to(cr, x1, y1);
+        cairo_line_to(cr, x2, y2);
+    };
+    addLine(0.0, 0.0, 0.0, height);
+    addLine(x, 0.0, x, height);
+    addLine(x, 0.0, 0.0, y);
+    addLine(0.0, y, x, height);
+    addLine(x, 0.0, width, y);
+    addLine(width, y, x, height);
+}
+}  // namespace
+
 IsoGraphBackgroundView::IsoGraphBackgroundView(double pageWidth, double pageHeight, Color backgroundColor,
                                                const BackgroundConfig& config):
         BaseIsometricBackgroundView(pageWidth, pageHeight, backgroundColor, config, DEFAULT_LINE_WIDTH) {}
@@ -87,3 +107,21 @@ void IsoGraphBackgroundView::paintGrid(cairo_t* cr, int cols, int rows, double x
         drawLine(x1, y1, x2, y2);
     }
 }
+
+bool IsoGraphBackgroundView::paintTiled(cairo_t* cr, double xstep, double ystep, double xOffset, double yOffset,
+                                        double contentWidth, double contentHeight) const {
+    // The lines of the tiles may overflow the content area by halfLineWidth, under the lines of its border
+    BackgroundTile tile(addCell, 2 * xstep, 2 * ystep, lineWidth, foregroundColor, CAIRO_LINE_CAP_ROUND);
+    const double halfLineWidth = 0.5 * lineWidth;
+    if (!tile.paint(cr, xOffset, yOffset, xOffset - halfLineWidth, yOffset - halfLineWidth, contentWidth + lineWidth,
+                    contentHeight + lineWidth)) {
+        return false;
+    }
+
+    // Horizontal lines on top and bottom
+    cairo_move_to(cr, xOffset, yOffset);
+    cairo_line_to(cr, xOffset + contentWidth, yOffset);
+    cairo_move_to(cr, xOffset, yOffset + contentHeight);
+    cairo_line_to(cr, xOffset + contentWidth, yOffset + contentHeight);
+    return true;
+}
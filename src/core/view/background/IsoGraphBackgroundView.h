@@ -28,6 +28,8 @@ public:
 protected:
     virtual void paintGrid(cairo_t* cr, int cols, int rows, double xstep, double ystep, double xOffset,
                            double yOffset) const override;
+    virtual bool paintTiled(cairo_t* cr, double xstep, double ystep, double xOffset, double yOffset,
+                            double contentWidth, double contentHeight) const override;
 
 protected:
     constexpr static double DEFAULT_LINE_WIDTH = 1.0;
@@ -8,11 +8,23 @@
 
 using namespace xoj::view;
 
-PdfBackgroundView::PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache):
-        BackgroundView(pageWidth, pageHeight), pageNo(pageNo), pdfCache(pdfCache) {}
+PdfBackgroundView::PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache,
+                                     PDFCacheTreatment onlyCachedPdf, PDFRasterizationTreatment waitForPdf):
+        BackgroundView(pageWidth, pageHeight),
+        pageNo(pageNo),
+        pdfCache(pdfCache),
+        onlyCachedPdf(onlyCachedPdf),
+        waitForPdf(waitForPdf) {}
 
 void PdfBackgroundView::draw(cairo_t* cr) const {
-    if (pdfCache) {
+    if (pdfCache && onlyCachedPdf) {
+        if (!pdfCache->renderCached(cr, pageNo)) {
+            // Not rendered yet: leave a blank page instead of waiting for poppler
+            cairo_set_source_rgb(cr, 1.0, 1.0, 1.0);
+            cairo_rectangle(cr, 0, 0, pageWidth, pageHeight);
+            cairo_fill(cr);
+        }
+    } else if (pdfCache) {
         // get zoom from cairo
         cairo_matrix_t matrix = {0};
         cairo_get_matrix(cr, &matrix);
@@ -22,7 +34,7 @@ void PdfBackgroundView::draw(cairo_t* cr) const {
         cairo_surface_get_device_scale(cairo_get_target(cr), &scaleX, &scaleY);
         xoj_assert(scaleX == scaleY);
         double pixelsPerPageUnit = matrix.xx * scaleX;
-        pdfCache->render(cr, pageNo, pixelsPerPageUnit, pageWidth, pageHeight);
+        pdfCache->render(cr, pageNo, pixelsPerPageUnit, pageWidth, pageHeight, waitForPdf);
     } else {
         g_warning("PdfBackgroundView::draw Missing pdf cache: cannot render the pdf page");
         PdfCache::renderMissingPdfPage(cr, pageWidth, pageHeight);
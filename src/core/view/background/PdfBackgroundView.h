@@ -15,7 +15,8 @@
 
 #include <cairo.h>  // for cairo_t
 
-#include "BackgroundView.h"  // for BackgroundView
+#include "BackgroundFlags.h"  // for PDFCacheTreatment
+#include "BackgroundView.h"   // for BackgroundView
 
 class PdfCache;
 
@@ -24,7 +25,9 @@ namespace view {
 
 class PdfBackgroundView: public BackgroundView {
 public:
-    PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache = nullptr);
+    PdfBackgroundView(double pageWidth, double pageHeight, size_t pageNo, PdfCache* pdfCache = nullptr,
+                      PDFCacheTreatment onlyCachedPdf = RENDER_PDF_IF_NEEDED,
+                      PDFRasterizationTreatment waitForPdf = RASTERIZE_PDF_ASYNCHRONOUSLY);
     virtual ~PdfBackgroundView() = default;
 
     /**
@@ -35,6 +38,8 @@ public:
 private:
     size_t pageNo;
     PdfCache* pdfCache = nullptr;
+    PDFCacheTreatment onlyCachedPdf;
+    PDFRasterizationTreatment waitForPdf;
 };
 
 };  // namespace view
@@ -7,9 +7,18 @@
 #include "view/background/OneColorBackgroundView.h"  // for OneColorBackgrou...
 #include "view/background/PlainBackgroundView.h"     // for PlainBackgroundView
 
+#include "BackgroundTile.h"  // for BackgroundTile
+
 using namespace background_config_strings;
 using namespace xoj::view;
 
+namespace {
+void addHorizontalLine(cairo_t* cr, double width, double) {
+    cairo_move_to(cr, 0.0, 0.0);
+    cairo_line_to(cr, width, 0.0);
+}
+}  // namespace
+
 RuledBackgroundView::RuledBackgroundView(double pageWidth, double pageHeight, Color backgroundColor,
                                          const BackgroundConfig& config):
         OneColorBackgroundView(pageWidth, pageHeight, backgroundColor, config, DEFAULT_LINE_WIDTH, DEFAULT_H_LINE_COLOR,
@@ -33,6 +42,15 @@ void RuledBackgroundView::draw(cairo_t* cr) const {
     auto [indexMinY, indexMaxY] =
             getIndexBounds(minY - HEADER_SIZE - 0.5 * lineWidth, maxY - HEADER_SIZE + 0.5 * lineWidth, lineSpacing, 0.0,
                            pageHeight - HEADER_SIZE - FOOTER_SIZE);
+    if (indexMinY > indexMaxY) {
+        return;
+    }
+
+    BackgroundTile tile(addHorizontalLine, lineSpacing, lineSpacing, lineWidth, foregroundColor, CAIRO_LINE_CAP_BUTT);
+    if (tile.paint(cr, 0.0, HEADER_SIZE, minX, HEADER_SIZE + indexMinY * lineSpacing - 0.5 * lineWidth, maxX - minX,
+                   (indexMaxY - indexMinY) * lineSpacing + lineWidth)) {
+        return;
+    }
 
     for (int i = indexMinY; i <= indexMaxY; ++i) {
         cairo_move_to(cr, minX, HEADER_SIZE + i * lineSpacing);
@@ -103,18 +103,21 @@ void SplineToolView::drawSpline(cairo_t* cr, const SplineHandlerData& data) cons
     if (data.knots.size() > 1) {
         cairo_t* effCr = this->prepareContext(cr);
 
+        // The definitive segments are already flattened: only the last one is evaluated again
         const Point& firstKnot = data.knots.front();
         cairo_move_to(effCr, firstKnot.x, firstKnot.y);
-
-        auto itKnot1 = data.knots.begin();
-        auto itKnot2 = std::next(itKnot1);
-        auto itTgt1 = data.tangents.begin();
-        auto itTgt2 = std::next(itTgt1);
-        for (; itKnot2 != data.knots.end(); ++itKnot1, ++itKnot2, ++itTgt1, ++itTgt2) {
-            cairo_curve_to(effCr, itKnot1->x + itTgt1->x, itKnot1->y + itTgt1->y, itKnot2->x - itTgt2->x,
-                           itKnot2->y - itTgt2->y, itKnot2->x, itKnot2->y);
+        for (const Point& pt: data.flattenedSegments) {
+            cairo_line_to(effCr, pt.x, pt.y);
         }
 
+        const size_t n = data.knots.size();
+        const Point& p = data.knots[n - 2];
+        const Point& q = data.knots[n - 1];
+        const Point& s = data.tangents[n - 2];
+        const Point& t = data.tangents[n - 1];
+        cairo_line_to(effCr, p.x, p.y);
+        cairo_curve_to(effCr, p.x + s.x, p.y + s.y, q.x - t.x, q.y - t.y, q.x, q.y);
+
         this->commitDrawing(cr);
     }
 }
@@ -1,11 +1,15 @@
 #include "StrokeToolFilledHighlighterView.h"
 
+#include <iterator>
 #include <vector>
 
 #include "model/Point.h"
+#include "model/Stroke.h"
 #include "util/Color.h"
-#include "util/Range.h"
+#include "util/Point.h"
+#include "util/Rectangle.h"
 #include "util/raii/CairoWrappers.h"
+#include "util/safe_casts.h"
 #include "view/StrokeViewHelper.h"
 
 using namespace xoj::view;
@@ -36,33 +40,38 @@ void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
              */
             return;
         }
+        this->initFilling(cr);
+        // Everything received so far
+        pts = this->filling.contour;
     }
 
     if (this->singleDot) {
         this->drawDot(this->mask.get(), pts.back());
+        this->drawDot(this->strokeMask.get(), pts.back());
     } else {
+        // The stroke only grows: the new segments are drawn over the mask
+        for (cairo_t* target: {this->strokeMask.get(), this->mask.get()}) {
+            cairo_set_line_width(target, this->strokeWidth);
+            StrokeViewHelper::pathToCairo(target, pts);
+            cairo_stroke(target);
+        }
+
         /*
          * Upon adding a segment, the filling can actually shrink.
-         * We wipe the portion of the mask that can change: the convex hull of the added points + the first point
+         * Its winding numbers change by those of the polygon made of the first point and of the added points.
          */
-        Range wipe(filling.firstPoint.x, filling.firstPoint.y);
-
+        std::vector<xoj::util::Point<double>> delta;
+        delta.reserve(pts.size() + 1);
+        auto addPoint = [&](double x, double y) {
+            cairo_matrix_transform_point(&this->toPixels, &x, &y);
+            delta.emplace_back(x, y);
+        };
+        addPoint(filling.firstPoint.x, filling.firstPoint.y);
         for (auto& p: pts) {
-            wipe.addPoint(p.x, p.y);
-        }
-
-        if (wipe.isValid()) {
-            this->mask.wipeRange(wipe);
+            addPoint(p.x, p.y);
         }
-
-
-        /*
-         * Draw both the filling and the stroke alike on the mask
-         */
-        cairo_set_line_width(this->mask.get(), this->strokeWidth);
-        StrokeViewHelper::pathToCairo(this->mask.get(), this->filling.contour);
-        cairo_fill_preserve(this->mask.get());
-        cairo_stroke(this->mask.get());
+        this->coverage->addPolygon(delta);
+        this->recomposeChanges();
     }
 
     xoj::util::CairoSaveGuard saveGuard(cr);
@@ -71,3 +80,64 @@ void StrokeToolFilledHighlighterView::draw(cairo_t* cr) const {
 
     this->mask.blitTo(cr);
 }
+
+void StrokeToolFilledHighlighterView::on(StrokeReplacementRequest, const Stroke& newStroke) {
+    StrokeToolFilledView::on(STROKE_REPLACEMENT_REQUEST, newStroke);
+    // The next call to draw() starts over with the entire new stroke
+    if (!this->filling.contour.empty()) {
+        this->filling.contour.erase(std::next(this->filling.contour.begin()), this->filling.contour.end());
+    }
+    this->mask.reset();
+    this->strokeMask.reset();
+    this->coverage.reset();
+}
+
+void StrokeToolFilledHighlighterView::initFilling(cairo_t* cr) const {
+    this->strokeMask = this->createMask(cr);
+
+    cairo_t* maskCr = this->mask.get();
+    double scaleY = 1.0;
+    cairo_surface_get_device_scale(cairo_get_target(maskCr), &this->deviceScale, &scaleY);
+    cairo_matrix_t ctm;
+    cairo_get_matrix(maskCr, &ctm);
+    cairo_matrix_t scale;
+    cairo_matrix_init_scale(&scale, this->deviceScale, this->deviceScale);
+    cairo_matrix_multiply(&this->toPixels, &ctm, &scale);
+
+    double x1 = 0;
+    double y1 = 0;
+    double x2 = 0;
+    double y2 = 0;
+    cairo_clip_extents(maskCr, &x1, &y1, &x2, &y2);
+    cairo_matrix_transform_point(&this->toPixels, &x2, &y2);
+    this->coverage.emplace(round_cast<int>(x2), round_cast<int>(y2));
+}
+
+void StrokeToolFilledHighlighterView::recomposeChanges() const {
+    using xoj::util::WindingBuffer;
+    cairo_t* cr = this->mask.get();
+    cairo_surface_t* strokeSurface = cairo_get_target(this->strokeMask.get());
+    const double s = 1.0 / this->deviceScale;
+
+    for (auto&& [tile, rect]: this->coverage->takeChanges()) {
+        xoj::util::CairoSaveGuard saveGuard(cr);
+        cairo_identity_matrix(cr);
+        cairo_rectangle(cr, rect.x * s, rect.y * s, rect.width * s, rect.height * s);
+        cairo_clip(cr);
+
+        // The filling, then the stroke over it
+        xoj::util::CairoSurfaceSPtr filling(
+                cairo_image_surface_create_for_data(const_cast<unsigned char*>(tile->coverage.data()),
+                                                    CAIRO_FORMAT_A8, WindingBuffer::TILE_SIZE,
+                                                    WindingBuffer::TILE_SIZE, WindingBuffer::TILE_SIZE),
+                xoj::util::adopt);
+        cairo_surface_set_device_scale(filling.get(), this->deviceScale, this->deviceScale);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_set_source_surface(cr, filling.get(), tile->x * s, tile->y * s);
+        cairo_paint(cr);
+
+        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        cairo_set_source_surface(cr, strokeSurface, 0, 0);
+        cairo_paint(cr);
+    }
+}
@@ -2,7 +2,7 @@
  * Xournal++
  *
  * View active stroke tool -- for filled highlighter only
- *      In this case, the mask needs to be wiped at every iteration, and repainted to avoid artefacts like in
+ *      In this case, the filling and the stroke must be drawn in a single mask, to avoid artefacts like in
  *          https://github.com/xournalpp/xournalpp/issues/3709
  *
  * @author Xournal++ Team
@@ -12,14 +12,58 @@
  */
 #pragma once
 
+#include <optional>
+
+#include <cairo.h>
+
+#include "util/WindingBuffer.h"
+#include "view/Mask.h"
+
 #include "StrokeToolFilledView.h"
 
 namespace xoj::view {
+/**
+ * @brief View active stroke tool -- filled highlighter
+ *
+ * Upon adding points, the filling can shrink as well as grow, so it cannot simply be painted over the mask. Instead,
+ * the winding numbers of the filling are accumulated: adding the points Pn+1, ..., Pm adds the polygon
+ * (P0, Pn, ..., Pm). Only the pixels of this polygon are recomposed from the filling's coverage and the stroke (drawn
+ * apart, in its own mask), so that the cost of an iteration does not grow with the length of the stroke.
+ */
 class StrokeToolFilledHighlighterView: public StrokeToolFilledView {
 public:
     StrokeToolFilledHighlighterView(const StrokeHandler* strokeHandler, const Stroke& stroke, Repaintable* parent);
     virtual ~StrokeToolFilledHighlighterView() noexcept;
 
     void draw(cairo_t* cr) const override;
+
+    void on(StrokeReplacementRequest, const Stroke& newStroke) override;
+
+private:
+    /**
+     * @brief Set up the stroke mask and the filling's coverage for the (newly created) mask
+     */
+    void initFilling(cairo_t* cr) const;
+
+    /**
+     * @brief Recompose the parts of the mask where the filling's coverage changed
+     */
+    void recomposeChanges() const;
+
+    /**
+     * @brief The stroke alone
+     */
+    mutable Mask strokeMask;
+
+    /**
+     * @brief Coverage of the filling, in pixels of the masks
+     */
+    mutable std::optional<xoj::util::WindingBuffer> coverage;
+
+    /**
+     * @brief From page coordinates to pixels of the masks
+     */
+    mutable cairo_matrix_t toPixels;
+    mutable double deviceScale = 1.0;
 };
 };  // namespace xoj::view
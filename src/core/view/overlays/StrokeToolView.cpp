@@ -28,6 +28,13 @@ StrokeToolView::~StrokeToolView() noexcept { this->unregisterFromPool(); }
 bool StrokeToolView::isViewOf(const OverlayBase* overlay) const { return overlay == this->strokeHandler; }
 
 void StrokeToolView::draw(cairo_t* cr) const {
+    this->drawStroke(cr);
+    this->drawPredictedEnd(cr);
+}
+
+void StrokeToolView::drawWithoutDrawingAids(cairo_t* cr) const { this->drawStroke(cr); }
+
+void StrokeToolView::drawStroke(cairo_t* cr) const {
 
     std::vector<Point> pts = this->flushBuffer();
     if (pts.empty()) {
@@ -86,6 +93,20 @@ void StrokeToolView::on(StrokeToolView::AddPointRequest, const Point& p) {
     this->parent->flagDirtyRegion(this->getRepaintRange(lastPoint, p));
 }
 
+void StrokeToolView::on(StrokeToolView::PredictedEndRequest, const Point& p) {
+    if (this->cairoOp != CAIRO_OPERATOR_OVER || this->strokeColor.alpha != 0xff || this->lineStyle.hasDashes()) {
+        // The segment would not blend in with the stroke
+        return;
+    }
+    xoj_assert(!this->pointBuffer.empty());
+    if (!this->predictedEndRange.empty()) {
+        this->parent->flagDirtyRegion(this->predictedEndRange);
+    }
+    this->predictedEnd = p;
+    this->predictedEndRange = this->getRepaintRange(this->pointBuffer.back(), p);
+    this->parent->flagDirtyRegion(this->predictedEndRange);
+}
+
 void StrokeToolView::on(StrokeToolView::ThickenFirstPointRequest, double newWidth) {
     xoj_assert(newWidth > 0.0);
     xoj_assert(this->pointBuffer.size() == 1);
@@ -99,7 +120,7 @@ void StrokeToolView::on(StrokeToolView::ThickenFirstPointRequest, double newWidt
 
 void StrokeToolView::deleteOn(StrokeToolView::CancellationRequest, const Range& rg) {
     this->pointBuffer.clear();
-    this->parent->drawAndDeleteToolView(this, rg);
+    this->parent->drawAndDeleteToolView(this, rg.unite(this->predictedEndRange));
 }
 
 void StrokeToolView::on(StrokeToolView::StrokeReplacementRequest, const Stroke& newStroke) {
@@ -107,6 +128,11 @@ void StrokeToolView::on(StrokeToolView::StrokeReplacementRequest, const Stroke&
         // only wipe mask it actually exists (the view has already been drawn at least once)
         this->mask.wipe();
     }
+    if (!this->predictedEndRange.empty()) {
+        this->parent->flagDirtyRegion(this->predictedEndRange);
+        this->predictedEnd.reset();
+        this->predictedEndRange = Range();
+    }
     this->pointBuffer = newStroke.getPointVector();
     this->dashOffset = 0;
     this->strokeWidth = newStroke.getWidth();
@@ -117,6 +143,10 @@ void StrokeToolView::on(StrokeToolView::StrokeReplacementRequest, const Stroke&
 }
 
 void StrokeToolView::deleteOn(StrokeToolView::FinalizationRequest, const Range& rg) {
+    if (!this->predictedEndRange.empty()) {
+        // The finalized stroke does not exactly end along the predicted segment
+        this->parent->flagDirtyRegion(this->predictedEndRange);
+    }
     this->parent->drawAndDeleteToolView(this, rg);
 }
 
@@ -136,6 +166,20 @@ void StrokeToolView::drawDot(cairo_t* cr, const Point& p) const {
     cairo_stroke(cr);
 }
 
+void StrokeToolView::drawPredictedEnd(cairo_t* cr) const {
+    if (!this->predictedEnd || this->pointBuffer.empty()) {
+        return;
+    }
+    const Point& p = this->pointBuffer.back();  // The last point of the stroke, see flushBuffer()
+    xoj::util::CairoSaveGuard saveGuard(cr);
+    Util::cairo_set_source_argb(cr, strokeColor);
+    cairo_set_line_width(cr, p.z == Point::NO_PRESSURE ? this->strokeWidth : p.z);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_ROUND);
+    cairo_move_to(cr, p.x, p.y);
+    cairo_line_to(cr, this->predictedEnd->x, this->predictedEnd->y);
+    cairo_stroke(cr);
+}
+
 std::vector<Point> StrokeToolView::flushBuffer() const {
     std::vector<Point> pts;
     std::swap(this->pointBuffer, pts);
@@ -10,18 +10,19 @@
  */
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include <cairo.h>
 
+#include "model/Point.h"
 #include "util/DispatchPool.h"
+#include "util/Range.h"
 #include "view/Mask.h"
 
 #include "BaseStrokeToolView.h"
 
 class StrokeHandler;
-class Point;
-class Range;
 class Stroke;
 class OverlayBase;
 
@@ -35,8 +36,16 @@ public:
 
     bool isViewOf(const OverlayBase* overlay) const override;
 
+    /**
+     * @brief Draw the stroke, followed by the predicted end of the stroke (if any)
+     */
     void draw(cairo_t* cr) const override;
 
+    /**
+     * @brief Draw the stroke only: the predicted end is not part of the stroke
+     */
+    void drawWithoutDrawingAids(cairo_t* cr) const override;
+
     /**
      * Listener interface
      */
@@ -48,6 +57,14 @@ public:
     } THICKEN_FIRST_POINT_REQUEST = {};
     void on(ThickenFirstPointRequest, double newPressure);
 
+    /**
+     * @brief The stabilizer predicts the stroke will end there. Until the next prediction, a straight segment from the
+     * last point of the stroke to the predicted end is drawn (but not added to the mask).
+     */
+    static constexpr struct PredictedEndRequest {
+    } PREDICTED_END_REQUEST = {};
+    void on(PredictedEndRequest, const Point& p);
+
     static constexpr struct StrokeReplacementRequest {
     } STROKE_REPLACEMENT_REQUEST = {};
     virtual void on(StrokeReplacementRequest, const Stroke& newStroke);
@@ -71,6 +88,16 @@ protected:
 
     void drawDot(cairo_t* cr, const Point& p) const;
 
+    /**
+     * @brief Draw the segment from the last point of the stroke to the predicted end, if any
+     */
+    void drawPredictedEnd(cairo_t* cr) const;
+
+    /**
+     * @brief Draw the part of the stroke received since the last call, and blit the mask
+     */
+    void drawStroke(cairo_t* cr) const;
+
     /**
      * @brief (Thread-safe) Flush the communication buffer and returns its content.
      */
@@ -97,6 +124,13 @@ protected:
      */
     mutable std::vector<Point> pointBuffer;  // Todo: implement a lock-free fifo?
 
+    /**
+     * @brief Predicted end of the stroke and the range where its segment was drawn.
+     *      The segment is only drawn on top of an opaque, plain stroke, where it blends in with the mask.
+     */
+    std::optional<Point> predictedEnd;
+    Range predictedEndRange;
+
     /**
      * @brief Drawing mask.
      *
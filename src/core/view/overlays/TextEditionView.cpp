@@ -1,6 +1,9 @@
 #include "TextEditionView.h"
 
+#include <pango/pangocairo.h>
+
 #include "control/tools/TextEditor.h"
+#include "control/tools/TextEditorLayout.h"
 #include "model/Text.h"
 #include "util/Color.h"
 #include "util/raii/CairoWrappers.h"
@@ -58,14 +61,25 @@ void TextEditionView::drawWithoutDrawingAids(cairo_t* cr) const {
     cairo_translate(cr, textElement->getX(), textElement->getY());
 
     // The data is owned by textEditor
-    PangoLayout* layout = this->textEditor->getUpToDateLayout();
-
-    // The cairo context might have changed. Update the pango layout
-    pango_cairo_update_layout(cr, layout);
-
-    pango_context_set_matrix(pango_layout_get_context(layout), nullptr);
-
-    pango_cairo_show_layout(cr, layout);
+    const TextEditorLayout& layout = this->textEditor->getUpToDateLayout();
+
+    // The paragraphs share the context of the prototype. As in TextView, only the font options of the target are
+    // applied, so that the paragraphs are not laid out again on each rendering
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(cairo_get_target(cr), options);
+    pango_cairo_context_set_font_options(pango_layout_get_context(layout.getPrototype()), options);
+    cairo_font_options_destroy(options);
+
+    // Only show the paragraphs in the area being repainted
+    double x1 = 0;
+    double y1 = 0;
+    double x2 = 0;
+    double y2 = 0;
+    cairo_clip_extents(cr, &x1, &y1, &x2, &y2);
+    layout.forEachLayout(y1, y2, [cr](PangoLayout* paragraph, double x, double y) {
+        cairo_move_to(cr, x, y);
+        pango_cairo_show_layout(cr, paragraph);
+    });
 }
 
 bool TextEditionView::isViewOf(const OverlayBase* overlay) const { return overlay == this->textEditor; }
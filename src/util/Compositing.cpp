@@ -0,0 +1,94 @@
+#include "util/Compositing.h"
+
+#include <cmath>    // for lround
+#include <cstring>  // for memcpy
+
+#ifdef __SSE2__
+#include <emmintrin.h>  // for __m128i, _mm_*
+#endif
+
+using namespace xoj::util::compositing;
+
+namespace {
+/// x / 255, rounded, for x in [0, 255 * 255]
+inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline uint32_t toByte(double v) { return static_cast<uint32_t>(std::lround(v * 255.0)); }
+
+#ifdef __SSE2__
+/// x / 255, rounded, for 16 bits lanes in [0, 255 * 255]
+inline __m128i div255(__m128i x) { return _mm_mulhi_epu16(_mm_add_epi16(x, _mm_set1_epi16(128)), _mm_set1_epi16(257)); }
+
+/// Copy the alpha lane of each pixel to its 4 lanes
+inline __m128i broadcastAlpha(__m128i x) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xff), 0xff); }
+
+/**
+ * The multiply blend mode for 2 pixels, in 16 bits lanes. The formula is the same for the alpha channel:
+ * sa * (1 - da) + da * (1 - sa) + sa * da = sa + da - sa * da
+ */
+inline __m128i multiply(__m128i color, __m128i mask, __m128i dst) {
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i src = div255(_mm_mullo_epi16(color, mask));
+    const __m128i sa = broadcastAlpha(src);
+    const __m128i da = broadcastAlpha(dst);
+    // As the pixels are premultiplied, the sum is at most 255 * 255
+    __m128i sum = _mm_mullo_epi16(src, _mm_sub_epi16(full, da));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(dst, _mm_sub_epi16(full, sa)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(src, dst));
+    return div255(sum);
+}
+#endif
+}  // namespace
+
+auto xoj::util::compositing::premultiply(double r, double g, double b, double a) -> PremultipliedColor {
+    return {toByte(a), toByte(r * a), toByte(g * a), toByte(b * a)};
+}
+
+void xoj::util::compositing::multiplyMasked(uint32_t* dst, const uint8_t* mask, size_t n,
+                                            const PremultipliedColor& color) {
+    size_t i = 0;
+#ifdef __SSE2__
+    // 4 pixels at a time. In memory, the channels of a pixel are b, g, r, a (little endian).
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c = _mm_set_epi16(static_cast<short>(color.a), static_cast<short>(color.r),
+                                    static_cast<short>(color.g), static_cast<short>(color.b),
+                                    static_cast<short>(color.a), static_cast<short>(color.r),
+                                    static_cast<short>(color.g), static_cast<short>(color.b));
+    for (; i + 4 <= n; i += 4) {
+        int32_t m4 = 0;
+        std::memcpy(&m4, mask + i, sizeof(m4));
+        __m128i m = _mm_cvtsi32_si128(m4);
+        m = _mm_unpacklo_epi8(m, m);
+        m = _mm_unpacklo_epi16(m, m);  // The coverage of each pixel in its 4 channels
+
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i lo = multiply(c, _mm_unpacklo_epi8(m, zero), _mm_unpacklo_epi8(d, zero));
+        const __m128i hi = multiply(c, _mm_unpackhi_epi8(m, zero), _mm_unpackhi_epi8(d, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; i++) {
+        const uint32_t m = mask[i];
+        const uint32_t d = dst[i];
+        // The source, through the mask
+        const uint32_t sa = div255(color.a * m);
+        const uint32_t sr = div255(color.r * m);
+        const uint32_t sg = div255(color.g * m);
+        const uint32_t sb = div255(color.b * m);
+
+        const uint32_t da = d >> 24;
+        const uint32_t dr = (d >> 16) & 0xff;
+        const uint32_t dg = (d >> 8) & 0xff;
+        const uint32_t db = d & 0xff;
+
+        // result = src * (1 - da) + dst * (1 - sa) + src * dst, and for alpha, sa + da - sa * da
+        const uint32_t ra = sa + da - div255(sa * da);
+        const uint32_t rr = div255(sr * (255 - da) + dr * (255 - sa) + sr * dr);
+        const uint32_t rg = div255(sg * (255 - da) + dg * (255 - sa) + sg * dg);
+        const uint32_t rb = div255(sb * (255 - da) + db * (255 - sa) + sb * db);
+        dst[i] = (ra << 24) | (rr << 16) | (rg << 8) | rb;
+    }
+}
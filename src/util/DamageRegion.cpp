@@ -0,0 +1,73 @@
+#include "util/DamageRegion.h"
+
+#include <limits>   // for numeric_limits
+#include <utility>  // for swap
+
+using namespace xoj::util;
+
+namespace {
+auto area(const Range& rg) -> double { return rg.isValid() ? rg.getWidth() * rg.getHeight() : 0.0; }
+
+/// The area the union of the rectangles has in excess of theirs
+auto waste(const Range& a, const Range& b) -> double {
+    return area(a.unite(b)) - area(a) - area(b) + area(a.intersect(b));
+}
+
+/// Merging two rectangles is free if the union has at most this proportion of area in excess
+constexpr double MERGE_RATIO = 0.25;
+}  // namespace
+
+void DamageRegion::add(const Range& rg) {
+    if (rg.empty() || !rg.isValid()) {
+        return;
+    }
+    Range merged = rg;
+    // A rectangle may absorb several others once merged
+    for (bool mergedSome = true; mergedSome;) {
+        mergedSome = false;
+        for (size_t i = 0; i < ranges.size(); i++) {
+            if (waste(ranges[i], merged) <= MERGE_RATIO * area(ranges[i].unite(merged))) {
+                merged = merged.unite(ranges[i]);
+                std::swap(ranges[i], ranges.back());
+                ranges.pop_back();
+                mergedSome = true;
+                break;
+            }
+        }
+    }
+    ranges.push_back(merged);
+
+    while (ranges.size() > MAX_RANGES) {
+        // Merge the pair wasting the least area
+        size_t best1 = 0;
+        size_t best2 = 1;
+        double bestWaste = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < ranges.size(); i++) {
+            for (size_t j = i + 1; j < ranges.size(); j++) {
+                if (double w = waste(ranges[i], ranges[j]); w < bestWaste) {
+                    bestWaste = w;
+                    best1 = i;
+                    best2 = j;
+                }
+            }
+        }
+        Range u = ranges[best1].unite(ranges[best2]);
+        std::swap(ranges[best2], ranges.back());
+        ranges.pop_back();
+        ranges[best1] = u;
+    }
+}
+
+bool DamageRegion::empty() const { return ranges.empty(); }
+
+auto DamageRegion::getRanges() const -> const std::vector<Range>& { return ranges; }
+
+auto DamageRegion::getBoundingBox() const -> Range {
+    Range res;
+    for (auto&& rg: ranges) {
+        res = res.unite(rg);
+    }
+    return res;
+}
+
+void DamageRegion::clear() { ranges.clear(); }
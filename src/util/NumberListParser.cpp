@@ -0,0 +1,58 @@
+#include "util/NumberListParser.h"
+
+#include <algorithm>     // for copy
+#include <charconv>      // for from_chars
+#include <system_error>  // for errc
+
+#include <glib.h>  // for g_ascii_strtod
+
+/**
+ * g_ascii_strtod needs a null-terminated copy of the token
+ */
+static auto parseDoubleWithGlib(const char* begin, const char* end, double& value) -> const char* {
+    constexpr size_t MAX_TOKEN_LENGTH = 64;
+    char buffer[MAX_TOKEN_LENGTH + 1];
+    const char* tokenEnd = begin;
+    while (tokenEnd != end && !xoj::util::isNumberSeparator(*tokenEnd) &&
+           static_cast<size_t>(tokenEnd - begin) < MAX_TOKEN_LENGTH) {
+        tokenEnd++;
+    }
+    std::copy(begin, tokenEnd, buffer);
+    buffer[tokenEnd - begin] = '\0';
+
+    char* parsedEnd = nullptr;
+    value = g_ascii_strtod(buffer, &parsedEnd);
+    return begin + (parsedEnd - buffer);
+}
+
+auto xoj::util::countNumberTokens(const char* begin, const char* end) -> size_t {
+    size_t count = 0;
+    bool inToken = false;
+    for (const char* p = begin; p != end; p++) {
+        const bool separator = isNumberSeparator(*p);
+        count += static_cast<size_t>(!separator && !inToken);
+        inToken = !separator;
+    }
+    return count;
+}
+
+auto xoj::util::parseDouble(const char* begin, const char* end, double& value) -> const char* {
+    const char* p = begin;
+    if (p != end && *p == '+') {
+        // Accepted by strtod but not by std::from_chars
+        p++;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    auto [ptr, ec] = std::from_chars(p, end, value);
+    if (ec == std::errc()) {
+        return ptr;
+    }
+    if (ec != std::errc::result_out_of_range) {
+        return begin;
+    }
+    // Let strtod decide between infinity and zero
+#endif
+    const char* res = parseDoubleWithGlib(p, end, value);
+    return res == p ? begin : res;
+}
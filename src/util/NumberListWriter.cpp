@@ -0,0 +1,54 @@
+#include "util/NumberListWriter.h"
+
+#include <algorithm>     // for copy_n, min
+#include <charconv>      // for to_chars, chars_format
+#include <cstring>       // for strlen
+#include <system_error>  // for errc
+
+#include <glib.h>  // for g_ascii_formatd, G_ASCII_DTOSTR_BUF_SIZE
+
+#include "util/OutputStream.h"  // for OutputStream
+#include "util/Util.h"          // for PRECISION_FORMAT_STRING
+
+namespace {
+/// The precision of Util::PRECISION_FORMAT_STRING
+constexpr int PRECISION = 8;
+}  // namespace
+
+auto xoj::util::formatDouble(char* first, double value) -> char* {
+#if defined(__cpp_lib_to_chars)
+    // Specified to give the same output as printf's "%.8g" in the C locale
+    auto [ptr, ec] = std::to_chars(first, first + FORMATTED_DOUBLE_MAX_LENGTH, value, std::chars_format::general,
+                                   PRECISION);
+    if (ec == std::errc()) {
+        return ptr;
+    }
+#endif
+    char str[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    const size_t length = std::min(std::strlen(str), FORMATTED_DOUBLE_MAX_LENGTH);
+    return std::copy_n(str, length, first);
+}
+
+xoj::util::NumberListWriter::NumberListWriter(OutputStream* out): out(out) {}
+
+xoj::util::NumberListWriter::~NumberListWriter() { flush(); }
+
+void xoj::util::NumberListWriter::write(double value) {
+    if (this->length + FORMATTED_DOUBLE_MAX_LENGTH + 1 > this->buffer.size()) {
+        flush();
+    }
+    char* p = this->buffer.data() + this->length;
+    if (!this->first) {
+        *p++ = ' ';
+    }
+    this->first = false;
+    this->length = static_cast<size_t>(formatDouble(p, value) - this->buffer.data());
+}
+
+void xoj::util::NumberListWriter::flush() {
+    if (this->length > 0) {
+        this->out->write(this->buffer.data(), this->length);
+        this->length = 0;
+    }
+}
@@ -1,11 +1,14 @@
 #include "util/OutputStream.h"
 
+#include <algorithm>  // for max, min
 #include <cassert>
 #include <cerrno>
+#include <cstdint>  // for uint64_t
 #include <cstring>  // for strlen
+#include <thread>   // for thread
 #include <utility>  // for move
 
-#include "util/GzUtil.h"  // for GzUtil
+#include "util/Assert.h"  // for xoj_assert
 #include "util/i18n.h"    // for FS, _F
 #include "util/safe_casts.h"
 
@@ -21,56 +24,156 @@ void OutputStream::write(const char* str) { write(str, std::strlen(str)); }
 /// GzOutputStream /////////////////////////////////////
 ////////////////////////////////////////////////////////
 
-GzOutputStream::GzOutputStream(fs::path file): file(std::move(file)) {
-    this->fp = GzUtil::openPath(this->file, "w");
-    if (this->fp == nullptr) {
+namespace {
+/// Uncompressed size of the blocks compressed in parallel
+constexpr size_t BLOCK_SIZE = 256 * 1024;
+/// Size of the deflate window, primed with the end of the previous block
+constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+}  // namespace
+
+GzOutputStream::GzOutputStream(fs::path file):
+        maxBlocksInFlight(std::max(1U, std::thread::hardware_concurrency())),
+        crc(crc32(0L, Z_NULL, 0)),
+        file(std::move(file)) {
+    this->fp.open(this->file, std::ios::binary | std::ios::trunc);
+    if (!this->fp) {
         this->error = FS(_F("Error opening file: \"{1}\"") % this->file.u8string());
         this->error = this->error + "\n" + std::strerror(errno);
+        return;
     }
+    this->open = true;
+
+    // Gzip header: deflate, no flags, no modification time, unknown OS
+    const char header[] = {'\x1f', '\x8b', '\x08', '\0', '\0', '\0', '\0', '\0', '\0', '\xff'};
+    writeRaw(std::string(header, sizeof(header)));
 }
 
 GzOutputStream::~GzOutputStream() {
-    if (this->fp) {
+    if (this->open) {
         close();
     }
-    this->fp = nullptr;
 }
 
 auto GzOutputStream::getLastError() const -> const std::string& { return this->error; }
 
 void GzOutputStream::write(const char* data, size_t len) {
-    xoj_assert(len != 0 && this->fp);
-    auto written = gzwrite(this->fp, data, strict_cast<unsigned int>(len));
-    if (as_unsigned(written) != len) {
-        int errnum = 0;
-        const char* error = gzerror(this->fp, &errnum);
-        if (errnum != Z_OK) {
-            this->error = FS(_F("Error writing data to file: \"{1}\"") % this->file.u8string());
-            this->error += "\n" + FS(_F("Error code {1}. Message:") % errnum) + "\n";
-            if (errnum == Z_ERRNO) {
-                // fs error. Fetch the precise message
-                this->error += std::strerror(errno);
-            } else {
-                this->error += error;
-            }
-        }
+    xoj_assert(len != 0 && this->open);
+    this->pending.append(data, len);
+    while (this->pending.size() >= BLOCK_SIZE) {
+        compressPending(false);
     }
 }
 
-void GzOutputStream::close() {
+auto GzOutputStream::compress(const std::string& input, const std::string& dictionary, bool last)
+        -> CompressedBlock {
+    CompressedBlock block{{}, crc32(0L, reinterpret_cast<const Bytef*>(input.data()), strict_cast<uInt>(input.size())),
+                          input.size(), false};
+
+    z_stream strm{};
+    // Raw deflate: the header and the trailer are written by the stream
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return block;
+    }
+    if (!dictionary.empty()) {
+        deflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(dictionary.data()),
+                             strict_cast<uInt>(dictionary.size()));
+    }
+
+    // Room for the sync marker (or the final block) as well
+    block.data.resize(deflateBound(&strm, strict_cast<uLong>(input.size())) + 16);
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    strm.avail_in = strict_cast<uInt>(input.size());
+    strm.next_out = reinterpret_cast<Bytef*>(block.data.data());
+    strm.avail_out = strict_cast<uInt>(block.data.size());
+
+    // Each block but the last one ends on a byte boundary, so that the next one can be appended
+    const int ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+    block.ok = last ? ret == Z_STREAM_END : ret == Z_OK && strm.avail_in == 0 && strm.avail_out != 0;
+    block.data.resize(block.data.size() - strm.avail_out);
+    deflateEnd(&strm);
+    return block;
+}
+
+void GzOutputStream::compressPending(bool last) {
+    std::string input;
+    if (this->pending.size() > BLOCK_SIZE) {
+        input = this->pending.substr(0, BLOCK_SIZE);
+        this->pending.erase(0, BLOCK_SIZE);
+    } else {
+        input = std::move(this->pending);
+        this->pending.clear();
+    }
+
+    std::string dictionary = std::move(this->dictionary);
+    this->dictionary = input.substr(input.size() - std::min(input.size(), DICTIONARY_SIZE));
+
+    if (this->blocks.size() >= this->maxBlocksInFlight) {
+        writeBlock();
+    }
+    // Falls back to compressing in this thread if no thread can be started
+    this->blocks.push_back(std::async(std::launch::async | std::launch::deferred,
+                                      [input = std::move(input), dictionary = std::move(dictionary), last]() {
+                                          return compress(input, dictionary, last);
+                                      }));
+}
+
+void GzOutputStream::writeBlock() {
+    CompressedBlock block = this->blocks.front().get();
+    this->blocks.pop_front();
+
+    if (!block.ok && this->error.empty()) {
+        this->error = FS(_F("Error writing data to file: \"{1}\"") % this->file.u8string());
+        this->error += "\n" + FS(_F("Error code {1}. Message:") % Z_STREAM_ERROR) + "\n" + zError(Z_STREAM_ERROR);
+    }
+    this->crc = crc32_combine(this->crc, block.crc, static_cast<z_off_t>(block.length));
+    this->totalLength += block.length;
+    writeRaw(block.data);
+}
+
+void GzOutputStream::writeRaw(const std::string& data) {
+    if (!this->error.empty()) {
+        return;
+    }
+    this->fp.write(data.data(), static_cast<std::streamsize>(data.size()));
     if (!this->fp) {
+        this->error = FS(_F("Error writing data to file: \"{1}\"") % this->file.u8string());
+        this->error = this->error + "\n" + std::strerror(errno);
+    }
+}
+
+void GzOutputStream::close() {
+    if (!this->open) {
         return;
     }
+    this->open = false;
 
-    auto errnum = gzclose(this->fp);
-    this->fp = nullptr;
+    compressPending(true);
+    while (!this->blocks.empty()) {
+        writeBlock();
+    }
 
-    if (errnum != Z_OK) {
-        this->error = FS(_F("Error occurred while closing file: \"{1}\"") % this->file.u8string());
-        this->error += "\n" + FS(_F("Error code {1}") % errnum);
-        if (errnum == Z_ERRNO) {
-            // fs error. Fetch the precise message
-            this->error = this->error + "\n" + std::strerror(errno);
+    // Gzip trailer: CRC32 and length modulo 2^32, little endian
+    std::string trailer;
+    for (uint64_t value: {static_cast<uint64_t>(this->crc), static_cast<uint64_t>(this->totalLength)}) {
+        for (int i = 0; i < 4; i++) {
+            trailer += static_cast<char>((value >> (8 * i)) & 0xffU);
         }
     }
+    writeRaw(trailer);
+
+    this->fp.close();
+    if (!this->fp && this->error.empty()) {
+        this->error = FS(_F("Error occurred while closing file: \"{1}\"") % this->file.u8string());
+        this->error = this->error + "\n" + std::strerror(errno);
+    }
 }
+
+////////////////////////////////////////////////////////
+/// StringOutputStream /////////////////////////////////
+////////////////////////////////////////////////////////
+
+void StringOutputStream::write(const char* data, size_t len) { this->data.append(data, len); }
+
+void StringOutputStream::close() {}
+
+auto StringOutputStream::getData() const -> const std::string& { return this->data; }
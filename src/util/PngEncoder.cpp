@@ -0,0 +1,247 @@
+#include "util/PngEncoder.h"
+
+#include <algorithm>  // for clamp, min
+#include <array>      // for array
+#include <cstddef>    // for ptrdiff_t, size_t
+#include <cstdint>    // for SIZE_MAX, int64_t, uint32_t
+#include <cstdlib>    // for abs
+#include <cstring>    // for memcpy
+#include <future>     // for async, future
+#include <utility>    // for swap
+
+#include <zlib.h>  // for deflate, crc32, adler32
+
+#include "util/safe_casts.h"  // for strict_cast
+
+using namespace xoj::util::png;
+
+namespace {
+constexpr std::array<uint8_t, 8> SIGNATURE{137, 80, 78, 71, 13, 10, 26, 10};
+constexpr size_t BYTES_PER_PIXEL = 4;
+/// Smaller chunks are not worth a thread
+constexpr int MIN_ROWS_PER_CHUNK = 64;
+/// Size of the deflate window, primed with the end of the previous chunk
+constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+
+enum Filter : uint8_t { FILTER_NONE, FILTER_SUB, FILTER_UP, FILTER_AVERAGE, FILTER_PAETH };
+constexpr std::array<Filter, 5> ALL_FILTERS{FILTER_NONE, FILTER_SUB, FILTER_UP, FILTER_AVERAGE, FILTER_PAETH};
+
+void appendU32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void appendChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t length) {
+    appendU32(out, static_cast<uint32_t>(length));
+    const size_t begin = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + length);
+    appendU32(out, static_cast<uint32_t>(crc32(0L, out.data() + begin, strict_cast<uInt>(length + 4))));
+}
+
+/// Unpremultiply a row of native endian ARGB32 pixels into RGBA bytes, as cairo_surface_write_to_png() does
+void toRGBA(const unsigned char* src, int width, uint8_t* dst) {
+    for (int i = 0; i < width; i++, src += BYTES_PER_PIXEL, dst += BYTES_PER_PIXEL) {
+        uint32_t p = 0;
+        std::memcpy(&p, src, sizeof(p));
+        const uint32_t a = p >> 24;
+        if (a == 0) {
+            dst[0] = dst[1] = dst[2] = dst[3] = 0;
+            continue;
+        }
+        dst[0] = static_cast<uint8_t>((((p >> 16) & 0xff) * 255 + a / 2) / a);
+        dst[1] = static_cast<uint8_t>((((p >> 8) & 0xff) * 255 + a / 2) / a);
+        dst[2] = static_cast<uint8_t>(((p & 0xff) * 255 + a / 2) / a);
+        dst[3] = static_cast<uint8_t>(a);
+    }
+}
+
+auto paeth(int a, int b, int c) -> int {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/// Filter the row into out, the filter type in front. prev is the previous row, zeros for the first one.
+void filterRow(Filter filter, const uint8_t* cur, const uint8_t* prev, size_t n, uint8_t* out) {
+    *out++ = filter;
+    const size_t bpp = BYTES_PER_PIXEL;
+    switch (filter) {
+        case FILTER_NONE:
+            std::memcpy(out, cur, n);
+            break;
+        case FILTER_SUB:
+            std::memcpy(out, cur, bpp);
+            for (size_t i = bpp; i < n; i++) {
+                out[i] = static_cast<uint8_t>(cur[i] - cur[i - bpp]);
+            }
+            break;
+        case FILTER_UP:
+            for (size_t i = 0; i < n; i++) {
+                out[i] = static_cast<uint8_t>(cur[i] - prev[i]);
+            }
+            break;
+        case FILTER_AVERAGE:
+            for (size_t i = 0; i < bpp; i++) {
+                out[i] = static_cast<uint8_t>(cur[i] - prev[i] / 2);
+            }
+            for (size_t i = bpp; i < n; i++) {
+                out[i] = static_cast<uint8_t>(cur[i] - (cur[i - bpp] + prev[i]) / 2);
+            }
+            break;
+        case FILTER_PAETH:
+            for (size_t i = 0; i < bpp; i++) {
+                out[i] = static_cast<uint8_t>(cur[i] - prev[i]);
+            }
+            for (size_t i = bpp; i < n; i++) {
+                out[i] = static_cast<uint8_t>(cur[i] - paeth(cur[i - bpp], prev[i], prev[i - bpp]));
+            }
+            break;
+    }
+}
+
+/// The heuristic of libpng: the smallest sum of the filtered bytes, as signed values
+auto filterScore(const std::vector<uint8_t>& filtered) -> size_t {
+    size_t score = 0;
+    for (size_t i = 1; i < filtered.size(); i++) {
+        score += static_cast<size_t>(std::abs(static_cast<int8_t>(filtered[i])));
+    }
+    return score;
+}
+
+/// Append to out what deflate outputs for the input
+auto deflateInto(z_stream& zs, const uint8_t* in, size_t length, int flush, std::vector<uint8_t>& out) -> bool {
+    std::array<uint8_t, 1 << 15> buffer;  // NOLINT(cppcoreguidelines-pro-type-member-init)
+    zs.next_in = const_cast<Bytef*>(in);
+    zs.avail_in = strict_cast<uInt>(length);
+    do {
+        zs.next_out = buffer.data();
+        zs.avail_out = strict_cast<uInt>(buffer.size());
+        if (deflate(&zs, flush) == Z_STREAM_ERROR) {
+            return false;
+        }
+        out.insert(out.end(), buffer.data(), buffer.data() + (buffer.size() - zs.avail_out));
+    } while (zs.avail_out == 0);
+    return true;
+}
+
+struct CompressedRows {
+    std::vector<uint8_t> data;
+    uLong adler = 0;
+    size_t length = 0;  ///< Of the uncompressed data
+    bool ok = false;
+};
+
+/**
+ * Compress the rows [begin, end) into a raw deflate stream, ending on a byte boundary so that the next chunk can be
+ * appended to it (or with the final block for the last chunk)
+ */
+auto compressRows(const unsigned char* data, int width, int stride, int begin, int end, bool last,
+                  Compression compression) -> CompressedRows {
+    CompressedRows res;
+    const size_t rowBytes = static_cast<size_t>(width) * BYTES_PER_PIXEL;
+    std::vector<uint8_t> prev(rowBytes, 0);
+    std::vector<uint8_t> cur(rowBytes);
+    std::vector<uint8_t> filtered(rowBytes + 1);
+    std::vector<uint8_t> candidate(rowBytes + 1);
+
+    z_stream zs{};
+    const int level = compression == Compression::FAST ? 1 : Z_DEFAULT_COMPRESSION;
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return res;
+    }
+
+    // The last rows of the previous chunk are filtered again, as the dictionary
+    const int dictionaryRows = static_cast<int>((DICTIONARY_SIZE + rowBytes) / (rowBytes + 1));
+    const int firstRow = std::max(0, begin - dictionaryRows);
+    if (firstRow > 0) {
+        toRGBA(data + static_cast<ptrdiff_t>(firstRow - 1) * stride, width, prev.data());
+    }
+    std::vector<uint8_t> dictionary;
+
+    res.adler = adler32(0L, nullptr, 0);
+    res.ok = true;
+    for (int y = firstRow; y < end && res.ok; y++) {
+        toRGBA(data + static_cast<ptrdiff_t>(y) * stride, width, cur.data());
+        if (compression == Compression::FAST) {
+            filterRow(FILTER_UP, cur.data(), prev.data(), rowBytes, filtered.data());
+        } else {
+            size_t bestScore = SIZE_MAX;
+            for (Filter filter: ALL_FILTERS) {
+                filterRow(filter, cur.data(), prev.data(), rowBytes, candidate.data());
+                if (size_t score = filterScore(candidate); score < bestScore) {
+                    bestScore = score;
+                    std::swap(filtered, candidate);
+                }
+            }
+        }
+        std::swap(prev, cur);
+
+        if (y < begin) {
+            dictionary.insert(dictionary.end(), filtered.begin(), filtered.end());
+            continue;
+        }
+        if (y == begin && !dictionary.empty()) {
+            const size_t size = std::min(dictionary.size(), DICTIONARY_SIZE);
+            deflateSetDictionary(&zs, dictionary.data() + dictionary.size() - size, strict_cast<uInt>(size));
+        }
+        res.adler = adler32(res.adler, filtered.data(), strict_cast<uInt>(filtered.size()));
+        res.length += filtered.size();
+        res.ok = deflateInto(zs, filtered.data(), filtered.size(), Z_NO_FLUSH, res.data);
+    }
+    res.ok = res.ok && deflateInto(zs, nullptr, 0, last ? Z_FINISH : Z_SYNC_FLUSH, res.data);
+    deflateEnd(&zs);
+    return res;
+}
+}  // namespace
+
+auto xoj::util::png::encode(const unsigned char* data, int width, int height, int stride,
+                            const EncoderOptions& options) -> std::vector<uint8_t> {
+    if (width <= 0 || height <= 0 || !data) {
+        return {};
+    }
+
+    const int chunkCount = std::clamp(height / MIN_ROWS_PER_CHUNK, 1, static_cast<int>(std::max(options.threads, 1U)));
+    std::vector<std::future<CompressedRows>> chunks;
+    chunks.reserve(static_cast<size_t>(chunkCount));
+    for (int i = 0; i < chunkCount; i++) {
+        const int begin = static_cast<int>(static_cast<int64_t>(height) * i / chunkCount);
+        const int end = static_cast<int>(static_cast<int64_t>(height) * (i + 1) / chunkCount);
+        // Falls back to compressing in this thread if no thread can be started
+        chunks.push_back(std::async(std::launch::async | std::launch::deferred, compressRows, data, width, stride,
+                                    begin, end, i + 1 == chunkCount, options.compression));
+    }
+
+    std::vector<uint8_t> res(SIGNATURE.begin(), SIGNATURE.end());
+
+    std::vector<uint8_t> header;
+    appendU32(header, static_cast<uint32_t>(width));
+    appendU32(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), {8 /* bit depth */, 6 /* RGBA */, 0, 0, 0 /* not interlaced */});
+    appendChunk(res, "IHDR", header.data(), header.size());
+
+    // The zlib stream: its header, the chunks, and the checksum of the whole
+    uLong adler = adler32(0L, nullptr, 0);
+    for (size_t i = 0; i < chunks.size(); i++) {
+        CompressedRows chunk = chunks[i].get();
+        if (!chunk.ok) {
+            return {};
+        }
+        if (i == 0) {
+            const std::array<uint8_t, 2> zlibHeader{0x78, options.compression == Compression::FAST ? uint8_t(0x01) :
+                                                                                                   uint8_t(0x9c)};
+            chunk.data.insert(chunk.data.begin(), zlibHeader.begin(), zlibHeader.end());
+        }
+        adler = adler32_combine(adler, chunk.adler, static_cast<z_off_t>(chunk.length));
+        if (i + 1 == chunks.size()) {
+            appendU32(chunk.data, static_cast<uint32_t>(adler));
+        }
+        appendChunk(res, "IDAT", chunk.data.data(), chunk.data.size());
+    }
+    appendChunk(res, "IEND", nullptr, 0);
+    return res;
+}
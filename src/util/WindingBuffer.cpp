@@ -0,0 +1,246 @@
+#include "util/WindingBuffer.h"
+
+#include <algorithm>  // for min, max, sort
+#include <climits>    // for INT_MAX, INT_MIN
+#include <cmath>      // for abs, ceil, floor, lround
+#include <cstddef>    // for ptrdiff_t
+
+#include "util/Assert.h"  // for xoj_assert
+
+using namespace xoj::util;
+
+namespace {
+using Pt = Point<double>;
+
+/**
+ * Split the segment at x = 0 and x = maxX. The parts on the left (resp. right) are moved onto x = 0 (resp. maxX): they
+ * keep their contribution to the winding numbers of the pixels in between.
+ */
+template <typename Fn>
+void forEachClippedPart(const Pt& a, const Pt& b, double maxX, Fn&& fn) {
+    std::array<double, 4> ts{0.0, 1.0};
+    size_t n = 2;
+    if (a.x != b.x) {
+        for (double x: {0.0, maxX}) {
+            const double t = (x - a.x) / (b.x - a.x);
+            if (t > 0.0 && t < 1.0) {
+                ts[n++] = t;
+            }
+        }
+    }
+    std::sort(ts.begin(), ts.begin() + static_cast<std::ptrdiff_t>(n));
+
+    for (size_t i = 0; i + 1 < n; i++) {
+        Pt p(a.x + ts[i] * (b.x - a.x), a.y + ts[i] * (b.y - a.y));
+        Pt q(a.x + ts[i + 1] * (b.x - a.x), a.y + ts[i + 1] * (b.y - a.y));
+        const double mid = 0.5 * (p.x + q.x);
+        if (mid < 0.0) {
+            p.x = q.x = 0.0;
+        } else if (mid > maxX) {
+            p.x = q.x = maxX;
+        }
+        fn(p, q);
+    }
+}
+
+/**
+ * Call fn(row, col, value) for the contributions of the segment to the accumulation buffer, for the rows in
+ * [0, height): the winding number of a pixel integrated over its area is the sum of the values of the pixel and of
+ * those on its left. The columns are nonnegative.
+ */
+template <typename Fn>
+void accumulateSegment(Pt p0, Pt p1, int height, Fn&& fn) {
+    if (p0.y == p1.y) {
+        return;
+    }
+    double dir = 1.0;
+    if (p0.y > p1.y) {
+        std::swap(p0, p1);
+        dir = -1.0;
+    }
+    const double dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    const int rowBegin = std::max(0, static_cast<int>(std::floor(p0.y)));
+    const int rowEnd = std::min(height, static_cast<int>(std::ceil(p1.y)));
+
+    for (int y = rowBegin; y < rowEnd; y++) {
+        const double top = std::max<double>(y, p0.y);
+        const double bottom = std::min<double>(y + 1, p1.y);
+        const double xa = p0.x + (top - p0.y) * dxdy;
+        const double xb = p0.x + (bottom - p0.y) * dxdy;
+        const double d = (bottom - top) * dir;
+
+        const double x0 = std::min(xa, xb);
+        const double x1 = std::max(xa, xb);
+        const double x0floor = std::floor(x0);
+        const double x1ceil = std::ceil(x1);
+        const int x0i = static_cast<int>(x0floor);
+        const int x1i = static_cast<int>(x1ceil);
+        if (x1i <= x0i + 1) {
+            // Within a single pixel
+            const double xmf = 0.5 * (xa + xb) - x0floor;
+            fn(y, x0i, d - d * xmf);
+            fn(y, x0i + 1, d * xmf);
+        } else {
+            const double s = 1.0 / (x1 - x0);
+            const double x0f = x0 - x0floor;
+            const double a0 = 0.5 * s * (1.0 - x0f) * (1.0 - x0f);
+            const double x1f = x1 - x1ceil + 1.0;
+            const double am = 0.5 * s * x1f * x1f;
+            fn(y, x0i, d * a0);
+            if (x1i == x0i + 2) {
+                fn(y, x0i + 1, d * (1.0 - a0 - am));
+            } else {
+                const double a1 = s * (1.5 - x0f);
+                fn(y, x0i + 1, d * (a1 - a0));
+                for (int x = x0i + 2; x < x1i - 1; x++) {
+                    fn(y, x, d * s);
+                }
+                const double a2 = a1 + (x1i - x0i - 3) * s;
+                fn(y, x1i - 1, d * (1.0 - a2 - am));
+            }
+            fn(y, x1i, d * am);
+        }
+    }
+}
+
+auto toCoverage(float winding) -> uint8_t {
+    return static_cast<uint8_t>(std::lround(std::min(1.0f, std::abs(winding)) * 255.0f));
+}
+
+/// Below this, the accumulated value is rounding noise: it is not worth creating a tile
+constexpr float EPSILON = 1e-6f;
+}  // namespace
+
+WindingBuffer::WindingBuffer(int width, int height): width(width), height(height) {
+    xoj_assert(width >= 0 && height >= 0);
+}
+
+void WindingBuffer::addPolygon(const std::vector<Pt>& polygon) {
+    if (polygon.size() < 3) {
+        return;
+    }
+    double minY = polygon.front().y;
+    double maxY = minY;
+    for (auto&& p: polygon) {
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+    const int rowBegin = std::max(0, static_cast<int>(std::floor(minY)));
+    const int rowEnd = std::min(height, static_cast<int>(std::ceil(maxY)));
+    if (rowBegin >= rowEnd) {
+        return;
+    }
+
+    auto forEachContribution = [&](auto&& fn) {
+        for (size_t i = 0; i < polygon.size(); i++) {
+            const Pt& a = polygon[i];
+            const Pt& b = polygon[(i + 1) % polygon.size()];
+            forEachClippedPart(a, b, width,
+                               [&](const Pt& p, const Pt& q) { accumulateSegment(p, q, rowEnd, fn); });
+        }
+    };
+
+    // First pass: the span of each row, so that the accumulation buffer is only as large as the polygon
+    struct Span {
+        int begin = INT_MAX;
+        int end = INT_MIN;
+        size_t offset = 0;
+    };
+    std::vector<Span> spans(static_cast<size_t>(rowEnd - rowBegin));
+    forEachContribution([&](int y, int x, double) {
+        Span& s = spans[static_cast<size_t>(y - rowBegin)];
+        s.begin = std::min(s.begin, x);
+        s.end = std::max(s.end, x + 1);
+    });
+    size_t total = 0;
+    for (Span& s: spans) {
+        if (s.begin < s.end) {
+            s.offset = total;
+            total += static_cast<size_t>(s.end - s.begin);
+        }
+    }
+
+    // Second pass: accumulate
+    std::vector<float> acc(total);
+    forEachContribution([&](int y, int x, double value) {
+        const Span& s = spans[static_cast<size_t>(y - rowBegin)];
+        acc[s.offset + static_cast<size_t>(x - s.begin)] += static_cast<float>(value);
+    });
+
+    // Add the prefix sums of the rows to the tiles
+    for (int y = rowBegin; y < rowEnd; y++) {
+        const Span& s = spans[static_cast<size_t>(y - rowBegin)];
+        Tile* tile = nullptr;
+        int runBegin = 0;
+        auto endRun = [&](int runEnd) {
+            if (tile && runEnd > runBegin) {
+                Rectangle<int> run(runBegin, y, runEnd - runBegin, 1);
+                if (tile->changed) {
+                    tile->changes.unite(run);
+                } else {
+                    tile->changes = run;
+                    tile->changed = true;
+                    changedTiles.push_back(tile);
+                }
+            }
+            tile = nullptr;
+        };
+
+        float sum = 0.0f;
+        const int end = std::min(s.end, width);
+        for (int x = s.begin; x < end; x++) {
+            sum += acc[s.offset + static_cast<size_t>(x - s.begin)];
+            if (std::abs(sum) < EPSILON) {
+                endRun(x);
+                continue;
+            }
+            if (!tile || x >= tile->x + TILE_SIZE) {
+                endRun(x);
+                tile = &getTile(x / TILE_SIZE, y / TILE_SIZE);
+                runBegin = x;
+            }
+            const size_t index = static_cast<size_t>((y - tile->y) * TILE_SIZE + x - tile->x);
+            tile->winding[index] += sum;
+            tile->coverage[index] = toCoverage(tile->winding[index]);
+        }
+        endRun(end);
+    }
+}
+
+void WindingBuffer::clear() {
+    tiles.clear();
+    changedTiles.clear();
+}
+
+auto WindingBuffer::takeChanges() -> std::vector<std::pair<const Tile*, Rectangle<int>>> {
+    std::vector<std::pair<const Tile*, Rectangle<int>>> res;
+    res.reserve(changedTiles.size());
+    for (Tile* tile: changedTiles) {
+        res.emplace_back(tile, tile->changes);
+        tile->changed = false;
+    }
+    changedTiles.clear();
+    return res;
+}
+
+auto WindingBuffer::getCoverage(int x, int y) const -> uint8_t {
+    if (x < 0 || y < 0) {
+        return 0;
+    }
+    auto it = tiles.find(toKey(x / TILE_SIZE, y / TILE_SIZE));
+    if (it == tiles.end()) {
+        return 0;
+    }
+    const Tile& tile = *it->second;
+    return tile.coverage[static_cast<size_t>((y - tile.y) * TILE_SIZE + x - tile.x)];
+}
+
+auto WindingBuffer::getTile(int col, int row) -> Tile& {
+    auto& tile = tiles[toKey(col, row)];
+    if (!tile) {
+        tile = std::make_unique<Tile>();
+        tile->x = col * TILE_SIZE;
+        tile->y = row * TILE_SIZE;
+    }
+    return *tile;
+}
@@ -1,8 +1,9 @@
 #include "util/XojPreviewExtractor.h"
 
-#include <array>    // for array
-#include <cstring>  // for strlen, strncmp
-#include <string>   // for allocator, string
+#include <algorithm>  // for min
+#include <array>      // for array
+#include <cstring>    // for strlen, strncmp
+#include <string>     // for allocator, string
 
 #include <glib.h>     // for g_free, g_base64_decode, g_malloc, gsize
 #include <zip.h>      // for zip_close, zip_fclose, zip_stat_t, zip_fopen
@@ -26,7 +27,12 @@ const size_t TAG_PREVIEW_END_NAME_LEN = strlen(TAG_PREVIEW_END_NAME);
 // max base64-overhead is ceil(50334/3)*4 = 67112
 // see https://stackoverflow.com/a/4715480/2907484
 // round it up a bit
+// This is also the most that is read of an .xoj file: the preview is at its start.
 constexpr auto BUF_SIZE = 68000;
+// The .xoj files are decompressed by chunks, until the end of the preview or the first page
+constexpr auto CHUNK_SIZE = 4096;
+// The most that is read of the thumbnail of an .xopp file
+constexpr zip_uint64_t MAX_THUMBNAIL_SIZE = 4 * 1024 * 1024;
 
 XojPreviewExtractor::XojPreviewExtractor() = default;
 
@@ -119,12 +125,24 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
             return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
         }
 
-        // The <preview> Tag is within the first 179 Bytes
-
-        std::array<char, BUF_SIZE> buffer{};
-        int readLen = gzread(fp, buffer.data(), BUF_SIZE);
-
-        PreviewExtractResult result = readPreview(buffer.data(), readLen);
+        // The <preview> Tag is within the first 179 Bytes: stop reading at the end of the preview, or at the first
+        // page if there is none
+        std::string buffer;
+        buffer.reserve(BUF_SIZE);
+        std::array<char, CHUNK_SIZE> chunk{};
+        PreviewExtractResult result = PREVIEW_RESULT_ERROR_READING_PREVIEW;
+        while (buffer.size() < BUF_SIZE) {
+            auto toRead = static_cast<unsigned int>(std::min<size_t>(CHUNK_SIZE, BUF_SIZE - buffer.size()));
+            int readLen = gzread(fp, chunk.data(), toRead);
+            if (readLen <= 0) {
+                break;
+            }
+            buffer.append(chunk.data(), static_cast<size_t>(readLen));
+            result = readPreview(buffer.data(), static_cast<int>(buffer.size()));
+            if (result != PREVIEW_RESULT_ERROR_READING_PREVIEW) {
+                break;
+            }
+        }
 
         gzclose(fp);
         return result;
@@ -140,7 +158,7 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
         return PREVIEW_RESULT_NO_PREVIEW;
     }
 
-    if (thumbStat.valid & ZIP_STAT_SIZE) {
+    if ((thumbStat.valid & ZIP_STAT_SIZE) && thumbStat.size <= MAX_THUMBNAIL_SIZE) {
         dataLen = thumbStat.size;
     } else {
         zip_close(zipFp);
@@ -157,9 +175,11 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
     data = static_cast<unsigned char*>(g_malloc(thumbStat.size));
     zip_uint64_t readBytes = 0;
     while (readBytes < dataLen) {
-        zip_int64_t read = zip_fread(thumb, data, thumbStat.size);
-        if (read == -1) {
+        zip_int64_t read = zip_fread(thumb, data + readBytes, thumbStat.size - readBytes);
+        if (read <= 0) {
             g_free(data);
+            data = nullptr;
+            dataLen = 0;
             zip_fclose(thumb);
             zip_close(zipFp);
             return PREVIEW_RESULT_ERROR_READING_PREVIEW;
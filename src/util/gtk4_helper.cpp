@@ -140,6 +140,7 @@ void gtk_button_set_icon_name(GtkButton* button, const char* iconName) {
 
 GtkWidget* gtk_popover_new() { return gtk_popover_new(nullptr); }
 void gtk_popover_set_child(GtkPopover* popover, GtkWidget* child) { set_child(GTK_CONTAINER(popover), child); }
+GtkWidget* gtk_popover_get_child(GtkPopover* popover) { return gtk_bin_get_child(GTK_BIN(popover)); }
 GtkWidget* gtk_popover_menu_new_from_model(GMenuModel* model) { return gtk_popover_new_from_model(nullptr, model); }
 
 /**** GtkLabel ****/
@@ -19,12 +19,10 @@ public:
     CircularBuffer(size_t length): std::vector<T>(length > 1 ? length : 1), length(length > 1 ? length : 1) {}
     ~CircularBuffer() = default;
     T front() { return (*this)[head]; }
-    T back() {
-        if (head == 0) {
-            return (*this)[length - 1];
-        }
-        return (*this)[head - 1];
-    }
+    /**
+     * The oldest element, i.e. the next one to be overwritten by push_front()
+     */
+    T back() { return (*this)[(head + 1) % length]; }
     void push_front(const T& ev) {
         head++;
         head %= length;
@@ -0,0 +1,72 @@
+/*
+ * Xournal++
+ *
+ * Area to repaint, as a few rectangles
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>  // for min
+#include <cstddef>    // for size_t
+#include <vector>     // for vector
+
+#include "util/Range.h"  // for Range
+
+namespace xoj::util {
+
+/**
+ * @brief The area to repaint, as a few rectangles rather than their bounding box.
+ *
+ * For instance, upon moving an ellipse, the old and the new outlines are repainted but not the inside. The rectangles
+ * wasting little area when merged are merged as they are added, and at most MAX_RANGES are kept.
+ */
+class DamageRegion {
+public:
+    /// The maximal number of rectangles kept
+    static constexpr size_t MAX_RANGES = 16;
+    /// The number of rectangles an outline is split into
+    static constexpr size_t OUTLINE_RUNS = 8;
+
+    /**
+     * @brief Add a rectangle. Empty or invalid ranges are ignored.
+     */
+    void add(const Range& rg);
+
+    /**
+     * @brief Add the polyline going through the points (anything with x and y members), with the given padding
+     * (typically half the line width): the bounding boxes of a few runs of consecutive points
+     */
+    template <typename PointContainer>
+    void addOutline(const PointContainer& pts, double padding) {
+        const size_t n = pts.size();
+        if (n == 0) {
+            return;
+        }
+        const size_t runs = std::min(OUTLINE_RUNS, n);
+        for (size_t r = 0; r < runs; r++) {
+            // Consecutive runs share a point, so that the segment in between is covered
+            const size_t begin = r * (n - 1) / runs;
+            const size_t end = std::min(n - 1, (r + 1) * (n - 1) / runs);
+            Range rg(pts[begin].x, pts[begin].y);
+            for (size_t i = begin + 1; i <= end; i++) {
+                rg.addPoint(pts[i].x, pts[i].y);
+            }
+            rg.addPadding(padding);
+            add(rg);
+        }
+    }
+
+    bool empty() const;
+    const std::vector<Range>& getRanges() const;
+    Range getBoundingBox() const;
+    void clear();
+
+private:
+    std::vector<Range> ranges;
+};
+};  // namespace xoj::util
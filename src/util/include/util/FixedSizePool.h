@@ -0,0 +1,158 @@
+/*
+ * Xournal++
+ *
+ * Pool of memory blocks of a fixed size
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t, max_align_t
+#include <mutex>    // for mutex, lock_guard
+#include <new>      // for operator new, align_val_t
+
+namespace xoj::util {
+
+/**
+ * @brief Allocator of memory blocks of a fixed size, for the objects allocated by millions (e.g. the strokes of a big
+ *      document).
+ *
+ * The blocks are carved out of large chunks, which saves most of the calls to malloc and keeps the objects together
+ * instead of fragmenting the heap. The freed blocks are reused, but the chunks are never returned to the system.
+ *
+ * Each thread keeps a small cache of free blocks, so that the threads (e.g. those parsing a document in parallel)
+ * rarely contend for the shared free list. A block may be freed by another thread than the one which allocated it.
+ */
+template <size_t BlockSize, size_t Alignment = alignof(std::max_align_t)>
+class FixedSizePool {
+public:
+    /// Number of blocks moved at once between the cache of a thread and the shared free list
+    static constexpr size_t BATCH_SIZE = 64;
+
+    /// Number of blocks in a chunk
+    static constexpr size_t CHUNK_BLOCKS = 1024;
+
+    static void* allocate();
+    static void deallocate(void* block);
+
+private:
+    struct Node {
+        Node* next;
+    };
+
+    static constexpr size_t ALIGNMENT = Alignment < alignof(Node) ? alignof(Node) : Alignment;
+    static constexpr size_t SIZE = BlockSize < sizeof(Node) ? sizeof(Node) : BlockSize;
+    static constexpr size_t STRIDE = (SIZE + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    struct Shared {
+        std::mutex mutex;
+        Node* freeList = nullptr;
+    };
+
+    /// Trivially destructible, so that it stays usable while the other thread_local objects are destroyed
+    struct Cache {
+        Node* freeList = nullptr;
+        size_t count = 0;
+        bool flushed = false;
+    };
+
+    /// Gives the cached blocks back to the shared free list when the thread exits
+    struct CacheFlusher {
+        ~CacheFlusher();
+    };
+
+    /// Never destroyed, as blocks may still be freed during the destruction of the static objects
+    static Shared& getShared() {
+        static Shared* shared = new Shared();
+        return *shared;
+    }
+
+    static Cache& getCache() {
+        thread_local Cache cache;
+        thread_local CacheFlusher flusher;
+        return cache;
+    }
+
+    static void refill(Cache& cache);
+    static void moveToShared(Cache& cache, size_t count);
+};
+
+template <size_t BlockSize, size_t Alignment>
+void* FixedSizePool<BlockSize, Alignment>::allocate() {
+    Cache& cache = getCache();
+    if (!cache.freeList) {
+        refill(cache);
+    }
+    Node* node = cache.freeList;
+    cache.freeList = node->next;
+    cache.count--;
+    return node;
+}
+
+template <size_t BlockSize, size_t Alignment>
+void FixedSizePool<BlockSize, Alignment>::deallocate(void* block) {
+    if (!block) {
+        return;
+    }
+    Cache& cache = getCache();
+    Node* node = static_cast<Node*>(block);
+    node->next = cache.freeList;
+    cache.freeList = node;
+    cache.count++;
+    if (cache.flushed || cache.count >= 2 * BATCH_SIZE) {
+        moveToShared(cache, cache.flushed ? cache.count : BATCH_SIZE);
+    }
+}
+
+template <size_t BlockSize, size_t Alignment>
+void FixedSizePool<BlockSize, Alignment>::refill(Cache& cache) {
+    {
+        Shared& shared = getShared();
+        std::lock_guard lock(shared.mutex);
+        for (size_t i = 0; i < BATCH_SIZE && shared.freeList; i++) {
+            Node* node = shared.freeList;
+            shared.freeList = node->next;
+            node->next = cache.freeList;
+            cache.freeList = node;
+            cache.count++;
+        }
+    }
+    if (cache.freeList) {
+        return;
+    }
+
+    // Carve a new chunk. Its blocks stay in this thread until they are freed
+    auto* chunk = static_cast<std::byte*>(::operator new(STRIDE * CHUNK_BLOCKS, std::align_val_t(ALIGNMENT)));
+    for (size_t i = CHUNK_BLOCKS; i > 0; i--) {
+        Node* node = reinterpret_cast<Node*>(chunk + (i - 1) * STRIDE);
+        node->next = cache.freeList;
+        cache.freeList = node;
+    }
+    cache.count += CHUNK_BLOCKS;
+}
+
+template <size_t BlockSize, size_t Alignment>
+void FixedSizePool<BlockSize, Alignment>::moveToShared(Cache& cache, size_t count) {
+    Shared& shared = getShared();
+    std::lock_guard lock(shared.mutex);
+    for (size_t i = 0; i < count && cache.freeList; i++) {
+        Node* node = cache.freeList;
+        cache.freeList = node->next;
+        cache.count--;
+        node->next = shared.freeList;
+        shared.freeList = node;
+    }
+}
+
+template <size_t BlockSize, size_t Alignment>
+FixedSizePool<BlockSize, Alignment>::CacheFlusher::~CacheFlusher() {
+    Cache& cache = getCache();
+    moveToShared(cache, cache.count);
+    cache.flushed = true;
+}
+
+}  // namespace xoj::util
@@ -0,0 +1,60 @@
+/*
+ * Xournal++
+ *
+ * Fast parser of whitespace separated lists of numbers (e.g. the coordinates of a stroke)
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+
+namespace xoj::util {
+
+/**
+ * @return true for the whitespace characters separating the numbers
+ */
+constexpr bool isNumberSeparator(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+/**
+ * @brief Count the whitespace separated tokens of [begin, end). Used to reserve memory before parsing the numbers.
+ */
+size_t countNumberTokens(const char* begin, const char* end);
+
+/**
+ * @brief Parse a floating point number at the beginning of [begin, end), independently of the locale.
+ *      The input does not need to be null-terminated. A leading '+' is accepted, leading whitespace is not.
+ * @return The position after the number, or begin if no number could be read
+ */
+const char* parseDouble(const char* begin, const char* end, double& value);
+
+/**
+ * @brief Call fn(double) with each of the whitespace separated numbers of [begin, end).
+ *      The parsing stops at the first token which is not a number.
+ * @return The position where the parsing stopped
+ */
+template <typename Fn>
+const char* forEachNumber(const char* begin, const char* end, Fn&& fn) {
+    const char* p = begin;
+    for (;;) {
+        while (p != end && isNumberSeparator(*p)) {
+            p++;
+        }
+        if (p == end) {
+            return p;
+        }
+        double value = 0;
+        const char* next = parseDouble(p, end, value);
+        if (next == p) {
+            return p;
+        }
+        fn(value);
+        p = next;
+    }
+}
+
+};  // namespace xoj::util
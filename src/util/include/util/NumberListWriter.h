@@ -0,0 +1,57 @@
+/*
+ * Xournal++
+ *
+ * Fast writer of whitespace separated lists of numbers (e.g. the coordinates of a stroke)
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>    // for array
+#include <cstddef>  // for size_t
+
+class OutputStream;
+
+namespace xoj::util {
+
+/// Enough for any double formatted by formatDouble()
+constexpr size_t FORMATTED_DOUBLE_MAX_LENGTH = 32;
+
+/**
+ * @brief Format the number as g_ascii_formatd() does with Util::PRECISION_FORMAT_STRING ("%.8g"), with the same
+ *      output, independently of the locale. No null terminator is written.
+ * @param first Where to write at least FORMATTED_DOUBLE_MAX_LENGTH characters
+ * @return The position after the last character written
+ */
+char* formatDouble(char* first, double value);
+
+/**
+ * Writes numbers formatted by formatDouble(), separated by spaces, into an OutputStream. The numbers are written in
+ * batches, into a buffer which is written to the stream once full or when the writer is flushed or destroyed.
+ */
+class NumberListWriter {
+public:
+    explicit NumberListWriter(OutputStream* out);
+    ~NumberListWriter();
+
+    NumberListWriter(const NumberListWriter&) = delete;
+    NumberListWriter& operator=(const NumberListWriter&) = delete;
+
+    /// Append a number to the list, after a space unless it is the first one
+    void write(double value);
+
+    /// Write the buffered numbers to the stream. The next number still follows a space.
+    void flush();
+
+private:
+    OutputStream* out;
+    std::array<char, 16 * 1024> buffer{};
+    size_t length = 0;
+    bool first = true;
+};
+
+};  // namespace xoj::util
@@ -11,9 +11,13 @@
 
 #pragma once
 
-#include <string>  // for string
+#include <cstddef>  // for size_t
+#include <deque>    // for deque
+#include <fstream>  // for ofstream
+#include <future>   // for future
+#include <string>   // for string
 
-#include <zlib.h>  // for gzFile
+#include <zlib.h>  // for uLong
 
 #include "filesystem.h"  // for path
 
@@ -30,6 +34,11 @@ public:
     virtual void close() = 0;
 };
 
+/**
+ * Writes a gzip file. The data is split into blocks which are compressed on worker threads (in the way of pigz):
+ * every block is primed with the end of the previous one and ends on a byte boundary, so that the result is a single
+ * gzip member, with the same compression ratio as a sequential deflate.
+ */
 class GzOutputStream: public OutputStream {
 public:
     GzOutputStream(fs::path file);
@@ -43,8 +52,50 @@ public:
     const std::string& getLastError() const;
 
 private:
-    gzFile fp = nullptr;
+    struct CompressedBlock {
+        std::string data;
+        uLong crc;
+        size_t length;
+        bool ok;
+    };
+
+    static CompressedBlock compress(const std::string& input, const std::string& dictionary, bool last);
+
+    /// Start the compression of the pending data
+    void compressPending(bool last);
+    /// Write the oldest compressed block to the file
+    void writeBlock();
+    void writeRaw(const std::string& data);
+
+private:
+    std::ofstream fp;
+    bool open = false;
+
+    std::string pending;
+    /// End of the previously compressed data, used as the dictionary of the next block
+    std::string dictionary;
+    std::deque<std::future<CompressedBlock>> blocks;
+    size_t maxBlocksInFlight;
+
+    uLong crc;
+    size_t totalLength = 0;
 
     std::string error;
     fs::path file;
 };
+
+/**
+ * Collects the data in memory
+ */
+class StringOutputStream: public OutputStream {
+public:
+    using OutputStream::write;
+    void write(const char* data, size_t len) override;
+
+    void close() override;
+
+    const std::string& getData() const;
+
+private:
+    std::string data;
+};
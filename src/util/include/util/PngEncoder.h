@@ -0,0 +1,43 @@
+/*
+ * Xournal++
+ *
+ * PNG encoder for cairo's image surfaces
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>  // for uint8_t
+#include <vector>   // for vector
+
+namespace xoj::util::png {
+
+enum class Compression {
+    /// zlib's default level, and the filter of each row chosen as libpng does
+    DEFAULT,
+    /// zlib's fastest level and the "up" filter: larger files, encoded several times faster
+    FAST
+};
+
+struct EncoderOptions {
+    Compression compression = Compression::DEFAULT;
+    /// The rows are split into this many chunks at most, compressed in parallel
+    unsigned int threads = 1;
+};
+
+/**
+ * @brief Encode premultiplied ARGB32 pixels, as in cairo's image surfaces, as an RGBA PNG file.
+ *
+ * The rows are unpremultiplied and filtered one at a time while being compressed, without any copy of the image. Each
+ * chunk of rows is compressed independently (on its own thread) and the resulting deflate streams are concatenated,
+ * as pigz does.
+ *
+ * @return The content of the file, or an empty vector on error
+ */
+std::vector<uint8_t> encode(const unsigned char* data, int width, int height, int stride,
+                            const EncoderOptions& options);
+};  // namespace xoj::util::png
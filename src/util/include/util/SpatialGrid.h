@@ -0,0 +1,197 @@
+/*
+ * Xournal++
+ *
+ * Uniform grid spatial index
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>      // for find, max, min
+#include <cmath>          // for floor, isfinite
+#include <cstddef>        // for size_t
+#include <cstdint>        // for int32_t, uint32_t, uint64_t
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "util/Range.h"  // for Range
+
+namespace xoj::util {
+
+/**
+ * @brief Uniform grid over the plane, for finding the items whose bounding box intersects an area without testing
+ *      every single item.
+ *
+ * Every item is registered in each cell its bounding box touches. Items covering too many cells (or with invalid
+ * bounds) are kept aside and returned by every query.
+ * A query may return items whose bounding box does not actually intersect the area: the caller does the exact test.
+ *
+ * @tparam T A hashable handle on the items, typically a pointer
+ */
+template <typename T>
+class SpatialGrid {
+public:
+    /// Default size of the cells, in page coordinates
+    static constexpr double DEFAULT_CELL_SIZE = 64.0;
+    /// Items touching more cells than that are kept in the oversized list
+    static constexpr int64_t MAX_CELLS_PER_ITEM = 256;
+
+    explicit SpatialGrid(double cellSize = DEFAULT_CELL_SIZE): cellSize(cellSize) {}
+
+    /**
+     * @brief Register the item with the given bounds. If the item is already registered, it is moved.
+     */
+    void insert(const T& item, const Range& bounds) {
+        remove(item);
+        const Span span = spanOf(bounds);
+        if (span.oversized) {
+            oversized.push_back(item);
+        } else {
+            for (int32_t row = span.minRow; row <= span.maxRow; row++) {
+                for (int32_t col = span.minCol; col <= span.maxCol; col++) {
+                    cells[toKey(col, row)].push_back(item);
+                }
+            }
+        }
+        items.emplace(item, span);
+    }
+
+    /**
+     * @return false if the item was not registered
+     */
+    bool remove(const T& item) {
+        auto it = items.find(item);
+        if (it == items.end()) {
+            return false;
+        }
+        const Span& span = it->second;
+        if (span.oversized) {
+            eraseFrom(oversized, item);
+        } else {
+            for (int32_t row = span.minRow; row <= span.maxRow; row++) {
+                for (int32_t col = span.minCol; col <= span.maxCol; col++) {
+                    auto cell = cells.find(toKey(col, row));
+                    if (cell != cells.end()) {
+                        eraseFrom(cell->second, item);
+                        if (cell->second.empty()) {
+                            cells.erase(cell);
+                        }
+                    }
+                }
+            }
+        }
+        items.erase(it);
+        return true;
+    }
+
+    bool contains(const T& item) const { return items.find(item) != items.end(); }
+
+    size_t size() const { return items.size(); }
+
+    bool empty() const { return items.empty(); }
+
+    void clear() {
+        cells.clear();
+        items.clear();
+        oversized.clear();
+    }
+
+    /**
+     * @return The items whose bounds may intersect the area, each one reported once, in no particular order
+     */
+    std::vector<T> query(const Range& area) const {
+        std::vector<T> res;
+        if (area.empty()) {
+            return res;
+        }
+        const Span q = spanOf(area);
+        const bool everything = q.cellCount() <= 0;  // The area is invalid
+        if (everything || q.oversized || static_cast<size_t>(q.cellCount()) >= items.size()) {
+            // Looking at every item is cheaper than looking at every cell
+            for (auto&& [item, span]: items) {
+                if (everything || span.oversized || span.intersects(q)) {
+                    res.push_back(item);
+                }
+            }
+            return res;
+        }
+
+        res = oversized;
+        for (int32_t row = q.minRow; row <= q.maxRow; row++) {
+            for (int32_t col = q.minCol; col <= q.maxCol; col++) {
+                auto cell = cells.find(toKey(col, row));
+                if (cell == cells.end()) {
+                    continue;
+                }
+                for (auto&& item: cell->second) {
+                    // Report the item only in the first cell it shares with the query, to avoid duplicates
+                    const Span& span = items.find(item)->second;
+                    if (col == std::max(span.minCol, q.minCol) && row == std::max(span.minRow, q.minRow)) {
+                        res.push_back(item);
+                    }
+                }
+            }
+        }
+        return res;
+    }
+
+private:
+    struct Span {
+        int32_t minCol = 0;
+        int32_t minRow = 0;
+        int32_t maxCol = -1;
+        int32_t maxRow = -1;
+        bool oversized = false;
+
+        int64_t cellCount() const {
+            return (static_cast<int64_t>(maxCol) - minCol + 1) * (static_cast<int64_t>(maxRow) - minRow + 1);
+        }
+        bool intersects(const Span& o) const {
+            return minCol <= o.maxCol && o.minCol <= maxCol && minRow <= o.maxRow && o.minRow <= maxRow;
+        }
+    };
+
+    Span spanOf(const Range& bounds) const {
+        Span span;
+        if (!bounds.isValid() || !std::isfinite(bounds.minX) || !std::isfinite(bounds.minY) ||
+            !std::isfinite(bounds.maxX) || !std::isfinite(bounds.maxY)) {
+            span.oversized = true;
+            return span;
+        }
+        auto toIndex = [this](double v) {
+            constexpr double LIMIT = 1e9;  // Keeps the cell indices within int32_t
+            return static_cast<int32_t>(std::floor(std::max(-LIMIT, std::min(LIMIT, v / cellSize))));
+        };
+        span.minCol = toIndex(bounds.minX);
+        span.minRow = toIndex(bounds.minY);
+        span.maxCol = toIndex(bounds.maxX);
+        span.maxRow = toIndex(bounds.maxY);
+        span.oversized = span.cellCount() > MAX_CELLS_PER_ITEM;
+        return span;
+    }
+
+    static constexpr uint64_t toKey(int32_t col, int32_t row) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(col);
+    }
+
+    static void eraseFrom(std::vector<T>& v, const T& item) {
+        auto it = std::find(v.begin(), v.end(), item);
+        if (it != v.end()) {
+            *it = std::move(v.back());
+            v.pop_back();
+        }
+    }
+
+private:
+    double cellSize;
+
+    std::unordered_map<uint64_t, std::vector<T>> cells;
+    std::unordered_map<T, Span> items;
+    std::vector<T> oversized;
+};
+};  // namespace xoj::util
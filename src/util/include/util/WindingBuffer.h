@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * Antialiased coverage of a polygon growing point by point
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <array>          // for array
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint8_t, uint64_t
+#include <memory>         // for unique_ptr
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
+
+#include "util/Point.h"      // for Point
+#include "util/Rectangle.h"  // for Rectangle
+
+namespace xoj::util {
+
+/**
+ * @brief Coverage of a filled polygon (non-zero rule, antialiased), for a polygon that changes a little at a time.
+ *
+ * The buffer holds, for every pixel, the winding number of the polygon integrated over the pixel. This is additive:
+ * adding the polygon (P0, Pn, ..., Pm) to the buffer of the polygon (P0, ..., Pn) gives the buffer of (P0, ..., Pm).
+ * Adding a polygon costs its perimeter plus its area, in pixels, whatever was added before.
+ *
+ * The pixels are stored in tiles of TILE_SIZE x TILE_SIZE, created when a polygon first touches them. The coverage of
+ * a pixel is min(1, |winding number|), stored as the alpha values of a CAIRO_FORMAT_A8 image of stride TILE_SIZE.
+ */
+class WindingBuffer {
+public:
+    /// Size of the tiles, in pixels. A multiple of 4, as cairo wants for the stride.
+    static constexpr int TILE_SIZE = 64;
+
+    struct Tile {
+        /// Position of the top left pixel of the tile
+        int x = 0;
+        int y = 0;
+        std::array<float, TILE_SIZE * TILE_SIZE> winding{};
+        std::array<uint8_t, TILE_SIZE * TILE_SIZE> coverage{};
+
+    private:
+        friend class WindingBuffer;
+        /// The pixels changed since the last call to takeChanges()
+        Rectangle<int> changes;
+        bool changed = false;
+    };
+
+    /**
+     * @param width, height The extent of the buffer, in pixels. The polygons are clipped to it.
+     */
+    WindingBuffer(int width, int height);
+
+    /**
+     * @brief Add the winding numbers of the polygon, in pixels. The polygon is implicitly closed.
+     */
+    void addPolygon(const std::vector<Point<double>>& polygon);
+
+    /**
+     * @brief Delete all the tiles
+     */
+    void clear();
+
+    /**
+     * @return The tiles whose coverage changed since the last call, with the bounding box (in pixels) of the changes
+     */
+    std::vector<std::pair<const Tile*, Rectangle<int>>> takeChanges();
+
+    /**
+     * @return The coverage of the pixel, between 0 and 255
+     */
+    uint8_t getCoverage(int x, int y) const;
+
+    inline size_t getTileCount() const { return tiles.size(); }
+
+private:
+    static constexpr uint64_t toKey(int col, int row) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32) | static_cast<uint32_t>(col);
+    }
+
+    Tile& getTile(int col, int row);
+
+    int width;
+    int height;
+    std::unordered_map<uint64_t, std::unique_ptr<Tile>> tiles;
+    std::vector<Tile*> changedTiles;
+};
+};  // namespace xoj::util
@@ -13,14 +13,16 @@
 
 #include <cstddef>  // for size_t
 #include <cstdint>  // for uint32_t
-#include <sstream>  // for istringstream
+#include <cstring>  // for memcpy
 #include <string>   // for string
 #include <vector>   // for vector
 
-#include "util/safe_casts.h"  // for as_signed
-
 #include "InputStreamException.h"
 
+/**
+ * @brief Reads the streams of ObjectOutputStream. The values are read in the order they were written, the reads only
+ * check that the stream is long enough.
+ */
 class ObjectInputStream {
 public:
     ObjectInputStream() = default;
@@ -54,35 +56,31 @@ private:
     template <class T>
     T readType();
 
+    /// Throws if less than n bytes are left
+    void checkAvailable(size_t n, const char* what) const;
+
 private:
-    std::istringstream istream;
-    size_t pos();
-    size_t len = 0;
+    std::string data;
+    size_t pos = 0;
 };
 
 extern template size_t ObjectInputStream::readType<size_t>();
 
 template <typename T>
 void ObjectInputStream::readData(std::vector<T>& data) {
-    checkType('b');
-
-    if (istream.str().size() < 2 * sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read data len and width", __FILE__, __LINE__);
-    }
-
     size_t len = readType<size_t>();
     size_t width = readType<size_t>();
 
     if (width != sizeof(T)) {
         throw InputStreamException("Data width mismatch requested type width", __FILE__, __LINE__);
     }
-
-    if (istream.str().size() < len * width) {
+    if (len > (this->data.size() - this->pos) / width) {
         throw InputStreamException("End reached, but try to read data", __FILE__, __LINE__);
     }
 
+    data.resize(len);
     if (len) {
-        data.resize(len);
-        istream.read((char*)data.data(), as_signed(len * width));
+        std::memcpy(static_cast<void*>(data.data()), this->data.data() + this->pos, len * width);
+        this->pos += len * width;
     }
 }
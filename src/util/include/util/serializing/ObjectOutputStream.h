@@ -21,6 +21,14 @@
 
 class ObjectEncoding;
 
+/**
+ * @brief Binary stream of serialized objects, used for the clipboard, the undo spill and the recovery journal.
+ *
+ * The stream starts with the version string XML_VERSION_STR. The values are written in native byte order, without any
+ * type tag: they must be read in the order they were written. Only the objects are delimited, by "_{" followed by the
+ * name of the object and "_}". Strings, images and arrays are prefixed with their length, and arrays are copied at
+ * once.
+ */
 class ObjectOutputStream {
 public:
     ObjectOutputStream(ObjectEncoding* encoder);
@@ -47,6 +55,12 @@ public:
 
     GString* getStr();
 
+private:
+    template <typename T>
+    void writeValue(const T& v);
+    /// The length, then the bytes
+    void writeBytes(const void* data, size_t len);
+
 private:
     ObjectEncoding* encoder = nullptr;
 };
@@ -16,7 +16,8 @@
 class ObjectInputStream;
 class ObjectOutputStream;
 
-const static char* const XML_VERSION_STR = "XojStrm1:";
+// Version 2: the values are not tagged with their type, only the objects are delimited
+const static char* const XML_VERSION_STR = "XojStrm2:";
 
 class Serializable {
 public:
@@ -1,40 +1,38 @@
 #include "util/serializing/ObjectInputStream.h"
 
 #include <cstdint>  // for uint32_t
+#include <cstring>  // for memcpy
 
 #include <glib.h>  // for g_free, g_strdup_...
 
 #include "util/PlaceholderString.h"                 // for PlaceholderString
 #include "util/i18n.h"                              // for FORMAT_STR, FS
-#include "util/safe_casts.h"                        // for as_signed
 #include "util/serializing/InputStreamException.h"  // for InputStreamException
 #include "util/serializing/Serializable.h"          // for XML_VERSION_STR
 
 template size_t ObjectInputStream::readType<size_t>();
 
+void ObjectInputStream::checkAvailable(size_t n, const char* what) const {
+    if (n > this->data.size() - this->pos) {
+        throw InputStreamException(FS(FORMAT_STR("End reached: trying to read {1} of {2} bytes at index {3} of {4}") %
+                                      what % n % this->pos % this->data.size()),
+                                   __FILE__, __LINE__);
+    }
+}
+
 // This function requires that T is read from its binary representation to work (e.g. integer type)
 template <typename T>
 T ObjectInputStream::readType() {
-    if (istream.str().size() < sizeof(T)) {
-        std::ostringstream oss;
-        oss << "End reached: trying to read " << sizeof(T) << " bytes while only " << istream.str().size()
-            << " bytes available";
-        throw InputStreamException(oss.str(), __FILE__, __LINE__);
-    }
+    checkAvailable(sizeof(T), "a value");
     T output;
-
-    istream.read((char*)&output, as_signed(sizeof(T)));
-
+    std::memcpy(&output, this->data.data() + this->pos, sizeof(T));
+    this->pos += sizeof(T);
     return output;
 }
 
-size_t ObjectInputStream::pos() { return static_cast<size_t>(istream.tellg()); }
-
 auto ObjectInputStream::read(const char* data, size_t data_len) -> bool {
-    istream.clear();
-    len = data_len;
-    std::string dataStr = std::string(data, len);
-    istream.str(dataStr);
+    this->data.assign(data, data_len);
+    this->pos = 0;
 
     try {
         std::string version = readString();
@@ -43,8 +41,9 @@ auto ObjectInputStream::read(const char* data, size_t data_len) -> bool {
                       version.c_str(), XML_VERSION_STR);
             return false;
         }
-    } catch (const InputStreamException& e) {
-        g_warning("InputStreamException: %s", e.what());
+    } catch (const InputStreamException&) {
+        g_warning("ObjectInputStream version mismatch... two different Xournal versions running? (expected %s)",
+                  XML_VERSION_STR);
         return false;
     }
     return true;
@@ -64,84 +63,51 @@ auto ObjectInputStream::readObject() -> std::string {
 }
 
 auto ObjectInputStream::getNextObjectName() -> std::string {
-    auto position = istream.tellg();
+    size_t position = this->pos;
 
     checkType('{');
     std::string name = readString();
 
-    istream.seekg(position);
+    this->pos = position;
     return name;
 }
 
 void ObjectInputStream::endObject() { checkType('}'); }
 
-auto ObjectInputStream::readInt() -> int {
-    checkType('i');
-    return readType<int>();
-}
+auto ObjectInputStream::readInt() -> int { return readType<int>(); }
 
-auto ObjectInputStream::readUInt() -> uint32_t {
-    checkType('u');
-    return readType<uint32_t>();
-}
+auto ObjectInputStream::readUInt() -> uint32_t { return readType<uint32_t>(); }
 
-auto ObjectInputStream::readDouble() -> double {
-    checkType('d');
-    return readType<double>();
-}
+auto ObjectInputStream::readDouble() -> double { return readType<double>(); }
 
-auto ObjectInputStream::readSizeT() -> size_t {
-    checkType('l');
-    return readType<size_t>();
-}
+auto ObjectInputStream::readSizeT() -> size_t { return readType<size_t>(); }
 
 auto ObjectInputStream::readString() -> std::string {
-    checkType('s');
-
     size_t lenString = readType<size_t>();
+    checkAvailable(lenString, "a string");
 
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an string", __FILE__, __LINE__);
-    }
-
-    std::string output;
-    output.resize(lenString);
-
-    istream.read(&output[0], as_signed(lenString));
-
+    std::string output(this->data, this->pos, lenString);
+    this->pos += lenString;
     return output;
 }
 
 auto ObjectInputStream::readImage() -> std::string {
-    checkType('m');
+    size_t lenImage = readType<size_t>();
+    checkAvailable(lenImage, "an image");
 
-    if (istream.str().size() < sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read an image's data's length", __FILE__, __LINE__);
-    }
-
-    const size_t len = readType<size_t>();
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an image", __FILE__, __LINE__);
-    }
-    std::string data;
-    data.resize(len);
-    istream.read(data.data(), as_signed(len));
-
-    return data;
+    std::string output(this->data, this->pos, lenImage);
+    this->pos += lenImage;
+    return output;
 }
 
 void ObjectInputStream::checkType(char type) {
-    if (istream.str().size() < 2) {
-        throw InputStreamException(
-                FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % getType(type) % pos() % len),
-                __FILE__, __LINE__);
-    }
-    char t = 0, underscore = 0;
-    istream >> underscore >> t;
+    checkAvailable(2, getType(type).c_str());
+    char underscore = this->data[this->pos];
+    char t = this->data[this->pos + 1];
 
     if (underscore != '_') {
         throw InputStreamException(FS(FORMAT_STR("Expected type signature of {1}, index {2} of {3}, but read '{4}'") %
-                                      getType(type) % (pos() + 1) % len % underscore),
+                                      getType(type) % (this->pos + 1) % this->data.size() % underscore),
                                    __FILE__, __LINE__);
     }
 
@@ -149,6 +115,7 @@ void ObjectInputStream::checkType(char type) {
         throw InputStreamException(FS(FORMAT_STR("Expected {1} but read {2}") % getType(type) % getType(t)), __FILE__,
                                    __LINE__);
     }
+    this->pos += 2;
 }
 
 auto ObjectInputStream::getType(char type) -> std::string {
@@ -157,20 +124,6 @@ auto ObjectInputStream::getType(char type) -> std::string {
         ret = "Object begin";
     } else if (type == '}') {
         ret = "Object end";
-    } else if (type == 'i') {
-        ret = "Number";
-    } else if (type == 'u') {
-        ret = "Unsigned Number";
-    } else if (type == 'd') {
-        ret = "Floating point";
-    } else if (type == 'l') {
-        ret = "Size";
-    } else if (type == 's') {
-        ret = "String";
-    } else if (type == 'b') {
-        ret = "Binary";
-    } else if (type == 'm') {
-        ret = "Image";
     } else {
         char* str = g_strdup_printf("Unknown type: %02hhx (%c)", type, type);
         ret = str;
@@ -1,6 +1,6 @@
 #include "util/serializing/ObjectOutputStream.h"
 
-#include <cairo.h>  // for CAIRO_STATUS_SUCCESS
+#include <cstring>  // for strlen
 
 #include "util/Assert.h"                      // for xoj_assert
 #include "util/serializing/ObjectEncoding.h"  // for ObjectEncoding
@@ -18,59 +18,46 @@ ObjectOutputStream::~ObjectOutputStream() {
     this->encoder = nullptr;
 }
 
+template <typename T>
+void ObjectOutputStream::writeValue(const T& v) {
+    this->encoder->addData(&v, sizeof(T));
+}
+
 void ObjectOutputStream::writeObject(const char* name) {
-    this->encoder->addStr("_{");
+    this->encoder->addData("_{", 2);
 
     writeString(name);
 }
 
-void ObjectOutputStream::endObject() { this->encoder->addStr("_}"); }
+void ObjectOutputStream::endObject() { this->encoder->addData("_}", 2); }
 
-void ObjectOutputStream::writeInt(int i) {
-    this->encoder->addStr("_i");
-    this->encoder->addData(&i, sizeof(int));
-}
+void ObjectOutputStream::writeInt(int i) { writeValue(i); }
 
-void ObjectOutputStream::writeUInt(uint32_t u) {
-    this->encoder->addStr("_u");
-    this->encoder->addData(&u, sizeof(uint32_t));
-}
+void ObjectOutputStream::writeUInt(uint32_t u) { writeValue(u); }
 
-void ObjectOutputStream::writeDouble(double d) {
-    this->encoder->addStr("_d");
-    this->encoder->addData(&d, sizeof(double));
-}
+void ObjectOutputStream::writeDouble(double d) { writeValue(d); }
+
+void ObjectOutputStream::writeSizeT(size_t st) { writeValue(st); }
 
-void ObjectOutputStream::writeSizeT(size_t st) {
-    this->encoder->addStr("_l");
-    this->encoder->addData(&st, sizeof(size_t));
+void ObjectOutputStream::writeBytes(const void* data, size_t len) {
+    writeValue(len);
+    this->encoder->addData(data, len);
 }
 
-void ObjectOutputStream::writeString(const char* str) { writeString(std::string(str)); }
+void ObjectOutputStream::writeString(const char* str) { writeBytes(str, std::strlen(str)); }
 
-void ObjectOutputStream::writeString(const std::string& s) {
-    this->encoder->addStr("_s");
-    size_t len = s.length();
-    this->encoder->addData(&len, sizeof(size_t));
-    this->encoder->addData(s.c_str(), len);
-}
+void ObjectOutputStream::writeString(const std::string& s) { writeBytes(s.data(), s.length()); }
 
 void ObjectOutputStream::writeData(const void* data, size_t len, size_t width) {
-    this->encoder->addStr("_b");
-    this->encoder->addData(&len, sizeof(size_t));
+    writeValue(len);
 
     // size of one element
-    this->encoder->addData(&width, sizeof(size_t));
-    if (data != nullptr) {
+    writeValue(width);
+    if (data != nullptr && len != 0) {
         this->encoder->addData(data, len * width);
     }
 }
 
-void ObjectOutputStream::writeImage(const std::string_view& imgData) {
-    this->encoder->addStr("_m");
-    size_t len = imgData.length();
-    this->encoder->addData(&len, sizeof(size_t));
-    this->encoder->addData(imgData.data(), len);
-}
+void ObjectOutputStream::writeImage(const std::string_view& imgData) { writeBytes(imgData.data(), imgData.length()); }
 
 auto ObjectOutputStream::getStr() -> GString* { return this->encoder->getData(); }
@@ -0,0 +1,50 @@
+/*
+ * Xournal++
+ *
+ * Synthetic documents for the benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+
+#include "model/Document.h"  // for Document
+#include "model/PageRef.h"   // for PageRef
+
+#include "DocumentGenerator.h"  // for DocumentGenerator
+
+namespace bench {
+
+constexpr double PAGE_WIDTH = DocumentGenerator::PAGE_WIDTH;
+constexpr double PAGE_HEIGHT = DocumentGenerator::PAGE_HEIGHT;
+
+/**
+ * @return A page covered with strokeCount handwriting-like strokes of pointCount points
+ */
+inline auto makeDensePage(size_t strokeCount, size_t pointCount, unsigned int seed = 1) -> PageRef {
+    DocumentGenerator::Options options;
+    options.strokesPerPage = strokeCount;
+    options.pointsPerStroke = pointCount;
+    options.seed = seed;
+    return DocumentGenerator(options).generatePage();
+}
+
+/**
+ * @return A document of pageCount pages like the ones of makeDensePage()
+ */
+inline auto makeDocument(DocumentHandler* handler, size_t pageCount, size_t strokeCount, size_t pointCount)
+        -> std::unique_ptr<Document> {
+    DocumentGenerator::Options options;
+    options.pages = pageCount;
+    options.strokesPerPage = strokeCount;
+    options.pointsPerStroke = pointCount;
+    return DocumentGenerator(options).generate(handler);
+}
+
+}  // namespace bench
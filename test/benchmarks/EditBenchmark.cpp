@@ -0,0 +1,143 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "control/shaperecognizer/ShapeRecognizer.h"
+#include "model/Element.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "model/eraser/ErasableStroke.h"
+#include "model/eraser/PaddedBox.h"
+#include "util/Range.h"
+#include "util/SmallVector.h"
+#include "util/UnionOfIntervals.h"
+
+#include "BenchmarkUtil.h"
+
+namespace {
+/// The padding of the eraser box for the round caps, as in EraseHandler
+constexpr double ROUND_CAP_PADDING = 0.4;
+}  // namespace
+
+/**
+ * Sweep the default eraser across a page of state.range(0) strokes, as EraseHandler does for each motion event
+ */
+static void BM_EraserSweep(benchmark::State& state) {
+    const double halfEraserSize = 5;
+    for (auto _: state) {
+        state.PauseTiming();
+        PageRef page = bench::makeDensePage(static_cast<size_t>(state.range(0)), 100);
+        Layer* layer = page->getSelectedLayer();
+        std::vector<std::unique_ptr<ErasableStroke>> erasables;
+        std::unordered_map<Stroke*, ErasableStroke*> erased;
+        state.ResumeTiming();
+
+        // A zigzag over the whole page
+        for (double y = 20; y < bench::PAGE_HEIGHT; y += 40) {
+            for (double x = 0; x < bench::PAGE_WIDTH; x += 2) {
+                const double ey = y + 20 * std::sin(x / 15);
+                Range range(x, ey);
+                Range area(x - halfEraserSize - 1, ey - halfEraserSize - 1, x + halfEraserSize + 1,
+                           ey + halfEraserSize + 1);
+                for (Element* e: layer->getElementsInArea(area)) {
+                    auto* s = dynamic_cast<Stroke*>(e);
+                    if (!s) {
+                        continue;
+                    }
+                    const PaddedBox box{{x, ey}, halfEraserSize, halfEraserSize + ROUND_CAP_PADDING * s->getWidth()};
+                    if (auto it = erased.find(s); it != erased.end()) {
+                        it->second->erase(box, range);
+                    } else if (auto intersections = s->intersectWithPaddedBox(box); !intersections.empty()) {
+                        auto& erasable = erasables.emplace_back(std::make_unique<ErasableStroke>(*s));
+                        erasable->beginErasure(intersections, range);
+                        erased.emplace(s, erasable.get());
+                    }
+                }
+                benchmark::DoNotOptimize(range);
+            }
+        }
+
+        for (auto& erasable: erasables) { benchmark::DoNotOptimize(erasable->getStrokes()); }
+    }
+}
+BENCHMARK(BM_EraserSweep)->ArgName("strokes")->Arg(500)->Arg(2000)->Unit(benchmark::kMillisecond);
+
+/**
+ * Scale and rotate a selection of state.range(0) strokes, as each motion event of a selection transform does
+ */
+static void BM_SelectionTransform(benchmark::State& state) {
+    PageRef page = bench::makeDensePage(static_cast<size_t>(state.range(0)), 100);
+    const auto& elements = page->getSelectedLayer()->getElements();
+    const double cx = bench::PAGE_WIDTH / 2;
+    const double cy = bench::PAGE_HEIGHT / 2;
+    bool grow = true;
+    for (auto _: state) {
+        const double f = grow ? 1.01 : 1 / 1.01;
+        for (const auto& e: elements) {
+            e->scale(cx, cy, f, f, 0, true);
+            e->rotate(cx, cy, grow ? 0.01 : -0.01);
+        }
+        grow = !grow;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SelectionTransform)->ArgName("strokes")->Arg(100)->Arg(2000);
+
+namespace {
+auto makeShape(int corners, size_t pointCount) -> Stroke {
+    std::mt19937 rng(corners);
+    std::uniform_real_distribution<double> jitter(-0.5, 0.5);
+    Stroke stroke;
+    stroke.setWidth(1.41);
+    for (size_t i = 0; i <= pointCount; i++) {
+        const double t = static_cast<double>(i) / static_cast<double>(pointCount);
+        double x = 0;
+        double y = 0;
+        if (corners == 0) {
+            // A circle
+            x = 100 + 50 * std::cos(2 * M_PI * t);
+            y = 100 + 50 * std::sin(2 * M_PI * t);
+        } else {
+            // A polygon, going through its corners on a circle
+            const double side = t * corners;
+            const double k = std::floor(side);
+            const double a0 = 2 * M_PI * k / corners;
+            const double a1 = 2 * M_PI * (k + 1) / corners;
+            const double u = side - k;
+            x = 100 + 50 * ((1 - u) * std::cos(a0) + u * std::cos(a1));
+            y = 100 + 50 * ((1 - u) * std::sin(a0) + u * std::sin(a1));
+        }
+        stroke.addPoint(Point(x + jitter(rng), y + jitter(rng)));
+    }
+    return stroke;
+}
+}  // namespace
+
+/**
+ * Recognize a shape drawn with state.range(1) points: a circle (no corners), a triangle or a rectangle
+ */
+static void BM_ShapeRecognizer(benchmark::State& state) {
+    Stroke stroke = makeShape(static_cast<int>(state.range(0)), static_cast<size_t>(state.range(1)));
+    for (auto _: state) {
+        ShapeRecognizer reco;
+        benchmark::DoNotOptimize(reco.recognizePatterns(&stroke, 10));
+    }
+}
+BENCHMARK(BM_ShapeRecognizer)->ArgNames({"corners", "points"})->ArgsProduct({{0, 3, 4}, {100, 1000}});
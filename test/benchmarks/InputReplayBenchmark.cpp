@@ -0,0 +1,166 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <cairo.h>
+#include <glib.h>
+
+#include "gui/inputdevices/InputRecording.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "util/raii/CairoWrappers.h"
+
+#include "BenchmarkUtil.h"
+
+using xoj::input::RecordedEvent;
+
+namespace {
+constexpr double STROKE_WIDTH = 1.41;
+/// As in InputHandler
+constexpr double PIXEL_MOTION_THRESHOLD = 0.3;
+
+/**
+ * A handwriting-like recording at 200 Hz: strokes of 150 motion events each, with a pressure curve, from a pen
+ */
+auto makeRecording(size_t strokeCount) -> std::vector<RecordedEvent> {
+    std::vector<RecordedEvent> events;
+    uint32_t time = 1000;
+    for (size_t s = 0; s < strokeCount; s++) {
+        const double x0 = 40 + static_cast<double>(s % 10) * 50;
+        const double y0 = 40 + static_cast<double>(s / 10 % 15) * 50;
+        auto event = [&](InputEventType type, double t) {
+            RecordedEvent e;
+            e.type = type;
+            e.deviceClass = INPUT_DEVICE_PEN;
+            e.relativeX = x0 + 40 * t + 5 * std::sin(20 * t);
+            e.relativeY = y0 + 10 * std::sin(7 * t);
+            e.absoluteX = e.relativeX + 100;
+            e.absoluteY = e.relativeY + 100;
+            e.button = type == MOTION_EVENT ? 0 : 1;
+            e.pressure = 0.3 + 0.5 * std::sin(3.14 * t);
+            e.timestamp = time;
+            time += 5;
+            return e;
+        };
+        events.push_back(event(BUTTON_PRESS_EVENT, 0));
+        for (int i = 1; i <= 150; i++) { events.push_back(event(MOTION_EVENT, i / 150.0)); }
+        events.push_back(event(BUTTON_RELEASE_EVENT, 1));
+    }
+    return events;
+}
+
+/// The recording of XOURNALPP_BENCH_INPUT if set, a synthetic one otherwise
+auto getRecording() -> std::vector<RecordedEvent> {
+    if (const char* file = g_getenv("XOURNALPP_BENCH_INPUT"); file && *file) {
+        if (auto events = xoj::input::load(fs::u8path(file))) {
+            return *events;
+        }
+    }
+    return makeRecording(100);
+}
+
+/**
+ * Replays the events of the pen as the StrokeHandler and the StrokeToolView do while drawing: each event far enough
+ * from the end of the stroke adds a point, and the new segment is painted on the mask of the stroke.
+ */
+class HeadlessReplay {
+public:
+    explicit HeadlessReplay(cairo_t* mask): mask(mask) {}
+
+    void process(const RecordedEvent& e) {
+        if (e.deviceClass != INPUT_DEVICE_PEN) {
+            return;
+        }
+        Point p(e.relativeX, e.relativeY, e.pressure > 0 ? e.pressure * STROKE_WIDTH : Point::NO_PRESSURE);
+        if (e.type == BUTTON_PRESS_EVENT) {
+            stroke = std::make_unique<Stroke>();
+            stroke->setWidth(STROKE_WIDTH);
+            stroke->addPoint(p);
+        } else if (e.type == MOTION_EVENT && stroke) {
+            const Point last = stroke->getPoint(stroke->getPointCount() - 1);
+            if (p.lineLengthTo(last) < PIXEL_MOTION_THRESHOLD) {
+                return;
+            }
+            cairo_set_line_width(mask, p.z > 0 ? p.z : STROKE_WIDTH);
+            cairo_move_to(mask, last.x, last.y);
+            cairo_line_to(mask, p.x, p.y);
+            cairo_stroke(mask);
+            stroke->addPoint(p);
+        } else if (e.type == BUTTON_RELEASE_EVENT && stroke) {
+            benchmark::DoNotOptimize(stroke->getPointCount());
+            stroke.reset();
+        }
+    }
+
+private:
+    cairo_t* mask;
+    std::unique_ptr<Stroke> stroke;
+};
+}  // namespace
+
+/**
+ * Replay a recording headlessly, reporting the distribution of the processing time of the events
+ */
+static void BM_ReplayInput(benchmark::State& state) {
+    const auto events = getRecording();
+    xoj::util::CairoSurfaceSPtr surface(
+            cairo_image_surface_create(CAIRO_FORMAT_A8, static_cast<int>(std::ceil(bench::PAGE_WIDTH)),
+                                       static_cast<int>(std::ceil(bench::PAGE_HEIGHT))),
+            xoj::util::adopt);
+
+    std::vector<int64_t> times;
+    times.reserve(events.size());
+    for (auto _: state) {
+        times.clear();
+        xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+        cairo_set_line_cap(cr.get(), CAIRO_LINE_CAP_ROUND);
+        HeadlessReplay replay(cr.get());
+        for (const RecordedEvent& e: events) {
+            const auto start = std::chrono::steady_clock::now();
+            replay.process(e);
+            const auto end = std::chrono::steady_clock::now();
+            times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+        cairo_surface_flush(surface.get());
+    }
+
+    // In ns, as are the times of Google Benchmark
+    const auto d = xoj::input::summarize(times);
+    state.counters["p50_ns"] = static_cast<double>(d.p50);
+    state.counters["p99_ns"] = static_cast<double>(d.p99);
+    state.counters["max_ns"] = static_cast<double>(d.max);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(events.size()));
+}
+BENCHMARK(BM_ReplayInput)->Unit(benchmark::kMillisecond);
+
+/**
+ * Read back a recording of state.range(0) strokes
+ */
+static void BM_LoadInputRecording(benchmark::State& state) {
+    std::stringstream ss;
+    xoj::input::save(ss, makeRecording(static_cast<size_t>(state.range(0))));
+    const std::string recording = ss.str();
+    for (auto _: state) {
+        std::istringstream in(recording);
+        auto events = xoj::input::load(in);
+        benchmark::DoNotOptimize(events);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(recording.size()));
+}
+BENCHMARK(BM_LoadInputRecording)->ArgName("strokes")->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,115 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+
+#include <benchmark/benchmark.h>
+#include <config-test.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+
+#include "BenchmarkUtil.h"
+#include "filesystem.h"
+
+namespace {
+/// Count the elements, so that the lazily loaded pages are parsed
+auto countElements(Document* doc) -> size_t {
+    size_t count = 0;
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        for (const Layer* l: *doc->getPage(i)->getLayers()) { count += l->getElements().size(); }
+    }
+    return count;
+}
+
+/// Save state.range(0) pages of 500 strokes, in the binary format if state.range(1) is set
+void saveSynthetic(benchmark::State& state, const fs::path& file) {
+    DocumentHandler handler;
+    auto doc = bench::makeDocument(&handler, static_cast<size_t>(state.range(0)), 500, 100);
+    SaveHandler h;
+    h.setBinaryPointEncoding(state.range(1) != 0);
+    h.saveDocument(doc.get(), file);
+    if (!h.getErrorMessage().empty()) {
+        state.SkipWithError(h.getErrorMessage().c_str());
+    }
+}
+}  // namespace
+
+static void BM_LoadBigTest(benchmark::State& state) {
+    for (auto _: state) {
+        LoadHandler loader;
+        auto doc = loader.loadDocument(GET_TESTFILE("big-test.xoj"));
+        if (!doc) {
+            state.SkipWithError(loader.getLastError().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(countElements(doc.get()));
+    }
+}
+BENCHMARK(BM_LoadBigTest)->Unit(benchmark::kMillisecond);
+
+static void BM_SaveBigTest(benchmark::State& state) {
+    LoadHandler loader;
+    auto doc = loader.loadDocument(GET_TESTFILE("big-test.xoj"));
+    if (!doc) {
+        state.SkipWithError(loader.getLastError().c_str());
+        return;
+    }
+    countElements(doc.get());
+    auto file = Util::getTmpDirSubfolder() / "bench-save.xopp";
+    for (auto _: state) {
+        SaveHandler h;
+        h.setBinaryPointEncoding(state.range(0) != 0);
+        h.saveDocument(doc.get(), file);
+    }
+}
+BENCHMARK(BM_SaveBigTest)->ArgName("binary")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_SaveSynthetic(benchmark::State& state) {
+    DocumentHandler handler;
+    auto doc = bench::makeDocument(&handler, static_cast<size_t>(state.range(0)), 500, 100);
+    auto file = Util::getTmpDirSubfolder() / "bench-save-synthetic.xopp";
+    for (auto _: state) {
+        SaveHandler h;
+        h.setBinaryPointEncoding(state.range(1) != 0);
+        h.saveDocument(doc.get(), file);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SaveSynthetic)
+        ->ArgNames({"pages", "binary"})
+        ->ArgsProduct({{1, 20}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
+
+static void BM_LoadSynthetic(benchmark::State& state) {
+    auto file = Util::getTmpDirSubfolder() / "bench-load-synthetic.xopp";
+    saveSynthetic(state, file);
+    for (auto _: state) {
+        LoadHandler loader;
+        auto doc = loader.loadDocument(file);
+        if (!doc) {
+            state.SkipWithError(loader.getLastError().c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(countElements(doc.get()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadSynthetic)
+        ->ArgNames({"pages", "binary"})
+        ->ArgsProduct({{1, 20}, {0, 1}})
+        ->Unit(benchmark::kMillisecond);
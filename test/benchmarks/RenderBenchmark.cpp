@@ -0,0 +1,111 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal Benchmarks
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <cairo.h>
+#include <config-test.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "model/Document.h"
+#include "model/Element.h"
+#include "model/Layer.h"
+#include "model/LineStyle.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/raii/CairoWrappers.h"
+#include "view/DocumentView.h"
+
+#include "BenchmarkUtil.h"
+
+namespace {
+/// Draw the page at the zoom state.range(0) / 100, as the page buffers of the main view do
+void renderPage(benchmark::State& state, const PageRef& page) {
+    const double zoom = static_cast<double>(state.range(0)) / 100.0;
+    xoj::util::CairoSurfaceSPtr surface(
+            cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(page->getWidth() * zoom)),
+                                       static_cast<int>(std::ceil(page->getHeight() * zoom))),
+            xoj::util::adopt);
+    for (auto _: state) {
+        xoj::util::CairoSPtr cr(cairo_create(surface.get()), xoj::util::adopt);
+        cairo_scale(cr.get(), zoom, zoom);
+        DocumentView view;
+        view.drawPage(page, cr.get(), true);
+        cairo_surface_flush(surface.get());
+    }
+}
+}  // namespace
+
+static void BM_RenderDensePage(benchmark::State& state) {
+    renderPage(state, bench::makeDensePage(2000, 100));
+}
+BENCHMARK(BM_RenderDensePage)
+        ->ArgName("zoom%")
+        ->Arg(50)
+        ->Arg(100)
+        ->Arg(200)
+        ->Arg(400)
+        ->Unit(benchmark::kMillisecond);
+
+/// The kinds of strokes: state.range(1) is 1 for pressure, state.range(2) for dashes, state.range(3) for a saturated
+/// pressure (the widths of many consecutive points are the same)
+static void BM_RenderStrokeKinds(benchmark::State& state) {
+    DocumentGenerator::Options options;
+    options.strokesPerPage = 1000;
+    options.pointsPerStroke = 100;
+    options.pressure = state.range(1) != 0;
+    PageRef page = DocumentGenerator(options).generatePage();
+
+    for (Layer* layer: *page->getLayers()) {
+        for (const auto& e: layer->getElements()) {
+            if (e->getType() != ELEMENT_STROKE) {
+                continue;
+            }
+            auto* stroke = static_cast<Stroke*>(e.get());
+            if (state.range(2) != 0) {
+                LineStyle style;
+                style.setDashes({6, 3});
+                stroke->setLineStyle(style);
+            }
+            if (state.range(3) != 0) {
+                std::vector<Point> pts = stroke->getPointVector();
+                for (Point& p: pts) {
+                    p.z = std::min(p.z, 1.0);
+                }
+                stroke->setPointVector(std::move(pts));
+            }
+        }
+    }
+    state.counters["strokes"] = static_cast<double>(options.strokesPerPage);
+    renderPage(state, page);
+}
+BENCHMARK(BM_RenderStrokeKinds)
+        ->ArgNames({"zoom%", "pressure", "dashed", "saturated"})
+        ->Args({100, 0, 0, 0})
+        ->Args({100, 0, 1, 0})
+        ->Args({100, 1, 0, 0})
+        ->Args({100, 1, 1, 0})
+        ->Args({100, 1, 1, 1})
+        ->Unit(benchmark::kMillisecond);
+
+static void BM_RenderBigTest(benchmark::State& state) {
+    LoadHandler loader;
+    auto doc = loader.loadDocument(GET_TESTFILE("big-test.xoj"));
+    if (!doc || doc->getPageCount() == 0) {
+        state.SkipWithError("Could not load big-test.xoj");
+        return;
+    }
+    renderPage(state, doc->getPage(0));
+}
+BENCHMARK(BM_RenderBigTest)->ArgName("zoom%")->Arg(50)->Arg(100)->Arg(200)->Unit(benchmark::kMillisecond);
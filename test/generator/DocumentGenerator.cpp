@@ -0,0 +1,153 @@
+#include "DocumentGenerator.h"
+
+#include <algorithm>  // for max
+#include <cmath>      // for cos, sin
+#include <cstdint>    // for uint32_t
+#include <iterator>   // for size
+#include <string>     // for string
+#include <utility>    // for move
+
+#include <cairo.h>  // for cairo_image_surface_create, cairo_surface_write_to_png_stream
+
+#include "model/Document.h"         // for Document
+#include "model/DocumentHandler.h"  // for DocumentHandler
+#include "model/Font.h"             // for XojFont
+#include "model/Image.h"            // for Image
+#include "model/Layer.h"            // for Layer
+#include "model/Point.h"            // for Point
+#include "model/Stroke.h"           // for Stroke, StrokeTool
+#include "model/Text.h"             // for Text
+#include "model/XojPage.h"          // for XojPage
+#include "pdf/base/XojPdfPage.h"    // for XojPdfPageSPtr
+#include "util/Color.h"             // for Color
+
+namespace {
+constexpr double STROKE_WIDTH = 1.41;
+constexpr int IMAGE_SIZE = 64;
+
+const char* const WORDS[] = {"lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit"};
+}  // namespace
+
+DocumentGenerator::DocumentGenerator(Options options): options(std::move(options)), rng(this->options.seed) {}
+
+auto DocumentGenerator::getLastError() const -> const std::string& { return this->lastError; }
+
+auto DocumentGenerator::generate(DocumentHandler* handler) -> std::unique_ptr<Document> {
+    auto doc = std::make_unique<Document>(handler);
+    size_t pdfPages = 0;
+    if (!this->options.pdfBackground.empty()) {
+        if (!doc->readPdf(this->options.pdfBackground, false, false)) {
+            this->lastError = doc->getLastErrorMsg();
+            return nullptr;
+        }
+        pdfPages = doc->getPdfPageCount();
+    }
+
+    for (size_t i = 0; i < this->options.pages; i++) {
+        if (pdfPages == 0) {
+            doc->addPage(generatePage());
+            continue;
+        }
+        XojPdfPageSPtr pdfPage = doc->getPdfPage(i % pdfPages);
+        auto page = std::make_shared<XojPage>(pdfPage->getWidth(), pdfPage->getHeight());
+        page->setBackgroundPdfPageNr(i % pdfPages);
+        Layer* layer = page->getSelectedLayer();
+        addStrokes(layer, page->getWidth(), page->getHeight());
+        addTexts(layer, page->getWidth(), page->getHeight());
+        addImages(layer, page->getWidth(), page->getHeight());
+        doc->addPage(page);
+    }
+    return doc;
+}
+
+auto DocumentGenerator::generatePage() -> PageRef {
+    auto page = std::make_shared<XojPage>(PAGE_WIDTH, PAGE_HEIGHT);
+    Layer* layer = page->getSelectedLayer();
+    addStrokes(layer, PAGE_WIDTH, PAGE_HEIGHT);
+    addTexts(layer, PAGE_WIDTH, PAGE_HEIGHT);
+    addImages(layer, PAGE_WIDTH, PAGE_HEIGHT);
+    return page;
+}
+
+void DocumentGenerator::addStrokes(Layer* layer, double width, double height) {
+    std::uniform_real_distribution<double> xPos(20, std::max(21.0, width - 120));
+    std::uniform_real_distribution<double> yPos(20, std::max(21.0, height - 20));
+    std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+    std::uniform_real_distribution<double> pressure(0.6, 1.2);
+
+    for (size_t s = 0; s < this->options.strokesPerPage; s++) {
+        auto stroke = std::make_unique<Stroke>();
+        stroke->setToolType(StrokeTool::PEN);
+        stroke->setWidth(STROKE_WIDTH);
+        stroke->setColor(Colors::black);
+
+        const double x = xPos(this->rng);
+        const double y = yPos(this->rng);
+        for (size_t i = 0; i < this->options.pointsPerStroke; i++) {
+            const double t = static_cast<double>(i) * 0.3;
+            const double px = x + t * 1.5 + 4 * std::cos(t) + jitter(this->rng);
+            const double py = y + 6 * std::sin(t) + jitter(this->rng);
+            stroke->addPoint(this->options.pressure ? Point(px, py, pressure(this->rng)) : Point(px, py));
+        }
+        layer->addElement(std::move(stroke));
+    }
+}
+
+void DocumentGenerator::addTexts(Layer* layer, double width, double height) {
+    std::uniform_real_distribution<double> xPos(20, std::max(21.0, width - 200));
+    std::uniform_real_distribution<double> yPos(20, std::max(21.0, height - 40));
+    std::uniform_int_distribution<size_t> word(0, std::size(WORDS) - 1);
+    std::uniform_int_distribution<int> wordCount(3, 12);
+
+    for (size_t t = 0; t < this->options.textsPerPage; t++) {
+        std::string str;
+        for (int i = wordCount(this->rng); i > 0; i--) {
+            str += WORDS[word(this->rng)];
+            str += i > 1 ? " " : ".";
+        }
+        auto text = std::make_unique<Text>();
+        text->setFont(XojFont("Sans", 12));
+        text->setColor(Colors::black);
+        text->setText(std::move(str));
+        text->setX(xPos(this->rng));
+        text->setY(yPos(this->rng));
+        layer->addElement(std::move(text));
+    }
+}
+
+void DocumentGenerator::addImages(Layer* layer, double width, double height) {
+    std::uniform_real_distribution<double> xPos(0, std::max(1.0, width - 100));
+    std::uniform_real_distribution<double> yPos(0, std::max(1.0, height - 100));
+    std::uniform_int_distribution<uint32_t> pixel;
+
+    for (size_t n = 0; n < this->options.imagesPerPage; n++) {
+        // Noise, so that the images are all different and do not compress well, like photos
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, IMAGE_SIZE, IMAGE_SIZE);
+        cairo_surface_flush(surface);
+        unsigned char* data = cairo_image_surface_get_data(surface);
+        const int stride = cairo_image_surface_get_stride(surface);
+        for (int y = 0; y < IMAGE_SIZE; y++) {
+            auto* row = reinterpret_cast<uint32_t*>(data + y * stride);
+            for (int x = 0; x < IMAGE_SIZE; x++) { row[x] = pixel(this->rng) & 0xffffffU; }
+        }
+        cairo_surface_mark_dirty(surface);
+
+        std::string png;
+        cairo_surface_write_to_png_stream(
+                surface,
+                [](void* closure, const unsigned char* data, unsigned int length) {
+                    static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(data), length);
+                    return CAIRO_STATUS_SUCCESS;
+                },
+                &png);
+        cairo_surface_destroy(surface);
+
+        auto image = std::make_unique<Image>();
+        image->setImage(std::move(png));
+        image->setX(xPos(this->rng));
+        image->setY(yPos(this->rng));
+        image->setWidth(100);
+        image->setHeight(100);
+        layer->addElement(std::move(image));
+    }
+}
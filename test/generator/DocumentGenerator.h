@@ -0,0 +1,73 @@
+/*
+ * Xournal++
+ *
+ * Generates large synthetic documents, for the benchmarks and the stress tests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <memory>   // for unique_ptr
+#include <random>   // for mt19937
+#include <string>   // for string
+
+#include "model/PageRef.h"  // for PageRef
+
+#include "filesystem.h"  // for path
+
+class Document;
+class DocumentHandler;
+class Layer;
+
+/**
+ * @brief Builds documents of any size out of the model classes, the same ones for the same options.
+ *
+ * The strokes look like handwriting: small loops drifting to the right, placed at random on the page. The texts and
+ * images are spread at random as well.
+ */
+class DocumentGenerator {
+public:
+    struct Options {
+        size_t pages = 10;
+        size_t strokesPerPage = 500;
+        size_t pointsPerStroke = 100;
+        bool pressure = true;
+        size_t textsPerPage = 0;
+        size_t imagesPerPage = 0;
+        /// The pages get the pages of this PDF as background, cycling through them, if it is not empty
+        fs::path pdfBackground;
+        unsigned int seed = 1;
+    };
+
+    static constexpr double PAGE_WIDTH = 595.275591;
+    static constexpr double PAGE_HEIGHT = 841.889764;
+
+    explicit DocumentGenerator(Options options);
+
+    /**
+     * @return The document, or nullptr if the PDF background could not be read (see getLastError())
+     */
+    std::unique_ptr<Document> generate(DocumentHandler* handler);
+
+    /**
+     * @return A page of the size of an A4 page, with the elements of the options
+     */
+    PageRef generatePage();
+
+    const std::string& getLastError() const;
+
+private:
+    void addStrokes(Layer* layer, double width, double height);
+    void addTexts(Layer* layer, double width, double height);
+    void addImages(Layer* layer, double width, double height);
+
+private:
+    Options options;
+    std::mt19937 rng;
+    std::string lastError;
+};
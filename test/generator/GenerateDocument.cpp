@@ -0,0 +1,95 @@
+/*
+ * Xournal++
+ *
+ * Writes a synthetic document, for the scaling tests:
+ *
+ *     generate-document --pages=1000 --strokes=500 --points=100 --images=2 big.xopp
+ *
+ * The same options always give the same document.
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdio>  // for fprintf, stderr
+
+#include <glib.h>
+
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+
+#include "DocumentGenerator.h"
+#include "filesystem.h"
+
+auto main(int argc, char* argv[]) -> int {
+    gint pages = 10;
+    gint strokes = 500;
+    gint points = 100;
+    gint texts = 0;
+    gint images = 0;
+    gint seed = 1;
+    gboolean noPressure = false;
+    gboolean binary = false;
+    gchar* pdf = nullptr;
+
+    const GOptionEntry options[] = {
+            {"pages", 0, 0, G_OPTION_ARG_INT, &pages, "Number of pages (default 10)", "N"},
+            {"strokes", 0, 0, G_OPTION_ARG_INT, &strokes, "Strokes per page (default 500)", "M"},
+            {"points", 0, 0, G_OPTION_ARG_INT, &points, "Points per stroke (default 100)", "K"},
+            {"texts", 0, 0, G_OPTION_ARG_INT, &texts, "Texts per page (default 0)", "N"},
+            {"images", 0, 0, G_OPTION_ARG_INT, &images, "Images per page (default 0)", "N"},
+            {"no-pressure", 0, 0, G_OPTION_ARG_NONE, &noPressure, "Strokes without pressure", nullptr},
+            {"pdf", 0, 0, G_OPTION_ARG_FILENAME, &pdf, "PDF whose pages are the backgrounds", "PDFFILE"},
+            {"seed", 0, 0, G_OPTION_ARG_INT, &seed, "Seed of the random numbers (default 1)", "SEED"},
+            {"binary", 0, 0, G_OPTION_ARG_NONE, &binary, "Encode the points in binary", nullptr},
+            {nullptr}};
+
+    GOptionContext* context = g_option_context_new("OUTPUT");
+    g_option_context_set_summary(context, "Write a synthetic Xournal++ document, the same one for the same options");
+    g_option_context_add_main_entries(context, options, nullptr);
+    GError* error = nullptr;
+    bool parsed = g_option_context_parse(context, &argc, &argv, &error);
+    g_option_context_free(context);
+    if (!parsed) {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+        return 1;
+    }
+    if (argc != 2 || pages < 0 || strokes < 0 || points < 0 || texts < 0 || images < 0) {
+        fprintf(stderr, "Usage: %s [OPTION...] OUTPUT\n", argv[0]);
+        return 1;
+    }
+
+    DocumentGenerator::Options genOptions;
+    genOptions.pages = static_cast<size_t>(pages);
+    genOptions.strokesPerPage = static_cast<size_t>(strokes);
+    genOptions.pointsPerStroke = static_cast<size_t>(points);
+    genOptions.textsPerPage = static_cast<size_t>(texts);
+    genOptions.imagesPerPage = static_cast<size_t>(images);
+    genOptions.pressure = !noPressure;
+    genOptions.seed = static_cast<unsigned int>(seed);
+    if (pdf) {
+        genOptions.pdfBackground = fs::u8path(pdf);
+        g_free(pdf);
+    }
+
+    DocumentHandler handler;
+    DocumentGenerator generator(genOptions);
+    auto doc = generator.generate(&handler);
+    if (!doc) {
+        fprintf(stderr, "Could not read the PDF: %s\n", generator.getLastError().c_str());
+        return 1;
+    }
+
+    SaveHandler saver;
+    saver.setBinaryPointEncoding(binary);
+    saver.saveDocument(doc.get(), fs::u8path(argv[1]));
+    if (!saver.getErrorMessage().empty()) {
+        fprintf(stderr, "%s\n", saver.getErrorMessage().c_str());
+        return 1;
+    }
+    return 0;
+}
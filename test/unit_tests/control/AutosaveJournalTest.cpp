@@ -0,0 +1,116 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/AutosaveJournal.h"
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+void addStroke(const PageRef& page) {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->setWidth(1.0);
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(20, 20));
+    (*page->getLayers())[0]->addElement(std::move(stroke));
+}
+
+size_t countElements(const PageRef& page) { return (*page->getLayers())[0]->getElements().size(); }
+}  // namespace
+
+TEST(ControlAutosaveJournal, testJournal) {
+    LoadHandler handler;
+    auto doc = handler.loadDocument(GET_TESTFILE("big-test.xoj"));
+    ASSERT_TRUE(doc);
+    ASSERT_GT(doc->getPageCount(), 3U);
+
+    const fs::path autosaveFile = Util::getTmpDirSubfolder() / "journal-test.autosave.xopp";
+    const fs::path journalFile = AutosaveJournal::getJournalPath(autosaveFile);
+    fs::remove(journalFile);
+
+    AutosaveJournal journal;
+    std::vector<size_t> modified;
+    {
+        SaveHandler h;
+        ASSERT_EQ(journal.prepareSave(doc.get(), autosaveFile, modified), AutosaveJournal::Target::DOCUMENT);
+        h.saveDocument(doc.get(), autosaveFile);
+        ASSERT_TRUE(h.getErrorMessage().empty());
+        journal.saved(autosaveFile);
+    }
+    EXPECT_EQ(journal.prepareSave(doc.get(), autosaveFile, modified), AutosaveJournal::Target::UP_TO_DATE);
+    journal.saved(autosaveFile);
+
+    // Only the modified page is written
+    PageRef page = doc->getPage(2);
+    const size_t elementCount = countElements(page);
+    addStroke(page);
+    {
+        ASSERT_EQ(journal.prepareSave(doc.get(), autosaveFile, modified), AutosaveJournal::Target::JOURNAL);
+        EXPECT_EQ(modified, std::vector<size_t>{2});
+        SaveHandler h;
+        h.prepareJournal(doc.get(), modified);
+        h.saveTo(journalFile);
+        ASSERT_TRUE(h.getErrorMessage().empty());
+        journal.saved(autosaveFile);
+    }
+
+    LoadHandler handler2;
+    auto restored = handler2.loadDocument(autosaveFile);
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(countElements(restored->getPage(2)), elementCount);
+
+    std::string error;
+    EXPECT_TRUE(AutosaveJournal::apply(restored.get(), autosaveFile, error));
+    EXPECT_TRUE(error.empty());
+    ASSERT_EQ(restored->getPageCount(), doc->getPageCount());
+    EXPECT_EQ(countElements(restored->getPage(2)), elementCount + 1);
+    EXPECT_EQ(countElements(restored->getPage(1)), countElements(doc->getPage(1)));
+
+    // A new page requires a full autosave
+    doc->insertPage(std::make_shared<XojPage>(100, 100), 0);
+    EXPECT_EQ(journal.prepareSave(doc.get(), autosaveFile, modified), AutosaveJournal::Target::DOCUMENT);
+    fs::remove(journalFile);
+}
+
+TEST(ControlAutosaveJournal, testMismatchingJournal) {
+    LoadHandler handler;
+    auto doc = handler.loadDocument(GET_TESTFILE("big-test.xoj"));
+    ASSERT_TRUE(doc);
+
+    const fs::path autosaveFile = Util::getTmpDirSubfolder() / "journal-mismatch.autosave.xopp";
+    const fs::path journalFile = AutosaveJournal::getJournalPath(autosaveFile);
+    {
+        SaveHandler h;
+        h.prepareJournal(doc.get(), {0});
+        h.saveTo(journalFile);
+        ASSERT_TRUE(h.getErrorMessage().empty());
+    }
+
+    // The autosaved document has another page count
+    doc->deletePage(0);
+    std::string error;
+    EXPECT_FALSE(AutosaveJournal::apply(doc.get(), autosaveFile, error));
+    EXPECT_FALSE(error.empty());
+    fs::remove(journalFile);
+}
@@ -0,0 +1,65 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/xojfile/BinaryPointData.h"
+#include "model/Point.h"
+
+TEST(ControlBinaryPointData, testRoundTrip) {
+    const std::vector<Point> stroke1 = {{1.5, 2.25, 0.5}, {-3.0, 400.125, 0.75}, {10.0, 20.0}};
+    const std::vector<Point> stroke2 = {{0.0, 0.0}, {595.0, 842.0}};
+
+    std::string data;
+    BinaryPointData::append(data, stroke1, true);
+    const size_t offset2 = data.size();
+    BinaryPointData::append(data, stroke2, false);
+    // 4 bytes per value, no pressure for the last point
+    EXPECT_EQ(offset2, 4U * (3 * 2 + 2));
+    EXPECT_EQ(data.size(), offset2 + 4U * 2 * 2);
+
+    std::vector<Point> points;
+    std::vector<double> pressures;
+    ASSERT_TRUE(BinaryPointData::read(data, 0, 3, true, points, pressures));
+    ASSERT_EQ(points.size(), 3U);
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_EQ(points[i].x, stroke1[i].x);
+        EXPECT_EQ(points[i].y, stroke1[i].y);
+    }
+    EXPECT_EQ(pressures, (std::vector<double>{0.5, 0.75}));
+
+    points.clear();
+    pressures.clear();
+    ASSERT_TRUE(BinaryPointData::read(data, offset2, 2, false, points, pressures));
+    ASSERT_EQ(points.size(), 2U);
+    EXPECT_EQ(points[1].x, 595.0);
+    EXPECT_EQ(points[1].y, 842.0);
+    EXPECT_EQ(points[1].z, Point::NO_PRESSURE);
+    EXPECT_TRUE(pressures.empty());
+}
+
+TEST(ControlBinaryPointData, testOutOfRange) {
+    std::string data;
+    BinaryPointData::append(data, {{1.0, 2.0}, {3.0, 4.0}}, false);
+
+    std::vector<Point> points;
+    std::vector<double> pressures;
+    EXPECT_FALSE(BinaryPointData::read(data, 0, 3, false, points, pressures));
+    EXPECT_FALSE(BinaryPointData::read(data, 0, 2, true, points, pressures));
+    EXPECT_FALSE(BinaryPointData::read(data, 4, 2, false, points, pressures));
+    EXPECT_FALSE(BinaryPointData::read(data, data.size() + 1, 0, false, points, pressures));
+    EXPECT_FALSE(BinaryPointData::read(data, 0, static_cast<size_t>(-1), true, points, pressures));
+    EXPECT_TRUE(points.empty());
+    EXPECT_TRUE(pressures.empty());
+}
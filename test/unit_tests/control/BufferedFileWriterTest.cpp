@@ -0,0 +1,57 @@
+#include <cstdio>    // for SEEK_SET, SEEK_END
+#include <fstream>   // for ifstream
+#include <iterator>  // for istreambuf_iterator
+#include <string>    // for string, to_string
+
+#include <gtest/gtest.h>
+
+#include "audio/BufferedFileWriter.h"
+#include "filesystem.h"  // for path, temp_directory_path
+
+namespace {
+auto readFile(const fs::path& file) -> std::string {
+    std::ifstream in(file, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+}  // namespace
+
+TEST(BufferedFileWriter, writesEverythingInOrder) {
+    const fs::path file = fs::temp_directory_path() / "xournalpp-BufferedFileWriterTest.bin";
+    BufferedFileWriter writer;
+    ASSERT_TRUE(writer.open(file));
+
+    // Over several blocks, and more than the queue holds
+    std::string expected;
+    for (size_t i = 0; expected.size() < BufferedFileWriter::BLOCK_SIZE * (BufferedFileWriter::MAX_QUEUED_BLOCKS + 3);
+         i++) {
+        const std::string chunk = std::to_string(i) + ";";
+        EXPECT_EQ(writer.write(chunk.data(), chunk.size()), chunk.size());
+        expected += chunk;
+    }
+    EXPECT_EQ(writer.tell(), static_cast<int64_t>(expected.size()));
+    EXPECT_EQ(writer.size(), static_cast<int64_t>(expected.size()));
+    EXPECT_TRUE(writer.close());
+
+    EXPECT_EQ(readFile(file), expected);
+    fs::remove(file);
+}
+
+TEST(BufferedFileWriter, seekOverwritesWhatWasWritten) {
+    const fs::path file = fs::temp_directory_path() / "xournalpp-BufferedFileWriterSeekTest.bin";
+    BufferedFileWriter writer;
+    ASSERT_TRUE(writer.open(file));
+
+    EXPECT_EQ(writer.write("header--body", 12), 12U);
+    // Like an encoder updating its header once the content is known
+    EXPECT_EQ(writer.seek(0, SEEK_SET), 0);
+    EXPECT_EQ(writer.write("HEADER", 6), 6U);
+    EXPECT_EQ(writer.tell(), 6);
+    EXPECT_EQ(writer.seek(0, SEEK_END), 12);
+    EXPECT_EQ(writer.write("!", 1), 1U);
+    EXPECT_EQ(writer.size(), 13);
+    EXPECT_EQ(writer.seek(-20, SEEK_CUR), -1);
+    EXPECT_TRUE(writer.close());
+
+    EXPECT_EQ(readFile(file), "HEADER--body!");
+    fs::remove(file);
+}
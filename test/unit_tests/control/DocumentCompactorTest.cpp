@@ -0,0 +1,136 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/DocumentCompactor.h"
+#include "model/Layer.h"
+#include "model/PageType.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "undo/CompactPageUndoAction.h"
+#include "util/Color.h"
+
+namespace {
+class TestPage: public XojPage {
+public:
+    using XojPage::addLayer;
+    using XojPage::XojPage;
+};
+
+auto makeStroke(const std::vector<Point>& points, StrokeTool tool = StrokeTool::PEN) -> std::unique_ptr<Stroke> {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->setToolType(tool);
+    stroke->setWidth(2);
+    if (tool == StrokeTool::ERASER) {
+        stroke->setColor(Colors::white);
+    }
+    for (const Point& p: points) { stroke->addPoint(p); }
+    return stroke;
+}
+
+auto line(Point from, Point to, int count) -> std::vector<Point> {
+    std::vector<Point> points;
+    for (int i = 0; i < count; i++) {
+        const double t = i / static_cast<double>(count - 1);
+        points.emplace_back(from.x + t * (to.x - from.x), from.y + t * (to.y - from.y));
+    }
+    return points;
+}
+}  // namespace
+
+TEST(ControlDocumentCompactor, testMergeAndSimplify) {
+    auto page = std::make_shared<XojPage>(200, 200);
+    Layer* layer = page->getSelectedLayer();
+    layer->addElement(makeStroke(line(Point(0, 0), Point(99, 0), 100)));
+    // Continues the first one
+    layer->addElement(makeStroke(line(Point(99, 0), Point(99, 50), 51)));
+    // Another style
+    auto other = makeStroke(line(Point(99, 50), Point(0, 50), 2));
+    other->setWidth(5);
+    layer->addElement(std::move(other));
+
+    DocumentCompactor::Report report;
+    auto undo = DocumentCompactor({}).compactPage(page, report);
+    ASSERT_TRUE(undo);
+    EXPECT_FALSE(undo->removesLayers());
+    EXPECT_EQ(report.mergedStrokes, 1U);
+    EXPECT_EQ(report.elementsBefore, 3U);
+    EXPECT_EQ(report.elementsAfter, 2U);
+    EXPECT_EQ(report.pointsBefore, 153U);
+    EXPECT_LT(report.pointsAfter, 12U);
+
+    const auto& elements = layer->getElements();
+    ASSERT_EQ(elements.size(), 2U);
+    const auto* merged = dynamic_cast<const Stroke*>(elements[0].get());
+    ASSERT_NE(merged, nullptr);
+    EXPECT_EQ(merged->getPointCount() + 2, report.pointsAfter);
+    EXPECT_EQ(merged->getPoint(0).x, 0);
+    EXPECT_EQ(merged->getPoint(merged->getPointCount() - 1).y, 50);
+    EXPECT_EQ(dynamic_cast<const Stroke*>(elements[1].get())->getWidth(), 5);
+}
+
+TEST(ControlDocumentCompactor, testDropUselessWhiteout) {
+    auto page = std::make_shared<XojPage>(200, 200);
+    page->setBackgroundType(PageType(PageTypeFormat::Plain));
+    Layer* layer = page->getSelectedLayer();
+    layer->addElement(makeStroke({Point(10, 10), Point(20, 10)}));
+    // Over the pen stroke
+    auto covering = makeStroke({Point(5, 10), Point(25, 10)}, StrokeTool::ERASER);
+    const Element* kept = covering.get();
+    layer->addElement(std::move(covering));
+    // On the blank page
+    layer->addElement(makeStroke({Point(100, 100), Point(150, 100)}, StrokeTool::ERASER));
+
+    DocumentCompactor::Report report;
+    EXPECT_FALSE(DocumentCompactor({}).compactPage(page, report));
+    EXPECT_EQ(report.droppedWhiteout, 0U);
+
+    DocumentCompactor::Options options;
+    options.dropUselessWhiteout = true;
+    ASSERT_TRUE(DocumentCompactor(options).compactPage(page, report));
+    EXPECT_EQ(report.droppedWhiteout, 1U);
+    ASSERT_EQ(layer->getElements().size(), 2U);
+    EXPECT_EQ(layer->getElements()[1].get(), kept);
+
+    // The whiteout hides the ruling
+    auto lined = std::make_shared<XojPage>(200, 200);
+    lined->getSelectedLayer()->addElement(makeStroke({Point(100, 100), Point(150, 100)}, StrokeTool::ERASER));
+    EXPECT_FALSE(DocumentCompactor(options).compactPage(lined, report));
+}
+
+TEST(ControlDocumentCompactor, testRemoveEmptyLayers) {
+    auto page = std::make_shared<TestPage>(200, 200, true);
+    auto* drawn = new Layer();
+    drawn->addElement(makeStroke({Point(10, 10), Point(20, 10)}));
+    auto* named = new Layer();
+    named->setName("Notes");
+    page->addLayer(drawn);
+    page->addLayer(new Layer());
+    page->addLayer(named);
+
+    DocumentCompactor::Report report;
+    auto undo = DocumentCompactor({}).compactPage(page, report);
+    ASSERT_TRUE(undo);
+    EXPECT_TRUE(undo->removesLayers());
+    EXPECT_EQ(report.removedLayers, 1U);
+    EXPECT_EQ(*page->getLayers(), (std::vector<Layer*>{drawn, named}));
+
+    // A page keeps a layer
+    auto empty = std::make_shared<TestPage>(200, 200, true);
+    empty->addLayer(new Layer());
+    empty->addLayer(new Layer());
+    ASSERT_TRUE(DocumentCompactor({}).compactPage(empty, report));
+    EXPECT_EQ(empty->getLayerCount(), 1U);
+}
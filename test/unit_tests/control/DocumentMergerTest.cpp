@@ -0,0 +1,62 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "control/DocumentMerger.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/DocumentListener.h"
+
+#include "filesystem.h"
+
+namespace {
+class CountingListener: public DocumentListener {
+public:
+    void pagesInserted(size_t first, size_t count) override {
+        inserted.emplace_back(first, count);
+        DocumentListener::pagesInserted(first, count);
+    }
+    void pageInserted(size_t page) override { single++; }
+
+    std::vector<std::pair<size_t, size_t>> inserted;
+    size_t single = 0;
+};
+}  // namespace
+
+TEST(ControlDocumentMerger, testAppend) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    CountingListener listener;
+    listener.registerListener(&handler);
+
+    auto result = DocumentMerger::append(doc, handler,
+                                         {GET_TESTFILE("packaged_xopp/pages.xopp"), GET_TESTFILE("missing.xopp"),
+                                          GET_TESTFILE("packaged_xopp/test.xopp")});
+    EXPECT_EQ(result.first, 0U);
+    EXPECT_EQ(result.pages.size(), 7U);
+    EXPECT_EQ(result.errors.size(), 1U);
+    EXPECT_FALSE(result.pdfChanged);
+    ASSERT_EQ(doc.getPageCount(), 7U);
+    EXPECT_EQ(doc.getPage(6), result.pages[6]);
+    EXPECT_EQ(listener.inserted, (std::vector<std::pair<size_t, size_t>>{{0, 7}}));
+    EXPECT_EQ(listener.single, 7U);
+
+    // The PDF is attached to its document
+    result = DocumentMerger::append(doc, handler, {GET_TESTFILE("packaged_xopp/pdfBackground/new.xopp")});
+    EXPECT_TRUE(result.pages.empty());
+    EXPECT_EQ(result.errors.size(), 1U);
+    EXPECT_EQ(doc.getPageCount(), 7U);
+    EXPECT_EQ(listener.inserted.size(), 1U);
+}
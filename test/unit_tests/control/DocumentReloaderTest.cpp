@@ -0,0 +1,82 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/DocumentReloader.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/Util.h"
+
+namespace {
+using Hashes = std::vector<DocumentReloader::PageHash>;
+
+auto makePage(double x) -> PageRef {
+    auto page = std::make_shared<XojPage>(200, 200);
+    auto stroke = std::make_unique<Stroke>();
+    stroke->setWidth(2);
+    stroke->addPoint(Point(x, 10));
+    stroke->addPoint(Point(x, 20));
+    page->getSelectedLayer()->addElement(std::move(stroke));
+    return page;
+}
+}  // namespace
+
+TEST(ControlDocumentReloader, testMatch) {
+    // A page edited
+    EXPECT_EQ(DocumentReloader::match({1, 2, 3}, {1, 5, 3}), (std::vector<size_t>{0, npos, 2}));
+    // Pages inserted and deleted
+    EXPECT_EQ(DocumentReloader::match({1, 2, 3, 4}, {1, 7, 2, 4, 8}), (std::vector<size_t>{0, npos, 1, 3, npos}));
+    // The pages keep their order
+    EXPECT_EQ(DocumentReloader::match({1, 2, 3, 9}, {0, 3, 2, 8}), (std::vector<size_t>{npos, 2, npos, npos}));
+    // Duplicated pages
+    EXPECT_EQ(DocumentReloader::match({1, 1, 2}, {1, 1, 1, 2}), (std::vector<size_t>{0, 1, npos, 2}));
+    // Unloaded pages match nothing
+    EXPECT_EQ(DocumentReloader::match(Hashes{std::nullopt, 2}, Hashes{std::nullopt, 2}),
+              (std::vector<size_t>{npos, 1}));
+    EXPECT_EQ(DocumentReloader::match({}, {1}), (std::vector<size_t>{npos}));
+}
+
+TEST(ControlDocumentReloader, testApply) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    for (double x: {10, 20, 30, 40}) { doc.addPage(makePage(x)); }
+    const PageRef kept0 = doc.getPage(0);
+    const PageRef kept2 = doc.getPage(2);
+
+    DocumentHandler loadedHandler;
+    Document loaded(&loadedHandler);
+    // The second page edited
+    for (double x: {10, 25, 30, 40}) { loaded.addPage(makePage(x)); }
+    // The last one as well: the names of the layers are saved
+    doc.getPage(3)->getSelectedLayer()->setName("Notes");
+
+    auto matches = DocumentReloader::match(DocumentReloader::hashPages(doc, false),
+                                           DocumentReloader::hashPages(loaded, false));
+    ASSERT_EQ(matches, (std::vector<size_t>{0, npos, 2, npos}));
+
+    std::vector<PageRef> pages;
+    for (size_t n = 0; n < loaded.getPageCount(); n++) { pages.push_back(loaded.getPage(n)); }
+    EXPECT_EQ(DocumentReloader::apply(doc, handler, pages, matches), 2U);
+
+    ASSERT_EQ(doc.getPageCount(), 4U);
+    EXPECT_EQ(doc.getPage(0), kept0);
+    EXPECT_EQ(doc.getPage(1), pages[1]);
+    EXPECT_EQ(doc.getPage(2), kept2);
+    EXPECT_EQ(doc.getPage(3), pages[3]);
+    EXPECT_EQ(DocumentReloader::hashPages(doc, false), DocumentReloader::hashPages(loaded, false));
+}
@@ -0,0 +1,57 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <sstream>
+#include <string>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "control/ExportHelper.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+TEST(ControlExportHelper, testExportBatch) {
+    auto folder = Util::getTmpDirSubfolder() / "export-batch";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+
+    const fs::path input = GET_TESTFILE("packaged_xopp/suite.xopp");
+    std::stringstream manifest;
+    manifest << "# A comment\n\n";
+    manifest << input.u8string() << '\t' << (folder / "a.pdf").u8string() << '\n';
+    manifest << input.u8string() << '\t' << (folder / "b.xopp").u8string() << '\n';
+    manifest << (folder / "missing.xopp").u8string() << '\t' << (folder / "c.pdf").u8string() << '\n';
+    manifest << input.u8string() << '\t' << (folder / "d.unknown").u8string() << '\n';
+
+    testing::internal::CaptureStdout();
+    int result = ExportHelper::exportBatch(manifest, ExportHelper::ExportOptions(), 2);
+    std::string report = testing::internal::GetCapturedStdout();
+
+    // The failures do not stop the other conversions
+    EXPECT_EQ(result, -3);
+    EXPECT_TRUE(fs::exists(folder / "a.pdf"));
+    EXPECT_TRUE(fs::exists(folder / "b.xopp"));
+
+    std::istringstream lines(report);
+    std::string line;
+    int ok = 0;
+    int failed = 0;
+    while (std::getline(lines, line)) {
+        EXPECT_EQ(line.front(), '{');
+        EXPECT_NE(line.find("\"ms\": "), std::string::npos);
+        ok += line.find("\"ok\": true") != std::string::npos;
+        failed += line.find("\"ok\": false, ") != std::string::npos && line.find("\"error\": ") != std::string::npos;
+    }
+    EXPECT_EQ(ok, 2);
+    EXPECT_EQ(failed, 2);
+}
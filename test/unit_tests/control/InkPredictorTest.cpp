@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "control/tools/InkPredictor.h"
+
+TEST(ControlInkPredictor, testNoSample) {
+    InkPredictor predictor(16);
+    EXPECT_FALSE(predictor.predict());
+
+    predictor.addSample(1.0, 2.0, 100);
+    predictor.reset();
+    EXPECT_FALSE(predictor.predict());
+}
+
+TEST(ControlInkPredictor, testNoSpeedYet) {
+    InkPredictor predictor(16);
+    predictor.addSample(1.0, 2.0, 100);
+    predictor.addSample(3.0, 5.0, 100);
+
+    auto p = predictor.predict();
+    ASSERT_TRUE(p);
+    EXPECT_DOUBLE_EQ(p->x, 3.0);
+    EXPECT_DOUBLE_EQ(p->y, 5.0);
+}
+
+TEST(ControlInkPredictor, testLinearMotion) {
+    InkPredictor predictor(16);
+    // 0.5 pt/ms along x, -0.25 pt/ms along y, one event every 8ms
+    for (guint32 t = 0; t <= 80; t += 8) {
+        predictor.addSample(10.0 + 0.5 * t, 50.0 - 0.25 * t, 1000 + t);
+    }
+
+    auto p = predictor.predict();
+    ASSERT_TRUE(p);
+    EXPECT_NEAR(p->x, 10.0 + 0.5 * 96, 1e-6);
+    EXPECT_NEAR(p->y, 50.0 - 0.25 * 96, 1e-6);
+}
+
+TEST(ControlInkPredictor, testExtrapolationIsBounded) {
+    InkPredictor predictor(16);
+    // The samples only span 4ms: the motion is not extrapolated further than 4ms ahead
+    predictor.addSample(0.0, 0.0, 1000);
+    predictor.addSample(2.0, 0.0, 1004);
+
+    auto p = predictor.predict();
+    ASSERT_TRUE(p);
+    EXPECT_NEAR(p->x, 4.0, 1e-6);
+    EXPECT_NEAR(p->y, 0.0, 1e-6);
+}
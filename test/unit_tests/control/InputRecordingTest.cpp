@@ -0,0 +1,89 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gui/inputdevices/InputRecording.h"
+
+using xoj::input::RecordedEvent;
+
+TEST(ControlInputRecording, testSaveAndLoad) {
+    RecordedEvent press;
+    press.type = BUTTON_PRESS_EVENT;
+    press.deviceClass = INPUT_DEVICE_PEN;
+    press.absoluteX = 1024.123456789;
+    press.absoluteY = 768.5;
+    press.relativeX = 0.1;
+    press.relativeY = 1.0 / 3.0;
+    press.button = 1;
+    press.pressure = 0.25;
+    press.timestamp = 4000000000U;
+
+    RecordedEvent touch;
+    touch.type = MOTION_EVENT;
+    touch.deviceClass = INPUT_DEVICE_TOUCHSCREEN;
+    touch.state = 17;
+    touch.sequence = 3;
+
+    std::stringstream ss;
+    ASSERT_TRUE(xoj::input::save(ss, {press, touch}));
+    // The invalid lines are skipped
+    ss << "not an event\n";
+
+    auto events = xoj::input::load(ss);
+    ASSERT_TRUE(events);
+    ASSERT_EQ(events->size(), 2U);
+
+    const RecordedEvent& e = events->front();
+    EXPECT_EQ(e.type, BUTTON_PRESS_EVENT);
+    EXPECT_EQ(e.deviceClass, INPUT_DEVICE_PEN);
+    EXPECT_EQ(e.absoluteX, press.absoluteX);
+    EXPECT_EQ(e.absoluteY, press.absoluteY);
+    EXPECT_EQ(e.relativeX, press.relativeX);
+    EXPECT_EQ(e.relativeY, press.relativeY);
+    EXPECT_EQ(e.button, 1U);
+    EXPECT_EQ(e.pressure, 0.25);
+    EXPECT_EQ(e.timestamp, 4000000000U);
+    EXPECT_EQ(e.sequence, 0);
+
+    const RecordedEvent& t = events->back();
+    EXPECT_EQ(t.type, MOTION_EVENT);
+    EXPECT_EQ(t.deviceClass, INPUT_DEVICE_TOUCHSCREEN);
+    EXPECT_EQ(t.state, 17U);
+    EXPECT_EQ(t.pressure, Point::NO_PRESSURE);
+    EXPECT_EQ(t.sequence, 3);
+}
+
+TEST(ControlInputRecording, testLoadInvalid) {
+    std::stringstream ss("XOJ-METADATA/1.0\n5 1 0 0 0 0 0 0 1 0 0\n");
+    EXPECT_FALSE(xoj::input::load(ss));
+
+    EXPECT_FALSE(xoj::input::parse("42 1 0 0 0 0 0 0 1 0 0"));
+    EXPECT_FALSE(xoj::input::parse("5 1 0 0"));
+}
+
+TEST(ControlInputRecording, testSummarize) {
+    std::vector<int64_t> samples;
+    for (int64_t i = 100; i >= 1; i--) { samples.push_back(i); }
+
+    auto d = xoj::input::summarize(samples);
+    EXPECT_EQ(d.count, 100U);
+    EXPECT_DOUBLE_EQ(d.mean, 50.5);
+    EXPECT_EQ(d.p50, 50);
+    EXPECT_EQ(d.p90, 90);
+    EXPECT_EQ(d.p99, 99);
+    EXPECT_EQ(d.max, 100);
+
+    EXPECT_EQ(xoj::input::summarize({}).count, 0U);
+}
@@ -0,0 +1,50 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/jobs/JobTrace.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+TEST(ControlJobTrace, testWrite) {
+    xoj::trace::clear();
+    int render = xoj::trace::registerThread("XournalScheduler render 0");
+    int serial = xoj::trace::registerThread("XournalScheduler");
+    xoj::trace::recordJob({JOB_TYPE_RENDER, JOB_PRIORITY_URGENT, nullptr, 1000, 1050, 1300, render});
+    xoj::trace::recordJob({JOB_TYPE_AUTOSAVE, JOB_PRIORITY_NONE, nullptr, 900, 1000, 5000, serial});
+
+    auto file = Util::getTmpDirSubfolder() / "job-trace.json";
+    ASSERT_TRUE(xoj::trace::write(file));
+    xoj::trace::clear();
+
+    std::ifstream in(file);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string json = ss.str();
+
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0U);
+    EXPECT_NE(json.find(R"("args":{"name":"XournalScheduler render 0"})"), std::string::npos);
+    EXPECT_NE(json.find(R"("args":{"name":"queue urgent"})"), std::string::npos);
+    EXPECT_NE(json.find(R"("name":"render","cat":"job","ph":"X","pid":1,"tid":0,"ts":1050,"dur":250)"),
+              std::string::npos);
+    EXPECT_NE(json.find(R"("priority":"urgent","queued_us":50)"), std::string::npos);
+    EXPECT_NE(json.find(R"("name":"autosave","cat":"job","ph":"X","pid":1,"tid":1,"ts":1000,"dur":4000)"),
+              std::string::npos);
+    EXPECT_EQ(std::count(json.begin(), json.end(), '{'), std::count(json.begin(), json.end(), '}'));
+    EXPECT_EQ(json.find(",\n]"), std::string::npos);
+}
@@ -0,0 +1,46 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/latex/LatexCache.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+TEST(ControlLatexCache, testStoreAndLookup) {
+    auto folder = Util::getTmpDirSubfolder() / "latex-cache-test";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+
+    const std::string key = LatexCache::key("\\frac{1}{2}", "pdflatex {}");
+    // The formula and the command are both part of the key
+    EXPECT_NE(key, LatexCache::key("\\frac{1}{3}", "pdflatex {}"));
+    EXPECT_NE(key, LatexCache::key("\\frac{1}{2}", "lualatex {}"));
+    EXPECT_EQ(key, LatexCache::key("\\frac{1}{2}", "pdflatex {}"));
+
+    LatexCache cache(folder);
+    EXPECT_FALSE(cache.lookup(key));
+
+    const auto rendered = folder / "rendered.pdf";
+    {
+        std::ofstream out(rendered, std::ios::binary);
+        out << "%PDF-1.5 formula";
+    }
+    cache.store(key, rendered);
+
+    auto pdf = LatexCache(folder).lookup(key);
+    ASSERT_TRUE(pdf);
+    EXPECT_EQ(*pdf, "%PDF-1.5 formula");
+}
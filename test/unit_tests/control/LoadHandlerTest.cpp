@@ -11,19 +11,24 @@
 
 #include <cmath>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 
 #include <config-test.h>
 #include <gtest/gtest.h>
+#include <zip.h>
 
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
 #include "model/Element.h"
 #include "model/Image.h"
+#include "model/ImageBuffer.h"
 #include "model/Stroke.h"
 #include "model/Text.h"
 #include "model/XojPage.h"
+#include "util/GzUtil.h"
 #include "util/PathUtil.h"
+#include "util/XojPreviewExtractor.h"
 
 #include "filesystem.h"
 
@@ -35,8 +40,9 @@ using std::string;
  * Unit test implementation for the "suite.xopp" file and its derivatives.
  * \param filepath The path to the actual file to load.
  * \param tol The absolute tolerance used when checking stroke coordinate data.
+ * \param binaryPoints Save the points of the strokes in binary form
  */
-void testLoadStoreLoadHelper(const fs::path& filepath, double tol = 1e-8) {
+void testLoadStoreLoadHelper(const fs::path& filepath, double tol = 1e-8, bool binaryPoints = false) {
     auto getElements = [](Document* doc) {
         EXPECT_EQ((size_t)1, doc->getPageCount());
         PageRef page = doc->getPage(0);
@@ -78,6 +84,7 @@ void testLoadStoreLoadHelper(const fs::path& filepath, double tol = 1e-8) {
     auto elements1 = getElements(doc1.get());
 
     SaveHandler h;
+    h.setBinaryPointEncoding(binaryPoints);
     h.prepareSave(doc1.get());
     auto tmp = Util::getTmpDirSubfolder() / "save.xopp";
     h.saveTo(tmp);
@@ -451,6 +458,11 @@ TEST(ControlLoadHandler, testLoadStoreLoadGerman) {
 }
 #endif
 
+TEST(ControlLoadHandler, testLoadStoreLoadBinaryPoints) {
+    // The points are stored as float32
+    testLoadStoreLoadHelper(GET_TESTFILE("packaged_xopp/suite.xopp"), /*tol=*/1e-3, /*binaryPoints=*/true);
+}
+
 // Backwards compatibility test that checks that full-precision float strings can be loaded.
 // See https://github.com/xournalpp/xournalpp/pull/4065
 TEST(ControlLoadHandler, testLoadStoreLoadFloatBwCompat) {
@@ -510,3 +522,227 @@ TEST(ControlLoadHandler, testStrokeWidthRecovery) {
 
     testPressureValues(8, {0.25, 0.30, 0.40, Point::NO_PRESSURE});
 }
+
+namespace {
+void expectSameContent(Document* expected, Document* doc) {
+    ASSERT_EQ(expected->getPageCount(), doc->getPageCount());
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        PageRef pA = expected->getPage(i);
+        PageRef pB = doc->getPage(i);
+        EXPECT_EQ(pA->getWidth(), pB->getWidth());
+        EXPECT_EQ(pA->getHeight(), pB->getHeight());
+        EXPECT_TRUE(pA->getBackgroundType() == pB->getBackgroundType());
+        ASSERT_EQ(pA->getLayerCount(), pB->getLayerCount());
+        for (size_t l = 0; l < pA->getLayerCount(); l++) {
+            const auto& elementsA = (*pA->getLayers())[l]->getElements();
+            const auto& elementsB = (*pB->getLayers())[l]->getElements();
+            ASSERT_EQ(elementsA.size(), elementsB.size());
+            for (size_t e = 0; e < elementsA.size(); e++) {
+                EXPECT_EQ(elementsA[e]->getType(), elementsB[e]->getType());
+                EXPECT_EQ(elementsA[e]->getX(), elementsB[e]->getX());
+                EXPECT_EQ(elementsA[e]->getY(), elementsB[e]->getY());
+                EXPECT_EQ(elementsA[e]->getElementWidth(), elementsB[e]->getElementWidth());
+                EXPECT_EQ(elementsA[e]->getElementHeight(), elementsB[e]->getElementHeight());
+            }
+        }
+    }
+}
+};  // namespace
+
+TEST(ControlLoadHandler, testParallelPageParsing) {
+    LoadHandler sequentialHandler;
+    sequentialHandler.setPageParserThreadCount(1);
+    auto expected = sequentialHandler.loadDocument(GET_TESTFILE("big-test.xoj"));
+
+    LoadHandler parallelHandler;
+    parallelHandler.setPageParserThreadCount(4);
+    auto doc = parallelHandler.loadDocument(GET_TESTFILE("big-test.xoj"));
+
+    ASSERT_TRUE(expected);
+    ASSERT_TRUE(doc);
+    EXPECT_EQ(sequentialHandler.getFileVersion(), parallelHandler.getFileVersion());
+    expectSameContent(expected.get(), doc.get());
+}
+
+TEST(ControlLoadHandler, testLazyPageLoading) {
+    LoadHandler eagerHandler;
+    auto expected = eagerHandler.loadDocument(GET_TESTFILE("big-test.xoj"));
+
+    LoadHandler lazyHandler;
+    lazyHandler.setLazyPageLoading(true);
+    auto doc = lazyHandler.loadDocument(GET_TESTFILE("big-test.xoj"));
+
+    ASSERT_TRUE(expected);
+    ASSERT_TRUE(doc);
+    ASSERT_GT(doc->getPageCount(), 1U);
+    PageRef page = doc->getPage(1);
+    EXPECT_TRUE(page->hasContentLoader());
+    EXPECT_FALSE(page->isContentLoaded());
+
+    // The layers are read when they are accessed
+    expectSameContent(expected.get(), doc.get());
+    EXPECT_TRUE(page->isContentLoaded());
+
+    // ... and read again after they were freed
+    EXPECT_TRUE(page->unloadContent());
+    EXPECT_FALSE(page->isContentLoaded());
+    expectSameContent(expected.get(), doc.get());
+
+    // Modified layers are kept
+    (*page->getLayers())[0]->setName("modified");
+    EXPECT_FALSE(page->unloadContent());
+    EXPECT_TRUE(page->isContentLoaded());
+
+    page->detachContentLoader();
+    EXPECT_FALSE(page->hasContentLoader());
+}
+
+TEST(ControlLoadHandler, testMappedUncompressedFile) {
+    LoadHandler handler;
+    auto expected = handler.loadDocument(GET_TESTFILE("big-test.xoj"));
+    ASSERT_TRUE(expected);
+
+    // An uncompressed copy of the file is parsed where it is mapped
+    const fs::path uncompressed = Util::getTmpDirSubfolder() / "big-test.unzipped.xoj";
+    {
+        gzFile fp = GzUtil::openPath(GET_TESTFILE("big-test.xoj"), "r");
+        ASSERT_TRUE(fp);
+        std::ofstream out(uncompressed, std::ios::binary);
+        char buffer[4096];
+        int read = 0;
+        while ((read = gzread(fp, buffer, sizeof(buffer))) > 0) { out.write(buffer, read); }
+        gzclose(fp);
+    }
+
+    for (unsigned int threads: {1U, 4U}) {
+        LoadHandler mappedHandler;
+        mappedHandler.setPageParserThreadCount(threads);
+        auto doc = mappedHandler.loadDocument(uncompressed);
+        ASSERT_TRUE(doc);
+        expectSameContent(expected.get(), doc.get());
+    }
+
+    // The lazily loaded pages do not read the file anymore
+    LoadHandler lazyHandler;
+    lazyHandler.setLazyPageLoading(true);
+    auto doc = lazyHandler.loadDocument(uncompressed);
+    ASSERT_TRUE(doc);
+    std::ofstream(uncompressed, std::ios::trunc).close();
+    expectSameContent(expected.get(), doc.get());
+    fs::remove(uncompressed);
+}
+
+TEST(ControlLoadHandler, testParallelPageParsingError) {
+    // The 4th page is broken: the error must be the one of a sequential parsing
+    std::string content = "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"test\" fileversion=\"4\">\n";
+    for (int i = 0; i < 6; i++) {
+        content += "<page width=\"100\" height=\"100\">\n";
+        content += i == 3 ? "<background type=\"unknown\"/>\n"
+                          : "<background type=\"solid\" color=\"#ffffffff\" style=\"plain\"/>\n";
+        content += "<layer/>\n</page>\n";
+    }
+    content += "</xournal>\n";
+
+    auto tmp = Util::getTmpDirSubfolder() / "parallel-error.xoj";
+    std::ofstream(tmp) << content;
+
+    LoadHandler sequentialHandler;
+    sequentialHandler.setPageParserThreadCount(1);
+    EXPECT_FALSE(sequentialHandler.loadDocument(tmp));
+
+    LoadHandler parallelHandler;
+    parallelHandler.setPageParserThreadCount(4);
+    EXPECT_FALSE(parallelHandler.loadDocument(tmp));
+
+    EXPECT_FALSE(sequentialHandler.getLastError().empty());
+    EXPECT_EQ(sequentialHandler.getLastError(), parallelHandler.getLastError());
+}
+
+TEST(ControlLoadHandler, testStreamedSave) {
+    LoadHandler handler;
+    auto expected = handler.loadDocument(GET_TESTFILE("big-test.xoj"));
+    ASSERT_TRUE(expected);
+
+    // The pages are written one after the other, without the XML tree of the whole document
+    for (bool binaryPoints: {false, true}) {
+        SaveHandler h;
+        h.setBinaryPointEncoding(binaryPoints);
+        auto tmp = Util::getTmpDirSubfolder() / "streamed-save.xopp";
+        h.saveDocument(expected.get(), tmp);
+        EXPECT_TRUE(h.getErrorMessage().empty());
+
+        LoadHandler handler2;
+        auto doc = handler2.loadDocument(tmp);
+        ASSERT_TRUE(doc);
+        ASSERT_EQ(expected->getPageCount(), doc->getPageCount());
+        for (size_t i = 0; i < doc->getPageCount(); i++) {
+            EXPECT_EQ(expected->getPage(i)->getLayerCount(), doc->getPage(i)->getLayerCount());
+        }
+        if (!binaryPoints) {
+            // The coordinates are rounded in the binary form
+            expectSameContent(expected.get(), doc.get());
+        }
+    }
+}
+
+TEST(ControlLoadHandler, testDeduplicatedImages) {
+    LoadHandler handler;
+    auto doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/imgAttachment/doc_with_jpg.xopp"));
+    ASSERT_TRUE(doc);
+    Layer* layer = (*doc->getPage(0)->getLayers())[0];
+    ASSERT_EQ(layer->getElements().size(), 1);
+    for (int i = 0; i < 2; i++) { layer->addElement(layer->getElements()[0]->clone()); }
+
+    auto tmp = Util::getTmpDirSubfolder() / "deduplicated-images.xopp";
+    SaveHandler h;
+    h.setBinaryPointEncoding(true);
+    h.saveDocument(doc.get(), tmp);
+    ASSERT_TRUE(h.getErrorMessage().empty());
+
+    // The copies of the image are stored once
+    int zipError = 0;
+    zip_t* zipFp = zip_open(tmp.u8string().c_str(), ZIP_RDONLY, &zipError);
+    ASSERT_TRUE(zipFp);
+    int imageEntries = 0;
+    for (zip_int64_t i = 0; i < zip_get_num_entries(zipFp, 0); i++) {
+        imageEntries += std::string(zip_get_name(zipFp, static_cast<zip_uint64_t>(i), 0)).rfind("images/", 0) == 0;
+    }
+    zip_discard(zipFp);
+    EXPECT_EQ(imageEntries, 1);
+
+    LoadHandler handler2;
+    auto loaded = handler2.loadDocument(tmp);
+    ASSERT_TRUE(loaded);
+    const auto& elements = (*loaded->getPage(0)->getLayers())[0]->getElements();
+    ASSERT_EQ(elements.size(), 3);
+    auto* img = dynamic_cast<Image*>(elements[0].get());
+    ASSERT_TRUE(img);
+    checkImageFormat(img, "jpeg");
+    for (auto&& e: elements) {
+        auto* copy = dynamic_cast<Image*>(e.get());
+        ASSERT_TRUE(copy);
+        EXPECT_EQ(copy->getBuffer(), img->getBuffer());
+        EXPECT_EQ(copy->getImage().get(), img->getImage().get());
+    }
+}
+
+TEST(ControlLoadHandler, testPreviewInArchive) {
+    LoadHandler handler;
+    auto doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/imgAttachment/doc_with_jpg.xopp"));
+    ASSERT_TRUE(doc);
+    auto preview = ImageBuffer::get(std::string("not a real PNG"));
+    doc->setPreview(preview, 42);
+
+    auto tmp = Util::getTmpDirSubfolder() / "preview-in-archive.xopp";
+    SaveHandler h;
+    h.setBinaryPointEncoding(true);
+    h.saveDocument(doc.get(), tmp);
+    ASSERT_TRUE(h.getErrorMessage().empty());
+
+    // The preview is stored as is, where the thumbnailer reads it
+    XojPreviewExtractor extractor;
+    ASSERT_EQ(PREVIEW_RESULT_IMAGE_READ, extractor.readFile(tmp));
+    gsize dataLen = 0;
+    unsigned char* data = extractor.getData(dataLen);
+    EXPECT_EQ(preview->getData(), std::string(reinterpret_cast<char*>(data), dataLen));
+}
@@ -0,0 +1,65 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/MemoryReport.h"
+
+namespace {
+constexpr size_t MIB = 1024 * 1024;
+
+auto makePage(size_t index, size_t points, size_t buffers) -> MemoryReport::Page {
+    MemoryReport::Page p;
+    p.index = index;
+    p.loaded = true;
+    p.pointsMemory = points;
+    p.viewBuffers = buffers;
+    return p;
+}
+}  // namespace
+
+TEST(ControlMemoryReport, testTotals) {
+    MemoryReport report;
+    report.pages.push_back(makePage(0, 1 * MIB, 2 * MIB));
+    report.pages.push_back(makePage(1, 3 * MIB, 4 * MIB));
+    report.pointsMemory = 4 * MIB;
+    report.viewBuffers = 6 * MIB;
+    report.pdfCache = 10 * MIB;
+    report.undoHistory = 5 * MIB;
+    // On disk
+    report.undoSpilled = 100 * MIB;
+
+    EXPECT_EQ(report.pages[1].getTotal(), 7 * MIB);
+    EXPECT_EQ(report.getTotal(), 25 * MIB);
+}
+
+TEST(ControlMemoryReport, testLargestPagesFirst) {
+    MemoryReport report;
+    report.document = "notes.xopp";
+    report.pages.push_back(makePage(0, 1 * MIB, 0));
+    report.pages.push_back(makePage(1, 0, 0));
+    report.pages.back().loaded = false;
+    report.pages.push_back(makePage(2, 8 * MIB, 0));
+    report.pages.push_back(makePage(3, 2 * MIB, 0));
+
+    const std::string text = report.toString(2);
+    EXPECT_NE(text.find("\"notes.xopp\""), std::string::npos);
+    EXPECT_NE(text.find("Pages (4, 1 unloaded)"), std::string::npos);
+    const auto third = text.find("Page 3: 8.0 MiB");
+    const auto fourth = text.find("Page 4: 2.0 MiB");
+    ASSERT_NE(third, std::string::npos);
+    ASSERT_NE(fourth, std::string::npos);
+    EXPECT_LT(third, fourth);
+    EXPECT_EQ(text.find("Page 1: "), std::string::npos);
+    EXPECT_NE(text.find("1 more loaded pages"), std::string::npos);
+}
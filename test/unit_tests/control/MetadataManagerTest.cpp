@@ -0,0 +1,84 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "control/settings/MetadataManager.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+auto createFolder() -> fs::path {
+    auto folder = Util::getTmpDirSubfolder() / "metadata-test";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    return folder;
+}
+}  // namespace
+
+TEST(ControlMetadataManager, testStoreAndLoad) {
+    auto folder = createFolder();
+    const fs::path fileA = "/home/user/a.xopp";
+    const fs::path fileB = "/home/user/with space/b.xopp";
+
+    {
+        MetadataManager manager(folder);
+        EXPECT_FALSE(manager.getForFile(fileA).valid);
+
+        manager.storeMetadata(fileA, 3, 1.5);
+        // Another document: the metadata of the first one are kept
+        manager.storeMetadata(fileB, 7, 2.0);
+        manager.storeMetadata(fileB, 8, 2.0);
+        manager.documentChanged();
+
+        auto entry = manager.getForFile(fileA);
+        EXPECT_TRUE(entry.valid);
+        EXPECT_EQ(entry.page, 3);
+    }
+
+    MetadataManager manager(folder);
+    auto a = manager.getForFile(fileA);
+    ASSERT_TRUE(a.valid);
+    EXPECT_EQ(a.page, 3);
+    EXPECT_DOUBLE_EQ(a.zoom, 1.5);
+
+    auto b = manager.getForFile(fileB);
+    ASSERT_TRUE(b.valid);
+    EXPECT_EQ(b.path, fileB);
+    EXPECT_EQ(b.page, 8);
+    EXPECT_DOUBLE_EQ(b.zoom, 2.0);
+}
+
+TEST(ControlMetadataManager, testImportLegacyFiles) {
+    auto folder = createFolder();
+    const fs::path file = "/home/user/legacy.xopp";
+    const auto legacyFile = folder / "1234.metadata";
+    {
+        std::ofstream out(legacyFile);
+        out << "XOJ-METADATA/1.0\n" << file << "\npage=4\nzoom=0.75\n";
+    }
+
+    {
+        MetadataManager manager(folder);
+        auto entry = manager.getForFile(file);
+        ASSERT_TRUE(entry.valid);
+        EXPECT_EQ(entry.page, 4);
+        EXPECT_DOUBLE_EQ(entry.zoom, 0.75);
+    }
+    // The legacy file was replaced by the index
+    EXPECT_FALSE(fs::exists(legacyFile));
+
+    MetadataManager manager(folder);
+    EXPECT_EQ(manager.getForFile(file).page, 4);
+}
@@ -0,0 +1,81 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/ParallelPageEdit.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/DocumentListener.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "undo/GroupUndoAction.h"
+#include "undo/UndoAction.h"
+
+namespace {
+class PageUndoAction: public UndoAction {
+public:
+    explicit PageUndoAction(const PageRef& page): UndoAction("PageUndoAction") { this->page = page; }
+
+    bool undo(Control*) override { return true; }
+    bool redo(Control*) override { return true; }
+    std::string getText() override { return "Edit"; }
+};
+
+class CountingListener: public DocumentListener {
+public:
+    explicit CountingListener(DocumentHandler* handler) { registerListener(handler); }
+
+    void documentChanged(DocumentChangeType type) override { documentChanges += type == DOCUMENT_CHANGE_PAGES; }
+    void pageChanged(size_t) override { pageChanges++; }
+
+    int documentChanges = 0;
+    int pageChanges = 0;
+};
+}  // namespace
+
+TEST(ControlParallelPageEdit, testEditPages) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 64; i++) { pages.push_back(std::make_shared<XojPage>(100, 100)); }
+    doc.addPages(pages.begin(), pages.end());
+    CountingListener listener(&handler);
+
+    auto group = ParallelPageEdit::run(doc, handler, pages, [](const PageRef& page) -> std::unique_ptr<UndoAction> {
+        auto stroke = std::make_unique<Stroke>();
+        stroke->addPoint(Point(0, 0));
+        stroke->addPoint(Point(10, 10));
+        page->getSelectedLayer()->addElement(std::move(stroke));
+        return std::make_unique<PageUndoAction>(page);
+    });
+    ASSERT_TRUE(group);
+
+    const auto edited = group->getPages();
+    ASSERT_EQ(edited.size(), pages.size());
+    for (size_t i = 0; i < pages.size(); i++) {
+        EXPECT_EQ(edited[i], pages[i]);
+        EXPECT_EQ(pages[i]->getSelectedLayer()->getElements().size(), 1U);
+    }
+    // Notified at once
+    EXPECT_EQ(listener.documentChanges, 1);
+    EXPECT_EQ(listener.pageChanges, 0);
+
+    // Nothing to undo nor to notify if no page changed
+    auto none = ParallelPageEdit::run(doc, handler, pages, [](const PageRef&) { return nullptr; });
+    EXPECT_FALSE(none);
+    EXPECT_EQ(listener.documentChanges, 1);
+}
@@ -0,0 +1,118 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "control/xojfile/LoadHandler.h"
+#include "control/xojfile/RecoveryJournal.h"
+#include "control/xojfile/SaveHandler.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+
+#include "filesystem.h"
+
+namespace {
+void addStroke(const PageRef& page) {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->setWidth(1.0);
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(20, 20));
+    (*page->getLayers())[0]->addElement(std::move(stroke));
+}
+
+size_t countElements(const PageRef& page) { return (*page->getLayers())[0]->getElements().size(); }
+
+auto saveTestDocument(const fs::path& file) -> std::unique_ptr<Document> {
+    LoadHandler handler;
+    auto doc = handler.loadDocument(GET_TESTFILE("big-test.xoj"));
+    if (doc) {
+        SaveHandler h;
+        h.saveDocument(doc.get(), file);
+        EXPECT_TRUE(h.getErrorMessage().empty());
+    }
+    return doc;
+}
+}  // namespace
+
+TEST(ControlRecoveryJournal, testRecovery) {
+    const fs::path documentFile = Util::getTmpDirSubfolder() / "recovery-test.xopp";
+    const fs::path journalFile = Util::getTmpDirSubfolder() / "recovery-test.journal";
+    fs::remove(journalFile);
+    auto doc = saveTestDocument(documentFile);
+    ASSERT_TRUE(doc);
+    ASSERT_GT(doc->getPageCount(), 3U);
+
+    const size_t elementCount = countElements(doc->getPage(2));
+    {
+        RecoveryJournal journal(journalFile);
+        EXPECT_FALSE(journal.hasLeftover());
+        journal.start(documentFile, RecoveryJournal::captureBaseline(doc.get()));
+        ASSERT_TRUE(journal.isActive());
+
+        // Every record of the page is appended, the last one wins
+        addStroke(doc->getPage(2));
+        journal.record(doc.get());
+        addStroke(doc->getPage(2));
+        journal.record(doc.get());
+        // The journal outlives a crash
+        EXPECT_TRUE(journal.keepForRecovery());
+    }
+
+    RecoveryJournal nextSession(journalFile);
+    ASSERT_TRUE(nextSession.hasLeftover());
+    std::string error;
+    auto recovery = RecoveryJournal::read(journalFile, error);
+    ASSERT_TRUE(recovery) << error;
+    EXPECT_EQ(recovery->documentFile, documentFile);
+    EXPECT_EQ(recovery->records.size(), 2U);
+
+    LoadHandler handler;
+    auto restored = handler.loadDocument(documentFile);
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(countElements(restored->getPage(2)), elementCount);
+    EXPECT_TRUE(RecoveryJournal::apply(restored.get(), *recovery, error)) << error;
+    EXPECT_EQ(countElements(restored->getPage(2)), elementCount + 2);
+    EXPECT_EQ(countElements(restored->getPage(1)), countElements(doc->getPage(1)));
+
+    // No journal is started before the leftover is discarded
+    nextSession.start(documentFile, RecoveryJournal::captureBaseline(restored.get()));
+    EXPECT_FALSE(nextSession.isActive());
+    nextSession.discardLeftover();
+    EXPECT_FALSE(fs::exists(journalFile));
+    fs::remove(documentFile);
+}
+
+TEST(ControlRecoveryJournal, testInvalidatedJournal) {
+    const fs::path documentFile = Util::getTmpDirSubfolder() / "recovery-invalidated.xopp";
+    const fs::path journalFile = Util::getTmpDirSubfolder() / "recovery-invalidated.journal";
+    fs::remove(journalFile);
+    auto doc = saveTestDocument(documentFile);
+    ASSERT_TRUE(doc);
+
+    RecoveryJournal journal(journalFile);
+    journal.start(documentFile, RecoveryJournal::captureBaseline(doc.get()));
+    ASSERT_TRUE(journal.isActive());
+
+    // A new page cannot be replayed onto the saved file
+    doc->insertPage(std::make_shared<XojPage>(100, 100), 0);
+    journal.record(doc.get());
+    EXPECT_FALSE(journal.isActive());
+    EXPECT_FALSE(fs::exists(journalFile));
+    EXPECT_FALSE(journal.keepForRecovery());
+    fs::remove(documentFile);
+}
@@ -0,0 +1,76 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "control/jobs/Job.h"
+#include "control/jobs/Scheduler.h"
+
+namespace {
+class TestJob: public Job {
+public:
+    TestJob(void* source, bool* deleted): source(source), deleted(deleted) {}
+
+    JobType getType() override { return JOB_TYPE_RENDER; }
+    void* getSource() override { return source; }
+
+protected:
+    void run() override {}
+    void onDelete() override { *deleted = true; }
+
+private:
+    void* source;
+    bool* deleted;
+};
+
+/// Exposes the queue index, without starting the workers
+class TestScheduler: public Scheduler {
+public:
+    bool hasQueuedJob(void* source, JobPriority priority) {
+        std::lock_guard lock{this->jobQueueMutex};
+        return hasQueuedJobUnlocked(source, JOB_TYPE_RENDER, priority);
+    }
+
+    void cancel(void* source, JobPriority priority) {
+        std::lock_guard lock{this->jobQueueMutex};
+        cancelQueuedJobsUnlocked(source, JOB_TYPE_RENDER, priority);
+    }
+};
+}  // namespace
+
+TEST(ControlScheduler, testQueueIndex) {
+    int sources[3];
+    bool deleted[3] = {false, false, false};
+
+    TestScheduler scheduler;
+    for (int i = 0; i < 3; i++) {
+        auto* job = new TestJob(&sources[i], &deleted[i]);
+        scheduler.addJob(job, i == 2 ? JOB_PRIORITY_LOW : JOB_PRIORITY_URGENT);
+        job->unref();
+    }
+
+    EXPECT_TRUE(scheduler.hasQueuedJob(&sources[0], JOB_PRIORITY_URGENT));
+    EXPECT_TRUE(scheduler.hasQueuedJob(&sources[1], JOB_PRIORITY_URGENT));
+    EXPECT_FALSE(scheduler.hasQueuedJob(&sources[2], JOB_PRIORITY_URGENT));
+    EXPECT_TRUE(scheduler.hasQueuedJob(&sources[2], JOB_PRIORITY_LOW));
+
+    scheduler.cancel(&sources[0], JOB_PRIORITY_URGENT);
+    EXPECT_TRUE(deleted[0]);
+    EXPECT_FALSE(deleted[1]);
+    EXPECT_FALSE(scheduler.hasQueuedJob(&sources[0], JOB_PRIORITY_URGENT));
+    EXPECT_TRUE(scheduler.hasQueuedJob(&sources[1], JOB_PRIORITY_URGENT));
+
+    // The cancelled job is still in the queue until it reaches the front, but it is not counted
+    auto depths = scheduler.getQueueDepths();
+    EXPECT_EQ(depths[JOB_PRIORITY_URGENT], 1U);
+    EXPECT_EQ(depths[JOB_PRIORITY_LOW], 1U);
+    EXPECT_EQ(depths[JOB_PRIORITY_HIGH], 0U);
+}
@@ -0,0 +1,93 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/tools/Selection.h"
+
+namespace {
+/// Plain even-odd test against all the edges
+auto referenceContains(const std::vector<Selection::BoundaryPoint>& polygon, double x, double y) -> bool {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const auto& a = polygon[j];
+        const auto& b = polygon[i];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/// A star-shaped lasso, with many vertices
+auto makeLasso(std::mt19937& gen, size_t n) -> std::unique_ptr<RegionSelect> {
+    std::uniform_real_distribution<double> radius(30, 100);
+    std::unique_ptr<RegionSelect> lasso;
+    for (size_t i = 0; i < n; i++) {
+        double angle = 2 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+        double r = radius(gen);
+        double x = 200 + r * std::cos(angle);
+        double y = 150 + r * std::sin(angle);
+        if (!lasso) {
+            lasso = std::make_unique<RegionSelect>(x, y);
+        } else {
+            lasso->currentPos(x, y);
+        }
+    }
+    return lasso;
+}
+}  // namespace
+
+TEST(ControlSelection, testLassoMatchesEvenOddRule) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coord(80, 320);
+
+    for (size_t n: {3, 10, 200, 3000}) {
+        auto lasso = makeLasso(gen, n);
+        const auto& polygon = lasso->getBoundary();
+        for (int i = 0; i < 20000; i++) {
+            double x = coord(gen);
+            double y = coord(gen) - 50;
+            ASSERT_EQ(lasso->contains(x, y), referenceContains(polygon, x, y))
+                    << n << " vertices, at " << x << ", " << y;
+        }
+        // The vertices themselves
+        for (const auto& p: polygon) {
+            EXPECT_EQ(lasso->contains(p.x, p.y), referenceContains(polygon, p.x, p.y));
+        }
+    }
+}
+
+TEST(ControlSelection, testLassoGrowing) {
+    RegionSelect lasso(0, 0);
+    lasso.currentPos(10, 0);
+    EXPECT_FALSE(lasso.contains(5, 0));
+    lasso.currentPos(10, 10);
+    EXPECT_TRUE(lasso.contains(8, 2));
+    EXPECT_FALSE(lasso.contains(2, 8));
+
+    // The grid is rebuilt when the lasso changes
+    lasso.currentPos(0, 10);
+    EXPECT_TRUE(lasso.contains(2, 8));
+    EXPECT_FALSE(lasso.contains(11, 5));
+}
+
+TEST(ControlSelection, testDegenerateLasso) {
+    RegionSelect lasso(0, 0);
+    lasso.currentPos(5, 5);
+    lasso.currentPos(10, 10);
+    EXPECT_FALSE(lasso.contains(5, 5));
+}
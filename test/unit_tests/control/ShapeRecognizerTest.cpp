@@ -0,0 +1,45 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "control/shaperecognizer/ShapeRecognizer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+
+namespace {
+auto makeLine() -> Stroke {
+    Stroke stroke;
+    for (int i = 0; i <= 100; i++) {
+        stroke.addPoint(Point(10.0 + 2.0 * i, 50.0 + 0.01 * i));
+    }
+    return stroke;
+}
+}  // namespace
+
+TEST(ShapeRecognizer, testLine) {
+    auto stroke = makeLine();
+    ShapeRecognizer reco;
+    auto recognized = reco.recognizePatterns(&stroke, 10);
+    ASSERT_TRUE(recognized);
+    ASSERT_EQ(recognized->getPointCount(), 2U);
+    // Nearly horizontal lines are straightened
+    EXPECT_DOUBLE_EQ(recognized->getPoint(0).y, recognized->getPoint(1).y);
+}
+
+TEST(ShapeRecognizer, testDeadline) {
+    auto stroke = makeLine();
+    ShapeRecognizer reco;
+    reco.setDeadline(std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+    EXPECT_FALSE(reco.recognizePatterns(&stroke, 10));
+}
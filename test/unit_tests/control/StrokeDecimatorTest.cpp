@@ -0,0 +1,102 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/tools/StrokeDecimator.h"
+
+namespace {
+/// The points kept in the stroke, as the StrokeHandler does
+auto decimate(StrokeDecimator& decimator, const std::vector<Point>& points) -> std::vector<Point> {
+    std::vector<Point> stroke{points.front()};
+    decimator.reset(points.front());
+    for (size_t i = 1; i < points.size(); i++) {
+        if (decimator.replacesLast(points[i])) {
+            stroke.back() = points[i];
+        } else {
+            stroke.push_back(points[i]);
+        }
+    }
+    return stroke;
+}
+}  // namespace
+
+TEST(ControlStrokeDecimator, testStraightLine) {
+    std::vector<Point> points;
+    for (int i = 0; i <= 40; i++) { points.emplace_back(i, 0.01 * (i % 2)); }
+
+    StrokeDecimator decimator(0.1);
+    auto stroke = decimate(decimator, points);
+    ASSERT_EQ(stroke.size(), 2U);
+    EXPECT_EQ(stroke.back().x, 40);
+}
+
+TEST(ControlStrokeDecimator, testCornerIsKept) {
+    std::vector<Point> points;
+    for (int i = 0; i <= 10; i++) { points.emplace_back(i, 0); }
+    for (int i = 1; i <= 10; i++) { points.emplace_back(10, i); }
+
+    StrokeDecimator decimator(0.1);
+    auto stroke = decimate(decimator, points);
+    ASSERT_EQ(stroke.size(), 3U);
+    EXPECT_EQ(stroke[1].x, 10);
+    EXPECT_EQ(stroke[1].y, 0);
+    EXPECT_EQ(stroke[2].y, 10);
+}
+
+TEST(ControlStrokeDecimator, testBoundedError) {
+    // A circle of radius 50, sampled every degree
+    std::vector<Point> points;
+    for (int i = 0; i <= 360; i++) {
+        const double a = i * M_PI / 180;
+        points.emplace_back(50 * std::cos(a), 50 * std::sin(a));
+    }
+    const double maxError = 0.2;
+    StrokeDecimator decimator(maxError);
+    auto stroke = decimate(decimator, points);
+    EXPECT_LT(stroke.size(), points.size() / 3);
+
+    // Every sample is within the error of the kept polyline
+    for (const Point& p: points) {
+        double distance = INFINITY;
+        for (size_t i = 0; i + 1 < stroke.size(); i++) {
+            const Point& a = stroke[i];
+            const Point& b = stroke[i + 1];
+            const double dx = b.x - a.x;
+            const double dy = b.y - a.y;
+            const double t = std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / (dx * dx + dy * dy), 0.0, 1.0);
+            distance = std::min(distance, std::hypot(p.x - a.x - t * dx, p.y - a.y - t * dy));
+        }
+        EXPECT_LE(distance, maxError + 1e-9);
+    }
+}
+
+TEST(ControlStrokeDecimator, testPressureExtremaAreKept) {
+    // A straight line, with the width going up to 3 and back down
+    std::vector<Point> points;
+    for (int i = 0; i <= 20; i++) { points.emplace_back(i, 0, 3 - std::abs(i - 10) * 0.2); }
+
+    StrokeDecimator decimator(0.1);
+    auto stroke = decimate(decimator, points);
+    EXPECT_GT(stroke.size(), 2U);
+    bool hasMaximum = false;
+    for (const Point& p: stroke) { hasMaximum |= p.z == 3; }
+    EXPECT_TRUE(hasMaximum);
+
+    // A constant width is decimated as without pressure
+    points.clear();
+    for (int i = 0; i <= 20; i++) { points.emplace_back(i, 0, 1.5); }
+    EXPECT_EQ(decimate(decimator, points).size(), 2U);
+}
@@ -0,0 +1,103 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "control/ThumbnailCache.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/raii/CairoWrappers.h"
+
+#include "filesystem.h"
+
+namespace {
+class ThumbnailCacheTest: public ::testing::Test {
+protected:
+    void SetUp() override {
+        folder = fs::temp_directory_path() / "xournalpp-thumbnail-test";
+        fs::remove_all(folder);
+    }
+    void TearDown() override { fs::remove_all(folder); }
+
+    fs::path folder;
+};
+
+auto createThumbnail(int width, int height) -> xoj::util::CairoSurfaceSPtr {
+    xoj::util::CairoSurfaceSPtr surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height),
+                                        xoj::util::adopt);
+    cairo_t* cr = cairo_create(surface.get());
+    cairo_set_source_rgb(cr, 1, 0, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+}
+}  // namespace
+
+TEST_F(ThumbnailCacheTest, testStoreAndLoad) {
+    ThumbnailCache cache(folder);
+    const fs::path file = "/tmp/document.xopp";
+    auto thumbnail = createThumbnail(20, 30);
+    cache.store(file, 3, 42, thumbnail.get());
+
+    auto loaded = cache.load(file, 3, 42, 20, 30);
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(cairo_image_surface_get_width(loaded.get()), 20);
+    EXPECT_EQ(cairo_image_surface_get_height(loaded.get()), 30);
+
+    // Only the thumbnail of the same content, page and size is used
+    EXPECT_FALSE(cache.load(file, 3, 43, 20, 30));
+    EXPECT_FALSE(cache.load(file, 2, 42, 20, 30));
+    EXPECT_FALSE(cache.load(file, 3, 42, 40, 60));
+    EXPECT_FALSE(cache.load("/tmp/other.xopp", 3, 42, 20, 30));
+
+    cache.store(file, 3, 43, thumbnail.get());
+    EXPECT_FALSE(cache.load(file, 3, 42, 20, 30));
+    EXPECT_TRUE(cache.load(file, 3, 43, 20, 30));
+}
+
+TEST_F(ThumbnailCacheTest, testOldDocumentsRemoved) {
+    ThumbnailCache cache(folder);
+    auto thumbnail = createThumbnail(4, 4);
+    for (size_t i = 0; i <= ThumbnailCache::MAX_DOCUMENTS; i++) {
+        cache.store("/tmp/document" + std::to_string(i) + ".xopp", 0, 1, thumbnail.get());
+    }
+
+    size_t count = 0;
+    for ([[maybe_unused]] const auto& f: fs::directory_iterator(folder)) {
+        count++;
+    }
+    EXPECT_EQ(count, ThumbnailCache::MAX_DOCUMENTS);
+}
+
+TEST(ThumbnailCache, testPageHash) {
+    XojPage page(100, 200);
+    const auto emptyHash = ThumbnailCache::hashPage(page, "");
+    EXPECT_EQ(ThumbnailCache::hashPage(page, ""), emptyHash);
+
+    auto stroke = std::make_unique<Stroke>();
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(20, 20));
+    Stroke* s = stroke.get();
+    (*page.getLayers())[0]->addElement(std::move(stroke));
+    const auto strokeHash = ThumbnailCache::hashPage(page, "");
+    EXPECT_NE(strokeHash, emptyHash);
+
+    s->move(1, 0);
+    EXPECT_NE(ThumbnailCache::hashPage(page, ""), strokeHash);
+
+    XojPage other(100, 300);
+    EXPECT_NE(ThumbnailCache::hashPage(other, ""), emptyHash);
+}
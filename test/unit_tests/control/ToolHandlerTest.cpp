@@ -0,0 +1,92 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "control/ToolEnums.h"
+#include "control/ToolHandler.h"
+#include "util/Color.h"
+
+namespace {
+struct CountingListener: public ToolListener {
+    void toolColorChanged() override { color++; }
+    void changeColorOfSelection() override { selection++; }
+    void toolSizeChanged() override { size++; }
+    void toolFillChanged() override { fill++; }
+    void toolLineStyleChanged() override { lineStyle++; }
+    void toolChanged() override { tool++; }
+
+    int color = 0;
+    int selection = 0;
+    int size = 0;
+    int fill = 0;
+    int lineStyle = 0;
+    int tool = 0;
+};
+}  // namespace
+
+TEST(ToolHandlerTest, testNotificationsWithoutBatch) {
+    CountingListener listener;
+    ToolHandler handler(&listener, nullptr, nullptr);
+
+    handler.setSize(TOOL_SIZE_THICK);
+    handler.setSize(TOOL_SIZE_FINE);
+    handler.setColor(Colors::red, true);
+
+    EXPECT_EQ(listener.size, 2);
+    EXPECT_EQ(listener.color, 1);
+    EXPECT_EQ(listener.selection, 1);
+    EXPECT_EQ(listener.tool, 0);
+}
+
+TEST(ToolHandlerTest, testBatchMergesNotifications) {
+    CountingListener listener;
+    ToolHandler handler(&listener, nullptr, nullptr);
+    {
+        ToolHandler::ChangeBatch batch(handler);
+        handler.setSize(TOOL_SIZE_THICK);
+        handler.setSize(TOOL_SIZE_FINE);
+        handler.setColor(Colors::red, true);
+        {
+            ToolHandler::ChangeBatch nested(handler);
+            handler.setFillEnabled(true);
+        }
+        // Not before the outermost batch ends, but the selection is edited right away
+        EXPECT_EQ(listener.size, 0);
+        EXPECT_EQ(listener.color, 0);
+        EXPECT_EQ(listener.fill, 0);
+        EXPECT_EQ(listener.selection, 1);
+    }
+    EXPECT_EQ(listener.size, 1);
+    EXPECT_EQ(listener.color, 1);
+    EXPECT_EQ(listener.fill, 1);
+    EXPECT_EQ(listener.tool, 0);
+}
+
+TEST(ToolHandlerTest, testToolChangeIsSentAlone) {
+    CountingListener listener;
+    ToolHandler handler(&listener, nullptr, nullptr);
+    ToolType notifiedType = TOOL_NONE;
+    handler.addToolChangedListener([&](ToolType type) { notifiedType = type; });
+    {
+        ToolHandler::ChangeBatch batch(handler);
+        handler.selectTool(TOOL_HIGHLIGHTER);
+        handler.setSize(TOOL_SIZE_THICK);
+        handler.setColor(Colors::yellow, false);
+        handler.fireToolChanged();
+        handler.selectTool(TOOL_PEN);
+        handler.fireToolChanged();
+    }
+    EXPECT_EQ(listener.tool, 1);
+    EXPECT_EQ(listener.size, 0);
+    EXPECT_EQ(listener.color, 0);
+    EXPECT_EQ(notifiedType, TOOL_PEN);
+}
@@ -0,0 +1,70 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "undo/DeleteUndoAction.h"
+#include "undo/UndoSpillFile.h"
+
+TEST(UndoSpill, testSpillFile) {
+    UndoSpillFile file;
+    auto first = file.write("abc", 3);
+    auto second = file.write("defgh", 5);
+    ASSERT_TRUE(first && second);
+
+    std::string data;
+    ASSERT_TRUE(file.read(*second, data));
+    EXPECT_EQ(data, "defgh");
+    ASSERT_TRUE(file.read(*first, data));
+    EXPECT_EQ(data, "abc");
+
+    EXPECT_FALSE(file.read({6, 5}, data));
+}
+
+TEST(UndoSpill, testSpillDeletedStrokes) {
+    const std::vector<Point> points{{10.0, 20.0, 0.5}, {30.0, 15.0, 1.0}, {25.0, 40.0, Point::NO_PRESSURE}};
+    auto stroke = std::make_unique<Stroke>();
+    stroke->setWidth(2.0);
+    stroke->setPointVector(points);
+    Stroke* s = stroke.get();
+    const double x = s->getX();
+    const double width = s->getElementWidth();
+
+    Layer layer;
+    DeleteUndoAction action(nullptr, false);
+    action.addElement(&layer, std::move(stroke), 0);
+    EXPECT_EQ(action.getSpillableSize(), points.size() * sizeof(Point));
+
+    UndoSpillFile file;
+    ASSERT_TRUE(action.spill(file));
+    EXPECT_TRUE(action.isSpilled());
+    EXPECT_EQ(action.getSpillableSize(), 0U);
+    EXPECT_EQ(s->getPointCount(), 0U);
+    // The bounds are kept while the points are spilled
+    EXPECT_DOUBLE_EQ(s->getX(), x);
+    EXPECT_DOUBLE_EQ(s->getElementWidth(), width);
+
+    action.restore(file);
+    EXPECT_FALSE(action.isSpilled());
+    ASSERT_EQ(s->getPointCount(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_DOUBLE_EQ(s->getPoint(i).x, points[i].x);
+        EXPECT_DOUBLE_EQ(s->getPoint(i).y, points[i].y);
+        EXPECT_DOUBLE_EQ(s->getPoint(i).z, points[i].z);
+    }
+}
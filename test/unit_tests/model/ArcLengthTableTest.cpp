@@ -0,0 +1,50 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "model/ArcLengthTable.h"
+#include "model/PathParameter.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+
+TEST(ArcLengthTable, testLengths) {
+    ArcLengthTable table({Point(0, 0), Point(3, 4), Point(3, 4), Point(3, 10)});
+    EXPECT_DOUBLE_EQ(table.getLength(0), 0.0);
+    EXPECT_DOUBLE_EQ(table.getLength(1), 5.0);
+    EXPECT_DOUBLE_EQ(table.getLength(2), 5.0);
+    EXPECT_DOUBLE_EQ(table.getLength(3), 11.0);
+    EXPECT_DOUBLE_EQ(table.getTotalLength(), 11.0);
+
+    EXPECT_DOUBLE_EQ(table.getLength(PathParameter(0, 0.2)), 1.0);
+    EXPECT_DOUBLE_EQ(table.getLength(PathParameter(2, 0.5)), 8.0);
+    EXPECT_DOUBLE_EQ(table.getLength(PathParameter(3, 0.0)), 11.0);
+
+    EXPECT_DOUBLE_EQ(ArcLengthTable({}).getTotalLength(), 0.0);
+}
+
+TEST(ArcLengthTable, testStrokeLengths) {
+    Stroke stroke;
+    stroke.addPoint(Point(0, 0));
+    stroke.addPoint(Point(10, 0));
+    EXPECT_DOUBLE_EQ(stroke.getArcLengthTable().getTotalLength(), 10.0);
+
+    // Shared by the clones
+    auto clone = stroke.cloneStroke();
+    EXPECT_EQ(&clone->getArcLengthTable(), &stroke.getArcLengthTable());
+
+    // And computed again once the points are modified
+    stroke.addPoint(Point(10, 5));
+    EXPECT_DOUBLE_EQ(stroke.getArcLengthTable().getTotalLength(), 15.0);
+    EXPECT_DOUBLE_EQ(clone->getArcLengthTable().getTotalLength(), 10.0);
+    stroke.scale(0, 0, 2, 2, 0, false);
+    EXPECT_DOUBLE_EQ(stroke.getArcLengthTable().getTotalLength(), 30.0);
+}
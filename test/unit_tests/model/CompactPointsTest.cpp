@@ -0,0 +1,79 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/CompactPoints.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+
+namespace {
+void expectNear(const std::vector<Point>& expected, const std::vector<Point>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_NEAR(expected[i].x, actual[i].x, 1e-4);
+        EXPECT_NEAR(expected[i].y, actual[i].y, 1e-4);
+        EXPECT_NEAR(expected[i].z, actual[i].z, 1e-4);
+    }
+}
+}  // namespace
+
+TEST(CompactPoints, testExpand) {
+    std::vector<Point> points{{10.123456789, 20.5}, {567.891234, 800.000001}, {0.0, 1e-3}};
+    CompactPoints compact(points);
+    EXPECT_EQ(compact.size(), 3U);
+    EXPECT_FALSE(compact.hasPressure());
+    expectNear(points, compact.expand());
+    EXPECT_EQ(compact.expand()[0].z, Point::NO_PRESSURE);
+
+    std::vector<Point> withPressure{{1.0, 2.0, 0.5}, {3.0, 4.0, 1.25}, {5.0, 6.0, Point::NO_PRESSURE}};
+    CompactPoints compactWithPressure(withPressure);
+    EXPECT_TRUE(compactWithPressure.hasPressure());
+    expectNear(withPressure, compactWithPressure.expand());
+}
+
+TEST(CompactPoints, testStroke) {
+    Stroke stroke;
+    stroke.setWidth(2.0);
+    std::vector<Point> points{{10.1, 20.2, 0.8}, {30.3, 40.4, 1.2}, {50.5, 60.6, Point::NO_PRESSURE}};
+    stroke.setPointVector(points);
+    const double boundsWidth = stroke.getElementWidth();
+
+    EXPECT_TRUE(stroke.compact());
+    EXPECT_TRUE(stroke.isCompacted());
+    EXPECT_EQ(stroke.getPointCount(), 3U);
+    EXPECT_TRUE(stroke.hasPressure());
+    EXPECT_DOUBLE_EQ(stroke.getElementWidth(), boundsWidth);
+
+    // The clones share the compacted points
+    auto clone = stroke.cloneStroke();
+    EXPECT_TRUE(clone->isCompacted());
+
+    // The points are expanded when they are read
+    expectNear(points, stroke.getPointVector());
+    EXPECT_FALSE(stroke.isCompacted());
+    EXPECT_TRUE(stroke.compact());
+    EXPECT_TRUE(stroke.isCompacted());
+
+    // and the modifications are kept
+    stroke.move(1.0, 2.0);
+    EXPECT_FALSE(stroke.isCompacted());
+    EXPECT_NEAR(stroke.getPoint(0).x, 11.1, 1e-4);
+    EXPECT_TRUE(stroke.compact());
+    EXPECT_NEAR(stroke.getPoint(2).y, 62.6, 1e-4);
+    EXPECT_NEAR(clone->getPoint(2).y, 60.6, 1e-4);
+
+    Stroke empty;
+    EXPECT_FALSE(empty.compact());
+}
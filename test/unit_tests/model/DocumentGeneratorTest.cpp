@@ -0,0 +1,101 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Element.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "DocumentGenerator.h"
+
+namespace {
+auto firstStrokePoints(Document* doc, size_t page) -> std::vector<Point> {
+    for (auto const& e: doc->getPage(page)->getSelectedLayer()->getElements()) {
+        if (e->getType() == ELEMENT_STROKE) {
+            return dynamic_cast<Stroke*>(e.get())->getPointVector();
+        }
+    }
+    return {};
+}
+
+auto countTypes(Document* doc) -> std::map<ElementType, size_t> {
+    std::map<ElementType, size_t> counts;
+    for (size_t i = 0; i < doc->getPageCount(); i++) {
+        for (auto const& e: doc->getPage(i)->getSelectedLayer()->getElements()) { counts[e->getType()]++; }
+    }
+    return counts;
+}
+}  // namespace
+
+TEST(DocumentGenerator, testCounts) {
+    DocumentGenerator::Options options;
+    options.pages = 3;
+    options.strokesPerPage = 20;
+    options.pointsPerStroke = 15;
+    options.textsPerPage = 2;
+    options.imagesPerPage = 1;
+
+    DocumentHandler handler;
+    auto doc = DocumentGenerator(options).generate(&handler);
+    ASSERT_NE(doc, nullptr);
+    ASSERT_EQ(doc->getPageCount(), 3U);
+
+    auto counts = countTypes(doc.get());
+    EXPECT_EQ(counts[ELEMENT_STROKE], 60U);
+    EXPECT_EQ(counts[ELEMENT_TEXT], 6U);
+    EXPECT_EQ(counts[ELEMENT_IMAGE], 3U);
+    EXPECT_EQ(firstStrokePoints(doc.get(), 2).size(), 15U);
+}
+
+TEST(DocumentGenerator, testSeed) {
+    DocumentGenerator::Options options;
+    options.pages = 2;
+    options.strokesPerPage = 5;
+    options.pointsPerStroke = 10;
+
+    DocumentHandler handler;
+    auto a = DocumentGenerator(options).generate(&handler);
+    auto b = DocumentGenerator(options).generate(&handler);
+    options.seed = 2;
+    auto c = DocumentGenerator(options).generate(&handler);
+
+    auto pointsA = firstStrokePoints(a.get(), 1);
+    auto pointsB = firstStrokePoints(b.get(), 1);
+    auto pointsC = firstStrokePoints(c.get(), 1);
+    ASSERT_EQ(pointsA.size(), 10U);
+    ASSERT_EQ(pointsC.size(), 10U);
+    for (size_t i = 0; i < pointsA.size(); i++) {
+        EXPECT_DOUBLE_EQ(pointsA[i].x, pointsB[i].x);
+        EXPECT_DOUBLE_EQ(pointsA[i].y, pointsB[i].y);
+        EXPECT_DOUBLE_EQ(pointsA[i].z, pointsB[i].z);
+    }
+    EXPECT_NE(pointsA[0].x, pointsC[0].x);
+}
+
+TEST(DocumentGenerator, testNoPressure) {
+    DocumentGenerator::Options options;
+    options.pages = 1;
+    options.strokesPerPage = 1;
+    options.pointsPerStroke = 10;
+    options.pressure = false;
+
+    DocumentHandler handler;
+    auto doc = DocumentGenerator(options).generate(&handler);
+    for (auto const& p: firstStrokePoints(doc.get(), 0)) { EXPECT_EQ(p.z, Point::NO_PRESSURE); }
+}
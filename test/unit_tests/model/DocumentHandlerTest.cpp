@@ -0,0 +1,85 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/DocumentHandler.h"
+#include "model/DocumentListener.h"
+
+namespace {
+class RecordingListener: public DocumentListener {
+public:
+    explicit RecordingListener(DocumentHandler* handler) { registerListener(handler); }
+
+    void documentChanged(DocumentChangeType type) override {
+        events.push_back(type == DOCUMENT_CHANGE_PAGES ? "pages" : "document");
+    }
+    void pageSizeChanged(size_t page) override { events.push_back("size " + std::to_string(page)); }
+    void pageChanged(size_t page) override { events.push_back("page " + std::to_string(page)); }
+    void pageInserted(size_t page) override { events.push_back("inserted " + std::to_string(page)); }
+
+    std::vector<std::string> events;
+};
+}  // namespace
+
+TEST(DocumentHandler, testPageChangesOfSeveralPages) {
+    DocumentHandler handler;
+    RecordingListener listener(&handler);
+    {
+        PageChangesGuard guard(&handler);
+        for (size_t p = 0; p < 1000; p++) {
+            handler.firePageSizeChanged(p);
+            handler.firePageChanged(p);
+        }
+        EXPECT_TRUE(listener.events.empty());
+    }
+    EXPECT_EQ(listener.events, std::vector<std::string>{"pages"});
+}
+
+TEST(DocumentHandler, testPageChangesOfOnePage) {
+    DocumentHandler handler;
+    RecordingListener listener(&handler);
+    {
+        PageChangesGuard guard(&handler);
+        {
+            // Nested: the events are sent at the end of the outermost
+            PageChangesGuard inner(&handler);
+            handler.firePageChanged(3);
+        }
+        handler.firePageSizeChanged(3);
+        EXPECT_TRUE(listener.events.empty());
+    }
+    EXPECT_EQ(listener.events, (std::vector<std::string>{"size 3", "page 3"}));
+
+    listener.events.clear();
+    { PageChangesGuard guard(&handler); }
+    EXPECT_TRUE(listener.events.empty());
+}
+
+TEST(DocumentHandler, testPageChangesWithInsertion) {
+    DocumentHandler handler;
+    RecordingListener listener(&handler);
+    {
+        PageChangesGuard guard(&handler);
+        handler.firePageChanged(2);
+        // The page 2 is now the page 3: its index is not sent any more
+        handler.firePageInserted(0);
+    }
+    EXPECT_EQ(listener.events, (std::vector<std::string>{"inserted 0", "pages"}));
+
+    // Out of a batch, the events are sent right away
+    listener.events.clear();
+    handler.firePageChanged(1);
+    EXPECT_EQ(listener.events, std::vector<std::string>{"page 1"});
+}
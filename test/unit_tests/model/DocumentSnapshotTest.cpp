@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+namespace {
+void addStroke(const PageRef& page) {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->addPoint(Point(10, 10));
+    stroke->addPoint(Point(20, 20));
+    (*page->getLayers())[0]->addElement(std::move(stroke));
+}
+
+size_t countElements(const PageRef& page) { return (*page->getLayers())[0]->getElements().size(); }
+}  // namespace
+
+TEST(DocumentSnapshot, testCopy) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    doc.setFilepath("/tmp/snapshot.xopp");
+    for (int i = 0; i < 3; i++) {
+        auto page = std::make_shared<XojPage>(100, 200);
+        page->setBackgroundName("background");
+        addStroke(page);
+        doc.addPage(page);
+    }
+
+    DocumentHandler snapshotHandler;
+    doc.lock();
+    auto snapshot = doc.createSnapshot(&snapshotHandler);
+    doc.unlock();
+
+    ASSERT_EQ(snapshot->getPageCount(), 3U);
+    EXPECT_EQ(snapshot->getFilepath(), doc.getFilepath());
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_NE(snapshot->getPage(i), doc.getPage(i));
+        EXPECT_EQ(snapshot->getPage(i)->getBackgroundName(), "background");
+        EXPECT_EQ(snapshot->getPage(i)->getWidth(), 100);
+    }
+
+    // The snapshot does not see the changes
+    addStroke(doc.getPage(1));
+    doc.deletePage(0);
+    EXPECT_EQ(countElements(doc.getPage(0)), 2U);
+    ASSERT_EQ(snapshot->getPageCount(), 3U);
+    EXPECT_EQ(countElements(snapshot->getPage(1)), 1U);
+}
+
+TEST(DocumentSnapshot, testPartialCopy) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    for (int i = 0; i < 3; i++) { doc.addPage(std::make_shared<XojPage>(100, 200)); }
+
+    DocumentHandler snapshotHandler;
+    doc.lock();
+    auto snapshot = doc.createSnapshot(&snapshotHandler, std::vector<size_t>{1});
+    doc.unlock();
+
+    ASSERT_EQ(snapshot->getPageCount(), 3U);
+    EXPECT_EQ(snapshot->getPage(0), doc.getPage(0));
+    EXPECT_NE(snapshot->getPage(1), doc.getPage(1));
+    EXPECT_EQ(snapshot->getPage(2), doc.getPage(2));
+}
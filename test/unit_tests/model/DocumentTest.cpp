@@ -0,0 +1,100 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/Util.h"
+
+namespace {
+void expectConsistentIndex(const Document& doc) {
+    for (size_t i = 0; i < doc.getPageCount(); i++) { EXPECT_EQ(doc.indexOf(doc.getPage(i)), i); }
+}
+}  // namespace
+
+TEST(Document, testIndexOf) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 10; i++) { pages.push_back(std::make_shared<XojPage>(100, 100)); }
+
+    doc.addPages(pages.begin(), pages.begin() + 5);
+    doc.addPage(pages[5]);
+    doc.insertPage(pages[6], 2);
+    doc.insertPages(pages.begin() + 7, pages.end(), 1);
+    ASSERT_EQ(doc.getPageCount(), 10U);
+    EXPECT_EQ(doc.indexOf(pages[7]), 1U);
+    EXPECT_EQ(doc.indexOf(pages[6]), 5U);
+    EXPECT_EQ(doc.indexOf(pages[0]), 0U);
+    expectConsistentIndex(doc);
+
+    doc.deletePages(3, 4);
+    ASSERT_EQ(doc.getPageCount(), 6U);
+    EXPECT_EQ(doc.indexOf(pages[6]), npos);
+    EXPECT_EQ(doc.indexOf(pages[2]), 3U);
+    expectConsistentIndex(doc);
+
+    doc.deletePage(0);
+    EXPECT_EQ(doc.indexOf(pages[0]), npos);
+    expectConsistentIndex(doc);
+
+    // The snapshots have their own pages
+    doc.lock();
+    auto snapshot = doc.createSnapshot(&handler);
+    doc.unlock();
+    expectConsistentIndex(*snapshot);
+    EXPECT_EQ(snapshot->indexOf(doc.getPage(0)), npos);
+
+    EXPECT_EQ(doc.indexOf(nullptr), npos);
+}
+
+TEST(Document, testRevision) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 3; i++) { pages.push_back(std::make_shared<XojPage>(100, 100)); }
+    doc.addPages(pages.begin(), pages.end());
+
+    auto revision = doc.getRevision();
+    auto pageRevision = pages[1]->getRevision();
+    EXPECT_EQ(doc.getRevision(), revision);
+    EXPECT_EQ(pages[1]->getRevision(), pageRevision);
+
+    // Only the changed page gets another revision
+    auto otherRevision = pages[2]->getRevision();
+    pages[1]->setBackgroundColor(Colors::black);
+    EXPECT_GT(pages[1]->getRevision(), pageRevision);
+    EXPECT_EQ(pages[2]->getRevision(), otherRevision);
+    EXPECT_GT(doc.getRevision(), revision);
+
+    pageRevision = pages[1]->getRevision();
+    pages[1]->getSelectedLayer()->addElement(std::make_unique<Stroke>());
+    EXPECT_GT(pages[1]->getRevision(), pageRevision);
+
+    pageRevision = pages[1]->getRevision();
+    pages[1]->getSelectedLayer()->setName("Renamed");
+    EXPECT_GT(pages[1]->getRevision(), pageRevision);
+
+    // The revision of the document keeps increasing when changed pages are removed and inserted again
+    revision = doc.getRevision();
+    doc.deletePage(1);
+    EXPECT_GT(doc.getRevision(), revision);
+    revision = doc.getRevision();
+    doc.insertPage(pages[1], 1);
+    EXPECT_GT(doc.getRevision(), revision);
+}
@@ -27,8 +27,7 @@ TEST(ErasableStroke, testOverlapTree) {
     // clang format on
 
     Stroke stroke;
-    std::vector<Point>& strokePoints = const_cast<std::vector<Point>&>(stroke.getPointVector());
-    strokePoints.swap(testPath);
+    stroke.setPointVector(std::move(testPath));
 
     stroke.setWidth(2);
     stroke.setFill(-1);
@@ -151,8 +150,10 @@ TEST(ErasableStroke, testGetStrokes) {
         Range range(0, 0);
         erasable.beginErasure(fakeIntersections[i], range);
         ASSERT_EQ(erasable.isClosedStroke(), areClosed[i]);
-        auto res = erasable.getStrokes();
+        std::vector<ErasableStroke::IndexRanges> copiedPoints;
+        auto res = erasable.getStrokes(&copiedPoints);
         ASSERT_EQ(res.size(), resultingPaths[i].size());
+        ASSERT_EQ(copiedPoints.size(), res.size());
         for (unsigned int j = 0; j < res.size(); ++j) {
             ASSERT_EQ(res[j]->getWidth(), strokes[i].getWidth());
             ASSERT_EQ(res[j]->getFill(), strokes[i].getFill());
@@ -166,6 +167,17 @@ TEST(ErasableStroke, testGetStrokes) {
                 ASSERT_EQ(pts1[k].y, pts2[k].y);
                 ASSERT_EQ(pts1[k].z, pts2[k].z);
             }
+
+            // The points in between the first and the last ones are those of the original stroke
+            size_t k = 1;
+            for (auto [first, last]: copiedPoints[j]) {
+                for (size_t n = first; n < last; ++n, ++k) {
+                    ASSERT_LT(k, pts1.size() - 1);
+                    ASSERT_EQ(pts1[k].x, strokes[i].getPoint(n).x);
+                    ASSERT_EQ(pts1[k].y, strokes[i].getPoint(n).y);
+                }
+            }
+            ASSERT_EQ(k, pts1.size() - 1);
         }
         ++i;
     }
@@ -235,3 +247,106 @@ TEST(ErasableStroke, testIntersectWithPaddedBox) {
         }
     }
 }
+
+TEST(ErasableStroke, testFindErasedSections) {
+    Stroke stroke;
+    stroke.setPointVector({{0, 0}, {2, 2}, {5, 2}, {7, 4}, {3, 6}, {2, 8}, {5, 11}, {7, 10}});
+    stroke.setWidth(1);
+    stroke.setFill(-1);
+    stroke.setToolType(StrokeTool::HIGHLIGHTER);
+
+    ErasableStroke erasable(stroke);
+    ErasableStroke reference(stroke);
+    const PaddedBox first{Point(1, 1), 0.5, 1};
+    Range range(1, 1);
+    erasable.beginErasure(stroke.intersectWithPaddedBox(first), range);
+    reference.beginErasure(stroke.intersectWithPaddedBox(first), range);
+
+    // Finding the sections does not erase them
+    const PaddedBox box{Point(3, 6), 0.5, 1};
+    auto sections = erasable.findErasedSections(box);
+    EXPECT_FALSE(sections.empty());
+    EXPECT_EQ(erasable.getRemainingSubSectionsVector(), reference.getRemainingSubSectionsVector());
+
+    Range range1(3, 6);
+    Range range2(3, 6);
+    erasable.erase(std::move(sections), range1);
+    reference.erase(box, range2);
+    EXPECT_EQ(erasable.getRemainingSubSectionsVector(), reference.getRemainingSubSectionsVector());
+    EXPECT_EQ(erasable.getRemainingSubSectionsVector().size(), 2U);
+    assertRangesEq(range1, range2);
+}
+
+TEST(ErasableStroke, testDirtyMaskRange) {
+    Stroke stroke;
+    stroke.setPointVector({{0, 0}, {2, 2}, {5, 2}, {7, 4}, {3, 6}, {2, 8}, {5, 11}, {7, 10}});
+    stroke.setWidth(1);
+    stroke.setFill(-1);
+    stroke.setToolType(StrokeTool::PEN);
+
+    ErasableStroke erasable(stroke);
+    Range range(20, 20);
+    erasable.beginErasure({}, range);
+    EXPECT_TRUE(erasable.linesMask.dirtyRange.empty());
+
+    // Only the erased part of the stroke is out of date, not the rest of the range to rerender
+    const PaddedBox box{Point(3, 6), 0.5, 1};
+    erasable.erase(box, range);
+    const Range& dirty = erasable.linesMask.dirtyRange;
+    EXPECT_FALSE(dirty.empty());
+    EXPECT_TRUE(dirty.contains(3, 6));
+    EXPECT_FALSE(dirty.contains(20, 20));
+    EXPECT_TRUE(range.contains(3, 6));
+    assertRangesEq(erasable.fillingMask.dirtyRange, dirty);
+
+    // Nothing to erase there
+    erasable.linesMask.dirtyRange = Range();
+    erasable.erase(PaddedBox{Point(20, 20), 0.5, 1}, range);
+    EXPECT_TRUE(erasable.linesMask.dirtyRange.empty());
+}
+
+namespace {
+class OverlapTester: public ErasableStroke {
+public:
+    using ErasableStroke::addOverlapsToRange;
+    using ErasableStroke::ErasableStroke;
+};
+}  // namespace
+
+TEST(ErasableStroke, testOverlapsOfLongStroke) {
+    // Hatching: each segment crosses many others
+    std::vector<Point> points;
+    for (int i = 0; i < 300; i++) {
+        points.emplace_back(i % 2 ? 100.0 : 0.0, 0.5 * i + (i % 3));
+    }
+    Stroke stroke;
+    stroke.setPointVector(points);
+    stroke.setWidth(4);
+    stroke.setFill(-1);
+    stroke.setToolType(StrokeTool::HIGHLIGHTER);
+    ASSERT_NE(stroke.getSegmentTree(), nullptr);
+
+    const std::vector<ErasableStroke::SubSection> subsections = {
+            {{0, 0.0}, {99, 0.5}}, {{100, 0.25}, {199, 1.0}}, {{200, 0.0}, {250, 0.0}}, {{251, 0.5}, {298, 0.75}}};
+
+    // Compare with the per-subsection trees
+    Range expected;
+    for (size_t i = 0; i < subsections.size(); i++) {
+        for (size_t j = i + 1; j < subsections.size(); j++) {
+            ErasableStroke::OverlapTree tree1;
+            ErasableStroke::OverlapTree tree2;
+            tree1.populate(subsections[i], stroke);
+            tree2.populate(subsections[j], stroke);
+            tree1.addOverlapsToRange(tree2, 2.0, expected);
+        }
+    }
+    ASSERT_TRUE(expected.isValid());
+
+    OverlapTester erasable(stroke);
+    Range range;
+    erasable.addOverlapsToRange(subsections, range);
+    EXPECT_NEAR(range.minX, expected.minX, 1e-9);
+    EXPECT_NEAR(range.minY, expected.minY, 1e-9);
+    EXPECT_NEAR(range.maxX, expected.maxX, 1e-9);
+    EXPECT_NEAR(range.maxY, expected.maxY, 1e-9);
+}
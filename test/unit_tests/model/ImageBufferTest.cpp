@@ -0,0 +1,93 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "model/Image.h"
+#include "model/ImageBuffer.h"
+
+TEST(ImageBuffer, testSharedData) {
+    auto buffer = ImageBuffer::get(std::string("image data"));
+    EXPECT_EQ(buffer->getData(), "image data");
+    EXPECT_EQ(ImageBuffer::get(std::string("image data")), buffer);
+    EXPECT_NE(ImageBuffer::get(std::string("other data")), buffer);
+
+    // The data of the released buffers is not kept
+    std::weak_ptr<const ImageBuffer> released = ImageBuffer::get(std::string("released data"));
+    EXPECT_TRUE(released.expired());
+    auto buffer2 = ImageBuffer::get(std::string("released data"));
+    EXPECT_EQ(buffer2->getData(), "released data");
+    EXPECT_EQ(buffer2.use_count(), 1);
+}
+
+TEST(ImageBuffer, testSharedSurface) {
+    std::ifstream imageFile{GET_TESTFILE("images/r90.jpg"), std::ios::binary};
+    auto imageData = std::string(std::istreambuf_iterator<char>(imageFile), {});
+
+    Image image;
+    image.setImage(imageData);
+    Image copy;
+    copy.setImage(imageData);
+    auto clone = image.clone();
+
+    EXPECT_EQ(image.getBuffer(), copy.getBuffer());
+    EXPECT_EQ(image.getBuffer(), dynamic_cast<Image*>(clone.get())->getBuffer());
+    EXPECT_FALSE(image.getBuffer()->isPng());
+
+    // The image is rendered once
+    EXPECT_EQ(image.getImage().get(), copy.getImage().get());
+    EXPECT_EQ(copy.getImageSize(), std::make_pair(130, 500));
+}
+
+TEST(ImageBuffer, testDownscaledSurfaces) {
+    std::ifstream imageFile{GET_TESTFILE("images/r90.jpg"), std::ios::binary};
+    auto buffer = ImageBuffer::get(std::string(std::istreambuf_iterator<char>(imageFile), {}));
+
+    // The smallest version halving the 130x500 image that is still large enough
+    auto small = buffer->getSurface(20, 100);
+    ASSERT_TRUE(small);
+    EXPECT_EQ(cairo_image_surface_get_width(small.get()), 33);
+    EXPECT_EQ(cairo_image_surface_get_height(small.get()), 125);
+    EXPECT_EQ(buffer->getSurface(30, 120).get(), small.get());
+
+    auto full = buffer->getSurface();
+    EXPECT_EQ(cairo_image_surface_get_width(full.get()), 130);
+    EXPECT_EQ(buffer->getSurface(130, 400).get(), full.get());
+    EXPECT_EQ(buffer->getSurfaceSize(), std::make_pair(130, 500));
+}
+
+TEST(ImageBuffer, testRasters) {
+    auto buffer = ImageBuffer::get(std::string("raster data"));
+    int renders = 0;
+    auto render = [&renders]() {
+        renders++;
+        return xoj::util::CairoSurfaceSPtr(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 10, 10),
+                                           xoj::util::adopt);
+    };
+
+    // Rendered once, then taken from the cache, which counts it in its budget
+    const size_t surfaces = ImageBuffer::getMemoryUsage().surfaces;
+    auto raster = buffer->getRaster(2, render);
+    ASSERT_TRUE(raster);
+    EXPECT_EQ(buffer->getRaster(2, render).get(), raster.get());
+    EXPECT_EQ(renders, 1);
+    EXPECT_EQ(ImageBuffer::getMemoryUsage().surfaces, surfaces + 400);
+
+    // The ids are distinct, as are the buffers
+    EXPECT_NE(buffer->getRaster(3, render).get(), raster.get());
+    EXPECT_NE(ImageBuffer::get(std::string("other raster data"))->getRaster(2, render).get(), raster.get());
+    EXPECT_EQ(renders, 3);
+}
@@ -38,8 +38,8 @@ TEST(Image, testGetImageApplyOrientation) {
 
     image.setImage(imageData);
 
-    // Test Image object has no size before the image has be rendered
-    EXPECT_EQ(image.getImageSize(), Image::NOSIZE);
+    // The size is read from the header, with the orientation applied, before the image is rendered
+    EXPECT_EQ(image.getImageSize(), rotatedImageSize);
 
     // getImage render the image in a cairo surface
     auto surface = image.getImage();
@@ -47,6 +47,7 @@ TEST(Image, testGetImageApplyOrientation) {
     // Test image now have the correct size - which is the image has been rotated.
     EXPECT_EQ(image.getImageSize(), rotatedImageSize);
     EXPECT_EQ(image.getImageSize(), std::make_pair(130, 500));
-    EXPECT_EQ(std::make_pair(cairo_image_surface_get_width(surface), cairo_image_surface_get_height(surface)),
+    EXPECT_EQ(std::make_pair(cairo_image_surface_get_width(surface.get()),
+                             cairo_image_surface_get_height(surface.get())),
               rotatedImageSize);
 }
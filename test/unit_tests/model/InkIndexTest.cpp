@@ -0,0 +1,85 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/InkIndex.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/Range.h"
+
+namespace {
+Stroke* addStroke(const PageRef& page, double x, double y, size_t timestamp = 0) {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->addPoint(Point(x, y));
+    stroke->addPoint(Point(x + 10, y + 10));
+    if (timestamp > 0) {
+        stroke->setTimestamp(timestamp);
+        stroke->setAudioFilename("recording.mp3");
+    }
+    Stroke* ptr = stroke.get();
+    (*page->getLayers())[0]->addElement(std::move(stroke));
+    return ptr;
+}
+}  // namespace
+
+TEST(InkIndex, testPagesWithInk) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    for (int i = 0; i < 3; i++) { doc.addPage(std::make_shared<XojPage>(200, 200)); }
+    addStroke(doc.getPage(0), 10, 10);
+    addStroke(doc.getPage(0), 150, 150);
+    Stroke* moved = addStroke(doc.getPage(2), 100, 100);
+
+    InkIndex& index = doc.getInkIndex();
+    EXPECT_EQ(index.getPagesWithInk(doc, Range(0, 0, 200, 200)), (std::vector<size_t>{0, 2}));
+    // Inside the bounds of the strokes of the first page, but away from them
+    EXPECT_EQ(index.getPagesWithInk(doc, Range(80, 80, 120, 120)), (std::vector<size_t>{2}));
+
+    moved->move(-95, -95);
+    EXPECT_EQ(index.getPagesWithInk(doc, Range(80, 80, 120, 120)), (std::vector<size_t>{}));
+    EXPECT_EQ(index.getPagesWithInk(doc, Range(0, 0, 20, 20)), (std::vector<size_t>{0, 2}));
+
+    (*doc.getPage(0)->getLayers())[0]->setVisible(false);
+    EXPECT_EQ(index.getPagesWithInk(doc, Range(0, 0, 20, 20)), (std::vector<size_t>{2}));
+
+    doc.deletePage(0);
+    EXPECT_EQ(index.getPagesWithInk(doc, Range(0, 0, 20, 20)), (std::vector<size_t>{1}));
+}
+
+TEST(InkIndex, testAudioElements) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    for (int i = 0; i < 2; i++) { doc.addPage(std::make_shared<XojPage>(200, 200)); }
+    Stroke* a = addStroke(doc.getPage(1), 10, 10, 3000);
+    Stroke* b = addStroke(doc.getPage(0), 10, 10, 1000);
+    addStroke(doc.getPage(0), 50, 50);  // Not linked to any audio
+
+    InkIndex& index = doc.getInkIndex();
+    auto found = index.getAudioElements(doc, 0, 5000);
+    ASSERT_EQ(found.size(), 2U);
+    EXPECT_EQ(found[0].element, b);
+    EXPECT_EQ(found[0].page, 0U);
+    EXPECT_EQ(found[1].element, a);
+    EXPECT_EQ(found[1].page, 1U);
+
+    EXPECT_TRUE(index.getAudioElements(doc, 1001, 2999).empty());
+    ASSERT_EQ(index.getAudioElements(doc, 2000, 3000).size(), 1U);
+
+    addStroke(doc.getPage(1), 10, 10, 2500);
+    EXPECT_EQ(index.getAudioElements(doc, 2000, 3000).size(), 2U);
+}
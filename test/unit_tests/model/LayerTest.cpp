@@ -0,0 +1,179 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/Range.h"
+
+namespace {
+auto makeStroke(double x) -> ElementPtr {
+    auto stroke = std::make_unique<Stroke>();
+    stroke->addPoint(Point(x, 0));
+    stroke->addPoint(Point(x + 1, 1));
+    return stroke;
+}
+
+auto getPointers(const Layer& layer) -> std::vector<Element*> {
+    std::vector<Element*> res;
+    for (auto&& e: layer.getElements()) {
+        res.push_back(e.get());
+    }
+    return res;
+}
+
+/// The layers are added by the LayerController in the application
+class TestPage: public XojPage {
+public:
+    using XojPage::addLayer;
+    using XojPage::XojPage;
+};
+}  // namespace
+
+TEST(Layer, testBatchInsertion) {
+    Layer layer;
+    Layer reference;
+    InsertionOrder batch;
+    for (int i = 0; i < 6; i++) {
+        layer.addElement(makeStroke(10 * i));
+        reference.addElement(makeStroke(10 * i));
+    }
+    // Runs of consecutive positions, at the start, in the middle and past the end
+    for (Element::Index pos: {0, 1, 4, 5, 6, 12, 13, 100}) {
+        batch.emplace_back(makeStroke(static_cast<double>(1000 + pos)), pos);
+        reference.insertElement(makeStroke(static_cast<double>(1000 + pos)), pos);
+    }
+    std::vector<Element*> inserted;
+    for (auto&& p: batch) {
+        inserted.push_back(p.e.get());
+    }
+    layer.insertElements(std::move(batch));
+
+    ASSERT_EQ(layer.getElements().size(), reference.getElements().size());
+    for (size_t i = 0; i < layer.getElements().size(); i++) {
+        EXPECT_EQ(layer.getElements()[i]->getX(), reference.getElements()[i]->getX());
+    }
+    EXPECT_EQ(layer.indexOf(inserted[2]), 4);
+    EXPECT_EQ(layer.indexOf(inserted.back()), 13);
+
+    // The spatial index returns the elements in the order of the layer
+    EXPECT_EQ(layer.getElementsInArea(Range(-1, -1, 2000, 2)), getPointers(layer));
+    auto lastThree = layer.getElementsInArea(Range(1012, -1, 1101, 2));
+    EXPECT_EQ(lastThree, (std::vector<Element*>{inserted[5], inserted[6], inserted[7]}));
+}
+
+TEST(Layer, testBatchRemoval) {
+    Layer layer;
+    for (int i = 0; i < 10; i++) {
+        layer.addElement(makeStroke(10 * i));
+    }
+    auto elements = getPointers(layer);
+
+    // Outdated positions are looked up in the layer
+    InsertionOrderRef refs{InsertionPositionRef(elements[1], 1), InsertionPositionRef(elements[7], 2),
+                           InsertionPositionRef(elements[4], 4), InsertionPositionRef(elements[8])};
+    auto removed = layer.removeElementsAt(refs);
+    ASSERT_EQ(removed.size(), 4U);
+    EXPECT_TRUE(std::is_sorted(removed.begin(), removed.end()));
+    EXPECT_EQ(removed[0].ref().e, elements[1]);
+    EXPECT_EQ(removed[1].pos, 4);
+    EXPECT_EQ(removed[2].pos, 7);
+    EXPECT_EQ(removed[3].ref().e, elements[8]);
+    EXPECT_EQ(layer.getElements().size(), 6U);
+    EXPECT_EQ(layer.getElementsInArea(Range(-1, -1, 100, 2)).size(), 6U);
+
+    // Inserting them back restores the layer
+    layer.insertElements(std::move(removed));
+    EXPECT_EQ(getPointers(layer), elements);
+    EXPECT_EQ(layer.getElementsInArea(Range(-1, -1, 100, 2)), elements);
+}
+
+TEST(Layer, testIndexOf) {
+    Layer layer;
+    for (int i = 0; i < 50; i++) {
+        layer.addElement(makeStroke(10 * i));
+    }
+    // Enough insertions at the same place to run out of room between the order keys
+    for (int i = 0; i < 40; i++) {
+        layer.insertElement(makeStroke(-10 * i), 1);
+    }
+    for (int i = 0; i < 30; i++) {
+        layer.insertElement(makeStroke(1000 + i), 7 * i);
+    }
+    for (int i = 0; i < 20; i++) {
+        Element* e = layer.getElements()[static_cast<size_t>(3 * i)].get();
+        EXPECT_EQ(layer.removeElement(e).pos, 3 * i);
+    }
+
+    auto elements = getPointers(layer);
+    for (size_t i = 0; i < elements.size(); i++) {
+        EXPECT_EQ(layer.indexOf(elements[i]), static_cast<Element::Index>(i));
+    }
+    auto other = makeStroke(0);
+    EXPECT_EQ(layer.indexOf(other.get()), Element::InvalidIndex);
+    EXPECT_EQ(layer.indexOf(nullptr), Element::InvalidIndex);
+
+    auto found = layer.getElementsInAreaWithPositions(Range(-1000, -1, 2000, 2));
+    ASSERT_EQ(found.size(), elements.size());
+    for (size_t i = 0; i < found.size(); i++) {
+        EXPECT_EQ(found[i].e, elements[i]);
+        EXPECT_EQ(found[i].pos, static_cast<Element::Index>(i));
+    }
+}
+
+TEST(Layer, testContentRevision) {
+    TestPage page(100, 100, true);
+    auto* first = new Layer();
+    auto* second = new Layer();
+    page.addLayer(first);
+    page.addLayer(second);
+    first->addElement(makeStroke(0));
+    Element* stroke = first->getElements().front().get();
+
+    const uint64_t firstRevision = first->getContentRevision();
+    const uint64_t secondRevision = second->getContentRevision();
+    const uint64_t pageWide = page.getPageWideChangeCount();
+
+    // A change of an element only concerns its layer
+    page.fireElementChanged(stroke);
+    EXPECT_NE(first->getContentRevision(), firstRevision);
+    EXPECT_EQ(second->getContentRevision(), secondRevision);
+    EXPECT_EQ(page.getPageWideChangeCount(), pageWide);
+
+    // Moving it as well
+    const uint64_t movedRevision = first->getContentRevision();
+    stroke->move(5, 5);
+    EXPECT_NE(first->getContentRevision(), movedRevision);
+
+    // Hiding it changes what the page shows, not the layer
+    const uint64_t shownRevision = first->getRevision();
+    const uint64_t shownContent = first->getContentRevision();
+    first->setVisible(false);
+    EXPECT_NE(first->getRevision(), shownRevision);
+    EXPECT_EQ(first->getContentRevision(), shownContent);
+
+    // A change of an area may concern any layer
+    Range range(0, 0, 10, 10);
+    page.fireRangeChanged(range);
+    EXPECT_EQ(page.getPageWideChangeCount(), pageWide + 1);
+
+    const uint64_t background = page.getBackgroundRevision();
+    page.setSelectedLayerId(1);
+    EXPECT_EQ(page.getBackgroundRevision(), background);
+    page.setBackgroundColor(Colors::black);
+    EXPECT_NE(page.getBackgroundRevision(), background);
+}
@@ -0,0 +1,50 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+
+#include "model/PdfTextIndex.h"
+
+TEST(PdfTextIndex, testNormalize) {
+    EXPECT_EQ(PdfTextIndex::normalize("  Hello \n\t World  "), "hello world");
+    EXPECT_EQ(PdfTextIndex::normalize("ÄBC"), "äbc");
+    // Decomposed and composed forms are the same
+    EXPECT_EQ(PdfTextIndex::normalize("A\xcc\x88"), PdfTextIndex::normalize("\xc3\x84"));
+    EXPECT_EQ(PdfTextIndex::normalize(""), "");
+}
+
+TEST(PdfTextIndex, testMayContain) {
+    PdfTextIndex index(3);
+    // Unknown pages may contain anything
+    EXPECT_TRUE(index.mayContain(0, "text"));
+    EXPECT_TRUE(index.mayContain(5, "text"));
+
+    index.setPageText(0, "Some Text\non two lines");
+    EXPECT_TRUE(index.mayContain(0, "text"));
+    EXPECT_TRUE(index.mayContain(0, "TEXT ON"));
+    EXPECT_FALSE(index.mayContain(0, "three"));
+    EXPECT_TRUE(index.mayContain(1, "three"));
+}
+
+TEST(PdfTextIndex, testTakePages) {
+    PdfTextIndex index(3);
+    EXPECT_EQ(index.takePagesToIndex(), (std::vector<size_t>{0, 1, 2}));
+    EXPECT_TRUE(index.takePagesToIndex().empty());
+
+    index.setPageText(1, "page");
+    index.cancelPages({0, 1, 2});
+    EXPECT_FALSE(index.isComplete());
+    EXPECT_EQ(index.takePagesToIndex(), (std::vector<size_t>{0, 2}));
+
+    index.setPageText(0, "page");
+    index.setPageText(2, "page");
+    EXPECT_TRUE(index.isComplete());
+}
@@ -0,0 +1,83 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/SegmentHitKernel.h"
+
+namespace {
+constexpr double PADDING = 0.1;
+
+/// The test of Stroke::intersects() for the segment from a to b
+bool hits(const Point& a, const Point& b, double x, double y, double h) {
+    if (std::abs(b.x - x) <= h && std::abs(b.y - y) <= h) {
+        return true;
+    }
+    const double len = std::hypot(b.x - a.x, b.y - a.y);
+    return len >= h && std::abs((x - a.x) * (a.y - b.y) + (y - a.y) * (b.x - a.x)) / len <= h &&
+           std::hypot(x - (a.x + b.x) / 2, y - (a.y + b.y) / 2) - h * std::sqrt(2) <= len / 2 + PADDING;
+}
+}  // namespace
+
+TEST(SegmentHitKernel, testCandidates) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> step(-4.0, 4.0);
+    std::vector<Point> points{{100.0, 100.0}};
+    for (size_t i = 0; i < 2000; i++) {
+        points.emplace_back(points.back().x + step(gen), points.back().y + step(gen));
+    }
+    const size_t last = points.size() - 2;
+
+    for (double h: {0.0, 0.5, 3.0, 20.0}) {
+        for (size_t k = 0; k < 300; k += 7) {
+            // Close to, or on, the stroke
+            const double x = points[k * 6].x + 0.3 * step(gen);
+            const double y = points[k * 6].y + 0.3 * step(gen);
+            const SegmentHitKernel kernel(x, y, h, PADDING);
+
+            // Every hit segment is found, in order, with few others
+            std::vector<size_t> expected;
+            for (size_t i = 0; i <= last; i++) {
+                if (hits(points[i], points[i + 1], x, y, h)) {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<size_t> found;
+            for (size_t i = kernel.findCandidate(points.data(), 0, last); i <= last;
+                 i = kernel.findCandidate(points.data(), i + 1, last)) {
+                if (hits(points[i], points[i + 1], x, y, h)) {
+                    found.push_back(i);
+                }
+            }
+            EXPECT_EQ(found, expected) << x << " " << y << " " << h;
+        }
+    }
+}
+
+TEST(SegmentHitKernel, testRanges) {
+    const std::vector<Point> points{{0.0, 0.0}, {10.0, 0.0}, {20.0, 0.0}, {30.0, 0.0}, {40.0, 0.0}};
+    const SegmentHitKernel kernel(25.0, 1.0, 2.0, PADDING);
+    EXPECT_EQ(kernel.findCandidate(points.data(), 0, 3), 2U);
+    EXPECT_EQ(kernel.findCandidate(points.data(), 2, 2), 2U);
+    EXPECT_EQ(kernel.findCandidate(points.data(), 3, 3), 4U);
+    EXPECT_EQ(kernel.findCandidate(points.data(), 0, 1), 2U);
+    // Empty range
+    EXPECT_EQ(kernel.findCandidate(points.data(), 3, 2), 3U);
+
+    // Far from the stroke
+    const SegmentHitKernel far(25.0, 50.0, 2.0, PADDING);
+    EXPECT_EQ(far.findCandidate(points.data(), 0, 3), 4U);
+}
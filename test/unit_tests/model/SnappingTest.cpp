@@ -0,0 +1,51 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Snapping.h"
+#include "model/Stroke.h"
+
+TEST(Snapping, testSnapToVerticesOfShapes) {
+    Stroke rectangle;
+    rectangle.setPointVector({{10.0, 10.0}, {10.0, 50.0}, {60.0, 50.0}, {60.0, 10.0}, {10.0, 10.0}});
+    std::vector<Element*> elements{&rectangle};
+
+    auto snapped = Snapping::snapToVertices({58.0, 49.0, 0.7}, elements, 5.0);
+    ASSERT_TRUE(snapped);
+    EXPECT_DOUBLE_EQ(snapped->x, 60.0);
+    EXPECT_DOUBLE_EQ(snapped->y, 50.0);
+    // The pressure of the position is kept
+    EXPECT_DOUBLE_EQ(snapped->z, 0.7);
+
+    EXPECT_FALSE(Snapping::snapToVertices({35.0, 30.0}, elements, 5.0));
+}
+
+TEST(Snapping, testSnapToEndpointsOfLongStrokes) {
+    std::vector<Point> points;
+    for (int i = 0; i <= 2 * static_cast<int>(Snapping::MAX_SHAPE_POINTS); i++) {
+        points.emplace_back(static_cast<double>(i), 0.0);
+    }
+    Stroke stroke;
+    stroke.setPointVector(points);
+    std::vector<Element*> elements{&stroke};
+
+    // The intermediate points are not vertices
+    EXPECT_FALSE(Snapping::snapToVertices({10.0, 3.0}, elements, 4.0));
+
+    auto snapped = Snapping::snapToVertices({points.back().x + 1.0, 1.0}, elements, 4.0);
+    ASSERT_TRUE(snapped);
+    EXPECT_DOUBLE_EQ(snapped->x, points.back().x);
+    EXPECT_DOUBLE_EQ(snapped->y, 0.0);
+}
@@ -0,0 +1,72 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeDetailLevels.h"
+
+namespace {
+/// Densely sampled arc of a circle of radius 100
+std::vector<Point> arc(size_t n, double pressure = Point::NO_PRESSURE) {
+    std::vector<Point> points;
+    for (size_t i = 0; i < n; i++) {
+        const double t = 1.5 * static_cast<double>(i) / static_cast<double>(n - 1);
+        points.emplace_back(100 * std::cos(t), 100 * std::sin(t), pressure);
+    }
+    return points;
+}
+}  // namespace
+
+TEST(StrokeDetailLevels, testSimplify) {
+    const auto points = arc(2000);
+    for (double tolerance: {0.25, 1.0, 4.0}) {
+        const auto simplified = StrokeDetailLevels::simplify(points, tolerance);
+        EXPECT_LT(simplified.size(), points.size() / 10);
+        EXPECT_TRUE(simplified.front().equalsPos(points.front()));
+        EXPECT_TRUE(simplified.back().equalsPos(points.back()));
+        // The chords of the arc stay within the tolerance
+        for (size_t i = 0; i + 1 < simplified.size(); i++) {
+            const Point middle((simplified[i].x + simplified[i + 1].x) / 2, (simplified[i].y + simplified[i + 1].y) / 2);
+            EXPECT_LE(100 - std::hypot(middle.x, middle.y), tolerance);
+        }
+    }
+
+    // A straight line is reduced to its ends
+    const std::vector<Point> line{Point(0, 0), Point(1, 1), Point(2, 2), Point(3, 3)};
+    EXPECT_EQ(StrokeDetailLevels::simplify(line, 0.25).size(), 2U);
+
+    // Unless its width varies
+    const std::vector<Point> pressureLine{Point(0, 0, 1), Point(1, 1, 5), Point(2, 2, 1)};
+    EXPECT_EQ(StrokeDetailLevels::simplify(pressureLine, 0.25).size(), 3U);
+}
+
+TEST(StrokeDetailLevels, testStrokeLevels) {
+    Stroke stroke;
+    stroke.setPointVector(arc(2000));
+
+    // Too small tolerances give the points themselves
+    EXPECT_EQ(&stroke.getSimplifiedPointVector(0.1), &stroke.getPointVector());
+
+    // The levels are cached per power of two
+    const auto& level = stroke.getSimplifiedPointVector(1.0);
+    EXPECT_LT(level.size(), stroke.getPointCount());
+    EXPECT_EQ(&stroke.getSimplifiedPointVector(1.5), &level);
+    EXPECT_NE(&stroke.getSimplifiedPointVector(2.0), &level);
+
+    // And computed again once the points change
+    stroke.move(10, 0);
+    EXPECT_DOUBLE_EQ(stroke.getSimplifiedPointVector(1.0).front().x, 110.0);
+}
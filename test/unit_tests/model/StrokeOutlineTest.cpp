@@ -0,0 +1,55 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/StrokeOutline.h"
+
+namespace {
+/// Whether the point is painted when filling the path
+auto isInFill(const cairo_path_t* path, double x, double y) -> bool {
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+    cairo_t* cr = cairo_create(surface);
+    cairo_append_path(cr, path);
+    cairo_set_fill_rule(cr, CAIRO_FILL_RULE_WINDING);
+    bool in = cairo_in_fill(cr, x, y);
+    cairo_destroy(cr);
+    cairo_surface_destroy(surface);
+    return in;
+}
+}  // namespace
+
+TEST(StrokeOutline, testOutlineIsCached) {
+    const std::vector<Point> points{{0.0, 0.0, 2.0}, {10.0, 0.0, 4.0}, {10.0, 10.0, 4.0}};
+    StrokeOutline outline;
+
+    const cairo_path_t* path = outline.get(points, CAIRO_LINE_CAP_ROUND);
+    ASSERT_NE(path, nullptr);
+    EXPECT_EQ(path->status, CAIRO_STATUS_SUCCESS);
+    EXPECT_GT(path->num_data, 0);
+    EXPECT_EQ(outline.get(points, CAIRO_LINE_CAP_ROUND), path);
+
+    // The width of a segment is the pressure of its first point
+    EXPECT_TRUE(isInFill(path, 5.0, 0.9));
+    EXPECT_FALSE(isInFill(path, 5.0, 1.5));
+    EXPECT_TRUE(isInFill(path, 11.5, 5.0));
+    // Round join
+    EXPECT_TRUE(isInFill(path, 11.5, -1.0));
+
+    // Butt caps: no round join
+    const cairo_path_t* butt = outline.get(points, CAIRO_LINE_CAP_BUTT);
+    EXPECT_FALSE(isInFill(butt, 11.5, -1.0));
+    EXPECT_TRUE(isInFill(butt, 5.0, 0.9));
+}
@@ -0,0 +1,130 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeSegmentTree.h"
+#include "util/Rectangle.h"
+
+using xoj::util::Rectangle;
+
+namespace {
+/// A long stroke going round in a spiral, so that most of its segments are close to other segments
+std::vector<Point> spiral(size_t n) {
+    std::vector<Point> points;
+    points.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        const double t = 0.05 * static_cast<double>(i);
+        points.emplace_back(300.0 + t * std::cos(t), 400.0 + t * std::sin(t));
+    }
+    return points;
+}
+
+bool touches(const Point& p, const Point& q, const Rectangle<double>& rect) {
+    return std::min(p.x, q.x) <= rect.x + rect.width && rect.x <= std::max(p.x, q.x) &&
+           std::min(p.y, q.y) <= rect.y + rect.height && rect.y <= std::max(p.y, q.y);
+}
+}  // namespace
+
+TEST(StrokeSegmentTree, testSegmentRanges) {
+    const auto points = spiral(5000);
+    StrokeSegmentTree tree(points);
+    EXPECT_EQ(tree.getSegmentCount(), points.size() - 1);
+
+    const std::vector<Rectangle<double>> areas{{300, 400, 5, 5}, {250, 380, 1, 40}, {0, 0, 10, 10}, {0, 0, 1000, 1000}};
+    for (const auto& area: areas) {
+        for (auto [first, last]: {std::pair<size_t, size_t>{0, points.size() - 2}, {100, 1234}, {4000, 4000}}) {
+            std::vector<size_t> found;
+            size_t previous = 0;
+            tree.forEachSegmentRangeIn(area, first, last, [&](size_t begin, size_t end) {
+                EXPECT_LE(begin, end);
+                EXPECT_TRUE(found.empty() || previous < begin);
+                for (size_t i = begin; i <= end; i++) { found.push_back(i); }
+                previous = end;
+                return false;
+            });
+
+            // Each touching segment is found
+            for (size_t i = first; i <= last; i++) {
+                if (touches(points[i], points[i + 1], area)) {
+                    EXPECT_TRUE(std::binary_search(found.begin(), found.end(), i)) << i;
+                }
+            }
+            for (size_t i: found) {
+                EXPECT_GE(i, first);
+                EXPECT_LE(i, last);
+            }
+        }
+    }
+
+    // The search stops when asked to
+    size_t calls = 0;
+    EXPECT_TRUE(tree.forEachSegmentRangeIn({0, 0, 1000, 1000}, 0, points.size() - 2, [&](size_t, size_t) {
+        calls++;
+        return true;
+    }));
+    EXPECT_EQ(calls, 1U);
+}
+
+TEST(StrokeSegmentTree, testJoinedSegmentRanges) {
+    const auto points = spiral(5000);
+    StrokeSegmentTree tree(points);
+
+    for (const auto& area: {Rectangle<double>{300, 400, 5, 5}, {250, 380, 1, 40}, {0, 0, 1000, 1000}}) {
+        std::vector<size_t> expected;
+        tree.forEachSegmentRangeIn(area, 100, 4000, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i <= end; i++) { expected.push_back(i); }
+            return false;
+        });
+
+        // Same segments, in ranges separated by at least one segment
+        std::vector<size_t> found;
+        tree.forEachJoinedSegmentRangeIn(area, 100, 4000, [&](size_t begin, size_t end) {
+            EXPECT_TRUE(found.empty() || found.back() + 1 < begin);
+            for (size_t i = begin; i <= end; i++) { found.push_back(i); }
+        });
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST(StrokeSegmentTree, testStrokeIntersects) {
+    const auto points = spiral(3000);
+    Stroke stroke;
+    stroke.setWidth(1.0);
+    stroke.setPointVector(points);
+
+    for (const auto& [x, y]: {std::pair{300.0, 400.0}, {310.3, 390.7}, {250.0, 250.0}, {420.0, 400.0}}) {
+        for (double halfEraserSize: {0.5, 3.0}) {
+            // Same result as testing the segments one by one
+            bool expected = false;
+            double expectedGap = -1;
+            for (size_t i = 0; i + 1 < points.size() && !expected; i++) {
+                Stroke segment;
+                segment.setPointVector({points[i], points[i + 1]});
+                expected = segment.intersects(x, y, halfEraserSize, &expectedGap);
+            }
+            double gap = -1;
+            EXPECT_EQ(stroke.intersects(x, y, halfEraserSize, &gap), expected) << x << " " << y;
+            EXPECT_EQ(gap, expectedGap);
+        }
+    }
+
+    // The tree follows the modifications
+    EXPECT_FALSE(stroke.intersects(1000.0, 400.0, 1.0));
+    stroke.move(700.0, 0.0);
+    EXPECT_TRUE(stroke.intersects(1000.0, 400.0, 1.0));
+}
@@ -0,0 +1,110 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+
+TEST(Stroke, testBoundsWithNegativeCoordinates) {
+    Stroke stroke;
+    stroke.setWidth(2.0);
+    stroke.setPointVector({{-30.0, -40.0}, {-10.0, -20.0}, {-20.0, -35.0}});
+
+    EXPECT_DOUBLE_EQ(stroke.getX(), -31.0);
+    EXPECT_DOUBLE_EQ(stroke.getY(), -41.0);
+    EXPECT_DOUBLE_EQ(stroke.getElementWidth(), 22.0);
+    EXPECT_DOUBLE_EQ(stroke.getElementHeight(), 22.0);
+    EXPECT_DOUBLE_EQ(stroke.getSnappedBounds().width, 20.0);
+}
+
+TEST(Stroke, testTransform) {
+    std::vector<Point> points{{10.0, 20.0, 0.5}, {30.0, 15.0, 1.0}, {25.0, 40.0, Point::NO_PRESSURE}};
+    Stroke stroke;
+    stroke.setWidth(1.0);
+    stroke.setPointVector(points);
+
+    stroke.rotate(20.0, 20.0, M_PI / 2);
+    stroke.scale(0.0, 0.0, 2.0, 0.5, 0.0, false);
+
+    cairo_matrix_t matrix;
+    cairo_matrix_init_scale(&matrix, 2.0, 0.5);
+    cairo_matrix_translate(&matrix, 20.0, 20.0);
+    cairo_matrix_rotate(&matrix, M_PI / 2);
+    cairo_matrix_translate(&matrix, -20.0, -20.0);
+    for (size_t i = 0; i < points.size(); i++) {
+        double x = points[i].x;
+        double y = points[i].y;
+        cairo_matrix_transform_point(&matrix, &x, &y);
+        EXPECT_NEAR(stroke.getPoint(i).x, x, 1e-9);
+        EXPECT_NEAR(stroke.getPoint(i).y, y, 1e-9);
+    }
+
+    // The pressure is scaled as the width, except where there is none
+    EXPECT_DOUBLE_EQ(stroke.getWidth(), 1.0);
+    EXPECT_DOUBLE_EQ(stroke.getPoint(0).z, 0.5);
+    EXPECT_DOUBLE_EQ(stroke.getPoint(2).z, Point::NO_PRESSURE);
+
+    stroke.scale(0.0, 0.0, 2.0, 2.0, 0.0, false);
+    EXPECT_DOUBLE_EQ(stroke.getWidth(), 2.0);
+    EXPECT_DOUBLE_EQ(stroke.getPoint(1).z, 2.0);
+    EXPECT_DOUBLE_EQ(stroke.getPoint(2).z, Point::NO_PRESSURE);
+}
+
+TEST(Stroke, testClonesSharePoints) {
+    Stroke stroke;
+    stroke.addPoint(Point(0, 0, 1));
+    stroke.addPoint(Point(10, 10, 2));
+    auto clone = stroke.cloneStroke();
+    auto clone2 = clone->cloneStroke();
+    EXPECT_EQ(clone->getPoints(), stroke.getPoints());
+    EXPECT_EQ(clone2->getPoints(), stroke.getPoints());
+
+    // Modifying a clone only copies its own points
+    clone->move(5, 0);
+    EXPECT_NE(clone->getPoints(), stroke.getPoints());
+    EXPECT_EQ(clone2->getPoints(), stroke.getPoints());
+    EXPECT_EQ(clone->getPoint(1).x, 15);
+    EXPECT_EQ(stroke.getPoint(1).x, 10);
+
+    stroke.addPoint(Point(20, 20, 3));
+    EXPECT_EQ(stroke.getPointCount(), 3U);
+    EXPECT_EQ(clone2->getPointCount(), 2U);
+    EXPECT_EQ(clone2->getPoint(1).x, 10);
+}
+
+TEST(Stroke, testBoundsComputedConcurrently) {
+    std::vector<Point> points;
+    for (int i = 0; i <= 10000; i++) { points.emplace_back(i * 0.01, std::sin(i * 0.01)); }
+    Stroke stroke;
+    stroke.setWidth(2.0);
+    stroke.setPointVector(points);
+
+    // The threads reading the bounds at once all see them completely computed
+    std::vector<xoj::util::Rectangle<double>> bounds(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < bounds.size(); i++) {
+        threads.emplace_back([&stroke, &bounds, i]() { bounds[i] = stroke.boundingRect(); });
+    }
+    for (auto& t: threads) { t.join(); }
+
+    for (const auto& rect: bounds) {
+        EXPECT_DOUBLE_EQ(rect.x, -1.0);
+        EXPECT_NEAR(rect.width, 102.0, 1e-9);
+        EXPECT_NEAR(rect.y, -2.0, 1e-3);
+        EXPECT_NEAR(rect.height, 4.0, 1e-3);
+    }
+}
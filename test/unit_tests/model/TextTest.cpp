@@ -0,0 +1,54 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <gtest/gtest.h>
+#include <pango/pango.h>
+
+#include "model/Font.h"
+#include "model/FontCache.h"
+#include "model/Text.h"
+
+TEST(Text, testCachedLayout) {
+    Text text;
+    text.setText("Hello");
+    PangoLayout* layout = text.getPangoLayout();
+    EXPECT_EQ(text.getPangoLayout(), layout);
+    EXPECT_STREQ(pango_layout_get_text(layout), "Hello");
+    const double width = text.getElementWidth();
+
+    // Editing the text invalidates the layout
+    text.setText("Hello world");
+    EXPECT_STREQ(pango_layout_get_text(text.getPangoLayout()), "Hello world");
+    EXPECT_GT(text.getElementWidth(), width);
+
+    // So does a change of font, even through getFont()
+    text.getFont().setSize(24);
+    const PangoFontDescription* desc = pango_layout_get_font_description(text.getPangoLayout());
+    EXPECT_EQ(pango_font_description_get_size(desc), 24 * PANGO_SCALE);
+}
+
+TEST(Text, testFontCache) {
+    XojFont font("Sans Bold", 14);
+    PangoFontDescription* desc = FontCache::createDescription(font);
+    ASSERT_NE(pango_font_description_get_family(desc), nullptr);
+    EXPECT_EQ(pango_font_description_get_weight(desc), PANGO_WEIGHT_BOLD);
+    EXPECT_EQ(pango_font_description_get_size(desc), 14 * PANGO_SCALE);
+    EXPECT_TRUE(pango_font_description_get_size_is_absolute(desc));
+
+    // Cached: the same font, at the size asked for
+    font.setSize(20);
+    PangoFontDescription* other = FontCache::createDescription(font);
+    EXPECT_STREQ(pango_font_description_get_family(other), pango_font_description_get_family(desc));
+    EXPECT_EQ(pango_font_description_get_size(other), 20 * PANGO_SCALE);
+
+    pango_font_description_free(desc);
+    pango_font_description_free(other);
+}
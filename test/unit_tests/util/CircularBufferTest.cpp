@@ -0,0 +1,34 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "util/CircularBuffer.h"
+
+TEST(CircularBuffer, testFrontAndBack) {
+    CircularBuffer<int> buffer(3);
+    buffer.assign(0);
+    EXPECT_EQ(buffer.size(), 3U);
+
+    buffer.push_front(1);
+    buffer.push_front(2);
+    buffer.push_front(3);
+    EXPECT_EQ(buffer.front(), 3);
+    EXPECT_EQ(buffer.back(), 1);
+
+    // The oldest element is overwritten
+    buffer.push_front(4);
+    EXPECT_EQ(buffer.front(), 4);
+    EXPECT_EQ(buffer.back(), 2);
+    EXPECT_EQ(std::accumulate(buffer.begin(), buffer.end(), 0), 2 + 3 + 4);
+}
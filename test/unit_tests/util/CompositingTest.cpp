@@ -0,0 +1,61 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/Compositing.h"
+
+using namespace xoj::util::compositing;
+
+namespace {
+auto channel(uint32_t pixel, int shift) -> double { return static_cast<double>((pixel >> shift) & 0xff) / 255.0; }
+}  // namespace
+
+TEST(UtilCompositing, testMultiplyMasked) {
+    const PremultipliedColor color = premultiply(1.0, 0.8, 0.2, 0.5);
+    EXPECT_EQ(color.a, 128U);
+    EXPECT_EQ(color.r, 128U);
+
+    std::vector<uint32_t> pixels;
+    std::vector<uint8_t> mask;
+    for (uint32_t a: {0U, 0x80U, 0xffU}) {
+        for (uint32_t m: {0U, 1U, 0x7fU, 0xffU}) {
+            // Premultiplied, opaque or not
+            pixels.push_back((a << 24) | ((a * 3 / 4) << 16) | ((a / 2) << 8) | (a / 5));
+            mask.push_back(static_cast<uint8_t>(m));
+        }
+    }
+    // Not a multiple of the number of pixels processed at once
+    pixels.push_back(0xff000000);
+    mask.push_back(0xff);
+    const std::vector<uint32_t> before = pixels;
+    multiplyMasked(pixels.data(), mask.data(), pixels.size(), color);
+
+    for (size_t i = 0; i < pixels.size(); i++) {
+        const double m = mask[i] / 255.0;
+        const double sa = color.a / 255.0 * m;
+        const double da = channel(before[i], 24);
+        EXPECT_NEAR(channel(pixels[i], 24), sa + da - sa * da, 1.5 / 255) << i;
+        const uint32_t src[] = {color.r, color.g, color.b};
+        for (int c = 0; c < 3; c++) {
+            const double s = src[c] / 255.0 * m;
+            const double d = channel(before[i], 16 - 8 * c);
+            EXPECT_NEAR(channel(pixels[i], 16 - 8 * c), s * (1 - da) + d * (1 - sa) + s * d, 1.5 / 255) << i;
+        }
+        if (mask[i] == 0) {
+            EXPECT_EQ(pixels[i], before[i]);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/DamageRegion.h"
+#include "util/Point.h"
+#include "util/Range.h"
+
+using xoj::util::DamageRegion;
+
+namespace {
+auto totalArea(const DamageRegion& region) -> double {
+    double res = 0;
+    for (auto&& rg: region.getRanges()) {
+        res += rg.getWidth() * rg.getHeight();
+    }
+    return res;
+}
+}  // namespace
+
+TEST(UtilDamageRegion, testMerge) {
+    DamageRegion region;
+    region.add(Range());
+    EXPECT_TRUE(region.empty());
+
+    region.add(Range(0, 0, 10, 10));
+    // Contained
+    region.add(Range(2, 2, 5, 5));
+    // Wasting little once merged
+    region.add(Range(0, 9, 10, 12));
+    ASSERT_EQ(region.getRanges().size(), 1U);
+    EXPECT_EQ(region.getRanges().front().maxY, 12);
+
+    // Far
+    region.add(Range(100, 100, 110, 110));
+    EXPECT_EQ(region.getRanges().size(), 2U);
+    // Bridging the two
+    region.add(Range(0, 0, 110, 110));
+    EXPECT_EQ(region.getRanges().size(), 1U);
+
+    region.clear();
+    for (int i = 0; i < 40; i++) {
+        region.add(Range(20 * i, 20 * i, 20 * i + 5, 20 * i + 5));
+    }
+    EXPECT_EQ(region.getRanges().size(), DamageRegion::MAX_RANGES);
+    const Range box = region.getBoundingBox();
+    EXPECT_EQ(box.minX, 0);
+    EXPECT_EQ(box.maxX, 20 * 39 + 5);
+}
+
+TEST(UtilDamageRegion, testOutline) {
+    // A circle: the outline covers far less than its bounding box, but all of its points
+    std::vector<xoj::util::Point<double>> circle;
+    for (int i = 0; i <= 100; i++) {
+        circle.emplace_back(100 * std::cos(i * 2 * M_PI / 100), 100 * std::sin(i * 2 * M_PI / 100));
+    }
+    DamageRegion region;
+    region.addOutline(circle, 1.0);
+    EXPECT_LT(totalArea(region), 0.5 * 202 * 202);
+    for (auto&& p: circle) {
+        bool covered = false;
+        for (auto&& rg: region.getRanges()) {
+            covered = covered || rg.contains(p.x, p.y);
+        }
+        EXPECT_TRUE(covered);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/FixedSizePool.h"
+
+using Pool = xoj::util::FixedSizePool<40, 16>;
+
+TEST(UtilFixedSizePool, testReuse) {
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 3 * Pool::CHUNK_BLOCKS; i++) {
+        void* block = Pool::allocate();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % 16, 0U);
+        blocks.push_back(block);
+    }
+    EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), blocks.size());
+
+    // The blocks do not overlap
+    for (void* block: blocks) { std::fill_n(static_cast<char*>(block), 40, 'x'); }
+
+    const std::set<void*> allocated(blocks.begin(), blocks.end());
+    for (void* block: blocks) { Pool::deallocate(block); }
+
+    // The freed blocks are used again
+    for (size_t i = 0; i < Pool::CHUNK_BLOCKS; i++) {
+        void* block = Pool::allocate();
+        EXPECT_TRUE(allocated.count(block));
+        Pool::deallocate(block);
+    }
+}
+
+TEST(UtilFixedSizePool, testThreads) {
+    // Blocks allocated in some threads and freed in others
+    std::vector<std::vector<void*>> blocks(4);
+    std::vector<std::thread> threads;
+    for (auto& b: blocks) {
+        threads.emplace_back([&b]() {
+            for (size_t i = 0; i < 5000; i++) { b.push_back(Pool::allocate()); }
+        });
+    }
+    for (auto& t: threads) { t.join(); }
+    threads.clear();
+
+    std::set<void*> all;
+    for (auto& b: blocks) { all.insert(b.begin(), b.end()); }
+    EXPECT_EQ(all.size(), 4U * 5000U);
+
+    for (size_t n = 0; n < blocks.size(); n++) {
+        threads.emplace_back([&b = blocks[(n + 1) % blocks.size()]]() {
+            for (void* block: b) { Pool::deallocate(block); }
+        });
+    }
+    for (auto& t: threads) { t.join(); }
+}
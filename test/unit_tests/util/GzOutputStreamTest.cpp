@@ -0,0 +1,76 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "util/GzUtil.h"
+#include "util/OutputStream.h"
+
+#include "filesystem.h"
+
+namespace {
+std::string readGzFile(const fs::path& path) {
+    gzFile fp = GzUtil::openPath(path, "r");
+    EXPECT_NE(fp, nullptr);
+    std::string res;
+    char buffer[4096];
+    int read = 0;
+    while ((read = gzread(fp, buffer, sizeof(buffer))) > 0) {
+        res.append(buffer, static_cast<size_t>(read));
+    }
+    EXPECT_EQ(read, 0);
+    gzclose(fp);
+    return res;
+}
+}  // namespace
+
+TEST(UtilGzOutputStream, testRoundTrip) {
+    // Several blocks, with writes crossing the block boundaries
+    std::string expected;
+    for (int i = 0; i < 100000; i++) {
+        expected += "<stroke tool=\"pen\">" + std::to_string(i * 7919 % 100003) + " " + std::to_string(i) +
+                    "</stroke>\n";
+    }
+
+    const fs::path path = fs::temp_directory_path() / "xournalpp-test-units_UtilGzOutputStream_testRoundTrip.gz";
+    {
+        GzOutputStream out(path);
+        ASSERT_TRUE(out.getLastError().empty());
+        for (size_t pos = 0; pos < expected.size(); pos += 10007) {
+            out.write(expected.data() + pos, std::min<size_t>(10007, expected.size() - pos));
+        }
+        out.close();
+        EXPECT_TRUE(out.getLastError().empty());
+    }
+
+    EXPECT_LT(fs::file_size(path), expected.size() / 4);
+    EXPECT_EQ(readGzFile(path), expected);
+    fs::remove(path);
+}
+
+TEST(UtilGzOutputStream, testEmpty) {
+    const fs::path path = fs::temp_directory_path() / "xournalpp-test-units_UtilGzOutputStream_testEmpty.gz";
+    {
+        GzOutputStream out(path);
+        ASSERT_TRUE(out.getLastError().empty());
+    }
+    EXPECT_EQ(readGzFile(path), "");
+    fs::remove(path);
+}
+
+TEST(UtilGzOutputStream, testOpenError) {
+    GzOutputStream out(fs::temp_directory_path() / "xournalpp-non-existing-dir" / "file.gz");
+    EXPECT_FALSE(out.getLastError().empty());
+}
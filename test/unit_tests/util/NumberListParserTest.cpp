@@ -0,0 +1,59 @@
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/NumberListParser.h"
+
+using namespace xoj::util;
+
+namespace {
+std::vector<double> parseAll(const std::string& s, size_t* stoppedAt = nullptr) {
+    std::vector<double> res;
+    const char* end = forEachNumber(s.data(), s.data() + s.size(), [&res](double v) { res.push_back(v); });
+    if (stoppedAt) {
+        *stoppedAt = static_cast<size_t>(end - s.data());
+    }
+    return res;
+}
+};  // namespace
+
+TEST(UtilNumberListParser, testCount) {
+    const std::string s = "  1.5 2\t-3.25\n4e2  ";
+    EXPECT_EQ(countNumberTokens(s.data(), s.data() + s.size()), 4U);
+    EXPECT_EQ(countNumberTokens(s.data(), s.data()), 0U);
+    const std::string blank = " \n\t ";
+    EXPECT_EQ(countNumberTokens(blank.data(), blank.data() + blank.size()), 0U);
+}
+
+TEST(UtilNumberListParser, testParse) {
+    EXPECT_EQ(parseAll("  1.5 2\t-3.25\n4e2  "), (std::vector<double>{1.5, 2.0, -3.25, 400.0}));
+    EXPECT_EQ(parseAll("+0.5 .25 7"), (std::vector<double>{0.5, 0.25, 7.0}));
+    EXPECT_TRUE(parseAll("").empty());
+
+    // The parsing stops at the first invalid token
+    size_t stoppedAt = 0;
+    EXPECT_EQ(parseAll("1 2 abc 3", &stoppedAt), (std::vector<double>{1.0, 2.0}));
+    EXPECT_EQ(stoppedAt, 4U);
+}
+
+TEST(UtilNumberListParser, testNotNullTerminated) {
+    // Only the first 5 characters are part of the input
+    const char text[] = "12.5 7.75";
+    std::vector<double> res;
+    forEachNumber(text, text + 5, [&res](double v) { res.push_back(v); });
+    EXPECT_EQ(res, (std::vector<double>{12.5}));
+
+    double value = 0;
+    EXPECT_EQ(parseDouble(text, text + 2, value), text + 2);
+    EXPECT_EQ(value, 12.0);
+}
+
+TEST(UtilNumberListParser, testOutOfRange) {
+    double value = 0;
+    const std::string huge = "1e999";
+    EXPECT_EQ(parseDouble(huge.data(), huge.data() + huge.size(), value), huge.data() + huge.size());
+    EXPECT_TRUE(std::isinf(value));
+}
@@ -0,0 +1,114 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glib.h>
+#include <gtest/gtest.h>
+
+#include "util/NumberListWriter.h"
+#include "util/OutputStream.h"
+#include "util/Util.h"
+
+using namespace xoj::util;
+
+namespace {
+class StringOutputStream: public OutputStream {
+public:
+    void write(const char* data, size_t len) override {
+        str.append(data, len);
+        writes++;
+    }
+    void close() override {}
+
+    using OutputStream::write;
+
+    std::string str;
+    size_t writes = 0;
+};
+
+std::string formatWithGlib(double value) {
+    char str[G_ASCII_DTOSTR_BUF_SIZE];
+    g_ascii_formatd(str, G_ASCII_DTOSTR_BUF_SIZE, Util::PRECISION_FORMAT_STRING, value);
+    return str;
+}
+
+std::string format(double value) {
+    char str[FORMATTED_DOUBLE_MAX_LENGTH];
+    return std::string(str, formatDouble(str, value));
+}
+};  // namespace
+
+TEST(UtilNumberListWriter, testSameAsGlib) {
+    const std::vector<double> values = {0.0,
+                                        -0.0,
+                                        1.0,
+                                        -1.5,
+                                        0.1,
+                                        123456789.0,
+                                        12345678.0,
+                                        1234567.85,
+                                        0.0001,
+                                        0.00001,
+                                        1e-300,
+                                        1e300,
+                                        595.275591,
+                                        841.889764,
+                                        99999999.5,
+                                        std::numeric_limits<double>::max(),
+                                        std::numeric_limits<double>::denorm_min(),
+                                        std::numeric_limits<double>::lowest(),
+                                        std::numeric_limits<double>::infinity(),
+                                        -std::numeric_limits<double>::infinity()};
+    for (double v: values) {
+        EXPECT_EQ(format(v), formatWithGlib(v)) << v;
+    }
+
+    std::mt19937_64 rng(42);  // NOLINT(cert-msc32-c, cert-msc51-cpp)
+    std::uniform_real_distribution<double> coordinates(-100.0, 5000.0);
+    std::uniform_int_distribution<int> exponents(-40, 40);
+    for (int i = 0; i < 10000; i++) {
+        const double v = coordinates(rng);
+        EXPECT_EQ(format(v), formatWithGlib(v)) << v;
+        const double w = std::ldexp(v, exponents(rng));
+        EXPECT_EQ(format(w), formatWithGlib(w)) << w;
+    }
+}
+
+TEST(UtilNumberListWriter, testList) {
+    StringOutputStream out;
+    {
+        NumberListWriter writer(&out);
+        writer.write(1.25);
+        writer.write(-3.0);
+        writer.write(0.5);
+    }
+    EXPECT_EQ(out.str, "1.25 -3 0.5");
+    EXPECT_EQ(out.writes, 1U);
+
+    StringOutputStream empty;
+    { NumberListWriter writer(&empty); }
+    EXPECT_EQ(empty.str, "");
+    EXPECT_EQ(empty.writes, 0U);
+}
+
+TEST(UtilNumberListWriter, testLongList) {
+    StringOutputStream out;
+    std::string expected;
+    {
+        NumberListWriter writer(&out);
+        for (int i = 0; i < 20000; i++) {
+            const double v = i * 1.0000001;
+            writer.write(v);
+            if (i == 100) {
+                // Flushing does not change the output
+                writer.flush();
+            }
+            expected += (i ? " " : "") + formatWithGlib(v);
+        }
+    }
+    EXPECT_EQ(out.str, expected);
+    // Batched, not one write per number
+    EXPECT_LT(out.writes, 50U);
+}
@@ -398,3 +398,27 @@ TEST(UtilObjectIOStream, testReadStroke) {
         FAIL();
     }
 }
+
+TEST(UtilObjectIOStream, testTruncatedStream) {
+    std::vector<double> data(1000, 42.);
+    std::string str = serializeDataVector(data);
+
+    // Every truncation of the array is detected
+    for (size_t len: {str.size() - 1, str.size() - 8 * 500, str.size() - 8 * 1000 - 1}) {
+        ObjectInputStream stream;
+        ASSERT_TRUE(stream.read(str.data(), len));
+        std::vector<double> outputData;
+        EXPECT_THROW(stream.readData(outputData), InputStreamException);
+    }
+}
+
+TEST(UtilObjectIOStream, testRejectOtherVersion) {
+    // The version string of the older format, tagged with its type
+    std::string str = "_s";
+    size_t len = 9;
+    str.append(reinterpret_cast<const char*>(&len), sizeof(size_t));
+    str += "XojStrm1:";
+
+    ObjectInputStream stream;
+    EXPECT_FALSE(stream.read(str.data(), str.size()));
+}
@@ -0,0 +1,122 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include "util/PngEncoder.h"
+
+using namespace xoj::util::png;
+
+namespace {
+auto readU32(const std::vector<uint8_t>& data, size_t pos) -> uint32_t {
+    return (uint32_t(data[pos]) << 24) | (uint32_t(data[pos + 1]) << 16) | (uint32_t(data[pos + 2]) << 8) |
+           uint32_t(data[pos + 3]);
+}
+
+auto paeth(int a, int b, int c) -> int {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+/// Decode an 8 bits RGBA PNG file, checking its structure
+auto decode(const std::vector<uint8_t>& png, int& width, int& height) -> std::vector<uint8_t> {
+    std::vector<uint8_t> zdata;
+    for (size_t pos = 8; pos + 12 <= png.size();) {
+        const uint32_t length = readU32(png, pos);
+        const std::string type(png.begin() + static_cast<ptrdiff_t>(pos) + 4,
+                               png.begin() + static_cast<ptrdiff_t>(pos) + 8);
+        const uint8_t* content = png.data() + pos + 8;
+        EXPECT_EQ(readU32(png, pos + 8 + length), crc32(0L, png.data() + pos + 4, length + 4)) << type;
+        if (type == "IHDR") {
+            width = static_cast<int>(readU32(png, pos + 8));
+            height = static_cast<int>(readU32(png, pos + 12));
+            EXPECT_EQ(content[8], 8);
+            EXPECT_EQ(content[9], 6);
+        } else if (type == "IDAT") {
+            zdata.insert(zdata.end(), content, content + length);
+        }
+        pos += 12 + length;
+    }
+
+    const size_t rowBytes = 4 * static_cast<size_t>(width);
+    std::vector<uint8_t> filtered((rowBytes + 1) * static_cast<size_t>(height));
+    uLongf size = filtered.size();
+    EXPECT_EQ(uncompress(filtered.data(), &size, zdata.data(), zdata.size()), Z_OK);
+    EXPECT_EQ(size, filtered.size());
+
+    std::vector<uint8_t> res(rowBytes * static_cast<size_t>(height));
+    for (size_t y = 0; y < static_cast<size_t>(height); y++) {
+        const uint8_t filter = filtered[y * (rowBytes + 1)];
+        const uint8_t* in = filtered.data() + y * (rowBytes + 1) + 1;
+        uint8_t* out = res.data() + y * rowBytes;
+        const uint8_t* up = y > 0 ? out - rowBytes : nullptr;
+        for (size_t i = 0; i < rowBytes; i++) {
+            const int a = i >= 4 ? out[i - 4] : 0;
+            const int b = up ? up[i] : 0;
+            const int c = up && i >= 4 ? up[i - 4] : 0;
+            const int predictor[] = {0, a, b, (a + b) / 2, paeth(a, b, c)};
+            EXPECT_LT(filter, 5);
+            out[i] = static_cast<uint8_t>(in[i] + predictor[filter % 5]);
+        }
+    }
+    return res;
+}
+}  // namespace
+
+TEST(UtilPngEncoder, testRoundTrip) {
+    const int width = 37;
+    const int height = 300;
+    const int stride = 4 * width + 12;
+    std::vector<unsigned char> data(static_cast<size_t>(stride * height));
+    for (int y = 0; y < height; y++) {
+        auto* row = reinterpret_cast<uint32_t*>(data.data() + y * stride);
+        for (int x = 0; x < width; x++) {
+            const uint32_t a = (x * 7 + y) % 3 == 0 ? 0xff : static_cast<uint32_t>(x + y) & 0xff;
+            const uint32_t r = a * static_cast<uint32_t>(x % 5) / 4;
+            const uint32_t g = a * static_cast<uint32_t>(y % 9) / 8;
+            row[x] = (a << 24) | (r << 16) | (g << 8) | (a / 2);
+        }
+    }
+
+    for (Compression compression: {Compression::DEFAULT, Compression::FAST}) {
+        for (unsigned int threads: {1U, 4U}) {
+            int w = 0;
+            int h = 0;
+            const auto rgba = decode(encode(data.data(), width, height, stride, {compression, threads}), w, h);
+            ASSERT_EQ(w, width);
+            ASSERT_EQ(h, height);
+            for (int y = 0; y < height; y++) {
+                const auto* row = reinterpret_cast<const uint32_t*>(data.data() + y * stride);
+                for (int x = 0; x < width; x++) {
+                    const uint8_t* px = rgba.data() + 4 * (y * width + x);
+                    const uint32_t a = row[x] >> 24;
+                    ASSERT_EQ(px[3], a);
+                    if (a != 0) {
+                        // Unpremultiplied
+                        ASSERT_NEAR(px[0] * a / 255.0, (row[x] >> 16) & 0xff, 0.5) << x << ", " << y;
+                        ASSERT_NEAR(px[2] * a / 255.0, row[x] & 0xff, 0.5) << x << ", " << y;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(UtilPngEncoder, testInvalid) { EXPECT_TRUE(encode(nullptr, 0, 0, 0, {}).empty()); }
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/Range.h"
+#include "util/SpatialGrid.h"
+
+using xoj::util::SpatialGrid;
+
+namespace {
+std::vector<int> sorted(std::vector<int> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+};  // namespace
+
+TEST(UtilSpatialGrid, testQuery) {
+    SpatialGrid<int> grid(10.0);
+    grid.insert(1, Range(0.0, 0.0, 5.0, 5.0));
+    grid.insert(2, Range(25.0, 25.0, 45.0, 45.0));
+    grid.insert(3, Range(-30.0, -30.0, -25.0, -25.0));
+    // Spans many cells: each item must be reported once only
+    grid.insert(4, Range(0.0, 0.0, 100.0, 100.0));
+
+    EXPECT_EQ(grid.size(), 4U);
+    // Make sure the cells are looked at, rather than the whole list of items
+    for (int i = 10; i < 100; i++) {
+        grid.insert(i, Range(1000.0 + i, 1000.0, 1001.0 + i, 1001.0));
+    }
+
+    EXPECT_EQ(sorted(grid.query(Range(1.0, 1.0, 2.0, 2.0))), (std::vector<int>{1, 4}));
+    EXPECT_EQ(sorted(grid.query(Range(30.0, 30.0, 60.0, 60.0))), (std::vector<int>{2, 4}));
+    EXPECT_EQ(sorted(grid.query(Range(-29.0, -29.0, 1.0, 1.0))), (std::vector<int>{1, 3, 4}));
+    EXPECT_TRUE(grid.query(Range(-100.0, 500.0, -90.0, 510.0)).empty());
+    EXPECT_TRUE(grid.query(Range()).empty());
+}
+
+TEST(UtilSpatialGrid, testMoveAndRemove) {
+    SpatialGrid<int> grid(10.0);
+    grid.insert(1, Range(0.0, 0.0, 5.0, 5.0));
+    grid.insert(2, Range(50.0, 50.0, 55.0, 55.0));
+
+    // Inserting again moves the item
+    grid.insert(1, Range(100.0, 100.0, 105.0, 105.0));
+    EXPECT_EQ(grid.size(), 2U);
+    EXPECT_TRUE(grid.query(Range(0.0, 0.0, 5.0, 5.0)).empty());
+    EXPECT_EQ(grid.query(Range(101.0, 101.0, 102.0, 102.0)), std::vector<int>{1});
+
+    EXPECT_TRUE(grid.remove(1));
+    EXPECT_FALSE(grid.remove(1));
+    EXPECT_FALSE(grid.contains(1));
+    EXPECT_TRUE(grid.contains(2));
+    EXPECT_TRUE(grid.query(Range(101.0, 101.0, 102.0, 102.0)).empty());
+
+    grid.clear();
+    EXPECT_TRUE(grid.empty());
+    EXPECT_TRUE(grid.query(Range(0.0, 0.0, 1000.0, 1000.0)).empty());
+}
+
+TEST(UtilSpatialGrid, testOversizedItems) {
+    SpatialGrid<int> grid(1.0);
+    // Too many cells, and invalid bounds: always reported
+    grid.insert(1, Range(0.0, 0.0, 1000.0, 1000.0));
+    grid.insert(2, Range(std::numeric_limits<double>::quiet_NaN(), 0.0, 1.0, 1.0));
+    grid.insert(3, Range(5.0, 5.0, 5.5, 5.5));
+    for (int i = 10; i < 100; i++) {
+        grid.insert(i, Range(-100.0 - i, 0.0, -99.5 - i, 0.5));
+    }
+
+    EXPECT_EQ(sorted(grid.query(Range(5.1, 5.1, 5.2, 5.2))), (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(sorted(grid.query(Range(2000.0, 2000.0, 2001.0, 2001.0))), (std::vector<int>{1, 2}));
+
+    EXPECT_TRUE(grid.remove(1));
+    EXPECT_TRUE(grid.remove(2));
+    EXPECT_TRUE(grid.query(Range(2000.0, 2000.0, 2001.0, 2001.0)).empty());
+}
@@ -0,0 +1,71 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/WindingBuffer.h"
+
+using xoj::util::WindingBuffer;
+using Pt = xoj::util::Point<double>;
+
+TEST(UtilWindingBuffer, testSquare) {
+    WindingBuffer buffer(100, 100);
+    buffer.addPolygon({{10, 10}, {30, 10}, {30, 20.5}, {10, 20.5}});
+    EXPECT_EQ(buffer.getCoverage(15, 15), 255);
+    EXPECT_EQ(buffer.getCoverage(29, 10), 255);
+    EXPECT_EQ(buffer.getCoverage(30, 15), 0);
+    EXPECT_EQ(buffer.getCoverage(9, 15), 0);
+    // Antialiased
+    EXPECT_EQ(buffer.getCoverage(15, 20), 128);
+    EXPECT_EQ(buffer.getCoverage(15, 21), 0);
+
+    auto changes = buffer.takeChanges();
+    ASSERT_EQ(changes.size(), 1U);
+    EXPECT_EQ(changes.front().second, xoj::util::Rectangle<int>(10, 10, 20, 11));
+    EXPECT_TRUE(buffer.takeChanges().empty());
+}
+
+TEST(UtilWindingBuffer, testIncremental) {
+    // The polygon (P0, ..., Pn) plus the polygon (P0, Pn, ..., Pm) is the polygon (P0, ..., Pm)
+    const std::vector<Pt> contour{{5, 5}, {150, 12}, {140, 80}, {20, 70}, {90, 30}, {60, 150}, {-20, 40}};
+    WindingBuffer whole(130, 120);
+    whole.addPolygon(contour);
+
+    WindingBuffer incremental(130, 120);
+    for (size_t n = 1; n + 1 < contour.size(); n++) {
+        incremental.addPolygon({contour[0], contour[n], contour[n + 1]});
+    }
+    for (int y = 0; y < 120; y++) {
+        for (int x = 0; x < 130; x++) {
+            ASSERT_NEAR(whole.getCoverage(x, y), incremental.getCoverage(x, y), 1) << x << ", " << y;
+        }
+    }
+    // Clipped to the extent of the buffer
+    EXPECT_EQ(whole.getCoverage(0, 40), 255);
+    EXPECT_EQ(whole.getCoverage(129, 15), 255);
+    EXPECT_EQ(whole.getCoverage(130, 15), 0);
+}
+
+TEST(UtilWindingBuffer, testShrinking) {
+    WindingBuffer buffer(200, 200);
+    // The filling grows, then its last point goes back: the first triangle is cancelled
+    buffer.addPolygon({{0, 0}, {100, 0}, {100, 100}});
+    EXPECT_EQ(buffer.getCoverage(90, 10), 255);
+    buffer.takeChanges();
+    buffer.addPolygon({{0, 0}, {100, 100}, {100, 0}});
+    EXPECT_EQ(buffer.getCoverage(90, 10), 0);
+    EXPECT_FALSE(buffer.takeChanges().empty());
+
+    buffer.clear();
+    EXPECT_EQ(buffer.getTileCount(), 0U);
+}
@@ -11,9 +11,12 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <fstream>
+#include <string>
 
 #include <gtest/gtest.h>
 
+#include "util/PathUtil.h"
 #include "util/XojPreviewExtractor.h"
 
 #include "config-test.h"
@@ -104,3 +107,25 @@ TEST(UtilXojPreviewExtractor, testInvalidFile) {
 
     EXPECT_EQ(PREVIEW_RESULT_ERROR_READING_PREVIEW, result);
 }
+
+TEST(UtilXojPreviewExtractor, testLoadLongPreview) {
+    // The preview spans several chunks, and is followed by a large page which is not read
+    auto file = Util::getTmpDirSubfolder() / "preview-test-long.xoj";
+    std::string preview;
+    for (int i = 0; i < 3000; i++) { preview += "QUFB"; }
+    {
+        std::ofstream out(file);
+        out << "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"Xournal++\" fileversion=\"2\">\n";
+        out << "<preview>" << preview << "</preview>\n<page width=\"595.28\" height=\"841.89\">\n";
+        out << std::string(1000000, ' ') << "</page>\n</xournal>\n";
+    }
+
+    XojPreviewExtractor extractor;
+    PreviewExtractResult result = extractor.readFile(file);
+
+    EXPECT_EQ(PREVIEW_RESULT_IMAGE_READ, result);
+
+    gsize dataLen = 0;
+    unsigned char* imageData = extractor.getData(dataLen);
+    EXPECT_EQ(std::string(9000, 'A'), std::string((char*)imageData, (size_t)dataLen));
+}